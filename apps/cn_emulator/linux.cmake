@@ -0,0 +1,63 @@
+################################################################################
+#
+# Linux definitions for the CN emulator application
+#
+# Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#     * Neither the name of the copyright holders nor the
+#       names of its contributors may be used to endorse or promote products
+#       derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+################################################################################
+
+################################################################################
+# Set architecture specific definitions
+
+ADD_DEFINITIONS(-Wall -Wextra -pedantic -std=c99 -pthread -D_GNU_SOURCE
+                -D_POSIX_C_SOURCE=200112L)
+
+################################################################################
+# Set architecture specific sources and include directories
+
+SET (DEMO_ARCH_SOURCES
+     ${DEMO_SOURCE_DIR}/netif-linux.c
+     ${COMMON_SOURCE_DIR}/system/system-linux.c
+     ${CONTRIB_SOURCE_DIR}/console/console-linux.c
+     ${CONTRIB_SOURCE_DIR}/trace/trace-printf.c
+     )
+
+IF((CMAKE_SYSTEM_PROCESSOR MATCHES x86*) OR (CMAKE_SYSTEM_PROCESSOR MATCHES i686))
+    SET (DEMO_ARCH_SOURCES ${DEMO_ARCH_SOURCES} ${OPLK_STACK_DIR}/src/common/ami/amix86.c)
+ELSEIF(CMAKE_SYSTEM_PROCESSOR MATCHES arm*)
+    SET (DEMO_ARCH_SOURCES ${DEMO_ARCH_SOURCES} ${OPLK_STACK_DIR}/src/common/ami/amile.c)
+ELSE()
+    MESSAGE(FATAL_ERROR "Unsupported CMAKE_SYSTEM_PROCESSOR ${CMAKE_SYSTEM_PROCESSOR}")
+ENDIF()
+
+################################################################################
+# Set architecture specific libraries
+
+SET (ARCH_LIBRARIES ${ARCH_LIBRARIES} pthread rt)
+
+################################################################################
+# Set architecture specific installation files
+
+INSTALL(PROGRAMS ${TOOLS_DIR}/linux/set_prio DESTINATION ${CMAKE_PROJECT_NAME})
@@ -0,0 +1,1420 @@
+/**
+********************************************************************************
+\file   emulator.c
+
+\brief  CN emulator
+
+The file implements the CN emulator. A single thread receives the frames of
+the MN from the network interface and answers them for all emulated CNs. The
+CNs are not instances of the stack: they follow the NMT state commands, answer
+PReqs from a PRes template and answer IdentRequests, StatusRequests and SDO
+requests with a minimal SDO server like the simulated CNs of the simulated
+Ethernet driver. Response latencies and faults are configured per CN.
+
+\ingroup module_cn_emulator
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#include <common/ami.h>
+#include <oplk/frame.h>
+#include <oplk/dll.h>
+#include <oplk/sdo.h>
+#include <oplk/sdoabortcodes.h>
+
+#include "emulator.h"
+#include "netif.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define EMU_SDO_QUEUE_SIZE          4                   // Number of pending SDO frames per CN
+#define EMU_SDO_FRAME_SIZE          64                  // Maximum size of an SDO frame of a CN
+
+#define EMU_MIN_FRAME_SIZE          60                  // Minimum Ethernet frame size without CRC
+#define EMU_MIN_PLK_FRAME_SIZE      18                  // POWERLINK header up to the ASnd service ID
+
+#define EMU_ASYNC_MTU               300                 // Asynchronous MTU of the emulated CNs
+#define EMU_PROFILE_VERSION         0x20                // POWERLINK profile version of the emulated CNs
+
+#define EMU_SDO_STATE_IDLE          0                   // No sequence layer connection
+#define EMU_SDO_STATE_INIT          1                   // Connection initialization was answered
+#define EMU_SDO_STATE_CONNECTED     2                   // Connection is established
+
+#define EMU_SDO_CON_MASK            0x03                // Mask of rcon and scon in the sequence layer header
+#define EMU_SDO_SEQ_NUM_MASK        0xFC                // Mask of the sequence numbers in the sequence layer header
+#define EMU_SDO_SEQ_OFFSET          18                  // Offset of the sequence layer header in the frame
+#define EMU_SDO_CMD_OFFSET          (EMU_SDO_SEQ_OFFSET + 4)
+#define EMU_SDO_DATA_OFFSET         (EMU_SDO_CMD_OFFSET + SDO_CMDL_HDR_FIXED_SIZE)
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief Pending SDO frame
+
+The structure contains an SDO frame which an emulated CN sends on the next
+UnspecifiedInvite after its ready time.
+*/
+typedef struct
+{
+    UINT64                  readyTime;                  ///< Time when the frame is ready to be sent [ns]
+    UINT                    frameSize;                  ///< Size of the frame
+    UINT8                   aFrame[EMU_SDO_FRAME_SIZE]; ///< Frame data
+} tEmuSdoFrame;
+
+/**
+\brief Emulated CN
+
+The structure contains the configuration, the state and the frame templates
+of an emulated CN. The PRes and the IdentResponse are prepared when the CN is
+set up, only their dynamic fields are updated before they are sent.
+*/
+typedef struct
+{
+    UINT                    nodeId;                     ///< Node ID of the CN
+    tEmuNodeConfig          config;                     ///< Configuration of the CN
+    tNmtState               nmtState;                   ///< NMT state of the CN
+    UINT64                  silentEndTime;              ///< End of the silent time after a reset [ns]
+    UINT32                  opPreqCount;                ///< Number of PReqs in Operational since the last reset
+    UINT32                  randomState;                ///< State of the fault generator
+    UINT32                  presCounter;                ///< Counter of the PRes payload
+    UINT8                   sdoState;                   ///< State of the SDO sequence layer connection
+    UINT8                   sdoRecvSeqNumCon;           ///< Last accepted sequence number of the client with scon
+    UINT8                   sdoSendSeqNumCon;           ///< Own sequence number with rcon
+    tEmuSdoFrame            aSdoQueue[EMU_SDO_QUEUE_SIZE];  ///< Pending SDO frames
+    UINT                    sdoQueueRead;               ///< Index of the oldest pending SDO frame
+    UINT                    sdoQueueCount;              ///< Number of pending SDO frames
+    tEmuSdoFrame            sdoLastResponse;            ///< Last SDO command response for retransmissions
+    UINT                    presFrameSize;              ///< Size of the PRes template
+    UINT8                   aPresFrame[NETIF_MAX_FRAME_SIZE];       ///< PRes template
+    UINT8                   aIdentResFrame[C_DLL_MINSIZE_IDENTRES]; ///< IdentResponse template
+    tEmuNodeStatistics      statistics;                 ///< Statistics of the CN
+} tEmuNode;
+
+/**
+\brief Emulator instance
+
+The structure contains the instance of the emulator.
+*/
+typedef struct
+{
+    tEmuConfig              config;                     ///< Configuration of the emulator
+    tEmuNode*               pNodes;                     ///< Allocated emulated CNs
+    UINT                    nodeCount;                  ///< Number of emulated CNs
+    tEmuNode*               apNode[EMU_MAX_NODE_ID + 1];    ///< Emulated CNs indexed by their node ID
+    UINT8                   aMnMac[6];                  ///< MAC address of the MN, taken from its SoA
+    tEmuStatistics          statistics;                 ///< Statistics of the emulator
+    volatile BOOL           fStopThread;                ///< Termination request of the emulation thread
+    BOOL                    fThreadStarted;             ///< The emulation thread was started
+    pthread_t               hThread;                    ///< Emulation thread
+    UINT8                   aRxFrame[NETIF_MAX_FRAME_SIZE]; ///< Receive buffer
+    UINT8                   aTxFrame[NETIF_MAX_FRAME_SIZE]; ///< Transmit buffer for frames without template
+} tEmuInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tEmuInstance emuInstance_l;
+
+static const UINT8 aEmuMacPrefix_l[5] = {0x02, 0x45, 0x4D, 0x55, 0x00};
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static UINT64 getTimeNs(void);
+static void transmitFrame(UINT8* pFrame_p, UINT frameSize_p, UINT64 dueTime_p);
+static BOOL isFault(tEmuNode* pNode_p, UINT perMille_p);
+static void setupFrameHeader(UINT8* pFrame_p, UINT nodeId_p, tMsgType msgType_p,
+                             UINT dstNodeId_p);
+static void setupPresFrame(tEmuNode* pNode_p);
+static void setupIdentResFrame(tEmuNode* pNode_p);
+static void resetNode(tEmuNode* pNode_p, UINT64 now_p);
+static BOOL isSilent(const tEmuNode* pNode_p, UINT64 now_p);
+static UINT8 getFlag2(const tEmuNode* pNode_p, UINT64 now_p);
+static void processFrame(tPlkFrame* pFrame_p, UINT frameSize_p, UINT64 now_p);
+static void processSoc(UINT64 now_p);
+static void processPreq(tPlkFrame* pFrame_p, UINT frameSize_p, UINT64 now_p);
+static void processSoa(tPlkFrame* pFrame_p, UINT64 now_p);
+static void processNmtCommand(tPlkFrame* pFrame_p, UINT64 now_p);
+static void executeNmtCommand(tEmuNode* pNode_p, UINT8 nmtCommand_p, UINT64 now_p);
+static void processSdo(tPlkFrame* pFrame_p, UINT frameSize_p, UINT64 now_p);
+static BOOL processSdoCommand(tEmuNode* pNode_p, UINT mnNodeId_p, tAsySdoCom* pCommand_p,
+                              UINT commandSize_p, UINT64 readyTime_p);
+static void queueSdoFrame(tEmuNode* pNode_p, UINT mnNodeId_p, tAsySdoCom* pCommand_p,
+                          UINT commandSize_p, UINT64 readyTime_p);
+static BOOL readObject(const tEmuNode* pNode_p, UINT index_p, UINT subIndex_p,
+                       UINT32* pValue_p, UINT* pSize_p);
+static void writeObject(tEmuNode* pNode_p, UINT index_p, UINT subIndex_p,
+                        UINT8* pData_p, UINT size_p);
+static void* emulationThread(void* pArgument_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize CN emulator
+
+The function sets up the emulated CNs and opens the network interface.
+
+\param  pConfig_p           Pointer to the configuration of the emulator.
+\param  aNodeConfig_p       Configurations of the CNs indexed by their node ID.
+\param  afEnabled_p         Flags of the emulated CNs indexed by their node ID.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_cn_emulator
+*/
+//------------------------------------------------------------------------------
+tOplkError emulator_init(const tEmuConfig* pConfig_p, const tEmuNodeConfig* aNodeConfig_p,
+                         const BOOL* afEnabled_p)
+{
+    tOplkError  ret;
+    tEmuNode*   pNode;
+    UINT        nodeId;
+    UINT        nodeCount = 0;
+
+    memset(&emuInstance_l, 0, sizeof(emuInstance_l));
+    emuInstance_l.config = *pConfig_p;
+
+    for (nodeId = 1; nodeId <= EMU_MAX_NODE_ID; nodeId++)
+    {
+        if (afEnabled_p[nodeId])
+            nodeCount++;
+    }
+
+    if (nodeCount == 0)
+        return kErrorApiInvalidParam;
+
+    emuInstance_l.pNodes = (tEmuNode*)calloc(nodeCount, sizeof(tEmuNode));
+    if (emuInstance_l.pNodes == NULL)
+        return kErrorNoResource;
+
+    for (nodeId = 1; nodeId <= EMU_MAX_NODE_ID; nodeId++)
+    {
+        if (!afEnabled_p[nodeId])
+            continue;
+
+        pNode = &emuInstance_l.pNodes[emuInstance_l.nodeCount++];
+        pNode->nodeId = nodeId;
+        pNode->config = aNodeConfig_p[nodeId];
+        if (pNode->config.presPayloadSize > EMU_MAX_PAYLOAD_SIZE)
+            pNode->config.presPayloadSize = EMU_MAX_PAYLOAD_SIZE;
+
+        // every CN gets its own fault sequence, the xorshift state must not be 0
+        pNode->randomState = (pConfig_p->seed * 0x9E3779B1UL) ^ nodeId;
+        if (pNode->randomState == 0)
+            pNode->randomState = 1;
+
+        resetNode(pNode, 0);
+        setupPresFrame(pNode);
+        setupIdentResFrame(pNode);
+        emuInstance_l.apNode[nodeId] = pNode;
+    }
+
+    ret = netif_open(pConfig_p->pIfName);
+    if (ret != kErrorOk)
+    {
+        free(emuInstance_l.pNodes);
+        emuInstance_l.pNodes = NULL;
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Shut down CN emulator
+
+The function closes the network interface and frees the emulated CNs. The
+emulation thread must be stopped before.
+
+\ingroup module_cn_emulator
+*/
+//------------------------------------------------------------------------------
+void emulator_exit(void)
+{
+    netif_close();
+    free(emuInstance_l.pNodes);
+    emuInstance_l.pNodes = NULL;
+    emuInstance_l.nodeCount = 0;
+    memset(emuInstance_l.apNode, 0, sizeof(emuInstance_l.apNode));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Start CN emulator
+
+The function starts the emulation thread. The memory of the process is
+locked to avoid page faults while responses are due. If the real-time
+priority can't be set, the thread is started with the default scheduling
+policy.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_cn_emulator
+*/
+//------------------------------------------------------------------------------
+tOplkError emulator_start(void)
+{
+    pthread_attr_t      attr;
+    struct sched_param  schedParam;
+    cpu_set_t           cpuSet;
+    int                 result = EPERM;
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        fprintf(stderr, "Couldn't lock memory (%s)!\n", strerror(errno));
+
+    emuInstance_l.fStopThread = FALSE;
+
+    if (emuInstance_l.config.threadPriority > 0)
+    {
+        pthread_attr_init(&attr);
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        schedParam.sched_priority = emuInstance_l.config.threadPriority;
+        pthread_attr_setschedparam(&attr, &schedParam);
+        result = pthread_create(&emuInstance_l.hThread, &attr, emulationThread, &emuInstance_l);
+        pthread_attr_destroy(&attr);
+        if (result != 0)
+        {
+            fprintf(stderr, "Couldn't start emulation thread with priority %d (%s)!\n",
+                    emuInstance_l.config.threadPriority, strerror(result));
+        }
+    }
+
+    if (result != 0)
+    {
+        result = pthread_create(&emuInstance_l.hThread, NULL, emulationThread, &emuInstance_l);
+        if (result != 0)
+        {
+            fprintf(stderr, "Couldn't start emulation thread (%s)!\n", strerror(result));
+            return kErrorNoResource;
+        }
+    }
+
+    emuInstance_l.fThreadStarted = TRUE;
+
+#if (defined(__GLIBC__) && __GLIBC__ >= 2 && __GLIBC_MINOR__ >= 12)
+    pthread_setname_np(emuInstance_l.hThread, "oplk-cnemu");
+#endif
+
+    if (emuInstance_l.config.cpu >= 0)
+    {
+        CPU_ZERO(&cpuSet);
+        CPU_SET(emuInstance_l.config.cpu, &cpuSet);
+        if (pthread_setaffinity_np(emuInstance_l.hThread, sizeof(cpuSet), &cpuSet) != 0)
+            fprintf(stderr, "Couldn't bind emulation thread to CPU %d!\n", emuInstance_l.config.cpu);
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Stop CN emulator
+
+The function stops the emulation thread. The thread terminates within the
+receive timeout of the network interface.
+
+\ingroup module_cn_emulator
+*/
+//------------------------------------------------------------------------------
+void emulator_stop(void)
+{
+    if (!emuInstance_l.fThreadStarted)
+        return;
+
+    emuInstance_l.fStopThread = TRUE;
+    pthread_join(emuInstance_l.hThread, NULL);
+    emuInstance_l.fThreadStarted = FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get statistics of an emulated CN
+
+The function returns the NMT state and the frame counters of an emulated CN.
+The counters are read while the emulation thread updates them, so they may be
+inconsistent by a single frame.
+
+\param  nodeId_p            Node ID of the CN.
+\param  pStatistics_p       Pointer to store the statistics.
+
+\return The function returns TRUE if the CN is emulated.
+
+\ingroup module_cn_emulator
+*/
+//------------------------------------------------------------------------------
+BOOL emulator_getNodeStatistics(UINT nodeId_p, tEmuNodeStatistics* pStatistics_p)
+{
+    tEmuNode*   pNode;
+
+    if ((nodeId_p == 0) || (nodeId_p > EMU_MAX_NODE_ID))
+        return FALSE;
+
+    pNode = emuInstance_l.apNode[nodeId_p];
+    if (pNode == NULL)
+        return FALSE;
+
+    *pStatistics_p = pNode->statistics;
+    pStatistics_p->nmtState = pNode->nmtState;
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get statistics of the emulator
+
+The function returns the frame counters of the emulator.
+
+\param  pStatistics_p       Pointer to store the statistics.
+
+\ingroup module_cn_emulator
+*/
+//------------------------------------------------------------------------------
+void emulator_getStatistics(tEmuStatistics* pStatistics_p)
+{
+    *pStatistics_p = emuInstance_l.statistics;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get current time
+
+The function returns the current time of the monotonic clock.
+
+\return The function returns the time in ns.
+*/
+//------------------------------------------------------------------------------
+static UINT64 getTimeNs(void)
+{
+    struct timespec     ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((UINT64)ts.tv_sec * 1000000000ULL) + (UINT64)ts.tv_nsec;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Transmit frame at its due time
+
+The function waits actively until the due time of a response and transmits
+it. Sleeping is not used because the latencies of a CN are in the range of a
+few microseconds. Responses which are handled after their due time are sent
+immediately and are counted.
+
+\param  pFrame_p            Pointer to the frame.
+\param  frameSize_p         Size of the frame without CRC.
+\param  dueTime_p           Time when the transmission shall start [ns].
+*/
+//------------------------------------------------------------------------------
+static void transmitFrame(UINT8* pFrame_p, UINT frameSize_p, UINT64 dueTime_p)
+{
+    UINT64  now;
+    UINT64  delay;
+
+    now = getTimeNs();
+    if (now > dueTime_p)
+        emuInstance_l.statistics.lateTxCount++;
+
+    while (now < dueTime_p)
+        now = getTimeNs();
+
+    delay = now - dueTime_p;
+    if (delay > emuInstance_l.statistics.maxTxDelayNs)
+        emuInstance_l.statistics.maxTxDelayNs = (delay > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (UINT32)delay;
+
+    if (frameSize_p < EMU_MIN_FRAME_SIZE)
+        frameSize_p = EMU_MIN_FRAME_SIZE;
+
+    if (netif_send(pFrame_p, frameSize_p) == kErrorOk)
+        emuInstance_l.statistics.txFrameCount++;
+    else
+        emuInstance_l.statistics.txErrorCount++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Decide whether a fault is injected
+
+The function draws the next number of the xorshift sequence of the fault
+generator of a CN and decides whether a fault is injected.
+
+\param  pNode_p             Pointer to the emulated CN.
+\param  perMille_p          Fault probability [1/1000].
+
+\return The function returns TRUE if the fault is injected.
+*/
+//------------------------------------------------------------------------------
+static BOOL isFault(tEmuNode* pNode_p, UINT perMille_p)
+{
+    UINT32  x;
+
+    if (perMille_p == 0)
+        return FALSE;
+
+    x = pNode_p->randomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    pNode_p->randomState = x;
+
+    return ((x % 1000) < perMille_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set up frame header
+
+The function sets up the Ethernet and POWERLINK header of a frame sent by an
+emulated CN. PRes and ASnd frames to the broadcast address use the
+corresponding multicast MAC addresses, other frames are addressed to the MN.
+
+\param  pFrame_p            Pointer to the frame.
+\param  nodeId_p            Node ID of the emulated CN.
+\param  msgType_p           POWERLINK message type.
+\param  dstNodeId_p         Destination node ID.
+*/
+//------------------------------------------------------------------------------
+static void setupFrameHeader(UINT8* pFrame_p, UINT nodeId_p, tMsgType msgType_p,
+                             UINT dstNodeId_p)
+{
+    tPlkFrame*  pFrame = (tPlkFrame*)pFrame_p;
+
+    if (msgType_p == kMsgTypePres)
+        ami_setUint48Be(pFrame->aDstMac, C_DLL_MULTICAST_PRES);
+    else if (dstNodeId_p == C_ADR_BROADCAST)
+        ami_setUint48Be(pFrame->aDstMac, C_DLL_MULTICAST_ASND);
+    else
+        memcpy(pFrame->aDstMac, emuInstance_l.aMnMac, 6);
+
+    memcpy(pFrame->aSrcMac, aEmuMacPrefix_l, sizeof(aEmuMacPrefix_l));
+    pFrame->aSrcMac[5] = (UINT8)nodeId_p;
+    ami_setUint16Be(&pFrame->etherType, C_DLL_ETHERTYPE_EPL);
+    ami_setUint8Le(&pFrame->messageType, (UINT8)msgType_p);
+    ami_setUint8Le(&pFrame->dstNodeId, (UINT8)dstNodeId_p);
+    ami_setUint8Le(&pFrame->srcNodeId, (UINT8)nodeId_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set up PRes template
+
+The function prepares the PRes of an emulated CN. The payload is zero, only
+the PRes counter is written into it if it is enabled.
+
+\param  pNode_p             Pointer to the emulated CN.
+*/
+//------------------------------------------------------------------------------
+static void setupPresFrame(tEmuNode* pNode_p)
+{
+    tPlkFrame*  pFrame = (tPlkFrame*)pNode_p->aPresFrame;
+
+    pNode_p->presFrameSize = PLK_FRAME_OFFSET_PDO_PAYLOAD + pNode_p->config.presPayloadSize;
+    if (pNode_p->presFrameSize < EMU_MIN_FRAME_SIZE)
+        pNode_p->presFrameSize = EMU_MIN_FRAME_SIZE;
+
+    memset(pNode_p->aPresFrame, 0, sizeof(pNode_p->aPresFrame));
+    setupFrameHeader(pNode_p->aPresFrame, pNode_p->nodeId, kMsgTypePres, C_ADR_BROADCAST);
+    ami_setUint8Le(&pFrame->data.pres.pdoVersion, (UINT8)pNode_p->config.pdoVersion);
+    ami_setUint16Le(&pFrame->data.pres.sizeLe, (UINT16)pNode_p->config.presPayloadSize);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set up IdentResponse template
+
+The function prepares the IdentResponse of an emulated CN from its
+configuration. It is called again if the configuration date or time is
+written.
+
+\param  pNode_p             Pointer to the emulated CN.
+*/
+//------------------------------------------------------------------------------
+static void setupIdentResFrame(tEmuNode* pNode_p)
+{
+    tPlkFrame*          pFrame = (tPlkFrame*)pNode_p->aIdentResFrame;
+    tIdentResponse*     pIdentRes = &pFrame->data.asnd.payload.identResponse;
+
+    memset(pNode_p->aIdentResFrame, 0, sizeof(pNode_p->aIdentResFrame));
+    setupFrameHeader(pNode_p->aIdentResFrame, pNode_p->nodeId, kMsgTypeAsnd, C_ADR_BROADCAST);
+    ami_setUint8Le(&pFrame->data.asnd.serviceId, kDllAsndIdentResponse);
+    ami_setUint8Le(&pIdentRes->powerlinkProfileVersion, EMU_PROFILE_VERSION);
+    ami_setUint32Le(&pIdentRes->featureFlagsLe, pNode_p->config.featureFlags);
+    ami_setUint16Le(&pIdentRes->mtuLe, EMU_ASYNC_MTU);
+    ami_setUint16Le(&pIdentRes->pollInSizeLe, (UINT16)pNode_p->config.preqPayloadSize);
+    ami_setUint16Le(&pIdentRes->pollOutSizeLe, (UINT16)pNode_p->config.presPayloadSize);
+    ami_setUint32Le(&pIdentRes->responseTimeLe, pNode_p->config.presLatencyNs);
+    ami_setUint32Le(&pIdentRes->deviceTypeLe, pNode_p->config.deviceType);
+    ami_setUint32Le(&pIdentRes->vendorIdLe, pNode_p->config.vendorId);
+    ami_setUint32Le(&pIdentRes->productCodeLe, pNode_p->config.productCode);
+    ami_setUint32Le(&pIdentRes->revisionNumberLe, pNode_p->config.revisionNumber);
+    ami_setUint32Le(&pIdentRes->serialNumberLe, pNode_p->config.serialNumber + pNode_p->nodeId);
+    ami_setUint32Le(&pIdentRes->verifyConfigurationDateLe, pNode_p->config.confDate);
+    ami_setUint32Le(&pIdentRes->verifyConfigurationTimeLe, pNode_p->config.confTime);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Reset emulated CN
+
+The function resets an emulated CN to the state NotActive and closes its SDO
+connection. The CN stays silent for its reset time.
+
+\param  pNode_p             Pointer to the emulated CN.
+\param  now_p               Current time [ns].
+*/
+//------------------------------------------------------------------------------
+static void resetNode(tEmuNode* pNode_p, UINT64 now_p)
+{
+    pNode_p->nmtState = kNmtCsNotActive;
+    pNode_p->silentEndTime = now_p + ((UINT64)pNode_p->config.resetTimeUs * 1000ULL);
+    pNode_p->opPreqCount = 0;
+    pNode_p->sdoState = EMU_SDO_STATE_IDLE;
+    pNode_p->sdoQueueRead = 0;
+    pNode_p->sdoQueueCount = 0;
+    pNode_p->sdoLastResponse.frameSize = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check whether an emulated CN is silent
+
+\param  pNode_p             Pointer to the emulated CN.
+\param  now_p               Current time [ns].
+
+\return The function returns TRUE if the CN is still in its reset time.
+*/
+//------------------------------------------------------------------------------
+static BOOL isSilent(const tEmuNode* pNode_p, UINT64 now_p)
+{
+    return (now_p < pNode_p->silentEndTime);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get flag 2 of an emulated CN
+
+The function returns the flags PR and RS of an emulated CN. RS counts the SDO
+frames whose processing time has elapsed.
+
+\param  pNode_p             Pointer to the emulated CN.
+\param  now_p               Current time [ns].
+
+\return The function returns flag 2 for PRes, StatusResponse and IdentResponse.
+*/
+//------------------------------------------------------------------------------
+static UINT8 getFlag2(const tEmuNode* pNode_p, UINT64 now_p)
+{
+    UINT    readyCount = 0;
+    UINT    i;
+
+    for (i = 0; i < pNode_p->sdoQueueCount; i++)
+    {
+        if (pNode_p->aSdoQueue[(pNode_p->sdoQueueRead + i) % EMU_SDO_QUEUE_SIZE].readyTime > now_p)
+            break;
+        readyCount++;
+    }
+
+    if (readyCount == 0)
+        return 0;
+
+    if (readyCount > PLK_FRAME_FLAG2_RS)
+        readyCount = PLK_FRAME_FLAG2_RS;
+
+    return (UINT8)((kDllAsyncReqPrioGeneric << PLK_FRAME_FLAG2_PR_SHIFT) | readyCount);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process received frame
+
+The function lets the emulated CNs process a frame received from the network.
+
+\param  pFrame_p            Pointer to the frame.
+\param  frameSize_p         Size of the frame.
+\param  now_p               Time of the reception [ns].
+*/
+//------------------------------------------------------------------------------
+static void processFrame(tPlkFrame* pFrame_p, UINT frameSize_p, UINT64 now_p)
+{
+    if ((frameSize_p < EMU_MIN_PLK_FRAME_SIZE) ||
+        (ami_getUint16Be(&pFrame_p->etherType) != C_DLL_ETHERTYPE_EPL))
+        return;
+
+    emuInstance_l.statistics.rxFrameCount++;
+
+    switch (ami_getUint8Le(&pFrame_p->messageType))
+    {
+        case kMsgTypeSoc:
+            emuInstance_l.statistics.socCount++;
+            processSoc(now_p);
+            break;
+
+        case kMsgTypePreq:
+            processPreq(pFrame_p, frameSize_p, now_p);
+            break;
+
+        case kMsgTypeSoa:
+            processSoa(pFrame_p, now_p);
+            break;
+
+        case kMsgTypeAsnd:
+            // frames of other CNs are not processed
+            if (ami_getUint8Le(&pFrame_p->srcNodeId) != C_ADR_MN_DEF_NODE_ID)
+                break;
+
+            switch (ami_getUint8Le(&pFrame_p->data.asnd.serviceId))
+            {
+                case kDllAsndNmtCommand:
+                    processNmtCommand(pFrame_p, now_p);
+                    break;
+
+                case kDllAsndSdo:
+                    processSdo(pFrame_p, frameSize_p, now_p);
+                    break;
+
+                default:
+                    break;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process SoC
+
+The function processes a SoC. Emulated CNs in NotActive enter PreOperational1
+and CNs in PreOperational1 enter PreOperational2.
+
+\param  now_p               Time of the reception [ns].
+*/
+//------------------------------------------------------------------------------
+static void processSoc(UINT64 now_p)
+{
+    tEmuNode*   pNode;
+    UINT        i;
+
+    for (i = 0; i < emuInstance_l.nodeCount; i++)
+    {
+        pNode = &emuInstance_l.pNodes[i];
+        if (pNode->nmtState == kNmtCsPreOperational1)
+            pNode->nmtState = kNmtCsPreOperational2;
+        else if ((pNode->nmtState == kNmtCsNotActive) && !isSilent(pNode, now_p))
+            pNode->nmtState = kNmtCsPreOperational1;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process PReq
+
+The function answers a PReq with the PRes template of the addressed CN if the
+CN is in an isochronous NMT state. The configured faults are injected: the
+PRes is lost or late with the configured probabilities, and the CN falls
+silent for a number of PReqs after it has been operational for a while.
+
+\param  pFrame_p            Pointer to the PReq.
+\param  frameSize_p         Size of the PReq.
+\param  now_p               Time of the reception [ns].
+*/
+//------------------------------------------------------------------------------
+static void processPreq(tPlkFrame* pFrame_p, UINT frameSize_p, UINT64 now_p)
+{
+    UINT            nodeId = ami_getUint8Le(&pFrame_p->dstNodeId);
+    tEmuNode*       pNode;
+    tPlkFrame*      pPres;
+    UINT64          dueTime;
+    UINT8           flag1;
+
+    if ((nodeId == 0) || (nodeId > EMU_MAX_NODE_ID) ||
+        (frameSize_p < PLK_FRAME_OFFSET_PDO_PAYLOAD))
+        return;
+
+    pNode = emuInstance_l.apNode[nodeId];
+    if (pNode == NULL)
+        return;
+
+    if ((pNode->nmtState != kNmtCsPreOperational2) &&
+        (pNode->nmtState != kNmtCsReadyToOperate) &&
+        (pNode->nmtState != kNmtCsOperational))
+        return;
+
+    if (pNode->nmtState == kNmtCsOperational)
+    {
+        pNode->opPreqCount++;
+        if ((pNode->config.muteAfter != 0) && (pNode->opPreqCount > pNode->config.muteAfter) &&
+            ((pNode->config.muteCount == 0) ||
+             (pNode->opPreqCount <= pNode->config.muteAfter + pNode->config.muteCount)))
+        {
+            pNode->statistics.presMuteCount++;
+            return;
+        }
+    }
+
+    if (isFault(pNode, pNode->config.presLossPerMille))
+    {
+        pNode->statistics.presLossCount++;
+        return;
+    }
+
+    dueTime = now_p + pNode->config.presLatencyNs;
+    if (isFault(pNode, pNode->config.presLatePerMille))
+    {
+        dueTime += pNode->config.presLateNs;
+        pNode->statistics.presLateCount++;
+    }
+
+    pPres = (tPlkFrame*)pNode->aPresFrame;
+    flag1 = ami_getUint8Le(&pFrame_p->data.preq.flag1) & PLK_FRAME_FLAG1_MS;
+    if (pNode->nmtState == kNmtCsOperational)
+        flag1 |= PLK_FRAME_FLAG1_RD;
+
+    ami_setUint8Le(&pPres->data.pres.nmtStatus, (UINT8)pNode->nmtState);
+    ami_setUint8Le(&pPres->data.pres.flag1, flag1);
+    ami_setUint8Le(&pPres->data.pres.flag2, getFlag2(pNode, now_p));
+    if (pNode->config.fPresCounter && (pNode->config.presPayloadSize >= sizeof(UINT32)))
+    {
+        ami_setUint32Le(&pNode->aPresFrame[PLK_FRAME_OFFSET_PDO_PAYLOAD], pNode->presCounter);
+        pNode->presCounter++;
+    }
+
+    transmitFrame(pNode->aPresFrame, pNode->presFrameSize, dueTime);
+    pNode->statistics.presCount++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process SoA
+
+The function processes a SoA. Emulated CNs in NotActive enter
+PreOperational1. If the SoA invites an emulated CN, the CN sends an
+IdentResponse, a StatusResponse or its next pending SDO frame.
+
+\param  pFrame_p            Pointer to the SoA.
+\param  now_p               Time of the reception [ns].
+*/
+//------------------------------------------------------------------------------
+static void processSoa(tPlkFrame* pFrame_p, UINT64 now_p)
+{
+    UINT            nodeId;
+    tEmuNode*       pNode;
+    tPlkFrame*      pAsnd;
+    tEmuSdoFrame*   pSdoFrame;
+    UINT            i;
+
+    memcpy(emuInstance_l.aMnMac, pFrame_p->aSrcMac, sizeof(emuInstance_l.aMnMac));
+
+    for (i = 0; i < emuInstance_l.nodeCount; i++)
+    {
+        pNode = &emuInstance_l.pNodes[i];
+        if ((pNode->nmtState == kNmtCsNotActive) && !isSilent(pNode, now_p))
+            pNode->nmtState = kNmtCsPreOperational1;
+    }
+
+    nodeId = ami_getUint8Le(&pFrame_p->data.soa.reqServiceTarget);
+    if ((nodeId == 0) || (nodeId > EMU_MAX_NODE_ID))
+        return;
+
+    pNode = emuInstance_l.apNode[nodeId];
+    if ((pNode == NULL) || (pNode->nmtState == kNmtCsNotActive))
+        return;
+
+    switch (ami_getUint8Le(&pFrame_p->data.soa.reqServiceId))
+    {
+        case kDllReqServiceIdent:
+            pAsnd = (tPlkFrame*)pNode->aIdentResFrame;
+            ami_setUint8Le(&pAsnd->data.asnd.payload.identResponse.flag2, getFlag2(pNode, now_p));
+            ami_setUint8Le(&pAsnd->data.asnd.payload.identResponse.nmtStatus, (UINT8)pNode->nmtState);
+            transmitFrame(pNode->aIdentResFrame, sizeof(pNode->aIdentResFrame),
+                          now_p + pNode->config.asndLatencyNs);
+            pNode->statistics.identResCount++;
+            break;
+
+        case kDllReqServiceStatus:
+            memset(emuInstance_l.aTxFrame, 0, C_DLL_MINSIZE_STATUSRES);
+            setupFrameHeader(emuInstance_l.aTxFrame, nodeId, kMsgTypeAsnd, C_ADR_BROADCAST);
+
+            // the exception clear flag follows the exception reset flag of the MN
+            pAsnd = (tPlkFrame*)emuInstance_l.aTxFrame;
+            ami_setUint8Le(&pAsnd->data.asnd.serviceId, kDllAsndStatusResponse);
+            ami_setUint8Le(&pAsnd->data.asnd.payload.statusResponse.flag1,
+                           ((ami_getUint8Le(&pFrame_p->data.soa.flag1) & PLK_FRAME_FLAG1_ER) != 0) ?
+                           PLK_FRAME_FLAG1_EC : 0);
+            ami_setUint8Le(&pAsnd->data.asnd.payload.statusResponse.flag2, getFlag2(pNode, now_p));
+            ami_setUint8Le(&pAsnd->data.asnd.payload.statusResponse.nmtStatus, (UINT8)pNode->nmtState);
+            transmitFrame(emuInstance_l.aTxFrame, C_DLL_MINSIZE_STATUSRES,
+                          now_p + pNode->config.asndLatencyNs);
+            pNode->statistics.statusResCount++;
+            break;
+
+        case kDllReqServiceUnspecified:
+            if (pNode->sdoQueueCount == 0)
+                return;
+
+            pSdoFrame = &pNode->aSdoQueue[pNode->sdoQueueRead];
+            if (pSdoFrame->readyTime > now_p)
+                return;
+
+            pNode->sdoQueueRead = (pNode->sdoQueueRead + 1) % EMU_SDO_QUEUE_SIZE;
+            pNode->sdoQueueCount--;
+
+            transmitFrame(pSdoFrame->aFrame, pSdoFrame->frameSize, now_p + pNode->config.asndLatencyNs);
+            pNode->statistics.sdoTxCount++;
+            break;
+
+        default:
+            // NMT requests and SyncRequests are not emulated
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process NMT command
+
+The function applies an NMT state command to the addressed emulated CNs.
+Plain commands address a single CN or all CNs, extended commands address the
+CNs in their node list.
+
+\param  pFrame_p            Pointer to the NMT command frame.
+\param  now_p               Time of the reception [ns].
+*/
+//------------------------------------------------------------------------------
+static void processNmtCommand(tPlkFrame* pFrame_p, UINT64 now_p)
+{
+    UINT        dstNodeId = ami_getUint8Le(&pFrame_p->dstNodeId);
+    UINT8       nmtCommand = ami_getUint8Le(&pFrame_p->data.asnd.payload.nmtCommandService.nmtCommandId);
+    UINT8*      pNodeList = pFrame_p->data.asnd.payload.nmtCommandService.aNmtCommandData;
+    tEmuNode*   pNode;
+    UINT        i;
+
+    if ((nmtCommand >= 0x40) && (nmtCommand < 0x60))
+    {   // extended NMT state command, convert to plain command
+        nmtCommand -= 0x20;
+        for (i = 0; i < emuInstance_l.nodeCount; i++)
+        {
+            pNode = &emuInstance_l.pNodes[i];
+            if ((pNodeList[pNode->nodeId >> 3] & (1 << (pNode->nodeId & 7))) != 0)
+                executeNmtCommand(pNode, nmtCommand, now_p);
+        }
+    }
+    else if (dstNodeId == C_ADR_BROADCAST)
+    {
+        for (i = 0; i < emuInstance_l.nodeCount; i++)
+            executeNmtCommand(&emuInstance_l.pNodes[i], nmtCommand, now_p);
+    }
+    else if ((dstNodeId != 0) && (dstNodeId <= EMU_MAX_NODE_ID) &&
+             (emuInstance_l.apNode[dstNodeId] != NULL))
+    {
+        executeNmtCommand(emuInstance_l.apNode[dstNodeId], nmtCommand, now_p);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Execute NMT state command
+
+The function changes the NMT state of an emulated CN according to a plain NMT
+state command. Reset commands restart the CN in NotActive after its reset
+time. CNs in their reset time ignore all commands.
+
+\param  pNode_p             Pointer to the emulated CN.
+\param  nmtCommand_p        Plain NMT state command.
+\param  now_p               Time of the reception [ns].
+*/
+//------------------------------------------------------------------------------
+static void executeNmtCommand(tEmuNode* pNode_p, UINT8 nmtCommand_p, UINT64 now_p)
+{
+    if (isSilent(pNode_p, now_p))
+        return;
+
+    switch (nmtCommand_p)
+    {
+        case 0x21:  // StartNode
+            if (pNode_p->nmtState == kNmtCsReadyToOperate)
+                pNode_p->nmtState = kNmtCsOperational;
+            break;
+
+        case 0x22:  // StopNode
+            if ((pNode_p->nmtState == kNmtCsPreOperational2) ||
+                (pNode_p->nmtState == kNmtCsReadyToOperate) ||
+                (pNode_p->nmtState == kNmtCsOperational))
+                pNode_p->nmtState = kNmtCsStopped;
+            break;
+
+        case 0x23:  // EnterPreOperational2
+            if ((pNode_p->nmtState == kNmtCsOperational) ||
+                (pNode_p->nmtState == kNmtCsStopped))
+                pNode_p->nmtState = kNmtCsPreOperational2;
+            break;
+
+        case 0x24:  // EnableReadyToOperate
+            if (pNode_p->nmtState == kNmtCsPreOperational2)
+                pNode_p->nmtState = kNmtCsReadyToOperate;
+            break;
+
+        case 0x28:  // ResetNode
+        case 0x29:  // ResetCommunication
+        case 0x2A:  // ResetConfiguration
+        case 0x2B:  // SwReset
+            resetNode(pNode_p, now_p);
+            pNode_p->statistics.resetCount++;
+            break;
+
+        default:
+            return;
+    }
+
+    pNode_p->statistics.nmtCmdCount++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process SDO frame
+
+The function implements the server side of the SDO sequence layer of an
+emulated CN. It answers the connection initialization, acknowledges the
+frames of the client and passes new commands to processSdoCommand().
+
+\param  pFrame_p            Pointer to the SDO frame.
+\param  frameSize_p         Size of the frame.
+\param  now_p               Time of the reception [ns].
+*/
+//------------------------------------------------------------------------------
+static void processSdo(tPlkFrame* pFrame_p, UINT frameSize_p, UINT64 now_p)
+{
+    UINT            nodeId = ami_getUint8Le(&pFrame_p->dstNodeId);
+    UINT            mnNodeId = ami_getUint8Le(&pFrame_p->srcNodeId);
+    tAsySdoSeq*     pSeq = &pFrame_p->data.asnd.payload.sdoSequenceFrame;
+    tEmuNode*       pNode;
+    UINT8           recvSeqNumCon;
+    UINT8           sendSeqNumCon;
+    UINT64          readyTime;
+
+    if ((nodeId == 0) || (nodeId > EMU_MAX_NODE_ID) ||
+        (frameSize_p < EMU_SDO_CMD_OFFSET))
+        return;
+
+    pNode = emuInstance_l.apNode[nodeId];
+    if ((pNode == NULL) || (pNode->nmtState == kNmtCsNotActive))
+        return;
+
+    pNode->statistics.sdoRxCount++;
+    readyTime = now_p + ((UINT64)pNode->config.sdoDelayUs * 1000ULL);
+    recvSeqNumCon = ami_getUint8Le(&pSeq->recvSeqNumCon);
+    sendSeqNumCon = ami_getUint8Le(&pSeq->sendSeqNumCon);
+
+    switch (sendSeqNumCon & EMU_SDO_CON_MASK)
+    {
+        case 0:
+            // connection closed by the client
+            pNode->sdoState = EMU_SDO_STATE_IDLE;
+            break;
+
+        case 1:
+            // initialization request (scon = 1, rcon = 0), answer with scon = 1, rcon = 1
+            if ((recvSeqNumCon & EMU_SDO_CON_MASK) != 0)
+                break;
+
+            pNode->sdoRecvSeqNumCon = sendSeqNumCon;
+            pNode->sdoSendSeqNumCon = (recvSeqNumCon & EMU_SDO_SEQ_NUM_MASK) | 1;
+            pNode->sdoState = EMU_SDO_STATE_INIT;
+            queueSdoFrame(pNode, mnNodeId, NULL, 0, readyTime);
+            break;
+
+        default:
+            if (pNode->sdoState == EMU_SDO_STATE_INIT)
+            {   // connection confirmed (scon = 2, rcon = 1), answer with scon = 2, rcon = 2
+                if ((recvSeqNumCon & EMU_SDO_CON_MASK) != 1)
+                    break;
+
+                pNode->sdoRecvSeqNumCon = (sendSeqNumCon & EMU_SDO_SEQ_NUM_MASK) | 2;
+                pNode->sdoSendSeqNumCon = (recvSeqNumCon & EMU_SDO_SEQ_NUM_MASK) | 2;
+                pNode->sdoState = EMU_SDO_STATE_CONNECTED;
+                queueSdoFrame(pNode, mnNodeId, NULL, 0, readyTime);
+                break;
+            }
+
+            if (pNode->sdoState != EMU_SDO_STATE_CONNECTED)
+                break;
+
+            if ((recvSeqNumCon & EMU_SDO_CON_MASK) == 3)
+            {   // the client missed the last response, send it again
+                if ((pNode->sdoLastResponse.frameSize != 0) &&
+                    (pNode->sdoQueueCount < EMU_SDO_QUEUE_SIZE))
+                {
+                    pNode->aSdoQueue[(pNode->sdoQueueRead + pNode->sdoQueueCount) % EMU_SDO_QUEUE_SIZE] =
+                        pNode->sdoLastResponse;
+                    pNode->aSdoQueue[(pNode->sdoQueueRead + pNode->sdoQueueCount) % EMU_SDO_QUEUE_SIZE].readyTime =
+                        readyTime;
+                    pNode->sdoQueueCount++;
+                }
+            }
+
+            if (((sendSeqNumCon & EMU_SDO_SEQ_NUM_MASK) ==
+                 ((pNode->sdoRecvSeqNumCon + 4) & EMU_SDO_SEQ_NUM_MASK)) &&
+                (frameSize_p > EMU_SDO_DATA_OFFSET))
+            {   // next frame of the client, it carries a command
+                pNode->sdoRecvSeqNumCon = (sendSeqNumCon & EMU_SDO_SEQ_NUM_MASK) | 2;
+                if (processSdoCommand(pNode, mnNodeId, &pSeq->sdoSeqPayload,
+                                      frameSize_p - EMU_SDO_CMD_OFFSET, readyTime))
+                    break;
+            }
+
+            if ((sendSeqNumCon & EMU_SDO_CON_MASK) == 3)
+            {   // acknowledge requested
+                queueSdoFrame(pNode, mnNodeId, NULL, 0, readyTime);
+            }
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process SDO command
+
+The function implements the SDO command layer of an emulated CN. Write
+commands are accepted, only the configuration date and time are stored.
+ReadByIndex is answered for the device type, the identity object and the
+configuration date and time, other objects and commands are aborted.
+Segmented transfers are answered after the last segment.
+
+\param  pNode_p             Pointer to the emulated CN.
+\param  mnNodeId_p          Node ID of the SDO client.
+\param  pCommand_p          Pointer to the command layer of the received frame.
+\param  commandSize_p       Size of the command layer including padding.
+\param  readyTime_p         Time when the response is ready [ns].
+
+\return The function returns TRUE if a response was queued.
+*/
+//------------------------------------------------------------------------------
+static BOOL processSdoCommand(tEmuNode* pNode_p, UINT mnNodeId_p, tAsySdoCom* pCommand_p,
+                              UINT commandSize_p, UINT64 readyTime_p)
+{
+    tAsySdoCom  response;
+    tAsySdoCom* pResponse = &response;
+    UINT8       flags = ami_getUint8Le(&pCommand_p->flags);
+    UINT8       commandId = ami_getUint8Le(&pCommand_p->commandId);
+    UINT        segmentSize = ami_getUint16Le(&pCommand_p->segmentSizeLe);
+    UINT        dataSize = 0;
+    UINT32      abortCode = 0;
+    UINT32      value;
+
+    if ((flags & SDO_CMDL_FLAG_RESPONSE) != 0)
+        return FALSE;
+
+    // intermediate segments are not answered, the data is not stored
+    if (((flags & SDO_CMDL_FLAG_SEGM_MASK) == SDO_CMDL_FLAG_SEGMINIT) ||
+        ((flags & SDO_CMDL_FLAG_SEGM_MASK) == SDO_CMDL_FLAG_SEGMENTED))
+        return FALSE;
+
+    memset(&response, 0, sizeof(response));
+    ami_setUint8Le(&pResponse->transactionId, ami_getUint8Le(&pCommand_p->transactionId));
+    ami_setUint8Le(&pResponse->commandId, commandId);
+
+    switch (commandId)
+    {
+        case kSdoServiceWriteByIndex:
+            if (((flags & SDO_CMDL_FLAG_SEGM_MASK) == SDO_CMDL_FLAG_EXPEDITED) &&
+                (segmentSize > SDO_CMDL_HDR_WRITEBYINDEX_SIZE) &&
+                (commandSize_p >= SDO_CMDL_HDR_FIXED_SIZE + segmentSize))
+            {
+                writeObject(pNode_p, ami_getUint16Le(&pCommand_p->aCommandData[0]),
+                            ami_getUint8Le(&pCommand_p->aCommandData[2]),
+                            &pCommand_p->aCommandData[SDO_CMDL_HDR_WRITEBYINDEX_SIZE],
+                            segmentSize - SDO_CMDL_HDR_WRITEBYINDEX_SIZE);
+            }
+            break;
+
+        case kSdoServiceWriteMultiByIndex:
+            break;
+
+        case kSdoServiceReadByIndex:
+            if ((commandSize_p < SDO_CMDL_HDR_FIXED_SIZE + SDO_CMDL_HDR_READBYINDEX_SIZE) ||
+                !readObject(pNode_p, ami_getUint16Le(&pCommand_p->aCommandData[0]),
+                            ami_getUint8Le(&pCommand_p->aCommandData[2]), &value, &dataSize))
+            {
+                abortCode = SDO_AC_OBJECT_NOT_EXIST;
+                break;
+            }
+
+            ami_setUint32Le(&pResponse->aCommandData[0], value);
+            break;
+
+        default:
+            abortCode = SDO_AC_UNKNOWN_COMMAND_SPECIFIER;
+            break;
+    }
+
+    if (abortCode != 0)
+    {
+        ami_setUint8Le(&pResponse->flags, SDO_CMDL_FLAG_RESPONSE | SDO_CMDL_FLAG_ABORT);
+        ami_setUint32Le(&pResponse->aCommandData[0], abortCode);
+        dataSize = sizeof(abortCode);
+    }
+    else
+    {
+        ami_setUint8Le(&pResponse->flags, SDO_CMDL_FLAG_RESPONSE);
+    }
+    ami_setUint16Le(&pResponse->segmentSizeLe, (UINT16)dataSize);
+
+    // a response is a new frame of the server sequence
+    pNode_p->sdoSendSeqNumCon = (UINT8)((pNode_p->sdoSendSeqNumCon + 4) & EMU_SDO_SEQ_NUM_MASK) | 2;
+    queueSdoFrame(pNode_p, mnNodeId_p, pResponse, SDO_CMDL_HDR_FIXED_SIZE + dataSize, readyTime_p);
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Queue SDO frame
+
+The function builds an SDO frame with the current sequence layer header of an
+emulated CN and queues it until the CN is invited. Command responses are also
+kept for retransmissions.
+
+\param  pNode_p             Pointer to the emulated CN.
+\param  mnNodeId_p          Node ID of the SDO client.
+\param  pCommand_p          Pointer to the command layer or NULL for an
+                            acknowledge.
+\param  commandSize_p       Size of the command layer.
+\param  readyTime_p         Time when the frame is ready [ns].
+*/
+//------------------------------------------------------------------------------
+static void queueSdoFrame(tEmuNode* pNode_p, UINT mnNodeId_p, tAsySdoCom* pCommand_p,
+                          UINT commandSize_p, UINT64 readyTime_p)
+{
+    tEmuSdoFrame*   pSdoFrame;
+    tPlkFrame*      pFrame;
+    UINT            frameSize = EMU_SDO_CMD_OFFSET + commandSize_p;
+
+    if (pNode_p->sdoQueueCount >= EMU_SDO_QUEUE_SIZE)
+    {   // a real CN would stall, the client recovers by its retransmissions
+        emuInstance_l.statistics.overrunCount++;
+        return;
+    }
+
+    if (frameSize < EMU_MIN_FRAME_SIZE)
+        frameSize = EMU_MIN_FRAME_SIZE;
+
+    pSdoFrame = &pNode_p->aSdoQueue[(pNode_p->sdoQueueRead + pNode_p->sdoQueueCount) % EMU_SDO_QUEUE_SIZE];
+    memset(pSdoFrame->aFrame, 0, frameSize);
+    setupFrameHeader(pSdoFrame->aFrame, pNode_p->nodeId, kMsgTypeAsnd, mnNodeId_p);
+
+    pFrame = (tPlkFrame*)pSdoFrame->aFrame;
+    ami_setUint8Le(&pFrame->data.asnd.serviceId, kDllAsndSdo);
+    ami_setUint8Le(&pFrame->data.asnd.payload.sdoSequenceFrame.recvSeqNumCon, pNode_p->sdoRecvSeqNumCon);
+    ami_setUint8Le(&pFrame->data.asnd.payload.sdoSequenceFrame.sendSeqNumCon, pNode_p->sdoSendSeqNumCon);
+    if (pCommand_p != NULL)
+        memcpy(&pSdoFrame->aFrame[EMU_SDO_CMD_OFFSET], pCommand_p, commandSize_p);
+
+    pSdoFrame->frameSize = frameSize;
+    pSdoFrame->readyTime = readyTime_p;
+    pNode_p->sdoQueueCount++;
+
+    if (pCommand_p != NULL)
+        pNode_p->sdoLastResponse = *pSdoFrame;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read object of an emulated CN
+
+The function returns the value of an object of an emulated CN. Only the
+device type, the identity object and the configuration date and time are
+emulated.
+
+\param  pNode_p             Pointer to the emulated CN.
+\param  index_p             Object index.
+\param  subIndex_p          Object sub-index.
+\param  pValue_p            Pointer to store the value.
+\param  pSize_p             Pointer to store the size of the value.
+
+\return The function returns TRUE if the object exists.
+*/
+//------------------------------------------------------------------------------
+static BOOL readObject(const tEmuNode* pNode_p, UINT index_p, UINT subIndex_p,
+                       UINT32* pValue_p, UINT* pSize_p)
+{
+    *pSize_p = sizeof(UINT32);
+
+    switch ((index_p << 8) | subIndex_p)
+    {
+        case 0x100000:
+            *pValue_p = pNode_p->config.deviceType;
+            return TRUE;
+
+        case 0x101800:
+            *pValue_p = 4;
+            *pSize_p = sizeof(UINT8);
+            return TRUE;
+
+        case 0x101801:
+            *pValue_p = pNode_p->config.vendorId;
+            return TRUE;
+
+        case 0x101802:
+            *pValue_p = pNode_p->config.productCode;
+            return TRUE;
+
+        case 0x101803:
+            *pValue_p = pNode_p->config.revisionNumber;
+            return TRUE;
+
+        case 0x101804:
+            *pValue_p = pNode_p->config.serialNumber + pNode_p->nodeId;
+            return TRUE;
+
+        case 0x102000:
+            *pValue_p = 2;
+            *pSize_p = sizeof(UINT8);
+            return TRUE;
+
+        case 0x102001:
+            *pValue_p = pNode_p->config.confDate;
+            return TRUE;
+
+        case 0x102002:
+            *pValue_p = pNode_p->config.confTime;
+            return TRUE;
+
+        default:
+            return FALSE;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write object of an emulated CN
+
+The function stores the configuration date and time written by the
+configuration manager of the MN, so the MN finds the CN configured after the
+next reset. Other objects are not stored.
+
+\param  pNode_p             Pointer to the emulated CN.
+\param  index_p             Object index.
+\param  subIndex_p          Object sub-index.
+\param  pData_p             Pointer to the written data.
+\param  size_p              Size of the written data.
+*/
+//------------------------------------------------------------------------------
+static void writeObject(tEmuNode* pNode_p, UINT index_p, UINT subIndex_p,
+                        UINT8* pData_p, UINT size_p)
+{
+    if ((index_p != 0x1020) || (size_p < sizeof(UINT32)))
+        return;
+
+    if (subIndex_p == 1)
+        pNode_p->config.confDate = ami_getUint32Le(pData_p);
+    else if (subIndex_p == 2)
+        pNode_p->config.confTime = ami_getUint32Le(pData_p);
+    else
+        return;
+
+    setupIdentResFrame(pNode_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Emulation thread
+
+This function is the emulation thread. It receives the frames of the network
+and lets the emulated CNs process them. The responses are sent from this
+thread at their due times.
+
+\param  pArgument_p     User specific pointer pointing to the instance structure
+
+\return The function returns a thread error code.
+*/
+//------------------------------------------------------------------------------
+static void* emulationThread(void* pArgument_p)
+{
+    tEmuInstance*   pInstance = (tEmuInstance*)pArgument_p;
+    int             frameSize;
+
+    while (!pInstance->fStopThread)
+    {
+        frameSize = netif_receive(pInstance->aRxFrame, sizeof(pInstance->aRxFrame));
+        if (frameSize < 0)
+            break;
+
+        if (frameSize > 0)
+            processFrame((tPlkFrame*)pInstance->aRxFrame, (UINT)frameSize, getTimeNs());
+    }
+
+    return NULL;
+}
+
+///\}
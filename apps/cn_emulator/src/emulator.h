@@ -0,0 +1,157 @@
+/**
+********************************************************************************
+\file   emulator.h
+
+\brief  Definitions for the CN emulator
+
+The file contains the definitions of the CN emulator. The emulator answers the
+frames of an MN for a set of emulated CNs on a real network interface.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_emulator_H_
+#define _INC_emulator_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <oplk/nmt.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define EMU_MAX_NODE_ID                 239                 ///< Maximum node ID of an emulated CN
+#define EMU_MAX_PAYLOAD_SIZE            C_DLL_ISOCHR_MAX_PAYL   ///< Maximum PReq and PRes payload size
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+/**
+\brief  Configuration of an emulated CN
+
+The structure contains the configuration of one emulated CN. The latencies are
+measured from the reception of the request by the emulator to the start of the
+transmission of the response.
+*/
+typedef struct
+{
+    UINT                preqPayloadSize;    ///< PReq payload size reported in the IdentResponse
+    UINT                presPayloadSize;    ///< Payload size of the PRes
+    UINT                pdoVersion;         ///< PDO version of the PRes
+    BOOL                fPresCounter;       ///< The first 4 bytes of the PRes payload count the PRes frames
+    UINT32              presLatencyNs;      ///< Latency of the PRes after the PReq [ns]
+    UINT32              asndLatencyNs;      ///< Latency of an ASnd frame after the SoA [ns]
+    UINT32              sdoDelayUs;         ///< Processing time of an SDO command until the response is pending [us]
+    UINT32              resetTimeUs;        ///< Time the CN is silent after a reset command [us]
+    UINT                presLossPerMille;   ///< Probability that a PRes is lost [1/1000]
+    UINT                presLatePerMille;   ///< Probability that a PRes is late [1/1000]
+    UINT32              presLateNs;         ///< Additional latency of a late PRes [ns]
+    UINT32              muteAfter;          ///< Number of PReqs in Operational after which the CN falls silent (0 = never)
+    UINT32              muteCount;          ///< Number of PReqs the CN stays silent (0 = until it is reset)
+    UINT32              deviceType;         ///< Device type reported in the IdentResponse and object 0x1000
+    UINT32              vendorId;           ///< Vendor ID reported in the IdentResponse and object 0x1018/1
+    UINT32              productCode;        ///< Product code reported in the IdentResponse and object 0x1018/2
+    UINT32              revisionNumber;     ///< Revision number reported in the IdentResponse and object 0x1018/3
+    UINT32              serialNumber;       ///< Serial number base, the node ID is added (object 0x1018/4)
+    UINT32              confDate;           ///< Configuration date reported in the IdentResponse (object 0x1020/1)
+    UINT32              confTime;           ///< Configuration time reported in the IdentResponse (object 0x1020/2)
+    UINT32              featureFlags;       ///< Feature flags reported in the IdentResponse
+} tEmuNodeConfig;
+
+/**
+\brief  Configuration of the emulator
+
+The structure contains the settings which are common to all emulated CNs.
+*/
+typedef struct
+{
+    const char*         pIfName;            ///< Name of the network interface
+    UINT32              seed;               ///< Seed of the fault generators (equal seeds give equal fault patterns)
+    int                 threadPriority;     ///< SCHED_FIFO priority of the emulation thread (0 = no real-time priority)
+    int                 cpu;                ///< CPU of the emulation thread (-1 = no affinity)
+} tEmuConfig;
+
+/**
+\brief  Statistics of an emulated CN
+
+The structure contains the state and the frame counters of an emulated CN.
+*/
+typedef struct
+{
+    tNmtState           nmtState;           ///< Current NMT state
+    UINT32              presCount;          ///< Number of transmitted PRes frames
+    UINT32              presLossCount;      ///< Number of dropped PRes frames
+    UINT32              presLateCount;      ///< Number of PRes frames sent with the additional latency
+    UINT32              presMuteCount;      ///< Number of PReqs not answered because the CN was silent
+    UINT32              identResCount;      ///< Number of transmitted IdentResponses
+    UINT32              statusResCount;     ///< Number of transmitted StatusResponses
+    UINT32              sdoRxCount;         ///< Number of received SDO frames
+    UINT32              sdoTxCount;         ///< Number of transmitted SDO frames
+    UINT32              nmtCmdCount;        ///< Number of executed NMT state commands
+    UINT32              resetCount;         ///< Number of executed reset commands
+} tEmuNodeStatistics;
+
+/**
+\brief  Statistics of the emulator
+
+The structure contains the frame counters of the emulator.
+*/
+typedef struct
+{
+    UINT64              rxFrameCount;       ///< Number of received POWERLINK frames
+    UINT64              txFrameCount;       ///< Number of transmitted frames
+    UINT64              txErrorCount;       ///< Number of frames which couldn't be transmitted
+    UINT64              socCount;           ///< Number of received SoC frames
+    UINT64              overrunCount;       ///< Number of SDO frames dropped because the queue of the CN was full
+    UINT64              lateTxCount;        ///< Number of responses whose due time had passed before they were sent
+    UINT32              maxTxDelayNs;       ///< Maximum delay of a transmission after its due time [ns]
+} tEmuStatistics;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+tOplkError emulator_init(const tEmuConfig* pConfig_p, const tEmuNodeConfig* aNodeConfig_p,
+                         const BOOL* afEnabled_p);
+void       emulator_exit(void);
+tOplkError emulator_start(void);
+void       emulator_stop(void);
+BOOL       emulator_getNodeStatistics(UINT nodeId_p, tEmuNodeStatistics* pStatistics_p);
+void       emulator_getStatistics(tEmuStatistics* pStatistics_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_emulator_H_ */
@@ -0,0 +1,395 @@
+/**
+********************************************************************************
+\file   main.c
+
+\brief  Main file of the CN emulator
+
+This file contains the main file of the openPOWERLINK CN emulator. The
+emulator answers an MN on a real network interface for many CNs at once to
+test the MN under load.
+
+\ingroup module_cn_emulator
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oplk/oplkinc.h>
+#include <system/system.h>
+#include <getopt/getopt.h>
+#include <console/console.h>
+
+#include "emulator.h"
+#include "nodecfg.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define DEFAULT_THREAD_PRIORITY     80
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tEmuNodeConfig   aNodeConfig_l[EMU_MAX_NODE_ID + 1];
+static BOOL             afEnabled_l[EMU_MAX_NODE_ID + 1];
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static int getOptions(int argc_p, char** argv_p, tEmuConfig* pConfig_p);
+static void loopMain(void);
+static void printStatistics(void);
+static void printNodeStatistics(void);
+static const char* getNmtStateName(tNmtState nmtState_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  main function
+
+This is the main function of the CN emulator.
+
+\param  argc                    Number of arguments
+\param  argv                    Pointer to argument strings
+
+\return Returns an exit code
+
+\ingroup module_cn_emulator
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    tOplkError      ret;
+    tEmuConfig      config;
+    UINT            nodeId;
+
+    for (nodeId = 0; nodeId <= EMU_MAX_NODE_ID; nodeId++)
+        nodecfg_setDefault(&aNodeConfig_l[nodeId]);
+
+    if (getOptions(argc, argv, &config) != 0)
+        return 1;
+
+    if (initSystem() < 0)
+    {
+        printf("Error initializing system!");
+        return 1;
+    }
+
+    printf("----------------------------------------------------\n");
+    printf("openPOWERLINK CN emulator\n");
+    printf("using openPOWERLINK Stack: %s\n", PLK_DEFINED_STRING_VERSION);
+    printf("----------------------------------------------------\n");
+
+    ret = emulator_init(&config, aNodeConfig_l, afEnabled_l);
+    if (ret != kErrorOk)
+    {
+        printf("emulator_init() failed (Error:0x%x)!\n", ret);
+        goto Exit;
+    }
+
+    ret = emulator_start();
+    if (ret != kErrorOk)
+    {
+        printf("emulator_start() failed (Error:0x%x)!\n", ret);
+        emulator_exit();
+        goto Exit;
+    }
+
+    loopMain();
+
+    emulator_stop();
+    printStatistics();
+    emulator_exit();
+
+Exit:
+    shutdownSystem();
+
+    return (ret == kErrorOk) ? 0 : 1;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Main loop of the CN emulator
+
+This function implements the main loop of the CN emulator. It reacts on
+commands from the command line while the emulation thread answers the MN.
+*/
+//------------------------------------------------------------------------------
+static void loopMain(void)
+{
+    char    cKey = 0;
+    BOOL    fExit = FALSE;
+
+    printf("\n-------------------------------\n");
+    printf("Press Esc to leave the program\n");
+    printf("Press s to print the statistics\n");
+    printf("Press n to print the node statistics\n");
+    printf("-------------------------------\n\n");
+
+    while (!fExit)
+    {
+        if (console_kbhit())
+        {
+            cKey = (char)console_getch();
+
+            switch (cKey)
+            {
+                case 's':
+                    printStatistics();
+                    break;
+
+                case 'n':
+                    printNodeStatistics();
+                    break;
+
+                case 0x1B:
+                    fExit = TRUE;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        if (system_getTermSignalState() == TRUE)
+        {
+            fExit = TRUE;
+            printf("Received termination signal, exiting...\n");
+        }
+
+        msleep(100);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print emulator statistics
+
+The function prints the frame counters of the emulator.
+*/
+//------------------------------------------------------------------------------
+static void printStatistics(void)
+{
+    tEmuStatistics  statistics;
+
+    emulator_getStatistics(&statistics);
+
+    printf("Received frames:    %llu\n", (unsigned long long)statistics.rxFrameCount);
+    printf("Transmitted frames: %llu\n", (unsigned long long)statistics.txFrameCount);
+    printf("Transmit errors:    %llu\n", (unsigned long long)statistics.txErrorCount);
+    printf("SoC frames:         %llu\n", (unsigned long long)statistics.socCount);
+    printf("SDO queue overruns: %llu\n", (unsigned long long)statistics.overrunCount);
+    printf("Late responses:     %llu\n", (unsigned long long)statistics.lateTxCount);
+    printf("Max. tx delay:      %lu ns\n", (unsigned long)statistics.maxTxDelayNs);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print node statistics
+
+The function prints the NMT state and the frame counters of each emulated CN.
+*/
+//------------------------------------------------------------------------------
+static void printNodeStatistics(void)
+{
+    tEmuNodeStatistics  statistics;
+    UINT                nodeId;
+
+    printf("%4s %-18s %10s %8s %8s %8s %6s %6s %8s %8s %6s %6s\n",
+           "Node", "NMT state", "PRes", "Lost", "Late", "Muted",
+           "Ident", "Status", "SDO rx", "SDO tx", "NMT", "Reset");
+
+    for (nodeId = 1; nodeId <= EMU_MAX_NODE_ID; nodeId++)
+    {
+        if (!emulator_getNodeStatistics(nodeId, &statistics))
+            continue;
+
+        printf("%4u %-18s %10lu %8lu %8lu %8lu %6lu %6lu %8lu %8lu %6lu %6lu\n",
+               nodeId, getNmtStateName(statistics.nmtState),
+               (unsigned long)statistics.presCount, (unsigned long)statistics.presLossCount,
+               (unsigned long)statistics.presLateCount, (unsigned long)statistics.presMuteCount,
+               (unsigned long)statistics.identResCount, (unsigned long)statistics.statusResCount,
+               (unsigned long)statistics.sdoRxCount, (unsigned long)statistics.sdoTxCount,
+               (unsigned long)statistics.nmtCmdCount, (unsigned long)statistics.resetCount);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get name of an NMT state
+
+\param  nmtState_p              NMT state of an emulated CN.
+
+\return The function returns the name of the NMT state.
+*/
+//------------------------------------------------------------------------------
+static const char* getNmtStateName(tNmtState nmtState_p)
+{
+    switch (nmtState_p)
+    {
+        case kNmtCsNotActive:
+            return "NotActive";
+
+        case kNmtCsPreOperational1:
+            return "PreOperational1";
+
+        case kNmtCsPreOperational2:
+            return "PreOperational2";
+
+        case kNmtCsReadyToOperate:
+            return "ReadyToOperate";
+
+        case kNmtCsOperational:
+            return "Operational";
+
+        case kNmtCsStopped:
+            return "Stopped";
+
+        default:
+            return "Unknown";
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get command line parameters
+
+The function parses the supplied command line parameters and stores the
+options at pConfig_p. The node configuration file and the node
+specifications are applied in the order of the command line.
+
+\param  argc_p                  Argument count.
+\param  argv_p                  Pointer to arguments.
+\param  pConfig_p               Pointer to store the emulator configuration.
+
+\return The function returns the parsing status.
+\retval 0           Successfully parsed
+\retval -1          Parsing error
+*/
+//------------------------------------------------------------------------------
+static int getOptions(int argc_p, char** argv_p, tEmuConfig* pConfig_p)
+{
+    int         opt;
+    tOplkError  ret = kErrorOk;
+
+    /* setup default parameters */
+    memset(pConfig_p, 0, sizeof(*pConfig_p));
+    pConfig_p->seed = 1;
+    pConfig_p->threadPriority = DEFAULT_THREAD_PRIORITY;
+    pConfig_p->cpu = -1;
+
+    /* get command line parameters */
+    while ((opt = getopt(argc_p, argv_p, "i:f:n:s:p:c:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'i':
+                pConfig_p->pIfName = optarg;
+                break;
+
+            case 'f':
+                ret = nodecfg_loadFile(optarg, aNodeConfig_l, afEnabled_l);
+                break;
+
+            case 'n':
+                ret = nodecfg_parseSpec(optarg, aNodeConfig_l, afEnabled_l);
+                break;
+
+            case 's':
+                pConfig_p->seed = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'p':
+                pConfig_p->threadPriority = (int)strtol(optarg, NULL, 10);
+                break;
+
+            case 'c':
+                pConfig_p->cpu = (int)strtol(optarg, NULL, 10);
+                break;
+
+            default: /* '?' */
+                ret = kErrorApiInvalidParam;
+                break;
+        }
+
+        if (ret != kErrorOk)
+            break;
+    }
+
+    if ((ret != kErrorOk) || (pConfig_p->pIfName == NULL))
+    {
+        fprintf(stderr, "Usage: %s -i INTERFACE [-f NODE_FILE] [-n NODE_SPEC]... "
+                        "[-s SEED] [-p PRIORITY] [-c CPU]\n", argv_p[0]);
+        fprintf(stderr, "NODE_SPEC: NODE_ID[-NODE_ID] [key=value]..., e.g. \"1-100 pres=64 drop=5\"\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+///\}
@@ -0,0 +1,286 @@
+/**
+********************************************************************************
+\file   netif-linux.c
+
+\brief  Network interface of the CN emulator for Linux
+
+The file implements the network interface of the CN emulator with a Linux
+packet socket. The socket receives all POWERLINK frames of the interface and
+transmits the frames of the emulated CNs with their own source MAC addresses.
+
+\ingroup module_cn_emulator
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <linux/if_packet.h>
+#include <linux/if_ether.h>
+
+#include "netif.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define NETIF_RX_TIMEOUT_US             100000              // Receive timeout to check for the termination of the caller
+#define NETIF_ETHERTYPE_PLK             0x88AB              // POWERLINK ethertype
+
+#ifndef PACKET_QDISC_BYPASS
+#define PACKET_QDISC_BYPASS             20
+#endif
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+typedef struct
+{
+    BOOL                fOpen;              ///< The socket is open
+    int                 sock;               ///< Packet socket
+    struct sockaddr_ll  txAddr;             ///< Link layer address for transmissions
+} tNetifInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tNetifInstance   netifInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Open network interface
+
+The function opens a packet socket which receives the POWERLINK frames of the
+specified interface. The interface is put into promiscuous mode because the
+MN addresses the emulated CNs by their own MAC addresses. Frames are sent
+past the queueing discipline of the interface if the kernel supports it.
+
+\param  pIfName_p           Name of the network interface.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_cn_emulator
+*/
+//------------------------------------------------------------------------------
+tOplkError netif_open(const char* pIfName_p)
+{
+    struct sockaddr_ll  addr;
+    struct packet_mreq  mreq;
+    struct timeval      timeout;
+    int                 ifIndex;
+    int                 value;
+
+    ifIndex = if_nametoindex(pIfName_p);
+    if (ifIndex == 0)
+    {
+        fprintf(stderr, "Network interface %s not found!\n", pIfName_p);
+        return kErrorNoResource;
+    }
+
+    netifInstance_l.sock = socket(AF_PACKET, SOCK_RAW, htons(NETIF_ETHERTYPE_PLK));
+    if (netifInstance_l.sock < 0)
+    {
+        fprintf(stderr, "Couldn't open packet socket (%s)!\n", strerror(errno));
+        return kErrorNoResource;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sll_family = AF_PACKET;
+    addr.sll_protocol = htons(NETIF_ETHERTYPE_PLK);
+    addr.sll_ifindex = ifIndex;
+    if (bind(netifInstance_l.sock, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+    {
+        fprintf(stderr, "Couldn't bind packet socket to %s (%s)!\n", pIfName_p, strerror(errno));
+        goto ExitError;
+    }
+
+    memset(&mreq, 0, sizeof(mreq));
+    mreq.mr_ifindex = ifIndex;
+    mreq.mr_type = PACKET_MR_PROMISC;
+    if (setsockopt(netifInstance_l.sock, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0)
+    {
+        fprintf(stderr, "Couldn't enable promiscuous mode of %s (%s)!\n", pIfName_p, strerror(errno));
+        goto ExitError;
+    }
+
+    // the receive timeout lets the caller check its termination flag
+    timeout.tv_sec = 0;
+    timeout.tv_usec = NETIF_RX_TIMEOUT_US;
+    if (setsockopt(netifInstance_l.sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0)
+    {
+        fprintf(stderr, "Couldn't set receive timeout (%s)!\n", strerror(errno));
+        goto ExitError;
+    }
+
+    // optional, available since Linux 3.14
+    value = 1;
+    (void)setsockopt(netifInstance_l.sock, SOL_PACKET, PACKET_QDISC_BYPASS, &value, sizeof(value));
+
+    netifInstance_l.txAddr = addr;
+    netifInstance_l.txAddr.sll_halen = ETH_ALEN;
+    netifInstance_l.fOpen = TRUE;
+
+    return kErrorOk;
+
+ExitError:
+    close(netifInstance_l.sock);
+    return kErrorNoResource;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close network interface
+
+The function closes the packet socket. The promiscuous mode is left by the
+kernel when the socket is closed.
+
+\ingroup module_cn_emulator
+*/
+//------------------------------------------------------------------------------
+void netif_close(void)
+{
+    if (netifInstance_l.fOpen)
+    {
+        close(netifInstance_l.sock);
+        netifInstance_l.fOpen = FALSE;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Receive frame
+
+The function waits for the next POWERLINK frame received by the interface.
+Frames transmitted by the emulator itself are skipped.
+
+\param  pFrame_p            Pointer to the frame buffer.
+\param  size_p              Size of the frame buffer.
+
+\return The function returns the size of the received frame, 0 if no frame
+        was received within the receive timeout or -1 on an error.
+
+\ingroup module_cn_emulator
+*/
+//------------------------------------------------------------------------------
+int netif_receive(UINT8* pFrame_p, UINT size_p)
+{
+    struct sockaddr_ll  addr;
+    socklen_t           addrLen;
+    ssize_t             frameSize;
+
+    for (;;)
+    {
+        addrLen = sizeof(addr);
+        frameSize = recvfrom(netifInstance_l.sock, pFrame_p, size_p, 0,
+                             (struct sockaddr*)&addr, &addrLen);
+        if (frameSize < 0)
+        {
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR))
+                return 0;
+
+            fprintf(stderr, "Error receiving frame (%s)!\n", strerror(errno));
+            return -1;
+        }
+
+        if (addr.sll_pkttype != PACKET_OUTGOING)
+            return (int)frameSize;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send frame
+
+The function transmits a frame. The frame must contain the Ethernet header and
+must be padded to the minimum Ethernet frame size.
+
+\param  pFrame_p            Pointer to the frame.
+\param  size_p              Size of the frame without CRC.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_cn_emulator
+*/
+//------------------------------------------------------------------------------
+tOplkError netif_send(const UINT8* pFrame_p, UINT size_p)
+{
+    ssize_t     sentSize;
+
+    memcpy(netifInstance_l.txAddr.sll_addr, pFrame_p, ETH_ALEN);
+    sentSize = sendto(netifInstance_l.sock, pFrame_p, size_p, 0,
+                      (struct sockaddr*)&netifInstance_l.txAddr, sizeof(netifInstance_l.txAddr));
+    if (sentSize != (ssize_t)size_p)
+        return kErrorNoResource;
+
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+///\}
@@ -0,0 +1,431 @@
+/**
+********************************************************************************
+\file   nodecfg.c
+
+\brief  Node configuration of the CN emulator
+
+The file parses the configuration of the emulated CNs from command line
+specifications and configuration files.
+
+\ingroup module_cn_emulator
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nodecfg.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define NODECFG_MAX_LINE_LENGTH     512
+#define NODECFG_TOKEN_DELIMITERS    " \t\r\n"
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static BOOL parseNumber(const char* pString_p, char** ppEnd_p, UINT32* pValue_p);
+static BOOL parseNodeRange(const char* pToken_p, UINT* pFirst_p, UINT* pLast_p);
+static BOOL parseSetting(const char* pToken_p, tEmuNodeConfig* pConfig_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set default node configuration
+
+The function sets the default configuration of an emulated CN. It answers
+with 36 byte PDOs, like the CN demo application, and the latencies of a fast
+CN.
+
+\param  pConfig_p           Pointer to the configuration.
+
+\ingroup module_cn_emulator
+*/
+//------------------------------------------------------------------------------
+void nodecfg_setDefault(tEmuNodeConfig* pConfig_p)
+{
+    memset(pConfig_p, 0, sizeof(*pConfig_p));
+
+    pConfig_p->preqPayloadSize = 36;
+    pConfig_p->presPayloadSize = 36;
+    pConfig_p->presLatencyNs = 2000;
+    pConfig_p->asndLatencyNs = 5000;
+    pConfig_p->sdoDelayUs = 0;
+    pConfig_p->resetTimeUs = 100000;
+    pConfig_p->deviceType = 0x000F0191;
+    pConfig_p->vendorId = 0;
+    pConfig_p->productCode = 0;
+    pConfig_p->revisionNumber = 0x00010000;
+    pConfig_p->serialNumber = 0;
+    pConfig_p->featureFlags = 0x00000025;   // isochronous, SDO by ASnd, NMT info services
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse node specification
+
+The function parses a node specification and applies it to the addressed
+CNs. A specification consists of a node ID or a range of node IDs, e.g. 1 or
+1-100, followed by settings in the form key=value:
+
+ key         | value
+ ------------| ---------------------------------------------------------------
+ preq        | PReq payload size
+ pres        | PRes payload size
+ pdover      | PDO version of the PRes
+ counter     | 1 to count the PRes frames in the first 4 payload bytes
+ latency     | PRes latency [us]
+ asndlatency | ASnd latency [us]
+ sdodelay    | Processing time of SDO commands [us]
+ reset       | Silent time after a reset command [ms]
+ drop        | Probability of a lost PRes [1/1000]
+ late        | Probability of a late PRes [1/1000] and its additional latency [us], e.g. late=5:200
+ mute        | Number of PReqs in Operational before falling silent and number of silent PReqs, e.g. mute=1000:50
+ devtype     | Device type
+ vendor      | Vendor ID
+ product     | Product code
+ revision    | Revision number
+ serial      | Serial number base, the node ID is added
+ confdate    | Configuration date
+ conftime    | Configuration time
+ features    | Feature flags
+
+Numbers can be decimal, hexadecimal (0x) or octal (0). Settings of later
+specifications override settings of earlier ones.
+
+\param  pSpec_p             Node specification.
+\param  aConfig_p           Configurations of the CNs indexed by their node ID.
+\param  afEnabled_p         Flags of the emulated CNs indexed by their node ID.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_cn_emulator
+*/
+//------------------------------------------------------------------------------
+tOplkError nodecfg_parseSpec(const char* pSpec_p, tEmuNodeConfig* aConfig_p, BOOL* afEnabled_p)
+{
+    char            aSpec[NODECFG_MAX_LINE_LENGTH];
+    char*           pToken;
+    char*           pSave = NULL;
+    UINT            first;
+    UINT            last;
+    UINT            nodeId;
+    tEmuNodeConfig  config;
+
+    if (strlen(pSpec_p) >= sizeof(aSpec))
+    {
+        fprintf(stderr, "Node specification is too long!\n");
+        return kErrorApiInvalidParam;
+    }
+    strcpy(aSpec, pSpec_p);
+
+    pToken = strtok_r(aSpec, NODECFG_TOKEN_DELIMITERS, &pSave);
+    if (pToken == NULL)
+        return kErrorOk;
+
+    if (!parseNodeRange(pToken, &first, &last))
+    {
+        fprintf(stderr, "Invalid node ID range '%s'!\n", pToken);
+        return kErrorApiInvalidParam;
+    }
+
+    // the settings are first parsed into a copy to leave the CNs unchanged on errors
+    for (nodeId = first; nodeId <= last; nodeId++)
+    {
+        config = aConfig_p[nodeId];
+        pSave = NULL;
+        strcpy(aSpec, pSpec_p);
+        strtok_r(aSpec, NODECFG_TOKEN_DELIMITERS, &pSave);
+
+        while ((pToken = strtok_r(NULL, NODECFG_TOKEN_DELIMITERS, &pSave)) != NULL)
+        {
+            if (!parseSetting(pToken, &config))
+            {
+                fprintf(stderr, "Invalid setting '%s'!\n", pToken);
+                return kErrorApiInvalidParam;
+            }
+        }
+
+        aConfig_p[nodeId] = config;
+        afEnabled_p[nodeId] = TRUE;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Load node configuration file
+
+The function reads a node configuration file. Each line contains a node
+specification as parsed by nodecfg_parseSpec(). Empty lines and lines
+starting with '#' are ignored.
+
+\param  pFileName_p         Name of the configuration file.
+\param  aConfig_p           Configurations of the CNs indexed by their node ID.
+\param  afEnabled_p         Flags of the emulated CNs indexed by their node ID.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_cn_emulator
+*/
+//------------------------------------------------------------------------------
+tOplkError nodecfg_loadFile(const char* pFileName_p, tEmuNodeConfig* aConfig_p, BOOL* afEnabled_p)
+{
+    FILE*       pFile;
+    char        aLine[NODECFG_MAX_LINE_LENGTH];
+    char*       pLine;
+    UINT        lineNumber = 0;
+    tOplkError  ret = kErrorOk;
+
+    pFile = fopen(pFileName_p, "r");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "Couldn't open node configuration file '%s'!\n", pFileName_p);
+        return kErrorNoResource;
+    }
+
+    while (fgets(aLine, sizeof(aLine), pFile) != NULL)
+    {
+        lineNumber++;
+
+        pLine = aLine + strspn(aLine, NODECFG_TOKEN_DELIMITERS);
+        if ((*pLine == '\0') || (*pLine == '#'))
+            continue;
+
+        ret = nodecfg_parseSpec(pLine, aConfig_p, afEnabled_p);
+        if (ret != kErrorOk)
+        {
+            fprintf(stderr, "Error in line %u of '%s'!\n", lineNumber, pFileName_p);
+            break;
+        }
+    }
+
+    fclose(pFile);
+    return ret;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse number
+
+\param  pString_p           String starting with the number.
+\param  ppEnd_p             Pointer to store the end of the number.
+\param  pValue_p            Pointer to store the number.
+
+\return The function returns TRUE if a number was parsed.
+*/
+//------------------------------------------------------------------------------
+static BOOL parseNumber(const char* pString_p, char** ppEnd_p, UINT32* pValue_p)
+{
+    unsigned long   value;
+
+    if ((*pString_p < '0') || (*pString_p > '9'))
+        return FALSE;
+
+    value = strtoul(pString_p, ppEnd_p, 0);
+    if ((*ppEnd_p == pString_p) || (value > 0xFFFFFFFFUL))
+        return FALSE;
+
+    *pValue_p = (UINT32)value;
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse node ID range
+
+\param  pToken_p            Token with a node ID or a range of node IDs.
+\param  pFirst_p            Pointer to store the first node ID.
+\param  pLast_p             Pointer to store the last node ID.
+
+\return The function returns TRUE if the range is valid.
+*/
+//------------------------------------------------------------------------------
+static BOOL parseNodeRange(const char* pToken_p, UINT* pFirst_p, UINT* pLast_p)
+{
+    char*   pEnd;
+    UINT32  first;
+    UINT32  last;
+
+    if (!parseNumber(pToken_p, &pEnd, &first))
+        return FALSE;
+
+    last = first;
+    if (*pEnd == '-')
+    {
+        if (!parseNumber(pEnd + 1, &pEnd, &last))
+            return FALSE;
+    }
+
+    if ((*pEnd != '\0') || (first == 0) || (first > last) || (last > EMU_MAX_NODE_ID))
+        return FALSE;
+
+    *pFirst_p = first;
+    *pLast_p = last;
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse setting
+
+The function parses a setting key=value and stores it in a configuration.
+
+\param  pToken_p            Token with the setting.
+\param  pConfig_p           Pointer to the configuration.
+
+\return The function returns TRUE if the setting is valid.
+*/
+//------------------------------------------------------------------------------
+static BOOL parseSetting(const char* pToken_p, tEmuNodeConfig* pConfig_p)
+{
+    const char* pValue;
+    char*       pEnd;
+    size_t      keyLength;
+    UINT32      value;
+    UINT32      value2 = 0;
+
+    pValue = strchr(pToken_p, '=');
+    if (pValue == NULL)
+        return FALSE;
+
+    keyLength = (size_t)(pValue - pToken_p);
+    pValue++;
+
+    if (!parseNumber(pValue, &pEnd, &value))
+        return FALSE;
+
+    // late and mute accept a second value separated by ':'
+    if (*pEnd == ':')
+    {
+        if (!parseNumber(pEnd + 1, &pEnd, &value2))
+            return FALSE;
+    }
+
+    if (*pEnd != '\0')
+        return FALSE;
+
+#define NODECFG_KEY(key_p)  ((keyLength == sizeof(key_p) - 1) && (strncmp(pToken_p, key_p, keyLength) == 0))
+
+    if (NODECFG_KEY("preq") && (value <= EMU_MAX_PAYLOAD_SIZE))
+        pConfig_p->preqPayloadSize = value;
+    else if (NODECFG_KEY("pres") && (value <= EMU_MAX_PAYLOAD_SIZE))
+        pConfig_p->presPayloadSize = value;
+    else if (NODECFG_KEY("pdover") && (value <= 0xFF))
+        pConfig_p->pdoVersion = value;
+    else if (NODECFG_KEY("counter"))
+        pConfig_p->fPresCounter = (value != 0);
+    else if (NODECFG_KEY("latency") && (value <= 0xFFFFFFFFUL / 1000))
+        pConfig_p->presLatencyNs = value * 1000;
+    else if (NODECFG_KEY("asndlatency") && (value <= 0xFFFFFFFFUL / 1000))
+        pConfig_p->asndLatencyNs = value * 1000;
+    else if (NODECFG_KEY("sdodelay"))
+        pConfig_p->sdoDelayUs = value;
+    else if (NODECFG_KEY("reset") && (value <= 0xFFFFFFFFUL / 1000))
+        pConfig_p->resetTimeUs = value * 1000;
+    else if (NODECFG_KEY("drop") && (value <= 1000))
+        pConfig_p->presLossPerMille = value;
+    else if (NODECFG_KEY("late") && (value <= 1000) && (value2 <= 0xFFFFFFFFUL / 1000))
+    {
+        pConfig_p->presLatePerMille = value;
+        pConfig_p->presLateNs = value2 * 1000;
+    }
+    else if (NODECFG_KEY("mute"))
+    {
+        pConfig_p->muteAfter = value;
+        pConfig_p->muteCount = value2;
+    }
+    else if (NODECFG_KEY("devtype"))
+        pConfig_p->deviceType = value;
+    else if (NODECFG_KEY("vendor"))
+        pConfig_p->vendorId = value;
+    else if (NODECFG_KEY("product"))
+        pConfig_p->productCode = value;
+    else if (NODECFG_KEY("revision"))
+        pConfig_p->revisionNumber = value;
+    else if (NODECFG_KEY("serial"))
+        pConfig_p->serialNumber = value;
+    else if (NODECFG_KEY("confdate"))
+        pConfig_p->confDate = value;
+    else if (NODECFG_KEY("conftime"))
+        pConfig_p->confTime = value;
+    else if (NODECFG_KEY("features"))
+        pConfig_p->featureFlags = value;
+    else
+        return FALSE;
+
+#undef NODECFG_KEY
+
+    return TRUE;
+}
+
+///\}
@@ -0,0 +1,620 @@
+/**
+********************************************************************************
+\file   pirecorder-linux.c
+
+\brief  Process image recorder for Linux
+
+The file implements the process image recorder for Linux. The recorder stores
+the input and output process image of every cycle in a record file.
+
+The synchronous path only copies the process images into a preallocated ring
+of snapshots. A writer thread with normal scheduling priority compresses the
+snapshots and writes them to the file, so the file I/O does not affect the
+timing of the synchronous path. If the writer thread cannot keep up, the
+snapshots of the following cycles are dropped and marked as missing.
+
+The record file consists of a header block and chunks of
+PIRECORDER_CHUNK_CYCLES cycles. All values are little endian.
+
+- Header block (PIRECORDER_BLOCK_SIZE bytes): magic "OPLKPIR" + '\0',
+  version (UINT32), size of the input process image (UINT32), size of the
+  output process image (UINT32) and cycles per chunk (UINT32).
+- Chunk: magic "PICK" (UINT32), number of cycles (UINT32), size of the cycle
+  records (UINT32), reserved (UINT32), first cycle (UINT64) and the cycle
+  records. A chunk starts at a multiple of PIRECORDER_BLOCK_SIZE.
+- Cycle record: flag (UINT8, 0 = missing, 1 = recorded), and for a recorded
+  cycle the size of the encoded data (UINT32) and the encoded data. The data
+  is the input process image followed by the output process image, XORed with
+  the previous recorded cycle of the chunk, or with zeros for the first one.
+  It is encoded in tokens: a token byte t < 0x80 stands for t + 1 zero bytes,
+  a token byte t >= 0x80 is followed by (t & 0x7F) + 1 literal bytes.
+
+The file offsets of the chunks are appended to an index file with the suffix
+".idx" as UINT64 values. Chunk n contains the cycles n * PIRECORDER_CHUNK_CYCLES
+to (n + 1) * PIRECORDER_CHUNK_CYCLES - 1, so a cycle is found by reading one
+index entry and decoding at most one chunk.
+
+\ingroup module_app_common
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
+
+#include "pirecorder.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define PIRECORDER_RING_CYCLES      1024        // Number of snapshots in the ring, must be a power of 2
+#define PIRECORDER_CHUNK_CYCLES     256         // Number of cycles per chunk
+#define PIRECORDER_BLOCK_SIZE       4096        // Alignment of the chunks for O_DIRECT
+#define PIRECORDER_FILE_VERSION     1
+#define PIRECORDER_CHUNK_MAGIC      0x4B434950  // "PICK"
+#define PIRECORDER_CHUNK_HDR_SIZE   24
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Process image recorder instance
+
+The structure contains the instance variables of the process image recorder.
+*/
+typedef struct
+{
+    BOOL                fActive;                ///< The recorder is running
+    int                 fd;                     ///< File descriptor of the record file
+    int                 indexFd;                ///< File descriptor of the index file
+    UINT                inSize;                 ///< Size of the input process image
+    UINT                outSize;                ///< Size of the output process image
+    UINT                slotSize;               ///< Size of a snapshot in the ring
+    BYTE*               pRing;                  ///< Ring of snapshots
+    volatile UINT32     writeIndex;             ///< Next snapshot written by the synchronous path
+    volatile UINT32     readIndex;              ///< Next snapshot read by the writer thread
+    volatile BOOL       fStop;                  ///< The writer thread shall terminate
+    UINT64              nextCycle;              ///< Cycle number of the next snapshot
+    sem_t               semData;                ///< Signals new snapshots to the writer thread
+    pthread_t           writerThread;           ///< Writer thread
+    BYTE*               pChunk;                 ///< Chunk buffer, aligned for O_DIRECT
+    size_t              chunkBufSize;           ///< Size of the chunk buffer
+    size_t              chunkSize;              ///< Used size of the chunk buffer
+    UINT                chunkCycleCount;        ///< Number of cycles in the chunk buffer
+    UINT64              chunkFirstCycle;        ///< First cycle of the chunk buffer
+    BYTE*               pPrevImage;             ///< Previous recorded cycle of the chunk
+    off_t               fileOffset;             ///< Offset of the next chunk in the file
+    tPiRecorderStatistics statistics;           ///< Recorder statistics
+} tPiRecorderInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tPiRecorderInstance  instance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void* writerThread(void* pArg_p);
+static void  addCycle(UINT64 cycle_p, const BYTE* pImage_p);
+static size_t encodeImage(BYTE* pDst_p, const BYTE* pImage_p, BYTE* pPrevImage_p, UINT size_p);
+static BOOL  writeChunk(void);
+static BOOL  writeBlocks(const BYTE* pData_p, size_t size_p, off_t offset_p);
+static void  setLe(BYTE* pDst_p, UINT64 value_p, UINT size_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the process image recorder
+
+The function creates the record file and the index file, allocates the
+snapshot ring and starts the writer thread.
+
+\param  pFileName_p             Name of the record file.
+\param  inSize_p                Size of the input process image.
+\param  outSize_p               Size of the output process image.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The recorder is started.
+\retval kErrorNoResource        The files, the memory or the thread could not
+                                be created.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+tOplkError pirecorder_init(const char* pFileName_p, UINT inSize_p, UINT outSize_p)
+{
+    char                indexFileName[256];
+    BYTE*               pHeader;
+    UINT                imageSize = inSize_p + outSize_p;
+    pthread_attr_t      attr;
+    struct sched_param  schedParam;
+
+    memset(&instance_l, 0, sizeof(instance_l));
+    instance_l.fd = -1;
+    instance_l.indexFd = -1;
+    instance_l.inSize = inSize_p;
+    instance_l.outSize = outSize_p;
+    instance_l.slotSize = (sizeof(UINT64) + imageSize + 7) & ~7U;
+
+    // every cycle record needs the flag, the size and at most one token per 128 bytes,
+    // because zero runs are not shorter than their token
+    instance_l.chunkBufSize = PIRECORDER_CHUNK_HDR_SIZE +
+                              PIRECORDER_CHUNK_CYCLES * (5 + imageSize + (imageSize + 127) / 128 + 1);
+    instance_l.chunkBufSize = (instance_l.chunkBufSize + PIRECORDER_BLOCK_SIZE - 1) &
+                              ~(size_t)(PIRECORDER_BLOCK_SIZE - 1);
+
+    snprintf(indexFileName, sizeof(indexFileName), "%s.idx", pFileName_p);
+
+    instance_l.pRing = malloc((size_t)instance_l.slotSize * PIRECORDER_RING_CYCLES);
+    instance_l.pPrevImage = malloc(imageSize);
+    if ((instance_l.pRing == NULL) || (instance_l.pPrevImage == NULL) ||
+        (posix_memalign((void**)&instance_l.pChunk, PIRECORDER_BLOCK_SIZE, instance_l.chunkBufSize) != 0))
+    {
+        printf("Unable to allocate the memory of the process image recorder!\n");
+        goto Exit;
+    }
+
+    // O_DIRECT keeps the recording out of the page cache, it is not supported by all file systems
+    instance_l.fd = open(pFileName_p, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+    if ((instance_l.fd < 0) && (errno == EINVAL))
+        instance_l.fd = open(pFileName_p, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    instance_l.indexFd = open(indexFileName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if ((instance_l.fd < 0) || (instance_l.indexFd < 0))
+    {
+        printf("Unable to create the process image record file %s!\n", pFileName_p);
+        goto Exit;
+    }
+
+    pHeader = instance_l.pChunk;
+    memset(pHeader, 0, PIRECORDER_BLOCK_SIZE);
+    memcpy(pHeader, "OPLKPIR", 8);
+    setLe(&pHeader[8], PIRECORDER_FILE_VERSION, 4);
+    setLe(&pHeader[12], inSize_p, 4);
+    setLe(&pHeader[16], outSize_p, 4);
+    setLe(&pHeader[20], PIRECORDER_CHUNK_CYCLES, 4);
+    if (!writeBlocks(pHeader, PIRECORDER_BLOCK_SIZE, 0))
+        goto Exit;
+    instance_l.fileOffset = PIRECORDER_BLOCK_SIZE;
+    instance_l.statistics.writtenBytes = PIRECORDER_BLOCK_SIZE;
+
+    if (sem_init(&instance_l.semData, 0, 0) != 0)
+        goto Exit;
+
+    // The writer must not inherit the real-time priority of the creating thread
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_OTHER);
+    schedParam.sched_priority = 0;
+    pthread_attr_setschedparam(&attr, &schedParam);
+    if (pthread_create(&instance_l.writerThread, &attr, writerThread, NULL) != 0)
+    {
+        pthread_attr_destroy(&attr);
+        sem_destroy(&instance_l.semData);
+        printf("Unable to create the thread of the process image recorder!\n");
+        goto Exit;
+    }
+    pthread_attr_destroy(&attr);
+
+    instance_l.fActive = TRUE;
+    printf("Recording process images to %s\n", pFileName_p);
+    return kErrorOk;
+
+Exit:
+    if (instance_l.fd >= 0)
+        close(instance_l.fd);
+    if (instance_l.indexFd >= 0)
+        close(instance_l.indexFd);
+    free(instance_l.pRing);
+    free(instance_l.pPrevImage);
+    free(instance_l.pChunk);
+    memset(&instance_l, 0, sizeof(instance_l));
+    instance_l.fd = -1;
+    instance_l.indexFd = -1;
+    return kErrorNoResource;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Shut down the process image recorder
+
+The function stops the writer thread after all buffered snapshots are written,
+writes the last chunk and closes the files.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+void pirecorder_exit(void)
+{
+    if (!instance_l.fActive)
+        return;
+
+    instance_l.fActive = FALSE;
+    instance_l.fStop = TRUE;
+    sem_post(&instance_l.semData);
+    pthread_join(instance_l.writerThread, NULL);
+    sem_destroy(&instance_l.semData);
+
+    if (instance_l.chunkCycleCount != 0)
+        writeChunk();
+
+    printf("Process image recorder: %llu cycles recorded, %llu dropped, %llu bytes written\n",
+           (unsigned long long)instance_l.statistics.recordedCycles,
+           (unsigned long long)instance_l.statistics.droppedCycles,
+           (unsigned long long)instance_l.statistics.writtenBytes);
+
+    close(instance_l.fd);
+    close(instance_l.indexFd);
+    free(instance_l.pRing);
+    free(instance_l.pPrevImage);
+    free(instance_l.pChunk);
+    instance_l.fd = -1;
+    instance_l.indexFd = -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Record the process images of a cycle
+
+The function copies the process images into the snapshot ring. It is called
+by the synchronous path once per cycle and does not block. If the ring is full,
+the cycle is dropped.
+
+\param  pPiIn_p                 Pointer to the input process image.
+\param  pPiOut_p                Pointer to the output process image.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+void pirecorder_record(const void* pPiIn_p, const void* pPiOut_p)
+{
+    UINT32      writeIndex;
+    BYTE*       pSlot;
+    UINT64      cycle;
+
+    if (!instance_l.fActive)
+        return;
+
+    cycle = instance_l.nextCycle++;
+    writeIndex = instance_l.writeIndex;
+    if ((UINT32)(writeIndex - instance_l.readIndex) >= PIRECORDER_RING_CYCLES)
+    {
+        instance_l.statistics.droppedCycles++;
+        return;
+    }
+
+    pSlot = &instance_l.pRing[(size_t)(writeIndex & (PIRECORDER_RING_CYCLES - 1)) * instance_l.slotSize];
+    memcpy(pSlot, &cycle, sizeof(cycle));
+    memcpy(pSlot + sizeof(UINT64), pPiIn_p, instance_l.inSize);
+    memcpy(pSlot + sizeof(UINT64) + instance_l.inSize, pPiOut_p, instance_l.outSize);
+
+    // the snapshot must be complete before the writer thread sees it
+    OPLK_MEMBAR();
+    instance_l.writeIndex = writeIndex + 1;
+    instance_l.statistics.recordedCycles++;
+    sem_post(&instance_l.semData);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the statistics of the process image recorder
+
+\param  pStatistics_p           Pointer to store the statistics.
+
+\ingroup module_app_common
+*/
+//------------------------------------------------------------------------------
+void pirecorder_getStatistics(tPiRecorderStatistics* pStatistics_p)
+{
+    *pStatistics_p = instance_l.statistics;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Writer thread of the process image recorder
+
+The thread takes the snapshots from the ring and adds them to the chunk
+buffer, which is written to the file if it is full.
+
+\param  pArg_p                  Thread argument (not used).
+
+\return The function returns NULL.
+*/
+//------------------------------------------------------------------------------
+static void* writerThread(void* pArg_p)
+{
+    UINT32      readIndex;
+    BYTE*       pSlot;
+    UINT64      cycle;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (;;)
+    {
+        sem_wait(&instance_l.semData);
+
+        readIndex = instance_l.readIndex;
+        while (readIndex != instance_l.writeIndex)
+        {
+            OPLK_MEMBAR();
+            pSlot = &instance_l.pRing[(size_t)(readIndex & (PIRECORDER_RING_CYCLES - 1)) *
+                                      instance_l.slotSize];
+            memcpy(&cycle, pSlot, sizeof(cycle));
+            addCycle(cycle, pSlot + sizeof(UINT64));
+
+            // the slot may be reused by the synchronous path afterwards
+            OPLK_MEMBAR();
+            instance_l.readIndex = ++readIndex;
+        }
+
+        if (instance_l.fStop)
+            break;
+    }
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add a cycle to the chunk buffer
+
+The function adds the cycle record of a snapshot to the chunk buffer. Cycles
+which were dropped since the previous snapshot are added as missing. Full
+chunks are written to the file.
+
+\param  cycle_p                 Cycle number of the snapshot.
+\param  pImage_p                Pointer to the process images of the snapshot.
+*/
+//------------------------------------------------------------------------------
+static void addCycle(UINT64 cycle_p, const BYTE* pImage_p)
+{
+    UINT64      cycle;
+    size_t      encodedSize;
+    BOOL        fMissing;
+
+    do
+    {
+        if (instance_l.chunkCycleCount == 0)
+        {
+            instance_l.chunkSize = PIRECORDER_CHUNK_HDR_SIZE;
+            memset(instance_l.pPrevImage, 0, instance_l.inSize + instance_l.outSize);
+        }
+
+        cycle = instance_l.chunkFirstCycle + instance_l.chunkCycleCount;
+        fMissing = (cycle != cycle_p);
+        if (fMissing)
+        {
+            instance_l.pChunk[instance_l.chunkSize++] = 0;
+        }
+        else
+        {
+            instance_l.pChunk[instance_l.chunkSize++] = 1;
+            encodedSize = encodeImage(&instance_l.pChunk[instance_l.chunkSize + 4], pImage_p,
+                                      instance_l.pPrevImage, instance_l.inSize + instance_l.outSize);
+            setLe(&instance_l.pChunk[instance_l.chunkSize], encodedSize, 4);
+            instance_l.chunkSize += 4 + encodedSize;
+        }
+
+        if (++instance_l.chunkCycleCount == PIRECORDER_CHUNK_CYCLES)
+            writeChunk();
+    } while (fMissing);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Encode a process image snapshot
+
+The function encodes the difference of a snapshot to the previous one and
+stores the snapshot as the previous one.
+
+\param  pDst_p                  Pointer to store the encoded data.
+\param  pImage_p                Pointer to the snapshot.
+\param  pPrevImage_p            Pointer to the previous snapshot.
+\param  size_p                  Size of the snapshot.
+
+\return The function returns the size of the encoded data.
+*/
+//------------------------------------------------------------------------------
+static size_t encodeImage(BYTE* pDst_p, const BYTE* pImage_p, BYTE* pPrevImage_p, UINT size_p)
+{
+    BYTE*       pDst = pDst_p;
+    BYTE*       pToken = NULL;
+    UINT        i;
+    UINT        run;
+
+    for (i = 0; i < size_p;)
+    {
+        for (run = 0; ((i + run) < size_p) && (run < 128) && (pImage_p[i + run] == pPrevImage_p[i + run]); run++)
+            ;
+
+        // a single unchanged byte within changed bytes is cheaper as a literal
+        if ((run > 1) || ((run == 1) && (pToken == NULL)))
+        {
+            *pDst++ = (BYTE)(run - 1);
+            i += run;
+            pToken = NULL;
+        }
+        else
+        {
+            if ((pToken == NULL) || (*pToken == 0xFF))
+            {
+                pToken = pDst++;
+                *pToken = 0x7F;
+            }
+            (*pToken)++;
+            *pDst++ = pImage_p[i] ^ pPrevImage_p[i];
+            pPrevImage_p[i] = pImage_p[i];
+            i++;
+        }
+    }
+
+    return (size_t)(pDst - pDst_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write the chunk buffer
+
+The function writes the chunk buffer to the record file and appends its offset
+to the index file.
+
+\return The function returns TRUE if the chunk is written.
+*/
+//------------------------------------------------------------------------------
+static BOOL writeChunk(void)
+{
+    size_t      paddedSize;
+    BYTE        indexEntry[8];
+    BOOL        fWritten;
+
+    setLe(&instance_l.pChunk[0], PIRECORDER_CHUNK_MAGIC, 4);
+    setLe(&instance_l.pChunk[4], instance_l.chunkCycleCount, 4);
+    setLe(&instance_l.pChunk[8], instance_l.chunkSize - PIRECORDER_CHUNK_HDR_SIZE, 4);
+    setLe(&instance_l.pChunk[12], 0, 4);
+    setLe(&instance_l.pChunk[16], instance_l.chunkFirstCycle, 8);
+
+    paddedSize = (instance_l.chunkSize + PIRECORDER_BLOCK_SIZE - 1) & ~(size_t)(PIRECORDER_BLOCK_SIZE - 1);
+    memset(&instance_l.pChunk[instance_l.chunkSize], 0, paddedSize - instance_l.chunkSize);
+
+    // the index entry is only written if the chunk is in the file
+    fWritten = writeBlocks(instance_l.pChunk, paddedSize, instance_l.fileOffset);
+    if (fWritten)
+    {
+        setLe(indexEntry, (UINT64)instance_l.fileOffset, 8);
+        if (write(instance_l.indexFd, indexEntry, sizeof(indexEntry)) != sizeof(indexEntry))
+            fWritten = FALSE;
+        instance_l.statistics.writtenBytes += paddedSize;
+    }
+
+    // the offset advances in any case, so the index keeps matching the chunk numbers
+    instance_l.fileOffset += paddedSize;
+    instance_l.chunkFirstCycle += PIRECORDER_CHUNK_CYCLES;
+    instance_l.chunkCycleCount = 0;
+
+    return fWritten;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write blocks to the record file
+
+The function writes aligned blocks to the record file. If the file system
+rejects the direct I/O, it falls back to buffered I/O.
+
+\param  pData_p                 Pointer to the data, aligned to
+                                PIRECORDER_BLOCK_SIZE.
+\param  size_p                  Size of the data, a multiple of
+                                PIRECORDER_BLOCK_SIZE.
+\param  offset_p                File offset.
+
+\return The function returns TRUE if the data is written.
+*/
+//------------------------------------------------------------------------------
+static BOOL writeBlocks(const BYTE* pData_p, size_t size_p, off_t offset_p)
+{
+    ssize_t     written;
+    int         flags;
+
+    written = pwrite(instance_l.fd, pData_p, size_p, offset_p);
+    if ((written < 0) && (errno == EINVAL))
+    {
+        flags = fcntl(instance_l.fd, F_GETFL);
+        if ((flags >= 0) && ((flags & O_DIRECT) != 0))
+        {
+            fcntl(instance_l.fd, F_SETFL, flags & ~O_DIRECT);
+            written = pwrite(instance_l.fd, pData_p, size_p, offset_p);
+        }
+    }
+
+    if (written != (ssize_t)size_p)
+    {
+        printf("Unable to write the process image record file!\n");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Store a little endian value
+
+\param  pDst_p                  Pointer to store the value.
+\param  value_p                 Value to store.
+\param  size_p                  Size of the value in bytes.
+*/
+//------------------------------------------------------------------------------
+static void setLe(BYTE* pDst_p, UINT64 value_p, UINT size_p)
+{
+    UINT    i;
+
+    for (i = 0; i < size_p; i++)
+        pDst_p[i] = (BYTE)(value_p >> (i * 8));
+}
+
+///\}
@@ -47,6 +47,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <errno.h>
 #include <pthread.h>
 #include <signal.h>
+#include <time.h>
 
 #include <oplk/oplk.h>
 
@@ -316,5 +317,25 @@ void msleep(unsigned int milliSeconds_p)
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief Get the tick count
+
+The function returns the number of milliseconds elapsed since an arbitrary
+point in time, e.g. the system start. It is used to measure time intervals.
+
+\return The function returns the tick count in milliseconds.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+UINT32 system_getTickCount(void)
+{
+    struct timespec     curTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &curTime);
+    return (UINT32)((curTime.tv_sec * 1000) + (curTime.tv_nsec / 1000000));
+}
+
 ///\}
 
@@ -174,6 +174,23 @@ void msleep(unsigned int milliSeconds_p)
     Sleep(milliSeconds_p);
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief Get the tick count
+
+The function returns the number of milliseconds elapsed since an arbitrary
+point in time, e.g. the system start. It is used to measure time intervals.
+
+\return The function returns the tick count in milliseconds.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+UINT32 system_getTickCount(void)
+{
+    return (UINT32)GetTickCount();
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -65,6 +65,7 @@ int initSystem(void);
 void shutdownSystem(void);
 BOOL system_getTermSignalState();
 void msleep(unsigned int milliSecond_p);
+UINT32 system_getTickCount(void);
 
 #if defined(CONFIG_USE_SYNCTHREAD)
 void startSyncThread(tSyncCb pfnSync_p);
@@ -33,6 +33,7 @@
 
 ADD_DEFINITIONS(-Wall -Wextra -pedantic -std=c99 -pthread -D_GNU_SOURCE
                 -D_POSIX_C_SOURCE=200112L)
+ADD_DEFINITIONS(-DCONFIG_USE_PIRECORDER)
 
 ################################################################################
 # Set architecture specific sources and include directories
@@ -40,6 +41,7 @@ ADD_DEFINITIONS(-Wall -Wextra -pedantic -std=c99 -pthread -D_GNU_SOURCE
 SET (DEMO_ARCH_SOURCES
      ${COMMON_SOURCE_DIR}/system/system-linux.c
      ${CONTRIB_SOURCE_DIR}/console/console-linux.c
+     ${COMMON_SOURCE_DIR}/pirecorder/pirecorder-linux.c
      )
 
 ################################################################################
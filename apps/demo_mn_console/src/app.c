@@ -45,6 +45,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 #include <oplk/oplk.h>
 
+#if defined(CONFIG_USE_PIRECORDER)
+#include <pirecorder/pirecorder.h>
+#endif
+
 #include "app.h"
 #include "xap.h"
 
@@ -113,12 +117,15 @@ static tOplkError initProcessImage(void);
 
 The function initializes the synchronous data application
 
+\param  pRecordFile_p           File to record the process images of every cycle
+                                (NULL = no recording).
+
 \return The function returns a tOplkError error code.
 
 \ingroup module_demo_mn_console
 */
 //------------------------------------------------------------------------------
-tOplkError initApp(void)
+tOplkError initApp(const char* pRecordFile_p)
 {
     tOplkError ret = kErrorOk;
     int        i;
@@ -137,6 +144,14 @@ tOplkError initApp(void)
 
     ret = initProcessImage();
 
+#if defined(CONFIG_USE_PIRECORDER)
+    if ((ret == kErrorOk) && (pRecordFile_p != NULL))
+        ret = pirecorder_init(pRecordFile_p, sizeof(PI_IN), sizeof(PI_OUT));
+#else
+    if (pRecordFile_p != NULL)
+        printf("Process image recording is not supported on this platform!\n");
+#endif
+
     return ret;
 }
 
@@ -153,6 +168,9 @@ The function shuts down the synchronous data application
 //------------------------------------------------------------------------------
 void shutdownApp(void)
 {
+#if defined(CONFIG_USE_PIRECORDER)
+    pirecorder_exit();
+#endif
     oplk_freeProcessImage();
 }
 
@@ -233,6 +251,10 @@ tOplkError processSync(void)
     pProcessImageIn_l->CN32_M00_DigitalOutput_00h_AU8_DigitalOutput = nodeVar_l[1].leds;
     pProcessImageIn_l->CN110_M00_DigitalOutput_00h_AU8_DigitalOutput = nodeVar_l[2].leds;
 
+#if defined(CONFIG_USE_PIRECORDER)
+    pirecorder_record(pProcessImageIn_l, pProcessImageOut_l);
+#endif
+
     ret = oplk_exchangeProcessImageIn();
 
     return ret;
@@ -60,7 +60,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 extern "C" {
 #endif
 
-tOplkError initApp(void);
+tOplkError initApp(const char* pRecordFile_p);
 void shutdownApp(void);
 tOplkError processSync(void);
 
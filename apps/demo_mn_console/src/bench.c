@@ -0,0 +1,712 @@
+/**
+********************************************************************************
+\file   bench.c
+
+\brief  Benchmark mode of the console MN demo
+
+This file contains the benchmark mode of the console MN demo. It generates
+SDO and ASnd load to the operational CNs at configurable rates and writes a
+JSON report with the cycle statistics, the event queue high-water marks and
+the error counters of the stack at the end of the run.
+
+\ingroup module_demo_mn_console
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplk.h>
+#include <system/system.h>
+#include <console/console.h>
+
+#include "bench.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define BENCH_MAX_NODE_ID           239         // Highest node ID of a CN
+#define BENCH_SDO_REQUEST_COUNT     64          // Number of SDO requests which may be pending
+#define BENCH_LOAD_BURST            32          // Maximum number of requests generated per call
+#define BENCH_ASND_SERVICE_ID       0xA0        // Manufacturer specific ASnd service ID
+#define BENCH_ASND_PAYLOAD_SIZE     64          // Payload size of the ASnd frames
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Load counters
+
+The structure contains the counters of the generated SDO or ASnd load.
+*/
+typedef struct
+{
+    UINT32              issued;                 ///< Number of requests due according to the rate
+    UINT32              posted;                 ///< Number of posted requests
+    UINT32              completed;              ///< Number of successfully completed requests
+    UINT32              failed;                 ///< Number of failed requests
+    UINT32              rejected;               ///< Number of requests which were not accepted by the stack
+} tBenchLoad;
+
+/**
+\brief  Benchmark instance
+
+The structure contains the state of the benchmark mode.
+*/
+typedef struct
+{
+    tBenchConfig        config;                                 ///< Configuration of the run
+    BOOL                fActive;                                ///< Benchmark mode is active
+    BOOL                fStarted;                               ///< Time measurement is started
+    UINT32              startTick;                              ///< Start of the run in ms
+    UINT32              elapsedMs;                              ///< Elapsed time of the run in ms
+    volatile BOOL       afOperational[BENCH_MAX_NODE_ID + 1];   ///< Operational state of the CNs
+    BOOL                afLoaded[BENCH_MAX_NODE_ID + 1];        ///< CNs which have been operational during the run
+    UINT                nextSdoNode;                            ///< Last node which got an SDO request
+    UINT                nextAsndNode;                           ///< Last node which got an ASnd frame
+    tOplkApiSdoRequest  aSdoRequest[BENCH_SDO_REQUEST_COUNT];   ///< SDO requests
+    BOOL                afSdoPending[BENCH_SDO_REQUEST_COUNT];  ///< Pending flags of the SDO requests
+    UINT32              aSdoData[BENCH_SDO_REQUEST_COUNT];      ///< Data buffers of the SDO requests
+    tBenchLoad          sdoLoad;                                ///< SDO load counters
+    tBenchLoad          asndLoad;                               ///< ASnd load counters
+} tBenchInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tBenchInstance   benchInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static UINT   getNextNode(UINT lastNode_p);
+static UINT32 getDueCount(UINT32 rate_p);
+static void   generateSdoLoad(void);
+static void   fetchSdoCompletions(void);
+static void   generateAsndLoad(void);
+static void   writeHistogram(FILE* pFile_p, const char* pName_p,
+                             const tCycleStatHistogram* pHistogram_p, BOOL fLast_p);
+static void   writeLoad(FILE* pFile_p, const char* pName_p, const tBenchLoad* pLoad_p,
+                        UINT32 rate_p, BOOL fLast_p);
+static void   writeCycleStatistics(FILE* pFile_p);
+static void   writeEventQueues(FILE* pFile_p);
+static void   writeErrorCounters(FILE* pFile_p);
+static UINT32 readCounter(UINT index_p, UINT subindex_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the benchmark mode
+
+The function initializes the benchmark mode. The mode is active if the
+duration of the configuration is not 0.
+
+\param  pConfig_p               Pointer to the benchmark configuration.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void bench_init(const tBenchConfig* pConfig_p)
+{
+    memset(&benchInstance_l, 0, sizeof(benchInstance_l));
+    benchInstance_l.config = *pConfig_p;
+    benchInstance_l.fActive = (pConfig_p->duration != 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check if the benchmark mode is active
+
+\return The function returns TRUE if the benchmark mode is active.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BOOL bench_isActive(void)
+{
+    return benchInstance_l.fActive;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Apply the cycle length of the benchmark
+
+The function overwrites the cycle length (object 0x1006) of the MN with the
+cycle length of the benchmark configuration. It must be called in the state
+NMT_GS_RESET_COMMUNICATION after the CDC has been loaded, so that the cycle
+length is used by the following NMT_GS_RESET_CONFIGURATION. The cycle length
+of the CNs is still set by the CDC.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+tOplkError bench_applyCycleLen(void)
+{
+    tOplkError  ret;
+    UINT32      cycleLen;
+
+    if (!benchInstance_l.fActive || (benchInstance_l.config.cycleLen == 0))
+        return kErrorOk;
+
+    cycleLen = benchInstance_l.config.cycleLen;
+    ret = oplk_writeLocalObject(0x1006, 0x00, &cycleLen, sizeof(cycleLen));
+    if (ret != kErrorOk)
+    {
+        console_printlog("Benchmark: Setting the cycle length failed (Error:0x%x)\n", ret);
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update the NMT state of a CN
+
+The function records whether a CN is operational. Only operational CNs get
+the SDO and ASnd load of the benchmark.
+
+\param  nodeId_p                Node ID of the CN.
+\param  nmtState_p              New NMT state of the CN.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void bench_setNodeState(UINT nodeId_p, tNmtState nmtState_p)
+{
+    if ((nodeId_p == 0) || (nodeId_p > BENCH_MAX_NODE_ID))
+        return;
+
+    benchInstance_l.afOperational[nodeId_p] = (nmtState_p == kNmtCsOperational);
+    if (nmtState_p == kNmtCsOperational)
+        benchInstance_l.afLoaded[nodeId_p] = TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process the benchmark
+
+The function generates the SDO and ASnd load according to the configured
+rates and fetches the completed SDO requests. The time of the run starts with
+the first call. It has to be called periodically by the main loop.
+
+\return The function returns TRUE if the duration of the run has elapsed.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+BOOL bench_process(void)
+{
+    if (!benchInstance_l.fActive)
+        return FALSE;
+
+    if (!benchInstance_l.fStarted)
+    {
+        benchInstance_l.startTick = system_getTickCount();
+        benchInstance_l.fStarted = TRUE;
+    }
+
+    benchInstance_l.elapsedMs = system_getTickCount() - benchInstance_l.startTick;
+
+    fetchSdoCompletions();
+    generateSdoLoad();
+    generateAsndLoad();
+
+    return (benchInstance_l.elapsedMs >= benchInstance_l.config.duration * 1000);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write the benchmark report
+
+The function writes the JSON report of the benchmark run. It contains the
+configuration, the load counters, the cycle statistics of the stack, the
+high-water marks of the event queues and the error counters of the MN. It must
+be called before the stack is shut down.
+
+\ingroup module_demo_mn_console
+*/
+//------------------------------------------------------------------------------
+void bench_writeReport(void)
+{
+    FILE*       pFile = stdout;
+
+    if (!benchInstance_l.fActive)
+        return;
+
+    fetchSdoCompletions();
+
+    if (benchInstance_l.config.pReportFile != NULL)
+    {
+        pFile = fopen(benchInstance_l.config.pReportFile, "w");
+        if (pFile == NULL)
+        {
+            console_printlog("Benchmark: Unable to open report file %s\n",
+                             benchInstance_l.config.pReportFile);
+            return;
+        }
+    }
+
+    fprintf(pFile, "{\n");
+    fprintf(pFile, "  \"config\": { \"duration_s\": %u, \"cycle_len_us\": %u, "
+                   "\"sdo_rate\": %u, \"asnd_rate\": %u },\n",
+            benchInstance_l.config.duration, benchInstance_l.config.cycleLen,
+            benchInstance_l.config.sdoRate, benchInstance_l.config.asndRate);
+    fprintf(pFile, "  \"elapsed_ms\": %u,\n", benchInstance_l.elapsedMs);
+    fprintf(pFile, "  \"load\": {\n");
+    writeLoad(pFile, "sdo", &benchInstance_l.sdoLoad, benchInstance_l.config.sdoRate, FALSE);
+    writeLoad(pFile, "asnd", &benchInstance_l.asndLoad, benchInstance_l.config.asndRate, TRUE);
+    fprintf(pFile, "  },\n");
+    writeCycleStatistics(pFile);
+    writeEventQueues(pFile);
+    writeErrorCounters(pFile);
+    fprintf(pFile, "}\n");
+
+    if (pFile != stdout)
+    {
+        fclose(pFile);
+        console_printlog("Benchmark: Report written to %s\n", benchInstance_l.config.pReportFile);
+    }
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the next operational CN
+
+The function searches the operational CN which follows the passed node in
+round robin order.
+
+\param  lastNode_p              Node which got the last request.
+
+\return The function returns the node ID of the next operational CN or 0 if
+        no CN is operational.
+*/
+//------------------------------------------------------------------------------
+static UINT getNextNode(UINT lastNode_p)
+{
+    UINT    nodeId = lastNode_p;
+    UINT    i;
+
+    for (i = 0; i < BENCH_MAX_NODE_ID; i++)
+    {
+        nodeId = (nodeId >= BENCH_MAX_NODE_ID) ? 1 : (nodeId + 1);
+        if (benchInstance_l.afOperational[nodeId])
+            return nodeId;
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the number of requests which are due
+
+\param  rate_p                  Rate of the requests per second.
+
+\return The function returns the number of requests which are due since the
+        start of the run.
+*/
+//------------------------------------------------------------------------------
+static UINT32 getDueCount(UINT32 rate_p)
+{
+    return (UINT32)(((UINT64)benchInstance_l.elapsedMs * rate_p) / 1000);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Generate SDO load
+
+The function posts the SDO read requests of object 0x1000 to the operational
+CNs which are due according to the SDO rate. Requests which are due while no
+free request buffer is available or while the stack refuses them are counted
+as rejected, so the offered load does not depend on the response time.
+*/
+//------------------------------------------------------------------------------
+static void generateSdoLoad(void)
+{
+    tBenchLoad*         pLoad = &benchInstance_l.sdoLoad;
+    tOplkApiSdoRequest* pRequest;
+    tOplkError          ret;
+    UINT32              dueCount;
+    UINT                burst;
+    UINT                nodeId;
+    UINT                i;
+
+    dueCount = getDueCount(benchInstance_l.config.sdoRate);
+    for (burst = 0; (pLoad->issued < dueCount) && (burst < BENCH_LOAD_BURST); burst++)
+    {
+        nodeId = getNextNode(benchInstance_l.nextSdoNode);
+        if (nodeId == 0)
+        {   // no load before the CNs are operational
+            pLoad->issued = dueCount;
+            break;
+        }
+
+        pLoad->issued++;
+        benchInstance_l.nextSdoNode = nodeId;
+
+        for (i = 0; i < BENCH_SDO_REQUEST_COUNT; i++)
+        {
+            if (!benchInstance_l.afSdoPending[i])
+                break;
+        }
+
+        if (i == BENCH_SDO_REQUEST_COUNT)
+        {
+            pLoad->rejected++;
+            continue;
+        }
+
+        pRequest = &benchInstance_l.aSdoRequest[i];
+        pRequest->nodeId = nodeId;
+        pRequest->index = 0x1000;
+        pRequest->subindex = 0x00;
+        pRequest->accessType = kSdoAccessTypeRead;
+        pRequest->sdoType = kSdoTypeAsnd;
+        pRequest->pData = &benchInstance_l.aSdoData[i];
+        pRequest->size = sizeof(benchInstance_l.aSdoData[i]);
+        pRequest->pUserArg = NULL;
+
+        ret = oplk_postSdoRequests(pRequest, 1);
+        if (ret != kErrorOk)
+        {
+            pLoad->rejected++;
+            continue;
+        }
+
+        benchInstance_l.afSdoPending[i] = TRUE;
+        pLoad->posted++;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Fetch SDO completions
+
+The function fetches the completions of the posted SDO requests and releases
+their request buffers.
+*/
+//------------------------------------------------------------------------------
+static void fetchSdoCompletions(void)
+{
+    tOplkApiSdoCompletion   aCompletion[BENCH_LOAD_BURST];
+    tBenchLoad*             pLoad = &benchInstance_l.sdoLoad;
+    UINT                    count;
+    UINT                    i;
+
+    do
+    {
+        if (oplk_getSdoCompletions(aCompletion, BENCH_LOAD_BURST, &count) != kErrorOk)
+            return;
+
+        for (i = 0; i < count; i++)
+        {
+            benchInstance_l.afSdoPending[aCompletion[i].pRequest - benchInstance_l.aSdoRequest] = FALSE;
+
+            if ((aCompletion[i].errorCode == kErrorOk) &&
+                (aCompletion[i].sdoComConState == kSdoComTransferFinished))
+                pLoad->completed++;
+            else
+                pLoad->failed++;
+        }
+    } while (count == BENCH_LOAD_BURST);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Generate ASnd load
+
+The function sends the ASnd frames with a manufacturer specific service ID to
+the operational CNs which are due according to the ASnd rate.
+*/
+//------------------------------------------------------------------------------
+static void generateAsndLoad(void)
+{
+    tBenchLoad*         pLoad = &benchInstance_l.asndLoad;
+    tAsndFrame          asndFrame;
+    UINT32              dueCount;
+    UINT                burst;
+    UINT                nodeId;
+
+    dueCount = getDueCount(benchInstance_l.config.asndRate);
+    for (burst = 0; (pLoad->issued < dueCount) && (burst < BENCH_LOAD_BURST); burst++)
+    {
+        nodeId = getNextNode(benchInstance_l.nextAsndNode);
+        if (nodeId == 0)
+        {   // no load before the CNs are operational
+            pLoad->issued = dueCount;
+            break;
+        }
+
+        pLoad->issued++;
+        benchInstance_l.nextAsndNode = nodeId;
+
+        asndFrame.serviceId = BENCH_ASND_SERVICE_ID;
+        memset(asndFrame.payload.aPayload, 0, BENCH_ASND_PAYLOAD_SIZE);
+        memcpy(asndFrame.payload.aPayload, &pLoad->issued, sizeof(pLoad->issued));
+
+        if (oplk_sendAsndFrame((UINT8)nodeId, &asndFrame,
+                               offsetof(tAsndFrame, payload) + BENCH_ASND_PAYLOAD_SIZE) != kErrorOk)
+        {
+            pLoad->rejected++;
+            continue;
+        }
+
+        pLoad->posted++;
+        pLoad->completed++;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write a histogram
+
+The function writes a histogram of the cycle statistics as JSON object. The
+times are written in microseconds.
+
+\param  pFile_p                 File to write to.
+\param  pName_p                 Name of the histogram.
+\param  pHistogram_p            Pointer to the histogram.
+\param  fLast_p                 TRUE if it is the last member of the object.
+*/
+//------------------------------------------------------------------------------
+static void writeHistogram(FILE* pFile_p, const char* pName_p,
+                           const tCycleStatHistogram* pHistogram_p, BOOL fLast_p)
+{
+    double  mean = 0.0;
+
+    if (pHistogram_p->sampleCount != 0)
+        mean = ((double)pHistogram_p->totalTime / pHistogram_p->sampleCount) / 1000.0;
+
+    fprintf(pFile_p, "    \"%s\": { \"samples\": %u, \"min_us\": %.1f, \"mean_us\": %.1f, "
+                     "\"max_us\": %.1f, \"p50_us\": %.1f, \"p99_us\": %.1f, \"p999_us\": %.1f }%s\n",
+            pName_p,
+            pHistogram_p->sampleCount,
+            (pHistogram_p->sampleCount != 0) ? pHistogram_p->minTime / 1000.0 : 0.0,
+            mean,
+            pHistogram_p->maxTime / 1000.0,
+            pHistogram_p->p50Time / 1000.0,
+            pHistogram_p->p99Time / 1000.0,
+            pHistogram_p->p999Time / 1000.0,
+            fLast_p ? "" : ",");
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write load counters
+
+\param  pFile_p                 File to write to.
+\param  pName_p                 Name of the load.
+\param  pLoad_p                 Pointer to the load counters.
+\param  rate_p                  Configured rate of the load.
+\param  fLast_p                 TRUE if it is the last member of the object.
+*/
+//------------------------------------------------------------------------------
+static void writeLoad(FILE* pFile_p, const char* pName_p, const tBenchLoad* pLoad_p,
+                      UINT32 rate_p, BOOL fLast_p)
+{
+    fprintf(pFile_p, "    \"%s\": { \"rate\": %u, \"issued\": %u, \"posted\": %u, "
+                     "\"completed\": %u, \"failed\": %u, \"rejected\": %u }%s\n",
+            pName_p, rate_p, pLoad_p->issued, pLoad_p->posted, pLoad_p->completed,
+            pLoad_p->failed, pLoad_p->rejected, fLast_p ? "" : ",");
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write the cycle statistics
+
+The function writes the histograms of the cycle stages and of the CN slots.
+The stages "rpdo_pi" and "tpdo_pi" contain the cost of the PDO copy between
+the frames and the process image.
+
+\param  pFile_p                 File to write to.
+*/
+//------------------------------------------------------------------------------
+static void writeCycleStatistics(FILE* pFile_p)
+{
+    static const char*      apStageName[kCycleStatStageCount] =
+    {
+        "cycle_time", "pres_rx", "rpdo", "sync_event", "app_sync", "rpdo_pi", "tpdo_pi",
+        "soc_wire"
+    };
+    static tCycleStatistics statistics;
+    tOplkError              ret;
+    UINT                    index;
+    UINT                    nodeCount;
+
+    ret = oplk_getCycleStatistics(&statistics);
+    if (ret != kErrorOk)
+    {
+        fprintf(pFile_p, "  \"cycle\": null,\n");
+        fprintf(pFile_p, "  \"nodes\": [],\n");
+        return;
+    }
+
+    fprintf(pFile_p, "  \"cycle\": {\n");
+    for (index = 0; index < kCycleStatStageCount; index++)
+    {
+        writeHistogram(pFile_p, apStageName[index], &statistics.aStage[index],
+                       (index == (kCycleStatStageCount - 1)));
+    }
+    fprintf(pFile_p, "  },\n");
+
+    for (nodeCount = 0; nodeCount < CYCLESTAT_NODE_COUNT; nodeCount++)
+    {
+        if (statistics.aNode[nodeCount].nodeId == 0)
+            break;
+    }
+
+    fprintf(pFile_p, "  \"nodes\": [\n");
+    for (index = 0; index < nodeCount; index++)
+    {
+        fprintf(pFile_p, "   { \"node_id\": %u,\n", statistics.aNode[index].nodeId);
+        writeHistogram(pFile_p, "soc_to_preq", &statistics.aNode[index].socToPreq, FALSE);
+        writeHistogram(pFile_p, "preq_to_pres", &statistics.aNode[index].preqToPres, FALSE);
+        writeHistogram(pFile_p, "preq_to_pres_wire", &statistics.aNode[index].preqToPresWire, TRUE);
+        fprintf(pFile_p, "   }%s\n", (index == (nodeCount - 1)) ? "" : ",");
+    }
+    fprintf(pFile_p, "  ],\n");
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write the event queue statistics
+
+The function writes the high-water marks of the event queues in bytes. They
+are only available if the stack records them.
+
+\param  pFile_p                 File to write to.
+*/
+//------------------------------------------------------------------------------
+static void writeEventQueues(FILE* pFile_p)
+{
+    tEventQueueStatistics   statistics;
+
+    if (oplk_getEventQueueStatistics(&statistics) != kErrorOk)
+    {
+        fprintf(pFile_p, "  \"event_queues\": null,\n");
+        return;
+    }
+
+    fprintf(pFile_p, "  \"event_queues\": { \"k2u_max\": %u, \"u2k_max\": %u, "
+                     "\"kernel_internal_max\": %u, \"user_internal_max\": %u },\n",
+            statistics.aMaxSize[kEventQueueK2U], statistics.aMaxSize[kEventQueueU2K],
+            statistics.aMaxSize[kEventQueueKInt], statistics.aMaxSize[kEventQueueUInt]);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write the error counters
+
+The function writes the cumulative error counters of the MN and the loss of
+PRes counters of the CNs which have been operational during the run.
+
+\param  pFile_p                 File to write to.
+*/
+//------------------------------------------------------------------------------
+static void writeErrorCounters(FILE* pFile_p)
+{
+    UINT    nodeId;
+    BOOL    fFirst = TRUE;
+
+    fprintf(pFile_p, "  \"errors\": { \"mn_crc\": %u, \"mn_cycle_time_exceeded\": %u,\n",
+            readCounter(OID_DLL_MN_CRCERROR_REC, 0x01),
+            readCounter(OID_DLL_MN_CYCTIME_EXCEED_REC, 0x01));
+
+    fprintf(pFile_p, "    \"loss_of_pres\": {");
+    for (nodeId = 1; nodeId <= BENCH_MAX_NODE_ID; nodeId++)
+    {
+        if (!benchInstance_l.afLoaded[nodeId])
+            continue;
+
+        fprintf(pFile_p, "%s \"%u\": %u", fFirst ? "" : ",", nodeId,
+                readCounter(OID_DLL_MNCN_LOSSPRES_CUMCNT_AU32, nodeId));
+        fFirst = FALSE;
+    }
+    fprintf(pFile_p, " }\n  }\n");
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read an error counter
+
+\param  index_p                 Index of the counter object.
+\param  subindex_p              Subindex of the counter object.
+
+\return The function returns the value of the counter or 0 if it cannot be
+        read.
+*/
+//------------------------------------------------------------------------------
+static UINT32 readCounter(UINT index_p, UINT subindex_p)
+{
+    UINT32  value = 0;
+    UINT    size = sizeof(value);
+
+    if (oplk_readLocalObject(index_p, subindex_p, &value, &size) != kErrorOk)
+        return 0;
+
+    return value;
+}
+
+///\}
@@ -0,0 +1,86 @@
+/**
+********************************************************************************
+\file   bench.h
+
+\brief  Definitions of the MN demo benchmark mode
+
+The file contains the definitions of the benchmark mode of the console MN demo.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_demo_bench_H_
+#define _INC_demo_bench_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Benchmark configuration
+
+The structure contains the parameters of a benchmark run.
+*/
+typedef struct
+{
+    UINT32              duration;               ///< Duration of the run in seconds (0 = benchmark mode disabled)
+    UINT32              cycleLen;               ///< Cycle length in us (0 = use the cycle length of the CDC)
+    UINT32              sdoRate;                ///< SDO read requests per second to the operational CNs
+    UINT32              asndRate;               ///< ASnd frames per second to the operational CNs
+    const char*         pReportFile;            ///< File of the JSON report (NULL = stdout)
+} tBenchConfig;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void       bench_init(const tBenchConfig* pConfig_p);
+BOOL       bench_isActive(void);
+tOplkError bench_applyCycleLen(void);
+void       bench_setNodeState(UINT nodeId_p, tNmtState nmtState_p);
+BOOL       bench_process(void);
+void       bench_writeReport(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_demo_bench_H_ */
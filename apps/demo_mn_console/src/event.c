@@ -46,6 +46,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <console/console.h>
 
 #include "event.h"
+#include "bench.h"
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -265,6 +266,8 @@ static tOplkError processStateChangeEvent(tOplkApiEventType EventType_p,
 #ifndef CONFIG_INCLUDE_CFM
             ret = setDefaultNodeAssignment();
 #endif
+            if (ret == kErrorOk)
+                ret = bench_applyCycleLen();
             console_printlog("StateChangeEvent(0x%X) originating event = 0x%X (%s)\n",
                              pNmtStateChange->newNmtState,
                              pNmtStateChange->nmtEvent,
@@ -441,6 +444,7 @@ static tOplkError processNodeEvent(tOplkApiEventType EventType_p,
             console_printlog("NodeEvent: (Node=%u, NmtState=%s)\n",
                              pNode->nodeId,
                              debugstr_getNmtStateStr(pNode->nmtState));
+            bench_setNodeState(pNode->nodeId, pNode->nmtState);
             break;
 
         case kNmtNodeEventError:
@@ -43,6 +43,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <stdio.h>
+#include <stdlib.h>
 #include <limits.h>
 
 #include <oplk/oplk.h>
@@ -56,6 +57,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "app.h"
 #include "event.h"
+#include "bench.h"
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -93,8 +95,10 @@ static BOOL fGsOff_l;
 //------------------------------------------------------------------------------
 typedef struct
 {
-    char        cdcFile[256];
-    char*       pLogFile;
+    char            cdcFile[256];
+    char*           pLogFile;
+    char*           pRecordFile;
+    tBenchConfig    bench;
 } tOptions;
 
 //------------------------------------------------------------------------------
@@ -109,6 +113,8 @@ static tOplkError initPowerlink(UINT32 cycleLen_p, char* pszCdcFileName_p,
                                 const BYTE* macAddr_p);
 static void loopMain(void);
 static void shutdownPowerlink(void);
+static void printCycleStatistics(void);
+static void printHistogram(const char* pName_p, const tCycleStatHistogram* pHistogram_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -142,6 +148,7 @@ int main(int argc, char** argv)
     }
 
     initEvents(&fGsOff_l);
+    bench_init(&opts.bench);
 
     printf("----------------------------------------------------\n");
     printf("openPOWERLINK console MN DEMO application\n");
@@ -151,10 +158,11 @@ int main(int argc, char** argv)
     if ((ret = initPowerlink(CYCLE_LEN, opts.cdcFile, aMacAddr_g)) != kErrorOk)
         goto Exit;
 
-    if ((ret = initApp()) != kErrorOk)
+    if ((ret = initApp(opts.pRecordFile)) != kErrorOk)
         goto Exit;
 
     loopMain();
+    bench_writeReport();
 
 Exit:
     shutdownPowerlink();
@@ -269,6 +277,8 @@ This function implements the main loop of the demo application.
   application.
 - It sends a NMT command to start the stack
 - It loops and reacts on commands from the command line.
+- In benchmark mode it generates the benchmark load and exits if the duration
+  of the run has elapsed.
 */
 //------------------------------------------------------------------------------
 static void loopMain(void)
@@ -295,7 +305,10 @@ static void loopMain(void)
     PRINTF("\n-------------------------------\n");
     PRINTF("Press Esc to leave the program\n");
     PRINTF("Press r to reset the node\n");
+    PRINTF("Press s to show the cycle statistics\n");
     PRINTF("-------------------------------\n\n");
+    if (bench_isActive())
+        PRINTF("Benchmark mode is active\n\n");
     while (!fExit)
     {
         if (console_kbhit())
@@ -319,6 +332,10 @@ static void loopMain(void)
                     }
                     break;
 
+                case 's':
+                    printCycleStatistics();
+                    break;
+
                 case 0x1B:
                     fExit = TRUE;
                     break;
@@ -340,6 +357,12 @@ static void loopMain(void)
             PRINTF("Kernel stack has gone! Exiting...\n");
         }
 
+        if (bench_process())
+        {
+            fExit = TRUE;
+            PRINTF("Benchmark finished, exiting...\n");
+        }
+
 #if defined(CONFIG_USE_SYNCTHREAD) || defined(CONFIG_KERNELSTACK_DIRECTLINK)
         msleep(100);
 #else
@@ -384,6 +407,84 @@ static void shutdownPowerlink(void)
 
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Print cycle statistics
+
+The function prints the latency histograms of the cycle stages and the slot
+timings of the CNs recorded by the stack.
+*/
+//------------------------------------------------------------------------------
+static void printCycleStatistics(void)
+{
+    static const char*  apStageName[kCycleStatStageCount] =
+    {
+        "Cycle time", "PRes Rx", "RPDO", "Sync event", "App sync", "RPDO PI", "TPDO PI",
+        "SoC wire"
+    };
+    static tCycleStatistics statistics;
+    tOplkError          ret;
+    UINT                index;
+    char                name[32];
+
+    ret = oplk_getCycleStatistics(&statistics);
+    if (ret != kErrorOk)
+    {
+        PRINTF("Cycle statistics are not available (Error:0x%x)\n", ret);
+        return;
+    }
+
+    PRINTF("\n%-16s %10s %10s %10s %10s %10s %10s %10s\n", "[us]", "samples",
+           "min", "mean", "max", "p50", "p99", "p99.9");
+    for (index = 0; index < kCycleStatStageCount; index++)
+        printHistogram(apStageName[index], &statistics.aStage[index]);
+
+    for (index = 0; index < CYCLESTAT_NODE_COUNT; index++)
+    {
+        if (statistics.aNode[index].nodeId == 0)
+            break;
+
+        sprintf(name, "CN %3u SoC-PReq", statistics.aNode[index].nodeId);
+        printHistogram(name, &statistics.aNode[index].socToPreq);
+        sprintf(name, "CN %3u PReq-PRes", statistics.aNode[index].nodeId);
+        printHistogram(name, &statistics.aNode[index].preqToPres);
+        if (statistics.aNode[index].preqToPresWire.sampleCount != 0)
+        {
+            sprintf(name, "CN %3u wire", statistics.aNode[index].nodeId);
+            printHistogram(name, &statistics.aNode[index].preqToPresWire);
+        }
+    }
+    PRINTF("\n");
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print histogram
+
+The function prints a line with the summary of a cycle statistics histogram.
+
+\param  pName_p                 Name of the histogram.
+\param  pHistogram_p            Pointer to the histogram.
+*/
+//------------------------------------------------------------------------------
+static void printHistogram(const char* pName_p, const tCycleStatHistogram* pHistogram_p)
+{
+    if (pHistogram_p->sampleCount == 0)
+    {
+        PRINTF("%-16s %10u\n", pName_p, 0);
+        return;
+    }
+
+    PRINTF("%-16s %10u %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", pName_p,
+           pHistogram_p->sampleCount,
+           pHistogram_p->minTime / 1000.0,
+           ((double)pHistogram_p->totalTime / pHistogram_p->sampleCount) / 1000.0,
+           pHistogram_p->maxTime / 1000.0,
+           pHistogram_p->p50Time / 1000.0,
+           pHistogram_p->p99Time / 1000.0,
+           pHistogram_p->p999Time / 1000.0);
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Get command line parameters
@@ -407,9 +508,11 @@ static int getOptions(int argc_p, char** argv_p, tOptions* pOpts_p)
     /* setup default parameters */
     strncpy(pOpts_p->cdcFile, "mnobd.cdc", 256);
     pOpts_p->pLogFile = NULL;
+    pOpts_p->pRecordFile = NULL;
+    memset(&pOpts_p->bench, 0, sizeof(pOpts_p->bench));
 
     /* get command line parameters */
-    while ((opt = getopt(argc_p, argv_p, "c:l:")) != -1)
+    while ((opt = getopt(argc_p, argv_p, "c:l:p:b:t:s:a:j:")) != -1)
     {
         switch (opt)
         {
@@ -421,8 +524,39 @@ static int getOptions(int argc_p, char** argv_p, tOptions* pOpts_p)
                 pOpts_p->pLogFile = optarg;
                 break;
 
+            case 'p':
+                pOpts_p->pRecordFile = optarg;
+                break;
+
+            case 'b':
+                pOpts_p->bench.duration = strtoul(optarg, NULL, 10);
+                break;
+
+            case 't':
+                pOpts_p->bench.cycleLen = strtoul(optarg, NULL, 10);
+                break;
+
+            case 's':
+                pOpts_p->bench.sdoRate = strtoul(optarg, NULL, 10);
+                break;
+
+            case 'a':
+                pOpts_p->bench.asndRate = strtoul(optarg, NULL, 10);
+                break;
+
+            case 'j':
+                pOpts_p->bench.pReportFile = optarg;
+                break;
+
             default: /* '?' */
-                printf("Usage: %s [-c CDC-FILE] [-l LOGFILE]\n", argv_p[0]);
+                printf("Usage: %s [-c CDC-FILE] [-l LOGFILE] [-p RECORD-FILE] [-b DURATION [-t CYCLE-LEN] "
+                       "[-s SDO-RATE] [-a ASND-RATE] [-j REPORT-FILE]]\n", argv_p[0]);
+                printf("  -p  Record the process images of every cycle to RECORD-FILE\n");
+                printf("  -b  Run the benchmark mode for DURATION seconds\n");
+                printf("  -t  Cycle length of the benchmark in us (default: CDC)\n");
+                printf("  -s  SDO read requests per second to the operational CNs\n");
+                printf("  -a  ASnd frames per second to the operational CNs\n");
+                printf("  -j  File of the JSON report (default: stdout)\n");
                 return -1;
         }
     }
@@ -63,6 +63,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define SUBNET_MASK             0xFFFFFF00          // 255.255.255.0
 #define DEFAULT_GATEWAY         0xC0A864FE          // 192.168.100.C_ADR_RT1_DEF_NODE_ID
 #define MAC_ADDR                0x00, 0x12, 0x34, 0x56, 0x78, NODEID
+#define PROCESS_TIMEOUT         10                  // maximum time oplk_waitAndProcess() waits for work [ms]
 
 //------------------------------------------------------------------------------
 // module global vars
@@ -278,8 +279,8 @@ static tOplkError loopMain(tInstance* pInstance_p)
 
     while (1)
     {
-        // do background tasks
-        if ((ret = oplk_process()) != kErrorOk)
+        // do background tasks as soon as the stack has work
+        if ((ret = oplk_waitAndProcess(PROCESS_TIMEOUT)) != kErrorOk)
             break;
 
         if (oplk_checkKernelStack() == FALSE)
@@ -41,6 +41,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <QThread>
+#include <QAtomicInt>
+#include <QElapsedTimer>
 
 #include <oplk/oplk.h>
 #include "xap.h"
@@ -49,12 +51,32 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // const defines
 //------------------------------------------------------------------------------
 #define MAX_NODES       255
+#define MAX_DATA_NODES  3           // number of nodes exchanging data with the GUI
 
 //------------------------------------------------------------------------------
 // class definitions
 //------------------------------------------------------------------------------
 class QWidget;
 class QString;
+class QTimer;
+
+//------------------------------------------------------------------------------
+/**
+\brief  Snapshot of the synchronous data
+
+The snapshot is written by the synchronous data callback and sampled by the
+GUI at display rate.
+*/
+//------------------------------------------------------------------------------
+typedef struct
+{
+    UINT            cycleCount;                 ///< Number of processed cycles
+    UINT            input[MAX_DATA_NODES];      ///< Digital inputs of the nodes
+    UINT            leds[MAX_DATA_NODES];       ///< Digital outputs of the nodes
+    UINT            lastSyncTime;               ///< Execution time of the last synchronous callback [ns]
+    UINT            maxSyncTime;                ///< Maximum execution time of the synchronous callback [ns]
+    UINT            missedCycles;               ///< Number of cycles missed by the synchronous callback
+} tSyncSnapshot;
 
 //------------------------------------------------------------------------------
 /**
@@ -83,18 +105,34 @@ public:
 signals:
     void processImageInChanged(int data_p, int nodeId_p);
     void processImageOutChanged(int data_p, int nodeId_p);
+    void syncStatisticsChanged(const QString& strStatistics_p);
+
+private slots:
+    void updateGui();
 
 private:
+    void writeSnapshot(void);
+    bool readSnapshot(tSyncSnapshot* pSnapshot_p);
+
     //    volatile UINT   ackCount;
 
     UINT            cnt;
     UINT            leds[MAX_NODES];
-    UINT            ledsOld[MAX_NODES];
     UINT            input[MAX_NODES];
-    UINT            inputOld[MAX_NODES];
     UINT            period[MAX_NODES];
     int             toggle[MAX_NODES];
 
+    QAtomicInt      snapshotSequence;           ///< Sequence counter of the snapshot, odd while it is written
+    tSyncSnapshot   snapshot;                   ///< Snapshot written by the synchronous callback
+    tSyncSnapshot   guiSnapshot;                ///< Snapshot shown by the GUI
+    QTimer*         pGuiTimer;                  ///< Timer sampling the snapshot at display rate
+
+    QElapsedTimer   syncTimer;                  ///< Time base of the synchronous callback
+    qint64          lastSyncStart;              ///< Start time of the previous synchronous callback [ns]
+    UINT            cycleLen;                   ///< Cycle length [ns], 0 if unknown
+    UINT            lastSyncTime;
+    UINT            maxSyncTime;
+    UINT            missedCycles;
 };
 
 #endif //_INC_DataInOutThread_H_
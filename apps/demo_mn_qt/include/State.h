@@ -75,6 +75,7 @@ public:
 public slots:
     void setStatusLed(int status_p);
     void setNmtStateText(const QString& strState_p);
+    void setSyncStatisticsText(const QString& strStatistics_p);
 
 private:
     QPalette     PalGreenButton;
@@ -85,6 +86,7 @@ private:
 
     QLabel*      pStatusLed;
     QLabel*      pNmtStateLabel;
+    QLabel*      pSyncStatisticsLabel;
     QHBoxLayout* pNmtStateLayout;
 
     QToolButton* apNodes[NODE_ID_MAX + 1];
@@ -175,6 +175,8 @@ Api::Api(MainWindow* pMainWindow_p, UINT nodeId_p, QString devName_p)
                      pOutput, SLOT(setValue(int, int)));
     QObject::connect(pDataInOutThread, SIGNAL(processImageInChanged(int, int)),
                      pInput, SLOT(setLeds(int, int)));
+    QObject::connect(pDataInOutThread, SIGNAL(syncStatisticsChanged(const QString&)),
+                     pState, SLOT(setSyncStatisticsText(const QString&)));
 
     memset(&initParam, 0, sizeof(initParam));
     initParam.sizeOfInitParam = sizeof(initParam);
@@ -40,6 +40,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <QWidget>
 #include <QThread>
 #include <QString>
+#include <QTimer>
+
+#include <string.h>
 
 #include "Api.h"
 
@@ -49,6 +52,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define DEFAULT_MAX_CYCLE_COUNT 20      // 6 is very fast
 #define APP_LED_COUNT_1         8       // number of LEDs for CN1
 #define APP_LED_MASK_1          (1 << (APP_LED_COUNT_1 - 1))
+#define GUI_UPDATE_INTERVAL     40      // interval of the GUI update in ms
+#define SNAPSHOT_READ_RETRIES   4       // tries to read a consistent snapshot
 
 
 //------------------------------------------------------------------------------
@@ -87,16 +92,30 @@ DataInOutThread::DataInOutThread()
     int         i;
 
     /* initialize all application variables */
+    cnt = 0;
     for (i = 0; (i < MAX_NODES) && (usedNodeIds_g[i] != 0); i++)
     {
         leds[i] = 0;
-        ledsOld[i] = 0;
         input[i] = 0;
-        inputOld[i] = 0;
         toggle[i] = 0;
         period[i] = 0;
     }
 
+    memset(&snapshot, 0, sizeof(snapshot));
+    memset(&guiSnapshot, 0, sizeof(guiSnapshot));
+    lastSyncStart = 0;
+    cycleLen = 0;
+    lastSyncTime = 0;
+    maxSyncTime = 0;
+    missedCycles = 0;
+    syncTimer.start();
+
+    // The GUI samples the snapshot at display rate, so the synchronous
+    // callback never waits for the GUI.
+    pGuiTimer = new QTimer(this);
+    connect(pGuiTimer, SIGNAL(timeout()), this, SLOT(updateGui()));
+    pGuiTimer->start(GUI_UPDATE_INTERVAL);
+
     pDataInOutThread_g = this;
 }
 
@@ -106,7 +125,8 @@ DataInOutThread::DataInOutThread()
 \brief  Synchronous data callback
 
 The function implements the handling of synchronous data. It will be called
-from the stack at the synchronisation time.
+from the stack at the synchronisation time. The data for the GUI is only
+written into the snapshot, the function doesn't emit any signals.
 
 \return The function returns a tOplkError error code.
 */
@@ -115,6 +135,27 @@ tOplkError DataInOutThread::processSync(void)
 {
     tOplkError          ret;
     int                 i;
+    qint64              syncStart;
+    qint64              interval;
+    UINT32              cycleLenUs;
+    UINT                size;
+
+    syncStart = syncTimer.nsecsElapsed();
+
+    if (cycleLen == 0)
+    {   // the configuration is complete when the first cycle is processed,
+        // so fetch the cycle length from the local OD
+        size = sizeof(cycleLenUs);
+        if (oplk_readLocalObject(0x1006, 0x00, &cycleLenUs, &size) == kErrorOk)
+            cycleLen = cycleLenUs * 1000;
+    }
+    else if (cnt != 0)
+    {   // count the cycles which elapsed since the previous call
+        interval = syncStart - lastSyncStart;
+        if (interval > (qint64)(cycleLen + (cycleLen / 2)))
+            missedCycles += (UINT)((interval + (cycleLen / 2)) / cycleLen) - 1;
+    }
+    lastSyncStart = syncStart;
 
     ret = oplk_exchangeProcessImageOut();
     if (ret != kErrorOk)
@@ -160,18 +201,6 @@ tOplkError DataInOutThread::processSync(void)
                 }
             }
         }
-
-        if (input[i] != inputOld[i])
-        {
-            inChanged(input[i], usedNodeIds_g[i]);
-            inputOld[i] = input[i];
-        }
-
-        if (leds[i] != ledsOld[i])
-        {
-            outChanged(leds[i], usedNodeIds_g[i]);
-            ledsOld[i] = leds[i];
-        }
     }
 
     pProcessImageIn_l->CN1_M00_DigitalOutput_00h_AU8_DigitalOutput = leds[0];
@@ -180,6 +209,12 @@ tOplkError DataInOutThread::processSync(void)
 
     ret = oplk_exchangeProcessImageIn();
 
+    lastSyncTime = (UINT)(syncTimer.nsecsElapsed() - syncStart);
+    if (lastSyncTime > maxSyncTime)
+        maxSyncTime = lastSyncTime;
+
+    writeSnapshot();
+
     return ret;
 }
 
@@ -261,7 +296,6 @@ void DataInOutThread::run()
         {
             return;
         }
-        QThread::msleep(8);
     }
 }
 
@@ -279,3 +313,103 @@ tSyncCb DataInOutThread::getSyncCbFunc()
     return AppCbSync;
 }
 
+//============================================================================//
+//            P R I V A T E   M E M B E R   F U N C T I O N S                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update the GUI
+
+The function is called by the GUI timer at display rate. It samples the
+snapshot of the synchronous data and signals the changes to the GUI.
+*/
+//------------------------------------------------------------------------------
+void DataInOutThread::updateGui()
+{
+    tSyncSnapshot       newSnapshot;
+    int                 i;
+    UINT                cycles;
+
+    if (!readSnapshot(&newSnapshot) || (newSnapshot.cycleCount == guiSnapshot.cycleCount))
+        return;
+
+    for (i = 0; (i < MAX_DATA_NODES) && (usedNodeIds_g[i] != 0); i++)
+    {
+        if (newSnapshot.input[i] != guiSnapshot.input[i])
+            inChanged(newSnapshot.input[i], usedNodeIds_g[i]);
+
+        if (newSnapshot.leds[i] != guiSnapshot.leds[i])
+            outChanged(newSnapshot.leds[i], usedNodeIds_g[i]);
+    }
+
+    cycles = newSnapshot.cycleCount + newSnapshot.missedCycles;
+    emit syncStatisticsChanged(QString("Sync: %1 us (max. %2 us)  Missed cycles: %3 (%4 %)")
+                               .arg(newSnapshot.lastSyncTime / 1000)
+                               .arg(newSnapshot.maxSyncTime / 1000)
+                               .arg(newSnapshot.missedCycles)
+                               .arg((100.0 * newSnapshot.missedCycles) / cycles, 0, 'f', 2));
+
+    guiSnapshot = newSnapshot;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write the snapshot of the synchronous data
+
+The function is called by the synchronous data callback. The snapshot is
+protected by a sequence counter which is odd while the snapshot is written,
+so the writer never blocks.
+*/
+//------------------------------------------------------------------------------
+void DataInOutThread::writeSnapshot(void)
+{
+    int                 i;
+
+    snapshotSequence.fetchAndAddOrdered(1);
+
+    snapshot.cycleCount = cnt;
+    for (i = 0; (i < MAX_DATA_NODES) && (usedNodeIds_g[i] != 0); i++)
+    {
+        snapshot.input[i] = input[i];
+        snapshot.leds[i] = leds[i];
+    }
+    snapshot.lastSyncTime = lastSyncTime;
+    snapshot.maxSyncTime = maxSyncTime;
+    snapshot.missedCycles = missedCycles;
+
+    snapshotSequence.fetchAndAddOrdered(1);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read the snapshot of the synchronous data
+
+The function reads a consistent copy of the snapshot. If the snapshot is
+written during every try, the function gives up and the GUI is updated at the
+next timer interval.
+
+\param  pSnapshot_p     Pointer to store the snapshot.
+
+\return The function returns true if a consistent snapshot was read.
+*/
+//------------------------------------------------------------------------------
+bool DataInOutThread::readSnapshot(tSyncSnapshot* pSnapshot_p)
+{
+    int                 sequence;
+    int                 retry;
+
+    for (retry = 0; retry < SNAPSHOT_READ_RETRIES; retry++)
+    {
+        sequence = snapshotSequence.fetchAndAddOrdered(0);
+        if ((sequence & 1) != 0)
+            continue;
+
+        *pSnapshot_p = snapshot;
+
+        if (snapshotSequence.fetchAndAddOrdered(0) == sequence)
+            return true;
+    }
+
+    return false;
+}
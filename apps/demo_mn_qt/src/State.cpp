@@ -128,6 +128,9 @@ State::State(QWidget* parent)
 
     pStateLayout->addStretch(1);
 
+    pSyncStatisticsLabel = new QLabel();
+    pStateLayout->addWidget(pSyncStatisticsLabel);
+
 }
 
 //------------------------------------------------------------------------------
@@ -178,3 +181,17 @@ void State::setNmtStateText(const QString& strState_p)
     pNmtStateLabel->setText(strState_p);
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Sets the synchronous data statistics
+
+Sets the text to show for the timing of the synchronous data exchange.
+
+\param  strStatistics_p  Statistics text
+*/
+//------------------------------------------------------------------------------
+void State::setSyncStatisticsText(const QString& strStatistics_p)
+{
+    pSyncStatisticsLabel->setText(strStatistics_p);
+}
+
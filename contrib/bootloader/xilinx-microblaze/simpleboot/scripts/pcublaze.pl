@@ -58,7 +58,7 @@ $sync_word_2 = "8F9FAFBF";
 sub usage
 {
 	print "usage:\n
-		pc.pl [--format : outfile format {mcs|hex|bin}] [--swap : bit swap {on|off}] [--memfile : user data file {<filename.ext>}] [--promfile : PROM file {filename.{mcs|hex}}] [--outfile : PROM out file {filename.ext}]\n
+		pc.pl [--format : outfile format {mcs|hex|bin}] [--swap : bit swap {on|off}] [--compress : LZ4 compression {on|off}] [--memfile : user data file {<filename.ext>}] [--promfile : PROM file {filename.{mcs|hex}}] [--outfile : PROM out file {filename.ext}]\n
 		--help   = print this help page\n
 
 		--format = PROM file format used
@@ -70,6 +70,10 @@ sub usage
 			on  => swaps bits in every byte
 			off => bits are not swapped\n
 
+		--compress = Specify if the sections are compressed
+			on  => sections are LZ4 compressed and decompressed by the bootloader
+			off => sections are stored uncompressed\n
+
 		--memfile  = File containing user data to be added to PROM file\n
 
 		--promfile = PROM file to which the user data should be added\n
@@ -88,7 +92,7 @@ sub usage
 #-- prints usage if no command line parameters are passed or there is an unknown
 #   parameter or help option is passed
 if ( @ARGV < 1 or
-     !GetOptions('help|?' => \$help, 'format=s' => \$format, 'swap=s' => \$do_swap, 'memfile=s' => \$user_file, 'promfile=s' => \$prom_file, 'outfile=s' => \$out_file, )
+     !GetOptions('help|?' => \$help, 'format=s' => \$format, 'swap=s' => \$do_swap, 'compress=s' => \$do_compress, 'memfile=s' => \$user_file, 'promfile=s' => \$prom_file, 'outfile=s' => \$out_file, )
      or defined $help )
 {
 	usage();
@@ -134,6 +138,9 @@ if (@memfilecheck[$#memfilecheck] eq "mem")
 
 	$char_count = 4;
 
+	# collect the sections (address, size, data bytes)
+	@sections = ();
+
 	while (<MEMFILE>)
 	{
 		if ($_ =~ /^\/\/ Program/)
@@ -165,51 +172,49 @@ if (@memfilecheck[$#memfilecheck] eq "mem")
 
 			$address =~ s/@//g;
 
-			# print address to file
-			@groups = ( $address =~ /.{1,2}/gs );
-
-			foreach $byte(@groups)
-			{
-				print USERDATA $byte;
+			push(@sections, [$address, $size, []]);
+		}
+		else
+		{
+			#data stream detected
+			$new_mem_line = $_;
 
-				$char_count++;
+			$new_mem_line =~ s/^\s+//;
+			$new_mem_line =~ s/\s+$//;
 
-				if ($char_count == 16)
-				{
-					print USERDATA "\n";
-					$char_count = 0;
-				}
-			}
+			@split_mem_lines = split (/ /, $new_mem_line);
 
-			# print size to file
-			@groups = ( $size =~ /.{1,2}/gs );
+			push(@{$sections[-1][2]}, @split_mem_lines) if (@sections);
+		}
+	}
 
-			foreach $byte(@groups)
-			{
+	foreach $section(@sections)
+	{
+		($address, $size, $data) = @$section;
 
-				print USERDATA $byte;
+		if ($do_compress eq "on")
+		{
+			# compress section data and mark the section in the size word
+			$raw_data = pack("H*", join("", @$data));
+			$lz4_data = lz4_compress($raw_data);
+			$lz4_size = length($lz4_data);
 
-				$char_count++;
+			print "Compressed section $address from " . length($raw_data) . " to $lz4_size bytes\n";
 
-				if ($char_count == 16)
-				{
-					print USERDATA "\n";
-					$char_count = 0;
-				}
-			}
+			# pad the compressed data to a multiple of 4 bytes
+			$lz4_data .= "\0" x ((4 - ($lz4_size % 4)) % 4);
 
+			print_user_bytes($address);
+			print_user_bytes(sprintf("%08X", hex($size) | 0x80000000));
+			print_user_bytes(sprintf("%08X", $lz4_size));
+			print_user_bytes(uc(unpack("H*", $lz4_data)));
 		}
 		else
 		{
-			#data stream detected
-			$new_mem_line = $_;
-
-			$new_mem_line =~ s/^\s+//;
-			$new_mem_line =~ s/\s+$//;
+			print_user_bytes($address);
+			print_user_bytes($size);
 
-			@split_mem_lines = split (/ /, $new_mem_line);
-
-			foreach $line(@split_mem_lines)
+			foreach $line(@$data)
 			{
 				print USERDATA $line;
 
@@ -225,21 +230,7 @@ if (@memfilecheck[$#memfilecheck] eq "mem")
 	}
 
 	# write good by zeros
-	@split_end = ( "0000000000000000" =~ /.{1,2}/gs );
-
-	foreach $byte(@split_end)
-	{
-
-		print USERDATA $byte;
-
-		$char_count++;
-
-		if ($char_count == 16)
-		{
-			print USERDATA "\n";
-			$char_count = 0;
-		}
-	}
+	print_user_bytes("0000000000000000");
 
 	# fill last line with zeros to 16
 	$char_rest = 16 - $char_count;
@@ -309,6 +300,7 @@ print "\n\r";
 print "Running script with following settings:\n";
 print "	PROM file format		==>	$format\n";
 print "	Bit swapping			==>	$do_swap\n";
+print "	Compression			==>	$do_compress\n";
 print "	User data file			==>	$user_file\n";
 print "	Original PROM file		==>	$prom_file\n";
 print "	Temporary PROM file		==>	$prom_file.tmp\n";
@@ -988,4 +980,128 @@ sub decimal2binary
 sub binary2decimal
 {
     return unpack("N", pack("B32", substr("0" x 32 . shift, -32)));
-}
\ No newline at end of file
+}
+#
+#
+#
+#
+################################
+################################
+
+#Print a hex string byte-wise to the user data file
+sub print_user_bytes
+{
+	my @groups = ( shift =~ /.{1,2}/gs );
+
+	foreach $byte(@groups)
+	{
+		print USERDATA $byte;
+
+		$char_count++;
+
+		if ($char_count == 16)
+		{
+			print USERDATA "\n";
+			$char_count = 0;
+		}
+	}
+}
+
+#
+#
+#
+#
+################################
+################################
+
+#Compress data to an LZ4 block (greedy matching with a hash of 4 byte sequences)
+sub lz4_compress
+{
+	my $data = shift;
+	my $length = length($data);
+	my $out = "";
+	my %positions = ();
+	my $anchor = 0;
+	my $pos = 0;
+
+	# the last match must start 12 bytes and end 5 bytes before the end
+	while ($pos + 12 < $length)
+	{
+		my $sequence = substr($data, $pos, 4);
+		my $ref = $positions{$sequence};
+
+		$positions{$sequence} = $pos;
+
+		if (defined $ref and ($pos - $ref) <= 65535)
+		{
+			my $match_length = 4;
+
+			while (($pos + $match_length < $length - 5) and
+			       (substr($data, $ref + $match_length, 1) eq substr($data, $pos + $match_length, 1)))
+			{
+				$match_length++;
+			}
+
+			$out .= lz4_sequence(substr($data, $anchor, $pos - $anchor), $pos - $ref, $match_length);
+
+			$pos += $match_length;
+			$anchor = $pos;
+		}
+		else
+		{
+			$pos++;
+		}
+	}
+
+	# the last sequence contains only literals
+	$out .= lz4_sequence(substr($data, $anchor), 0, 0);
+
+	return $out;
+}
+
+#
+#
+#
+#
+################################
+################################
+
+#Encode an LZ4 sequence of literals and a match (no match if length is 0)
+sub lz4_sequence
+{
+	my ($literals, $offset, $match_length) = @_;
+	my $literal_length = length($literals);
+	my $out;
+	my $rest;
+
+	$match_length -= 4 if ($match_length > 0);
+
+	$out = pack("C", (($literal_length < 15 ? $literal_length : 15) << 4) |
+	                 ($match_length < 15 ? $match_length : 15));
+
+	if ($literal_length >= 15)
+	{
+		for ($rest = $literal_length - 15; $rest >= 255; $rest -= 255)
+		{
+			$out .= pack("C", 255);
+		}
+		$out .= pack("C", $rest);
+	}
+
+	$out .= $literals;
+
+	return $out if ($offset == 0);
+
+	$out .= pack("v", $offset);
+
+	if ($match_length >= 15)
+	{
+		for ($rest = $match_length - 15; $rest >= 255; $rest -= 255)
+		{
+			$out .= pack("C", 255);
+		}
+		$out .= pack("C", $rest);
+	}
+
+	return $out;
+}
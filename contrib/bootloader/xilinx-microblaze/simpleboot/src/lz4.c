@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holders nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Decompressor for LZ4 blocks (see lz4_Block_format.md of the LZ4 project).
+ * The compressed data is read from the flash in chunks, the literals of a
+ * sequence are read directly to the destination. Matches are copied from the
+ * already decompressed data in the destination, so no window buffer is needed.
+ */
+#include <string.h>
+#include "lz4.h"
+
+/************************** Constant Definitions *****************************/
+
+#define LZ4_MIN_MATCH           4
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+    LZ4_READ_FUNC_t ReadFunc;
+    u32 Address;                    // flash address of the next chunk
+    u32 Remaining;                  // bytes left in the flash
+    u32 Pos;                        // read position in the buffer
+    u32 Len;                        // valid bytes in the buffer
+    u8 Buf[LZ4_READ_CHUNK_LEN];
+} LZ4_READER_t;
+
+/************************** Variable Definitions *****************************/
+static LZ4_READER_t reader;
+
+/************************** Function Prototypes ******************************/
+static int lz4_get_byte(u8 *Data);
+static int lz4_get_bytes(u8 *Dst, u32 Len);
+static int lz4_get_length(u32 *Len);
+
+/****************************** Program **************************************/
+
+/*
+ * Decompress the LZ4 block of SrcLen bytes at the flash address SrcAddress to
+ * Dst. Returns the number of decompressed bytes or 0 if the block is invalid
+ * or does not fit into DstLen bytes.
+ */
+u32 lz4_decompress(LZ4_READ_FUNC_t ReadFunc, u32 SrcAddress, u32 SrcLen,
+                   u8 *Dst, u32 DstLen)
+{
+    u32 out = 0;
+    u32 len;
+    u32 offset;
+    u8 token;
+    u8 data;
+    u8 *match;
+
+    reader.ReadFunc = ReadFunc;
+    reader.Address = SrcAddress;
+    reader.Remaining = SrcLen;
+    reader.Pos = 0;
+    reader.Len = 0;
+
+    while(lz4_get_byte(&token) == 0)
+    {
+        /* literals */
+        len = token >> 4;
+        if((len == 15) && (lz4_get_length(&len) != 0))
+            return 0;
+
+        if(len > DstLen - out)
+            return 0;
+
+        if(lz4_get_bytes(Dst + out, len) != 0)
+            return 0;
+        out += len;
+
+        /* the last sequence contains only literals */
+        if(lz4_get_byte(&data) != 0)
+            break;
+
+        /* match */
+        offset = data;
+        if(lz4_get_byte(&data) != 0)
+            return 0;
+        offset |= (u32)data << 8;
+
+        if((offset == 0) || (offset > out))
+            return 0;
+
+        len = token & 0xF;
+        if((len == 15) && (lz4_get_length(&len) != 0))
+            return 0;
+        len += LZ4_MIN_MATCH;
+
+        if(len > DstLen - out)
+            return 0;
+
+        /* the match may overlap the output, so copy byte-wise */
+        match = Dst + out - offset;
+        out += len;
+        while(len--)
+        {
+            *(match + offset) = *match;
+            match++;
+        }
+    }
+
+    return out;
+}
+
+/*
+ * Get the next byte of the compressed data. Returns -1 at the end of the data.
+ */
+static int lz4_get_byte(u8 *Data)
+{
+    if(reader.Pos == reader.Len)
+    {
+        if(reader.Remaining == 0)
+            return -1;
+
+        reader.Len = (reader.Remaining > LZ4_READ_CHUNK_LEN) ?
+                     LZ4_READ_CHUNK_LEN : reader.Remaining;
+        reader.ReadFunc(reader.Address, reader.Buf, reader.Len);
+        reader.Address += reader.Len;
+        reader.Remaining -= reader.Len;
+        reader.Pos = 0;
+    }
+
+    *Data = reader.Buf[reader.Pos++];
+
+    return 0;
+}
+
+/*
+ * Get Len bytes of the compressed data. The bytes which are not in the buffer
+ * are read from the flash directly to Dst.
+ */
+static int lz4_get_bytes(u8 *Dst, u32 Len)
+{
+    u32 count;
+
+    count = reader.Len - reader.Pos;
+    if(count > Len)
+        count = Len;
+
+    memcpy(Dst, reader.Buf + reader.Pos, count);
+    reader.Pos += count;
+    Dst += count;
+    Len -= count;
+
+    if(Len == 0)
+        return 0;
+
+    if(Len > reader.Remaining)
+        return -1;
+
+    if(Len >= LZ4_READ_CHUNK_LEN)
+    {
+        reader.ReadFunc(reader.Address, Dst, Len);
+        reader.Address += Len;
+        reader.Remaining -= Len;
+        return 0;
+    }
+
+    while(Len--)
+    {
+        if(lz4_get_byte(Dst++) != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * Add the extension bytes of a literal or match length to Len.
+ */
+static int lz4_get_length(u32 *Len)
+{
+    u8 data;
+
+    do {
+        if(lz4_get_byte(&data) != 0)
+            return -1;
+        *Len += data;
+    } while(data == 255);
+
+    return 0;
+}
@@ -19,6 +19,7 @@
 #include "global.h"
 #include "spi.h"
 #include "util.h"
+#include "lz4.h"
 #include "mb_interface.h"
 #include "xil_cache.h"
 
@@ -109,6 +110,7 @@
 /************************** Function Prototypes ******************************/
 static Xuint32 DetectSync(void);
 Xuint32 load_section(Xuint32 SourceAddress, Xuint32 *SectStrtAddr, u8 first_section);
+static void read_flash(u32 Address, u8 *Buf, u32 Len);
 #if SPI_FLASH == 0
   void* mycpy(void* dest, const void* src, size_t count);
 #endif
@@ -278,11 +280,7 @@ u32 load_section(u32 SourceAddress, u32 *SectStrtAddr, u8 first_section){
 
     u32 SectionStartAddress;
     u32 SectionSizeByte;
-#if SPI_FLASH == 1 && BIT_SWAP_ON == 1
-    //volatile u16 *dptr16;
-    volatile u8 *dptr8;
-    volatile u8 spi_data;
-#endif
+    u32 CompressedSizeByte = 0;
     volatile u16 data[4];
     u32 address;
 
@@ -338,12 +336,33 @@ u32 load_section(u32 SourceAddress, u32 *SectStrtAddr, u8 first_section){
     SectionSizeByte = BitReOrder16(data[0]);
     SectionSizeByte = (SectionSizeByte << 16) | BitReOrder16(data[1]);
 
+    /*
+     * Compressed sections contain the size of the LZ4 block after the size
+     * of the section. The block is padded to a multiple of 4 bytes.
+     */
+    if(SectionSizeByte & LZ4_SECTION_FLAG)
+    {
+        SectionSizeByte &= ~LZ4_SECTION_FLAG;
+
+#if SPI_FLASH == 1
+        spi_fast_read(&spi_inst, address, (u8 *)&data[0], 4);
+#else
+        mycpy(&data, (void *)address, 4);
+#endif
+        address += 4;
+
+        CompressedSizeByte = BitReOrder16(data[0]);
+        CompressedSizeByte = (CompressedSizeByte << 16) | BitReOrder16(data[1]);
+    }
+
 #if DEBUG
     print("Section size 0x");
     putnum(SectionSizeByte);
+    print(" compressed size 0x");
+    putnum(CompressedSizeByte);
     print("\r\n");
 
-    if((address + SectionSizeByte) > FLASH_END_ADDRESS)
+    if((address + (CompressedSizeByte ? CompressedSizeByte : SectionSizeByte)) > FLASH_END_ADDRESS)
     {
         print("Failed: Invalid section size\r\n");
 
@@ -352,37 +371,77 @@ u32 load_section(u32 SourceAddress, u32 *SectStrtAddr, u8 first_section){
 #endif
 
     /* Load program to sdram */
-#if SPI_FLASH == 1
-    #if BIT_SWAP_ON == 0
-    spi_fast_read(&spi_inst, address, (u8 *)SectionStartAddress, SectionSizeByte);
-    address += SectionSizeByte;
-    #else
-    dptr8 = (u8 *)SectionStartAddress;
-    do{
-        spi_fast_read(&spi_inst, address, (u8 *)&spi_data, 1);
-        address += 1;
-        *dptr8++ = BitReOrder8(spi_data);
-    } while(--SectionSizeByte > 0);
-    #endif
-#else
-    mycpy((void *)SectionStartAddress, (void *)address, SectionSizeByte);
-    address += SectionSizeByte;
+    if(CompressedSizeByte != 0)
+    {
+        if(lz4_decompress(read_flash, address, CompressedSizeByte,
+                          (u8 *)SectionStartAddress, SectionSizeByte) != SectionSizeByte)
+        {
+#if DEBUG
+            print("Failed: Invalid compressed section\r\n");
 #endif
-
+            return 0;
+        }
+        address += (CompressedSizeByte + 3) & ~3;
+    }
+    else
+    {
+        read_flash(address, (u8 *)SectionStartAddress, SectionSizeByte);
+        address += SectionSizeByte;
+    }
 
     return address;
 
 }
 
+/*
+ * Read Len bytes from the flash at Address to Buf
+ *
+ * Note:     1.     The SPI flash is read by a single fast read command, the
+ *                  bits are reordered in the destination afterwards
+ */
+static void read_flash(u32 Address, u8 *Buf, u32 Len)
+{
+#if SPI_FLASH == 1
+    spi_fast_read(&spi_inst, Address, Buf, Len);
+  #if BIT_SWAP_ON == 1
+    while(Len--)
+    {
+        *Buf = BitReOrder8(*Buf);
+        Buf++;
+    }
+  #endif
+#else
+    mycpy(Buf, (void *)Address, Len);
+#endif
+}
+
 #if SPI_FLASH == 0
 /**
  * simple memcpy which copies size data from src to dst
+ *
+ * If source and destination are word aligned and no bit swap is needed the
+ * data is copied word-wise, so the flash is read with full bus width.
  */
 void* mycpy(void* dest, const void* src, size_t count)
 {
         char* dst8 = (char*)dest;
         char* src8 = (char*)src;
 
+#if BIT_SWAP_ON == 0
+        if ((((u32)dst8 | (u32)src8) & 3) == 0) {
+            u32* dst32 = (u32*)dst8;
+            u32* src32 = (u32*)src8;
+
+            while (count >= 4) {
+                *dst32++ = *src32++;
+                count -= 4;
+            }
+
+            dst8 = (char*)dst32;
+            src8 = (char*)src32;
+        }
+#endif
+
         while (count--) {
 #if BIT_SWAP_ON == 0
             *dst8++ = *src8++;
@@ -48,7 +48,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <oplk/oplk.h>
 #include <oplk/debugstr.h>
+#include <common/target.h>
 #include <kernel/ctrlk.h>
+#include <kernel/eventkcal.h>
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -73,14 +75,41 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#ifndef DAEMON_IDLE_DELAY_MIN_US
+#define DAEMON_IDLE_DELAY_MIN_US        2       // First delay of an idle background loop [us]
+#endif
+
+#ifndef DAEMON_IDLE_DELAY_MAX_US
+#define DAEMON_IDLE_DELAY_MAX_US        100     // Maximum delay of an idle background loop [us] (0 = busy polling)
+#endif
+
+#ifndef DAEMON_PROFILE_INTERVAL_MS
+#define DAEMON_PROFILE_INTERVAL_MS      0       // Interval of the background loop profile output [ms] (0 = disabled)
+#endif
 
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
 
+/**
+\brief Background loop profile
+
+The structure contains the profile of the background loop. It shows how much
+time of the PCP is spent for processing and for idle delays.
+*/
+typedef struct
+{
+    UINT32              iterationCount;             ///< Number of loop iterations
+    UINT32              busyIterationCount;         ///< Number of iterations which processed events
+    UINT32              maxProcessTime;             ///< Maximum processing time of an iteration [ns]
+    ULONGLONG           processTime;                ///< Total processing time [ns]
+    ULONGLONG           idleTime;                   ///< Total time of the idle delays [ns]
+} tDaemonProfile;
+
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
+static tDaemonProfile   profile_l;
 
 //------------------------------------------------------------------------------
 // local function prototypes
@@ -88,6 +117,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 static tOplkError initPlk(void);
 static void shtdPlk(void);
 static void bgtPlk(void);
+static void printProfile(void);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -188,20 +218,103 @@ static void shtdPlk(void)
 /**
 \brief    openPOWERLINK stack background tasks
 
-This function runs the background tasks
+This function runs the background tasks. The events are processed by
+ctrlk_process() in bounded batches (see eventkcal_process()). If an iteration
+finds no events, the loop waits before the next poll of the host interface.
+The delay doubles with every idle iteration up to DAEMON_IDLE_DELAY_MAX_US and
+is reset as soon as events are processed. The delay loop runs from the
+instruction cache and does not access the memory bus, so the idle loop does
+not delay the memory accesses of the DLL interrupt handlers.
 */
 //------------------------------------------------------------------------------
 static void bgtPlk(void)
 {
-    BOOL fExit = FALSE;
+    BOOL                    fExit = FALSE;
+    tEventBatchStatistics   statistics;
+    UINT32                  lastEventCount;
+    UINT32                  idleDelay = 0;
+    UINT32                  processTime;
+    ULONGLONG               startCycles;
+    ULONGLONG               idleCycles;
+#if (DAEMON_PROFILE_INTERVAL_MS != 0)
+    ULONGLONG               printCycles;
+#endif
+
+    OPLK_MEMSET(&profile_l, 0, sizeof(tDaemonProfile));
+    eventkcal_getBatchStatistics(&statistics);
+    lastEventCount = statistics.eventCount;
+#if (DAEMON_PROFILE_INTERVAL_MS != 0)
+    printCycles = target_getCycleCounter();
+#endif
 
     while (1)
     {
         ctrlk_updateHeartbeat();
+
+        startCycles = target_getCycleCounter();
         fExit = ctrlk_process();
+        processTime = (UINT32)target_convertCyclesToNs(target_getCycleCounter() - startCycles);
+
+        profile_l.iterationCount++;
+        profile_l.processTime += processTime;
+        if (processTime > profile_l.maxProcessTime)
+            profile_l.maxProcessTime = processTime;
 
         if (fExit != FALSE)
             break;
+
+        eventkcal_getBatchStatistics(&statistics);
+        if (statistics.eventCount != lastEventCount)
+        {   // Events were processed, poll again immediately
+            lastEventCount = statistics.eventCount;
+            profile_l.busyIterationCount++;
+            idleDelay = 0;
+        }
+        else if (DAEMON_IDLE_DELAY_MAX_US != 0)
+        {
+            idleDelay = (idleDelay == 0) ? DAEMON_IDLE_DELAY_MIN_US : (idleDelay * 2);
+            if (idleDelay > DAEMON_IDLE_DELAY_MAX_US)
+                idleDelay = DAEMON_IDLE_DELAY_MAX_US;
+
+            idleCycles = target_getCycleCounter();
+            usleep(idleDelay);
+            profile_l.idleTime += target_convertCyclesToNs(target_getCycleCounter() - idleCycles);
+        }
+
+#if (DAEMON_PROFILE_INTERVAL_MS != 0)
+        if (target_convertCyclesToNs(target_getCycleCounter() - printCycles) >=
+            DAEMON_PROFILE_INTERVAL_MS * 1000000ULL)
+        {
+            printProfile();
+            printCycles = target_getCycleCounter();
+        }
+#endif
     }
+
+    printProfile();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Print the background loop profile
+
+This function prints the profile of the background loop and the statistics of
+the event batches.
+*/
+//------------------------------------------------------------------------------
+static void printProfile(void)
+{
+    tEventBatchStatistics   statistics;
+
+    eventkcal_getBatchStatistics(&statistics);
+
+    PRINTF("Background loop: %lu iterations (%lu busy), process %lu us (max %lu ns), idle %lu us\n",
+           (ULONG)profile_l.iterationCount, (ULONG)profile_l.busyIterationCount,
+           (ULONG)(profile_l.processTime / 1000), (ULONG)profile_l.maxProcessTime,
+           (ULONG)(profile_l.idleTime / 1000));
+    PRINTF("Event batches: %lu batches, %lu events (max %lu), %lu budget stops, max %lu ns\n",
+           (ULONG)statistics.batchCount, (ULONG)statistics.eventCount,
+           (ULONG)statistics.maxBatchSize, (ULONG)statistics.budgetExceededCount,
+           (ULONG)statistics.maxBatchTime);
 }
 
@@ -48,6 +48,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <linux/errno.h>
 #include <linux/version.h>
 #include <linux/mm.h>
+#include <linux/poll.h>
 #include <asm/page.h>
 #include <asm/uaccess.h>
 #include <asm/page.h>
@@ -65,6 +66,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <kernel/eventk.h>
 #include <kernel/eventkcal.h>
+#include <kernel/edrvirq.h>
 #include <errhndkcal.h>
 
 //============================================================================//
@@ -135,6 +137,7 @@ static  long    powerlinkIoctl(struct file* filp, unsigned int cmd, unsigned lon
 static int      powerlinkIoctl(struct inode* dev, struct file* filp, unsigned int cmd, unsigned long arg);
 #endif
 
+static unsigned int powerlinkPoll(struct file* filp, struct poll_table_struct* wait);
 static int      powerlinkMmap(struct file* filp, struct vm_area_struct* vma);
 static void     powerlinkVmaOpen(struct vm_area_struct* vma);
 static void     powerlinkVmaClose(struct vm_area_struct* vma);
@@ -145,8 +148,12 @@ static int      storeInitParam(unsigned long arg);
 static int      getStatus(unsigned long arg);
 static int      getHeartbeat(unsigned long arg);
 static int      sendAsyncFrame(unsigned long arg);
+static int      sendAsyncFrames(unsigned long arg);
 static int      writeErrorObject(unsigned long arg);
 static int      readErrorObject(unsigned long arg);
+static int      setSyncEventFd(unsigned long arg);
+static int      setIrqConfig(unsigned long arg);
+static int      getIrqConfig(unsigned long arg);
 
 static void     increaseHeartbeatCb(ULONG data_p);
 static void     startHeartbeatTimer(ULONG timeInMs_p);
@@ -171,6 +178,7 @@ static struct file_operations  powerlinkFileOps_g =
     .ioctl =     powerlinkIoctl,
 #endif
     .mmap =      powerlinkMmap,
+    .poll =      powerlinkPoll,
 };
 
 static struct vm_operations_struct powerlinkVmOps =
@@ -377,7 +385,6 @@ static int  powerlinkIoctl(struct inode* dev, struct file* filp,
 #endif
 {
     int             ret;
-    tOplkError      oplRet;
 
     //DEBUG_LVL_ALWAYS_TRACE("PLK: + powerlinkIoctl (cmd=%d type=%d)...\n", _IOC_NR(cmd), _IOC_TYPE(cmd));
     ret = -EINVAL;
@@ -406,12 +413,12 @@ static int  powerlinkIoctl(struct inode* dev, struct file* filp,
             ret = getHeartbeat(arg);
             break;
 
-        case PLK_CMD_POST_EVENT:
-            ret = eventkcal_postEventFromUser(arg);
+        case PLK_CMD_DLLCAL_ASYNCSEND_MULTI:
+            ret = sendAsyncFrames(arg);
             break;
 
-        case PLK_CMD_GET_EVENT:
-            ret = eventkcal_getEventForUser(arg);
+        case PLK_CMD_SIGNAL_EVENT:
+            ret = eventkcal_signalEventFromUser();
             break;
 
         case PLK_CMD_DLLCAL_ASYNCSEND:
@@ -426,11 +433,16 @@ static int  powerlinkIoctl(struct inode* dev, struct file* filp,
             ret = readErrorObject(arg);
             break;
 
-        case PLK_CMD_PDO_SYNC:
-            if ((oplRet = pdokcal_waitSyncEvent()) == kErrorRetry)
-                ret = -ERESTARTSYS;
-            else
-                ret = 0;
+        case PLK_CMD_PDO_SYNC_EVENTFD:
+            ret = setSyncEventFd(arg);
+            break;
+
+        case PLK_CMD_IRQ_SET_CONFIG:
+            ret = setIrqConfig(arg);
+            break;
+
+        case PLK_CMD_IRQ_GET_CONFIG:
+            ret = getIrqConfig(arg);
             break;
 
         default:
@@ -448,14 +460,24 @@ static int  powerlinkIoctl(struct inode* dev, struct file* filp,
 /**
 \brief  openPOWERLINK driver mmap function
 
-The function implements openPOWERLINK kernel module mmap function.
+The function implements openPOWERLINK kernel module mmap function. The memory
+area is selected by the page offset (PLK_MMAP_PGOFF_xxx). Besides the PDO
+memory the K2U and U2K event queues, the PDO sync information and the kernel
+stack status can be mapped. The PDO buffers can be mapped cached,
+write-combining or uncached, the page with the buffer control information is
+always mapped cached.
 
 \ingroup module_driver_linux_kernel
 */
 //------------------------------------------------------------------------------
 static int powerlinkMmap(struct file* filp, struct vm_area_struct* vma)
 {
-    BYTE*       pPdoMem;
+    BYTE*               pMem;
+    size_t              memSize;
+    size_t              mapSize = vma->vm_end - vma->vm_start;
+    size_t              cachedSize = mapSize;
+    pgprot_t            bufferProt = vma->vm_page_prot;
+    tPdoMemCacheMode    cacheMode;
 
     DEBUG_LVL_ALWAYS_TRACE("%s() vma: vm_start:%lX vm_end:%lX vm_pgoff:%lX\n",
                            __func__, vma->vm_start, vma->vm_end, vma->vm_pgoff);
@@ -463,24 +485,121 @@ static int powerlinkMmap(struct file* filp, struct vm_area_struct* vma)
     vma->vm_flags |= VM_RESERVED;
     vma->vm_ops = &powerlinkVmOps;
 
-    if ((pPdoMem = pdokcal_getPdoMemRegion()) == NULL)
+    switch (vma->vm_pgoff)
     {
-        DEBUG_LVL_ERROR_TRACE("%s() no pdo memory allocated!\n", __func__);
-        return -ENOMEM;
+        case PLK_MMAP_PGOFF_PDO:
+        case PLK_MMAP_PGOFF_PDO_WC:
+        case PLK_MMAP_PGOFF_PDO_UC:
+            if ((pMem = pdokcal_getPdoMemRegion()) == NULL)
+            {
+                DEBUG_LVL_ERROR_TRACE("%s() no pdo memory allocated!\n", __func__);
+                return -ENOMEM;
+            }
+
+            switch (vma->vm_pgoff)
+            {
+                case PLK_MMAP_PGOFF_PDO_WC:
+                    cacheMode = kPdoMemWriteCombine;
+                    bufferProt = pgprot_writecombine(vma->vm_page_prot);
+                    break;
+
+                case PLK_MMAP_PGOFF_PDO_UC:
+                    cacheMode = kPdoMemUncached;
+                    bufferProt = pgprot_noncached(vma->vm_page_prot);
+                    break;
+
+                default:
+                    cacheMode = kPdoMemCached;
+                    break;
+            }
+
+            if (pdokcal_setMemCacheMode(cacheMode, &cachedSize) != kErrorOk)
+            {
+                DEBUG_LVL_ERROR_TRACE("%s() memory type %d of the pdo memory not available!\n",
+                                      __func__, cacheMode);
+                return -EINVAL;
+            }
+
+            if (cachedSize > mapSize)
+                cachedSize = mapSize;
+            break;
+
+        case PLK_MMAP_PGOFF_PDO_SYNC:
+            if ((pMem = pdokcal_getSyncInfoMem()) == NULL)
+            {
+                DEBUG_LVL_ERROR_TRACE("%s() no sync information allocated!\n", __func__);
+                return -ENOMEM;
+            }
+
+            if ((vma->vm_end - vma->vm_start > PAGE_SIZE) || ((vma->vm_flags & VM_WRITE) != 0))
+                return -EINVAL;
+            break;
+
+        case PLK_MMAP_PGOFF_CTRL_STATUS:
+            if ((pMem = ctrlkcal_getStatusMem()) == NULL)
+            {
+                DEBUG_LVL_ERROR_TRACE("%s() no status memory allocated!\n", __func__);
+                return -ENOMEM;
+            }
+
+            if ((vma->vm_end - vma->vm_start > PAGE_SIZE) || ((vma->vm_flags & VM_WRITE) != 0))
+                return -EINVAL;
+            break;
+
+        case PLK_MMAP_PGOFF_EVENT_K2U:
+        case PLK_MMAP_PGOFF_EVENT_U2K:
+            pMem = eventkcal_getQueueMem((vma->vm_pgoff == PLK_MMAP_PGOFF_EVENT_K2U) ?
+                                         kEventQueueK2U : kEventQueueU2K, &memSize);
+            if (pMem == NULL)
+            {
+                DEBUG_LVL_ERROR_TRACE("%s() no event queue memory allocated!\n", __func__);
+                return -ENOMEM;
+            }
+
+            if (vma->vm_end - vma->vm_start > PAGE_ALIGN(memSize))
+                return -EINVAL;
+            break;
+
+        default:
+            return -EINVAL;
     }
 
-    if (remap_pfn_range(vma, vma->vm_start, (__pa(pPdoMem) >> PAGE_SHIFT),
-                        vma->vm_end - vma->vm_start, vma->vm_page_prot))
+    if (remap_pfn_range(vma, vma->vm_start, (__pa(pMem) >> PAGE_SHIFT),
+                        cachedSize, vma->vm_page_prot))
     {
         DEBUG_LVL_ERROR_TRACE("%s() remap_pfn_range failed\n", __func__);
         return -EAGAIN;
     }
 
+    // the PDO buffers behind the control information may use another memory type
+    if ((mapSize > cachedSize) &&
+        remap_pfn_range(vma, vma->vm_start + cachedSize, (__pa(pMem + cachedSize) >> PAGE_SHIFT),
+                        mapSize - cachedSize, bufferProt))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() remap_pfn_range of the pdo buffers failed\n", __func__);
+        return -EAGAIN;
+    }
+
     powerlinkVmaOpen(vma);
     return 0;
 
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  openPOWERLINK driver poll function
+
+The function implements openPOWERLINK kernel module poll function. The device
+is readable if events for the user layer are available in the K2U queue.
+
+\ingroup module_driver_linux_kernel
+*/
+//------------------------------------------------------------------------------
+static unsigned int powerlinkPoll(struct file* filp, struct poll_table_struct* wait)
+{
+    return eventkcal_pollEventForUser(filp, wait);
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  openPOWERLINK driver VMA open functionnet
@@ -536,6 +655,11 @@ static int executeCmd(unsigned long arg)
     if (copy_from_user(&ctrlCmd, (const void __user *)arg, sizeof(tCtrlCmd)))
         return -EFAULT;
 
+    // stop updating the module values of the status page before the
+    // kernel modules are shut down
+    if (ctrlkcal_getStatus() == kCtrlStatusRunning)
+        ctrlkcal_setStatus(kCtrlStatusReady);
+
     ctrlk_executeCmd(ctrlCmd.cmd, &ret, &status, NULL);
     ctrlCmd.cmd = 0;
     ctrlCmd.retVal = ret;
@@ -653,7 +777,8 @@ static int sendAsyncFrame(unsigned long arg)
         return -EFAULT;
     }
 
-    if (copy_from_user(pBuf, (const void __user *)asyncFrameInfo.pData, asyncFrameInfo.size))
+    if ((asyncFrameInfo.size > C_DLL_MAX_ASYNC_MTU) ||
+        copy_from_user(pBuf, (const void __user *)asyncFrameInfo.pData, asyncFrameInfo.size))
     {
         free_pages((ULONG)pBuf, order);
         return -EFAULT;
@@ -670,6 +795,94 @@ static int sendAsyncFrame(unsigned long arg)
     return 0;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Send multiple async frames ioctl
+
+The function implements the ioctl for sending an array of asynchronous frames
+with one call. The result of each frame is returned in the status array. The
+DLL is triggered once for each priority which got new frames. Afterwards the
+fill levels of the NMT and generic queues are returned.
+
+\ingroup module_driver_linux_kernel
+*/
+//------------------------------------------------------------------------------
+static int sendAsyncFrames(unsigned long arg)
+{
+    BYTE*                   pBuf;
+    tIoctlDllCalAsyncMulti  multiInfo;
+    tIoctlDllCalAsync       aFrameInfo[PLK_DLLCAL_ASYNCSEND_MAX_FRAMES];
+    tOplkError              aStatus[PLK_DLLCAL_ASYNCSEND_MAX_FRAMES];
+    tFrameInfo              frameInfo;
+    BOOL                    afFillTx[2] = {FALSE, FALSE};
+    tDllAsyncReqPriority    priority;
+    tEvent                  event;
+    ULONG                   fillLevel;
+    UINT                    i;
+    int                     order;
+    int                     ret = 0;
+
+    if (copy_from_user(&multiInfo, (const void __user *)arg, sizeof(tIoctlDllCalAsyncMulti)))
+        return -EFAULT;
+
+    if ((multiInfo.frameCount == 0) || (multiInfo.frameCount > PLK_DLLCAL_ASYNCSEND_MAX_FRAMES))
+        return -EINVAL;
+
+    if (copy_from_user(aFrameInfo, (const void __user *)multiInfo.pFrames,
+                       multiInfo.frameCount * sizeof(tIoctlDllCalAsync)))
+        return -EFAULT;
+
+    order = get_order(C_DLL_MAX_ASYNC_MTU);
+    if ((pBuf = (BYTE*)__get_free_pages(GFP_KERNEL, order)) == NULL)
+        return -ENOMEM;
+
+    for (i = 0; i < multiInfo.frameCount; i++)
+    {
+        if ((aFrameInfo[i].size > C_DLL_MAX_ASYNC_MTU) ||
+            copy_from_user(pBuf, (const void __user *)aFrameInfo[i].pData, aFrameInfo[i].size))
+        {
+            aStatus[i] = kErrorInvalidOperation;
+            continue;
+        }
+
+        frameInfo.pFrame = (tPlkFrame*)pBuf;
+        frameInfo.frameSize = aFrameInfo[i].size;
+        aStatus[i] = dllkcal_writeAsyncFrame(&frameInfo, aFrameInfo[i].queue);
+
+        if ((aStatus[i] == kErrorOk) && (aFrameInfo[i].queue != kDllCalQueueTxSync))
+            afFillTx[aFrameInfo[i].queue == kDllCalQueueTxNmt] = TRUE;
+    }
+
+    free_pages((ULONG)pBuf, order);
+
+    // trigger the DLL once for each priority
+    for (i = 0; i < 2; i++)
+    {
+        if (!afFillTx[i])
+            continue;
+
+        priority = (i != 0) ? kDllAsyncReqPrioNmt : kDllAsyncReqPrioGeneric;
+        event.eventSink = kEventSinkDllk;
+        event.eventType = kEventTypeDllkFillTx;
+        OPLK_MEMSET(&event.netTime, 0x00, sizeof(event.netTime));
+        event.pEventArg = &priority;
+        event.eventArgSize = sizeof(priority);
+        eventk_postEvent(&event);
+    }
+
+    dllkcal_getAsyncQueueCount(kDllCalQueueTxNmt, &fillLevel);
+    multiInfo.fillLevelNmt = (UINT32)fillLevel;
+    dllkcal_getAsyncQueueCount(kDllCalQueueTxGen, &fillLevel);
+    multiInfo.fillLevelGen = (UINT32)fillLevel;
+
+    if (copy_to_user((void __user *)multiInfo.pStatus, aStatus,
+                     multiInfo.frameCount * sizeof(tOplkError)) ||
+        copy_to_user((void __user *)arg, &multiInfo, sizeof(tIoctlDllCalAsyncMulti)))
+        ret = -EFAULT;
+
+    return ret;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Write error object ioctl
@@ -719,6 +932,72 @@ static int readErrorObject(unsigned long arg)
     return 0;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Set sync eventfd ioctl
+
+The function implements the ioctl for registering the eventfd which is
+signaled on every sync event.
+
+\ingroup module_driver_linux_kernel
+*/
+//------------------------------------------------------------------------------
+static int setSyncEventFd(unsigned long arg)
+{
+    int             eventFd;
+
+    if (copy_from_user(&eventFd, (const void __user *)arg, sizeof(int)))
+        return -EFAULT;
+
+    return pdokcal_setSyncEventFd(eventFd);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set interrupt configuration ioctl
+
+The function implements the ioctl for changing the CPU affinity of the
+controller interrupts and the priorities of the interrupt threads and the
+kernel threads.
+
+\ingroup module_driver_linux_kernel
+*/
+//------------------------------------------------------------------------------
+static int setIrqConfig(unsigned long arg)
+{
+    tIrqConfig      irqConfig;
+
+    if (copy_from_user(&irqConfig, (const void __user *)arg, sizeof(tIrqConfig)))
+        return -EFAULT;
+
+    if (edrvirq_setConfig(&irqConfig) != kErrorOk)
+        return -EINVAL;
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get interrupt configuration ioctl
+
+The function implements the ioctl for reading the interrupt configuration and
+the effective settings of the controller interrupts and the kernel threads.
+
+\ingroup module_driver_linux_kernel
+*/
+//------------------------------------------------------------------------------
+static int getIrqConfig(unsigned long arg)
+{
+    tIrqConfig      irqConfig;
+
+    edrvirq_getConfig(&irqConfig);
+
+    if (copy_to_user((void __user *)arg, &irqConfig, sizeof(tIrqConfig)))
+        return -EFAULT;
+
+    return 0;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Start heartbeat timer
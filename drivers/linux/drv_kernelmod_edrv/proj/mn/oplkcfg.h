@@ -63,6 +63,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define CONFIG_DLLCAL_QUEUE                         CIRCBUF_QUEUE
 
+// The event queues between kernel and user layer are mapped into user space
+// and are therefore used in lock-free mode
+#define CIRCBUF_LOCKFREE_BUFFERS                    ((1UL << CIRCBUF_USER_TO_KERNEL_QUEUE) | \
+                                                     (1UL << CIRCBUF_KERNEL_TO_USER_QUEUE))
+
 
 //==============================================================================
 // Ethernet driver (Edrv) specific defines
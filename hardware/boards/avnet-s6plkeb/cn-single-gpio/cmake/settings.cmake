@@ -79,4 +79,4 @@ SET(CFG_PROMGEN_FLAGS "-w -p mcs -c FF")
 SET(CFG_PROMGEN_TYPE "-s 8192 -u 0000")
 SET(CFG_PROMGEN_PREFIX "-spi")
 
-SET(CFG_PCUBLAZE_PARAMS "--format mcs --swap off")
+SET(CFG_PCUBLAZE_PARAMS "--format mcs --swap off --compress on")
@@ -197,6 +197,7 @@ tHostifReturn hostif_irqRegHdl(tHostifInstance pInstance_p,
                                tHostifIrqSrc irqSrc_p, tHostifIrqCb pfnCb_p);
 tHostifReturn hostif_irqSourceEnable(tHostifInstance pInstance_p,
                                      tHostifIrqSrc irqSrc_p, BOOL fEnable_p);
+tHostifReturn hostif_irqSet(tHostifInstance pInstance_p, tHostifIrqSrc irqSrc_p);
 tHostifReturn hostif_irqMasterEnable(tHostifInstance pInstance_p,
                                      BOOL fEnable_p);
 
@@ -218,6 +219,9 @@ tHostifReturn hostif_getBuf(tHostifInstance pInstance_p, tHostifInstanceId instI
 
 tHostifReturn hostif_getInitParam(tHostifInstance pInstance_p, UINT8** ppBase_p);
 
+tHostifReturn hostif_dmaCopy(tHostifInstance pInstance_p, void* pDst_p,
+                             const void* pSrc_p, UINT size_p);
+
 #ifdef __cplusplus
 }
 #endif
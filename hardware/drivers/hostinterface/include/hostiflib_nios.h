@@ -98,6 +98,34 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     alt_ic_irq_disable(HOSTIF_IRQ_IC_ID, HOSTIF_IRQ)
 
 #define HOSTIF_INLINE inline
+
+/// cache maintenance (write back and invalidate a data range)
+#define HOSTIF_FLUSH_DCACHE_RANGE(ptr, size)    alt_dcache_flush(ptr, size)
+
+/// DMA
+/// Define HOSTIF_DMA_NAME with the name of a memory-to-memory DMA device
+/// (e.g. "/dev/dma_0") to transfer buffers with hostif_dmaCopy() by DMA.
+#if defined(HOSTIF_DMA_NAME)
+#include <sys/alt_dma.h>
+
+#define HOSTIF_DMA_TXCHAN                   alt_dma_txchan
+#define HOSTIF_DMA_RXCHAN                   alt_dma_rxchan
+
+#define HOSTIF_DMA_OPEN(txChan, rxChan)     \
+    ((((txChan) = alt_dma_txchan_open(HOSTIF_DMA_NAME)) != NULL) && \
+     (((rxChan) = alt_dma_rxchan_open(HOSTIF_DMA_NAME)) != NULL))
+
+#define HOSTIF_DMA_CLOSE(txChan, rxChan)    \
+    do { \
+        if ((txChan) != NULL) alt_dma_txchan_close(txChan); \
+        if ((rxChan) != NULL) alt_dma_rxchan_close(rxChan); \
+    } while (0)
+
+/// The receive channel is prepared first, so the transfer starts with the send.
+#define HOSTIF_DMA_START(txChan, rxChan, pDst, pSrc, size, pfnDone, pArg) \
+    ((alt_dma_rxchan_prepare(rxChan, pDst, size, pfnDone, pArg) >= 0) && \
+     (alt_dma_txchan_send(txChan, pSrc, size, NULL, NULL) >= 0))
+#endif
 //------------------------------------------------------------------------------
 // typedef
 //------------------------------------------------------------------------------
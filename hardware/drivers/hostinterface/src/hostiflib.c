@@ -104,6 +104,10 @@ static tHostif* paHostifInstance_l[HOSTIF_INSTANCE_COUNT] =
 /* Local functions for PCP and Host */
 static void freePtr(void* p);
 static tHostifReturn checkMagic(UINT8* pBase_p);
+static void copySequential(void* pDst_p, const void* pSrc_p, UINT size_p);
+#if defined(HOSTIF_DMA_NAME)
+static void dmaDoneCb(void* pArg_p, void* pData_p);
+#endif
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -205,6 +209,11 @@ tHostifReturn hostif_create(tHostifConfig* pConfig_p, tHostifInstance* ppInstanc
         goto Exit;
     }
 
+#if defined(HOSTIF_DMA_NAME)
+    // without DMA channels hostif_dmaCopy() falls back to CPU copies
+    pHostif->fDmaAvailable = HOSTIF_DMA_OPEN(pHostif->dmaTxChan, pHostif->dmaRxChan);
+#endif
+
     // return instance pointer
     *ppInstance_p = pHostif;
 
@@ -251,6 +260,10 @@ tHostifReturn hostif_delete(tHostifInstance pInstance_p)
         goto Exit;
     }
 
+#if defined(HOSTIF_DMA_NAME)
+    HOSTIF_DMA_CLOSE(pHostif->dmaTxChan, pHostif->dmaRxChan);
+#endif
+
     // delete instance in instance array
     for (i = 0; i < HOSTIF_INSTANCE_COUNT; i++)
     {
@@ -432,6 +445,77 @@ Exit:
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Copy a buffer by DMA
+
+This function copies a buffer with a single DMA transfer and waits until the
+transfer is completed. It is used to exchange whole buffers (e.g. process
+images) between local memory and memory accessed through the bridge, which
+avoids a long series of single CPU bus transactions. If the target provides no
+DMA (HOSTIF_DMA_NAME not defined or device not found), the buffer is copied by
+the CPU with ascending word accesses, which are served from the prefetch
+buffer of a parallel interface slave with prefetching enabled.
+
+\param  pInstance_p             Host interface instance
+\param  pDst_p                  Destination address
+\param  pSrc_p                  Source address
+\param  size_p                  Size of the buffer [byte]
+
+\return The function returns a tHostifReturn error code.
+\retval kHostifSuccessful       The buffer is copied.
+\retval kHostifInvalidParameter The caller has provided incorrect parameters.
+\retval kHostifHwWriteError     The DMA transfer could not be started.
+
+\ingroup module_hostiflib
+*/
+//------------------------------------------------------------------------------
+tHostifReturn hostif_dmaCopy(tHostifInstance pInstance_p, void* pDst_p,
+                             const void* pSrc_p, UINT size_p)
+{
+    tHostifReturn ret = kHostifSuccessful;
+#if defined(HOSTIF_DMA_NAME)
+    tHostif*      pHostif = (tHostif*)pInstance_p;
+#endif
+
+    if (pInstance_p == NULL || pDst_p == NULL || pSrc_p == NULL)
+    {
+        ret = kHostifInvalidParameter;
+        goto Exit;
+    }
+
+    if (size_p == 0)
+        goto Exit;
+
+#if defined(HOSTIF_DMA_NAME)
+    if (pHostif->fDmaAvailable)
+    {
+        // the DMA bypasses the data cache
+        HOSTIF_FLUSH_DCACHE_RANGE((void*)pSrc_p, size_p);
+        HOSTIF_FLUSH_DCACHE_RANGE(pDst_p, size_p);
+
+        pHostif->fDmaDone = FALSE;
+        if (!HOSTIF_DMA_START(pHostif->dmaTxChan, pHostif->dmaRxChan,
+                              pDst_p, pSrc_p, size_p, dmaDoneCb, pHostif))
+        {
+            ret = kHostifHwWriteError;
+            goto Exit;
+        }
+
+        // the transfer of a process image takes only a few microseconds
+        while (!pHostif->fDmaDone)
+            ;
+
+        goto Exit;
+    }
+#endif
+
+    copySequential(pDst_p, pSrc_p, size_p);
+
+Exit:
+    return ret;
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -470,3 +554,60 @@ static tHostifReturn checkMagic(UINT8* pBase_p)
         return kHostifWrongMagic;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Copy a buffer sequentially
+
+This function copies a buffer with 32 bit accesses in ascending address order
+if both addresses are aligned. The remaining bytes are copied one by one.
+Unaligned buffers are copied by memcpy().
+
+\param  pDst_p                  Destination address
+\param  pSrc_p                  Source address
+\param  size_p                  Size of the buffer [byte]
+*/
+//------------------------------------------------------------------------------
+static void copySequential(void* pDst_p, const void* pSrc_p, UINT size_p)
+{
+    volatile UINT32*        pDst32 = (volatile UINT32*)pDst_p;
+    const volatile UINT32*  pSrc32 = (const volatile UINT32*)pSrc_p;
+    volatile UINT8*         pDst8;
+    const volatile UINT8*   pSrc8;
+
+    if ((((size_t)pDst_p | (size_t)pSrc_p) & (sizeof(UINT32) - 1)) != 0)
+    {
+        memcpy(pDst_p, pSrc_p, size_p);
+        return;
+    }
+
+    for (; size_p >= sizeof(UINT32); size_p -= sizeof(UINT32))
+        *pDst32++ = *pSrc32++;
+
+    pDst8 = (volatile UINT8*)pDst32;
+    pSrc8 = (const volatile UINT8*)pSrc32;
+    while (size_p-- > 0)
+        *pDst8++ = *pSrc8++;
+}
+
+#if defined(HOSTIF_DMA_NAME)
+//------------------------------------------------------------------------------
+/**
+\brief  DMA transfer completion callback
+
+This function is called by the DMA driver when the receive channel has written
+the whole destination buffer.
+
+\param  pArg_p      Host interface instance
+\param  pData_p     Destination address of the transfer
+*/
+//------------------------------------------------------------------------------
+static void dmaDoneCb(void* pArg_p, void* pData_p)
+{
+    tHostif* pHostif = (tHostif*)pArg_p;
+
+    (void)pData_p;
+
+    pHostif->fDmaDone = TRUE;
+}
+#endif
+
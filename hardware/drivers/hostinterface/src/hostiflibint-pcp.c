@@ -288,6 +288,38 @@ Exit:
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Set an irq source
+
+This function sets the pending flag of the given irq source. If the source is
+enabled, an interrupt is triggered at the host. It is used as doorbell for
+the host interface queues.
+
+Note that only the Pcp is allowed to set irq sources!
+
+\param  pInstance_p             host interface instance
+\param  irqSrc_p                irq source to set
+
+\return The function returns a tHostifReturn error code.
+\retval kHostifSuccessful       The process function exit without errors.
+\retval kHostifInvalidParameter The caller has provided incorrect parameters.
+
+\ingroup module_hostiflib
+*/
+//------------------------------------------------------------------------------
+tHostifReturn hostif_irqSet(tHostifInstance pInstance_p, tHostifIrqSrc irqSrc_p)
+{
+    tHostif*    pHostif = (tHostif*)pInstance_p;
+
+    if (pInstance_p == NULL || irqSrc_p >= kHostifIrqSrcLast)
+        return kHostifInvalidParameter;
+
+    hostif_setIrq(pHostif->pBase, (UINT16)(1 << irqSrc_p));
+
+    return kHostifSuccessful;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  This function sets a state to the host interface
@@ -109,6 +109,12 @@ typedef struct sHostif
     tHostifBufMap       aBufMap[kHostifInstIdLast];   ///< Table storing buffer mapping
     tHostifInitParam*   pInitParam;                   ///< Initialization parameter
     UINT8*              apDynBuf[HOSTIF_DYNBUF_COUNT];
+#if defined(HOSTIF_DMA_NAME)
+    HOSTIF_DMA_TXCHAN   dmaTxChan;                    ///< DMA channel reading the source
+    HOSTIF_DMA_RXCHAN   dmaRxChan;                    ///< DMA channel writing the destination
+    BOOL                fDmaAvailable;                ///< DMA channels are open
+    volatile BOOL       fDmaDone;                     ///< Current DMA transfer is completed
+#endif
 } tHostif;
 
 //------------------------------------------------------------------------------
@@ -82,6 +82,7 @@ qsysUtil::addHdlParam  gEnableMux   NATURAL 0   $hdlParamVisible
 qsysUtil::addHdlParam  gDataWidth   NATURAL 16  $hdlParamVisible
 qsysUtil::addHdlParam  gAddrWidth   NATURAL 16  $hdlParamVisible
 qsysUtil::addHdlParam  gAdWidth     NATURAL 1   $hdlParamVisible
+qsysUtil::addHdlParam  gEnablePrefetch NATURAL 0 $hdlParamVisible
 
 # -----------------------------------------------------------------------------
 # System Info parameters
@@ -96,6 +97,7 @@ qsysUtil::addSysParam sys_clk INTEGER 0 {CLOCK_RATE c0} $sysParamVisible
 qsysUtil::addGuiParam  gui_enableMux BOOLEAN FALSE "Enable MUX Bus" "" ""
 qsysUtil::addGuiParam  gui_dataWidth NATURAL 16 "Data width"    "Bits" "8 16 32"
 qsysUtil::addGuiParam  gui_addrWidth NATURAL 16 "Address width" "Bits" "1:32"
+qsysUtil::addGuiParam  gui_enablePrefetch BOOLEAN FALSE "Enable read prefetch and posted writes" "" ""
 
 # -----------------------------------------------------------------------------
 # GUI configuration
@@ -129,8 +131,15 @@ proc validation_callback {} {
         set enableMux 0
     }
 
+    if { [get_parameter_value gui_enablePrefetch] } {
+        set enablePrefetch 1
+    } else {
+        set enablePrefetch 0
+    }
+
     # Assign HDL generics
     set_parameter_value gEnableMux  $enableMux
+    set_parameter_value gEnablePrefetch $enablePrefetch
     set_parameter_value gDataWidth  $dataBits
     set_parameter_value gAddrWidth  $addrBits
     set_parameter_value gAdWidth    $maxBits
@@ -1,6 +1,12 @@
 -------------------------------------------------------------------------------
 --! @file prlSlave-rtl-ea.vhd
 --! @brief Multiplexed memory mapped slave
+--! @details If gEnablePrefetch is set, the slave reads the next word after a
+--! host read in the background. A following read of this word is acknowledged
+--! without accessing the bus, so sequential reads (e.g. process image copies)
+--! don't wait for the bus latency. Host writes are posted: the host is
+--! acknowledged as soon as the write is started on the bus. Prefetching must
+--! only be enabled if the memory behind the slave has no read side effects.
 -------------------------------------------------------------------------------
 --
 --    (c) B&R, 2014
@@ -57,7 +63,9 @@ entity prlSlave is
         --! Address bus width
         gAddrWidth      : natural := 16;
         --! Ad bus width (valid when gEnableMux /= FALSE)
-        gAdWidth        : natural := 16
+        gAdWidth        : natural := 16;
+        --! Enable read prefetch and posted writes (0 = FALSE)
+        gEnablePrefetch : natural := 0
     );
     port (
         --! Clock
@@ -114,6 +122,10 @@ end prlSlave;
 architecture rtl of prlSlave is
     -- address register to store the address populated to the interface
     signal addressRegister      : std_logic_vector(gAddrWidth-1 downto 0);
+    -- address of the current host access
+    signal hostAddress          : std_logic_vector(gAddrWidth-1 downto 0);
+    -- address increment enable (prefetch of the next word)
+    signal addrIncEnable        : std_logic;
 
     -- byteenable register to store byteenable qualifiers
     signal byteenableRegister       : std_logic_vector(gDataWidth/8-1 downto 0);
@@ -129,6 +141,17 @@ architecture rtl of prlSlave is
     signal readDataRegister         : std_logic_vector(gDataWidth-1 downto 0);
     signal readDataRegister_next    : std_logic_vector(gDataWidth-1 downto 0);
 
+    -- prefetch register holding the word following the last host read
+    signal prefetchData             : std_logic_vector(gDataWidth-1 downto 0);
+    -- prefetch register is valid for the address in the address register
+    signal prefetchValid            : std_logic;
+    -- host read is served from the prefetch register
+    signal prefetchHit              : std_logic;
+    -- current host access is a read
+    signal accessRead               : std_logic;
+    -- host write strobe of a posted write wasn't released yet
+    signal postedWriteAck           : std_logic;
+
     -- synchronized signals
     signal hostChipselect   : std_logic;
     signal hostWrite        : std_logic;
@@ -146,7 +169,10 @@ architecture rtl of prlSlave is
         sIdle,
         sStart,
         sWaitForBus,
-        sHold
+        sHold,
+        sPostedWrite,
+        sPrefetchStart,
+        sPrefetchWait
     );
 
     signal fsm : tFsm;
@@ -171,6 +197,7 @@ begin
             byteenableRegister  <= (others => cInactivated);
             writeDataRegister   <= (others => cInactivated);
             readDataRegister    <= (others => cInactivated);
+            prefetchData        <= (others => cInactivated);
             hostDataEnable_reg  <= cInactivated;
             hostAck_reg         <= cInactivated;
         elsif rising_edge(iClk) then
@@ -181,12 +208,11 @@ begin
                 byteenableRegister <= iPrlSlv_be;
 
                 -- Assign byte addresses to the address register
-                if gEnableMux /= 0 then
-                    addressRegister <= (others => cInactivated);
-                    addressRegister <= inst_latch.output;
-                else
-                    addressRegister <= iPrlSlv_addr;
-                end if;
+                addressRegister <= hostAddress;
+            elsif addrIncEnable = cActivated then
+                -- Prefetch the whole next word
+                byteenableRegister <= (others => cActivated);
+                addressRegister <= std_logic_vector(unsigned(addressRegister) + gDataWidth/8);
             end if;
 
             if writeDataRegClkEnable = cActivated then
@@ -197,12 +223,34 @@ begin
                 end if;
             end if;
 
-            if iMst_waitrequest = cInactivated and hostRead = cActivated then
-                readDataRegister <= readDataRegister_next;
+            if gEnablePrefetch = 0 then
+                if iMst_waitrequest = cInactivated and hostRead = cActivated then
+                    readDataRegister <= readDataRegister_next;
+                end if;
+            else
+                if prefetchHit = cActivated then
+                    readDataRegister <= prefetchData;
+                elsif fsm = sWaitForBus and iMst_waitrequest = cInactivated and
+                      hostRead = cActivated then
+                    readDataRegister <= readDataRegister_next;
+                end if;
+
+                if fsm = sPrefetchWait and iMst_waitrequest = cInactivated then
+                    prefetchData <= readDataRegister_next;
+                end if;
             end if;
         end if;
     end process;
 
+    -- Byte address of the host access
+    hostAddress <= inst_latch.output when gEnableMux /= 0 else iPrlSlv_addr;
+
+    -- A host read of the prefetched word is served without a bus access
+    prefetchHit <= cActivated when gEnablePrefetch /= 0 and fsm = sIdle and
+                                   hostRead = cActivated and prefetchValid = cActivated and
+                                   hostAddress = addressRegister else
+                   cInactivated;
+
     oMst_address    <= addressRegister;
 
     -- Multiplexed output
@@ -226,6 +274,7 @@ begin
     combProc : process (
         hostWrite,
         hostRead,
+        postedWriteAck,
         fsm
     )
     begin
@@ -240,6 +289,11 @@ begin
             elsif hostWrite = cActivated then
                 hostAck         <= cActivated;
             end if;
+        elsif fsm = sPostedWrite then
+            -- Acknowledge the write while it is transferred on the bus
+            if hostWrite = cActivated and postedWriteAck = cActivated then
+                hostAck         <= cActivated;
+            end if;
         end if;
     end process;
 
@@ -252,24 +306,42 @@ begin
             writeDataRegClkEnable   <= cInactivated;
             oMst_write              <= cInactivated;
             oMst_read               <= cInactivated;
+            addrIncEnable           <= cInactivated;
+            prefetchValid           <= cInactivated;
+            accessRead              <= cInactivated;
+            postedWriteAck          <= cInactivated;
         elsif rising_edge(iClk) then
             --defaults
             byteenableRegClkEnable  <= cInactivated;
             writeDataRegClkEnable   <= cInactivated;
+            addrIncEnable           <= cInactivated;
 
             case fsm is
                 when sIdle =>
                     oMst_write                  <= cInactivated;
                     oMst_read                   <= cInactivated;
                     if hostRead = cActivated or hostWrite = cActivated then
-                        fsm                     <= sStart;
                         byteenableRegClkEnable  <= cActivated;
                         writeDataRegClkEnable   <= hostWrite;
+                        accessRead              <= hostRead;
+                        -- The prefetched word is used once and dropped by writes
+                        prefetchValid           <= cInactivated;
+
+                        if prefetchHit = cActivated then
+                            fsm                 <= sHold;
+                        else
+                            fsm                 <= sStart;
+                        end if;
                     end if;
                 when sStart =>
-                    fsm         <= sWaitForBus;
                     oMst_read   <= hostRead;
                     oMst_write  <= hostWrite;
+                    if gEnablePrefetch /= 0 and hostWrite = cActivated then
+                        fsm             <= sPostedWrite;
+                        postedWriteAck  <= cActivated;
+                    else
+                        fsm             <= sWaitForBus;
+                    end if;
                 when sWaitForBus =>
                     if iMst_waitrequest = cInactivated then
                         fsm         <= sHold;
@@ -278,7 +350,35 @@ begin
                     end if;
                 when sHold =>
                     if hostRead = cInactivated and hostWrite = cInactivated then
-                        fsm <= sIdle;
+                        if gEnablePrefetch /= 0 and accessRead = cActivated then
+                            fsm             <= sPrefetchStart;
+                            addrIncEnable   <= cActivated;
+                        else
+                            fsm             <= sIdle;
+                        end if;
+                    end if;
+                when sPostedWrite =>
+                    -- A strobe released once must not acknowledge the next write
+                    if hostWrite = cInactivated then
+                        postedWriteAck  <= cInactivated;
+                    end if;
+
+                    if iMst_waitrequest = cInactivated then
+                        oMst_write      <= cInactivated;
+                        if hostWrite = cActivated and postedWriteAck = cActivated then
+                            fsm         <= sHold;
+                        else
+                            fsm         <= sIdle;
+                        end if;
+                    end if;
+                when sPrefetchStart =>
+                    fsm         <= sPrefetchWait;
+                    oMst_read   <= cActivated;
+                when sPrefetchWait =>
+                    if iMst_waitrequest = cInactivated then
+                        fsm             <= sIdle;
+                        oMst_read       <= cInactivated;
+                        prefetchValid   <= cActivated;
                     end if;
             end case;
         end if;
@@ -45,6 +45,49 @@ OPTION (CFG_COMPILE_LIB_CN                      "Compile openPOWERLINK CN librar
 OPTION (CFG_COMPILE_LIB_CNAPP_USERINTF          "Compile openPOWERLINK CN application library for userspace" ON)
 OPTION (CFG_COMPILE_LIB_CNAPP_KERNELINTF        "Compile openPOWERLINK CN application library for kernel interface" ON)
 OPTION (CFG_COMPILE_LIB_CNDRV_PCAP              "Compile openPOWERLINK CN driver library for linux userspace (pcap)" ON)
+OPTION (CFG_LINUX_USER_CN_SYNCTIMER             "Process the isochronous task of the CN library on the software sync timer locked to the SoC" OFF)
+
+################################################################################
+# Options for the userspace Ethernet driver
+
+OPTION (CFG_LINUX_USER_EDRV_RAWSOCK             "Use raw socket (PACKET_MMAP) Ethernet driver instead of pcap in linux userspace" OFF)
+OPTION (CFG_LINUX_USER_EDRV_TXTIME              "Transmit frames of the raw socket Ethernet driver with SO_TXTIME (needs ETF qdisc)" OFF)
+OPTION (CFG_LINUX_USER_EDRV_SIM                 "Attach the MN to a simulated network of CNs instead of an Ethernet interface in linux userspace" OFF)
+OPTION (CFG_LINUX_USER_EDRV_REPLAY              "Replay the pcap/pcapng file given as device name instead of using an Ethernet interface in linux userspace" OFF)
+OPTION (CFG_LINUX_USER_EDRV_DPDK                "Use DPDK poll mode Ethernet driver with the PCI address given as device name in linux userspace" OFF)
+
+IF(CFG_LINUX_USER_EDRV_SIM)
+    # The simulated CNs are only meaningful for the MN libraries
+    SET(HARDWARE_DRIVER_LINUXUSER_SOURCES ${HARDWARE_DRIVER_LINUXUSER_SIM_SOURCES})
+    SET(CFG_COMPILE_LIB_CN OFF)
+    SET(CFG_COMPILE_LIB_CNDRV_PCAP OFF)
+ELSEIF(CFG_LINUX_USER_EDRV_REPLAY)
+    SET(HARDWARE_DRIVER_LINUXUSER_SOURCES ${HARDWARE_DRIVER_LINUXUSER_REPLAY_SOURCES})
+ELSEIF(CFG_LINUX_USER_EDRV_DPDK)
+    FIND_PACKAGE(PkgConfig REQUIRED)
+    PKG_CHECK_MODULES(DPDK REQUIRED libdpdk)
+    SET(HARDWARE_DRIVER_LINUXUSER_SOURCES ${HARDWARE_DRIVER_LINUXUSER_DPDK_SOURCES})
+    INCLUDE_DIRECTORIES(${DPDK_INCLUDE_DIRS})
+    ADD_DEFINITIONS(${DPDK_CFLAGS_OTHER})
+    SET(ARCH_LIBRARIES ${ARCH_LIBRARIES} ${DPDK_LDFLAGS})
+    ADD_DEFINITIONS(-DEDRV_USE_TX_TIME=TRUE -DEDRV_USE_HW_TIMESTAMP=TRUE)
+ELSEIF(CFG_LINUX_USER_EDRV_RAWSOCK)
+    SET(HARDWARE_DRIVER_LINUXUSER_SOURCES ${HARDWARE_DRIVER_LINUXUSER_RAWSOCK_SOURCES})
+    ADD_DEFINITIONS(-DEDRV_USE_TX_BATCH=TRUE)
+    IF(CFG_LINUX_USER_EDRV_TXTIME)
+        ADD_DEFINITIONS(-DEDRV_USE_TX_TIME=TRUE)
+    ENDIF()
+ENDIF()
+
+################################################################################
+# Options for the userspace interface between application and driver daemon
+
+OPTION (CFG_LINUX_USER_PDO_SYNC_FUTEX           "Signal sync events to the application with a futex in shared memory instead of a named semaphore" OFF)
+
+IF(CFG_LINUX_USER_PDO_SYNC_FUTEX)
+    SET(PDO_UCAL_POSIX_SOURCES ${PDO_UCAL_POSIXFUTEX_SOURCES})
+    SET(PDO_KCAL_POSIXMEM_SOURCES ${PDO_KCAL_POSIXFUTEX_SOURCES})
+ENDIF()
 
 ################################################################################
 # Add library subdirectories
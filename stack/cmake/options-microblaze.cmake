@@ -41,6 +41,15 @@ INCLUDE(geneclipseincludelist)
 SET(XIL_HW_LIB_DIR ${OPLK_BASE_DIR}/hardware/lib/${SYSTEM_NAME_DIR}/${SYSTEM_PROCESSOR_DIR})
 SET(XIL_TOOLS_DIR ${TOOLS_DIR}/xilinx-microblaze)
 
+################################################################################
+# Profile-guided local memory section assignments
+SET(CFG_SECTION_PROFILE "" CACHE FILEPATH
+    "Profile of a reference run (gprof flat profile or cycle counts) used to assign the local memory sections")
+SET(CFG_SECTION_PROFILE_ELF "" CACHE FILEPATH "ELF file of the profiled reference run")
+SET(CFG_SECTION_PROFILE_BUDGET "0" CACHE STRING "Size of the local memory available for the stack in bytes")
+SET(CFG_SECTION_PROFILE_REF "unknown" CACHE STRING
+    "Description of the reference run (e.g. mapping size and node count)")
+
 ################################################################################
 # Add libraries
 OPTION(CFG_COMPILE_LIB_CN                      "Compile openPOWERLINK CN library" ON)
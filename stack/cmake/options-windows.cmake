@@ -34,6 +34,20 @@ OPTION(CFG_COMPILE_LIB_MN           "Compile openPOWERLINK MN library" ON)
 OPTION(CFG_COMPILE_LIB_CN           "Compile openPOWERLINK CN library" ON)
 
 OPTION(CFG_WINDOWS_DLL              "Build openPOWERLINK library as DLL" OFF)
+OPTION(CFG_WINDOWS_PCAP_TX_BATCH    "Transmit the cyclic frames of a cycle with a single pcap send queue" OFF)
+
+IF(CFG_WINDOWS_PCAP_TX_BATCH)
+    ADD_DEFINITIONS(-DEDRV_USE_TX_BATCH=TRUE)
+ENDIF()
+
+OPTION(CFG_WINDOWS_HIGHRES_TIMER    "Use high resolution waitable timers and an MMCSS worker thread for the high-resolution timer module" OFF)
+SET(CFG_WINDOWS_HRESTIMER_BUSYWAIT_NS "0" CACHE STRING "Time in ns the high-resolution timer busy-waits before the expiry (0 = disabled)")
+
+IF(CFG_WINDOWS_HIGHRES_TIMER)
+    ADD_DEFINITIONS(-DEDRV_USE_HIGHRES_TIMER=TRUE)
+ENDIF()
+
+ADD_DEFINITIONS(-DCONFIG_HRESTIMER_BUSYWAIT_NS=${CFG_WINDOWS_HRESTIMER_BUSYWAIT_NS})
 
 # MN libraries
 IF(CFG_COMPILE_LIB_MN)
@@ -35,6 +35,7 @@
 SET(COMMON_SOURCES
     ${COMMON_SOURCE_DIR}/debugstr.c
     ${COMMON_SOURCE_DIR}/event/event.c
+    ${COMMON_SOURCE_DIR}/nodeset/nodeset.c
     )
 
 SET(COMMON_WINDOWS_SOURCES
@@ -43,6 +44,8 @@ SET(COMMON_WINDOWS_SOURCES
 
 SET(COMMON_LINUXUSER_SOURCES
     ${ARCH_SOURCE_DIR}/linux/ftracedebug.c
+    ${ARCH_SOURCE_DIR}/linux/bintrace.c
+    ${ARCH_SOURCE_DIR}/linux/memarena.c
     ${CONTRIB_SOURCE_DIR}/trace/trace-printf.c
     )
 
@@ -58,6 +61,36 @@ SET(COMMON_CAL_DIRECT_SOURCES
     ${COMMON_SOURCE_DIR}/dll/dllcal-direct.c
     )
 
+SET(CYCLESTAT_LOCAL_SOURCES
+    ${COMMON_SOURCE_DIR}/cyclestat/cyclestat.c
+    ${COMMON_SOURCE_DIR}/cyclestat/cyclestat-local.c
+    )
+
+SET(CYCLESTAT_POSIXMEM_SOURCES
+    ${COMMON_SOURCE_DIR}/cyclestat/cyclestat.c
+    ${COMMON_SOURCE_DIR}/cyclestat/cyclestat-posixshm.c
+    )
+
+SET(FLIGHTREC_LOCAL_SOURCES
+    ${COMMON_SOURCE_DIR}/flightrec/flightrec.c
+    ${COMMON_SOURCE_DIR}/flightrec/flightrec-local.c
+    )
+
+SET(FLIGHTREC_POSIXMEM_SOURCES
+    ${COMMON_SOURCE_DIR}/flightrec/flightrec.c
+    ${COMMON_SOURCE_DIR}/flightrec/flightrec-posixshm.c
+    )
+
+SET(METRICS_LOCAL_SOURCES
+    ${COMMON_SOURCE_DIR}/metrics/metrics.c
+    ${COMMON_SOURCE_DIR}/metrics/metrics-local.c
+    )
+
+SET(METRICS_POSIXMEM_SOURCES
+    ${COMMON_SOURCE_DIR}/metrics/metrics.c
+    ${COMMON_SOURCE_DIR}/metrics/metrics-posixshm.c
+    )
+
 ################################################################################
 # Application library (User) sources
 ################################################################################
@@ -69,6 +102,7 @@ SET(USER_MN_SOURCES
     ${USER_SOURCE_DIR}/obd/obdcdc.c
     ${USER_SOURCE_DIR}/api/processimage-cia302.c
     ${USER_SOURCE_DIR}/cfmu.c
+    ${USER_SOURCE_DIR}/nmt/multiplexu.c
     )
 
 ################################################################################
@@ -77,8 +111,11 @@ SET(USER_MN_SOURCES
 SET(USER_SOURCES
     ${USER_SOURCE_DIR}/api/generic.c
     ${USER_SOURCE_DIR}/api/processimage.c
+    ${USER_SOURCE_DIR}/api/sdobatch.c
     ${USER_SOURCE_DIR}/obd/obd.c
     ${USER_SOURCE_DIR}/obd/obdcreate.c
+    ${USER_SOURCE_DIR}/obd/obdstore.c
+    ${USER_SOURCE_DIR}/obd/obdfile.c
     ${USER_SOURCE_DIR}/dll/dllucal.c
     ${USER_SOURCE_DIR}/event/eventu.c
     ${USER_SOURCE_DIR}/nmt/nmtu.c
@@ -99,6 +136,18 @@ SET(USER_SOURCES
     ${USER_SOURCE_DIR}/ledu.c
     )
 
+SET(USER_CTRL_LINUXUSER_SOURCES
+    ${USER_SOURCE_DIR}/ctrl/ctrludefer-linux.c
+    )
+
+SET(USER_PDO_LINUXUSER_SOURCES
+    ${USER_SOURCE_DIR}/pdo/pdoucopy-linux.c
+    )
+
+SET(USER_SDO_LINUXUSER_SOURCES
+    ${USER_SOURCE_DIR}/sdo/sdo-comuasync-linux.c
+    )
+
 ################################################################################
 # User control CAL sources
 
@@ -151,6 +200,7 @@ SET(EVENT_UCAL_LINUXUSER_SOURCES
 
 SET(EVENT_UCAL_LINUXIOCTL_SOURCES
     ${USER_SOURCE_DIR}/event/eventucal-linuxioctl.c
+    ${USER_SOURCE_DIR}/event/eventucalintf-circbuf.c
     )
 
 SET(EVENT_UCAL_WINDOWS_SOURCES
@@ -175,6 +225,11 @@ SET(PDO_UCAL_POSIX_SOURCES
     ${USER_SOURCE_DIR}/pdo/pdoucalsync-bsdsem.c
     )
 
+SET(PDO_UCAL_POSIXFUTEX_SOURCES
+    ${USER_SOURCE_DIR}/pdo/pdoucalmem-posixshm.c
+    ${USER_SOURCE_DIR}/pdo/pdoucalsync-futex.c
+    )
+
 SET(PDO_UCAL_LINUXMMAPIOCTL_SOURCES
     ${USER_SOURCE_DIR}/pdo/pdoucalsync-ioctl.c
     ${USER_SOURCE_DIR}/pdo/pdoucalmem-linuxmmap.c
@@ -277,6 +332,15 @@ SET(PDO_KCAL_POSIXMEM_SOURCES
     ${KERNEL_SOURCE_DIR}/pdo/pdokcalsync-bsdsem.c
     )
 
+SET(PDO_KCAL_POSIXFUTEX_SOURCES
+    ${KERNEL_SOURCE_DIR}/pdo/pdokcalmem-posixshm.c
+    ${KERNEL_SOURCE_DIR}/pdo/pdokcalsync-futex.c
+    )
+
+SET(PDO_KCAL_RXWORKER_LINUX_SOURCES
+    ${KERNEL_SOURCE_DIR}/pdo/pdokcalrx-linux.c
+    )
+
 SET(PDO_KCAL_LINUXKERNEL_SOURCES
     ${KERNEL_SOURCE_DIR}/pdo/pdokcalmem-linuxkernel.c
     ${KERNEL_SOURCE_DIR}/pdo/pdokcalsync-linuxkernel.c
@@ -290,6 +354,47 @@ SET(HARDWARE_DRIVER_LINUXUSER_SOURCES
     ${KERNEL_SOURCE_DIR}/timer/hrestimer-posix.c
     ${EDRV_SOURCE_DIR}/edrvcyclic.c
     ${EDRV_SOURCE_DIR}/edrv-pcap_linux.c
+    ${EDRV_SOURCE_DIR}/edrvfilter.c
+    ${EDRV_SOURCE_DIR}/edrvrxpool-linux.c
+    ${EDRV_SOURCE_DIR}/edrvmirror-posixshm.c
+    )
+
+SET(HARDWARE_DRIVER_LINUXUSER_RAWSOCK_SOURCES
+    ${KERNEL_SOURCE_DIR}/veth/veth-linuxuser.c
+    ${KERNEL_SOURCE_DIR}/timer/hrestimer-posix.c
+    ${EDRV_SOURCE_DIR}/edrvcyclic.c
+    ${EDRV_SOURCE_DIR}/edrv-rawsock_linux.c
+    ${EDRV_SOURCE_DIR}/edrvrxpool-linux.c
+    ${EDRV_SOURCE_DIR}/edrvmirror-posixshm.c
+    )
+
+SET(HARDWARE_DRIVER_LINUXUSER_SIM_SOURCES
+    ${KERNEL_SOURCE_DIR}/veth/veth-linuxuser.c
+    ${KERNEL_SOURCE_DIR}/timer/hrestimer-posix.c
+    ${EDRV_SOURCE_DIR}/edrvcyclic.c
+    ${EDRV_SOURCE_DIR}/edrv-sim_linux.c
+    ${EDRV_SOURCE_DIR}/edrvmirror-posixshm.c
+    )
+
+SET(HARDWARE_DRIVER_LINUXUSER_REPLAY_SOURCES
+    ${KERNEL_SOURCE_DIR}/veth/veth-linuxuser.c
+    ${KERNEL_SOURCE_DIR}/timer/hrestimer-posix.c
+    ${EDRV_SOURCE_DIR}/edrvcyclic.c
+    ${EDRV_SOURCE_DIR}/edrv-replay_linux.c
+    ${EDRV_SOURCE_DIR}/edrvmirror-posixshm.c
+    )
+
+SET(HARDWARE_DRIVER_LINUXUSER_DPDK_SOURCES
+    ${KERNEL_SOURCE_DIR}/veth/veth-linuxuser.c
+    ${KERNEL_SOURCE_DIR}/timer/hrestimer-posix.c
+    ${EDRV_SOURCE_DIR}/edrvcyclic.c
+    ${EDRV_SOURCE_DIR}/edrv-dpdk_linux.c
+    ${EDRV_SOURCE_DIR}/edrvmirror-posixshm.c
+    )
+
+SET(HARDWARE_DRIVER_LINUXUSER_SYNCTIMER_SOURCES
+    ${KERNEL_SOURCE_DIR}/timer/synctimer-linuxuser.c
+    ${KERNEL_SOURCE_DIR}/timer/syncservo.c
     )
 
 SET(HARDWARE_DRIVER_WINDOWS_SOURCES
@@ -307,10 +412,12 @@ SET(HARDWARE_DRIVER_LINUXKERNEL_SOURCES
 SET(HARDWARE_DRIVER_OPENMAC_SOURCES
      ${KERNEL_SOURCE_DIR}/timer/timestamp-openmac.c
      ${KERNEL_SOURCE_DIR}/edrv/edrv-openmac.c
+     ${KERNEL_SOURCE_DIR}/pdo/pdokcalrxdma-openmac.c
      )
 
 SET(HARDWARE_DRIVER_OPENMAC_CN_SOURCES
      ${KERNEL_SOURCE_DIR}/timer/synctimer-openmac.c
+     ${KERNEL_SOURCE_DIR}/timer/syncservo.c
      )
 
 ################################################################################
@@ -379,10 +486,12 @@ SET(TARGET_MICROBLAZE_SOURCES
 
 SET(ARCH_X86_SOURCES
     ${COMMON_SOURCE_DIR}/ami/amix86.c
+    ${COMMON_SOURCE_DIR}/ami/amibulk.c
     )
 
 SET(ARCH_LE_SOURCES
     ${COMMON_SOURCE_DIR}/ami/amile.c
+    ${COMMON_SOURCE_DIR}/ami/amibulk.c
     )
 
 ################################################################################
@@ -392,6 +501,10 @@ SET(ARCH_LE_SOURCES
 SET(OPLK_HEADERS
     ${STACK_INCLUDE_DIR}/oplk/benchmark.h
     ${STACK_INCLUDE_DIR}/oplk/cfm.h
+    ${STACK_INCLUDE_DIR}/oplk/cyclestat.h
+    ${STACK_INCLUDE_DIR}/oplk/syncservo.h
+    ${STACK_INCLUDE_DIR}/oplk/flightrec.h
+    ${STACK_INCLUDE_DIR}/oplk/metrics.h
     ${STACK_INCLUDE_DIR}/oplk/debug.h
     ${STACK_INCLUDE_DIR}/oplk/debugstr.h
     ${STACK_INCLUDE_DIR}/oplk/dll.h
@@ -405,11 +518,16 @@ SET(OPLK_HEADERS
     ${STACK_INCLUDE_DIR}/oplk/version.h
     ${STACK_INCLUDE_DIR}/oplk/event.h
     ${STACK_INCLUDE_DIR}/oplk/ftracedebug.h
+    ${STACK_INCLUDE_DIR}/oplk/bintrace.h
+    ${STACK_INCLUDE_DIR}/oplk/memarena.h
+    ${STACK_INCLUDE_DIR}/oplk/multiplex.h
     ${STACK_INCLUDE_DIR}/oplk/basictypes.h
     ${STACK_INCLUDE_DIR}/oplk/led.h
     ${STACK_INCLUDE_DIR}/oplk/nmt.h
     ${STACK_INCLUDE_DIR}/oplk/obd.h
     ${STACK_INCLUDE_DIR}/oplk/obdcdc.h
+    ${STACK_INCLUDE_DIR}/oplk/obdfile.h
+    ${STACK_INCLUDE_DIR}/oplk/obdstore.h
     ${STACK_INCLUDE_DIR}/oplk/obdmacro.h
     ${STACK_INCLUDE_DIR}/oplk/powerlink-module.h
     ${STACK_INCLUDE_DIR}/oplk/sdo.h
@@ -431,8 +549,13 @@ SET(STACK_HEADERS
     ${STACK_INCLUDE_DIR}/common/ctrl.h
     ${STACK_INCLUDE_DIR}/common/ctrlcal.h
     ${STACK_INCLUDE_DIR}/common/ctrlcal-mem.h
+    ${STACK_INCLUDE_DIR}/common/cyclestat.h
+    ${STACK_INCLUDE_DIR}/common/flightrec.h
+    ${STACK_INCLUDE_DIR}/common/memcopy.h
+    ${STACK_INCLUDE_DIR}/common/metrics.h
     ${STACK_INCLUDE_DIR}/common/dllcal.h
     ${STACK_INCLUDE_DIR}/common/errhnd.h
+    ${STACK_INCLUDE_DIR}/common/nodeset.h
     ${STACK_INCLUDE_DIR}/common/pdo.h
     ${STACK_INCLUDE_DIR}/common/target.h
     ${STACK_INCLUDE_DIR}/common/timer.h
@@ -449,6 +572,7 @@ SET(USER_HEADERS
     ${STACK_INCLUDE_DIR}/user/eventucalintf.h
     ${STACK_INCLUDE_DIR}/user/identu.h
     ${STACK_INCLUDE_DIR}/user/ledu.h
+    ${STACK_INCLUDE_DIR}/user/multiplexu.h
     ${STACK_INCLUDE_DIR}/user/nmtcnu.h
     ${STACK_INCLUDE_DIR}/user/nmtmnu.h
     ${STACK_INCLUDE_DIR}/user/nmtu.h
@@ -472,6 +596,7 @@ SET(KERNEL_HEADERS
     ${STACK_INCLUDE_DIR}/kernel/dllktgt.h
     ${STACK_INCLUDE_DIR}/kernel/hrestimer.h
     ${STACK_INCLUDE_DIR}/kernel/synctimer.h
+    ${STACK_INCLUDE_DIR}/kernel/syncservo.h
     ${STACK_INCLUDE_DIR}/kernel/errhndk.h
     ${STACK_INCLUDE_DIR}/kernel/eventk.h
     ${STACK_INCLUDE_DIR}/kernel/eventkcal.h
@@ -481,6 +606,10 @@ SET(KERNEL_HEADERS
     ${STACK_INCLUDE_DIR}/kernel/pdokcal.h
     ${STACK_INCLUDE_DIR}/kernel/veth.h
     ${STACK_INCLUDE_DIR}/kernel/edrv.h
+    ${STACK_INCLUDE_DIR}/kernel/edrvfilter.h
+    ${STACK_INCLUDE_DIR}/kernel/edrvmirror.h
+    ${STACK_INCLUDE_DIR}/kernel/edrvpoll.h
+    ${STACK_INCLUDE_DIR}/kernel/edrvirq.h
     )
 
 SET(OBJDICT_HEADERS
@@ -53,10 +53,26 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define ami_getUint8Be(pAddr_p) (*(UINT8*)(pAddr_p))
 #define ami_getUint8Le(pAddr_p) (*(UINT8*)(pAddr_p))
 
+// The 16, 32 and 64 bit accessors are inlined if the byte order of the target
+// is known at compile time. The access through the unaligned types compiles to
+// a plain load or store on targets with unaligned access and to byte accesses
+// on all others. The AMI implementations define AMI_NO_INLINE to provide the
+// out-of-line functions.
+#if ((CONFIG_AMI_INLINE != FALSE) && !defined(AMI_NO_INLINE) && \
+     defined(__GNUC__) && defined(__BYTE_ORDER__))
+#define AMI_INLINE_ACCESSORS
+#endif
+
 //------------------------------------------------------------------------------
 // typedef
 //------------------------------------------------------------------------------
 
+#ifdef AMI_INLINE_ACCESSORS
+typedef UINT16 __attribute__((__may_alias__, __aligned__(1))) tAmiUnalignedUint16;
+typedef UINT32 __attribute__((__may_alias__, __aligned__(1))) tAmiUnalignedUint32;
+typedef UINT64 __attribute__((__may_alias__, __aligned__(1))) tAmiUnalignedUint64;
+#endif
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
@@ -118,9 +134,137 @@ UINT64 ami_getUint64Le(void* pAddr_p);
 void ami_setTimeOfDay(void* pAddr_p, tTimeOfDay* pTimeOfDay_p);
 void ami_getTimeOfDay(void* pAddr_p, tTimeOfDay* pTimeOfDay_p);
 
+// Bulk conversion functions for arrays of WORD
+void ami_setUint16ArrayBe(void* pAddr_p, const UINT16* pVal_p, UINT count_p);
+void ami_setUint16ArrayLe(void* pAddr_p, const UINT16* pVal_p, UINT count_p);
+
+void ami_getUint16ArrayBe(const void* pAddr_p, UINT16* pVal_p, UINT count_p);
+void ami_getUint16ArrayLe(const void* pAddr_p, UINT16* pVal_p, UINT count_p);
+
+// Bulk conversion functions for arrays of DWORD
+void ami_setUint32ArrayBe(void* pAddr_p, const UINT32* pVal_p, UINT count_p);
+void ami_setUint32ArrayLe(void* pAddr_p, const UINT32* pVal_p, UINT count_p);
+
+void ami_getUint32ArrayBe(const void* pAddr_p, UINT32* pVal_p, UINT count_p);
+void ami_getUint32ArrayLe(const void* pAddr_p, UINT32* pVal_p, UINT count_p);
+
+// Bulk conversion functions for arrays of QWORD
+void ami_setUint64ArrayBe(void* pAddr_p, const UINT64* pVal_p, UINT count_p);
+void ami_setUint64ArrayLe(void* pAddr_p, const UINT64* pVal_p, UINT count_p);
+
+void ami_getUint64ArrayBe(const void* pAddr_p, UINT64* pVal_p, UINT count_p);
+void ami_getUint64ArrayLe(const void* pAddr_p, UINT64* pVal_p, UINT count_p);
+
+// Bulk conversion functions for bit-packed boolean values
+void ami_setBitArray(void* pAddr_p, UINT bitOffset_p, const UINT8* pVal_p, UINT count_p);
+void ami_getBitArray(const void* pAddr_p, UINT bitOffset_p, UINT8* pVal_p, UINT count_p);
+
 #ifdef __cplusplus
 }
 #endif
 
+//------------------------------------------------------------------------------
+// inline functions
+//------------------------------------------------------------------------------
+
+#ifdef AMI_INLINE_ACCESSORS
+
+#define AMI_SWAP16(val_p)   ((UINT16)(((val_p) >> 8) | ((val_p) << 8)))
+#define AMI_SWAP32(val_p)   ((UINT32)__builtin_bswap32(val_p))
+#define AMI_SWAP64(val_p)   ((UINT64)__builtin_bswap64(val_p))
+
+#if (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define AMI_TO_BE16(val_p)  ((UINT16)(val_p))
+#define AMI_TO_BE32(val_p)  ((UINT32)(val_p))
+#define AMI_TO_BE64(val_p)  ((UINT64)(val_p))
+#define AMI_TO_LE16(val_p)  AMI_SWAP16((UINT16)(val_p))
+#define AMI_TO_LE32(val_p)  AMI_SWAP32(val_p)
+#define AMI_TO_LE64(val_p)  AMI_SWAP64(val_p)
+#else
+#define AMI_TO_BE16(val_p)  AMI_SWAP16((UINT16)(val_p))
+#define AMI_TO_BE32(val_p)  AMI_SWAP32(val_p)
+#define AMI_TO_BE64(val_p)  AMI_SWAP64(val_p)
+#define AMI_TO_LE16(val_p)  ((UINT16)(val_p))
+#define AMI_TO_LE32(val_p)  ((UINT32)(val_p))
+#define AMI_TO_LE64(val_p)  ((UINT64)(val_p))
+#endif
+
+static __inline__ void ami_inlineSetUint16Be(void* pAddr_p, UINT16 uint16Val_p)
+{
+    *(tAmiUnalignedUint16*)pAddr_p = AMI_TO_BE16(uint16Val_p);
+}
+
+static __inline__ void ami_inlineSetUint16Le(void* pAddr_p, UINT16 uint16Val_p)
+{
+    *(tAmiUnalignedUint16*)pAddr_p = AMI_TO_LE16(uint16Val_p);
+}
+
+static __inline__ UINT16 ami_inlineGetUint16Be(const void* pAddr_p)
+{
+    return AMI_TO_BE16(*(const tAmiUnalignedUint16*)pAddr_p);
+}
+
+static __inline__ UINT16 ami_inlineGetUint16Le(const void* pAddr_p)
+{
+    return AMI_TO_LE16(*(const tAmiUnalignedUint16*)pAddr_p);
+}
+
+static __inline__ void ami_inlineSetUint32Be(void* pAddr_p, UINT32 uint32Val_p)
+{
+    *(tAmiUnalignedUint32*)pAddr_p = AMI_TO_BE32(uint32Val_p);
+}
+
+static __inline__ void ami_inlineSetUint32Le(void* pAddr_p, UINT32 uint32Val_p)
+{
+    *(tAmiUnalignedUint32*)pAddr_p = AMI_TO_LE32(uint32Val_p);
+}
+
+static __inline__ UINT32 ami_inlineGetUint32Be(const void* pAddr_p)
+{
+    return AMI_TO_BE32(*(const tAmiUnalignedUint32*)pAddr_p);
+}
+
+static __inline__ UINT32 ami_inlineGetUint32Le(const void* pAddr_p)
+{
+    return AMI_TO_LE32(*(const tAmiUnalignedUint32*)pAddr_p);
+}
+
+static __inline__ void ami_inlineSetUint64Be(void* pAddr_p, UINT64 uint64Val_p)
+{
+    *(tAmiUnalignedUint64*)pAddr_p = AMI_TO_BE64(uint64Val_p);
+}
+
+static __inline__ void ami_inlineSetUint64Le(void* pAddr_p, UINT64 uint64Val_p)
+{
+    *(tAmiUnalignedUint64*)pAddr_p = AMI_TO_LE64(uint64Val_p);
+}
+
+static __inline__ UINT64 ami_inlineGetUint64Be(const void* pAddr_p)
+{
+    return AMI_TO_BE64(*(const tAmiUnalignedUint64*)pAddr_p);
+}
+
+static __inline__ UINT64 ami_inlineGetUint64Le(const void* pAddr_p)
+{
+    return AMI_TO_LE64(*(const tAmiUnalignedUint64*)pAddr_p);
+}
+
+// The function names map to the inline versions, the exported functions remain
+// available for callers which take their address or are built without inlining.
+#define ami_setUint16Be(pAddr_p, uint16Val_p)   ami_inlineSetUint16Be(pAddr_p, uint16Val_p)
+#define ami_setUint16Le(pAddr_p, uint16Val_p)   ami_inlineSetUint16Le(pAddr_p, uint16Val_p)
+#define ami_getUint16Be(pAddr_p)                ami_inlineGetUint16Be(pAddr_p)
+#define ami_getUint16Le(pAddr_p)                ami_inlineGetUint16Le(pAddr_p)
+#define ami_setUint32Be(pAddr_p, uint32Val_p)   ami_inlineSetUint32Be(pAddr_p, uint32Val_p)
+#define ami_setUint32Le(pAddr_p, uint32Val_p)   ami_inlineSetUint32Le(pAddr_p, uint32Val_p)
+#define ami_getUint32Be(pAddr_p)                ami_inlineGetUint32Be(pAddr_p)
+#define ami_getUint32Le(pAddr_p)                ami_inlineGetUint32Le(pAddr_p)
+#define ami_setUint64Be(pAddr_p, uint64Val_p)   ami_inlineSetUint64Be(pAddr_p, uint64Val_p)
+#define ami_setUint64Le(pAddr_p, uint64Val_p)   ami_inlineSetUint64Le(pAddr_p, uint64Val_p)
+#define ami_getUint64Be(pAddr_p)                ami_inlineGetUint64Be(pAddr_p)
+#define ami_getUint64Le(pAddr_p)                ami_inlineGetUint64Le(pAddr_p)
+
+#endif /* AMI_INLINE_ACCESSORS */
+
 
 #endif /* _INC_common_ami_H_ */
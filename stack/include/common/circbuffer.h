@@ -46,6 +46,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 #define NR_OF_CIRC_BUFFERS              20
 #define CIRCBUF_BLOCK_ALIGNMENT         4
+#define CIRCBUF_CACHE_LINE_SIZE         64      // Size used to separate the lock-free indices
 
 #undef  DEBUG_CIRCBUF_SIZE_CHECK                // Add debug code for retrieving maximum used buffer size
 
@@ -64,6 +65,7 @@ typedef enum
     kCircBufNoReadableData              =  1,
     kCircBufReadsizeTooSmall            =  2,
     kCircBufBufferFull                  =  3,
+    kCircBufDataNotContiguous           =  4,
     kCircBufOpenMismatch                =  7,
     kCircBufInvalidArg                  =  9,
     kCircBufOutOfMem                    = 11,
@@ -72,6 +74,24 @@ typedef enum
     kCircBufNoResource                  = 20
 } tCircBufError;
 
+/**
+*  \brief Index of a lock-free circular buffer
+*
+*  The union defines an index of a circular buffer which is used in lock-free
+*  single-producer/single-consumer mode. The index is only modified by its
+*  owner (producer or consumer). It is padded to a cache line to avoid false
+*  sharing between the producer and the consumer.
+*/
+typedef union
+{
+    struct
+    {
+        volatile UINT32 offset;             ///< Offset in the buffer
+        volatile UINT32 blockCount;         ///< Number of processed blocks
+    } index;
+    UINT8               aCacheLine[CIRCBUF_CACHE_LINE_SIZE];    ///< Cache line padding
+} tCircBufLockFreeIndex;
+
 /**
 *  \brief Header for circular buffer
 *
@@ -89,6 +109,9 @@ typedef struct
 #ifdef DEBUG_CIRCBUF_SIZE_CHECK
     UINT32              maxSize;            ///< Maximum used space in circular buffer
 #endif
+    UINT32              lockFree;           ///< Buffer is used in lock-free mode
+    tCircBufLockFreeIndex writeIndex;       ///< Write index in lock-free mode (producer)
+    tCircBufLockFreeIndex readIndex;        ///< Read index in lock-free mode (consumer)
 } tCircBufHeader;
 
 /**
@@ -104,6 +127,8 @@ typedef struct
     void*               pCircBufArchInstance;       ///< Pointer to architecture specific stuff
     UINT8               bufferId;                   ///< The id of the circular buffer
     VOIDFUNCPTR         pfnSigCb;                   ///< Pointer to the signaling callback function
+    BOOL                fLockFree;                  ///< Buffer is used in lock-free single-producer/single-consumer mode
+    BOOL                fSignalOnEmpty;             ///< Signal only writes to an empty buffer (lock-free mode only)
 } tCircBufInstance;
 
 //------------------------------------------------------------------------------
@@ -127,6 +152,10 @@ tCircBufError circbuf_writeMultipleData(tCircBufInstance* pInstance_p, const voi
 tCircBufError circbuf_readData(tCircBufInstance* pInstance_p, void* pData_p,
                                size_t size_p, size_t* pDataBlockSize_p)
                                SECTION_CIRCBUF_READ_DATA;
+tCircBufError circbuf_reserve(tCircBufInstance* pInstance_p, size_t size_p, void** ppData_p);
+tCircBufError circbuf_commit(tCircBufInstance* pInstance_p, void* pData_p);
+tCircBufError circbuf_peek(tCircBufInstance* pInstance_p, void** ppData_p, size_t* pDataBlockSize_p);
+tCircBufError circbuf_release(tCircBufInstance* pInstance_p);
 UINT32        circbuf_getDataCount(tCircBufInstance* pInstance_p);
 tCircBufError circBuf_setSignaling(tCircBufInstance* pInstance_p, VOIDFUNCPTR pfnSigCb_p);
 
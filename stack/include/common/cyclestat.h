@@ -0,0 +1,150 @@
+/**
+********************************************************************************
+\file   common/cyclestat.h
+
+\brief  Definitions for the cycle statistics module
+
+The cycle statistics module measures the latency of the stages of a POWERLINK
+cycle relative to the start of the cycle and records it in histograms.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_common_cyclestat_H_
+#define _INC_common_cyclestat_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <oplk/cyclestat.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+#if (CONFIG_CYCLE_STATISTICS != FALSE)
+#define CYCLESTAT_START_CYCLE()         cyclestat_startCycle()
+#define CYCLESTAT_MARK(stage_p)         cyclestat_mark(stage_p)
+#define CYCLESTAT_MARK_PREQ_TX(nodeId_p) cyclestat_markPreqTx(nodeId_p)
+#define CYCLESTAT_MARK_PRES_RX(nodeId_p) cyclestat_markPresRx(nodeId_p)
+#define CYCLESTAT_MARK_SOC_WIRE(timeStamp_p) cyclestat_markSocWire(timeStamp_p)
+#define CYCLESTAT_ADD_PRES_WIRE(nodeId_p, latency_p) cyclestat_addPresWireLatency(nodeId_p, latency_p)
+#define CYCLESTAT_MARK_SYNC_START()     cyclestat_markSyncStart()
+#define CYCLESTAT_CHECK_SYNC_END()      cyclestat_checkSyncEnd()
+#else
+#define CYCLESTAT_START_CYCLE()
+#define CYCLESTAT_MARK(stage_p)
+#define CYCLESTAT_MARK_PREQ_TX(nodeId_p)
+#define CYCLESTAT_MARK_PRES_RX(nodeId_p)
+#define CYCLESTAT_MARK_SOC_WIRE(timeStamp_p)
+#define CYCLESTAT_ADD_PRES_WIRE(nodeId_p, latency_p)
+#define CYCLESTAT_MARK_SYNC_START()
+#define CYCLESTAT_CHECK_SYNC_END()      TRUE
+#endif
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Rolling window of a histogram
+
+The structure contains the samples of the rolling window of a histogram. The
+window consists of two halves. New samples are recorded in the active half.
+If it is full, the other half is cleared and becomes the active one.
+*/
+typedef struct
+{
+    UINT32              activeHalf;                             ///< Index of the active half
+    UINT32              aSampleCount[2];                        ///< Number of samples per half
+    UINT32              aBucket[2][CYCLESTAT_BUCKET_COUNT];     ///< Number of samples per bucket and half
+} tCycleStatWindow;
+
+/**
+\brief  Rolling windows of a node
+
+The structure contains the rolling windows of the timings of a node and the
+transmission time of its last PReq.
+*/
+typedef struct
+{
+    ULONGLONG           preqTxTime;             ///< Cycle counter value of the last PReq transmission
+    tCycleStatWindow    socToPreq;              ///< Rolling window of the time from SoC to PReq
+    tCycleStatWindow    preqToPres;             ///< Rolling window of the time from PReq to PRes
+    tCycleStatWindow    preqToPresWire;         ///< Rolling window of the wire time from PReq to PRes
+} tCycleStatNodeWindow;
+
+/**
+\brief  Cycle statistics memory
+
+The structure is shared between the user and the kernel layer of the stack.
+The percentiles in \ref statistics are only determined when the statistics
+are read.
+*/
+typedef struct
+{
+    ULONGLONG               cycleStartTime;                         ///< Cycle counter value of the current cycle start
+    ULONGLONG               socWireTime;                            ///< Hardware time stamp of the last SoC in ns
+    tCycleStatistics        statistics;                             ///< Histograms of the cycle stages and nodes
+    tCycleStatWindow        aStageWindow[kCycleStatStageCount];     ///< Rolling windows of the cycle stages
+    tCycleStatNodeWindow    aNodeWindow[CYCLESTAT_NODE_COUNT];      ///< Rolling windows of the nodes
+    ULONGLONG               syncCycleStartTime;                     ///< Cycle start of the current sync processing (0 = none)
+    tCycleStatSyncBudget    syncBudget;                             ///< Sync budget of the application
+} tCycleStatMemory;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+tOplkError cyclestat_init(void);
+void       cyclestat_exit(void);
+void       cyclestat_startCycle(void);
+void       cyclestat_mark(tCycleStatStage stage_p);
+void       cyclestat_markPreqTx(UINT nodeId_p);
+void       cyclestat_markPresRx(UINT nodeId_p);
+void       cyclestat_markSocWire(ULONGLONG timeStamp_p);
+void       cyclestat_addPresWireLatency(UINT nodeId_p, ULONGLONG latency_p);
+tOplkError cyclestat_getStatistics(tCycleStatistics* pStatistics_p);
+void       cyclestat_markSyncStart(void);
+BOOL       cyclestat_checkSyncEnd(void);
+tOplkError cyclestat_setSyncBudget(UINT32 budget_p, BOOL fSkipLateTxPdo_p);
+tOplkError cyclestat_getSyncBudget(tCycleStatSyncBudget* pSyncBudget_p);
+
+tOplkError cyclestat_initMemory(tCycleStatMemory** ppMemory_p);
+void       cyclestat_exitMemory(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_common_cyclestat_H_ */
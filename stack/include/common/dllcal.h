@@ -58,6 +58,17 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_DLLCAL_BUFFER_SIZE_TX_SYNC  8192
 #endif
 
+// Size of the queue for virtual Ethernet frames, 0 = share the generic queue
+#ifndef CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH
+#define CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH  32767
+#endif
+
+// Drop virtual Ethernet frames silently if their queue is full instead of
+// rejecting them with kErrorDllAsyncTxBufferFull
+#ifndef CONFIG_DLLCAL_TX_VETH_DROP_ON_FULL
+#define CONFIG_DLLCAL_TX_VETH_DROP_ON_FULL  FALSE
+#endif
+
 /* setup interface getting function for DLLCAL queue */
 #if (CONFIG_DLLCAL_QUEUE == DIRECT_QUEUE)
 #define GET_DLLKCAL_INTERFACE dllcaldirect_getInterface
@@ -81,6 +92,13 @@ typedef struct
     tDllAsndFilter          filter;
 } tDllCalAsndServiceIdFilter;
 
+typedef struct
+{
+    tDllAsndServiceId       serviceId;
+    UINT                    maxFramesPerSec;    ///< Maximum forwarded frames per second, 0 = unlimited
+    BOOL                    fCoalesce;          ///< Forward only StatusResponses which have changed
+} tDllCalAsndServiceIdLimit;
+
 typedef struct
 {
     tDllReqServiceId        service;
@@ -99,6 +117,7 @@ typedef enum
     kDllCalQueueTxNmt        = 0x01, ///< TX NMT queue
     kDllCalQueueTxGen        = 0x02, ///< TX Generic queue
     kDllCalQueueTxSync       = 0x03, ///< Tx Sync queue
+    kDllCalQueueTxVeth       = 0x04, ///< Tx virtual Ethernet queue
 } tDllCalQueue;
 
 /**
@@ -119,6 +138,8 @@ typedef struct
     tOplkError (*pfnGetDataBlock)(tDllCalQueueInstance pDllCalQueue_p, UINT8* pData_p, UINT* pDataSize_p);
     tOplkError (*pfnGetDataBlockCount)(tDllCalQueueInstance pDllCalQueue_p, ULONG* pDataBlockCount_p);
     tOplkError (*pfnResetDataBlockQueue)(tDllCalQueueInstance pDllCalQueue_p, ULONG timeOutMs_p);
+    tOplkError (*pfnReserveDataBlock)(tDllCalQueueInstance pDllCalQueue_p, UINT8** ppData_p, UINT dataSize_p);   ///< Reserve a data block in place (NULL = not supported)
+    tOplkError (*pfnCommitDataBlock)(tDllCalQueueInstance pDllCalQueue_p, UINT8* pData_p);                     ///< Commit a reserved data block (NULL = not supported)
 } tDllCalFuncIntf;
 
 //------------------------------------------------------------------------------
@@ -132,6 +153,8 @@ extern "C" {
 tDllCalFuncIntf* dllcaldirect_getInterface(void);
 tDllCalFuncIntf* dllcalshb_getInterface(void);
 tDllCalFuncIntf* dllcalioctl_getInterface(void);
+void             dllcalioctl_startBatch(void);
+tOplkError       dllcalioctl_flushBatch(void);
 tDllCalFuncIntf* dllucalcircbuf_getInterface(void);
 tDllCalFuncIntf* dllkcalcircbuf_getInterface(void);
 
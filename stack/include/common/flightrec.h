@@ -0,0 +1,103 @@
+/**
+********************************************************************************
+\file   common/flightrec.h
+
+\brief  Definitions for the cycle flight recorder module
+
+The cycle flight recorder module keeps the frames of the last cycles handled by
+the DLL and freezes them when a DLL error occurs.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+#ifndef _INC_common_flightrec_H_
+#define _INC_common_flightrec_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <oplk/flightrec.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+#if (CONFIG_FLIGHT_RECORDER != FALSE)
+#define FLIGHTREC_START_CYCLE()                         flightrec_startCycle()
+#define FLIGHTREC_RECORD_FRAME(pFrame_p, size_p, fTx_p) flightrec_recordFrame(pFrame_p, size_p, fTx_p)
+#else
+#define FLIGHTREC_START_CYCLE()
+#define FLIGHTREC_RECORD_FRAME(pFrame_p, size_p, fTx_p)
+#endif
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Flight recorder memory
+
+The structure is shared between the user and the kernel layer of the stack.
+The cycles are stored in a ring, \ref curCycleIndex is the entry of the current
+cycle. \ref fFrozen is set by the kernel layer and cleared by the user layer.
+*/
+typedef struct
+{
+    UINT32              fFrozen;                                ///< Recorder is frozen
+    UINT32              triggerErrors;                          ///< DLL error events which froze the recorder
+    UINT32              triggerNodeId;                          ///< Node ID of the error which froze the recorder
+    ULONGLONG           triggerTime;                            ///< Timestamp of the error which froze the recorder in ns
+    UINT32              cycleCount;                             ///< Number of cycles recorded since the recorder was armed
+    UINT32              curCycleIndex;                          ///< Ring entry of the current cycle
+    tFlightRecCycle     aCycle[CONFIG_FLIGHT_RECORDER_CYCLES];  ///< Ring of recorded cycles
+} tFlightRecMemory;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+tOplkError flightrec_init(void);
+void       flightrec_exit(void);
+void       flightrec_startCycle(void);
+void       flightrec_recordFrame(const void* pFrame_p, UINT frameSize_p, BOOL fTx_p);
+void       flightrec_trigger(UINT32 errors_p, UINT nodeId_p);
+tOplkError flightrec_getRecord(tFlightRecord* pRecord_p);
+void       flightrec_rearm(void);
+
+tOplkError flightrec_initMemory(tFlightRecMemory** ppMemory_p);
+void       flightrec_exitMemory(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_common_flightrec_H_ */
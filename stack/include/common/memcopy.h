@@ -0,0 +1,156 @@
+/**
+********************************************************************************
+\file   common/memcopy.h
+
+\brief  Specialized memory copy functions
+
+The header provides copy functions for call sites which know more about the
+copied data than OPLK_MEMCPY(). Copies of small constant sizes use
+OPLK_MEMCPY_FIXED() from oplkinc.h. Large blocks which are not read again by
+the current core, e.g. PDO images handed over to another layer, are copied by
+memcopy_stream().
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_common_memcopy_H_
+#define _INC_common_memcopy_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+
+// The SSE2 streaming stores are only used in user space, the kernel doesn't
+// save the vector registers of the interrupted task.
+#if defined(__GNUC__) && defined(__SSE2__) && !defined(__KERNEL__)
+#include <emmintrin.h>
+#define MEMCOPY_STREAM_SSE2
+#endif
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define MEMCOPY_STREAM_BLOCK_SIZE       64          // bytes copied per loop, one cache line
+#define MEMCOPY_PREFETCH_DISTANCE       256         // bytes the source is prefetched ahead
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// inline functions
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy a block which the current core doesn't read again
+
+The function copies the block with non-temporal stores, which write the
+destination past the caches and don't read it before. The source is
+prefetched ahead of the copy. Thus the copy neither evicts the working set of
+the current core nor causes a cache line transfer to the consumer, which
+would read the lines from the cache of this core otherwise.
+
+The non-temporal stores are weakly ordered. Before the block is published to
+another core or a DMA, the caller has to order them with
+memcopy_streamFence() or OPLK_MEMBAR(), which is a full barrier. A fence per
+block would wait for each block to be written to the memory.
+
+Blocks smaller than CONFIG_MEMCOPY_STREAM_THRESHOLD and targets without SSE2
+are copied with OPLK_MEMCPY().
+
+\param  pDst_p              Destination of the copy.
+\param  pSrc_p              Source of the copy.
+\param  size_p              Number of bytes to copy.
+*/
+//------------------------------------------------------------------------------
+static __inline__ void memcopy_stream(void* pDst_p, const void* pSrc_p, size_t size_p)
+{
+#ifdef MEMCOPY_STREAM_SSE2
+    BYTE*           pDst = (BYTE*)pDst_p;
+    const BYTE*     pSrc = (const BYTE*)pSrc_p;
+    size_t          headSize;
+    __m128i         aData[4];
+
+    if (size_p < CONFIG_MEMCOPY_STREAM_THRESHOLD)
+    {
+        OPLK_MEMCPY(pDst_p, pSrc_p, size_p);
+        return;
+    }
+
+    // the streaming stores need a destination aligned to 16 bytes
+    headSize = (16 - ((size_t)pDst & 15)) & 15;
+    OPLK_MEMCPY(pDst, pSrc, headSize);
+    pDst += headSize;
+    pSrc += headSize;
+    size_p -= headSize;
+
+    while (size_p >= MEMCOPY_STREAM_BLOCK_SIZE)
+    {
+        __builtin_prefetch(pSrc + MEMCOPY_PREFETCH_DISTANCE);
+        aData[0] = _mm_loadu_si128((const __m128i*)pSrc);
+        aData[1] = _mm_loadu_si128((const __m128i*)(pSrc + 16));
+        aData[2] = _mm_loadu_si128((const __m128i*)(pSrc + 32));
+        aData[3] = _mm_loadu_si128((const __m128i*)(pSrc + 48));
+        _mm_stream_si128((__m128i*)pDst, aData[0]);
+        _mm_stream_si128((__m128i*)(pDst + 16), aData[1]);
+        _mm_stream_si128((__m128i*)(pDst + 32), aData[2]);
+        _mm_stream_si128((__m128i*)(pDst + 48), aData[3]);
+        pDst += MEMCOPY_STREAM_BLOCK_SIZE;
+        pSrc += MEMCOPY_STREAM_BLOCK_SIZE;
+        size_p -= MEMCOPY_STREAM_BLOCK_SIZE;
+    }
+
+    OPLK_MEMCPY(pDst, pSrc, size_p);
+#else
+    OPLK_MEMCPY(pDst_p, pSrc_p, size_p);
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Order the stores of memcopy_stream()
+
+The function makes the blocks copied by memcopy_stream() visible to other
+cores and DMAs before any following store.
+*/
+//------------------------------------------------------------------------------
+static __inline__ void memcopy_streamFence(void)
+{
+#ifdef MEMCOPY_STREAM_SSE2
+    _mm_sfence();
+#endif
+}
+
+#endif /* _INC_common_memcopy_H_ */
@@ -0,0 +1,90 @@
+/**
+********************************************************************************
+\file   common/metrics.h
+
+\brief  Internal definitions of the metrics registry
+
+The file contains the internal definitions of the metrics registry. Modules
+register their metrics at initialization and update them with the METRICS_xxx
+macros, which are empty if CONFIG_METRICS is FALSE.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+#ifndef _INC_common_metrics_H_
+#define _INC_common_metrics_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <oplk/metrics.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+#if (CONFIG_METRICS != FALSE)
+#define METRICS_REGISTER(name_p, type_p, ppMetric_p)    metrics_register(name_p, type_p, ppMetric_p)
+#define METRICS_ADD(pMetric_p, value_p)                 metrics_add(pMetric_p, value_p)
+#define METRICS_SET(pMetric_p, value_p)                 metrics_set(pMetric_p, value_p)
+#define METRICS_OBSERVE(pMetric_p, value_p)             metrics_observe(pMetric_p, value_p)
+#else
+#define METRICS_REGISTER(name_p, type_p, ppMetric_p)
+#define METRICS_ADD(pMetric_p, value_p)
+#define METRICS_SET(pMetric_p, value_p)
+#define METRICS_OBSERVE(pMetric_p, value_p)
+#endif
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+tOplkError metrics_init(void);
+void       metrics_exit(void);
+tOplkError metrics_register(const char* pName_p, tMetricType type_p, tMetric** ppMetric_p);
+void       metrics_add(tMetric* pMetric_p, UINT32 value_p);
+void       metrics_set(tMetric* pMetric_p, UINT64 value_p);
+void       metrics_observe(tMetric* pMetric_p, UINT32 value_p);
+tOplkError metrics_getMemory(tMetricsMemory* pMetrics_p);
+
+tOplkError metrics_initMemory(tMetricsMemory** ppMemory_p);
+void       metrics_exitMemory(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_common_metrics_H_ */
@@ -0,0 +1,99 @@
+/**
+********************************************************************************
+\file   common/nodeset.h
+
+\brief  Definitions for node ID sets
+
+A node set contains one bit per node ID (0 - 255). It has the layout of the
+POWERLINK node list (DS 301, 7.3.1.2.3) when it is stored in little endian
+byte order.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_common_nodeset_H_
+#define _INC_common_nodeset_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define NODESET_WORD_COUNT          8                       // 256 node IDs in 32 bit words
+#define NODESET_NODELIST_SIZE       (NODESET_WORD_COUNT * 4)  // size of a POWERLINK node list
+
+#define NODESET_ADD(pSet_p, nodeId_p) \
+            ((pSet_p)->aWord[(nodeId_p) >> 5] |= ((UINT32)1 << ((nodeId_p) & 31)))
+
+#define NODESET_REMOVE(pSet_p, nodeId_p) \
+            ((pSet_p)->aWord[(nodeId_p) >> 5] &= ~((UINT32)1 << ((nodeId_p) & 31)))
+
+#define NODESET_CONTAINS(pSet_p, nodeId_p) \
+            (((pSet_p)->aWord[(nodeId_p) >> 5] & ((UINT32)1 << ((nodeId_p) & 31))) != 0)
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief Node set
+
+The structure contains one bit per node ID. Bit n of word n / 32 represents
+node ID n.
+*/
+typedef struct
+{
+    UINT32              aWord[NODESET_WORD_COUNT];  ///< Bits of the node IDs
+} tNodeSet;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void nodeset_clear(tNodeSet* pSet_p);
+BOOL nodeset_isEmpty(const tNodeSet* pSet_p);
+UINT nodeset_count(const tNodeSet* pSet_p);
+void nodeset_union(tNodeSet* pSet_p, const tNodeSet* pOther_p);
+void nodeset_intersect(tNodeSet* pSet_p, const tNodeSet* pOther_p);
+void nodeset_subtract(tNodeSet* pSet_p, const tNodeSet* pOther_p);
+UINT nodeset_getNext(const tNodeSet* pSet_p, UINT nodeId_p);
+void nodeset_fromNodeList(tNodeSet* pSet_p, const UINT8* pNodeList_p);
+void nodeset_toNodeList(const tNodeSet* pSet_p, UINT8* pNodeList_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_common_nodeset_H_ */
@@ -41,6 +41,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <oplk/oplkinc.h>
+#include <oplk/frame.h>
+#include <oplk/event.h>
 
 //------------------------------------------------------------------------------
 // const defines
@@ -48,9 +50,45 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define PDO_SHB_BUF_ID                  "PdoMem"
 #define PDO_SYNC_BSDSEM                 "/semPdoSync"
 #define PDO_SHMEM_NAME                  "/podShm"
+#define PDO_SYNC_SHMEM_NAME             "/pdoSyncShm"
 
 #define PDO_MAX_ALLOC_SIZE      239 * 2 * 1500      //jba replace with a clean solution
 
+#define PDO_CACHE_LINE_SIZE             64      // Alignment of the PDO channel buffers and control information
+#define PDO_ALIGN_CACHE_LINE(size)      (((size) + (PDO_CACHE_LINE_SIZE - 1)) & ~(PDO_CACHE_LINE_SIZE - 1))
+
+// Every RPDO reader holds one buffer, the writer needs one besides the latest
+// one. The TPDOs use the first three buffers as triple buffer. With
+// CONFIG_PDO_TX_ZERO_COPY the kernel layer keeps a fourth TPDO buffer, which
+// replaces a read buffer that is still being sent.
+#if (CONFIG_PDO_RX_READER_COUNT < 1) || (CONFIG_PDO_RX_READER_COUNT > 8)
+#error "CONFIG_PDO_RX_READER_COUNT is out of range!"
+#endif
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE) && (CONFIG_PDO_RX_READER_COUNT < 2)
+#define PDO_BUFFER_COUNT                4
+#else
+#define PDO_BUFFER_COUNT                (CONFIG_PDO_RX_READER_COUNT + 2)
+#endif
+
+// The kernel process images are located in the PDO memory region, the output
+// image uses index 0 and the input image index 1 of the arrays.
+#define PDO_KERNEL_PI_SIZE              PDO_ALIGN_CACHE_LINE(CONFIG_PDO_KERNEL_PI_SIZE)
+#define PDO_KERNEL_PI_OUTPUT            0
+#define PDO_KERNEL_PI_INPUT             1
+
+// With CONFIG_PDO_TX_ZERO_COPY every TPDO channel buffer is preceded by room for
+// the frame header and holds at least the payload of a minimum sized PRes, so
+// that the buffer can be sent as frame without copying the payload.
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+#define PDO_TX_FRAME_HEADROOM           PDO_ALIGN_CACHE_LINE(CONFIG_EDRV_TX_BUFFER_HEADROOM + PLK_FRAME_OFFSET_PDO_PAYLOAD)
+#define PDO_TX_MIN_PAYLOAD              (C_DLL_MINSIZE_PRES - PLK_FRAME_OFFSET_PDO_PAYLOAD)
+#define PDO_TX_PAYLOAD_SIZE(size)       PDO_ALIGN_CACHE_LINE(((size) > PDO_TX_MIN_PAYLOAD) ? (size) : PDO_TX_MIN_PAYLOAD)
+#else
+#define PDO_TX_FRAME_HEADROOM           0
+#define PDO_TX_PAYLOAD_SIZE(size)       PDO_ALIGN_CACHE_LINE(size)
+#endif
+#define PDO_TX_BUFFER_SIZE(size)        (PDO_TX_FRAME_HEADROOM + PDO_TX_PAYLOAD_SIZE(size))
+
 // PDO mapping related OD defines
 #define PDOU_OBD_IDX_RX_COMM_PARAM      0x1400
 #define PDOU_OBD_IDX_RX_MAPP_PARAM      0x1600
@@ -63,6 +101,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define PDOU_MAX_PDO_OBJECTS            256
 #define PDO_MAX_PDO_CHANNELS            256
 
+#define PDO_NODE_BITMAP_SIZE            32      // Size of a bitmap with one bit per node ID
+
 
 // invalid PDO-NodeId
 #define PDO_INVALID_NODE_ID             0xFF
@@ -177,22 +217,167 @@ typedef struct
     tPdoChannel*        pTxPdoChannel;          ///< Pointer to TXPDO channel table
 } tPdoChannelSetup;
 
+/**
+\brief PDO route
+
+This structure specifies a route which copies a region of an RPDO into a TPDO
+in the kernel layer, without passing the data through the process images. It
+is used to exchange the route between the user and the kernel layer. The
+offsets are byte offsets in the PDO payload.
+*/
+typedef struct
+{
+    UINT16              rxChannelId;            ///< ID of the RPDO channel
+    UINT16              rxOffset;               ///< Offset of the data in the RPDO
+    UINT16              size;                   ///< Size of the data
+    UINT16              txChannelId;            ///< ID of the TPDO channel
+    UINT16              txOffset;               ///< Offset of the data in the TPDO
+} tPdoRoute;
+
+/**
+\brief Kernel process image copy operation
+
+This structure specifies a block which the kernel layer copies between a PDO
+and a process image assembled in the kernel layer. The offsets are byte
+offsets in the PDO payload and in the process image.
+*/
+typedef struct
+{
+    UINT32              piOffset;               ///< Offset of the data in the process image
+    UINT16              channelId;              ///< ID of the PDO channel
+    UINT16              pdoOffset;              ///< Offset of the data in the PDO
+    UINT16              size;                   ///< Size of the data
+    UINT16              fTx;                    ///< Flag determines the direction. TRUE = TPDO from input image, FALSE = RPDO to output image
+} tPdoKernelPiCopy;
+
+/**
+\brief Kernel process image setup
 
+This structure is used to set up the process images assembled in the kernel
+layer. The copy operations are passed in the PDO memory, because they do not
+fit into an event.
+*/
+typedef struct
+{
+    UINT32              rxPiSize;               ///< Size of the output process image (RPDOs)
+    UINT32              txPiSize;               ///< Size of the input process image (TPDOs)
+    UINT32              copyCount;              ///< Number of copy operations, 0 disables the kernel process images
+} tPdoKernelPiSetup;
+
+/**
+\brief PDO sync shared memory
+
+This structure is placed in the shared memory PDO_SYNC_SHMEM_NAME by the futex
+sync modules. The kernel layer increments \ref syncCount on every sync event
+and wakes the user layer only if it sleeps on the futex. The sequence counter is
+odd while the cycle information is updated, a reader must retry if it is odd or
+changed while reading.
+*/
+typedef struct
+{
+    volatile UINT32     syncCount;              ///< Futex word, incremented on every sync event
+    volatile UINT32     waiterCount;            ///< Number of user threads sleeping on the futex
+    volatile UINT32     sequence;               ///< Sequence counter of updates of the cycle information
+    UINT32              reserved;
+    volatile UINT64     cycleCount;             ///< Number of sync events since initialization
+    volatile UINT64     timeStamp;              ///< CLOCK_MONOTONIC time of the last sync event in ns
+} tPdoSyncShm;
+
+
+/**
+\brief PDO buffer control information
+
+The TPDOs are exchanged by a triple buffer. The RPDOs may be read by several
+independent readers: the writer publishes a buffer by storing it in
+\ref cleanBuf and then selects a buffer which is neither the latest one nor
+held by a reader as next write buffer. A reader claims the latest buffer in
+its entry of \ref aReaderBuf and keeps it until it claims a newer one, so the
+writer never waits for a reader.
+*/
 typedef struct
 {
     ULONG               channelOffset;
-    OPLK_ATOMIC_T       readBuf;
+    OPLK_ATOMIC_T       readBuf;                ///< Read buffer of the TPDO reader
     OPLK_ATOMIC_T       writeBuf;
-    OPLK_ATOMIC_T       cleanBuf;
-    UINT8               newData;
+    OPLK_ATOMIC_T       cleanBuf;               ///< Latest published buffer
+    UINT8               newData;                ///< A new TPDO is published
+    UINT32              sequence;               ///< Sequence number of the last written PDO
+    UINT32              aSequence[PDO_BUFFER_COUNT];                ///< Sequence number of the PDO in each buffer
+    OPLK_ATOMIC_T       aReaderBuf[CONFIG_PDO_RX_READER_COUNT];     ///< Buffer held by each RPDO reader
 } tPdoBufferInfo;
 
+/**
+\brief PDO buffer control information padded to a cache line
+
+The union pads the control information of a PDO channel to a cache line. This
+avoids false sharing between the kernel layer and the user layer when they
+access different channels.
+*/
+typedef union
+{
+    tPdoBufferInfo      info;                                   ///< Control information of the channel
+    UINT8               aCacheLine[PDO_CACHE_LINE_SIZE];        ///< Cache line padding
+} tPdoBufferInfoCacheLine;
+
+/**
+\brief SoC time information in the PDO memory
+
+The kernel layer updates the structure on every sync event, so the time of the
+SoC is available together with the RPDOs of the cycle. The sequence counter is
+odd while the structure is updated, a reader must retry if it is odd or changed
+while reading.
+*/
 typedef struct
 {
+    volatile UINT32     sequence;               ///< Sequence counter of updates
+    UINT32              reserved;
+    tSocTimeInfo        timeInfo;               ///< Time information of the last SoC
+} tPdoSocTime;
+
+/**
+\brief SoC time information padded to a cache line
+*/
+typedef union
+{
+    tPdoSocTime         socTime;                                ///< SoC time information
+    UINT8               aCacheLine[PDO_CACHE_LINE_SIZE];        ///< Cache line padding
+} tPdoSocTimeCacheLine;
+
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+/**
+\brief Kernel process images in the PDO memory
+
+The output process image is written by the kernel layer and read by the user
+layer, the input process image vice versa. Each image is exchanged by a triple
+buffer which is controlled by its entry in \ref aImageInfo, so both layers
+always work on a complete image of one cycle.
+*/
+typedef struct
+{
+    tPdoBufferInfoCacheLine aImageInfo[2];                              ///< Triple buffer control of the output and the input image
+    BYTE                aaaImage[2][3][PDO_KERNEL_PI_SIZE];             ///< Triple buffers of the output and the input image
+    tPdoKernelPiCopy    aCopy[CONFIG_PDO_KERNEL_PI_COPY_COUNT];         ///< Copy operations passed by the user layer
+} tPdoKernelPi;
+#endif
+
+/**
+\brief PDO memory region
+
+The structure is located at the start of the shared PDO memory. The channel
+control information is placed first, so every entry starts at a cache line
+because the region itself is page aligned. The PDO buffers follow the
+region at the next cache line.
+*/
+typedef struct
+{
+    tPdoBufferInfoCacheLine rxChannelInfo[D_PDO_RPDOChannels_U16];
+    tPdoBufferInfoCacheLine txChannelInfo[D_PDO_TPDOChannels_U16];
+    tPdoSocTimeCacheLine socTime;
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+    tPdoKernelPi        kernelPi;
+#endif
     UINT16              valid;
     size_t              pdoMemSize;
-    tPdoBufferInfo      rxChannelInfo[D_PDO_RPDOChannels_U16];
-    tPdoBufferInfo      txChannelInfo[D_PDO_TPDOChannels_U16];
 #ifdef OPLK_LOCK_T
     OPLK_LOCK_T         lock;
 #endif
@@ -43,6 +43,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 #include <oplk/oplkinc.h>
 
+#if (TARGET_SYSTEM == _LINUX_) && !defined(__KERNEL__)
+#include <pthread.h>
+#endif
+
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
@@ -68,6 +72,20 @@ tOplkError target_setDefaultGateway(UINT32 defaultGateway_p);
 ULONGLONG  target_getCurrentTimestamp(void);
 void       target_enableGlobalInterrupt(BYTE fEnable_p) SECTION_TARGET_GLOBAL_INT;
 UINT32     target_getTickCount(void);
+ULONGLONG  target_getCycleCounter(void);
+ULONGLONG  target_convertCyclesToNs(ULONGLONG cycles_p);
+
+#if (TARGET_SYSTEM == _LINUX_) && !defined(__KERNEL__)
+void       target_setThreadConfig(const tThreadParam* paThreadParam_p);
+tOplkError target_createThread(pthread_t* pThread_p, tThreadRole role_p, const char* pName_p,
+                               void* (*pfnThread_p)(void*), void* pArg_p);
+tOplkError target_setThreadParams(pthread_t thread_p, tThreadRole role_p,
+                                  tThreadSchedPolicy policy_p, INT priority_p, UINT32 cpuMask_p);
+ULONGLONG  target_convertRealtimeToTimestamp(ULONGLONG realtime_p);
+#if (CONFIG_TARGET_CACHE_ALLOC != FALSE) && (CONFIG_METRICS != FALSE)
+void       target_updateCacheMetrics(void);
+#endif
+#endif
 
 #ifdef __cplusplus
 }
@@ -70,6 +70,7 @@ UINT16     ctrlkcal_getStatus(void);
 void       ctrlkcal_updateHeartbeat(UINT16 heartbeat_p);
 tOplkError ctrlkcal_readInitParam(tCtrlInitParam* pInitParam_p);
 void       ctrlkcal_storeInitParam(tCtrlInitParam* pInitParam_p);
+BYTE*      ctrlkcal_getStatusMem(void);
 
 #ifdef __cplusplus
 }
@@ -77,6 +77,7 @@ struct _tDllkNodeInfo
 {
     UINT                        nodeId;
     UINT16                      presPayloadLimit;       // object 0x1F8D: NMT_PResPayloadLimitList_AU16
+    UINT                        presFrameSizeLimit;     // maximum PRes frame size derived from presPayloadLimit
     UINT8                       presFilterFlags;
 #if defined(CONFIG_INCLUDE_NMT_MN)
     UINT8                       aMacAddr[6];
@@ -86,8 +87,18 @@ struct _tDllkNodeInfo
     tNmtState                   nmtState;
     ULONG                       dllErrorEvents;
     UINT32                      presTimeoutNs;          // object 0x1F92: NMT_MNCNPResTimeout_AU32
+    UINT8                       multiplCycleAssign;     // object 0x1F9B: NMT_MultiplCycleAssign_AU8, 0 = continuous CN
+#if (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE)
+    UINT32                      adaptPresTimeoutNs;     // PRes timeout adapted to the measured response times
+    UINT32                      presLatencyMaxNs;       // decaying maximum of the measured response times
+    UINT32                      presLatencyCount;       // number of measured response times
+    ULONGLONG                   preqTxTimeNs;           // timestamp of the last PReq transmission
+#endif
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+    ULONGLONG                   preqTxWireTimeNs;       // hardware time stamp of the last PReq transmission
+    ULONGLONG                   presRxWireTimeNs;       // hardware time stamp of the last PRes reception
+#endif
     struct sEdrvTxBuffer*       pPreqTxBuffer;
-    struct _tDllkNodeInfo*      pNextNodeInfo;
     UINT8                       errSigState;            // State of error signaling initialization state machine
     UINT8                       errSigReqCnt;           // Request counter for error signaling initialization
 #endif
@@ -138,13 +149,26 @@ tOplkError dllk_process(tEvent* pEvent_p) SECTION_DLLK_PROCESS;
 tOplkError dllk_regAsyncHandler(tDllkCbAsync pfnDllkCbAsync_p);
 tOplkError dllk_deregAsyncHandler(tDllkCbAsync pfnDllkCbAsync_p);
 tOplkError dllk_setAsndServiceIdFilter(tDllAsndServiceId ServiceId_p, tDllAsndFilter Filter_p);
+tOplkError dllk_setAsndServiceIdLimit(tDllAsndServiceId serviceId_p, UINT maxFramesPerSec_p,
+                                      BOOL fCoalesce_p);
 void       dllk_regRpdoHandler(tDllkCbProcessRpdo pfnDllkCbProcessRpdo_p);
 void       dllk_regTpdoHandler(tDllkCbProcessTpdo pfnDllkCbProcessTpdo_p);
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+void       dllk_regTpdoZeroCopyHandler(tDllkCbProcessTpdo pfnDllkCbProcessTpdo_p);
+#endif
 tSyncCb dllk_regSyncHandler(tSyncCb pfnCbSync_p);
+#if (CONFIG_DLL_SOC_TIME_INFO != FALSE)
+void       dllk_getSocTimeInfo(tSocTimeInfo* pSocTimeInfo_p);
+#endif
 #if CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_SYNC != FALSE || CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_ASYNC != FALSE
 tOplkError dllk_releaseRxFrame(tPlkFrame* pFrame_p, UINT uiFrameSize_p);
 #endif
 
+#if (CONFIG_DLL_STATE_TRANSITION_COUNT != FALSE)
+tOplkError dllk_getStateTransitionCount(BOOL fStopped_p, tDllState dllState_p,
+                                        tNmtEvent nmtEvent_p, UINT32* pCount_p);
+#endif
+
 #if NMT_MAX_NODE_ID > 0
 tOplkError dllk_configNode(tDllNodeInfo* pNodeInfo_p);
 tOplkError dllk_addNode(tDllNodeOpParam* pNodeOpParam_p);
@@ -155,6 +179,9 @@ tOplkError dllk_deleteNode(tDllNodeOpParam* pNodeOpParam_p);
 tOplkError dllk_setFlag1OfNode(UINT nodeId_p, UINT8 soaFlag1_p);
 void       dllk_getCurrentCnNodeIdList(BYTE** ppbCnNodeIdList_p);
 tOplkError dllk_getCnMacAddress(UINT nodeId_p, UINT8* pCnMacAddress_p);
+#if (CONFIG_DLL_PREOP1_IDLE_SLOT_TIME_MAX != 0) && (CONFIG_TIMER_USE_HIGHRES != FALSE)
+tOplkError dllk_wakeReducedCycle(void);
+#endif
 #endif
 
 #ifdef __cplusplus
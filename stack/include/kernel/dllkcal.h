@@ -51,14 +51,40 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // typedef
 //------------------------------------------------------------------------------
+#if defined(CONFIG_INCLUDE_NMT_MN)
+/**
+\brief Asynchronous request queues of the MN SoA scheduler
+
+The enumeration lists the request queues which are served by
+dllkcal_getSoaRequest() in this round-robin order.
+*/
+typedef enum
+{
+    kDllkCalSoaQueueCnGen       = 0,    ///< Generic requests of CNs
+    kDllkCalSoaQueueCnNmt,              ///< NMT requests of CNs
+    kDllkCalSoaQueueMnGenNmt,           ///< Generic and NMT frames of the MN
+    kDllkCalSoaQueueMnIdent,            ///< IdentRequests issued by the MN
+    kDllkCalSoaQueueMnStatus,           ///< StatusRequests issued by the MN
+    kDllkCalSoaQueueMnSync,             ///< SyncRequests issued by the MN
+    kDllkCalSoaQueueCount               ///< Number of SoA request queues
+} tDllkCalSoaQueue;
+#endif
+
 typedef struct
 {
     ULONG       curTxFrameCountGen;
     ULONG       curTxFrameCountNmt;
+    ULONG       curTxFrameCountVeth;                        ///< Virtual Ethernet frames in their own queue
     ULONG       curRxFrameCount;
     ULONG       maxTxFrameCountGen;
     ULONG       maxTxFrameCountNmt;
+    ULONG       maxTxFrameCountVeth;                        ///< High-water mark of the virtual Ethernet queue
     ULONG       maxRxFrameCount;
+    ULONG       txDropCountVeth;                            ///< Virtual Ethernet frames rejected or dropped because their queue was full
+#if defined(CONFIG_INCLUDE_NMT_MN)
+    ULONG       aSoaRequestCount[kDllkCalSoaQueueCount];    ///< Requests entered per SoA queue (MnGenNmt: SoAs with a pending MN frame)
+    ULONG       aSoaGrantCount[kDllkCalSoaQueueCount];      ///< Async slots assigned per SoA queue
+#endif
 } tDllkCalStatistics;
 
 //------------------------------------------------------------------------------
@@ -86,6 +112,8 @@ tOplkError dllkcal_sendAsyncFrame(tFrameInfo* pFrameInfo_p, tDllAsyncReqPriority
 
 tOplkError dllkcal_writeAsyncFrame(tFrameInfo* pFrameInfo_p, tDllCalQueue dllQueue);
 
+tOplkError dllkcal_getAsyncQueueCount(tDllCalQueue dllQueue_p, ULONG* pCount_p);
+
 tOplkError dllkcal_clearAsyncBuffer(void);
 
 tOplkError dllkcal_getStatistics(tDllkCalStatistics** ppStatistics);
@@ -102,9 +130,15 @@ tOplkError dllkcal_issueRequest(tDllReqServiceId service_p, UINT nodeId_p,
 tOplkError dllkcal_getSoaRequest(tDllReqServiceId* pReqServiceId_p,
                                  UINT* pNodeId_p, tSoaPayload* pSoaPayload_p) SECTION_DLLKCAL_GETSOAREQ;
 
+UINT       dllkcal_getSoaRequestCount(void);
+
 tOplkError dllkcal_setAsyncPendingRequests(UINT nodeId_p, tDllAsyncReqPriority asyncReqPrio_p,
                                            UINT count_p) SECTION_DLLKCAL_GETPENREQ;
 
+tOplkError dllkcal_setSoaQueueWeight(tDllkCalSoaQueue queue_p, UINT weight_p);
+
+tOplkError dllkcal_setNodeAsyncWeight(UINT nodeId_p, UINT weight_p);
+
 #endif
 
 
@@ -84,6 +84,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_EDRV_CYCLIC_USE_DIAGNOSTICS      FALSE
 #endif
 
+#ifndef CONFIG_EDRV_CYCLIC_USE_LEAD_TIME
+#define CONFIG_EDRV_CYCLIC_USE_LEAD_TIME        FALSE   // Arm the cyclic timers earlier to compensate their latency
+#endif
+
 #ifndef EDRV_CYCLIC_SAMPLE_NUM
 #define EDRV_CYCLIC_SAMPLE_NUM                  501
 #endif
@@ -92,6 +96,30 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EDRV_USE_TTTX                           FALSE
 #endif
 
+#ifndef EDRV_USE_TX_BATCH
+#define EDRV_USE_TX_BATCH                       FALSE   // Driver transmits a Tx buffer list with a single kick
+#endif
+
+#ifndef EDRV_USE_TX_BUFFER_LIST
+#define EDRV_USE_TX_BUFFER_LIST                 FALSE   // Driver implements edrv_sendTxBufferList() with a single doorbell write
+#endif
+
+#ifndef EDRV_USE_TX_TIME
+#define EDRV_USE_TX_TIME                        FALSE   // Driver transmits a Tx buffer at its launch time (target_getCurrentTimestamp() base)
+#endif
+
+#ifndef EDRV_USE_HIGHRES_TIMER
+#define EDRV_USE_HIGHRES_TIMER                  FALSE   // Driver provides high resolution timers and runs its worker thread in a realtime MMCSS task
+#endif
+
+#ifndef EDRV_USE_HW_TIMESTAMP
+#define EDRV_USE_HW_TIMESTAMP                   FALSE   // Driver stores the hardware time stamps of received and transmitted frames in their buffers
+#endif
+
+#ifndef CONFIG_EDRV_RX_POOL_BUFFERS
+#define CONFIG_EDRV_RX_POOL_BUFFERS             32      // Number of Rx pool buffers of drivers which copy the received frames
+#endif
+
 //------------------------------------------------------------------------------
 // Type definitions
 //------------------------------------------------------------------------------
@@ -115,6 +143,12 @@ typedef tEdrvReleaseRxBuffer (*tEdrvRxHandler)(tEdrvRxBuffer* pRxBuffer_p);
 /// Callback function pointer for Tx frames
 typedef void (*tEdrvTxHandler)(tEdrvTxBuffer* pTxBuffer_p);
 
+/// Callback function pointer for link changes (called in interrupt context)
+typedef void (*tEdrvLinkChangeHandler)(BOOL fLinkUp_p);
+
+/// Callback function pointer for Rx pool buffers whose last reference was released
+typedef void (*tEdrvRxPoolRecycleCb)(UINT index_p);
+
 /// Callback function pointer for Edrv cyclic sync
 typedef tOplkError (*tEdrvCyclicCbSync)(void);
 
@@ -164,6 +198,9 @@ struct sEdrvTxBuffer
     tEdrvTxBufferNumber txBufferNumber; ///< Edrv Tx buffer number
     UINT8*              pBuffer;        ///< Pointer to the Tx buffer
     UINT                maxBufferSize;  ///< Maximum size of the Tx buffer
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+    UINT64              txTimeStampNs;  ///< MAC time of the transmission [ns], valid in the Tx handler (0 = not available)
+#endif
 };
 
 /**
@@ -177,6 +214,9 @@ struct sEdrvRxBuffer
     UINT                rxFrameSize;    ///< Size of Rx frame (without CRC)
     UINT8*              pBuffer;        ///< Pointer to the Rx buffer
     tTimestamp*         pRxTimeStamp;   ///< Pointer to Rx time stamp
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+    UINT64              rxTimeStampNs;  ///< MAC time of the reception [ns] (0 = not available)
+#endif
 };
 
 /**
@@ -189,6 +229,8 @@ typedef struct
     UINT8           aMacAddr[6];    ///< The Ethernet controllers MAC address
     tEdrvRxHandler  pfnRxHandler;   ///< Rx frame callback function pointer
     tHwParam        hwParam;        ///< Hardware parameter
+    UINT            txBufferCount;  ///< Number of Tx buffers needed by the DLL (0 = driver default)
+    tEdrvLinkChangeHandler pfnLinkChangeHandler;    ///< Link change callback function pointer (NULL = not used, CONFIG_EDRV_FAST_LINK)
 } tEdrvInitParam;
 
 /**
@@ -233,6 +275,12 @@ typedef struct
     UINT32      aCycleTime[EDRV_CYCLIC_SAMPLE_NUM]; // until next SOC send
     UINT32      aUsedCycleTime[EDRV_CYCLIC_SAMPLE_NUM];
     UINT32      aSpareCycleTime[EDRV_CYCLIC_SAMPLE_NUM];
+#if (CONFIG_EDRV_CYCLIC_USE_LEAD_TIME != FALSE)
+    // lead time compensation
+    UINT32      leadTime;           // current lead time of the cyclic timers [ns]
+    UINT32      timerLatencyMax;    // maximum measured latency of the cyclic timers [ns]
+    ULONGLONG   lateFrameCount;     // number of frames which were sent after their launch time
+#endif
 } tEdrvCyclicDiagnostics;
 
 //------------------------------------------------------------------------------
@@ -250,9 +298,11 @@ tOplkError edrv_allocTxBuffer(tEdrvTxBuffer* pBuffer_p);
 tOplkError edrv_freeTxBuffer(tEdrvTxBuffer* pBuffer_p);
 tOplkError edrv_updateTxBuffer(tEdrvTxBuffer* pBuffer_p);
 tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p);
+tOplkError edrv_sendTxBufferList(tEdrvTxBuffer** ppBuffer_p, UINT count_p, UINT* pSentCount_p);
 tOplkError edrv_setTxBufferReady(tEdrvTxBuffer* pBuffer_p);
 tOplkError edrv_startTxBuffer(tEdrvTxBuffer* pBuffer_p);
 tOplkError edrv_releaseRxBuffer(tEdrvRxBuffer* pBuffer_p);
+tOplkError edrv_holdRxBuffer(tEdrvRxBuffer* pBuffer_p);
 tOplkError edrv_changeRxFilter(tEdrvFilter* pFilter_p, UINT count_p, UINT entryChanged_p, UINT changeFlags_p);
 int edrv_getDiagnostics(char* pBuffer_p, INT size_p);
 
@@ -267,10 +317,27 @@ tOplkError edrvcyclic_regSyncHandler(tEdrvCyclicCbSync pfnEdrvCyclicCbSync_p);
 tOplkError edrvcyclic_regErrorHandler(tEdrvCyclicCbError pfnEdrvCyclicCbError_p);
 tOplkError edrvcyclic_getDiagnostics(tEdrvCyclicDiagnostics** ppDiagnostics_p);
 
+tOplkError edrvrxpool_init(UINT8* pMemory_p, UINT bufferCount_p, UINT bufferSize_p,
+                           tEdrvRxPoolRecycleCb pfnRecycle_p);
+void       edrvrxpool_exit(void);
+tOplkError edrvrxpool_allocBuffer(UINT8** ppBuffer_p);
+tOplkError edrvrxpool_acquireBuffer(UINT index_p);
+tOplkError edrvrxpool_addRef(UINT8* pBuffer_p);
+tOplkError edrvrxpool_release(UINT8* pBuffer_p);
+
 #if EDRV_USE_TTTX == TRUE
 tOplkError edrv_getMacTime(UINT64* pCurtime_p);
 #endif
 
+#if (EDRV_USE_TX_BATCH != FALSE)
+tOplkError edrv_beginTxBatch(void);
+tOplkError edrv_endTxBatch(void);
+#endif
+
+#if (CONFIG_EDRV_RX_FILTER_BATCH != FALSE)
+tOplkError edrv_commitRxFilter(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
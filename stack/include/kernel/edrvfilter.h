@@ -0,0 +1,79 @@
+/**
+********************************************************************************
+\file   edrvfilter.h
+
+\brief  Definitions for the software Rx filter of the Ethernet driver
+
+This file contains the definitions for the software Rx filter. It is used by
+Ethernet drivers whose controller cannot filter POWERLINK frames itself.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_edrvfilter_H_
+#define _INC_edrvfilter_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <kernel/edrv.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#if (CONFIG_EDRV_SOFT_FILTER != FALSE)
+#define EDRVFILTER_CHANGE_RX_FILTER(pFilter_p, count_p) \
+    edrvfilter_compile(pFilter_p, count_p)
+#define EDRVFILTER_DROP_FRAME(pFrame_p, frameSize_p) \
+    edrvfilter_dropFrame(pFrame_p, frameSize_p)
+#else
+#define EDRVFILTER_CHANGE_RX_FILTER(pFilter_p, count_p)
+#define EDRVFILTER_DROP_FRAME(pFrame_p, frameSize_p)    FALSE
+#endif
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void         edrvfilter_compile(tEdrvFilter* pFilter_p, UINT count_p);
+tEdrvFilter* edrvfilter_match(const UINT8* pFrame_p, UINT frameSize_p);
+BOOL         edrvfilter_dropFrame(const UINT8* pFrame_p, UINT frameSize_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_edrvfilter_H_ */
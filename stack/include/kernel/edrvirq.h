@@ -0,0 +1,105 @@
+/**
+********************************************************************************
+\file   edrvirq.h
+
+\brief  Definitions for the interrupt placement of the Ethernet drivers
+
+This file contains the definitions for the interrupt and thread placement of
+the Linux kernel Ethernet drivers. The CPU affinity of the controller
+interrupts and the real-time priorities of the interrupt threads and the
+kernel threads of the stack can be set by module parameters and ioctl calls.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+#ifndef _INC_edrvirq_H_
+#define _INC_edrvirq_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <oplk/powerlink-module.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define EDRVIRQ_CAPTURE_THREAD(irq_p)   edrvirq_captureThread(irq_p)
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Interrupt classes
+
+The enumeration lists the classes of controller interrupts. The class selects
+the CPU affinity of the interrupt.
+*/
+typedef enum
+{
+    kEdrvIrqClassIsoc = 0,      ///< Interrupt carrying the isochronous Rx path
+    kEdrvIrqClassAsync          ///< Interrupt of the asynchronous queue only
+} tEdrvIrqClass;
+
+/**
+\brief  Kernel threads of the stack
+
+The enumeration lists the kernel threads of the stack whose real-time priority
+can be configured.
+*/
+typedef enum
+{
+    kEdrvIrqThreadEventk = 0,   ///< Kernel event thread
+    kEdrvIrqThreadPoll,         ///< Poll thread of the Ethernet driver poll mode
+    kEdrvIrqThreadCount         ///< Number of threads
+} tEdrvIrqThread;
+
+struct task_struct;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ULONG      edrvirq_getRequestFlags(tEdrvIrqClass irqClass_p);
+tOplkError edrvirq_addIrq(UINT irq_p, tEdrvIrqClass irqClass_p, ULONG flags_p);
+void       edrvirq_removeIrq(UINT irq_p);
+void       edrvirq_captureThread(UINT irq_p);
+void       edrvirq_addThread(tEdrvIrqThread thread_p, struct task_struct* pTask_p);
+void       edrvirq_removeThread(tEdrvIrqThread thread_p);
+tOplkError edrvirq_setConfig(const tIrqConfig* pConfig_p);
+void       edrvirq_getConfig(tIrqConfig* pConfig_p);
+INT        edrvirq_getDiagnostics(char* pBuffer_p, INT size_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_edrvirq_H_ */
@@ -0,0 +1,118 @@
+/**
+********************************************************************************
+\file   edrvmirror.h
+
+\brief  Definitions for the Ethernet driver mirror ring
+
+This file contains the definitions for the mirror ring of the Ethernet driver.
+The ring contains copies of the frames received and transmitted by the
+Ethernet driver. It is located in shared memory and read by
+tools/linux/edrvmirror2pcapng.pl.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+#ifndef _INC_edrvmirror_H_
+#define _INC_edrvmirror_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define EDRVMIRROR_SHM_NAME             "/shmEdrvMirror"    ///< Name of the shared memory (/dev/shm/shmEdrvMirror)
+#define EDRVMIRROR_MAGIC                "OPLKMIRR"          ///< Magic at the start of the shared memory
+#define EDRVMIRROR_VERSION              1                   ///< Version of the shared memory layout
+#define EDRVMIRROR_SLOT_DATA_SIZE       1536                ///< Maximum number of bytes recorded of a frame
+
+#define EDRVMIRROR_FLAG_TX              0x00000001          ///< Frame was transmitted by the node
+
+#if (CONFIG_EDRV_MIRROR != FALSE)
+#define EDRVMIRROR_RECORD_FRAME(pFrame_p, size_p, timeStamp_p, flags_p) \
+    edrvmirror_recordFrame(pFrame_p, size_p, timeStamp_p, flags_p)
+#else
+#define EDRVMIRROR_RECORD_FRAME(pFrame_p, size_p, timeStamp_p, flags_p)
+#endif
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Mirror ring header
+
+The structure describes the header of the mirror ring. It is followed by
+slotCount slots of slotSize bytes. All members are in the byte order of the
+host.
+*/
+typedef struct
+{
+    char                aMagic[8];          ///< EDRVMIRROR_MAGIC
+    UINT32              version;            ///< EDRVMIRROR_VERSION
+    UINT32              slotCount;          ///< Number of slots
+    UINT32              slotSize;           ///< Size of a slot including its header
+    UINT32              reserved;           ///< Reserved
+    UINT64              writeCount;         ///< Number of frames written to the ring
+} tEdrvMirrorHeader;
+
+/**
+\brief  Mirror ring slot header
+
+The structure describes the header of a slot of the mirror ring. The frame
+data follows the header. The writer sets \ref sequence to 0 before it updates
+the slot and to the number of the frame plus one afterwards, so a reader
+detects slots which are overwritten while it copies them.
+*/
+typedef struct
+{
+    UINT32              sequence;           ///< Number of the frame in the slot plus one (lower 32 bit)
+    UINT32              frameSize;          ///< Size of the frame in bytes
+    UINT32              capturedSize;       ///< Number of recorded bytes of the frame
+    UINT32              flags;              ///< EDRVMIRROR_FLAG_xxx
+    UINT64              timeStamp;          ///< Time of the frame in ns (CLOCK_REALTIME)
+} tEdrvMirrorSlot;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+tOplkError edrvmirror_init(void);
+void       edrvmirror_exit(void);
+void       edrvmirror_recordFrame(const void* pFrame_p, UINT frameSize_p,
+                                  UINT64 timeStamp_p, UINT32 flags_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_edrvmirror_H_ */
@@ -0,0 +1,90 @@
+/**
+********************************************************************************
+\file   edrvpoll.h
+
+\brief  Definitions for the Ethernet driver poll mode
+
+This file contains the definitions for the poll mode of the Linux kernel
+Ethernet drivers. In poll mode a kernel thread busy-polls the Ethernet
+controller during the isochronous phase of the POWERLINK cycle instead of
+taking an interrupt for every frame.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+#ifndef _INC_edrvpoll_H_
+#define _INC_edrvpoll_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#if (CONFIG_EDRV_POLL_MODE != FALSE)
+#define EDRVPOLL_WATCH_FRAME(pFrame_p)  edrvpoll_watchFrame(pFrame_p)
+#define EDRVPOLL_COUNT_IRQ()            edrvpoll_countIrq()
+#else
+#define EDRVPOLL_WATCH_FRAME(pFrame_p)
+#define EDRVPOLL_COUNT_IRQ()
+#endif
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Poll callback function
+
+The function processes the pending Rx and Tx events of the Ethernet
+controller like its interrupt handler. It is called by the poll thread with
+local interrupts disabled.
+
+\return The function returns TRUE if an event was pending.
+*/
+typedef BOOL (*tEdrvPollCb)(void);
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+tOplkError edrvpoll_init(UINT irq_p, tEdrvPollCb pfnPoll_p);
+void       edrvpoll_exit(void);
+void       edrvpoll_watchFrame(const void* pFrame_p);
+void       edrvpoll_countIrq(void);
+INT        edrvpoll_getDiagnostics(char* pBuffer_p, INT size_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_edrvpoll_H_ */
@@ -0,0 +1,103 @@
+/**
+********************************************************************************
+\file   edrvreplay.h
+
+\brief  Definitions for the replay Ethernet driver
+
+This file contains the definitions for the configuration and the statistics
+of the replay Ethernet driver (edrv-replay_linux.c). The driver feeds the
+frames of a pcap or pcapng capture into the stack instead of receiving them
+from a network.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+#ifndef _INC_edrvreplay_H_
+#define _INC_edrvreplay_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Configuration of the replay
+
+The structure contains the configuration of the replay. The capture file is
+the device name which is passed to the stack. The defaults are taken from the
+CONFIG_EDRV_REPLAY_xxx options.
+*/
+typedef struct
+{
+    UINT                speedPercent;       ///< Replay speed relative to the capture (100 = original timing, 0 = as fast as possible)
+    UINT32              startDelayMs;       ///< Delay between the driver initialization and the first frame [ms]
+    UINT                localNodeId;        ///< POWERLINK frames of this node are not injected (0 = inject all frames)
+    const char*         pReportFileName;    ///< CSV file for frame costs and NMT state changes (NULL = no report)
+} tEdrvReplayConfig;
+
+/**
+\brief  Statistics of the replay
+
+The structure contains the counters of the replay. The processing cost of a
+frame is the time the Rx handler of the stack needs for it.
+*/
+typedef struct
+{
+    UINT64              readFrameCount;     ///< Number of frames read from the capture
+    UINT64              injectedFrameCount; ///< Number of frames passed to the stack
+    UINT64              skippedFrameCount;  ///< Number of frames which are not injected (direction, node ID, size, link type)
+    UINT64              txFrameCount;       ///< Number of frames transmitted by the stack
+    UINT64              totalCostNs;        ///< Sum of the processing costs of the injected frames [ns]
+    UINT64              maxCostNs;          ///< Maximum processing cost of an injected frame [ns]
+    UINT64              stateChangeCount;   ///< Number of NMT state changes of the stack during the replay
+    BOOL                fFinished;          ///< The end of the capture was reached
+} tEdrvReplayStatistics;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void       edrvreplay_getConfig(tEdrvReplayConfig* pConfig_p);
+tOplkError edrvreplay_setConfig(const tEdrvReplayConfig* pConfig_p);
+void       edrvreplay_getStatistics(tEdrvReplayStatistics* pStatistics_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_edrvreplay_H_ */
@@ -0,0 +1,106 @@
+/**
+********************************************************************************
+\file   edrvsim.h
+
+\brief  Definitions for the simulated Ethernet driver
+
+This file contains the definitions for the configuration and the statistics
+of the simulated Ethernet driver (edrv-sim_linux.c). The driver emulates a
+network of CNs inside the process of the MN.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/#ifndef _INC_edrvsim_H_
+#define _INC_edrvsim_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define EDRVSIM_MAX_CN                  239                 ///< Maximum number of simulated CNs (node IDs 1 - 239)
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Configuration of the simulated network
+
+The structure contains the configuration of the simulated CNs. The defaults
+are taken from the CONFIG_EDRV_SIM_xxx options. The latencies are measured
+from the end of the request on the wire to the start of the response.
+*/
+typedef struct
+{
+    UINT                cnCount;            ///< Number of simulated CNs, they use the node IDs 1 to cnCount
+    UINT32              presLatencyNs;      ///< Latency of the PRes after the PReq [ns]
+    UINT32              asndLatencyNs;      ///< Latency of an ASnd frame after the SoA [ns]
+    UINT32              sdoDelayUs;         ///< Processing time of an SDO command until the response is pending [us]
+    UINT                presLossPerMille;   ///< Probability that a PRes is lost [1/1000]
+    UINT                sdoLossPerMille;    ///< Probability that an SDO response is lost [1/1000]
+    UINT32              seed;               ///< Seed of the loss generator (equal seeds give equal loss patterns)
+    UINT                presPayloadSize;    ///< Payload size of the PRes (0 = echo the PReq payload)
+    UINT32              deviceType;         ///< Device type reported in the IdentResponse and object 0x1000
+    UINT32              vendorId;           ///< Vendor ID reported in the IdentResponse and object 0x1018/1
+    UINT32              productCode;        ///< Product code reported in the IdentResponse and object 0x1018/2
+    UINT32              revisionNumber;     ///< Revision number reported in the IdentResponse and object 0x1018/3
+} tEdrvSimConfig;
+
+/**
+\brief  Statistics of the simulated network
+
+The structure contains the frame counters of the simulated network.
+*/
+typedef struct
+{
+    UINT64              txFrameCount;       ///< Number of frames transmitted by the MN
+    UINT64              rxFrameCount;       ///< Number of frames transmitted by the simulated CNs
+    UINT64              presLossCount;      ///< Number of dropped PRes frames
+    UINT64              sdoLossCount;       ///< Number of dropped SDO responses
+    UINT64              overrunCount;       ///< Number of frames dropped because the event queue was full
+} tEdrvSimStatistics;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void       edrvsim_getConfig(tEdrvSimConfig* pConfig_p);
+tOplkError edrvsim_setConfig(const tEdrvSimConfig* pConfig_p);
+void       edrvsim_getStatistics(tEdrvSimStatistics* pStatistics_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_edrvsim_H_ */
@@ -57,6 +57,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // typedef
 //------------------------------------------------------------------------------
 
+// forward declarations of the Linux kernel types used in eventkcal-linuxkernel.c
+struct file;
+struct poll_table_struct;
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
@@ -72,9 +76,13 @@ tOplkError eventkcal_postKernelEvent(tEvent* pEvent_p) SECTION_EVENTKCAL_POST;
 tOplkError eventkcal_rxHandler(tEvent* pEvent_p);
 void       eventkcal_process(void);
 
+/* functions used in eventkcal-linux.c and eventkcal-nooshostif.c */
+void       eventkcal_getBatchStatistics(tEventBatchStatistics* pStatistics_p);
+
 /* functions used in eventkcal-linuxkernel.c */
-int        eventkcal_postEventFromUser (unsigned long arg);
-int        eventkcal_getEventForUser(unsigned long arg);
+BYTE*        eventkcal_getQueueMem(tEventQueue eventQueue_p, size_t* pSize_p);
+int          eventkcal_signalEventFromUser(void);
+unsigned int eventkcal_pollEventForUser(struct file* pFile_p, struct poll_table_struct* pWait_p);
 
 #ifdef __cplusplus
 }
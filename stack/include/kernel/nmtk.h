@@ -65,6 +65,7 @@ extern "C" {
 tOplkError nmtk_init(void);
 tOplkError nmtk_delInstance(void);
 tOplkError nmtk_process(tEvent* pEvent_p);
+tNmtState  nmtk_getNmtState(void);
 
 #ifdef __cplusplus
 }
@@ -71,6 +71,9 @@ tOplkError pdok_allocChannelMem(tPdoAllocationParam* pAllocationParam_p);
 tOplkError pdok_configureChannel(tPdoChannelConf* pChannelConf_p);
 tOplkError pdok_setupPdoBuffers(size_t rxPdoMemSize_p, size_t txPdoMemSize_p);
 tOplkError pdok_sendSyncEvent(void);
+tOplkError pdok_addRoute(const tPdoRoute* pRoute_p);
+void       pdok_clearRoutes(void);
+tOplkError pdok_setupKernelPi(const tPdoKernelPiSetup* pSetup_p);
 
 #ifdef __cplusplus
 }
@@ -43,6 +43,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/oplkinc.h>
 #include <oplk/event.h>
 #include <common/pdo.h>
+#include <oplk/frame.h>
 
 //------------------------------------------------------------------------------
 // const defines
@@ -52,6 +53,19 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // typedef
 //------------------------------------------------------------------------------
 
+/**
+\brief Memory type of the PDO buffers
+
+The enumeration lists the memory types of the PDO buffers which are mapped to
+the user layer by the Linux kernel driver.
+*/
+typedef enum
+{
+    kPdoMemCached = 0,                  ///< Cached (write-back) memory
+    kPdoMemWriteCombine,                ///< Write-combining memory
+    kPdoMemUncached                     ///< Uncached memory
+} tPdoMemCacheMode;
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
@@ -75,16 +89,46 @@ tOplkError pdokcal_initPdoMem(tPdoChannelSetup* pPdoChannels, size_t rxPdoMemSiz
 void       pdokcal_cleanupPdoMem(void);
 BYTE*      pdokcal_getPdoMemRegion(void);
 tOplkError pdokcal_writeRxPdo(UINT channelId_p, BYTE* pPayload_p, UINT16 pdoSize_p) SECTION_PDOKCAL_WRITE_RPDO;
+BYTE*      pdokcal_getRxPdoWriteBuffer(UINT channelId_p) SECTION_PDOKCAL_WRITE_RPDO;
+void       pdokcal_commitRxPdo(UINT channelId_p) SECTION_PDOKCAL_WRITE_RPDO;
 tOplkError pdokcal_readTxPdo(UINT channelId_p, BYTE* pPayload_p, UINT16 pdoSize_p) SECTION_PDOKCAL_READ_TPDO;
+BOOL       pdokcal_isTxPdoNew(UINT channelId_p) SECTION_PDOKCAL_READ_TPDO;
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+tPlkFrame* pdokcal_getTxPdoFrame(UINT channelId_p, tPlkFrame* pFrame_p) SECTION_PDOKCAL_READ_TPDO;
+#endif
+void       pdokcal_discardTxPdo(UINT channelId_p);
+void       pdokcal_writeSocTime(const tSocTimeInfo* pSocTimeInfo_p);
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+tOplkError pdokcal_readKernelPiCopy(tPdoKernelPiCopy* paCopy_p, UINT copyCount_p);
+void       pdokcal_writeKernelPiOut(const BYTE* pImage_p, UINT size_p);
+const BYTE* pdokcal_getKernelPiIn(void);
+#endif
 BYTE*      pdokcal_getPdoPointer(BOOL fTxPdo_p, UINT offset_p, UINT16 pdoSize_p);
 
 // PDO sync functions
 tOplkError pdokcal_initSync(void);
 void       pdokcal_exitSync(void);
 tOplkError pdokcal_controlSync(BOOL fEnable_p);
-tOplkError pdokcal_waitSyncEvent(void);
 tOplkError pdokcal_sendSyncEvent(void);
 
+/* functions used in pdokcalsync-linuxkernel.c */
+int        pdokcal_setSyncEventFd(int eventFd_p);
+BYTE*      pdokcal_getSyncInfoMem(void);
+
+/* functions used in pdokcalmem-linuxkernel.c */
+tOplkError pdokcal_setMemCacheMode(tPdoMemCacheMode mode_p, size_t* pCachedSize_p);
+
+/* functions used in pdokcalrx-linux.c */
+tOplkError pdokcal_initRxWorker(void);
+void       pdokcal_exitRxWorker(void);
+tOplkError pdokcal_postRxPdo(tPlkFrame* pFrame_p, UINT frameSize_p);
+
+/* functions used in pdokcalrxdma-openmac.c */
+tOplkError pdokcal_initRxDma(void);
+void       pdokcal_exitRxDma(void);
+tOplkError pdokcal_copyRxPdoDma(UINT channelId_p, tPlkFrame* pFrame_p, UINT frameSize_p,
+                                UINT16 pdoSize_p) SECTION_PDOKCAL_WRITE_RPDO;
+
 #ifdef __cplusplus
 }
 #endif
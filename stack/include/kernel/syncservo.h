@@ -0,0 +1,92 @@
+/**
+********************************************************************************
+\file   kernel/syncservo.h
+
+\brief  Definitions for the sync servo module
+
+The sync servo is a PI controller which locks the sync timer of a CN to the
+SoC frames of the MN. It is used by the sync timer implementations.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+
+#ifndef _INC_kernel_syncservo_H_
+#define _INC_kernel_syncservo_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <oplk/syncservo.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Sync servo instance
+
+The structure contains the state of a sync servo. All times are in ticks of
+the sync timer.
+*/
+typedef struct
+{
+    UINT32              nominalPeriod;          ///< Configured cycle length
+    UINT32              period;                 ///< Estimated cycle length
+    INT64               periodFraction;         ///< Estimated cycle length with fractional bits
+    UINT32              outlierLimit;           ///< Outlier limit (0 = no outlier rejection)
+    UINT                outlierSequence;        ///< Number of consecutive outliers
+    UINT64              absErrorFraction;       ///< Moving average of the absolute error with fractional bits
+    tSyncServoStatistics statistics;            ///< Statistics in ticks
+} tSyncServo;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void   syncservo_init(tSyncServo* pServo_p, UINT32 period_p, UINT32 outlierLimit_p);
+void   syncservo_restart(tSyncServo* pServo_p);
+INT32  syncservo_update(tSyncServo* pServo_p, INT32 error_p);
+void   syncservo_reject(tSyncServo* pServo_p);
+void   syncservo_getStatistics(const tSyncServo* pServo_p, UINT32 tickNs_p,
+                               tSyncServoStatistics* pStatistics_p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_kernel_syncservo_H_ */
@@ -44,6 +44,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <oplk/oplkinc.h>
+#include <oplk/syncservo.h>
 
 //------------------------------------------------------------------------------
 // const defines
@@ -76,6 +77,7 @@ tOplkError synctimer_syncTriggerAtTimeStamp(tTimestamp* pTimeStamp_p);
 tOplkError synctimer_stopSync(void);
 void       synctimer_enableExtSyncIrq(UINT32 syncIntCycle_p, UINT32 pulseWidth_p);
 void       synctimer_disableExtSyncIrq(void);
+tOplkError synctimer_getStatistics(tSyncServoStatistics* pStatistics_p);
 
 #ifdef __cplusplus
 }
@@ -52,6 +52,24 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // typedef
 //------------------------------------------------------------------------------
 
+/**
+\brief  Virtual Ethernet statistics
+
+The structure contains the frame counters of the virtual Ethernet interface.
+TX counts frames from the virtual interface to POWERLINK, RX counts frames from
+POWERLINK to the virtual interface.
+*/
+typedef struct
+{
+    UINT32              txFrames;               ///< Frames passed to the DLL
+    UINT32              txBytes;                ///< Bytes passed to the DLL
+    UINT32              txRetries;              ///< Send attempts deferred because the async TX queue was full
+    UINT32              txDropped;              ///< Frames dropped because the async TX queue stayed full
+    UINT32              rxFrames;               ///< Frames passed to the virtual interface
+    UINT32              rxBytes;                ///< Bytes passed to the virtual interface
+    UINT32              rxDropped;              ///< Frames which could not be passed to the virtual interface
+} tVethStatistics;
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
@@ -62,6 +80,7 @@ extern "C" {
 
 tOplkError veth_addInstance(const UINT8 aSrcMac_p[6]);
 tOplkError veth_delInstance(void);
+tOplkError veth_getStatistics(tVethStatistics* pStatistics_p);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,132 @@
+/**
+********************************************************************************
+\file   oplk/bintrace.h
+
+\brief  Definitions for the binary trace module
+
+This file contains the definitions for the binary trace module. Trace points
+record fixed-size binary records into per-thread lock-free rings instead of
+formatting strings in the real-time path. The rings are written to a file
+with bintrace_writeFile() and converted offline by tools/bintrace2json.pl.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+#ifndef _INC_oplk_bintrace_H_
+#define _INC_oplk_bintrace_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define BINTRACE_FILE_MAGIC             "OPLKBTRC"      ///< Magic at the start of a trace file
+#define BINTRACE_FILE_VERSION           1               ///< Version of the trace file format
+#define BINTRACE_ARG_COUNT              4               ///< Maximum number of arguments of a trace record
+
+#if (CONFIG_BINTRACE != FALSE)
+#define BINTRACE0(id_p)                         bintrace_record(id_p, 0, 0, 0, 0)
+#define BINTRACE1(id_p, a0_p)                   bintrace_record(id_p, (UINT32)(a0_p), 0, 0, 0)
+#define BINTRACE2(id_p, a0_p, a1_p)             bintrace_record(id_p, (UINT32)(a0_p), (UINT32)(a1_p), 0, 0)
+#define BINTRACE4(id_p, a0_p, a1_p, a2_p, a3_p) bintrace_record(id_p, (UINT32)(a0_p), (UINT32)(a1_p), \
+                                                                (UINT32)(a2_p), (UINT32)(a3_p))
+#else
+#define BINTRACE0(id_p)
+#define BINTRACE1(id_p, a0_p)
+#define BINTRACE2(id_p, a0_p, a1_p)
+#define BINTRACE4(id_p, a0_p, a1_p, a2_p, a3_p)
+#endif
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Trace IDs
+
+The enumeration lists the trace IDs of the stack. The values are part of the
+trace file format and must not be changed. IDs ending with Begin and End are
+shown as durations by the decoder, all other IDs as instant events.
+Applications may use IDs starting at kBinTraceIdUser.
+*/
+typedef enum
+{
+    kBinTraceIdInvalid              = 0x0000,   ///< Invalid trace ID
+    kBinTraceIdDllkSocTx            = 0x0001,   ///< SoC transmitted (MN) - no arguments
+    kBinTraceIdDllkSocRx            = 0x0002,   ///< SoC received (CN) - no arguments
+    kBinTraceIdDllkPreqTx           = 0x0003,   ///< PReq transmitted - arg0: node ID
+    kBinTraceIdDllkPresRx           = 0x0004,   ///< PRes received - arg0: node ID, arg1: NMT state
+    kBinTraceIdEventkProcessBegin   = 0x0010,   ///< Kernel event processing started - arg0: sink, arg1: type
+    kBinTraceIdEventkProcessEnd     = 0x0011,   ///< Kernel event processing finished - arg0: sink, arg1: error
+    kBinTraceIdEventuProcessBegin   = 0x0012,   ///< User event processing started - arg0: sink, arg1: type
+    kBinTraceIdEventuProcessEnd     = 0x0013,   ///< User event processing finished - arg0: sink, arg1: error
+    kBinTraceIdEventkError          = 0x0014,   ///< Kernel error event posted - arg0: source, arg1: error
+    kBinTraceIdEventuError          = 0x0015,   ///< User error event posted - arg0: source, arg1: error
+    kBinTraceIdNmtkStateChange      = 0x0020,   ///< NMT state change - arg0: old state, arg1: new state, arg2: event
+    kBinTraceIdUser                 = 0x8000,   ///< First trace ID available for applications
+} eBinTraceId;
+
+/// Data type for the enumerator \ref eBinTraceId.
+typedef UINT16 tBinTraceId;
+
+/**
+\brief  Trace record
+
+The structure describes a trace record. All records have the same size, so
+recording a trace point does not need any formatting or length handling.
+*/
+typedef struct
+{
+    ULONGLONG           timeStamp;                      ///< Timestamp in ns (target_getCurrentTimestamp())
+    UINT16              traceId;                        ///< Trace ID (\ref eBinTraceId)
+    UINT16              reserved;                       ///< Reserved, 0
+    UINT32              aArg[BINTRACE_ARG_COUNT];       ///< Arguments of the trace point
+    UINT32              padding;                        ///< Pads the record to 32 bytes
+} tBinTraceRecord;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (CONFIG_BINTRACE != FALSE)
+
+void       bintrace_record(tBinTraceId traceId_p, UINT32 arg0_p, UINT32 arg1_p,
+                           UINT32 arg2_p, UINT32 arg3_p);
+tOplkError bintrace_writeFile(const char* pFileName_p);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_oplk_bintrace_H_ */
@@ -0,0 +1,185 @@
+/**
+********************************************************************************
+\file   oplk/cyclestat.h
+
+\brief  Definitions for the cycle statistics
+
+This file contains the definitions of the cycle statistics which can be read
+by the application with oplk_getCycleStatistics().
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_oplk_cyclestat_H_
+#define _INC_oplk_cyclestat_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+// The histogram buckets are linear below CYCLESTAT_SUB_BUCKET_COUNT ns and
+// logarithmic above, each power of two being split into
+// CYCLESTAT_SUB_BUCKET_COUNT linear buckets. Therefore the relative error of a
+// bucket is below 1 / CYCLESTAT_SUB_BUCKET_COUNT over the whole range.
+#define CYCLESTAT_SUB_BUCKET_BITS       3
+#define CYCLESTAT_SUB_BUCKET_COUNT      (1 << CYCLESTAT_SUB_BUCKET_BITS)
+#define CYCLESTAT_BUCKET_COUNT          ((32 - CYCLESTAT_SUB_BUCKET_BITS + 1) * CYCLESTAT_SUB_BUCKET_COUNT)
+
+/// Lower limit in nanoseconds of the histogram bucket with the specified index
+#define CYCLESTAT_BUCKET_LOWER_LIMIT(index_p) \
+    (((index_p) < CYCLESTAT_SUB_BUCKET_COUNT) ? (UINT32)(index_p) : \
+     ((UINT32)(CYCLESTAT_SUB_BUCKET_COUNT + ((index_p) % CYCLESTAT_SUB_BUCKET_COUNT)) << \
+      (((index_p) / CYCLESTAT_SUB_BUCKET_COUNT) - 1)))
+
+/// Maximum number of nodes whose PReq and PRes timings are recorded
+#define CYCLESTAT_NODE_COUNT            16
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Cycle stages
+
+The enumeration lists the stages of a POWERLINK cycle which are measured by the
+cycle statistics. Except for \ref kCycleStatStageCycleStart and
+\ref kCycleStatStageSocWire, the time of a stage is measured relative to the
+start of the cycle, i.e. the transmission of the SoC on an MN or the reception
+of the SoC on a CN. \ref kCycleStatStageSocWire is only recorded if the
+Ethernet driver provides hardware time stamps (EDRV_USE_HW_TIMESTAMP).
+*/
+typedef enum
+{
+    kCycleStatStageCycleStart   = 0,    ///< Time between the starts of two consecutive cycles
+    kCycleStatStagePresRx       = 1,    ///< Reception of a PRes frame
+    kCycleStatStageRxPdo        = 2,    ///< Processing of a received PDO in the kernel layer
+    kCycleStatStageSyncEvent    = 3,    ///< Signaling of the sync event to the user layer
+    kCycleStatStageAppSync      = 4,    ///< Return of oplk_waitSyncEvent() to the application
+    kCycleStatStageRxPi         = 5,    ///< Copying of the RPDOs to the process image finished
+    kCycleStatStageTxPi         = 6,    ///< Copying of the TPDOs from the process image finished
+    kCycleStatStageSocWire      = 7,    ///< Time between the hardware time stamps of two consecutive SoC frames
+    kCycleStatStageCount        = 8,    ///< Number of cycle stages
+} tCycleStatStage;
+
+/**
+\brief  Histogram of a cycle stage
+
+The structure contains the latency histogram of a single cycle stage. All
+times are in nanoseconds. The histogram covers all samples since the start of
+the stack, whereas the percentiles are determined from a rolling window of the
+most recent samples (see CONFIG_CYCLE_STATISTICS_WINDOW_SIZE). A percentile is
+the upper limit of the histogram bucket which contains it.
+*/
+typedef struct
+{
+    UINT32              sampleCount;                        ///< Number of samples
+    UINT32              minTime;                            ///< Minimum time
+    UINT32              maxTime;                            ///< Maximum time
+    UINT64              totalTime;                          ///< Sum of all times
+    UINT32              aBucket[CYCLESTAT_BUCKET_COUNT];    ///< Number of samples per bucket
+    UINT32              windowSampleCount;                  ///< Number of samples in the rolling window
+    UINT32              p50Time;                            ///< Median of the rolling window
+    UINT32              p99Time;                            ///< 99th percentile of the rolling window
+    UINT32              p999Time;                           ///< 99.9th percentile of the rolling window
+} tCycleStatHistogram;
+
+/**
+\brief  Node timings
+
+The structure contains the latency histograms of the isochronous slot of a
+single node. They are only recorded on an MN. \ref socToPreq is the time from
+the transmission of the SoC to the transmission of the PReq to the node,
+\ref preqToPres is the time from the transmission of the PReq to the
+reception of the PRes of the node. PRes frames which are not requested by a
+PReq in the same cycle (e.g. PRes Chaining) are not recorded.
+\ref preqToPresWire is the same time determined from the hardware time stamps
+of both frames, i.e. without the interrupt and processing latencies of the
+MN. It is only recorded if the Ethernet driver provides hardware time stamps.
+*/
+typedef struct
+{
+    UINT                nodeId;                             ///< Node ID (0 if the entry is unused)
+    tCycleStatHistogram socToPreq;                          ///< Time from SoC to PReq transmission
+    tCycleStatHistogram preqToPres;                         ///< Time from PReq transmission to PRes reception
+    tCycleStatHistogram preqToPresWire;                     ///< Wire time from PReq transmission to PRes reception
+} tCycleStatNode;
+
+/**
+\brief  Cycle statistics
+
+The structure contains the latency histograms of all cycle stages and the
+timings of the nodes. The entries of the nodes are assigned in the order of
+their first PReq.
+*/
+typedef struct
+{
+    tCycleStatHistogram aStage[kCycleStatStageCount];       ///< Histograms of the cycle stages
+    tCycleStatNode      aNode[CYCLESTAT_NODE_COUNT];        ///< Timings of the nodes
+} tCycleStatistics;
+
+/**
+\brief  Sync budget statistics
+
+The structure contains the settings and the statistics of the sync budget of
+the application. The sync processing of the application starts with the
+delivery of the sync event (return of oplk_waitSyncEvent() or call of the sync
+callback) and ends with the copy of the TPDOs by oplk_exchangeProcessImageIn().
+Both times are measured in nanoseconds relative to the start of the cycle. If
+the TPDOs are copied later than the budget or in a later cycle, the cycle is
+counted as an overrun.
+*/
+typedef struct
+{
+    UINT32              budget;                             ///< Budget of the sync processing in ns (0 = disabled)
+    BOOL                fSkipLateTxPdo;                     ///< Late TPDOs are skipped, the previous TPDOs are sent instead
+    UINT32              cycleCount;                         ///< Number of checked cycles
+    UINT32              overrunCount;                       ///< Number of cycles which exceeded the budget
+    UINT32              skippedTxPdoCount;                  ///< Number of skipped TPDO copies
+    UINT32              lastStartTime;                      ///< Start of the last sync processing
+    UINT32              lastEndTime;                        ///< End of the last sync processing
+    UINT32              maxEndTime;                         ///< Latest end of the sync processing within its cycle
+} tCycleStatSyncBudget;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_oplk_cyclestat_H_ */
@@ -142,7 +142,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #if (DEBUG_GLB_LVL & DEBUG_LVL_EVENTU)
 #define DEBUG_LVL_EVENTU_TRACE(...)                TRACE(__VA_ARGS__)
 #else
-#define DEBUG_LVL_EVENUT_TRACE(...)
+#define DEBUG_LVL_EVENTU_TRACE(...)
 #endif
 
 #if (DEBUG_GLB_LVL & DEBUG_LVL_EVENTK)
@@ -65,6 +65,46 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_EVENT_SIZE_CIRCBUF_USER_INTERNAL         32768               // Default size for user-internal event queue
 #endif
 
+#ifndef CONFIG_EVENT_SIZE_CIRCBUF_USER_INTERNAL_LOW
+#define CONFIG_EVENT_SIZE_CIRCBUF_USER_INTERNAL_LOW     16384               // Default size for user-internal low-priority event queue (0 = disabled)
+#endif
+
+#ifndef CONFIG_EVENTU_LOW_PRIORITY_THREAD
+#define CONFIG_EVENTU_LOW_PRIORITY_THREAD               FALSE               // Process the user-internal low-priority events (SDO, API) in a separate thread (Linux)
+#endif
+
+#ifndef CONFIG_EVENTU_CYCLE_SLICE
+#define CONFIG_EVENTU_CYCLE_SLICE                       FALSE               // Process the low-priority events only after the input process image was exchanged (Linux userspace only, requires CONFIG_EVENTU_LOW_PRIORITY_THREAD)
+#endif
+
+#ifndef CONFIG_EVENTU_CYCLE_SLICE_BUDGET_US
+#define CONFIG_EVENTU_CYCLE_SLICE_BUDGET_US             200                 // Time in us per cycle for processing low-priority events
+#endif
+
+#ifndef CONFIG_EVENTU_CYCLE_SLICE_IDLE_MS
+#define CONFIG_EVENTU_CYCLE_SLICE_IDLE_MS               10                  // A slice is started anyway if no process image was exchanged for this time
+#endif
+
+#ifndef CONFIG_EVENT_SIZE_PRODUCER_RING
+#define CONFIG_EVENT_SIZE_PRODUCER_RING                 8192                // Size of the per-CPU producer rings of the Linux kernel event CAL (power of 2)
+#endif
+
+#ifndef CONFIG_EVENT_PAYLOAD_POOL_SLOTS
+#define CONFIG_EVENT_PAYLOAD_POOL_SLOTS                 0                   // Number of payload slots for large arguments of internal events (0 = disabled)
+#endif
+
+#ifndef CONFIG_EVENT_PAYLOAD_THRESHOLD
+#define CONFIG_EVENT_PAYLOAD_THRESHOLD                  256                 // Internal event arguments larger than this are stored in the payload pool
+#endif
+
+#ifndef CONFIG_EVENT_BATCH_MAX_EVENTS
+#define CONFIG_EVENT_BATCH_MAX_EVENTS                   32                  // Maximum number of events processed per event thread wakeup (0 = unlimited)
+#endif
+
+#ifndef CONFIG_EVENT_BATCH_TIME_BUDGET_US
+#define CONFIG_EVENT_BATCH_TIME_BUDGET_US               1000                // Maximum time in us spent per event thread wakeup (0 = unlimited)
+#endif
+
 #ifndef CONFIG_DLLCAL_SIZE_CIRCBUF_CN_REQ_NMT
 #define CONFIG_DLLCAL_SIZE_CIRCBUF_CN_REQ_NMT           2048                // Default size for NMT request queue
 #endif
@@ -81,6 +121,34 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_DLLCAL_SIZE_CIRCBUF_REQ_STATUS           2048                // Default size for status request queue
 #endif
 
+#ifndef CONFIG_DLLCAL_SOA_WEIGHT_CN_GEN
+#define CONFIG_DLLCAL_SOA_WEIGHT_CN_GEN                 4                   // Consecutive async slots for CN generic requests per scheduler round
+#endif
+
+#ifndef CONFIG_DLLCAL_SOA_WEIGHT_CN_NMT
+#define CONFIG_DLLCAL_SOA_WEIGHT_CN_NMT                 4                   // Consecutive async slots for CN NMT requests per scheduler round
+#endif
+
+#ifndef CONFIG_DLLCAL_SOA_WEIGHT_MN_GEN_NMT
+#define CONFIG_DLLCAL_SOA_WEIGHT_MN_GEN_NMT             4                   // Consecutive async slots for MN generic/NMT frames per scheduler round
+#endif
+
+#ifndef CONFIG_DLLCAL_SOA_WEIGHT_MN_IDENT
+#define CONFIG_DLLCAL_SOA_WEIGHT_MN_IDENT               1                   // Consecutive async slots for IdentRequests per scheduler round
+#endif
+
+#ifndef CONFIG_DLLCAL_SOA_WEIGHT_MN_STATUS
+#define CONFIG_DLLCAL_SOA_WEIGHT_MN_STATUS              1                   // Consecutive async slots for StatusRequests per scheduler round
+#endif
+
+#ifndef CONFIG_DLLCAL_SOA_WEIGHT_MN_SYNC
+#define CONFIG_DLLCAL_SOA_WEIGHT_MN_SYNC                1                   // Consecutive async slots for SyncRequests per scheduler round
+#endif
+
+#ifndef CONFIG_DLLCAL_SOA_NODE_WEIGHT
+#define CONFIG_DLLCAL_SOA_NODE_WEIGHT                   1                   // Default number of pending CN requests queued per node at once
+#endif
+
 #ifndef CONFIG_DLL_PRES_CHAINING_CN
 #define CONFIG_DLL_PRES_CHAINING_CN                     FALSE
 #endif
@@ -93,6 +161,282 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_ASYNC       FALSE
 #endif
 
+#ifndef CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE
+#define CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE                FALSE               // MN: shorten the PRes timeouts of the CNs to their measured response times (requires target_getCurrentTimestamp())
+#endif
+
+#ifndef CONFIG_DLL_PREOP1_FAST_BOOT
+#define CONFIG_DLL_PREOP1_FAST_BOOT                     FALSE               // MN: shorten the reduced cycle in PreOp1 while asynchronous frames and requests are queued
+#endif
+
+#ifndef CONFIG_DLL_PREOP1_FAST_SLOT_TIME
+#define CONFIG_DLL_PREOP1_FAST_SLOT_TIME                20000               // MN: minimum reduced cycle time in [ns] of the fast boot mode
+#endif
+
+#ifndef CONFIG_DLL_PREOP1_FAST_QUEUE_DEPTH
+#define CONFIG_DLL_PREOP1_FAST_QUEUE_DEPTH              2                   // MN: number of queued frames and requests which activates the fast boot mode
+#endif
+
+#ifndef CONFIG_DLL_PREOP1_IDLE_SLOT_TIME_MAX
+#define CONFIG_DLL_PREOP1_IDLE_SLOT_TIME_MAX            0                   // MN: maximum time in [ns] the reduced cycle in PreOp1 is stretched to while there is no demand, 0 = disabled
+#endif
+
+#ifndef CONFIG_DLL_STATE_TRANSITION_COUNT
+#define CONFIG_DLL_STATE_TRANSITION_COUNT               FALSE               // CN: count the transitions of the DLL state machine (dllk_getStateTransitionCount())
+#endif
+
+#ifndef CONFIG_DLL_WARMUP_CYCLES
+#define CONFIG_DLL_WARMUP_CYCLES                        0                   // Number of TPDO frame build iterations run before the first isochronous cycle
+#endif
+
+#ifndef CONFIG_DLL_RUNTIME_CYCLE_CHANGE
+#define CONFIG_DLL_RUNTIME_CYCLE_CHANGE                 FALSE               // Apply writes of the cycle length (0x1006) at runtime at a cycle boundary instead of on the next reset
+#endif
+
+#ifndef CONFIG_DLL_PRES_LATE_BINDING
+#define CONFIG_DLL_PRES_LATE_BINDING                    FALSE               // CN: fill the PRes shortly before the expected PReq instead of on the sync event (requires CONFIG_EDRV_AUTO_RESPONSE)
+#endif
+
+#ifndef CONFIG_DLL_SOC_TIME_INFO
+#define CONFIG_DLL_SOC_TIME_INFO                        FALSE               // Publish the NetTime and RelativeTime of every SoC with the local time of the SoC (oplk_getNetTime())
+#endif
+
+#ifndef CONFIG_DLL_PRES_LATE_BINDING_MARGIN
+#define CONFIG_DLL_PRES_LATE_BINDING_MARGIN             5000                // CN: margin in [ns] added to the measured PRes fill duration to get the lead time before the PReq
+#endif
+
+#ifndef CONFIG_PDO_RX_DIRECT_COPY
+#define CONFIG_PDO_RX_DIRECT_COPY                       FALSE               // Copy RPDOs from the Rx buffer directly into the PDO triple buffer
+#endif
+
+#ifndef CONFIG_PDO_RX_DMA
+#define CONFIG_PDO_RX_DMA                               FALSE               // Copy RPDOs by the memory-to-memory DMA of an openMAC design (requires CONFIG_PDO_RX_DIRECT_COPY)
+#endif
+
+#ifndef CONFIG_PDO_RX_DMA_TRANSFERS
+#define CONFIG_PDO_RX_DMA_TRANSFERS                     4                   // Maximum number of pending RPDO DMA transfers
+#endif
+
+#ifndef CONFIG_PDO_HOSTIF_DMA
+#define CONFIG_PDO_HOSTIF_DMA                           FALSE               // Host exchanges a local copy of the PDO buffers with the PCP by DMA (host interface)
+#endif
+
+#ifndef CONFIG_PDO_STATIC_COPY
+#define CONFIG_PDO_STATIC_COPY                          FALSE               // Use PDO copy functions generated by tools/genpdocopy.pl (pdostaticcopy.h) for matching mappings
+#endif
+
+#ifndef CONFIG_PDO_WARMUP_CYCLES
+#define CONFIG_PDO_WARMUP_CYCLES                        0                   // Number of process image copy iterations run after the PDO configuration
+#endif
+
+#ifndef CONFIG_PDO_HITLESS_REMAP
+#define CONFIG_PDO_HITLESS_REMAP                        FALSE               // Switch the mapping of a single PDO channel at runtime without stopping the PDO engine
+#endif
+
+#ifndef CONFIG_PDO_TX_ZERO_COPY
+#define CONFIG_PDO_TX_ZERO_COPY                         FALSE               // CN: send the PRes directly from the TPDO triple buffer (requires local PDO memory and CONFIG_EDRV_AUTO_RESPONSE, edrv-openmac)
+#endif
+
+#ifndef CONFIG_PDO_RX_WORKER
+#define CONFIG_PDO_RX_WORKER                            FALSE               // Process RPDOs in a separate worker thread (Linux userspace only)
+#endif
+
+#ifndef CONFIG_PDO_RX_WORKER_QUEUE_SIZE
+#define CONFIG_PDO_RX_WORKER_QUEUE_SIZE                 64                  // Number of frames in the queue of the RPDO worker (power of two)
+#endif
+
+#ifndef CONFIG_PDO_PARALLEL_COPY
+#define CONFIG_PDO_PARALLEL_COPY                        FALSE               // Copy the PDO channels of large process images by a pool of worker threads (Linux userspace only)
+#endif
+
+#ifndef CONFIG_PDO_PARALLEL_COPY_WORKERS
+#define CONFIG_PDO_PARALLEL_COPY_WORKERS                3                   // Number of worker threads, the thread which exchanges the process image copies as well
+#endif
+
+#ifndef CONFIG_PDO_PARALLEL_COPY_THRESHOLD
+#define CONFIG_PDO_PARALLEL_COPY_THRESHOLD              (32 * 1024)         // Mapped PDO data of a direction above which it is copied in parallel [bytes]
+#endif
+
+#ifndef CONFIG_PDO_RX_STREAM_COPY
+#define CONFIG_PDO_RX_STREAM_COPY                       FALSE               // Write RPDOs into the triple buffer with non-temporal stores, if the user layer runs on another core (memcopy_stream())
+#endif
+
+#ifndef CONFIG_PDO_RX_READER_COUNT
+#define CONFIG_PDO_RX_READER_COUNT                      1                   // Number of independent RPDO readers of the PDO memory, RPDOs use readers + 2 buffers (1..8)
+#endif
+
+#ifndef CONFIG_PDO_TX_STREAM_COPY
+#define CONFIG_PDO_TX_STREAM_COPY                       FALSE               // Read TPDOs into the Tx frame with non-temporal stores, if the frame is sent by DMA without being read by the CPU (memcopy_stream())
+#endif
+
+#ifndef CONFIG_PDO_ROUTE_COUNT
+#define CONFIG_PDO_ROUTE_COUNT                          0                   // Number of routes which copy RPDO data into TPDOs in the kernel layer (0 = disabled)
+#endif
+
+#ifndef CONFIG_PDO_ROUTE_BUFFER_SIZE
+#define CONFIG_PDO_ROUTE_BUFFER_SIZE                    256                 // Maximum total size of the data of all PDO routes [bytes]
+#endif
+
+#ifndef CONFIG_PDO_KERNEL_PI
+#define CONFIG_PDO_KERNEL_PI                            FALSE               // Assemble the process images in the kernel layer, the user layer only switches buffers (kernel-interface builds)
+#endif
+
+#ifndef CONFIG_PDO_KERNEL_PI_SIZE
+#define CONFIG_PDO_KERNEL_PI_SIZE                       4096                // Maximum size of each process image assembled in the kernel layer [bytes]
+#endif
+
+#ifndef CONFIG_PDO_KERNEL_PI_COPY_COUNT
+#define CONFIG_PDO_KERNEL_PI_COPY_COUNT                 256                 // Maximum number of copy operations of the process images assembled in the kernel layer
+#endif
+
+#ifndef CONFIG_CYCLE_STATISTICS
+#define CONFIG_CYCLE_STATISTICS                         FALSE               // Record latency histograms of the cycle stages (requires target_getCurrentTimestamp())
+#endif
+
+#ifndef CONFIG_CYCLE_STATISTICS_WINDOW_SIZE
+#define CONFIG_CYCLE_STATISTICS_WINDOW_SIZE             10000               // Number of samples in the rolling percentile windows of the cycle statistics
+#endif
+
+#ifndef CONFIG_FLIGHT_RECORDER
+#define CONFIG_FLIGHT_RECORDER                          FALSE               // Keep the frames of the last cycles and freeze them on DLL errors (requires target_getCurrentTimestamp())
+#endif
+
+#ifndef CONFIG_METRICS
+#define CONFIG_METRICS                                  FALSE               // Collect the counters, gauges and histograms of the stack modules in the metrics registry
+#endif
+
+#ifndef CONFIG_METRICS_COUNT
+#define CONFIG_METRICS_COUNT                            64                  // Maximum number of metrics in the metrics registry
+#endif
+
+#ifndef CONFIG_EVENT_LATENCY
+#define CONFIG_EVENT_LATENCY                            FALSE               // Measure the queueing delay and processing time of events in circular buffer queues (requires CONFIG_METRICS)
+#endif
+
+#ifndef CONFIG_FLIGHT_RECORDER_CYCLES
+#define CONFIG_FLIGHT_RECORDER_CYCLES                   16                  // Number of cycles kept by the flight recorder
+#endif
+
+#ifndef CONFIG_FLIGHT_RECORDER_FRAMES
+#define CONFIG_FLIGHT_RECORDER_FRAMES                   32                  // Maximum number of frames recorded per cycle by the flight recorder
+#endif
+
+#ifndef CONFIG_FLIGHT_RECORDER_TRIGGER
+#define CONFIG_FLIGHT_RECORDER_TRIGGER                  (DLL_ERR_CN_LOSS_SOC | DLL_ERR_MN_CYCTIMEEXCEED | DLL_ERR_MN_CN_LOSS_PRES) // DLL error events (kernel/errhndk.h) which freeze the flight recorder
+#endif
+
+#ifndef CONFIG_CTRL_STARTUP_TIMING
+#define CONFIG_CTRL_STARTUP_TIMING                      FALSE               // Measure the duration of the start-up phases of the stack (requires target_getCurrentTimestamp())
+#endif
+
+#ifndef CONFIG_API_DEFERRED_EVENTS
+#define CONFIG_API_DEFERRED_EVENTS                      FALSE               // Call the non-critical API event callbacks from a separate worker thread (Linux userspace only)
+#endif
+
+#ifndef CONFIG_API_DEFERRED_EVENTS_QUEUE_SIZE
+#define CONFIG_API_DEFERRED_EVENTS_QUEUE_SIZE           64                  // Number of API events in the queue of the deferred event worker (power of two)
+#endif
+
+#ifndef CONFIG_SDO_SERVER_ASYNC
+#define CONFIG_SDO_SERVER_ASYNC                         FALSE               // Execute expedited SDO server accesses to objects with a callback on worker threads (Linux userspace only)
+#endif
+
+#ifndef CONFIG_SDO_SERVER_ASYNC_WORKERS
+#define CONFIG_SDO_SERVER_ASYNC_WORKERS                 2                   // Number of worker threads of the asynchronous SDO server
+#endif
+
+#ifndef CONFIG_SDO_SERVER_ASYNC_QUEUE_SIZE
+#define CONFIG_SDO_SERVER_ASYNC_QUEUE_SIZE              8                   // Number of OD accesses waiting for a worker thread (further accesses are executed directly)
+#endif
+
+#ifndef CONFIG_SDO_SERVER_ASYNC_MIN_INDEX
+#define CONFIG_SDO_SERVER_ASYNC_MIN_INDEX               0x2000              // Lowest object index which is accessed by the worker threads (communication objects stay in the event thread)
+#endif
+
+#ifndef CONFIG_SDO_SEQ_ADAPTIVE_RTO
+#define CONFIG_SDO_SEQ_ADAPTIVE_RTO                     FALSE               // Adapt the SDO sequence layer retransmission timeout to the measured round trip time
+#endif
+
+#ifndef CONFIG_SDO_SEQ_RTO_MIN_MS
+#define CONFIG_SDO_SEQ_RTO_MIN_MS                       50                  // Lower bound of the adaptive retransmission timeout [ms]
+#endif
+
+#ifndef CONFIG_SDO_SEQ_DUP_ACK_THRESHOLD
+#define CONFIG_SDO_SEQ_DUP_ACK_THRESHOLD                2                   // Number of duplicate acknowledges which trigger a retransmission before the timeout
+#endif
+
+#ifndef CONFIG_EDRV_MIRROR
+#define CONFIG_EDRV_MIRROR                              FALSE               // Mirror the frames of the Linux user space Ethernet drivers into a shared memory ring
+#endif
+
+#ifndef CONFIG_EDRV_MIRROR_SLOTS
+#define CONFIG_EDRV_MIRROR_SLOTS                        4096                // Number of frames kept in the Ethernet driver mirror ring
+#endif
+
+#ifndef CONFIG_EDRV_SIM_CN_COUNT
+#define CONFIG_EDRV_SIM_CN_COUNT                        239                 // Number of CNs emulated by the simulated Ethernet driver (node IDs 1 - n)
+#endif
+
+#ifndef CONFIG_EDRV_SIM_PRES_LATENCY_NS
+#define CONFIG_EDRV_SIM_PRES_LATENCY_NS                 2000                // Latency of the simulated CNs between PReq and PRes [ns]
+#endif
+
+#ifndef CONFIG_EDRV_SIM_ASND_LATENCY_NS
+#define CONFIG_EDRV_SIM_ASND_LATENCY_NS                 5000                // Latency of the simulated CNs between SoA and ASnd [ns]
+#endif
+
+#ifndef CONFIG_EDRV_SIM_SDO_DELAY_US
+#define CONFIG_EDRV_SIM_SDO_DELAY_US                    100                 // Processing time of an SDO command in the simulated CNs [us]
+#endif
+
+#ifndef CONFIG_EDRV_SIM_PRES_LOSS_PER_MILLE
+#define CONFIG_EDRV_SIM_PRES_LOSS_PER_MILLE             0                   // Probability that a simulated CN drops a PRes [1/1000]
+#endif
+
+#ifndef CONFIG_EDRV_SIM_SDO_LOSS_PER_MILLE
+#define CONFIG_EDRV_SIM_SDO_LOSS_PER_MILLE              0                   // Probability that a simulated CN drops an SDO response [1/1000]
+#endif
+
+#ifndef CONFIG_EDRV_REPLAY_SPEED_PERCENT
+#define CONFIG_EDRV_REPLAY_SPEED_PERCENT                100                 // Speed of the replay Ethernet driver relative to the capture (0 = as fast as possible)
+#endif
+
+#ifndef CONFIG_EDRV_REPLAY_START_DELAY_MS
+#define CONFIG_EDRV_REPLAY_START_DELAY_MS               0                   // Delay between the initialization of the replay Ethernet driver and the first frame [ms]
+#endif
+
+#ifndef CONFIG_EDRV_REPLAY_LOCAL_NODE_ID
+#define CONFIG_EDRV_REPLAY_LOCAL_NODE_ID                C_ADR_MN_DEF_NODE_ID    // Frames of this node are not replayed, the stack sends them itself (0 = replay all)
+#endif
+
+#ifndef CONFIG_EDRV_FAST_LINK
+#define CONFIG_EDRV_FAST_LINK                           FALSE               // Force the link settings instead of auto-negotiation and report link changes to the DLL (edrv-i210, edrv-82573)
+#endif
+
+#ifndef CONFIG_EDRV_FAST_LINK_PHY_CONTROL
+#define CONFIG_EDRV_FAST_LINK_PHY_CONTROL               0x2100              // Value of the PHY control register in fast link mode (default: 100 Mbit/s full duplex, auto-negotiation off)
+#endif
+
+#ifndef CONFIG_BINTRACE
+#define CONFIG_BINTRACE                                 FALSE               // Record binary trace points into per-thread rings (Linux user space only)
+#endif
+
+#ifndef CONFIG_BINTRACE_RING_COUNT
+#define CONFIG_BINTRACE_RING_COUNT                      8                   // Maximum number of threads recording binary trace points
+#endif
+
+#ifndef CONFIG_BINTRACE_RING_SIZE
+#define CONFIG_BINTRACE_RING_SIZE                       4096                // Number of records per binary trace ring (must be a power of 2)
+#endif
+
+#ifndef CONFIG_ERRHND_HISTORY_COALESCE_WINDOW_MS
+#define CONFIG_ERRHND_HISTORY_COALESCE_WINDOW_MS        0                   // Window in [ms] in which identical error history entries are merged (0 = disabled)
+#endif
+
+#ifndef CONFIG_ERRHND_HISTORY_COALESCE_ENTRIES
+#define CONFIG_ERRHND_HISTORY_COALESCE_ENTRIES          8                   // Number of distinct error history entries which can be merged at the same time
+#endif
+
 #if defined(CONFIG_INCLUDE_NMT_MN)
     // MN should support generic Asnd frames, thus the maximum ID
     // is set to a large value
@@ -116,11 +460,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #ifndef D_PDO_RPDOChannelObjects_U8
-#define D_PDO_RPDOChannelObjects_U8                     254                 // number of supported mapped objects per RPDO channel
+#define D_PDO_RPDOChannelObjects_U8                     254                 // max. number of mapped objects per RPDO channel (allocated per OD mapping size)
 #endif
 
 #ifndef D_PDO_TPDOChannelObjects_U8
-#define D_PDO_TPDOChannelObjects_U8                     254                 // number of supported mapped objects per TPDO channel
+#define D_PDO_TPDOChannelObjects_U8                     254                 // max. number of mapped objects per TPDO channel (allocated per OD mapping size)
 #endif
 
 #ifndef D_PDO_RPDOChannels_U16
@@ -149,6 +493,26 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_DLL_SOC_SYNC_SHIFT_US                    150                 // negative time shift of isochronous task in relation to SoC
 #endif
 
+#ifndef CONFIG_SYNCTIMER_PI_SERVO
+#define CONFIG_SYNCTIMER_PI_SERVO                       FALSE               // use the PI servo instead of the moving mean in the openMAC sync timer
+#endif
+
+#ifndef CONFIG_SYNCTIMER_KP_SHIFT
+#define CONFIG_SYNCTIMER_KP_SHIFT                       3                   // proportional gain of the sync servo (1 / 2^n)
+#endif
+
+#ifndef CONFIG_SYNCTIMER_KI_SHIFT
+#define CONFIG_SYNCTIMER_KI_SHIFT                       6                   // integral gain of the sync servo (1 / 2^n)
+#endif
+
+#ifndef CONFIG_SYNCTIMER_ACQUISITION_CYCLES
+#define CONFIG_SYNCTIMER_ACQUISITION_CYCLES             16                  // cycles with high gains after the first SoC or a cycle length change
+#endif
+
+#ifndef CONFIG_SYNCTIMER_OUTLIER_LIMIT
+#define CONFIG_SYNCTIMER_OUTLIER_LIMIT                  0                   // sync errors in [ns] above this limit are ignored by the servo (0 = off)
+#endif
+
 #ifndef CONFIG_DLL_PRES_FILTER_COUNT
 #if defined(CONFIG_INCLUDE_NMT_MN)
 #define CONFIG_DLL_PRES_FILTER_COUNT                           -1           // maximum count of Rx filter entries for PRes frames
@@ -165,6 +529,18 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 #endif
 
+#ifndef CONFIG_DLL_SOC_WATCHDOG
+#define CONFIG_DLL_SOC_WATCHDOG                         FALSE               // CN: detect loss of SoC by a periodic check of the last SoC time instead of re-arming the cycle timer on every SoC (requires CONFIG_TIMER_USE_HIGHRES)
+#endif
+
+#ifndef CONFIG_DLL_SOC_WATCHDOG_PERIOD_US
+#define CONFIG_DLL_SOC_WATCHDOG_PERIOD_US               0                   // CN: period of the loss of SoC check [us] (0 = cycle length)
+#endif
+
+#ifndef CONFIG_DLL_PRES_NODE_FILTER
+#define CONFIG_DLL_PRES_NODE_FILTER                     TRUE                // CN: drop PRes of nodes whose RPDOs and heartbeat are not consumed before they are processed (requires NMT_MAX_NODE_ID > 0)
+#endif
+
 #ifndef D_NMT_MaxCNNumber_U8
 #define D_NMT_MaxCNNumber_U8                            239                 // maximum number of supported regular CNs in the Node ID range 1 .. 239
 #endif
@@ -173,6 +549,42 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define NMTMNU_PRC_NODE_ADD_MAX_NUM                     D_NMT_MaxCNNumber_U8
 #endif
 
+#ifndef NMTMNU_PRC_NODE_SHIFT_MAX_NUM
+#define NMTMNU_PRC_NODE_SHIFT_MAX_NUM                   1                   // maximum number of PRC nodes which are shifted with one batch of SyncReqs
+#endif
+
+#ifndef CONFIG_NMTMNU_MULTIPLEX_SCHEDULE
+#define CONFIG_NMTMNU_MULTIPLEX_SCHEDULE                FALSE               // MN: compute the multiplexed cycle assignment (0x1F9B) of the multiplexed CNs at NMT_ResetConfiguration
+#endif
+
+#ifndef CONFIG_NMTMNU_IDENTREQ_BACKOFF_MAX_MS
+#define CONFIG_NMTMNU_IDENTREQ_BACKOFF_MAX_MS           0                   // MN: maximum interval of IdentRequests to absent optional CNs, doubled after each missing IdentResponse (0 = fixed interval)
+#endif
+
+#ifndef CONFIG_NMTMNU_SUPERVISOR_TICK_MS
+#define CONFIG_NMTMNU_SUPERVISOR_TICK_MS                0                   // MN: period of the tick which checks the IdentRequest, StatusRequest and state monitoring deadlines of all CNs (0 = one user timer per CN)
+#endif
+
+#ifndef CONFIG_NMTMNU_COALESCE_NMT_CMD
+#define CONFIG_NMTMNU_COALESCE_NMT_CMD                  FALSE               // MN: send the per-node NMT state commands issued while processing one event as one extended NMT command
+#endif
+
+#ifndef CONFIG_NMTMNU_STATREQ_RELAX_MAX_MS
+#define CONFIG_NMTMNU_STATREQ_RELAX_MAX_MS              0                   // MN: maximum interval of StatusRequests to healthy async-only CNs, doubled after each StatusResponse without error (0 = fixed interval)
+#endif
+
+#ifndef CONFIG_IDENTU_CACHE_MAX_AGE
+#define CONFIG_IDENTU_CACHE_MAX_AGE                     5000                // maximum age in ms of a cached IdentResponse before a new one is requested
+#endif
+
+#ifndef CONFIG_STATUSU_CACHE_MAX_AGE
+#define CONFIG_STATUSU_CACHE_MAX_AGE                    1000                // maximum age in ms of a cached StatusResponse before a new one is requested
+#endif
+
+#ifndef CONFIG_NMTU_CACHE_MAX_WAITERS
+#define CONFIG_NMTU_CACHE_MAX_WAITERS                   4                   // maximum number of coalesced requesters per node for cached Ident-/StatusResponses
+#endif
+
 // defines for POWERLINK API layer static process image
 #ifndef API_PROCESS_IMAGE_SIZE_IN
 #define API_PROCESS_IMAGE_SIZE_IN                       0
@@ -198,10 +610,26 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_OBD_USE_STORE_RESTORE                    FALSE
 #endif
 
+#ifndef CONFIG_OBD_USE_STORE_MMAP
+#define CONFIG_OBD_USE_STORE_MMAP                       FALSE               // Store the OD in a memory mapped file (requires CONFIG_OBD_USE_STORE_RESTORE)
+#endif
+
+#ifndef CONFIG_OBD_DEF_STORE_FILENAME
+#define CONFIG_OBD_DEF_STORE_FILENAME                   "pl_obd.sto"
+#endif
+
+#ifndef CONFIG_OBD_STORE_PART_SIZE
+#define CONFIG_OBD_STORE_PART_SIZE                      0x10000             // Size of the store file area of each OD partition (multiple of 4096)
+#endif
+
 #ifndef CONFIG_OBD_USE_LOAD_CONCISEDCF
 #define CONFIG_OBD_USE_LOAD_CONCISEDCF                  FALSE
 #endif
 
+#ifndef CONFIG_OBD_DOMAIN_STREAM_COUNT
+#define CONFIG_OBD_DOMAIN_STREAM_COUNT                  0                   // Number of domain objects which can be backed by a stream (0 = disabled)
+#endif
+
 #ifndef CONFIG_OBD_DEF_CONCISEDCF_FILENAME
 #define CONFIG_OBD_DEF_CONCISEDCF_FILENAME              "pl_obd.cdc"
 #endif
@@ -218,6 +646,26 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_OBD_INCLUDE_A000_TO_DEVICE_PART          FALSE
 #endif
 
+#ifndef CONFIG_OBD_INDEX_HASH_SIZE
+#define CONFIG_OBD_INDEX_HASH_SIZE                      0                   // Size of the OD index hash table (power of two, 0 = binary search only)
+#endif
+
+#ifndef CONFIG_OBD_DEFER_DEFAULTS
+#define CONFIG_OBD_DEFER_DEFAULTS                       FALSE               // Copy the default values of an OD partition on its first access instead of at obd_init()
+#endif
+
+#ifndef CONFIG_OBD_LOAD_CHANGED_ONLY
+#define CONFIG_OBD_LOAD_CHANGED_ONLY                    FALSE               // Reload only the communication objects which were changed since the last NMT reset
+#endif
+
+#ifndef CONFIG_OBD_CONST_TABLES
+#define CONFIG_OBD_CONST_TABLES                         FALSE               // Place the index tables and the sub-index tables of non-array objects in ROM
+#endif
+
+#ifndef CONFIG_OBD_FAST_ACCESS
+#define CONFIG_OBD_FAST_ACCESS                          TRUE                // Access numerical objects without callback function and range directly
+#endif
+
 #ifndef PLK_VETH_NAME
 #define PLK_VETH_NAME                                   "plk"               // name of net device in Linux
 #endif
@@ -235,6 +683,29 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 #endif
 
+#ifndef CONFIG_MEMARENA
+#define CONFIG_MEMARENA                                 FALSE               // Serve OPLK_MALLOC() from a static arena instead of the heap (Linux user space only)
+#endif
+
+// rough approximation of the arena size: stack base, per node data (identification, configuration,
+// timers) and PDO channels; blocks are rounded to powers of two
+#ifndef CONFIG_MEMARENA_SIZE
+#define CONFIG_MEMARENA_SIZE                            ((1024 * 1024) + (NMT_MAX_NODE_ID * 4096) + \
+                                                         ((D_PDO_RPDOChannels_U16 + D_PDO_TPDOChannels_U16) * 1024))
+#endif
+
+#ifndef CONFIG_MEMARENA_MODULE_COUNT
+#define CONFIG_MEMARENA_MODULE_COUNT                    32                  // Number of modules accounted separately in the memory arena report
+#endif
+
+#ifndef CONFIG_AMI_INLINE
+#define CONFIG_AMI_INLINE                               TRUE                // Inline the 16/32/64 bit AMI accessors if the compiler provides the byte order (GCC)
+#endif
+
+#ifndef CONFIG_MEMCOPY_STREAM_THRESHOLD
+#define CONFIG_MEMCOPY_STREAM_THRESHOLD                 256                 // Blocks smaller than this are copied by memcopy_stream() with regular stores [bytes]
+#endif
+
 #ifndef EDRV_FILTER_WITH_RX_HANDLER
 #define EDRV_FILTER_WITH_RX_HANDLER                     FALSE
 #endif
@@ -247,5 +718,133 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_EDRV_AUTO_RESPONSE_DELAY                 FALSE
 #endif
 
+#ifndef CONFIG_EDRV_TX_BUFFER_HEADROOM
+#define CONFIG_EDRV_TX_BUFFER_HEADROOM                  0                   // Bytes the Ethernet driver needs in front of a Tx frame (edrv-openmac: size of the packet length field)
+#endif
+
+#ifndef CONFIG_EDRV_RX_FILTER_BATCH
+#define CONFIG_EDRV_RX_FILTER_BATCH                     FALSE               // Commit Rx filter changes at the cycle boundary and reuse armed auto-responses (edrv-openmac)
+#endif
+
+#ifndef CONFIG_EDRV_SOFT_FILTER
+#define CONFIG_EDRV_SOFT_FILTER                         FALSE               // Drop POWERLINK frames which match no Rx filter in software (edrv-pcap_linux, edrv-8139, edrv-8255x)
+#endif
+
+#ifndef CONFIG_EDRV_SOFT_FILTER_COUNT
+#define CONFIG_EDRV_SOFT_FILTER_COUNT                   272                 // Maximum number of Rx filter entries in the hash table of the software Rx filter
+#endif
+
+#ifndef CONFIG_EDRV_I210_MULTI_QUEUE
+#define CONFIG_EDRV_I210_MULTI_QUEUE                    FALSE               // Separate isochronous and asynchronous Tx/Rx queues in edrv-i210
+#endif
+
+#ifndef CONFIG_EDRV_POLL_MODE
+#define CONFIG_EDRV_POLL_MODE                           FALSE               // Busy-poll the controller in the isochronous phase (edrv-82573, edrv-8255x, edrv-8139)
+#endif
+
+#ifndef CONFIG_EDRV_PCAP_BUFFER_SIZE
+#define CONFIG_EDRV_PCAP_BUFFER_SIZE                    (1024 * 1024)       // Kernel capture buffer of the receive handle of edrv-pcap_linux and edrv-pcap_win [bytes]
+#endif
+
+#ifndef CONFIG_EDRV_PCAP_QDISC_BYPASS
+#define CONFIG_EDRV_PCAP_QDISC_BYPASS                   FALSE               // Send the frames of edrv-pcap_linux past the queueing discipline (the Tx handler is then called right after sending)
+#endif
+
+#if (TARGET_SYSTEM == _LINUX_)
+// CPU affinity masks of the realtime threads (bit n = CPU n, 0 = no pinning).
+// Use CPUs which are isolated by the kernel parameter isolcpus for short cycle times.
+#ifndef CONFIG_THREAD_CPU_MASK_HRTIMER
+#define CONFIG_THREAD_CPU_MASK_HRTIMER                  0                   // CPU affinity of the high-resolution timer threads
+#endif
+
+#ifndef CONFIG_THREAD_CPU_MASK_EDRV_RX
+#define CONFIG_THREAD_CPU_MASK_EDRV_RX                  0                   // CPU affinity of the Ethernet driver receive thread
+#endif
+
+#ifndef CONFIG_THREAD_CPU_MASK_EVENT
+#define CONFIG_THREAD_CPU_MASK_EVENT                    0                   // CPU affinity of the event threads
+#endif
+
+#ifndef CONFIG_THREAD_CPU_MASK_PDO_RX
+#define CONFIG_THREAD_CPU_MASK_PDO_RX                   0                   // CPU affinity of the RPDO worker thread
+#endif
+
+#ifndef CONFIG_THREAD_CPU_MASK_PDO_COPY
+#define CONFIG_THREAD_CPU_MASK_PDO_COPY                 0                   // CPUs of the parallel copy worker threads, one CPU per worker (round-robin)
+#endif
+
+#ifndef CONFIG_IRQ_CPU_MASK_EDRV_ISOC
+#define CONFIG_IRQ_CPU_MASK_EDRV_ISOC                   0                   // CPU affinity of the interrupt of the isochronous Rx path (edrv-82573, edrv-i210)
+#endif
+
+#ifndef CONFIG_IRQ_CPU_MASK_EDRV_ASYNC
+#define CONFIG_IRQ_CPU_MASK_EDRV_ASYNC                  0                   // CPU affinity of the asynchronous queue interrupt (edrv-i210 multi-queue mode)
+#endif
+
+#ifndef CONFIG_IRQ_EDRV_ISOC_HARDIRQ
+#define CONFIG_IRQ_EDRV_ISOC_HARDIRQ                    FALSE               // Don't thread the interrupt of the isochronous Rx path (edrv-82573, edrv-i210, not on PREEMPT_RT)
+#endif
+
+#ifndef CONFIG_THREAD_PRIORITY_EDRV_IRQ
+#define CONFIG_THREAD_PRIORITY_EDRV_IRQ                 0                   // SCHED_FIFO priority of the controller interrupt threads (edrv-82573, edrv-i210, 0 = kernel default)
+#endif
+
+#ifndef CONFIG_THREAD_PRIORITY_EVENTK
+#define CONFIG_THREAD_PRIORITY_EVENTK                   0                   // SCHED_FIFO priority of the Linux kernel event thread (0 = built-in)
+#endif
+
+#ifndef CONFIG_THREAD_PRIORITY_EDRV_POLL
+#define CONFIG_THREAD_PRIORITY_EDRV_POLL                0                   // SCHED_FIFO priority of the Ethernet driver poll thread (0 = built-in)
+#endif
+
+#ifndef CONFIG_THREAD_CPU_MASK_EDRV_POLL
+#define CONFIG_THREAD_CPU_MASK_EDRV_POLL                0                   // CPU affinity of the Ethernet driver poll thread (CONFIG_EDRV_POLL_MODE)
+#endif
+
+#ifndef CONFIG_HRESTIMER_BUSY_WAIT_US
+#define CONFIG_HRESTIMER_BUSY_WAIT_US                   0                   // Time in us the high-resolution timer polls the clock before a deadline
+#endif
+
+// The PDO shared memory of the POSIX shared memory implementation can be placed
+// on a hugetlbfs mount to avoid TLB misses (e.g. "/dev/hugepages").
+#ifndef CONFIG_PDO_SHM_HUGETLBFS_PATH
+#define CONFIG_PDO_SHM_HUGETLBFS_PATH                   ""                  // Mount point of hugetlbfs for the PDO memory ("" = POSIX shared memory)
+#endif
+
+// The PDO buffers which the Linux kernel driver maps to the user layer can use
+// write-combining or uncached memory (x86 only). Reads of the RPDOs from such
+// memory are slow, the user layer has to copy them once.
+#ifndef CONFIG_PDO_MMAP_CACHE_MODE
+#define CONFIG_PDO_MMAP_CACHE_MODE                      0                   // Memory type of the mapped PDO buffers (0 = cached, 1 = write-combining, 2 = uncached)
+#endif
+
+#ifndef CONFIG_PDO_SHM_LOCK
+#define CONFIG_PDO_SHM_LOCK                             FALSE               // Lock the PDO shared memory into RAM
+#endif
+
+#ifndef CONFIG_MEMLOCK_ALL
+#define CONFIG_MEMLOCK_ALL                              FALSE               // Lock and pre-fault all current and future memory of the process at initialization (mlockall)
+#endif
+
+#ifndef CONFIG_MEMLOCK_STACK_PREFAULT
+#define CONFIG_MEMLOCK_STACK_PREFAULT                   (64 * 1024)         // Bytes of the stack of the initializing thread which are pre-faulted (CONFIG_MEMLOCK_ALL)
+#endif
+
+// The realtime threads can be assigned to a group of the resctrl file system
+// (Intel RDT CAT, ARM MPAM) which reserves a part of the L3 cache for them. The
+// group and its schemata are created by the system configuration.
+#ifndef CONFIG_TARGET_CACHE_ALLOC
+#define CONFIG_TARGET_CACHE_ALLOC                       FALSE               // Assign the realtime stack threads to a resctrl cache allocation group
+#endif
+
+#ifndef CONFIG_TARGET_CACHE_ALLOC_GROUP
+#define CONFIG_TARGET_CACHE_ALLOC_GROUP                 "/sys/fs/resctrl/oplk" // Directory of the resctrl group (CONFIG_TARGET_CACHE_ALLOC)
+#endif
+
+#ifndef CONFIG_TARGET_CACHE_ALLOC_ROLES
+#define CONFIG_TARGET_CACHE_ALLOC_ROLES                 0x043F              // Thread roles assigned to the group (bit n = tThreadRole n, default Edrv Rx to PDO Rx and PDO copy)
+#endif
+#endif
+
 #endif /* _INC_oplk_defaultcfg_H_ */
 
@@ -213,6 +213,7 @@ typedef struct
 #if defined(CONFIG_INCLUDE_NMT_MN)
     UINT16              preqPayloadLimit;               ///< object 0x1F8B: NMT_MNPReqPayloadLimitList_AU16
     UINT32              presTimeoutNs;                  ///< object 0x1F92: NMT_MNCNPResTimeout_AU32
+    UINT8               multiplCycleAssign;             ///< object 0x1F9B: NMT_MultiplCycleAssign_AU8, 0 = continuous CN
 #endif
 } tDllNodeInfo;
 
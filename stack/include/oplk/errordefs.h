@@ -171,6 +171,7 @@ typedef enum
     kErrorObdInvalidDcf             = 0x003C,       ///< The device configuration file (CDC) is not valid
     kErrorObdOutOfMemory            = 0x003D,       ///< Out of memory
     kErrorObdNoConfigData           = 0x003E,       ///< No configuration data present (CDC is empty)
+    kErrorObdStoreInvalid           = 0x003F,       ///< The stored OD data is not valid
 
     // area for NMT module 0x0040 - 0x004F
     kErrorNmtUnknownCommand         = 0x0040,       ///< Unknown NMT command
@@ -265,6 +266,8 @@ typedef enum
     kErrorApiPIInvalidJobSize       = 0x014B,       ///< Process image: invalid job size
     kErrorApiPIInvalidPIPointer     = 0x014C,       ///< Process image: pointer to application's process image is invalid
     kErrorApiPINonBlockingNotSupp   = 0x014D,       ///< Process image: non-blocking copy jobs are not supported on this target
+    kErrorApiNotSupported           = 0x014E,       ///< The called function is not supported by the stack configuration
+    kErrorApiSdoQueueFull           = 0x014F,       ///< SDO batch: request queue is full
 
     // area until 0x07FF is reserved
     // area for user application from 0x0800 to 0x7FFF
@@ -90,6 +90,7 @@ typedef enum
     kEventTypeNmtMnuNmtCmdSent      = 0x18,     ///< NMT command was actually sent (arg is pointer to tPlkFrame)
     kEventTypeApiUserDef            = 0x19,     ///< user-defined event (arg is user-defined pointer)
     kEventTypeDllkCycleFinish       = 0x1A,     ///< SoA sent, cycle finished (arg is pointer to nothing)
+    kEventTypeDllkPresFill          = 0x1B,     ///< DLL kernel late PRes fill event (arg is pointer to nothing)
     kEventTypePdokAlloc             = 0x20,     ///< alloc PDOs (arg is pointer to tPdoAllocationParam)
     kEventTypePdokConfig            = 0x21,     ///< configure PDO channel (arg is pointer to tPdoChannelConf)
     kEventTypeNmtMnuNodeCmd         = 0x22,     ///< trigger NMT node command (arg is pointer to tNmtNodeCommand)
@@ -99,6 +100,12 @@ typedef enum
     kEventTypePdokControlSync       = 0x26,     ///< enable/disable the pdokcal sync trigger (arg is pointer to BOOL)
     kEventTypeReleaseRxFrame        = 0x27,     ///< Free receive buffer (arg is pointer to the buffer to release)
     kEventTypeAsndNotRx             = 0x28,     ///< Didn't receive ASnd frame for DLL user module (arg is pointer to tDllAsndNotRx)
+    kEventTypeDllkServLimit         = 0x29,     ///< configure ASnd forwarding limits (arg is pointer to tDllCalAsndServiceIdLimit)
+    kEventTypePdokAddRoute          = 0x2A,     ///< add RPDO to TPDO route (arg is pointer to tPdoRoute)
+    kEventTypePdokClearRoutes       = 0x2B,     ///< remove all RPDO to TPDO routes (arg is pointer to nothing)
+    kEventTypeSdoObdAccessDone      = 0x2C,     ///< deferred OD access of the SDO server finished (arg is pointer to tSdoComObdAccess)
+    kEventTypePdokSetupKernelPi     = 0x2D,     ///< set up the kernel process images (arg is pointer to tPdoKernelPiSetup)
+    kEventTypeNmtMnuLinkUp          = 0x2E,     ///< link of the MN came up (arg is pointer to nothing)
 } tEventType;
 
 /**
@@ -121,6 +128,7 @@ typedef enum
     kEventSinkNmtMnu                = 0x0A,     ///< events for NmtMnu module
     kEventSinkLedu                  = 0x0B,     ///< events for Ledu module
     kEventSinkPdokCal               = 0x0C,     ///< events for PdokCal module
+    kEventSinkSdoCom                = 0x0D,     ///< events for SDO command layer module
     kEventSinkGw309Ascii            = 0x0E,     ///< events for GW309ASCII module
     kEventSinkApi                   = 0x0F,     ///< events for API module
 
@@ -246,6 +254,36 @@ typedef struct
 */
 typedef tOplkError (*tSyncCb)(void);
 
+/**
+\brief Sync event information
+
+The structure describes the sync events which were signaled since the last
+time the information was read.
+*/
+typedef struct
+{
+    UINT64                  cycleCount;     ///< Number of sync events since the stack was initialized
+    UINT64                  timeStamp;      ///< CLOCK_MONOTONIC time of the last sync event in ns
+    UINT32                  missedCycles;   ///< Number of sync events which were not handled since the last read
+} tSyncInfo;
+
+/**
+\brief SoC time information
+
+The structure describes the time of the last SoC frame. The local time is taken
+with target_getCurrentTimestamp() when the SoC is received (CN) or sent (MN).
+The offset is the filtered difference between the NetTime of the SoCs and the
+local time, the current NetTime is the current local time plus the offset.
+*/
+typedef struct
+{
+    tNetTime                netTime;        ///< NetTime of the SoC (zero if the MN doesn't provide it)
+    UINT64                  relativeTime;   ///< RelativeTime of the SoC in us
+    UINT64                  localTime;      ///< Local time of the SoC in ns
+    INT64                   netTimeOffset;  ///< Estimated offset of the NetTime to the local time in ns
+    UINT32                  socCount;       ///< Number of SoCs since the stack was initialized (0 = no SoC yet)
+} tSocTimeInfo;
+
 /**
 \brief Callback for event post
 
@@ -296,5 +334,35 @@ SHB)
 */
 typedef void* tEventQueueInstPtr;
 
+/**
+\brief  Event batch statistics
+
+The structure contains the statistics of the batched event processing of an
+event handler thread. A batch contains all events which are processed after a
+single wakeup of the thread.
+*/
+typedef struct
+{
+    UINT32              batchCount;             ///< Number of processed batches
+    UINT32              eventCount;             ///< Number of processed events
+    UINT32              lastBatchSize;          ///< Number of events in the last batch
+    UINT32              maxBatchSize;           ///< Maximum number of events in a batch
+    UINT32              budgetExceededCount;    ///< Number of batches stopped by the event or time budget
+    UINT32              lastBatchTime;          ///< Processing time of the last batch in ns
+    UINT32              maxBatchTime;           ///< Maximum processing time of a batch in ns
+    UINT64              totalBatchTime;         ///< Total processing time of all batches in ns
+} tEventBatchStatistics;
+
+/**
+\brief  Event queue statistics
+
+The structure contains the maximum used size (high-water mark) of the event
+queues. The size of a queue which is not accessible by the user layer is 0.
+*/
+typedef struct
+{
+    UINT32              aMaxSize[kEventQueueNum];   ///< Maximum used size of the queues in bytes
+} tEventQueueStatistics;
+
 #endif /* _INC_oplk_event_H_ */
 
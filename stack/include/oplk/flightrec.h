@@ -0,0 +1,117 @@
+/**
+********************************************************************************
+\file   oplk/flightrec.h
+
+\brief  Definitions for the cycle flight recorder
+
+This file contains the definitions of the cycle flight recorder which can be
+read by the application with oplk_getFlightRecord().
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+#ifndef _INC_oplk_flightrec_H_
+#define _INC_oplk_flightrec_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+/// Number of bytes of a frame which are recorded
+#define FLIGHTREC_FRAME_HEADER_SIZE     64
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Recorded frame
+
+The structure contains the header of a frame which was transmitted or
+received by the DLL in a recorded cycle.
+*/
+typedef struct
+{
+    UINT32              timeOffset;                             ///< Time of the frame relative to the cycle start in ns
+    UINT16              frameSize;                              ///< Size of the frame in bytes
+    UINT8               fTx;                                    ///< TRUE if the frame was transmitted, FALSE if it was received
+    UINT8               reserved;                               ///< Reserved
+    BYTE                aHeader[FLIGHTREC_FRAME_HEADER_SIZE];   ///< First bytes of the frame, starting with the Ethernet header
+} tFlightRecFrame;
+
+/**
+\brief  Recorded cycle
+
+The structure contains the frames of a recorded cycle. A cycle starts with the
+transmission of the SoC on an MN or the reception of the SoC on a CN. Frames
+which exceed CONFIG_FLIGHT_RECORDER_FRAMES are only counted.
+*/
+typedef struct
+{
+    UINT32              cycleNumber;                            ///< Number of the cycle since the recorder was armed
+    ULONGLONG           startTime;                              ///< Timestamp of the cycle start in ns
+    UINT32              frameCount;                             ///< Number of recorded frames
+    UINT32              droppedCount;                           ///< Number of frames which were not recorded
+    tFlightRecFrame     aFrame[CONFIG_FLIGHT_RECORDER_FRAMES];  ///< Recorded frames
+} tFlightRecCycle;
+
+/**
+\brief  Flight record
+
+The structure contains the last cycles recorded by the flight recorder,
+starting with the oldest one. The recorder is frozen by the first DLL error
+which matches CONFIG_FLIGHT_RECORDER_TRIGGER, so the last cycle is the one in
+which the error was detected.
+*/
+typedef struct
+{
+    BOOL                fFrozen;                                ///< TRUE if the recorder was frozen by an error
+    UINT32              triggerErrors;                          ///< DLL error events which froze the recorder
+    UINT                triggerNodeId;                          ///< Node ID of the error which froze the recorder
+    ULONGLONG           triggerTime;                            ///< Timestamp of the error which froze the recorder in ns
+    UINT                cycleCount;                             ///< Number of valid entries in aCycle
+    tFlightRecCycle     aCycle[CONFIG_FLIGHT_RECORDER_CYCLES];  ///< Recorded cycles
+} tFlightRecord;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_oplk_flightrec_H_ */
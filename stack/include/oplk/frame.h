@@ -99,6 +99,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define SDO_CMDL_HDR_VAR_SIZE               4       // size of variable header part
 #define SDO_CMDL_HDR_WRITEBYINDEX_SIZE      4       // size of write by index header (index + subindex + reserved)
 #define SDO_CMDL_HDR_READBYINDEX_SIZE       4       // size of read by index header (index + subindex + reserved)
+#define SDO_CMDL_HDR_MULTI_SUBHDR_SIZE      8       // size of sub-block header of multiple parameter commands (offset + index + subindex + padding)
+#define SDO_CMDL_HDR_MULTI_READ_SIZE        4       // size of an entry of a read multiple parameter request (index + subindex + reserved)
+#define SDO_CMDL_HDR_MULTI_SUBABORT_SIZE    8       // size of an entry of a write multiple parameter response (index + subindex + flags + abort code)
 
 // defines for SDO command layer flags
 #define SDO_CMDL_FLAG_RESPONSE       0x80
@@ -109,6 +112,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define SDO_CMDL_FLAG_SEGMCOMPL      0x30
 #define SDO_CMDL_FLAG_SEGM_MASK      0x30
 
+// defines for the sub-blocks of multiple parameter commands
+#define SDO_CMDL_MULTI_FLAG_SUBABORT 0x80
+#define SDO_CMDL_MULTI_PADDING_MASK  0x03
+
 //------------------------------------------------------------------------------
 // typedef
 //------------------------------------------------------------------------------
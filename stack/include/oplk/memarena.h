@@ -0,0 +1,121 @@
+/**
+********************************************************************************
+\file   oplk/memarena.h
+
+\brief  Definitions for the memory arena module
+
+This file contains the definitions for the memory arena module. If
+CONFIG_MEMARENA is enabled, OPLK_MALLOC() and OPLK_FREE() are served from a
+single statically reserved region instead of the heap. The stack then never
+calls malloc() or free(), neither during oplk_init() nor afterwards. The module
+accounts the used memory per source module so that CONFIG_MEMARENA_SIZE can be
+sized for an application with memarena_getReport().
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+#ifndef _INC_oplk_memarena_H_
+#define _INC_oplk_memarena_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define MEMARENA_MODULE_NAME_LENGTH     24      ///< Maximum length of a module name in the report (incl. terminator)
+
+#if (CONFIG_MEMARENA != FALSE) && !defined(OPLK_MALLOC)
+#define OPLK_MALLOC(siz)                memarena_alloc((siz), __FILE__)
+#define OPLK_FREE(ptr)                  memarena_free(ptr)
+#endif
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Memory usage of a module
+
+The structure describes the arena memory used by one source module. The byte
+counts include the block headers and the rounding to the size classes, i.e.
+they show what the module really consumes of the arena.
+*/
+typedef struct
+{
+    char                aName[MEMARENA_MODULE_NAME_LENGTH];    ///< File name of the module
+    size_t              usedBytes;                              ///< Bytes currently allocated
+    size_t              peakBytes;                              ///< Maximum of usedBytes
+    UINT32              allocCount;                             ///< Number of allocations
+    UINT32              freeCount;                              ///< Number of frees
+    UINT32              lateAllocCount;                         ///< Number of allocations after oplk_init() returned
+} tMemArenaModuleReport;
+
+/**
+\brief  Memory arena report
+
+The structure describes the usage of the memory arena. carvedBytes is the part
+of the arena which has been split into blocks so far. Freed blocks are kept in
+the free list of their size class and are reused, so carvedBytes only grows
+until the application reaches its steady state. If more modules allocate than
+the table can hold, the remaining ones are accounted to a last entry named
+"(other)".
+*/
+typedef struct
+{
+    size_t                  arenaSize;                              ///< Size of the arena (CONFIG_MEMARENA_SIZE)
+    size_t                  carvedBytes;                            ///< Bytes of the arena split into blocks
+    size_t                  usedBytes;                              ///< Bytes currently allocated
+    size_t                  peakBytes;                              ///< Maximum of usedBytes
+    UINT32                  failedCount;                            ///< Number of allocations which could not be served
+    UINT32                  moduleCount;                            ///< Number of valid entries in aModule
+    tMemArenaModuleReport   aModule[CONFIG_MEMARENA_MODULE_COUNT];  ///< Per module usage
+} tMemArenaReport;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (CONFIG_MEMARENA != FALSE)
+
+void*      memarena_alloc(size_t size_p, const char* pModule_p);
+void       memarena_free(void* pMem_p);
+void       memarena_setInitDone(void);
+tOplkError memarena_getReport(tMemArenaReport* pReport_p);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_oplk_memarena_H_ */
@@ -0,0 +1,132 @@
+/**
+********************************************************************************
+\file   oplk/metrics.h
+
+\brief  Definitions of the metrics registry
+
+The file contains the public definitions of the metrics registry. The metrics
+memory is also the layout of the shared memory which is read by external
+collectors.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+#ifndef _INC_oplk_metrics_H_
+#define _INC_oplk_metrics_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+#define METRICS_MEMORY_MAGIC            0x4B4C504D      ///< "MPLK", identifies the metrics memory
+#define METRICS_MEMORY_VERSION          1               ///< Version of the layout of the metrics memory
+#define METRICS_NAME_LENGTH             32              ///< Maximum length of a metric name including the terminating zero
+#define METRICS_HISTOGRAM_BUCKETS       16              ///< Number of buckets of a histogram
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Metric types
+
+The enumeration lists the types of the metrics.
+*/
+typedef enum
+{
+    kMetricTypeCounter          = 1,    ///< Monotonic counter
+    kMetricTypeGauge            = 2,    ///< Value which is set to the current state
+    kMetricTypeHistogram        = 3,    ///< Distribution of observed values
+} eMetricType;
+
+/**
+\brief  Metric type data type
+
+Data type of the enumerator \ref eMetricType.
+*/
+typedef UINT32 tMetricType;
+
+/**
+\brief  Metric
+
+The structure contains a registered metric. The value of a counter or a gauge
+is stored in \ref value. A histogram counts the observed values in
+power-of-two buckets: bucket 0 counts the value 0, bucket n counts the values
+from 2^(n-1) to 2^n - 1 and the last bucket also counts all larger values.
+
+A metric is updated by a single context of the stack, so readers see
+monotonic values but may read a torn 64 bit value on 32 bit targets. Readers
+should repeat a read if two consecutive reads of a value differ.
+*/
+typedef struct
+{
+    char                name[METRICS_NAME_LENGTH];              ///< Name of the metric, e.g. "dllkcal.asnd_rx_frames"
+    tMetricType         type;                                   ///< Type of the metric
+    UINT32              reserved;                               ///< Reserved
+    UINT64              value;                                  ///< Counter or gauge value, number of observations of a histogram
+    UINT64              sum;                                    ///< Sum of the observed values of a histogram
+    UINT32              aBucket[METRICS_HISTOGRAM_BUCKETS];     ///< Buckets of a histogram
+} tMetric;
+
+/**
+\brief  Metrics memory
+
+The structure contains all registered metrics. On Linux userspace builds it is
+the shared memory "/shmMetrics", which is created by the stack and can be
+mapped read-only by collectors. A collector checks \ref magic, \ref version
+and \ref metricSize and reads the first \ref metricCount entries. Entries are
+never removed or moved while the memory exists.
+*/
+typedef struct
+{
+    UINT32              magic;                                  ///< METRICS_MEMORY_MAGIC
+    UINT32              version;                                ///< METRICS_MEMORY_VERSION
+    UINT32              metricSize;                             ///< Size of a metric entry
+    UINT32              maxMetricCount;                         ///< Number of metric entries
+    volatile UINT32     metricCount;                            ///< Number of registered metrics
+    UINT32              reserved;                               ///< Reserved
+    tMetric             aMetric[CONFIG_METRICS_COUNT];          ///< Registered metrics
+} tMetricsMemory;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_oplk_metrics_H_ */
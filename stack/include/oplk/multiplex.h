@@ -0,0 +1,90 @@
+/**
+********************************************************************************
+\file   oplk/multiplex.h
+
+\brief  Definitions for the multiplexed cycle report
+
+This file contains the definitions of the multiplexed cycle report which can be
+read by the application with oplk_getMultiplexReport().
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_oplk_multiplex_H_
+#define _INC_oplk_multiplex_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+/// Maximum number of multiplexed cycles (0x1F98.7: MultiplCycleCnt_U8)
+#define MULTIPLEX_MAX_CYCLE_COUNT       255
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Multiplexed cycle report
+
+The structure describes the multiplexed cycle assignment (object 0x1F9B) which
+is computed by the MN at NMT_ResetConfiguration. All times are in nanoseconds
+and account for the PReq and PRes frames and the PRes latency of the CNs.
+Continuous CNs are polled in every cycle, each multiplexed CN is polled once
+per multiplexed cycle in its assigned cycle.
+*/
+typedef struct
+{
+    BOOL                fValid;                                         ///< The multiplexed cycle assignment was computed
+    UINT                multiplCycleCnt;                                ///< Number of multiplexed cycles, 0 if multiplexing is inactive
+    UINT                continuousNodeCount;                            ///< Number of continuous CNs
+    UINT                multiplexedNodeCount;                           ///< Number of multiplexed CNs
+    UINT32              continuousTimeNs;                               ///< Isochronous time of the continuous CNs
+    UINT32              isochrPhaseNs;                                  ///< Longest isochronous phase of all multiplexed cycles
+    UINT32              aCycleTimeNs[MULTIPLEX_MAX_CYCLE_COUNT];        ///< Isochronous time of the multiplexed CNs per multiplexed cycle
+    UINT8               aCycleNodeCount[MULTIPLEX_MAX_CYCLE_COUNT];     ///< Number of multiplexed CNs per multiplexed cycle
+} tMultiplexReport;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_oplk_multiplex_H_ */
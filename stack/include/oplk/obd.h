@@ -294,12 +294,78 @@ typedef struct
     void MEM*           pData;
 } tVarParam;
 
+/**
+\brief Entry information
+
+The structure contains the information about an entry which is returned by
+obd_getEntryInfo().
+*/
+typedef struct
+{
+    tObdType            type;               ///< Data type of the entry
+    tObdAccess          access;             ///< Access type of the entry
+    tObdSize            dataSize;           ///< Current data size of the entry
+    BOOL                fNumerical;         ///< TRUE if the entry is numerical
+    void*               pData;              ///< Pointer to the current data of the entry
+} tObdEntryInfo;
+
 typedef struct
 {
     void MEM*           pData;
     tObdSize            size;
 } tObdVarEntry;
 
+/**
+\brief Domain stream operations
+
+The enumeration lists the operations of a domain stream callback function.
+*/
+typedef enum
+{
+    kObdDomainStreamOpen    = 0x00,         ///< A transfer starts, the size is the size of the transfer
+    kObdDomainStreamRead    = 0x01,         ///< Read data at the offset
+    kObdDomainStreamWrite   = 0x02,         ///< Write data at the offset
+    kObdDomainStreamClose   = 0x03,         ///< The transfer is finished, the offset is the number of transferred bytes
+    kObdDomainStreamAbort   = 0x04          ///< The transfer was aborted, the offset is the number of transferred bytes
+} tObdDomainStreamOp;
+
+/**
+\brief Domain stream callback function
+
+The callback function accesses the data of a domain stream. The data of a read
+is copied directly into the frame, the data of a write is taken directly from
+the frame.
+
+\param  pArg_p          Argument of the stream.
+\param  op_p            Operation to execute.
+\param  offset_p        Offset of the data in the domain.
+\param  pData_p         Pointer to the data to read or write (NULL for the
+                        other operations).
+\param  size_p          Size of the data to read or write, or the size of the
+                        transfer for \ref kObdDomainStreamOpen.
+
+\return The function returns a tOplkError error code.
+*/
+typedef tOplkError (*tObdDomainStreamCb)(void* pArg_p, tObdDomainStreamOp op_p, UINT32 offset_p,
+                                         void* pData_p, UINT size_p);
+
+/**
+\brief Domain stream
+
+The structure describes a stream which provides the data of a large domain
+object (e.g. a firmware image) instead of a memory buffer. The data is read
+and written segment by segment with the offset of the segment, so the domain
+never has to be held in memory. The structure must stay valid as long as the
+stream is used.
+*/
+typedef struct
+{
+    tObdDomainStreamCb  pfnAccess;          ///< Callback function which accesses the data
+    void*               pArg;               ///< Argument of the callback function
+    UINT32              size;               ///< Current size of the data, must be updated by the callback when a write is closed
+    UINT32              maxSize;            ///< Maximum size of the data which is accepted by a write
+} tObdDomainStream;
+
 /// C type definition for DS301 data type \ref kObdTypeOString
 typedef struct
 {
@@ -320,6 +386,8 @@ typedef struct
 {
    tObdSize             size;
    char*                pString;
+   tObdSize             length;             ///< Cached length of the string, managed by the OD
+   UINT8                lengthState;        ///< State of the cached length, managed by the OD
 } tObdVString;                              // 000A
 
 typedef struct
@@ -418,8 +486,37 @@ typedef struct
     tObdPart            currentOdPart;
     void MEM*           pData;
     tObdSize            objSize;
+    UINT                index;              ///< Index of the object of kObdCmdWriteObj/kObdCmdReadObj
+    UINT                subIndex;           ///< Sub-index of the object of kObdCmdWriteObj/kObdCmdReadObj
 } tObdCbStoreParam;
 
+/**
+\brief Resolved entry
+
+The structure references an OD entry which was looked up by obd_resolveEntry().
+It is used to access the entry repeatedly without searching the OD.
+*/
+typedef struct
+{
+    tObdEntryPtr        pObdEntry;          ///< Pointer to the object entry (NULL if not resolved)
+    tObdSubEntryPtr     pSubEntry;          ///< Pointer to the sub-index entry
+    UINT                subIndex;           ///< Sub-index of the entry
+} tObdEntryRef;
+
+/**
+\brief Segmented write
+
+The structure describes a write of an OD entry whose data is copied into the
+object in several parts, e.g. by the segments of an SDO download. It is set up
+by obd_beginSegmentedWrite() and completed by obd_finishSegmentedWrite().
+*/
+typedef struct
+{
+    tObdEntryRef        entryRef;           ///< Written entry
+    void*               pData;              ///< Object data the parts are copied to
+    tObdSize            size;               ///< Size of the whole write
+} tObdSegmentedWrite;
+
 typedef tOplkError (ROM *tInitTabEntryCallback)(void MEM* pTabEntry_p, UINT uiObjIndex_p);
 typedef tOplkError (ROM *tObdStoreLoadCallback)(tObdCbStoreParam MEM* pCbStoreParam_p);
 
@@ -447,8 +544,16 @@ tOplkError obd_init(tObdInitParam MEM* pInitParam_p);
 tOplkError obd_deleteInstance(void);
 tOplkError obd_writeEntry(UINT index_p, UINT subIndex_p, void* pSrcData_p, tObdSize size_p);
 tOplkError obd_readEntry(UINT index_p, UINT subIndex_p, void* pDstData_p, tObdSize* pSize_p);
+tOplkError obd_resolveEntry(UINT index_p, UINT subIndex_p, tObdEntryRef* pEntryRef_p);
+tOplkError obd_readResolvedEntry(tObdEntryRef* pEntryRef_p, void* pDstData_p, tObdSize* pSize_p);
+tOplkError obd_writeResolvedEntry(tObdEntryRef* pEntryRef_p, void* pSrcData_p, tObdSize size_p);
+tOplkError obd_beginSegmentedWrite(UINT index_p, UINT subIndex_p, tObdSize size_p,
+                                   tObdSegmentedWrite* pWrite_p);
+tOplkError obd_finishSegmentedWrite(tObdSegmentedWrite* pWrite_p, tObdSize size_p);
 tOplkError obd_accessOdPart(tObdPart obdPart_p, tObdDir direction_p);
 tOplkError obd_defineVar(tVarParam MEM* pVarParam_p);
+tOplkError obd_defineVarRange(UINT index_p, UINT firstSubindex_p, UINT subindexCount_p,
+                              tObdSize entrySize_p, void MEM* pData_p);
 void*      obd_getObjectDataPtr(UINT index_p, UINT subIndex_p);
 tOplkError obd_registerUserOd(tObdEntryPtr pUserOd_p);
 void       obd_initVarEntry(tObdVarEntry MEM* pVarEntry_p, tObdType type_p, tObdSize obdSize_p);
@@ -457,10 +562,15 @@ UINT       obd_getNodeId(void);
 tOplkError obd_setNodeId(UINT nodeId_p, tObdNodeIdType nodeIdType_p);
 tOplkError obd_isNumerical(UINT index_p, UINT subIndex_p, BOOL* pfEntryNumerical_p);
 tOplkError obd_getType(UINT index_p, UINT subIndex_p, tObdType* pType_p);
+tOplkError obd_getEntryInfo(UINT index_p, UINT subIndex_p, tObdEntryInfo* pEntryInfo_p);
 tOplkError obd_writeEntryFromLe(UINT index_p, UINT subIndex_p, void* pSrcData_p, tObdSize size_p);
 tOplkError obd_readEntryToLe(UINT index_p, UINT subIndex_p, void* pDstData_p, tObdSize* pSize_p);
 tOplkError obd_getAccessType(UINT index_p, UINT subIndex_p, tObdAccess* pAccessType_p);
+tOplkError obd_hasCallback(UINT index_p, BOOL* pfCallback_p);
 tOplkError obd_searchVarEntry(UINT index_p, UINT subindex_p, tObdVarEntry MEM** ppVarEntry_p);
+tOplkError obd_setDomainStream(UINT index_p, UINT subIndex_p, tObdDomainStream* pStream_p);
+tObdDomainStream* obd_getDomainStream(UINT index_p, UINT subIndex_p);
+void       obd_releaseDomainStream(tObdDomainStream* pStream_p);
 
 tOplkError obd_initObd(tObdInitParam MEM* pInitParam_p);
 
@@ -64,6 +64,8 @@ void obdcdc_exit(void);
 void obdcdc_setFilename(char* pCdcFilename_p);
 void obdcdc_setBuffer(UINT8* pCdc_p, size_t cdcSize_p);
 tOplkError obdcdc_loadCdc(void);
+tOplkError obdcdc_getSharedConfig(UINT nodeId_p, UINT8** ppBaseDcf_p, UINT32* pBaseSize_p,
+                                  UINT8** ppNodeDcf_p);
 
 #ifdef __cplusplus
 }
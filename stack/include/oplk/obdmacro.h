@@ -177,7 +177,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define OBD_END_PART()
 
 // index macros
-#define OBD_BEGIN_INDEX_RAM(ind, cnt, call)                                     static tObdSubEntry MEM aObdSubEntry##ind##Ram_g[cnt]= {
+#define OBD_BEGIN_INDEX_RAM(ind, cnt, call)                                     static OBD_TABLE_CONST tObdSubEntry OBD_TABLE_MEM aObdSubEntry##ind##Ram_g[cnt]= {
 #define OBD_END_INDEX(ind)                                                      OBD_END_SUBINDEX()};
 #define OBD_RAM_INDEX_RAM_ARRAY(ind, cnt, call, typ, acc, dtyp, name, def)      static tObdSubEntry MEM aObdSubEntry##ind##Ram_g[]= { \
                                                                                 {0, kObdTypeUInt8, kObdAccCR,                        &xDef##ind##_0x00_g, NULL}, \
@@ -222,9 +222,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define OBD_END()
 
 // partition macros
-#define OBD_BEGIN_PART_GENERIC()                                                static  tObdEntry  aObdTabGeneric_g[]      = {
-#define OBD_BEGIN_PART_MANUFACTURER()                                           static  tObdEntry  aObdTabManufacturer_g[] = {
-#define OBD_BEGIN_PART_DEVICE()                                                 static  tObdEntry  aObdTabDevice_g[]       = {
+#define OBD_BEGIN_PART_GENERIC()                                                static OBD_TABLE_CONST tObdEntry OBD_TABLE_MEM aObdTabGeneric_g[]      = {
+#define OBD_BEGIN_PART_MANUFACTURER()                                           static OBD_TABLE_CONST tObdEntry OBD_TABLE_MEM aObdTabManufacturer_g[] = {
+#define OBD_BEGIN_PART_DEVICE()                                                 static OBD_TABLE_CONST tObdEntry OBD_TABLE_MEM aObdTabDevice_g[]       = {
 #define OBD_END_PART()                                                          {OBD_TABLE_INDEX_END, (tObdSubEntryPtr)(void*)&dwObd_OBK_g, 0, NULL}};
 
 // index macros
@@ -257,9 +257,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define OBD_END()
 
 // partition macros
-#define OBD_BEGIN_PART_GENERIC()                                                pInitParam->pGenericPart      = (tObdEntryPtr)&aObdTabGeneric_g[0];
-#define OBD_BEGIN_PART_MANUFACTURER()                                           pInitParam->pManufacturerPart = (tObdEntryPtr)&aObdTabManufacturer_g[0];
-#define OBD_BEGIN_PART_DEVICE()                                                 pInitParam->pDevicePart       = (tObdEntryPtr)&aObdTabDevice_g[0];
+#define OBD_BEGIN_PART_GENERIC()                                                pInitParam->pGenericPart      = (tObdEntryPtr)&aObdTabGeneric_g[0]; \
+                                                                                pInitParam->numGeneric        = OBD_TABLE_INDEX_NUM(aObdTabGeneric_g);
+#define OBD_BEGIN_PART_MANUFACTURER()                                           pInitParam->pManufacturerPart = (tObdEntryPtr)&aObdTabManufacturer_g[0]; \
+                                                                                pInitParam->numManufacturer   = OBD_TABLE_INDEX_NUM(aObdTabManufacturer_g);
+#define OBD_BEGIN_PART_DEVICE()                                                 pInitParam->pDevicePart       = (tObdEntryPtr)&aObdTabDevice_g[0]; \
+                                                                                pInitParam->numDevice         = OBD_TABLE_INDEX_NUM(aObdTabDevice_g);
 #define OBD_END_PART()
 
 // index macros
@@ -48,6 +48,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/led.h>
 #include <oplk/cfm.h>
 #include <oplk/event.h>
+#include <oplk/cyclestat.h>
+#include <oplk/syncservo.h>
+#include <oplk/multiplex.h>
+#include <oplk/flightrec.h>
+#include <oplk/metrics.h>
 
 //------------------------------------------------------------------------------
 // const defines
@@ -331,6 +336,11 @@ typedef struct
     UINT32              syncResLatency;             ///< Constant response latency for SyncRes in ns
     UINT                syncNodeId;                 ///< Specifies the synchronization point for the MN. The synchronization take place after a PRes from a CN with this node-ID (0 = SoC, 255 = SoA)
     BOOL                fSyncOnPrcNode;             ///< If it is TRUE, Sync on PRes chained CN; FALSE: conventional CN (PReq/PRes)
+    tThreadParam        aThreadParam[kThreadRoleCount]; ///< Placement of the stack threads, indexed by \ref tThreadRole
+                                                    /**< The parameters are applied to all threads which are created in the
+                                                         application process on Linux. Threads of a separate driver (kernel
+                                                         module or driver daemon) keep their compile-time placement
+                                                         (CONFIG_THREAD_CPU_MASK_xxx). */
 } tOplkApiInitParam;
 
 /**
@@ -344,6 +354,78 @@ typedef struct
     UINT           imageSize;                       ///< Size of the process image
 } tOplkApiProcessImage;
 
+/**
+\brief  SDO request structure
+
+This structure describes an SDO transfer which is posted with
+oplk_postSdoRequests(). The structure and the data buffer must stay valid
+until the completion of the request is fetched with oplk_getSdoCompletions().
+*/
+typedef struct
+{
+    UINT                nodeId;                     ///< Node ID of the node to access (0 = local OD)
+    UINT                index;                      ///< Index of the object to access
+    UINT                subindex;                   ///< Subindex of the object to access
+    tSdoAccessType      accessType;                 ///< Read or write access
+    tSdoType            sdoType;                    ///< The type of the SDO transfer (SDO over ASnd or SDO over UDP)
+    void*               pData;                      ///< Pointer to the data buffer. The data is in little endian byte order.
+    UINT                size;                       ///< Size of the data buffer (read) or of the data to write (write)
+    void*               pUserArg;                   ///< User defined argument
+} tOplkApiSdoRequest;
+
+/**
+\brief  SDO completion structure
+
+This structure describes the result of an SDO request which was posted with
+oplk_postSdoRequests().
+*/
+typedef struct
+{
+    tOplkApiSdoRequest* pRequest;                   ///< Pointer to the completed request
+    tOplkError          errorCode;                  ///< Error which prevented the transfer (kErrorOk if the transfer was performed)
+    tSdoComConState     sdoComConState;             ///< State of the finished transfer (kSdoComTransferFinished on success)
+    UINT32              abortCode;                  ///< SDO abort code
+    UINT                transferredBytes;           ///< Number of transferred bytes
+} tOplkApiSdoCompletion;
+
+/**
+\brief  Local object access structure
+
+This structure describes an access to an object of the local OD by
+oplk_readLocalObjects() or oplk_writeLocalObjects(). The list of accesses is
+prepared once with oplk_prepareLocalObjects() which looks up the objects.
+*/
+typedef struct
+{
+    UINT                index;                      ///< Index of the object
+    UINT                subindex;                   ///< Subindex of the object
+    void*               pData;                      ///< Pointer to the data buffer. The data is in platform byte order.
+    UINT                size;                       ///< Size of the data buffer (read, returns the size of the read data) or of the data to write (write)
+    tOplkError          errorCode;                  ///< Result of the last access
+    tObdEntryRef        entryRef;                   ///< Looked up object, set by oplk_prepareLocalObjects()
+} tOplkApiLocalObject;
+
+/**
+\brief  Start-up timing structure
+
+This structure contains the duration of the start-up phases of the stack which
+can be read with oplk_getStartupTiming(). All times are in microseconds. The
+phases of the NMT reset states are recorded until the node reaches
+PreOperational2 for the first time.
+*/
+typedef struct
+{
+    UINT32              odInitUs;                   ///< Initialization of the OD module
+    UINT32              kernelInitUs;               ///< Initialization of the kernel stack
+    UINT32              userInitUs;                 ///< Initialization of the remaining user modules
+    UINT32              resetApplicationUs;         ///< NMT_ResetApplication, loading of the application part of the OD
+    UINT32              resetCommunicationUs;       ///< NMT_ResetCommunication, loading of the communication part of the OD and the CDC
+    UINT32              cdcLoadUs;                  ///< Loading of the CDC (part of resetCommunicationUs)
+    UINT32              resetConfigurationUs;       ///< NMT_ResetConfiguration, configuration of the DLL and SDO
+    UINT32              preOp1Us;                   ///< Time from the stack initialization to PreOperational1
+    UINT32              preOp2Us;                   ///< Time from the stack initialization to PreOperational2 (first SoC)
+} tOplkApiStartupTiming;
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
@@ -363,20 +445,63 @@ OPLKDLLEXPORT tOplkError oplk_readObject(tSdoComConHdl* pSdoComConHdl_p, UINT no
 OPLKDLLEXPORT tOplkError oplk_writeObject(tSdoComConHdl* pSdoComConHdl_p, UINT nodeId_p, UINT index_p,
                                           UINT subindex_p, void* pSrcData_le_p, UINT size_p,
                                           tSdoType sdoType_p, void* pUserArg_p);
+OPLKDLLEXPORT tOplkError oplk_readObjectToStream(tSdoComConHdl* pSdoComConHdl_p, UINT nodeId_p, UINT index_p,
+                                                 UINT subindex_p, tObdDomainStream* pStream_p,
+                                                 tSdoType sdoType_p, void* pUserArg_p);
+OPLKDLLEXPORT tOplkError oplk_writeObjectFromStream(tSdoComConHdl* pSdoComConHdl_p, UINT nodeId_p, UINT index_p,
+                                                    UINT subindex_p, tObdDomainStream* pStream_p,
+                                                    tSdoType sdoType_p, void* pUserArg_p);
+OPLKDLLEXPORT tOplkError oplk_readObjectToScatterList(tSdoComConHdl* pSdoComConHdl_p, UINT nodeId_p, UINT index_p,
+                                                      UINT subindex_p, tSdoScatterEntry* aEntry_p, UINT entryCount_p,
+                                                      tSdoType sdoType_p, void* pUserArg_p);
 OPLKDLLEXPORT tOplkError oplk_freeSdoChannel(tSdoComConHdl sdoComConHdl_p);
 OPLKDLLEXPORT tOplkError oplk_abortSdo(tSdoComConHdl sdoComConHdl_p, UINT32 abortCode_p);
 OPLKDLLEXPORT tOplkError oplk_readLocalObject(UINT index_p, UINT subindex_p, void* pDstData_p, UINT* pSize_p);
 OPLKDLLEXPORT tOplkError oplk_writeLocalObject(UINT index_p, UINT subindex_p, void* pSrcData_p, UINT size_p);
+OPLKDLLEXPORT tOplkError oplk_prepareLocalObjects(tOplkApiLocalObject* aObject_p, UINT objectCount_p);
+OPLKDLLEXPORT tOplkError oplk_readLocalObjects(tOplkApiLocalObject* aObject_p, UINT objectCount_p);
+OPLKDLLEXPORT tOplkError oplk_writeLocalObjects(tOplkApiLocalObject* aObject_p, UINT objectCount_p);
 OPLKDLLEXPORT tOplkError oplk_sendAsndFrame(UINT8 dstNodeId_p, tAsndFrame* pAsndFrame_p, size_t asndSize_p);
+OPLKDLLEXPORT tOplkError oplk_allocAsndFrame(size_t asndSize_p, tAsndFrame** ppAsndFrame_p);
+OPLKDLLEXPORT tOplkError oplk_sendAllocatedAsndFrame(UINT8 dstNodeId_p, tAsndFrame* pAsndFrame_p, size_t asndSize_p);
 OPLKDLLEXPORT tOplkError oplk_setAsndForward(UINT8 serviceId_p, tOplkApiAsndFilter FilterType_p);
+OPLKDLLEXPORT tOplkError oplk_setAsndForwardLimit(UINT8 serviceId_p, UINT maxFramesPerSec_p,
+                                                  BOOL fForwardChangedOnly_p);
 OPLKDLLEXPORT tOplkError oplk_postUserEvent(void* pUserArg_p);
 OPLKDLLEXPORT tOplkError oplk_triggerMnStateChange(UINT nodeId_p, tNmtNodeCommand nodeCommand_p);
 OPLKDLLEXPORT tOplkError oplk_setCdcBuffer(BYTE* pbCdc_p, UINT cdcSize_p);
 OPLKDLLEXPORT tOplkError oplk_setCdcFilename(char* pszCdcFilename_p);
+OPLKDLLEXPORT tOplkError oplk_setStoreFilename(char* pszStoreFilename_p);
+OPLKDLLEXPORT tOplkError oplk_setDomainStream(UINT index_p, UINT subindex_p, tObdDomainStream* pStream_p);
+OPLKDLLEXPORT tOplkError oplk_openDomainFile(UINT index_p, UINT subindex_p, const char* pFilename_p,
+                                             UINT32 maxSize_p, tObdDomainStream** ppStream_p);
+OPLKDLLEXPORT tOplkError oplk_closeDomainFile(tObdDomainStream* pStream_p);
 OPLKDLLEXPORT tOplkError oplk_process(void);
+OPLKDLLEXPORT tOplkError oplk_waitAndProcess(UINT32 timeoutMs_p);
+OPLKDLLEXPORT int        oplk_getWaitHandle(void);
 OPLKDLLEXPORT tOplkError oplk_getIdentResponse(UINT nodeId_p, tIdentResponse** ppIdentResponse_p);
 OPLKDLLEXPORT BOOL       oplk_checkKernelStack(void);
 OPLKDLLEXPORT tOplkError oplk_waitSyncEvent(ULONG timeout_p);
+OPLKDLLEXPORT int        oplk_getSyncFd(void);
+OPLKDLLEXPORT tOplkError oplk_getSyncInfo(tSyncInfo* pSyncInfo_p);
+OPLKDLLEXPORT tOplkError oplk_getSocTimeInfo(tSocTimeInfo* pSocTimeInfo_p);
+OPLKDLLEXPORT tOplkError oplk_getNetTime(tNetTime* pNetTime_p);
+OPLKDLLEXPORT tOplkError oplk_getCycleStatistics(tCycleStatistics* pStatistics_p);
+OPLKDLLEXPORT tOplkError oplk_setSyncBudget(UINT32 budget_p, BOOL fSkipLateTxPdo_p);
+OPLKDLLEXPORT tOplkError oplk_getSyncBudgetStatistics(tCycleStatSyncBudget* pSyncBudget_p);
+OPLKDLLEXPORT tOplkError oplk_getMultiplexReport(tMultiplexReport* pReport_p);
+OPLKDLLEXPORT tOplkError oplk_getFlightRecord(tFlightRecord* pRecord_p);
+OPLKDLLEXPORT tOplkError oplk_rearmFlightRecorder(void);
+OPLKDLLEXPORT tOplkError oplk_getMetrics(tMetricsMemory* pMetrics_p);
+OPLKDLLEXPORT tOplkError oplk_getStartupTiming(tOplkApiStartupTiming* pTiming_p);
+OPLKDLLEXPORT tOplkError oplk_getSyncStatistics(tSyncServoStatistics* pStatistics_p);
+OPLKDLLEXPORT tOplkError oplk_getEventQueueStatistics(tEventQueueStatistics* pStatistics_p);
+
+// SDO batch API functions
+OPLKDLLEXPORT tOplkError oplk_postSdoRequests(tOplkApiSdoRequest* aRequest_p, UINT requestCount_p);
+OPLKDLLEXPORT tOplkError oplk_getSdoCompletions(tOplkApiSdoCompletion* aCompletion_p, UINT maxCount_p,
+                                                UINT* pCount_p);
+OPLKDLLEXPORT tOplkError oplk_setSdoBatchConcurrency(UINT maxConnections_p);
 
 // Process image API functions
 OPLKDLLEXPORT tOplkError oplk_allocProcessImage(UINT sizeProcessImageIn_p, UINT sizeProcessImageOut_p);
@@ -385,8 +510,24 @@ OPLKDLLEXPORT tOplkError oplk_linkProcessImageObject(UINT objIndex_p, UINT first
                                                      BOOL fOutputPI_p, tObdSize entrySize_p, UINT* pVarEntries_p);
 OPLKDLLEXPORT tOplkError oplk_exchangeProcessImageIn(void);
 OPLKDLLEXPORT tOplkError oplk_exchangeProcessImageOut(void);
+OPLKDLLEXPORT tOplkError oplk_exchangeProcessImageInNodes(const UINT8* pNodeBitmap_p, UINT bitmapSize_p);
+OPLKDLLEXPORT tOplkError oplk_exchangeProcessImageOutNodes(const UINT8* pNodeBitmap_p, UINT bitmapSize_p);
 OPLKDLLEXPORT void*      oplk_getProcessImageIn(void);
 OPLKDLLEXPORT void*      oplk_getProcessImageOut(void);
+OPLKDLLEXPORT tOplkError oplk_setProcessImageZeroCopy(BOOL fEnable_p);
+OPLKDLLEXPORT tOplkError oplk_setProcessImageKernelAssembly(BOOL fEnable_p);
+OPLKDLLEXPORT tOplkError oplk_enableProcessImageInDirtyTracking(BOOL fEnable_p);
+OPLKDLLEXPORT tOplkError oplk_markProcessImageInDirty(UINT offset_p, UINT size_p);
+OPLKDLLEXPORT tOplkError oplk_getProcessImageOutUpdates(UINT8* pNodeBitmap_p, UINT bitmapSize_p);
+OPLKDLLEXPORT tOplkError oplk_getProcessImageOutSequence(UINT nodeId_p, UINT32* pSequence_p);
+OPLKDLLEXPORT tOplkError oplk_enableProcessImageInSnapshot(BOOL fEnable_p);
+OPLKDLLEXPORT tOplkError oplk_getProcessImageInSnapshot(void* pDest_p, UINT offset_p, UINT size_p);
+OPLKDLLEXPORT tOplkError oplk_getProcessImageOutSnapshot(void* pDest_p, UINT offset_p, UINT size_p);
+
+// PDO routing API functions
+OPLKDLLEXPORT tOplkError oplk_addPdoRoute(UINT rxMappParamIndex_p, UINT rxOffset_p, UINT size_p,
+                                          UINT txMappParamIndex_p, UINT txOffset_p);
+OPLKDLLEXPORT tOplkError oplk_clearPdoRoutes(void);
 
 // objdict specific process image functions
 OPLKDLLEXPORT tOplkError oplk_setupProcessImage(void);
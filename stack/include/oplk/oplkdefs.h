@@ -123,6 +123,24 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CDC_OFFSET_SUBINDEX                             2                   ///< Offset of sub-index in CDC file entry
 #define CDC_OFFSET_SIZE                                 3                   ///< Offset of size field in CDC file entry
 #define CDC_OFFSET_DATA                                 7                   ///< Offset of object data in CDC file entry
+
+#define CDC_PRECOMPILED_MAGIC                           0x43444350          ///< Magic number of a precompiled CDC ("PCDC")
+#define CDC_PRECOMPILED_VERSION                         1                   ///< Format version of a precompiled CDC
+#define CDC_PRECOMPILED_VERSION_SHARED                  2                   ///< Format version of a precompiled CDC with shared CN configurations
+#define CDC_PRECOMPILED_OFFSET_MAGIC                    0                   ///< Offset of magic number in precompiled CDC header
+#define CDC_PRECOMPILED_OFFSET_VERSION                  4                   ///< Offset of format version in precompiled CDC header
+#define CDC_PRECOMPILED_OFFSET_LOCAL_OFFSET             8                   ///< Offset of local CDC section offset in precompiled CDC header
+#define CDC_PRECOMPILED_OFFSET_LOCAL_SIZE               12                  ///< Offset of local CDC section size in precompiled CDC header
+#define CDC_PRECOMPILED_OFFSET_NODE_COUNT               16                  ///< Offset of number of node index entries in precompiled CDC header
+#define CDC_PRECOMPILED_HEADER_SIZE                     20                  ///< Size of precompiled CDC header
+#define CDC_PRECOMPILED_NODE_OFFSET_NODEID              0                   ///< Offset of node ID in node index entry
+#define CDC_PRECOMPILED_NODE_OFFSET_OFFSET              4                   ///< Offset of ConciseDCF offset in node index entry
+#define CDC_PRECOMPILED_NODE_OFFSET_SIZE                8                   ///< Offset of ConciseDCF size in node index entry
+#define CDC_PRECOMPILED_NODE_OFFSET_OBJECT_COUNT        12                  ///< Offset of ConciseDCF object count in node index entry
+#define CDC_PRECOMPILED_NODE_ENTRY_SIZE                 16                  ///< Size of node index entry
+#define CDC_PRECOMPILED_NODE_OFFSET_BASE_OFFSET         16                  ///< Offset of shared ConciseDCF offset in node index entry (version 2)
+#define CDC_PRECOMPILED_NODE_OFFSET_BASE_SIZE           20                  ///< Offset of shared ConciseDCF size in node index entry (version 2)
+#define CDC_PRECOMPILED_NODE_ENTRY_SIZE_SHARED          24                  ///< Size of node index entry (version 2)
 /// \}
 
 //------------------------------------------------------------------------------
@@ -151,6 +169,8 @@ These constants determine the different queue implementations.
 #define CIRCBUF_DLLCAL_CN_REQ_GEN                       8                   ///< Generic request queue for MN asynchronous scheduler
 #define CIRCBUF_DLLCAL_CN_REQ_IDENT                     9                   ///< Ident request queue for MN asynchronous scheduler
 #define CIRCBUF_DLLCAL_CN_REQ_STATUS                    10                  ///< Status request queue for MN asynchronous scheduler
+#define CIRCBUF_USER_INTERNAL_LOW_QUEUE                 11                  ///< User internal event queue for low-priority sinks
+#define CIRCBUF_DLLCAL_TXVETH                           12                  ///< Queue for sending virtual Ethernet frames in the DLLCAL
 /// \}
 
 //------------------------------------------------------------------------------
@@ -54,6 +54,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/version.h>
 #include <oplk/debug.h>
 #include <oplk/ftracedebug.h>
+#include <oplk/bintrace.h>
+#include <oplk/memarena.h>
 
 //------------------------------------------------------------------------------
 // const defines
@@ -66,6 +68,19 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define OPLK_MEMCPY(dst, src, siz)    memcpy((dst), (src), (siz))
 #endif
 
+// Copies of small constant sizes (e.g. MAC addresses) are expanded inline
+#ifndef OPLK_MEMCPY_FIXED
+#if defined(__GNUC__)
+#define OPLK_MEMCPY_FIXED(dst, src, siz)  __builtin_memcpy((dst), (src), (siz))
+#else
+#define OPLK_MEMCPY_FIXED(dst, src, siz)  OPLK_MEMCPY(dst, src, siz)
+#endif
+#endif
+
+#ifndef OPLK_MEMMOVE
+#define OPLK_MEMMOVE(dst, src, siz)   memmove((dst), (src), (siz))
+#endif
+
 #ifndef OPLK_MEMSET
 #define OPLK_MEMSET(dst, val, siz)    memset((dst), (val), (siz))
 #endif
@@ -85,6 +100,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define OPLK_ATOMIC_INIT(ignore)      ((void)0)
 #endif
 
+#ifndef OPLK_MEMBAR
+#if defined(__GNUC__)
+#define OPLK_MEMBAR()                 __asm__ __volatile__ ("" : : : "memory")    // compiler barrier for single core targets
+#else
+#define OPLK_MEMBAR()                 ((void)0)
+#endif
+#endif
+
 #ifndef TIME_STAMP_T
 #define TIME_STAMP_T                  UINT32
 #endif
@@ -167,6 +190,59 @@ typedef struct
     const char*         pDevName;   ///< Device name of the Ethernet controller (valid if non-null)
 } tHwParam;
 
+/**
+\brief Thread roles
+
+The following enumeration lists the roles of the threads which are created by
+the openPOWERLINK stack on targets with thread support (Linux userspace). It
+is used as index into the thread parameter table of the initialization
+parameters.
+*/
+typedef enum
+{
+    kThreadRoleEdrvRx = 0,      ///< Receive/worker thread of the Ethernet driver
+    kThreadRoleHrTimer,         ///< High-resolution timer threads
+    kThreadRoleSyncTimer,       ///< Synchronization timer thread
+    kThreadRoleEventK,          ///< Kernel layer event thread
+    kThreadRoleEventU,          ///< User layer event thread
+    kThreadRolePdoRx,           ///< RPDO worker thread
+    kThreadRoleTimerU,          ///< User timer thread
+    kThreadRoleVeth,            ///< Virtual Ethernet receive thread
+    kThreadRoleSdoUdp,          ///< SDO/UDP receive thread
+    kThreadRoleApiEvent,        ///< Worker thread of the deferred API event callbacks
+    kThreadRolePdoCopy,         ///< Worker threads of the parallel process image copy
+    kThreadRoleSdoServer,       ///< Worker threads of the asynchronous SDO server
+    kThreadRoleEventULow,       ///< User layer event thread of the low-priority events
+    kThreadRoleCount            ///< Number of thread roles
+} tThreadRole;
+
+/**
+\brief Thread scheduling policies
+
+The following enumeration lists the scheduling policies of a stack thread.
+*/
+typedef enum
+{
+    kThreadSchedDefault = 0,    ///< Scheduling policy and priority of the stack default
+    kThreadSchedOther,          ///< Non-realtime scheduling (SCHED_OTHER), the priority is ignored
+    kThreadSchedFifo,           ///< Realtime FIFO scheduling (SCHED_FIFO)
+    kThreadSchedRr              ///< Realtime round-robin scheduling (SCHED_RR)
+} tThreadSchedPolicy;
+
+/**
+\brief Thread parameter structure
+
+The following structure specifies the placement of a stack thread. A
+zero-initialized structure selects the stack defaults.
+*/
+typedef struct
+{
+    tThreadSchedPolicy  schedPolicy;    ///< Scheduling policy of the thread
+    INT                 priority;       ///< Realtime priority of the thread (kThreadSchedFifo and kThreadSchedRr)
+    UINT32              cpuMask;        ///< CPU affinity mask (bit n = CPU n, 0 = stack default)
+    UINT32              numaNodeMask;   ///< NUMA nodes the memory of the thread is allocated from (bit n = node n, 0 = no binding)
+} tThreadParam;
+
 /**
 \brief Timestamp structure
 
@@ -0,0 +1,232 @@
+/**
+********************************************************************************
+\file   oplk/piaccess.h
+
+\brief  Typed accessors for the process images
+
+This file contains the templates of the typed process image accessors for C++
+applications. The offsets of the variables are template arguments, therefore
+the compiler resolves every access to a load or store at a constant offset of
+the image and selects an aligned access wherever the offset allows it.
+
+The header for an openCONFIGURATOR project is generated from its xap.xml file
+by tools/genpiaccess.pl. It replaces the packed structures of xap.h.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_oplk_piaccess_H_
+#define _INC_oplk_piaccess_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#ifndef __cplusplus
+#error "oplk/piaccess.h can only be used by C++ applications"
+#endif
+
+#include <string.h>
+
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+namespace oplk
+{
+namespace pi
+{
+
+/**
+\brief  Load and store of a process image variable
+
+The template implements the memory access of a variable. Variables at an
+offset which is a multiple of their alignment are accessed directly, all others
+by OPLK_MEMCPY_FIXED() which the compiler replaces by the best unaligned access
+of the target. The process images of the stack are allocated by OPLK_MALLOC(),
+therefore their start is suitably aligned for every type.
+*/
+template<typename T, bool fAligned_p>
+struct Access
+{
+    static T load(const BYTE* pVar_p)
+    {
+        T   value;
+
+        OPLK_MEMCPY_FIXED(&value, pVar_p, sizeof(T));
+        return value;
+    }
+
+    static void store(BYTE* pVar_p, T value_p)
+    {
+        OPLK_MEMCPY_FIXED(pVar_p, &value_p, sizeof(T));
+    }
+};
+
+template<typename T>
+struct Access<T, true>
+{
+    static T load(const BYTE* pVar_p)
+    {
+        return *reinterpret_cast<const T*>(pVar_p);
+    }
+
+    static void store(BYTE* pVar_p, T value_p)
+    {
+        *reinterpret_cast<T*>(pVar_p) = value_p;
+    }
+};
+
+/**
+\brief  Process image variable
+
+The template describes a variable of type T at the byte offset offset_p of a
+process image. The stack copies the PDOs to and from the process images in the
+byte order of the host, so the accessors need no conversion.
+*/
+template<typename T, UINT offset_p>
+struct Var
+{
+    typedef T tValue;
+
+    static const UINT offset = offset_p;
+    static const UINT size = sizeof(T);
+
+    static T get(const void* pImage_p)
+    {
+        return Access<T, (offset_p % alignof(T)) == 0>::load(static_cast<const BYTE*>(pImage_p) + offset_p);
+    }
+
+    static void set(void* pImage_p, T value_p)
+    {
+        Access<T, (offset_p % alignof(T)) == 0>::store(static_cast<BYTE*>(pImage_p) + offset_p, value_p);
+    }
+};
+
+/**
+\brief  Process image bit
+
+The template describes a boolean variable stored in bit bit_p of the byte at
+offset_p of a process image.
+*/
+template<UINT offset_p, UINT bit_p>
+struct Bit
+{
+    static_assert(bit_p < 8, "The bit offset must be less than 8");
+
+    typedef bool tValue;
+
+    static const UINT offset = offset_p;
+    static const UINT size = 1;
+
+    static bool get(const void* pImage_p)
+    {
+        return ((static_cast<const BYTE*>(pImage_p)[offset_p] >> bit_p) & 1) != 0;
+    }
+
+    static void set(void* pImage_p, bool fValue_p)
+    {
+        BYTE*   pVar = static_cast<BYTE*>(pImage_p) + offset_p;
+
+        *pVar = fValue_p ? (BYTE)(*pVar | (1 << bit_p)) : (BYTE)(*pVar & ~(1 << bit_p));
+    }
+};
+
+/**
+\brief  Process image array
+
+The template describes count_p consecutive variables of type T starting at the
+byte offset offset_p of a process image. Elements with a constant index are
+accessed by Element<index>, the whole array is transferred by read() and
+write().
+*/
+template<typename T, UINT offset_p, UINT count_p>
+struct Array
+{
+    typedef T tValue;
+
+    static const UINT offset = offset_p;
+    static const UINT count = count_p;
+    static const UINT size = count_p * sizeof(T);
+
+    template<UINT index_p>
+    struct Element : Var<T, offset_p + (index_p * sizeof(T))>
+    {
+        static_assert(index_p < count_p, "The array index is out of range");
+    };
+
+    static T get(const void* pImage_p, UINT index_p)
+    {
+        return Access<T, (offset_p % alignof(T)) == 0>::load(static_cast<const BYTE*>(pImage_p) + offset_p + (index_p * sizeof(T)));
+    }
+
+    static void set(void* pImage_p, UINT index_p, T value_p)
+    {
+        Access<T, (offset_p % alignof(T)) == 0>::store(static_cast<BYTE*>(pImage_p) + offset_p + (index_p * sizeof(T)), value_p);
+    }
+
+    static void read(const void* pImage_p, T* pDest_p)
+    {
+        OPLK_MEMCPY(pDest_p, static_cast<const BYTE*>(pImage_p) + offset_p, size);
+    }
+
+    static void write(void* pImage_p, const T* pSrc_p)
+    {
+        OPLK_MEMCPY(static_cast<BYTE*>(pImage_p) + offset_p, pSrc_p, size);
+    }
+};
+
+/**
+\brief  Check a variable against the size of its process image
+
+The function is used by the generated headers in a static_assert to check at
+compile time that a variable lies completely within its process image.
+
+\param  offset_p            Offset of the variable.
+\param  size_p              Size of the variable.
+\param  imageSize_p         Size of the process image.
+
+\return The function returns true if the variable fits into the image.
+*/
+constexpr bool fitsImage(UINT offset_p, UINT size_p, UINT imageSize_p)
+{
+    return (offset_p <= imageSize_p) && (size_p <= imageSize_p - offset_p);
+}
+
+} // namespace pi
+} // namespace oplk
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#endif /* _INC_oplk_piaccess_H_ */
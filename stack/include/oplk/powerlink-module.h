@@ -63,12 +63,31 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define PLK_CMD_CTRL_READ_INITPARAM             _IOR (PLK_IOC_MAGIC, 2, tCtrlInitParam)
 #define PLK_CMD_CTRL_GET_STATUS                 _IOR (PLK_IOC_MAGIC, 3, UINT16)
 #define PLK_CMD_CTRL_GET_HEARTBEAT              _IOR (PLK_IOC_MAGIC, 4, UINT16)
-#define PLK_CMD_POST_EVENT                      _IOW (PLK_IOC_MAGIC, 5, tEvent)
-#define PLK_CMD_GET_EVENT                       _IOR (PLK_IOC_MAGIC, 6, tEvent)
 #define PLK_CMD_DLLCAL_ASYNCSEND                _IO  (PLK_IOC_MAGIC, 7)
 #define PLK_CMD_ERRHND_WRITE                    _IOW (PLK_IOC_MAGIC, 8, tErrHndIoctl)
 #define PLK_CMD_ERRHND_READ                     _IOR (PLK_IOC_MAGIC, 9, tErrHndIoctl)
-#define PLK_CMD_PDO_SYNC                        _IO  (PLK_IOC_MAGIC, 10)
+#define PLK_CMD_SIGNAL_EVENT                    _IO  (PLK_IOC_MAGIC, 11)
+#define PLK_CMD_DLLCAL_ASYNCSEND_MULTI          _IOWR(PLK_IOC_MAGIC, 12, tIoctlDllCalAsyncMulti)
+#define PLK_CMD_PDO_SYNC_EVENTFD                _IOW (PLK_IOC_MAGIC, 13, int)
+#define PLK_CMD_IRQ_SET_CONFIG                  _IOW (PLK_IOC_MAGIC, 14, tIrqConfig)
+#define PLK_CMD_IRQ_GET_CONFIG                  _IOR (PLK_IOC_MAGIC, 15, tIrqConfig)
+
+/// Maximum number of frames of one PLK_CMD_DLLCAL_ASYNCSEND_MULTI call
+#define PLK_DLLCAL_ASYNCSEND_MAX_FRAMES         32
+
+/// Maximum number of controller interrupts reported by PLK_CMD_IRQ_GET_CONFIG
+#define PLK_IRQ_CONFIG_MAX_IRQS                 4
+
+//------------------------------------------------------------------------------
+//  Memory areas for <mmap>, selected by the page offset
+//------------------------------------------------------------------------------
+#define PLK_MMAP_PGOFF_PDO                      0   ///< PDO memory
+#define PLK_MMAP_PGOFF_EVENT_K2U                1   ///< Kernel-to-user event queue
+#define PLK_MMAP_PGOFF_EVENT_U2K                2   ///< User-to-kernel event queue
+#define PLK_MMAP_PGOFF_PDO_SYNC                 3   ///< PDO sync information (read-only)
+#define PLK_MMAP_PGOFF_CTRL_STATUS              4   ///< Kernel stack status (read-only)
+#define PLK_MMAP_PGOFF_PDO_WC                   5   ///< PDO memory, buffers mapped write-combining
+#define PLK_MMAP_PGOFF_PDO_UC                   6   ///< PDO memory, buffers mapped uncached
 
 //------------------------------------------------------------------------------
 // typedef
@@ -80,6 +99,15 @@ typedef struct
     size_t                  size;
 } tIoctlDllCalAsync;
 
+typedef struct
+{
+    tIoctlDllCalAsync*      pFrames;        ///< Array of frames to send
+    tOplkError*             pStatus;        ///< Array to store the result of each frame
+    UINT32                  frameCount;     ///< Number of frames in the arrays
+    UINT32                  fillLevelNmt;   ///< Returns the number of frames in the NMT queue
+    UINT32                  fillLevelGen;   ///< Returns the number of frames in the generic queue
+} tIoctlDllCalAsyncMulti;
+
 typedef struct
 {
     void*                   pData;
@@ -92,6 +120,91 @@ typedef struct
     UINT32                  errVal;
 } tErrHndIoctl;
 
+/**
+\brief PDO sync information
+
+The structure is updated by the kernel module on every sync event and can be
+mapped read-only with PLK_MMAP_PGOFF_PDO_SYNC. The sequence counter is odd
+while the structure is updated, a reader must retry if it is odd or changed
+while reading.
+*/
+typedef struct
+{
+    volatile UINT32         sequence;       ///< Sequence counter of updates
+    UINT32                  reserved;
+    volatile UINT64         cycleCount;     ///< Number of sync events since initialization
+    volatile UINT64         timeStamp;      ///< CLOCK_MONOTONIC time of the last sync event in ns
+} tPdoSyncInfoMem;
+
+/**
+\brief Kernel stack status
+
+The structure is updated by the kernel module together with the heartbeat
+counter and on every status change. It can be mapped read-only with
+PLK_MMAP_PGOFF_CTRL_STATUS to monitor the kernel stack without ioctl calls.
+The sequence counter is odd while the structure is updated, a reader must
+retry if it is odd or changed while reading. The values of the stack modules
+are only valid while the status is kCtrlStatusRunning.
+*/
+typedef struct
+{
+    volatile UINT32         sequence;           ///< Sequence counter of updates
+    volatile UINT16         status;             ///< Status of the kernel stack (\ref tCtrlKernelStatus)
+    volatile UINT16         heartbeat;          ///< Heartbeat counter of the kernel stack
+    volatile UINT32         nmtState;           ///< Current NMT state (\ref tNmtState)
+    UINT32                  reserved;
+    volatile UINT64         cycleCount;         ///< Number of sync events (see \ref tPdoSyncInfoMem)
+    volatile UINT32         cnLossSocCnt;       ///< Cumulative counter of object 0x1C0B
+    volatile UINT32         cnLossPreqCnt;      ///< Cumulative counter of object 0x1C0D
+    volatile UINT32         cnCrcErrCnt;        ///< Cumulative counter of object 0x1C0F
+    volatile UINT32         mnCrcErrCnt;        ///< Cumulative counter of object 0x1C00
+    volatile UINT32         mnCycTimeExceedCnt; ///< Cumulative counter of object 0x1C02
+    volatile UINT32         fillLevelNmt;       ///< Number of frames in the NMT Tx queue
+    volatile UINT32         fillLevelGen;       ///< Number of frames in the generic Tx queue
+    volatile UINT32         fillLevelK2U;       ///< Number of events in the kernel-to-user queue
+    volatile UINT32         fillLevelU2K;       ///< Number of events in the user-to-kernel queue
+} tCtrlStatusMem;
+
+/**
+\brief Controller interrupt information
+
+The structure reports the effective configuration of an interrupt of the
+Ethernet controller, see \ref tIrqConfig.
+*/
+typedef struct
+{
+    UINT32                  irq;                ///< Interrupt number
+    UINT32                  irqClass;           ///< Interrupt class (0 = isochronous, 1 = asynchronous)
+    UINT32                  cpuMask;            ///< CPU affinity set for the interrupt (0 = kernel default)
+    UINT32                  fHardIrq;           ///< The handler runs in the primary interrupt handler
+    INT32                   threadPriority;     ///< SCHED_FIFO priority of the interrupt thread (-1 = no thread seen yet)
+} tIrqInfo;
+
+/**
+\brief Interrupt and thread configuration
+
+The structure is written with PLK_CMD_IRQ_SET_CONFIG and read with
+PLK_CMD_IRQ_GET_CONFIG. The defaults are set by the module parameters of the
+kernel module. CPU masks and priorities of 0 keep the default of the kernel or
+the stack. The CPU masks and priorities are applied immediately, fIsocHardIrq
+is applied when the Ethernet controller is initialized the next time. The
+fields behind fIsocHardIrq are only reported by PLK_CMD_IRQ_GET_CONFIG.
+*/
+typedef struct
+{
+    UINT32                  cpuMaskIsoc;        ///< CPU affinity of the isochronous interrupts
+    UINT32                  cpuMaskAsync;       ///< CPU affinity of the asynchronous interrupts
+    INT32                   irqThreadPriority;  ///< SCHED_FIFO priority of the interrupt threads (PREEMPT_RT, threadirqs)
+    INT32                   eventkPriority;     ///< SCHED_FIFO priority of the kernel event thread
+    INT32                   pollPriority;       ///< SCHED_FIFO priority of the poll thread (CONFIG_EDRV_POLL_MODE)
+    UINT32                  fIsocHardIrq;       ///< Process the isochronous interrupts in the primary handler
+    UINT32                  fIsocHardIrqSupported;  ///< The primary handler processing is supported by the kernel
+    INT32                   eventkPriorityActive;   ///< Current priority of the kernel event thread (-1 = not running)
+    INT32                   pollPriorityActive;     ///< Current priority of the poll thread (-1 = not running)
+    UINT32                  irqCount;           ///< Number of valid entries in aIrq
+    tIrqInfo                aIrq[PLK_IRQ_CONFIG_MAX_IRQS];  ///< Controller interrupts
+} tIrqConfig;
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
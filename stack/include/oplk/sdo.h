@@ -43,6 +43,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 #include <oplk/oplkinc.h>
 #include <oplk/frame.h>
+#include <oplk/obd.h>
 #include <oplk/sdoabortcodes.h>
 
 //------------------------------------------------------------------------------
@@ -68,8 +69,32 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define SEQ_NUM_MASK                0xFC
 
+// size of ASnd, SDO sequence layer and fixed SDO command layer headers
+#define SDO_ASYNC_HEADER_SIZE       (ASND_HEADER_SIZE + 4 + SDO_CMDL_HDR_FIXED_SIZE)
+// size of all headers of an SDO frame including the Ethernet header
+#define SDO_FRAME_HEADER_SIZE       (14 + SDO_ASYNC_HEADER_SIZE)
+
+#if (SDO_MAX_SEGMENT_SIZE > (C_DLL_MAX_ASYNC_MTU - SDO_ASYNC_HEADER_SIZE))
+#error "SDO_MAX_SEGMENT_SIZE exceeds the maximum asynchronous MTU!"
+#endif
+
 // size for send buffer and history
+#if ((SDO_MAX_SEGMENT_SIZE + SDO_FRAME_HEADER_SIZE) > C_IP_MIN_MTU)
+#define SDO_MAX_FRAME_SIZE          (SDO_MAX_SEGMENT_SIZE + SDO_FRAME_HEADER_SIZE)
+#else
 #define SDO_MAX_FRAME_SIZE          C_IP_MIN_MTU
+#endif
+// size of a sub-block of a Read/Write Multiple Parameter by Index command
+#define SDO_MULTI_SUBBLOCK_SIZE(dataSize_p) (SDO_CMDL_HDR_MULTI_SUBHDR_SIZE + (((dataSize_p) + 3) & ~3))
+
+// payload size of a Read/Write Multiple Parameter by Index command which fits
+// into a single segment at the minimum asynchronous MTU
+#if ((C_DLL_MIN_ASYNC_MTU - SDO_ASYNC_HEADER_SIZE) < SDO_MAX_SEGMENT_SIZE)
+#define SDO_MULTI_MAX_PAYLOAD_SIZE  (C_DLL_MIN_ASYNC_MTU - SDO_ASYNC_HEADER_SIZE)
+#else
+#define SDO_MULTI_MAX_PAYLOAD_SIZE  SDO_MAX_SEGMENT_SIZE
+#endif
+
 // size for receive frame
 // -> needed because SND-Kit sends up to 1518 Byte
 //    without Sdo-Command: Maximum Segment Size
@@ -139,7 +164,8 @@ typedef enum
     kSdoServiceWriteByIndex             = 0x01,
     kSdoServiceReadByIndex              = 0x02,
 
-    // the following services are optional and are not supported now
+    // the following services are optional, only the multiple parameter
+    // services are supported (expedited transfers only)
     kSdoServiceWriteAllByIndex          = 0x03,
     kSdoServiceReadAllByIndex           = 0x04,
     kSdoServiceWriteByName              = 0x05,
@@ -204,6 +230,7 @@ typedef struct
     UINT                targetIndex;            ///< Index which was accessed
     UINT                targetSubIndex;         ///< Sub-index which was accessed
     UINT                transferredBytes;       ///< The number of bytes transferred
+    UINT32              transferTimeMs;         ///< Duration of the transfer in milliseconds
     void*               pUserArg;               ///< The user defined argument pointer
 } tSdoComFinished;
 
@@ -211,6 +238,19 @@ typedef struct
 /// callback function pointer to inform application about connection
 typedef tOplkError (*tSdoFinishedCb)(tSdoComFinished* pSdoComFinished_p);
 
+/**
+\brief Structure for an entry of a scatter list
+
+The structure describes one buffer of a scatter list. The data of a read is
+written to the buffers of the list in their order, so large objects can be read
+into several buffers without a temporary buffer which holds the whole object.
+*/
+typedef struct
+{
+    void*               pData;                  ///< Pointer to the buffer
+    UINT                size;                   ///< Size of the buffer
+} tSdoScatterEntry;
+
 /**
 \brief Structure for initializing Read/Write by Index SDO transfer
 
@@ -228,8 +268,45 @@ typedef struct
     tSdoAccessType      sdoAccessType;          ///< The SDO access type (Read or Write) for this transfer
     tSdoFinishedCb      pfnSdoFinishedCb;       ///< Pointer to callback function which will be called when transfer is finished.
     void*               pUserArg;               ///< User definable argument pointer
+    tObdDomainStream*   pStream;                ///< Stream which provides/receives the data instead of pData (NULL = use pData)
+    tSdoScatterEntry*   paScatterList;          ///< Scatter list which receives the data of a read instead of pData (NULL = use pData)
+    UINT                scatterEntryCount;      ///< Number of entries of the scatter list
 } tSdoComTransParamByIndex;
 
+/**
+\brief Structure for an entry of a Read/Write Multiple Parameter by Index transfer
+
+This structure describes one object which is accessed by a Read or Write
+Multiple Parameter by Index SDO transfer. The result of the access is stored
+in the structure when the transfer is finished.
+*/
+typedef struct
+{
+    UINT                index;                  ///< Index to read/write
+    UINT                subindex;               ///< Sub-index to read/write
+    void*               pData;                  ///< Pointer to data in little endian byte order
+    UINT                dataSize;               ///< Size of data to be written or of the read buffer, returns the size of the read data
+    UINT32              abortCode;              ///< Returns the SDO abort code of the entry (0 = entry was transferred)
+} tSdoMultiAccEntry;
+
+/**
+\brief Structure for initializing Read/Write Multiple Parameter by Index SDO transfer
+
+This structure is used to initialize a SDO transfer of a Read or Write
+Multiple Parameter by Index command. The command must fit into a single
+segment. The transfer is finished when the target has answered. The results
+of the single entries are then stored in the entry array.
+*/
+typedef struct
+{
+    tSdoComConHdl       sdoComConHdl;           ///< Handle to SDO command layer connection
+    tSdoMultiAccEntry*  paEntries;              ///< Array of entries to read/write, must stay valid until the transfer is finished
+    UINT                entryCount;             ///< Number of entries in the array
+    tSdoAccessType      sdoAccessType;          ///< The SDO access type (Read or Write) for this transfer
+    tSdoFinishedCb      pfnSdoFinishedCb;       ///< Pointer to callback function which will be called when transfer is finished.
+    void*               pUserArg;               ///< User definable argument pointer
+} tSdoComTransParamMultiByIndex;
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
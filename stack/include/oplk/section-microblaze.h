@@ -48,7 +48,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define XIL_INTERNAL_RAM    __attribute__((section(".local_memory")))
 
-#ifdef NDEBUG
+#if defined(CONFIG_SECTION_PROFILE)
+// Section assignments generated from a profiled reference run (tools/gensections.pl)
+#include "section-profile.h"
+#elif defined(NDEBUG)
 #ifdef CONFIG_MN
     /* TODO:
      * Implement MN on Xilinx!
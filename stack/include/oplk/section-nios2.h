@@ -52,7 +52,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define ALT_INTERNAL_RAM    __attribute__((section(".tc_i_mem")))
 
-#ifdef NDEBUG
+#if defined(CONFIG_SECTION_PROFILE)
+// Section assignments generated from a profiled reference run (tools/gensections.pl)
+#include "section-profile.h"
+#elif defined(NDEBUG)
 #ifdef CONFIG_MN
 
 #define SECTION_CIRCBUF_WRITE_DATA          ALT_INTERNAL_RAM
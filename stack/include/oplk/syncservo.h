@@ -0,0 +1,91 @@
+/**
+********************************************************************************
+\file   oplk/syncservo.h
+
+\brief  Definitions for the sync servo statistics
+
+The file contains the statistics of the servo which synchronizes the sync
+timer of a CN to the SoC frames of the MN.
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+
+#ifndef _INC_oplk_syncservo_H_
+#define _INC_oplk_syncservo_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Sync servo statistics
+
+The structure contains the statistics of the sync servo of a CN. All times are
+in nanoseconds. The sync error is the difference between the reception of the
+SoC and the time predicted by the servo, i.e. a positive error means that the
+SoC was received late. The minimum, maximum and mean errors only contain the
+samples since the servo is locked, i.e. after the acquisition phase.
+*/
+typedef struct
+{
+    BOOL                fLocked;                ///< The servo finished the acquisition phase
+    UINT32              sampleCount;            ///< Number of sync errors since the last acquisition
+    UINT32              acquisitionCount;       ///< Number of acquisition phases
+    UINT32              outlierCount;           ///< Number of sync errors ignored as outliers
+    UINT32              rejectedCount;          ///< Number of SoC frames rejected because of a loss of sync
+    INT32               lastError;              ///< Last sync error
+    INT32               minError;               ///< Minimum sync error
+    INT32               maxError;               ///< Maximum sync error
+    UINT32              meanAbsError;           ///< Moving average of the absolute sync error
+    UINT32              period;                 ///< Cycle period estimated by the servo
+    INT32               drift;                  ///< Drift of the local clock relative to the MN in ppb
+} tSyncServoStatistics;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_oplk_syncservo_H_ */
@@ -90,5 +90,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define OPLK_ATOMIC_EXCHANGE(address, newval, oldval) \
     oldval = __sync_lock_test_and_set(address, newval);
 
+#ifdef __KERNEL__
+#define OPLK_MEMBAR()           smp_mb()
+#else
+#define OPLK_MEMBAR()           __sync_synchronize()
+#endif
+
 #endif /* _INC_targetdefs_linux_H_ */
 
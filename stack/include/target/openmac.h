@@ -82,6 +82,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // typedef
 //------------------------------------------------------------------------------
 typedef void (*tOpenmacIrqCb) (void* pArg_p);
+typedef void (*tOpenmacDmaCb) (void* pArg_p, void* pDst_p);
 
 /**
 \brief openMAC IRQ sources
@@ -120,6 +121,11 @@ void openmac_timerIrqEnable(UINT timer_p, UINT32 pulseWidthNs_p);
 void openmac_timerSetCompareValue(UINT timer_p, UINT32 val_p);
 UINT32 openmac_timerGetTimeValue(UINT timer_p);
 
+tOplkError openmac_dmaInit(void);
+void openmac_dmaExit(void);
+tOplkError openmac_dmaCopy(void* pDst_p, const void* pSrc_p, UINT size_p,
+                           tOpenmacDmaCb pfnDoneCb_p, void* pArg_p);
+
 #ifdef __cplusplus
 }
 #endif
@@ -68,9 +68,20 @@ void       ctrlu_exit(void);
 tOplkError ctrlu_initStack(tOplkApiInitParam* pInitParam_p);
 tOplkError ctrlu_shutdownStack(void);
 tOplkError ctrlu_processStack(void);
+tOplkError ctrlu_waitAndProcess(UINT32 timeoutMs_p);
+int        ctrlu_getWaitHandle(void);
+tOplkError ctrlu_getEventQueueStatistics(tEventQueueStatistics* pStatistics_p);
 BOOL       ctrlu_checkKernelStack(void);
 tOplkError ctrlu_callUserEventCallback(tOplkApiEventType eventType_p, tOplkApiEventArg* pEventArg_p);
 tOplkError ctrlu_cbObdAccess(tObdCbParam MEM* pParam_p);
+#if (CONFIG_CTRL_STARTUP_TIMING != FALSE)
+tOplkError ctrlu_getStartupTiming(tOplkApiStartupTiming* pTiming_p);
+#endif
+#if (CONFIG_API_DEFERRED_EVENTS != FALSE)
+tOplkError ctrlu_initDeferredEvents(tOplkApiCbEvent pfnCbEvent_p, void* pUserArg_p);
+void       ctrlu_exitDeferredEvents(void);
+tOplkError ctrlu_postDeferredEvent(tOplkApiEventType eventType_p, const tOplkApiEventArg* pEventArg_p);
+#endif
 
 #ifdef __cplusplus
 }
@@ -72,8 +72,15 @@ tOplkError dllucal_regAsndService(tDllAsndServiceId ServiceId_p,
                                   tDlluCbAsnd pfnDlluCbAsnd_p,
                                   tDllAsndFilter Filter_p);
 
+tOplkError dllucal_setAsndServiceLimit(tDllAsndServiceId serviceId_p,
+                                       UINT maxFramesPerSec_p, BOOL fCoalesce_p);
+
 tOplkError dllucal_sendAsyncFrame(tFrameInfo* pFrameInfo, tDllAsyncReqPriority Priority_p);
 
+tOplkError dllucal_allocAsyncFrame(tFrameInfo* pFrameInfo_p, tDllAsyncReqPriority priority_p);
+
+tOplkError dllucal_sendAllocatedAsyncFrame(tFrameInfo* pFrameInfo_p, tDllAsyncReqPriority priority_p);
+
 tOplkError dllucal_process(tEvent* pEvent_p);
 
 
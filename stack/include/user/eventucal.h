@@ -70,6 +70,25 @@ tOplkError eventucal_exit(void);
 tOplkError eventucal_postKernelEvent(tEvent* pEvent_p);
 tOplkError eventucal_postUserEvent(tEvent* pEvent_p);
 void       eventucal_process(void);
+void       eventucal_waitEvent(UINT32 timeoutMs_p);
+
+/* functions used in eventucal-linux.c */
+void       eventucal_getBatchStatistics(tEventBatchStatistics* pStatistics_p);
+
+/* functions used in eventucal-linux.c and eventucal-linuxioctl.c */
+int        eventucal_getWaitHandle(void);
+void       eventucal_getQueueStatistics(tEventQueueStatistics* pStatistics_p);
+
+#if (CONFIG_EVENTU_LOW_PRIORITY_THREAD != FALSE)
+/* functions used in eventu.c if the low-priority events have their own thread */
+void       eventucal_lockSharedState(void);
+void       eventucal_unlockSharedState(void);
+#endif
+
+#if (CONFIG_EVENTU_CYCLE_SLICE != FALSE)
+/* function used in processimage.c to start the slice of the low-priority events */
+void       eventucal_startCycleSlice(void);
+#endif
 
 #ifdef __cplusplus
 }
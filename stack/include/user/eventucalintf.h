@@ -71,7 +71,13 @@ tOplkError eventucal_exitQueueCircbuf(tEventQueue eventQueue_p);
 tOplkError eventucal_postEventCircbuf(tEventQueue eventQueue_p, tEvent* pEvent_p);
 tOplkError eventucal_processEventCircbuf(tEventQueue eventQueue_p);
 UINT       eventucal_getEventCountCircbuf(tEventQueue eventQueue_p);
+#ifdef DEBUG_CIRCBUF_SIZE_CHECK
+UINT32     eventucal_getMaxSizeCircbuf(tEventQueue eventQueue_p);
+#endif
 tOplkError eventucal_setSignalingCircbuf(tEventQueue eventQueue_p, VOIDFUNCPTR pfnSignalCb_p);
+tOplkError eventucal_setLowLaneSignalingCircbuf(tEventQueue eventQueue_p, VOIDFUNCPTR pfnSignalCb_p);
+tOplkError eventucal_processLowLaneEventCircbuf(tEventQueue eventQueue_p);
+UINT       eventucal_getLowLaneEventCountCircbuf(tEventQueue eventQueue_p);
 
 
 #ifdef __cplusplus
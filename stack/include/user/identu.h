@@ -54,6 +54,19 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 typedef tOplkError (*tIdentuCbResponse)(UINT nodeId_p, tIdentResponse* pIdentResponse_p);
 
+/**
+\brief Snapshot of a cached IdentResponse
+
+The structure contains a copy of the cached IdentResponse of a node. The
+version is incremented whenever the content of the IdentResponse changes.
+*/
+typedef struct
+{
+    tIdentResponse      identResponse;      ///< Copy of the IdentResponse
+    UINT32              version;            ///< Version of the IdentResponse
+    UINT32              age;                ///< Time in ms since the IdentResponse was received
+} tIdentuSnapshot;
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
@@ -69,6 +82,10 @@ tOplkError identu_reset(void);
 tOplkError identu_getIdentResponse(UINT nodeId_p, tIdentResponse** ppIdentResponse_p);
 tOplkError identu_requestIdentResponse(UINT nodeId_p, tIdentuCbResponse pfnCbResponse_p);
 UINT32     identu_getRunningRequests(void);
+tOplkError identu_requestCachedIdentResponse(UINT nodeId_p, tIdentuCbResponse pfnCbResponse_p);
+tOplkError identu_getIdentResponseSnapshot(UINT nodeId_p, tIdentuSnapshot* pSnapshot_p);
+tOplkError identu_registerChangeCb(tIdentuCbResponse pfnCbChange_p);
+tOplkError identu_deregisterChangeCb(tIdentuCbResponse pfnCbChange_p);
 
 #ifdef __cplusplus
 }
@@ -63,6 +63,20 @@ typedef struct
 
 typedef tOplkError (*tPdoCbEventPdoChange)(tPdoEventPdoChange* pEventPdoChange_p);
 
+#if (CONFIG_PDO_PARALLEL_COPY != FALSE)
+/// Number of threads of a parallel copy, including the calling thread
+#define PDOU_PARALLEL_COPY_THREADS      (CONFIG_PDO_PARALLEL_COPY_WORKERS + 1)
+
+/**
+\brief Channel copy function of the parallel copy engine
+
+The function copies a single PDO channel. The worker index (0 to
+PDOU_PARALLEL_COPY_THREADS - 1) allows to separate data, which is shared by
+the channels, between the workers.
+*/
+typedef tOplkError (*tPdouCopyChannelCb)(UINT channelId_p, UINT workerIndex_p);
+#endif
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
@@ -85,7 +99,30 @@ tOplkError pdou_cbNmtStateChange(tEventNmtStateChange NmtStateChange_p);
 
 tOplkError pdou_copyRxPdoToPi (void);
 tOplkError pdou_copyTxPdoFromPi (void);
+tOplkError pdou_copyRxPdoToPiPartial(const UINT8* pNodeBitmap_p, UINT bitmapSize_p);
+tOplkError pdou_copyTxPdoFromPiPartial(const UINT8* pNodeBitmap_p, UINT bitmapSize_p);
 tOplkError pdou_registerEventPdoChangeCb(tPdoCbEventPdoChange pfnCbEventPdoChange_p);
+tOplkError pdou_setupZeroCopy(void* pRxPi_p, UINT rxPiSize_p, void* pTxPi_p, UINT txPiSize_p);
+void*      pdou_getZeroCopyRxPdo(void);
+void*      pdou_getZeroCopyTxPdo(void);
+tOplkError pdou_setupKernelPi(void* pRxPi_p, UINT rxPiSize_p, void* pTxPi_p, UINT txPiSize_p);
+void*      pdou_getKernelPiOut(void);
+void*      pdou_getKernelPiIn(void);
+void       pdou_enableTxPdoDirtyTracking(BOOL fEnable_p);
+void       pdou_markTxPdoDirty(const void* pData_p, UINT size_p);
+void       pdou_getRxPdoUpdates(UINT8* pNodeBitmap_p, UINT bitmapSize_p);
+tOplkError pdou_getRxPdoSequence(UINT nodeId_p, UINT32* pSequence_p);
+tOplkError pdou_addPdoRoute(UINT rxMappParamIndex_p, UINT rxOffset_p, UINT size_p,
+                            UINT txMappParamIndex_p, UINT txOffset_p);
+tOplkError pdou_clearPdoRoutes(void);
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+void       pdou_setStaticCopyProcessImage(void* pRxPi_p, UINT rxPiSize_p, void* pTxPi_p, UINT txPiSize_p);
+#endif
+#if (CONFIG_PDO_PARALLEL_COPY != FALSE)
+tOplkError pdou_initParallelCopy(void);
+void       pdou_exitParallelCopy(void);
+tOplkError pdou_runParallelCopy(tPdouCopyChannelCb pfnCopyChannel_p, UINT channelCount_p);
+#endif
 
 #ifdef __cplusplus
 }
@@ -66,12 +66,18 @@ tOplkError pdoucal_exit(void);
 tOplkError pdoucal_postPdokChannelAlloc(tPdoAllocationParam* pAllocationParam_p);
 tOplkError pdoucal_postConfigureChannel(tPdoChannelConf* pChannelConf_p);
 tOplkError pdoucal_postSetupPdoBuffers(size_t rxPdoMemSize_p, size_t txPdoMemSize_p);
+tOplkError pdoucal_postAddRoute(const tPdoRoute* pRoute_p);
+tOplkError pdoucal_postClearRoutes(void);
+tOplkError pdoucal_postSetupKernelPi(const tPdoKernelPiSetup* pSetup_p);
 
 // PDO memory functions
 tOplkError pdoucal_openMem(void);
 tOplkError pdoucal_closeMem(void);
 tOplkError pdoucal_allocateMem(size_t memSize_p, BYTE** pPdoMem_p);
 tOplkError pdoucal_freeMem(BYTE* pMem_p, size_t memSize_p);
+#if (CONFIG_PDO_HOSTIF_DMA != FALSE)
+tOplkError pdoucal_copyMem(BYTE* pDst_p, const BYTE* pSrc_p, size_t size_p);
+#endif
 
 //PDO buffer functions
 tOplkError pdoucal_initPdoMem(tPdoChannelSetup* pPdoChannels_p, size_t rxPdoMemSize_p,
@@ -80,11 +86,24 @@ void       pdoucal_cleanupPdoMem(void);
 BYTE*      pdoucal_getTxPdoAdrs(UINT channelId_p);
 tOplkError pdoucal_setTxPdo(UINT channelId_p, BYTE* pPdo_p, WORD pdoSize_p);
 tOplkError pdoucal_getRxPdo(BYTE** ppPdo_p, UINT channelId_p, WORD pdoSize_p);
+UINT32     pdoucal_getRxPdoSequence(UINT channelId_p);
+tOplkError pdoucal_getReaderRxPdo(UINT readerId_p, BYTE** ppPdo_p, UINT channelId_p,
+                                  WORD pdoSize_p);
+UINT32     pdoucal_getReaderRxPdoSequence(UINT readerId_p, UINT channelId_p);
+tOplkError pdoucal_getSocTime(tSocTimeInfo* pSocTimeInfo_p);
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+tOplkError pdoucal_writeKernelPiCopy(const tPdoKernelPiCopy* paCopy_p, UINT copyCount_p);
+BYTE*      pdoucal_getKernelPiOut(void);
+BYTE*      pdoucal_getKernelPiIn(void);
+BYTE*      pdoucal_setKernelPiIn(void);
+#endif
 
 // PDO sync functions
 tOplkError pdoucal_initSync(tSyncCb pfnSyncCb_p);
 void       pdoucal_exitSync(void);
 tOplkError pdoucal_waitSyncEvent(ULONG timeout_p);
+int        pdoucal_getSyncFd(void);
+tOplkError pdoucal_getSyncInfo(tSyncInfo* pSyncInfo_p);
 tOplkError pdoucal_callSyncCb(void);
 
 #ifdef __cplusplus
@@ -54,6 +54,27 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // typedef
 //------------------------------------------------------------------------------
+#if (CONFIG_SDO_SERVER_ASYNC != FALSE)
+/**
+\brief Deferred OD access of the SDO server
+
+The structure describes an expedited OD access of the SDO server which is
+executed by a worker thread. It is handed back to the command layer in a
+kEventTypeSdoObdAccessDone event when the access is finished.
+*/
+typedef struct
+{
+    tSdoComConHdl       sdoComConHdl;                   ///< Command layer connection of the request
+    tSdoSeqConHdl       sdoSeqConHdl;                   ///< Sequence layer connection of the request
+    UINT8               transactionId;                  ///< Transaction ID of the request
+    BOOL                fWrite;                         ///< TRUE = write access, FALSE = read access
+    UINT                index;                          ///< Index of the object
+    UINT                subIndex;                       ///< Sub-index of the object
+    tObdSize            size;                           ///< Size of the written data or of the read data
+    tOplkError          result;                         ///< Result of the OD access
+    UINT8               aData[SDO_MAX_SEGMENT_SIZE];    ///< Written or read data in little endian byte order
+} tSdoComObdAccess;
+#endif
 
 //------------------------------------------------------------------------------
 // function prototypes
@@ -67,9 +88,17 @@ tOplkError sdocom_init(void);
 tOplkError sdocom_addInstance(void);
 tOplkError sdocom_delInstance(void);
 
+#if defined(CONFIG_INCLUDE_SDOS) && (CONFIG_SDO_SERVER_ASYNC != FALSE)
+tOplkError sdocom_processEvent(tEvent* pEvent_p);
+tOplkError sdocom_initObdWorkers(void);
+void       sdocom_exitObdWorkers(void);
+tOplkError sdocom_queueObdAccess(const tSdoComObdAccess* pObdAccess_p);
+#endif
+
 #if defined(CONFIG_INCLUDE_SDOC)
 tOplkError sdocom_defineConnection(tSdoComConHdl* pSdoComConHdl_p, UINT targetNodeId_p, tSdoType protType_p);
 tOplkError sdocom_initTransferByIndex(tSdoComTransParamByIndex* pSdoComTransParam_p);
+tOplkError sdocom_initTransferMultiByIndex(tSdoComTransParamMultiByIndex* pSdoComTransParam_p);
 UINT       sdocom_getNodeId(tSdoComConHdl sdoComConHdl_p);
 tOplkError sdocom_undefineConnection(tSdoComConHdl sdoComConHdl_p);
 tOplkError sdocom_getState(tSdoComConHdl sdoComConHdl_p, tSdoComFinished* pSdoComFinished_p);
@@ -72,6 +72,7 @@ tOplkError sdoseq_sendData(tSdoSeqConHdl sdoSeqConHdl_p, UINT dataSize_p, tPlkFr
 tOplkError sdoseq_processEvent(tEvent* pEvent_p);
 tOplkError sdoseq_deleteCon(tSdoSeqConHdl sdoSeqConHdl_p);
 tOplkError sdoseq_setTimeout(UINT32 timeout_p);
+tOplkError sdoseq_setWindowSize(tSdoSeqConHdl sdoSeqConHdl_p, UINT windowSize_p);
 
 #ifdef __cplusplus
 }
@@ -53,6 +53,19 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 typedef tOplkError (*tStatusuCbResponse)(UINT nodeId_p, tStatusResponse* pStatusResponse_p);
 
+/**
+\brief Snapshot of a cached StatusResponse
+
+The structure contains a copy of the cached StatusResponse of a node. The
+version is incremented whenever the content of the StatusResponse changes.
+*/
+typedef struct
+{
+    tStatusResponse     statusResponse;     ///< Copy of the StatusResponse
+    UINT32              version;            ///< Version of the StatusResponse
+    UINT32              age;                ///< Time in ms since the StatusResponse was received
+} tStatusuSnapshot;
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
@@ -66,6 +79,10 @@ tOplkError statusu_addInstance(void);
 tOplkError statusu_delInstance(void);
 tOplkError statusu_reset(void);
 tOplkError statusu_requestStatusResponse(UINT nodeId_p, tStatusuCbResponse pfnCbResponse_p);
+tOplkError statusu_requestCachedStatusResponse(UINT nodeId_p, tStatusuCbResponse pfnCbResponse_p);
+tOplkError statusu_getStatusResponseSnapshot(UINT nodeId_p, tStatusuSnapshot* pSnapshot_p);
+tOplkError statusu_registerChangeCb(tStatusuCbResponse pfnCbChange_p);
+tOplkError statusu_deregisterChangeCb(tStatusuCbResponse pfnCbChange_p);
 
 #ifdef __cplusplus
 }
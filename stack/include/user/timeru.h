@@ -45,6 +45,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <common/timer.h>
 #include <user/eventu.h>
 
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define TIMERU_TIMEOUT_INFINITE     0xFFFFFFFFUL    ///< No timer must be processed by timeru_process()
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
@@ -56,6 +61,7 @@ tOplkError timeru_init(void);
 tOplkError timeru_addInstance(void);
 tOplkError timeru_delInstance(void);
 tOplkError timeru_process(void);
+UINT32     timeru_getNextTimeout(void);
 tOplkError timeru_setTimer(tTimerHdl* pTimerHdl_p, ULONG timeInMs_p, tTimerArg argument_p);
 tOplkError timeru_modifyTimer(tTimerHdl* pTimerHdl_p, ULONG timeInMs_p, tTimerArg argument_p);
 tOplkError timeru_deleteTimer(tTimerHdl* pTimerHdl_p);
@@ -63,6 +63,24 @@ INCLUDE_DIRECTORIES(
                     ${CFG_COMPILE_LIB_CN_HW_LIB_DIR}/libomethlib/include
                    )
 
+################################################################################
+# Generate the local memory section assignments from the profile
+IF(CFG_SECTION_PROFILE AND NOT CMAKE_BUILD_TYPE STREQUAL "Debug")
+    MESSAGE(STATUS "Generating local memory section assignments from ${CFG_SECTION_PROFILE}")
+    FILE(MAKE_DIRECTORY ${PROJECT_BINARY_DIR}/include)
+    EXECUTE_PROCESS(COMMAND perl ${TOOLS_DIR}/gensections.pl --arch microblaze
+                            --profile ${CFG_SECTION_PROFILE} --elf ${CFG_SECTION_PROFILE_ELF}
+                            --budget ${CFG_SECTION_PROFILE_BUDGET} --ref ${CFG_SECTION_PROFILE_REF}
+                            --out ${PROJECT_BINARY_DIR}/include/section-profile.h
+                    RESULT_VARIABLE SECTION_PROFILE_RESULT)
+    IF(NOT SECTION_PROFILE_RESULT EQUAL 0)
+        MESSAGE(FATAL_ERROR "Generating the local memory section assignments failed!")
+    ENDIF()
+
+    INCLUDE_DIRECTORIES(${PROJECT_BINARY_DIR}/include)
+    ADD_DEFINITIONS(-DCONFIG_SECTION_PROFILE)
+ENDIF()
+
 ################################################################################
 # Set additional target specific compile flags
 ADD_DEFINITIONS("${XIL_CFLAGS} -fmessage-length=0 -mcpu=${CFG_CPU_VERSION} -ffunction-sections -fdata-sections")
@@ -93,6 +93,8 @@ The OBD defines determine the Object Dictionary.
 /**@}*/
 
 #define CONFIG_CFM_CONFIGURE_CYCLE_LENGTH          TRUE
+#define CONFIG_CFM_MAX_PARALLEL_DOWNLOADS          32
+#define CONFIG_CFM_CONF_DIGEST                     TRUE
 
 /**
 \name Service Date Object defines
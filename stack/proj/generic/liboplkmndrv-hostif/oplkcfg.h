@@ -127,6 +127,7 @@ These defines are set by the host interface ipcore settings
 #define CONFIG_DLLCAL_BUFFER_SIZE_TX_NMT            HOSTIF_SIZE_TXNMTQ
 #define CONFIG_DLLCAL_BUFFER_SIZE_TX_GEN            HOSTIF_SIZE_TXGENQ
 #define CONFIG_DLLCAL_BUFFER_SIZE_TX_SYNC           HOSTIF_SIZE_TXSYNCQ
+#define CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH           0       // no host interface queue, share the generic queue
 /**@}*/
 
 #define CONFIG_EVENT_SIZE_CIRCBUF_KERNEL_INTERNAL   2048
@@ -109,12 +109,17 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_DLL_SOC_SYNC_SHIFT_US                150
 
 // time when CN processing the isochronous task (sync callback of application and cycle preparation)
+#ifndef CONFIG_DLL_PROCESS_SYNC
 #define CONFIG_DLL_PROCESS_SYNC                     DLL_PROCESS_SYNC_ON_SOC
+#endif
 
 // Disable deferred release of rx-buffers until EdrvPcap supports it
 #define CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_SYNC    FALSE
 #define CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_ASYNC   FALSE
 
+// Record latency histograms of the cycle stages
+#define CONFIG_CYCLE_STATISTICS                     TRUE
+
 //==============================================================================
 // OBD specific defines
 //==============================================================================
@@ -122,6 +127,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Switch this define to TRUE if the stack should check the object ranges
 #define CONFIG_OBD_CHECK_OBJECT_RANGE               TRUE
 
+// Size of the hash table for the OD index lookup (power of two, must be
+// larger than the number of OD indices)
+#define CONFIG_OBD_INDEX_HASH_SIZE                  256
+
 // set this define to TRUE if there are strings or domains in OD, which
 // may be changed in object size and/or object data pointer by its object
 // callback function (called event kObdEvWrStringDomain)
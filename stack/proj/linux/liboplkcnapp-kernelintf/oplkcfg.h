@@ -93,6 +93,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Switch this define to TRUE if the stack should check the object ranges
 #define CONFIG_OBD_CHECK_OBJECT_RANGE               TRUE
 
+// Size of the hash table for the OD index lookup (power of two, must be
+// larger than the number of OD indices)
+#define CONFIG_OBD_INDEX_HASH_SIZE                  256
+
 // set this define to TRUE if there are strings or domains in OD, which
 // may be changed in object size and/or object data pointer by its object
 // callback function (called event kObdEvWrStringDomain)
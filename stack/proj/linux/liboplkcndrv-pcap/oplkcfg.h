@@ -107,6 +107,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_SYNC    FALSE
 #define CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_ASYNC   FALSE
 
+// Record latency histograms of the cycle stages
+// NOTE: Ensure that this setting is equally configured in user and kernel layer!!
+#define CONFIG_CYCLE_STATISTICS                     TRUE
+
 //==============================================================================
 // Timer module specific defines
 //==============================================================================
@@ -97,6 +97,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Switch this define to TRUE if the stack should check the object ranges
 #define CONFIG_OBD_CHECK_OBJECT_RANGE                   TRUE
 
+// Size of the hash table for the OD index lookup (power of two, must be
+// larger than the number of OD indices)
+#define CONFIG_OBD_INDEX_HASH_SIZE                      1024
+
 // set this define to TRUE if there are strings or domains in OD, which
 // may be changed in object size and/or object data pointer by its object
 // callback function (called event kObdEvWrStringDomain)
@@ -105,6 +109,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_OBD_USE_LOAD_CONCISEDCF                  TRUE
 #define CONFIG_OBD_DEF_CONCISEDCF_FILENAME              "mnobd.cdc"
 #define CONFIG_CFM_CONFIGURE_CYCLE_LENGTH               TRUE
+#define CONFIG_CFM_MAX_PARALLEL_DOWNLOADS               32
+#define CONFIG_CFM_CONF_DIGEST                          TRUE
 
 // Configure if the range from 0xA000 is used for mapping client objects.
 // openCONFIGURATOR uses this range for mapping objects.
@@ -122,9 +128,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //==============================================================================
 
 // increase the number of SDO channels, because we are master
-#define CONFIG_SDO_MAX_CONNECTION_ASND                  100
-#define CONFIG_SDO_MAX_CONNECTION_SEQ                   100
-#define CONFIG_SDO_MAX_CONNECTION_COM                   100
+// (one connection to each CN, connections are looked up in hash tables)
+#define CONFIG_SDO_MAX_CONNECTION_ASND                  254
+#define CONFIG_SDO_MAX_CONNECTION_SEQ                   254
+#define CONFIG_SDO_MAX_CONNECTION_COM                   254
 #define CONFIG_SDO_MAX_CONNECTION_UDP                   50
 
 #endif // _INC_oplkcfg_H_
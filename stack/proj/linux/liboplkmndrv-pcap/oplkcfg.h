@@ -85,6 +85,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // switch this define to TRUE to include Edrv diagnostic functions
 #define CONFIG_EDRV_USE_DIAGNOSTICS                 FALSE
 
+// switch this define to TRUE to compensate the timer latency of the cyclic Edrv
+#define CONFIG_EDRV_CYCLIC_USE_LEAD_TIME            TRUE
+
 //==============================================================================
 // Data Link Layer (DLL) specific defines
 //==============================================================================
@@ -107,6 +110,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_SYNC    FALSE
 #define CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_ASYNC   FALSE
 
+// Record latency histograms of the cycle stages
+// NOTE: Ensure that this setting is equally configured in user and kernel layer!!
+#define CONFIG_CYCLE_STATISTICS                     TRUE
+
 //==============================================================================
 // Timer module specific defines
 //==============================================================================
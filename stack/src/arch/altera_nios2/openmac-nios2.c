@@ -51,6 +51,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <io.h>
 #include <unistd.h>
 
+#if defined(OPENMAC_DMA_NAME)
+#include <sys/alt_dma.h>
+#endif
+
 #include <target/openmac.h>
 
 
@@ -95,6 +99,10 @@ typedef struct
 {
     tOpenmacIrqCb   pfnIrqCb[kOpenmacIrqLast];
     void*           pIrqCbArg[kOpenmacIrqLast];
+#if defined(OPENMAC_DMA_NAME)
+    alt_dma_txchan  dmaTxChan;      ///< Send channel of the memory-to-memory DMA
+    alt_dma_rxchan  dmaRxChan;      ///< Receive channel of the memory-to-memory DMA
+#endif
 } tOpenmacInst;
 
 //------------------------------------------------------------------------------
@@ -414,6 +422,110 @@ UINT32 openmac_timerGetTimeValue(UINT timer_p)
     return IORD_32DIRECT(OPENMAC_TIMER_BASE, offset);
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize memory-to-memory DMA
+
+This function opens the memory-to-memory DMA device named by OPENMAC_DMA_NAME
+(e.g. "/dev/dma_0") of the FPGA design.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk          The DMA is available.
+\retval kErrorNoResource  The design provides no DMA device.
+
+\ingroup module_openmac
+*/
+//------------------------------------------------------------------------------
+tOplkError openmac_dmaInit(void)
+{
+#if defined(OPENMAC_DMA_NAME)
+    instance_l.dmaTxChan = alt_dma_txchan_open(OPENMAC_DMA_NAME);
+    instance_l.dmaRxChan = alt_dma_rxchan_open(OPENMAC_DMA_NAME);
+    if ((instance_l.dmaTxChan == NULL) || (instance_l.dmaRxChan == NULL))
+    {
+        openmac_dmaExit();
+        return kErrorNoResource;
+    }
+
+    return kErrorOk;
+#else
+    return kErrorNoResource;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close memory-to-memory DMA
+
+\ingroup module_openmac
+*/
+//------------------------------------------------------------------------------
+void openmac_dmaExit(void)
+{
+#if defined(OPENMAC_DMA_NAME)
+    if (instance_l.dmaTxChan != NULL)
+        alt_dma_txchan_close(instance_l.dmaTxChan);
+    if (instance_l.dmaRxChan != NULL)
+        alt_dma_rxchan_close(instance_l.dmaRxChan);
+
+    instance_l.dmaTxChan = NULL;
+    instance_l.dmaRxChan = NULL;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Start memory-to-memory DMA transfer
+
+This function queues a transfer at the memory-to-memory DMA and returns
+immediately. The callback is called in interrupt context after the destination
+is written and gets the destination address as second argument. Transfers are
+completed in the order they are queued. The DMA
+bypasses the data cache, so both ranges are flushed.
+
+\param  pDst_p          Destination address
+\param  pSrc_p          Source address
+\param  size_p          Size of the transfer [byte]
+\param  pfnDoneCb_p     Callback called when the transfer is completed
+\param  pArg_p          Argument given to the callback
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk          The transfer is queued.
+\retval kErrorNoResource  The DMA is not available or its queue is full.
+
+\ingroup module_openmac
+*/
+//------------------------------------------------------------------------------
+tOplkError openmac_dmaCopy(void* pDst_p, const void* pSrc_p, UINT size_p,
+                           tOpenmacDmaCb pfnDoneCb_p, void* pArg_p)
+{
+#if defined(OPENMAC_DMA_NAME)
+    if (instance_l.dmaRxChan == NULL)
+        return kErrorNoResource;
+
+    alt_dcache_flush((void*)pSrc_p, size_p);
+    alt_dcache_flush(pDst_p, size_p);
+
+    // The receive channel is prepared first, so the transfer starts with the send
+    if (alt_dma_rxchan_prepare(instance_l.dmaRxChan, pDst_p, size_p,
+                               pfnDoneCb_p, pArg_p) < 0)
+        return kErrorNoResource;
+
+    if (alt_dma_txchan_send(instance_l.dmaTxChan, pSrc_p, size_p, NULL, NULL) < 0)
+        return kErrorNoResource;
+
+    return kErrorOk;
+#else
+    UNUSED_PARAMETER(pDst_p);
+    UNUSED_PARAMETER(pSrc_p);
+    UNUSED_PARAMETER(size_p);
+    UNUSED_PARAMETER(pfnDoneCb_p);
+    UNUSED_PARAMETER(pArg_p);
+
+    return kErrorNoResource;
+#endif
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -43,6 +43,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <unistd.h>
 #include <sys/alt_irq.h>
 #include <sys/alt_alarm.h>
+#include <sys/alt_timestamp.h>
 #include <oplk/oplkinc.h>
 #include <common/target.h>
 
@@ -78,6 +79,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
+static BOOL         fTimestampTimer_l = FALSE;  // HAL timestamp timer is available
+static UINT32       lastCounter_l = 0;          // last read 32 bit counter value
+static UINT32       counterHigh_l = 0;          // upper 32 bit of the cycle counter
 
 //------------------------------------------------------------------------------
 // local function prototypes
@@ -153,6 +157,10 @@ openPOWERLINK stack.
 //------------------------------------------------------------------------------
 tOplkError target_init(void)
 {
+    fTimestampTimer_l = (alt_timestamp_start() >= 0);
+    lastCounter_l = 0;
+    counterHigh_l = 0;
+
     return kErrorOk;
 }
 
@@ -187,6 +195,78 @@ void target_msleep(unsigned int milliSecond_p)
     usleep(TGTCONIO_MS_IN_US(milliSecond_p));
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get current timestamp
+
+The function returns the current timestamp in nanoseconds. Its resolution is
+the one of target_getCycleCounter().
+
+\return The function returns the timestamp in nanoseconds
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+ULONGLONG target_getCurrentTimestamp(void)
+{
+    return target_convertCyclesToNs(target_getCycleCounter());
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get cycle counter
+
+The function returns the value of the HAL timestamp timer if the system
+provides one (alt_timestamp()), otherwise the HAL system tick. The 32 bit
+hardware value is extended to 64 bit in software, therefore the function must
+be called at least once per overflow period of the hardware counter.
+
+\return The function returns the cycle counter value.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+ULONGLONG target_getCycleCounter(void)
+{
+    UINT32      counter;
+    ULONGLONG   value;
+
+    target_enableGlobalInterrupt(FALSE);
+
+    counter = fTimestampTimer_l ? (UINT32)alt_timestamp() : (UINT32)alt_nticks();
+    if (counter < lastCounter_l)
+        counterHigh_l++;
+    lastCounter_l = counter;
+    value = ((ULONGLONG)counterHigh_l << 32) | counter;
+
+    target_enableGlobalInterrupt(TRUE);
+
+    return value;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Convert cycle counter value to nanoseconds
+
+The function converts a value or a difference of values of
+target_getCycleCounter() to nanoseconds.
+
+\param  cycles_p                Cycle counter value.
+
+\return The function returns the value in nanoseconds.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+ULONGLONG target_convertCyclesToNs(ULONGLONG cycles_p)
+{
+    ULONGLONG   freq;
+
+    freq = fTimestampTimer_l ? (ULONGLONG)alt_timestamp_freq() : (ULONGLONG)alt_ticks_per_second();
+
+    return ((cycles_p / freq) * 1000000000ULL) + (((cycles_p % freq) * 1000000000ULL) / freq);
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
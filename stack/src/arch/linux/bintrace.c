@@ -0,0 +1,326 @@
+/**
+********************************************************************************
+\file   linux/bintrace.c
+
+\brief  Linux binary trace functions
+
+The file implements the binary trace module for Linux user space. Every thread
+recording trace points claims a ring on its first trace point. A ring is only
+written by its thread, so recording a trace point needs no lock. If the ring
+is full the oldest records are overwritten.
+
+\ingroup module_debug
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include <oplk/oplkinc.h>
+#include <common/target.h>
+
+#if (CONFIG_BINTRACE != FALSE)
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//          P R I V A T E   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define BINTRACE_RING_MASK      (CONFIG_BINTRACE_RING_SIZE - 1)
+
+#if ((CONFIG_BINTRACE_RING_SIZE & BINTRACE_RING_MASK) != 0)
+#error "CONFIG_BINTRACE_RING_SIZE must be a power of 2!"
+#endif
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Trace ring
+
+The structure describes the trace ring of a thread. writeIndex counts all
+records ever written to the ring. It only increases, so a reader can detect
+records which were overwritten while it copied them.
+*/
+typedef struct
+{
+    UINT32              writeIndex;                             ///< Number of records written to the ring
+    UINT32              threadId;                               ///< Linux thread ID of the owner
+    tBinTraceRecord     aRecord[CONFIG_BINTRACE_RING_SIZE];     ///< Records of the ring
+} tBinTraceRing;
+
+/**
+\brief  Trace file header
+
+The structure describes the header of a trace file. It is followed by
+ringCount ring headers (thread ID and record count, both UINT32), each
+followed by its records in chronological order.
+*/
+typedef struct
+{
+    char                aMagic[8];              ///< BINTRACE_FILE_MAGIC
+    UINT32              version;                ///< BINTRACE_FILE_VERSION
+    UINT32              recordSize;             ///< Size of a tBinTraceRecord
+    UINT32              ringCount;              ///< Number of rings in the file
+    UINT32              droppedCount;           ///< Number of trace points dropped because all rings were claimed
+} tBinTraceFileHeader;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tBinTraceRing            aRing_l[CONFIG_BINTRACE_RING_COUNT];
+static UINT32                   ringCount_l = 0;
+static UINT32                   droppedCount_l = 0;
+static __thread tBinTraceRing*  pThreadRing_l = NULL;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tBinTraceRing* claimRing(void);
+static size_t copyRing(tBinTraceRing* pRing_p, tBinTraceRecord* pRecord_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Record a trace point
+
+The function records a trace point in the ring of the calling thread. It is
+normally called through the BINTRACEx() macros.
+
+\param  traceId_p       Trace ID of the trace point.
+\param  arg0_p          First argument of the trace point.
+\param  arg1_p          Second argument of the trace point.
+\param  arg2_p          Third argument of the trace point.
+\param  arg3_p          Fourth argument of the trace point.
+
+\ingroup module_debug
+*/
+//------------------------------------------------------------------------------
+void bintrace_record(tBinTraceId traceId_p, UINT32 arg0_p, UINT32 arg1_p,
+                     UINT32 arg2_p, UINT32 arg3_p)
+{
+    tBinTraceRing*      pRing = pThreadRing_l;
+    tBinTraceRecord*    pRecord;
+    UINT32              writeIndex;
+
+    if (pRing == NULL)
+    {
+        pRing = claimRing();
+        if (pRing == NULL)
+        {
+            __atomic_add_fetch(&droppedCount_l, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+
+    writeIndex = pRing->writeIndex;
+    pRecord = &pRing->aRecord[writeIndex & BINTRACE_RING_MASK];
+    pRecord->timeStamp = target_getCurrentTimestamp();
+    pRecord->traceId = traceId_p;
+    pRecord->aArg[0] = arg0_p;
+    pRecord->aArg[1] = arg1_p;
+    pRecord->aArg[2] = arg2_p;
+    pRecord->aArg[3] = arg3_p;
+
+    // Publish the record after its content is written
+    __atomic_store_n(&pRing->writeIndex, writeIndex + 1, __ATOMIC_RELEASE);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write trace file
+
+The function writes the contents of all trace rings to a file. It can be
+called while trace points are recorded. Records which are overwritten while
+the rings are copied are omitted.
+
+\param  pFileName_p     Name of the trace file.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                Function executes correctly
+\retval kErrorNoResource        The file could not be written
+
+\ingroup module_debug
+*/
+//------------------------------------------------------------------------------
+tOplkError bintrace_writeFile(const char* pFileName_p)
+{
+    static tBinTraceRecord  aRecord[CONFIG_BINTRACE_RING_SIZE];
+    tBinTraceFileHeader     header;
+    FILE*                   pFile;
+    UINT32                  ringCount;
+    UINT32                  aRingHeader[2];
+    size_t                  recordCount;
+    UINT32                  i;
+    tOplkError              ret = kErrorOk;
+
+    pFile = fopen(pFileName_p, "wb");
+    if (pFile == NULL)
+        return kErrorNoResource;
+
+    ringCount = __atomic_load_n(&ringCount_l, __ATOMIC_ACQUIRE);
+    if (ringCount > CONFIG_BINTRACE_RING_COUNT)
+        ringCount = CONFIG_BINTRACE_RING_COUNT;
+
+    OPLK_MEMSET(&header, 0, sizeof(header));
+    OPLK_MEMCPY(header.aMagic, BINTRACE_FILE_MAGIC, sizeof(header.aMagic));
+    header.version = BINTRACE_FILE_VERSION;
+    header.recordSize = sizeof(tBinTraceRecord);
+    header.ringCount = ringCount;
+    header.droppedCount = __atomic_load_n(&droppedCount_l, __ATOMIC_RELAXED);
+
+    if (fwrite(&header, sizeof(header), 1, pFile) != 1)
+        ret = kErrorNoResource;
+
+    for (i = 0; (i < ringCount) && (ret == kErrorOk); i++)
+    {
+        recordCount = copyRing(&aRing_l[i], aRecord);
+
+        aRingHeader[0] = aRing_l[i].threadId;
+        aRingHeader[1] = (UINT32)recordCount;
+        if ((fwrite(aRingHeader, sizeof(aRingHeader), 1, pFile) != 1) ||
+            (fwrite(aRecord, sizeof(tBinTraceRecord), recordCount, pFile) != recordCount))
+            ret = kErrorNoResource;
+    }
+
+    if (fclose(pFile) != 0)
+        ret = kErrorNoResource;
+
+    return ret;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Claim a trace ring
+
+The function claims a free trace ring for the calling thread.
+
+\return The function returns the claimed ring or NULL if all rings are used.
+*/
+//------------------------------------------------------------------------------
+static tBinTraceRing* claimRing(void)
+{
+    UINT32          ringIndex;
+    tBinTraceRing*  pRing;
+
+    ringIndex = __atomic_load_n(&ringCount_l, __ATOMIC_RELAXED);
+    do
+    {
+        if (ringIndex >= CONFIG_BINTRACE_RING_COUNT)
+            return NULL;
+    } while (!__atomic_compare_exchange_n(&ringCount_l, &ringIndex, ringIndex + 1,
+                                          FALSE, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    pRing = &aRing_l[ringIndex];
+    pRing->threadId = (UINT32)syscall(SYS_gettid);
+    pThreadRing_l = pRing;
+
+    return pRing;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy the records of a trace ring
+
+The function copies the valid records of a trace ring in chronological order.
+Records which are overwritten by the owner during the copy are dropped.
+
+\param  pRing_p         Ring to copy.
+\param  pRecord_p       Buffer for CONFIG_BINTRACE_RING_SIZE records.
+
+\return The function returns the number of copied records.
+*/
+//------------------------------------------------------------------------------
+static size_t copyRing(tBinTraceRing* pRing_p, tBinTraceRecord* pRecord_p)
+{
+    UINT32      startIndex;
+    UINT32      endIndex;
+    UINT32      writeIndex;
+    UINT32      index;
+
+    endIndex = __atomic_load_n(&pRing_p->writeIndex, __ATOMIC_ACQUIRE);
+    startIndex = (endIndex > CONFIG_BINTRACE_RING_SIZE) ?
+                 (endIndex - CONFIG_BINTRACE_RING_SIZE) : 0;
+
+    for (index = startIndex; index != endIndex; index++)
+        pRecord_p[index - startIndex] = pRing_p->aRecord[index & BINTRACE_RING_MASK];
+
+    // Discard the records the owner may have overwritten during the copy,
+    // including the one written at the time writeIndex was read again.
+    writeIndex = __atomic_load_n(&pRing_p->writeIndex, __ATOMIC_ACQUIRE);
+    if ((writeIndex + 1 - startIndex) > CONFIG_BINTRACE_RING_SIZE)
+    {
+        UINT32  skipCount = writeIndex + 1 - startIndex - CONFIG_BINTRACE_RING_SIZE;
+
+        if (skipCount >= (endIndex - startIndex))
+            return 0;
+
+        memmove(pRecord_p, pRecord_p + skipCount,
+                (endIndex - startIndex - skipCount) * sizeof(tBinTraceRecord));
+        return endIndex - startIndex - skipCount;
+    }
+
+    return endIndex - startIndex;
+}
+
+/// \}
+
+#endif
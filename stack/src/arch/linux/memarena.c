@@ -0,0 +1,441 @@
+/**
+********************************************************************************
+\file   linux/memarena.c
+
+\brief  Linux memory arena functions
+
+The file implements the memory arena module for Linux user space. The arena is
+a static array which is split into blocks of power-of-two size classes on
+demand. A freed block is put into the free list of its class and reused by the
+next allocation of that class, so allocating and freeing take constant time
+and never touch the heap. Every block header stores the index of the module
+which allocated it for the per module accounting.
+
+\ingroup module_debug
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <string.h>
+#include <pthread.h>
+
+#include <oplk/oplkinc.h>
+
+#if (CONFIG_MEMARENA != FALSE)
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//          P R I V A T E   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define MEMARENA_MIN_CLASS          5                   // Smallest block is 32 bytes incl. header
+#define MEMARENA_CLASS_COUNT        32                  // Size classes up to 2^31 bytes
+#define MEMARENA_BLOCK_MAGIC_USED   0x414D4555          // "UEMA"
+#define MEMARENA_BLOCK_MAGIC_FREE   0x414D4546          // "FEMA"
+#define MEMARENA_OTHER_NAME         "(other)"
+
+#if (CONFIG_MEMARENA_MODULE_COUNT < 2)
+#error "CONFIG_MEMARENA_MODULE_COUNT must be at least 2!"
+#endif
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Block header
+
+The structure describes the header in front of every block of the arena. Its
+size keeps the payload aligned to 16 bytes. While a block is free, the first
+bytes of the payload link it into the free list of its class.
+*/
+typedef struct
+{
+    UINT32              magic;                  ///< MEMARENA_BLOCK_MAGIC_USED or MEMARENA_BLOCK_MAGIC_FREE
+    UINT8               sizeClass;              ///< The block size is 2^sizeClass bytes
+    UINT8               moduleIndex;            ///< Index of the allocating module in the report
+    UINT16              reserved;               ///< Reserved, 0
+    UINT64              padding;                ///< Pads the header to 16 bytes
+} tMemArenaBlock;
+
+/**
+\brief  Free block
+
+The structure describes a block in the free list of its class.
+*/
+typedef struct sMemArenaFreeBlock
+{
+    tMemArenaBlock              header;         ///< Block header
+    struct sMemArenaFreeBlock*  pNext;          ///< Next free block of the class
+} tMemArenaFreeBlock;
+
+/**
+\brief  Arena storage
+
+The union reserves the arena and aligns it to 16 bytes.
+*/
+typedef union
+{
+    UINT8               aByte[CONFIG_MEMARENA_SIZE];            ///< Bytes of the arena
+    tMemArenaBlock      aAlign[1];                              ///< Aligns the arena to the block header
+} tMemArenaStorage;
+
+/**
+\brief  Memory arena instance
+
+The structure contains all variables of the memory arena module. The report is
+updated in place, so memarena_getReport() only needs to copy it.
+*/
+typedef struct
+{
+    size_t                  carveOffset;                            ///< Offset of the first byte not yet split into blocks
+    tMemArenaFreeBlock*     apFreeList[MEMARENA_CLASS_COUNT];       ///< Free lists of the size classes
+    const char*             apModuleFile[CONFIG_MEMARENA_MODULE_COUNT]; ///< __FILE__ of the modules in the report
+    BOOL                    fInitDone;                              ///< oplk_init() has returned
+    tMemArenaReport         report;                                 ///< Usage report
+} tMemArenaInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tMemArenaStorage     arena_l;
+static tMemArenaInstance    instance_l;
+static pthread_mutex_t      mutex_l = PTHREAD_MUTEX_INITIALIZER;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static UINT                 getSizeClass(size_t size_p);
+static UINT                 getModuleIndex(const char* pModule_p);
+static tMemArenaFreeBlock*  getBlock(UINT sizeClass_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Allocate memory from the arena
+
+The function allocates a block from the arena. It is called by OPLK_MALLOC().
+If no block of the required class is free, a new block is split from the
+unused part of the arena. If the arena is exhausted, a free block of a larger
+class is used instead.
+
+\param  size_p              Number of bytes to allocate.
+\param  pModule_p           File name of the allocating module (__FILE__).
+
+\return The function returns a pointer to the allocated memory or NULL if the
+        arena is exhausted.
+
+\ingroup module_debug
+*/
+//------------------------------------------------------------------------------
+void* memarena_alloc(size_t size_p, const char* pModule_p)
+{
+    tMemArenaFreeBlock*     pBlock;
+    tMemArenaModuleReport*  pModule;
+    UINT                    sizeClass;
+    size_t                  blockSize;
+
+    sizeClass = getSizeClass(size_p);
+
+    pthread_mutex_lock(&mutex_l);
+
+    pBlock = (sizeClass < MEMARENA_CLASS_COUNT) ? getBlock(sizeClass) : NULL;
+    if (pBlock == NULL)
+    {
+        instance_l.report.failedCount++;
+        pthread_mutex_unlock(&mutex_l);
+        DEBUG_LVL_ERROR_TRACE("%s() Arena exhausted, %lu bytes requested by %s\n",
+                              __func__, (ULONG)size_p, pModule_p);
+        return NULL;
+    }
+
+    blockSize = (size_t)1 << pBlock->header.sizeClass;
+    pBlock->header.magic = MEMARENA_BLOCK_MAGIC_USED;
+    pBlock->header.moduleIndex = (UINT8)getModuleIndex(pModule_p);
+
+    pModule = &instance_l.report.aModule[pBlock->header.moduleIndex];
+    pModule->usedBytes += blockSize;
+    if (pModule->usedBytes > pModule->peakBytes)
+        pModule->peakBytes = pModule->usedBytes;
+    pModule->allocCount++;
+    if (instance_l.fInitDone)
+        pModule->lateAllocCount++;
+
+    instance_l.report.usedBytes += blockSize;
+    if (instance_l.report.usedBytes > instance_l.report.peakBytes)
+        instance_l.report.peakBytes = instance_l.report.usedBytes;
+
+    pthread_mutex_unlock(&mutex_l);
+
+    return &pBlock->header + 1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Free memory of the arena
+
+The function returns a block to the free list of its class. It is called by
+OPLK_FREE(). Pointers which do not belong to an allocated block of the arena
+are rejected with an error trace.
+
+\param  pMem_p              Pointer to the memory to free. NULL is ignored.
+
+\ingroup module_debug
+*/
+//------------------------------------------------------------------------------
+void memarena_free(void* pMem_p)
+{
+    tMemArenaFreeBlock*     pBlock;
+    tMemArenaModuleReport*  pModule;
+    size_t                  blockSize;
+
+    if (pMem_p == NULL)
+        return;
+
+    pBlock = (tMemArenaFreeBlock*)((tMemArenaBlock*)pMem_p - 1);
+
+    pthread_mutex_lock(&mutex_l);
+
+    if (((UINT8*)pBlock < arena_l.aByte) ||
+        ((UINT8*)pBlock >= (arena_l.aByte + instance_l.carveOffset)) ||
+        (pBlock->header.magic != MEMARENA_BLOCK_MAGIC_USED))
+    {
+        pthread_mutex_unlock(&mutex_l);
+        DEBUG_LVL_ERROR_TRACE("%s() Invalid pointer %p\n", __func__, pMem_p);
+        return;
+    }
+
+    blockSize = (size_t)1 << pBlock->header.sizeClass;
+    pModule = &instance_l.report.aModule[pBlock->header.moduleIndex];
+    pModule->usedBytes -= blockSize;
+    pModule->freeCount++;
+    instance_l.report.usedBytes -= blockSize;
+
+    pBlock->header.magic = MEMARENA_BLOCK_MAGIC_FREE;
+    pBlock->pNext = instance_l.apFreeList[pBlock->header.sizeClass];
+    instance_l.apFreeList[pBlock->header.sizeClass] = pBlock;
+
+    pthread_mutex_unlock(&mutex_l);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Mark the end of the stack initialization
+
+The function is called when oplk_init() returns. Allocations after this point
+are counted as late allocations in the report. They are still served from the
+arena, but they show which part of CONFIG_MEMARENA_SIZE is needed at runtime.
+
+\ingroup module_debug
+*/
+//------------------------------------------------------------------------------
+void memarena_setInitDone(void)
+{
+    pthread_mutex_lock(&mutex_l);
+    instance_l.fInitDone = TRUE;
+    pthread_mutex_unlock(&mutex_l);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the memory arena report
+
+The function copies the usage report of the memory arena.
+
+\param  pReport_p           Pointer to store the report.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                The report was copied.
+\retval kErrorInvalidOperation  pReport_p is NULL.
+
+\ingroup module_debug
+*/
+//------------------------------------------------------------------------------
+tOplkError memarena_getReport(tMemArenaReport* pReport_p)
+{
+    if (pReport_p == NULL)
+        return kErrorInvalidOperation;
+
+    pthread_mutex_lock(&mutex_l);
+    *pReport_p = instance_l.report;
+    pthread_mutex_unlock(&mutex_l);
+
+    pReport_p->arenaSize = CONFIG_MEMARENA_SIZE;
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the size class of an allocation
+
+\param  size_p              Number of bytes requested.
+
+\return The function returns the smallest size class whose blocks can hold the
+        requested bytes and the block header.
+*/
+//------------------------------------------------------------------------------
+static UINT getSizeClass(size_t size_p)
+{
+    UINT    sizeClass = MEMARENA_MIN_CLASS;
+
+    if (size_p > CONFIG_MEMARENA_SIZE)
+        return MEMARENA_CLASS_COUNT;
+
+    size_p += sizeof(tMemArenaBlock);
+    while (((size_t)1 << sizeClass) < size_p)
+        sizeClass++;
+
+    return sizeClass;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get a free block
+
+The function takes a block of the size class from its free list or splits a
+new one from the unused part of the arena. As a last resort, a free block of a
+larger class is taken. The function must be called with the mutex locked.
+
+\param  sizeClass_p         Size class of the block.
+
+\return The function returns the block or NULL if no block is available.
+*/
+//------------------------------------------------------------------------------
+static tMemArenaFreeBlock* getBlock(UINT sizeClass_p)
+{
+    tMemArenaFreeBlock*     pBlock;
+    size_t                  blockSize = (size_t)1 << sizeClass_p;
+    UINT                    sizeClass;
+
+    pBlock = instance_l.apFreeList[sizeClass_p];
+    if (pBlock != NULL)
+    {
+        instance_l.apFreeList[sizeClass_p] = pBlock->pNext;
+        return pBlock;
+    }
+
+    if (blockSize <= (CONFIG_MEMARENA_SIZE - instance_l.carveOffset))
+    {
+        pBlock = (tMemArenaFreeBlock*)(arena_l.aByte + instance_l.carveOffset);
+        instance_l.carveOffset += blockSize;
+        instance_l.report.carvedBytes = instance_l.carveOffset;
+        pBlock->header.sizeClass = (UINT8)sizeClass_p;
+        pBlock->header.reserved = 0;
+        pBlock->header.padding = 0;
+        return pBlock;
+    }
+
+    for (sizeClass = sizeClass_p + 1; sizeClass < MEMARENA_CLASS_COUNT; sizeClass++)
+    {
+        pBlock = instance_l.apFreeList[sizeClass];
+        if (pBlock != NULL)
+        {
+            instance_l.apFreeList[sizeClass] = pBlock->pNext;
+            return pBlock;
+        }
+    }
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the report index of a module
+
+The function looks up the module in the report and adds it if it is not yet
+known. If the table is full, the last entry collects all remaining modules.
+The function must be called with the mutex locked.
+
+\param  pModule_p           File name of the module (__FILE__).
+
+\return The function returns the index of the module in the report.
+*/
+//------------------------------------------------------------------------------
+static UINT getModuleIndex(const char* pModule_p)
+{
+    tMemArenaReport*        pReport = &instance_l.report;
+    const char*             pName;
+    UINT                    index;
+
+    if (pModule_p == NULL)
+        pModule_p = MEMARENA_OTHER_NAME;
+
+    for (index = 0; index < pReport->moduleCount; index++)
+    {
+        if ((instance_l.apModuleFile[index] == pModule_p) ||
+            (strcmp(instance_l.apModuleFile[index], pModule_p) == 0))
+            return index;
+    }
+
+    if (index == (CONFIG_MEMARENA_MODULE_COUNT - 1))
+        pModule_p = MEMARENA_OTHER_NAME;
+
+    if (index >= CONFIG_MEMARENA_MODULE_COUNT)
+        return CONFIG_MEMARENA_MODULE_COUNT - 1;
+
+    pName = strrchr(pModule_p, '/');
+    pName = (pName != NULL) ? (pName + 1) : pModule_p;
+    strncpy(pReport->aModule[index].aName, pName, MEMARENA_MODULE_NAME_LENGTH - 1);
+    instance_l.apModuleFile[index] = pModule_p;
+    pReport->moduleCount++;
+
+    return index;
+}
+
+/// \}
+
+#endif
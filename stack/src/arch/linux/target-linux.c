@@ -41,10 +41,119 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 #include <unistd.h>
 #include <fcntl.h>
+#include <stdio.h>
 #include <signal.h>
 #include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include <string.h>
+#include <malloc.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#include <cpuid.h>
+#define TARGET_USE_TSC          TRUE
+#else
+#define TARGET_USE_TSC          FALSE
+#endif
 
 #include <oplk/oplk.h>
+#include <common/target.h>
+
+#if (CONFIG_TARGET_CACHE_ALLOC != FALSE)
+#include <common/metrics.h>
+#include <linux/perf_event.h>
+#endif
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define TARGET_TSC_CALIBRATION_NS       2000000     // duration of the TSC frequency measurement
+#define TARGET_MPOL_BIND                2           // MPOL_BIND of <numaif.h>, libnuma is not required
+#define TARGET_MPOL_MAX_NODES           (sizeof(unsigned long) * 8)
+
+#define TARGET_CACHE_ALLOC_COUNTERS     32          // cache miss counters of the realtime threads
+#define TARGET_CACHE_ALLOC_DOMAINS      8           // L3 monitoring domains which are summed up
+#define TARGET_CACHE_ALLOC_UPDATE_MS    1000        // minimum period of the cache metrics update
+#define TARGET_CACHE_ALLOC_L3_PATH      "/sys/devices/system/cpu/cpu0/cache/index3"
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+#if (CONFIG_TARGET_CACHE_ALLOC != FALSE)
+/**
+\brief  Start parameters of a thread in the cache allocation group
+
+The structure contains the thread function and its argument, which are called
+after the new thread assigned itself to the cache allocation group.
+*/
+typedef struct
+{
+    void*               (*pfnThread)(void*);            ///< Thread function
+    void*               pArg;                           ///< Argument of the thread function
+} tCacheAllocThreadStart;
+
+/**
+\brief  Cache allocation instance
+
+The structure contains the state of the cache allocation group of the
+realtime threads.
+*/
+typedef struct
+{
+    BOOL                fGroupValid;                    ///< The resctrl group is accessible
+    UINT64              reservedBytes;                  ///< L3 cache reserved by the group in domain 0 (0 = unknown)
+#if (CONFIG_METRICS != FALSE)
+    pthread_mutex_t     counterLock;                    ///< Protects the table of miss counters
+    int                 aMissCounterFd[TARGET_CACHE_ALLOC_COUNTERS];    ///< Cache miss counters of the threads
+    UINT                missCounterCount;               ///< Number of valid entries in aMissCounterFd
+    UINT32              lastUpdateTick;                 ///< Tick count of the last metrics update
+    BOOL                fMetricsRegistered;             ///< The metrics are registered
+    tMetric*            pMetricReserved;                ///< Metric of the reserved cache size
+    tMetric*            pMetricOccupancy;               ///< Metric of the cache occupancy of the group
+    tMetric*            pMetricMisses;                  ///< Metric of the cache misses of the threads
+#endif
+} tCacheAllocInstance;
+#endif
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static ULONGLONG    cycleCounterFreq_l = 1000000000ULL;     // cycle counter frequency in Hz
+static tThreadParam aThreadParam_l[kThreadRoleCount];       // thread placement of the application
+#if (TARGET_USE_TSC != FALSE)
+static BOOL         fUseTsc_l = FALSE;
+#endif
+#if (CONFIG_TARGET_CACHE_ALLOC != FALSE)
+static tCacheAllocInstance  cacheAlloc_l;
+#endif
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError setSchedParams(pthread_t thread_p, tThreadSchedPolicy policy_p, INT priority_p);
+static tOplkError setCpuAffinity(pthread_t thread_p, UINT32 cpuMask_p);
+static BOOL       bindMemory(UINT32 nodeMask_p, int* pOldMode_p, unsigned long* pOldNodeMask_p);
+static void       reportThreadPlacement(pthread_t thread_p, UINT32 nodeMask_p);
+#if (CONFIG_MEMLOCK_ALL != FALSE)
+static void lockMemory(void);
+#endif
+#if (TARGET_USE_TSC != FALSE)
+static void calibrateTsc(void);
+#endif
+#if (CONFIG_TARGET_CACHE_ALLOC != FALSE)
+static void       initCacheAlloc(void);
+static void       exitCacheAlloc(void);
+static UINT64     getReservedCacheSize(void);
+static BOOL       readFileLine(const char* pPath_p, const char* pPrefix_p, char* pBuffer_p, size_t size_p);
+static void*      startCacheAllocThread(void* pArg_p);
+#endif
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -74,6 +183,18 @@ tOplkError target_init(void)
     sigaddset(&mask, SIGRTMIN + 1);
     pthread_sigmask(SIG_BLOCK, &mask, NULL);
 
+#if (CONFIG_MEMLOCK_ALL != FALSE)
+    lockMemory();
+#endif
+
+#if (TARGET_USE_TSC != FALSE)
+    calibrateTsc();
+#endif
+
+#if (CONFIG_TARGET_CACHE_ALLOC != FALSE)
+    initCacheAlloc();
+#endif
+
     return Ret;
 }
 
@@ -89,6 +210,11 @@ The function cleans up target specific stuff.
 tOplkError target_cleanup(void)
 {
     tOplkError  Ret  = kErrorOk;
+
+#if (CONFIG_TARGET_CACHE_ALLOC != FALSE)
+    exitCacheAlloc();
+#endif
+
     return Ret;
 }
 
@@ -254,3 +380,796 @@ UINT32 target_getTickCount(void)
     return ticks;
 }
 
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get current timestamp
+
+The function returns the current timestamp in nanoseconds.
+
+\return The function returns the timestamp in nanoseconds
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+ULONGLONG target_getCurrentTimestamp(void)
+{
+    ULONGLONG               timeStamp;
+    struct timespec         curTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &curTime);
+    timeStamp = ((ULONGLONG)curTime.tv_sec * 1000000000ULL) + (ULONGLONG)curTime.tv_nsec;
+
+    return timeStamp;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Convert a realtime clock value to a timestamp
+
+The function converts a CLOCK_REALTIME value, e.g. the kernel receive time
+stamp of a frame, to the time base of target_getCurrentTimestamp()
+(CLOCK_MONOTONIC). The offset between both clocks is sampled at the time of
+the call, so the value should be converted soon after it was taken.
+
+\param  realtime_p              CLOCK_REALTIME value in nanoseconds.
+
+\return The function returns the timestamp in nanoseconds.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+ULONGLONG target_convertRealtimeToTimestamp(ULONGLONG realtime_p)
+{
+    struct timespec         realTime;
+    struct timespec         monoTime;
+    ULONGLONG               offset;
+
+    clock_gettime(CLOCK_REALTIME, &realTime);
+    clock_gettime(CLOCK_MONOTONIC, &monoTime);
+    offset = (((ULONGLONG)realTime.tv_sec * 1000000000ULL) + (ULONGLONG)realTime.tv_nsec) -
+             (((ULONGLONG)monoTime.tv_sec * 1000000000ULL) + (ULONGLONG)monoTime.tv_nsec);
+
+    return realtime_p - offset;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get cycle counter
+
+The function returns the value of a free running counter with the lowest read
+overhead available. On x86 CPUs with an invariant TSC it is the time stamp
+counter, otherwise it is CLOCK_MONOTONIC in nanoseconds. The value can be
+converted with target_convertCyclesToNs(). The TSC is only used after
+target_init() measured its frequency.
+
+\return The function returns the cycle counter value.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+ULONGLONG target_getCycleCounter(void)
+{
+#if (TARGET_USE_TSC != FALSE)
+    if (fUseTsc_l)
+        return __builtin_ia32_rdtsc();
+#endif
+
+    return target_getCurrentTimestamp();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Convert cycle counter value to nanoseconds
+
+The function converts a value or a difference of values of
+target_getCycleCounter() to nanoseconds.
+
+\param  cycles_p                Cycle counter value.
+
+\return The function returns the value in nanoseconds.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+ULONGLONG target_convertCyclesToNs(ULONGLONG cycles_p)
+{
+    if (cycleCounterFreq_l == 1000000000ULL)
+        return cycles_p;
+
+    return ((cycles_p / cycleCounterFreq_l) * 1000000000ULL) +
+           (((cycles_p % cycleCounterFreq_l) * 1000000000ULL) / cycleCounterFreq_l);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set the thread placement of the application
+
+The function stores the thread placement which is specified by the application
+in the initialization parameters. It is used by target_createThread() and
+target_setThreadParams() for all threads which are created afterwards.
+Zero-initialized entries select the stack defaults of the role.
+
+\param  paThreadParam_p         Table of thread parameters, indexed by
+                                tThreadRole. If it is NULL the stack
+                                defaults are used for all roles.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+void target_setThreadConfig(const tThreadParam* paThreadParam_p)
+{
+    if (paThreadParam_p == NULL)
+        OPLK_MEMSET(aThreadParam_l, 0, sizeof(aThreadParam_l));
+    else
+        OPLK_MEMCPY(aThreadParam_l, paThreadParam_p, sizeof(aThreadParam_l));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Create a stack thread
+
+The function creates and names a thread of the openPOWERLINK stack. If the
+application specified NUMA nodes for the role of the thread, the thread is
+created with a memory policy which binds its allocations (e.g. its stack) to
+these nodes. With CONFIG_TARGET_CACHE_ALLOC the threads of the roles in
+CONFIG_TARGET_CACHE_ALLOC_ROLES assign themselves to the cache allocation group
+before they run the thread function. The scheduling parameters are set by
+target_setThreadParams() afterwards.
+
+\param  pThread_p               Pointer to store the created thread.
+\param  role_p                  Role of the thread.
+\param  pName_p                 Name of the thread.
+\param  pfnThread_p             Thread function.
+\param  pArg_p                  Argument of the thread function.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+tOplkError target_createThread(pthread_t* pThread_p, tThreadRole role_p, const char* pName_p,
+                               void* (*pfnThread_p)(void*), void* pArg_p)
+{
+    int                     oldMode = 0;
+    unsigned long           oldNodeMask = 0;
+    BOOL                    fMemBound;
+    int                     result;
+#if (CONFIG_TARGET_CACHE_ALLOC != FALSE)
+    tCacheAllocThreadStart* pStart = NULL;
+#endif
+
+    if (role_p >= kThreadRoleCount)
+        return kErrorInvalidInstanceParam;
+
+#if (CONFIG_TARGET_CACHE_ALLOC != FALSE)
+    if (cacheAlloc_l.fGroupValid && ((CONFIG_TARGET_CACHE_ALLOC_ROLES & (1UL << role_p)) != 0))
+    {
+        pStart = (tCacheAllocThreadStart*)OPLK_MALLOC(sizeof(tCacheAllocThreadStart));
+        if (pStart != NULL)
+        {
+            pStart->pfnThread = pfnThread_p;
+            pStart->pArg = pArg_p;
+            pfnThread_p = startCacheAllocThread;
+            pArg_p = pStart;
+        }
+    }
+#endif
+
+    // The memory policy of the calling thread is inherited by the new thread
+    fMemBound = bindMemory(aThreadParam_l[role_p].numaNodeMask, &oldMode, &oldNodeMask);
+
+    result = pthread_create(pThread_p, NULL, pfnThread_p, pArg_p);
+
+    if (fMemBound)
+        syscall(SYS_set_mempolicy, oldMode, &oldNodeMask, TARGET_MPOL_MAX_NODES + 1);
+
+    if (result != 0)
+    {
+#if (CONFIG_TARGET_CACHE_ALLOC != FALSE)
+        if (pStart != NULL)
+            OPLK_FREE(pStart);
+#endif
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't create thread %s (%d)!\n", __func__, pName_p, result);
+        return kErrorNoResource;
+    }
+
+#if (defined(__GLIBC__) && __GLIBC__ >= 2 && __GLIBC_MINOR__ >= 12)
+    pthread_setname_np(*pThread_p, pName_p);
+#endif
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set realtime parameters of a thread
+
+The function sets the scheduling policy and priority of a stack thread and pins
+it to CPUs. The parameters of the application (see target_setThreadConfig())
+override the stack defaults of the role. To get deterministic short cycles the
+realtime threads should be pinned to CPUs which are isolated by the kernel
+parameter isolcpus. The effective placement of the thread is reported by a
+trace message.
+
+\param  thread_p                Thread to configure.
+\param  role_p                  Role of the thread.
+\param  policy_p                Default scheduling policy of the role. If it is
+                                kThreadSchedDefault the thread keeps its
+                                inherited scheduling parameters by default.
+\param  priority_p              Default realtime priority of the role.
+\param  cpuMask_p               Default CPU affinity mask of the role
+                                (bit n = CPU n). If it is 0 the affinity is
+                                not changed by default.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+tOplkError target_setThreadParams(pthread_t thread_p, tThreadRole role_p,
+                                  tThreadSchedPolicy policy_p, INT priority_p, UINT32 cpuMask_p)
+{
+    const tThreadParam*     pAppParam;
+    tOplkError              ret = kErrorOk;
+
+    if (role_p >= kThreadRoleCount)
+        return kErrorInvalidInstanceParam;
+
+    pAppParam = &aThreadParam_l[role_p];
+    if (pAppParam->schedPolicy != kThreadSchedDefault)
+    {
+        policy_p = pAppParam->schedPolicy;
+        priority_p = pAppParam->priority;
+    }
+
+    if (pAppParam->cpuMask != 0)
+        cpuMask_p = pAppParam->cpuMask;
+
+    if (policy_p != kThreadSchedDefault)
+        ret = setSchedParams(thread_p, policy_p, priority_p);
+
+    if (ret == kErrorOk)
+        ret = setCpuAffinity(thread_p, cpuMask_p);
+
+    reportThreadPlacement(thread_p, pAppParam->numaNodeMask);
+
+    return ret;
+}
+
+#if (CONFIG_TARGET_CACHE_ALLOC != FALSE) && (CONFIG_METRICS != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Update the cache metrics
+
+The function updates the metrics of the cache allocation group: the reserved
+L3 cache size, the L3 occupancy of the group, if the resctrl monitoring is
+available, and the sum of the cache misses of the realtime threads. The
+function is called by the processing of the user layer, it reads the counters
+at most every TARGET_CACHE_ALLOC_UPDATE_MS.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+void target_updateCacheMetrics(void)
+{
+    char        aPath[256];
+    char        aLine[32];
+    UINT64      occupancy = 0;
+    UINT64      misses = 0;
+    UINT64      value;
+    UINT32      tick;
+    UINT        i;
+
+    if (!cacheAlloc_l.fGroupValid)
+        return;
+
+    tick = target_getTickCount();
+    if (cacheAlloc_l.fMetricsRegistered &&
+        ((UINT32)(tick - cacheAlloc_l.lastUpdateTick) < TARGET_CACHE_ALLOC_UPDATE_MS))
+        return;
+
+    cacheAlloc_l.lastUpdateTick = tick;
+
+    // The registry is initialized after target_init()
+    if (!cacheAlloc_l.fMetricsRegistered)
+    {
+        METRICS_REGISTER("target.l3_reserved_bytes", kMetricTypeGauge, &cacheAlloc_l.pMetricReserved);
+        METRICS_REGISTER("target.l3_occupancy_bytes", kMetricTypeGauge, &cacheAlloc_l.pMetricOccupancy);
+        METRICS_REGISTER("target.rt_cache_misses", kMetricTypeCounter, &cacheAlloc_l.pMetricMisses);
+        METRICS_SET(cacheAlloc_l.pMetricReserved, cacheAlloc_l.reservedBytes);
+        cacheAlloc_l.fMetricsRegistered = TRUE;
+    }
+
+    for (i = 0; i < TARGET_CACHE_ALLOC_DOMAINS; i++)
+    {
+        snprintf(aPath, sizeof(aPath), "%s/mon_data/mon_L3_%02u/llc_occupancy",
+                 CONFIG_TARGET_CACHE_ALLOC_GROUP, i);
+        if (!readFileLine(aPath, "", aLine, sizeof(aLine)))
+            break;
+
+        occupancy += strtoull(aLine, NULL, 10);
+    }
+    METRICS_SET(cacheAlloc_l.pMetricOccupancy, occupancy);
+
+    pthread_mutex_lock(&cacheAlloc_l.counterLock);
+    for (i = 0; i < cacheAlloc_l.missCounterCount; i++)
+    {
+        if (read(cacheAlloc_l.aMissCounterFd[i], &value, sizeof(value)) == sizeof(value))
+            misses += value;
+    }
+    pthread_mutex_unlock(&cacheAlloc_l.counterLock);
+    METRICS_SET(cacheAlloc_l.pMetricMisses, misses);
+}
+#endif
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set the scheduling parameters of a thread
+
+\param  thread_p                Thread to configure.
+\param  policy_p                Scheduling policy of the thread.
+\param  priority_p              Realtime priority of the thread.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError setSchedParams(pthread_t thread_p, tThreadSchedPolicy policy_p, INT priority_p)
+{
+    struct sched_param      schedParam;
+    int                     policy;
+
+    switch (policy_p)
+    {
+        case kThreadSchedFifo:
+            policy = SCHED_FIFO;
+            break;
+
+        case kThreadSchedRr:
+            policy = SCHED_RR;
+            break;
+
+        default:
+            policy = SCHED_OTHER;
+            priority_p = 0;
+            break;
+    }
+
+    schedParam.sched_priority = priority_p;
+    if (pthread_setschedparam(thread_p, policy, &schedParam) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't set policy %d priority %d!\n",
+                              __func__, policy, priority_p);
+        return kErrorNoResource;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set the CPU affinity of a thread
+
+\param  thread_p                Thread to configure.
+\param  cpuMask_p               CPU affinity mask of the thread (bit n = CPU n).
+                                If it is 0 the affinity is not changed.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError setCpuAffinity(pthread_t thread_p, UINT32 cpuMask_p)
+{
+    cpu_set_t               cpuSet;
+    UINT                    cpu;
+
+    if (cpuMask_p == 0)
+        return kErrorOk;
+
+    CPU_ZERO(&cpuSet);
+    for (cpu = 0; cpu < 32; cpu++)
+    {
+        if ((cpuMask_p & (1UL << cpu)) != 0)
+            CPU_SET(cpu, &cpuSet);
+    }
+
+    if (pthread_setaffinity_np(thread_p, sizeof(cpuSet), &cpuSet) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't set CPU affinity 0x%X!\n", __func__, cpuMask_p);
+        return kErrorNoResource;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Bind the memory of the calling thread to NUMA nodes
+
+The function binds the memory allocations of the calling thread to the
+specified NUMA nodes. The previous memory policy is returned so that the caller
+is able to restore it.
+
+\param  nodeMask_p              NUMA nodes (bit n = node n). If it is 0 the
+                                memory policy is not changed.
+\param  pOldMode_p              Pointer to store the previous policy mode.
+\param  pOldNodeMask_p          Pointer to store the previous node mask.
+
+\return The function returns TRUE if the memory policy was changed.
+*/
+//------------------------------------------------------------------------------
+static BOOL bindMemory(UINT32 nodeMask_p, int* pOldMode_p, unsigned long* pOldNodeMask_p)
+{
+    unsigned long   nodeMask = nodeMask_p;
+
+    if (nodeMask_p == 0)
+        return FALSE;
+
+    if (syscall(SYS_get_mempolicy, pOldMode_p, pOldNodeMask_p, TARGET_MPOL_MAX_NODES,
+                NULL, 0UL) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't get memory policy (%s)\n", __func__, strerror(errno));
+        return FALSE;
+    }
+
+    if (syscall(SYS_set_mempolicy, TARGET_MPOL_BIND, &nodeMask, TARGET_MPOL_MAX_NODES + 1) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't bind memory to NUMA nodes 0x%X (%s)\n",
+                              __func__, nodeMask_p, strerror(errno));
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Report the effective placement of a thread
+
+\param  thread_p                Thread to report.
+\param  nodeMask_p              NUMA nodes the memory of the thread is bound to.
+*/
+//------------------------------------------------------------------------------
+static void reportThreadPlacement(pthread_t thread_p, UINT32 nodeMask_p)
+{
+    struct sched_param      schedParam;
+    int                     policy;
+    cpu_set_t               cpuSet;
+    UINT32                  cpuMask = 0;
+    UINT                    cpu;
+    char                    aName[16] = "";
+
+    UNUSED_PARAMETER(nodeMask_p);
+
+    if ((pthread_getschedparam(thread_p, &policy, &schedParam) != 0) ||
+        (pthread_getaffinity_np(thread_p, sizeof(cpuSet), &cpuSet) != 0))
+        return;
+
+    for (cpu = 0; cpu < 32; cpu++)
+    {
+        if (CPU_ISSET(cpu, &cpuSet))
+            cpuMask |= (1UL << cpu);
+    }
+
+#if (defined(__GLIBC__) && __GLIBC__ >= 2 && __GLIBC_MINOR__ >= 12)
+    pthread_getname_np(thread_p, aName, sizeof(aName));
+#endif
+
+    DEBUG_LVL_ALWAYS_TRACE("Thread %s: %s priority %d, CPUs 0x%08X, NUMA nodes 0x%X\n",
+                           aName,
+                           (policy == SCHED_FIFO) ? "SCHED_FIFO" :
+                           ((policy == SCHED_RR) ? "SCHED_RR" : "SCHED_OTHER"),
+                           schedParam.sched_priority, cpuMask, nodeMask_p);
+}
+
+#if (CONFIG_MEMLOCK_ALL != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Lock and pre-fault the memory of the process
+
+The function locks all current and future memory of the process into RAM.
+Locked mappings are populated by the kernel, therefore the PDO memory, the
+circular buffers and the Tx/Rx buffers which are allocated by the stack later
+on are already resident when the first cycle starts. The same applies to the
+stacks of the threads created by the stack. Memory freed with free() is kept in
+the process so that it needs not to be faulted in again. The stack of the
+calling thread is pre-faulted up to CONFIG_MEMLOCK_STACK_PREFAULT bytes.
+
+If the memory cannot be locked (e.g. missing CAP_IPC_LOCK or RLIMIT_MEMLOCK too
+small) the stack continues without locked memory.
+*/
+//------------------------------------------------------------------------------
+static void lockMemory(void)
+{
+    volatile UINT8  aStackPrefault[CONFIG_MEMLOCK_STACK_PREFAULT];
+    size_t          offset;
+
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() mlockall failed (%s)\n", __func__, strerror(errno));
+        return;
+    }
+
+    for (offset = 0; offset < sizeof(aStackPrefault); offset += 1024)
+        aStackPrefault[offset] = 0;
+}
+#endif
+
+#if (TARGET_USE_TSC != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Calibrate the time stamp counter
+
+The function checks if the CPU provides an invariant TSC, i.e. a TSC which runs
+with a constant rate in all power states. If so, its frequency is measured
+against CLOCK_MONOTONIC and target_getCycleCounter() switches to the TSC.
+*/
+//------------------------------------------------------------------------------
+static void calibrateTsc(void)
+{
+    unsigned int    eax;
+    unsigned int    ebx;
+    unsigned int    ecx;
+    unsigned int    edx;
+    ULONGLONG       startTime;
+    ULONGLONG       endTime;
+    ULONGLONG       startTsc;
+    ULONGLONG       endTsc;
+
+    if (fUseTsc_l)
+        return;
+
+    if ((__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0) || ((edx & (1 << 8)) == 0))
+        return;     // no invariant TSC
+
+    startTime = target_getCurrentTimestamp();
+    startTsc = __builtin_ia32_rdtsc();
+    do
+    {
+        endTime = target_getCurrentTimestamp();
+        endTsc = __builtin_ia32_rdtsc();
+    } while ((endTime - startTime) < TARGET_TSC_CALIBRATION_NS);
+
+    cycleCounterFreq_l = ((endTsc - startTsc) * 1000000000ULL) / (endTime - startTime);
+    fUseTsc_l = TRUE;
+}
+#endif
+
+#if (CONFIG_TARGET_CACHE_ALLOC != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the cache allocation group
+
+The function checks that the resctrl group CONFIG_TARGET_CACHE_ALLOC_GROUP can
+be joined and reports the size of the L3 cache it reserves. The working set of
+the realtime threads (PDO memory, circular buffers, DLL instance) should fit
+into this size. If the group is not accessible, the threads run without cache
+allocation.
+*/
+//------------------------------------------------------------------------------
+static void initCacheAlloc(void)
+{
+    char    aPath[256];
+
+    OPLK_MEMSET(&cacheAlloc_l, 0, sizeof(cacheAlloc_l));
+
+    snprintf(aPath, sizeof(aPath), "%s/tasks", CONFIG_TARGET_CACHE_ALLOC_GROUP);
+    if (access(aPath, W_OK) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() can't join cache allocation group %s (%s)\n",
+                              __func__, CONFIG_TARGET_CACHE_ALLOC_GROUP, strerror(errno));
+        return;
+    }
+
+#if (CONFIG_METRICS != FALSE)
+    if (pthread_mutex_init(&cacheAlloc_l.counterLock, NULL) != 0)
+        return;
+#endif
+
+    cacheAlloc_l.reservedBytes = getReservedCacheSize();
+    cacheAlloc_l.fGroupValid = TRUE;
+
+    DEBUG_LVL_ALWAYS_TRACE("Cache allocation group %s: %llu KiB of L3 reserved\n",
+                           CONFIG_TARGET_CACHE_ALLOC_GROUP,
+                           (unsigned long long)(cacheAlloc_l.reservedBytes / 1024));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Clean up the cache allocation group
+
+The function closes the cache miss counters. The threads of the stack are
+already terminated.
+*/
+//------------------------------------------------------------------------------
+static void exitCacheAlloc(void)
+{
+#if (CONFIG_METRICS != FALSE)
+    UINT    i;
+
+    if (!cacheAlloc_l.fGroupValid)
+        return;
+
+    for (i = 0; i < cacheAlloc_l.missCounterCount; i++)
+        close(cacheAlloc_l.aMissCounterFd[i]);
+
+    cacheAlloc_l.missCounterCount = 0;
+    pthread_mutex_destroy(&cacheAlloc_l.counterLock);
+#endif
+
+    cacheAlloc_l.fGroupValid = FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the L3 cache size reserved by the group
+
+The function calculates the size of the L3 cache reserved for the group in
+cache domain 0 from the capacity bitmask of its schemata ("L3:0=<mask>;...")
+and the geometry of the L3 cache of CPU 0.
+
+\return The function returns the reserved size in bytes or 0 if it is unknown.
+*/
+//------------------------------------------------------------------------------
+static UINT64 getReservedCacheSize(void)
+{
+    char            aPath[256];
+    char            aLine[256];
+    char*           pMask;
+    char*           pEnd;
+    unsigned long   mask;
+    UINT64          cacheSize;
+    UINT64          ways;
+    UINT            bitCount = 0;
+
+    snprintf(aPath, sizeof(aPath), "%s/schemata", CONFIG_TARGET_CACHE_ALLOC_GROUP);
+    if (!readFileLine(aPath, "L3:", aLine, sizeof(aLine)))
+        return 0;
+
+    pMask = strstr(aLine, "0=");
+    if (pMask == NULL)
+        return 0;
+
+    for (mask = strtoul(pMask + 2, NULL, 16); mask != 0; mask >>= 1)
+        bitCount += (UINT)(mask & 1);
+
+    if (!readFileLine(TARGET_CACHE_ALLOC_L3_PATH "/size", "", aLine, sizeof(aLine)))
+        return 0;
+
+    cacheSize = strtoull(aLine, &pEnd, 10);
+    if (*pEnd == 'K')
+        cacheSize *= 1024;
+    else if (*pEnd == 'M')
+        cacheSize *= 1024 * 1024;
+
+    if (!readFileLine(TARGET_CACHE_ALLOC_L3_PATH "/ways_of_associativity", "", aLine, sizeof(aLine)))
+        return 0;
+
+    ways = strtoull(aLine, NULL, 10);
+    if (ways == 0)
+        return 0;
+
+    return (cacheSize / ways) * bitCount;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read a line of a file
+
+The function reads the first line of a file which contains the specified
+prefix. Leading white space of the line is skipped.
+
+\param  pPath_p                 Path of the file.
+\param  pPrefix_p               Prefix of the line, "" for the first line.
+\param  pBuffer_p               Buffer to store the line without the prefix.
+\param  size_p                  Size of the buffer.
+
+\return The function returns TRUE if a line was found.
+*/
+//------------------------------------------------------------------------------
+static BOOL readFileLine(const char* pPath_p, const char* pPrefix_p, char* pBuffer_p, size_t size_p)
+{
+    FILE*   pFile;
+    char*   pLine;
+    BOOL    fFound = FALSE;
+
+    pFile = fopen(pPath_p, "r");
+    if (pFile == NULL)
+        return FALSE;
+
+    while (fgets(pBuffer_p, (int)size_p, pFile) != NULL)
+    {
+        for (pLine = pBuffer_p; (*pLine == ' ') || (*pLine == '\t'); pLine++)
+            ;
+
+        if (strncmp(pLine, pPrefix_p, strlen(pPrefix_p)) == 0)
+        {
+            memmove(pBuffer_p, pLine + strlen(pPrefix_p), strlen(pLine + strlen(pPrefix_p)) + 1);
+            fFound = TRUE;
+            break;
+        }
+    }
+
+    fclose(pFile);
+    return fFound;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Start a thread in the cache allocation group
+
+The function is the start function of the realtime threads if
+CONFIG_TARGET_CACHE_ALLOC is enabled. The thread writes its thread ID into the
+task list of the resctrl group, so only this thread is moved to the group.
+With CONFIG_METRICS a counter of its cache misses is opened, which is read by
+target_updateCacheMetrics(). Afterwards the thread function is called.
+
+\param  pArg_p                  Pointer to the start parameters.
+
+\return The function returns the exit code of the thread function.
+*/
+//------------------------------------------------------------------------------
+static void* startCacheAllocThread(void* pArg_p)
+{
+    tCacheAllocThreadStart  start = *(tCacheAllocThreadStart*)pArg_p;
+    char                    aPath[256];
+    FILE*                   pFile;
+    pid_t                   tid;
+    int                     result = -1;
+#if (CONFIG_METRICS != FALSE)
+    struct perf_event_attr  attr;
+    int                     fd;
+#endif
+
+    OPLK_FREE(pArg_p);
+
+    tid = (pid_t)syscall(SYS_gettid);
+    snprintf(aPath, sizeof(aPath), "%s/tasks", CONFIG_TARGET_CACHE_ALLOC_GROUP);
+    pFile = fopen(aPath, "w");
+    if (pFile != NULL)
+    {
+        // resctrl reports an invalid thread ID when the buffer is flushed
+        result = fprintf(pFile, "%d\n", (int)tid);
+        if (fclose(pFile) != 0)
+            result = -1;
+    }
+
+    if ((pFile == NULL) || (result < 0))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't move thread %d to %s (%s)\n",
+                              __func__, (int)tid, CONFIG_TARGET_CACHE_ALLOC_GROUP, strerror(errno));
+    }
+
+#if (CONFIG_METRICS != FALSE)
+    OPLK_MEMSET(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.exclude_hv = 1;
+
+    // The counter is optional, e.g. perf_event_paranoid may forbid it
+    fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (fd >= 0)
+    {
+        pthread_mutex_lock(&cacheAlloc_l.counterLock);
+        if (cacheAlloc_l.missCounterCount < TARGET_CACHE_ALLOC_COUNTERS)
+            cacheAlloc_l.aMissCounterFd[cacheAlloc_l.missCounterCount++] = fd;
+        else
+            close(fd);
+        pthread_mutex_unlock(&cacheAlloc_l.counterLock);
+    }
+#endif
+
+    return start.pfnThread(start.pArg);
+}
+#endif
+
+///\}
@@ -80,3 +80,40 @@ UINT32 target_getTickCount(void)
 {
     return jiffies * 1000 / HZ;
 }
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get cycle counter
+
+The function returns the value of a free running counter with a low read
+overhead. In the Linux kernel it is the ktime clock in nanoseconds, which is
+based on the TSC or the architecture timer where available.
+
+\return The function returns the cycle counter value.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+ULONGLONG target_getCycleCounter(void)
+{
+    return ktime_to_ns(ktime_get());
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Convert cycle counter value to nanoseconds
+
+The function converts a value or a difference of values of
+target_getCycleCounter() to nanoseconds.
+
+\param  cycles_p                Cycle counter value.
+
+\return The function returns the value in nanoseconds.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+ULONGLONG target_convertCyclesToNs(ULONGLONG cycles_p)
+{
+    return cycles_p;
+}
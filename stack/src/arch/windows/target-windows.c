@@ -40,6 +40,16 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <oplk/oplk.h>
+#include <common/target.h>
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static ULONGLONG    cycleCounterFreq_l = 0;     // performance counter frequency in Hz, read on first use
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -106,3 +116,70 @@ UINT32 target_getTickCount(void)
 {
     return GetTickCount();
 }
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get current timestamp
+
+The function returns the current timestamp in nanoseconds. It is based on the
+performance counter.
+
+\return The function returns the timestamp in nanoseconds
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+ULONGLONG target_getCurrentTimestamp(void)
+{
+    return target_convertCyclesToNs(target_getCycleCounter());
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get cycle counter
+
+The function returns the value of the performance counter
+(QueryPerformanceCounter()). It can be converted with
+target_convertCyclesToNs().
+
+\return The function returns the cycle counter value.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+ULONGLONG target_getCycleCounter(void)
+{
+    LARGE_INTEGER   counter;
+
+    QueryPerformanceCounter(&counter);
+
+    return (ULONGLONG)counter.QuadPart;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Convert cycle counter value to nanoseconds
+
+The function converts a value or a difference of values of
+target_getCycleCounter() to nanoseconds.
+
+\param  cycles_p                Cycle counter value.
+
+\return The function returns the value in nanoseconds.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+ULONGLONG target_convertCyclesToNs(ULONGLONG cycles_p)
+{
+    if (cycleCounterFreq_l == 0)
+    {
+        LARGE_INTEGER   frequency;
+
+        QueryPerformanceFrequency(&frequency);
+        cycleCounterFreq_l = (ULONGLONG)frequency.QuadPart;
+    }
+
+    return ((cycles_p / cycleCounterFreq_l) * 1000000000ULL) +
+           (((cycles_p % cycleCounterFreq_l) * 1000000000ULL) / cycleCounterFreq_l);
+}
@@ -409,6 +409,60 @@ UINT32 openmac_timerGetTimeValue(UINT timer_p)
     return Xil_In32(OPENMAC_TIMER_BASE + offset);
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize memory-to-memory DMA
+
+The Microblaze designs provide no memory-to-memory DMA for the stack.
+
+\return The function returns kErrorNoResource.
+
+\ingroup module_openmac
+*/
+//------------------------------------------------------------------------------
+tOplkError openmac_dmaInit(void)
+{
+    return kErrorNoResource;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close memory-to-memory DMA
+
+\ingroup module_openmac
+*/
+//------------------------------------------------------------------------------
+void openmac_dmaExit(void)
+{
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Start memory-to-memory DMA transfer
+
+\param  pDst_p          Destination address
+\param  pSrc_p          Source address
+\param  size_p          Size of the transfer [byte]
+\param  pfnDoneCb_p     Callback called when the transfer is completed
+\param  pArg_p          Argument given to the callback
+
+\return The function returns kErrorNoResource.
+
+\ingroup module_openmac
+*/
+//------------------------------------------------------------------------------
+tOplkError openmac_dmaCopy(void* pDst_p, const void* pSrc_p, UINT size_p,
+                           tOpenmacDmaCb pfnDoneCb_p, void* pArg_p)
+{
+    UNUSED_PARAMETER(pDst_p);
+    UNUSED_PARAMETER(pSrc_p);
+    UNUSED_PARAMETER(size_p);
+    UNUSED_PARAMETER(pfnDoneCb_p);
+    UNUSED_PARAMETER(pArg_p);
+
+    return kErrorNoResource;
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -49,6 +49,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <xintc.h>         // interrupt controller
 
 #include <common/target.h>
+#include <target/openmac.h>
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -74,6 +75,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#define TARGET_CYCLE_COUNTER_FREQ       50000000ULL     // openMAC timer runs with 50 MHz (OMETH_TICKS_2_NS())
 
 //------------------------------------------------------------------------------
 // local types
@@ -82,6 +84,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
+static UINT32       lastCounter_l = 0;          // last read 32 bit counter value
+static UINT32       counterHigh_l = 0;          // upper 32 bit of the cycle counter
 
 //------------------------------------------------------------------------------
 // local function prototypes
@@ -230,6 +234,73 @@ void target_msleep (UINT32 milliSeconds_p)
     usleep(TGTCONIO_MS_IN_US(milliSeconds_p));
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get current timestamp
+
+The function returns the current timestamp in nanoseconds. Its resolution is
+the one of target_getCycleCounter().
+
+\return The function returns the timestamp in nanoseconds
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+ULONGLONG target_getCurrentTimestamp(void)
+{
+    return target_convertCyclesToNs(target_getCycleCounter());
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get cycle counter
+
+The function returns the value of the free running openMAC timer. The 32 bit
+hardware value is extended to 64 bit in software, therefore the function must
+be called at least once per overflow period of the timer (about 85 s).
+
+\return The function returns the cycle counter value.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+ULONGLONG target_getCycleCounter(void)
+{
+    UINT32      counter;
+    ULONGLONG   value;
+
+    target_enableGlobalInterrupt(FALSE);
+
+    counter = openmac_timerGetTimeValue(HWTIMER_SYNC);
+    if (counter < lastCounter_l)
+        counterHigh_l++;
+    lastCounter_l = counter;
+    value = ((ULONGLONG)counterHigh_l << 32) | counter;
+
+    target_enableGlobalInterrupt(TRUE);
+
+    return value;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Convert cycle counter value to nanoseconds
+
+The function converts a value or a difference of values of
+target_getCycleCounter() to nanoseconds.
+
+\param  cycles_p                Cycle counter value.
+
+\return The function returns the value in nanoseconds.
+
+\ingroup module_target
+*/
+//------------------------------------------------------------------------------
+ULONGLONG target_convertCyclesToNs(ULONGLONG cycles_p)
+{
+    return cycles_p * (1000000000ULL / TARGET_CYCLE_COUNTER_FREQ);
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
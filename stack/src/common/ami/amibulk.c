@@ -0,0 +1,634 @@
+/**
+********************************************************************************
+\file   ami/amibulk.c
+
+\brief  Bulk conversion functions of the Abstract Memory Interface (ami)
+
+This file implements the AMI functions which convert whole arrays of values
+of the same width in a single call. If the byte order of the buffer matches the
+platform byte order, the values are simply copied. Otherwise, the bytes are
+swapped. The swap functions use SIMD instructions if the compiler is
+configured for a target which supports them (AVX2, SSE2 or NEON). As the
+kernel does not allow the usage of SIMD registers, the portable C
+implementation is always used in kernel space.
+
+The file also contains functions which extract and insert bit-packed boolean
+values.
+
+\ingroup module_ami
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <common/ami.h>
+
+#if !defined(__KERNEL__)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define AMI_BULK_USE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define AMI_BULK_USE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AMI_BULK_USE_NEON
+#endif
+#endif
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void swap16(void* pDst_p, const void* pSrc_p, UINT count_p);
+static void swap32(void* pDst_p, const void* pSrc_p, UINT count_p);
+static void swap64(void* pDst_p, const void* pSrc_p, UINT count_p);
+static void swapBytes(UINT8* pDst_p, const UINT8* pSrc_p, UINT count_p, UINT width_p);
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Set Uint16 array to little endian
+
+Sets an array of 16 bit values to a buffer in little endian.
+
+\param[out] pAddr_p         Pointer to the destination buffer
+\param[in]  pVal_p          Pointer to the source values
+\param[in]  count_p         Number of values to convert
+
+\ingroup module_ami
+*/
+//------------------------------------------------------------------------------
+void ami_setUint16ArrayLe(void* pAddr_p, const UINT16* pVal_p, UINT count_p)
+{
+    if (CHECK_IF_BIG_ENDIAN())
+        swap16(pAddr_p, pVal_p, count_p);
+    else
+        OPLK_MEMCPY(pAddr_p, pVal_p, count_p * sizeof(UINT16));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get Uint16 array from little endian
+
+Reads an array of 16 bit values from a buffer in little endian.
+
+\param[in]  pAddr_p         Pointer to the source buffer
+\param[out] pVal_p          Pointer to store the values in platform endian
+\param[in]  count_p         Number of values to convert
+
+\ingroup module_ami
+*/
+//------------------------------------------------------------------------------
+void ami_getUint16ArrayLe(const void* pAddr_p, UINT16* pVal_p, UINT count_p)
+{
+    if (CHECK_IF_BIG_ENDIAN())
+        swap16(pVal_p, pAddr_p, count_p);
+    else
+        OPLK_MEMCPY(pVal_p, pAddr_p, count_p * sizeof(UINT16));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Set Uint16 array to big endian
+
+Sets an array of 16 bit values to a buffer in big endian.
+
+\param[out] pAddr_p         Pointer to the destination buffer
+\param[in]  pVal_p          Pointer to the source values
+\param[in]  count_p         Number of values to convert
+
+\ingroup module_ami
+*/
+//------------------------------------------------------------------------------
+void ami_setUint16ArrayBe(void* pAddr_p, const UINT16* pVal_p, UINT count_p)
+{
+    if (!CHECK_IF_BIG_ENDIAN())
+        swap16(pAddr_p, pVal_p, count_p);
+    else
+        OPLK_MEMCPY(pAddr_p, pVal_p, count_p * sizeof(UINT16));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get Uint16 array from big endian
+
+Reads an array of 16 bit values from a buffer in big endian.
+
+\param[in]  pAddr_p         Pointer to the source buffer
+\param[out] pVal_p          Pointer to store the values in platform endian
+\param[in]  count_p         Number of values to convert
+
+\ingroup module_ami
+*/
+//------------------------------------------------------------------------------
+void ami_getUint16ArrayBe(const void* pAddr_p, UINT16* pVal_p, UINT count_p)
+{
+    if (!CHECK_IF_BIG_ENDIAN())
+        swap16(pVal_p, pAddr_p, count_p);
+    else
+        OPLK_MEMCPY(pVal_p, pAddr_p, count_p * sizeof(UINT16));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Set Uint32 array to little endian
+
+Sets an array of 32 bit values to a buffer in little endian.
+
+\param[out] pAddr_p         Pointer to the destination buffer
+\param[in]  pVal_p          Pointer to the source values
+\param[in]  count_p         Number of values to convert
+
+\ingroup module_ami
+*/
+//------------------------------------------------------------------------------
+void ami_setUint32ArrayLe(void* pAddr_p, const UINT32* pVal_p, UINT count_p)
+{
+    if (CHECK_IF_BIG_ENDIAN())
+        swap32(pAddr_p, pVal_p, count_p);
+    else
+        OPLK_MEMCPY(pAddr_p, pVal_p, count_p * sizeof(UINT32));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get Uint32 array from little endian
+
+Reads an array of 32 bit values from a buffer in little endian.
+
+\param[in]  pAddr_p         Pointer to the source buffer
+\param[out] pVal_p          Pointer to store the values in platform endian
+\param[in]  count_p         Number of values to convert
+
+\ingroup module_ami
+*/
+//------------------------------------------------------------------------------
+void ami_getUint32ArrayLe(const void* pAddr_p, UINT32* pVal_p, UINT count_p)
+{
+    if (CHECK_IF_BIG_ENDIAN())
+        swap32(pVal_p, pAddr_p, count_p);
+    else
+        OPLK_MEMCPY(pVal_p, pAddr_p, count_p * sizeof(UINT32));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Set Uint32 array to big endian
+
+Sets an array of 32 bit values to a buffer in big endian.
+
+\param[out] pAddr_p         Pointer to the destination buffer
+\param[in]  pVal_p          Pointer to the source values
+\param[in]  count_p         Number of values to convert
+
+\ingroup module_ami
+*/
+//------------------------------------------------------------------------------
+void ami_setUint32ArrayBe(void* pAddr_p, const UINT32* pVal_p, UINT count_p)
+{
+    if (!CHECK_IF_BIG_ENDIAN())
+        swap32(pAddr_p, pVal_p, count_p);
+    else
+        OPLK_MEMCPY(pAddr_p, pVal_p, count_p * sizeof(UINT32));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get Uint32 array from big endian
+
+Reads an array of 32 bit values from a buffer in big endian.
+
+\param[in]  pAddr_p         Pointer to the source buffer
+\param[out] pVal_p          Pointer to store the values in platform endian
+\param[in]  count_p         Number of values to convert
+
+\ingroup module_ami
+*/
+//------------------------------------------------------------------------------
+void ami_getUint32ArrayBe(const void* pAddr_p, UINT32* pVal_p, UINT count_p)
+{
+    if (!CHECK_IF_BIG_ENDIAN())
+        swap32(pVal_p, pAddr_p, count_p);
+    else
+        OPLK_MEMCPY(pVal_p, pAddr_p, count_p * sizeof(UINT32));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Set Uint64 array to little endian
+
+Sets an array of 64 bit values to a buffer in little endian.
+
+\param[out] pAddr_p         Pointer to the destination buffer
+\param[in]  pVal_p          Pointer to the source values
+\param[in]  count_p         Number of values to convert
+
+\ingroup module_ami
+*/
+//------------------------------------------------------------------------------
+void ami_setUint64ArrayLe(void* pAddr_p, const UINT64* pVal_p, UINT count_p)
+{
+    if (CHECK_IF_BIG_ENDIAN())
+        swap64(pAddr_p, pVal_p, count_p);
+    else
+        OPLK_MEMCPY(pAddr_p, pVal_p, count_p * sizeof(UINT64));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get Uint64 array from little endian
+
+Reads an array of 64 bit values from a buffer in little endian.
+
+\param[in]  pAddr_p         Pointer to the source buffer
+\param[out] pVal_p          Pointer to store the values in platform endian
+\param[in]  count_p         Number of values to convert
+
+\ingroup module_ami
+*/
+//------------------------------------------------------------------------------
+void ami_getUint64ArrayLe(const void* pAddr_p, UINT64* pVal_p, UINT count_p)
+{
+    if (CHECK_IF_BIG_ENDIAN())
+        swap64(pVal_p, pAddr_p, count_p);
+    else
+        OPLK_MEMCPY(pVal_p, pAddr_p, count_p * sizeof(UINT64));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Set Uint64 array to big endian
+
+Sets an array of 64 bit values to a buffer in big endian.
+
+\param[out] pAddr_p         Pointer to the destination buffer
+\param[in]  pVal_p          Pointer to the source values
+\param[in]  count_p         Number of values to convert
+
+\ingroup module_ami
+*/
+//------------------------------------------------------------------------------
+void ami_setUint64ArrayBe(void* pAddr_p, const UINT64* pVal_p, UINT count_p)
+{
+    if (!CHECK_IF_BIG_ENDIAN())
+        swap64(pAddr_p, pVal_p, count_p);
+    else
+        OPLK_MEMCPY(pAddr_p, pVal_p, count_p * sizeof(UINT64));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get Uint64 array from big endian
+
+Reads an array of 64 bit values from a buffer in big endian.
+
+\param[in]  pAddr_p         Pointer to the source buffer
+\param[out] pVal_p          Pointer to store the values in platform endian
+\param[in]  count_p         Number of values to convert
+
+\ingroup module_ami
+*/
+//------------------------------------------------------------------------------
+void ami_getUint64ArrayBe(const void* pAddr_p, UINT64* pVal_p, UINT count_p)
+{
+    if (!CHECK_IF_BIG_ENDIAN())
+        swap64(pVal_p, pAddr_p, count_p);
+    else
+        OPLK_MEMCPY(pVal_p, pAddr_p, count_p * sizeof(UINT64));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get array of bit-packed boolean values
+
+Extracts a number of consecutive bits from a buffer. Each bit is stored as a
+boolean value (0 or 1) in one byte of the destination array. Bit 0 of a byte
+in the buffer is the first bit, according to the POWERLINK bit order.
+
+\param[in]  pAddr_p         Pointer to the source buffer
+\param[in]  bitOffset_p     Offset of first bit in the source buffer
+\param[out] pVal_p          Pointer to store the boolean values
+\param[in]  count_p         Number of bits to extract
+
+\ingroup module_ami
+*/
+//------------------------------------------------------------------------------
+void ami_getBitArray(const void* pAddr_p, UINT bitOffset_p, UINT8* pVal_p, UINT count_p)
+{
+    const UINT8*    pSrc = (const UINT8*)pAddr_p + (bitOffset_p >> 3);
+    UINT            bit = bitOffset_p & 0x7;
+    UINT8           data;
+
+    // extract byte-aligned groups of 8 bits at once
+    if (bit == 0)
+    {
+        for (; count_p >= 8; count_p -= 8, pVal_p += 8)
+        {
+            data = *pSrc++;
+            pVal_p[0] = data & 0x01;
+            pVal_p[1] = (data >> 1) & 0x01;
+            pVal_p[2] = (data >> 2) & 0x01;
+            pVal_p[3] = (data >> 3) & 0x01;
+            pVal_p[4] = (data >> 4) & 0x01;
+            pVal_p[5] = (data >> 5) & 0x01;
+            pVal_p[6] = (data >> 6) & 0x01;
+            pVal_p[7] = (data >> 7) & 0x01;
+        }
+    }
+
+    for (; count_p > 0; count_p--, pVal_p++)
+    {
+        *pVal_p = (*pSrc >> bit) & 0x01;
+        if (++bit == 8)
+        {
+            bit = 0;
+            pSrc++;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Set array of bit-packed boolean values
+
+Inserts a number of boolean values as consecutive bits into a buffer. All other
+bits of the buffer are left unchanged. Any non-zero value is stored as 1.
+
+\param[out] pAddr_p         Pointer to the destination buffer
+\param[in]  bitOffset_p     Offset of first bit in the destination buffer
+\param[in]  pVal_p          Pointer to the boolean values
+\param[in]  count_p         Number of bits to insert
+
+\ingroup module_ami
+*/
+//------------------------------------------------------------------------------
+void ami_setBitArray(void* pAddr_p, UINT bitOffset_p, const UINT8* pVal_p, UINT count_p)
+{
+    UINT8*          pDst = (UINT8*)pAddr_p + (bitOffset_p >> 3);
+    UINT            bit = bitOffset_p & 0x7;
+    UINT8           data;
+
+    // insert byte-aligned groups of 8 bits at once
+    if (bit == 0)
+    {
+        for (; count_p >= 8; count_p -= 8, pVal_p += 8)
+        {
+            data = (pVal_p[0] != 0) |
+                   ((pVal_p[1] != 0) << 1) |
+                   ((pVal_p[2] != 0) << 2) |
+                   ((pVal_p[3] != 0) << 3) |
+                   ((pVal_p[4] != 0) << 4) |
+                   ((pVal_p[5] != 0) << 5) |
+                   ((pVal_p[6] != 0) << 6) |
+                   ((pVal_p[7] != 0) << 7);
+            *pDst++ = data;
+        }
+    }
+
+    for (; count_p > 0; count_p--, pVal_p++)
+    {
+        if (*pVal_p != 0)
+            *pDst |= (UINT8)(1 << bit);
+        else
+            *pDst &= (UINT8)~(1 << bit);
+
+        if (++bit == 8)
+        {
+            bit = 0;
+            pDst++;
+        }
+    }
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief    Swap bytes of 16 bit values
+
+The function copies an array of 16 bit values and swaps the bytes of each
+value. Source and destination must either be identical or must not overlap.
+
+\param[out] pDst_p          Pointer to the destination buffer
+\param[in]  pSrc_p          Pointer to the source buffer
+\param[in]  count_p         Number of values
+*/
+//------------------------------------------------------------------------------
+static void swap16(void* pDst_p, const void* pSrc_p, UINT count_p)
+{
+    UINT8*          pDst = (UINT8*)pDst_p;
+    const UINT8*    pSrc = (const UINT8*)pSrc_p;
+
+#if defined(AMI_BULK_USE_AVX2)
+    const __m256i   mask = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                            1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+    for (; count_p >= 16; count_p -= 16, pSrc += 32, pDst += 32)
+    {
+        __m256i val = _mm256_loadu_si256((const __m256i*)pSrc);
+        _mm256_storeu_si256((__m256i*)pDst, _mm256_shuffle_epi8(val, mask));
+    }
+#elif defined(AMI_BULK_USE_SSE2)
+    for (; count_p >= 8; count_p -= 8, pSrc += 16, pDst += 16)
+    {
+        __m128i val = _mm_loadu_si128((const __m128i*)pSrc);
+        val = _mm_or_si128(_mm_slli_epi16(val, 8), _mm_srli_epi16(val, 8));
+        _mm_storeu_si128((__m128i*)pDst, val);
+    }
+#elif defined(AMI_BULK_USE_NEON)
+    for (; count_p >= 8; count_p -= 8, pSrc += 16, pDst += 16)
+    {
+        vst1q_u8(pDst, vrev16q_u8(vld1q_u8(pSrc)));
+    }
+#endif
+
+    swapBytes(pDst, pSrc, count_p, 2);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Swap bytes of 32 bit values
+
+The function copies an array of 32 bit values and swaps the bytes of each
+value. Source and destination must either be identical or must not overlap.
+
+\param[out] pDst_p          Pointer to the destination buffer
+\param[in]  pSrc_p          Pointer to the source buffer
+\param[in]  count_p         Number of values
+*/
+//------------------------------------------------------------------------------
+static void swap32(void* pDst_p, const void* pSrc_p, UINT count_p)
+{
+    UINT8*          pDst = (UINT8*)pDst_p;
+    const UINT8*    pSrc = (const UINT8*)pSrc_p;
+
+#if defined(AMI_BULK_USE_AVX2)
+    const __m256i   mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+    for (; count_p >= 8; count_p -= 8, pSrc += 32, pDst += 32)
+    {
+        __m256i val = _mm256_loadu_si256((const __m256i*)pSrc);
+        _mm256_storeu_si256((__m256i*)pDst, _mm256_shuffle_epi8(val, mask));
+    }
+#elif defined(AMI_BULK_USE_SSE2)
+    for (; count_p >= 4; count_p -= 4, pSrc += 16, pDst += 16)
+    {
+        __m128i val = _mm_loadu_si128((const __m128i*)pSrc);
+        // swap 16 bit words, then swap bytes within the words
+        val = _mm_shufflehi_epi16(_mm_shufflelo_epi16(val, 0xB1), 0xB1);
+        val = _mm_or_si128(_mm_slli_epi16(val, 8), _mm_srli_epi16(val, 8));
+        _mm_storeu_si128((__m128i*)pDst, val);
+    }
+#elif defined(AMI_BULK_USE_NEON)
+    for (; count_p >= 4; count_p -= 4, pSrc += 16, pDst += 16)
+    {
+        vst1q_u8(pDst, vrev32q_u8(vld1q_u8(pSrc)));
+    }
+#endif
+
+    swapBytes(pDst, pSrc, count_p, 4);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Swap bytes of 64 bit values
+
+The function copies an array of 64 bit values and swaps the bytes of each
+value. Source and destination must either be identical or must not overlap.
+
+\param[out] pDst_p          Pointer to the destination buffer
+\param[in]  pSrc_p          Pointer to the source buffer
+\param[in]  count_p         Number of values
+*/
+//------------------------------------------------------------------------------
+static void swap64(void* pDst_p, const void* pSrc_p, UINT count_p)
+{
+    UINT8*          pDst = (UINT8*)pDst_p;
+    const UINT8*    pSrc = (const UINT8*)pSrc_p;
+
+#if defined(AMI_BULK_USE_AVX2)
+    const __m256i   mask = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                            7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+
+    for (; count_p >= 4; count_p -= 4, pSrc += 32, pDst += 32)
+    {
+        __m256i val = _mm256_loadu_si256((const __m256i*)pSrc);
+        _mm256_storeu_si256((__m256i*)pDst, _mm256_shuffle_epi8(val, mask));
+    }
+#elif defined(AMI_BULK_USE_SSE2)
+    for (; count_p >= 2; count_p -= 2, pSrc += 16, pDst += 16)
+    {
+        __m128i val = _mm_loadu_si128((const __m128i*)pSrc);
+        // reverse 16 bit words, then swap bytes within the words
+        val = _mm_shufflehi_epi16(_mm_shufflelo_epi16(val, 0x1B), 0x1B);
+        val = _mm_or_si128(_mm_slli_epi16(val, 8), _mm_srli_epi16(val, 8));
+        _mm_storeu_si128((__m128i*)pDst, val);
+    }
+#elif defined(AMI_BULK_USE_NEON)
+    for (; count_p >= 2; count_p -= 2, pSrc += 16, pDst += 16)
+    {
+        vst1q_u8(pDst, vrev64q_u8(vld1q_u8(pSrc)));
+    }
+#endif
+
+    swapBytes(pDst, pSrc, count_p, 8);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Swap bytes of values of arbitrary width
+
+The function is the portable implementation of the swap functions. It is used
+if no SIMD instructions are available and for the remaining values which do not
+fill a complete SIMD register.
+
+\param[out] pDst_p          Pointer to the destination buffer
+\param[in]  pSrc_p          Pointer to the source buffer
+\param[in]  count_p         Number of values
+\param[in]  width_p         Width of a single value in bytes
+*/
+//------------------------------------------------------------------------------
+static void swapBytes(UINT8* pDst_p, const UINT8* pSrc_p, UINT count_p, UINT width_p)
+{
+    UINT8           aTemp[8];
+    UINT            i;
+
+    for (; count_p > 0; count_p--, pSrc_p += width_p, pDst_p += width_p)
+    {
+        for (i = 0; i < width_p; i++)
+            aTemp[i] = pSrc_p[width_p - 1 - i];
+
+        for (i = 0; i < width_p; i++)
+            pDst_p[i] = aTemp[i];
+    }
+}
+
+///\}
@@ -41,6 +41,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // includes
 //------------------------------------------------------------------------------
+#define AMI_NO_INLINE                   // provide the out-of-line accessors
 #include <common/ami.h>
 
 //============================================================================//
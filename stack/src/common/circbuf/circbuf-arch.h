@@ -46,6 +46,23 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+/**
+\brief Circular buffers used in lock-free mode
+
+The bit mask selects the circular buffer IDs which are used in lock-free
+single-producer/single-consumer mode (bit n selects buffer ID n). Such a buffer
+must only be written by a single thread and read by a single thread. The mode
+is supported by the posixshm, linuxkernel, win32, noos and nooshostif
+architecture modules. It is stored in the buffer header by the creator,
+connecting instances use the mode of the existing buffer. For the host interface
+queues the read and write indices replace the lock shared by the PCP and the
+host.
+*/
+#ifndef CIRCBUF_LOCKFREE_BUFFERS
+#define CIRCBUF_LOCKFREE_BUFFERS        0
+#endif
+
+#define CIRCBUF_IS_LOCKFREE(id)         ((CIRCBUF_LOCKFREE_BUFFERS & (1UL << (id))) != 0)
 
 //------------------------------------------------------------------------------
 // typedef
@@ -68,6 +85,9 @@ void              circbuf_disconnectBuffer(tCircBufInstance* pInstance_p);
 void              circbuf_lock(tCircBufInstance* pInstance_p) SECTION_CIRCBUF_LOCK;
 void              circbuf_unlock(tCircBufInstance* pInstance_p) SECTION_CIRCBUF_UNLOCK;
 
+// only provided by the linuxkernel architecture module
+BYTE*             circbuf_getSharedMem(UINT8 id_p, size_t* pSize_p);
+
 #ifdef __cplusplus
 }
 #endif
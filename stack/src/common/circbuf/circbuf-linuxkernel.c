@@ -53,6 +53,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <linux/wait.h>
 #include <linux/spinlock.h>
 #include <linux/kthread.h>
+#include <linux/mm.h>
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -85,11 +86,20 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 typedef struct
 {
     spinlock_t          spinlock;       ///< spinlock used for locking
+    UINT                pageOrder;      ///< Page order of shared buffer memory, only used in lock-free mode
 } tCircBufArchInstance;
 
+/** \brief Shared memory of a lock-free circular buffer */
+typedef struct
+{
+    BYTE*               pMem;           ///< Start of the memory (header page followed by the buffer)
+    size_t              size;           ///< Size of the memory
+} tCircBufSharedMem;
+
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
+static tCircBufSharedMem    aSharedMem_l[NR_OF_CIRC_BUFFERS];
 
 
 //------------------------------------------------------------------------------
@@ -125,6 +135,7 @@ tCircBufInstance* circbuf_createInstance(UINT8 id_p)
     OPLK_MEMSET(pInstance, 0, sizeof(tCircBufInstance) + sizeof(tCircBufArchInstance));
     pInstance->pCircBufArchInstance = (BYTE*)pInstance + sizeof(tCircBufInstance);
     pInstance->bufferId = id_p;
+    pInstance->fLockFree = CIRCBUF_IS_LOCKFREE(id_p);
 
     pArch = (tCircBufArchInstance*)pInstance->pCircBufArchInstance;
     spin_lock_init(&pArch->spinlock);
@@ -165,6 +176,28 @@ The function allocates the memory needed for the circular buffer.
 //------------------------------------------------------------------------------
 tCircBufError circbuf_allocBuffer(tCircBufInstance* pInstance_p, size_t* pSize_p)
 {
+    tCircBufArchInstance*   pArch = (tCircBufArchInstance*)pInstance_p->pCircBufArchInstance;
+    size_t                  headerSize;
+    BYTE*                   pMem;
+
+    if (pInstance_p->fLockFree)
+    {
+        // Lock-free buffers can be mapped into user space. They are allocated
+        // in whole pages with the same layout as the posixshm buffers: the
+        // header page is followed by the buffer.
+        headerSize = PAGE_ALIGN(sizeof(tCircBufHeader));
+        pArch->pageOrder = get_order(headerSize + *pSize_p);
+        pMem = (BYTE*)__get_free_pages(GFP_KERNEL | __GFP_ZERO, pArch->pageOrder);
+        if (pMem == NULL)
+            return kCircBufNoResource;
+
+        pInstance_p->pCircBufHeader = (tCircBufHeader*)pMem;
+        pInstance_p->pCircBuf = pMem + headerSize;
+        aSharedMem_l[pInstance_p->bufferId].pMem = pMem;
+        aSharedMem_l[pInstance_p->bufferId].size = headerSize + *pSize_p;
+        return kCircBufOk;
+    }
+
     if ((pInstance_p->pCircBufHeader = OPLK_MALLOC(sizeof(tCircBufHeader))) == NULL)
     {
         return kCircBufNoResource;
@@ -191,6 +224,16 @@ The function frees the allocated memory used by the circular buffer.
 //------------------------------------------------------------------------------
 void circbuf_freeBuffer(tCircBufInstance* pInstance_p)
 {
+    tCircBufArchInstance*   pArch = (tCircBufArchInstance*)pInstance_p->pCircBufArchInstance;
+
+    if (pInstance_p->fLockFree)
+    {
+        aSharedMem_l[pInstance_p->bufferId].pMem = NULL;
+        aSharedMem_l[pInstance_p->bufferId].size = 0;
+        free_pages((unsigned long)pInstance_p->pCircBufHeader, pArch->pageOrder);
+        return;
+    }
+
     OPLK_FREE(pInstance_p->pCircBuf);
     OPLK_FREE(pInstance_p->pCircBufHeader);
 }
@@ -269,6 +312,32 @@ void circbuf_unlock(tCircBufInstance* pInstance_p)
     spin_unlock(&pArchInstance->spinlock);
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get shared memory of circular buffer
+
+The function returns the memory of a lock-free circular buffer, which can be
+mapped into user space. The memory starts with the buffer header, the buffer
+itself starts at the next page boundary.
+
+\param  id_p                ID of the circular buffer.
+\param  pSize_p             Pointer to store the size of the memory.
+
+\return The function returns the start of the memory or NULL if the buffer is
+        not allocated or not used in lock-free mode.
+
+\ingroup module_lib_circbuf
+*/
+//------------------------------------------------------------------------------
+BYTE* circbuf_getSharedMem(UINT8 id_p, size_t* pSize_p)
+{
+    if ((id_p >= NR_OF_CIRC_BUFFERS) || (aSharedMem_l[id_p].pMem == NULL))
+        return NULL;
+
+    *pSize_p = aSharedMem_l[id_p].size;
+    return aSharedMem_l[id_p].pMem;
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
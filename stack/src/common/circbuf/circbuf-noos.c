@@ -112,6 +112,7 @@ tCircBufInstance* circbuf_createInstance(UINT8 id_p)
 
     pInstance->pCircBufArchInstance = NULL;
     pInstance->bufferId = id_p;
+    pInstance->fLockFree = CIRCBUF_IS_LOCKFREE(id_p);
 
     return pInstance;
 }
@@ -93,6 +93,8 @@ const tHostifInstanceId hostifInstance[NR_OF_CIRC_BUFFERS] =
         kHostifInstIdInvalid,       ///< Generic request queue for MN asynchronous scheduler
         kHostifInstIdInvalid,       ///< Ident request queue for MN asynchronous scheduler
         kHostifInstIdInvalid,       ///< Status request queue for MN asynchronous scheduler
+        kHostifInstIdInvalid,       ///< User internal event queue for low-priority sinks
+        kHostifInstIdInvalid,       ///< Queue for sending virtual Ethernet frames in the DLLCAL
 };
 
 #if CONFIG_HOSTIF_PCP == TRUE
@@ -155,6 +157,7 @@ tCircBufInstance* circbuf_createInstance(UINT8 id_p)
     {
         // Queue must use local resources
         pInstance->pCircBufArchInstance = NULL;
+        pInstance->fSignalOnEmpty = FALSE;
     }
     else
     {   // Queue must use host interface
@@ -169,9 +172,14 @@ tCircBufInstance* circbuf_createInstance(UINT8 id_p)
         }
 
         pInstance->pCircBufArchInstance = (void*)pHostif;
+
+        // The consumer on the other side of the host interface drains the
+        // queue completely, so a doorbell is only needed for an empty queue.
+        pInstance->fSignalOnEmpty = TRUE;
     }
 
     pInstance->bufferId = id_p;
+    pInstance->fLockFree = CIRCBUF_IS_LOCKFREE(id_p);
 
     return pInstance;
 }
@@ -5,7 +5,12 @@
 \brief  Circular buffer implementation using Posix shared memory
 
 This file contains the architecture specific circular buffer functions
-using posix shared memory and BSD semaphores for locking.
+using posix shared memory. The buffers are locked with a robust process-shared
+mutex which is stored in the shared memory behind the buffer header. The mutex
+doesn't need a system call if it is not contended. If a process dies while it
+holds the lock, the next locking process recovers the mutex, so the other side
+of the circular buffer can continue, e.g. if the application is restarted
+without restarting the driver daemon.
 
 \ingroup module_lib_circbuf
 *******************************************************************************/
@@ -49,7 +54,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sys/types.h>
 #include <fcntl.h>           /* For O_* constants */
 #include <sys/stat.h>        /* For mode constants */
-#include <semaphore.h>
+#include <pthread.h>
 #include <errno.h>
 
 
@@ -81,11 +86,19 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // local types
 //------------------------------------------------------------------------------
 
+/** \brief Shared lock of a circular buffer, stored behind the buffer header */
+typedef struct
+{
+    pthread_mutex_t     mutex;          ///< Robust process-shared mutex
+    UINT32              recoverCount;   ///< Number of recoveries after the death of the lock owner
+} tCircBufShmLock;
+
 /** \brief Architecture specific part of circular buffer instance */
 typedef struct
 {
     int                 fd;             ///< Shared memory file descriptor
-    sem_t*              lockSem;        ///< Semaphore used for locking
+    size_t              headerSize;     ///< Size of the mapped header area
+    tCircBufShmLock*    pLock;          ///< Shared lock in the header area
 } tCircBufArchInstance;
 
 //------------------------------------------------------------------------------
@@ -95,6 +108,9 @@ typedef struct
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
+static size_t           getHeaderSize(void);
+static tCircBufShmLock* getLock(tCircBufInstance* pInstance_p);
+static BOOL             initLock(tCircBufShmLock* pLock_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -116,8 +132,6 @@ The function allocates the memory needed for the circular buffer instance.
 tCircBufInstance* circbuf_createInstance(UINT8 id_p)
 {
     tCircBufInstance*           pInstance;
-    tCircBufArchInstance*       pArch;
-    char                        semName[16];
 
     if ((pInstance = OPLK_MALLOC(sizeof(tCircBufInstance) +
                                  sizeof(tCircBufArchInstance))) == NULL)
@@ -128,16 +142,7 @@ tCircBufInstance* circbuf_createInstance(UINT8 id_p)
     OPLK_MEMSET(pInstance, 0, sizeof(tCircBufInstance) + sizeof(tCircBufArchInstance));
     pInstance->pCircBufArchInstance = (BYTE*)pInstance + sizeof(tCircBufInstance);
     pInstance->bufferId = id_p;
-
-    pArch = (tCircBufArchInstance*)pInstance->pCircBufArchInstance;
-
-    sprintf(semName, "/semCircbuf-%d", id_p);
-    if ((pArch->lockSem = sem_open(semName, O_CREAT, S_IRWXG, 1)) == SEM_FAILED)
-    {
-        TRACE("%s() open sem failed!\n", __func__);
-        OPLK_FREE(pInstance);
-        return NULL;
-    }
+    pInstance->fLockFree = CIRCBUF_IS_LOCKFREE(id_p);
 
     return pInstance;
 }
@@ -155,9 +160,6 @@ The function frees the allocated memory used by the circular buffer instance.
 //------------------------------------------------------------------------------
 void circbuf_freeInstance(tCircBufInstance* pInstance_p)
 {
-    tCircBufArchInstance* pArch = (tCircBufArchInstance*)pInstance_p->pCircBufArchInstance;
-
-    sem_close(pArch->lockSem);
     OPLK_FREE(pInstance_p);
 }
 
@@ -165,7 +167,8 @@ void circbuf_freeInstance(tCircBufInstance* pInstance_p)
 /**
 \brief  Allocate memory for circular buffer
 
-The function allocates the memory needed for the circular buffer.
+The function allocates the memory needed for the circular buffer and
+initializes its shared lock.
 
 \param  pInstance_p         Pointer to the circular buffer instance.
 \param  pSize_p             Size of memory to allocate.
@@ -186,7 +189,7 @@ tCircBufError circbuf_allocBuffer(tCircBufInstance* pInstance_p, size_t* pSize_p
     pArch = (tCircBufArchInstance*)pInstance_p->pCircBufArchInstance;
 
     sprintf(shmName, "/shmCircbuf-%d", pInstance_p->bufferId);
-    pageSize = (sizeof(tCircBufHeader) + sysconf(_SC_PAGE_SIZE) - 1) & (~(sysconf(_SC_PAGE_SIZE) - 1));
+    pageSize = getHeaderSize();
     size = *pSize_p + pageSize;
 
     if ((pArch->fd = shm_open(shmName, O_RDWR | O_CREAT, 0)) < 0)
@@ -203,7 +206,7 @@ tCircBufError circbuf_allocBuffer(tCircBufInstance* pInstance_p, size_t* pSize_p
         return kCircBufNoResource;
     }
 
-    pInstance_p->pCircBufHeader = mmap(NULL, sizeof(tCircBufHeader),
+    pInstance_p->pCircBufHeader = mmap(NULL, pageSize,
                                        PROT_READ | PROT_WRITE, MAP_SHARED, pArch->fd, 0);
     if (pInstance_p->pCircBufHeader == MAP_FAILED)
     {
@@ -212,13 +215,26 @@ tCircBufError circbuf_allocBuffer(tCircBufInstance* pInstance_p, size_t* pSize_p
         shm_unlink(shmName);
         return kCircBufNoResource;
     }
+    pArch->headerSize = pageSize;
+
+    // the lock of a previous run is discarded
+    pArch->pLock = getLock(pInstance_p);
+    if (!initLock(pArch->pLock))
+    {
+        TRACE("%s() init lock failed!\n", __func__);
+        munmap(pInstance_p->pCircBufHeader, pageSize);
+        close(pArch->fd);
+        shm_unlink(shmName);
+        return kCircBufNoResource;
+    }
 
     pInstance_p->pCircBuf = mmap(NULL, *pSize_p, PROT_READ | PROT_WRITE, MAP_SHARED,
                                  pArch->fd, pageSize);
     if (pInstance_p->pCircBuf == MAP_FAILED)
     {
         TRACE("%s() mmap buffer failed! (%s)\n", __func__, strerror(errno));
-        munmap(pInstance_p->pCircBufHeader, sizeof(tCircBufHeader));
+        pthread_mutex_destroy(&pArch->pLock->mutex);
+        munmap(pInstance_p->pCircBufHeader, pageSize);
         close(pArch->fd);
         shm_unlink(shmName);
         return kCircBufNoResource;
@@ -247,7 +263,8 @@ void circbuf_freeBuffer(tCircBufInstance* pInstance_p)
     sprintf (shmName, "/shmCircbuf-%d", pInstance_p->bufferId);
 
     munmap(pInstance_p->pCircBuf, pInstance_p->pCircBufHeader->bufferSize);
-    munmap(pInstance_p->pCircBufHeader, sizeof(tCircBufHeader));
+    pthread_mutex_destroy(&pArch->pLock->mutex);
+    munmap(pInstance_p->pCircBufHeader, pArch->headerSize);
     close(pArch->fd);
     shm_unlink(shmName);
 }
@@ -272,7 +289,7 @@ tCircBufError circbuf_connectBuffer(tCircBufInstance* pInstance_p)
     tCircBufArchInstance*       pArch;
     size_t                      pageSize;
 
-    pageSize = sysconf(_SC_PAGE_SIZE);
+    pageSize = getHeaderSize();
     pArch = (tCircBufArchInstance*)pInstance_p->pCircBufArchInstance;
 
     sprintf(shmName, "/shmCircbuf-%d", pInstance_p->bufferId);
@@ -281,20 +298,22 @@ tCircBufError circbuf_connectBuffer(tCircBufInstance* pInstance_p)
         return kCircBufNoResource;
     }
 
-    pInstance_p->pCircBufHeader = mmap(NULL, sizeof(tCircBufHeader),
+    pInstance_p->pCircBufHeader = mmap(NULL, pageSize,
                                        PROT_READ | PROT_WRITE, MAP_SHARED, pArch->fd, 0);
     if (pInstance_p->pCircBufHeader == MAP_FAILED)
     {
         close(pArch->fd);
         return kCircBufNoResource;
     }
+    pArch->headerSize = pageSize;
+    pArch->pLock = getLock(pInstance_p);
 
     size = pInstance_p->pCircBufHeader->bufferSize;
     pInstance_p->pCircBuf = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
                                  pArch->fd, pageSize);
     if (pInstance_p->pCircBuf == MAP_FAILED)
     {
-        munmap(pInstance_p->pCircBufHeader, sizeof(tCircBufHeader));
+        munmap(pInstance_p->pCircBufHeader, pageSize);
         close(pArch->fd);
         return kCircBufNoResource;
     }
@@ -319,7 +338,7 @@ void circbuf_disconnectBuffer(tCircBufInstance* pInstance_p)
 
     pArch = (tCircBufArchInstance*)pInstance_p->pCircBufArchInstance;
     munmap(pInstance_p->pCircBuf, pInstance_p->pCircBufHeader->bufferSize);
-    munmap(pInstance_p->pCircBufHeader, sizeof(tCircBufHeader));
+    munmap(pInstance_p->pCircBufHeader, pArch->headerSize);
     close(pArch->fd);
 }
 
@@ -327,7 +346,11 @@ void circbuf_disconnectBuffer(tCircBufInstance* pInstance_p)
 /**
 \brief  Lock circular buffer
 
-The function enters a locked section of the circular buffer.
+The function enters a locked section of the circular buffer. If the previous
+owner of the lock died inside the locked section, the lock is recovered. The
+buffer header is only changed after the data of a block is copied, so the
+buffer stays usable; a block which was reserved but not committed by the dead
+owner remains pending.
 
 \param  pInstance_p         Pointer to circular buffer instance.
 
@@ -338,7 +361,14 @@ void circbuf_lock(tCircBufInstance* pInstance_p)
 {
     tCircBufArchInstance* pArchInstance =
                               (tCircBufArchInstance*)pInstance_p->pCircBufArchInstance;
-    sem_wait(pArchInstance->lockSem);
+
+    if (pthread_mutex_lock(&pArchInstance->pLock->mutex) == EOWNERDEAD)
+    {
+        TRACE("%s() Recover lock of circbuf %d after death of owner\n",
+              __func__, pInstance_p->bufferId);
+        pArchInstance->pLock->recoverCount++;
+        pthread_mutex_consistent(&pArchInstance->pLock->mutex);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -356,7 +386,8 @@ void circbuf_unlock(tCircBufInstance* pInstance_p)
 {
     tCircBufArchInstance* pArchInstance =
                               (tCircBufArchInstance*)pInstance_p->pCircBufArchInstance;
-    sem_post(pArchInstance->lockSem);
+
+    pthread_mutex_unlock(&pArchInstance->pLock->mutex);
 }
 
 //============================================================================//
@@ -365,5 +396,69 @@ void circbuf_unlock(tCircBufInstance* pInstance_p)
 /// \name Private Functions
 /// \{
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get size of header area
+
+The function returns the size of the shared memory area which contains the
+buffer header and the shared lock. It is a multiple of the page size.
+
+\return The function returns the size of the header area.
+*/
+//------------------------------------------------------------------------------
+static size_t getHeaderSize(void)
+{
+    size_t      pageSize = sysconf(_SC_PAGE_SIZE);
+    size_t      size;
+
+    size = ((sizeof(tCircBufHeader) + sizeof(UINT64) - 1) & ~(sizeof(UINT64) - 1)) +
+           sizeof(tCircBufShmLock);
+    return (size + pageSize - 1) & ~(pageSize - 1);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get shared lock of circular buffer
+
+\param  pInstance_p         Pointer to circular buffer instance with mapped
+                            header area.
+
+\return The function returns the pointer to the shared lock.
+*/
+//------------------------------------------------------------------------------
+static tCircBufShmLock* getLock(tCircBufInstance* pInstance_p)
+{
+    return (tCircBufShmLock*)((BYTE*)pInstance_p->pCircBufHeader +
+                              ((sizeof(tCircBufHeader) + sizeof(UINT64) - 1) & ~(sizeof(UINT64) - 1)));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize shared lock
+
+The function initializes the robust process-shared mutex of a circular buffer.
+
+\param  pLock_p             Pointer to shared lock.
+
+\return The function returns TRUE if the lock is initialized.
+*/
+//------------------------------------------------------------------------------
+static BOOL initLock(tCircBufShmLock* pLock_p)
+{
+    pthread_mutexattr_t     attr;
+    BOOL                    fOk;
+
+    if (pthread_mutexattr_init(&attr) != 0)
+        return FALSE;
+
+    fOk = ((pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED) == 0) &&
+           (pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST) == 0) &&
+           (pthread_mutex_init(&pLock_p->mutex, &attr) == 0));
+
+    pthread_mutexattr_destroy(&attr);
+    pLock_p->recoverCount = 0;
+    return fOk;
+}
+
 ///\}
 
@@ -123,6 +123,7 @@ tCircBufInstance* circbuf_createInstance(UINT8 id_p)
     OPLK_MEMSET(pInstance, 0, sizeof(tCircBufInstance) + sizeof(tCircBufArchInstance));
     pInstance->pCircBufArchInstance = (BYTE*)pInstance + sizeof(tCircBufInstance);
     pInstance->bufferId = id_p;
+    pInstance->fLockFree = CIRCBUF_IS_LOCKFREE(id_p);
 
     pArch = (tCircBufArchInstance*)pInstance->pCircBufArchInstance;
 
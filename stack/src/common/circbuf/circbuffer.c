@@ -61,6 +61,19 @@ calling circbuf_connect(). The same applies for deinitialization.
 After all connected instances are disconnected by calling circbuf_disconnect(),
 the main instance can clean up and free the buffer by calling circbuf_free().
 
+Buffers with exactly one writing and one reading instance can be used in
+lock-free single-producer/single-consumer mode. In this mode the producer only
+modifies the write index and the consumer only modifies the read index of the
+buffer, therefore no lock is needed. The mode is selected per buffer ID in the
+architecture specific module (see CIRCBUF_LOCKFREE_BUFFERS).
+
+Producers can build a data block directly in the buffer by calling
+circbuf_reserve() and circbuf_commit(). Consumers can process a data block in
+the buffer by calling circbuf_peek() and circbuf_release(). Reserved blocks are
+always contiguous. If a block doesn't fit at the end of the buffer, the rest of
+the buffer is filled with a padding block and the block is placed at the start
+of the buffer.
+
 *******************************************************************************/
 
 //------------------------------------------------------------------------------
@@ -92,6 +105,8 @@ the main instance can clean up and free the buffer by calling circbuf_free().
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#define CIRCBUF_BLOCK_PADDING       0xFFFFFFFF      ///< Block header of a padding block
+#define CIRCBUF_BLOCK_PENDING       0x80000000      ///< Block header flag of a reserved block which isn't committed
 
 //------------------------------------------------------------------------------
 // local types
@@ -104,6 +119,21 @@ the main instance can clean up and free the buffer by calling circbuf_free().
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
+static tCircBufError writeDataLockFree(tCircBufInstance* pInstance_p,
+                                       const void* pData_p, size_t size_p,
+                                       const void* pData2_p, size_t size2_p);
+static tCircBufError readDataLockFree(tCircBufInstance* pInstance_p, void* pData_p,
+                                      size_t size_p, size_t* pDataBlockSize_p);
+static tCircBufError reserveBlockLockFree(tCircBufInstance* pInstance_p, size_t size_p,
+                                          void** ppData_p);
+static tCircBufError getFirstBlock(tCircBufInstance* pInstance_p, UINT32* pBlockHeader_p);
+static tCircBufError getFirstBlockLockFree(tCircBufInstance* pInstance_p,
+                                           UINT32* pBlockHeader_p);
+static void signalLockFree(tCircBufInstance* pInstance_p, UINT32 writeOffset_p);
+static void copyToBuffer(tCircBufInstance* pInstance_p, UINT32 offset_p,
+                         const void* pData_p, size_t size_p);
+static void copyFromBuffer(tCircBufInstance* pInstance_p, UINT32 offset_p,
+                           void* pData_p, size_t size_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -156,6 +186,11 @@ tCircBufError circbuf_alloc(UINT8 id_p, size_t size_p, tCircBufInstance** ppInst
 #ifdef DEBUG_CIRCBUF_SIZE_CHECK
     pInstance->pCircBufHeader->maxSize = 0;
 #endif
+    pInstance->pCircBufHeader->lockFree = (pInstance->fLockFree != FALSE);
+    pInstance->pCircBufHeader->writeIndex.index.offset = 0;
+    pInstance->pCircBufHeader->writeIndex.index.blockCount = 0;
+    pInstance->pCircBufHeader->readIndex.index.offset = 0;
+    pInstance->pCircBufHeader->readIndex.index.blockCount = 0;
     pInstance->pfnSigCb = NULL;
 
     *ppInstance_p = pInstance;
@@ -215,6 +250,9 @@ tCircBufError circbuf_connect(UINT8 id_p, tCircBufInstance** ppInstance_p)
         return kCircBufNoResource;
     }
 
+    // The mode of an existing buffer is determined by its creator
+    pInstance->fLockFree = (pInstance->pCircBufHeader->lockFree != 0);
+
     *ppInstance_p = pInstance;
 
     return kCircBufOk;
@@ -263,6 +301,10 @@ void circbuf_reset(tCircBufInstance* pInstance_p)
     pHeader->writeOffset = 0;
     pHeader->freeSize = pHeader->bufferSize;
     pHeader->dataCount = 0;
+    pHeader->writeIndex.index.offset = 0;
+    pHeader->writeIndex.index.blockCount = 0;
+    pHeader->readIndex.index.offset = 0;
+    pHeader->readIndex.index.blockCount = 0;
     circbuf_unlock(pInstance_p);
 }
 
@@ -293,6 +335,9 @@ tCircBufError circbuf_writeData (tCircBufInstance* pInstance_p, const void* pDat
     if ((pData_p == NULL) || (size_p == 0))
         return kCircBufOk;
 
+    if (pInstance_p->fLockFree)
+        return writeDataLockFree(pInstance_p, pData_p, size_p, NULL, 0);
+
     blockSize     = (size_p + (CIRCBUF_BLOCK_ALIGNMENT-1)) & ~(CIRCBUF_BLOCK_ALIGNMENT-1);
     fullBlockSize = blockSize + sizeof(UINT32);
 
@@ -376,6 +421,9 @@ tCircBufError circbuf_writeMultipleData(tCircBufInstance* pInstance_p,
         return kCircBufOk;
     }
 
+    if (pInstance_p->fLockFree)
+        return writeDataLockFree(pInstance_p, pData_p, size_p, pData2_p, size2_p);
+
     blockSize      = (size_p + size2_p + (CIRCBUF_BLOCK_ALIGNMENT - 1)) & ~(CIRCBUF_BLOCK_ALIGNMENT - 1);
     fullBlockSize  = blockSize + sizeof(UINT32);
 
@@ -461,6 +509,8 @@ The function reads a data block from a circular buffer.
 tCircBufError circbuf_readData(tCircBufInstance* pInstance_p, void* pData_p,
                                size_t size_p, size_t* pDataBlockSize_p)
 {
+    tCircBufError       ret;
+    UINT32              blockHeader;
     size_t              dataSize;
     size_t              blockSize;
     size_t              fullBlockSize;
@@ -471,14 +521,17 @@ tCircBufError circbuf_readData(tCircBufInstance* pInstance_p, void* pData_p,
     if ((pData_p == NULL) || (size_p == 0))
         return kCircBufOk;
 
+    if (pInstance_p->fLockFree)
+        return readDataLockFree(pInstance_p, pData_p, size_p, pDataBlockSize_p);
+
     circbuf_lock(pInstance_p);
-    if (pHeader->freeSize == pHeader->bufferSize)
+    if ((ret = getFirstBlock(pInstance_p, &blockHeader)) != kCircBufOk)
     {
         circbuf_unlock(pInstance_p);
-        return kCircBufNoReadableData;
+        return ret;
     }
 
-    dataSize = *(UINT32*)(pCircBuf + pHeader->readOffset);
+    dataSize = blockHeader;
     blockSize = (dataSize + (CIRCBUF_BLOCK_ALIGNMENT - 1)) & ~(CIRCBUF_BLOCK_ALIGNMENT - 1);
     fullBlockSize  = blockSize + sizeof(UINT32);
 
@@ -514,6 +567,245 @@ tCircBufError circbuf_readData(tCircBufInstance* pInstance_p, void* pData_p,
 
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Reserve a data block in a circular buffer
+
+The function reserves a contiguous data block in a circular buffer. The caller
+can build the data directly in the returned memory and must hand it over to the
+consumer by calling circbuf_commit(). In lock-free mode only one block can be
+reserved at a time and no other data must be written until the block is
+committed. In locked mode a reserved block holds back all following blocks
+from the consumer until it is committed.
+
+\param  pInstance_p     Pointer to circular buffer instance.
+\param  size_p          The size of the data block to reserve.
+\param  ppData_p        Pointer to store the pointer to the reserved data block.
+
+\return The function returns a tCircBufError error code.
+
+\ingroup module_lib_circbuf
+*/
+//------------------------------------------------------------------------------
+tCircBufError circbuf_reserve(tCircBufInstance* pInstance_p, size_t size_p, void** ppData_p)
+{
+    size_t              fullBlockSize;
+    size_t              chunkSize;
+    size_t              reqSize;
+    tCircBufHeader*     pHeader = pInstance_p->pCircBufHeader;
+    BYTE*               pCircBuf = pInstance_p->pCircBuf;
+
+    if ((ppData_p == NULL) || (size_p == 0) || (size_p >= CIRCBUF_BLOCK_PENDING))
+        return kCircBufInvalidArg;
+
+    if (pInstance_p->fLockFree)
+        return reserveBlockLockFree(pInstance_p, size_p, ppData_p);
+
+    fullBlockSize = ((size_p + (CIRCBUF_BLOCK_ALIGNMENT - 1)) & ~(CIRCBUF_BLOCK_ALIGNMENT - 1)) +
+                    sizeof(UINT32);
+
+    circbuf_lock(pInstance_p);
+
+    chunkSize = pHeader->bufferSize - pHeader->writeOffset;
+    reqSize = (fullBlockSize <= chunkSize) ? fullBlockSize : (chunkSize + fullBlockSize);
+    if (reqSize > pHeader->freeSize)
+    {
+        circbuf_unlock(pInstance_p);
+        return kCircBufOutOfMem;
+    }
+
+    if (fullBlockSize > chunkSize)
+    {   // Fill the end of the buffer with a padding block
+        *(UINT32*)(pCircBuf + pHeader->writeOffset) = CIRCBUF_BLOCK_PADDING;
+        pHeader->writeOffset = 0;
+    }
+
+    *(UINT32*)(pCircBuf + pHeader->writeOffset) = (UINT32)size_p | CIRCBUF_BLOCK_PENDING;
+    *ppData_p = pCircBuf + pHeader->writeOffset + sizeof(UINT32);
+
+    pHeader->writeOffset = (UINT32)((pHeader->writeOffset + fullBlockSize) % pHeader->bufferSize);
+    pHeader->freeSize -= reqSize;
+
+#ifdef DEBUG_CIRCBUF_SIZE_CHECK
+    if (pHeader->bufferSize - pHeader->freeSize > pHeader->maxSize)
+        pHeader->maxSize = pHeader->bufferSize - pHeader->freeSize;
+#endif
+
+    circbuf_unlock(pInstance_p);
+
+    return kCircBufOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Commit a reserved data block
+
+The function commits a data block which was reserved by circbuf_reserve().
+Afterwards the data block is available to the consumer.
+
+\param  pInstance_p     Pointer to circular buffer instance.
+\param  pData_p         Pointer to the reserved data block.
+
+\return The function returns a tCircBufError error code.
+
+\ingroup module_lib_circbuf
+*/
+//------------------------------------------------------------------------------
+tCircBufError circbuf_commit(tCircBufInstance* pInstance_p, void* pData_p)
+{
+    tCircBufHeader*     pHeader = pInstance_p->pCircBufHeader;
+    UINT32*             pBlockHeader;
+    UINT32              blockOffset;
+    size_t              fullBlockSize;
+    UINT32              writeOffset;
+
+    if (pData_p == NULL)
+        return kCircBufInvalidArg;
+
+    pBlockHeader = (UINT32*)((BYTE*)pData_p - sizeof(UINT32));
+
+    if (pInstance_p->fLockFree)
+    {
+        blockOffset = (UINT32)((BYTE*)pBlockHeader - pInstance_p->pCircBuf);
+        fullBlockSize = ((*pBlockHeader + (CIRCBUF_BLOCK_ALIGNMENT - 1)) & ~(CIRCBUF_BLOCK_ALIGNMENT - 1)) +
+                        sizeof(UINT32);
+
+        writeOffset = pHeader->writeIndex.index.offset;
+
+        // Publish the block after its data is completely written
+        OPLK_MEMBAR();
+        pHeader->writeIndex.index.blockCount++;
+        pHeader->writeIndex.index.offset = (UINT32)((blockOffset + fullBlockSize) % pHeader->bufferSize);
+
+        signalLockFree(pInstance_p, writeOffset);
+    }
+    else
+    {
+        circbuf_lock(pInstance_p);
+        *pBlockHeader &= ~CIRCBUF_BLOCK_PENDING;
+        pHeader->dataCount++;
+        circbuf_unlock(pInstance_p);
+
+        if (pInstance_p->pfnSigCb != NULL)
+        {
+            pInstance_p->pfnSigCb();
+        }
+    }
+
+    return kCircBufOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Peek at the next data block of a circular buffer
+
+The function returns the next data block of a circular buffer without copying
+it. The data block stays in the buffer until it is released by calling
+circbuf_release(). Data blocks written by circbuf_writeData() or
+circbuf_writeMultipleData() could wrap around the end of the buffer. For such
+a block kCircBufDataNotContiguous is returned and it must be read by
+circbuf_readData().
+
+\param  pInstance_p         Pointer to circular buffer instance.
+\param  ppData_p            Pointer to store the pointer to the data block.
+\param  pDataBlockSize_p    Pointer to store the size of the data block.
+
+\return The function returns a tCircBufError error code.
+
+\ingroup module_lib_circbuf
+*/
+//------------------------------------------------------------------------------
+tCircBufError circbuf_peek(tCircBufInstance* pInstance_p, void** ppData_p,
+                           size_t* pDataBlockSize_p)
+{
+    tCircBufError       ret;
+    UINT32              blockHeader;
+    UINT32              readOffset;
+    tCircBufHeader*     pHeader = pInstance_p->pCircBufHeader;
+
+    if ((ppData_p == NULL) || (pDataBlockSize_p == NULL))
+        return kCircBufInvalidArg;
+
+    if (pInstance_p->fLockFree)
+    {
+        ret = getFirstBlockLockFree(pInstance_p, &blockHeader);
+        readOffset = pHeader->readIndex.index.offset;
+    }
+    else
+    {
+        circbuf_lock(pInstance_p);
+        ret = getFirstBlock(pInstance_p, &blockHeader);
+        readOffset = pHeader->readOffset;
+        circbuf_unlock(pInstance_p);
+    }
+
+    if (ret != kCircBufOk)
+        return ret;
+
+    if (readOffset + sizeof(UINT32) + blockHeader > pHeader->bufferSize)
+        return kCircBufDataNotContiguous;
+
+    *ppData_p = pInstance_p->pCircBuf + readOffset + sizeof(UINT32);
+    *pDataBlockSize_p = blockHeader;
+
+    return kCircBufOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Release the next data block of a circular buffer
+
+The function removes the data block which was returned by circbuf_peek() from
+the circular buffer.
+
+\param  pInstance_p         Pointer to circular buffer instance.
+
+\return The function returns a tCircBufError error code.
+
+\ingroup module_lib_circbuf
+*/
+//------------------------------------------------------------------------------
+tCircBufError circbuf_release(tCircBufInstance* pInstance_p)
+{
+    tCircBufError       ret;
+    UINT32              blockHeader;
+    size_t              fullBlockSize;
+    tCircBufHeader*     pHeader = pInstance_p->pCircBufHeader;
+
+    if (pInstance_p->fLockFree)
+    {
+        if ((ret = getFirstBlockLockFree(pInstance_p, &blockHeader)) != kCircBufOk)
+            return ret;
+
+        fullBlockSize = ((blockHeader + (CIRCBUF_BLOCK_ALIGNMENT - 1)) & ~(CIRCBUF_BLOCK_ALIGNMENT - 1)) +
+                        sizeof(UINT32);
+
+        // Release the block after its data is completely processed
+        OPLK_MEMBAR();
+        pHeader->readIndex.index.blockCount++;
+        pHeader->readIndex.index.offset = (UINT32)((pHeader->readIndex.index.offset + fullBlockSize) %
+                                                   pHeader->bufferSize);
+        return kCircBufOk;
+    }
+
+    circbuf_lock(pInstance_p);
+    if ((ret = getFirstBlock(pInstance_p, &blockHeader)) != kCircBufOk)
+    {
+        circbuf_unlock(pInstance_p);
+        return ret;
+    }
+
+    fullBlockSize = ((blockHeader + (CIRCBUF_BLOCK_ALIGNMENT - 1)) & ~(CIRCBUF_BLOCK_ALIGNMENT - 1)) +
+                    sizeof(UINT32);
+    pHeader->readOffset = (UINT32)((pHeader->readOffset + fullBlockSize) % pHeader->bufferSize);
+    pHeader->freeSize += fullBlockSize;
+    pHeader->dataCount--;
+    circbuf_unlock(pInstance_p);
+
+    return kCircBufOk;
+}
+
+
 //------------------------------------------------------------------------------
 /**
 \brief  Get the available data count
@@ -530,6 +822,10 @@ The function returns the available data count
 UINT32 circbuf_getDataCount(tCircBufInstance* pInstance_p)
 {
     tCircBufHeader*     pHeader = pInstance_p->pCircBufHeader;
+
+    if (pInstance_p->fLockFree)
+        return pHeader->writeIndex.index.blockCount - pHeader->readIndex.index.blockCount;
+
     return pHeader->dataCount;
 }
 
@@ -579,5 +875,345 @@ tCircBufError circBuf_setSignaling(tCircBufInstance* pInstance_p, VOIDFUNCPTR pf
 /// \name Private Functions
 /// \{
 
+//------------------------------------------------------------------------------
+/**
+\brief  Write data to a lock-free circular buffer
+
+The function writes one or two data blocks as a single block to a circular
+buffer which is used in lock-free mode. It must only be called by the producer
+of the buffer. The write index is updated after the data is written, so the
+consumer never sees a partially written block. One block alignment unit is
+always kept free to distinguish a full from an empty buffer.
+
+\param  pInstance_p     Pointer to circular buffer instance.
+\param  pData_p         Pointer to the first data block to be written.
+\param  size_p          The size of the first data block to be written.
+\param  pData2_p        Pointer to the second data block to be written. NULL
+                        if only one data block should be written.
+\param  size2_p         The size of the second data block to be written.
+
+\return The function returns a tCircBufError error code.
+*/
+//------------------------------------------------------------------------------
+static tCircBufError writeDataLockFree(tCircBufInstance* pInstance_p,
+                                       const void* pData_p, size_t size_p,
+                                       const void* pData2_p, size_t size2_p)
+{
+    size_t              blockSize;
+    size_t              fullBlockSize;
+    size_t              usedSize;
+    UINT32              writeOffset;
+    UINT32              readOffset;
+    UINT32              dataOffset;
+    tCircBufHeader*     pHeader = pInstance_p->pCircBufHeader;
+
+    blockSize     = (size_p + size2_p + (CIRCBUF_BLOCK_ALIGNMENT - 1)) & ~(CIRCBUF_BLOCK_ALIGNMENT - 1);
+    fullBlockSize = blockSize + sizeof(UINT32);
+
+    writeOffset = pHeader->writeIndex.index.offset;
+    readOffset = pHeader->readIndex.index.offset;
+    OPLK_MEMBAR();
+
+    usedSize = (writeOffset + pHeader->bufferSize - readOffset) % pHeader->bufferSize;
+    if (fullBlockSize >= pHeader->bufferSize - usedSize)
+        return kCircBufOutOfMem;
+
+#ifdef DEBUG_CIRCBUF_SIZE_CHECK
+    if (usedSize + fullBlockSize > pHeader->maxSize)
+        pHeader->maxSize = (UINT32)(usedSize + fullBlockSize);
+#endif
+
+    *(UINT32*)(pInstance_p->pCircBuf + writeOffset) = (UINT32)(size_p + size2_p);
+    dataOffset = (UINT32)((writeOffset + sizeof(UINT32)) % pHeader->bufferSize);
+    copyToBuffer(pInstance_p, dataOffset, pData_p, size_p);
+    if (pData2_p != NULL)
+    {
+        dataOffset = (UINT32)((dataOffset + size_p) % pHeader->bufferSize);
+        copyToBuffer(pInstance_p, dataOffset, pData2_p, size2_p);
+    }
+
+    // Publish the block after its data is completely written
+    OPLK_MEMBAR();
+    pHeader->writeIndex.index.blockCount++;
+    pHeader->writeIndex.index.offset = (UINT32)((writeOffset + fullBlockSize) % pHeader->bufferSize);
+
+    signalLockFree(pInstance_p, writeOffset);
+
+    return kCircBufOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read data from a lock-free circular buffer
+
+The function reads a data block from a circular buffer which is used in
+lock-free mode. It must only be called by the consumer of the buffer. The read
+index is updated after the data is copied, so the producer never overwrites a
+block which is being read.
+
+\param  pInstance_p         Pointer to circular buffer instance.
+\param  pData_p             Pointer to store the read data.
+\param  size_p              The size of the destination buffer to store the data.
+\param  pDataBlockSize_p    Pointer to store the size of the read data.
+
+\return The function returns a tCircBufError error code.
+*/
+//------------------------------------------------------------------------------
+static tCircBufError readDataLockFree(tCircBufInstance* pInstance_p, void* pData_p,
+                                      size_t size_p, size_t* pDataBlockSize_p)
+{
+    size_t              dataSize;
+    size_t              fullBlockSize;
+    UINT32              readOffset;
+    tCircBufHeader*     pHeader = pInstance_p->pCircBufHeader;
+    tCircBufError       ret;
+    UINT32              blockHeader;
+
+    if ((ret = getFirstBlockLockFree(pInstance_p, &blockHeader)) != kCircBufOk)
+        return ret;
+
+    readOffset = pHeader->readIndex.index.offset;
+    dataSize = blockHeader;
+    if (dataSize > size_p)
+        return kCircBufReadsizeTooSmall;
+
+    fullBlockSize = ((dataSize + (CIRCBUF_BLOCK_ALIGNMENT - 1)) & ~(CIRCBUF_BLOCK_ALIGNMENT - 1)) +
+                    sizeof(UINT32);
+
+    copyFromBuffer(pInstance_p, (UINT32)((readOffset + sizeof(UINT32)) % pHeader->bufferSize),
+                   pData_p, dataSize);
+
+    // Release the block after its data is completely read
+    OPLK_MEMBAR();
+    pHeader->readIndex.index.blockCount++;
+    pHeader->readIndex.index.offset = (UINT32)((readOffset + fullBlockSize) % pHeader->bufferSize);
+
+    *pDataBlockSize_p = dataSize;
+    return kCircBufOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Reserve a data block in a lock-free circular buffer
+
+The function reserves a contiguous data block in a circular buffer which is
+used in lock-free mode. It must only be called by the producer of the buffer.
+The block is published by circbuf_commit(), therefore no pending flag is
+needed in its header.
+
+\param  pInstance_p     Pointer to circular buffer instance.
+\param  size_p          The size of the data block to reserve.
+\param  ppData_p        Pointer to store the pointer to the reserved data block.
+
+\return The function returns a tCircBufError error code.
+*/
+//------------------------------------------------------------------------------
+static tCircBufError reserveBlockLockFree(tCircBufInstance* pInstance_p, size_t size_p,
+                                          void** ppData_p)
+{
+    size_t              fullBlockSize;
+    size_t              chunkSize;
+    size_t              reqSize;
+    size_t              usedSize;
+    UINT32              writeOffset;
+    UINT32              readOffset;
+    tCircBufHeader*     pHeader = pInstance_p->pCircBufHeader;
+    BYTE*               pCircBuf = pInstance_p->pCircBuf;
+
+    fullBlockSize = ((size_p + (CIRCBUF_BLOCK_ALIGNMENT - 1)) & ~(CIRCBUF_BLOCK_ALIGNMENT - 1)) +
+                    sizeof(UINT32);
+
+    writeOffset = pHeader->writeIndex.index.offset;
+    readOffset = pHeader->readIndex.index.offset;
+    OPLK_MEMBAR();
+
+    usedSize = (writeOffset + pHeader->bufferSize - readOffset) % pHeader->bufferSize;
+    chunkSize = pHeader->bufferSize - writeOffset;
+    reqSize = (fullBlockSize <= chunkSize) ? fullBlockSize : (chunkSize + fullBlockSize);
+    if (reqSize >= pHeader->bufferSize - usedSize)
+        return kCircBufOutOfMem;
+
+#ifdef DEBUG_CIRCBUF_SIZE_CHECK
+    if (usedSize + reqSize > pHeader->maxSize)
+        pHeader->maxSize = (UINT32)(usedSize + reqSize);
+#endif
+
+    if (fullBlockSize > chunkSize)
+    {   // Fill the end of the buffer with a padding block
+        *(UINT32*)(pCircBuf + writeOffset) = CIRCBUF_BLOCK_PADDING;
+        writeOffset = 0;
+    }
+
+    *(UINT32*)(pCircBuf + writeOffset) = (UINT32)size_p;
+    *ppData_p = pCircBuf + writeOffset + sizeof(UINT32);
+
+    return kCircBufOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get first data block of circular buffer
+
+The function skips a padding block at the read offset of a circular buffer and
+returns the header of the first data block. The caller must lock the buffer.
+
+\param  pInstance_p         Pointer to circular buffer instance.
+\param  pBlockHeader_p      Pointer to store the header of the data block.
+
+\return The function returns a tCircBufError error code.
+*/
+//------------------------------------------------------------------------------
+static tCircBufError getFirstBlock(tCircBufInstance* pInstance_p, UINT32* pBlockHeader_p)
+{
+    tCircBufHeader*     pHeader = pInstance_p->pCircBufHeader;
+    UINT32              blockHeader;
+
+    if (pHeader->freeSize == pHeader->bufferSize)
+        return kCircBufNoReadableData;
+
+    blockHeader = *(UINT32*)(pInstance_p->pCircBuf + pHeader->readOffset);
+    if (blockHeader == CIRCBUF_BLOCK_PADDING)
+    {
+        pHeader->freeSize += pHeader->bufferSize - pHeader->readOffset;
+        pHeader->readOffset = 0;
+        blockHeader = *(UINT32*)(pInstance_p->pCircBuf);
+    }
+
+    if ((blockHeader & CIRCBUF_BLOCK_PENDING) != 0)
+        return kCircBufNoReadableData;
+
+    *pBlockHeader_p = blockHeader;
+    return kCircBufOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get first data block of lock-free circular buffer
+
+The function skips a padding block at the read index of a circular buffer which
+is used in lock-free mode and returns the header of the first data block. It
+must only be called by the consumer of the buffer.
+
+\param  pInstance_p         Pointer to circular buffer instance.
+\param  pBlockHeader_p      Pointer to store the header of the data block.
+
+\return The function returns a tCircBufError error code.
+*/
+//------------------------------------------------------------------------------
+static tCircBufError getFirstBlockLockFree(tCircBufInstance* pInstance_p,
+                                           UINT32* pBlockHeader_p)
+{
+    tCircBufHeader*     pHeader = pInstance_p->pCircBufHeader;
+    UINT32              readOffset;
+    UINT32              writeOffset;
+    UINT32              blockHeader;
+
+    readOffset = pHeader->readIndex.index.offset;
+    writeOffset = pHeader->writeIndex.index.offset;
+    OPLK_MEMBAR();
+
+    if (readOffset == writeOffset)
+        return kCircBufNoReadableData;
+
+    blockHeader = *(UINT32*)(pInstance_p->pCircBuf + readOffset);
+    if (blockHeader == CIRCBUF_BLOCK_PADDING)
+    {
+        // A padding block is always followed by a data block at the start
+        pHeader->readIndex.index.offset = 0;
+        blockHeader = *(UINT32*)(pInstance_p->pCircBuf);
+    }
+
+    *pBlockHeader_p = blockHeader;
+    return kCircBufOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Signal a write to a lock-free circular buffer
+
+The function calls the signaling callback after a data block was published in
+a lock-free circular buffer. If fSignalOnEmpty is set, the callback is only
+called if the consumer has already read all blocks before the new one, i.e. the
+buffer was empty. The consumer must then read all available blocks for each
+signal. The read index is read after the write index is published, so a
+consumer which empties the buffer concurrently never misses the signal.
+
+\param  pInstance_p         Pointer to circular buffer instance.
+\param  writeOffset_p       Write offset before the new data block was published.
+*/
+//------------------------------------------------------------------------------
+static void signalLockFree(tCircBufInstance* pInstance_p, UINT32 writeOffset_p)
+{
+    if (pInstance_p->pfnSigCb == NULL)
+        return;
+
+    if (pInstance_p->fSignalOnEmpty)
+    {
+        OPLK_MEMBAR();
+        if (pInstance_p->pCircBufHeader->readIndex.index.offset != writeOffset_p)
+            return;
+    }
+
+    pInstance_p->pfnSigCb();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy data into circular buffer
+
+The function copies data into the circular buffer. If the data exceeds the end
+of the buffer, it is continued at the start of the buffer.
+
+\param  pInstance_p         Pointer to circular buffer instance.
+\param  offset_p            Offset in the circular buffer to write the data.
+\param  pData_p             Pointer to the data to be copied.
+\param  size_p              The size of the data to be copied.
+*/
+//------------------------------------------------------------------------------
+static void copyToBuffer(tCircBufInstance* pInstance_p, UINT32 offset_p,
+                         const void* pData_p, size_t size_p)
+{
+    size_t      chunkSize = pInstance_p->pCircBufHeader->bufferSize - offset_p;
+
+    if (size_p <= chunkSize)
+    {
+        OPLK_MEMCPY(pInstance_p->pCircBuf + offset_p, pData_p, size_p);
+    }
+    else
+    {
+        OPLK_MEMCPY(pInstance_p->pCircBuf + offset_p, pData_p, chunkSize);
+        OPLK_MEMCPY(pInstance_p->pCircBuf, (const UINT8*)pData_p + chunkSize, size_p - chunkSize);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy data from circular buffer
+
+The function copies data from the circular buffer. If the data exceeds the end
+of the buffer, it is continued at the start of the buffer.
+
+\param  pInstance_p         Pointer to circular buffer instance.
+\param  offset_p            Offset in the circular buffer to read the data.
+\param  pData_p             Pointer to store the data.
+\param  size_p              The size of the data to be copied.
+*/
+//------------------------------------------------------------------------------
+static void copyFromBuffer(tCircBufInstance* pInstance_p, UINT32 offset_p,
+                           void* pData_p, size_t size_p)
+{
+    size_t      chunkSize = pInstance_p->pCircBufHeader->bufferSize - offset_p;
+
+    if (size_p <= chunkSize)
+    {
+        OPLK_MEMCPY(pData_p, pInstance_p->pCircBuf + offset_p, size_p);
+    }
+    else
+    {
+        OPLK_MEMCPY(pData_p, pInstance_p->pCircBuf + offset_p, chunkSize);
+        OPLK_MEMCPY((UINT8*)pData_p + chunkSize, pInstance_p->pCircBuf, size_p - chunkSize);
+    }
+}
+
 ///\}
 
@@ -0,0 +1,762 @@
+/**
+********************************************************************************
+\file   cyclestat.c
+
+\brief  Implementation of the cycle statistics module
+
+The cycle statistics module measures the latency of the stages of a POWERLINK
+cycle relative to the start of the cycle. The latencies are recorded in
+histograms with logarithmic buckets which are split into linear sub-buckets
+(HDR histogram). Every stage is only marked from a single context, therefore
+the histograms are updated without locks. The histograms are located in the
+memory provided by the cycle statistics memory implementation, which can be
+shared between the user and the kernel layer.
+
+\ingroup module_cyclestat
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <common/cyclestat.h>
+#include <common/target.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define CYCLESTAT_WINDOW_HALF_SIZE  ((CONFIG_CYCLE_STATISTICS_WINDOW_SIZE + 1) / 2)
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tCycleStatMemory*    pCycleStatMem_l = NULL;
+static UINT                 initCount_l = 0;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void addSample(tCycleStatHistogram* pHistogram_p, tCycleStatWindow* pWindow_p,
+                      ULONGLONG time_p);
+static void addWindowSample(tCycleStatWindow* pWindow_p, UINT bucketIndex_p);
+static void setPercentiles(tCycleStatHistogram* pHistogram_p, const tCycleStatWindow* pWindow_p);
+static UINT getBucketIndex(UINT32 time_p);
+static UINT getNodeIndex(UINT nodeId_p, BOOL fAssign_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize cycle statistics module
+
+The function initializes the cycle statistics module. If the user and the
+kernel layer run in the same process, the function is called by both layers.
+The module is initialized by the first call only.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_cyclestat
+*/
+//------------------------------------------------------------------------------
+tOplkError cyclestat_init(void)
+{
+    tOplkError      ret;
+
+    if (initCount_l == 0)
+    {
+        ret = cyclestat_initMemory(&pCycleStatMem_l);
+        if (ret != kErrorOk)
+        {
+            pCycleStatMem_l = NULL;
+            return ret;
+        }
+    }
+
+    initCount_l++;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Shut down cycle statistics module
+
+The function shuts down the cycle statistics module. The module is shut down
+by the call matching the first call of cyclestat_init().
+
+\ingroup module_cyclestat
+*/
+//------------------------------------------------------------------------------
+void cyclestat_exit(void)
+{
+    if (initCount_l == 0)
+        return;
+
+    initCount_l--;
+    if (initCount_l == 0)
+    {
+        pCycleStatMem_l = NULL;
+        cyclestat_exitMemory();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Mark the start of a cycle
+
+The function stores the start time of a new cycle and records the time since
+the start of the previous cycle. It must only be called by the DLL.
+
+\ingroup module_cyclestat
+*/
+//------------------------------------------------------------------------------
+void cyclestat_startCycle(void)
+{
+    ULONGLONG       timeStamp;
+    ULONGLONG       lastCycleStartTime;
+
+    if (pCycleStatMem_l == NULL)
+        return;
+
+    timeStamp = target_getCycleCounter();
+    lastCycleStartTime = pCycleStatMem_l->cycleStartTime;
+    pCycleStatMem_l->cycleStartTime = timeStamp;
+
+    if (lastCycleStartTime != 0)
+    {
+        addSample(&pCycleStatMem_l->statistics.aStage[kCycleStatStageCycleStart],
+                  &pCycleStatMem_l->aStageWindow[kCycleStatStageCycleStart],
+                  target_convertCyclesToNs(timeStamp - lastCycleStartTime));
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Mark a cycle stage
+
+The function records the time of the specified cycle stage relative to the
+start of the current cycle. A stage must only be marked from a single context.
+
+\param  stage_p         The cycle stage to be marked.
+
+\ingroup module_cyclestat
+*/
+//------------------------------------------------------------------------------
+void cyclestat_mark(tCycleStatStage stage_p)
+{
+    ULONGLONG       timeStamp;
+    ULONGLONG       cycleStartTime;
+
+    if ((pCycleStatMem_l == NULL) || (stage_p >= kCycleStatStageCount))
+        return;
+
+    cycleStartTime = pCycleStatMem_l->cycleStartTime;
+    if (cycleStartTime == 0)
+        return;     // no cycle started yet
+
+    timeStamp = target_getCycleCounter();
+    if (timeStamp < cycleStartTime)
+        return;     // new cycle was started concurrently
+
+    addSample(&pCycleStatMem_l->statistics.aStage[stage_p],
+              &pCycleStatMem_l->aStageWindow[stage_p],
+              target_convertCyclesToNs(timeStamp - cycleStartTime));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Mark the transmission of a PReq
+
+The function records the time of the transmission of a PReq to the specified
+node relative to the start of the current cycle. It must only be called by the
+DLL. If all node entries are already assigned to other nodes, the PReq is not
+recorded.
+
+\param  nodeId_p        Node ID of the destination of the PReq.
+
+\ingroup module_cyclestat
+*/
+//------------------------------------------------------------------------------
+void cyclestat_markPreqTx(UINT nodeId_p)
+{
+    ULONGLONG       timeStamp;
+    ULONGLONG       cycleStartTime;
+    UINT            index;
+
+    if (pCycleStatMem_l == NULL)
+        return;
+
+    index = getNodeIndex(nodeId_p, TRUE);
+    if (index >= CYCLESTAT_NODE_COUNT)
+        return;
+
+    timeStamp = target_getCycleCounter();
+    pCycleStatMem_l->aNodeWindow[index].preqTxTime = timeStamp;
+
+    cycleStartTime = pCycleStatMem_l->cycleStartTime;
+    if ((cycleStartTime == 0) || (timeStamp < cycleStartTime))
+        return;
+
+    addSample(&pCycleStatMem_l->statistics.aNode[index].socToPreq,
+              &pCycleStatMem_l->aNodeWindow[index].socToPreq,
+              target_convertCyclesToNs(timeStamp - cycleStartTime));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Mark the reception of a PRes
+
+The function records the time of the reception of a PRes from the specified
+node relative to the transmission of the PReq to this node. It must only be
+called by the DLL. A PRes is only recorded if the PReq was transmitted in the
+current cycle.
+
+\param  nodeId_p        Node ID of the source of the PRes.
+
+\ingroup module_cyclestat
+*/
+//------------------------------------------------------------------------------
+void cyclestat_markPresRx(UINT nodeId_p)
+{
+    ULONGLONG       timeStamp;
+    ULONGLONG       preqTxTime;
+    UINT            index;
+
+    if (pCycleStatMem_l == NULL)
+        return;
+
+    index = getNodeIndex(nodeId_p, FALSE);
+    if (index >= CYCLESTAT_NODE_COUNT)
+        return;     // node was never requested
+
+    preqTxTime = pCycleStatMem_l->aNodeWindow[index].preqTxTime;
+    if ((preqTxTime == 0) || (preqTxTime < pCycleStatMem_l->cycleStartTime))
+        return;     // no PReq in the current cycle
+
+    pCycleStatMem_l->aNodeWindow[index].preqTxTime = 0;
+
+    timeStamp = target_getCycleCounter();
+    if (timeStamp < preqTxTime)
+        return;
+
+    addSample(&pCycleStatMem_l->statistics.aNode[index].preqToPres,
+              &pCycleStatMem_l->aNodeWindow[index].preqToPres,
+              target_convertCyclesToNs(timeStamp - preqTxTime));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Mark the hardware time stamp of a SoC
+
+The function records the time between the hardware time stamps of two
+consecutive SoC frames, i.e. the transmission time on an MN and the reception
+time on a CN. It must only be called by the DLL.
+
+\param  timeStamp_p     Hardware time stamp of the SoC in ns (0 = not available).
+
+\ingroup module_cyclestat
+*/
+//------------------------------------------------------------------------------
+void cyclestat_markSocWire(ULONGLONG timeStamp_p)
+{
+    ULONGLONG       lastTimeStamp;
+
+    if (pCycleStatMem_l == NULL)
+        return;
+
+    lastTimeStamp = pCycleStatMem_l->socWireTime;
+    pCycleStatMem_l->socWireTime = timeStamp_p;
+
+    if ((timeStamp_p == 0) || (lastTimeStamp == 0) || (timeStamp_p < lastTimeStamp))
+        return;
+
+    addSample(&pCycleStatMem_l->statistics.aStage[kCycleStatStageSocWire],
+              &pCycleStatMem_l->aStageWindow[kCycleStatStageSocWire],
+              timeStamp_p - lastTimeStamp);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add the wire latency of a PRes
+
+The function records the time between the hardware time stamps of the PReq to
+the specified node and of the PRes of this node. It must only be called by the
+DLL.
+
+\param  nodeId_p        Node ID of the source of the PRes.
+\param  latency_p       Time from the PReq to the PRes on the wire in ns.
+
+\ingroup module_cyclestat
+*/
+//------------------------------------------------------------------------------
+void cyclestat_addPresWireLatency(UINT nodeId_p, ULONGLONG latency_p)
+{
+    UINT            index;
+
+    if (pCycleStatMem_l == NULL)
+        return;
+
+    index = getNodeIndex(nodeId_p, FALSE);
+    if (index >= CYCLESTAT_NODE_COUNT)
+        return;     // node was never requested
+
+    addSample(&pCycleStatMem_l->statistics.aNode[index].preqToPresWire,
+              &pCycleStatMem_l->aNodeWindow[index].preqToPresWire,
+              latency_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get cycle statistics
+
+The function copies the current cycle statistics and determines the
+percentiles of the rolling windows. The histograms are updated without locks,
+therefore the samples of a stage which are recorded during the copy may be
+incomplete in the copy.
+
+\param  pStatistics_p   Pointer to store the cycle statistics.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_cyclestat
+*/
+//------------------------------------------------------------------------------
+tOplkError cyclestat_getStatistics(tCycleStatistics* pStatistics_p)
+{
+    UINT            index;
+
+    if (pCycleStatMem_l == NULL)
+        return kErrorNoResource;
+
+    OPLK_MEMBAR();
+    OPLK_MEMCPY(pStatistics_p, &pCycleStatMem_l->statistics, sizeof(tCycleStatistics));
+
+    for (index = 0; index < kCycleStatStageCount; index++)
+        setPercentiles(&pStatistics_p->aStage[index], &pCycleStatMem_l->aStageWindow[index]);
+
+    for (index = 0; index < CYCLESTAT_NODE_COUNT; index++)
+    {
+        setPercentiles(&pStatistics_p->aNode[index].socToPreq,
+                       &pCycleStatMem_l->aNodeWindow[index].socToPreq);
+        setPercentiles(&pStatistics_p->aNode[index].preqToPres,
+                       &pCycleStatMem_l->aNodeWindow[index].preqToPres);
+        setPercentiles(&pStatistics_p->aNode[index].preqToPresWire,
+                       &pCycleStatMem_l->aNodeWindow[index].preqToPresWire);
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Mark the start of the sync processing
+
+The function records the start of the sync processing of the application and
+marks the stage \ref kCycleStatStageAppSync. It must only be called by the
+user layer when the sync event is delivered to the application.
+
+\ingroup module_cyclestat
+*/
+//------------------------------------------------------------------------------
+void cyclestat_markSyncStart(void)
+{
+    ULONGLONG       timeStamp;
+    ULONGLONG       cycleStartTime;
+
+    if (pCycleStatMem_l == NULL)
+        return;
+
+    cyclestat_mark(kCycleStatStageAppSync);
+
+    cycleStartTime = pCycleStatMem_l->cycleStartTime;
+    timeStamp = target_getCycleCounter();
+    if ((cycleStartTime == 0) || (timeStamp < cycleStartTime))
+        return;
+
+    pCycleStatMem_l->syncCycleStartTime = cycleStartTime;
+    pCycleStatMem_l->syncBudget.lastStartTime =
+        (UINT32)target_convertCyclesToNs(timeStamp - cycleStartTime);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the end of the sync processing
+
+The function records the end of the sync processing of the application and
+checks it against the sync budget. It must only be called by the user layer
+before the TPDOs are copied from the process image.
+
+\return The function returns TRUE if the TPDOs shall be copied and FALSE if
+        they are too late and shall be skipped.
+
+\ingroup module_cyclestat
+*/
+//------------------------------------------------------------------------------
+BOOL cyclestat_checkSyncEnd(void)
+{
+    tCycleStatSyncBudget*   pSyncBudget;
+    ULONGLONG               timeStamp;
+    ULONGLONG               syncCycleStartTime;
+    UINT32                  endTime;
+    BOOL                    fOverrun;
+
+    if (pCycleStatMem_l == NULL)
+        return TRUE;
+
+    pSyncBudget = &pCycleStatMem_l->syncBudget;
+    syncCycleStartTime = pCycleStatMem_l->syncCycleStartTime;
+    if ((pSyncBudget->budget == 0) || (syncCycleStartTime == 0))
+        return TRUE;    // no budget or no sync processing started
+
+    pCycleStatMem_l->syncCycleStartTime = 0;
+    timeStamp = target_getCycleCounter();
+    endTime = (UINT32)target_convertCyclesToNs(timeStamp - syncCycleStartTime);
+    pSyncBudget->lastEndTime = endTime;
+    pSyncBudget->cycleCount++;
+
+    if (pCycleStatMem_l->cycleStartTime != syncCycleStartTime)
+    {   // the next cycle already started
+        fOverrun = TRUE;
+    }
+    else
+    {
+        if (endTime > pSyncBudget->maxEndTime)
+            pSyncBudget->maxEndTime = endTime;
+        fOverrun = (endTime > pSyncBudget->budget);
+    }
+
+    if (!fOverrun)
+        return TRUE;
+
+    pSyncBudget->overrunCount++;
+    if (!pSyncBudget->fSkipLateTxPdo)
+        return TRUE;
+
+    pSyncBudget->skippedTxPdoCount++;
+    return FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set the sync budget
+
+The function sets the sync budget of the application and resets the sync
+budget statistics.
+
+\param  budget_p            Budget of the sync processing in ns relative to the
+                            start of the cycle. 0 disables the check.
+\param  fSkipLateTxPdo_p    If TRUE, the TPDOs of a sync processing which
+                            exceeded the budget are not copied. The previous
+                            TPDOs are sent instead.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_cyclestat
+*/
+//------------------------------------------------------------------------------
+tOplkError cyclestat_setSyncBudget(UINT32 budget_p, BOOL fSkipLateTxPdo_p)
+{
+    if (pCycleStatMem_l == NULL)
+        return kErrorNoResource;
+
+    pCycleStatMem_l->syncCycleStartTime = 0;
+    OPLK_MEMSET(&pCycleStatMem_l->syncBudget, 0, sizeof(tCycleStatSyncBudget));
+    pCycleStatMem_l->syncBudget.budget = budget_p;
+    pCycleStatMem_l->syncBudget.fSkipLateTxPdo = fSkipLateTxPdo_p;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get sync budget statistics
+
+The function copies the settings and the statistics of the sync budget.
+
+\param  pSyncBudget_p   Pointer to store the sync budget statistics.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_cyclestat
+*/
+//------------------------------------------------------------------------------
+tOplkError cyclestat_getSyncBudget(tCycleStatSyncBudget* pSyncBudget_p)
+{
+    if (pCycleStatMem_l == NULL)
+        return kErrorNoResource;
+
+    OPLK_MEMBAR();
+    OPLK_MEMCPY(pSyncBudget_p, &pCycleStatMem_l->syncBudget, sizeof(tCycleStatSyncBudget));
+
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add sample to histogram
+
+The function adds a sample to the specified histogram and its rolling window.
+Times which exceed the range of the histogram are recorded in its last bucket.
+
+\param  pHistogram_p    Pointer to the histogram.
+\param  pWindow_p       Pointer to the rolling window of the histogram.
+\param  time_p          Time to be recorded in ns.
+*/
+//------------------------------------------------------------------------------
+static void addSample(tCycleStatHistogram* pHistogram_p, tCycleStatWindow* pWindow_p,
+                      ULONGLONG time_p)
+{
+    UINT32          time;
+    UINT            bucketIndex;
+
+    time = (time_p > 0xFFFFFFFFULL) ? 0xFFFFFFFF : (UINT32)time_p;
+    bucketIndex = getBucketIndex(time);
+
+    addWindowSample(pWindow_p, bucketIndex);
+
+    pHistogram_p->aBucket[bucketIndex]++;
+    if ((pHistogram_p->sampleCount == 0) || (time < pHistogram_p->minTime))
+        pHistogram_p->minTime = time;
+    if (time > pHistogram_p->maxTime)
+        pHistogram_p->maxTime = time;
+    pHistogram_p->totalTime += time;
+
+    // Publish the sample count after the sample is completely recorded
+    OPLK_MEMBAR();
+    pHistogram_p->sampleCount++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add sample to rolling window
+
+The function adds a sample to the active half of a rolling window. If the
+active half is full, the other half is cleared and activated before.
+
+\param  pWindow_p       Pointer to the rolling window.
+\param  bucketIndex_p   Index of the histogram bucket of the sample.
+*/
+//------------------------------------------------------------------------------
+static void addWindowSample(tCycleStatWindow* pWindow_p, UINT bucketIndex_p)
+{
+    UINT32          half = pWindow_p->activeHalf;
+
+    if (pWindow_p->aSampleCount[half] >= CYCLESTAT_WINDOW_HALF_SIZE)
+    {
+        half ^= 1;
+        pWindow_p->aSampleCount[half] = 0;
+        OPLK_MEMSET(pWindow_p->aBucket[half], 0, sizeof(pWindow_p->aBucket[half]));
+        OPLK_MEMBAR();
+        pWindow_p->activeHalf = half;
+    }
+
+    pWindow_p->aBucket[half][bucketIndex_p]++;
+    pWindow_p->aSampleCount[half]++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Determine percentiles of rolling window
+
+The function determines the percentiles of a rolling window and stores them
+in the copy of its histogram. The number of samples is counted from the
+buckets, so that a concurrent update of the window only shifts the
+percentiles by the concurrently recorded samples.
+
+\param  pHistogram_p    Pointer to the copy of the histogram.
+\param  pWindow_p       Pointer to the rolling window of the histogram.
+*/
+//------------------------------------------------------------------------------
+static void setPercentiles(tCycleStatHistogram* pHistogram_p, const tCycleStatWindow* pWindow_p)
+{
+    static const UINT   aPermille[3] = {500, 990, 999};
+    UINT32*             apPercentile[3];
+    UINT64              aRank[3];
+    UINT64              sampleCount = 0;
+    UINT64              count = 0;
+    UINT32              upperLimit;
+    UINT                index;
+    UINT                percentile = 0;
+
+    apPercentile[0] = &pHistogram_p->p50Time;
+    apPercentile[1] = &pHistogram_p->p99Time;
+    apPercentile[2] = &pHistogram_p->p999Time;
+
+    for (index = 0; index < CYCLESTAT_BUCKET_COUNT; index++)
+        sampleCount += pWindow_p->aBucket[0][index] + pWindow_p->aBucket[1][index];
+
+    pHistogram_p->windowSampleCount = (UINT32)sampleCount;
+    pHistogram_p->p50Time = 0;
+    pHistogram_p->p99Time = 0;
+    pHistogram_p->p999Time = 0;
+
+    if (sampleCount == 0)
+        return;
+
+    for (index = 0; index < 3; index++)
+        aRank[index] = ((sampleCount * aPermille[index]) + 999) / 1000;
+
+    for (index = 0; (index < CYCLESTAT_BUCKET_COUNT) && (percentile < 3); index++)
+    {
+        count += pWindow_p->aBucket[0][index] + pWindow_p->aBucket[1][index];
+
+        upperLimit = (index < CYCLESTAT_BUCKET_COUNT - 1) ?
+                     (CYCLESTAT_BUCKET_LOWER_LIMIT(index + 1) - 1) : 0xFFFFFFFF;
+        if (upperLimit > pHistogram_p->maxTime)
+            upperLimit = pHistogram_p->maxTime;
+
+        while ((percentile < 3) && (count >= aRank[percentile]))
+        {
+            *apPercentile[percentile] = upperLimit;
+            percentile++;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get histogram bucket of a time
+
+The function determines the index of the histogram bucket of the specified
+time. Times below CYCLESTAT_SUB_BUCKET_COUNT are mapped linearly, all other
+times are mapped to the sub-bucket of their most significant bit.
+
+\param  time_p          Time in ns.
+
+\return The function returns the index of the histogram bucket.
+*/
+//------------------------------------------------------------------------------
+static UINT getBucketIndex(UINT32 time_p)
+{
+    UINT32          value = time_p;
+    UINT            msb = 0;
+
+    if (time_p < CYCLESTAT_SUB_BUCKET_COUNT)
+        return (UINT)time_p;
+
+    if (value >= 0x10000)
+    {
+        value >>= 16;
+        msb += 16;
+    }
+    if (value >= 0x100)
+    {
+        value >>= 8;
+        msb += 8;
+    }
+    if (value >= 0x10)
+    {
+        value >>= 4;
+        msb += 4;
+    }
+    if (value >= 0x4)
+    {
+        value >>= 2;
+        msb += 2;
+    }
+    if (value >= 0x2)
+        msb += 1;
+
+    return ((msb - CYCLESTAT_SUB_BUCKET_BITS + 1) * CYCLESTAT_SUB_BUCKET_COUNT) +
+           ((time_p >> (msb - CYCLESTAT_SUB_BUCKET_BITS)) & (CYCLESTAT_SUB_BUCKET_COUNT - 1));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get node entry of a node
+
+The function searches the node entry of the specified node. If the node has no
+entry yet, a free entry can be assigned to it.
+
+\param  nodeId_p        Node ID of the node.
+\param  fAssign_p       Assign a free entry if the node has no entry.
+
+\return The function returns the index of the node entry or
+        CYCLESTAT_NODE_COUNT if no entry is available.
+*/
+//------------------------------------------------------------------------------
+static UINT getNodeIndex(UINT nodeId_p, BOOL fAssign_p)
+{
+    tCycleStatNode*     pNode = pCycleStatMem_l->statistics.aNode;
+    UINT                index;
+
+    if (nodeId_p == 0)
+        return CYCLESTAT_NODE_COUNT;
+
+    for (index = 0; index < CYCLESTAT_NODE_COUNT; index++, pNode++)
+    {
+        if (pNode->nodeId == nodeId_p)
+            return index;
+
+        if (pNode->nodeId == 0)
+        {   // the entries are assigned in order, so the node has no entry
+            if (!fAssign_p)
+                break;
+
+            pNode->nodeId = nodeId_p;
+            return index;
+        }
+    }
+
+    return CYCLESTAT_NODE_COUNT;
+}
+
+/// \}
@@ -85,27 +85,23 @@ typedef struct
     char*                sApiEvent;
 } tApiEventInfo;
 
-typedef struct
-{
-    tOplkError          key;
-    char*               sName;
-} tRetValInfo;
+/**
+\brief Value string entry
 
+The structure assigns a string to a value of a sparse value range (error codes,
+emergency error codes, abort codes). The tables of these entries are sorted by
+ascending value, so they can be searched binary.
+*/
 typedef struct
 {
-    UINT16              key;
+    UINT32              value;
     char*               sName;
-} tEmergErrCodeInfo;
-
-typedef struct
-{
-    UINT32              abortCode;
-    char*               sAbortCode;
-} tAbortCodeInfo;
+} tValueStrInfo;
 
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
+static char* findValueStr(const tValueStrInfo* pTable_p, UINT count_p, UINT32 value_p);
 
 //------------------------------------------------------------------------------
 // local vars
@@ -217,6 +213,7 @@ static char* eventSinkStr_l[] =
     "EventSinkNmtMnu",
     "EventSinkLedu",
     "EventSinkPdokCal",
+    "EventSinkSdoCom",
     "EventSinkGw309Ascii",
     "EventSinkApi"
 };
@@ -251,7 +248,7 @@ static char* eventTypeStr_l[] =
     "EventTypeNmtMnuNmtCmdSent",        // NMT command was actually sent
     "EventTypeApiUserDef",              // user-defined event
     "EventTypeDllkCycleFinish",         // SoA sent, cycle finished
-    "0x1B",                             // reserved
+    "EventTypeDllkPresFill",            // DLL kernel late PRes fill event
     "0x1C",                             // reserved
     "0x1D",                             // reserved
     "0x1E",                             // reserved
@@ -262,7 +259,15 @@ static char* eventTypeStr_l[] =
     "EventTypeGw309AsciiReq",           // GW309ASCII request
     "EventTypeNmtMnuNodeAdded",         // node was added to isochronous phase by DLL
     "EventTypePdokSetupPdoBuf",         // dealloc PDOs
-    "EventTypePdokControlSync"          // enable/disable the pdokcal sync trigger (arg is pointer to BOOL)
+    "EventTypePdokControlSync",         // enable/disable the pdokcal sync trigger (arg is pointer to BOOL)
+    "EventTypeReleaseRxFrame",          // free receive buffer
+    "EventTypeAsndNotRx",               // didn't receive ASnd frame for DLL user module
+    "EventTypeDllkServLimit",           // configure ASnd forwarding limits
+    "EventTypePdokAddRoute",            // add RPDO to TPDO route
+    "EventTypePdokClearRoutes",         // remove all RPDO to TPDO routes
+    "EventTypeSdoObdAccessDone",        // deferred OD access of the SDO server finished
+    "EventTypePdokSetupKernelPi",       // set up the kernel process images
+    "EventTypeNmtMnuLinkUp"             // link of the MN came up
 };
 
 // text strings for POWERLINK states
@@ -305,8 +310,8 @@ static tApiEventInfo apiEventInfo_l[] =
     { kOplkApiEventCfmResult,        "CFM result"                        },
 };
 
-// text strings for values of type tOplkError
-static tRetValInfo retValInfo_l[] =
+// text strings for values of type tOplkError (sorted by value)
+static const tValueStrInfo retValInfo_l[] =
 {
     /* area for generic errors 0x0000 - 0x000F */
     { kErrorOk,                       "No error / function call successful"},
@@ -364,6 +369,7 @@ static tRetValInfo retValInfo_l[] =
     { kErrorObdInvalidDcf,            "Device configuration file (CDC) is not valid"},
     { kErrorObdOutOfMemory,           "Out of memory"},
     { kErrorObdNoConfigData,          "No configuration data present (CDC is empty)"},
+    { kErrorObdStoreInvalid,          "Stored OD data is not valid"},
 
 
     /* area for NMT module 0x0040 - 0x004F */
@@ -459,16 +465,15 @@ static tRetValInfo retValInfo_l[] =
     { kErrorApiPIInvalidJobSize,      "Process image: invalid job size"},
     { kErrorApiPIInvalidPIPointer,    "Process image: pointer to application's process image is invalid"},
     { kErrorApiPINonBlockingNotSupp,  "Process image: non-blocking copy jobs are not supported on this target"},
+    { kErrorApiNotSupported,          "The called function is not supported by the stack configuration"},
+    { kErrorApiSdoQueueFull,          "SDO batch: request queue is full"},
 };
 
-static const tEmergErrCodeInfo emergErrCodeInfo_l[] =
+// text strings for emergency error codes (sorted by value)
+static const tValueStrInfo emergErrCodeInfo_l[] =
 {
     { E_NO_ERROR,                    "E_NO_ERROR"               },
 
-    // 0xFxxx manufacturer specific error codes
-    { E_NMT_NO_IDENT_RES,            "E_NMT_NO_IDENT_RES"       },
-    { E_NMT_NO_STATUS_RES,           "E_NMT_NO_STATUS_RES"      },
-
     // 0x816x HW errors
     { E_DLL_BAD_PHYS_MODE,           "E_DLL_BAD_PHYS_MODE"      },
     { E_DLL_COLLISION,               "E_DLL_COLLISION"          },
@@ -522,6 +527,10 @@ static const tEmergErrCodeInfo emergErrCodeInfo_l[] =
     { E_NMT_BPO2,                    "E_NMT_BPO2"               },
     { E_NMT_BRO,                     "E_NMT_BRO"                },
     { E_NMT_WRONG_STATE,             "E_NMT_WRONG_STATE"        },
+
+    // 0xFxxx manufacturer specific error codes
+    { E_NMT_NO_IDENT_RES,            "E_NMT_NO_IDENT_RES"       },
+    { E_NMT_NO_STATUS_RES,           "E_NMT_NO_STATUS_RES"      },
 };
 
 // text strings for NMT node events
@@ -559,9 +568,10 @@ static char* OplkSdoComConStateStr_g[] =
     "LowerLayerAbort",          // 0x05
 };
 
-// text strings for abort codes
-static tAbortCodeInfo abortCodeInfo_g[] =
+// text strings for abort codes (sorted by value)
+static const tValueStrInfo abortCodeInfo_l[] =
 {
+    { 0,                                        "SDO_AC_OK" },
     { SDO_AC_TIME_OUT,                          "SDO_AC_TIME_OUT" },
     { SDO_AC_UNKNOWN_COMMAND_SPECIFIER,         "SDO_AC_UNKNOWN_COMMAND_SPECIFIER" },
     { SDO_AC_INVALID_BLOCK_SIZE,                "SDO_AC_INVALID_BLOCK_SIZE" },
@@ -591,7 +601,6 @@ static tAbortCodeInfo abortCodeInfo_g[] =
     { SDO_AC_DATA_NOT_TRANSF_DUE_DEVICE_STATE,  "SDO_AC_DATA_NOT_TRANSF_DUE_DEVICE_STATE" },
     { SDO_AC_OBJECT_DICTIONARY_NOT_EXIST,       "SDO_AC_OBJECT_DICTIONARY_NOT_EXIST" },
     { SDO_AC_CONFIG_DATA_EMPTY,                 "SDO_AC_CONFIG_DATA_EMPTY" },
-    { 0,                                        "SDO_AC_OK" }
 };
 
 //============================================================================//
@@ -840,14 +849,7 @@ The function returns the string describing the given entry of type tOplkError.
 //------------------------------------------------------------------------------
 char* debugstr_getRetValStr(tOplkError OplkError_p)
 {
-    UINT        i;
-
-    for (i = 0; i < tabentries(retValInfo_l); i++)
-    {
-        if (retValInfo_l[i].key == OplkError_p)
-            return (retValInfo_l[i].sName);
-    }
-    return invalidStr_l;
+    return findValueStr(retValInfo_l, tabentries(retValInfo_l), (UINT32)OplkError_p);
 }
 
 //------------------------------------------------------------------------------
@@ -866,15 +868,7 @@ code.
 //------------------------------------------------------------------------------
 char* debugstr_getEmergErrCodeStr(UINT16 emergErrCode_p)
 {
-
-    UINT        i;
-
-    for (i = 0; i < tabentries(emergErrCodeInfo_l); i++)
-    {
-        if (emergErrCodeInfo_l[i].key == emergErrCode_p)
-            return (emergErrCodeInfo_l[i].sName);
-    }
-    return invalidStr_l;
+    return findValueStr(emergErrCodeInfo_l, tabentries(emergErrCodeInfo_l), emergErrCode_p);
 }
 
 //------------------------------------------------------------------------------
@@ -892,17 +886,49 @@ The function returns the string describing the specified abort code.
 //------------------------------------------------------------------------------
 char* debugstr_getAbortCodeStr(UINT32 abortCode_p)
 {
-    tAbortCodeInfo*         pEntry;
-    UINT                    i;
+    return findValueStr(abortCodeInfo_l, tabentries(abortCodeInfo_l), abortCode_p);
+}
 
-    pEntry = abortCodeInfo_g;
-    for (i = 0; i < tabentries(abortCodeInfo_g); i++)
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find the string of a value
+
+The function searches the string of a value in a value string table. The table
+must be sorted by ascending value.
+
+\param  pTable_p            Value string table.
+\param  count_p             Number of table entries.
+\param  value_p             Value to search.
+
+\return The function returns the string of the value or "INVALID" if the value
+        is not contained in the table.
+*/
+//------------------------------------------------------------------------------
+static char* findValueStr(const tValueStrInfo* pTable_p, UINT count_p, UINT32 value_p)
+{
+    UINT        low = 0;
+    UINT        high = count_p;
+    UINT        mid;
+
+    while (low < high)
     {
-        if (pEntry->abortCode == abortCode_p)
-        {
-            return pEntry->sAbortCode;
-        }
-        pEntry++;
+        mid = low + ((high - low) / 2);
+        if (pTable_p[mid].value == value_p)
+            return pTable_p[mid].sName;
+
+        if (pTable_p[mid].value < value_p)
+            low = mid + 1;
+        else
+            high = mid;
     }
+
     return invalidStr_l;
 }
+
+/// \}
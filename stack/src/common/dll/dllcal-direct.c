@@ -110,7 +110,9 @@ static tDllCalFuncIntf funcintf_l =
     insertDataBlock,
     getDataBlock,
     getDataBlockCount,
-    resetDataBlockQueue
+    resetDataBlockQueue,
+    NULL,
+    NULL
 };
 
 //============================================================================//
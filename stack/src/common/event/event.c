@@ -44,6 +44,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/event.h>
 #include "event.h"
 
+#if (CONFIG_EVENT_LATENCY != FALSE)
+#include <common/metrics.h>
+#include <common/target.h>
+#endif
+
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
 //============================================================================//
@@ -71,7 +76,27 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
+#if (CONFIG_EVENT_LATENCY != FALSE)
+/**
+\brief Latency metrics of an event queue
+*/
+typedef struct
+{
+    tMetric*            pDelay;             ///< Histogram of the queueing delay in [us]
+    tMetric*            pProcTime;          ///< Histogram of the processing time in [us]
+    tMetric*            pMaxDepth;          ///< Gauge of the maximum number of queued events
+    UINT32              maxDepth;           ///< Maximum number of queued events
+} tEventQueueLatency;
 
+/**
+\brief Latency metrics of an event sink
+*/
+typedef struct
+{
+    tMetric*            pDelay;             ///< Histogram of the queueing delay in [us]
+    tMetric*            pProcTime;          ///< Histogram of the processing time in [us]
+} tEventSinkLatency;
+#endif
 
 //------------------------------------------------------------------------------
 // local function prototypes
@@ -80,20 +105,84 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
+#if (CONFIG_EVENT_LATENCY != FALSE)
+static const char* const    aaQueueMetricName_l[kEventQueueNum][3] =
+{
+    { "event.k2u.delay_us",  "event.k2u.proc_us",  "event.k2u.depth_max" },
+    { "event.kint.delay_us", "event.kint.proc_us", "event.kint.depth_max" },
+    { "event.u2k.delay_us",  "event.u2k.proc_us",  "event.u2k.depth_max" },
+    { "event.uint.delay_us", "event.uint.proc_us", "event.uint.depth_max" }
+};
+
+static const char* const    aaSinkMetricName_l[EVENT_SINK_COUNT][2] =
+{
+    { "event.sink_sync.delay_us",       "event.sink_sync.proc_us" },
+    { "event.sink_nmtk.delay_us",       "event.sink_nmtk.proc_us" },
+    { "event.sink_dllk.delay_us",       "event.sink_dllk.proc_us" },
+    { "event.sink_dllucal.delay_us",    "event.sink_dllucal.proc_us" },
+    { "event.sink_dllkcal.delay_us",    "event.sink_dllkcal.proc_us" },
+    { "event.sink_pdok.delay_us",       "event.sink_pdok.proc_us" },
+    { "event.sink_nmtu.delay_us",       "event.sink_nmtu.proc_us" },
+    { "event.sink_errk.delay_us",       "event.sink_errk.proc_us" },
+    { "event.sink_erru.delay_us",       "event.sink_erru.proc_us" },
+    { "event.sink_sdoasyseq.delay_us",  "event.sink_sdoasyseq.proc_us" },
+    { "event.sink_nmtmnu.delay_us",     "event.sink_nmtmnu.proc_us" },
+    { "event.sink_ledu.delay_us",       "event.sink_ledu.proc_us" },
+    { "event.sink_pdokcal.delay_us",    "event.sink_pdokcal.proc_us" },
+    { NULL,                             NULL },
+    { "event.sink_gw309ascii.delay_us", "event.sink_gw309ascii.proc_us" },
+    { "event.sink_api.delay_us",        "event.sink_api.proc_us" }
+};
+
+static tEventQueueLatency   aQueueLatency_l[kEventQueueNum];
+static tEventSinkLatency    aSinkLatency_l[EVENT_SINK_COUNT];
+#endif
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
 //============================================================================//
 
+//------------------------------------------------------------------------------
+/**
+\brief  Build the dispatch index of an event dispatch table
+
+The function fills a dispatch index with EVENT_SINK_COUNT entries. Entry n
+points to the dispatch table entry of sink n, or is NULL if the table contains
+no entry for the sink. The index allows event_getHandlerForSink() to find the
+handler of a sink without searching the table.
+
+\param  pDispatchTbl_p      Pointer to dispatch table, terminated with an entry
+                            for kEventSinkInvalid.
+\param  apDispatchIndex_p   Pointer to dispatch index to be filled.
+
+\ingroup module_event
+*/
+//------------------------------------------------------------------------------
+void event_initDispatchIndex(tEventDispatchEntry* pDispatchTbl_p,
+                             tEventDispatchEntry** apDispatchIndex_p)
+{
+    UINT    sink;
+
+    for (sink = 0; sink < EVENT_SINK_COUNT; sink++)
+        apDispatchIndex_p[sink] = NULL;
+
+    while (pDispatchTbl_p->sink != kEventSinkInvalid)
+    {
+        if ((UINT)pDispatchTbl_p->sink < EVENT_SINK_COUNT)
+            apDispatchIndex_p[pDispatchTbl_p->sink] = pDispatchTbl_p;
+        pDispatchTbl_p++;
+    }
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Finds the appropriate event handler for a specific sink
 
-The function searches the event dispatch table for the appropriate event
-handler for the specified sink. It returns the pointer to the event handler
-and the corresponding event source.
+The function looks up the event handler for the specified sink in a dispatch
+index built by event_initDispatchIndex(). It returns the pointer to the event
+handler and the corresponding event source.
 
-\param  ppDispatchEntry_p   Pointer to dispatch entry pointer.
+\param  apDispatchIndex_p   Pointer to dispatch index.
 \param  sink_p              Event sink to search for.
 \param  ppfnEventHandler_p  Pointer to store event handler function pointer.
 \param  pEventSource_p      Pointer to store the corresponding event source.
@@ -105,28 +194,273 @@ and the corresponding event source.
 \ingroup module_event
 */
 //------------------------------------------------------------------------------
-tOplkError event_getHandlerForSink(tEventDispatchEntry** ppDispatchEntry_p,
+tOplkError event_getHandlerForSink(tEventDispatchEntry* const* apDispatchIndex_p,
                                    tEventSink sink_p,
                                    tProcessEventCb* ppfnEventHandler_p,
                                    tEventSource* pEventSource_p)
 {
-    tOplkError              ret = kErrorEventUnknownSink;
+    tEventDispatchEntry*    pDispatchEntry;
+
+    if ((UINT)sink_p >= EVENT_SINK_COUNT)
+        return kErrorEventUnknownSink;
+
+    pDispatchEntry = apDispatchIndex_p[sink_p];
+    if (pDispatchEntry == NULL)
+        return kErrorEventUnknownSink;
+
+    *pEventSource_p = pDispatchEntry->source;
+    *ppfnEventHandler_p = pDispatchEntry->pfnEventHandler;
+
+    return kErrorOk;
+}
+
+#if (CONFIG_EVENT_PAYLOAD_POOL_SLOTS != 0)
+//------------------------------------------------------------------------------
+/**
+\brief  Store event argument in payload pool
+
+The function stores the argument of an event in a free slot of a payload pool
+if it is larger than CONFIG_EVENT_PAYLOAD_THRESHOLD. The queue entry of the
+event then only contains the returned slot pointer instead of the argument.
+The slot must be freed with event_freePayload() after the event is processed.
+
+\param  pPool_p             Pointer to payload pool.
+\param  pEvent_p            Pointer to event.
+
+\return The function returns the pointer to the slot or NULL if the argument
+        shall be queued inline.
+
+\ingroup module_event
+*/
+//------------------------------------------------------------------------------
+void* event_allocPayload(tEventPayloadPool* pPool_p, const tEvent* pEvent_p)
+{
+    UINT            slot;
+    OPLK_ATOMIC_T   fUsed;
+
+    if ((pEvent_p->eventArgSize <= CONFIG_EVENT_PAYLOAD_THRESHOLD) ||
+        (pEvent_p->eventArgSize > MAX_EVENT_ARG_SIZE))
+        return NULL;
 
-    while ((*ppDispatchEntry_p)->sink != kEventSinkInvalid)
+    for (slot = 0; slot < CONFIG_EVENT_PAYLOAD_POOL_SLOTS; slot++)
     {
-        if (sink_p == (*ppDispatchEntry_p)->sink)
+        OPLK_ATOMIC_EXCHANGE(&pPool_p->aSlotUsed[slot], TRUE, fUsed);
+        if (!fUsed)
         {
-            *pEventSource_p = (*ppDispatchEntry_p)->source;
-            *ppfnEventHandler_p = (*ppDispatchEntry_p)->pfnEventHandler;
-            (*ppDispatchEntry_p)++;
-            ret = kErrorOk;
-            break;
+            OPLK_MEMCPY(pPool_p->aSlot[slot], pEvent_p->pEventArg, pEvent_p->eventArgSize);
+            return pPool_p->aSlot[slot];
         }
-        (*ppDispatchEntry_p)++;
     }
 
-    return ret;
+    // pool is exhausted
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Free payload pool slot
+
+\param  pPool_p             Pointer to payload pool.
+\param  pPayload_p          Slot pointer returned by event_allocPayload().
+
+\ingroup module_event
+*/
+//------------------------------------------------------------------------------
+void event_freePayload(tEventPayloadPool* pPool_p, void* pPayload_p)
+{
+    UINT            slot;
+    OPLK_ATOMIC_T   fUsed;
+
+    slot = (UINT)(((UINT8*)pPayload_p - pPool_p->aSlot[0]) / MAX_EVENT_ARG_SIZE);
+    if (slot < CONFIG_EVENT_PAYLOAD_POOL_SLOTS)
+    {
+        OPLK_ATOMIC_EXCHANGE(&pPool_p->aSlotUsed[slot], FALSE, fUsed);
+        UNUSED_PARAMETER(fUsed);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get payload reference of queued event
+
+The function checks whether a queued event references its argument in a
+payload pool. Its argument then only consists of the slot pointer while the
+event header still contains the size of the original argument.
+
+\param  pEvent_p            Pointer to queued event header.
+\param  argSize_p           Size of the argument in the queue.
+
+\return The function returns the pointer to the slot or NULL if the argument
+        is stored inline.
+
+\ingroup module_event
+*/
+//------------------------------------------------------------------------------
+void* event_getPayloadRef(const tEvent* pEvent_p, size_t argSize_p)
+{
+    void*   pPayload;
+
+    if ((argSize_p != sizeof(void*)) || (pEvent_p->eventArgSize <= CONFIG_EVENT_PAYLOAD_THRESHOLD))
+        return NULL;
+
+    OPLK_MEMCPY(&pPayload, (const UINT8*)pEvent_p + sizeof(tEvent), sizeof(void*));
+    return pPayload;
+}
+#endif
+
+#if (CONFIG_EVENT_LATENCY != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Register latency metrics of an event queue
+
+The function registers the latency metrics of the specified queue and of all
+event sinks in the metrics registry. It is called by the CAL modules of both
+layers for each of their queues. Metrics which are already registered keep
+their values.
+
+\param  eventQueue_p        Event queue.
+
+\ingroup module_event
+*/
+//------------------------------------------------------------------------------
+void event_initLatency(tEventQueue eventQueue_p)
+{
+    tEventQueueLatency* pQueue;
+    UINT                sink;
+
+    if ((UINT)eventQueue_p >= kEventQueueNum)
+        return;
+
+    pQueue = &aQueueLatency_l[eventQueue_p];
+    METRICS_REGISTER(aaQueueMetricName_l[eventQueue_p][0], kMetricTypeHistogram, &pQueue->pDelay);
+    METRICS_REGISTER(aaQueueMetricName_l[eventQueue_p][1], kMetricTypeHistogram, &pQueue->pProcTime);
+    METRICS_REGISTER(aaQueueMetricName_l[eventQueue_p][2], kMetricTypeGauge, &pQueue->pMaxDepth);
+    pQueue->maxDepth = 0;
+
+    for (sink = 0; sink < EVENT_SINK_COUNT; sink++)
+    {
+        if (aaSinkMetricName_l[sink][0] == NULL)
+            continue;
+
+        METRICS_REGISTER(aaSinkMetricName_l[sink][0], kMetricTypeHistogram,
+                         &aSinkLatency_l[sink].pDelay);
+        METRICS_REGISTER(aaSinkMetricName_l[sink][1], kMetricTypeHistogram,
+                         &aSinkLatency_l[sink].pProcTime);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Stamp a queued event with the post time
+
+The function stores the current cycle counter at pStamp_p, which points
+behind the argument of the queued event and may be unaligned.
+
+\param  pStamp_p            Pointer to the stamp in the queue entry.
+
+\ingroup module_event
+*/
+//------------------------------------------------------------------------------
+void event_stampLatency(void* pStamp_p)
+{
+    UINT64  postTime;
+
+    postTime = target_getCycleCounter();
+    OPLK_MEMCPY(pStamp_p, &postTime, sizeof(postTime));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Observe the queueing delay of an event
+
+The function adds the time between posting and dispatching of an event to the
+delay histogram of its queue and of its sink.
+
+\param  eventQueue_p        Event queue the event was read from.
+\param  pEvent_p            Pointer to the event.
+\param  pStamp_p            Pointer to the stamp in the queue entry.
+
+\return The function returns the current cycle counter, which is the start
+        time of processing the event.
+
+\ingroup module_event
+*/
+//------------------------------------------------------------------------------
+UINT64 event_observeLatency(tEventQueue eventQueue_p, const tEvent* pEvent_p,
+                            const void* pStamp_p)
+{
+    UINT64  postTime;
+    UINT64  now;
+    UINT32  delay;
+
+    now = target_getCycleCounter();
+    OPLK_MEMCPY(&postTime, pStamp_p, sizeof(postTime));
+    delay = (UINT32)(target_convertCyclesToNs(now - postTime) / 1000);
+
+    if ((UINT)eventQueue_p < kEventQueueNum)
+        METRICS_OBSERVE(aQueueLatency_l[eventQueue_p].pDelay, delay);
+
+    if ((UINT)pEvent_p->eventSink < EVENT_SINK_COUNT)
+        METRICS_OBSERVE(aSinkLatency_l[pEvent_p->eventSink].pDelay, delay);
+
+    return now;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Observe the processing time of an event
+
+The function adds the processing time of an event to the processing time
+histogram of its queue and of its sink.
+
+\param  eventQueue_p        Event queue the event was read from.
+\param  pEvent_p            Pointer to the event.
+\param  startTime_p         Start time returned by event_observeLatency().
+
+\ingroup module_event
+*/
+//------------------------------------------------------------------------------
+void event_observeProcessing(tEventQueue eventQueue_p, const tEvent* pEvent_p,
+                             UINT64 startTime_p)
+{
+    UINT32  procTime;
+
+    procTime = (UINT32)(target_convertCyclesToNs(target_getCycleCounter() - startTime_p) / 1000);
+
+    if ((UINT)eventQueue_p < kEventQueueNum)
+        METRICS_OBSERVE(aQueueLatency_l[eventQueue_p].pProcTime, procTime);
+
+    if ((UINT)pEvent_p->eventSink < EVENT_SINK_COUNT)
+        METRICS_OBSERVE(aSinkLatency_l[pEvent_p->eventSink].pProcTime, procTime);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Observe the depth of an event queue
+
+The function updates the high-water mark of the number of queued events.
+
+\param  eventQueue_p        Event queue.
+\param  depth_p             Number of events in the queue after posting.
+
+\ingroup module_event
+*/
+//------------------------------------------------------------------------------
+void event_observeDepth(tEventQueue eventQueue_p, UINT32 depth_p)
+{
+    tEventQueueLatency* pQueue;
+
+    if ((UINT)eventQueue_p >= kEventQueueNum)
+        return;
+
+    pQueue = &aQueueLatency_l[eventQueue_p];
+    if (depth_p > pQueue->maxDepth)
+    {
+        pQueue->maxDepth = depth_p;
+        METRICS_SET(pQueue->pMaxDepth, depth_p);
+    }
 }
+#endif
 
 
 //============================================================================//
@@ -48,6 +48,54 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#define EVENT_SINK_COUNT        (kEventSinkApi + 1)     ///< Size of an event dispatch index
+
+#if (CONFIG_EVENT_PAYLOAD_POOL_SLOTS != 0)
+#if !defined(OPLK_ATOMIC_EXCHANGE)
+#error "CONFIG_EVENT_PAYLOAD_POOL_SLOTS requires OPLK_ATOMIC_EXCHANGE on this target."
+#endif
+
+#if (CONFIG_EVENT_PAYLOAD_THRESHOLD < 8)
+#error "CONFIG_EVENT_PAYLOAD_THRESHOLD must be larger than the size of a payload reference."
+#endif
+#endif
+
+#if (CONFIG_EVENT_LATENCY != FALSE)
+#if (CONFIG_METRICS == FALSE)
+#error "CONFIG_EVENT_LATENCY requires CONFIG_METRICS."
+#endif
+#define EVENT_LATENCY_STAMP_SIZE    sizeof(UINT64)          ///< Size of the post timestamp appended to a queued event
+#else
+#define EVENT_LATENCY_STAMP_SIZE    0
+#endif
+
+/**
+Events for these sinks are not relevant for the POWERLINK cycle. Queues with a
+low priority lane carry them separately, so they never delay DLL, NMT and PDO
+events.
+*/
+#define EVENT_SINK_IS_LOW_PRIORITY(sink_p)  (((sink_p) == kEventSinkApi) ||       \
+                                             ((sink_p) == kEventSinkErru) ||      \
+                                             ((sink_p) == kEventSinkLedu) ||      \
+                                             ((sink_p) == kEventSinkSdoAsySeq) || \
+                                             ((sink_p) == kEventSinkSdoCom))
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+#if (CONFIG_EVENT_PAYLOAD_POOL_SLOTS != 0)
+/**
+\brief Event payload pool
+
+The pool stores large arguments of events which are queued within one address
+space. The queue entry of such an event only contains a reference to its slot.
+*/
+typedef struct
+{
+    UINT8               aSlot[CONFIG_EVENT_PAYLOAD_POOL_SLOTS][MAX_EVENT_ARG_SIZE];     ///< Payload slots
+    OPLK_ATOMIC_T       aSlotUsed[CONFIG_EVENT_PAYLOAD_POOL_SLOTS];                     ///< Slot is in use
+} tEventPayloadPool;
+#endif
 
 //------------------------------------------------------------------------------
 // function prototypes
@@ -57,10 +105,27 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 extern "C" {
 #endif
 
-tOplkError event_getHandlerForSink(tEventDispatchEntry** ppDispatchEntry_p,
+void       event_initDispatchIndex(tEventDispatchEntry* pDispatchTbl_p,
+                                   tEventDispatchEntry** apDispatchIndex_p);
+tOplkError event_getHandlerForSink(tEventDispatchEntry* const* apDispatchIndex_p,
                                    tEventSink sink_p,
                                    tProcessEventCb* ppfnEventHandler_p,
                                    tEventSource* pEventSource_p) SECTION_EVENT_GET_HDL_FOR_SINK;
+#if (CONFIG_EVENT_PAYLOAD_POOL_SLOTS != 0)
+void*      event_allocPayload(tEventPayloadPool* pPool_p, const tEvent* pEvent_p);
+void       event_freePayload(tEventPayloadPool* pPool_p, void* pPayload_p);
+void*      event_getPayloadRef(const tEvent* pEvent_p, size_t argSize_p);
+#endif
+
+#if (CONFIG_EVENT_LATENCY != FALSE)
+void       event_initLatency(tEventQueue eventQueue_p);
+void       event_stampLatency(void* pStamp_p);
+UINT64     event_observeLatency(tEventQueue eventQueue_p, const tEvent* pEvent_p,
+                                const void* pStamp_p);
+void       event_observeProcessing(tEventQueue eventQueue_p, const tEvent* pEvent_p,
+                                   UINT64 startTime_p);
+void       event_observeDepth(tEventQueue eventQueue_p, UINT32 depth_p);
+#endif
 
 #ifdef __cplusplus
 }
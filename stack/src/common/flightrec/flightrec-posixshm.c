@@ -0,0 +1,184 @@
+/**
+********************************************************************************
+\file   flightrec-posixshm.c
+
+\brief  Posix shared memory implementation of the flight recorder module
+
+This file provides the memory of the flight recorder in posix shared memory.
+It is used if the user and the kernel layer of the stack run in different
+processes.
+
+\ingroup module_flightrec
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <common/flightrec.h>
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <fcntl.h>           /* For O_* constants */
+#include <sys/stat.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define FLIGHTREC_SHM_NAME "/shmFlightRec"
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static int                  fd_l;
+static tFlightRecMemory*    pFlightRecMem_l;
+static BOOL                 fCreator_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize flight recorder memory
+
+The function maps the shared memory of the flight recorder. The shared memory
+is created and cleared by the first process which maps it.
+
+\param  ppMemory_p      Pointer to store the pointer to the memory.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_flightrec
+*/
+//------------------------------------------------------------------------------
+tOplkError flightrec_initMemory(tFlightRecMemory** ppMemory_p)
+{
+    struct stat             stat;
+
+    if (pFlightRecMem_l != NULL)
+        return kErrorNoFreeInstance;
+
+    fCreator_l = FALSE;
+    if ((fd_l = shm_open(FLIGHTREC_SHM_NAME, O_RDWR | O_CREAT, 0)) < 0)
+    {
+        TRACE("%s() shm_open failed!\n", __func__);
+        return kErrorNoResource;
+    }
+
+    if (fstat(fd_l, &stat) != 0)
+    {
+        close(fd_l);
+        return kErrorNoResource;
+    }
+
+    if (stat.st_size == 0)
+    {
+        if (ftruncate(fd_l, sizeof(tFlightRecMemory)) == -1)
+        {
+            TRACE("%s() ftruncate failed!\n", __func__);
+            close(fd_l);
+            shm_unlink(FLIGHTREC_SHM_NAME);
+            return kErrorNoResource;
+        }
+        fCreator_l = TRUE;
+    }
+
+    pFlightRecMem_l = mmap(NULL, sizeof(tFlightRecMemory), PROT_READ | PROT_WRITE, MAP_SHARED, fd_l, 0);
+    if (pFlightRecMem_l == MAP_FAILED)
+    {
+        TRACE("%s() mmap failed!\n", __func__);
+        pFlightRecMem_l = NULL;
+        close(fd_l);
+        if (fCreator_l)
+            shm_unlink(FLIGHTREC_SHM_NAME);
+        return kErrorNoResource;
+    }
+
+    if (fCreator_l)
+    {
+        OPLK_MEMSET(pFlightRecMem_l, 0, sizeof(tFlightRecMemory));
+    }
+
+    *ppMemory_p = pFlightRecMem_l;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Free flight recorder memory
+
+The function unmaps the shared memory of the flight recorder. The shared
+memory is removed by the process which created it.
+
+\ingroup module_flightrec
+*/
+//------------------------------------------------------------------------------
+void flightrec_exitMemory(void)
+{
+    if (pFlightRecMem_l != NULL)
+    {
+        munmap(pFlightRecMem_l, sizeof(tFlightRecMemory));
+        close(fd_l);
+        if (fCreator_l)
+            shm_unlink(FLIGHTREC_SHM_NAME);
+        fd_l = 0;
+        pFlightRecMem_l = NULL;
+    }
+}
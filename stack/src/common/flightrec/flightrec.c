@@ -0,0 +1,333 @@
+/**
+********************************************************************************
+\file   flightrec.c
+
+\brief  Implementation of the cycle flight recorder module
+
+The cycle flight recorder keeps the frames handled by the DLL in the last
+CONFIG_FLIGHT_RECORDER_CYCLES cycles. The cycles are stored in a ring of fixed
+size entries, so recording a cycle takes a constant amount of time and memory
+and the recorder can be enabled in production systems. When the error handler
+reports a DLL error which matches CONFIG_FLIGHT_RECORDER_TRIGGER the ring is
+frozen until the application rearms the recorder. The ring is located in the
+memory provided by the flight recorder memory implementation, which can be
+shared between the user and the kernel layer.
+
+\ingroup module_flightrec
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <common/flightrec.h>
+#include <common/target.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tFlightRecMemory*    pFlightRecMem_l = NULL;
+static UINT                 initCount_l = 0;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize flight recorder module
+
+The function initializes the flight recorder module. If the user and the
+kernel layer run in the same process, the function is called by both layers.
+The module is initialized by the first call only.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_flightrec
+*/
+//------------------------------------------------------------------------------
+tOplkError flightrec_init(void)
+{
+    tOplkError      ret;
+
+    if (initCount_l == 0)
+    {
+        ret = flightrec_initMemory(&pFlightRecMem_l);
+        if (ret != kErrorOk)
+        {
+            pFlightRecMem_l = NULL;
+            return ret;
+        }
+    }
+
+    initCount_l++;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Shut down flight recorder module
+
+The function shuts down the flight recorder module. The module is shut down
+by the call matching the first call of flightrec_init().
+
+\ingroup module_flightrec
+*/
+//------------------------------------------------------------------------------
+void flightrec_exit(void)
+{
+    if (initCount_l == 0)
+        return;
+
+    initCount_l--;
+    if (initCount_l == 0)
+    {
+        pFlightRecMem_l = NULL;
+        flightrec_exitMemory();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Mark the start of a cycle
+
+The function starts recording a new cycle in the oldest entry of the ring. It
+must only be called by the DLL.
+
+\ingroup module_flightrec
+*/
+//------------------------------------------------------------------------------
+void flightrec_startCycle(void)
+{
+    tFlightRecCycle*    pCycle;
+    UINT32              index;
+
+    if ((pFlightRecMem_l == NULL) || pFlightRecMem_l->fFrozen)
+        return;
+
+    if (pFlightRecMem_l->cycleCount == 0)
+        index = 0;
+    else
+        index = (pFlightRecMem_l->curCycleIndex + 1) % CONFIG_FLIGHT_RECORDER_CYCLES;
+
+    pCycle = &pFlightRecMem_l->aCycle[index];
+    pCycle->cycleNumber = pFlightRecMem_l->cycleCount;
+    pCycle->startTime = target_getCurrentTimestamp();
+    pCycle->frameCount = 0;
+    pCycle->droppedCount = 0;
+
+    pFlightRecMem_l->curCycleIndex = index;
+    pFlightRecMem_l->cycleCount++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Record a frame
+
+The function records the header of a frame in the current cycle. It must only
+be called by the DLL. Frames which are handled before the first cycle is
+started are not recorded.
+
+\param  pFrame_p        Pointer to the frame.
+\param  frameSize_p     Size of the frame in bytes.
+\param  fTx_p           TRUE if the frame was transmitted, FALSE if it was
+                        received.
+
+\ingroup module_flightrec
+*/
+//------------------------------------------------------------------------------
+void flightrec_recordFrame(const void* pFrame_p, UINT frameSize_p, BOOL fTx_p)
+{
+    tFlightRecCycle*    pCycle;
+    tFlightRecFrame*    pFrame;
+    ULONGLONG           timeStamp;
+
+    if ((pFlightRecMem_l == NULL) || pFlightRecMem_l->fFrozen ||
+        (pFlightRecMem_l->cycleCount == 0))
+        return;
+
+    pCycle = &pFlightRecMem_l->aCycle[pFlightRecMem_l->curCycleIndex];
+    if (pCycle->frameCount >= CONFIG_FLIGHT_RECORDER_FRAMES)
+    {
+        pCycle->droppedCount++;
+        return;
+    }
+
+    timeStamp = target_getCurrentTimestamp();
+
+    pFrame = &pCycle->aFrame[pCycle->frameCount];
+    pFrame->timeOffset = (timeStamp > pCycle->startTime) ? (UINT32)(timeStamp - pCycle->startTime) : 0;
+    pFrame->frameSize = (UINT16)frameSize_p;
+    pFrame->fTx = (UINT8)fTx_p;
+    pFrame->reserved = 0;
+    OPLK_MEMCPY(pFrame->aHeader, pFrame_p, min(frameSize_p, FLIGHTREC_FRAME_HEADER_SIZE));
+
+    pCycle->frameCount++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Freeze the flight recorder
+
+The function freezes the flight recorder because of a DLL error. The cycles
+recorded so far are kept until the recorder is rearmed. Further errors do not
+change the trigger information.
+
+\param  errors_p        DLL error events which caused the trigger.
+\param  nodeId_p        Node ID of the error.
+
+\ingroup module_flightrec
+*/
+//------------------------------------------------------------------------------
+void flightrec_trigger(UINT32 errors_p, UINT nodeId_p)
+{
+    if ((pFlightRecMem_l == NULL) || pFlightRecMem_l->fFrozen)
+        return;
+
+    pFlightRecMem_l->triggerErrors = errors_p;
+    pFlightRecMem_l->triggerNodeId = nodeId_p;
+    pFlightRecMem_l->triggerTime = target_getCurrentTimestamp();
+    OPLK_MEMBAR();
+    pFlightRecMem_l->fFrozen = TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get flight record
+
+The function copies the recorded cycles, starting with the oldest one. The
+record is only consistent if the recorder is frozen, otherwise the current
+cycle may be modified during the copy.
+
+\param  pRecord_p       Pointer to store the flight record.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_flightrec
+*/
+//------------------------------------------------------------------------------
+tOplkError flightrec_getRecord(tFlightRecord* pRecord_p)
+{
+    UINT32          cycleCount;
+    UINT32          firstIndex;
+    UINT32          index;
+
+    if (pFlightRecMem_l == NULL)
+        return kErrorNoResource;
+
+    pRecord_p->fFrozen = (pFlightRecMem_l->fFrozen != FALSE);
+    OPLK_MEMBAR();
+    pRecord_p->triggerErrors = pFlightRecMem_l->triggerErrors;
+    pRecord_p->triggerNodeId = pFlightRecMem_l->triggerNodeId;
+    pRecord_p->triggerTime = pFlightRecMem_l->triggerTime;
+
+    cycleCount = pFlightRecMem_l->cycleCount;
+    if (cycleCount > CONFIG_FLIGHT_RECORDER_CYCLES)
+    {
+        firstIndex = (pFlightRecMem_l->curCycleIndex + 1) % CONFIG_FLIGHT_RECORDER_CYCLES;
+        cycleCount = CONFIG_FLIGHT_RECORDER_CYCLES;
+    }
+    else
+    {
+        firstIndex = 0;
+    }
+
+    for (index = 0; index < cycleCount; index++)
+    {
+        OPLK_MEMCPY(&pRecord_p->aCycle[index],
+                    &pFlightRecMem_l->aCycle[(firstIndex + index) % CONFIG_FLIGHT_RECORDER_CYCLES],
+                    sizeof(tFlightRecCycle));
+    }
+    pRecord_p->cycleCount = cycleCount;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Rearm the flight recorder
+
+The function discards the recorded cycles and restarts recording with the next
+cycle.
+
+\ingroup module_flightrec
+*/
+//------------------------------------------------------------------------------
+void flightrec_rearm(void)
+{
+    if (pFlightRecMem_l == NULL)
+        return;
+
+    pFlightRecMem_l->cycleCount = 0;
+    pFlightRecMem_l->triggerErrors = 0;
+    pFlightRecMem_l->triggerNodeId = 0;
+    pFlightRecMem_l->triggerTime = 0;
+    OPLK_MEMBAR();
+    pFlightRecMem_l->fFrozen = FALSE;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+/// \}
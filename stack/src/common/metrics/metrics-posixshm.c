@@ -0,0 +1,186 @@
+/**
+********************************************************************************
+\file   metrics-posixshm.c
+
+\brief  Posix shared memory implementation of the metrics registry module
+
+This file provides the memory of the metrics registry in posix shared memory.
+It is used on Linux userspace builds, so the metrics can be read by external
+collectors and the user and the kernel layer may run in different processes.
+
+\ingroup module_metrics
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <common/metrics.h>
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <fcntl.h>           /* For O_* constants */
+#include <sys/stat.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define METRICS_SHM_NAME "/shmMetrics"
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static int                  fd_l;
+static tMetricsMemory*      pMetricsMem_l;
+static BOOL                 fCreator_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize metrics memory
+
+The function maps the shared memory of the metrics registry. The shared memory
+is created and cleared by the first process which maps it. It is readable by
+all users, so collectors can map it without the privileges of the stack. A
+memory left by a previous stack build with another size is recreated.
+
+\param  ppMemory_p      Pointer to store the pointer to the memory.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_metrics
+*/
+//------------------------------------------------------------------------------
+tOplkError metrics_initMemory(tMetricsMemory** ppMemory_p)
+{
+    struct stat             stat;
+
+    if (pMetricsMem_l != NULL)
+        return kErrorNoFreeInstance;
+
+    fCreator_l = FALSE;
+    if ((fd_l = shm_open(METRICS_SHM_NAME, O_RDWR | O_CREAT, 0644)) < 0)
+    {
+        TRACE("%s() shm_open failed!\n", __func__);
+        return kErrorNoResource;
+    }
+
+    if (fstat(fd_l, &stat) != 0)
+    {
+        close(fd_l);
+        return kErrorNoResource;
+    }
+
+    if (stat.st_size != sizeof(tMetricsMemory))
+    {
+        if (ftruncate(fd_l, sizeof(tMetricsMemory)) == -1)
+        {
+            TRACE("%s() ftruncate failed!\n", __func__);
+            close(fd_l);
+            shm_unlink(METRICS_SHM_NAME);
+            return kErrorNoResource;
+        }
+        fCreator_l = TRUE;
+    }
+
+    pMetricsMem_l = mmap(NULL, sizeof(tMetricsMemory), PROT_READ | PROT_WRITE, MAP_SHARED, fd_l, 0);
+    if (pMetricsMem_l == MAP_FAILED)
+    {
+        TRACE("%s() mmap failed!\n", __func__);
+        pMetricsMem_l = NULL;
+        close(fd_l);
+        if (fCreator_l)
+            shm_unlink(METRICS_SHM_NAME);
+        return kErrorNoResource;
+    }
+
+    if (fCreator_l)
+    {
+        OPLK_MEMSET(pMetricsMem_l, 0, sizeof(tMetricsMemory));
+    }
+
+    *ppMemory_p = pMetricsMem_l;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Free metrics memory
+
+The function unmaps the shared memory of the metrics registry. The shared
+memory is removed by the process which created it.
+
+\ingroup module_metrics
+*/
+//------------------------------------------------------------------------------
+void metrics_exitMemory(void)
+{
+    if (pMetricsMem_l != NULL)
+    {
+        munmap(pMetricsMem_l, sizeof(tMetricsMemory));
+        close(fd_l);
+        if (fCreator_l)
+            shm_unlink(METRICS_SHM_NAME);
+        fd_l = 0;
+        pMetricsMem_l = NULL;
+    }
+}
@@ -0,0 +1,308 @@
+/**
+********************************************************************************
+\file   metrics.c
+
+\brief  Implementation of the metrics registry
+
+The metrics registry collects counters, gauges and histograms of the stack
+modules in one table. A module registers its metrics once at initialization
+and updates them on the hot path without locks: every metric is updated by a
+single context only, so a plain store suffices and readers never block the
+stack. The table is located in the memory provided by the metrics memory
+implementation, which can be shared between the user and the kernel layer and
+read by external collectors, see \ref tMetricsMemory.
+
+\ingroup module_metrics
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <common/metrics.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tMetricsMemory*      pMetricsMem_l = NULL;
+static UINT                 initCount_l = 0;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize metrics registry
+
+The function initializes the metrics registry. If the user and the kernel
+layer run in the same process, the function is called by both layers. The
+module is initialized by the first call only.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_metrics
+*/
+//------------------------------------------------------------------------------
+tOplkError metrics_init(void)
+{
+    tOplkError      ret;
+
+    if (initCount_l == 0)
+    {
+        ret = metrics_initMemory(&pMetricsMem_l);
+        if (ret != kErrorOk)
+        {
+            pMetricsMem_l = NULL;
+            return ret;
+        }
+
+        if (pMetricsMem_l->magic != METRICS_MEMORY_MAGIC)
+        {   // the memory is new, set up the header for the collectors
+            pMetricsMem_l->version = METRICS_MEMORY_VERSION;
+            pMetricsMem_l->metricSize = sizeof(tMetric);
+            pMetricsMem_l->maxMetricCount = CONFIG_METRICS_COUNT;
+            pMetricsMem_l->metricCount = 0;
+            OPLK_MEMBAR();
+            pMetricsMem_l->magic = METRICS_MEMORY_MAGIC;
+        }
+    }
+
+    initCount_l++;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Shut down metrics registry
+
+The function shuts down the metrics registry. The module is shut down by the
+call matching the first call of metrics_init().
+
+\ingroup module_metrics
+*/
+//------------------------------------------------------------------------------
+void metrics_exit(void)
+{
+    if (initCount_l == 0)
+        return;
+
+    initCount_l--;
+    if (initCount_l == 0)
+    {
+        metrics_exitMemory();
+        pMetricsMem_l = NULL;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Register a metric
+
+The function registers a metric and returns the entry which is updated by the
+module. If a metric with the same name is already registered, e.g. by a
+previous initialization of the module, its entry is returned and keeps its
+value. Metrics are registered during the initialization of the layers, which
+is not done concurrently, so the function does not lock the table.
+
+\param  pName_p         Name of the metric.
+\param  type_p          Type of the metric.
+\param  ppMetric_p      Pointer to store the pointer to the metric entry. NULL
+                        is stored if the metric could not be registered.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The metric is registered.
+\retval kErrorApiInvalidParam   The name is too long or the metric is
+                                registered with another type.
+\retval kErrorNoResource        The registry is full or not initialized.
+
+\ingroup module_metrics
+*/
+//------------------------------------------------------------------------------
+tOplkError metrics_register(const char* pName_p, tMetricType type_p, tMetric** ppMetric_p)
+{
+    tMetric*        pMetric;
+    UINT            i;
+
+    *ppMetric_p = NULL;
+
+    if (pMetricsMem_l == NULL)
+        return kErrorNoResource;
+
+    if (strlen(pName_p) >= METRICS_NAME_LENGTH)
+        return kErrorApiInvalidParam;
+
+    for (i = 0; i < pMetricsMem_l->metricCount; i++)
+    {
+        pMetric = &pMetricsMem_l->aMetric[i];
+        if (strcmp(pMetric->name, pName_p) == 0)
+        {
+            if (pMetric->type != type_p)
+                return kErrorApiInvalidParam;
+
+            *ppMetric_p = pMetric;
+            return kErrorOk;
+        }
+    }
+
+    if (pMetricsMem_l->metricCount >= CONFIG_METRICS_COUNT)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() No free entry for metric %s\n", __func__, pName_p);
+        return kErrorNoResource;
+    }
+
+    pMetric = &pMetricsMem_l->aMetric[pMetricsMem_l->metricCount];
+    OPLK_MEMSET(pMetric, 0, sizeof(tMetric));
+    strncpy(pMetric->name, pName_p, METRICS_NAME_LENGTH - 1);
+    pMetric->type = type_p;
+
+    // the entry must be complete before the collectors see it
+    OPLK_MEMBAR();
+    pMetricsMem_l->metricCount++;
+
+    *ppMetric_p = pMetric;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Increment a counter
+
+\param  pMetric_p       Pointer to the metric entry (may be NULL).
+\param  value_p         Value to add.
+
+\ingroup module_metrics
+*/
+//------------------------------------------------------------------------------
+void metrics_add(tMetric* pMetric_p, UINT32 value_p)
+{
+    if (pMetric_p != NULL)
+        pMetric_p->value += value_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set a gauge
+
+\param  pMetric_p       Pointer to the metric entry (may be NULL).
+\param  value_p         Current value.
+
+\ingroup module_metrics
+*/
+//------------------------------------------------------------------------------
+void metrics_set(tMetric* pMetric_p, UINT64 value_p)
+{
+    if (pMetric_p != NULL)
+        pMetric_p->value = value_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add an observation to a histogram
+
+\param  pMetric_p       Pointer to the metric entry (may be NULL).
+\param  value_p         Observed value.
+
+\ingroup module_metrics
+*/
+//------------------------------------------------------------------------------
+void metrics_observe(tMetric* pMetric_p, UINT32 value_p)
+{
+    UINT        bucket;
+
+    if (pMetric_p == NULL)
+        return;
+
+    // the bucket is the bit length of the value
+    for (bucket = 0; (value_p >> bucket) != 0; bucket++)
+        ;
+    if (bucket >= METRICS_HISTOGRAM_BUCKETS)
+        bucket = METRICS_HISTOGRAM_BUCKETS - 1;
+
+    pMetric_p->aBucket[bucket]++;
+    pMetric_p->sum += value_p;
+    pMetric_p->value++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the metrics
+
+The function copies the metrics memory.
+
+\param  pMetrics_p      Pointer to store the metrics.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The metrics were copied.
+\retval kErrorNoResource        The registry is not initialized.
+
+\ingroup module_metrics
+*/
+//------------------------------------------------------------------------------
+tOplkError metrics_getMemory(tMetricsMemory* pMetrics_p)
+{
+    if (pMetricsMem_l == NULL)
+        return kErrorNoResource;
+
+    OPLK_MEMCPY(pMetrics_p, pMetricsMem_l, sizeof(tMetricsMemory));
+    return kErrorOk;
+}
@@ -0,0 +1,367 @@
+/**
+********************************************************************************
+\file   nodeset.c
+
+\brief  Implementation of node ID sets
+
+This file implements the node set module. It provides set operations on
+bitmaps of node IDs. Iterating a set only visits the node IDs which are
+members of the set, empty words are skipped and the next member within a word
+is found by counting the trailing zero bits.
+
+\ingroup module_nodeset
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <common/ami.h>
+#include <common/nodeset.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static UINT countTrailingZeros(UINT32 word_p);
+static UINT countBits(UINT32 word_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Clear node set
+
+The function removes all node IDs from the node set.
+
+\param  pSet_p              Pointer to the node set.
+
+\ingroup module_nodeset
+*/
+//------------------------------------------------------------------------------
+void nodeset_clear(tNodeSet* pSet_p)
+{
+    OPLK_MEMSET(pSet_p, 0, sizeof(tNodeSet));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check if node set is empty
+
+\param  pSet_p              Pointer to the node set.
+
+\return The function returns TRUE if the node set contains no node ID.
+
+\ingroup module_nodeset
+*/
+//------------------------------------------------------------------------------
+BOOL nodeset_isEmpty(const tNodeSet* pSet_p)
+{
+    UINT32  bits = 0;
+    UINT    wordIdx;
+
+    for (wordIdx = 0; wordIdx < NODESET_WORD_COUNT; wordIdx++)
+        bits |= pSet_p->aWord[wordIdx];
+
+    return (bits == 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Count node IDs in node set
+
+\param  pSet_p              Pointer to the node set.
+
+\return The function returns the number of node IDs in the node set.
+
+\ingroup module_nodeset
+*/
+//------------------------------------------------------------------------------
+UINT nodeset_count(const tNodeSet* pSet_p)
+{
+    UINT    count = 0;
+    UINT    wordIdx;
+
+    for (wordIdx = 0; wordIdx < NODESET_WORD_COUNT; wordIdx++)
+        count += countBits(pSet_p->aWord[wordIdx]);
+
+    return count;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add node set
+
+The function adds all node IDs of another node set to the node set.
+
+\param  pSet_p              Pointer to the node set which is modified.
+\param  pOther_p            Pointer to the node set to add.
+
+\ingroup module_nodeset
+*/
+//------------------------------------------------------------------------------
+void nodeset_union(tNodeSet* pSet_p, const tNodeSet* pOther_p)
+{
+    UINT    wordIdx;
+
+    for (wordIdx = 0; wordIdx < NODESET_WORD_COUNT; wordIdx++)
+        pSet_p->aWord[wordIdx] |= pOther_p->aWord[wordIdx];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Intersect node sets
+
+The function removes all node IDs from the node set which are not contained
+in another node set.
+
+\param  pSet_p              Pointer to the node set which is modified.
+\param  pOther_p            Pointer to the node set to intersect with.
+
+\ingroup module_nodeset
+*/
+//------------------------------------------------------------------------------
+void nodeset_intersect(tNodeSet* pSet_p, const tNodeSet* pOther_p)
+{
+    UINT    wordIdx;
+
+    for (wordIdx = 0; wordIdx < NODESET_WORD_COUNT; wordIdx++)
+        pSet_p->aWord[wordIdx] &= pOther_p->aWord[wordIdx];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Subtract node set
+
+The function removes all node IDs of another node set from the node set.
+
+\param  pSet_p              Pointer to the node set which is modified.
+\param  pOther_p            Pointer to the node set to subtract.
+
+\ingroup module_nodeset
+*/
+//------------------------------------------------------------------------------
+void nodeset_subtract(tNodeSet* pSet_p, const tNodeSet* pOther_p)
+{
+    UINT    wordIdx;
+
+    for (wordIdx = 0; wordIdx < NODESET_WORD_COUNT; wordIdx++)
+        pSet_p->aWord[wordIdx] &= ~pOther_p->aWord[wordIdx];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get next node ID of node set
+
+The function returns the next node ID of the node set after the specified node
+ID. The node set can be iterated with:
+
+    for (nodeId = nodeset_getNext(pSet, C_ADR_INVALID); nodeId != C_ADR_INVALID;
+         nodeId = nodeset_getNext(pSet, nodeId))
+
+Node ID 0 is never returned because it terminates the iteration.
+
+\param  pSet_p              Pointer to the node set.
+\param  nodeId_p            Node ID after which the search starts.
+                            C_ADR_INVALID starts with the first node ID.
+
+\return The function returns the next node ID of the node set or C_ADR_INVALID
+        if there is none.
+
+\ingroup module_nodeset
+*/
+//------------------------------------------------------------------------------
+UINT nodeset_getNext(const tNodeSet* pSet_p, UINT nodeId_p)
+{
+    UINT    nodeId = nodeId_p + 1;
+    UINT    wordIdx;
+    UINT32  word;
+
+    if (nodeId >= (NODESET_WORD_COUNT * 32))
+        return C_ADR_INVALID;
+
+    wordIdx = nodeId >> 5;
+    word = pSet_p->aWord[wordIdx] & ~(((UINT32)1 << (nodeId & 31)) - 1);
+
+    while (word == 0)
+    {
+        wordIdx++;
+        if (wordIdx >= NODESET_WORD_COUNT)
+            return C_ADR_INVALID;
+
+        word = pSet_p->aWord[wordIdx];
+    }
+
+    return (wordIdx << 5) + countTrailingZeros(word);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Convert POWERLINK node list into node set
+
+\param  pSet_p              Pointer to store the node set.
+\param  pNodeList_p         Pointer to the node list (NODESET_NODELIST_SIZE
+                            bytes, e.g. of an extended NMT command).
+
+\ingroup module_nodeset
+*/
+//------------------------------------------------------------------------------
+void nodeset_fromNodeList(tNodeSet* pSet_p, const UINT8* pNodeList_p)
+{
+    UINT    wordIdx;
+
+    for (wordIdx = 0; wordIdx < NODESET_WORD_COUNT; wordIdx++, pNodeList_p += 4)
+        pSet_p->aWord[wordIdx] = ami_getUint32Le((void*)pNodeList_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Convert node set into POWERLINK node list
+
+\param  pSet_p              Pointer to the node set.
+\param  pNodeList_p         Pointer to store the node list
+                            (NODESET_NODELIST_SIZE bytes).
+
+\ingroup module_nodeset
+*/
+//------------------------------------------------------------------------------
+void nodeset_toNodeList(const tNodeSet* pSet_p, UINT8* pNodeList_p)
+{
+    UINT    wordIdx;
+
+    for (wordIdx = 0; wordIdx < NODESET_WORD_COUNT; wordIdx++, pNodeList_p += 4)
+        ami_setUint32Le(pNodeList_p, pSet_p->aWord[wordIdx]);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Count trailing zero bits of a word
+
+\param  word_p              Word, must not be 0.
+
+\return The function returns the number of trailing zero bits.
+*/
+//------------------------------------------------------------------------------
+static UINT countTrailingZeros(UINT32 word_p)
+{
+#if defined(__GNUC__)
+    return (UINT)__builtin_ctz(word_p);
+#else
+    UINT    count = 0;
+
+    if ((word_p & 0xFFFF) == 0)
+    {
+        count += 16;
+        word_p >>= 16;
+    }
+    if ((word_p & 0xFF) == 0)
+    {
+        count += 8;
+        word_p >>= 8;
+    }
+    if ((word_p & 0xF) == 0)
+    {
+        count += 4;
+        word_p >>= 4;
+    }
+    if ((word_p & 0x3) == 0)
+    {
+        count += 2;
+        word_p >>= 2;
+    }
+    if ((word_p & 0x1) == 0)
+        count += 1;
+
+    return count;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Count set bits of a word
+
+\param  word_p              Word.
+
+\return The function returns the number of set bits.
+*/
+//------------------------------------------------------------------------------
+static UINT countBits(UINT32 word_p)
+{
+#if defined(__GNUC__)
+    return (UINT)__builtin_popcount(word_p);
+#else
+    word_p = word_p - ((word_p >> 1) & 0x55555555);
+    word_p = (word_p & 0x33333333) + ((word_p >> 2) & 0x33333333);
+    word_p = (word_p + (word_p >> 4)) & 0x0F0F0F0F;
+
+    return (UINT)((word_p * 0x01010101) >> 24);
+#endif
+}
+
+/// \}
@@ -52,6 +52,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <kernel/eventkcal.h>
 
 #include <common/ctrl.h>
+#include <common/cyclestat.h>
+#include <common/flightrec.h>
+#include <common/metrics.h>
 #include <kernel/ctrlk.h>
 #include <kernel/ctrlkcal.h>
 
@@ -333,6 +336,21 @@ static tOplkError initStack(void)
 
     ctrlkcal_readInitParam(&instance_l.initParam);
 
+#if (CONFIG_CYCLE_STATISTICS != FALSE)
+    if ((ret = cyclestat_init()) != kErrorOk)
+        return ret;
+#endif
+
+#if (CONFIG_FLIGHT_RECORDER != FALSE)
+    if ((ret = flightrec_init()) != kErrorOk)
+        return ret;
+#endif
+
+#if (CONFIG_METRICS != FALSE)
+    if ((ret = metrics_init()) != kErrorOk)
+        return ret;
+#endif
+
     if ((ret = eventk_init()) != kErrorOk)
         return ret;
 
@@ -402,6 +420,18 @@ static tOplkError shutdownStack(void)
     eventk_exit();
     errhndk_exit();
 
+#if (CONFIG_CYCLE_STATISTICS != FALSE)
+    cyclestat_exit();
+#endif
+
+#if (CONFIG_FLIGHT_RECORDER != FALSE)
+    flightrec_exit();
+#endif
+
+#if (CONFIG_METRICS != FALSE)
+    metrics_exit();
+#endif
+
     return kErrorOk;
 }
 
@@ -44,6 +44,16 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <common/ctrl.h>
 #include <common/ctrlcal.h>
+#include <kernel/ctrlkcal.h>
+#include <kernel/nmtk.h>
+#include <kernel/dllkcal.h>
+#include <kernel/pdokcal.h>
+#include <kernel/eventkcalintf.h>
+#include <errhndkcal.h>
+#include <oplk/powerlink-module.h>
+
+#include <linux/gfp.h>
+#include <linux/spinlock.h>
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -74,14 +84,22 @@ UINT16              status_g;
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
+typedef struct
+{
+    spinlock_t          lock;               ///< Protects the status page and the stored values
+    tCtrlStatusMem*     pStatusMem;         ///< Status page mapped by the user layer
+    UINT16              heartbeat;          ///< Last heartbeat counter
+} tCtrlkCalInstance;
 
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
+static tCtrlkCalInstance    instance_l;
 
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
+static void updateStatusMem(void);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -101,7 +119,13 @@ implementation nothing has to be done!
 //------------------------------------------------------------------------------
 tOplkError ctrlkcal_init(void)
 {
-    status_g = kCtrlStatusReady;
+    OPLK_MEMSET(&instance_l, 0, sizeof(tCtrlkCalInstance));
+    spin_lock_init(&instance_l.lock);
+    instance_l.pStatusMem = (tCtrlStatusMem*)get_zeroed_page(GFP_KERNEL);
+    if (instance_l.pStatusMem == NULL)
+        return kErrorNoResource;
+
+    ctrlkcal_setStatus(kCtrlStatusReady);
     return kErrorOk;
 }
 
@@ -118,7 +142,17 @@ the memory block access functions.
 //------------------------------------------------------------------------------
 void ctrlkcal_exit(void)
 {
-    status_g = kCtrlStatusUnavailable;
+    ULONG       flags;
+
+    ctrlkcal_setStatus(kCtrlStatusUnavailable);
+
+    spin_lock_irqsave(&instance_l.lock, flags);
+    if (instance_l.pStatusMem != NULL)
+    {
+        free_page((ULONG)instance_l.pStatusMem);
+        instance_l.pStatusMem = NULL;
+    }
+    spin_unlock_irqrestore(&instance_l.lock, flags);
 }
 
 //------------------------------------------------------------------------------
@@ -195,7 +229,12 @@ The function stores the status of the kernel stack in the control memory block.
 //------------------------------------------------------------------------------
 void ctrlkcal_setStatus(UINT16 status_p)
 {
+    ULONG       flags;
+
+    spin_lock_irqsave(&instance_l.lock, flags);
     status_g = status_p;
+    updateStatusMem();
+    spin_unlock_irqrestore(&instance_l.lock, flags);
 }
 
 //------------------------------------------------------------------------------
@@ -228,7 +267,12 @@ can be used by the user stack to detect if the kernel stack is still running.
 //------------------------------------------------------------------------------
 void ctrlkcal_updateHeartbeat(UINT16 heartbeat_p)
 {
-    UNUSED_PARAMETER(heartbeat_p);
+    ULONG       flags;
+
+    spin_lock_irqsave(&instance_l.lock, flags);
+    instance_l.heartbeat = heartbeat_p;
+    updateStatusMem();
+    spin_unlock_irqrestore(&instance_l.lock, flags);
 }
 
 //------------------------------------------------------------------------------
@@ -269,3 +313,91 @@ tOplkError ctrlkcal_readInitParam(tCtrlInitParam* pInitParam_p)
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get the status page
+
+The function returns the page containing the kernel stack status
+(\ref tCtrlStatusMem) which is mapped into the user layer.
+
+\return The function returns the address of the page or NULL if the module is
+        not initialized.
+
+\ingroup module_ctrlkcal
+*/
+//------------------------------------------------------------------------------
+BYTE* ctrlkcal_getStatusMem(void)
+{
+    return (BYTE*)instance_l.pStatusMem;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update the status page
+
+The function writes the current status, the heartbeat counter and, while the
+kernel stack is running, the state of the stack modules into the status page.
+It must be called with the instance lock held.
+*/
+//------------------------------------------------------------------------------
+static void updateStatusMem(void)
+{
+    tCtrlStatusMem*     pMem = instance_l.pStatusMem;
+    tPdoSyncInfoMem*    pSyncInfo;
+    tErrHndObjects*     pErrHndObjects;
+    ULONG               count;
+
+    if (pMem == NULL)
+        return;
+
+    pMem->sequence++;
+    smp_wmb();
+
+    pMem->status = status_g;
+    pMem->heartbeat = instance_l.heartbeat;
+
+    if (status_g == kCtrlStatusRunning)
+    {
+        pMem->nmtState = (UINT32)nmtk_getNmtState();
+
+        pSyncInfo = (tPdoSyncInfoMem*)pdokcal_getSyncInfoMem();
+        pMem->cycleCount = (pSyncInfo != NULL) ? pSyncInfo->cycleCount : 0;
+
+        pErrHndObjects = errhndkcal_getMemPtr();
+        pMem->cnLossSocCnt = pErrHndObjects->cnLossSoc.cumulativeCnt;
+        pMem->cnLossPreqCnt = pErrHndObjects->cnLossPreq.cumulativeCnt;
+        pMem->cnCrcErrCnt = pErrHndObjects->cnCrcErr.cumulativeCnt;
+#if defined(CONFIG_INCLUDE_NMT_MN)
+        pMem->mnCrcErrCnt = pErrHndObjects->mnCrcErr.cumulativeCnt;
+        pMem->mnCycTimeExceedCnt = pErrHndObjects->mnCycTimeExceed.cumulativeCnt;
+#endif
+
+        if (dllkcal_getAsyncQueueCount(kDllCalQueueTxNmt, &count) == kErrorOk)
+            pMem->fillLevelNmt = (UINT32)count;
+        if (dllkcal_getAsyncQueueCount(kDllCalQueueTxGen, &count) == kErrorOk)
+            pMem->fillLevelGen = (UINT32)count;
+
+        pMem->fillLevelK2U = eventkcal_getEventCountCircbuf(kEventQueueK2U);
+        pMem->fillLevelU2K = eventkcal_getEventCountCircbuf(kEventQueueU2K);
+    }
+    else
+    {
+        pMem->nmtState = (UINT32)kNmtGsOff;
+        pMem->fillLevelNmt = 0;
+        pMem->fillLevelGen = 0;
+        pMem->fillLevelK2U = 0;
+        pMem->fillLevelU2K = 0;
+    }
+
+    smp_wmb();
+    pMem->sequence++;
+}
+
+///\}
+
@@ -52,6 +52,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/nmt.h>
 #include <kernel/edrv.h>
 #include <oplk/benchmark.h>
+#include <common/nodeset.h>
 
 #if CONFIG_TIMER_USE_HIGHRES != FALSE
 #include <kernel/hrestimer.h>
@@ -91,6 +92,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #error "PRes Chaining CN support requires CONFIG_DLL_PROCESS_SYNC == DLL_PROCESS_SYNC_ON_TIMER."
 #endif
 
+#if (CONFIG_DLL_PRES_LATE_BINDING != FALSE) && ((CONFIG_EDRV_AUTO_RESPONSE == FALSE) || (CONFIG_TIMER_USE_HIGHRES == FALSE))
+#error "DLLK: CONFIG_DLL_PRES_LATE_BINDING requires CONFIG_EDRV_AUTO_RESPONSE and CONFIG_TIMER_USE_HIGHRES."
+#endif
+
+#if (CONFIG_DLL_PRES_LATE_BINDING != FALSE) && (CONFIG_DLL_PRES_CHAINING_CN != FALSE)
+#error "DLLK: CONFIG_DLL_PRES_LATE_BINDING is not supported with PRes Chaining."
+#endif
+
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
@@ -110,6 +119,21 @@ void  TgtDbgPostTraceValue (DWORD dwTraceValue_p);
     TGT_DBG_POST_TRACE_VALUE((kEventSinkDllk << 28) | (Event_p << 24) \
                              | (uiNodeId_p << 16) | wErrorCode_p)
 
+// PRes timeout of a CN which is used for the slot schedule
+#if (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE)
+#define DLLK_PRES_TIMEOUT_NS(pIntNodeInfo_p)    ((pIntNodeInfo_p)->adaptPresTimeoutNs)
+#else
+#define DLLK_PRES_TIMEOUT_NS(pIntNodeInfo_p)    ((pIntNodeInfo_p)->presTimeoutNs)
+#endif
+
+// PRes latencies of the CNs are measured from the hardware time stamps of the frames
+#if (EDRV_USE_HW_TIMESTAMP != FALSE) && defined(CONFIG_INCLUDE_NMT_MN) && \
+    ((CONFIG_CYCLE_STATISTICS != FALSE) || (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE))
+#define DLLK_PRES_WIRE_LATENCY                  TRUE
+#else
+#define DLLK_PRES_WIRE_LATENCY                  FALSE
+#endif
+
 // defines for indexes of tDllkInstance.pTxBuffer
 #define DLLK_TXFRAME_IDENTRES       0   // IdentResponse on CN / MN
 #define DLLK_TXFRAME_STATUSRES      2   // StatusResponse on CN / MN
@@ -141,19 +165,48 @@ void  TgtDbgPostTraceValue (DWORD dwTraceValue_p);
 #define DLLK_BUFLEN_FILLING             1   // just the buffer is being filled
 #define DLLK_BUFLEN_MIN                 60  // minimum ethernet frame length
 
-// defines for tDllkInstance.updateTxFrame
-#define DLLK_UPDATE_NONE                0   // no update necessary
-#define DLLK_UPDATE_STATUS              1   // StatusRes needs update
-#define DLLK_UPDATE_BOTH                2   // IdentRes and StatusRes need update
+// defines for tDllkInstance.updateTxFrame (changed fields of IdentRes and StatusRes)
+#define DLLK_UPDATE_NONE                0x00    // no update necessary
+#define DLLK_UPDATE_NMTSTATUS           0x01    // NMT state changed
+#define DLLK_UPDATE_FLAG1               0x02    // Flag 1 changed (StatusRes only)
+#define DLLK_UPDATE_FLAG2               0x04    // Flag 2 changed
+#define DLLK_UPDATE_IDENTRES            (DLLK_UPDATE_NMTSTATUS | DLLK_UPDATE_FLAG2)
+#define DLLK_UPDATE_STATUSRES           (DLLK_UPDATE_NMTSTATUS | DLLK_UPDATE_FLAG1 | DLLK_UPDATE_FLAG2)
 
 // defines for tDllkNodeInfo.presFilterFlags
 #define DLLK_FILTER_FLAG_PDO            0x01    // PRes needed for RPDO
 #define DLLK_FILTER_FLAG_HB             0x02    // PRes needed for Heartbeat Consumer
 
+// defines for tDllkInstance.aCnNodeIndex
+#define DLLK_NODE_INDEX_INVALID         0xFF    // node is not in the CN node-ID list
+
+// defines for the dynamic fields of tDllkFrameTemplate
+#define DLLK_FRAME_FIELD_NMTSTATUS      0   // NMT state
+#define DLLK_FRAME_FIELD_FLAG1          1   // Flag 1
+#define DLLK_FRAME_FIELD_FLAG2          2   // Flag 2 (RS, PR)
+#define DLLK_FRAME_FIELD_REQSERVICEID   3   // SoA RequestedServiceID
+#define DLLK_FRAME_FIELD_REQTARGET      4   // SoA RequestedServiceTarget
+#define DLLK_FRAME_FIELD_COUNT          5
+
 //------------------------------------------------------------------------------
 // typedef
 //------------------------------------------------------------------------------
 
+/**
+ * \brief Structure for a Tx frame template
+ *
+ * The static part of a Tx frame is built once when the frame is created. The
+ * template lists the offsets of the dynamic header fields which are patched
+ * during operation. A field is only written if its value changes.
+ */
+typedef struct
+{
+    UINT16    aFieldOffset[DLLK_FRAME_FIELD_COUNT]; ///< Offset of the dynamic fields in the frame, 0 if not present
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+    UINT8*    pEdrvBuffer;                          ///< Frame buffer allocated by the Ethernet driver
+#endif
+} tDllkFrameTemplate;
+
 /**
  * \brief Structure for handling the report of a loss of SoC to the error handler
  *
@@ -166,28 +219,49 @@ typedef struct
     BOOL      fTimeoutOccurred;     ///< The sync interrupt occurred after a report of a loss of SoC
 } tDllLossSocStatus;
 
+/**
+ * \brief Structure for limiting the forwarding of an ASnd service
+ *
+ * Frames which are not responses to a request of the local MN are only
+ * forwarded to the user layer within the configured rate. Unchanged
+ * StatusResponses can be dropped completely.
+ */
+typedef struct
+{
+    UINT      maxFramesPerSec;      ///< Maximum number of forwarded frames per second, 0 = unlimited
+    BOOL      fCoalesce;            ///< Forward only changed StatusResponses
+    UINT32    windowStart;          ///< Tick count at the start of the current rate window
+    UINT      frameCount;           ///< Number of frames forwarded in the current rate window
+} tDllkAsndLimit;
+
 typedef struct
 {
     tNmtState               nmtState;
     UINT64                  relativeTime;
     UINT8                   aLocalMac[6];
     tEdrvTxBuffer*          pTxBuffer;                      // Buffers for Tx-Frames
+    tDllkFrameTemplate*     pFrameTemplate;                 // Templates of the Tx-Frames
     UINT                    maxTxFrames;
     UINT8                   flag1;                          // Flag 1 with EN, EC for PRes, StatusRes
     UINT8                   mnFlag1;                        // Flag 1 with MS, EA, ER from PReq, SoA of MN
     UINT8                   flag2;                          // Flag 2 with PR and RS for PRes, StatusRes, IdentRes
-    UINT8                   updateTxFrame;
+    UINT8                   updateTxFrame;                  // changed fields of IdentRes and StatusRes (DLLK_UPDATE_xxx)
     UINT                    usedPresFilterCount;
     tDllConfigParam         dllConfigParam;
     tDllIdentParam          dllIdentParam;
     tDllState               dllState;
     tDllkCbProcessRpdo      pfnCbProcessRpdo;
     tDllkCbProcessTpdo      pfnCbProcessTpdo;
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+    tDllkCbProcessTpdo      pfnCbProcessTpdoZeroCopy;
+#endif
     tDllkCbAsync            pfnCbAsync;
     tSyncCb                 pfnCbSync;
     tDllAsndFilter          aAsndFilter[DLL_MAX_ASND_SERVICE_ID];
+    tDllkAsndLimit          aAsndLimit[DLL_MAX_ASND_SERVICE_ID];
     tEdrvFilter             aFilter[DLLK_FILTER_COUNT];
 #if NMT_MAX_NODE_ID > 0
+    UINT32                  aStatusResSignature[NMT_MAX_NODE_ID];   // signature of last forwarded StatusResponse per node, 0 = none
     tDllkNodeInfo           aNodeInfo[NMT_MAX_NODE_ID];
 #endif
     UINT8                   curTxBufferOffsetIdentRes;
@@ -200,8 +274,15 @@ typedef struct
 #endif
 
 #if defined(CONFIG_INCLUDE_NMT_MN)
-    tDllkNodeInfo*          pFirstNodeInfo;
     UINT8                   aCnNodeIdList[2][NMT_MAX_NODE_ID];
+    UINT8                   aCnNodeIndex[2][C_ADR_BROADCAST + 1];   // position of node ID in aCnNodeIdList
+    tNodeSet                aCnNodeSet[2];                          // CNs in aCnNodeIdList which shall respond with a PRes
+    tNodeSet                cnHandledSet;                           // CNs of the current cycle whose PRes was received or reported as lost
+    tNodeSet                isochrNodeSet;                          // nodes in apIsochrNodeInfo or apPrcNodeInfo
+    tDllkNodeInfo*          apIsochrNodeInfo[NMT_MAX_NODE_ID];      // isochronous nodes, own PRes first, then in ascending node ID order
+    UINT                    isochrNodeCount;
+    tDllkNodeInfo*          apPrcNodeInfo[NMT_MAX_NODE_ID];         // PRC nodes in ascending node ID order
+    UINT                    prcNodeCount;
     UINT8                   curNodeIndex;
     tEdrvTxBuffer**         ppTxBufferList;
     UINT8                   syncLastSoaReq;
@@ -210,21 +291,49 @@ typedef struct
     UINT8                   curLastSoaReq;
     BOOL                    fSyncProcessed;
     BOOL                    fPrcSlotFinished;
-    tDllkNodeInfo*          pFirstPrcNodeInfo;
+#if (DLLK_PRES_WIRE_LATENCY != FALSE)
+    ULONGLONG               rxTimeStampNs;                  // hardware time stamp of the frame being processed
+#endif
 #endif
 
 #if CONFIG_TIMER_USE_HIGHRES != FALSE
     tTimerHdl               timerHdlCycle;                  // used for POWERLINK cycle monitoring on CN and generation on MN
+#if (CONFIG_DLL_SOC_WATCHDOG != FALSE)
+    UINT64                  lastSocTime;                    // CN: time stamp of the last SoC checked by the watchdog
+#endif
 #if defined(CONFIG_INCLUDE_NMT_MN)
     tTimerHdl               timerHdlResponse;               // used for CN response monitoring
 #endif
 #endif
 
+#if (CONFIG_DLL_PRES_LATE_BINDING != FALSE)
+    tTimerHdl               timerHdlPresFill;               // used for the late PRes fill on CN
+    ULONGLONG               socRxTimeNs;                    // reception time of the last SoC
+    ULONGLONG               preqOffsetNs;                   // minimum time between SoC and PReq reception, 0 = not measured
+    ULONGLONG               presFillTimeNs;                 // expiry time of the PRes fill timer
+    ULONGLONG               presFillDurationNs;             // maximum time from timer expiry to completed PRes fill
+    BOOL                    fPresFillTimer;                 // PRes fill timer is started for the current cycle
+    BOOL                    fPresFillExpired;               // PRes fill timer expired in the current cycle
+    BOOL                    fPresFillPending;               // PRes fill is deferred to the PRes fill timer
+    BOOL                    fPresFillReadyFlag;             // ready flag of the deferred PRes fill
+    UINT32                  presFillMissCount;              // PReqs received before the deferred PRes fill
+#endif
+
     UINT                    prescaleCycleCount;             // cycle counter for toggling PS bit in MN SOC
     UINT                    cycleCount;                     // cycle counter (needed for multiplexed cycle support)
     UINT64                  frameTimeout;                   // frame timeout (cycle length + loss of frame tolerance)
+#if (CONFIG_DLL_RUNTIME_CYCLE_CHANGE != FALSE)
+    UINT32                  newCycleLen;                    // announced cycle length in [us], 0 = no change pending
+    UINT64                  socRelativeTime;                // CN: relative time of the last received SoC
+#endif
+#if defined(CONFIG_INCLUDE_NMT_MN) && (CONFIG_DLL_PREOP1_IDLE_SLOT_TIME_MAX != 0)
+    UINT32                  idleSlotTime;                   // MN: stretched reduced cycle time in [ns], 0 = nominal reduced cycle
+#endif
 
     tDllLossSocStatus       lossSocStatus;
+#if (CONFIG_DLL_SOC_TIME_INFO != FALSE)
+    tSocTimeInfo            socTimeInfo;                    // time information of the last SoC
+#endif
 
 #if CONFIG_DLL_PRES_CHAINING_CN != FALSE
     UINT                    syncReqPrevNodeId;
@@ -257,15 +366,26 @@ void       dllk_processTransmittedNonPlk(tEdrvTxBuffer* pTxBuffer_p) SECTION_DLL
 #if defined(CONFIG_INCLUDE_NMT_MN)
 void       dllk_processTransmittedSoc(tEdrvTxBuffer * pTxBuffer_p) SECTION_DLLK_PROCESS_TX_SOC;
 void       dllk_processTransmittedSoa(tEdrvTxBuffer * pTxBuffer_p) SECTION_DLLK_PROCESS_TX_SOA;
+#if (CONFIG_CYCLE_STATISTICS != FALSE) || (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE)
+void       dllk_processTransmittedPreq(tEdrvTxBuffer* pTxBuffer_p);
+#endif
+#if (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE)
+void       dllk_resetPresTimeout(tDllkNodeInfo* pIntNodeInfo_p);
+#endif
 #endif
 tOplkError dllk_updateFrameIdentRes(tEdrvTxBuffer* pTxBuffer_p, tNmtState nmtState_p);
 tOplkError dllk_updateFrameStatusRes(tEdrvTxBuffer* pTxBuffer_p, tNmtState NmtState_p);
 tOplkError dllk_updateFramePres(tEdrvTxBuffer* pTxBuffer_p, tNmtState nmtState_p);
 tOplkError dllk_checkFrame(tPlkFrame * pFrame_p, UINT frameSize_p);
+BOOL       dllk_patchFrame(tEdrvTxBuffer* pTxBuffer_p, UINT field_p, UINT8 value_p);
+BOOL       dllk_checkFrameField(tEdrvTxBuffer* pTxBuffer_p, UINT field_p, UINT8 value_p);
 tOplkError dllk_createTxFrame(UINT* pHandle_p, UINT* pFrameSize_p,
                               tMsgType msgType_p, tDllAsndServiceId serviceId_p);
 tOplkError dllk_deleteTxFrame(UINT handle_p);
 tOplkError dllk_processTpdo(tFrameInfo* pFrameInfo_p, BOOL fReadyFlag_p);
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+tOplkError dllk_processTpdoZeroCopy(tEdrvTxBuffer* pTxBuffer_p, BOOL fReadyFlag_p);
+#endif
 #if defined(CONFIG_INCLUDE_NMT_MN)
 tOplkError dllk_mnSendSoa(tNmtState nmtState_p, tDllState* pDllStateProposed_p,
                           BOOL fEnableInvitation_p);
@@ -323,6 +443,21 @@ tOplkError dllk_setupSyncPhase(tNmtState nmtState_p, BOOL fReadyFlag_p, UINT nex
 tDllkNodeInfo* dllk_getNodeInfo(UINT uiNodeId_p);
 #endif
 
+//------------------------------------------------------------------------------
+/* runtime cycle length change */
+#if (CONFIG_DLL_RUNTIME_CYCLE_CHANGE != FALSE)
+#if defined(CONFIG_INCLUDE_NMT_MN)
+tOplkError dllk_switchCycleLenMn(void);
+#endif
+tOplkError dllk_switchCycleLenCn(UINT64 relativeTime_p);
+#endif
+
+//------------------------------------------------------------------------------
+/* SoC time information */
+#if (CONFIG_DLL_SOC_TIME_INFO != FALSE)
+void       dllk_updateSocTime(tPlkFrame* pSocFrame_p, UINT64 localTime_p);
+#endif
+
 //------------------------------------------------------------------------------
 /* Cycle/Sync Callback functions */
 #if defined(CONFIG_INCLUDE_NMT_MN)
@@ -332,11 +467,20 @@ tOplkError dllk_cbMnTimerCycle(tTimerEventArg* pEventArg_p);
 #endif
 #if CONFIG_TIMER_USE_HIGHRES != FALSE
 tOplkError dllk_cbCnTimer(tTimerEventArg* pEventArg_p);
+#if (CONFIG_DLL_SOC_WATCHDOG != FALSE)
+tOplkError dllk_feedSocWatchdog(void);
+#endif
 #endif
 #if (CONFIG_DLL_PROCESS_SYNC == DLL_PROCESS_SYNC_ON_TIMER)
 tOplkError dllk_cbCnTimerSync(void);
 tOplkError dllk_cbCnLossOfSync(void);
 #endif
+#if (CONFIG_DLL_PRES_LATE_BINDING != FALSE)
+tOplkError dllk_cbCnTimerPresFill(tTimerEventArg* pEventArg_p);
+#endif
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+void       dllk_cbLinkChange(BOOL fLinkUp_p);
+#endif
 
 //------------------------------------------------------------------------------
 /* PRes Chaining functions */
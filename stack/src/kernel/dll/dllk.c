@@ -41,6 +41,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <common/ami.h>
+#include <common/target.h>
 #include "dllk-internal.h"
 
 //============================================================================//
@@ -66,6 +67,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#define DLLK_SOC_TIME_FILTER_SHIFT  3           // weight 1/8 of a new sample in the NetTime offset filter
+#define DLLK_SOC_TIME_RESYNC_NS     1000000     // offset change in [ns] which is taken as jump of the NetTime
 
 //------------------------------------------------------------------------------
 // local types
@@ -76,11 +79,20 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 tDllkInstance               dllkInstance_g;
 static tEdrvTxBuffer        aDllkTxBuffer_l[DLLK_TXFRAME_COUNT];
+static tDllkFrameTemplate   aDllkFrameTemplate_l[DLLK_TXFRAME_COUNT];
 TGT_DLLK_DEFINE_CRITICAL_SECTION
 
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
+#if defined(CONFIG_INCLUDE_NMT_MN)
+static UINT findNodeArrayIndex(tDllkNodeInfo** apNodeInfo_p, UINT count_p, UINT nodeId_p);
+static void insertNodeArray(tDllkNodeInfo** apNodeInfo_p, UINT* pCount_p, tDllkNodeInfo* pIntNodeInfo_p);
+static void removeNodeArray(tDllkNodeInfo** apNodeInfo_p, UINT* pCount_p, tDllkNodeInfo* pIntNodeInfo_p);
+#endif
+#if (CONFIG_DLL_RUNTIME_CYCLE_CHANGE != FALSE)
+static tOplkError announceCycleLen(UINT32 cycleLen_p);
+#endif
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -137,6 +149,7 @@ tOplkError dllk_addInstance(tDllkInitParam* pInitParam_p)
 
     // initialize and link pointers in instance structure to frame tables
     dllkInstance_g.pTxBuffer = aDllkTxBuffer_l;
+    dllkInstance_g.pFrameTemplate = aDllkFrameTemplate_l;
     dllkInstance_g.maxTxFrames = sizeof (aDllkTxBuffer_l) / sizeof (tEdrvTxBuffer);
     dllkInstance_g.dllState = kDllGsInit;               // initialize state
 
@@ -157,6 +170,12 @@ tOplkError dllk_addInstance(tDllkInitParam* pInitParam_p)
     OPLK_MEMCPY(EdrvInitParam.aMacAddr, pInitParam_p->aLocalMac, 6);
     EdrvInitParam.hwParam = pInitParam_p->hwParam;
     EdrvInitParam.pfnRxHandler = dllk_processFrameReceived;
+    EdrvInitParam.txBufferCount = dllkInstance_g.maxTxFrames;
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+    EdrvInitParam.pfnLinkChangeHandler = dllk_cbLinkChange;
+#else
+    EdrvInitParam.pfnLinkChangeHandler = NULL;
+#endif
     if ((ret = edrv_init(&EdrvInitParam)) != kErrorOk)
         return ret;
 
@@ -170,6 +189,7 @@ tOplkError dllk_addInstance(tDllkInitParam* pInitParam_p)
     {
         dllkInstance_g.pTxBuffer[index].pBuffer = NULL;
     }
+    OPLK_MEMSET(aDllkFrameTemplate_l, 0, sizeof(aDllkFrameTemplate_l));
 
 #if defined(CONFIG_INCLUDE_NMT_MN)
     if ((ret = edrvcyclic_init()) != kErrorOk)
@@ -255,6 +275,10 @@ tOplkError dllk_config(tDllConfigParam* pDllConfigParam_p)
 #if (EDRV_USE_TTTX == TRUE)
         // Time triggered sending requires sync on SOC
         dllkInstance_g.dllConfigParam.syncNodeId = C_ADR_SYNC_ON_SOC;
+#endif
+#if (CONFIG_DLL_RUNTIME_CYCLE_CHANGE != FALSE)
+        dllkInstance_g.newCycleLen = 0;
+        dllkInstance_g.socRelativeTime = 0;
 #endif
     }
 
@@ -273,6 +297,13 @@ tOplkError dllk_config(tDllConfigParam* pDllConfigParam_p)
         }
     }
 
+#if (CONFIG_DLL_RUNTIME_CYCLE_CHANGE != FALSE)
+    if ((ret == kErrorOk) && (nmtState > kNmtGsResetConfiguration))
+    {   // the cycle length is applied at a cycle boundary
+        ret = announceCycleLen(pDllConfigParam_p->cycleLen);
+    }
+#endif
+
     if (dllkInstance_g.dllConfigParam.fAsyncOnly != FALSE)
     {   // it is configured as async-only CN
         // disable multiplexed cycle, so that cycleCount will not be incremented spuriously on SoC
@@ -396,6 +427,30 @@ tSyncCb dllk_regSyncHandler(tSyncCb pfnCbSync_p)
     return pfnCbOld;
 }
 
+#if (CONFIG_DLL_SOC_TIME_INFO != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Get the time information of the last SoC
+
+The function returns the NetTime and RelativeTime of the last SoC together with
+the local time of the SoC and the estimated offset of the NetTime to the local
+time.
+
+\param  pSocTimeInfo_p      Pointer to store the SoC time information.
+
+\ingroup module_dllk
+*/
+//------------------------------------------------------------------------------
+void dllk_getSocTimeInfo(tSocTimeInfo* pSocTimeInfo_p)
+{
+    TGT_DLLK_DECLARE_FLAGS;
+
+    TGT_DLLK_ENTER_CRITICAL_SECTION();
+    *pSocTimeInfo_p = dllkInstance_g.socTimeInfo;
+    TGT_DLLK_LEAVE_CRITICAL_SECTION();
+}
+#endif
+
 //------------------------------------------------------------------------------
 /**
 \brief  Register handler for RPDO frames
@@ -431,6 +486,79 @@ void dllk_regTpdoHandler(tDllkCbProcessTpdo pfnDllkCbProcessTpdo_p)
     dllkInstance_g.pfnCbProcessTpdo = pfnDllkCbProcessTpdo_p;
 }
 
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Register zero-copy handler for TPDO frames
+
+The function registers the handler for TPDO frames which may be sent directly
+from the TPDO buffer. The handler may replace the frame in the frame info by a
+frame located in the TPDO buffer, which is then sent instead of the frame
+buffer of the Ethernet driver.
+
+\param  pfnDllkCbProcessTpdo_p    Pointer to callback function.
+
+\ingroup module_dllk
+*/
+//------------------------------------------------------------------------------
+void dllk_regTpdoZeroCopyHandler(tDllkCbProcessTpdo pfnDllkCbProcessTpdo_p)
+{
+    dllkInstance_g.pfnCbProcessTpdoZeroCopy = pfnDllkCbProcessTpdo_p;
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set forwarding limits of an ASnd service
+
+The function limits the forwarding of received frames of the specified
+AsndServiceId to the user layer. Responses to requests of the local MN are
+always forwarded.
+
+\param  serviceId_p         ASnd service ID.
+\param  maxFramesPerSec_p   Maximum number of forwarded frames per second.
+                            0 disables the rate limit.
+\param  fCoalesce_p         If TRUE, a StatusResponse is only forwarded if it
+                            differs from the last forwarded one of the node.
+                            Only valid for kDllAsndStatusResponse.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                          Limits were successfully set.
+\retval kErrorDllInvalidAsndServiceId     An invalid service ID was specified.
+\retval kErrorDllInvalidParam             Coalescing is not supported for the
+                                          service ID.
+
+\ingroup module_dllk
+*/
+//------------------------------------------------------------------------------
+tOplkError dllk_setAsndServiceIdLimit(tDllAsndServiceId serviceId_p, UINT maxFramesPerSec_p,
+                                      BOOL fCoalesce_p)
+{
+    tDllkAsndLimit*     pLimit;
+
+    if (serviceId_p >= tabentries(dllkInstance_g.aAsndLimit))
+        return kErrorDllInvalidAsndServiceId;
+
+    if ((fCoalesce_p != FALSE) && (serviceId_p != kDllAsndStatusResponse))
+        return kErrorDllInvalidParam;
+
+    pLimit = &dllkInstance_g.aAsndLimit[serviceId_p];
+    pLimit->maxFramesPerSec = maxFramesPerSec_p;
+    pLimit->fCoalesce = fCoalesce_p;
+    pLimit->frameCount = 0;
+    pLimit->windowStart = target_getTickCount();
+
+#if NMT_MAX_NODE_ID > 0
+    if (serviceId_p == kDllAsndStatusResponse)
+    {   // forward next StatusResponse of each node
+        OPLK_MEMSET(dllkInstance_g.aStatusResSignature, 0,
+                    sizeof(dllkInstance_g.aStatusResSignature));
+    }
+#endif
+
+    return kErrorOk;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Set the specified node ID filter
@@ -531,13 +659,18 @@ tOplkError dllk_configNode(tDllNodeInfo* pNodeInfo_p)
         pIntNodeInfo->presPayloadLimit = (UINT16)dllkInstance_g.dllConfigParam.isochrRxMaxPayload;
     else
         pIntNodeInfo->presPayloadLimit = pNodeInfo_p->presPayloadLimit;
+    pIntNodeInfo->presFrameSizeLimit = pIntNodeInfo->presPayloadLimit + PLK_FRAME_OFFSET_PDO_PAYLOAD;
 
 #if defined(CONFIG_INCLUDE_NMT_MN)
     pIntNodeInfo->presTimeoutNs = pNodeInfo_p->presTimeoutNs;
+#if (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE)
+    dllk_resetPresTimeout(pIntNodeInfo);
+#endif
     if (pNodeInfo_p->preqPayloadLimit > dllkInstance_g.dllConfigParam.isochrTxMaxPayload)
         pIntNodeInfo->preqPayloadLimit = (UINT16)dllkInstance_g.dllConfigParam.isochrTxMaxPayload;
     else
         pIntNodeInfo->preqPayloadLimit = pNodeInfo_p->preqPayloadLimit;
+    pIntNodeInfo->multiplCycleAssign = pNodeInfo_p->multiplCycleAssign;
 
     // initialize elements of internal node info structure
     pIntNodeInfo->soaFlag1 = PLK_FRAME_FLAG1_ER;
@@ -774,6 +907,43 @@ tOplkError dllk_getCnMacAddress(UINT nodeId_p, BYTE* pCnMacAddress_p)
     return kErrorOk;
 }
 
+#if (CONFIG_DLL_PREOP1_IDLE_SLOT_TIME_MAX != 0) && (CONFIG_TIMER_USE_HIGHRES != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Return to the nominal reduced cycle
+
+The function ends a stretched reduced cycle of the MN in PreOp1 because a
+request or an asynchronous frame is pending or the NMT state changes. The
+next SoA is sent after the AsyncSlotTimeout and not at the end of the
+stretched slot.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_dllk
+*/
+//------------------------------------------------------------------------------
+tOplkError dllk_wakeReducedCycle(void)
+{
+    tOplkError      ret = kErrorOk;
+
+    TGT_DLLK_DECLARE_FLAGS
+
+    TGT_DLLK_ENTER_CRITICAL_SECTION()
+
+    if ((dllkInstance_g.dllState == kDllMsNonCyclic) && (dllkInstance_g.idleSlotTime != 0))
+    {   // the current slot is empty, so the SoA can be sent earlier
+        dllkInstance_g.idleSlotTime = 0;
+        ret = hrestimer_modifyTimer(&dllkInstance_g.timerHdlCycle,
+                                    dllkInstance_g.dllConfigParam.asyncSlotTimeout,
+                                    dllk_cbMnTimerCycle, 0L, FALSE);
+    }
+
+    TGT_DLLK_LEAVE_CRITICAL_SECTION()
+
+    return ret;
+}
+#endif
+
 #endif
 
 //============================================================================//
@@ -906,7 +1076,8 @@ tOplkError dllk_cbMnSyncHandler(void)
 {
     tOplkError      ret = kErrorOk;
     tNmtState       nmtState;
-    BYTE*           pbCnNodeId;
+    tNodeSet        missingSet;
+    UINT            nodeId;
     UINT32          arg;
 
     TGT_DLLK_DECLARE_FLAGS;
@@ -917,15 +1088,27 @@ tOplkError dllk_cbMnSyncHandler(void)
     if (nmtState <= kNmtGsResetConfiguration)
         goto Exit;
 
-    // do cycle finish which has to be done inside the callback function triggered by interrupt
-    pbCnNodeId = &dllkInstance_g.aCnNodeIdList[dllkInstance_g.curTxBufferOffsetCycle][dllkInstance_g.curNodeIndex];
+#if (CONFIG_EDRV_RX_FILTER_BATCH != FALSE)
+    // apply the PRes filter changes before the next cycle starts
+    ret = edrv_commitRxFilter();
+    if (ret != kErrorOk)
+        goto Exit;
+#endif
 
-    while (*pbCnNodeId != C_ADR_INVALID)
-    {   // issue error for each CN in list which was not processed yet, i.e. PRes received
-        ret = dllk_issueLossOfPres(*pbCnNodeId);
+    // do cycle finish which has to be done inside the callback function triggered by interrupt
+    // The CNs which are missing are the expected CNs of the cycle which were
+    // neither received nor already reported as lost.
+    missingSet = dllkInstance_g.aCnNodeSet[dllkInstance_g.curTxBufferOffsetCycle];
+    nodeset_subtract(&missingSet, &dllkInstance_g.cnHandledSet);
+    nodeset_clear(&dllkInstance_g.cnHandledSet);
+
+    for (nodeId = nodeset_getNext(&missingSet, C_ADR_INVALID);
+         nodeId != C_ADR_INVALID;
+         nodeId = nodeset_getNext(&missingSet, nodeId))
+    {   // issue error for each CN whose PRes was not received
+        ret = dllk_issueLossOfPres(nodeId);
         if (ret != kErrorOk)
             goto Exit;
-        pbCnNodeId++;
     }
 
     dllkInstance_g.fSyncProcessed = FALSE;
@@ -935,6 +1118,13 @@ tOplkError dllk_cbMnSyncHandler(void)
     dllkInstance_g.curTxBufferOffsetCycle ^= 1;
     dllkInstance_g.curNodeIndex = 0;
 
+#if (CONFIG_DLL_SOC_TIME_INFO != FALSE)
+    // the SoC of the new cycle is sent now
+    dllk_updateSocTime((tPlkFrame*)dllkInstance_g.pTxBuffer[DLLK_TXFRAME_SOC +
+                                                            dllkInstance_g.curTxBufferOffsetCycle].pBuffer,
+                       target_getCurrentTimestamp());
+#endif
+
     ret = dllk_postEvent(kEventTypeDllkCycleFinish);
 
 Exit:
@@ -950,6 +1140,50 @@ Exit:
 }
 #endif
 
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Callback function for link changes
+
+This function is called by the Ethernet driver module in interrupt context if
+the link of the Ethernet controller went up or down. On an MN the link up is
+forwarded to the NMT MN module, which identifies the missing CNs immediately
+instead of waiting for the next IdentRequest interval.
+
+\param  fLinkUp_p           TRUE if the link is up, FALSE if it is down.
+*/
+//------------------------------------------------------------------------------
+void dllk_cbLinkChange(BOOL fLinkUp_p)
+{
+#if defined(CONFIG_INCLUDE_NMT_MN)
+    tOplkError      ret;
+    tEvent          event;
+    UINT32          arg;
+#else
+    UNUSED_PARAMETER(fLinkUp_p);
+#endif
+
+    DEBUG_LVL_DLL_TRACE("%s() link %s\n", __func__, (fLinkUp_p != FALSE) ? "up" : "down");
+
+#if defined(CONFIG_INCLUDE_NMT_MN)
+    if ((fLinkUp_p == FALSE) || (dllkInstance_g.nmtState < kNmtMsNotActive))
+        return;
+
+    event.eventSink = kEventSinkNmtMnu;
+    event.eventType = kEventTypeNmtMnuLinkUp;
+    event.eventArgSize = 0;
+    event.pEventArg = NULL;
+    ret = eventk_postEvent(&event);
+    if (ret != kErrorOk)
+    {
+        arg = dllkInstance_g.dllState;
+        // Error event for API layer
+        eventk_postError(kEventSourceDllk, ret, sizeof(arg), &arg);
+    }
+#endif
+}
+#endif
+
 #if CONFIG_TIMER_USE_HIGHRES != FALSE
 //------------------------------------------------------------------------------
 /**
@@ -958,6 +1192,10 @@ Exit:
 This function is called by the timer module. It monitors the POWERLINK cycle
 when running as CN.
 
+With CONFIG_DLL_SOC_WATCHDOG the timer is periodic and the function checks the
+time of the last SoC. A frame timeout is reported once per cycle length after
+the frame timeout has elapsed, like by the restarted timer otherwise.
+
 \param  pEventArg_p         Pointer to timer event argument.
 
 \return The function returns a tOplkError error code.
@@ -968,6 +1206,9 @@ tOplkError dllk_cbCnTimer(tTimerEventArg* pEventArg_p)
     tOplkError      ret = kErrorOk;
     tNmtState       nmtState;
     UINT32          arg;
+#if (CONFIG_DLL_SOC_WATCHDOG != FALSE)
+    UINT64          now;
+#endif
 
     TGT_DLLK_DECLARE_FLAGS;
 
@@ -982,6 +1223,19 @@ tOplkError dllk_cbCnTimer(tTimerEventArg* pEventArg_p)
     if (nmtState <= kNmtGsResetConfiguration)
         goto Exit;
 
+#if (CONFIG_DLL_SOC_WATCHDOG != FALSE)
+    now = target_getCurrentTimestamp();
+    while ((dllkInstance_g.frameTimeout != 0) &&
+           ((now - dllkInstance_g.lastSocTime) >= dllkInstance_g.frameTimeout))
+    {
+        ret = dllk_changeState(kNmtEventDllCeFrameTimeout, nmtState);
+        if (ret != kErrorOk)
+            goto Exit;
+
+        // report further loss of SoC after one more cycle
+        dllkInstance_g.lastSocTime += 1000ULL * dllkInstance_g.dllConfigParam.cycleLen;
+    }
+#else
     ret = dllk_changeState(kNmtEventDllCeFrameTimeout, nmtState);
     if (ret != kErrorOk)
         goto Exit;
@@ -991,6 +1245,7 @@ tOplkError dllk_cbCnTimer(tTimerEventArg* pEventArg_p)
                dllkInstance_g.dllConfigParam.cycleLen, dllk_cbCnTimer, 0L, FALSE);
     if (ret != kErrorOk)
         goto Exit;
+#endif
 
 Exit:
     if (ret != kErrorOk)
@@ -1003,6 +1258,69 @@ Exit:
     TGT_DLLK_LEAVE_CRITICAL_SECTION();
     return ret;
 }
+
+#if (CONFIG_DLL_SOC_WATCHDOG != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Feed the loss of SoC watchdog
+
+The function is called on every received SoC on a CN. It only stores the time
+of the SoC, which is checked by the periodic cycle timer, so the timer need
+not be reprogrammed on every cycle. The cycle timer is started with the first
+SoC after it was deleted.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+tOplkError dllk_feedSocWatchdog(void)
+{
+    UINT64          period;
+
+    dllkInstance_g.lastSocTime = target_getCurrentTimestamp();
+
+    if (dllkInstance_g.timerHdlCycle != 0)
+        return kErrorOk;
+
+    period = (CONFIG_DLL_SOC_WATCHDOG_PERIOD_US != 0) ? (1000ULL * CONFIG_DLL_SOC_WATCHDOG_PERIOD_US) :
+                                                        (1000ULL * dllkInstance_g.dllConfigParam.cycleLen);
+    return hrestimer_modifyTimer(&dllkInstance_g.timerHdlCycle, period, dllk_cbCnTimer, 0L, TRUE);
+}
+#endif
+#endif
+
+#if (CONFIG_DLL_PRES_LATE_BINDING != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  CN PRes fill timer callback function
+
+This function is called by the timer module. The timer is started on SoC
+reception and expires the lead time before the expected PReq. The function
+triggers the deferred fill of the PRes.
+
+\param  pEventArg_p             Pointer to timer event argument.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+tOplkError dllk_cbCnTimerPresFill(tTimerEventArg* pEventArg_p)
+{
+    tOplkError      ret = kErrorOk;
+
+    TGT_DLLK_DECLARE_FLAGS;
+
+    TGT_DLLK_ENTER_CRITICAL_SECTION();
+
+    if (pEventArg_p->timerHdl == dllkInstance_g.timerHdlPresFill)
+    {   // no zombie callback
+        dllkInstance_g.presFillTimeNs = target_getCurrentTimestamp();
+        dllkInstance_g.fPresFillExpired = TRUE;
+        if (dllkInstance_g.fPresFillPending)
+            ret = dllk_postEvent(kEventTypeDllkPresFill);
+    }
+
+    TGT_DLLK_LEAVE_CRITICAL_SECTION();
+    return ret;
+}
 #endif
 
 #if (CONFIG_DLL_PROCESS_SYNC == DLL_PROCESS_SYNC_ON_TIMER)
@@ -1095,10 +1413,25 @@ tOplkError dllk_setupLocalNode(tNmtState nmtState_p)
     dllkInstance_g.mnFlag1 = 0;
     dllkInstance_g.flag2 = 0;
 
+#if NMT_MAX_NODE_ID > 0
+    // forward first StatusResponse of each node after reset
+    OPLK_MEMSET(dllkInstance_g.aStatusResSignature, 0,
+                sizeof(dllkInstance_g.aStatusResSignature));
+#endif
+
 #if defined(CONFIG_INCLUDE_NMT_MN)
-    // initialize linked node list
-    dllkInstance_g.pFirstNodeInfo = NULL;
-    dllkInstance_g.pFirstPrcNodeInfo = NULL;
+    // initialize arrays of isochronous nodes
+    nodeset_clear(&dllkInstance_g.isochrNodeSet);
+    dllkInstance_g.isochrNodeCount = 0;
+    dllkInstance_g.prcNodeCount = 0;
+
+    // initialize node-ID lists and their lookup tables
+    dllkInstance_g.aCnNodeIdList[0][0] = C_ADR_INVALID;
+    dllkInstance_g.aCnNodeIdList[1][0] = C_ADR_INVALID;
+    OPLK_MEMSET(dllkInstance_g.aCnNodeIndex, DLLK_NODE_INDEX_INVALID, sizeof(dllkInstance_g.aCnNodeIndex));
+    nodeset_clear(&dllkInstance_g.aCnNodeSet[0]);
+    nodeset_clear(&dllkInstance_g.aCnNodeSet[1]);
+    nodeset_clear(&dllkInstance_g.cnHandledSet);
 #endif
 
     /*-----------------------------------------------------------------------*/
@@ -1283,6 +1616,10 @@ tOplkError dllk_setupLocalNodeMn(void)
             if (ret != kErrorOk)
                 return ret;
             pIntNodeInfo->pPreqTxBuffer = &dllkInstance_g.pTxBuffer[handle];
+#if (CONFIG_CYCLE_STATISTICS != FALSE) || (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE)
+            pIntNodeInfo->pPreqTxBuffer[0].pfnTxHandler = dllk_processTransmittedPreq;
+            pIntNodeInfo->pPreqTxBuffer[1].pfnTxHandler = dllk_processTransmittedPreq;
+#endif
         }
     }
 
@@ -1387,6 +1724,16 @@ tOplkError dllk_setupLocalNodeCn(void)
     dllkInstance_g.syncReqPrevNodeId = 0;
 #endif
 
+#if (CONFIG_DLL_PRES_LATE_BINDING != FALSE)
+    // the PReq offset is measured again for the new configuration
+    dllkInstance_g.preqOffsetNs = 0;
+    dllkInstance_g.presFillDurationNs = 0;
+    dllkInstance_g.fPresFillTimer = FALSE;
+    dllkInstance_g.fPresFillExpired = FALSE;
+    dllkInstance_g.fPresFillPending = FALSE;
+    dllkInstance_g.presFillMissCount = 0;
+#endif
+
     return ret;
 }
 
@@ -1431,6 +1778,14 @@ tOplkError dllk_cleanupLocalNode(tNmtState oldNmtState_p)
         return ret;
 #endif
 
+#if (CONFIG_DLL_PRES_LATE_BINDING != FALSE)
+    if ((ret = hrestimer_deleteTimer(&dllkInstance_g.timerHdlPresFill)) != kErrorOk)
+        return ret;
+
+    dllkInstance_g.fPresFillTimer = FALSE;
+    dllkInstance_g.fPresFillPending = FALSE;
+#endif
+
 #if defined(CONFIG_INCLUDE_NMT_MN)
     if ((ret = edrvcyclic_stopCycle()) != kErrorOk)
         return ret;
@@ -1489,6 +1844,7 @@ tOplkError dllk_cleanupLocalNode(tNmtState oldNmtState_p)
             // disable PReq and PRes for this node
             dllkInstance_g.aNodeInfo[index].preqPayloadLimit = 0;
             dllkInstance_g.aNodeInfo[index].presPayloadLimit = 0;
+            dllkInstance_g.aNodeInfo[index].presFrameSizeLimit = PLK_FRAME_OFFSET_PDO_PAYLOAD;
         }
     }
     else
@@ -1497,6 +1853,7 @@ tOplkError dllk_cleanupLocalNode(tNmtState oldNmtState_p)
         {
             // disable PReq and PRes for this node
             dllkInstance_g.aNodeInfo[index].presPayloadLimit = 0;
+            dllkInstance_g.aNodeInfo[index].presFrameSizeLimit = PLK_FRAME_OFFSET_PDO_PAYLOAD;
             dllkInstance_g.aNodeInfo[index].preqPayloadLimit = 0;
         }
     }
@@ -1507,6 +1864,7 @@ tOplkError dllk_cleanupLocalNode(tNmtState oldNmtState_p)
     {
         // disable PRes for this node
         dllkInstance_g.aNodeInfo[index].presPayloadLimit = 0;
+        dllkInstance_g.aNodeInfo[index].presFrameSizeLimit = PLK_FRAME_OFFSET_PDO_PAYLOAD;
     }
 #endif
 
@@ -1549,6 +1907,186 @@ tDllkNodeInfo* dllk_getNodeInfo(UINT nodeId_p)
 }
 #endif // NMT_MAX_NODE_ID > 0
 
+#if (CONFIG_DLL_RUNTIME_CYCLE_CHANGE != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Announce a new cycle length
+
+The function is called if the cycle length is configured while the node
+communicates. The new cycle length is applied at the next cycle boundary by
+dllk_switchCycleLenMn() on an MN and dllk_switchCycleLenCn() on a CN.
+
+A CN widens its loss of SoC monitoring to the longer of both cycle lengths
+until it receives the first SoC of the new cycle length. Therefore, the new
+cycle length must be written to the CNs before it is written to the MN.
+
+\param  cycleLen_p          New cycle length in [us].
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError announceCycleLen(UINT32 cycleLen_p)
+{
+    tOplkError  ret = kErrorOk;
+    UINT32      maxCycleLen;
+
+    if (cycleLen_p == 0)
+        return kErrorDllInvalidParam;
+
+    if (cycleLen_p == dllkInstance_g.dllConfigParam.cycleLen)
+    {   // no change or pending change withdrawn
+        dllkInstance_g.newCycleLen = 0;
+        return kErrorOk;
+    }
+
+    dllkInstance_g.newCycleLen = cycleLen_p;
+
+    if (dllkInstance_g.nmtState < kNmtMsNotActive)
+    {   // CN: the SoC of the new cycle length must not be detected as lost
+        maxCycleLen = (cycleLen_p > dllkInstance_g.dllConfigParam.cycleLen) ?
+                      cycleLen_p : dllkInstance_g.dllConfigParam.cycleLen;
+
+        if (dllkInstance_g.frameTimeout != 0)
+        {
+            dllkInstance_g.frameTimeout = (1000LL * ((UINT64)maxCycleLen)) +
+                ((UINT64)dllkInstance_g.dllConfigParam.lossOfFrameTolerance);
+        }
+
+#if (CONFIG_DLL_PROCESS_SYNC == DLL_PROCESS_SYNC_ON_TIMER)
+        ret = synctimer_setLossOfSyncTolerance(dllkInstance_g.dllConfigParam.lossOfFrameTolerance +
+                                               ((maxCycleLen - dllkInstance_g.dllConfigParam.cycleLen) * 1000));
+#endif
+    }
+
+    return ret;
+}
+
+#if defined(CONFIG_INCLUDE_NMT_MN)
+//------------------------------------------------------------------------------
+/**
+\brief  Switch to the announced cycle length on the MN
+
+The function is called while the frames of the next cycle are prepared. If a
+new cycle length is announced, it is applied to the next cycle if it starts a
+multiplexed cycle. The cyclic Edrv and the relative time of the SoC use the new
+cycle length from that cycle on, so the CNs can detect the change by the
+relative time of the following SoC.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+tOplkError dllk_switchCycleLenMn(void)
+{
+    tOplkError  ret;
+
+    if (dllkInstance_g.newCycleLen == 0)
+        return kErrorOk;
+
+    if ((dllkInstance_g.dllConfigParam.multipleCycleCnt > 0) &&
+        (((dllkInstance_g.cycleCount + 1) % dllkInstance_g.dllConfigParam.multipleCycleCnt) != 0))
+        return kErrorOk;    // wait for the start of the next multiplexed cycle
+
+    ret = edrvcyclic_setCycleTime(dllkInstance_g.newCycleLen);
+    if (ret != kErrorOk)
+        return ret;
+
+    dllkInstance_g.dllConfigParam.cycleLen = dllkInstance_g.newCycleLen;
+    dllkInstance_g.newCycleLen = 0;
+    dllkInstance_g.frameTimeout = 1000LL * ((UINT64)dllkInstance_g.dllConfigParam.cycleLen);
+
+    return kErrorOk;
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief  Switch to the announced cycle length on the CN
+
+The function is called on every received SoC. If a new cycle length is
+announced and the relative time of the SoC advanced by the new cycle length,
+the MN has switched the cycle length. The frame timeout and the sync timer are
+then set up for the new cycle length, so the sync timer locks to it again.
+
+\param  relativeTime_p      Relative time of the received SoC in [us].
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+tOplkError dllk_switchCycleLenCn(UINT64 relativeTime_p)
+{
+    tOplkError  ret = kErrorOk;
+    UINT64      lastRelativeTime;
+
+    lastRelativeTime = dllkInstance_g.socRelativeTime;
+    dllkInstance_g.socRelativeTime = relativeTime_p;
+
+    if ((dllkInstance_g.newCycleLen == 0) || (lastRelativeTime == 0) ||
+        ((relativeTime_p - lastRelativeTime) != dllkInstance_g.newCycleLen))
+        return kErrorOk;
+
+    dllkInstance_g.dllConfigParam.cycleLen = dllkInstance_g.newCycleLen;
+    dllkInstance_g.newCycleLen = 0;
+
+    if (dllkInstance_g.frameTimeout != 0)
+    {
+        dllkInstance_g.frameTimeout = (1000LL * ((UINT64)dllkInstance_g.dllConfigParam.cycleLen)) +
+            ((UINT64)dllkInstance_g.dllConfigParam.lossOfFrameTolerance);
+    }
+
+#if (CONFIG_DLL_PROCESS_SYNC == DLL_PROCESS_SYNC_ON_TIMER)
+    ret = synctimer_setCycleLen(dllkInstance_g.dllConfigParam.cycleLen);
+    if (ret != kErrorOk)
+        return ret;
+
+    ret = synctimer_setLossOfSyncTolerance(dllkInstance_g.dllConfigParam.lossOfFrameTolerance);
+#endif
+
+    return ret;
+}
+#endif
+
+#if (CONFIG_DLL_SOC_TIME_INFO != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Update the SoC time information
+
+The function stores the NetTime and RelativeTime of a SoC with its local time.
+The offset of the NetTime to the local time is smoothed by an exponential
+filter, which suppresses the jitter of the software time stamp. A change of
+the offset by more than DLLK_SOC_TIME_RESYNC_NS is a jump of the NetTime and
+the filter is restarted.
+
+\param  pSocFrame_p         Received or sent SoC frame.
+\param  localTime_p         Local time of the SoC in [ns].
+*/
+//------------------------------------------------------------------------------
+void dllk_updateSocTime(tPlkFrame* pSocFrame_p, UINT64 localTime_p)
+{
+    tSocTimeInfo*   pInfo = &dllkInstance_g.socTimeInfo;
+    INT64           sample;
+    INT64           diff;
+
+    pInfo->netTime.sec = ami_getUint32Le(&pSocFrame_p->data.soc.netTimeLe.sec);
+    pInfo->netTime.nsec = ami_getUint32Le(&pSocFrame_p->data.soc.netTimeLe.nsec);
+    pInfo->relativeTime = ami_getUint64Le(&pSocFrame_p->data.soc.relativeTimeLe);
+    pInfo->localTime = localTime_p;
+
+    sample = (INT64)(((UINT64)pInfo->netTime.sec * 1000000000ULL) + pInfo->netTime.nsec) -
+             (INT64)localTime_p;
+    diff = sample - pInfo->netTimeOffset;
+
+    if ((pInfo->socCount == 0) ||
+        (diff > DLLK_SOC_TIME_RESYNC_NS) || (diff < -DLLK_SOC_TIME_RESYNC_NS))
+        pInfo->netTimeOffset = sample;
+    else
+        pInfo->netTimeOffset += diff >> DLLK_SOC_TIME_FILTER_SHIFT;
+
+    pInfo->socCount++;
+    if (pInfo->socCount == 0)
+        pInfo->socCount = 1;    // 0 is reserved for "no SoC yet"
+}
+#endif
+
 
 #if defined(CONFIG_INCLUDE_NMT_MN)
 //------------------------------------------------------------------------------
@@ -1565,21 +2103,17 @@ This function adds a node to the isochronous phase.
 tOplkError dllk_addNodeIsochronous(tDllkNodeInfo* pIntNodeInfo_p)
 {
     tOplkError          ret = kErrorOk;
-    tDllkNodeInfo**     ppIntNodeInfo;
     tPlkFrame *         pTxFrame;
 
+    if (NODESET_CONTAINS(&dllkInstance_g.isochrNodeSet, pIntNodeInfo_p->nodeId))
+    {   // node was already added
+        // $$$ d.k. maybe this should be an error
+        goto Exit;
+    }
+
     if (pIntNodeInfo_p->nodeId == dllkInstance_g.dllConfigParam.nodeId)
     {   // we shall send PRes ourself
-        // insert our node as first entry in the list
-        ppIntNodeInfo = &dllkInstance_g.pFirstNodeInfo;
-        if (*ppIntNodeInfo != NULL)
-        {
-            if ((*ppIntNodeInfo)->nodeId == pIntNodeInfo_p->nodeId)
-            {   // node was already added to list
-                // $$$ d.k. maybe this should be an error
-                goto Exit;
-            }
-        }
+        // our node is sorted as first entry of the isochronous nodes
         // set "PReq"-TxBuffer to PRes-TxBuffer
         pIntNodeInfo_p->pPreqTxBuffer = &dllkInstance_g.pTxBuffer[DLLK_TXFRAME_PRES];
 
@@ -1589,29 +2123,6 @@ tOplkError dllk_addNodeIsochronous(tDllkNodeInfo* pIntNodeInfo_p)
     }
     else
     {   // normal CN shall be added to isochronous phase
-        // insert node into list in ascending order
-        if (pIntNodeInfo_p->pPreqTxBuffer == NULL)
-        {
-            ppIntNodeInfo = &dllkInstance_g.pFirstPrcNodeInfo;
-        }
-        else
-        {
-            ppIntNodeInfo = &dllkInstance_g.pFirstNodeInfo;
-        }
-
-        while ((*ppIntNodeInfo != NULL) &&
-               (((*ppIntNodeInfo)->nodeId < pIntNodeInfo_p->nodeId) ||
-               ((*ppIntNodeInfo)->nodeId == dllkInstance_g.dllConfigParam.nodeId)))
-        {
-            ppIntNodeInfo = &(*ppIntNodeInfo)->pNextNodeInfo;
-        }
-
-        if ((*ppIntNodeInfo != NULL) && ((*ppIntNodeInfo)->nodeId == pIntNodeInfo_p->nodeId))
-        {   // node was already added to list
-            // $$$ d.k. maybe this should be an error
-            goto Exit;
-        }
-
         if (pIntNodeInfo_p->pPreqTxBuffer != NULL)
         {   // TxBuffer entry exists
             tEvent          event;
@@ -1645,9 +2156,12 @@ tOplkError dllk_addNodeIsochronous(tDllkNodeInfo* pIntNodeInfo_p)
     pIntNodeInfo_p->fSoftDelete = FALSE;
     pIntNodeInfo_p->nmtState = kNmtCsNotActive;
     pIntNodeInfo_p->dllErrorEvents = 0L;
-    // add node to list
-    pIntNodeInfo_p->pNextNodeInfo = *ppIntNodeInfo;
-    *ppIntNodeInfo = pIntNodeInfo_p;
+    // add node to the array in ascending order
+    NODESET_ADD(&dllkInstance_g.isochrNodeSet, pIntNodeInfo_p->nodeId);
+    if (pIntNodeInfo_p->pPreqTxBuffer == NULL)
+        insertNodeArray(dllkInstance_g.apPrcNodeInfo, &dllkInstance_g.prcNodeCount, pIntNodeInfo_p);
+    else
+        insertNodeArray(dllkInstance_g.apIsochrNodeInfo, &dllkInstance_g.isochrNodeCount, pIntNodeInfo_p);
 
 Exit:
     return ret;
@@ -1667,44 +2181,31 @@ This function removes a node from the isochronous phase.
 tOplkError dllk_deleteNodeIsochronous(tDllkNodeInfo* pIntNodeInfo_p)
 {
     tOplkError          ret = kErrorOk;
-    tDllkNodeInfo**     ppIntNodeInfo;
-    tPlkFrame *         pTxFrame;
 
-    if (pIntNodeInfo_p->pPreqTxBuffer == NULL)
-    {
-        ppIntNodeInfo = &dllkInstance_g.pFirstPrcNodeInfo;
-    }
-    else
-    {
-        ppIntNodeInfo = &dllkInstance_g.pFirstNodeInfo;
-    }
-    // search node in whole list
-    while ((*ppIntNodeInfo != NULL) && (*ppIntNodeInfo != pIntNodeInfo_p))
-    {
-        ppIntNodeInfo = &(*ppIntNodeInfo)->pNextNodeInfo;
-    }
-    if ((*ppIntNodeInfo == NULL) || (*ppIntNodeInfo != pIntNodeInfo_p))
-    {   // node was not found in list
+    if (!NODESET_CONTAINS(&dllkInstance_g.isochrNodeSet, pIntNodeInfo_p->nodeId))
+    {   // node was not added
         // $$$ d.k. maybe this should be an error
         return ret;
     }
 
-    // remove node from list
-    *ppIntNodeInfo = pIntNodeInfo_p->pNextNodeInfo;
+    // remove node from array
+    NODESET_REMOVE(&dllkInstance_g.isochrNodeSet, pIntNodeInfo_p->nodeId);
+    if (pIntNodeInfo_p->pPreqTxBuffer == NULL)
+        removeNodeArray(dllkInstance_g.apPrcNodeInfo, &dllkInstance_g.prcNodeCount, pIntNodeInfo_p);
+    else
+        removeNodeArray(dllkInstance_g.apIsochrNodeInfo, &dllkInstance_g.isochrNodeCount, pIntNodeInfo_p);
     if (pIntNodeInfo_p->pPreqTxBuffer != NULL)
     {   // disable TPDO
-        pTxFrame = (tPlkFrame*)pIntNodeInfo_p->pPreqTxBuffer[0].pBuffer;
-        if (pTxFrame != NULL)
+        if (pIntNodeInfo_p->pPreqTxBuffer[0].pBuffer != NULL)
         {   // frame does exist
             // update frame (disable RD in Flag1)
-            ami_setUint8Le(&pTxFrame->data.preq.flag1, 0);
+            dllk_patchFrame(&pIntNodeInfo_p->pPreqTxBuffer[0], DLLK_FRAME_FIELD_FLAG1, 0);
         }
 
-        pTxFrame = (tPlkFrame *) pIntNodeInfo_p->pPreqTxBuffer[1].pBuffer;
-        if (pTxFrame != NULL)
+        if (pIntNodeInfo_p->pPreqTxBuffer[1].pBuffer != NULL)
         {   // frame does exist
             // update frame (disable RD in Flag1)
-            ami_setUint8Le(&pTxFrame->data.preq.flag1, 0);
+            dllk_patchFrame(&pIntNodeInfo_p->pPreqTxBuffer[1], DLLK_FRAME_FIELD_FLAG1, 0);
         }
     }
     return ret;
@@ -2030,6 +2531,16 @@ tOplkError dllk_setupSyncPhase(tNmtState nmtState_p, BOOL fReadyFlag_p,
     tFrameInfo          FrameInfo;
     tDllkNodeInfo*      pIntNodeInfo;
     BYTE                flag1;
+    UINT8*              pCnNodeIndex;
+    UINT                nodeIndex;
+    UINT                prcIndex;
+    UINT                multiplCycle = 0;
+
+    // determine the multiplexed cycle which is set up (1 .. MultiplCycleCnt)
+    if (dllkInstance_g.dllConfigParam.multipleCycleCnt > 0)
+    {
+        multiplCycle = ((dllkInstance_g.cycleCount + 1) % dllkInstance_g.dllConfigParam.multipleCycleCnt) + 1;
+    }
 
     // calculate WaitSoCPReq delay
     if (dllkInstance_g.dllConfigParam.waitSocPreq != 0)
@@ -2043,23 +2554,44 @@ tOplkError dllk_setupSyncPhase(tNmtState nmtState_p, BOOL fReadyFlag_p,
     }
 
     pCnNodeId = &dllkInstance_g.aCnNodeIdList[nextTxBufferOffset_p][0];
+    pCnNodeIndex = &dllkInstance_g.aCnNodeIndex[nextTxBufferOffset_p][0];
+
+    // remove the nodes of the previous list from the lookup table
+    for (; *pCnNodeId != C_ADR_INVALID; pCnNodeId++)
+    {
+        pCnNodeIndex[*pCnNodeId] = DLLK_NODE_INDEX_INVALID;
+    }
+    pCnNodeId = &dllkInstance_g.aCnNodeIdList[nextTxBufferOffset_p][0];
+    nodeset_clear(&dllkInstance_g.aCnNodeSet[nextTxBufferOffset_p]);
 
     if (nmtState_p != kNmtMsOperational)
         fReadyFlag_p = FALSE;
 
-    pIntNodeInfo = dllkInstance_g.pFirstNodeInfo;
-    while (pIntNodeInfo != NULL)
+    for (nodeIndex = 0; nodeIndex < dllkInstance_g.isochrNodeCount; nodeIndex++)
     {
+        pIntNodeInfo = dllkInstance_g.apIsochrNodeInfo[nodeIndex];
+        if ((multiplCycle != 0) && (pIntNodeInfo->multiplCycleAssign != 0) &&
+            (pIntNodeInfo->multiplCycleAssign != multiplCycle))
+        {   // multiplexed CN is not polled in this cycle
+            continue;
+        }
+
         pTxBuffer = &pIntNodeInfo->pPreqTxBuffer[nextTxBufferOffset_p];
         if ((pTxBuffer != NULL) && (pTxBuffer->pBuffer != NULL))
         {   // PReq does exist
             pTxFrame = (tPlkFrame*)pTxBuffer->pBuffer;
 
-            flag1 = pIntNodeInfo->soaFlag1 & PLK_FRAME_FLAG1_EA;
+            // keep RD flag, it is maintained by the TPDO processing
+            flag1 = (pIntNodeInfo->soaFlag1 & PLK_FRAME_FLAG1_EA) |
+                    (ami_getUint8Le(&pTxFrame->data.preq.flag1) & PLK_FRAME_FLAG1_RD);
+
+            if ((multiplCycle != 0) && (pIntNodeInfo->multiplCycleAssign != 0))
+            {   // CN is accessed in a multiplexed slot
+                flag1 |= PLK_FRAME_FLAG1_MS;
+            }
 
-            // $$$ d.k. set PLK_FRAME_FLAG1_MS if necessary
             // update frame (Flag1)
-            ami_setUint8Le(&pTxFrame->data.preq.flag1, flag1);
+            dllk_patchFrame(pTxBuffer, DLLK_FRAME_FIELD_FLAG1, flag1);
 
             // process TPDO
             FrameInfo.pFrame = pTxFrame;
@@ -2075,30 +2607,29 @@ tOplkError dllk_setupSyncPhase(tNmtState nmtState_p, BOOL fReadyFlag_p,
             if (pTxBuffer == &dllkInstance_g.pTxBuffer[DLLK_TXFRAME_PRES + nextTxBufferOffset_p])
             {   // PRes of MN will be sent
                 // update NMT state
-                ami_setUint8Le(&pTxFrame->data.pres.nmtStatus, (BYTE) nmtState_p);
+                dllk_patchFrame(pTxBuffer, DLLK_FRAME_FIELD_NMTSTATUS, (UINT8)nmtState_p);
 
                 *pNextTimeOffsetNs_p = pIntNodeInfo->presTimeoutNs;
+                for (prcIndex = 0; prcIndex < dllkInstance_g.prcNodeCount; prcIndex++)
                 {
-                    tDllkNodeInfo*   pIntPrcNodeInfo;
-
-                    pIntPrcNodeInfo = dllkInstance_g.pFirstPrcNodeInfo;
-                    while (pIntPrcNodeInfo != NULL)
-                    {
-                        *pCnNodeId = (BYTE)pIntPrcNodeInfo->nodeId;
-                        pCnNodeId++;
-                        *pNextTimeOffsetNs_p = pIntNodeInfo->presTimeoutNs;
-                        pIntPrcNodeInfo = pIntPrcNodeInfo->pNextNodeInfo;
-                    }
-
-                    *pCnNodeId = C_ADR_BROADCAST;    // mark this entry as PRC slot finished
+                    *pCnNodeId = (BYTE)dllkInstance_g.apPrcNodeInfo[prcIndex]->nodeId;
+                    pCnNodeIndex[*pCnNodeId] = (UINT8)(pCnNodeId - &dllkInstance_g.aCnNodeIdList[nextTxBufferOffset_p][0]);
+                    NODESET_ADD(&dllkInstance_g.aCnNodeSet[nextTxBufferOffset_p], *pCnNodeId);
                     pCnNodeId++;
+                    *pNextTimeOffsetNs_p = pIntNodeInfo->presTimeoutNs;
                 }
+
+                *pCnNodeId = C_ADR_BROADCAST;    // mark this entry as PRC slot finished
+                pCnNodeIndex[C_ADR_BROADCAST] = (UINT8)(pCnNodeId - &dllkInstance_g.aCnNodeIdList[nextTxBufferOffset_p][0]);
+                pCnNodeId++;
             }
             else
             {   // PReq to CN
                 *pCnNodeId = (BYTE)pIntNodeInfo->nodeId;
+                pCnNodeIndex[*pCnNodeId] = (UINT8)(pCnNodeId - &dllkInstance_g.aCnNodeIdList[nextTxBufferOffset_p][0]);
+                NODESET_ADD(&dllkInstance_g.aCnNodeSet[nextTxBufferOffset_p], *pCnNodeId);
                 pCnNodeId++;
-                *pNextTimeOffsetNs_p = pIntNodeInfo->presTimeoutNs;
+                *pNextTimeOffsetNs_p = DLLK_PRES_TIMEOUT_NS(pIntNodeInfo);
             }
 
             if (nextTimeOffsetNs == 0)
@@ -2112,8 +2643,6 @@ tOplkError dllk_setupSyncPhase(tNmtState nmtState_p, BOOL fReadyFlag_p,
                 accFrameLenNs = 0;
             }
         }
-
-        pIntNodeInfo = pIntNodeInfo->pNextNodeInfo;
     }
     *pCnNodeId = C_ADR_INVALID;    // mark last entry in node-ID list
 
@@ -2121,5 +2650,96 @@ tOplkError dllk_setupSyncPhase(tNmtState nmtState_p, BOOL fReadyFlag_p,
 }
 #endif
 
+#if defined(CONFIG_INCLUDE_NMT_MN)
+//------------------------------------------------------------------------------
+/**
+\brief  Find the position of a node in an array of isochronous nodes
+
+The function searches the sorted array by bisection. The own node of the MN
+is sorted before all CNs, because it sends its PRes first.
+
+\param  apNodeInfo_p        Array of isochronous or PRC nodes.
+\param  count_p             Number of nodes in the array.
+\param  nodeId_p            Node ID to search.
+
+\return The function returns the index of the first node which is not sorted
+        before the specified node.
+*/
+//------------------------------------------------------------------------------
+static UINT findNodeArrayIndex(tDllkNodeInfo** apNodeInfo_p, UINT count_p, UINT nodeId_p)
+{
+    UINT    ownNodeId = dllkInstance_g.dllConfigParam.nodeId;
+    UINT    lower = 0;
+    UINT    upper = count_p;
+    UINT    middle;
+    UINT    key;
+
+    if (nodeId_p == ownNodeId)
+        return 0;
+
+    while (lower < upper)
+    {
+        middle = (lower + upper) / 2;
+        key = apNodeInfo_p[middle]->nodeId;
+        if ((key == ownNodeId) || (key < nodeId_p))
+            lower = middle + 1;
+        else
+            upper = middle;
+    }
+
+    return lower;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Insert a node into an array of isochronous nodes
+
+The function inserts the node at its position in the sorted array. The arrays
+are used for setting up the isochronous phase in each cycle, so adding a node
+during operation only moves the pointers behind it instead of rebuilding the
+array.
+
+\param  apNodeInfo_p        Array of isochronous or PRC nodes.
+\param  pCount_p            Pointer to the number of nodes in the array.
+\param  pIntNodeInfo_p      Pointer to internal node info structure.
+*/
+//------------------------------------------------------------------------------
+static void insertNodeArray(tDllkNodeInfo** apNodeInfo_p, UINT* pCount_p, tDllkNodeInfo* pIntNodeInfo_p)
+{
+    UINT    index;
+
+    if (*pCount_p >= NMT_MAX_NODE_ID)
+        return;
+
+    index = findNodeArrayIndex(apNodeInfo_p, *pCount_p, pIntNodeInfo_p->nodeId);
+    OPLK_MEMMOVE(&apNodeInfo_p[index + 1], &apNodeInfo_p[index],
+                 (*pCount_p - index) * sizeof(*apNodeInfo_p));
+    apNodeInfo_p[index] = pIntNodeInfo_p;
+    (*pCount_p)++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Remove a node from an array of isochronous nodes
+
+\param  apNodeInfo_p        Array of isochronous or PRC nodes.
+\param  pCount_p            Pointer to the number of nodes in the array.
+\param  pIntNodeInfo_p      Pointer to internal node info structure.
+*/
+//------------------------------------------------------------------------------
+static void removeNodeArray(tDllkNodeInfo** apNodeInfo_p, UINT* pCount_p, tDllkNodeInfo* pIntNodeInfo_p)
+{
+    UINT    index;
+
+    index = findNodeArrayIndex(apNodeInfo_p, *pCount_p, pIntNodeInfo_p->nodeId);
+    if ((index >= *pCount_p) || (apNodeInfo_p[index] != pIntNodeInfo_p))
+        return;
+
+    (*pCount_p)--;
+    OPLK_MEMMOVE(&apNodeInfo_p[index], &apNodeInfo_p[index + 1],
+                 (*pCount_p - index) * sizeof(*apNodeInfo_p));
+}
+#endif
+
 ///\}
 
@@ -52,6 +52,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define DLLCAL_CIRCBUF_SIZE_TX_NMT   32767
 #define DLLCAL_CIRCBUF_SIZE_TX_GEN   32767
 #define DLLCAL_CIRCBUF_SIZE_TX_SYNC  8192
+#define DLLCAL_CIRCBUF_SIZE_TX_VETH  CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH
 
 //------------------------------------------------------------------------------
 // module global vars
@@ -111,7 +112,9 @@ static tDllCalFuncIntf funcintf_l =
     insertDataBlock,
     getDataBlock,
     getDataBlockCount,
-    resetDataBlockQueue
+    resetDataBlockQueue,
+    NULL,
+    NULL
 };
 
 //============================================================================//
@@ -187,6 +190,11 @@ static tOplkError addInstance(tDllCalQueueInstance* ppDllCalQueue_p,
                                       &pDllCalCircbufInstance->pCircBufInstance);
             break;
 
+        case kDllCalQueueTxVeth:
+            circError = circbuf_alloc(CIRCBUF_DLLCAL_TXVETH, DLLCAL_CIRCBUF_SIZE_TX_VETH,
+                                      &pDllCalCircbufInstance->pCircBufInstance);
+            break;
+
         default:
             ret = kErrorInvalidInstanceParam;
             break;
@@ -47,6 +47,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <kernel/dllk.h>
 
 #include <kernel/eventk.h>
+#include <common/metrics.h>
 
 #ifdef CONFIG_INCLUDE_NMT_MN
 #include <common/circbuffer.h>
@@ -96,11 +97,23 @@ typedef struct
     tDllCalFuncIntf*        pTxNmtFuncs;
     tDllCalFuncIntf*        pTxGenFuncs;
 
+#if (CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH != 0)
+    tDllCalQueueInstance    dllCalQueueTxVeth;      ///< Dll Cal Queue instance for virtual Ethernet frames
+    tDllCalFuncIntf*        pTxVethFuncs;
+#endif
+
 #if defined(CONFIG_INCLUDE_NMT_MN)
     tDllCalQueueInstance    dllCalQueueTxSync;      ///< Dll Cal Queue instance for Sync Request
     tDllCalFuncIntf*        pTxSyncFuncs;
 #endif
     tDllkCalStatistics      statistics;
+#if (CONFIG_METRICS != FALSE)
+    tMetric*                pMetricAsndRxFrames;    ///< Metric of the ASnd frames forwarded to the user layer
+    tMetric*                pMetricAsndRxErrors;    ///< Metric of the ASnd frames which could not be forwarded
+    tMetric*                pMetricTxQueueNmt;      ///< Metric of the fill level of the NMT Tx queue
+    tMetric*                pMetricTxQueueGen;      ///< Metric of the distribution of the fill level of the generic Tx queue
+    tMetric*                pMetricVethTxDrops;     ///< Metric of the dropped virtual Ethernet frames
+#endif
 
 #if defined(CONFIG_INCLUDE_NMT_MN)
     // IdentRequest queue with CN node IDs
@@ -111,11 +124,14 @@ typedef struct
     tCircBufInstance*       pQueueStatusReq;
 
     tCircBufInstance*       pQueueCnRequestNmt;
-    UINT                    aCnRequestCntNmt[254];
+    UINT                    aCnRequestCntNmt[NMT_MAX_NODE_ID];
     tCircBufInstance*       pQueueCnRequestGen;
-    UINT                    aCnRequestCntGen[254];
+    UINT                    aCnRequestCntGen[NMT_MAX_NODE_ID];
+    UINT                    aNodeWeight[NMT_MAX_NODE_ID];   ///< Max. number of requests queued per node at once
 
-    UINT                    nextRequestQueue;
+    UINT                    nextRequestQueue;       ///< SoA queue currently served
+    UINT                    aSoaWeight[kDllkCalSoaQueueCount];  ///< Slots per round for each SoA queue
+    UINT                    aSoaDeficit[kDllkCalSoaQueueCount]; ///< Slots left in the current round
 #endif
 } tDllkCalInstance;
 
@@ -128,7 +144,14 @@ static tDllkCalInstance     instance_l;
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
+#if (CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH != 0)
+static tOplkError insertVethFrame(tFrameInfo* pFrameInfo_p);
+#endif
+
 #if defined(CONFIG_INCLUDE_NMT_MN)
+static void resetSoaScheduler(void);
+static BOOL getQueueRequest(UINT queue_p, tDllReqServiceId* pReqServiceId_p,
+                            UINT* pNodeId_p, tSoaPayload* pSoaPayload_p);
 static BOOL getCnGenRequest(tDllReqServiceId* pReqServiceId_p, UINT* pNodeId_p);
 static BOOL getCnNmtRequest(tDllReqServiceId* pReqServiceId_p, UINT* pNodeId_p);
 static BOOL getMnGenNmtRequest(tDllReqServiceId* pReqServiceId_p, UINT* pNodeId_p);
@@ -158,13 +181,35 @@ tOplkError dllkcal_init(void)
     tOplkError      ret = kErrorOk;
 #if defined(CONFIG_INCLUDE_NMT_MN)
     tCircBufError   circErr;
+    UINT            index;
 #endif
 
     // reset instance structure
     OPLK_MEMSET(&instance_l, 0, sizeof (instance_l));
 
+    METRICS_REGISTER("dllkcal.asnd_rx_frames", kMetricTypeCounter, &instance_l.pMetricAsndRxFrames);
+    METRICS_REGISTER("dllkcal.asnd_rx_errors", kMetricTypeCounter, &instance_l.pMetricAsndRxErrors);
+    METRICS_REGISTER("dllkcal.tx_queue_nmt", kMetricTypeGauge, &instance_l.pMetricTxQueueNmt);
+    METRICS_REGISTER("dllkcal.tx_queue_gen", kMetricTypeHistogram, &instance_l.pMetricTxQueueGen);
+    METRICS_REGISTER("dllkcal.veth_tx_drops", kMetricTypeCounter, &instance_l.pMetricVethTxDrops);
+
+#if defined(CONFIG_INCLUDE_NMT_MN)
+    instance_l.aSoaWeight[kDllkCalSoaQueueCnGen] = CONFIG_DLLCAL_SOA_WEIGHT_CN_GEN;
+    instance_l.aSoaWeight[kDllkCalSoaQueueCnNmt] = CONFIG_DLLCAL_SOA_WEIGHT_CN_NMT;
+    instance_l.aSoaWeight[kDllkCalSoaQueueMnGenNmt] = CONFIG_DLLCAL_SOA_WEIGHT_MN_GEN_NMT;
+    instance_l.aSoaWeight[kDllkCalSoaQueueMnIdent] = CONFIG_DLLCAL_SOA_WEIGHT_MN_IDENT;
+    instance_l.aSoaWeight[kDllkCalSoaQueueMnStatus] = CONFIG_DLLCAL_SOA_WEIGHT_MN_STATUS;
+    instance_l.aSoaWeight[kDllkCalSoaQueueMnSync] = CONFIG_DLLCAL_SOA_WEIGHT_MN_SYNC;
+    for (index = 0; index < tabentries(instance_l.aNodeWeight); index++)
+        instance_l.aNodeWeight[index] = CONFIG_DLLCAL_SOA_NODE_WEIGHT;
+    resetSoaScheduler();
+#endif
+
     instance_l.pTxNmtFuncs = GET_DLLKCAL_INTERFACE();
     instance_l.pTxGenFuncs = GET_DLLKCAL_INTERFACE();
+#if (CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH != 0)
+    instance_l.pTxVethFuncs = GET_DLLKCAL_INTERFACE();
+#endif
 #if defined(CONFIG_INCLUDE_NMT_MN)
     instance_l.pTxSyncFuncs = GET_DLLKCAL_INTERFACE();
 #endif
@@ -185,6 +230,16 @@ tOplkError dllkcal_init(void)
         goto Exit;
     }
 
+#if (CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH != 0)
+    ret = instance_l.pTxVethFuncs->pfnAddInstance(&instance_l.dllCalQueueTxVeth,
+                                                  kDllCalQueueTxVeth);
+    if (ret != kErrorOk)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() TxVeth failed\n", __func__);
+        goto Exit;
+    }
+#endif
+
 #if defined(CONFIG_INCLUDE_NMT_MN)
     ret = instance_l.pTxSyncFuncs->pfnAddInstance(&instance_l.dllCalQueueTxSync,
                                                   kDllCalQueueTxSync);
@@ -254,6 +309,9 @@ tOplkError dllkcal_exit(void)
 
     instance_l.pTxNmtFuncs->pfnDelInstance(instance_l.dllCalQueueTxNmt);
     instance_l.pTxGenFuncs->pfnDelInstance(instance_l.dllCalQueueTxGen);
+#if (CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH != 0)
+    instance_l.pTxVethFuncs->pfnDelInstance(instance_l.dllCalQueueTxVeth);
+#endif
 #if defined(CONFIG_INCLUDE_NMT_MN)
     instance_l.pTxSyncFuncs->pfnDelInstance(instance_l.dllCalQueueTxSync);
 #endif
@@ -281,6 +339,7 @@ tOplkError dllkcal_process(tEvent* pEvent_p)
 {
     tOplkError                  ret = kErrorOk;
     tDllCalAsndServiceIdFilter* pServFilter;
+    tDllCalAsndServiceIdLimit*  pServLimit;
     tDllIdentParam*             pIdentParam;
     tDllConfigParam*            pConfigParam;
 
@@ -305,11 +364,22 @@ tOplkError dllkcal_process(tEvent* pEvent_p)
                                               pServFilter->filter);
             break;
 
+        case kEventTypeDllkServLimit:
+            pServLimit = (tDllCalAsndServiceIdLimit*)pEvent_p->pEventArg;
+            ret = dllk_setAsndServiceIdLimit(pServLimit->serviceId,
+                                             pServLimit->maxFramesPerSec,
+                                             pServLimit->fCoalesce);
+            break;
+
 #if defined(CONFIG_INCLUDE_NMT_MN)
         case kEventTypeDllkIssueReq:
             pIssueReq = (tDllCalIssueRequest*)pEvent_p->pEventArg;
             ret = dllkcal_issueRequest(pIssueReq->service, pIssueReq->nodeId,
                                        pIssueReq->soaFlag1);
+#if (CONFIG_DLL_PREOP1_IDLE_SLOT_TIME_MAX != 0) && (CONFIG_TIMER_USE_HIGHRES != FALSE)
+            if (ret == kErrorOk)
+                ret = dllk_wakeReducedCycle();
+#endif
             break;
 #endif
 
@@ -368,6 +438,7 @@ tOplkError dllkcal_process(tEvent* pEvent_p)
 \brief Get count of TX frames
 
 This function returns the count of TX frames of the FIFO with highest priority.
+The frames of the virtual Ethernet queue are counted with the generic priority.
 
 \param  pPriority_p             Pointer to store the FIFO type.
 \param  pCount_p                Pointer to store the number of TX frames.
@@ -382,6 +453,9 @@ tOplkError dllkcal_getAsyncTxCount(tDllAsyncReqPriority* pPriority_p,
 {
     tOplkError  ret = kErrorOk;
     ULONG       frameCount;
+#if (CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH != 0)
+    ULONG       vethFrameCount;
+#endif
 
     ret = instance_l.pTxNmtFuncs->pfnGetDataBlockCount(instance_l.dllCalQueueTxNmt,
                                                        &frameCount);
@@ -394,6 +468,7 @@ tOplkError dllkcal_getAsyncTxCount(tDllAsyncReqPriority* pPriority_p,
     {
         instance_l.statistics.maxTxFrameCountNmt = frameCount;
     }
+    METRICS_SET(instance_l.pMetricTxQueueNmt, frameCount);
 
     if (frameCount != 0)
     {   // NMT requests are in queue
@@ -413,6 +488,23 @@ tOplkError dllkcal_getAsyncTxCount(tDllAsyncReqPriority* pPriority_p,
     {
         instance_l.statistics.maxTxFrameCountGen = frameCount;
     }
+    METRICS_OBSERVE(instance_l.pMetricTxQueueGen, frameCount);
+
+#if (CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH != 0)
+    ret = instance_l.pTxVethFuncs->pfnGetDataBlockCount(instance_l.dllCalQueueTxVeth,
+                                                        &vethFrameCount);
+    if (ret != kErrorOk)
+    {
+        goto Exit;
+    }
+
+    if (vethFrameCount > instance_l.statistics.maxTxFrameCountVeth)
+    {
+        instance_l.statistics.maxTxFrameCountVeth = vethFrameCount;
+    }
+
+    frameCount += vethFrameCount;
+#endif
 
     *pPriority_p = kDllAsyncReqPrioGeneric;
     *pCount_p = (UINT)frameCount;
@@ -425,7 +517,9 @@ Exit:
 /**
 \brief Get TX frame of specified FIFO
 
-The function return TX frames form the specified FIFO.
+The function return TX frames form the specified FIFO. For the generic priority
+the frames of the generic queue (e.g. SDO) are returned before the frames of
+the virtual Ethernet queue, so SDO transfers are not delayed by IP traffic.
 
 \param  pFrame_p                Pointer to store TX frame.
 \param  pFrameSize_p            Pointer to maximum size of buffer. Will be
@@ -454,6 +548,14 @@ tOplkError dllkcal_getAsyncTxFrame(void* pFrame_p, UINT* pFrameSize_p,
             ret = instance_l.pTxGenFuncs->pfnGetDataBlock(
                                             instance_l.dllCalQueueTxGen,
                                             (BYTE*)pFrame_p, pFrameSize_p);
+#if (CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH != 0)
+            if (ret == kErrorDllAsyncTxBufferEmpty)
+            {
+                ret = instance_l.pTxVethFuncs->pfnGetDataBlock(
+                                            instance_l.dllCalQueueTxVeth,
+                                            (BYTE*)pFrame_p, pFrameSize_p);
+            }
+#endif
             break;
     }
 
@@ -493,10 +595,12 @@ tOplkError dllkcal_asyncFrameReceived(tFrameInfo* pFrameInfo_p)
     if (ret != kErrorOk)
     {
         instance_l.statistics.curRxFrameCount++;
+        METRICS_ADD(instance_l.pMetricAsndRxErrors, 1);
     }
     else
     {
         instance_l.statistics.maxRxFrameCount++;
+        METRICS_ADD(instance_l.pMetricAsndRxFrames, 1);
 #if CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_ASYNC != FALSE
         ret = kErrorReject; // Signalizes dllk to release buffer later
 #endif
@@ -536,6 +640,13 @@ tOplkError dllkcal_sendAsyncFrame(tFrameInfo* pFrameInfo_p,
             break;
 
         default:    // generic priority
+#if (CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH != 0)
+            if (ami_getUint16Be(&pFrameInfo_p->pFrame->etherType) != C_DLL_ETHERTYPE_EPL)
+            {   // non-POWERLINK frames are queued separately
+                ret = insertVethFrame(pFrameInfo_p);
+                break;
+            }
+#endif
             ret = instance_l.pTxGenFuncs->pfnInsertDataBlock(
                                         instance_l.dllCalQueueTxGen,
                                         (BYTE*)pFrameInfo_p->pFrame,
@@ -593,15 +704,73 @@ tOplkError dllkcal_writeAsyncFrame(tFrameInfo* pFrameInfo_p, tDllCalQueue dllQue
                                         (BYTE*)pFrameInfo_p->pFrame,
                                         &(pFrameInfo_p->frameSize));
             break;
+#if (CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH != 0)
+        case kDllCalQueueTxVeth:   // virtual Ethernet frames
+            ret = insertVethFrame(pFrameInfo_p);
+            break;
+#endif
 #if defined(CONFIG_INCLUDE_NMT_MN)
         case kDllCalQueueTxSync:   // sync request priority
             ret = instance_l.pTxSyncFuncs->pfnInsertDataBlock(
                                         instance_l.dllCalQueueTxSync,
                                         (BYTE*)pFrameInfo_p->pFrame,
                                         &(pFrameInfo_p->frameSize));
+            if (ret == kErrorOk)
+                instance_l.statistics.aSoaRequestCount[kDllkCalSoaQueueMnSync]++;
+            break;
+#endif
+        default:
+            break;
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the number of frames in an asynchronous transmit queue
+
+The function returns the number of frames which are currently stored in the
+specified dll CAL queue.
+
+\param  dllQueue_p              DllCal Queue to use
+\param  pCount_p                Pointer to store the number of frames.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_dllkcal
+*/
+//------------------------------------------------------------------------------
+tOplkError dllkcal_getAsyncQueueCount(tDllCalQueue dllQueue_p, ULONG* pCount_p)
+{
+    tOplkError  ret = kErrorOk;
+
+    *pCount_p = 0;
+    switch (dllQueue_p)
+    {
+        case kDllCalQueueTxNmt:    // NMT request priority
+            ret = instance_l.pTxNmtFuncs->pfnGetDataBlockCount(instance_l.dllCalQueueTxNmt,
+                                                               pCount_p);
+            break;
+
+        case kDllCalQueueTxGen:    // generic priority
+            ret = instance_l.pTxGenFuncs->pfnGetDataBlockCount(instance_l.dllCalQueueTxGen,
+                                                               pCount_p);
+            break;
+#if (CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH != 0)
+        case kDllCalQueueTxVeth:   // virtual Ethernet frames
+            ret = instance_l.pTxVethFuncs->pfnGetDataBlockCount(instance_l.dllCalQueueTxVeth,
+                                                                pCount_p);
+            break;
+#endif
+#if defined(CONFIG_INCLUDE_NMT_MN)
+        case kDllCalQueueTxSync:   // sync request priority
+            ret = instance_l.pTxSyncFuncs->pfnGetDataBlockCount(instance_l.dllCalQueueTxSync,
+                                                                pCount_p);
             break;
 #endif
         default:
+            ret = kErrorDllInvalidParam;
             break;
     }
 
@@ -630,6 +799,12 @@ tOplkError dllkcal_clearAsyncBuffer(void)
     //ret is ignored
     ret = instance_l.pTxGenFuncs->pfnResetDataBlockQueue(
                                     instance_l.dllCalQueueTxGen, 1000);
+
+#if (CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH != 0)
+    //ret is ignored
+    ret = instance_l.pTxVethFuncs->pfnResetDataBlockQueue(
+                                    instance_l.dllCalQueueTxVeth, 1000);
+#endif
     return ret;
 }
 
@@ -654,7 +829,7 @@ tOplkError dllkcal_clearAsyncQueues(void)
                                     instance_l.dllCalQueueTxSync, 1000);
 
     // clear MN asynchronous queues
-    instance_l.nextRequestQueue = 0;
+    resetSoaScheduler();
 
     circbuf_reset(instance_l.pQueueCnRequestGen);
     circbuf_reset(instance_l.pQueueCnRequestNmt);
@@ -690,6 +865,12 @@ tOplkError dllkcal_getStatistics(tDllkCalStatistics** ppStatistics)
     ret = instance_l.pTxGenFuncs->pfnGetDataBlockCount(instance_l.dllCalQueueTxGen,
                                      &instance_l.statistics.curTxFrameCountGen);
 
+#if (CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH != 0)
+    //ret is ignored
+    ret = instance_l.pTxVethFuncs->pfnGetDataBlockCount(instance_l.dllCalQueueTxVeth,
+                                     &instance_l.statistics.curTxFrameCountVeth);
+#endif
+
     *ppStatistics = &instance_l.statistics;
     return ret;
 }
@@ -737,6 +918,7 @@ tOplkError dllkcal_issueRequest(tDllReqServiceId service_p, UINT nodeId_p,
                 ret = kErrorDllAsyncTxBufferFull;
                 goto Exit;
             }
+            instance_l.statistics.aSoaRequestCount[kDllkCalSoaQueueMnIdent]++;
             break;
 
         case kDllReqServiceStatus:
@@ -746,6 +928,7 @@ tOplkError dllkcal_issueRequest(tDllReqServiceId service_p, UINT nodeId_p,
                 ret = kErrorDllAsyncTxBufferFull;
                 goto Exit;
             }
+            instance_l.statistics.aSoaRequestCount[kDllkCalSoaQueueMnStatus]++;
             break;
 
         default:
@@ -784,46 +967,53 @@ tOplkError dllkcal_getSoaRequest(tDllReqServiceId* pReqServiceId_p,
 {
     tOplkError      ret = kErrorOk;
     UINT            count;
+    UINT            queue;
+
+    if (*pReqServiceId_p != kDllReqServiceNo)
+        instance_l.statistics.aSoaRequestCount[kDllkCalSoaQueueMnGenNmt]++;
 
-    for (count = DLLKCAL_MAX_QUEUES; count > 0; count--)
+    // Weighted round-robin over the request queues: The current queue keeps
+    // the slot as long as it has slots left in this round. An empty queue
+    // forfeits the rest of its round. One more iteration than queues allows
+    // the starting queue to be served again with a fresh round.
+    for (count = DLLKCAL_MAX_QUEUES + 1; count > 0; count--)
     {
-        switch (instance_l.nextRequestQueue)
+        queue = instance_l.nextRequestQueue;
+        if ((instance_l.aSoaDeficit[queue] > 0) &&
+            (getQueueRequest(queue, pReqServiceId_p, pNodeId_p, pSoaPayload_p) == TRUE))
         {
-            case 0:
-                if (getCnGenRequest(pReqServiceId_p, pNodeId_p) == TRUE)
-                    goto Exit;
-                break;
+            instance_l.aSoaDeficit[queue]--;
+            instance_l.statistics.aSoaGrantCount[queue]++;
+            goto Exit;
+        }
 
-            case 1:
-                if (getCnNmtRequest(pReqServiceId_p, pNodeId_p) == TRUE)
-                    goto Exit;
-                break;
+        instance_l.aSoaDeficit[queue] = 0;
+        queue = (queue + 1) % DLLKCAL_MAX_QUEUES;
+        instance_l.aSoaDeficit[queue] = instance_l.aSoaWeight[queue];
+        instance_l.nextRequestQueue = queue;
+    }
 
-            case 2:
-                if (getMnGenNmtRequest(pReqServiceId_p, pNodeId_p) == TRUE)
-                    goto Exit;
-                break;
+Exit:
+    return ret;
+}
 
-            case 3:
-                if (getMnIdentRequest(pReqServiceId_p, pNodeId_p) == TRUE)
-                    goto Exit;
-                break;
+//------------------------------------------------------------------------------
+/**
+\brief Get count of queued SoA requests
 
-            case 4:
-                if (getMnStatusRequest(pReqServiceId_p, pNodeId_p) == TRUE)
-                    goto Exit;
-                break;
+The function returns the number of IdentRequests and StatusRequests which are
+queued by the MN and wait for their SoA invitation. It is used by the kernel
+DLL module to detect a deep request backlog in the reduced cycle.
 
-            case 5:
-                if (getMnSyncRequest(pReqServiceId_p, pNodeId_p, pSoaPayload_p)
-                                == TRUE)
-                    goto Exit;
-                break;
-        }
-    }
+\return The function returns the number of queued requests.
 
-Exit:
-    return ret;
+\ingroup module_dllkcal
+*/
+//------------------------------------------------------------------------------
+UINT dllkcal_getSoaRequestCount(void)
+{
+    return (UINT)(circbuf_getDataCount(instance_l.pQueueIdentReq) +
+                  circbuf_getDataCount(instance_l.pQueueStatusReq));
 }
 
 //------------------------------------------------------------------------------
@@ -850,6 +1040,11 @@ tOplkError dllkcal_setAsyncPendingRequests(UINT nodeId_p,
     tCircBufError       err;
     UINT*               pLocalRequestCnt;
     tCircBufInstance*   pTargetQueue;
+    tDllkCalSoaQueue    queue;
+    UINT                posted;
+
+    if ((nodeId_p == C_ADR_INVALID) || (nodeId_p > NMT_MAX_NODE_ID))
+        return kErrorInvalidNodeId;
 
     // get local request count for the node and the target queue
     switch (asyncReqPrio_p)
@@ -857,22 +1052,31 @@ tOplkError dllkcal_setAsyncPendingRequests(UINT nodeId_p,
         case kDllAsyncReqPrioNmt:
             pLocalRequestCnt = &instance_l.aCnRequestCntNmt[nodeId_p-1];
             pTargetQueue = instance_l.pQueueCnRequestNmt;
+            queue = kDllkCalSoaQueueCnNmt;
             break;
 
         default:
             pLocalRequestCnt = &instance_l.aCnRequestCntGen[nodeId_p-1];
             pTargetQueue = instance_l.pQueueCnRequestGen;
+            queue = kDllkCalSoaQueueCnGen;
             break;
     }
 
     // compare the node request count with the locally stored one
     if (*pLocalRequestCnt < count_p)
     {
-        // The node has added some requests, but post only one for fair
-        // scheduling among the other nodes.
-        err = circbuf_writeData(pTargetQueue, &nodeId_p, sizeof(nodeId_p));
-        if (err == kCircBufOk)
+        // The node has added some requests, but post only as many as its
+        // weight allows for fair scheduling among the other nodes.
+        for (posted = 0; (posted < instance_l.aNodeWeight[nodeId_p-1]) &&
+                         (*pLocalRequestCnt < count_p); posted++)
+        {
+            err = circbuf_writeData(pTargetQueue, &nodeId_p, sizeof(nodeId_p));
+            if (err != kCircBufOk)
+                break;
+
             (*pLocalRequestCnt)++; // increment locally only by successful post
+            instance_l.statistics.aSoaRequestCount[queue]++;
+        }
     }
     else
     {
@@ -882,13 +1086,161 @@ tOplkError dllkcal_setAsyncPendingRequests(UINT nodeId_p,
 
     return ret;
 }
+
+//------------------------------------------------------------------------------
+/**
+\brief Set weight of an SoA request queue
+
+The function sets the number of consecutive asynchronous slots the specified
+request queue may use in one round of the SoA scheduler before the next queue
+is served.
+
+\param  queue_p                 Request queue to configure.
+\param  weight_p                Number of slots per round (at least 1).
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_dllkcal
+*/
+//------------------------------------------------------------------------------
+tOplkError dllkcal_setSoaQueueWeight(tDllkCalSoaQueue queue_p, UINT weight_p)
+{
+    if ((queue_p >= kDllkCalSoaQueueCount) || (weight_p == 0))
+        return kErrorDllInvalidParam;
+
+    instance_l.aSoaWeight[queue_p] = weight_p;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief Set asynchronous weight of a node
+
+The function sets how many pending asynchronous requests of the specified CN
+are queued at once. A node with a higher weight gets more consecutive slots
+within the CN request queues than other nodes.
+
+\param  nodeId_p                Node ID of the CN.
+\param  weight_p                Number of requests queued at once (at least 1).
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_dllkcal
+*/
+//------------------------------------------------------------------------------
+tOplkError dllkcal_setNodeAsyncWeight(UINT nodeId_p, UINT weight_p)
+{
+    if ((nodeId_p == C_ADR_INVALID) || (nodeId_p > tabentries(instance_l.aNodeWeight)))
+        return kErrorInvalidNodeId;
+
+    if (weight_p == 0)
+        return kErrorDllInvalidParam;
+
+    instance_l.aNodeWeight[nodeId_p - 1] = weight_p;
+    return kErrorOk;
+}
 #endif
 
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
 
+#if (CONFIG_DLLCAL_BUFFER_SIZE_TX_VETH != 0)
+//------------------------------------------------------------------------------
+/**
+\brief Insert a frame into the virtual Ethernet queue
+
+The function inserts a virtual Ethernet frame into its own queue. If the queue
+is full, the frame is either rejected or, if CONFIG_DLLCAL_TX_VETH_DROP_ON_FULL
+is TRUE, dropped and counted in the statistics.
+
+\param  pFrameInfo_p            Pointer to frame info structure
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError insertVethFrame(tFrameInfo* pFrameInfo_p)
+{
+    tOplkError  ret;
+
+    ret = instance_l.pTxVethFuncs->pfnInsertDataBlock(instance_l.dllCalQueueTxVeth,
+                                                      (BYTE*)pFrameInfo_p->pFrame,
+                                                      &(pFrameInfo_p->frameSize));
+    if (ret == kErrorDllAsyncTxBufferFull)
+    {
+        instance_l.statistics.txDropCountVeth++;
+        METRICS_ADD(instance_l.pMetricVethTxDrops, 1);
+#if (CONFIG_DLLCAL_TX_VETH_DROP_ON_FULL != FALSE)
+        ret = kErrorOk;
+#endif
+    }
+
+    return ret;
+}
+
+#endif
+
 #if defined(CONFIG_INCLUDE_NMT_MN)
+//------------------------------------------------------------------------------
+/**
+\brief Reset SoA scheduler
+
+The function restarts the SoA scheduler with a fresh round of the first
+request queue.
+*/
+//------------------------------------------------------------------------------
+static void resetSoaScheduler(void)
+{
+    OPLK_MEMSET(instance_l.aSoaDeficit, 0, sizeof(instance_l.aSoaDeficit));
+    instance_l.nextRequestQueue = kDllkCalSoaQueueCnGen;
+    instance_l.aSoaDeficit[kDllkCalSoaQueueCnGen] = instance_l.aSoaWeight[kDllkCalSoaQueueCnGen];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief Get request of an SoA queue
+
+The function returns the next request of the specified SoA request queue.
+
+\param  queue_p                 Request queue to read.
+\param  pReqServiceId_p         Pointer to store the next request.
+\param  pNodeId_p               Pointer to store the node ID for the next
+                                request.
+\param  pSoaPayload_p           Pointer to SoA payload.
+
+\return Returns whether a request was found
+\retval TRUE        A request was found
+\retval FALSE       No request was found
+*/
+//------------------------------------------------------------------------------
+static BOOL getQueueRequest(UINT queue_p, tDllReqServiceId* pReqServiceId_p,
+                            UINT* pNodeId_p, tSoaPayload* pSoaPayload_p)
+{
+    switch (queue_p)
+    {
+        case kDllkCalSoaQueueCnGen:
+            return getCnGenRequest(pReqServiceId_p, pNodeId_p);
+
+        case kDllkCalSoaQueueCnNmt:
+            return getCnNmtRequest(pReqServiceId_p, pNodeId_p);
+
+        case kDllkCalSoaQueueMnGenNmt:
+            return getMnGenNmtRequest(pReqServiceId_p, pNodeId_p);
+
+        case kDllkCalSoaQueueMnIdent:
+            return getMnIdentRequest(pReqServiceId_p, pNodeId_p);
+
+        case kDllkCalSoaQueueMnStatus:
+            return getMnStatusRequest(pReqServiceId_p, pNodeId_p);
+
+        case kDllkCalSoaQueueMnSync:
+            return getMnSyncRequest(pReqServiceId_p, pNodeId_p, pSoaPayload_p);
+
+        default:
+            return FALSE;
+    }
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief Get CN Generic request
@@ -910,9 +1262,6 @@ static BOOL getCnGenRequest(tDllReqServiceId* pReqServiceId_p, UINT* pNodeId_p)
     UINT            rxNodeId;
     size_t          size = sizeof(rxNodeId);
 
-    // next queue will be CnNmtReq queue
-    instance_l.nextRequestQueue = 1;
-
     err = circbuf_readData(instance_l.pQueueCnRequestGen, &rxNodeId, size, &size);
 
     switch (err)
@@ -956,9 +1305,6 @@ static BOOL getCnNmtRequest(tDllReqServiceId* pReqServiceId_p, UINT* pNodeId_p)
     UINT            rxNodeId;
     size_t          size = sizeof(rxNodeId);
 
-    // next queue will be MnGenReq queue
-    instance_l.nextRequestQueue = 2;
-
     err = circbuf_readData(instance_l.pQueueCnRequestNmt, &rxNodeId, size, &size);
 
     switch (err)
@@ -999,8 +1345,6 @@ The function returns the next MN Generic/NMT request.
 static BOOL getMnGenNmtRequest(tDllReqServiceId* pReqServiceId_p, UINT* pNodeId_p)
 {
     // MnNmtReq and MnGenReq
-    // next queue will be MnIdentReq queue
-    instance_l.nextRequestQueue = 3;
     if (*pReqServiceId_p != kDllReqServiceNo)
     {
         *pNodeId_p = C_ADR_INVALID;   // DLLk must exchange this with the actual node ID
@@ -1030,9 +1374,6 @@ static BOOL getMnIdentRequest(tDllReqServiceId* pReqServiceId_p, UINT* pNodeId_p
     UINT            rxNodeId;
     size_t          size = sizeof(rxNodeId);
 
-    // next queue will be MnStatusReq queue
-    instance_l.nextRequestQueue = 4;
-
     err = circbuf_readData(instance_l.pQueueIdentReq, &rxNodeId, size, &size);
 
     if (err == kCircBufOk)
@@ -1065,8 +1406,6 @@ static BOOL getMnStatusRequest(tDllReqServiceId* pReqServiceId_p, UINT* pNodeId_
     UINT            rxNodeId;
     size_t          size = sizeof(rxNodeId);
 
-    // next queue will be MnSyncReq queue
-    instance_l.nextRequestQueue = 5;
     err = circbuf_readData(instance_l.pQueueStatusReq, &rxNodeId, size, &size);
 
     if (err == kCircBufOk)
@@ -1106,8 +1445,6 @@ static BOOL getMnSyncRequest(tDllReqServiceId* pReqServiceId_p, UINT* pNodeId_p,
     tDllSyncRequest     syncRequest;
     tDllNodeOpParam     nodeOpParam;
 
-    // next queue will be CnGenReq queue
-    instance_l.nextRequestQueue = 0;
     ret = instance_l.pTxSyncFuncs->pfnGetDataBlockCount(
                                 instance_l.dllCalQueueTxSync, &syncReqCount);
     if (ret != kErrorOk)
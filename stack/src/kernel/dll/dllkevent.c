@@ -41,6 +41,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <common/ami.h>
+#include <common/target.h>
 #include "dllk-internal.h"
 
 //============================================================================//
@@ -92,6 +93,14 @@ static tOplkError processStartReducedCycle(void);
 static tOplkError processPresReady(tNmtState nmtState_p);
 #endif
 static tOplkError processFillTx(tDllAsyncReqPriority asyncReqPriority_p, tNmtState nmtState_p);
+static tOplkError fillPresCn(tNmtState nmtState_p, BOOL fReadyFlag_p);
+#if (CONFIG_DLL_PRES_LATE_BINDING != FALSE)
+static tOplkError processPresFill(tNmtState nmtState_p);
+#endif
+static BOOL       isTxFrameOutdated(tEdrvTxBuffer* pTxBuffer_p, tNmtState nmtState_p);
+#if (CONFIG_DLL_WARMUP_CYCLES > 0)
+static tOplkError warmUpCycle(tNmtState nmtState_p);
+#endif
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -120,8 +129,19 @@ tOplkError dllk_process(tEvent* pEvent_p)
     {
         case kEventTypeNmtStateChange:
             pNmtStateChange = (tEventNmtStateChange*)pEvent_p->pEventArg;
+#if defined(CONFIG_INCLUDE_NMT_MN) && (CONFIG_DLL_PREOP1_IDLE_SLOT_TIME_MAX != 0) && \
+    (CONFIG_TIMER_USE_HIGHRES != FALSE)
+            ret = dllk_wakeReducedCycle();
+            if (ret != kErrorOk)
+                break;
+#endif
             ret = processNmtStateChange(pNmtStateChange->newNmtState,
                                         pNmtStateChange->oldNmtState);
+#if (CONFIG_EDRV_RX_FILTER_BATCH != FALSE)
+            // apply the filter changes of the new state at once
+            if (ret == kErrorOk)
+                ret = edrv_commitRxFilter();
+#endif
             break;
 
         case kEventTypeNmtEvent:
@@ -134,9 +154,8 @@ tOplkError dllk_process(tEvent* pEvent_p)
             break;
 
         case kEventTypeDllkFlag1:
-            // trigger update of StatusRes on SoA, because Flag 1 was changed
-            if (dllkInstance_g.updateTxFrame == DLLK_UPDATE_NONE)
-                dllkInstance_g.updateTxFrame = DLLK_UPDATE_STATUS;
+            // trigger update of StatusRes at cycle finish, because Flag 1 was changed
+            dllkInstance_g.updateTxFrame |= DLLK_UPDATE_FLAG1;
             break;
 
         case kEventTypeDllkCycleFinish:
@@ -159,6 +178,12 @@ tOplkError dllk_process(tEvent* pEvent_p)
             break;
 #endif
 
+#if (CONFIG_DLL_PRES_LATE_BINDING != FALSE)
+        case kEventTypeDllkPresFill:
+            ret = processPresFill(dllkInstance_g.nmtState);
+            break;
+#endif
+
         default:
             ret = kErrorInvalidEvent;
             ASSERTMSG(ret != kErrorInvalidEvent, "dllk_process(): unhandled event type!\n");
@@ -193,6 +218,11 @@ tOplkError dllk_issueLossOfPres(UINT nodeId_p)
     pIntNodeInfo = dllk_getNodeInfo(nodeId_p);
     if (pIntNodeInfo != NULL)
     {
+#if (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE)
+        // fall back to the configured PRes timeout until the CN is measured again
+        dllk_resetPresTimeout(pIntNodeInfo);
+#endif
+
         if (pIntNodeInfo->fSoftDelete == FALSE)
         {   // normal isochronous CN
             tEventDllError  dllEvent;
@@ -415,7 +445,15 @@ static tOplkError processNmtStateChange(tNmtState newNmtState_p, tNmtState oldNm
         // node processes isochronous and asynchronous frames
         case kNmtCsPreOperational2:
             // signal update of IdentRes and StatusRes on SoA
-            dllkInstance_g.updateTxFrame = DLLK_UPDATE_BOTH;
+            dllkInstance_g.updateTxFrame |= DLLK_UPDATE_NMTSTATUS;
+
+#if (CONFIG_DLL_WARMUP_CYCLES > 0)
+            if (oldNmtState_p == kNmtCsPreOperational1)
+            {
+                if ((ret = warmUpCycle(newNmtState_p)) != kErrorOk)
+                    return ret;
+            }
+#endif
 
             // enable PRes (necessary if coming from Stopped)
 #if (CONFIG_EDRV_AUTO_RESPONSE != FALSE)
@@ -465,7 +503,15 @@ static tOplkError processNmtStateChange(tNmtState newNmtState_p, tNmtState oldNm
         case kNmtMsPreOperational2:
         case kNmtMsOperational:
             // signal update of IdentRes and StatusRes on SoA
-            dllkInstance_g.updateTxFrame = DLLK_UPDATE_BOTH;
+            dllkInstance_g.updateTxFrame |= DLLK_UPDATE_NMTSTATUS;
+
+#if (CONFIG_DLL_WARMUP_CYCLES > 0)
+            if (oldNmtState_p == kNmtMsPreOperational1)
+            {   // the isochronous cycle starts with the next SoC
+                if ((ret = warmUpCycle(newNmtState_p)) != kErrorOk)
+                    return ret;
+            }
+#endif
             break;
 
 #endif
@@ -480,13 +526,13 @@ static tOplkError processNmtStateChange(tNmtState newNmtState_p, tNmtState oldNm
 
         case kNmtCsOperational:
             // signal update of IdentRes and StatusRes on SoA
-            dllkInstance_g.updateTxFrame = DLLK_UPDATE_BOTH;
+            dllkInstance_g.updateTxFrame |= DLLK_UPDATE_NMTSTATUS;
             break;
 
         // node stopped by MN
         case kNmtCsStopped:
             // signal update of IdentRes and StatusRes on SoA
-            dllkInstance_g.updateTxFrame = DLLK_UPDATE_BOTH;
+            dllkInstance_g.updateTxFrame |= DLLK_UPDATE_NMTSTATUS;
 
 #if (CONFIG_EDRV_AUTO_RESPONSE != FALSE)
             // disable auto-response for PRes filter
@@ -595,6 +641,7 @@ static tOplkError processFillTx(tDllAsyncReqPriority asyncReqPriority_p, tNmtSta
     UINT            frameSize;
     UINT            frameCount;
     UINT            nextTxBufferOffset;
+    UINT8           flag2;
 #if (CONFIG_EDRV_AUTO_RESPONSE != FALSE)
     UINT            filterEntry;
 #endif
@@ -639,6 +686,13 @@ static tOplkError processFillTx(tDllAsyncReqPriority asyncReqPriority_p, tNmtSta
 
                 pTxBuffer->txFrameSize = frameSize;    // set buffer valid
 
+#if defined(CONFIG_INCLUDE_NMT_MN) && (CONFIG_DLL_PREOP1_IDLE_SLOT_TIME_MAX != 0) && \
+    (CONFIG_TIMER_USE_HIGHRES != FALSE)
+                ret = dllk_wakeReducedCycle();
+                if (ret != kErrorOk)
+                    goto Exit;
+#endif
+
 #if (CONFIG_EDRV_AUTO_RESPONSE != FALSE)
                 if ((nmtState_p & (NMT_TYPE_MASK | NMT_SUPERSTATE_MASK)) == (NMT_TYPE_CS | NMT_CS_PLKMODE))
                 {
@@ -743,20 +797,48 @@ static tOplkError processFillTx(tDllAsyncReqPriority asyncReqPriority_p, tNmtSta
         }
         if (frameCount > 0)
         {
-            dllkInstance_g.flag2 = (UINT8)(((asyncReqPriority_p << PLK_FRAME_FLAG2_PR_SHIFT) &
-                                             PLK_FRAME_FLAG2_PR) | (frameCount & PLK_FRAME_FLAG2_RS));
+            flag2 = (UINT8)(((asyncReqPriority_p << PLK_FRAME_FLAG2_PR_SHIFT) &
+                              PLK_FRAME_FLAG2_PR) | (frameCount & PLK_FRAME_FLAG2_RS));
         }
         else
         {
-            dllkInstance_g.flag2 = 0;
+            flag2 = 0;
+        }
+
+        // IdentRes and StatusRes are only refreshed if Flag 2 was changed
+        if (flag2 != dllkInstance_g.flag2)
+        {
+            dllkInstance_g.flag2 = flag2;
+            dllkInstance_g.updateTxFrame |= DLLK_UPDATE_FLAG2;
         }
-        dllkInstance_g.updateTxFrame = DLLK_UPDATE_BOTH;
     }
 
 Exit:
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Check if IdentRes or StatusRes is outdated
+
+The function checks whether the dynamic fields of the currently active
+IdentRes or StatusRes buffer differ from the current values. Only then the
+other buffer has to be refreshed and handed to the Ethernet driver. Fields
+which are not part of the frame (e.g. Flag 1 of IdentRes) are ignored.
+
+\param  pTxBuffer_p             Pointer to the currently active TX buffer.
+\param  nmtState_p              NMT state of the node.
+
+\return The function returns TRUE if the frame has to be updated.
+*/
+//------------------------------------------------------------------------------
+static BOOL isTxFrameOutdated(tEdrvTxBuffer* pTxBuffer_p, tNmtState nmtState_p)
+{
+    return (dllk_checkFrameField(pTxBuffer_p, DLLK_FRAME_FIELD_NMTSTATUS, (UINT8)nmtState_p) ||
+            dllk_checkFrameField(pTxBuffer_p, DLLK_FRAME_FIELD_FLAG2, dllkInstance_g.flag2) ||
+            dllk_checkFrameField(pTxBuffer_p, DLLK_FRAME_FIELD_FLAG1, dllkInstance_g.flag1));
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Process cycle finish event
@@ -773,37 +855,37 @@ static tOplkError processCycleFinish(tNmtState nmtState_p)
     tOplkError      ret = kErrorReject;
     tEdrvTxBuffer*  pTxBuffer;
 
-    switch (dllkInstance_g.updateTxFrame)
+    if ((dllkInstance_g.updateTxFrame & DLLK_UPDATE_IDENTRES) != 0)
     {
-        case DLLK_UPDATE_BOTH:
+        pTxBuffer = &dllkInstance_g.pTxBuffer[DLLK_TXFRAME_IDENTRES +
+                                              dllkInstance_g.curTxBufferOffsetIdentRes];
+        if ((pTxBuffer->pBuffer != NULL) && isTxFrameOutdated(pTxBuffer, nmtState_p))
+        {   // IdentRes does exist and has to be changed, so switch to the other buffer
             dllkInstance_g.curTxBufferOffsetIdentRes ^= 1;
             pTxBuffer = &dllkInstance_g.pTxBuffer[DLLK_TXFRAME_IDENTRES +
                                                   dllkInstance_g.curTxBufferOffsetIdentRes];
-            if (pTxBuffer->pBuffer != NULL)
-            {   // IdentRes does exist
-                if ((ret = dllk_updateFrameIdentRes(pTxBuffer, nmtState_p)) != kErrorOk)
-                    return ret;
-            }
-            // fall-through
+            if ((ret = dllk_updateFrameIdentRes(pTxBuffer, nmtState_p)) != kErrorOk)
+                return ret;
+        }
+    }
 
-        case DLLK_UPDATE_STATUS:
+    if ((dllkInstance_g.updateTxFrame & DLLK_UPDATE_STATUSRES) != 0)
+    {
+        pTxBuffer = &dllkInstance_g.pTxBuffer[DLLK_TXFRAME_STATUSRES +
+                                              dllkInstance_g.curTxBufferOffsetStatusRes];
+        if ((pTxBuffer->pBuffer != NULL) && isTxFrameOutdated(pTxBuffer, nmtState_p))
+        {   // StatusRes does exist and has to be changed, so switch to the other buffer
             dllkInstance_g.curTxBufferOffsetStatusRes ^= 1;
             pTxBuffer = &dllkInstance_g.pTxBuffer[DLLK_TXFRAME_STATUSRES +
                                                   dllkInstance_g.curTxBufferOffsetStatusRes];
-            if (pTxBuffer->pBuffer != NULL)
-            {   // StatusRes does exist
-                if ((ret = dllk_updateFrameStatusRes(pTxBuffer, nmtState_p)) != kErrorOk)
-                    return ret;
-            }
-
-            // reset signal variable
-            dllkInstance_g.updateTxFrame = DLLK_UPDATE_NONE;
-            break;
-
-        default:
-            break;
+            if ((ret = dllk_updateFrameStatusRes(pTxBuffer, nmtState_p)) != kErrorOk)
+                return ret;
+        }
     }
 
+    // reset signal variable
+    dllkInstance_g.updateTxFrame = DLLK_UPDATE_NONE;
+
     ret = errhndk_decrementCounters((nmtState_p >= kNmtMsNotActive));
 
 #if defined(CONFIG_INCLUDE_NMT_MN)
@@ -868,7 +950,10 @@ static tOplkError processSync(tNmtState nmtState_p)
 /**
 \brief  Process sync event on CN
 
-The function processes the sync event on a CN.
+The function processes the sync event on a CN. With
+CONFIG_DLL_PRES_LATE_BINDING the PRes fill is deferred to the PRes fill timer
+as soon as the PReq offset of the node is measured, so the TPDOs are copied
+shortly before the PReq.
 
 \param  nmtState_p              NMT state of the node.
 \param  fReadyFlag_p            Status of the ready flag.
@@ -877,25 +962,73 @@ The function processes the sync event on a CN.
 */
 //------------------------------------------------------------------------------
 static tOplkError processSyncCn(tNmtState nmtState_p, BOOL fReadyFlag_p)
+{
+#if (CONFIG_DLL_PRES_LATE_BINDING != FALSE)
+    BOOL                fDefer;
+
+    TGT_DLLK_DECLARE_FLAGS;
+
+    TGT_DLLK_ENTER_CRITICAL_SECTION();
+#if (CONFIG_DLL_PROCESS_SYNC == DLL_PROCESS_SYNC_ON_SOC)
+    // the sync event belongs to the current cycle
+    fDefer = (dllkInstance_g.fPresFillTimer && !dllkInstance_g.fPresFillExpired);
+#else
+    // the sync event belongs to the next cycle whose SoC starts the timer
+    fDefer = (dllkInstance_g.preqOffsetNs != 0);
+#endif
+    if (fDefer)
+    {
+        dllkInstance_g.fPresFillReadyFlag = fReadyFlag_p;
+        dllkInstance_g.fPresFillPending = TRUE;
+    }
+    TGT_DLLK_LEAVE_CRITICAL_SECTION();
+
+    if (fDefer)
+        return kErrorOk;
+#endif
+
+    return fillPresCn(nmtState_p, fReadyFlag_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Fill PRes on CN
+
+The function copies the TPDOs into the PRes of the next cycle and updates the
+PRes.
+
+\param  nmtState_p              NMT state of the node.
+\param  fReadyFlag_p            Status of the ready flag.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError fillPresCn(tNmtState nmtState_p, BOOL fReadyFlag_p)
 {
     tOplkError          ret = kErrorOk;
-    tPlkFrame *         pTxFrame;
     tEdrvTxBuffer*      pTxBuffer;
+#if (CONFIG_PDO_TX_ZERO_COPY == FALSE)
+    tPlkFrame *         pTxFrame;
     tFrameInfo          FrameInfo;
+#endif
     UINT                nextTxBufferOffset = dllkInstance_g.curTxBufferOffsetCycle ^ 1;
 
     // local node is CN, update only the PRes
     pTxBuffer = &dllkInstance_g.pTxBuffer[DLLK_TXFRAME_PRES + nextTxBufferOffset];
     if (pTxBuffer->pBuffer != NULL)
     {   // PRes does exist
-        pTxFrame = (tPlkFrame*)pTxBuffer->pBuffer;
-
         if (nmtState_p != kNmtCsOperational)
             fReadyFlag_p = FALSE;
 
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+        // the PRes may be sent directly from the TPDO buffer
+        ret = dllk_processTpdoZeroCopy(pTxBuffer, fReadyFlag_p);
+#else
+        pTxFrame = (tPlkFrame*)pTxBuffer->pBuffer;
         FrameInfo.pFrame = pTxFrame;
         FrameInfo.frameSize = pTxBuffer->txFrameSize;
         ret = dllk_processTpdo(&FrameInfo, fReadyFlag_p);
+#endif
         if (ret != kErrorOk)
             return ret;
 
@@ -912,6 +1045,49 @@ static tOplkError processSyncCn(tNmtState nmtState_p, BOOL fReadyFlag_p)
     return ret;
 }
 
+#if (CONFIG_DLL_PRES_LATE_BINDING != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Process late PRes fill event
+
+The function fills the PRes which was deferred by the sync event. The time
+from the expiry of the PRes fill timer until the PRes is filled is measured
+and determines the lead time of the timer (see startPresFillTimer() in
+dllkframe.c).
+
+\param  nmtState_p              NMT state of the node.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError processPresFill(tNmtState nmtState_p)
+{
+    tOplkError          ret;
+    BOOL                fReadyFlag;
+    ULONGLONG           duration;
+
+    TGT_DLLK_DECLARE_FLAGS;
+
+    TGT_DLLK_ENTER_CRITICAL_SECTION();
+    if (!dllkInstance_g.fPresFillPending)
+    {   // PRes was already filled
+        TGT_DLLK_LEAVE_CRITICAL_SECTION();
+        return kErrorOk;
+    }
+    dllkInstance_g.fPresFillPending = FALSE;
+    fReadyFlag = dllkInstance_g.fPresFillReadyFlag;
+    TGT_DLLK_LEAVE_CRITICAL_SECTION();
+
+    ret = fillPresCn(nmtState_p, fReadyFlag);
+
+    duration = target_getCurrentTimestamp() - dllkInstance_g.presFillTimeNs;
+    if (duration > dllkInstance_g.presFillDurationNs)
+        dllkInstance_g.presFillDurationNs = duration;
+
+    return ret;
+}
+#endif
+
 #if defined(CONFIG_INCLUDE_NMT_MN)
 //------------------------------------------------------------------------------
 /**
@@ -938,12 +1114,25 @@ static tOplkError processSyncMn(tNmtState nmtState_p, BOOL fReadyFlag_p)
     pTxBuffer->timeOffsetNs = nextTimeOffsetNs;
     pTxFrame = (tPlkFrame*)pTxBuffer->pBuffer;
 
+#if (CONFIG_DLL_RUNTIME_CYCLE_CHANGE != FALSE)
+    // apply an announced cycle length to the prepared cycle
+    ret = dllk_switchCycleLenMn();
+    if (ret != kErrorOk)
+        return ret;
+#endif
+
     // Set SoC relative time
     ami_setUint64Le(&pTxFrame->data.soc.relativeTimeLe, dllkInstance_g.relativeTime);
     dllkInstance_g.relativeTime += dllkInstance_g.dllConfigParam.cycleLen;
 
-    // Update SOC Prescaler Flag
-    ami_setUint8Le(&pTxFrame->data.soc.flag1, dllkInstance_g.mnFlag1 & (PLK_FRAME_FLAG1_PS | PLK_FRAME_FLAG1_MC));
+    if ((dllkInstance_g.dllConfigParam.multipleCycleCnt > 0) &&
+        (((dllkInstance_g.cycleCount + 1) % dllkInstance_g.dllConfigParam.multipleCycleCnt) == 0))
+    {   // the multiplexed cycle restarts with this cycle, toggle MC flag
+        dllkInstance_g.mnFlag1 ^= PLK_FRAME_FLAG1_MC;
+    }
+
+    // Update SOC Prescaler and Multiplexed Cycle Completed Flag
+    dllk_patchFrame(pTxBuffer, DLLK_FRAME_FIELD_FLAG1, dllkInstance_g.mnFlag1 & (PLK_FRAME_FLAG1_PS | PLK_FRAME_FLAG1_MC));
 
     if (dllkInstance_g.ppTxBufferList == NULL)
         return ret;
@@ -982,7 +1171,7 @@ The function processes the PRes Ready event.
 static tOplkError processPresReady(tNmtState nmtState_p)
 {
     tOplkError          ret = kErrorOk;
-    tPlkFrame*          pTxFrame;
+    tEdrvTxBuffer*      pTxBuffer;
 
     // post PRes to transmit FIFO
     if (nmtState_p != kNmtCsBasicEthernet)
@@ -991,20 +1180,19 @@ static tOplkError processPresReady(tNmtState nmtState_p)
         if (dllkInstance_g.pTxBuffer[DLLK_TXFRAME_PRES +
                                      dllkInstance_g.curTxBufferOffsetCycle].pBuffer != NULL)
         {   // PRes does exist
-            pTxFrame = (tPlkFrame*)dllkInstance_g.pTxBuffer[DLLK_TXFRAME_PRES +
-                                                            dllkInstance_g.curTxBufferOffsetCycle].pBuffer;
+            pTxBuffer = &dllkInstance_g.pTxBuffer[DLLK_TXFRAME_PRES + dllkInstance_g.curTxBufferOffsetCycle];
             // update frame (NMT state, RD, RS, PR, MS, EN flags)
             if (nmtState_p < kNmtCsPreOperational2)
             {   // NMT state is not PreOp2, ReadyToOp or Op
                 // fake NMT state PreOp2, because PRes will be sent only in PreOp2 or greater
                 nmtState_p = kNmtCsPreOperational2;
             }
-            ami_setUint8Le(&pTxFrame->data.pres.nmtStatus, (UINT8)nmtState_p);
-            ami_setUint8Le(&pTxFrame->data.pres.flag2, dllkInstance_g.flag2);
+            dllk_patchFrame(pTxBuffer, DLLK_FRAME_FIELD_NMTSTATUS, (UINT8)nmtState_p);
+            dllk_patchFrame(pTxBuffer, DLLK_FRAME_FIELD_FLAG2, dllkInstance_g.flag2);
             if (nmtState_p != kNmtCsOperational)
             {   // mark PDO as invalid in all NMT state but Op
                 // $$$ reset only RD flag; set other flags appropriately
-                ami_setUint8Le(&pTxFrame->data.pres.flag1, 0);
+                dllk_patchFrame(pTxBuffer, DLLK_FRAME_FIELD_FLAG1, 0);
             }
             // $$$ make function that updates Pres, StatusRes
             // mark PRes frame as ready for transmission
@@ -1016,6 +1204,78 @@ static tOplkError processPresReady(tNmtState nmtState_p)
 }
 #endif
 
+#if (CONFIG_DLL_WARMUP_CYCLES > 0)
+//------------------------------------------------------------------------------
+/**
+\brief  Warm up the cycle processing
+
+The function runs the TPDO processing of the isochronous Tx frames
+CONFIG_DLL_WARMUP_CYCLES times before the first isochronous cycle. Only the
+frames of the next cycle are filled, they are not sent and are filled again
+by the first sync event. Code and data of the PDO copy and frame build paths
+are therefore resident and cached when the first SoC is sent.
+
+\param  nmtState_p              NMT state of the local node.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError warmUpCycle(tNmtState nmtState_p)
+{
+    tOplkError          ret = kErrorOk;
+    tEdrvTxBuffer*      pTxBuffer;
+#if defined(CONFIG_INCLUDE_NMT_MN) || (CONFIG_PDO_TX_ZERO_COPY == FALSE)
+    tFrameInfo          frameInfo;
+#endif
+    UINT                nextTxBufferOffset = dllkInstance_g.curTxBufferOffsetCycle ^ 1;
+    UINT                count;
+#if defined(CONFIG_INCLUDE_NMT_MN)
+    UINT                nodeIndex;
+#endif
+
+    for (count = 0; count < CONFIG_DLL_WARMUP_CYCLES; count++)
+    {
+#if defined(CONFIG_INCLUDE_NMT_MN)
+        if (nmtState_p >= kNmtMsNotActive)
+        {   // PReqs and own PRes of the MN
+            for (nodeIndex = 0; nodeIndex < dllkInstance_g.isochrNodeCount; nodeIndex++)
+            {
+                pTxBuffer = &dllkInstance_g.apIsochrNodeInfo[nodeIndex]->pPreqTxBuffer[nextTxBufferOffset];
+                if (pTxBuffer->pBuffer == NULL)
+                    continue;
+
+                frameInfo.pFrame = (tPlkFrame*)pTxBuffer->pBuffer;
+                frameInfo.frameSize = pTxBuffer->txFrameSize;
+                if ((ret = dllk_processTpdo(&frameInfo, FALSE)) != kErrorOk)
+                    return ret;
+            }
+        }
+        else
+#endif
+        {   // PRes of the CN
+            pTxBuffer = &dllkInstance_g.pTxBuffer[DLLK_TXFRAME_PRES + nextTxBufferOffset];
+            if (pTxBuffer->pBuffer == NULL)
+                break;
+
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+            if ((ret = dllk_processTpdoZeroCopy(pTxBuffer, FALSE)) != kErrorOk)
+                return ret;
+#else
+            frameInfo.pFrame = (tPlkFrame*)pTxBuffer->pBuffer;
+            frameInfo.frameSize = pTxBuffer->txFrameSize;
+            if ((ret = dllk_processTpdo(&frameInfo, FALSE)) != kErrorOk)
+                return ret;
+#endif
+
+            if ((ret = dllk_updateFramePres(pTxBuffer, nmtState_p)) != kErrorOk)
+                return ret;
+        }
+    }
+
+    return ret;
+}
+#endif
+
 #if defined(CONFIG_INCLUDE_NMT_MN)
 //------------------------------------------------------------------------------
 /**
@@ -1041,16 +1301,17 @@ static tOplkError processStartReducedCycle(void)
     dllkInstance_g.cycleCount = 0;
 
     // remove any CN from isochronous phase
-    while (dllkInstance_g.pFirstNodeInfo != NULL)
+    // the last node is removed first, so no array entries need to be moved
+    while (dllkInstance_g.isochrNodeCount > 0)
     {
-        ret = dllk_deleteNodeIsochronous(dllkInstance_g.pFirstNodeInfo);
+        ret = dllk_deleteNodeIsochronous(dllkInstance_g.apIsochrNodeInfo[dllkInstance_g.isochrNodeCount - 1]);
         if (ret != kErrorOk)
             goto Exit;
     }
 
-    while (dllkInstance_g.pFirstPrcNodeInfo != NULL)
+    while (dllkInstance_g.prcNodeCount > 0)
     {
-        ret = dllk_deleteNodeIsochronous(dllkInstance_g.pFirstPrcNodeInfo);
+        ret = dllk_deleteNodeIsochronous(dllkInstance_g.apPrcNodeInfo[dllkInstance_g.prcNodeCount - 1]);
         if (ret != kErrorOk)
             goto Exit;
     }
@@ -1059,6 +1320,10 @@ static tOplkError processStartReducedCycle(void)
     // hence changeState() will not ignore the next call
     dllkInstance_g.dllState = kDllMsNonCyclic;
 
+#if (CONFIG_DLL_PREOP1_IDLE_SLOT_TIME_MAX != 0)
+    dllkInstance_g.idleSlotTime = 0;
+#endif
+
 #if CONFIG_TIMER_USE_HIGHRES != FALSE
     if (dllkInstance_g.dllConfigParam.asyncSlotTimeout != 0)
     {
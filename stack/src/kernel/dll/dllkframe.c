@@ -43,6 +43,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stddef.h>
 
 #include <common/ami.h>
+#include <common/cyclestat.h>
+#include <common/flightrec.h>
+#include <common/target.h>
 #include "dllk-internal.h"
 
 //============================================================================//
@@ -70,6 +73,16 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // const defines
 //------------------------------------------------------------------------------
 
+#if (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE)
+// The adapted PRes timeout of a CN is the decaying maximum of its measured
+// response times plus a relative and an absolute margin. It is applied after
+// a minimum number of measurements.
+#define DLLK_PRES_TIMEOUT_MIN_SAMPLES       1000
+#define DLLK_PRES_TIMEOUT_MARGIN_SHIFT      2       // relative margin of 1/4
+#define DLLK_PRES_TIMEOUT_MARGIN_NS         10000
+#define DLLK_PRES_TIMEOUT_DECAY_SHIFT       10
+#endif
+
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
@@ -90,19 +103,42 @@ static tOplkError processReceivedSoa(tEdrvRxBuffer* pRxBuffer_p, tNmtState nmtSt
 static tOplkError processReceivedAsnd(tFrameInfo* pFrameInfo_p, tEdrvRxBuffer* pRxBuffer_p,
                                       tNmtState nmtState_p, tEdrvReleaseRxBuffer* pReleaseRxBuffer_p);
 static tOplkError forwardRpdo(tFrameInfo* pFrameInfo_p);
+static BOOL       isAsndForwardLimited(tFrameInfo* pFrameInfo_p, UINT asndServiceId_p);
 static void       postInvalidFormatError(UINT nodeId_p, tNmtState nmtState_p);
 static BOOL       presFrameFormatIsInvalid(tFrameInfo* pFrameInfo_p, tDllkNodeInfo* pIntNodeInfo_p,
                                            tNmtState nodeNmtState_p);
+#if (CONFIG_DLL_PRES_NODE_FILTER != FALSE) && (NMT_MAX_NODE_ID > 0)
+static BOOL       presFrameIsFiltered(tPlkFrame* pFrame_p, tNmtState nmtState_p);
+#endif
+#if (CONFIG_DLL_PRES_LATE_BINDING != FALSE)
+static tOplkError startPresFillTimer(tNmtState nmtState_p);
+static void       measurePreqOffset(void);
+#endif
 
 #if defined(CONFIG_INCLUDE_NMT_MN)
 static tOplkError checkAndSetSyncEvent(BOOL fPrcSlotFinished_p, UINT nodeId_p);
 static tOplkError updateNode(tDllkNodeInfo* pIntNodeInfo_p, UINT nodeId_p, tNmtState nodeNmtState_p);
 static tOplkError searchNodeInfo(UINT nodeId_p, tDllkNodeInfo** ppIntNodeInfo_p, BOOL* pfPrcSlotFinished_p);
+#if (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE)
+static void       updatePresTimeout(tDllkNodeInfo* pIntNodeInfo_p, ULONGLONG latency_p);
+#endif
+#if (DLLK_PRES_WIRE_LATENCY != FALSE)
+static void       updateWireLatency(tDllkNodeInfo* pIntNodeInfo_p);
+#endif
 #endif
 
 #if defined(CONFIG_INCLUDE_NMT_MN)
 static void       handleErrorSignaling(tPlkFrame* pFrame_p, UINT nodeId_p);
+#if (CONFIG_DLL_PREOP1_FAST_BOOT != FALSE) && (CONFIG_TIMER_USE_HIGHRES != FALSE)
+static UINT32     getReducedCycleTime(void);
+#endif
+#if (CONFIG_DLL_PREOP1_IDLE_SLOT_TIME_MAX != 0) && (CONFIG_TIMER_USE_HIGHRES != FALSE)
+static UINT32     getIdleCycleTime(UINT32 reducedCycleTime_p);
 #endif
+#endif
+
+static void       setupFrameTemplate(tDllkFrameTemplate* pTemplate_p, tMsgType msgType_p,
+                                     tDllAsndServiceId serviceId_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -170,14 +206,13 @@ tEdrvReleaseRxBuffer dllk_processFrameReceived(tEdrvRxBuffer* pRxBuffer_p)
 #if (CONFIG_DLL_PRES_READY_AFTER_SOA != FALSE) || (CONFIG_DLL_PRES_READY_AFTER_SOC != FALSE)
                     Ret = edrv_startTxBuffer(pTxBuffer);
 #else
-                    pTxFrame = (tPlkFrame*)pTxBuffer->pBuffer;
                     // update frame (NMT state, RD, RS, PR, MS, EN flags)
-                    ami_setUint8Le(&pTxFrame->data.pres.nmtStatus, (BYTE)nmtState);
-                    ami_setUint8Le(&pTxFrame->data.pres.flag2, dllkInstance_g.flag2);
+                    dllk_patchFrame(pTxBuffer, DLLK_FRAME_FIELD_NMTSTATUS, (UINT8)nmtState);
+                    dllk_patchFrame(pTxBuffer, DLLK_FRAME_FIELD_FLAG2, dllkInstance_g.flag2);
                     if (nmtState != kNmtCsOperational)
                     {   // mark PDO as invalid in NMT state Op
                         // $$$ reset only RD flag; set other flags appropriately
-                        ami_setUint8Le(&pTxFrame->data.pres.flag1, 0);
+                        dllk_patchFrame(pTxBuffer, DLLK_FRAME_FIELD_FLAG1, 0);
                     }
                     // $$$ make function that updates Pres, StatusRes
                     // send PRes frame
@@ -200,6 +235,9 @@ tEdrvReleaseRxBuffer dllk_processFrameReceived(tEdrvRxBuffer* pRxBuffer_p)
 
     frameInfo.pFrame = pFrame;
     frameInfo.frameSize = pRxBuffer_p->rxFrameSize;
+#if (DLLK_PRES_WIRE_LATENCY != FALSE)
+    dllkInstance_g.rxTimeStampNs = pRxBuffer_p->rxTimeStampNs;
+#endif
 
     if (ami_getUint16Be(&pFrame->etherType) != C_DLL_ETHERTYPE_EPL)
     {   // non-POWERLINK frame
@@ -212,6 +250,13 @@ tEdrvReleaseRxBuffer dllk_processFrameReceived(tEdrvRxBuffer* pRxBuffer_p)
     }
 
     msgType = (tMsgType)ami_getUint8Le(&pFrame->messageType);
+
+#if (CONFIG_FLIGHT_RECORDER != FALSE)
+    // a received SoC is recorded in the cycle it starts
+    if (msgType != kMsgTypeSoc)
+        flightrec_recordFrame(pFrame, pRxBuffer_p->rxFrameSize, FALSE);
+#endif
+
     switch (msgType)
     {
         case kMsgTypePreq:
@@ -226,6 +271,12 @@ tEdrvReleaseRxBuffer dllk_processFrameReceived(tEdrvRxBuffer* pRxBuffer_p)
             break;
 
         case kMsgTypePres:
+#if (CONFIG_DLL_PRES_NODE_FILTER != FALSE) && (NMT_MAX_NODE_ID > 0)
+            if (presFrameIsFiltered(pFrame, nmtState))
+            {   // nobody consumes this PRes
+                goto Exit;
+            }
+#endif
             ret = processReceivedPres(&frameInfo, nmtState, &nmtEvent, &releaseRxBuffer);
             if (ret != kErrorOk)
                 goto Exit;
@@ -477,6 +528,14 @@ void dllk_processTransmittedSoc(tEdrvTxBuffer* pTxBuffer_p)
     if (nmtState <= kNmtGsResetConfiguration)
         goto Exit;
 
+    CYCLESTAT_START_CYCLE();
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+    CYCLESTAT_MARK_SOC_WIRE(pTxBuffer_p->txTimeStampNs);
+#endif
+    BINTRACE0(kBinTraceIdDllkSocTx);
+    FLIGHTREC_START_CYCLE();
+    FLIGHTREC_RECORD_FRAME(pTxBuffer_p->pBuffer, pTxBuffer_p->txFrameSize, TRUE);
+
     // SoC frame sent
     ret = dllk_changeState(kNmtEventDllMeAsndTimeout, nmtState);
     if (ret != kErrorOk)
@@ -512,6 +571,12 @@ void dllk_processTransmittedSoa(tEdrvTxBuffer* pTxBuffer_p)
     tNmtState       nmtState;
     UINT            handle = DLLK_TXFRAME_SOA;
     UINT32          arg;
+#if CONFIG_TIMER_USE_HIGHRES != FALSE
+    UINT32          reducedCycleTime;
+#if (CONFIG_DLL_PREOP1_FAST_BOOT != FALSE)
+    BOOL            fCnInvited;
+#endif
+#endif
 
     TGT_DLLK_DECLARE_FLAGS
 
@@ -523,6 +588,14 @@ void dllk_processTransmittedSoa(tEdrvTxBuffer* pTxBuffer_p)
     if (nmtState <= kNmtGsResetConfiguration)
         goto Exit;
 
+    FLIGHTREC_RECORD_FRAME(pTxBuffer_p->pBuffer, pTxBuffer_p->txFrameSize, TRUE);
+
+#if (CONFIG_TIMER_USE_HIGHRES != FALSE) && (CONFIG_DLL_PREOP1_FAST_BOOT != FALSE)
+    // the next SoA needs not to wait for a response if no CN is invited
+    fCnInvited = ((dllkInstance_g.aLastReqServiceId[dllkInstance_g.curLastSoaReq] != kDllReqServiceNo) &&
+                  (dllkInstance_g.aLastTargetNodeId[dllkInstance_g.curLastSoaReq] != dllkInstance_g.dllConfigParam.nodeId));
+#endif
+
     // SoA frame sent
     // check if we are invited
     // old handling only in PreOp1
@@ -597,8 +670,15 @@ void dllk_processTransmittedSoa(tEdrvTxBuffer* pTxBuffer_p)
     if ((dllkInstance_g.dllState == kDllMsNonCyclic) &&
         (dllkInstance_g.dllConfigParam.asyncSlotTimeout != 0))
     {
-        ret = hrestimer_modifyTimer(&dllkInstance_g.timerHdlCycle,
-                                    dllkInstance_g.dllConfigParam.asyncSlotTimeout,
+        reducedCycleTime = dllkInstance_g.dllConfigParam.asyncSlotTimeout;
+#if (CONFIG_DLL_PREOP1_FAST_BOOT != FALSE)
+        if (!fCnInvited)
+            reducedCycleTime = getReducedCycleTime();
+#endif
+#if (CONFIG_DLL_PREOP1_IDLE_SLOT_TIME_MAX != 0)
+        reducedCycleTime = getIdleCycleTime(reducedCycleTime);
+#endif
+        ret = hrestimer_modifyTimer(&dllkInstance_g.timerHdlCycle, reducedCycleTime,
                                     dllk_cbMnTimerCycle, 0L, FALSE);
         if (ret != kErrorOk)
             goto Exit;
@@ -630,6 +710,77 @@ Exit:
     TGT_DLLK_LEAVE_CRITICAL_SECTION()
     return;
 }
+
+#if (CONFIG_CYCLE_STATISTICS != FALSE) || (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Callback function for transmitted PReq frame
+
+The function implements the callback function which is called when a PReq
+frame was transmitted. It records the transmission time of the PReq in the
+cycle statistics and for the adaptation of the PRes timeout. If the Ethernet
+driver provides hardware time stamps, the transmission time on the wire is
+recorded, too.
+
+\param  pTxBuffer_p         Pointer to TxBuffer structure of transmitted frame.
+
+*/
+//------------------------------------------------------------------------------
+void dllk_processTransmittedPreq(tEdrvTxBuffer* pTxBuffer_p)
+{
+    tPlkFrame*      pTxFrame = (tPlkFrame*)pTxBuffer_p->pBuffer;
+    UINT            nodeId;
+#if (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE) || (DLLK_PRES_WIRE_LATENCY != FALSE)
+    tDllkNodeInfo*  pIntNodeInfo;
+#endif
+
+    nodeId = ami_getUint8Le(&pTxFrame->dstNodeId);
+
+    CYCLESTAT_MARK_PREQ_TX(nodeId);
+    BINTRACE1(kBinTraceIdDllkPreqTx, nodeId);
+    FLIGHTREC_RECORD_FRAME(pTxFrame, pTxBuffer_p->txFrameSize, TRUE);
+
+#if (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE) || (DLLK_PRES_WIRE_LATENCY != FALSE)
+    pIntNodeInfo = dllk_getNodeInfo(nodeId);
+    if (pIntNodeInfo == NULL)
+        return;
+
+#if (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE)
+    pIntNodeInfo->preqTxTimeNs = target_getCurrentTimestamp();
+#endif
+#if (DLLK_PRES_WIRE_LATENCY != FALSE)
+    // The completion of the PReq may be signaled after the reception of the PRes
+    pIntNodeInfo->preqTxWireTimeNs = pTxBuffer_p->txTimeStampNs;
+    updateWireLatency(pIntNodeInfo);
+#endif
+#endif
+}
+#endif
+
+#if (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Reset adapted PRes timeout
+
+The function resets the PRes timeout of a CN to its configured value
+(object 0x1F92) and restarts the measurement of its response times. It is
+called when the CN is configured and when its PRes was lost.
+
+\param  pIntNodeInfo_p      Pointer to internal node info structure.
+*/
+//------------------------------------------------------------------------------
+void dllk_resetPresTimeout(tDllkNodeInfo* pIntNodeInfo_p)
+{
+    pIntNodeInfo_p->presLatencyCount = 0;
+    pIntNodeInfo_p->presLatencyMaxNs = 0;
+    pIntNodeInfo_p->preqTxTimeNs = 0;
+    pIntNodeInfo_p->adaptPresTimeoutNs = pIntNodeInfo_p->presTimeoutNs;
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+    pIntNodeInfo_p->preqTxWireTimeNs = 0;
+    pIntNodeInfo_p->presRxWireTimeNs = 0;
+#endif
+}
+#endif
 #endif
 
 //------------------------------------------------------------------------------
@@ -647,13 +798,10 @@ The function updates an IdentResponse frame with the specified information.
 tOplkError dllk_updateFrameIdentRes(tEdrvTxBuffer* pTxBuffer_p, tNmtState nmtState_p)
 {
     tOplkError      ret = kErrorOk;
-    tPlkFrame*      pTxFrame;
-
-    pTxFrame = (tPlkFrame*)pTxBuffer_p->pBuffer;
 
     // update frame (NMT state, RD, RS, PR flags)
-    ami_setUint8Le(&pTxFrame->data.asnd.payload.identResponse.nmtStatus, (UINT8)nmtState_p);
-    ami_setUint8Le(&pTxFrame->data.asnd.payload.identResponse.flag2, dllkInstance_g.flag2);
+    dllk_patchFrame(pTxBuffer_p, DLLK_FRAME_FIELD_NMTSTATUS, (UINT8)nmtState_p);
+    dllk_patchFrame(pTxBuffer_p, DLLK_FRAME_FIELD_FLAG2, dllkInstance_g.flag2);
 
 #if (CONFIG_EDRV_AUTO_RESPONSE != FALSE)
     if (nmtState_p < kNmtMsNotActive)
@@ -680,14 +828,11 @@ The function updates a StatusResponse frame with the specified information.
 tOplkError dllk_updateFrameStatusRes(tEdrvTxBuffer* pTxBuffer_p, tNmtState nmtState_p)
 {
     tOplkError      ret = kErrorOk;
-    tPlkFrame*      pTxFrame;
-
-    pTxFrame = (tPlkFrame*)pTxBuffer_p->pBuffer;
 
     // update frame (NMT state, RD, RS, PR, EC, EN flags)
-    ami_setUint8Le(&pTxFrame->data.asnd.payload.statusResponse.nmtStatus, (UINT8)nmtState_p);
-    ami_setUint8Le(&pTxFrame->data.asnd.payload.statusResponse.flag2, dllkInstance_g.flag2);
-    ami_setUint8Le(&pTxFrame->data.asnd.payload.statusResponse.flag1, dllkInstance_g.flag1);
+    dllk_patchFrame(pTxBuffer_p, DLLK_FRAME_FIELD_NMTSTATUS, (UINT8)nmtState_p);
+    dllk_patchFrame(pTxBuffer_p, DLLK_FRAME_FIELD_FLAG2, dllkInstance_g.flag2);
+    dllk_patchFrame(pTxBuffer_p, DLLK_FRAME_FIELD_FLAG1, dllkInstance_g.flag1);
 
 #if (CONFIG_EDRV_AUTO_RESPONSE != FALSE)
     if (nmtState_p < kNmtMsNotActive)
@@ -720,8 +865,8 @@ tOplkError dllk_updateFramePres(tEdrvTxBuffer* pTxBuffer_p, tNmtState nmtState_p
     pTxFrame = (tPlkFrame*)pTxBuffer_p->pBuffer;
 
     // update frame (NMT state, RD, RS, PR, MS, EN flags)
-    ami_setUint8Le(&pTxFrame->data.pres.nmtStatus, (BYTE) nmtState_p);
-    ami_setUint8Le(&pTxFrame->data.pres.flag2, dllkInstance_g.flag2);
+    dllk_patchFrame(pTxBuffer_p, DLLK_FRAME_FIELD_NMTSTATUS, (UINT8)nmtState_p);
+    dllk_patchFrame(pTxBuffer_p, DLLK_FRAME_FIELD_FLAG2, dllkInstance_g.flag2);
 
     // get RD flag
     flag1 = ami_getUint8Le(&pTxFrame->data.pres.flag1) & PLK_FRAME_FLAG1_RD;
@@ -739,7 +884,7 @@ tOplkError dllk_updateFramePres(tEdrvTxBuffer* pTxBuffer_p, tNmtState nmtState_p
     {   // mark PDO as invalid in all NMT states but OPERATIONAL - reset only RD flag
         flag1 &= ~PLK_FRAME_FLAG1_RD;
     }
-    ami_setUint8Le(&pTxFrame->data.pres.flag1, flag1);        // update frame (flag1)
+    dllk_patchFrame(pTxBuffer_p, DLLK_FRAME_FIELD_FLAG1, flag1);     // update frame (flag1)
 
 #if (CONFIG_EDRV_AUTO_RESPONSE != FALSE)
 //    if (NmtState_p < kNmtMsNotActive)
@@ -777,7 +922,7 @@ tOplkError dllk_checkFrame(tPlkFrame* pFrame_p, UINT frameSize_p)
         if (ami_getUint48Be(pFrame_p->aSrcMac) == 0)
         {
             // source MAC address
-            OPLK_MEMCPY(&pFrame_p->aSrcMac[0], &dllkInstance_g.aLocalMac[0], 6);
+            OPLK_MEMCPY_FIXED(&pFrame_p->aSrcMac[0], &dllkInstance_g.aLocalMac[0], 6);
         }
 
         // check ethertype
@@ -815,6 +960,63 @@ tOplkError dllk_checkFrame(tPlkFrame* pFrame_p, UINT frameSize_p)
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Patch dynamic field of TX frame
+
+The function updates a dynamic header field of a TX frame. The field is
+located by the template of the frame and is only written if its value changes.
+Therefore, frames which don't change cause no writes to the frame buffer.
+
+\param  pTxBuffer_p         Pointer to TX buffer of frame.
+\param  field_p             Dynamic field to be updated (DLLK_FRAME_FIELD_xxx).
+\param  value_p             New value of the field.
+
+\return The function returns TRUE if the frame was changed, otherwise FALSE.
+*/
+//------------------------------------------------------------------------------
+BOOL dllk_patchFrame(tEdrvTxBuffer* pTxBuffer_p, UINT field_p, UINT8 value_p)
+{
+    UINT    offset;
+    UINT8*  pField;
+
+    offset = dllkInstance_g.pFrameTemplate[pTxBuffer_p - dllkInstance_g.pTxBuffer].aFieldOffset[field_p];
+    if (offset == 0)
+        return FALSE;       // field is not part of this frame
+
+    pField = pTxBuffer_p->pBuffer + offset;
+    if (ami_getUint8Le(pField) == value_p)
+        return FALSE;
+
+    ami_setUint8Le(pField, value_p);
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check dynamic field of TX frame
+
+The function checks whether a dynamic header field of a TX frame differs from
+the specified value. The frame is not modified.
+
+\param  pTxBuffer_p         Pointer to TX buffer of frame.
+\param  field_p             Dynamic field to be checked (DLLK_FRAME_FIELD_xxx).
+\param  value_p             Value to be compared with the field.
+
+\return The function returns TRUE if the field differs, otherwise FALSE.
+*/
+//------------------------------------------------------------------------------
+BOOL dllk_checkFrameField(tEdrvTxBuffer* pTxBuffer_p, UINT field_p, UINT8 value_p)
+{
+    UINT    offset;
+
+    offset = dllkInstance_g.pFrameTemplate[pTxBuffer_p - dllkInstance_g.pTxBuffer].aFieldOffset[field_p];
+    if (offset == 0)
+        return FALSE;       // field is not part of this frame
+
+    return (ami_getUint8Le(pTxBuffer_p->pBuffer + offset) != value_p);
+}
+
 #if defined (CONFIG_INCLUDE_NMT_MN)
 //------------------------------------------------------------------------------
 /**
@@ -933,12 +1135,12 @@ tOplkError dllk_updateFrameSoa(tEdrvTxBuffer* pTxBuffer_p, tNmtState nmtState_p,
             // Update EA/ER flag only for StatusReq
             if (dllkInstance_g.aLastReqServiceId[curReq_p] == kDllReqServiceStatus)
             {
-                ami_setUint8Le(&pTxFrame->data.soa.flag1,
-                               pNodeInfo->soaFlag1 & (PLK_FRAME_FLAG1_EA | PLK_FRAME_FLAG1_ER));
+                dllk_patchFrame(pTxBuffer_p, DLLK_FRAME_FIELD_FLAG1,
+                                pNodeInfo->soaFlag1 & (PLK_FRAME_FLAG1_EA | PLK_FRAME_FLAG1_ER));
             }
             else
             {
-                pTxFrame->data.soa.flag1 = 0;
+                dllk_patchFrame(pTxBuffer_p, DLLK_FRAME_FIELD_FLAG1, 0);
             }
         }
         else
@@ -953,12 +1155,12 @@ tOplkError dllk_updateFrameSoa(tEdrvTxBuffer* pTxBuffer_p, tNmtState nmtState_p,
     }
 
     // update frame (target)
-    ami_setUint8Le(&pTxFrame->data.soa.reqServiceId,
-                   (UINT8)dllkInstance_g.aLastReqServiceId[curReq_p]);
-    ami_setUint8Le(&pTxFrame->data.soa.reqServiceTarget,
-                   (UINT8)dllkInstance_g.aLastTargetNodeId[curReq_p]);
+    dllk_patchFrame(pTxBuffer_p, DLLK_FRAME_FIELD_REQSERVICEID,
+                    (UINT8)dllkInstance_g.aLastReqServiceId[curReq_p]);
+    dllk_patchFrame(pTxBuffer_p, DLLK_FRAME_FIELD_REQTARGET,
+                    (UINT8)dllkInstance_g.aLastTargetNodeId[curReq_p]);
     // update frame (NMT state)
-    ami_setUint8Le(&pTxFrame->data.soa.nmtStatus, (BYTE)nmtState_p);
+    dllk_patchFrame(pTxBuffer_p, DLLK_FRAME_FIELD_NMTSTATUS, (UINT8)nmtState_p);
 
     return ret;
 }
@@ -1165,7 +1367,7 @@ tOplkError dllk_createTxFrame (UINT* pHandle_p, UINT* pFrameSize_p,
         {   // fill out Frame only if it is a POWERLINK frame
             ami_setUint16Be(&pTxFrame->etherType, C_DLL_ETHERTYPE_EPL);
             ami_setUint8Le(&pTxFrame->srcNodeId, (BYTE) dllkInstance_g.dllConfigParam.nodeId);
-            OPLK_MEMCPY(&pTxFrame->aSrcMac[0], &dllkInstance_g.aLocalMac[0], 6);
+            OPLK_MEMCPY_FIXED(&pTxFrame->aSrcMac[0], &dllkInstance_g.aLocalMac[0], 6);
 
             switch (msgType_p)
             {
@@ -1278,6 +1480,11 @@ tOplkError dllk_createTxFrame (UINT* pHandle_p, UINT* pFrameSize_p,
             // POWERLINK message type
             ami_setUint8Le(&pTxFrame->messageType, (BYTE)msgType_p);
         }
+
+        setupFrameTemplate(&dllkInstance_g.pFrameTemplate[handle], msgType_p, serviceId_p);
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+        dllkInstance_g.pFrameTemplate[handle].pEdrvBuffer = pTxBuffer->pBuffer;
+#endif
     }
 
     *pFrameSize_p = pTxBuffer->maxBufferSize;
@@ -1317,6 +1524,12 @@ tOplkError dllk_deleteTxFrame (UINT handle_p)
         // $$$ d.k. What's up with running transmissions?
         pTxBuffer->txFrameSize = DLLK_BUFLEN_EMPTY;
 
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+        // the frame may currently be sent from the TPDO buffer
+        if (dllkInstance_g.pFrameTemplate[handle_p].pEdrvBuffer != NULL)
+            pTxBuffer->pBuffer = dllkInstance_g.pFrameTemplate[handle_p].pEdrvBuffer;
+#endif
+
         ret = edrv_freeTxBuffer(pTxBuffer);
         if (ret != kErrorOk)
         {   // error occurred while releasing Tx frame
@@ -1324,6 +1537,7 @@ tOplkError dllk_deleteTxFrame (UINT handle_p)
         }
 
         pTxBuffer->pBuffer = NULL;
+        OPLK_MEMSET(&dllkInstance_g.pFrameTemplate[handle_p], 0, sizeof(tDllkFrameTemplate));
     }
 
     return ret;
@@ -1353,6 +1567,48 @@ tOplkError dllk_processTpdo(tFrameInfo* pFrameInfo_p, BOOL fReadyFlag_p)
     return ret;
 }
 
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Process TPDO frame without copying the payload
+
+The function forwards the specified TPDO frame to the zero-copy callback of the
+PDO module. The frame is always handed over in the frame buffer of the Ethernet
+driver, which holds the current frame header. If the PDO module returns a frame
+located in the TPDO buffer, the Tx buffer is switched to this frame. The caller
+must update the frame in the Ethernet driver afterwards.
+
+\param  pTxBuffer_p         Pointer to Tx buffer of the frame.
+\param  fReadyFlag_p        Ready flag.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+tOplkError dllk_processTpdoZeroCopy(tEdrvTxBuffer* pTxBuffer_p, BOOL fReadyFlag_p)
+{
+    tOplkError          ret = kErrorOk;
+    tFrameInfo          frameInfo;
+    tDllkFrameTemplate* pTemplate;
+
+    pTemplate = &dllkInstance_g.pFrameTemplate[pTxBuffer_p - dllkInstance_g.pTxBuffer];
+    pTxBuffer_p->pBuffer = pTemplate->pEdrvBuffer;
+
+    frameInfo.pFrame = (tPlkFrame*)pTxBuffer_p->pBuffer;
+    frameInfo.frameSize = pTxBuffer_p->txFrameSize;
+    if (dllkInstance_g.pfnCbProcessTpdoZeroCopy != NULL)
+    {
+        ret = dllkInstance_g.pfnCbProcessTpdoZeroCopy(&frameInfo, fReadyFlag_p);
+        pTxBuffer_p->pBuffer = (UINT8*)frameInfo.pFrame;
+    }
+    else
+    {
+        ret = dllk_processTpdo(&frameInfo, fReadyFlag_p);
+    }
+
+    return ret;
+}
+#endif
+
 //----------------------------------------------------------------------------//
 //                L O C A L   F U N C T I O N S                               //
 //----------------------------------------------------------------------------//
@@ -1406,6 +1662,10 @@ static tOplkError processReceivedPreq(tFrameInfo* pFrameInfo_p, tNmtState nmtSta
         goto Exit;
     }
 
+#if (CONFIG_DLL_PRES_LATE_BINDING != FALSE)
+    measurePreqOffset();
+#endif
+
 #if CONFIG_EDRV_EARLY_RX_INT == FALSE
     if (nmtState_p >= kNmtCsPreOperational2)
     {   // respond to and process PReq frames only in PreOp2, ReadyToOp and Op
@@ -1485,7 +1745,12 @@ Exit:
 /**
 \brief  Check for a invalid PRes frame
 
-The function checks if a PRes frame is invalid.
+The function checks if a PRes frame is invalid. The frame must be large
+enough for the contained payload size. If the node is in a cyclic state, the
+frame must additionally not exceed the frame size limit of the node, which is
+precomputed from its payload limit by dllk_configNode(). Because the payload
+size is bounded by the frame size, this also ensures that the payload limit
+isn't exceeded, so a valid frame costs only two comparisons.
 
 \param  pFrameInfo_p        Pointer to frame information.
 \param  pIntNodeInfo_p      Pointer to node information.
@@ -1498,33 +1763,64 @@ The function checks if a PRes frame is invalid.
 static BOOL presFrameFormatIsInvalid(tFrameInfo* pFrameInfo_p, tDllkNodeInfo* pIntNodeInfo_p,
                                      tNmtState nodeNmtState_p)
 {
-    tPlkFrame*  pFrame = pFrameInfo_p->pFrame;
-    size_t      frameSize = pFrameInfo_p->frameSize;
-    size_t      payloadSize = ami_getUint16Le(&pFrame->data.pres.sizeLe);
+    UINT    frameSize = pFrameInfo_p->frameSize;
+    UINT    minFrameSize = ami_getUint16Le(&pFrameInfo_p->pFrame->data.pres.sizeLe) +
+                           PLK_FRAME_OFFSET_PDO_PAYLOAD;
 
 #if (NMT_MAX_NODE_ID > 0)
-    size_t      payloadLimit = pIntNodeInfo_p->presPayloadLimit;
+    // Additional check for MN and CN which can handle cross-traffic
+    if ((nodeNmtState_p & 0xFF) > (kNmtCsPreOperational2 & 0xFF))
+        return ((frameSize < minFrameSize) || (frameSize > pIntNodeInfo_p->presFrameSizeLimit));
 #else
     UNUSED_PARAMETER(pIntNodeInfo_p);
     UNUSED_PARAMETER(nodeNmtState_p);
 #endif
 
-    // Check if frame is too small for contained payload size
-    if ((payloadSize + PLK_FRAME_OFFSET_PDO_PAYLOAD) > frameSize)
-        return TRUE;
+    return (frameSize < minFrameSize);
+}
 
-    // Additional checks for MN and CN which can handle cross-traffic
-#if (NMT_MAX_NODE_ID > 0)
-    if ((nodeNmtState_p & 0xFF) > (kNmtCsPreOperational2 & 0xFF))
-    {
-        if ((payloadSize > payloadLimit) ||                                     // payload limit is exceeded
-            (frameSize > (payloadLimit + PLK_FRAME_OFFSET_PDO_PAYLOAD)))        // frame is too big for payload limit
-            return TRUE;
-    }
+#if (CONFIG_DLL_PRES_NODE_FILTER != FALSE) && (NMT_MAX_NODE_ID > 0)
+//------------------------------------------------------------------------------
+/**
+\brief  Check if a PRes frame is filtered
+
+The function checks if a received PRes frame is dropped by the per-node PRes
+filter of a CN. With a single PRes Rx filter (CONFIG_DLL_PRES_FILTER_COUNT < 0)
+or an Ethernet driver without Rx filters, a cross-traffic CN receives the PRes
+of every node in the cycle. The PRes of nodes whose RPDOs and heartbeat are not
+consumed (see dllk_addNodeFilter()) are dropped here like a per-node Rx filter
+would do it, so they don't cost the PRes processing.
+
+\param  pFrame_p            Pointer to the received PRes frame.
+\param  nmtState_p          NMT state of the local node.
+
+\return The function returns TRUE if the frame shall be dropped.
+*/
+//------------------------------------------------------------------------------
+static BOOL presFrameIsFiltered(tPlkFrame* pFrame_p, tNmtState nmtState_p)
+{
+    UINT            nodeId;
+    tDllkNodeInfo*  pIntNodeInfo;
+
+    // only the cyclic states of a CN process PRes frames of other nodes
+    if ((nmtState_p < kNmtCsPreOperational2) || (nmtState_p > kNmtCsOperational))
+        return FALSE;
+
+    nodeId = ami_getUint8Le(&pFrame_p->srcNodeId);
+
+#if (CONFIG_DLL_PRES_CHAINING_CN != FALSE)
+    // the PResMN is handled as PReq with PRes Chaining
+    if ((dllkInstance_g.fPrcEnabled != FALSE) && (nodeId == C_ADR_MN_DEF_NODE_ID))
+        return FALSE;
 #endif
 
-    return FALSE;
+    pIntNodeInfo = dllk_getNodeInfo(nodeId);
+    if (pIntNodeInfo == NULL)
+        return FALSE;   // processReceivedPres() reports the missing node info
+
+    return ((pIntNodeInfo->presFilterFlags & (DLLK_FILTER_FLAG_PDO | DLLK_FILTER_FLAG_HB)) == 0);
 }
+#endif
 
 #if defined(CONFIG_INCLUDE_NMT_MN)
 //------------------------------------------------------------------------------
@@ -1639,6 +1935,12 @@ the PRes frame. For all nodes between the one we received the last PRes and
 this node we issue a loss of PRes. The node information of the node will
 be stored at \p ppIntNodeInfo_p.
 
+The position of the node in the current node-ID list is taken from the lookup
+table which is set up with the list, so the search doesn't depend on the number
+of nodes in the isochronous phase. The node and the skipped nodes are marked as
+handled, so that only the remaining nodes are reported as lost at the end of
+the cycle.
+
 \param  nodeId_p            Node ID of node to search.
 \param  ppIntNodeInfo_p     Location to store the pointer to the node information.
 \param  pfPrcSlotFinished_p Pointer to store the flag for a finished poll response
@@ -1651,41 +1953,138 @@ static tOplkError searchNodeInfo(UINT nodeId_p, tDllkNodeInfo** ppIntNodeInfo_p,
                                  BOOL* pfPrcSlotFinished_p)
 {
     tOplkError      ret = kErrorOk;
-    UINT8           nextNodeIndex = dllkInstance_g.curNodeIndex;
-    UINT8*          pCnNodeId = &dllkInstance_g.aCnNodeIdList[dllkInstance_g.curTxBufferOffsetCycle][nextNodeIndex];
-    tDllkNodeInfo*  pIntNodeInfo = NULL;
+    UINT            curNodeIndex = dllkInstance_g.curNodeIndex;
+    UINT8*          pCnNodeIndex = dllkInstance_g.aCnNodeIndex[dllkInstance_g.curTxBufferOffsetCycle];
+    UINT8*          pCnNodeId;
+    UINT            nodeIndex;
+    UINT            prcIndex;
 
-    while (*pCnNodeId != C_ADR_INVALID)
-    {
-        if (*pCnNodeId == nodeId_p)
-        {   // CN found in list
-            nextNodeIndex = nextNodeIndex - dllkInstance_g.curNodeIndex;
-            dllkInstance_g.curNodeIndex += nextNodeIndex + 1;
+    *ppIntNodeInfo_p = NULL;
 
-            // issue error for each CN in list between last and current
-            for (pCnNodeId-- ; nextNodeIndex > 0; nextNodeIndex--, pCnNodeId--)
-            {
-                if ((ret = dllk_issueLossOfPres(*pCnNodeId)) != kErrorOk)
-                    return ret;
-            }
+    nodeIndex = (nodeId_p < C_ADR_BROADCAST) ? pCnNodeIndex[nodeId_p] : DLLK_NODE_INDEX_INVALID;
+    prcIndex = pCnNodeIndex[C_ADR_BROADCAST];
 
-            pIntNodeInfo = dllk_getNodeInfo(nodeId_p);
-            break;
-        }
-        else
-        {
-            if (*pCnNodeId == C_ADR_BROADCAST)
-                *pfPrcSlotFinished_p = TRUE;        // PRC slot finished
-        }
+    if ((nodeIndex == DLLK_NODE_INDEX_INVALID) || (nodeIndex < curNodeIndex))
+    {   // CN not found in the remaining list
+        if ((prcIndex != DLLK_NODE_INDEX_INVALID) && (prcIndex >= curNodeIndex))
+            *pfPrcSlotFinished_p = TRUE;        // PRC slot finished
+        return ret;
+    }
+
+    if ((prcIndex != DLLK_NODE_INDEX_INVALID) && (prcIndex >= curNodeIndex) && (prcIndex < nodeIndex))
+        *pfPrcSlotFinished_p = TRUE;            // PRC slot finished
+
+    dllkInstance_g.curNodeIndex = (UINT8)(nodeIndex + 1);
+
+    NODESET_ADD(&dllkInstance_g.cnHandledSet, nodeId_p);
 
-        pCnNodeId++;
-        nextNodeIndex++;
+    // issue error for each CN in list between last and current
+    pCnNodeId = &dllkInstance_g.aCnNodeIdList[dllkInstance_g.curTxBufferOffsetCycle][nodeIndex];
+    for (pCnNodeId--; nodeIndex > curNodeIndex; nodeIndex--, pCnNodeId--)
+    {
+        if (*pCnNodeId == C_ADR_BROADCAST)
+            continue;                           // PRC slot marker
+
+        NODESET_ADD(&dllkInstance_g.cnHandledSet, *pCnNodeId);
+        if ((ret = dllk_issueLossOfPres(*pCnNodeId)) != kErrorOk)
+            return ret;
     }
 
-    *ppIntNodeInfo_p = pIntNodeInfo;
+    *ppIntNodeInfo_p = dllk_getNodeInfo(nodeId_p);
     return ret;
 }
 
+#if (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Update adapted PRes timeout
+
+The function processes a measured response time of a CN from the transmission
+of its PReq to the reception of its PRes. The decaying maximum of the response
+times follows an increase immediately and a decrease slowly. After a minimum
+number of measurements, the PRes timeout which is used for the slot schedule
+is set to the maximum plus a safety margin. It never exceeds the configured
+PRes timeout.
+
+\param  pIntNodeInfo_p      Pointer to internal node info structure.
+\param  latency_p           Measured response time in ns.
+*/
+//------------------------------------------------------------------------------
+static void updatePresTimeout(tDllkNodeInfo* pIntNodeInfo_p, ULONGLONG latency_p)
+{
+    UINT32      timeout;
+
+    if (latency_p >= pIntNodeInfo_p->presTimeoutNs)
+        return;     // PRes was late or the PReq was from a previous cycle
+
+    if (latency_p >= pIntNodeInfo_p->presLatencyMaxNs)
+    {
+        pIntNodeInfo_p->presLatencyMaxNs = (UINT32)latency_p;
+    }
+    else
+    {
+        pIntNodeInfo_p->presLatencyMaxNs -= (pIntNodeInfo_p->presLatencyMaxNs - (UINT32)latency_p) >>
+                                            DLLK_PRES_TIMEOUT_DECAY_SHIFT;
+    }
+
+    if (pIntNodeInfo_p->presLatencyCount < DLLK_PRES_TIMEOUT_MIN_SAMPLES)
+    {
+        pIntNodeInfo_p->presLatencyCount++;
+        return;
+    }
+
+    timeout = pIntNodeInfo_p->presLatencyMaxNs + (pIntNodeInfo_p->presLatencyMaxNs >> DLLK_PRES_TIMEOUT_MARGIN_SHIFT) +
+              DLLK_PRES_TIMEOUT_MARGIN_NS;
+    if (timeout > pIntNodeInfo_p->presTimeoutNs)
+        timeout = pIntNodeInfo_p->presTimeoutNs;
+
+    pIntNodeInfo_p->adaptPresTimeoutNs = timeout;
+}
+#endif
+
+#if (DLLK_PRES_WIRE_LATENCY != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Update wire latency of a PRes
+
+The function determines the response time of a CN from the hardware time
+stamps of its PReq and its PRes. It is called when either of both time stamps
+is available, because the Ethernet driver may signal the completion of the
+PReq after the reception of the PRes. Each time stamp is used only once. The
+response time is recorded in the cycle statistics and is used for the
+adaptation of the PRes timeout instead of the software measured one.
+
+\param  pIntNodeInfo_p      Pointer to internal node info structure.
+*/
+//------------------------------------------------------------------------------
+static void updateWireLatency(tDllkNodeInfo* pIntNodeInfo_p)
+{
+    ULONGLONG   preqTxTime = pIntNodeInfo_p->preqTxWireTimeNs;
+    ULONGLONG   presRxTime = pIntNodeInfo_p->presRxWireTimeNs;
+    ULONGLONG   latency;
+
+    if ((preqTxTime == 0) || (presRxTime == 0))
+        return;     // other time stamp is still pending
+
+    if (presRxTime < preqTxTime)
+    {   // PRes belongs to a previous PReq
+        pIntNodeInfo_p->presRxWireTimeNs = 0;
+        return;
+    }
+
+    pIntNodeInfo_p->preqTxWireTimeNs = 0;
+    pIntNodeInfo_p->presRxWireTimeNs = 0;
+    latency = presRxTime - preqTxTime;
+    if (latency >= pIntNodeInfo_p->presTimeoutNs)
+        return;     // PRes was late or the PReq was from a previous cycle
+
+    CYCLESTAT_ADD_PRES_WIRE(pIntNodeInfo_p->nodeId, latency);
+#if (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE)
+    updatePresTimeout(pIntNodeInfo_p, latency);
+#endif
+}
+#endif
+
 #endif
 
 //------------------------------------------------------------------------------
@@ -1713,14 +2112,20 @@ static tOplkError processReceivedPres(tFrameInfo* pFrameInfo_p, tNmtState nmtSta
     tDllkNodeInfo*  pIntNodeInfo = NULL;
     tNmtState       nodeNmtState;
 
+    CYCLESTAT_MARK(kCycleStatStagePresRx);
+
     pFrame = pFrameInfo_p->pFrame;
     nodeId = ami_getUint8Le(&pFrame->srcNodeId);
 
+    CYCLESTAT_MARK_PRES_RX(nodeId);
+
     if (nodeId == C_ADR_MN_DEF_NODE_ID)
         nodeNmtState = (tNmtState)ami_getUint8Le(&pFrame->data.pres.nmtStatus) | NMT_TYPE_MS;
     else
         nodeNmtState = (tNmtState)ami_getUint8Le(&pFrame->data.pres.nmtStatus) | NMT_TYPE_CS;
 
+    BINTRACE2(kBinTraceIdDllkPresRx, nodeId, nodeNmtState);
+
 #if CONFIG_DLL_PRES_CHAINING_CN != FALSE
     // handle PResMN as PReq for PRes Chaining
     if ((dllkInstance_g.fPrcEnabled != FALSE) && (nodeId == C_ADR_MN_DEF_NODE_ID))
@@ -1758,6 +2163,24 @@ static tOplkError processReceivedPres(tFrameInfo* pFrameInfo_p, tNmtState nmtSta
                 return ret;
             }
 
+#if (DLLK_PRES_WIRE_LATENCY != FALSE)
+            if (dllkInstance_g.rxTimeStampNs != 0)
+            {   // response time is measured on the wire
+                pIntNodeInfo->presRxWireTimeNs = dllkInstance_g.rxTimeStampNs;
+#if (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE)
+                pIntNodeInfo->preqTxTimeNs = 0;
+#endif
+                updateWireLatency(pIntNodeInfo);
+            }
+#endif
+#if (CONFIG_DLL_PRES_TIMEOUT_ADAPTIVE != FALSE)
+            if (pIntNodeInfo->preqTxTimeNs != 0)
+            {   // PRes was requested and is not measured yet
+                updatePresTimeout(pIntNodeInfo, target_getCurrentTimestamp() - pIntNodeInfo->preqTxTimeNs);
+                pIntNodeInfo->preqTxTimeNs = 0;
+            }
+#endif
+
             if ((ret = checkAndSetSyncEvent(fPrcSlotFinished, nodeId)) != kErrorOk)
                 return ret;
 
@@ -1860,6 +2283,24 @@ static tOplkError processReceivedSoc(tEdrvRxBuffer* pRxBuffer_p, tNmtState nmtSt
         return ret;
     }
 
+#if (CONFIG_EDRV_RX_FILTER_BATCH != FALSE)
+    // the SoC starts a new cycle, apply the collected filter changes
+    ret = edrv_commitRxFilter();
+    if (ret != kErrorOk)
+        return ret;
+#endif
+
+    CYCLESTAT_START_CYCLE();
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+    CYCLESTAT_MARK_SOC_WIRE(pRxBuffer_p->rxTimeStampNs);
+#endif
+    BINTRACE0(kBinTraceIdDllkSocRx);
+#if (CONFIG_DLL_SOC_TIME_INFO != FALSE)
+    dllk_updateSocTime((tPlkFrame*)pRxBuffer_p->pBuffer, target_getCurrentTimestamp());
+#endif
+    FLIGHTREC_START_CYCLE();
+    FLIGHTREC_RECORD_FRAME(pRxBuffer_p->pBuffer, pRxBuffer_p->rxFrameSize, FALSE);
+
 #if CONFIG_DLL_PRES_READY_AFTER_SOC != FALSE
     // post PRes to transmit FIFO of the ethernet controller, but don't start
     // transmission over bus
@@ -1872,6 +2313,19 @@ static tOplkError processReceivedSoc(tEdrvRxBuffer* pRxBuffer_p, tNmtState nmtSt
     }
 #endif
 
+#if (CONFIG_DLL_PRES_LATE_BINDING != FALSE)
+    ret = startPresFillTimer(nmtState_p);
+    if (ret != kErrorOk)
+        return ret;
+#endif
+
+#if (CONFIG_DLL_RUNTIME_CYCLE_CHANGE != FALSE)
+    // detect a change of the cycle length before the SoC is passed to the sync timer
+    ret = dllk_switchCycleLenCn(ami_getUint64Le(&((tPlkFrame*)pRxBuffer_p->pBuffer)->data.soc.relativeTimeLe));
+    if (ret != kErrorOk)
+        return ret;
+#endif
+
     if (nmtState_p >= kNmtCsStopped)
     {   // SoC frames only in Stopped, PreOp2, ReadyToOp and Operational
 
@@ -1897,13 +2351,91 @@ static tOplkError processReceivedSoc(tEdrvRxBuffer* pRxBuffer_p, tNmtState nmtSt
 #if CONFIG_TIMER_USE_HIGHRES != FALSE
     if (dllkInstance_g.frameTimeout != 0)
     {
+#if (CONFIG_DLL_SOC_WATCHDOG != FALSE)
+        ret = dllk_feedSocWatchdog();
+#else
         hrestimer_modifyTimer(&dllkInstance_g.timerHdlCycle, dllkInstance_g.frameTimeout,
                               dllk_cbCnTimer, 0L, FALSE);
+#endif
     }
 #endif
     return ret;
 }
 
+#if (CONFIG_DLL_PRES_LATE_BINDING != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Start PRes fill timer
+
+The function is called on SoC reception. It starts the PRes fill timer, which
+expires the lead time before the expected PReq of the node. The lead time is
+the maximum measured PRes fill duration plus CONFIG_DLL_PRES_LATE_BINDING_MARGIN.
+If the PReq offset is not measured yet or is shorter than the lead time, a
+deferred PRes fill is triggered immediately.
+
+\param  nmtState_p          NMT state of the local node.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError startPresFillTimer(tNmtState nmtState_p)
+{
+    tOplkError          ret = kErrorOk;
+    tEdrvTxBuffer*      pTxBuffer;
+    ULONGLONG           leadTime;
+
+    dllkInstance_g.socRxTimeNs = target_getCurrentTimestamp();
+    dllkInstance_g.fPresFillTimer = FALSE;
+    dllkInstance_g.fPresFillExpired = FALSE;
+
+    pTxBuffer = &dllkInstance_g.pTxBuffer[DLLK_TXFRAME_PRES + dllkInstance_g.curTxBufferOffsetCycle];
+    leadTime = dllkInstance_g.presFillDurationNs + CONFIG_DLL_PRES_LATE_BINDING_MARGIN;
+    if ((nmtState_p >= kNmtCsPreOperational2) && (pTxBuffer->pBuffer != NULL) &&
+        (dllkInstance_g.preqOffsetNs > leadTime))
+    {
+        ret = hrestimer_modifyTimer(&dllkInstance_g.timerHdlPresFill,
+                                    dllkInstance_g.preqOffsetNs - leadTime,
+                                    dllk_cbCnTimerPresFill, 0L, FALSE);
+        if (ret == kErrorOk)
+            dllkInstance_g.fPresFillTimer = TRUE;
+    }
+    else if (dllkInstance_g.fPresFillPending)
+    {   // no time left before the PReq, fill the PRes as soon as possible
+        dllkInstance_g.presFillTimeNs = dllkInstance_g.socRxTimeNs;
+        ret = dllk_postEvent(kEventTypeDllkPresFill);
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure the PReq offset
+
+The function is called on PReq reception. It updates the minimum time between
+the reception of SoC and PReq and counts the PReqs which were received before
+the deferred PRes fill was completed.
+*/
+//------------------------------------------------------------------------------
+static void measurePreqOffset(void)
+{
+    ULONGLONG   offset;
+
+    if (dllkInstance_g.socRxTimeNs == 0)
+        return;
+
+    offset = target_getCurrentTimestamp() - dllkInstance_g.socRxTimeNs;
+    if (offset >= (ULONGLONG)dllkInstance_g.dllConfigParam.cycleLen * 1000)
+        return;     // SoC of this cycle was lost
+
+    if ((dllkInstance_g.preqOffsetNs == 0) || (offset < dllkInstance_g.preqOffsetNs))
+        dllkInstance_g.preqOffsetNs = offset;
+
+    if (dllkInstance_g.fPresFillPending && dllkInstance_g.fPresFillTimer)
+        dllkInstance_g.presFillMissCount++;
+}
+#endif
+
 //------------------------------------------------------------------------------
 /**
 \brief  Process received SoA frame
@@ -1939,6 +2471,14 @@ static tOplkError processReceivedSoa(tEdrvRxBuffer* pRxBuffer_p, tNmtState nmtSt
         goto Exit;
     }
 
+#if (CONFIG_EDRV_RX_FILTER_BATCH != FALSE)
+    // the SoA starts the asynchronous phase (the only one in PreOp1),
+    // apply the collected filter changes
+    ret = edrv_commitRxFilter();
+    if (ret != kErrorOk)
+        goto Exit;
+#endif
+
     // check TargetNodeId
     nodeId = ami_getUint8Le(&pFrame->data.soa.reqServiceTarget);
     if (nodeId == dllkInstance_g.dllConfigParam.nodeId)
@@ -2220,6 +2760,92 @@ Exit:
 }
 
 #if defined(CONFIG_INCLUDE_NMT_MN)
+#if (CONFIG_DLL_PREOP1_FAST_BOOT != FALSE) && (CONFIG_TIMER_USE_HIGHRES != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Get the time until the next SoA in the reduced cycle
+
+The function determines the time until the next SoA in PreOp1 if the current
+asynchronous slot is not used by a CN. As long as the asynchronous queues and
+the IdentRequest/StatusRequest queues hold at least
+CONFIG_DLL_PREOP1_FAST_QUEUE_DEPTH entries, the reduced cycle is shortened to
+the transmission time of an asynchronous frame of AsyncMTU size but at least
+CONFIG_DLL_PREOP1_FAST_SLOT_TIME. Otherwise the nominal AsyncSlotTimeout
+is used.
+
+\return The function returns the time until the next SoA in [ns].
+*/
+//------------------------------------------------------------------------------
+static UINT32 getReducedCycleTime(void)
+{
+    tDllAsyncReqPriority    priority;
+    UINT                    frameCount = 0;
+    UINT32                  cycleTime;
+
+    if (dllkcal_getAsyncTxCount(&priority, &frameCount) != kErrorOk)
+        return dllkInstance_g.dllConfigParam.asyncSlotTimeout;
+
+    if ((frameCount + dllkcal_getSoaRequestCount()) < CONFIG_DLL_PREOP1_FAST_QUEUE_DEPTH)
+        return dllkInstance_g.dllConfigParam.asyncSlotTimeout;
+
+    // an own frame sent after the SoA has to fit into the shortened cycle
+    cycleTime = ((dllkInstance_g.dllConfigParam.asyncMtu + C_DLL_T_ETH2_WRAPPER) * 8 * C_DLL_T_BITTIME) +
+                C_DLL_T_PREAMBLE + C_DLL_T_IFG;
+    if (cycleTime < CONFIG_DLL_PREOP1_FAST_SLOT_TIME)
+        cycleTime = CONFIG_DLL_PREOP1_FAST_SLOT_TIME;
+
+    if (cycleTime > dllkInstance_g.dllConfigParam.asyncSlotTimeout)
+        cycleTime = dllkInstance_g.dllConfigParam.asyncSlotTimeout;
+
+    return cycleTime;
+}
+#endif
+
+#if (CONFIG_DLL_PREOP1_IDLE_SLOT_TIME_MAX != 0) && (CONFIG_TIMER_USE_HIGHRES != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Get the time until the next SoA in an idle reduced cycle
+
+The function stretches the reduced cycle in PreOp1 while there is no demand,
+i.e. the SoA which was just sent invites no node and the asynchronous queues
+and the IdentRequest/StatusRequest queues are empty. The time until the next
+SoA is doubled with every idle slot up to CONFIG_DLL_PREOP1_IDLE_SLOT_TIME_MAX.
+As soon as there is demand again, the specified reduced cycle time is used.
+dllk_wakeReducedCycle() ends a stretched slot early if a request is queued in
+the meantime.
+
+\param  reducedCycleTime_p      Time until the next SoA in [ns] if the reduced
+                                cycle is not idle.
+
+\return The function returns the time until the next SoA in [ns].
+*/
+//------------------------------------------------------------------------------
+static UINT32 getIdleCycleTime(UINT32 reducedCycleTime_p)
+{
+    tDllAsyncReqPriority    priority;
+    UINT                    frameCount = 0;
+
+    if ((dllkInstance_g.aLastReqServiceId[dllkInstance_g.curLastSoaReq] != kDllReqServiceNo) ||
+        (dllkcal_getAsyncTxCount(&priority, &frameCount) != kErrorOk) ||
+        (frameCount != 0) || (dllkcal_getSoaRequestCount() != 0) ||
+        (reducedCycleTime_p >= CONFIG_DLL_PREOP1_IDLE_SLOT_TIME_MAX))
+    {
+        dllkInstance_g.idleSlotTime = 0;
+        return reducedCycleTime_p;
+    }
+
+    if (dllkInstance_g.idleSlotTime == 0)
+        dllkInstance_g.idleSlotTime = reducedCycleTime_p;
+
+    if (dllkInstance_g.idleSlotTime < (CONFIG_DLL_PREOP1_IDLE_SLOT_TIME_MAX / 2))
+        dllkInstance_g.idleSlotTime *= 2;
+    else
+        dllkInstance_g.idleSlotTime = CONFIG_DLL_PREOP1_IDLE_SLOT_TIME_MAX;
+
+    return dllkInstance_g.idleSlotTime;
+}
+#endif
+
 //------------------------------------------------------------------------------
 /**
 \brief  Handle MN error signaling
@@ -2363,6 +2989,8 @@ static tOplkError processReceivedAsnd(tFrameInfo* pFrameInfo_p, tEdrvRxBuffer* p
     tPlkFrame*      pFrame;
     UINT            asndServiceId;
     UINT            nodeId;
+    BOOL            fForward = FALSE;
+    BOOL            fSolicited = FALSE;
 
 #if defined(CONFIG_INCLUDE_NMT_MN)
     UINT8           flag1;
@@ -2391,6 +3019,20 @@ static tOplkError processReceivedAsnd(tFrameInfo* pFrameInfo_p, tEdrvRxBuffer* p
                     (nodeId == dllkInstance_g.aLastTargetNodeId[dllkInstance_g.curLastSoaReq]))
                 {   // mark request as responded
                     dllkInstance_g.aLastReqServiceId[dllkInstance_g.curLastSoaReq] = kDllReqServiceNo;
+                    fSolicited = TRUE;
+
+#if (CONFIG_DLL_PREOP1_FAST_BOOT != FALSE) && (CONFIG_TIMER_USE_HIGHRES != FALSE)
+                    if ((dllkInstance_g.dllState == kDllMsNonCyclic) &&
+                        (dllkInstance_g.dllConfigParam.asyncSlotTimeout != 0))
+                    {   // the asynchronous slot is finished, so do not wait
+                        // for the end of the slot timeout
+                        ret = hrestimer_modifyTimer(&dllkInstance_g.timerHdlCycle,
+                                                    getReducedCycleTime(),
+                                                    dllk_cbMnTimerCycle, 0L, FALSE);
+                        if (ret != kErrorOk)
+                            goto Exit;
+                    }
+#endif
                 }
 
                 if (((tDllAsndServiceId)asndServiceId) == kDllAsndIdentResponse)
@@ -2474,6 +3116,26 @@ static tOplkError processReceivedAsnd(tFrameInfo* pFrameInfo_p, tEdrvRxBuffer* p
 
         if (dllkInstance_g.aAsndFilter[asndServiceId] == kDllAsndFilterAny)
         {   // ASnd service ID is registered
+            fForward = TRUE;
+        }
+        else if (dllkInstance_g.aAsndFilter[asndServiceId] == kDllAsndFilterLocal)
+        {   // ASnd service ID is registered, but only local node ID or broadcasts
+            // shall be forwarded
+            nodeId = ami_getUint8Le(&pFrame->dstNodeId);
+            if ((nodeId == dllkInstance_g.dllConfigParam.nodeId) || (nodeId == C_ADR_BROADCAST))
+            {   // ASnd frame is intended for us
+                fForward = TRUE;
+            }
+        }
+
+        if ((fForward != FALSE) && (fSolicited == FALSE) &&
+            (isAsndForwardLimited(pFrameInfo_p, asndServiceId) != FALSE))
+        {   // drop frame already in the kernel
+            fForward = FALSE;
+        }
+
+        if (fForward != FALSE)
+        {
             // forward frame via async receive FIFO to userspace
             ret = dllkcal_asyncFrameReceived(pFrameInfo_p);
             if(ret == kErrorReject)
@@ -2484,29 +3146,87 @@ static tOplkError processReceivedAsnd(tFrameInfo* pFrameInfo_p, tEdrvRxBuffer* p
             else if (ret != kErrorOk)
                 goto Exit;
         }
-        else if (dllkInstance_g.aAsndFilter[asndServiceId] == kDllAsndFilterLocal)
-        {   // ASnd service ID is registered, but only local node ID or broadcasts
-            // shall be forwarded
-            nodeId = ami_getUint8Le(&pFrame->dstNodeId);
-            if ((nodeId == dllkInstance_g.dllConfigParam.nodeId) || (nodeId == C_ADR_BROADCAST))
-            {   // ASnd frame is intended for us
-                // forward frame via async receive FIFO to userspace
-                ret = dllkcal_asyncFrameReceived(pFrameInfo_p);
-                if(ret == kErrorReject)
-                {
-                    *pReleaseRxBuffer_p = kEdrvReleaseRxBufferLater;
-                    ret = kErrorOk;
-                }
-                else if (ret != kErrorOk)
-                    goto Exit;
-            }
-        }
     }
 
 Exit:
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Check forwarding limits of a received ASnd frame
+
+The function checks whether a received ASnd frame, which is not a response to
+a request of the local MN, exceeds the forwarding limits of its service ID.
+If coalescing is enabled for StatusResponses, a StatusResponse is only
+forwarded if its payload differs from the last forwarded one of the node.
+
+\param  pFrameInfo_p        Pointer to frame information.
+\param  asndServiceId_p     ASnd service ID of the frame.
+
+\return The function returns TRUE if the frame shall be dropped, otherwise
+        FALSE.
+*/
+//------------------------------------------------------------------------------
+static BOOL isAsndForwardLimited(tFrameInfo* pFrameInfo_p, UINT asndServiceId_p)
+{
+    tDllkAsndLimit*     pLimit = &dllkInstance_g.aAsndLimit[asndServiceId_p];
+    UINT32*             pLastSignature = NULL;
+    UINT32              signature = 0;
+    UINT32              tickCount;
+#if NMT_MAX_NODE_ID > 0
+    UINT8*              pPayload;
+    UINT8*              pEnd;
+    UINT                nodeId;
+
+    if ((pLimit->fCoalesce != FALSE) &&
+        (asndServiceId_p == kDllAsndStatusResponse) &&
+        (pFrameInfo_p->frameSize >= C_DLL_MINSIZE_STATUSRES))
+    {
+        nodeId = ami_getUint8Le(&pFrameInfo_p->pFrame->srcNodeId);
+        if ((nodeId > 0) && (nodeId <= tabentries(dllkInstance_g.aStatusResSignature)))
+        {
+            // FNV-1a hash over the StatusResponse payload
+            pPayload = (UINT8*)&pFrameInfo_p->pFrame->data.asnd.payload;
+            pEnd = (UINT8*)pFrameInfo_p->pFrame + pFrameInfo_p->frameSize;
+            signature = 2166136261UL ^ pFrameInfo_p->frameSize;
+            for (; pPayload < pEnd; pPayload++)
+                signature = (signature ^ *pPayload) * 16777619UL;
+
+            if (signature == 0)
+                signature = 1;
+
+            pLastSignature = &dllkInstance_g.aStatusResSignature[nodeId - 1];
+            if (*pLastSignature == signature)
+                return TRUE;
+        }
+    }
+#else
+    UNUSED_PARAMETER(pFrameInfo_p);
+#endif
+
+    if (pLimit->maxFramesPerSec != 0)
+    {
+        tickCount = target_getTickCount();
+        if ((tickCount - pLimit->windowStart) >= 1000)
+        {   // start new rate window
+            pLimit->windowStart = tickCount;
+            pLimit->frameCount = 0;
+        }
+
+        if (pLimit->frameCount >= pLimit->maxFramesPerSec)
+            return TRUE;
+
+        pLimit->frameCount++;
+    }
+
+    // remember only StatusResponses which are actually forwarded
+    if (pLastSignature != NULL)
+        *pLastSignature = signature;
+
+    return FALSE;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Forward RPDO frame
@@ -2531,5 +3251,69 @@ static tOplkError forwardRpdo(tFrameInfo* pFrameInfo_p)
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Set up TX frame template
+
+The function sets up the template of a TX frame. It stores the offsets of the
+dynamic fields which are updated during operation for the specified frame type.
+
+\param  pTemplate_p         Pointer to frame template.
+\param  msgType_p           Type of the frame.
+\param  serviceId_p         Service ID if the frame is an ASnd frame.
+*/
+//------------------------------------------------------------------------------
+static void setupFrameTemplate(tDllkFrameTemplate* pTemplate_p, tMsgType msgType_p,
+                               tDllAsndServiceId serviceId_p)
+{
+    OPLK_MEMSET(pTemplate_p, 0, sizeof(tDllkFrameTemplate));
+
+    switch (msgType_p)
+    {
+        case kMsgTypeAsnd:
+            if (serviceId_p == kDllAsndIdentResponse)
+            {
+                pTemplate_p->aFieldOffset[DLLK_FRAME_FIELD_NMTSTATUS] =
+                                offsetof(tPlkFrame, data.asnd.payload.identResponse.nmtStatus);
+                pTemplate_p->aFieldOffset[DLLK_FRAME_FIELD_FLAG2] =
+                                offsetof(tPlkFrame, data.asnd.payload.identResponse.flag2);
+            }
+            else if (serviceId_p == kDllAsndStatusResponse)
+            {
+                pTemplate_p->aFieldOffset[DLLK_FRAME_FIELD_NMTSTATUS] =
+                                offsetof(tPlkFrame, data.asnd.payload.statusResponse.nmtStatus);
+                pTemplate_p->aFieldOffset[DLLK_FRAME_FIELD_FLAG1] =
+                                offsetof(tPlkFrame, data.asnd.payload.statusResponse.flag1);
+                pTemplate_p->aFieldOffset[DLLK_FRAME_FIELD_FLAG2] =
+                                offsetof(tPlkFrame, data.asnd.payload.statusResponse.flag2);
+            }
+            break;
+
+        case kMsgTypePres:
+            pTemplate_p->aFieldOffset[DLLK_FRAME_FIELD_NMTSTATUS] = offsetof(tPlkFrame, data.pres.nmtStatus);
+            pTemplate_p->aFieldOffset[DLLK_FRAME_FIELD_FLAG1] = offsetof(tPlkFrame, data.pres.flag1);
+            pTemplate_p->aFieldOffset[DLLK_FRAME_FIELD_FLAG2] = offsetof(tPlkFrame, data.pres.flag2);
+            break;
+
+        case kMsgTypePreq:
+            pTemplate_p->aFieldOffset[DLLK_FRAME_FIELD_FLAG1] = offsetof(tPlkFrame, data.preq.flag1);
+            break;
+
+        case kMsgTypeSoc:
+            pTemplate_p->aFieldOffset[DLLK_FRAME_FIELD_FLAG1] = offsetof(tPlkFrame, data.soc.flag1);
+            break;
+
+        case kMsgTypeSoa:
+            pTemplate_p->aFieldOffset[DLLK_FRAME_FIELD_NMTSTATUS] = offsetof(tPlkFrame, data.soa.nmtStatus);
+            pTemplate_p->aFieldOffset[DLLK_FRAME_FIELD_FLAG1] = offsetof(tPlkFrame, data.soa.flag1);
+            pTemplate_p->aFieldOffset[DLLK_FRAME_FIELD_REQSERVICEID] = offsetof(tPlkFrame, data.soa.reqServiceId);
+            pTemplate_p->aFieldOffset[DLLK_FRAME_FIELD_REQTARGET] = offsetof(tPlkFrame, data.soa.reqServiceTarget);
+            break;
+
+        default:
+            break;
+    }
+}
+
 ///\}
 
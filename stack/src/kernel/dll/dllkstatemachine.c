@@ -68,22 +68,156 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // const defines
 //------------------------------------------------------------------------------
 
+// Columns of the CN transition tables
+#define DLLK_SM_EVENT_FIRST         kNmtEventDllCeSoc                       ///< Event of the first column (kNmtEventDllCeSoc .. kNmtEventDllCeFrameTimeout)
+#define DLLK_SM_EVENT_OTHER         7                                       ///< Column of all other events
+#define DLLK_SM_EVENT_COUNT         8                                       ///< Number of columns
+#define DLLK_SM_STATE_COUNT         (kDllCsWaitSoa + 1)                     ///< Number of rows (CN DLL states)
+
+// Transition tables
+#define DLLK_SM_TABLE_FULL_CYCLE    0                                       ///< NMT_CS_PRE_OPERATIONAL_2, NMT_CS_READY_TO_OPERATE, NMT_CS_OPERATIONAL
+#define DLLK_SM_TABLE_STOPPED       1                                       ///< NMT_CS_STOPPED
+#define DLLK_SM_TABLE_COUNT         2                                       ///< Number of transition tables
+
+#define DLLK_SM_KEEP                0xFF                                    ///< Remain in the current DLL state
+
+// Actions of a transition
+#define DLLK_SM_ACT_IGNORE_PREOP2   0x01                                    ///< Ignore the event in NMT_CS_PRE_OPERATIONAL_2
+#define DLLK_SM_ACT_LOSS_SOC        0x02                                    ///< Report loss of SoC (triggerLossOfSocEvent())
+#define DLLK_SM_ACT_LOSS_SOC_TMO    0x04                                    ///< Report loss of SoC on frame timeout (triggerLossOfSocEventOnFrameTimeout())
+#define DLLK_SM_ACT_VALID_SOC       0x08                                    ///< Valid SoC received, reset the loss of SoC report flags
+#define DLLK_SM_ACT_MUX             0x10                                    ///< Report the multiplexed errors if a PReq was expected in this cycle
+
+// Transition table entries
+#define DLLK_SM(nextState_p, actions_p, errors_p, muxErrors_p) \
+    { (UINT8)(nextState_p), (UINT8)(actions_p), (UINT16)(errors_p), (UINT16)(muxErrors_p) }
+#define DLLK_SM_NONE                DLLK_SM(DLLK_SM_KEEP, 0, 0, 0)
+
+#if defined(CONFIG_INCLUDE_MASND)
+#define DLLK_SM_FULL_WAITPREQ_AINV  DLLK_SM(kDllCsWaitSoc, DLLK_SM_ACT_MUX, 0, DLL_ERR_CN_LOSS_PREQ | DLL_ERR_CN_LOSS_SOA)
+#define DLLK_SM_STOP_WAITSOA_AINV   DLLK_SM(kDllCsWaitSoc, 0, DLL_ERR_CN_LOSS_SOA, 0)
+#else
+#define DLLK_SM_FULL_WAITPREQ_AINV  DLLK_SM_NONE
+#define DLLK_SM_STOP_WAITSOA_AINV   DLLK_SM_NONE
+#endif
+
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
 
-typedef tOplkError (*tDllkStateFunc)(tNmtState, tNmtEvent, tEventDllError*);
+/**
+\brief  CN DLL state transition
 
+The structure describes the transition of the CN DLL state machine for one
+DLL state and one event. The CN error events (DLL_ERR_CN_xxx) fit into 16 bit.
+*/
 typedef struct
 {
-    tDllState      nmtState;
-    tDllkStateFunc pfnState;
-} tDllkStateTable;
+    UINT8           nextState;          ///< Next DLL state (DLLK_SM_KEEP = remain in current state)
+    UINT8           actions;            ///< Actions of the transition (DLLK_SM_ACT_xxx)
+    UINT16          errorEvents;        ///< Error events which are reported
+    UINT16          muxErrorEvents;     ///< Error events which are reported by DLLK_SM_ACT_MUX
+} tDllkTransition;
+
+typedef tDllkTransition tDllkTransitionTable[DLLK_SM_STATE_COUNT][DLLK_SM_EVENT_COUNT];
 
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
 
+/*
+The tables contain one row per DLL state (kDllGsInit .. kDllCsWaitSoa) and
+one column per event in the order SoC, PReq, PRes, SoA, AInv, ASnd,
+frame timeout and all other events.
+*/
+static const tDllkTransitionTable   aCsTransitionTable_l[DLLK_SM_TABLE_COUNT] =
+{
+    // DLLK_SM_TABLE_FULL_CYCLE
+    {
+        {   // kDllGsInit: enter DLL_CS_WAIT_PREQ
+            DLLK_SM(kDllCsWaitPreq, 0, 0, 0), DLLK_SM(kDllCsWaitPreq, 0, 0, 0),
+            DLLK_SM(kDllCsWaitPreq, 0, 0, 0), DLLK_SM(kDllCsWaitPreq, 0, 0, 0),
+            DLLK_SM(kDllCsWaitPreq, 0, 0, 0), DLLK_SM(kDllCsWaitPreq, 0, 0, 0),
+            DLLK_SM(kDllCsWaitPreq, 0, 0, 0), DLLK_SM(kDllCsWaitPreq, 0, 0, 0),
+        },
+        {   // kDllCsWaitPreq
+            DLLK_SM(DLLK_SM_KEEP, 0, DLL_ERR_CN_LOSS_SOA, 0),                           // SoC: DLL_CT7
+            DLLK_SM(kDllCsWaitSoa, 0, DLL_ERR_CN_RECVD_PREQ, 0),                        // PReq: DLL_CT2
+            DLLK_SM_NONE,                                                               // PRes
+            DLLK_SM(kDllCsWaitSoc, DLLK_SM_ACT_MUX, 0, DLL_ERR_CN_LOSS_PREQ),           // SoA
+            DLLK_SM_FULL_WAITPREQ_AINV,                                                 // AInv
+            DLLK_SM(DLLK_SM_KEEP, 0, DLL_ERR_CN_LOSS_SOA, 0),                           // ASnd
+            DLLK_SM(kDllCsWaitSoc, DLLK_SM_ACT_IGNORE_PREOP2 | DLLK_SM_ACT_LOSS_SOC_TMO,
+                    DLL_ERR_CN_LOSS_SOA, 0),                                            // Frame timeout: DLL_CT8
+            DLLK_SM_NONE,                                                               // Other
+        },
+        {   // kDllCsWaitSoc
+            DLLK_SM(kDllCsWaitPreq, DLLK_SM_ACT_VALID_SOC, 0, 0),                       // SoC: DLL_CT1
+            DLLK_SM(DLLK_SM_KEEP, DLLK_SM_ACT_LOSS_SOC, 0, 0),                          // PReq
+            DLLK_SM_NONE,                                                               // PRes
+            DLLK_SM(DLLK_SM_KEEP, DLLK_SM_ACT_LOSS_SOC, 0, 0),                          // SoA
+            DLLK_SM_NONE,                                                               // AInv
+            DLLK_SM_NONE,                                                               // ASnd
+            DLLK_SM(DLLK_SM_KEEP, DLLK_SM_ACT_IGNORE_PREOP2 | DLLK_SM_ACT_LOSS_SOC_TMO,
+                    0, 0),                                                              // Frame timeout: DLL_CT4
+            DLLK_SM_NONE,                                                               // Other
+        },
+        {   // kDllCsWaitSoa
+            DLLK_SM(kDllCsWaitPreq, 0, DLL_ERR_CN_LOSS_SOA, 0),                         // SoC: DLL_CT9
+            DLLK_SM(kDllCsWaitSoc, DLLK_SM_ACT_LOSS_SOC, DLL_ERR_CN_LOSS_SOA, 0),       // PReq
+            DLLK_SM_NONE,                                                               // PRes
+            DLLK_SM(kDllCsWaitSoc, 0, 0, 0),                                            // SoA
+            DLLK_SM_NONE,                                                               // AInv
+            DLLK_SM(DLLK_SM_KEEP, 0, DLL_ERR_CN_LOSS_SOA, 0),                           // ASnd: DLL_CT10
+            DLLK_SM(kDllCsWaitSoc, DLLK_SM_ACT_IGNORE_PREOP2 | DLLK_SM_ACT_LOSS_SOC_TMO,
+                    DLL_ERR_CN_LOSS_SOA, 0),                                            // Frame timeout: DLL_CT3
+            DLLK_SM_NONE,                                                               // Other
+        },
+    },
+    // DLLK_SM_TABLE_STOPPED
+    {
+        {   // kDllGsInit: enter DLL_CS_WAIT_SOA
+            DLLK_SM(kDllCsWaitSoa, 0, 0, 0), DLLK_SM(kDllCsWaitSoa, 0, 0, 0),
+            DLLK_SM(kDllCsWaitSoa, 0, 0, 0), DLLK_SM(kDllCsWaitSoa, 0, 0, 0),
+            DLLK_SM(kDllCsWaitSoa, 0, 0, 0), DLLK_SM(kDllCsWaitSoa, 0, 0, 0),
+            DLLK_SM(kDllCsWaitSoa, 0, 0, 0), DLLK_SM(kDllCsWaitSoa, 0, 0, 0),
+        },
+        {   // kDllCsWaitPreq
+            DLLK_SM(DLLK_SM_KEEP, 0, DLL_ERR_CN_LOSS_SOA, 0),                           // SoC: DLL_CT7
+            DLLK_SM(kDllCsWaitSoa, 0, 0, 0),                                            // PReq: DLL_CT2
+            DLLK_SM_NONE,                                                               // PRes
+            DLLK_SM(kDllCsWaitSoc, 0, 0, 0),                                            // SoA
+            DLLK_SM_NONE,                                                               // AInv
+            DLLK_SM(DLLK_SM_KEEP, 0, DLL_ERR_CN_LOSS_SOA, 0),                           // ASnd
+            DLLK_SM(kDllCsWaitSoc, DLLK_SM_ACT_LOSS_SOC_TMO, DLL_ERR_CN_LOSS_SOA, 0),   // Frame timeout: DLL_CT8
+            DLLK_SM_NONE,                                                               // Other
+        },
+        {   // kDllCsWaitSoc
+            DLLK_SM(kDllCsWaitSoa, 0, 0, 0),                                            // SoC: DLL_CT1
+            DLLK_SM(DLLK_SM_KEEP, DLLK_SM_ACT_LOSS_SOC, 0, 0),                          // PReq: DLL_CT4
+            DLLK_SM_NONE,                                                               // PRes
+            DLLK_SM(DLLK_SM_KEEP, DLLK_SM_ACT_LOSS_SOC, 0, 0),                          // SoA
+            DLLK_SM_NONE,                                                               // AInv
+            DLLK_SM_NONE,                                                               // ASnd
+            DLLK_SM(DLLK_SM_KEEP, DLLK_SM_ACT_LOSS_SOC_TMO, 0, 0),                      // Frame timeout
+            DLLK_SM_NONE,                                                               // Other
+        },
+        {   // kDllCsWaitSoa
+            DLLK_SM(DLLK_SM_KEEP, 0, DLL_ERR_CN_LOSS_SOA, 0),                           // SoC: DLL_CT9
+            DLLK_SM_NONE,                                                               // PReq
+            DLLK_SM_NONE,                                                               // PRes
+            DLLK_SM(kDllCsWaitSoc, 0, 0, 0),                                            // SoA
+            DLLK_SM_STOP_WAITSOA_AINV,                                                  // AInv
+            DLLK_SM(DLLK_SM_KEEP, 0, DLL_ERR_CN_LOSS_SOA, 0),                           // ASnd: DLL_CT10
+            DLLK_SM(kDllCsWaitSoc, DLLK_SM_ACT_LOSS_SOC_TMO, DLL_ERR_CN_LOSS_SOA, 0),   // Frame timeout: DLL_CT3
+            DLLK_SM_NONE,                                                               // Other
+        },
+    },
+};
+
+#if (CONFIG_DLL_STATE_TRANSITION_COUNT != FALSE)
+static UINT32   aTransitionCount_l[DLLK_SM_TABLE_COUNT][DLLK_SM_STATE_COUNT][DLLK_SM_EVENT_COUNT];
+#endif
 
 //------------------------------------------------------------------------------
 // local function prototypes
@@ -95,49 +229,13 @@ static tOplkError processNmtMsFullCycle(tNmtState nmtState_p, tNmtEvent nmtEvent
                                         tEventDllError* pDllEvent_p);
 #endif
 
-static tOplkError processCsFullCycleDllWaitPreq(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
-                                                tEventDllError* pDllEvent_p);
-static tOplkError processCsFullCycleDllWaitSoc(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
-                                               tEventDllError* pDllEvent_p);
-static tOplkError processCsFullCycleDllWaitSoa(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
-                                               tEventDllError* pDllEvent_p);
-static tOplkError processCsFullCycleDllGsInit(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
-                                              tEventDllError* pDllEvent_p);
-
-
-static tOplkError processCsStoppedDllWaitPreq(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
-                                              tEventDllError* pDllEvent_p);
-static tOplkError processCsStoppedDllWaitSoc(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
-                                             tEventDllError* pDllEvent_p);
-static tOplkError processCsStoppedDllWaitSoa(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
-                                             tEventDllError* pDllEvent_p);
-static tOplkError processCsStoppedDllGsInit(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
-                                            tEventDllError* pDllEvent_p);
+static void processCsTransition(UINT table_p, tNmtState nmtState_p, tNmtEvent nmtEvent_p,
+                                tEventDllError* pDllEvent_p);
+static UINT getEventIndex(tNmtEvent nmtEvent_p);
 
 static BOOL triggerLossOfSocEvent(void);
 static BOOL triggerLossOfSocEventOnFrameTimeout(void);
 
-//------------------------------------------------------------------------------
-// local vars
-//------------------------------------------------------------------------------
-
-tDllkStateFunc  pfnProcessCsFullCycle_g[] =
-{
-    processCsFullCycleDllGsInit,
-    processCsFullCycleDllWaitPreq,
-    processCsFullCycleDllWaitSoc,
-    processCsFullCycleDllWaitSoa,
-};
-
-tDllkStateFunc  pfnProcessCsStopped_g[] =
-{
-    processCsStoppedDllGsInit,
-    processCsStoppedDllWaitPreq,
-    processCsStoppedDllWaitSoc,
-    processCsStoppedDllWaitSoa,
-};
-
-
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
 //============================================================================//
@@ -176,10 +274,8 @@ tOplkError dllk_changeState(tNmtEvent nmtEvent_p, tNmtState nmtState_p)
         case kNmtCsPreOperational2:
         case kNmtCsReadyToOperate:
         case kNmtCsOperational:
-            if(dllkInstance_g.dllState < kDllMsNonCyclic)     // ensure that only CS states are handled
-                ret = pfnProcessCsFullCycle_g[dllkInstance_g.dllState](nmtState_p,
-                                                                       nmtEvent_p,
-                                                                       &dllEvent);
+            if (dllkInstance_g.dllState < kDllMsNonCyclic)     // ensure that only CS states are handled
+                processCsTransition(DLLK_SM_TABLE_FULL_CYCLE, nmtState_p, nmtEvent_p, &dllEvent);
             break;
 
 #if defined(CONFIG_INCLUDE_NMT_MN)
@@ -210,10 +306,8 @@ tOplkError dllk_changeState(tNmtEvent nmtEvent_p, tNmtState nmtState_p)
             break;
 
         case kNmtCsStopped:
-            if(dllkInstance_g.dllState < kDllMsNonCyclic)     // ensure that only CS states are handled
-                ret = pfnProcessCsStopped_g[dllkInstance_g.dllState](nmtState_p,
-                                                                     nmtEvent_p,
-                                                                     &dllEvent);
+            if (dllkInstance_g.dllState < kDllMsNonCyclic)     // ensure that only CS states are handled
+                processCsTransition(DLLK_SM_TABLE_STOPPED, nmtState_p, nmtEvent_p, &dllEvent);
             break;
 
 #if defined(CONFIG_INCLUDE_NMT_MN)
@@ -239,6 +333,38 @@ tOplkError dllk_changeState(tNmtEvent nmtEvent_p, tNmtState nmtState_p)
     return ret;
 }
 
+#if (CONFIG_DLL_STATE_TRANSITION_COUNT != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Get the number of CN DLL state transitions
+
+The function returns how often the CN DLL state machine handled an event in
+a DLL state. The counters are used to profile the state machine, they are
+only available if CONFIG_DLL_STATE_TRANSITION_COUNT is TRUE.
+
+\param  fStopped_p              TRUE for the transitions in NMT_CS_STOPPED,
+                                FALSE for the transitions in the CN full cycle
+                                states.
+\param  dllState_p              DLL state (kDllGsInit .. kDllCsWaitSoa).
+\param  nmtEvent_p              Event. All events which are not handled by the
+                                CN DLL state machine share one counter.
+\param  pCount_p                Pointer to store the number of transitions.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+tOplkError dllk_getStateTransitionCount(BOOL fStopped_p, tDllState dllState_p,
+                                        tNmtEvent nmtEvent_p, UINT32* pCount_p)
+{
+    if ((pCount_p == NULL) || ((UINT)dllState_p >= DLLK_SM_STATE_COUNT))
+        return kErrorDllInvalidParam;
+
+    *pCount_p = aTransitionCount_l[fStopped_p ? DLLK_SM_TABLE_STOPPED : DLLK_SM_TABLE_FULL_CYCLE]
+                                  [dllState_p][getEventIndex(nmtEvent_p)];
+    return kErrorOk;
+}
+#endif
+
 //----------------------------------------------------------------------------//
 //                L O C A L   F U N C T I O N S                               //
 //----------------------------------------------------------------------------//
@@ -261,8 +387,10 @@ The function handles DLL state changes in NMT state MsPreoperational1
 static tOplkError processNmtMsPreop1(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
                                      tEventDllError* pDllEvent_p)
 {
-    tOplkError      ret = kErrorOk;
-    tDllState       DummyDllState;
+    tOplkError          ret = kErrorOk;
+    tDllState           DummyDllState;
+    tDllReqServiceId    lastReqServiceId;
+    UINT                lastTargetNodeId;
 
     UNUSED_PARAMETER(pDllEvent_p);
 
@@ -284,10 +412,9 @@ static tOplkError processNmtMsPreop1(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
         case kNmtEventDllCeAsnd:
             // because of reduced POWERLINK cycle SoA shall be triggered, not SoC
 
-            ret = dllk_asyncFrameNotReceived(dllkInstance_g.aLastReqServiceId[dllkInstance_g.curLastSoaReq],
-                                             dllkInstance_g.aLastTargetNodeId[dllkInstance_g.curLastSoaReq]);
-            if (ret != kErrorOk)
-                return ret;
+            // save the previous invitation, it is overwritten by the next SoA
+            lastReqServiceId = dllkInstance_g.aLastReqServiceId[dllkInstance_g.curLastSoaReq];
+            lastTargetNodeId = dllkInstance_g.aLastTargetNodeId[dllkInstance_g.curLastSoaReq];
 
             // $$$ d.k. only continue with sending of the SoA, if the received ASnd was the requested one
             //          or the transmission of the previous SoA has already finished.
@@ -300,7 +427,13 @@ static tOplkError processNmtMsPreop1(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
 
             // increment cycle counter to detect if C_DLL_PREOP1_START_CYCLES empty cycles are elapsed
             dllkInstance_g.cycleCount++;
-            ret = kErrorOk;
+
+            // report an unanswered invitation after the SoA was sent, so posting
+            // the event to the user layer doesn't delay the SoA
+            ret = dllk_asyncFrameNotReceived(lastReqServiceId, lastTargetNodeId);
+            if (ret != kErrorOk)
+                return ret;
+
             // reprogramming of timer will be done in CbFrameTransmitted()
             break;
 
@@ -338,9 +471,8 @@ static tOplkError processNmtMsFullCycle(tNmtState nmtState_p, tNmtEvent nmtEvent
             if (dllkInstance_g.dllConfigParam.multipleCycleCnt > 0)
             {   // multiplexed cycle active
                 dllkInstance_g.cycleCount = (dllkInstance_g.cycleCount + 1) % dllkInstance_g.dllConfigParam.multipleCycleCnt;
-                // $$$ check multiplexed cycle restart
-                //     -> toggle MC flag
-                //     -> change node linked list
+                // the MC flag and the polled multiplexed CNs are updated
+                // by the cycle preparation (processSyncMn())
             }
 
             switch (dllkInstance_g.dllState)
@@ -404,436 +536,95 @@ static tOplkError processNmtMsFullCycle(tNmtState nmtState_p, tNmtEvent nmtEvent
 
 //------------------------------------------------------------------------------
 /**
-\brief  Handle DLL state changes for CS full cycle in DllWaitPreq
+\brief  Handle DLL state changes of a CN
 
-The function handles DLL state changes in full cycle NMT states and DLL
-state WaitPreq.
+The function handles the DLL state changes in the CN NMT states with cyclic
+communication. The transition for the current DLL state and the event is
+read from the transition table of the NMT state and executed. Every event
+takes the same path through the function.
 
-\param  nmtEvent_p              Event to handle.
+\param  table_p                 Transition table of the NMT state
+                                (DLLK_SM_TABLE_xxx).
 \param  nmtState_p              Current NMT state.
+\param  nmtEvent_p              Event to handle.
 \param  pDllEvent_p             DLL error event.
-
-\return The function returns a tOplkError error code.
 */
 //------------------------------------------------------------------------------
-static tOplkError processCsFullCycleDllWaitPreq(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
-                                                tEventDllError* pDllEvent_p)
+static void processCsTransition(UINT table_p, tNmtState nmtState_p, tNmtEvent nmtEvent_p,
+                                tEventDllError* pDllEvent_p)
 {
-    switch (nmtEvent_p)
-    {
-        case kNmtEventDllCePreq:                // DLL_CT2
-            // enter DLL_CS_WAIT_SOA
-            pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_RECVD_PREQ;
-            dllkInstance_g.dllState = kDllCsWaitSoa;
-            break;
-
-        case kNmtEventDllCeFrameTimeout:        // DLL_CT8
-            if (nmtState_p == kNmtCsPreOperational2)
-            {   // ignore frame timeout in PreOp2,
-                // because the previously configured cycle len
-                // may be wrong.
-                // 2008/10/15 d.k. If it would not be ignored,
-                // we would go cyclically to PreOp1 and on next
-                // SoC back to PreOp2.
-                break;
-            }
-
-            if(triggerLossOfSocEventOnFrameTimeout())
-                pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOC;
+    const tDllkTransition*  pTransition;
+    UINT                    eventIndex;
+    UINT                    actions;
 
-            // report DLL_CEV_LOSS_SOA
-            pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOA;
+    eventIndex = getEventIndex(nmtEvent_p);
+    pTransition = &aCsTransitionTable_l[table_p][dllkInstance_g.dllState][eventIndex];
+    actions = pTransition->actions;
 
-            // enter DLL_CS_WAIT_SOC
-            dllkInstance_g.dllState = kDllCsWaitSoc;
-            break;
-
-#if defined(CONFIG_INCLUDE_MASND)
-            case kNmtEventDllCeAInv:
-                // check if multiplexed and PReq should have been received in this cycle
-                // and if >= NMT_CS_READY_TO_OPERATE
-                if ((dllkInstance_g.cycleCount == 0)  &&
-                    (nmtState_p >= kNmtCsReadyToOperate))
-                {
-                    pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_PREQ | DLL_ERR_CN_LOSS_SOA;
-                }
-
-                // enter DLL_CS_WAIT_SOC
-                dllkInstance_g.dllState = kDllCsWaitSoc;
-                break;
+#if (CONFIG_DLL_STATE_TRANSITION_COUNT != FALSE)
+    aTransitionCount_l[table_p][dllkInstance_g.dllState][eventIndex]++;
 #endif
 
-        case kNmtEventDllCeSoa:
-            // check if multiplexed and PReq should have been received in this cycle
-            // and if >= NMT_CS_READY_TO_OPERATE
-            if ((dllkInstance_g.cycleCount == 0) && (nmtState_p >= kNmtCsReadyToOperate))
-            {   // report DLL_CEV_LOSS_OF_PREQ
-                pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_PREQ;
-            }
-            // enter DLL_CS_WAIT_SOC
-            dllkInstance_g.dllState = kDllCsWaitSoc;
-            break;
-
-        case kNmtEventDllCeSoc:                 // DLL_CT7
-        case kNmtEventDllCeAsnd:
-            // report DLL_CEV_LOSS_SOA
-            pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOA;
-            //fall through
-
-        case kNmtEventDllCePres:
-        default:
-            // remain in this state
-            break;
+    if (((actions & DLLK_SM_ACT_IGNORE_PREOP2) != 0) && (nmtState_p == kNmtCsPreOperational2))
+    {   // ignore frame timeout in PreOp2,
+        // because the previously configured cycle len
+        // may be wrong.
+        // 2008/10/15 d.k. If it would not be ignored,
+        // we would go cyclically to PreOp1 and on next
+        // SoC back to PreOp2.
+        return;
     }
 
-    return kErrorOk;
-}
-
-//------------------------------------------------------------------------------
-/**
-\brief  Handle DLL state changes for CS full cycle in DllWaitSoC
-
-The function handles DLL state changes in full cycle NMT states and DLL
-state WaitSoC.
-
-\param  nmtEvent_p              Event to handle.
-\param  nmtState_p              Current NMT state.
-\param  pDllEvent_p             DLL error event.
-
-\return The function returns a tOplkError error code.
-*/
-//------------------------------------------------------------------------------
-static tOplkError processCsFullCycleDllWaitSoc(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
-                                               tEventDllError* pDllEvent_p)
-{
-    switch (nmtEvent_p)
+    if ((actions & DLLK_SM_ACT_LOSS_SOC_TMO) != 0)
     {
-        case kNmtEventDllCeSoc:             // DLL_CT1
-            // start of cycle and isochronous phase
-            // enter DLL_CS_WAIT_PREQ
-            dllkInstance_g.dllState = kDllCsWaitPreq;
-
-            // Valid Soc arrived -> Reset report flags!
-            dllkInstance_g.lossSocStatus.fLossReported = FALSE;
-            dllkInstance_g.lossSocStatus.fTimeoutOccurred = FALSE;
-            break;
-
-//          case kNmtEventDllCePres: // jba why commented out
-        case kNmtEventDllCeFrameTimeout:    // DLL_CT4
-            if (nmtState_p == kNmtCsPreOperational2)
-            {   // ignore frame timeout in PreOp2,
-                // because the previously configured cycle len
-                // may be wrong.
-                // 2008/10/15 d.k. If it would not be ignored,
-                // we would go cyclically to PreOp1 and on next
-                // SoC back to PreOp2.
-                break;
-            }
-
-            if(triggerLossOfSocEventOnFrameTimeout())
-                pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOC;
-
-            break;
-        case kNmtEventDllCePreq:
-        case kNmtEventDllCeSoa:
-            if(triggerLossOfSocEvent())
-                pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOC;
-
-        case kNmtEventDllCeAsnd:
-        default:
-            // remain in this state
-            break;
+        if (triggerLossOfSocEventOnFrameTimeout())
+            pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOC;
     }
-    return kErrorOk;
-}
-
-//------------------------------------------------------------------------------
-/**
-\brief  Handle DLL state changes for CS full cycle in DllWaitSoA
-
-The function handles DLL state changes in full cycle NMT states and DLL
-state WaitSoA.
-
-\param  nmtEvent_p              Event to handle.
-\param  nmtState_p              Current NMT state.
-\param  pDllEvent_p             DLL error event.
 
-\return The function returns a tOplkError error code.
-*/
-//------------------------------------------------------------------------------
-static tOplkError processCsFullCycleDllWaitSoa(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
-                                               tEventDllError* pDllEvent_p)
-{
-    switch (nmtEvent_p)
+    if ((actions & DLLK_SM_ACT_LOSS_SOC) != 0)
     {
-        case kNmtEventDllCeFrameTimeout:
-            // DLL_CT3
-            if (nmtState_p == kNmtCsPreOperational2)
-            {   // ignore frame timeout in PreOp2,
-                // because the previously configured cycle len
-                // may be wrong.
-                // 2008/10/15 d.k. If it would not be ignored,
-                // we would go cyclically to PreOp1 and on next
-                // SoC back to PreOp2.
-                break;
-            }
-
-            if(triggerLossOfSocEventOnFrameTimeout())
-                pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOC;
-
-            pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOA;
-
-            dllkInstance_g.dllState = kDllCsWaitSoc;
-            break;
-        case kNmtEventDllCePreq:
-            if(triggerLossOfSocEvent())
-                pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOC;
-
-            // report DLL_CEV_LOSS_SOA
-            pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOA;
-
-        case kNmtEventDllCeSoa:
-            // enter DLL_CS_WAIT_SOC
-            dllkInstance_g.dllState = kDllCsWaitSoc;
-            break;
-
-        case kNmtEventDllCeSoc:             // DLL_CT9
-            // report DLL_CEV_LOSS_SOA
-            pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOA;
-            // enter DLL_CS_WAIT_PREQ
-            dllkInstance_g.dllState = kDllCsWaitPreq;
-            break;
-
-        case kNmtEventDllCeAsnd:            // DLL_CT10
-            // report DLL_CEV_LOSS_SOA
-            pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOA;
-
-        case kNmtEventDllCePres:
-        default:
-            // remain in this state
-            break;
+        if (triggerLossOfSocEvent())
+            pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOC;
     }
-    return kErrorOk;
-}
-
-//------------------------------------------------------------------------------
-/**
-\brief  Handle DLL state changes for CS full cycle in DllGsInit
-
-The function handles DLL state changes in full cycle NMT states and DLL
-state GsInit.
-
-\param  nmtEvent_p              Event to handle.
-\param  nmtState_p              Current NMT state.
-\param  pDllEvent_p             DLL error event.
 
-\return The function returns a tOplkError error code.
-*/
-//------------------------------------------------------------------------------
-static tOplkError processCsFullCycleDllGsInit(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
-                                              tEventDllError* pDllEvent_p)
-{
-    UNUSED_PARAMETER(nmtState_p);
-    UNUSED_PARAMETER(nmtEvent_p);
-    UNUSED_PARAMETER(pDllEvent_p);
-
-    // enter DLL_CS_WAIT_PREQ
-    dllkInstance_g.dllState = kDllCsWaitPreq;
-
-    return kErrorOk;
-}
-
-//------------------------------------------------------------------------------
-/**
-\brief  Handle DLL state changes for CS stopped in DllWaitPReq
-
-The function handles DLL state changes in CS stopped NMT state and DLL
-state WaitPReq.
-
-\param  nmtEvent_p              Event to handle.
-\param  nmtState_p              Current NMT state.
-\param  pDllEvent_p             DLL error event.
-
-\return The function returns a tOplkError error code.
-*/
-//------------------------------------------------------------------------------
-static tOplkError processCsStoppedDllWaitPreq(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
-                                              tEventDllError* pDllEvent_p)
-{
-    UNUSED_PARAMETER(nmtState_p);
-
-    switch (nmtEvent_p)
-    {
-        case kNmtEventDllCePreq:            // DLL_CT2
-            // enter DLL_CS_WAIT_SOA
-            dllkInstance_g.dllState = kDllCsWaitSoa;
-            break;
-
-        case kNmtEventDllCeFrameTimeout:    // DLL_CT8
-            if(triggerLossOfSocEventOnFrameTimeout())
-                pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOC;
-
-            // report DLL_CEV_LOSS_SOA
-            pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOA;
-            //fall through
-
-        case kNmtEventDllCeSoa:
-            // NMT_CS_STOPPED active - it is Ok if no PReq was received
-            // enter DLL_CS_WAIT_SOC
-            dllkInstance_g.dllState = kDllCsWaitSoc;
-            break;
-
-        case kNmtEventDllCeSoc:             // DLL_CT7
-        case kNmtEventDllCeAsnd:
-            // report DLL_CEV_LOSS_SOA
-            pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOA;
-            //fall through
-
-        case kNmtEventDllCePres:
-        default:
-            // remain in this state
-            break;
+    if ((actions & DLLK_SM_ACT_VALID_SOC) != 0)
+    {   // Valid SoC arrived -> Reset report flags!
+        dllkInstance_g.lossSocStatus.fLossReported = FALSE;
+        dllkInstance_g.lossSocStatus.fTimeoutOccurred = FALSE;
     }
-    return kErrorOk;
-}
 
-//------------------------------------------------------------------------------
-/**
-\brief  Handle DLL state changes for CS stopped in DllWaitSoC
-
-The function handles DLL state changes in CS stopped NMT state and DLL
-state WaitSoC.
-
-\param  nmtEvent_p              Event to handle.
-\param  nmtState_p              Current NMT state.
-\param  pDllEvent_p             DLL error event.
-
-\return The function returns a tOplkError error code.
-*/
-//------------------------------------------------------------------------------
-static tOplkError processCsStoppedDllWaitSoc(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
-                                             tEventDllError* pDllEvent_p)
-{
-    UNUSED_PARAMETER(nmtState_p);
-
-    switch (nmtEvent_p)
+    if ((actions & DLLK_SM_ACT_MUX) != 0)
     {
-        case kNmtEventDllCeSoc:             // DLL_CT1
-            // start of cycle and isochronous phase - enter DLL_CS_WAIT_SOA
-            dllkInstance_g.dllState = kDllCsWaitSoa;
-            break;
-
-//          case kNmtEventDllCePres: //jba why commented out?
-        case kNmtEventDllCePreq:            // DLL_CT4
-        case kNmtEventDllCeSoa:
-            if(triggerLossOfSocEvent())
-                pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOC;
-
-            break;
-
-        case kNmtEventDllCeFrameTimeout:
-            if(triggerLossOfSocEventOnFrameTimeout())
-                pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOC;
-
-            //fall through
-#if defined(CONFIG_INCLUDE_MASND)
-        case kNmtEventDllCeAInv:
-#endif
-        case kNmtEventDllCeAsnd:
-        default:
-            // remain in this state
-            break;
+        // check if multiplexed and PReq should have been received in this cycle
+        // and if >= NMT_CS_READY_TO_OPERATE
+        if ((dllkInstance_g.cycleCount == 0) && (nmtState_p >= kNmtCsReadyToOperate))
+            pDllEvent_p->dllErrorEvents |= pTransition->muxErrorEvents;
     }
-    return kErrorOk;
-}
-
-//------------------------------------------------------------------------------
-/**
-\brief  Handle DLL state changes for CS stopped in DllWaitSoA
-
-The function handles DLL state changes in CS stopped NMT state and DLL
-state WaitSoA.
-
-\param  nmtEvent_p              Event to handle.
-\param  nmtState_p              Current NMT state.
-\param  pDllEvent_p             DLL error event.
-
-\return The function returns a tOplkError error code.
-*/
-//------------------------------------------------------------------------------
-static tOplkError processCsStoppedDllWaitSoa(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
-                                             tEventDllError* pDllEvent_p)
-{
-    UNUSED_PARAMETER(nmtState_p);
-
-    switch (nmtEvent_p)
-    {
-        case kNmtEventDllCeFrameTimeout:            // DLL_CT3
-            if(triggerLossOfSocEventOnFrameTimeout())
-                pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOC;
-
-            // report DLL_CEV_LOSS_SOA
-            pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOA;
-            // fall through
-
-#if defined(CONFIG_INCLUDE_MASND)
-        case kNmtEventDllCeAInv:
-            //  report DLL_ERR_CN_LOSS_SOA
-            pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOA;
-#endif
-
-        case kNmtEventDllCeSoa:
-            // enter DLL_CS_WAIT_SOC
-            dllkInstance_g.dllState = kDllCsWaitSoc;
-            break;
-
-        case kNmtEventDllCeSoc:                     // DLL_CT9
-            // report DLL_CEV_LOSS_SOA
-            pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOA;
-            // remain in DLL_CS_WAIT_SOA
-            break;
-
-        case kNmtEventDllCeAsnd:                    // DLL_CT10
-            // report DLL_CEV_LOSS_SOA
-            pDllEvent_p->dllErrorEvents |= DLL_ERR_CN_LOSS_SOA;
-            // fall through
 
-        case kNmtEventDllCePreq:
-            // NMT_CS_STOPPED active and we do not expect any PReq
-            // so just ignore it
+    pDllEvent_p->dllErrorEvents |= pTransition->errorEvents;
 
-        case kNmtEventDllCePres:
-        default:
-            // remain in this state
-            break;
-    }
-    return kErrorOk;
+    if (pTransition->nextState != DLLK_SM_KEEP)
+        dllkInstance_g.dllState = (tDllState)pTransition->nextState;
 }
 
 //------------------------------------------------------------------------------
 /**
-\brief  Handle DLL state changes for CS stopped in GsInit
+\brief  Get the column of an event in the transition tables
 
-The function handles DLL state changes in CS stopped NMT state and DLL
-state GsInit.
+\param  nmtEvent_p              Event.
 
-\param  nmtEvent_p              Event to handle.
-\param  nmtState_p              Current NMT state.
-\param  pDllEvent_p             DLL error event.
-
-\return The function returns a tOplkError error code.
+\return The function returns the column of the event.
 */
 //------------------------------------------------------------------------------
-static tOplkError processCsStoppedDllGsInit(tNmtState nmtState_p, tNmtEvent nmtEvent_p,
-                                            tEventDllError* pDllEvent_p)
+static UINT getEventIndex(tNmtEvent nmtEvent_p)
 {
-    UNUSED_PARAMETER(nmtState_p);
-    UNUSED_PARAMETER(nmtEvent_p);
-    UNUSED_PARAMETER(pDllEvent_p);
+    UINT    eventIndex;
 
-    // enter DLL_CS_WAIT_PREQ
-    dllkInstance_g.dllState = kDllCsWaitSoa;
-    return kErrorOk;
+    eventIndex = (UINT)nmtEvent_p - (UINT)DLLK_SM_EVENT_FIRST;
+    if (eventIndex >= DLLK_SM_EVENT_OTHER)
+        eventIndex = DLLK_SM_EVENT_OTHER;
+
+    return eventIndex;
 }
 
 //------------------------------------------------------------------------------
@@ -54,6 +54,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/oplkinc.h>
 #include <common/ami.h>
 #include <kernel/edrv.h>
+#include <kernel/edrvpoll.h>
+#include <kernel/edrvfilter.h>
 
 #include <linux/module.h>
 #include <linux/kernel.h>
@@ -300,6 +302,9 @@ static irqreturn_t edrvIrqHandler (INT irqNum_p, void* ppDevInstData_p);
 static void reinitRx(void);
 static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id* pId_p);
 static void removeOnePciDev(struct pci_dev* pPciDev_p);
+#if (CONFIG_EDRV_POLL_MODE != FALSE)
+static BOOL pollController(void);
+#endif
 static UINT8 calcHash (UINT8* pMacAddr_p);
 
 //------------------------------------------------------------------------------
@@ -500,7 +505,8 @@ selects the Rx filter entry that shall be changed and \p changeFlags_p determine
 the property.
 If \p entryChanged_p is equal or larger count_p all Rx filters shall be changed.
 
-\note Rx filters are not supported by this driver!
+\note The controller does not support Rx filters. If CONFIG_EDRV_SOFT_FILTER
+      is TRUE, the filters are evaluated in software (see edrvfilter.c).
 
 \param  pFilter_p           Base pointer of Rx filter array
 \param  count_p             Number of Rx filter array entries
@@ -520,6 +526,9 @@ tOplkError edrv_changeRxFilter(tEdrvFilter* pFilter_p, UINT count_p,
     UNUSED_PARAMETER(entryChanged_p);
     UNUSED_PARAMETER(changeFlags_p);
 
+    // the software filter is always compiled from the complete array
+    EDRVFILTER_CHANGE_RX_FILTER(pFilter_p, count_p);
+
     return kErrorOk;
 }
 
@@ -651,6 +660,7 @@ tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
     }
 
     EDRV_COUNT_SEND;
+    EDRVPOLL_WATCH_FRAME(pBuffer_p->pBuffer);
 
     // pad with zeros if necessary, because controller does not do it
     if (pBuffer_p->txFrameSize < EDRV_MIN_ETH_SIZE)
@@ -721,6 +731,36 @@ tOplkError edrv_startTxBuffer(tEdrvTxBuffer* pBuffer_p)
     return kErrorOk;
 }
 
+#if CONFIG_EDRV_USE_DIAGNOSTICS != FALSE
+//------------------------------------------------------------------------------
+/**
+\brief  Get Edrv module diagnostics
+
+This function returns the Edrv diagnostics to a provided buffer.
+
+\param  pBuffer_p   Pointer to buffer filled with diagnostics.
+\param  size_p      Size of buffer
+
+\return The function returns the number of characters written to the buffer.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+INT edrv_getDiagnostics(char* pBuffer_p, INT size_p)
+{
+    INT             usedSize = 0;
+
+    usedSize += snprintf(pBuffer_p + usedSize, size_p - usedSize,
+                         "\nEdrv Diagnostic Information\n");
+
+#if (CONFIG_EDRV_POLL_MODE != FALSE)
+    usedSize += edrvpoll_getDiagnostics(pBuffer_p + usedSize, size_p - usedSize);
+#endif
+
+    return usedSize;
+}
+#endif
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -753,6 +793,8 @@ static irqreturn_t edrvIrqHandler (INT irqNum_p, void* ppDevInstData_p)
     UNUSED_PARAMETER(irqNum_p);
     UNUSED_PARAMETER(ppDevInstData_p);
 
+    EDRVPOLL_COUNT_IRQ();
+
     // read the interrupt status
     status = EDRV_REGW_READ(EDRV_REGW_INT_STATUS);
 
@@ -910,8 +952,11 @@ static irqreturn_t edrvIrqHandler (INT irqNum_p, void* ppDevInstData_p)
 
                 EDRV_COUNT_RX;
 
+                EDRVPOLL_WATCH_FRAME(rxBuffer.pBuffer);
+
                 // call Rx handler of Data link layer
-                edrvInstance_l.initParam.pfnRxHandler(&rxBuffer);
+                if (!EDRVFILTER_DROP_FRAME(rxBuffer.pBuffer, rxBuffer.rxFrameSize))
+                    edrvInstance_l.initParam.pfnRxHandler(&rxBuffer);
             }
 
             // calulate new offset (UINT32 aligned)
@@ -939,6 +984,23 @@ Exit:
     return handled;
 }
 
+#if (CONFIG_EDRV_POLL_MODE != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Poll Ethernet controller
+
+This function is the poll callback of the poll mode. It processes the pending
+events of the Ethernet controller by its interrupt handler.
+
+\return The function returns TRUE if an event was pending.
+*/
+//------------------------------------------------------------------------------
+static BOOL pollController(void)
+{
+    return (edrvIrqHandler(edrvInstance_l.pPciDev->irq, edrvInstance_l.pPciDev) == IRQ_HANDLED);
+}
+#endif
+
 //------------------------------------------------------------------------------
 /**
 \brief  Reinitialize Rx process
@@ -1070,6 +1132,14 @@ static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id*
         goto Exit;
     }
 
+#if (CONFIG_EDRV_POLL_MODE != FALSE)
+    if (edrvpoll_init(pPciDev_p->irq, pollController) != kErrorOk)
+    {
+        result = -ENOMEM;
+        goto Exit;
+    }
+#endif
+
     // allocate buffers
     printk("%s allocate buffers\n", __FUNCTION__);
     edrvInstance_l.pTxBuf = pci_alloc_consistent(pPciDev_p, EDRV_TX_BUFFER_SIZE,
@@ -1166,6 +1236,10 @@ static void removeOnePciDev(struct pci_dev* pPciDev_p)
     // disable interrupts
     EDRV_REGW_WRITE(EDRV_REGW_INT_MASK, 0);
 
+#if (CONFIG_EDRV_POLL_MODE != FALSE)
+    edrvpoll_exit();
+#endif
+
     // remove interrupt handler
     free_irq(pPciDev_p->irq, pPciDev_p);
 
@@ -83,6 +83,8 @@ DAMAGE.
 #include <oplk/oplkinc.h>
 #include <common/ami.h>
 #include <kernel/edrv.h>
+#include <kernel/edrvpoll.h>
+#include <kernel/edrvfilter.h>
 
 #include <linux/module.h>
 #include <linux/kernel.h>
@@ -378,6 +380,9 @@ static BOOL issueScbcmd(UINT16 cmd_p, UINT arg_p, UINT opcode_p);
 
 static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id* pId_p);
 static void removeOnePciDev(struct pci_dev* pPciDev_p);
+#if (CONFIG_EDRV_POLL_MODE != FALSE)
+static BOOL pollController(void);
+#endif
 
 //------------------------------------------------------------------------------
 // local vars
@@ -597,7 +602,8 @@ selects the Rx filter entry that shall be changed and \p changeFlags_p determine
 the property.
 If \p entryChanged_p is equal or larger count_p all Rx filters shall be changed.
 
-\note Rx filters are not supported by this driver!
+\note The controller does not support Rx filters. If CONFIG_EDRV_SOFT_FILTER
+      is TRUE, the filters are evaluated in software (see edrvfilter.c).
 
 \param  pFilter_p           Base pointer of Rx filter array
 \param  count_p             Number of Rx filter array entries
@@ -617,6 +623,9 @@ tOplkError edrv_changeRxFilter(tEdrvFilter* pFilter_p, UINT count_p,
     UNUSED_PARAMETER(entryChanged_p);
     UNUSED_PARAMETER(changeFlags_p);
 
+    // the software filter is always compiled from the complete array
+    EDRVFILTER_CHANGE_RX_FILTER(pFilter_p, count_p);
+
     return kErrorOk;
 }
 
@@ -728,6 +737,8 @@ tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
 
     pCmdBlock = (struct sCmdBlock*)((edrvInstance_l.pCbVirtAdd) + (CB_REQUIRED_SIZE * edrvInstance_l.tailTxDesc));
 
+    EDRVPOLL_WATCH_FRAME(pBuffer_p->pBuffer);
+
     // array to store virtual address of pTxBuffer
     edrvInstance_l.aCbVirtAddrBuf[edrvInstance_l.tailTxDesc] = (ULONG)pBuffer_p;
 
@@ -757,6 +768,36 @@ tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
         return ret;
 }
 
+#if CONFIG_EDRV_USE_DIAGNOSTICS != FALSE
+//------------------------------------------------------------------------------
+/**
+\brief  Get Edrv module diagnostics
+
+This function returns the Edrv diagnostics to a provided buffer.
+
+\param  pBuffer_p   Pointer to buffer filled with diagnostics.
+\param  size_p      Size of buffer
+
+\return The function returns the number of characters written to the buffer.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+INT edrv_getDiagnostics(char* pBuffer_p, INT size_p)
+{
+    INT             usedSize = 0;
+
+    usedSize += snprintf(pBuffer_p + usedSize, size_p - usedSize,
+                         "\nEdrv Diagnostic Information\n");
+
+#if (CONFIG_EDRV_POLL_MODE != FALSE)
+    usedSize += edrvpoll_getDiagnostics(pBuffer_p + usedSize, size_p - usedSize);
+#endif
+
+    return usedSize;
+}
+#endif
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -788,6 +829,8 @@ static irqreturn_t edrvIrqHandler(INT irqNum_p, void* ppDevInstData_p)
     UNUSED_PARAMETER(irqNum_p);
     UNUSED_PARAMETER(ppDevInstData_p);
 
+    EDRVPOLL_COUNT_IRQ();
+
     handled = IRQ_HANDLED;
     state = ioread16(edrvInstance_l.pIoAddr + SCBSTAT);
 
@@ -839,9 +882,12 @@ static irqreturn_t edrvIrqHandler(INT irqNum_p, void* ppDevInstData_p)
                                         (RFD_REQUIRED_SIZE * edrvInstance_l.headRxDesc)) +
                                         (sizeof(struct sRxDescCmdBlock)));
 
+                    EDRVPOLL_WATCH_FRAME(RxBuffer.pBuffer);
+
                     // Call Rx handler of Data link layer
 
-                    RetReleaseRxBuffer = edrvInstance_l.initParam.pfnRxHandler(&RxBuffer);
+                    if (!EDRVFILTER_DROP_FRAME(RxBuffer.pBuffer, RxBuffer.rxFrameSize))
+                        RetReleaseRxBuffer = edrvInstance_l.initParam.pfnRxHandler(&RxBuffer);
                 }// closing Descriptor is valid
 
                 // clean the status bits of the currently handled descriptor
@@ -919,6 +965,23 @@ Exit:
     return handled;
 }
 
+#if (CONFIG_EDRV_POLL_MODE != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Poll Ethernet controller
+
+This function is the poll callback of the poll mode. It processes the pending
+events of the Ethernet controller by its interrupt handler.
+
+\return The function returns TRUE if an event was pending.
+*/
+//------------------------------------------------------------------------------
+static BOOL pollController(void)
+{
+    return (edrvIrqHandler(edrvInstance_l.pPciDev->irq, edrvInstance_l.pPciDev) == IRQ_HANDLED);
+}
+#endif
+
 //------------------------------------------------------------------------------
 /**
 \brief  Issue individual address command
@@ -1702,6 +1765,14 @@ static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id*
         goto ExitFail;
     }
 
+#if (CONFIG_EDRV_POLL_MODE != FALSE)
+    if (edrvpoll_init(pPciDev_p->irq, pollController) != kErrorOk)
+    {
+        result = -ENOMEM;
+        goto ExitFail;
+    }
+#endif
+
     // allocate buffers
     printk("%s allocate buffers\n", __FUNCTION__);
     // allocate tx-buffers
@@ -1791,6 +1862,10 @@ static void removeOnePciDev(struct pci_dev* pPciDev_p)
         issueScbcmd(SC_RUC_ABORT, 0, 0);
     }
 
+#if (CONFIG_EDRV_POLL_MODE != FALSE)
+    edrvpoll_exit();
+#endif
+
      // remove interrupt handler
     free_irq(pPciDev_p->irq, pPciDev_p);
 
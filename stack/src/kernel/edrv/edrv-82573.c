@@ -11,7 +11,8 @@ Buffer handling:
 All buffers are created statically (i.e. at compile time resp. at
 initialisation via kmalloc() ) and not dynamically on request (i.e. via
 edrv_allocTxBuffer().
-edrv_allocTxBuffer() searches for an unused buffer which is large enough.
+The number of Tx buffers is taken from the init parameters of the DLL.
+edrv_allocTxBuffer() takes an unused buffer from a free stack.
 edrv_init() may allocate some buffers with sizes less than maximum frame
 size (i.e. 1514 bytes), e.g. for SoC, SoA, StatusResponse, IdentResponse,
 NMT requests / commands. The less the size of the buffer the less the
@@ -54,6 +55,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/oplkinc.h>
 #include <common/ami.h>
 #include <kernel/edrv.h>
+#include <kernel/edrvpoll.h>
+#include <kernel/edrvirq.h>
 
 #include <linux/module.h>
 #include <linux/kernel.h>
@@ -70,6 +73,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <linux/sched.h>
 #include <linux/delay.h>
 #include <linux/gfp.h>
+#include <linux/slab.h>
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(2, 6, 26)
 #include <linux/semaphore.h>
 #endif
@@ -101,9 +105,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // const defines
 //------------------------------------------------------------------------------
 #ifndef EDRV_MAX_TX_BUFFERS
-#define EDRV_MAX_TX_BUFFERS     42
+#define EDRV_MAX_TX_BUFFERS     42      // default if the DLL requests no buffer count
 #endif
 
+#define EDRV_TX_BUFFER_CHUNK    32      // Tx buffers per DMA memory chunk
+
 #ifndef EDRV_MAX_TX_DESCS
 #define EDRV_MAX_TX_DESCS       16
 #define EDRV_TX_DESC_MASK       (EDRV_MAX_TX_DESCS - 1)
@@ -120,7 +126,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define EDRV_MAX_FRAME_SIZE     0x600
 
-#define EDRV_TX_BUFFER_SIZE     (EDRV_MAX_TX_BUFFERS * EDRV_MAX_FRAME_SIZE) // n * (MTU + 14 + 4)
 #define EDRV_TX_DESCS_SIZE      (EDRV_MAX_TX_DESCS * sizeof (tEdrvTxDesc))
 
 #define EDRV_RX_BUFFER_SIZE_SHIFT   11  // 2048 Byte
@@ -130,6 +135,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EDRV_AUTO_READ_DONE_TIMEOUT 10  // ms
 #define EDRV_MASTER_DISABLE_TIMEOUT 90  // ms
 #define EDRV_LINK_UP_TIMEOUT        3000 // ms
+#define EDRV_MDIC_TIMEOUT           20  // [50 us]
 
 
 #define DRV_NAME                "plk"
@@ -152,6 +158,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EDRV_REGDW_CTRL_MST_DIS 0x00000004  // GIO Master Disable
 #define EDRV_REGDW_CTRL_LRST    0x00000008  // Link Reset
 #define EDRV_REGDW_CTRL_SLU     0x00000040  // Set Link Up
+#define EDRV_REGDW_CTRL_SPEED_100 0x00000100  // Speed Selection 100 Mb/s
+#define EDRV_REGDW_CTRL_FRCSPD  0x00000800  // Force Speed
+#define EDRV_REGDW_CTRL_FRCDPLX 0x00001000  // Force Duplex
 #define EDRV_REGDW_CTRL_RST     0x04000000  // Reset
 #define EDRV_REGDW_CTRL_PHY_RST 0x80000000  // PHY Reset
 
@@ -165,6 +174,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EDRV_REGDW_EEC          0x00010     // EEPROM Control Register
 #define EDRV_REGDW_EEC_AUTO_RD  0x00000200  // Auto Read Done
 
+#define EDRV_REGDW_MDIC         0x00020     // MDI Control
+#define EDRV_REGDW_MDIC_PHY_ADDR 0x00200000 // Address of the internal PHY (1)
+#define EDRV_REGDW_MDIC_OP_WRITE 0x04000000 // Write Operation
+#define EDRV_REGDW_MDIC_READY   0x10000000  // Ready Bit
+#define EDRV_REGDW_MDIC_ERROR   0x40000000  // Error Bit
+
 #define EDRV_REGDW_ICR          0x000C0     // Interrupt Cause Read
 #define EDRV_REGDW_ITR          0x000C4     // Interrupt Throttling Rate
 #define EDRV_REGDW_IMS          0x000D0     // Interrupt Mask Set/Read
@@ -181,11 +196,18 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EDRV_REGDW_INT_SRPD     0x00010000  // Small Receive Packet Detected
 #define EDRV_REGDW_INT_INT_ASSERTED 0x80000000  // PCIe Int. has been asserted
 
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+#define EDRV_REGDW_INT_MASK_LINK EDRV_REGDW_INT_LSC
+#else
+#define EDRV_REGDW_INT_MASK_LINK 0
+#endif
+
 #define EDRV_REGDW_INT_MASK_DEF (EDRV_REGDW_INT_TXDW \
                                | EDRV_REGDW_INT_RXT0 \
                                | EDRV_REGDW_INT_RXDMT0 \
                                | EDRV_REGDW_INT_RXO \
-                               | EDRV_REGDW_INT_RXSEQ)
+                               | EDRV_REGDW_INT_RXSEQ \
+                               | EDRV_REGDW_INT_MASK_LINK)
 
 #define EDRV_REGDW_TIPG         0x00410     // Transmit Inter Packet Gap
 #define EDRV_REGDW_TIPG_DEF     0x00702008  // default according to Intel PCIe GbE Controllers Open Source Software Developer's Manual
@@ -253,6 +275,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EDRV_REGDW_SWSM         0x05B50     // Software Semaphore
 #define EDRV_REGDW_SWSM_SWESMBI 0x00000002  // Software EEPROM Semaphore Bit
 
+// PHY register definitions
+#define EDRV_PHY_CTRL           0x00        // PHY Control
+#define EDRV_PHY_CTRL_RESET     0x8000      // Software Reset
+#define EDRV_PHY_CTRL_SPEED_100 0x2000      // Speed Selection 100 Mb/s
+#define EDRV_PHY_CTRL_FD        0x0100      // Full-Duplex
+
 // defines for the status byte in the receive descriptor
 #define EDRV_RXSTAT_DD          0x01        // Descriptor Done (Processed by Hardware)
 #define EDRV_RXSTAT_EOP         0x02        // End of Packet
@@ -339,12 +367,16 @@ typedef struct
     spinlock_t          spinLockRxBufRelease;
     INT                 pageAllocations;
 
-    UINT8*              pTxBuf;      // pointer to Tx buffer
-    dma_addr_t          pTxBufDma;
+    UINT8**             papTxBufChunk;      // Tx buffer memory chunks
+    dma_addr_t*         paTxBufChunkDma;    // DMA addresses of the Tx buffer memory chunks
+    UINT                txBufChunkCount;
     tEdrvTxDesc*        pTxDesc;      // pointer to Tx descriptors
     tEdrvTxBuffer*      apTxBuffer[EDRV_MAX_TX_DESCS];
     dma_addr_t          pTxDescDma;
-    BOOL                afTxBufUsed[EDRV_MAX_TX_BUFFERS];
+    BOOL*               pafTxBufUsed;
+    UINT*               paTxBufFree;        // stack of free Tx buffer numbers
+    UINT                txBufFreeCount;
+    UINT                txBufferCount;
 
     UINT                headTxDesc;
     UINT                tailTxDesc;
@@ -372,6 +404,16 @@ static INT edrvIrqHandler (INT irqNum_p, void* ppDevInstData_p, struct pt_regs*
 #endif
 static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id* pId_p);
 static void removeOnePciDev(struct pci_dev* pPciDev_p);
+static tOplkError postTxBuffer(tEdrvTxBuffer* pBuffer_p);
+static INT allocTxBufferPool(struct pci_dev* pPciDev_p);
+static void freeTxBufferPool(struct pci_dev* pPciDev_p);
+#if (CONFIG_EDRV_POLL_MODE != FALSE)
+static BOOL pollController(void);
+#endif
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+static void writeMdioPhyReg(UINT phyReg_p, UINT16 value_p);
+static void signalLinkChange(void);
+#endif
 
 //------------------------------------------------------------------------------
 // local vars
@@ -651,32 +693,28 @@ tOplkError edrv_allocTxBuffer(tEdrvTxBuffer* pBuffer_p)
         goto Exit;
     }
 
-    if (edrvInstance_l.pTxBuf == NULL)
+    if (edrvInstance_l.papTxBufChunk == NULL)
     {
         printk("%s Tx buffers currently not allocated\n", __FUNCTION__);
         ret = kErrorEdrvNoFreeBufEntry;
         goto Exit;
     }
 
-    // search a free Tx buffer with appropriate size
-    for (i = 0; i < EDRV_MAX_TX_BUFFERS; i++)
-    {
-        if (edrvInstance_l.afTxBufUsed[i] == FALSE)
-        {
-            // free channel found
-            edrvInstance_l.afTxBufUsed[i] = TRUE;
-            pBuffer_p->txBufferNumber.value = i;
-            pBuffer_p->pBuffer = edrvInstance_l.pTxBuf + (i * EDRV_MAX_FRAME_SIZE);
-            pBuffer_p->maxBufferSize = EDRV_MAX_FRAME_SIZE;
-            break;
-        }
-    }
-    if (i >= EDRV_MAX_TX_BUFFERS)
+    if (edrvInstance_l.txBufFreeCount == 0)
     {
         ret = kErrorEdrvNoFreeBufEntry;
         goto Exit;
     }
 
+    // take a free Tx buffer from the stack
+    edrvInstance_l.txBufFreeCount--;
+    i = edrvInstance_l.paTxBufFree[edrvInstance_l.txBufFreeCount];
+    edrvInstance_l.pafTxBufUsed[i] = TRUE;
+    pBuffer_p->txBufferNumber.value = i;
+    pBuffer_p->pBuffer = edrvInstance_l.papTxBufChunk[i / EDRV_TX_BUFFER_CHUNK] +
+                         ((i % EDRV_TX_BUFFER_CHUNK) * EDRV_MAX_FRAME_SIZE);
+    pBuffer_p->maxBufferSize = EDRV_MAX_FRAME_SIZE;
+
 Exit:
     return ret;
 }
@@ -700,9 +738,12 @@ tOplkError edrv_freeTxBuffer(tEdrvTxBuffer* pBuffer_p)
 
     bufferNumber = pBuffer_p->txBufferNumber.value;
 
-    if (bufferNumber < EDRV_MAX_TX_BUFFERS)
+    if ((bufferNumber < edrvInstance_l.txBufferCount) &&
+        (edrvInstance_l.pafTxBufUsed[bufferNumber] != FALSE))
     {
-        edrvInstance_l.afTxBufUsed[bufferNumber] = FALSE;
+        edrvInstance_l.pafTxBufUsed[bufferNumber] = FALSE;
+        edrvInstance_l.paTxBufFree[edrvInstance_l.txBufFreeCount] = bufferNumber;
+        edrvInstance_l.txBufFreeCount++;
     }
 
     return kErrorOk;
@@ -723,43 +764,54 @@ This function sends the Tx buffer.
 //------------------------------------------------------------------------------
 tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
 {
-    tOplkError      ret = kErrorOk;
-    UINT            bufferNumber;
-    tEdrvTxDesc*    pTxDesc;
+    tOplkError      ret;
 
-    bufferNumber = pBuffer_p->txBufferNumber.value;
+    ret = postTxBuffer(pBuffer_p);
+    if (ret != kErrorOk)
+        return ret;
 
-    if ((bufferNumber >= EDRV_MAX_TX_BUFFERS) ||
-        (edrvInstance_l.afTxBufUsed[bufferNumber] == FALSE))
-    {
-        ret = kErrorEdrvBufNotExisting;
-        goto Exit;
-    }
+    // start transmission
+    EDRV_REGDW_WRITE(EDRV_REGDW_TDT, edrvInstance_l.tailTxDesc);
 
-    // one descriptor has to be left empty for distinction between full and empty
-    if (((edrvInstance_l.tailTxDesc + 1) & EDRV_TX_DESC_MASK) == edrvInstance_l.headTxDesc)
-    {
-        ret = kErrorEdrvNoFreeTxDesc;
-        goto Exit;
-    }
+    return kErrorOk;
+}
 
-    EDRV_COUNT_SEND;
+//------------------------------------------------------------------------------
+/**
+\brief  Send Tx buffer list
 
-    // save pointer to buffer structure for TxHandler
-    edrvInstance_l.apTxBuffer[edrvInstance_l.tailTxDesc] = pBuffer_p;
+This function sends a list of Tx buffers. The descriptors of all buffers are
+set up first and the transmission is started by a single write of the Tx
+descriptor tail register.
 
-    pTxDesc = &edrvInstance_l.pTxDesc[edrvInstance_l.tailTxDesc];
-    pTxDesc->bufferAddr_le = edrvInstance_l.pTxBufDma + (bufferNumber * EDRV_MAX_FRAME_SIZE);
-    pTxDesc->status_le = 0;
-    pTxDesc->lengthCmd_le = ((UINT32)pBuffer_p->txFrameSize) | EDRV_TX_DESC_CMD_DEF;
+\param  ppBuffer_p          Pointer to the list of Tx buffers
+\param  count_p             Number of Tx buffers in the list
+\param  pSentCount_p        Pointer to store the number of Tx buffers which
+                            were sent. If an error occurs, the failing buffer
+                            is ppBuffer_p[*pSentCount_p].
 
-    // increment Tx descriptor queue tail pointer
-    edrvInstance_l.tailTxDesc = (edrvInstance_l.tailTxDesc + 1) & EDRV_TX_DESC_MASK;
+\return The function returns a tOplkError error code.
 
-    // start transmission
-    EDRV_REGDW_WRITE(EDRV_REGDW_TDT, edrvInstance_l.tailTxDesc);
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_sendTxBufferList(tEdrvTxBuffer** ppBuffer_p, UINT count_p, UINT* pSentCount_p)
+{
+    tOplkError      ret = kErrorOk;
+    UINT            index;
 
-Exit:
+    for (index = 0; index < count_p; index++)
+    {
+        ret = postTxBuffer(ppBuffer_p[index]);
+        if (ret != kErrorOk)
+            break;
+    }
+
+    // start transmission of all posted buffers
+    if (index > 0)
+        EDRV_REGDW_WRITE(EDRV_REGDW_TDT, edrvInstance_l.tailTxDesc);
+
+    *pSentCount_p = index;
     return ret;
 }
 
@@ -988,6 +1040,11 @@ INT edrv_getDiagnostics(char* pBuffer_p, INT size_p)
         }
     }
 
+#if (CONFIG_EDRV_POLL_MODE != FALSE)
+    usedSize += edrvpoll_getDiagnostics(pBuffer_p + usedSize, size_p - usedSize);
+#endif
+    usedSize += edrvirq_getDiagnostics(pBuffer_p + usedSize, size_p - usedSize);
+
     usedSize += snprintf(pBuffer_p + usedSize, size_p - usedSize,
                          "\n");
 
@@ -1032,6 +1089,54 @@ tOplkError edrv_releaseRxBuffer(tEdrvRxBuffer* pRxBuffer_p)
 /// \name Private Functions
 /// \{
 
+//------------------------------------------------------------------------------
+/**
+\brief  Post Tx buffer
+
+This function sets up the next Tx descriptor for the Tx buffer. The
+transmission is started by the caller by writing the Tx descriptor tail
+register.
+
+\param  pBuffer_p   Tx buffer descriptor
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError postTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    UINT            bufferNumber;
+    tEdrvTxDesc*    pTxDesc;
+
+    bufferNumber = pBuffer_p->txBufferNumber.value;
+
+    if ((bufferNumber >= edrvInstance_l.txBufferCount) ||
+        (edrvInstance_l.pafTxBufUsed[bufferNumber] == FALSE))
+    {
+        return kErrorEdrvBufNotExisting;
+    }
+
+    // one descriptor has to be left empty for distinction between full and empty
+    if (((edrvInstance_l.tailTxDesc + 1) & EDRV_TX_DESC_MASK) == edrvInstance_l.headTxDesc)
+        return kErrorEdrvNoFreeTxDesc;
+
+    EDRV_COUNT_SEND;
+    EDRVPOLL_WATCH_FRAME(pBuffer_p->pBuffer);
+
+    // save pointer to buffer structure for TxHandler
+    edrvInstance_l.apTxBuffer[edrvInstance_l.tailTxDesc] = pBuffer_p;
+
+    pTxDesc = &edrvInstance_l.pTxDesc[edrvInstance_l.tailTxDesc];
+    pTxDesc->bufferAddr_le = edrvInstance_l.paTxBufChunkDma[bufferNumber / EDRV_TX_BUFFER_CHUNK] +
+                             ((bufferNumber % EDRV_TX_BUFFER_CHUNK) * EDRV_MAX_FRAME_SIZE);
+    pTxDesc->status_le = 0;
+    pTxDesc->lengthCmd_le = ((UINT32)pBuffer_p->txFrameSize) | EDRV_TX_DESC_CMD_DEF;
+
+    // increment Tx descriptor queue tail pointer
+    edrvInstance_l.tailTxDesc = (edrvInstance_l.tailTxDesc + 1) & EDRV_TX_DESC_MASK;
+
+    return kErrorOk;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Ethernet driver interrupt handler
@@ -1049,6 +1154,9 @@ static irqreturn_t edrvIrqHandler (INT irqNum_p, void* ppDevInstData_p)
     UINT32  status;
     INT     handled = IRQ_HANDLED;
 
+    EDRVPOLL_COUNT_IRQ();
+    EDRVIRQ_CAPTURE_THREAD(irqNum_p);
+
     // Read the interrupt status
     status = EDRV_REGDW_READ(EDRV_REGDW_ICR);
 
@@ -1077,7 +1185,7 @@ static irqreturn_t edrvIrqHandler (INT irqNum_p, void* ppDevInstData_p)
     {
         UINT headRxDescOrg;
 
-        if (edrvInstance_l.pTxBuf == NULL)
+        if (edrvInstance_l.papTxBufChunk == NULL)
         {
             printk("%s Tx buffers currently not allocated\n", __FUNCTION__);
             goto Exit;
@@ -1145,6 +1253,8 @@ static irqreturn_t edrvIrqHandler (INT irqNum_p, void* ppDevInstData_p)
                                                     (dma_addr_t)ami_getUint64Le(&pRxDesc->bufferAddr_le),
                                                     EDRV_RX_BUFFER_SIZE, PCI_DMA_FROMDEVICE);
 
+                        EDRVPOLL_WATCH_FRAME(rxBuffer.pBuffer);
+
                         // Call Rx handler of Data link layer
                         retReleaseRxBuffer = edrvInstance_l.initParam.pfnRxHandler(&rxBuffer);
                         if (retReleaseRxBuffer == kEdrvReleaseRxBufferLater)
@@ -1296,6 +1406,13 @@ static irqreturn_t edrvIrqHandler (INT irqNum_p, void* ppDevInstData_p)
         }
     }
 
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+    if ((status & EDRV_REGDW_INT_LSC) != 0)
+    {   // Link status change
+        signalLinkChange();
+    }
+#endif
+
 #if CONFIG_EDRV_USE_DIAGNOSTICS != FALSE
     edrvInstance_l.pos++;
     if (edrvInstance_l.pos == EDRV_SAMPLE_NUM)
@@ -1308,6 +1425,174 @@ Exit:
     return handled;
 }
 
+#if (CONFIG_EDRV_POLL_MODE != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Poll Ethernet controller
+
+This function is the poll callback of the poll mode. It processes the pending
+events of the Ethernet controller by its interrupt handler.
+
+\return The function returns TRUE if an event was pending.
+*/
+//------------------------------------------------------------------------------
+static BOOL pollController(void)
+{
+    return (edrvIrqHandler(edrvInstance_l.pPciDev->irq, edrvInstance_l.pPciDev) == IRQ_HANDLED);
+}
+#endif
+
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Write PHY register via MDIO
+
+The function writes into a register of the internal PHY via the MDI control
+register. The caller must own the Software/Firmware semaphore.
+
+\param  phyReg_p            PHY register to write.
+\param  value_p             Value to write into the register.
+*/
+//------------------------------------------------------------------------------
+static void writeMdioPhyReg(UINT phyReg_p, UINT16 value_p)
+{
+    UINT32  mdic;
+    INT     i;
+
+    mdic = value_p | (phyReg_p << 16) | EDRV_REGDW_MDIC_PHY_ADDR | EDRV_REGDW_MDIC_OP_WRITE;
+    EDRV_REGDW_WRITE(EDRV_REGDW_MDIC, mdic);
+
+    // wait for completion of transfer
+    for (i = EDRV_MDIC_TIMEOUT; i > 0; i--)
+    {
+        udelay(50);
+        mdic = EDRV_REGDW_READ(EDRV_REGDW_MDIC);
+        if ((mdic & EDRV_REGDW_MDIC_READY) != 0)
+            break;
+    }
+
+    if ((i == 0) || ((mdic & EDRV_REGDW_MDIC_ERROR) != 0))
+        printk("%s write of PHY register 0x%02X failed\n", __FUNCTION__, phyReg_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Signal a link change
+
+The function is called by the interrupt handler on a link status change. It
+reports the current link state to the DLL.
+*/
+//------------------------------------------------------------------------------
+static void signalLinkChange(void)
+{
+    BOOL    fLinkUp;
+
+    fLinkUp = ((EDRV_REGDW_READ(EDRV_REGDW_STATUS) & EDRV_REGDW_STATUS_LU) != 0);
+
+    if (edrvInstance_l.initParam.pfnLinkChangeHandler != NULL)
+        edrvInstance_l.initParam.pfnLinkChangeHandler(fLinkUp);
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief  Allocate the Tx buffer pool
+
+The function allocates the number of Tx buffers requested by the DLL in the
+init parameters. The DMA memory is allocated in chunks of EDRV_TX_BUFFER_CHUNK
+frames and the free buffers are kept on a stack, so allocating and freeing a
+buffer takes constant time.
+
+\param  pPciDev_p           Pointer to corresponding PCI device structure
+
+\return The function returns 0 on success or a negative error code.
+*/
+//------------------------------------------------------------------------------
+static INT allocTxBufferPool(struct pci_dev* pPciDev_p)
+{
+    UINT    bufferCount;
+    UINT    chunkCount;
+    UINT    index;
+
+    bufferCount = edrvInstance_l.initParam.txBufferCount;
+    if (bufferCount == 0)
+        bufferCount = EDRV_MAX_TX_BUFFERS;
+
+    chunkCount = (bufferCount + EDRV_TX_BUFFER_CHUNK - 1) / EDRV_TX_BUFFER_CHUNK;
+    edrvInstance_l.papTxBufChunk = kcalloc(chunkCount, sizeof(UINT8*), GFP_KERNEL);
+    edrvInstance_l.paTxBufChunkDma = kcalloc(chunkCount, sizeof(dma_addr_t), GFP_KERNEL);
+    edrvInstance_l.pafTxBufUsed = kcalloc(bufferCount, sizeof(BOOL), GFP_KERNEL);
+    edrvInstance_l.paTxBufFree = kcalloc(bufferCount, sizeof(UINT), GFP_KERNEL);
+    if ((edrvInstance_l.papTxBufChunk == NULL) || (edrvInstance_l.paTxBufChunkDma == NULL) ||
+        (edrvInstance_l.pafTxBufUsed == NULL) || (edrvInstance_l.paTxBufFree == NULL))
+    {
+        freeTxBufferPool(pPciDev_p);
+        return -ENOMEM;
+    }
+
+    edrvInstance_l.txBufChunkCount = chunkCount;
+    for (index = 0; index < chunkCount; index++)
+    {
+        edrvInstance_l.papTxBufChunk[index] = pci_alloc_consistent(pPciDev_p,
+                                                                   EDRV_TX_BUFFER_CHUNK * EDRV_MAX_FRAME_SIZE,
+                                                                   &edrvInstance_l.paTxBufChunkDma[index]);
+        if (edrvInstance_l.papTxBufChunk[index] == NULL)
+        {
+            freeTxBufferPool(pPciDev_p);
+            return -ENOMEM;
+        }
+    }
+
+    // push the buffers in reverse order, so buffer 0 is allocated first
+    for (index = 0; index < bufferCount; index++)
+        edrvInstance_l.paTxBufFree[index] = bufferCount - 1 - index;
+
+    edrvInstance_l.txBufFreeCount = bufferCount;
+    edrvInstance_l.txBufferCount = bufferCount;
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Free the Tx buffer pool
+
+The function frees the Tx buffer memory allocated by allocTxBufferPool().
+
+\param  pPciDev_p           Pointer to corresponding PCI device structure
+*/
+//------------------------------------------------------------------------------
+static void freeTxBufferPool(struct pci_dev* pPciDev_p)
+{
+    UINT    index;
+
+    if ((edrvInstance_l.papTxBufChunk != NULL) && (edrvInstance_l.paTxBufChunkDma != NULL))
+    {
+        for (index = 0; index < edrvInstance_l.txBufChunkCount; index++)
+        {
+            if (edrvInstance_l.papTxBufChunk[index] != NULL)
+            {
+                pci_free_consistent(pPciDev_p, EDRV_TX_BUFFER_CHUNK * EDRV_MAX_FRAME_SIZE,
+                                    edrvInstance_l.papTxBufChunk[index],
+                                    edrvInstance_l.paTxBufChunkDma[index]);
+            }
+        }
+    }
+
+    kfree(edrvInstance_l.papTxBufChunk);
+    edrvInstance_l.papTxBufChunk = NULL;
+    kfree(edrvInstance_l.paTxBufChunkDma);
+    edrvInstance_l.paTxBufChunkDma = NULL;
+    kfree(edrvInstance_l.pafTxBufUsed);
+    edrvInstance_l.pafTxBufUsed = NULL;
+    kfree(edrvInstance_l.paTxBufFree);
+    edrvInstance_l.paTxBufFree = NULL;
+
+    edrvInstance_l.txBufChunkCount = 0;
+    edrvInstance_l.txBufFreeCount = 0;
+    edrvInstance_l.txBufferCount = 0;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Initialize one PCI device
@@ -1331,6 +1616,7 @@ static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id*
     UINT    order;
     UINT    rxBuffersInAllocation;
     UINT    rxBuffer;
+    ULONG   irqFlags;
 
     if (edrvInstance_l.pPciDev != NULL)
     {   // Edrv is already connected to a PCI device
@@ -1421,7 +1707,16 @@ static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id*
     temp = EDRV_REGDW_READ(EDRV_REGDW_ICR);
 
     // set global configuration
-    EDRV_REGDW_WRITE(EDRV_REGDW_CTRL, EDRV_REGDW_CTRL_DEF);
+    temp = EDRV_REGDW_CTRL_DEF;
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+    // skip the auto-negotiation, the MAC uses the same settings as the PHY
+    temp |= (EDRV_REGDW_CTRL_FRCSPD | EDRV_REGDW_CTRL_FRCDPLX);
+    if ((CONFIG_EDRV_FAST_LINK_PHY_CONTROL & EDRV_PHY_CTRL_SPEED_100) != 0)
+        temp |= EDRV_REGDW_CTRL_SPEED_100;
+    if ((CONFIG_EDRV_FAST_LINK_PHY_CONTROL & EDRV_PHY_CTRL_FD) != 0)
+        temp |= EDRV_REGDW_CTRL_FD;
+#endif
+    EDRV_REGDW_WRITE(EDRV_REGDW_CTRL, temp);
 
     // PHY reset by software
     // 1. Obtain the Software/Firmware semaphore (SWSM.SWESMBI). Set it to 1b.
@@ -1438,7 +1733,10 @@ static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id*
     // 3. Delay 10 ms
     msleep(10);
     // 4. Start configuring the PHY.
-
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+    // force the link settings, the PHY applies them with a software reset
+    writeMdioPhyReg(EDRV_PHY_CTRL, (CONFIG_EDRV_FAST_LINK_PHY_CONTROL | EDRV_PHY_CTRL_RESET));
+#endif
     // 5. Release the Software/Firmware semaphore
     temp = EDRV_REGDW_READ(EDRV_REGDW_SWSM);
     temp &= ~EDRV_REGDW_SWSM_SWESMBI;
@@ -1477,12 +1775,23 @@ static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id*
     }
 
     // install interrupt handler
-    result = request_irq(pPciDev_p->irq, edrvIrqHandler, IRQF_SHARED, DRV_NAME, pPciDev_p);
+    irqFlags = IRQF_SHARED | edrvirq_getRequestFlags(kEdrvIrqClassIsoc);
+    result = request_irq(pPciDev_p->irq, edrvIrqHandler, irqFlags, DRV_NAME, pPciDev_p);
     if (result != 0)
     {
         goto ExitFail;
     }
 
+    edrvirq_addIrq(pPciDev_p->irq, kEdrvIrqClassIsoc, irqFlags);
+
+#if (CONFIG_EDRV_POLL_MODE != FALSE)
+    if (edrvpoll_init(pPciDev_p->irq, pollController) != kErrorOk)
+    {
+        result = -ENOMEM;
+        goto ExitFail;
+    }
+#endif
+
     // allocate buffers
     result = pci_set_dma_mask(pPciDev_p, DMA_BIT_MASK(32));
     if (result != 0)
@@ -1492,13 +1801,9 @@ static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id*
     }
 
     // allocate tx-buffers
-    edrvInstance_l.pTxBuf = pci_alloc_consistent(pPciDev_p, EDRV_TX_BUFFER_SIZE,
-                                                 &edrvInstance_l.pTxBufDma);
-    if (edrvInstance_l.pTxBuf == NULL)
-    {
-        result = -ENOMEM;
+    result = allocTxBufferPool(pPciDev_p);
+    if (result != 0)
         goto ExitFail;
-    }
 
     // allocate tx-descriptors
     edrvInstance_l.pTxDesc = pci_alloc_consistent(pPciDev_p, EDRV_TX_DESCS_SIZE,
@@ -1713,19 +2018,19 @@ static void removeOnePciDev(struct pci_dev* pPciDev_p)
         EDRV_REGDW_WRITE(EDRV_REGDW_TCTL, 0);
     }
 
+#if (CONFIG_EDRV_POLL_MODE != FALSE)
+    edrvpoll_exit();
+#endif
+
     // remove interrupt handler
+    edrvirq_removeIrq(pPciDev_p->irq);
     free_irq(pPciDev_p->irq, pPciDev_p);
 
     // Disable Message Signalled Interrupt
     pci_disable_msi(pPciDev_p);
 
     // free buffers
-    if (edrvInstance_l.pTxBuf != NULL)
-    {
-        pci_free_consistent(pPciDev_p, EDRV_TX_BUFFER_SIZE,
-                            edrvInstance_l.pTxBuf, edrvInstance_l.pTxBufDma);
-        edrvInstance_l.pTxBuf = NULL;
-    }
+    freeTxBufferPool(pPciDev_p);
 
     if (edrvInstance_l.pTxDesc != NULL)
     {
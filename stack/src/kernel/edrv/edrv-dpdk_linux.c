@@ -0,0 +1,1039 @@
+/**
+********************************************************************************
+\file   edrv-dpdk_linux.c
+
+\brief  Implementation of Linux DPDK Ethernet driver
+
+This file contains the implementation of the Linux DPDK Ethernet driver. It
+drives a network port with a DPDK poll mode driver (PMD) and bypasses the
+kernel network stack completely. A worker thread busy-polls the receive and the
+transmit queue of the port on an isolated CPU. Received frames are passed to
+the DLL in their mbufs, transmitted frames are copied into mbufs and sent by
+the worker thread at their launch time.
+
+\ingroup module_edrv
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <kernel/edrv.h>
+#include <kernel/edrvmirror.h>
+#include <common/target.h>
+
+#include <unistd.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <time.h>
+#include <sys/syscall.h>
+
+#include <rte_eal.h>
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_cycles.h>
+#include <rte_pause.h>
+#include <rte_ring.h>
+#include <rte_mempool.h>
+#include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
+#include <rte_ethdev.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#ifndef CONFIG_THREAD_PRIORITY_EDRV_RX
+#define CONFIG_THREAD_PRIORITY_EDRV_RX      CONFIG_THREAD_PRIORITY_MEDIUM
+#endif
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define EDRV_MAX_FRAME_SIZE         0x600
+
+#define EDRV_RX_DESCRIPTORS         512                 // Number of descriptors in the receive queue
+#define EDRV_TX_DESCRIPTORS         512                 // Number of descriptors in the transmit queue
+#define EDRV_RX_MBUFS               4095                // Number of mbufs for received frames
+#define EDRV_TX_MBUFS               2047                // Number of mbufs for transmitted frames
+#define EDRV_MBUF_CACHE_SIZE        64                  // Size of the per thread mbuf cache
+#define EDRV_TX_RING_SIZE           1024                // Number of frames queued for the worker thread (power of two)
+#define EDRV_RX_BURST               32                  // Maximum number of frames received at once
+#define EDRV_TX_BURST               32                  // Maximum number of frames transmitted at once
+#define EDRV_LINK_CHECK_MS          100                 // Interval of the link status check [ms]
+
+// Prefix of virtual device names, other names are PCI addresses
+#define EDRV_VDEV_PREFIX            "net_"
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief Private area of a Tx mbuf
+
+The structure is stored in the private area of the mbufs of transmitted frames.
+*/
+typedef struct
+{
+    tEdrvTxBuffer*      pTxBuffer;                      ///< Tx buffer of the frame
+    UINT64              launchTsc;                      ///< Launch time of the frame in TSC cycles (0 = immediately)
+} tEdrvTxPriv;
+
+// Private structure
+typedef struct
+{
+    tEdrvInitParam      initParam;
+    UINT16              portId;                         ///< DPDK port of the Ethernet interface
+    struct rte_mempool* pRxPool;                        ///< mbufs of received frames
+    struct rte_mempool* pTxPool;                        ///< mbufs of transmitted frames
+    struct rte_ring*    pTxRing;                        ///< Frames queued for the worker thread
+    struct rte_mbuf*    apTxHold[EDRV_TX_BURST];        ///< Frames dequeued from the Tx ring, not yet transmitted
+    UINT                txHoldIndex;                    ///< Next frame to be transmitted in apTxHold
+    UINT                txHoldCount;                    ///< Number of frames in apTxHold
+    UINT64              tscHz;                          ///< TSC frequency
+    volatile BOOL       fLinkUp;                        ///< Link status of the port
+    BOOL                fEalInitialized;                ///< The DPDK environment is initialized
+    BOOL                fPortStarted;                   ///< The port is started
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+    INT                 rxTimeStampOffset;              ///< Offset of the Rx time stamp mbuf field (-1 = not available)
+    uint64_t            rxTimeStampFlag;                ///< mbuf flag of a valid Rx time stamp
+#endif
+    volatile BOOL       fStopThread;
+    sem_t               syncSem;
+    pthread_t           hThread;
+} tEdrvInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tEdrvInstance edrvInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError initEal(const char* pDevName_p);
+static tOplkError openPort(tEdrvInstance* pInstance_p);
+static void closePort(tEdrvInstance* pInstance_p);
+static struct rte_mbuf* getRxMbuf(UINT8* pBuffer_p);
+static void processRx(tEdrvInstance* pInstance_p);
+static void processTx(tEdrvInstance* pInstance_p);
+static void updateLinkStatus(tEdrvInstance* pInstance_p);
+#if (CONFIG_EDRV_MIRROR != FALSE)
+static UINT64 getRealtime(void);
+#endif
+static void* workerThread(void* pArgument_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Ethernet driver initialization
+
+This function initializes the Ethernet driver. The device name is the PCI
+address of the port (e.g. 0000:03:00.0) or the name of a DPDK virtual device
+(e.g. net_af_packet0,iface=eth1).
+
+\param  pEdrvInitParam_p    Edrv initialization parameters
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_init(tEdrvInitParam* pEdrvInitParam_p)
+{
+    tOplkError          ret = kErrorOk;
+
+    // clear instance structure
+    OPLK_MEMSET(&edrvInstance_l, 0, sizeof(edrvInstance_l));
+
+    if (pEdrvInitParam_p->hwParam.pDevName == NULL)
+    {
+        ret = kErrorEdrvInit;
+        goto Exit;
+    }
+
+    // save the init data, the MAC address is updated when the port is opened
+    edrvInstance_l.initParam = *pEdrvInitParam_p;
+
+    ret = initEal(edrvInstance_l.initParam.hwParam.pDevName);
+    if (ret != kErrorOk)
+        goto Exit;
+    edrvInstance_l.fEalInitialized = TRUE;
+
+    ret = openPort(&edrvInstance_l);
+    if (ret != kErrorOk)
+        goto Exit;
+
+    // report the MAC address of the port if none was specified
+    OPLK_MEMCPY(pEdrvInitParam_p->aMacAddr, edrvInstance_l.initParam.aMacAddr, 6);
+
+    if (sem_init(&edrvInstance_l.syncSem, 0, 0) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't init semaphore\n", __func__);
+        ret = kErrorEdrvInit;
+        goto Exit;
+    }
+
+#if (CONFIG_EDRV_MIRROR != FALSE)
+    // the driver works without mirror ring, therefore errors are ignored
+    edrvmirror_init();
+#endif
+
+    if (target_createThread(&edrvInstance_l.hThread, kThreadRoleEdrvRx, "oplk-edrvdpdk",
+                            workerThread, &edrvInstance_l) != kErrorOk)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Couldn't create worker thread!\n", __func__);
+        ret = kErrorEdrvInit;
+        goto Exit;
+    }
+
+    // the worker thread busy-polls, so it should get a CPU of its own
+    if (target_setThreadParams(edrvInstance_l.hThread, kThreadRoleEdrvRx, kThreadSchedFifo,
+                               CONFIG_THREAD_PRIORITY_EDRV_RX,
+                               CONFIG_THREAD_CPU_MASK_EDRV_RX) != kErrorOk)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't set thread scheduling parameters!\n",
+                                __func__);
+    }
+
+    /* wait until thread is started */
+    sem_wait(&edrvInstance_l.syncSem);
+
+Exit:
+    if (ret != kErrorOk)
+    {
+        closePort(&edrvInstance_l);
+        if (edrvInstance_l.fEalInitialized)
+            rte_eal_cleanup();
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Ethernet driver shutdown
+
+This function shuts down the Ethernet driver.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_shutdown(void)
+{
+    // signal shutdown to the thread and wait for it to terminate
+    edrvInstance_l.fStopThread = TRUE;
+    pthread_join(edrvInstance_l.hThread, NULL);
+
+    closePort(&edrvInstance_l);
+    sem_destroy(&edrvInstance_l.syncSem);
+    rte_eal_cleanup();
+
+#if (CONFIG_EDRV_MIRROR != FALSE)
+    edrvmirror_exit();
+#endif
+
+    // clear instance structure
+    OPLK_MEMSET(&edrvInstance_l, 0, sizeof(edrvInstance_l));
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send Tx buffer
+
+This function sends the Tx buffer. The frame is copied into an mbuf and queued
+for the worker thread, which owns the transmit queue of the port. Several
+callers may send concurrently. If the Tx buffer contains a launch time, the
+worker thread transmits the frame when the TSC reaches it. The Tx handler is
+called by the worker thread as soon as the port accepted the frame.
+
+\param  pBuffer_p           Tx buffer descriptor
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    struct rte_mbuf*    pMbuf;
+    tEdrvTxPriv*        pPriv;
+    UINT8*              pData;
+    UINT64              launchTime;
+    UINT64              now;
+
+    // the launch time is only valid for this transmission
+    launchTime = pBuffer_p->launchTime;
+    pBuffer_p->launchTime = 0;
+
+    FTRACE_MARKER("%s", __func__);
+
+    if (pBuffer_p->txFrameSize > EDRV_MAX_FRAME_SIZE)
+        return kErrorInvalidOperation;
+
+    if (!edrvInstance_l.fLinkUp)
+    {
+        /* there's no link! We pretend that packet is sent and immediately call
+         * tx handler! Otherwise the stack would hang! */
+        if (pBuffer_p->pfnTxHandler != NULL)
+        {
+            pBuffer_p->pfnTxHandler(pBuffer_p);
+        }
+        return kErrorOk;
+    }
+
+    pMbuf = rte_pktmbuf_alloc(edrvInstance_l.pTxPool);
+    if (pMbuf == NULL)
+    {
+        DEBUG_LVL_EDRV_TRACE("%s() no free Tx mbuf\n", __func__);
+        return kErrorEdrvNoFreeBufEntry;
+    }
+
+    pData = (UINT8*)rte_pktmbuf_append(pMbuf, (uint16_t)pBuffer_p->txFrameSize);
+    OPLK_MEMCPY(pData, pBuffer_p->pBuffer, pBuffer_p->txFrameSize);
+
+    pPriv = (tEdrvTxPriv*)rte_mbuf_to_priv(pMbuf);
+    pPriv->pTxBuffer = pBuffer_p;
+    pPriv->launchTsc = 0;
+    if (launchTime != 0)
+    {   // convert the launch time into TSC cycles
+        now = target_getCurrentTimestamp();
+        if (launchTime > now)
+        {
+            pPriv->launchTsc = rte_get_tsc_cycles() +
+                               (((launchTime - now) * edrvInstance_l.tscHz) / 1000000000ULL);
+        }
+    }
+
+    if (rte_ring_enqueue(edrvInstance_l.pTxRing, pMbuf) != 0)
+    {
+        DEBUG_LVL_EDRV_TRACE("%s() Tx ring full\n", __func__);
+        rte_pktmbuf_free(pMbuf);
+        return kErrorEdrvNoFreeBufEntry;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Allocate Tx buffer
+
+This function allocates a Tx buffer.
+
+\param  pBuffer_p           Tx buffer descriptor
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_allocTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    tOplkError ret = kErrorOk;
+
+    if (pBuffer_p->maxBufferSize > EDRV_MAX_FRAME_SIZE)
+    {
+        ret = kErrorEdrvNoFreeBufEntry;
+        goto Exit;
+    }
+
+    // allocate buffer with malloc
+    pBuffer_p->pBuffer = OPLK_MALLOC(pBuffer_p->maxBufferSize);
+    if (pBuffer_p->pBuffer == NULL)
+    {
+        ret = kErrorEdrvNoFreeBufEntry;
+        goto Exit;
+    }
+
+    pBuffer_p->txBufferNumber.pArg = NULL;
+
+Exit:
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Free Tx buffer
+
+This function releases the Tx buffer.
+
+\param  pBuffer_p           Tx buffer descriptor
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_freeTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    UINT8* pBuffer = pBuffer_p->pBuffer;
+
+    // mark buffer as free, before actually freeing it
+    pBuffer_p->pBuffer = NULL;
+
+    OPLK_FREE(pBuffer);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Release Rx buffer
+
+This function releases a reference to a late release Rx buffer. The mbuf is
+returned to its pool when its last reference is released.
+
+\param  pRxBuffer_p         Rx buffer to be released
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_releaseRxBuffer(tEdrvRxBuffer* pRxBuffer_p)
+{
+    struct rte_mbuf*    pMbuf;
+
+    pMbuf = getRxMbuf(pRxBuffer_p->pBuffer);
+    if (pMbuf == NULL)
+        return kErrorEdrvInvalidRxBuf;
+
+    rte_pktmbuf_free(pMbuf);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Hold Rx buffer
+
+This function adds a reference to a late release Rx buffer, so that an
+additional consumer can keep the frame without copying it. The reference count
+of the mbuf is used, so the mbuf is returned to its pool when every reference
+is released by edrv_releaseRxBuffer().
+
+\param  pRxBuffer_p         Rx buffer to be held
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_holdRxBuffer(tEdrvRxBuffer* pRxBuffer_p)
+{
+    struct rte_mbuf*    pMbuf;
+
+    pMbuf = getRxMbuf(pRxBuffer_p->pBuffer);
+    if (pMbuf == NULL)
+        return kErrorEdrvInvalidRxBuf;
+
+    rte_mbuf_refcnt_update(pMbuf, 1);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Change Rx filter setup
+
+This function changes the Rx filter setup. The parameter entryChanged_p
+selects the Rx filter entry that shall be changed and \p changeFlags_p determines
+the property.
+If \p entryChanged_p is equal or larger count_p all Rx filters shall be changed.
+
+\note Rx filters are not supported by this driver!
+
+\param  pFilter_p           Base pointer of Rx filter array
+\param  count_p             Number of Rx filter array entries
+\param  entryChanged_p      Index of Rx filter entry that shall be changed
+\param  changeFlags_p       Bit mask that selects the changing Rx filter property
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_changeRxFilter(tEdrvFilter* pFilter_p, UINT count_p,
+                               UINT entryChanged_p, UINT changeFlags_p)
+{
+    UNUSED_PARAMETER(pFilter_p);
+    UNUSED_PARAMETER(count_p);
+    UNUSED_PARAMETER(entryChanged_p);
+    UNUSED_PARAMETER(changeFlags_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Clear multicast address entry
+
+This function removes the multicast entry from the Ethernet controller.
+
+\note The port runs in promiscuous mode, therefore the function does nothing.
+
+\param  pMacAddr_p  Multicast address
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_clearRxMulticastMacAddr(UINT8* pMacAddr_p)
+{
+    UNUSED_PARAMETER(pMacAddr_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set multicast address entry
+
+This function sets a multicast entry into the Ethernet controller.
+
+\note The port runs in promiscuous mode, therefore the function does nothing.
+
+\param  pMacAddr_p  Multicast address
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_setRxMulticastMacAddr(UINT8* pMacAddr_p)
+{
+    UNUSED_PARAMETER(pMacAddr_p);
+
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize DPDK environment
+
+This function initializes the DPDK environment abstraction layer (EAL) for the
+single port given by the device name. The EAL runs without shared
+configuration files and pins the calling thread to its main lcore, therefore
+the CPU affinity of the calling thread is restored afterwards.
+
+\param  pDevName_p      Device name (PCI address or virtual device)
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError initEal(const char* pDevName_p)
+{
+    char        aArg0[] = "oplk-edrvdpdk";
+    char        aArg1[] = "--in-memory";
+    char        aArgPci[] = "-a";
+    char        aArgVdev[] = "--vdev";
+    char        aDevName[128];
+    char*       apArgv[4];
+    cpu_set_t   cpuSet;
+    BOOL        fCpuSetValid;
+    INT         ret;
+
+    strncpy(aDevName, pDevName_p, sizeof(aDevName) - 1);
+    aDevName[sizeof(aDevName) - 1] = '\0';
+
+    apArgv[0] = aArg0;
+    apArgv[1] = aArg1;
+    if (strncmp(aDevName, EDRV_VDEV_PREFIX, strlen(EDRV_VDEV_PREFIX)) == 0)
+        apArgv[2] = aArgVdev;
+    else
+        apArgv[2] = aArgPci;
+    apArgv[3] = aDevName;
+
+    fCpuSetValid = (pthread_getaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0);
+
+    ret = rte_eal_init(4, apArgv);
+
+    if (fCpuSetValid)
+        pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+
+    if (ret < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Error!! Can't initialize DPDK: %s\n", __func__,
+                              rte_strerror(rte_errno));
+        return kErrorEdrvInit;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Open port
+
+This function creates the mbuf pools and the Tx ring and configures and starts
+the port with one receive and one transmit queue in promiscuous mode. If the
+PMD supports it, received frames carry a hardware time stamp.
+
+\param  pInstance_p     Pointer to the instance structure
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError openPort(tEdrvInstance* pInstance_p)
+{
+    struct rte_eth_dev_info devInfo;
+    struct rte_eth_conf     portConf;
+    struct rte_ether_addr   macAddr;
+    uint16_t                rxDescCount = EDRV_RX_DESCRIPTORS;
+    uint16_t                txDescCount = EDRV_TX_DESCRIPTORS;
+    INT                     socketId;
+    UINT16                  portId;
+    BOOL                    fPortFound = FALSE;
+
+    RTE_ETH_FOREACH_DEV(portId)
+    {   // the EAL only probes the given device
+        pInstance_p->portId = portId;
+        fPortFound = TRUE;
+        break;
+    }
+
+    if (!fPortFound)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() no DPDK port found for %s\n", __func__,
+                              pInstance_p->initParam.hwParam.pDevName);
+        return kErrorEdrvInit;
+    }
+
+    portId = pInstance_p->portId;
+    socketId = rte_eth_dev_socket_id(portId);
+    if (socketId < 0)
+        socketId = (INT)rte_socket_id();
+
+    pInstance_p->tscHz = rte_get_tsc_hz();
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+    pInstance_p->rxTimeStampOffset = -1;
+#endif
+
+    pInstance_p->pRxPool = rte_pktmbuf_pool_create("oplk_edrv_rx", EDRV_RX_MBUFS,
+                                                   EDRV_MBUF_CACHE_SIZE, 0,
+                                                   RTE_MBUF_DEFAULT_BUF_SIZE, socketId);
+    pInstance_p->pTxPool = rte_pktmbuf_pool_create("oplk_edrv_tx", EDRV_TX_MBUFS,
+                                                   EDRV_MBUF_CACHE_SIZE,
+                                                   RTE_ALIGN(sizeof(tEdrvTxPriv), RTE_MBUF_PRIV_ALIGN),
+                                                   RTE_MBUF_DEFAULT_BUF_SIZE, socketId);
+    pInstance_p->pTxRing = rte_ring_create("oplk_edrv_tx", EDRV_TX_RING_SIZE, socketId,
+                                           RING_F_SC_DEQ);
+    if ((pInstance_p->pRxPool == NULL) || (pInstance_p->pTxPool == NULL) ||
+        (pInstance_p->pTxRing == NULL))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't create mbuf pools: %s\n", __func__,
+                              rte_strerror(rte_errno));
+        return kErrorEdrvInit;
+    }
+
+    if (rte_eth_dev_info_get(portId, &devInfo) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't get port information\n", __func__);
+        return kErrorEdrvInit;
+    }
+
+    OPLK_MEMSET(&portConf, 0, sizeof(portConf));
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+    if ((devInfo.rx_offload_capa & RTE_ETH_RX_OFFLOAD_TIMESTAMP) != 0)
+        portConf.rxmode.offloads |= RTE_ETH_RX_OFFLOAD_TIMESTAMP;
+#endif
+
+    if ((rte_eth_dev_configure(portId, 1, 1, &portConf) != 0) ||
+        (rte_eth_dev_adjust_nb_rx_tx_desc(portId, &rxDescCount, &txDescCount) != 0) ||
+        (rte_eth_rx_queue_setup(portId, 0, rxDescCount, (UINT)socketId, NULL,
+                                pInstance_p->pRxPool) != 0) ||
+        (rte_eth_tx_queue_setup(portId, 0, txDescCount, (UINT)socketId, NULL) != 0))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't configure port %u\n", __func__, portId);
+        return kErrorEdrvInit;
+    }
+
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+    if ((portConf.rxmode.offloads & RTE_ETH_RX_OFFLOAD_TIMESTAMP) != 0)
+    {   // the PMD stores the time stamp in a dynamic mbuf field
+        if (rte_mbuf_dyn_rx_timestamp_register(&pInstance_p->rxTimeStampOffset,
+                                               &pInstance_p->rxTimeStampFlag) != 0)
+            pInstance_p->rxTimeStampOffset = -1;
+    }
+#endif
+
+    /* if no MAC address was specified use the MAC address of the port,
+     * otherwise program the specified one
+     */
+    if ((pInstance_p->initParam.aMacAddr[0] == 0) &&
+        (pInstance_p->initParam.aMacAddr[1] == 0) &&
+        (pInstance_p->initParam.aMacAddr[2] == 0) &&
+        (pInstance_p->initParam.aMacAddr[3] == 0) &&
+        (pInstance_p->initParam.aMacAddr[4] == 0) &&
+        (pInstance_p->initParam.aMacAddr[5] == 0)  )
+    {
+        rte_eth_macaddr_get(portId, &macAddr);
+        OPLK_MEMCPY(pInstance_p->initParam.aMacAddr, macAddr.addr_bytes, 6);
+    }
+    else
+    {
+        OPLK_MEMCPY(macAddr.addr_bytes, pInstance_p->initParam.aMacAddr, 6);
+        if (rte_eth_dev_default_mac_addr_set(portId, &macAddr) != 0)
+        {
+            DEBUG_LVL_EDRV_TRACE("%s() couldn't set MAC address of port %u\n",
+                                 __func__, portId);
+        }
+    }
+
+    if (rte_eth_dev_start(portId) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't start port %u\n", __func__, portId);
+        return kErrorEdrvInit;
+    }
+    pInstance_p->fPortStarted = TRUE;
+
+    rte_eth_promiscuous_enable(portId);
+    updateLinkStatus(pInstance_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close port
+
+This function stops and closes the port and releases the mbufs, the Tx ring and
+the mbuf pools.
+
+\param  pInstance_p     Pointer to the instance structure
+*/
+//------------------------------------------------------------------------------
+static void closePort(tEdrvInstance* pInstance_p)
+{
+    struct rte_mbuf*    pMbuf;
+
+    if (pInstance_p->fPortStarted)
+    {
+        rte_eth_dev_stop(pInstance_p->portId);
+        rte_eth_dev_close(pInstance_p->portId);
+        pInstance_p->fPortStarted = FALSE;
+    }
+
+    while (pInstance_p->txHoldIndex < pInstance_p->txHoldCount)
+        rte_pktmbuf_free(pInstance_p->apTxHold[pInstance_p->txHoldIndex++]);
+
+    if (pInstance_p->pTxRing != NULL)
+    {
+        while (rte_ring_dequeue(pInstance_p->pTxRing, (void**)&pMbuf) == 0)
+            rte_pktmbuf_free(pMbuf);
+
+        rte_ring_free(pInstance_p->pTxRing);
+        pInstance_p->pTxRing = NULL;
+    }
+
+    if (pInstance_p->pTxPool != NULL)
+    {
+        rte_mempool_free(pInstance_p->pTxPool);
+        pInstance_p->pTxPool = NULL;
+    }
+
+    if (pInstance_p->pRxPool != NULL)
+    {
+        rte_mempool_free(pInstance_p->pRxPool);
+        pInstance_p->pRxPool = NULL;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get mbuf of Rx buffer
+
+This function returns the mbuf which contains a received frame. The PMD places
+the frame behind the default headroom of the mbuf, the Rx pool has no private
+area.
+
+\param  pBuffer_p       Pointer to the received frame
+
+\return The function returns the mbuf or NULL if the pointer is no Rx buffer.
+*/
+//------------------------------------------------------------------------------
+static struct rte_mbuf* getRxMbuf(UINT8* pBuffer_p)
+{
+    struct rte_mbuf*    pMbuf;
+
+    if (pBuffer_p == NULL)
+        return NULL;
+
+    pMbuf = (struct rte_mbuf*)(pBuffer_p - RTE_PKTMBUF_HEADROOM - sizeof(struct rte_mbuf));
+    if ((pMbuf->pool != edrvInstance_l.pRxPool) ||
+        (rte_pktmbuf_mtod(pMbuf, UINT8*) != pBuffer_p))
+        return NULL;
+
+    return pMbuf;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process received frames
+
+This function receives a burst of frames from the receive queue and passes
+them to the DLL. The frames stay in their mbufs, which are freed when the DLL
+releases them.
+
+\param  pInstance_p     Pointer to the instance structure
+*/
+//------------------------------------------------------------------------------
+static void processRx(tEdrvInstance* pInstance_p)
+{
+    struct rte_mbuf*        apMbuf[EDRV_RX_BURST];
+    tEdrvRxBuffer           rxBuffer;
+    tTimestamp              rxTimeStamp;
+    tEdrvReleaseRxBuffer    release;
+    UINT16                  count;
+    UINT16                  i;
+
+    count = rte_eth_rx_burst(pInstance_p->portId, 0, apMbuf, EDRV_RX_BURST);
+    if (count == 0)
+        return;
+
+    // the software time stamp is shared by the frames of the burst
+    rxTimeStamp.timeStamp = (TIME_STAMP_T)target_getCurrentTimestamp();
+
+    for (i = 0; i < count; i++)
+    {
+        if (apMbuf[i]->nb_segs != 1)
+        {   // frames larger than an mbuf are no POWERLINK frames
+            rte_pktmbuf_free(apMbuf[i]);
+            continue;
+        }
+
+        rxBuffer.bufferInFrame = kEdrvBufferLastInFrame;
+        rxBuffer.rxFrameSize = rte_pktmbuf_data_len(apMbuf[i]);
+        rxBuffer.pBuffer = rte_pktmbuf_mtod(apMbuf[i], UINT8*);
+        rxBuffer.pRxTimeStamp = &rxTimeStamp;
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+        rxBuffer.rxTimeStampNs = 0;
+        if ((pInstance_p->rxTimeStampOffset >= 0) &&
+            ((apMbuf[i]->ol_flags & pInstance_p->rxTimeStampFlag) != 0))
+        {
+            rxBuffer.rxTimeStampNs = *RTE_MBUF_DYNFIELD(apMbuf[i], pInstance_p->rxTimeStampOffset,
+                                                         rte_mbuf_timestamp_t*);
+        }
+#endif
+
+        EDRVMIRROR_RECORD_FRAME(rxBuffer.pBuffer, rxBuffer.rxFrameSize, getRealtime(), 0);
+
+        FTRACE_MARKER("%s RX", __func__);
+        release = pInstance_p->initParam.pfnRxHandler(&rxBuffer);
+
+        if (release == kEdrvReleaseRxBufferImmediately)
+            rte_pktmbuf_free(apMbuf[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process queued frames
+
+This function transmits the queued frames whose launch time is reached and
+calls the Tx handlers of their Tx buffers. The frames are transmitted in the
+order they were queued. Frames which the port doesn't accept are retried in
+the next loop of the worker thread.
+
+\param  pInstance_p     Pointer to the instance structure
+*/
+//------------------------------------------------------------------------------
+static void processTx(tEdrvInstance* pInstance_p)
+{
+    tEdrvTxBuffer*      apTxBuffer[EDRV_TX_BURST];
+    struct rte_mbuf**   ppMbuf;
+    tEdrvTxPriv*        pPriv;
+    UINT64              now;
+    UINT16              count;
+    UINT16              sentCount;
+    UINT16              i;
+
+    if (pInstance_p->txHoldIndex >= pInstance_p->txHoldCount)
+    {
+        pInstance_p->txHoldIndex = 0;
+        pInstance_p->txHoldCount = rte_ring_dequeue_burst(pInstance_p->pTxRing,
+                                                          (void**)pInstance_p->apTxHold,
+                                                          EDRV_TX_BURST, NULL);
+        if (pInstance_p->txHoldCount == 0)
+            return;
+    }
+
+    ppMbuf = &pInstance_p->apTxHold[pInstance_p->txHoldIndex];
+    now = rte_get_tsc_cycles();
+    for (count = 0; count < (pInstance_p->txHoldCount - pInstance_p->txHoldIndex); count++)
+    {
+        pPriv = (tEdrvTxPriv*)rte_mbuf_to_priv(ppMbuf[count]);
+        if (pPriv->launchTsc > now)
+            break;
+
+        // the mbuf belongs to the port after the transmission
+        apTxBuffer[count] = pPriv->pTxBuffer;
+        EDRVMIRROR_RECORD_FRAME(rte_pktmbuf_mtod(ppMbuf[count], UINT8*),
+                                rte_pktmbuf_data_len(ppMbuf[count]), getRealtime(),
+                                EDRVMIRROR_FLAG_TX);
+    }
+
+    if (count == 0)
+        return;
+
+    sentCount = rte_eth_tx_burst(pInstance_p->portId, 0, ppMbuf, count);
+    pInstance_p->txHoldIndex += sentCount;
+
+    for (i = 0; i < sentCount; i++)
+    {
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+        // Tx time stamps are only provided by the PTP functions of a PMD
+        apTxBuffer[i]->txTimeStampNs = 0;
+#endif
+        if (apTxBuffer[i]->pfnTxHandler != NULL)
+        {
+            apTxBuffer[i]->pfnTxHandler(apTxBuffer[i]);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update link status
+
+This function reads the link status of the port.
+
+\param  pInstance_p     Pointer to the instance structure
+*/
+//------------------------------------------------------------------------------
+static void updateLinkStatus(tEdrvInstance* pInstance_p)
+{
+    struct rte_eth_link link;
+
+    OPLK_MEMSET(&link, 0, sizeof(link));
+    rte_eth_link_get_nowait(pInstance_p->portId, &link);
+
+    pInstance_p->fLinkUp = (link.link_status == RTE_ETH_LINK_UP);
+}
+
+#if (CONFIG_EDRV_MIRROR != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Get real time
+
+\return The function returns the current CLOCK_REALTIME in ns.
+*/
+//------------------------------------------------------------------------------
+static UINT64 getRealtime(void)
+{
+    struct timespec realTime;
+
+    clock_gettime(CLOCK_REALTIME, &realTime);
+    return ((UINT64)realTime.tv_sec * 1000000000ULL) + (UINT64)realTime.tv_nsec;
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief  Edrv worker thread
+
+This function is the Edrv worker thread. It busy-polls the receive and the
+transmit queue of the port as emulation of non-reentrant interrupt processing,
+so the receive and transmit callback functions of the DLL are mutual exclusive.
+The link status is checked every EDRV_LINK_CHECK_MS.
+
+\param  pArgument_p     User specific pointer pointing to the instance structure
+
+\return The function returns a thread error code.
+*/
+//------------------------------------------------------------------------------
+static void* workerThread(void* pArgument_p)
+{
+    tEdrvInstance*  pInstance = (tEdrvInstance*)pArgument_p;
+    UINT64          linkCheckCycles;
+    UINT64          nextLinkCheck;
+    UINT64          now;
+
+    DEBUG_LVL_EDRV_TRACE("%s(): ThreadId:%ld\n", __func__, syscall(SYS_gettid));
+
+    // use the per lcore mbuf caches, the driver works without them as well
+    rte_thread_register();
+
+    linkCheckCycles = (pInstance->tscHz * EDRV_LINK_CHECK_MS) / 1000;
+    nextLinkCheck = rte_get_tsc_cycles() + linkCheckCycles;
+
+    /* signal that thread is successfully started */
+    sem_post(&pInstance->syncSem);
+
+    while (!pInstance->fStopThread)
+    {
+        processRx(pInstance);
+        processTx(pInstance);
+
+        now = rte_get_tsc_cycles();
+        if (now >= nextLinkCheck)
+        {
+            updateLinkStatus(pInstance);
+            nextLinkCheck = now + linkCheckCycles;
+        }
+
+        rte_pause();
+    }
+
+    rte_thread_unregister();
+
+    return NULL;
+}
+
+///\}
@@ -17,6 +17,21 @@ Tx-Rx queue (e.g. descriptor write back, queue errors etc.), the second one
 handles timer interrupts and therefore enables the I210 hardware timer as a
 source for the high-resolution timer module.
 
+Multi-queue mode
+
+If CONFIG_EDRV_I210_MULTI_QUEUE is enabled, the driver uses two Tx-Rx queue
+pairs with an MSI-X vector each. Queue 0 is the isochronous queue. Its Tx queue
+is the Qav SR queue with launch time and carries all frames of the cyclic Tx
+list (SoC, PReq, SoA). Queue 1 is a best-effort strict priority queue for all
+other frames (ASnd, virtual Ethernet). An EtherType filter steers received
+POWERLINK frames into Rx queue 0, all other frames end up in Rx queue 1. The
+calls into the data link layer are serialized between the two vectors.
+
+The vectors are registered at the interrupt placement (see
+edrvirq-linuxkernel.c). The timer vector and the isochronous queue vector are
+pinned with the isochronous CPU mask, the asynchronous queue vector with the
+asynchronous CPU mask.
+
 
 \ingroup module_edrv
 *******************************************************************************/
@@ -54,6 +69,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 #include <oplk/oplkinc.h>
 #include <kernel/edrv.h>
+#include <kernel/edrvirq.h>
 
 #include <linux/pci.h>
 #include <linux/interrupt.h>
@@ -83,9 +99,18 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_BAR              0
 #define DRIVER_NAME             "plk"
 
+#if (CONFIG_EDRV_I210_MULTI_QUEUE != FALSE)
+#define EDRV_MAX_RX_QUEUES       2
+#define EDRV_MAX_TX_QUEUES       2
+#define EDRV_MAX_QUEUE_VECTOR    2
+#else
 #define EDRV_MAX_RX_QUEUES       1
 #define EDRV_MAX_TX_QUEUES       1
 #define EDRV_MAX_QUEUE_VECTOR    1
+#endif
+
+#define EDRV_QUEUE_ISOC          0               // Queue for isochronous frames (Tx: SR queue with launch time)
+#define EDRV_QUEUE_ASYNC         1               // Queue for asynchronous frames (multi-queue mode only)
 
 #define INTERRUPT_STRING_SIZE    25
 #define SEC_TO_NSEC              1000000000
@@ -121,6 +146,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EDRV_SYSTIMH_REG         0x0B604         // System time register High
 #define EDRV_STAT_TPT            0x040D4         // Total Packets Transmitted
 #define EDRV_MRQC_REG            0x05818         // Multiple Receive Queues Command
+#define EDRV_ETQF(n)             (0x05CB0 + 4 * n)   // EtherType Queue Filter ( n: 0-7 )
 #define EDRV_EEER_REG            0x00E30         // Energy Efficient Ethernet (EEE) Register
 // Semaphore defines used for Software/Firmware synchronization
 #define EDRV_SWSM_SMBI           0x00000001      // Software
@@ -159,17 +185,15 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define EDRV_TIPG_DEF            0x00702008      // default according to Intel PCIe GbE Controllers Open Source Software Developer's Manual
 #define EDRV_TXPBSIZE_DEF        0x04104208      // 8 Kb TQ0, 8Kb TQ1, 4 Kb TQ2, 4Kb TQ3 and 4 Kb Os2Bmc
-#define EDRV_MAX_TX_DESCRIPTOR   256             // Max no of Desc in mem
-#define EDRV_MAX_TX_DESC_LEN     (EDRV_MAX_TX_DESCRIPTOR - 1)
-// One slot to diff full
-#define EDRV_MAX_TTX_DESC_LEN    ((EDRV_MAX_TX_DESCRIPTOR >> 1) -1)
+#define EDRV_MIN_TX_DESCRIPTOR   256             // Min no of Desc in mem
+#define EDRV_MAX_TX_DESCRIPTOR   4096            // Max no of Desc in mem
 #ifndef EDRV_MAX_TX_BUFFERS
-#define EDRV_MAX_TX_BUFFERS      128             // Max no of Buffers
+#define EDRV_MAX_TX_BUFFERS      128             // Default no of Buffers if the DLL requests none
 #endif
+#define EDRV_TX_BUFFER_CHUNK     32              // No of Buffers per allocated memory chunk
 
 #define EDRV_MAX_FRAME_SIZE      0x600           // 1536
-#define EDRV_TX_BUFFER_SIZE      (EDRV_MAX_TX_BUFFERS * EDRV_MAX_FRAME_SIZE)
-#define EDRV_TX_DESCS_SIZE       (EDRV_MAX_TX_DESCRIPTOR * sizeof(tEdrvAdvTxDesc))
+#define EDRV_TX_DESCS_SIZE(cnt)  ((cnt) * sizeof(tEdrvAdvTxDesc))
 
 #define EDRV_TDESC_CMD_DEXT              (1 << 29)         // Descriptor type
 #define EDRV_TDESC_CMD_RS                (1 << 27)         // Report Status
@@ -267,6 +291,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EDRV_RXPBSIZE_CLEAR      0x3F            // Clear Packet buffer size
 #define EDRV_RXPBSIZE_DEF        0x8000001E      // default configuration
 #define EDRV_RAH_AV              (1 << 31)       // Address Valid
+#define EDRV_MRQC_DEF_Q_SHIFT    3               // Default queue of frames which match no filter
+#define EDRV_ETQF_QUEUE_SHIFT    16              // Rx queue of the EtherType filter
+#define EDRV_ETQF_FILTER_EN      (1 << 26)       // EtherType filter enable
+#define EDRV_ETQF_QUEUE_EN       (1 << 31)       // Steer matching frames into the Rx queue
 
 //------------------------------------------------------------------------------
 // Time Sync Register offset and defines
@@ -281,6 +309,16 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EDRV_TRGTTIML0                   0x0B644           // Target Time Register 0 Low
 #define EDRV_TRGTTIMH0                   0x0B648           // Target Time Register 0 High
 #define EDRV_TSSDP                       0x0003C           // Time Sync SDP Configuration Register
+#define EDRV_TSYNCRXCTL                  0x0B620           // Rx Time Sync Control Register
+#define EDRV_TSYNCRXCTL_TYPE_ALL         (4 << 1)          // Time stamp all received packets
+#define EDRV_TSYNCRXCTL_EN               (1 << 4)          // Enable Rx time stamping
+#define EDRV_RDESC_STATUS_TSIP           (1 << 15)         // Time stamp is placed in front of the packet
+#define EDRV_RX_TIMESTAMP_LEN            16                // Length of the time stamp in front of the packet
+#define EDRV_RX_TIMESTAMP_OFFSET         8                 // Offset of SYSTIM in the time stamp
+
+// Convert a SYSTIM value (seconds in the upper, nanoseconds in the lower half) to ns
+#define EDRV_SYSTIM_TO_NS(systim_p)      (((UINT64)((systim_p) >> 32) * 1000000000ULL) + \
+                                          ((systim_p) & 0xFFFFFFFFULL))
 #define	EDRV_TSIM_TT0                    (1 << 3)          // Target time 0 Trigger Mask.
 #define	EDRV_TSIM_TT1                    (1 << 4)          // Target time 1 Trigger Mask.
 #define EDRV_TSAUXC_SAMP_AUTO            0x00000008        // Sample SYSTIM into AUXSTMP0 register
@@ -325,6 +363,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define	EDRV_INTR_ICR_RXDMT0     (1 << 4 )       // Receive Descriptor Minimum Threshold Reached
 #define EDRV_INTR_ICR_RXMISS     (1 << 6)        // Missed packet interrupt
 #define EDRV_INTR_ICR_FER        (1 << 22)       // Fatal Error
+#define EDRV_INTR_ICR_LSC        (1 << 2 )       // Link Status Change
 #define EDRV_EIMC_OTHR_EN        (1 << 31)       // Other Interrupt Cause Active
 #define EDRV_EICS_OTHER          (1 << 0 )       // Vector for Other Interrupt Cause in MSI-X mode
 #define EDRV_EICS_QUEUE          0x0000001E      // All queue interrupts
@@ -332,6 +371,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EDRV_EICS_TXRXQUEUE2     (1 << 2 )       // Vector for TX-RX queue 1
 #define EDRV_EICS_TXRXQUEUE3     (1 << 3 )       // Vector for TX-RX queue 2
 #define EDRV_EICS_TXRXQUEUE4     (1 << 4 )       // Vector for TX-RX queue 3
+#define EDRV_EICS_QUEUE_VECTORS  (EDRV_EICS_QUEUE & (((1 << EDRV_MAX_QUEUE_VECTOR) - 1) << 1))
+                                                 // Vectors of the used Tx-Rx queues
 #define EDRV_IVAR_VALID          0x80            // Interrupt vector valid bit
 #define EDRV_INTR_ICR_MASK_DEF   (EDRV_INTR_ICR_TXDW           /* Transmit descriptor write back */\
                                   | EDRV_INTR_ICR_RXDW         /* Receive descriptor write back */\
@@ -360,6 +401,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EDRV_CTRL_MASTER_DIS     (1 << 2 )       // GIO Master Disable
 #define EDRV_CTRL_SLU            (1 << 6 )       // Set Link Up
 #define EDRV_CTRL_ILOS           (1 << 7 )       // Invert Loss-of-Signal (LOS/LINK) Signal
+#define EDRV_CTRL_SPEED_100      (1 << 8 )       // Speed selection 100 Mb/s
+#define EDRV_CTRL_FRCSPD         (1 << 11)       // Force Speed
+#define EDRV_CTRL_FRCDPLX        (1 << 12)       // Force Duplex
 #define EDRV_CTRL_RST            (1 << 26)       // Port Software Reset
 #define EDRV_CTRL_RFCE           (1 << 27)       // Receive Flow Control Enable
 #define EDRV_CTRL_TFCE           (1 << 28)       // Transmit Flow Control Enable
@@ -401,6 +445,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EDRV_REGDW_WRITE(reg, val)      writel(val, (UINT8*)edrvInstance_l.pIoAddr + reg)
 #define EDRV_REGB_READ(reg)             readb(edrvInstance_l.pIoAddr + reg)
 
+#if (CONFIG_EDRV_I210_MULTI_QUEUE != FALSE)
+#define EDRV_DLL_LOCK(flags)            spin_lock_irqsave(&edrvInstance_l.dllLock, flags)
+#define EDRV_DLL_UNLOCK(flags)          spin_unlock_irqrestore(&edrvInstance_l.dllLock, flags)
+#else
+#define EDRV_DLL_LOCK(flags)
+#define EDRV_DLL_UNLOCK(flags)
+#endif
+
 // TracePoint support for realtime-debugging
 #ifdef _DBG_TRACE_POINTS_
 void TgtDbgSignalTracePoint (UINT8 bTracePointNumber_p);
@@ -538,8 +590,7 @@ typedef struct
     INT                 index;           // Queue index
     dma_addr_t          descDma;         // DMA address for descriptor queue
     void*               pDescVirt;       // Virtual address for descriptor queue
-    tEdrvTxBuffer*      apTxBuffer[EDRV_MAX_TX_DESCRIPTOR];
-                                         // Tx buffer array
+    tEdrvTxBuffer**     papTxBuffer;     // Tx buffer array (one entry per time-triggered descriptor)
     BYTE __iomem*       pBuf;            // pointer to buffer for the queue
     tEdrvPktBuff*       pPktBuff;        // Bookkeeping structure
     INT                 nextDesc;        // Next descriptor to used
@@ -553,13 +604,22 @@ typedef struct
     tEdrvQueue*         pTxQueue[EDRV_MAX_TX_QUEUES];      // Tx queue array
     tEdrvQueue*         pRxQueue[EDRV_MAX_RX_QUEUES];      // Rx Queue Array
     tEdrvQVector*       pQvector[EDRV_MAX_QUEUE_VECTOR];   // Vector Array
-    UINT8*              pTxBuf;                            // Tx Buffer pointer
-    BOOL                afTxBufUsed[EDRV_MAX_TX_BUFFERS];  // Array to keep track of used Tx buffers
+    UINT8**             papTxBufChunk;                     // Tx Buffer memory chunks
+    UINT                txBufChunkCount;                   // No. of Tx Buffer memory chunks
+    BOOL*               pafTxBufUsed;                      // Array to keep track of used Tx buffers
+    UINT*               paTxBufFree;                       // Stack of free Tx buffer numbers
+    UINT                txBufFreeCount;                    // No. of free Tx buffers on the stack
+    UINT                txBufferCount;                     // No. of Tx buffers
+    UINT                txDescCount;                       // No. of Tx descriptors per Tx queue
+    UINT                ttxDescMask;                       // Index mask of the time-triggered descriptors
 
     UINT                txMaxQueue;                        // Max Tx queue
     UINT                rxMaxQueue;                        // Max Rx queue
     UINT                numQVectors;                       // No. of queue vectors (Total = NumQvectors + 1)
     struct msix_entry*  pMsixEntry;                        // Pointer to MSI-X structure
+#if (CONFIG_EDRV_I210_MULTI_QUEUE != FALSE)
+    spinlock_t          dllLock;                           // Serializes the DLL callbacks of the queue vectors
+#endif
     // Timer related members
     tTimerHdl           timerHdl;                          // Timer handle
     tHresCallback       hresTimerCb;                       // Timer callback
@@ -581,6 +641,12 @@ static tOplkError acquireSwFwSync(UINT16 mask_p);
 static void releaseSwFwSync(UINT16 mask_p);
 static void writeMdioPhyReg(UINT phyreg_p, USHORT value_p);
 static UINT16 readMdioPhyReg(INT phyreg_p);
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+static void signalLinkChange(void);
+#endif
+static INT allocTxBufferPool(void);
+static void freeTxBufferPool(void);
+static tOplkError postTxBuffer(tEdrvTxBuffer* pBuffer_p, INT* pQueue_p);
 static void freeTxBuffersOfQueue(tEdrvQueue* pTxQueue_p);
 static void freeTxBuffers(void);
 static void freeTxQueues(void);
@@ -595,6 +661,9 @@ static void configureRxQueue(tEdrvQueue* pRxQueue_p);
 static void initQavMode(void);
 static void writeIvarRegister(INT vector_p, INT index_p, INT offset_p);
 static INT requestMsixIrq(void);
+#if (CONFIG_EDRV_I210_MULTI_QUEUE != FALSE)
+static void initRxSteering(void);
+#endif
 static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id* pId_p);
 static void removeOnePciDev(struct pci_dev* pPciDev_p);
 
@@ -869,32 +938,28 @@ tOplkError edrv_allocTxBuffer(tEdrvTxBuffer* pBuffer_p)
         goto Exit;
     }
 
-    if (edrvInstance_l.pTxBuf == NULL)
+    if (edrvInstance_l.papTxBufChunk == NULL)
     {
         printk("%s Tx buffers currently not allocated\n", __FUNCTION__);
         ret = kErrorEdrvNoFreeBufEntry;
         goto Exit;
     }
 
-    for (channel = 0; channel < EDRV_MAX_TX_BUFFERS; channel++)
-    {
-        if (edrvInstance_l.afTxBufUsed[channel] == FALSE)
-        {
-            // free channel found
-            edrvInstance_l.afTxBufUsed[channel] = TRUE;
-            pBuffer_p->txBufferNumber.value = channel;
-            pBuffer_p->pBuffer = edrvInstance_l.pTxBuf + (channel * EDRV_MAX_FRAME_SIZE);
-            pBuffer_p->maxBufferSize = EDRV_MAX_FRAME_SIZE;
-            break;
-        }
-    }
-
-    if (channel >= EDRV_MAX_TX_BUFFERS)
+    if (edrvInstance_l.txBufFreeCount == 0)
     {
         ret = kErrorEdrvNoFreeBufEntry;
         goto Exit;
     }
 
+    // take a free channel from the stack
+    edrvInstance_l.txBufFreeCount--;
+    channel = edrvInstance_l.paTxBufFree[edrvInstance_l.txBufFreeCount];
+    edrvInstance_l.pafTxBufUsed[channel] = TRUE;
+    pBuffer_p->txBufferNumber.value = channel;
+    pBuffer_p->pBuffer = edrvInstance_l.papTxBufChunk[channel / EDRV_TX_BUFFER_CHUNK] +
+                         ((channel % EDRV_TX_BUFFER_CHUNK) * EDRV_MAX_FRAME_SIZE);
+    pBuffer_p->maxBufferSize = EDRV_MAX_FRAME_SIZE;
+
 Exit:
     return ret;
 }
@@ -918,9 +983,12 @@ tOplkError edrv_freeTxBuffer(tEdrvTxBuffer* pBuffer_p)
 
     bufferNumber = pBuffer_p->txBufferNumber.value;
 
-    if (bufferNumber < EDRV_MAX_TX_BUFFERS)
+    if ((bufferNumber < edrvInstance_l.txBufferCount) &&
+        (edrvInstance_l.pafTxBufUsed[bufferNumber] != FALSE))
     {
-        edrvInstance_l.afTxBufUsed[bufferNumber] = FALSE;
+        edrvInstance_l.pafTxBufUsed[bufferNumber] = FALSE;
+        edrvInstance_l.paTxBufFree[edrvInstance_l.txBufFreeCount] = bufferNumber;
+        edrvInstance_l.txBufFreeCount++;
     }
 
     return kErrorOk;
@@ -941,87 +1009,62 @@ This function sends the Tx buffer.
 //------------------------------------------------------------------------------
 tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
 {
-    tOplkError      ret = kErrorOk;
-    UINT            bufferNumber;
-    tEdrvQueue*     pTxQueue;
-    INT             queue = 0;
-    INT             index = 0;
-    dma_addr_t      txDma;
-    tEdrvTtxDesc*   pTtxDesc;
-
-#if EDRV_USE_TTTX != FALSE
-    UINT64          launchTime;
-    UINT64          curTime;
-#endif
+    tOplkError      ret;
+    INT             queue;
 
-    bufferNumber = pBuffer_p->txBufferNumber.value;
+    ret = postTxBuffer(pBuffer_p, &queue);
+    if (ret != kErrorOk)
+        return ret;
 
-    if ((bufferNumber >= EDRV_MAX_TX_BUFFERS) || (edrvInstance_l.afTxBufUsed[bufferNumber] == FALSE))
-    {
-        ret = kErrorEdrvBufNotExisting;
-        goto Exit;
-    }
+    // Handle the frame to Hw
+    EDRV_REGDW_WRITE(EDRV_TDTAIL(queue), (edrvInstance_l.pTxQueue[queue]->nextDesc * 2));
 
-    pTxQueue = edrvInstance_l.pTxQueue[queue];
-    index = pTxQueue->nextDesc;
+    return kErrorOk;
+}
 
-    if (((index + 1) & EDRV_MAX_TTX_DESC_LEN) == pTxQueue->nextWb)
-    {
-        ret = kErrorEdrvNoFreeTxDesc;
-        goto Exit;
-    }
+//------------------------------------------------------------------------------
+/**
+\brief  Send Tx buffer list
 
-    pTtxDesc = EDRV_GET_TTX_DESC(pTxQueue,index);
+This function sends a list of Tx buffers. The descriptors of all buffers are
+set up first and the frames are handed to the hardware by a single write of
+the tail register of each used queue.
 
-    pTtxDesc->ctxtDesc.idxL4lenMss = 0;
-    pTtxDesc->ctxtDesc.ipMaclenVlan = 0;
+\param  ppBuffer_p          Pointer to the list of Tx buffers
+\param  count_p             Number of Tx buffers in the list
+\param  pSentCount_p        Pointer to store the number of Tx buffers which
+                            were sent. If an error occurs, the failing buffer
+                            is ppBuffer_p[*pSentCount_p].
 
-#if EDRV_USE_TTTX != FALSE
-    launchTime = pBuffer_p->launchTime;
+\return The function returns a tOplkError error code.
 
-    // Scale the launch time to 32 nsecs unit
-    do_div(launchTime, SEC_TO_NSEC);
-    curTime = pBuffer_p->launchTime - (launchTime * SEC_TO_NSEC);
-    do_div(curTime, 32);
-    pTtxDesc->ctxtDesc.launchTime = curTime;
-#endif
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_sendTxBufferList(tEdrvTxBuffer** ppBuffer_p, UINT count_p, UINT* pSentCount_p)
+{
+    tOplkError      ret = kErrorOk;
+    UINT            index;
+    INT             queue;
+    UINT            queueMask = 0;
 
-    // Set descriptor type
-    pTtxDesc->ctxtDesc.tucmdType = (EDRV_TDESC_CMD_DEXT | EDRV_TDESC_DTYP_CTXT);
+    for (index = 0; index < count_p; index++)
+    {
+        ret = postTxBuffer(ppBuffer_p[index], &queue);
+        if (ret != kErrorOk)
+            break;
 
-    txDma = dma_map_single(&edrvInstance_l.pPciDev->dev, pBuffer_p->pBuffer,
-                           pBuffer_p->txFrameSize, DMA_TO_DEVICE);
+        queueMask |= (1 << queue);
+    }
 
-    if (dma_mapping_error(&edrvInstance_l.pPciDev->dev, txDma))
+    // Handle the frames to Hw
+    for (queue = 0; queue < EDRV_MAX_TX_QUEUES; queue++)
     {
-        ret = kErrorEdrvNoFreeBufEntry;
-        goto Exit;
+        if ((queueMask & (1 << queue)) != 0)
+            EDRV_REGDW_WRITE(EDRV_TDTAIL(queue), (edrvInstance_l.pTxQueue[queue]->nextDesc * 2));
     }
 
-    // Store TxBuffer for reference in ISR
-    pTxQueue->apTxBuffer[index] = pBuffer_p;
-
-    EDRV_COUNT_SEND;
-    // Store Dma address, length and virtual address for reference
-    pTxQueue->pPktBuff[index].dmaAddr = txDma;
-    pTxQueue->pPktBuff[index].pVirtAddr = pBuffer_p->pBuffer;
-    pTxQueue->pPktBuff[index].len = pBuffer_p->txFrameSize;
-
-    pTtxDesc->advDesc.sRead.bufferAddrLe = cpu_to_le64(txDma);
-    pTtxDesc->advDesc.sRead.cmdTypeLen = (UINT)pBuffer_p->txFrameSize;
-    pTtxDesc->advDesc.sRead.cmdTypeLen |= (EDRV_TDESC_CMD_DEXT | EDRV_TDESC_DTYP_ADV |
-                                           EDRV_TDESC_CMD_EOP | EDRV_TDESC_CMD_IFCS |
-                                           EDRV_TDESC_CMD_RS);
-
-    pTtxDesc->advDesc.sRead.statusIdxPaylen = (pBuffer_p->txFrameSize << 14);
-
-    index = ((index + 1) & EDRV_MAX_TTX_DESC_LEN);
-    // increment Tx descriptor queue tail pointer
-    pTxQueue->nextDesc = index;
-    // Handle the frame to Hw
-    EDRV_REGDW_WRITE(EDRV_TDTAIL(queue), (index * 2));
-
-Exit:
+    *pSentCount_p = index;
     return ret;
 }
 
@@ -1236,6 +1279,112 @@ tOplkError edrv_registerHresCallback(tHresCallback pfnHighResCb_p)
 /// \name Private Functions
 /// \{
 
+//------------------------------------------------------------------------------
+/**
+\brief  Post Tx buffer
+
+This function sets up the Tx descriptors of the Tx buffer in its queue. The
+frame is handed to the hardware by the caller by writing the tail register of
+the queue.
+
+\param  pBuffer_p           Tx buffer descriptor
+\param  pQueue_p            Pointer to store the queue of the Tx buffer
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError postTxBuffer(tEdrvTxBuffer* pBuffer_p, INT* pQueue_p)
+{
+    tOplkError      ret = kErrorOk;
+    UINT            bufferNumber;
+    tEdrvQueue*     pTxQueue;
+    INT             queue = EDRV_QUEUE_ISOC;
+    INT             index = 0;
+    dma_addr_t      txDma;
+    tEdrvTtxDesc*   pTtxDesc;
+
+#if EDRV_USE_TTTX != FALSE
+    UINT64          launchTime;
+    UINT64          curTime;
+#endif
+
+    bufferNumber = pBuffer_p->txBufferNumber.value;
+
+    if ((bufferNumber >= edrvInstance_l.txBufferCount) ||
+        (edrvInstance_l.pafTxBufUsed[bufferNumber] == FALSE))
+    {
+        ret = kErrorEdrvBufNotExisting;
+        goto Exit;
+    }
+
+#if (CONFIG_EDRV_I210_MULTI_QUEUE != FALSE)
+    // Only the frames of the cyclic Tx list have a launch time, all other
+    // frames go to the best-effort queue so they cannot delay cyclic frames.
+    if (pBuffer_p->launchTime == 0)
+        queue = EDRV_QUEUE_ASYNC;
+#endif
+
+    pTxQueue = edrvInstance_l.pTxQueue[queue];
+    index = pTxQueue->nextDesc;
+
+    if (((index + 1) & edrvInstance_l.ttxDescMask) == pTxQueue->nextWb)
+    {
+        ret = kErrorEdrvNoFreeTxDesc;
+        goto Exit;
+    }
+
+    pTtxDesc = EDRV_GET_TTX_DESC(pTxQueue,index);
+
+    pTtxDesc->ctxtDesc.idxL4lenMss = 0;
+    pTtxDesc->ctxtDesc.ipMaclenVlan = 0;
+
+#if EDRV_USE_TTTX != FALSE
+    launchTime = pBuffer_p->launchTime;
+
+    // Scale the launch time to 32 nsecs unit
+    do_div(launchTime, SEC_TO_NSEC);
+    curTime = pBuffer_p->launchTime - (launchTime * SEC_TO_NSEC);
+    do_div(curTime, 32);
+    pTtxDesc->ctxtDesc.launchTime = curTime;
+#endif
+
+    // Set descriptor type
+    pTtxDesc->ctxtDesc.tucmdType = (EDRV_TDESC_CMD_DEXT | EDRV_TDESC_DTYP_CTXT);
+
+    txDma = dma_map_single(&edrvInstance_l.pPciDev->dev, pBuffer_p->pBuffer,
+                           pBuffer_p->txFrameSize, DMA_TO_DEVICE);
+
+    if (dma_mapping_error(&edrvInstance_l.pPciDev->dev, txDma))
+    {
+        ret = kErrorEdrvNoFreeBufEntry;
+        goto Exit;
+    }
+
+    // Store TxBuffer for reference in ISR
+    pTxQueue->papTxBuffer[index] = pBuffer_p;
+
+    EDRV_COUNT_SEND;
+    // Store Dma address, length and virtual address for reference
+    pTxQueue->pPktBuff[index].dmaAddr = txDma;
+    pTxQueue->pPktBuff[index].pVirtAddr = pBuffer_p->pBuffer;
+    pTxQueue->pPktBuff[index].len = pBuffer_p->txFrameSize;
+
+    pTtxDesc->advDesc.sRead.bufferAddrLe = cpu_to_le64(txDma);
+    pTtxDesc->advDesc.sRead.cmdTypeLen = (UINT)pBuffer_p->txFrameSize;
+    pTtxDesc->advDesc.sRead.cmdTypeLen |= (EDRV_TDESC_CMD_DEXT | EDRV_TDESC_DTYP_ADV |
+                                           EDRV_TDESC_CMD_EOP | EDRV_TDESC_CMD_IFCS |
+                                           EDRV_TDESC_CMD_RS);
+
+    pTtxDesc->advDesc.sRead.statusIdxPaylen = (pBuffer_p->txFrameSize << 14);
+
+    index = ((index + 1) & edrvInstance_l.ttxDescMask);
+    // increment Tx descriptor queue tail pointer
+    pTxQueue->nextDesc = index;
+    *pQueue_p = queue;
+
+Exit:
+    return ret;
+}
 
 //------------------------------------------------------------------------------
 /**
@@ -1257,6 +1406,8 @@ static irqreturn_t edrvTimerInterrupt(INT irqNum_p, void* ppDevInstData_p)
     UINT32          reg;
     INT             handled = IRQ_HANDLED;
 
+    EDRVIRQ_CAPTURE_THREAD(irqNum_p);
+
     if (ppDevInstData_p != edrvInstance_l.pPciDev)
     {
         handled = IRQ_NONE;
@@ -1265,6 +1416,21 @@ static irqreturn_t edrvTimerInterrupt(INT irqNum_p, void* ppDevInstData_p)
 
     status = EDRV_REGDW_READ(EDRV_INTR_READ_REG);
 
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+    // the link status change shares the vector with the time sync interrupt
+    if ((status & EDRV_INTR_ICR_LSC) != 0)
+    {
+        status &= ~EDRV_INTR_ICR_LSC;
+        signalLinkChange();
+
+        if ((status & EDRV_INTR_ICR_TIME_SYNC) == 0)
+        {
+            EDRV_REGDW_WRITE(EDRV_INTR_SET_REG, status);
+            goto Exit;
+        }
+    }
+#endif
+
     if ((status & EDRV_INTR_ICR_TIME_SYNC) == 0)
     {
         handled = IRQ_NONE;
@@ -1308,9 +1474,14 @@ static irqreturn_t edrvIrqHandler(INT irqNum_p, void* ppDevInstData_p)
     tEdrvQVector*   pQVector = (tEdrvQVector*)ppDevInstData_p;
     tEdrvQueue*     pTxQueue;
     tEdrvQueue*     pRxQueue;
+#if (CONFIG_EDRV_I210_MULTI_QUEUE != FALSE)
+    ULONG           flags;
+#endif
 
     handled = IRQ_HANDLED;
 
+    EDRVIRQ_CAPTURE_THREAD(irqNum_p);
+
     if (edrvInstance_l.pQvector[pQVector->queueIdx] != pQVector)
     {
         handled = IRQ_NONE;
@@ -1322,8 +1493,14 @@ static irqreturn_t edrvIrqHandler(INT irqNum_p, void* ppDevInstData_p)
     pTxQueue = edrvInstance_l.pTxQueue[pQVector->queueIdx];
     pRxQueue = edrvInstance_l.pRxQueue[pQVector->queueIdx];
 
+#if (CONFIG_EDRV_I210_MULTI_QUEUE != FALSE)
+    // The Tx and Rx causes in ICR are shared by the queue vectors, so they
+    // don't tell which queue has work. The rings are checked by their DD bits.
+    reg = (EDRV_INTR_ICR_RXDW | EDRV_INTR_ICR_TXDW);
+#else
     // Read the interrupt status
     reg = EDRV_REGDW_READ(EDRV_INTR_READ_REG);
+#endif
 
     // Process Rx with priority over Tx
     if ((pRxQueue != NULL )&& (reg & EDRV_INTR_ICR_RXDW))
@@ -1362,10 +1539,26 @@ static irqreturn_t edrvIrqHandler(INT irqNum_p, void* ppDevInstData_p)
                                         rcvLen,
                                         DMA_FROM_DEVICE);
 
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+                rxBuffer.rxTimeStampNs = 0;
+                if ((pAdvRxDesc->sWb.extStatusError & EDRV_RDESC_STATUS_TSIP) &&
+                    (rcvLen > EDRV_RX_TIMESTAMP_LEN))
+                {   // strip the time stamp in front of the packet
+                    UINT64  systim;
+
+                    systim = le64_to_cpu(*(__le64*)(rxBuffer.pBuffer + EDRV_RX_TIMESTAMP_OFFSET));
+                    rxBuffer.rxTimeStampNs = EDRV_SYSTIM_TO_NS(systim);
+                    rxBuffer.pBuffer += EDRV_RX_TIMESTAMP_LEN;
+                    rxBuffer.rxFrameSize -= EDRV_RX_TIMESTAMP_LEN;
+                }
+#endif
+
                 // Forward the Rcv packet to DLL
                 if (edrvInstance_l.initParam.pfnRxHandler != NULL)
                 {
+                    EDRV_DLL_LOCK(flags);
                     edrvInstance_l.initParam.pfnRxHandler(&rxBuffer);
+                    EDRV_DLL_UNLOCK(flags);
                 }
 
             }
@@ -1409,8 +1602,8 @@ static irqreturn_t edrvIrqHandler(INT irqNum_p, void* ppDevInstData_p)
 
                 txStatus = pAdvTxDesc->sWb.statusLe;
                 pAdvTxDesc->sWb.statusLe = 0;
-                pTxBuffer = pTxQueue->apTxBuffer[index];
-                pTxQueue->apTxBuffer[index] = NULL;
+                pTxBuffer = pTxQueue->papTxBuffer[index];
+                pTxQueue->papTxBuffer[index] = NULL;
 
                 dma_unmap_single(&edrvInstance_l.pPciDev->dev,
                                  pTxQueue->pPktBuff[index].dmaAddr,
@@ -1418,10 +1611,16 @@ static irqreturn_t edrvIrqHandler(INT irqNum_p, void* ppDevInstData_p)
                 EDRV_COUNT_TX;
                 if (pTxBuffer != NULL)
                 {
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+                    // DMA transmit time reported in the write-back descriptor
+                    pTxBuffer->txTimeStampNs = EDRV_SYSTIM_TO_NS(le64_to_cpu(pAdvTxDesc->sWb.timeStampLe));
+#endif
                     // Call Tx handler of Data link layer
                     if (pTxBuffer->pfnTxHandler != NULL)
                     {
+                        EDRV_DLL_LOCK(flags);
                         pTxBuffer->pfnTxHandler(pTxBuffer);
+                        EDRV_DLL_UNLOCK(flags);
                     }
                 }
                 else
@@ -1429,7 +1628,7 @@ static irqreturn_t edrvIrqHandler(INT irqNum_p, void* ppDevInstData_p)
                     EDRV_COUNT_TX_FUN;
                 }
 
-                index = ((index + 1) & EDRV_MAX_TTX_DESC_LEN);
+                index = ((index + 1) & edrvInstance_l.ttxDescMask);
 
                 pTxQueue->nextWb = index;
                 pTtxDesc = EDRV_GET_TTX_DESC(pTxQueue,index);
@@ -1442,9 +1641,11 @@ static irqreturn_t edrvIrqHandler(INT irqNum_p, void* ppDevInstData_p)
         } while (pAdvTxDesc->sWb.statusLe & EDRV_TDESC_STATUS_DD);
     }
 
+#if (CONFIG_EDRV_I210_MULTI_QUEUE == FALSE)
     // Set the values in ICR again which were not processed here so that they are available
     // for processing in other ISR
     EDRV_REGDW_WRITE(EDRV_INTR_SET_REG, reg);
+#endif
 
 Exit:
     return handled;
@@ -1700,6 +1901,138 @@ static UINT16 readMdioPhyReg(INT phyreg_p)
     return value;
 }
 
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Signal a link change
+
+The function is called by the interrupt handler on a link status change. It
+reports the current link state to the DLL.
+*/
+//------------------------------------------------------------------------------
+static void signalLinkChange(void)
+{
+    BOOL    fLinkUp;
+
+    fLinkUp = ((EDRV_REGDW_READ(EDRV_STATUS_REG) & EDRV_STATUS_LU) != 0);
+
+    if (edrvInstance_l.initParam.pfnLinkChangeHandler != NULL)
+        edrvInstance_l.initParam.pfnLinkChangeHandler(fLinkUp);
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief  Allocate the Tx buffer pool
+
+The function allocates the Tx buffers requested by the DLL in the init
+parameters. The buffer memory is allocated in chunks of EDRV_TX_BUFFER_CHUNK
+frames, so large pools don't need a big physically contiguous block. The free
+buffers are kept on a stack, therefore allocating and freeing a buffer takes
+constant time. The Tx descriptor rings are sized to hold every Tx buffer.
+
+\return The function returns 0 on success or a negative error code.
+*/
+//------------------------------------------------------------------------------
+static INT allocTxBufferPool(void)
+{
+    UINT        bufferCount;
+    UINT        chunkCount;
+    UINT        descCount;
+    UINT        index;
+
+    bufferCount = edrvInstance_l.initParam.txBufferCount;
+    if (bufferCount == 0)
+        bufferCount = EDRV_MAX_TX_BUFFERS;
+
+    chunkCount = (bufferCount + EDRV_TX_BUFFER_CHUNK - 1) / EDRV_TX_BUFFER_CHUNK;
+    edrvInstance_l.papTxBufChunk = kcalloc(chunkCount, sizeof(UINT8*), GFP_KERNEL);
+    if (edrvInstance_l.papTxBufChunk != NULL)
+        edrvInstance_l.txBufChunkCount = chunkCount;
+
+    edrvInstance_l.pafTxBufUsed = kcalloc(bufferCount, sizeof(BOOL), GFP_KERNEL);
+    edrvInstance_l.paTxBufFree = kcalloc(bufferCount, sizeof(UINT), GFP_KERNEL);
+    if ((edrvInstance_l.papTxBufChunk == NULL) ||
+        (edrvInstance_l.pafTxBufUsed == NULL) ||
+        (edrvInstance_l.paTxBufFree == NULL))
+    {
+        freeTxBufferPool();
+        return -ENOMEM;
+    }
+
+    for (index = 0; index < chunkCount; index++)
+    {
+        edrvInstance_l.papTxBufChunk[index] = kzalloc(EDRV_TX_BUFFER_CHUNK * EDRV_MAX_FRAME_SIZE,
+                                                      GFP_KERNEL);
+        if (edrvInstance_l.papTxBufChunk[index] == NULL)
+        {
+            freeTxBufferPool();
+            return -ENOMEM;
+        }
+    }
+
+    // push the buffers in reverse order, so buffer 0 is allocated first
+    for (index = 0; index < bufferCount; index++)
+        edrvInstance_l.paTxBufFree[index] = bufferCount - 1 - index;
+
+    edrvInstance_l.txBufFreeCount = bufferCount;
+    edrvInstance_l.txBufferCount = bufferCount;
+
+    // Every time-triggered Tx descriptor uses two descriptors of the ring and
+    // one slot is needed to distinguish a full from an empty ring.
+    descCount = EDRV_MIN_TX_DESCRIPTOR;
+    while ((descCount < ((bufferCount + 1) * 2)) && (descCount < EDRV_MAX_TX_DESCRIPTOR))
+        descCount <<= 1;
+
+    edrvInstance_l.txDescCount = descCount;
+    edrvInstance_l.ttxDescMask = (descCount >> 1) - 1;
+
+    printk("%s: %u Tx buffers, %u Tx descriptors per queue\n", __FUNCTION__,
+           bufferCount, descCount);
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Free the Tx buffer pool
+
+The function frees the Tx buffer memory allocated by allocTxBufferPool().
+*/
+//------------------------------------------------------------------------------
+static void freeTxBufferPool(void)
+{
+    UINT        index;
+
+    if (edrvInstance_l.papTxBufChunk != NULL)
+    {
+        for (index = 0; index < edrvInstance_l.txBufChunkCount; index++)
+        {
+            if (edrvInstance_l.papTxBufChunk[index] != NULL)
+                kfree(edrvInstance_l.papTxBufChunk[index]);
+        }
+
+        kfree(edrvInstance_l.papTxBufChunk);
+        edrvInstance_l.papTxBufChunk = NULL;
+        edrvInstance_l.txBufChunkCount = 0;
+    }
+
+    if (edrvInstance_l.pafTxBufUsed != NULL)
+    {
+        kfree(edrvInstance_l.pafTxBufUsed);
+        edrvInstance_l.pafTxBufUsed = NULL;
+    }
+
+    if (edrvInstance_l.paTxBufFree != NULL)
+    {
+        kfree(edrvInstance_l.paTxBufFree);
+        edrvInstance_l.paTxBufFree = NULL;
+    }
+
+    edrvInstance_l.txBufFreeCount = 0;
+    edrvInstance_l.txBufferCount = 0;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Free TX buffer queue
@@ -1711,9 +2044,9 @@ The function frees the buffers of a TX queue.
 //------------------------------------------------------------------------------
 static void freeTxBuffersOfQueue(tEdrvQueue* pTxQueue_p)
 {
-    INT         index;
+    UINT        index;
 
-    for (index = 0; index < EDRV_MAX_RX_DESCRIPTOR; index++)
+    for (index = 0; index <= edrvInstance_l.ttxDescMask; index++)
     {
         // set report status for all descriptor
         if (pTxQueue_p->pPktBuff[index].dmaAddr)
@@ -1768,10 +2101,14 @@ static void freeTxQueues(void)
         if (pTxQueue->pPktBuff != NULL)
             kfree(pTxQueue->pPktBuff);
 
+        if (pTxQueue->papTxBuffer != NULL)
+            kfree(pTxQueue->papTxBuffer);
+
         if (pTxQueue->pDescVirt != NULL)
         {
             dma_free_coherent(&edrvInstance_l.pPciDev->dev,
-                              EDRV_TX_DESCS_SIZE, pTxQueue->pDescVirt,
+                              ALIGN(EDRV_TX_DESCS_SIZE(edrvInstance_l.txDescCount), 4096),
+                              pTxQueue->pDescVirt,
                               pTxQueue->descDma);
             kfree(pTxQueue);
             edrvInstance_l.pTxQueue[index] = NULL;
@@ -1798,7 +2135,7 @@ static tOplkError initTxQueue(tEdrvQueue* pTxQueue_p)
 
     // Allocate Tx Descriptor
     printk("{%s}:Allocating Tx Desc %p\n", __FUNCTION__, pTxQueue_p);
-    descSize = ALIGN(EDRV_TX_DESCS_SIZE, 4096);
+    descSize = ALIGN(EDRV_TX_DESCS_SIZE(edrvInstance_l.txDescCount), 4096);
     pTxQueue_p->pDescVirt = dma_alloc_coherent(&edrvInstance_l.pPciDev->dev,
                                                descSize, &pTxQueue_p->descDma, GFP_KERNEL);
     if (pTxQueue_p->pDescVirt == NULL)
@@ -1807,12 +2144,17 @@ static tOplkError initTxQueue(tEdrvQueue* pTxQueue_p)
     printk("... Done\n");
 
     // Clear the descriptor memory
-    memset(pTxQueue_p->pDescVirt, 0, EDRV_TX_DESCS_SIZE);
+    memset(pTxQueue_p->pDescVirt, 0, EDRV_TX_DESCS_SIZE(edrvInstance_l.txDescCount));
 
-    pTxQueue_p->pPktBuff = kzalloc((EDRV_MAX_TX_DESCRIPTOR * sizeof(tEdrvPktBuff)), GFP_KERNEL);
+    // Bookkeeping is done per time-triggered descriptor (pair of descriptors)
+    pTxQueue_p->pPktBuff = kcalloc(edrvInstance_l.ttxDescMask + 1, sizeof(tEdrvPktBuff), GFP_KERNEL);
     if (pTxQueue_p->pPktBuff == NULL)
         return kErrorEdrvInit;
 
+    pTxQueue_p->papTxBuffer = kcalloc(edrvInstance_l.ttxDescMask + 1, sizeof(tEdrvTxBuffer*), GFP_KERNEL);
+    if (pTxQueue_p->papTxBuffer == NULL)
+        return kErrorEdrvInit;
+
     pTxQueue_p->nextDesc = 0;
     pTxQueue_p->nextWb = 0;
 
@@ -1846,7 +2188,7 @@ static void configureTxQueue(tEdrvQueue* pTxQueue_p)
     txDescDma = pTxQueue_p->descDma;
 
     // Initialize the queue parameters in controller
-    EDRV_REGDW_WRITE(EDRV_TDLEN(queue), EDRV_TX_DESCS_SIZE);
+    EDRV_REGDW_WRITE(EDRV_TDLEN(queue), EDRV_TX_DESCS_SIZE(edrvInstance_l.txDescCount));
     EDRV_REGDW_WRITE(EDRV_TDBAL(queue), (txDescDma & 0x00000000ffffffffULL));
     EDRV_REGDW_WRITE(EDRV_TDBAH(queue), (txDescDma >> 32));
     EDRV_REGDW_WRITE(EDRV_TDHEAD(queue), 0);
@@ -1907,7 +2249,7 @@ static void freeRxQueues(void)
         if (pRxQueue->pDescVirt != NULL)
         {
             dma_free_coherent(&edrvInstance_l.pPciDev->dev,
-                              EDRV_TX_DESCS_SIZE, pRxQueue->pDescVirt,
+                              ALIGN(EDRV_RX_DESCS_SIZE, 4096), pRxQueue->pDescVirt,
                               pRxQueue->descDma);
             kfree(pRxQueue);
             edrvInstance_l.pRxQueue[index] = NULL;
@@ -2078,6 +2420,9 @@ static void configureRxQueue(tEdrvQueue* pRxQueue_p)
     reg = EDRV_REGDW_READ(EDRV_SRRCTL(queue));
     //reg |= EDRV_SRRCTL_DROP_EN;
     reg |= EDRV_SRRCTL_DESCTYPE_ADV;          // Advance mode with no packet split
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+    reg |= EDRV_SRRCTL_TIMESTAMP;             // Place the Rx time stamp in front of the packet
+#endif
     EDRV_REGDW_WRITE(EDRV_SRRCTL(queue), reg);
 
     // Enable the rx queue
@@ -2129,7 +2474,13 @@ static void initQavMode(void)
 
     // Configure Q0 as SR queue
     dwTqavcc0 = EDRV_TQAVCC_QUEUE_MODE_SR; /* no idle slope */
-    EDRV_REGDW_WRITE(EDRV_TQAVCC(0), dwTqavcc0);
+    EDRV_REGDW_WRITE(EDRV_TQAVCC(EDRV_QUEUE_ISOC), dwTqavcc0);
+
+#if (CONFIG_EDRV_I210_MULTI_QUEUE != FALSE)
+    // Configure Q1 as strict priority queue, it waits for the SR queue
+    // (EDRV_TQAVCTRL_SP_WAIT_SR) so the launch times are kept
+    EDRV_REGDW_WRITE(EDRV_TQAVCC(EDRV_QUEUE_ASYNC), 0);
+#endif
 
     dwTqavctrl = 0;
     dwTqavctrl = EDRV_TQAVCTRL_TXMODE | EDRV_TQAVCTRL_FETCH_ARB
@@ -2192,6 +2543,8 @@ static INT requestMsixIrq(void)
     UINT            txQueue;
     UINT            rxQueue;
     tEdrvQVector*   pQvector;
+    tEdrvIrqClass   irqClass;
+    ULONG           flags;
 
     // request timer interrupt
     ret = request_irq(edrvInstance_l.pMsixEntry[vector].vector,
@@ -2199,15 +2552,21 @@ static INT requestMsixIrq(void)
     if (ret != 0)
         return ret;
 
+    edrvirq_addIrq(edrvInstance_l.pMsixEntry[vector].vector, kEdrvIrqClassIsoc, 0);
+
     vector++;
     // request queue interrupts
     for (index = 0; index < edrvInstance_l.numQVectors; index++, vector++)
     {
         pQvector = edrvInstance_l.pQvector[index];
+        irqClass = (index == EDRV_QUEUE_ISOC) ? kEdrvIrqClassIsoc : kEdrvIrqClassAsync;
+        flags = edrvirq_getRequestFlags(irqClass);
         ret = request_irq(edrvInstance_l.pMsixEntry[vector].vector,
-                          edrvIrqHandler, 0, pQvector->strName, pQvector);
+                          edrvIrqHandler, flags, pQvector->strName, pQvector);
         if (ret != 0)
             return ret;
+
+        edrvirq_addIrq(edrvInstance_l.pMsixEntry[vector].vector, irqClass, flags);
     }
 
     // Configure MSI-X
@@ -2233,6 +2592,32 @@ static INT requestMsixIrq(void)
     return ret;
 }
 
+#if (CONFIG_EDRV_I210_MULTI_QUEUE != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the Rx queue steering
+
+The function steers the received frames to the Rx queues. POWERLINK frames are
+received in the isochronous queue by an EtherType filter, all other frames go
+to the default queue, which is the asynchronous queue.
+*/
+//------------------------------------------------------------------------------
+static void initRxSteering(void)
+{
+    UINT32      reg;
+
+    reg = EDRV_REGDW_READ(EDRV_MRQC_REG);
+    reg &= ~(0x7 << EDRV_MRQC_DEF_Q_SHIFT);
+    reg |= (EDRV_QUEUE_ASYNC << EDRV_MRQC_DEF_Q_SHIFT);
+    EDRV_REGDW_WRITE(EDRV_MRQC_REG, reg);
+
+    reg = C_DLL_ETHERTYPE_EPL;
+    reg |= (EDRV_QUEUE_ISOC << EDRV_ETQF_QUEUE_SHIFT);
+    reg |= (EDRV_ETQF_FILTER_EN | EDRV_ETQF_QUEUE_EN);
+    EDRV_REGDW_WRITE(EDRV_ETQF(0), reg);
+}
+#endif
+
 //------------------------------------------------------------------------------
 /**
 \brief  Initialize one PCI device
@@ -2390,6 +2775,14 @@ static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id*
     reg = EDRV_REGDW_READ(EDRV_CTRL_REG);
     reg &= ~(EDRV_CTRL_FD | EDRV_CTRL_ILOS | EDRV_CTRL_TFCE | EDRV_CTRL_RFCE);
     reg |= EDRV_CTRL_SLU;
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+    // skip the auto-negotiation, the MAC uses the same settings as the PHY
+    reg |= (EDRV_CTRL_FRCSPD | EDRV_CTRL_FRCDPLX);
+    if ((CONFIG_EDRV_FAST_LINK_PHY_CONTROL & PHY_LINK_SPEED_100) != 0)
+        reg |= EDRV_CTRL_SPEED_100;
+    if ((CONFIG_EDRV_FAST_LINK_PHY_CONTROL & PHY_MODE_FD) != 0)
+        reg |= EDRV_CTRL_FD;
+#endif
     EDRV_REGDW_WRITE(EDRV_CTRL_REG, reg);
 
     // Reset the PHY
@@ -2406,7 +2799,11 @@ static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id*
     reg &= ~(EDRV_CTRL_PHY_RST);
     EDRV_REGDW_WRITE(EDRV_CTRL_REG, reg);
     msleep(10);
-    //5. Release semaphore
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+    //5. Force the link settings, the PHY applies them with a software reset
+    writeMdioPhyReg(PHY_CONTROL_REG_OFFSET, (CONFIG_EDRV_FAST_LINK_PHY_CONTROL | PHY_RESET));
+#endif
+    //6. Release semaphore
     releaseSwFwSync(EDRV_SWFW_PHY0_SM);
 
     // Get Control from hardware
@@ -2419,12 +2816,20 @@ static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id*
     edrvInstance_l.txMaxQueue = EDRV_MAX_TX_QUEUES;
     edrvInstance_l.rxMaxQueue = EDRV_MAX_RX_QUEUES;
     edrvInstance_l.numQVectors = EDRV_MAX_QUEUE_VECTOR;
+#if (CONFIG_EDRV_I210_MULTI_QUEUE != FALSE)
+    spin_lock_init(&edrvInstance_l.dllLock);
+#endif
 
     //Initialise the SYSTIM timer with current system time
     EDRV_REGDW_WRITE(EDRV_TSAUXC, 0x0);
     sysTime = ktime_to_timespec(ktime_get_real());
     writeSystimRegister(&sysTime);
 
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+    // Time stamp all received packets
+    EDRV_REGDW_WRITE(EDRV_TSYNCRXCTL, EDRV_TSYNCRXCTL_EN | EDRV_TSYNCRXCTL_TYPE_ALL);
+#endif
+
     // Clear the statistic register
     reg = EDRV_REGDW_READ(EDRV_STAT_TPT);
     reg = EDRV_REGDW_READ(EDRV_STAT_TPR);
@@ -2470,12 +2875,9 @@ static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id*
     }
 
     // Allocate Tx buffer memory
-    edrvInstance_l.pTxBuf = kzalloc(EDRV_TX_BUFFER_SIZE, GFP_KERNEL);
-    if (edrvInstance_l.pTxBuf == NULL)
-    {
-        result = -ENOMEM;
+    result = allocTxBufferPool();
+    if (result != 0)
         goto ExitFail;
-    }
 
     for (index = 0; index < edrvInstance_l.txMaxQueue; index++)
     {
@@ -2611,6 +3013,10 @@ static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id*
         configureRxQueue(edrvInstance_l.pRxQueue[index]);
     }
 
+#if (CONFIG_EDRV_I210_MULTI_QUEUE != FALSE)
+    initRxSteering();
+#endif
+
     // Allocate Rx buffers
     for (index = 0; index < edrvInstance_l.rxMaxQueue; index++)
     {
@@ -2632,14 +3038,18 @@ static INT initOnePciDev(struct pci_dev* pPciDev_p, const struct pci_device_id*
     printk("...Done\n");
 
     // enable interrupts
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+    EDRV_REGDW_WRITE(EDRV_INTR_MASK_SET_READ, (EDRV_INTR_ICR_TIME_SYNC | EDRV_INTR_ICR_LSC));
+#else
     EDRV_REGDW_WRITE(EDRV_INTR_MASK_SET_READ, (EDRV_INTR_ICR_TIME_SYNC ));
+#endif
 
     reg = EDRV_REGDW_READ(EDRV_EXT_INTR_MASK_SET);
-    reg |= (EDRV_EICS_TXRXQUEUE1 | EDRV_EICS_OTHER);
+    reg |= (EDRV_EICS_QUEUE_VECTORS | EDRV_EICS_OTHER);
     EDRV_REGDW_WRITE(EDRV_EXT_INTR_MASK_SET, reg);
 
     reg = EDRV_REGDW_READ(EDRV_INTR_EIAC);
-    reg |= (EDRV_EICS_TXRXQUEUE1 | EDRV_EICS_OTHER);
+    reg |= (EDRV_EICS_QUEUE_VECTORS | EDRV_EICS_OTHER);
     EDRV_REGDW_WRITE(EDRV_INTR_EIAC, reg);
 
     printk("%s waiting for link up...", __FUNCTION__);
@@ -2709,10 +3119,12 @@ static void removeOnePciDev(struct pci_dev* pPciDev_p)
     if (edrvInstance_l.pMsixEntry)
     {
         vector = 0;
+        edrvirq_removeIrq(edrvInstance_l.pMsixEntry[vector].vector);
         free_irq(edrvInstance_l.pMsixEntry[vector].vector, pPciDev_p);
         vector++;
         for (index = 0; index < edrvInstance_l.numQVectors; index++)
         {
+            edrvirq_removeIrq(edrvInstance_l.pMsixEntry[vector].vector);
             free_irq(edrvInstance_l.pMsixEntry[vector].vector,
                      edrvInstance_l.pQvector[index]);
             vector++;
@@ -2721,25 +3133,37 @@ static void removeOnePciDev(struct pci_dev* pPciDev_p)
         kfree(edrvInstance_l.pMsixEntry);
     }
 
-    reg = EDRV_REGDW_READ(EDRV_TXDCTL(0));
-    reg |= EDRV_TXDCTL_SWFLSH;
-    EDRV_REGDW_WRITE(EDRV_TXDCTL(0), reg);
+    for (index = 0; index < EDRV_MAX_TX_QUEUES; index++)
+    {
+        reg = EDRV_REGDW_READ(EDRV_TXDCTL(index));
+        reg |= EDRV_TXDCTL_SWFLSH;
+        EDRV_REGDW_WRITE(EDRV_TXDCTL(index), reg);
+    }
 
     //Disable Rx
-    reg = EDRV_REGDW_READ(EDRV_RXDCTL(0));
-    reg |= EDRV_RXDCTL_SWFLUSH;
-    EDRV_REGDW_WRITE(EDRV_RXDCTL(0), reg);
+    for (index = 0; index < EDRV_MAX_RX_QUEUES; index++)
+    {
+        reg = EDRV_REGDW_READ(EDRV_RXDCTL(index));
+        reg |= EDRV_RXDCTL_SWFLUSH;
+        EDRV_REGDW_WRITE(EDRV_RXDCTL(index), reg);
+    }
 
     EDRV_REGDW_READ(EDRV_STATUS_REG);
     msleep(10);
 
-    reg = EDRV_REGDW_READ(EDRV_TXDCTL(0));
-    reg &= ~EDRV_TXDCTL_SWFLSH;
-    EDRV_REGDW_WRITE(EDRV_TXDCTL(0), reg);
+    for (index = 0; index < EDRV_MAX_TX_QUEUES; index++)
+    {
+        reg = EDRV_REGDW_READ(EDRV_TXDCTL(index));
+        reg &= ~EDRV_TXDCTL_SWFLSH;
+        EDRV_REGDW_WRITE(EDRV_TXDCTL(index), reg);
+    }
 
-    reg = EDRV_REGDW_READ(EDRV_RXDCTL(0));
-    reg &= ~EDRV_RXDCTL_SWFLUSH;
-    EDRV_REGDW_WRITE(EDRV_RXDCTL(0), reg);
+    for (index = 0; index < EDRV_MAX_RX_QUEUES; index++)
+    {
+        reg = EDRV_REGDW_READ(EDRV_RXDCTL(index));
+        reg &= ~EDRV_RXDCTL_SWFLUSH;
+        EDRV_REGDW_WRITE(EDRV_RXDCTL(index), reg);
+    }
 
     // Disable Tx
     reg = EDRV_REGDW_READ(EDRV_TCTL_REG);
@@ -2757,10 +3181,7 @@ static void removeOnePciDev(struct pci_dev* pPciDev_p)
     freeTxQueues();
     freeRxQueues();
 
-    if (edrvInstance_l.pTxBuf != NULL)
-    {
-        kfree(edrvInstance_l.pTxBuf);
-    }
+    freeTxBufferPool();
 
     // Power down PHY
     wReg = readMdioPhyReg(PHY_I210_COPPER_SPEC);
@@ -90,10 +90,31 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // const defines
 //------------------------------------------------------------------------------
 #define EDRV_MAX_FRAME_SIZE     0x600
+#define EDRV_CLUSTER_SIZE       2048
+
+// The mBlk tuple of a Tx buffer is stored in front of the frame data in its
+// cluster, the frame data starts EDRV_TX_HEADROOM bytes after the cluster start.
+#define EDRV_TX_HEADROOM        32
+
+#ifndef CONFIG_EDRV_MUX_RX_LOAN_COUNT
+#define CONFIG_EDRV_MUX_RX_LOAN_COUNT   16      // maximum number of Rx clusters loaned to the DLL
+#endif
 
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
+/**
+\brief Loaned Rx cluster
+
+The structure describes a received MUX packet whose cluster is used by the DLL
+until it is released by edrv_releaseRxBuffer().
+*/
+typedef struct
+{
+    UINT8*              pBuffer;        ///< Frame data passed to the DLL
+    M_BLK_ID            pPkt;           ///< Packet that owns the cluster (NULL = entry is free)
+} tEdrvRxLoan;
+
 // Private structure
 typedef struct
 {
@@ -108,6 +129,7 @@ typedef struct
     INT                 txTaskId;
     SEM_ID              txWakeupSem;
     BOOL                fStopTxTask;
+    tEdrvRxLoan         aRxLoan[CONFIG_EDRV_MUX_RX_LOAN_COUNT];
 
 #if CONFIG_EDRV_USE_DIAGNOSTICS != FALSE
     struct timespec     txSendTime;
@@ -132,6 +154,8 @@ static STATUS muxRestart(void* pEnd_p, void* pNetCallbackId_p);
 static void muxError(END_OBJ* pEnd_p, END_ERR* pError_p, void* pNetCallbackId_p);
 static INT txTask(INT iArg_p);
 static void getMacAddr(PROTO_COOKIE pCookie_p, char* pIfName, UINT8* pMacAddr_p);
+static tEdrvRxLoan* loanRxPacket(M_BLK_ID pPkt_p);
+static M_BLK_ID getTxTuple(UINT8* pBuffer_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -169,7 +193,7 @@ tOplkError edrv_init(tEdrvInitParam* pEdrvInitParam_p)
 
     /* create memory pool */
     clDescTblData.clNum = 65536;
-    clDescTblData.clSize = 2048;
+    clDescTblData.clSize = EDRV_CLUSTER_SIZE;
 
     bufCfgData.pName = "data";
     bufCfgData.attributes = ATTR_AI_SH_ISR;
@@ -295,6 +319,8 @@ This function shuts down the Ethernet driver.
 //------------------------------------------------------------------------------
 tOplkError edrv_shutdown(void)
 {
+    UINT    index;
+
     // signal shutdown to the thread
     muxUnbind(edrvInstance_l.pCookie, MUX_PROTO_PROMISC,
               (FUNCPTR)packetHandler);
@@ -304,6 +330,13 @@ tOplkError edrv_shutdown(void)
     semGive(edrvInstance_l.txWakeupSem);
     taskDelay(sysClkRateGet() / 10);
 
+    // free the clusters which have not been released by the DLL
+    for (index = 0; index < CONFIG_EDRV_MUX_RX_LOAN_COUNT; index++)
+    {
+        if (edrvInstance_l.aRxLoan[index].pPkt != NULL)
+            netMblkClChainFree(edrvInstance_l.aRxLoan[index].pPkt);
+    }
+
     netPoolRelease(edrvInstance_l.dataPoolId, NET_REL_IN_CONTEXT);
 
     semDelete(edrvInstance_l.mutex);
@@ -320,7 +353,10 @@ tOplkError edrv_shutdown(void)
 /**
 \brief  Send Tx buffer
 
-This function sends the Tx buffer.
+This function sends the Tx buffer. The frame is not copied, a new mBlk which
+references the cluster of the Tx buffer is passed to the MUX. The cluster
+reference of the Tx buffer keeps the cluster allocated after the driver
+has freed the sent mBlk.
 
 \param  pBuffer_p           Tx buffer descriptor
 
@@ -333,6 +369,7 @@ tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
 {
     tOplkError  ret = kErrorOk;
     INT         muxRet;
+    M_BLK_ID    pTuple;
     M_BLK_ID    pPacket;
 
     if (pBuffer_p->txBufferNumber.pArg != NULL)
@@ -355,16 +392,23 @@ tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
     }
     semGive(edrvInstance_l.mutex);
 
-    /* generate packet */
-    if ((pPacket = netTupleGet(edrvInstance_l.dataPoolId, EDRV_MAX_MTU,
-                               M_WAIT, MT_HEADER, TRUE)) == NULL)
+    /* generate packet referencing the cluster of the Tx buffer */
+    pTuple = getTxTuple(pBuffer_p->pBuffer);
+    if ((pPacket = netMblkGet(edrvInstance_l.dataPoolId, M_DONTWAIT, MT_HEADER)) == NULL)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Couldn't get mBlk!\n", __func__);
+        goto Exit;
+    }
+    if (netMblkDup(pTuple, pPacket) == NULL)
     {
-        DEBUG_LVL_ERROR_TRACE("%s() Couldn't get tuple!\n", __func__);
+        DEBUG_LVL_ERROR_TRACE("%s() Couldn't duplicate mBlk!\n", __func__);
+        netMblkFree(edrvInstance_l.dataPoolId, pPacket);
         goto Exit;
     }
     pPacket->mBlkHdr.reserved = htons(0x88ab);
-    OPLK_MEMCPY(pPacket->mBlkHdr.mData, pBuffer_p->pBuffer, pBuffer_p->txFrameSize);
     pPacket->mBlkHdr.mLen = pBuffer_p->txFrameSize;
+    pPacket->mBlkHdr.mFlags |= M_PKTHDR;
+    pPacket->mBlkPktHdr.len = pBuffer_p->txFrameSize;
     /* send packet out */
     if ((muxRet = muxSend(edrvInstance_l.pCookie, pPacket)) != OK)
     {
@@ -390,7 +434,9 @@ Exit:
 /**
 \brief  Allocate Tx buffer
 
-This function allocates a Tx buffer.
+This function allocates a Tx buffer. The buffer is located in a cluster of the
+driver's network pool. The mBlk tuple of the cluster is allocated once and
+used for all transmissions of the buffer.
 
 \param  pBuffer_p           Tx buffer descriptor
 
@@ -401,7 +447,9 @@ This function allocates a Tx buffer.
 //------------------------------------------------------------------------------
 tOplkError edrv_allocTxBuffer(tEdrvTxBuffer* pBuffer_p)
 {
-    tOplkError ret = kErrorOk;
+    tOplkError  ret = kErrorOk;
+    M_BLK_ID    pTuple;
+    UINT8*      pCluster;
 
     if (pBuffer_p->maxBufferSize > EDRV_MAX_FRAME_SIZE)
     {
@@ -409,14 +457,20 @@ tOplkError edrv_allocTxBuffer(tEdrvTxBuffer* pBuffer_p)
         goto Exit;
     }
 
-    // allocate buffer with malloc
-    pBuffer_p->pBuffer = OPLK_MALLOC(pBuffer_p->maxBufferSize);
-    if (pBuffer_p->pBuffer == NULL)
+    // allocate mBlk tuple from the network pool
+    if ((pTuple = netTupleGet(edrvInstance_l.dataPoolId, EDRV_CLUSTER_SIZE,
+                              M_WAIT, MT_HEADER, TRUE)) == NULL)
     {
         ret = kErrorEdrvNoFreeBufEntry;
         goto Exit;
     }
 
+    // store the tuple in front of the frame data
+    pCluster = (UINT8*)pTuple->mBlkHdr.mData;
+    *(M_BLK_ID*)pCluster = pTuple;
+    pTuple->mBlkHdr.mData = (char*)(pCluster + EDRV_TX_HEADROOM);
+    pBuffer_p->pBuffer = pCluster + EDRV_TX_HEADROOM;
+
     pBuffer_p->txBufferNumber.pArg = NULL;
 
 Exit:
@@ -443,11 +497,56 @@ tOplkError edrv_freeTxBuffer(tEdrvTxBuffer* pBuffer_p)
     // mark buffer as free, before actually freeing it
     pBuffer_p->pBuffer = NULL;
 
-    OPLK_FREE(pBuffer);
+    // a packet still referencing the cluster keeps it allocated
+    netMblkClChainFree(getTxTuple(pBuffer));
 
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Release Rx buffer
+
+This function releases a received frame buffer which was kept by the DLL
+(the Rx handler returned kEdrvReleaseRxBufferLater). The loaned MUX cluster
+is returned to the network pool.
+
+\param  pRxBuffer_p         Rx buffer descriptor
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_releaseRxBuffer(tEdrvRxBuffer* pRxBuffer_p)
+{
+    tOplkError      ret = kErrorEdrvInvalidRxBuf;
+    tEdrvRxLoan*    pLoan;
+    M_BLK_ID        pPkt = NULL;
+    UINT            index;
+
+    semTake(edrvInstance_l.mutex, WAIT_FOREVER);
+    for (index = 0; index < CONFIG_EDRV_MUX_RX_LOAN_COUNT; index++)
+    {
+        pLoan = &edrvInstance_l.aRxLoan[index];
+        if ((pLoan->pPkt != NULL) && (pLoan->pBuffer == pRxBuffer_p->pBuffer))
+        {
+            pPkt = pLoan->pPkt;
+            pLoan->pPkt = NULL;
+            break;
+        }
+    }
+    semGive(edrvInstance_l.mutex);
+
+    if (pPkt != NULL)
+    {
+        netMblkClChainFree(pPkt);
+        ret = kErrorOk;
+    }
+
+    return ret;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Change Rx filter setup
@@ -553,7 +652,11 @@ void EdrvShow(void)
 /**
 \brief  Edrv packet handler
 
-This function is the packet handler forwarding the frames to the dllk.
+This function is the packet handler forwarding the frames to the dllk. A
+frame which is located in a single cluster is passed to the dllk without
+copying. If the dllk keeps the frame, the cluster is loaned to it until it is
+released by edrv_releaseRxBuffer(). Frames in a cluster chain and frames
+received while all loan entries are in use are copied.
 
 \param  pCookie_p           Pointer to MUX interface
 \param  type_p              Network service type of the packet
@@ -567,9 +670,11 @@ This function is the packet handler forwarding the frames to the dllk.
 static BOOL packetHandler(void* pCookie_p, LONG type_p, M_BLK_ID pPkt_p,
                                 LL_HDR_INFO* pLLHInfo_p, void* pNetCallbackId_p)
 {
-    tEdrvInstance*  pInstance = (tEdrvInstance*) pNetCallbackId_p;
-    tEdrvRxBuffer   rxBuffer;
-    char            aBuffer[EDRV_MAX_MTU];
+    tEdrvInstance*          pInstance = (tEdrvInstance*) pNetCallbackId_p;
+    tEdrvRxBuffer           rxBuffer;
+    tEdrvRxLoan*            pLoan = NULL;
+    tEdrvReleaseRxBuffer    releaseRxBuffer;
+    char                    aBuffer[EDRV_MAX_MTU];
 
     UNUSED_PARAMETER(pCookie_p);
     UNUSED_PARAMETER(type_p);
@@ -578,16 +683,41 @@ static BOOL packetHandler(void* pCookie_p, LONG type_p, M_BLK_ID pPkt_p,
                     pInstance->initParam.aMacAddr, 6 ) != 0)
     {
         rxBuffer.bufferInFrame = kEdrvBufferLastInFrame;
-        rxBuffer.rxFrameSize = netMblkToBufCopy(pPkt_p, aBuffer, NULL);
-        rxBuffer.pBuffer = (unsigned char*)aBuffer;
+        rxBuffer.pRxTimeStamp = NULL;
+
+        if (pPkt_p->mBlkHdr.mNext == NULL)
+            pLoan = loanRxPacket(pPkt_p);
+
+        if (pLoan != NULL)
+        {   // zero-copy, pass the cluster data to the dllk
+            rxBuffer.rxFrameSize = pPkt_p->mBlkHdr.mLen;
+            rxBuffer.pBuffer = pLoan->pBuffer;
+        }
+        else
+        {
+            rxBuffer.rxFrameSize = netMblkToBufCopy(pPkt_p, aBuffer, NULL);
+            rxBuffer.pBuffer = (UINT8*)aBuffer;
+        }
+
+        releaseRxBuffer = pInstance->initParam.pfnRxHandler(&rxBuffer);
+        if (pLoan != NULL)
+        {
+            if (releaseRxBuffer == kEdrvReleaseRxBufferLater)
+                return TRUE;    // the packet is freed by edrv_releaseRxBuffer()
 
-        pInstance->initParam.pfnRxHandler(&rxBuffer);
-        netMblkClChainFree(pPkt_p);
+            // return the loan entry
+            semTake(pInstance->mutex, WAIT_FOREVER);
+            pLoan->pPkt = NULL;
+            semGive(pInstance->mutex);
+        }
     }
     else
     {   // self generated traffic
         DEBUG_LVL_EDRV_TRACE ("%s() self generated traffic!\n", __func__);
     }
+
+    // the packet is consumed in any case
+    netMblkClChainFree(pPkt_p);
     return TRUE;
 }
 
@@ -752,5 +882,55 @@ static void getMacAddr(PROTO_COOKIE pCookie_p, char* pIfName_p, UINT8* pMacAddr_
     OPLK_MEMCPY(pMacAddr_p, aData, 6);
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Loan a received packet
+
+This function enters a received packet into a free entry of the Rx loan table.
+The entry is made before the frame is passed to the dllk, so the frame can
+already be released while the Rx handler is running.
+
+\param  pPkt_p      Received packet.
+
+\return The function returns a pointer to the loan entry or NULL if all
+        entries are in use.
+*/
+//------------------------------------------------------------------------------
+static tEdrvRxLoan* loanRxPacket(M_BLK_ID pPkt_p)
+{
+    tEdrvRxLoan*    pLoan;
+    UINT            index;
+
+    semTake(edrvInstance_l.mutex, WAIT_FOREVER);
+    for (index = 0; index < CONFIG_EDRV_MUX_RX_LOAN_COUNT; index++)
+    {
+        pLoan = &edrvInstance_l.aRxLoan[index];
+        if (pLoan->pPkt == NULL)
+        {
+            pLoan->pBuffer = (UINT8*)pPkt_p->mBlkHdr.mData;
+            pLoan->pPkt = pPkt_p;
+            semGive(edrvInstance_l.mutex);
+            return pLoan;
+        }
+    }
+    semGive(edrvInstance_l.mutex);
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get mBlk tuple of a Tx buffer
+
+\param  pBuffer_p   Frame data of the Tx buffer.
+
+\return The function returns the mBlk tuple which owns the cluster.
+*/
+//------------------------------------------------------------------------------
+static M_BLK_ID getTxTuple(UINT8* pBuffer_p)
+{
+    return *(M_BLK_ID*)(pBuffer_p - EDRV_TX_HEADROOM);
+}
+
 ///\}
 
@@ -100,6 +100,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     #undef EDRV_MAX_TX_BUF2
 #endif
 
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+// Convert extended openMAC time stamp ticks to ns without truncation
+#define EDRV_TICKS_2_NS(ticks_p)    ((UINT64)(ticks_p) * OMETH_TICKS_2_NS(1))
+#endif
+
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
@@ -147,6 +152,20 @@ typedef struct
 #if CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_ASYNC != FALSE
     OMETH_HOOK_H        pRxAsndHookInst;
 #endif
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+    UINT64              lastTimeStampTicks;     // latest time stamp extended to 64 bit
+#endif
+#if (CONFIG_EDRV_RX_FILTER_BATCH != FALSE)
+    // Rx filter changes which are applied by edrv_commitRxFilter()
+    tEdrvFilter*        pPendingFilter;
+    UINT                aPendingChangeFlags[EDRV_MAX_FILTERS];
+    BOOL                fFilterChangePending;
+#if EDRV_MAX_AUTO_RESPONSES != 0
+    // auto-response frames which are armed in the openMAC response descriptors
+    tEdrvTxBuffer*      apCachedResponse[EDRV_MAX_AUTO_RESPONSES];
+    ULONG               aCachedResponseCount[EDRV_MAX_AUTO_RESPONSES];
+#endif
+#endif
 } tEdrvInstance;
 
 //------------------------------------------------------------------------------
@@ -159,6 +178,8 @@ static tEdrvInstance edrvInstance_l;
 //------------------------------------------------------------------------------
 static ometh_config_typ getMacConfig(UINT adapter_p);
 static tOplkError initRxFilters(void);
+static tOplkError changeRxFilterEntry(tEdrvFilter* pFilter_p, UINT entry_p, UINT changeFlags_p);
+static void enableAutoResponse(UINT entry_p, tEdrvTxBuffer* pTxBuffer_p);
 #if (OPENMAC_PKTLOCTX == OPENMAC_PKTBUF_LOCAL)
 static ometh_packet_typ* allocTxMsgBufferIntern(tEdrvTxBuffer* pBuffer_p);
 static void freeTxMsgBufferIntern(tEdrvTxBuffer* pBuffer_p);
@@ -168,6 +189,9 @@ static void freeTxMsgBufferIntern(tEdrvTxBuffer* pBuffer_p);
 static INT rxHook(void* pArg_p, ometh_packet_typ* pPacket_p, OMETH_BUF_FREE_FCT* pfnFree_p) SECTION_EDRVOPENMAC_RX_HOOK;
 static void txAckCb(ometh_packet_typ* pPacket_p, void* pArg_p, ULONG time_p);
 static void irqHandler(void* pArg_p) SECTION_EDRVOPENMAC_IRQ_HDL;
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+static UINT64 extendTimeStamp(UINT32 timeStamp_p);
+#endif
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -494,6 +518,13 @@ tOplkError edrv_updateTxBuffer(tEdrvTxBuffer* pBuffer_p)
         goto Exit;
     }
 
+#if (CONFIG_EDRV_RX_FILTER_BATCH != FALSE)
+    // remember the armed frame, it is valid until it has been sent
+    edrvInstance_l.apCachedResponse[pBuffer_p->txBufferNumber.value] = pBuffer_p;
+    edrvInstance_l.aCachedResponseCount[pBuffer_p->txBufferNumber.value] =
+        omethResponseCount(edrvInstance_l.apRxFilterInst[pBuffer_p->txBufferNumber.value]);
+#endif
+
 Exit:
 #else
     //invalid call, since auto-resp is deactivated for MN support
@@ -597,6 +628,10 @@ selects the Rx filter entry that shall be changed and \p changeFlags_p determine
 the property.
 If entryChanged_p is equal or larger \p count_p all Rx filters shall be changed.
 
+If CONFIG_EDRV_RX_FILTER_BATCH is enabled, the change of a specific entry is
+only recorded and applied by the next call of edrv_commitRxFilter(). A change
+of all entries is applied immediately and discards the recorded changes.
+
 \param  pFilter_p           Base pointer of Rx filter array
 \param  count_p             Number of Rx filter array entries
 \param  entryChanged_p      Index of Rx filter entry that shall be changed
@@ -624,6 +659,17 @@ tOplkError edrv_changeRxFilter(tEdrvFilter* pFilter_p, UINT count_p,
     {   // no specific entry changed
         // -> all entries changed
 
+#if (CONFIG_EDRV_RX_FILTER_BATCH != FALSE)
+        // the filter array may hold new Tx buffers, so nothing is reused
+        target_enableGlobalInterrupt(FALSE);
+        OPLK_MEMSET(edrvInstance_l.aPendingChangeFlags, 0, sizeof(edrvInstance_l.aPendingChangeFlags));
+        edrvInstance_l.fFilterChangePending = FALSE;
+#if EDRV_MAX_AUTO_RESPONSES != 0
+        OPLK_MEMSET(edrvInstance_l.apCachedResponse, 0, sizeof(edrvInstance_l.apCachedResponse));
+#endif
+        target_enableGlobalInterrupt(TRUE);
+#endif
+
         // at first, disable all filters in openMAC
         for (entry = 0; entry < EDRV_MAX_FILTERS; entry++)
         {
@@ -653,8 +699,7 @@ tOplkError edrv_changeRxFilter(tEdrvFilter* pFilter_p, UINT count_p,
                 // set buffer number of TxBuffer to filter entry
                 pFilter_p[entry].pTxBuffer[0].txBufferNumber.value = entry;
                 pFilter_p[entry].pTxBuffer[1].txBufferNumber.value = entry;
-                edrv_updateTxBuffer(pFilter_p[entry].pTxBuffer);
-                omethResponseEnable(edrvInstance_l.apRxFilterInst[entry]);
+                enableAutoResponse(entry, pFilter_p[entry].pTxBuffer);
 
 #if CONFIG_EDRV_AUTO_RESPONSE_DELAY != FALSE
                 {
@@ -692,96 +737,67 @@ tOplkError edrv_changeRxFilter(tEdrvFilter* pFilter_p, UINT count_p,
     }
     else
     {   // specific entry should be changed
-
-        if (((changeFlags_p & (EDRV_FILTER_CHANGE_VALUE
-                                 | EDRV_FILTER_CHANGE_MASK
-#if CONFIG_EDRV_AUTO_RESPONSE_DELAY != FALSE
-                                 | EDRV_FILTER_CHANGE_AUTO_RESPONSE_DELAY
+#if (CONFIG_EDRV_RX_FILTER_BATCH != FALSE)
+        target_enableGlobalInterrupt(FALSE);
+        edrvInstance_l.pPendingFilter = pFilter_p;
+        // the filter state is always evaluated, so a recorded entry is never lost
+        edrvInstance_l.aPendingChangeFlags[entryChanged_p] |= changeFlags_p | EDRV_FILTER_CHANGE_STATE;
+        edrvInstance_l.fFilterChangePending = TRUE;
+        target_enableGlobalInterrupt(TRUE);
+#else
+        ret = changeRxFilterEntry(pFilter_p, entryChanged_p, changeFlags_p);
 #endif
-                                 | EDRV_FILTER_CHANGE_AUTO_RESPONSE)) != 0)
-            || (pFilter_p[entryChanged_p].fEnable == FALSE))
-        {
-            // disable this filter entry
-            omethFilterDisable(edrvInstance_l.apRxFilterInst[entryChanged_p]);
+    }
 
-            if ((changeFlags_p & EDRV_FILTER_CHANGE_VALUE) != 0)
-            {   // filter value has changed
-                for (index = 0; index < sizeof(pFilter_p->aFilterValue); index++)
-                {
-                    omethFilterSetByteValue(edrvInstance_l.apRxFilterInst[entryChanged_p],
-                                            index,
-                                            pFilter_p[entryChanged_p].aFilterValue[index]);
-                }
-            }
+Exit:
+    return ret;
+}
 
-            if ((changeFlags_p & EDRV_FILTER_CHANGE_MASK) != 0)
-            {   // filter mask has changed
-                for (index = 0; index < sizeof(pFilter_p->aFilterMask); index++)
-                {
-                    omethFilterSetByteMask(edrvInstance_l.apRxFilterInst[entryChanged_p],
-                                           index,
-                                           pFilter_p[entryChanged_p].aFilterMask[index]);
-                }
-            }
+#if (CONFIG_EDRV_RX_FILTER_BATCH != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Commit Rx filter changes
 
-            if ((changeFlags_p & EDRV_FILTER_CHANGE_AUTO_RESPONSE) != 0)
-            {   // filter auto-response state or frame has changed
-                if (pFilter_p[entryChanged_p].pTxBuffer != NULL)
-                {   // auto-response enable
-                    // set buffer number of TxBuffer to filter entry
-                    pFilter_p[entryChanged_p].pTxBuffer[0].txBufferNumber.value = entryChanged_p;
-                    pFilter_p[entryChanged_p].pTxBuffer[1].txBufferNumber.value = entryChanged_p;
-                    edrv_updateTxBuffer(pFilter_p[entryChanged_p].pTxBuffer);
-                    omethResponseEnable(edrvInstance_l.apRxFilterInst[entryChanged_p]);
-                }
-                else
-                {   // auto-response disable
-                    omethResponseDisable(edrvInstance_l.apRxFilterInst[entryChanged_p]);
-                }
-            }
+This function applies all Rx filter changes which were recorded by
+edrv_changeRxFilter() since the last commit. It is called at the cycle
+boundary, so the filter entries are rewritten at most once per cycle.
 
-#if CONFIG_EDRV_AUTO_RESPONSE_DELAY != FALSE
-            if ((changeFlags_p & EDRV_FILTER_CHANGE_AUTO_RESPONSE_DELAY) != 0)
-            {   // filter auto-response delay has changed
-                UINT32 delayNs;
+\return The function returns a tOplkError error code.
 
-                if (pFilter_p[entryChanged_p].pTxBuffer == NULL)
-                {
-                    ret = kErrorEdrvInvalidParam;
-                    goto Exit;
-                }
-                delayNs = pFilter_p[entryChanged_p].pTxBuffer->timeOffsetNs;
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_commitRxFilter(void)
+{
+    tOplkError  ret = kErrorOk;
+    tOplkError  entryRet;
+    UINT        entry;
+    UINT        changeFlags;
 
-                if (delayNs == 0)
-                {   // no auto-response delay is set
-                    // send frame immediately after IFG
-                    omethResponseTime(edrvInstance_l.apRxFilterInst[entryChanged_p], 0);
-                }
-                else
-                {   // auto-response delay is set
-                    UINT32 delayAfterIfgNs;
+    if (!edrvInstance_l.fFilterChangePending)
+        return kErrorOk;
 
-                    if (delayNs < C_DLL_T_IFG)
-                    {   // set delay to a minimum of IFG
-                        delayNs = C_DLL_T_IFG;
-                    }
-                    delayAfterIfgNs = delayNs - C_DLL_T_IFG;
-                    omethResponseTime(edrvInstance_l.apRxFilterInst[entryChanged_p],
-                                      OMETH_NS_2_TICKS(delayAfterIfgNs));
-                }
-            }
-#endif
-        }
+    target_enableGlobalInterrupt(FALSE);
+    edrvInstance_l.fFilterChangePending = FALSE;
 
-        if (pFilter_p[entryChanged_p].fEnable != FALSE)
-        {   // enable the filter
-            omethFilterEnable(edrvInstance_l.apRxFilterInst[entryChanged_p]);
+    for (entry = 0; entry < EDRV_MAX_FILTERS; entry++)
+    {
+        changeFlags = edrvInstance_l.aPendingChangeFlags[entry];
+        if (changeFlags == 0)
+            continue;
+
+        edrvInstance_l.aPendingChangeFlags[entry] = 0;
+        entryRet = changeRxFilterEntry(edrvInstance_l.pPendingFilter, entry, changeFlags);
+        if (ret == kErrorOk)
+        {   // report the first error, but apply the remaining changes
+            ret = entryRet;
         }
     }
+    target_enableGlobalInterrupt(TRUE);
 
-Exit:
     return ret;
 }
+#endif
 
 //------------------------------------------------------------------------------
 /**
@@ -942,6 +958,143 @@ static ometh_config_typ getMacConfig(UINT adapter_p)
     return config;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Change Rx filter entry
+
+This function writes the changes of a specific Rx filter entry to openMAC.
+
+\param  pFilter_p           Base pointer of Rx filter array
+\param  entry_p             Index of Rx filter entry that shall be changed
+\param  changeFlags_p       Bit mask that selects the changing Rx filter property
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError changeRxFilterEntry(tEdrvFilter* pFilter_p, UINT entry_p, UINT changeFlags_p)
+{
+    tOplkError  ret = kErrorOk;
+    UINT        index;
+
+    if (((changeFlags_p & (EDRV_FILTER_CHANGE_VALUE
+                             | EDRV_FILTER_CHANGE_MASK
+#if CONFIG_EDRV_AUTO_RESPONSE_DELAY != FALSE
+                             | EDRV_FILTER_CHANGE_AUTO_RESPONSE_DELAY
+#endif
+                             | EDRV_FILTER_CHANGE_AUTO_RESPONSE)) != 0)
+        || (pFilter_p[entry_p].fEnable == FALSE))
+    {
+        // disable this filter entry
+        omethFilterDisable(edrvInstance_l.apRxFilterInst[entry_p]);
+
+        if ((changeFlags_p & EDRV_FILTER_CHANGE_VALUE) != 0)
+        {   // filter value has changed
+            for (index = 0; index < sizeof(pFilter_p->aFilterValue); index++)
+            {
+                omethFilterSetByteValue(edrvInstance_l.apRxFilterInst[entry_p],
+                                        index,
+                                        pFilter_p[entry_p].aFilterValue[index]);
+            }
+        }
+
+        if ((changeFlags_p & EDRV_FILTER_CHANGE_MASK) != 0)
+        {   // filter mask has changed
+            for (index = 0; index < sizeof(pFilter_p->aFilterMask); index++)
+            {
+                omethFilterSetByteMask(edrvInstance_l.apRxFilterInst[entry_p],
+                                       index,
+                                       pFilter_p[entry_p].aFilterMask[index]);
+            }
+        }
+
+        if ((changeFlags_p & EDRV_FILTER_CHANGE_AUTO_RESPONSE) != 0)
+        {   // filter auto-response state or frame has changed
+            if (pFilter_p[entry_p].pTxBuffer != NULL)
+            {   // auto-response enable
+                // set buffer number of TxBuffer to filter entry
+                pFilter_p[entry_p].pTxBuffer[0].txBufferNumber.value = entry_p;
+                pFilter_p[entry_p].pTxBuffer[1].txBufferNumber.value = entry_p;
+                enableAutoResponse(entry_p, pFilter_p[entry_p].pTxBuffer);
+            }
+            else
+            {   // auto-response disable
+                omethResponseDisable(edrvInstance_l.apRxFilterInst[entry_p]);
+            }
+        }
+
+#if CONFIG_EDRV_AUTO_RESPONSE_DELAY != FALSE
+        if ((changeFlags_p & EDRV_FILTER_CHANGE_AUTO_RESPONSE_DELAY) != 0)
+        {   // filter auto-response delay has changed
+            UINT32 delayNs;
+
+            if (pFilter_p[entry_p].pTxBuffer == NULL)
+            {
+                ret = kErrorEdrvInvalidParam;
+                goto Exit;
+            }
+            delayNs = pFilter_p[entry_p].pTxBuffer->timeOffsetNs;
+
+            if (delayNs == 0)
+            {   // no auto-response delay is set
+                // send frame immediately after IFG
+                omethResponseTime(edrvInstance_l.apRxFilterInst[entry_p], 0);
+            }
+            else
+            {   // auto-response delay is set
+                UINT32 delayAfterIfgNs;
+
+                if (delayNs < C_DLL_T_IFG)
+                {   // set delay to a minimum of IFG
+                    delayNs = C_DLL_T_IFG;
+                }
+                delayAfterIfgNs = delayNs - C_DLL_T_IFG;
+                omethResponseTime(edrvInstance_l.apRxFilterInst[entry_p],
+                                  OMETH_NS_2_TICKS(delayAfterIfgNs));
+            }
+        }
+#endif
+    }
+
+    if (pFilter_p[entry_p].fEnable != FALSE)
+    {   // enable the filter
+        omethFilterEnable(edrvInstance_l.apRxFilterInst[entry_p]);
+    }
+
+Exit:
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Enable auto-response of Rx filter
+
+This function hands the auto-response frame over to openMAC and enables the
+auto-response of the Rx filter. If CONFIG_EDRV_RX_FILTER_BATCH is enabled, a
+frame which is still armed in the response descriptor is not rebuilt. Changes
+of the frame content have to be announced with edrv_updateTxBuffer().
+
+\param  entry_p             Index of Rx filter entry
+\param  pTxBuffer_p         Auto-response Tx buffer
+*/
+//------------------------------------------------------------------------------
+static void enableAutoResponse(UINT entry_p, tEdrvTxBuffer* pTxBuffer_p)
+{
+#if ((CONFIG_EDRV_RX_FILTER_BATCH != FALSE) && (EDRV_MAX_AUTO_RESPONSES != 0))
+    if ((edrvInstance_l.apCachedResponse[entry_p] == pTxBuffer_p) &&
+        (edrvInstance_l.aCachedResponseCount[entry_p] ==
+            omethResponseCount(edrvInstance_l.apRxFilterInst[entry_p])))
+    {   // frame was not sent since it has been armed
+        edrvInstance_l.apTxBuffer[entry_p] = pTxBuffer_p;
+    }
+    else
+#endif
+    {
+        edrv_updateTxBuffer(pTxBuffer_p);
+    }
+
+    omethResponseEnable(edrvInstance_l.apRxFilterInst[entry_p]);
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Initialize Rx filters
@@ -1180,6 +1333,11 @@ static void txAckCb(ometh_packet_typ* pPacket_p, void* pArg_p, ULONG time_p)
 
     edrvInstance_l.txPacketFreed++;
 
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+    if (pArg_p != NULL)
+        pTxBuffer->txTimeStampNs = EDRV_TICKS_2_NS(extendTimeStamp((UINT32)time_p));
+#endif
+
     if(pArg_p != NULL && pTxBuffer->pfnTxHandler != NULL)
         pTxBuffer->pfnTxHandler(pTxBuffer);
 }
@@ -1215,6 +1373,9 @@ static INT rxHook(void* pArg_p, ometh_packet_typ* pPacket_p, OMETH_BUF_FREE_FCT*
     rxBuffer.rxFrameSize = pPacket_p->length;
     timeStamp.timeStamp = omethGetTimestamp(pPacket_p);
     rxBuffer.pRxTimeStamp = &timeStamp;
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+    rxBuffer.rxTimeStampNs = EDRV_TICKS_2_NS(extendTimeStamp((UINT32)timeStamp.timeStamp));
+#endif
 
     // Before handing over the Rx packet to the stack invalidate the packet's
     // memory range.
@@ -1232,6 +1393,10 @@ static INT rxHook(void* pArg_p, ometh_packet_typ* pPacket_p, OMETH_BUF_FREE_FCT*
     {   // filter with auto-response frame triggered
         BENCHMARK_MOD_01_SET(5);
         // call Tx handler function from DLL
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+        // the transmission time of an auto-response frame is not reported
+        edrvInstance_l.apTxBuffer[txRespIndex]->txTimeStampNs = 0;
+#endif
         if (edrvInstance_l.apTxBuffer[txRespIndex]->pfnTxHandler != NULL)
         {
             edrvInstance_l.apTxBuffer[txRespIndex]->pfnTxHandler(edrvInstance_l.apTxBuffer[txRespIndex]);
@@ -1243,5 +1408,41 @@ static INT rxHook(void* pArg_p, ometh_packet_typ* pPacket_p, OMETH_BUF_FREE_FCT*
     return ret;
 }
 
+#if (EDRV_USE_HW_TIMESTAMP != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Extend time stamp to 64 bit
+
+The function extends a 32 bit openMAC time stamp to 64 bit. The time stamps of
+received and transmitted frames may be reported slightly out of order,
+therefore the time stamp is interpreted relative to the latest one. The
+function must be called at least once per half wrap-around period of the
+openMAC timer, which is ensured by the POWERLINK cycle.
+
+\param  timeStamp_p     openMAC time stamp in ticks.
+
+\return The function returns the extended time stamp in ticks.
+*/
+//------------------------------------------------------------------------------
+static UINT64 extendTimeStamp(UINT32 timeStamp_p)
+{
+    UINT64  timeStamp;
+    INT32   diff;
+
+    if (edrvInstance_l.lastTimeStampTicks == 0)
+    {
+        edrvInstance_l.lastTimeStampTicks = timeStamp_p;
+        return timeStamp_p;
+    }
+
+    diff = (INT32)(timeStamp_p - (UINT32)edrvInstance_l.lastTimeStampTicks);
+    timeStamp = edrvInstance_l.lastTimeStampTicks + (INT64)diff;
+    if (diff > 0)
+        edrvInstance_l.lastTimeStampTicks = timeStamp;
+
+    return timeStamp;
+}
+#endif
+
 ///\}
 
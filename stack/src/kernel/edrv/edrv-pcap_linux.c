@@ -41,6 +41,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <kernel/edrv.h>
+#include <kernel/edrvmirror.h>
+#include <kernel/edrvfilter.h>
+#include <common/target.h>
 
 #include <unistd.h>
 #include <pcap.h>
@@ -55,6 +58,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <netinet/in.h>
 #include <net/if.h>
 
+#if (CONFIG_EDRV_PCAP_QDISC_BYPASS != FALSE)
+#include <linux/if_packet.h>
+#endif
+
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
 //============================================================================//
@@ -62,6 +69,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#ifndef CONFIG_THREAD_PRIORITY_EDRV_RX
+#define CONFIG_THREAD_PRIORITY_EDRV_RX      CONFIG_THREAD_PRIORITY_MEDIUM
+#endif
 
 //------------------------------------------------------------------------------
 // module global vars
@@ -80,16 +90,42 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 #define EDRV_MAX_FRAME_SIZE     0x600
 
+// Number of frames which may wait for their loopback (power of two)
+#define EDRV_TX_QUEUE_SIZE      512
+
+// The pcap buffer of a frame is only valid within the packet handler. If the
+// DLL releases Rx frames later, they are copied into Rx pool buffers.
+#if (CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_SYNC != FALSE) || (CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_ASYNC != FALSE)
+#define EDRV_USE_RX_POOL        TRUE
+#else
+#define EDRV_USE_RX_POOL        FALSE
+#endif
+
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
+/**
+\brief Entry of the Tx queue
+
+The entry holds a sent Tx buffer until its frame is looped back to the receive
+handle. The sequence number of the entry tells the senders and the worker
+thread whether it is free or filled.
+*/
+typedef struct
+{
+    UINT                sequence;       ///< Sequence number of the entry
+    UINT                tag;            ///< Tag of the transmission
+    tEdrvTxBuffer*      pBuffer;        ///< Sent Tx buffer
+} tEdrvTxQueueEntry;
+
 // Private structure
 typedef struct
 {
     tEdrvInitParam      initParam;
-    tEdrvTxBuffer*      pTransmittedTxBufferLastEntry;
-    tEdrvTxBuffer*      pTransmittedTxBufferFirstEntry;
-    pthread_mutex_t     mutex;
+    tEdrvTxQueueEntry   aTxQueue[EDRV_TX_QUEUE_SIZE];   ///< Frames waiting for their loopback
+    UINT                txQueueWritePos;                ///< Next write position of the senders
+    UINT                txQueueReadPos;                 ///< Next read position of the worker thread
+    UINT                txTag;                          ///< Last assigned transmission tag
     sem_t               syncSem;
     pcap_t*             pPcap;
     pcap_t*             pPcapThread;
@@ -106,6 +142,13 @@ static tEdrvInstance edrvInstance_l;
 //------------------------------------------------------------------------------
 static void packetHandler(u_char* pParam_p, const struct pcap_pkthdr* pHeader_p, const u_char* pPktData_p);
 static void* workerThread(void* pArgument_p);
+#if (CONFIG_EDRV_PCAP_QDISC_BYPASS == FALSE)
+static tOplkError queueTxBuffer(tEdrvTxBuffer* pBuffer_p);
+#endif
+static void completeTxBuffer(tEdrvInstance* pInstance_p, const u_char* pPktData_p);
+static pcap_t* openPcap(const char* pDevName_p, INT bufferSize_p);
+static tOplkError setRxFilter(pcap_t* pPcap_p, const UINT8* pMacAddr_p);
+static tOplkError setTxHandle(pcap_t* pPcap_p);
 static void getMacAdrs(const char* pIfName_p, UINT8* pMacAddr_p);
 static INT getLinkStatus(const char* pIfName_p);
 
@@ -129,8 +172,7 @@ This function initializes the Ethernet driver.
 tOplkError edrv_init(tEdrvInitParam* pEdrvInitParam_p)
 {
     tOplkError          ret = kErrorOk;
-    char                aErrorMessage[PCAP_ERRBUF_SIZE];
-    struct sched_param  schedParam;
+    UINT                i;
 
     // clear instance structure
     OPLK_MEMSET(&edrvInstance_l, 0, sizeof(edrvInstance_l));
@@ -158,18 +200,10 @@ tOplkError edrv_init(tEdrvInitParam* pEdrvInitParam_p)
     // save the init data (with updated MAC address)
     edrvInstance_l.initParam = *pEdrvInitParam_p;
 
-    edrvInstance_l.pPcap = pcap_open_live(
-                        edrvInstance_l.initParam.hwParam.pDevName,
-                        65535,  // snaplen
-                        1,      // promiscuous mode
-                        1,      // milli seconds read timeout
-                        aErrorMessage
-                    );
-
+    // the send handle never delivers frames, so it gets no capture buffer
+    edrvInstance_l.pPcap = openPcap(edrvInstance_l.initParam.hwParam.pDevName, 0);
     if (edrvInstance_l.pPcap == NULL)
     {
-        DEBUG_LVL_ERROR_TRACE("%s() Error!! Can't open pcap: %s\n", __func__,
-                                aErrorMessage);
         ret = kErrorEdrvInit;
         goto Exit;
     }
@@ -181,12 +215,12 @@ tOplkError edrv_init(tEdrvInitParam* pEdrvInitParam_p)
         goto Exit;
     }
 
-    if (pthread_mutex_init(&edrvInstance_l.mutex, NULL) != 0)
-    {
-        DEBUG_LVL_ERROR_TRACE("%s() couldn't init mutex\n", __func__);
-        ret = kErrorEdrvInit;
+    ret = setTxHandle(edrvInstance_l.pPcap);
+    if (ret != kErrorOk)
         goto Exit;
-    }
+
+    for (i = 0; i < EDRV_TX_QUEUE_SIZE; i++)
+        edrvInstance_l.aTxQueue[i].sequence = i;
 
     if (sem_init(&edrvInstance_l.syncSem, 0, 0) != 0)
     {
@@ -195,25 +229,36 @@ tOplkError edrv_init(tEdrvInitParam* pEdrvInitParam_p)
         goto Exit;
     }
 
-    if (pthread_create(&edrvInstance_l.hThread, NULL,
-                       workerThread,  &edrvInstance_l) != 0)
+#if (CONFIG_EDRV_MIRROR != FALSE)
+    // the driver works without mirror ring, therefore errors are ignored
+    edrvmirror_init();
+#endif
+
+#if (EDRV_USE_RX_POOL != FALSE)
+    ret = edrvrxpool_init(NULL, CONFIG_EDRV_RX_POOL_BUFFERS, EDRV_MAX_FRAME_SIZE, NULL);
+    if (ret != kErrorOk)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't create Rx buffer pool\n", __func__);
+        goto Exit;
+    }
+#endif
+
+    if (target_createThread(&edrvInstance_l.hThread, kThreadRoleEdrvRx, "oplk-edrvpcap",
+                            workerThread, &edrvInstance_l) != kErrorOk)
     {
         DEBUG_LVL_ERROR_TRACE("%s() Couldn't create worker thread!\n", __func__);
         ret = kErrorEdrvInit;
         goto Exit;
     }
 
-    schedParam.__sched_priority = CONFIG_THREAD_PRIORITY_MEDIUM;
-    if (pthread_setschedparam(edrvInstance_l.hThread, SCHED_FIFO, &schedParam) != 0)
+    if (target_setThreadParams(edrvInstance_l.hThread, kThreadRoleEdrvRx, kThreadSchedFifo,
+                               CONFIG_THREAD_PRIORITY_EDRV_RX,
+                               CONFIG_THREAD_CPU_MASK_EDRV_RX) != kErrorOk)
     {
         DEBUG_LVL_ERROR_TRACE("%s() couldn't set thread scheduling parameters!\n",
                                 __func__);
     }
 
-#if (defined(__GLIBC__) && __GLIBC__ >= 2 && __GLIBC_MINOR__ >= 12)
-    pthread_setname_np(edrvInstance_l.hThread, "oplk-edrvpcap");
-#endif
-
     /* wait until thread is started */
     sem_wait(&edrvInstance_l.syncSem);
 
@@ -243,7 +288,14 @@ tOplkError edrv_shutdown(void)
 
     pcap_close(edrvInstance_l.pPcap);
 
-    pthread_mutex_destroy(&edrvInstance_l.mutex);
+
+#if (CONFIG_EDRV_MIRROR != FALSE)
+    edrvmirror_exit();
+#endif
+
+#if (EDRV_USE_RX_POOL != FALSE)
+    edrvrxpool_exit();
+#endif
 
     // clear instance structure
     OPLK_MEMSET(&edrvInstance_l, 0, sizeof(edrvInstance_l));
@@ -271,7 +323,7 @@ tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
 
     FTRACE_MARKER("%s", __func__);
 
-    if (pBuffer_p->txBufferNumber.pArg != NULL)
+    if (__atomic_load_n(&pBuffer_p->txBufferNumber.value, __ATOMIC_ACQUIRE) != 0)
     {
         ret = kErrorInvalidOperation;
         goto Exit;
@@ -288,18 +340,37 @@ tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
     }
     else
     {
-        pthread_mutex_lock(&edrvInstance_l.mutex);
-        if (edrvInstance_l.pTransmittedTxBufferLastEntry == NULL)
+#if (CONFIG_EDRV_PCAP_QDISC_BYPASS != FALSE)
+        /* frames which bypass the queueing discipline are not looped back to
+         * the receive handle, therefore the Tx handler is called right after
+         * the frame was handed to the network device */
+        pcapRet = pcap_sendpacket(edrvInstance_l.pPcap, pBuffer_p->pBuffer,
+                                  (INT)pBuffer_p->txFrameSize);
+        if  (pcapRet != 0)
         {
-            edrvInstance_l.pTransmittedTxBufferLastEntry =
-                edrvInstance_l.pTransmittedTxBufferFirstEntry = pBuffer_p;
+            DEBUG_LVL_EDRV_TRACE("%s() pcap_sendpacket returned %d (%s)\n",
+                    __func__, pcapRet, pcap_geterr(edrvInstance_l.pPcap));
+            ret = kErrorInvalidOperation;
+            goto Exit;
         }
-        else
+
+#if (CONFIG_EDRV_MIRROR != FALSE)
         {
-            edrvInstance_l.pTransmittedTxBufferLastEntry->txBufferNumber.pArg = pBuffer_p;
-            edrvInstance_l.pTransmittedTxBufferLastEntry = pBuffer_p;
+            struct timespec     realTime;
+
+            clock_gettime(CLOCK_REALTIME, &realTime);
+            EDRVMIRROR_RECORD_FRAME(pBuffer_p->pBuffer, pBuffer_p->txFrameSize,
+                                    ((UINT64)realTime.tv_sec * 1000000000ULL) + (UINT64)realTime.tv_nsec,
+                                    EDRVMIRROR_FLAG_TX);
         }
-        pthread_mutex_unlock(&edrvInstance_l.mutex);
+#endif
+
+        if (pBuffer_p->pfnTxHandler != NULL)
+            pBuffer_p->pfnTxHandler(pBuffer_p);
+#else
+        ret = queueTxBuffer(pBuffer_p);
+        if (ret != kErrorOk)
+            goto Exit;
 
         pcapRet = pcap_sendpacket(edrvInstance_l.pPcap, pBuffer_p->pBuffer,
                                   (INT)pBuffer_p->txFrameSize);
@@ -308,7 +379,11 @@ tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
             DEBUG_LVL_EDRV_TRACE("%s() pcap_sendpacket returned %d (%s)\n",
                     __func__, pcapRet, pcap_geterr(edrvInstance_l.pPcap));
             ret = kErrorInvalidOperation;
+
+            // cancel the transmission, the worker thread drops its queue entry
+            __atomic_store_n(&pBuffer_p->txBufferNumber.value, 0, __ATOMIC_RELEASE);
         }
+#endif
     }
 
 Exit:
@@ -377,6 +452,58 @@ tOplkError edrv_freeTxBuffer(tEdrvTxBuffer* pBuffer_p)
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Release Rx buffer
+
+This function releases a reference to an Rx buffer which was handed to the Rx
+handler with kEdrvReleaseRxBufferLater or held by edrv_holdRxBuffer(). The pool
+buffer is reused when its last reference is released.
+
+\param  pRxBuffer_p         Rx buffer to be released
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_releaseRxBuffer(tEdrvRxBuffer* pRxBuffer_p)
+{
+#if (EDRV_USE_RX_POOL != FALSE)
+    return edrvrxpool_release(pRxBuffer_p->pBuffer);
+#else
+    UNUSED_PARAMETER(pRxBuffer_p);
+
+    return kErrorEdrvInvalidRxBuf;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Hold Rx buffer
+
+This function adds a reference to an Rx buffer which is already held, so that
+an additional consumer can keep the frame without copying it. Every reference
+is released by edrv_releaseRxBuffer().
+
+\param  pRxBuffer_p         Rx buffer to be held
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_holdRxBuffer(tEdrvRxBuffer* pRxBuffer_p)
+{
+#if (EDRV_USE_RX_POOL != FALSE)
+    return edrvrxpool_addRef(pRxBuffer_p->pBuffer);
+#else
+    UNUSED_PARAMETER(pRxBuffer_p);
+
+    return kErrorEdrvInvalidRxBuf;
+#endif
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Change Rx filter setup
@@ -386,7 +513,8 @@ selects the Rx filter entry that shall be changed and \p changeFlags_p determine
 the property.
 If \p entryChanged_p is equal or larger count_p all Rx filters shall be changed.
 
-\note Rx filters are not supported by this driver!
+\note The controller does not support Rx filters. If CONFIG_EDRV_SOFT_FILTER
+      is TRUE, the filters are evaluated in software (see edrvfilter.c).
 
 \param  pFilter_p           Base pointer of Rx filter array
 \param  count_p             Number of Rx filter array entries
@@ -406,6 +534,9 @@ tOplkError edrv_changeRxFilter(tEdrvFilter* pFilter_p, UINT count_p,
     UNUSED_PARAMETER(entryChanged_p);
     UNUSED_PARAMETER(changeFlags_p);
 
+    // the software filter is always compiled from the complete array
+    EDRVFILTER_CHANGE_RX_FILTER(pFilter_p, count_p);
+
     return kErrorOk;
 }
 
@@ -469,71 +600,201 @@ This function is the packet handler forwarding the frames to the dllk.
 static void packetHandler(u_char* pParam_p, const struct pcap_pkthdr* pHeader_p, const u_char* pPktData_p)
 {
     tEdrvInstance*  pInstance = (tEdrvInstance*)pParam_p;
-    tEdrvRxBuffer   rxBuffer;
+    tEdrvRxBuffer           rxBuffer;
+    tTimestamp              rxTimeStamp;
+    tEdrvReleaseRxBuffer    release;
+    BOOL                    fTx;
+
+    fTx = (OPLK_MEMCMP(pPktData_p + 6, pInstance->initParam.aMacAddr, 6) == 0);
 
-    if (OPLK_MEMCMP (pPktData_p + 6, pInstance->initParam.aMacAddr, 6 ) != 0)
+    EDRVMIRROR_RECORD_FRAME(pPktData_p, pHeader_p->caplen,
+                            ((UINT64)pHeader_p->ts.tv_sec * 1000000000ULL) +
+                            ((UINT64)pHeader_p->ts.tv_usec * 1000ULL),
+                            fTx ? EDRVMIRROR_FLAG_TX : 0);
+
+    if (!fTx)
     {   // filter out self generated traffic
+        if (EDRVFILTER_DROP_FRAME(pPktData_p, pHeader_p->caplen))
+            return;
+
         rxBuffer.bufferInFrame = kEdrvBufferLastInFrame;
         rxBuffer.rxFrameSize = pHeader_p->caplen;
+#if (EDRV_USE_RX_POOL != FALSE)
+        if ((pHeader_p->caplen > EDRV_MAX_FRAME_SIZE) ||
+            (edrvrxpool_allocBuffer(&rxBuffer.pBuffer) != kErrorOk))
+        {   // all pool buffers are held, the frame is dropped
+            FTRACE_MARKER("%s RX dropped", __func__);
+            return;
+        }
+
+        OPLK_MEMCPY(rxBuffer.pBuffer, pPktData_p, pHeader_p->caplen);
+#else
         rxBuffer.pBuffer = (UINT8*)pPktData_p;
+#endif
+
+        // kernel receive time stamp of the frame
+        rxTimeStamp.timeStamp = (TIME_STAMP_T)target_convertRealtimeToTimestamp(
+                                    ((UINT64)pHeader_p->ts.tv_sec * 1000000000ULL) +
+                                    ((UINT64)pHeader_p->ts.tv_usec * 1000ULL));
+        rxBuffer.pRxTimeStamp = &rxTimeStamp;
 
         FTRACE_MARKER("%s RX", __func__);
-        pInstance->initParam.pfnRxHandler(&rxBuffer);
+        release = pInstance->initParam.pfnRxHandler(&rxBuffer);
+
+#if (EDRV_USE_RX_POOL != FALSE)
+        // drop the reference of the driver, the buffer stays held by its consumers
+        if (release == kEdrvReleaseRxBufferImmediately)
+            edrvrxpool_release(rxBuffer.pBuffer);
+#else
+        UNUSED_PARAMETER(release);
+#endif
     }
     else
     {   // self generated traffic
         FTRACE_MARKER("%s TX-receive", __func__);
 
-        if (pInstance->pTransmittedTxBufferFirstEntry != NULL)
-        {
-            tEdrvTxBuffer* pTxBuffer = pInstance->pTransmittedTxBufferFirstEntry;
-
-            if (pTxBuffer->pBuffer != NULL)
-            {
-                if (OPLK_MEMCMP(pPktData_p, pTxBuffer->pBuffer, 6) == 0)
-                {
-                    pthread_mutex_lock(&pInstance->mutex);
-                    pInstance->pTransmittedTxBufferFirstEntry =
-                        pInstance->pTransmittedTxBufferFirstEntry->txBufferNumber.pArg;
-                    if (pInstance->pTransmittedTxBufferFirstEntry == NULL)
-                    {
-                        pInstance->pTransmittedTxBufferLastEntry = NULL;
-                    }
-                    pthread_mutex_unlock(&pInstance->mutex);
-
-                    pTxBuffer->txBufferNumber.pArg = NULL;
-
-                    if (pTxBuffer->pfnTxHandler != NULL)
-                    {
-                        pTxBuffer->pfnTxHandler(pTxBuffer);
-                    }
-                }
-                else
-                {
-                    TRACE("%s: no matching TxB: DstMAC=%02X%02X%02X%02X%02X%02X\n",
-                        __func__,
-                        (UINT)pPktData_p[0],
-                        (UINT)pPktData_p[1],
-                        (UINT)pPktData_p[2],
-                        (UINT)pPktData_p[3],
-                        (UINT)pPktData_p[4],
-                        (UINT)pPktData_p[5]);
-                    TRACE("   current TxB %p: DstMAC=%02X%02X%02X%02X%02X%02X\n",
-                        (void*)pTxBuffer,
-                        (UINT)pTxBuffer->pBuffer[0],
-                        (UINT)pTxBuffer->pBuffer[1],
-                        (UINT)pTxBuffer->pBuffer[2],
-                        (UINT)pTxBuffer->pBuffer[3],
-                        (UINT)pTxBuffer->pBuffer[4],
-                        (UINT)pTxBuffer->pBuffer[5]);
-                }
-            }
+        completeTxBuffer(pInstance, pPktData_p);
+    }
+}
+
+#if (CONFIG_EDRV_PCAP_QDISC_BYPASS == FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Queue a Tx buffer for its loopback
+
+The function tags the transmission of the Tx buffer and appends it to the Tx
+queue, where it waits until the worker thread receives the looped back frame.
+The queue is a bounded lock-free queue: the senders reserve an entry by
+advancing the write position atomically and publish it with the sequence number
+of the entry, the worker thread is the only reader. The tag of the transmission
+is kept in the Tx buffer, so a transmission which is cancelled later is
+recognized by the worker thread without taking its entry out of the queue.
+
+\param  pBuffer_p           Tx buffer descriptor
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError queueTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    tEdrvTxQueueEntry*  pEntry;
+    UINT                tag;
+    UINT                expected = 0;
+    UINT                pos;
+    INT                 diff;
+
+    do
+    {   // tag 0 marks an idle Tx buffer
+        tag = __atomic_add_fetch(&edrvInstance_l.txTag, 1, __ATOMIC_RELAXED);
+    } while (tag == 0);
+
+    if (!__atomic_compare_exchange_n(&pBuffer_p->txBufferNumber.value, &expected, tag,
+                                     FALSE, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+    {   // the Tx buffer is already waiting for its loopback
+        return kErrorInvalidOperation;
+    }
+
+    pos = __atomic_load_n(&edrvInstance_l.txQueueWritePos, __ATOMIC_RELAXED);
+    for (;;)
+    {
+        pEntry = &edrvInstance_l.aTxQueue[pos & (EDRV_TX_QUEUE_SIZE - 1)];
+        diff = (INT)(__atomic_load_n(&pEntry->sequence, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0)
+        {   // the entry is free, try to reserve it
+            if (__atomic_compare_exchange_n(&edrvInstance_l.txQueueWritePos, &pos, pos + 1,
+                                            TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+        else if (diff < 0)
+        {   // the queue is full
+            __atomic_store_n(&pBuffer_p->txBufferNumber.value, 0, __ATOMIC_RELEASE);
+            return kErrorEdrvNoFreeBufEntry;
         }
         else
+        {   // another sender reserved the entry
+            pos = __atomic_load_n(&edrvInstance_l.txQueueWritePos, __ATOMIC_RELAXED);
+        }
+    }
+
+    pEntry->tag = tag;
+    pEntry->pBuffer = pBuffer_p;
+    __atomic_store_n(&pEntry->sequence, pos + 1, __ATOMIC_RELEASE);
+
+    return kErrorOk;
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief  Complete the transmission of a looped back frame
+
+The function matches a frame sent by the local node with the oldest entry of
+the Tx queue and calls the Tx handler of its Tx buffer. Entries of cancelled
+transmissions are dropped on the way. The function is only called by the worker
+thread.
+
+\param  pInstance_p         Pointer to the instance structure
+\param  pPktData_p          Looped back frame
+*/
+//------------------------------------------------------------------------------
+static void completeTxBuffer(tEdrvInstance* pInstance_p, const u_char* pPktData_p)
+{
+    tEdrvTxQueueEntry*  pEntry;
+    tEdrvTxBuffer*      pTxBuffer;
+    UINT                pos;
+    BOOL                fValid;
+
+    for (;;)
+    {
+        pos = pInstance_p->txQueueReadPos;
+        pEntry = &pInstance_p->aTxQueue[pos & (EDRV_TX_QUEUE_SIZE - 1)];
+        if (__atomic_load_n(&pEntry->sequence, __ATOMIC_ACQUIRE) != (pos + 1))
         {
             //TRACE("%s: no TxB: DstMAC=%02X%02X%02X%02X%02X%02X\n", __func__, pPktData_p[0], pPktData_p[1],
             //      pPktData_p[2], pPktData_p[3], pPktData_p[4], pPktData_p[5]);
+            return;
+        }
+
+        pTxBuffer = pEntry->pBuffer;
+        fValid = (__atomic_load_n(&pTxBuffer->txBufferNumber.value, __ATOMIC_ACQUIRE) == pEntry->tag) &&
+                 (pTxBuffer->pBuffer != NULL);
+
+        if (fValid && (OPLK_MEMCMP(pPktData_p, pTxBuffer->pBuffer, 6) != 0))
+        {
+            TRACE("%s: no matching TxB: DstMAC=%02X%02X%02X%02X%02X%02X\n",
+                __func__,
+                (UINT)pPktData_p[0],
+                (UINT)pPktData_p[1],
+                (UINT)pPktData_p[2],
+                (UINT)pPktData_p[3],
+                (UINT)pPktData_p[4],
+                (UINT)pPktData_p[5]);
+            TRACE("   current TxB %p: DstMAC=%02X%02X%02X%02X%02X%02X\n",
+                (void*)pTxBuffer,
+                (UINT)pTxBuffer->pBuffer[0],
+                (UINT)pTxBuffer->pBuffer[1],
+                (UINT)pTxBuffer->pBuffer[2],
+                (UINT)pTxBuffer->pBuffer[3],
+                (UINT)pTxBuffer->pBuffer[4],
+                (UINT)pTxBuffer->pBuffer[5]);
+            return;
         }
+
+        // hand the entry back to the senders
+        pInstance_p->txQueueReadPos = pos + 1;
+        __atomic_store_n(&pEntry->sequence, pos + EDRV_TX_QUEUE_SIZE, __ATOMIC_RELEASE);
+
+        if (fValid)
+            break;
+
+        // the transmission was cancelled, the frame belongs to a later entry
+    }
+
+    __atomic_store_n(&pTxBuffer->txBufferNumber.value, 0, __ATOMIC_RELEASE);
+
+    if (pTxBuffer->pfnTxHandler != NULL)
+    {
+        pTxBuffer->pfnTxHandler(pTxBuffer);
     }
 }
 
@@ -555,29 +816,22 @@ static void* workerThread(void* pArgument_p)
 {
     INT             pcapRet;
     tEdrvInstance*  pInstance = (tEdrvInstance*)pArgument_p;
-    char            aErrorMessage[PCAP_ERRBUF_SIZE];
 
     DEBUG_LVL_EDRV_TRACE("%s(): ThreadId:%ld\n", __func__, syscall(SYS_gettid));
 
-    pInstance->pPcapThread =
-        pcap_open_live(pInstance->initParam.hwParam.pDevName,
-                       65535,  // snaplen
-                       1,      // promiscuous mode
-                       1,      // milli seconds read timeout
-                       aErrorMessage);
-
+    pInstance->pPcapThread = openPcap(pInstance->initParam.hwParam.pDevName,
+                                      CONFIG_EDRV_PCAP_BUFFER_SIZE);
    if (pInstance->pPcapThread == NULL)
-   {
-       DEBUG_LVL_ERROR_TRACE("%s() Error!! Can't open pcap: %s\n", __func__,
-                               aErrorMessage);
        return NULL;
-   }
 
    if (pcap_setdirection(pInstance->pPcapThread, PCAP_D_INOUT) < 0)
    {
        DEBUG_LVL_ERROR_TRACE("%s() couldn't set PCAP direction1\n", __func__);
    }
 
+   // a missing filter only costs performance, therefore errors are ignored
+   setRxFilter(pInstance->pPcapThread, pInstance->initParam.aMacAddr);
+
    /* signal that thread is successfully started */
    sem_post(&pInstance->syncSem);
 
@@ -605,6 +859,158 @@ static void* workerThread(void* pArgument_p)
    return NULL;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Open a pcap handle
+
+The function opens a pcap handle on the Ethernet interface. The handle works in
+immediate mode, so every frame is delivered to the worker thread as soon as it
+arrives instead of when the kernel buffer is full or the read timeout expires.
+The snapshot length is limited to the largest POWERLINK frame.
+
+\param  pDevName_p      Ethernet interface device name
+\param  bufferSize_p    Size of the kernel capture buffer in bytes
+                        (0 = default of libpcap).
+
+\return The function returns the pcap handle or NULL on error.
+*/
+//------------------------------------------------------------------------------
+static pcap_t* openPcap(const char* pDevName_p, INT bufferSize_p)
+{
+    pcap_t*     pPcap;
+    INT         pcapRet;
+    char        aErrorMessage[PCAP_ERRBUF_SIZE];
+
+    pPcap = pcap_create(pDevName_p, aErrorMessage);
+    if (pPcap == NULL)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Error!! Can't open pcap: %s\n", __func__,
+                              aErrorMessage);
+        return NULL;
+    }
+
+    pcap_set_snaplen(pPcap, EDRV_MAX_FRAME_SIZE);
+    pcap_set_promisc(pPcap, 1);
+    pcap_set_timeout(pPcap, 1);
+    pcap_set_immediate_mode(pPcap, 1);
+    if (bufferSize_p != 0)
+        pcap_set_buffer_size(pPcap, bufferSize_p);
+
+    pcapRet = pcap_activate(pPcap);
+    if (pcapRet < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Error!! Can't activate pcap: %s\n", __func__,
+                              pcap_geterr(pPcap));
+        pcap_close(pPcap);
+        return NULL;
+    }
+
+    if (pcapRet > 0)
+    {
+        DEBUG_LVL_EDRV_TRACE("%s() pcap_activate warning: %s\n", __func__,
+                             pcap_geterr(pPcap));
+    }
+
+    return pPcap;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set socket filter of the receive handle
+
+The function installs a BPF filter in the kernel, so only frames which concern
+the local node are copied to user space. These are frames addressed to the
+local MAC address or to a multicast/broadcast address and the frames sent by
+the local node, which are needed to confirm the transmission. Without virtual
+Ethernet only POWERLINK frames are accepted.
+
+\param  pPcap_p         Receive pcap handle
+\param  pMacAddr_p      Local MAC address
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError setRxFilter(pcap_t* pPcap_p, const UINT8* pMacAddr_p)
+{
+    struct bpf_program  filter;
+    char                aFilter[160];
+    char                aMacAddr[18];
+
+    snprintf(aMacAddr, sizeof(aMacAddr), "%02x:%02x:%02x:%02x:%02x:%02x",
+             (UINT)pMacAddr_p[0], (UINT)pMacAddr_p[1], (UINT)pMacAddr_p[2],
+             (UINT)pMacAddr_p[3], (UINT)pMacAddr_p[4], (UINT)pMacAddr_p[5]);
+
+#if defined(CONFIG_INCLUDE_VETH)
+    snprintf(aFilter, sizeof(aFilter),
+             "ether dst %s or ether multicast or ether src %s",
+             aMacAddr, aMacAddr);
+#else
+    snprintf(aFilter, sizeof(aFilter),
+             "ether proto 0x%04x and (ether dst %s or ether multicast or ether src %s)",
+             C_DLL_ETHERTYPE_EPL, aMacAddr, aMacAddr);
+#endif
+
+    if (pcap_compile(pPcap_p, &filter, aFilter, 1, PCAP_NETMASK_UNKNOWN) < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't compile filter '%s': %s\n", __func__,
+                              aFilter, pcap_geterr(pPcap_p));
+        return kErrorEdrvInit;
+    }
+
+    if (pcap_setfilter(pPcap_p, &filter) < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't set filter: %s\n", __func__,
+                              pcap_geterr(pPcap_p));
+        pcap_freecode(&filter);
+        return kErrorEdrvInit;
+    }
+
+    pcap_freecode(&filter);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set up the send handle
+
+The send handle only transmits frames. A socket filter which rejects all frames
+keeps the kernel from copying the received traffic into its capture buffer.
+If configured, the frames of the handle bypass the queueing discipline of the
+network device.
+
+\param  pPcap_p         Send pcap handle
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError setTxHandle(pcap_t* pPcap_p)
+{
+    static struct bpf_insn  aRejectAll[] = { BPF_STMT(BPF_RET | BPF_K, 0) };
+    struct bpf_program      filter;
+#if (CONFIG_EDRV_PCAP_QDISC_BYPASS != FALSE)
+    INT                     value = 1;
+#endif
+
+    filter.bf_len = sizeof(aRejectAll) / sizeof(aRejectAll[0]);
+    filter.bf_insns = aRejectAll;
+    if (pcap_setfilter(pPcap_p, &filter) < 0)
+    {   // the handle still works, it only buffers frames for nothing
+        DEBUG_LVL_EDRV_TRACE("%s() couldn't set filter: %s\n", __func__,
+                             pcap_geterr(pPcap_p));
+    }
+
+#if (CONFIG_EDRV_PCAP_QDISC_BYPASS != FALSE)
+    if (setsockopt(pcap_fileno(pPcap_p), SOL_PACKET, PACKET_QDISC_BYPASS,
+                   &value, sizeof(value)) < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't bypass queueing discipline\n", __func__);
+        return kErrorEdrvInit;
+    }
+#endif
+
+    return kErrorOk;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Get Edrv MAC address
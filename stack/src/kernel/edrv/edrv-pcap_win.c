@@ -64,6 +64,18 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EDRV_HANDLE_TIMER1      3
 #define EDRV_HANDLE_COUNT       4
 
+#if (EDRV_USE_HIGHRES_TIMER != FALSE)
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION   0x00000002
+#endif
+
+#define EDRV_MMCSS_TASK         "Pro Audio"     // MMCSS task of the worker thread
+#define EDRV_MMCSS_PRIO_CRITICAL    2           // AVRT_PRIORITY_CRITICAL
+#endif
+
+#define EDRV_TX_QUEUE_FRAMES    256     // frames which fit into the Tx send queue
+#define EDRV_TX_QUEUE_SIZE      (EDRV_TX_QUEUE_FRAMES * (sizeof(struct pcap_pkthdr) + EDRV_MAX_FRAME_SIZE))
+
 //------------------------------------------------------------------------------
 // module global vars
 //------------------------------------------------------------------------------
@@ -85,6 +97,13 @@ void hresTimerCb(UINT index_p);
 // local types
 //------------------------------------------------------------------------------
 
+#if (EDRV_USE_HIGHRES_TIMER != FALSE)
+// function types from AVRT.DLL
+typedef HANDLE (WINAPI* AVSETMMTHREADCHARACTERISTICS)(LPCSTR TaskName, LPDWORD TaskIndex);
+typedef BOOL (WINAPI* AVSETMMTHREADPRIORITY)(HANDLE AvrtHandle, int Priority);
+typedef BOOL (WINAPI* AVREVERTMMTHREADCHARACTERISTICS)(HANDLE AvrtHandle);
+#endif
+
 typedef struct
 {
     tEdrvInitParam      initParam;
@@ -94,6 +113,11 @@ typedef struct
     pcap_t*             pcap;
     HANDLE              aHandle[EDRV_HANDLE_COUNT];
     HANDLE              threadHandle;
+#if (EDRV_USE_TX_BATCH != FALSE)
+    pcap_send_queue*    pTxQueue;           ///< Send queue collecting the frames of a Tx batch
+    struct timeval      txBatchTimeStamp;   ///< Software time stamp of the current Tx batch
+    BOOL                fTxBatch;           ///< Tx batch is active
+#endif
 } tEdrvInstance;
 
 //------------------------------------------------------------------------------
@@ -106,6 +130,15 @@ static tEdrvInstance edrInstance_l;
 //------------------------------------------------------------------------------
 static void packetHandler(u_char* pParam_p, const struct pcap_pkthdr* pHeader_p, const u_char* pPktData_p);
 static UINT32 WINAPI edrvWorkerThread(void*);
+static void setRxFilter(pcap_t* pPcap_p, const UINT8* pMacAddr_p);
+static HANDLE createTimer(void);
+#if (EDRV_USE_HIGHRES_TIMER != FALSE)
+static void registerMmcssThread(HINSTANCE* phInstLibAvrt_p, HANDLE* phAvrt_p);
+static void unregisterMmcssThread(HINSTANCE hInstLibAvrt_p, HANDLE hAvrt_p);
+#endif
+#if (EDRV_USE_TX_BATCH != FALSE)
+static tOplkError transmitTxQueue(void);
+#endif
 
 //------------------------------------------------------------------------------
 /**
@@ -189,7 +222,7 @@ tOplkError edrv_init(tEdrvInitParam* pEdrvInitParam_p)
     // save the init data (with updated MAC address)
     edrInstance_l.initParam = *pEdrvInitParam_p;
     edrInstance_l.pcap = pcap_open_live(pEdrvInitParam_p->hwParam.pDevName,
-                                        65535, 1, 1, sErr_Msg);
+                                        EDRV_MAX_FRAME_SIZE, 1, 1, sErr_Msg);
     if (edrInstance_l.pcap == NULL)
     {
         DEBUG_LVL_ERROR_TRACE("Error!! Can't open pcap: %s\n", sErr_Msg);
@@ -202,24 +235,42 @@ tOplkError edrv_init(tEdrvInitParam* pEdrvInitParam_p)
         DEBUG_LVL_ERROR_TRACE("pcap_setmintocopy failed\n");
     }
 
+    // the kernel buffer of the driver decouples the reception from the worker thread
+    if (pcap_setbuff(edrInstance_l.pcap, CONFIG_EDRV_PCAP_BUFFER_SIZE) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("pcap_setbuff failed\n");
+    }
+
+    // only frames which concern the local node are copied to user space
+    setRxFilter(edrInstance_l.pcap, edrInstance_l.initParam.aMacAddr);
+
     // put pcap into nonblocking mode
     if (pcap_setnonblock(edrInstance_l.pcap, 1, sErr_Msg) != 0)
     {
         DEBUG_LVL_ERROR_TRACE("Can't put pcap into nonblocking mode: %s\n", sErr_Msg);
     }
 
+#if (EDRV_USE_TX_BATCH != FALSE)
+    edrInstance_l.pTxQueue = pcap_sendqueue_alloc((u_int)EDRV_TX_QUEUE_SIZE);
+    if (edrInstance_l.pTxQueue == NULL)
+    {
+        DEBUG_LVL_ERROR_TRACE("Can't allocate pcap send queue\n");
+        return kErrorNoResource;
+    }
+#endif
+
     // get event handle for pcap instance
     edrInstance_l.aHandle[EDRV_HANDLE_PCAP] = pcap_getevent(edrInstance_l.pcap);
 
     // Create two unnamed waitable timers for hrestimer sub-module.
-    edrInstance_l.aHandle[EDRV_HANDLE_TIMER0] = CreateWaitableTimer(NULL, FALSE, NULL);
+    edrInstance_l.aHandle[EDRV_HANDLE_TIMER0] = createTimer();
     if (edrInstance_l.aHandle[EDRV_HANDLE_TIMER0] == NULL)
     {
         DEBUG_LVL_ERROR_TRACE("CreateWaitableTimer failed (%d)\n", GetLastError());
         return kErrorEdrvInit;
     }
 
-    edrInstance_l.aHandle[EDRV_HANDLE_TIMER1] = CreateWaitableTimer(NULL, FALSE, NULL);
+    edrInstance_l.aHandle[EDRV_HANDLE_TIMER1] = createTimer();
     if (edrInstance_l.aHandle[EDRV_HANDLE_TIMER1] == NULL)
     {
         DEBUG_LVL_ERROR_TRACE("CreateWaitableTimer failed (%d)\n", GetLastError());
@@ -258,6 +309,11 @@ tOplkError edrv_shutdown(void)
 
     CloseHandle(edrInstance_l.threadHandle);
 
+#if (EDRV_USE_TX_BATCH != FALSE)
+    if (edrInstance_l.pTxQueue != NULL)
+        pcap_sendqueue_destroy(edrInstance_l.pTxQueue);
+#endif
+
     pcap_close(edrInstance_l.pcap);
 
     CloseHandle(edrInstance_l.aHandle[EDRV_HANDLE_EVENT]);
@@ -276,7 +332,8 @@ tOplkError edrv_shutdown(void)
 /**
 \brief  Send Tx buffer
 
-This function sends the Tx buffer.
+This function sends the Tx buffer. If a Tx batch is active, the frame is
+appended to the send queue and transmitted by edrv_endTxBatch().
 
 \param  pBuffer_p           Tx buffer descriptor
 
@@ -310,6 +367,38 @@ tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
     }
     LeaveCriticalSection(&edrInstance_l.criticalSection);
 
+#if (EDRV_USE_TX_BATCH != FALSE)
+    if (edrInstance_l.fTxBatch)
+    {
+        struct pcap_pkthdr  header;
+
+        // All frames of the batch carry the same time stamp, thus the
+        // synchronized transmission sends them back-to-back.
+        header.ts = edrInstance_l.txBatchTimeStamp;
+        header.caplen = (bpf_u_int32)pBuffer_p->txFrameSize;
+        header.len = (bpf_u_int32)pBuffer_p->txFrameSize;
+
+        // the send queue is shared with frames sent by other threads
+        EnterCriticalSection(&edrInstance_l.criticalSection);
+        iRet = pcap_sendqueue_queue(edrInstance_l.pTxQueue, &header, pBuffer_p->pBuffer);
+        if (iRet != 0)
+        {   // send queue is full, flush it and try again
+            ret = transmitTxQueue();
+            if (ret == kErrorOk)
+            {
+                iRet = pcap_sendqueue_queue(edrInstance_l.pTxQueue, &header, pBuffer_p->pBuffer);
+                if (iRet != 0)
+                {
+                    DEBUG_LVL_ERROR_TRACE("%s pcap_sendqueue_queue failed\n", __func__);
+                    ret = kErrorInvalidOperation;
+                }
+            }
+        }
+        LeaveCriticalSection(&edrInstance_l.criticalSection);
+        return ret;
+    }
+#endif
+
     iRet = pcap_sendpacket(edrInstance_l.pcap, pBuffer_p->pBuffer, (int)pBuffer_p->txFrameSize);
     if  (iRet != 0)
     {
@@ -319,6 +408,60 @@ tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
     return ret;
 }
 
+#if (EDRV_USE_TX_BATCH != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Begin Tx batch
+
+This function starts a transmit batch. All frames sent until edrv_endTxBatch()
+is called are collected in a pcap send queue and transmitted with a single
+call.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_beginTxBatch(void)
+{
+    FILETIME    fileTime;
+    ULONGLONG   time;
+
+    // software time stamp of the batch in microseconds
+    GetSystemTimeAsFileTime(&fileTime);
+    time = (((ULONGLONG)fileTime.dwHighDateTime << 32) | fileTime.dwLowDateTime) / 10;
+    edrInstance_l.txBatchTimeStamp.tv_sec = (long)(time / 1000000);
+    edrInstance_l.txBatchTimeStamp.tv_usec = (long)(time % 1000000);
+
+    edrInstance_l.fTxBatch = TRUE;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  End Tx batch
+
+This function ends a transmit batch and transmits the frames of the send queue
+with synchronized transmission.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_endTxBatch(void)
+{
+    tOplkError  ret;
+
+    EnterCriticalSection(&edrInstance_l.criticalSection);
+    edrInstance_l.fTxBatch = FALSE;
+    ret = transmitTxQueue();
+    LeaveCriticalSection(&edrInstance_l.criticalSection);
+
+    return ret;
+}
+#endif
+
 //------------------------------------------------------------------------------
 /**
 \brief  Allocate Tx buffer
@@ -549,6 +692,54 @@ static void packetHandler(u_char* pParam_p, const struct pcap_pkthdr* pHeader_p,
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Set packet filter
+
+The function installs a BPF filter in the packet capture driver, so only frames
+which concern the local node cross the user/kernel boundary. These are frames
+addressed to the local MAC address or to a multicast/broadcast address and the
+frames sent by the local node, which are needed to confirm the transmission.
+Without virtual Ethernet only POWERLINK frames are accepted. If the filter
+can't be installed, all frames are received as before.
+
+\param  pPcap_p         Pcap handle
+\param  pMacAddr_p      Local MAC address
+*/
+//------------------------------------------------------------------------------
+static void setRxFilter(pcap_t* pPcap_p, const UINT8* pMacAddr_p)
+{
+    struct bpf_program  filter;
+    char                aFilter[160];
+    char                aMacAddr[18];
+
+    sprintf(aMacAddr, "%02x:%02x:%02x:%02x:%02x:%02x",
+            (UINT)pMacAddr_p[0], (UINT)pMacAddr_p[1], (UINT)pMacAddr_p[2],
+            (UINT)pMacAddr_p[3], (UINT)pMacAddr_p[4], (UINT)pMacAddr_p[5]);
+
+#if defined(CONFIG_INCLUDE_VETH)
+    sprintf(aFilter, "ether dst %s or ether multicast or ether src %s",
+            aMacAddr, aMacAddr);
+#else
+    sprintf(aFilter, "ether proto 0x%04x and (ether dst %s or ether multicast or ether src %s)",
+            C_DLL_ETHERTYPE_EPL, aMacAddr, aMacAddr);
+#endif
+
+    // the netmask is only needed for IP broadcast filters
+    if (pcap_compile(pPcap_p, &filter, aFilter, 1, 0) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("Can't compile filter '%s': %s\n", aFilter, pcap_geterr(pPcap_p));
+        return;
+    }
+
+    if (pcap_setfilter(pPcap_p, &filter) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("Can't set filter: %s\n", pcap_geterr(pPcap_p));
+    }
+
+    pcap_freecode(&filter);
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Edrv worker thread
@@ -566,6 +757,12 @@ static UINT32 WINAPI edrvWorkerThread(void* pArgument_p)
     tEdrvInstance*  pInstance = pArgument_p;
     int             pcapRet;
     UINT32          waitRet;
+#if (EDRV_USE_HIGHRES_TIMER != FALSE)
+    HINSTANCE       hInstLibAvrt = NULL;
+    HANDLE          hAvrt = NULL;
+
+    registerMmcssThread(&hInstLibAvrt, &hAvrt);
+#endif
 
     // increase priority
     SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
@@ -578,6 +775,9 @@ static UINT32 WINAPI edrvWorkerThread(void* pArgument_p)
         {
             case WAIT_OBJECT_0 + EDRV_HANDLE_EVENT:
             {   // shutdown was signalled
+#if (EDRV_USE_HIGHRES_TIMER != FALSE)
+                unregisterMmcssThread(hInstLibAvrt, hAvrt);
+#endif
                 return 0;
             }
 
@@ -611,5 +811,143 @@ static UINT32 WINAPI edrvWorkerThread(void* pArgument_p)
     return 0;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Create a timer for the high-resolution timer module
+
+The function creates an unnamed auto-reset waitable timer. If
+EDRV_USE_HIGHRES_TIMER is TRUE, a high resolution waitable timer is created,
+which expires with the resolution of the performance counter instead of the
+system timer tick. It falls back to a standard waitable timer on Windows
+versions without high resolution timers (before Windows 10 1803).
+
+\return The function returns the timer handle or NULL on error.
+*/
+//------------------------------------------------------------------------------
+static HANDLE createTimer(void)
+{
+#if (EDRV_USE_HIGHRES_TIMER != FALSE)
+    HANDLE  hTimer;
+
+    hTimer = CreateWaitableTimerEx(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (hTimer != NULL)
+        return hTimer;
+
+    DEBUG_LVL_ERROR_TRACE("High resolution timer not supported (%d), using standard timer\n",
+                          GetLastError());
+#endif
+
+    return CreateWaitableTimer(NULL, FALSE, NULL);
+}
+
+#if (EDRV_USE_HIGHRES_TIMER != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Register the calling thread at the MMCSS
+
+The function registers the calling thread as EDRV_MMCSS_TASK task with
+critical priority at the Multimedia Class Scheduler Service. The service
+keeps the thread in the realtime priority range and prevents that it is
+throttled. The functions of AVRT.DLL are loaded at runtime, if they are not
+available the thread stays a normal time critical thread.
+
+\param  phInstLibAvrt_p     Pointer to store the handle of AVRT.DLL.
+\param  phAvrt_p            Pointer to store the MMCSS task handle.
+*/
+//------------------------------------------------------------------------------
+static void registerMmcssThread(HINSTANCE* phInstLibAvrt_p, HANDLE* phAvrt_p)
+{
+    AVSETMMTHREADCHARACTERISTICS    pfnAvSetMmThreadCharacteristics;
+    AVSETMMTHREADPRIORITY           pfnAvSetMmThreadPriority;
+    DWORD                           taskIndex = 0;
+
+    *phAvrt_p = NULL;
+
+    *phInstLibAvrt_p = LoadLibrary("avrt.dll");
+    if (*phInstLibAvrt_p == NULL)
+    {
+        DEBUG_LVL_ERROR_TRACE("LoadLibrary(avrt.dll) failed (%d)\n", GetLastError());
+        return;
+    }
+
+    pfnAvSetMmThreadCharacteristics = (AVSETMMTHREADCHARACTERISTICS)GetProcAddress(*phInstLibAvrt_p,
+                                                                                   "AvSetMmThreadCharacteristicsA");
+    pfnAvSetMmThreadPriority = (AVSETMMTHREADPRIORITY)GetProcAddress(*phInstLibAvrt_p,
+                                                                     "AvSetMmThreadPriority");
+    if ((pfnAvSetMmThreadCharacteristics == NULL) || (pfnAvSetMmThreadPriority == NULL))
+    {
+        DEBUG_LVL_ERROR_TRACE("GetProcAddress(AvSetMmThread...) failed (%d)\n", GetLastError());
+        return;
+    }
+
+    *phAvrt_p = pfnAvSetMmThreadCharacteristics(EDRV_MMCSS_TASK, &taskIndex);
+    if (*phAvrt_p == NULL)
+    {
+        DEBUG_LVL_ERROR_TRACE("AvSetMmThreadCharacteristics failed (%d)\n", GetLastError());
+        return;
+    }
+
+    pfnAvSetMmThreadPriority(*phAvrt_p, EDRV_MMCSS_PRIO_CRITICAL);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Unregister the calling thread from the MMCSS
+
+\param  hInstLibAvrt_p      Handle of AVRT.DLL.
+\param  hAvrt_p             MMCSS task handle.
+*/
+//------------------------------------------------------------------------------
+static void unregisterMmcssThread(HINSTANCE hInstLibAvrt_p, HANDLE hAvrt_p)
+{
+    AVREVERTMMTHREADCHARACTERISTICS pfnAvRevertMmThreadCharacteristics;
+
+    if (hInstLibAvrt_p == NULL)
+        return;
+
+    if (hAvrt_p != NULL)
+    {
+        pfnAvRevertMmThreadCharacteristics = (AVREVERTMMTHREADCHARACTERISTICS)GetProcAddress(hInstLibAvrt_p,
+                                                                                             "AvRevertMmThreadCharacteristics");
+        if (pfnAvRevertMmThreadCharacteristics != NULL)
+            pfnAvRevertMmThreadCharacteristics(hAvrt_p);
+    }
+
+    FreeLibrary(hInstLibAvrt_p);
+}
+#endif
+
+#if (EDRV_USE_TX_BATCH != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Transmit Tx send queue
+
+This function transmits all frames of the Tx send queue and empties it.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError transmitTxQueue(void)
+{
+    pcap_send_queue*    pQueue = edrInstance_l.pTxQueue;
+    u_int               sentLen;
+    tOplkError          ret = kErrorOk;
+
+    if (pQueue->len == 0)
+        return kErrorOk;
+
+    sentLen = pcap_sendqueue_transmit(edrInstance_l.pcap, pQueue, 1);
+    if (sentLen < pQueue->len)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s pcap_sendqueue_transmit sent %u of %u bytes (%s)\n",
+                              __func__, sentLen, pQueue->len, pcap_geterr(edrInstance_l.pcap));
+        ret = kErrorInvalidOperation;
+    }
+
+    pQueue->len = 0;
+    return ret;
+}
+#endif
+
 ///\}
 
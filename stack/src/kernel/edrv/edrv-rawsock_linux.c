@@ -0,0 +1,1111 @@
+/**
+********************************************************************************
+\file   edrv-rawsock_linux.c
+
+\brief  Implementation of Linux raw socket Ethernet driver
+
+This file contains the implementation of the Linux raw socket Ethernet driver.
+It uses memory mapped packet rings (PACKET_MMAP) for receiving and
+transmitting frames. Received frames are passed to the DLL directly in the
+receive ring, transmitted frames are copied into the transmit ring and sent
+with a single system call per batch.
+
+\ingroup module_edrv
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <kernel/edrv.h>
+#include <kernel/edrvmirror.h>
+#include <common/target.h>
+
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <netinet/in.h>
+#include <net/if.h>
+#include <net/ethernet.h>
+#include <linux/if_packet.h>
+#if (EDRV_USE_TX_TIME != FALSE)
+#include <time.h>
+#include <linux/net_tstamp.h>
+#endif
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#ifndef CONFIG_THREAD_PRIORITY_EDRV_RX
+#define CONFIG_THREAD_PRIORITY_EDRV_RX      CONFIG_THREAD_PRIORITY_MEDIUM
+#endif
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define EDRV_MAX_FRAME_SIZE     0x600
+
+#define EDRV_RING_FRAME_SIZE    2048                    // Size of a frame slot in the packet rings
+#define EDRV_RING_BLOCK_SIZE    4096                    // Size of a block in the packet rings
+#define EDRV_RX_RING_FRAMES     256                     // Number of frames in the receive ring
+#define EDRV_TX_RING_FRAMES     64                      // Number of frames in the transmit ring
+#define EDRV_POLL_TIMEOUT_MS    10                      // Poll timeout of the worker thread
+
+// Offset of the frame data in a transmit ring slot
+#define EDRV_TX_DATA_OFFSET     (TPACKET2_HDRLEN - sizeof(struct sockaddr_ll))
+
+#if (EDRV_USE_TX_TIME != FALSE)
+#ifndef SO_TXTIME
+#define SO_TXTIME               61
+#define SCM_TXTIME              SO_TXTIME
+#endif
+#endif
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief Packet ring
+
+The structure describes a memory mapped packet ring.
+*/
+typedef struct
+{
+    UINT8*              pRing;                          ///< Pointer to the mapped ring
+    size_t              ringSize;                       ///< Size of the mapped ring
+    UINT                frameCount;                     ///< Number of frames in the ring
+} tEdrvPacketRing;
+
+// Private structure
+typedef struct
+{
+    tEdrvInitParam      initParam;
+    INT                 rxSocket;                       ///< Socket with receive ring
+    INT                 txSocket;                       ///< Socket with transmit ring
+    tEdrvPacketRing     rxRing;                         ///< Receive ring
+    tEdrvPacketRing     txRing;                         ///< Transmit ring
+    UINT                rxIndex;                        ///< Next frame to be processed in receive ring
+    tEdrvTxBuffer*      apTxPending[EDRV_TX_RING_FRAMES];           ///< Tx buffers waiting for transmission
+    volatile UINT       txHead;                         ///< Number of queued Tx frames
+    volatile UINT       txTail;                         ///< Number of completed Tx frames
+    BOOL                fTxBatch;                       ///< Transmit kick is deferred to the end of the batch
+    BOOL                fTxKickPending;                 ///< Frames were queued during the batch
+#if (EDRV_USE_TX_TIME != FALSE)
+    BOOL                fTxTime;                        ///< The Tx socket supports SO_TXTIME
+    UINT64              txBatchLaunchTime;              ///< Launch time of the frames queued during the batch
+#endif
+    BOOL                fStopThread;
+    sem_t               syncSem;
+    pthread_t           hThread;
+} tEdrvInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tEdrvInstance edrvInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError openSockets(tEdrvInstance* pInstance_p);
+static void closeSockets(tEdrvInstance* pInstance_p);
+static INT setupRing(INT socket_p, INT ringType_p, UINT frameCount_p, tEdrvPacketRing* pRing_p);
+static void processRxRing(tEdrvInstance* pInstance_p);
+static void recycleRxSlot(UINT slot_p);
+static void processTxCompletion(tEdrvInstance* pInstance_p, const UINT8* pFrame_p);
+static void kickTx(tEdrvInstance* pInstance_p);
+#if (EDRV_USE_TX_TIME != FALSE)
+static void kickTxAt(tEdrvInstance* pInstance_p, UINT64 launchTime_p);
+#endif
+static void* workerThread(void* pArgument_p);
+static void getMacAdrs(const char* pIfName_p, UINT8* pMacAddr_p);
+static INT getLinkStatus(const char* pIfName_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Ethernet driver initialization
+
+This function initializes the Ethernet driver.
+
+\param  pEdrvInitParam_p    Edrv initialization parameters
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_init(tEdrvInitParam* pEdrvInitParam_p)
+{
+    tOplkError          ret = kErrorOk;
+
+    // clear instance structure
+    OPLK_MEMSET(&edrvInstance_l, 0, sizeof(edrvInstance_l));
+    edrvInstance_l.rxSocket = -1;
+    edrvInstance_l.txSocket = -1;
+
+    if (pEdrvInitParam_p->hwParam.pDevName == NULL)
+    {
+        ret = kErrorEdrvInit;
+        goto Exit;
+    }
+
+    /* if no MAC address was specified read MAC address of used
+     * Ethernet interface
+     */
+    if ((pEdrvInitParam_p->aMacAddr[0] == 0) &&
+        (pEdrvInitParam_p->aMacAddr[1] == 0) &&
+        (pEdrvInitParam_p->aMacAddr[2] == 0) &&
+        (pEdrvInitParam_p->aMacAddr[3] == 0) &&
+        (pEdrvInitParam_p->aMacAddr[4] == 0) &&
+        (pEdrvInitParam_p->aMacAddr[5] == 0)  )
+    {   // read MAC address from controller
+        getMacAdrs(pEdrvInitParam_p->hwParam.pDevName,
+                   pEdrvInitParam_p->aMacAddr);
+    }
+
+    // save the init data (with updated MAC address)
+    edrvInstance_l.initParam = *pEdrvInitParam_p;
+
+    if ((ret = openSockets(&edrvInstance_l)) != kErrorOk)
+        goto Exit;
+
+    if (sem_init(&edrvInstance_l.syncSem, 0, 0) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't init semaphore\n", __func__);
+        ret = kErrorEdrvInit;
+        goto Exit;
+    }
+
+#if (CONFIG_EDRV_MIRROR != FALSE)
+    // the driver works without mirror ring, therefore errors are ignored
+    edrvmirror_init();
+#endif
+
+    if (target_createThread(&edrvInstance_l.hThread, kThreadRoleEdrvRx, "oplk-edrvraw",
+                            workerThread, &edrvInstance_l) != kErrorOk)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Couldn't create worker thread!\n", __func__);
+        ret = kErrorEdrvInit;
+        goto Exit;
+    }
+
+    if (target_setThreadParams(edrvInstance_l.hThread, kThreadRoleEdrvRx, kThreadSchedFifo,
+                               CONFIG_THREAD_PRIORITY_EDRV_RX,
+                               CONFIG_THREAD_CPU_MASK_EDRV_RX) != kErrorOk)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't set thread scheduling parameters!\n",
+                                __func__);
+    }
+
+    /* wait until thread is started */
+    sem_wait(&edrvInstance_l.syncSem);
+
+Exit:
+    if (ret != kErrorOk)
+        closeSockets(&edrvInstance_l);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Ethernet driver shutdown
+
+This function shuts down the Ethernet driver.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_shutdown(void)
+{
+    // signal shutdown to the thread and wait for it to terminate
+    edrvInstance_l.fStopThread = TRUE;
+    pthread_join(edrvInstance_l.hThread, NULL);
+
+    closeSockets(&edrvInstance_l);
+    sem_destroy(&edrvInstance_l.syncSem);
+
+#if (CONFIG_EDRV_MIRROR != FALSE)
+    edrvmirror_exit();
+#endif
+
+    // clear instance structure
+    OPLK_MEMSET(&edrvInstance_l, 0, sizeof(edrvInstance_l));
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send Tx buffer
+
+This function sends the Tx buffer. The frame is copied into the next free slot
+of the transmit ring. Several callers may send concurrently, a slot is claimed
+by a compare-and-swap of the ring head. The claim fails if the ring is full or
+the kernel still owns the slot. The kernel transmits the slots in ring order.
+If a transmit batch is active, the frame is sent by edrv_endTxBatch(). If the
+Tx buffer contains a launch time, the frame is transmitted at this time.
+
+\param  pBuffer_p           Tx buffer descriptor
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    struct tpacket2_hdr*    pHeader;
+    UINT                    slot;
+    UINT                    head;
+#if (EDRV_USE_TX_TIME != FALSE)
+    UINT64                  launchTime;
+
+    // the launch time is only valid for this transmission
+    launchTime = pBuffer_p->launchTime;
+    pBuffer_p->launchTime = 0;
+#endif
+
+    FTRACE_MARKER("%s", __func__);
+
+    if (pBuffer_p->txFrameSize > EDRV_MAX_FRAME_SIZE)
+        return kErrorInvalidOperation;
+
+    if (getLinkStatus(edrvInstance_l.initParam.hwParam.pDevName) == FALSE)
+    {
+        /* there's no link! We pretend that packet is sent and immediately call
+         * tx handler! Otherwise the stack would hang! */
+        if (pBuffer_p->pfnTxHandler != NULL)
+        {
+            pBuffer_p->pfnTxHandler(pBuffer_p);
+        }
+        return kErrorOk;
+    }
+
+    // claim the next slot, the fill level is checked again on every attempt
+    do
+    {
+        head = edrvInstance_l.txHead;
+        if ((head - edrvInstance_l.txTail) >= EDRV_TX_RING_FRAMES)
+        {
+            DEBUG_LVL_EDRV_TRACE("%s() Tx ring full\n", __func__);
+            return kErrorEdrvNoFreeBufEntry;
+        }
+
+        slot = head % EDRV_TX_RING_FRAMES;
+        pHeader = (struct tpacket2_hdr*)(edrvInstance_l.txRing.pRing + (slot * EDRV_RING_FRAME_SIZE));
+        if (pHeader->tp_status != TP_STATUS_AVAILABLE)
+        {   // the kernel still owns the frame in this slot
+            DEBUG_LVL_EDRV_TRACE("%s() Tx slot %u not available (0x%X)\n",
+                                 __func__, slot, pHeader->tp_status);
+            return kErrorEdrvNoFreeBufEntry;
+        }
+    } while (!__sync_bool_compare_and_swap(&edrvInstance_l.txHead, head, head + 1));
+
+    edrvInstance_l.apTxPending[slot] = pBuffer_p;
+    OPLK_MEMCPY((UINT8*)pHeader + EDRV_TX_DATA_OFFSET, pBuffer_p->pBuffer, pBuffer_p->txFrameSize);
+    pHeader->tp_len = pBuffer_p->txFrameSize;
+
+    // Hand over the slot after the frame is completely written
+    __sync_synchronize();
+    pHeader->tp_status = TP_STATUS_SEND_REQUEST;
+
+    if (edrvInstance_l.fTxBatch)
+    {
+        edrvInstance_l.fTxKickPending = TRUE;
+#if (EDRV_USE_TX_TIME != FALSE)
+        if (edrvInstance_l.txBatchLaunchTime == 0)
+            edrvInstance_l.txBatchLaunchTime = launchTime;
+#endif
+    }
+    else
+    {
+#if (EDRV_USE_TX_TIME != FALSE)
+        kickTxAt(&edrvInstance_l, launchTime);
+#else
+        kickTx(&edrvInstance_l);
+#endif
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Begin Tx batch
+
+This function starts a transmit batch. All frames sent until edrv_endTxBatch()
+is called are transmitted with a single system call.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_beginTxBatch(void)
+{
+    edrvInstance_l.fTxBatch = TRUE;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  End Tx batch
+
+This function ends a transmit batch and transmits the frames which were sent
+during the batch.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_endTxBatch(void)
+{
+    edrvInstance_l.fTxBatch = FALSE;
+
+    if (edrvInstance_l.fTxKickPending)
+    {
+        edrvInstance_l.fTxKickPending = FALSE;
+#if (EDRV_USE_TX_TIME != FALSE)
+        kickTxAt(&edrvInstance_l, edrvInstance_l.txBatchLaunchTime);
+        edrvInstance_l.txBatchLaunchTime = 0;
+#else
+        kickTx(&edrvInstance_l);
+#endif
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Allocate Tx buffer
+
+This function allocates a Tx buffer.
+
+\param  pBuffer_p           Tx buffer descriptor
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_allocTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    tOplkError ret = kErrorOk;
+
+    if (pBuffer_p->maxBufferSize > EDRV_MAX_FRAME_SIZE)
+    {
+        ret = kErrorEdrvNoFreeBufEntry;
+        goto Exit;
+    }
+
+    // allocate buffer with malloc
+    pBuffer_p->pBuffer = OPLK_MALLOC(pBuffer_p->maxBufferSize);
+    if (pBuffer_p->pBuffer == NULL)
+    {
+        ret = kErrorEdrvNoFreeBufEntry;
+        goto Exit;
+    }
+
+    pBuffer_p->txBufferNumber.pArg = NULL;
+
+Exit:
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Free Tx buffer
+
+This function releases the Tx buffer.
+
+\param  pBuffer_p           Tx buffer descriptor
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_freeTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    UINT8* pBuffer = pBuffer_p->pBuffer;
+
+    // mark buffer as free, before actually freeing it
+    pBuffer_p->pBuffer = NULL;
+
+    OPLK_FREE(pBuffer);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Release Rx buffer
+
+This function releases a reference to a late release Rx buffer. The frame slot
+is handed back to the kernel when its last reference is released.
+
+\param  pRxBuffer_p         Rx buffer to be released
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_releaseRxBuffer(tEdrvRxBuffer* pRxBuffer_p)
+{
+    return edrvrxpool_release(pRxBuffer_p->pBuffer);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Hold Rx buffer
+
+This function adds a reference to a late release Rx buffer, so that an
+additional consumer can keep the frame without copying it. The frame slot is
+handed back to the kernel when every reference is released by
+edrv_releaseRxBuffer().
+
+\param  pRxBuffer_p         Rx buffer to be held
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_holdRxBuffer(tEdrvRxBuffer* pRxBuffer_p)
+{
+    return edrvrxpool_addRef(pRxBuffer_p->pBuffer);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Change Rx filter setup
+
+This function changes the Rx filter setup. The parameter entryChanged_p
+selects the Rx filter entry that shall be changed and \p changeFlags_p determines
+the property.
+If \p entryChanged_p is equal or larger count_p all Rx filters shall be changed.
+
+\note Rx filters are not supported by this driver!
+
+\param  pFilter_p           Base pointer of Rx filter array
+\param  count_p             Number of Rx filter array entries
+\param  entryChanged_p      Index of Rx filter entry that shall be changed
+\param  changeFlags_p       Bit mask that selects the changing Rx filter property
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_changeRxFilter(tEdrvFilter* pFilter_p, UINT count_p,
+                               UINT entryChanged_p, UINT changeFlags_p)
+{
+    UNUSED_PARAMETER(pFilter_p);
+    UNUSED_PARAMETER(count_p);
+    UNUSED_PARAMETER(entryChanged_p);
+    UNUSED_PARAMETER(changeFlags_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Clear multicast address entry
+
+This function removes the multicast entry from the Ethernet controller.
+
+\param  pMacAddr_p  Multicast address
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_clearRxMulticastMacAddr(UINT8* pMacAddr_p)
+{
+    UNUSED_PARAMETER(pMacAddr_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set multicast address entry
+
+This function sets a multicast entry into the Ethernet controller.
+
+\param  pMacAddr_p  Multicast address
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_setRxMulticastMacAddr(UINT8* pMacAddr_p)
+{
+    UNUSED_PARAMETER(pMacAddr_p);
+
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Open sockets
+
+This function opens the receive and the transmit socket and sets up their
+packet rings. Two sockets are used because the kernel doesn't loop back frames
+to the sending socket. The receive socket sees the frames of the transmit
+socket as outgoing frames, which is used to detect the Tx completion.
+
+\param  pInstance_p     Pointer to the instance structure
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError openSockets(tEdrvInstance* pInstance_p)
+{
+    struct sockaddr_ll  sockAddr;
+    struct packet_mreq  mreq;
+    INT                 ifIndex;
+    INT                 version = TPACKET_V2;
+#if (EDRV_USE_TX_TIME != FALSE)
+    struct sock_txtime  txTime;
+#endif
+
+    ifIndex = if_nametoindex(pInstance_p->initParam.hwParam.pDevName);
+    if (ifIndex == 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Unknown interface %s\n", __func__,
+                              pInstance_p->initParam.hwParam.pDevName);
+        return kErrorEdrvInit;
+    }
+
+    OPLK_MEMSET(&sockAddr, 0, sizeof(sockAddr));
+    sockAddr.sll_family = AF_PACKET;
+    sockAddr.sll_protocol = htons(ETH_P_ALL);
+    sockAddr.sll_ifindex = ifIndex;
+
+    // Receive socket
+    pInstance_p->rxSocket = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+    if (pInstance_p->rxSocket < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Can't open Rx socket (%s)\n", __func__, strerror(errno));
+        return kErrorEdrvInit;
+    }
+
+    if ((setsockopt(pInstance_p->rxSocket, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0) ||
+        (setupRing(pInstance_p->rxSocket, PACKET_RX_RING, EDRV_RX_RING_FRAMES, &pInstance_p->rxRing) != 0) ||
+        (bind(pInstance_p->rxSocket, (struct sockaddr*)&sockAddr, sizeof(sockAddr)) != 0))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Can't setup Rx socket (%s)\n", __func__, strerror(errno));
+        return kErrorEdrvInit;
+    }
+
+    // the frame slots of the receive ring are held through the Rx buffer pool
+    if (edrvrxpool_init(pInstance_p->rxRing.pRing, pInstance_p->rxRing.frameCount,
+                        EDRV_RING_FRAME_SIZE, recycleRxSlot) != kErrorOk)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Can't create Rx buffer pool\n", __func__);
+        return kErrorEdrvInit;
+    }
+
+    OPLK_MEMSET(&mreq, 0, sizeof(mreq));
+    mreq.mr_ifindex = ifIndex;
+    mreq.mr_type = PACKET_MR_PROMISC;
+    if (setsockopt(pInstance_p->rxSocket, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Can't enable promiscuous mode (%s)\n", __func__, strerror(errno));
+        return kErrorEdrvInit;
+    }
+
+    // Transmit socket, doesn't receive any frames
+    pInstance_p->txSocket = socket(AF_PACKET, SOCK_RAW, 0);
+    if (pInstance_p->txSocket < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Can't open Tx socket (%s)\n", __func__, strerror(errno));
+        return kErrorEdrvInit;
+    }
+
+    sockAddr.sll_protocol = 0;
+    if ((setsockopt(pInstance_p->txSocket, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0) ||
+        (setupRing(pInstance_p->txSocket, PACKET_TX_RING, EDRV_TX_RING_FRAMES, &pInstance_p->txRing) != 0) ||
+        (bind(pInstance_p->txSocket, (struct sockaddr*)&sockAddr, sizeof(sockAddr)) != 0))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Can't setup Tx socket (%s)\n", __func__, strerror(errno));
+        return kErrorEdrvInit;
+    }
+
+#if (EDRV_USE_TX_TIME != FALSE)
+    // The launch times are only met if the ETF qdisc with CLOCK_TAI is
+    // configured on the interface
+    OPLK_MEMSET(&txTime, 0, sizeof(txTime));
+    txTime.clockid = CLOCK_TAI;
+    pInstance_p->fTxTime = (setsockopt(pInstance_p->txSocket, SOL_SOCKET, SO_TXTIME,
+                                       &txTime, sizeof(txTime)) == 0);
+    if (!pInstance_p->fTxTime)
+    {
+        DEBUG_LVL_EDRV_TRACE("%s() SO_TXTIME not supported, launch times are polled (%s)\n",
+                             __func__, strerror(errno));
+    }
+#endif
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close sockets
+
+This function unmaps the packet rings and closes the sockets.
+
+\param  pInstance_p     Pointer to the instance structure
+*/
+//------------------------------------------------------------------------------
+static void closeSockets(tEdrvInstance* pInstance_p)
+{
+    edrvrxpool_exit();
+
+    if (pInstance_p->rxRing.pRing != NULL)
+        munmap(pInstance_p->rxRing.pRing, pInstance_p->rxRing.ringSize);
+
+    if (pInstance_p->txRing.pRing != NULL)
+        munmap(pInstance_p->txRing.pRing, pInstance_p->txRing.ringSize);
+
+    if (pInstance_p->rxSocket >= 0)
+        close(pInstance_p->rxSocket);
+
+    if (pInstance_p->txSocket >= 0)
+        close(pInstance_p->txSocket);
+
+    pInstance_p->rxRing.pRing = NULL;
+    pInstance_p->txRing.pRing = NULL;
+    pInstance_p->rxSocket = -1;
+    pInstance_p->txSocket = -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set up packet ring
+
+This function sets up and maps a packet ring of a socket.
+
+\param  socket_p        Socket descriptor
+\param  ringType_p      Ring type (PACKET_RX_RING or PACKET_TX_RING)
+\param  frameCount_p    Number of frames in the ring
+\param  pRing_p         Pointer to store the ring information
+
+\return The function returns 0 on success or -1 on error.
+*/
+//------------------------------------------------------------------------------
+static INT setupRing(INT socket_p, INT ringType_p, UINT frameCount_p, tEdrvPacketRing* pRing_p)
+{
+    struct tpacket_req  req;
+    void*               pRing;
+
+    req.tp_block_size = EDRV_RING_BLOCK_SIZE;
+    req.tp_frame_size = EDRV_RING_FRAME_SIZE;
+    req.tp_frame_nr = frameCount_p;
+    req.tp_block_nr = (frameCount_p * EDRV_RING_FRAME_SIZE) / EDRV_RING_BLOCK_SIZE;
+
+    if (setsockopt(socket_p, SOL_PACKET, ringType_p, &req, sizeof(req)) != 0)
+        return -1;
+
+    pRing = mmap(NULL, req.tp_block_size * req.tp_block_nr, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_LOCKED, socket_p, 0);
+    if (pRing == MAP_FAILED)
+        return -1;
+
+    pRing_p->pRing = (UINT8*)pRing;
+    pRing_p->ringSize = req.tp_block_size * req.tp_block_nr;
+    pRing_p->frameCount = frameCount_p;
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process receive ring
+
+This function processes all frames which are available in the receive ring.
+Received frames are passed to the DLL in the ring. Outgoing frames complete the
+pending Tx buffers.
+
+\param  pInstance_p     Pointer to the instance structure
+*/
+//------------------------------------------------------------------------------
+static void processRxRing(tEdrvInstance* pInstance_p)
+{
+    struct tpacket2_hdr*    pHeader;
+    struct sockaddr_ll*     pSockAddr;
+    tEdrvRxBuffer           rxBuffer;
+    tTimestamp              rxTimeStamp;
+    tEdrvReleaseRxBuffer    release;
+    UINT8*                  pFrame;
+    UINT                    slot;
+
+    for (;;)
+    {
+        slot = pInstance_p->rxIndex;
+        pHeader = (struct tpacket2_hdr*)(pInstance_p->rxRing.pRing + (slot * EDRV_RING_FRAME_SIZE));
+
+        if (((pHeader->tp_status & TP_STATUS_USER) == 0) || (edrvrxpool_acquireBuffer(slot) != kErrorOk))
+            break;
+
+        __sync_synchronize();
+
+        pSockAddr = (struct sockaddr_ll*)((UINT8*)pHeader + TPACKET_ALIGN(sizeof(struct tpacket2_hdr)));
+        pFrame = (UINT8*)pHeader + pHeader->tp_mac;
+        release = kEdrvReleaseRxBufferImmediately;
+
+        EDRVMIRROR_RECORD_FRAME(pFrame, pHeader->tp_snaplen,
+                                ((UINT64)pHeader->tp_sec * 1000000000ULL) + pHeader->tp_nsec,
+                                (pSockAddr->sll_pkttype == PACKET_OUTGOING) ? EDRVMIRROR_FLAG_TX : 0);
+
+        if (pSockAddr->sll_pkttype == PACKET_OUTGOING)
+        {   // self generated traffic
+            FTRACE_MARKER("%s TX-receive", __func__);
+            processTxCompletion(pInstance_p, pFrame);
+        }
+        else if (OPLK_MEMCMP(pFrame + 6, pInstance_p->initParam.aMacAddr, 6) != 0)
+        {
+            rxBuffer.bufferInFrame = kEdrvBufferLastInFrame;
+            rxBuffer.rxFrameSize = pHeader->tp_snaplen;
+            rxBuffer.pBuffer = pFrame;
+
+            // kernel receive time stamp of the frame
+            rxTimeStamp.timeStamp = (TIME_STAMP_T)target_convertRealtimeToTimestamp(
+                                        ((UINT64)pHeader->tp_sec * 1000000000ULL) + pHeader->tp_nsec);
+            rxBuffer.pRxTimeStamp = &rxTimeStamp;
+
+            FTRACE_MARKER("%s RX", __func__);
+            release = pInstance_p->initParam.pfnRxHandler(&rxBuffer);
+        }
+
+        if (release == kEdrvReleaseRxBufferImmediately)
+            edrvrxpool_release(pFrame);
+
+        pInstance_p->rxIndex = (slot + 1) % pInstance_p->rxRing.frameCount;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Recycle Rx slot
+
+This function is called by the Rx buffer pool if the last reference to a frame
+slot of the receive ring is released. The slot is handed back to the kernel.
+
+\param  slot_p          Index of the frame slot
+*/
+//------------------------------------------------------------------------------
+static void recycleRxSlot(UINT slot_p)
+{
+    struct tpacket2_hdr*    pHeader;
+
+    pHeader = (struct tpacket2_hdr*)(edrvInstance_l.rxRing.pRing + (slot_p * EDRV_RING_FRAME_SIZE));
+
+    __sync_synchronize();
+    pHeader->tp_status = TP_STATUS_KERNEL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process Tx completion
+
+This function completes the oldest pending Tx buffer if the outgoing frame
+matches it and calls its Tx handler.
+
+\param  pInstance_p     Pointer to the instance structure
+\param  pFrame_p        Pointer to the outgoing frame
+*/
+//------------------------------------------------------------------------------
+static void processTxCompletion(tEdrvInstance* pInstance_p, const UINT8* pFrame_p)
+{
+    tEdrvTxBuffer*  pTxBuffer;
+    UINT            slot;
+
+    if (pInstance_p->txTail == pInstance_p->txHead)
+        return;
+
+    slot = pInstance_p->txTail % EDRV_TX_RING_FRAMES;
+    pTxBuffer = pInstance_p->apTxPending[slot];
+
+    if ((pTxBuffer == NULL) || (pTxBuffer->pBuffer == NULL))
+        return;
+
+    if (OPLK_MEMCMP(pFrame_p, pTxBuffer->pBuffer, 6) != 0)
+    {
+        TRACE("%s: no matching TxB: DstMAC=%02X%02X%02X%02X%02X%02X\n",
+              __func__,
+              (UINT)pFrame_p[0], (UINT)pFrame_p[1], (UINT)pFrame_p[2],
+              (UINT)pFrame_p[3], (UINT)pFrame_p[4], (UINT)pFrame_p[5]);
+        return;
+    }
+
+    pInstance_p->apTxPending[slot] = NULL;
+    __sync_synchronize();
+    pInstance_p->txTail++;
+
+    if (pTxBuffer->pfnTxHandler != NULL)
+    {
+        pTxBuffer->pfnTxHandler(pTxBuffer);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Kick transmission
+
+This function asks the kernel to transmit all frames of the transmit ring
+which are ready for transmission.
+
+\param  pInstance_p     Pointer to the instance structure
+*/
+//------------------------------------------------------------------------------
+static void kickTx(tEdrvInstance* pInstance_p)
+{
+    if ((send(pInstance_p->txSocket, NULL, 0, MSG_DONTWAIT) < 0) && (errno != EAGAIN))
+    {
+        DEBUG_LVL_EDRV_TRACE("%s() send returned error (%s)\n", __func__, strerror(errno));
+    }
+}
+
+#if (EDRV_USE_TX_TIME != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Kick transmission at launch time
+
+This function asks the kernel to transmit all frames of the transmit ring
+which are ready for transmission at the specified launch time. If the socket
+supports SO_TXTIME, the launch time is passed to the qdisc. Otherwise the
+function polls the clock until the launch time is reached.
+
+\param  pInstance_p     Pointer to the instance structure
+\param  launchTime_p    Launch time (target_getCurrentTimestamp() base) [ns],
+                        0 transmits the frames immediately.
+*/
+//------------------------------------------------------------------------------
+static void kickTxAt(tEdrvInstance* pInstance_p, UINT64 launchTime_p)
+{
+    struct msghdr       msg;
+    struct cmsghdr*     pCmsg;
+    UINT8               aControl[CMSG_SPACE(sizeof(UINT64))];
+    struct timespec     taiTime;
+    struct timespec     monoTime;
+    UINT64              txTime;
+
+    if (launchTime_p == 0)
+    {
+        kickTx(pInstance_p);
+        return;
+    }
+
+    if (!pInstance_p->fTxTime)
+    {
+        while (target_getCurrentTimestamp() < launchTime_p)
+            ;
+        kickTx(pInstance_p);
+        return;
+    }
+
+    // convert launch time from CLOCK_MONOTONIC to CLOCK_TAI
+    clock_gettime(CLOCK_TAI, &taiTime);
+    clock_gettime(CLOCK_MONOTONIC, &monoTime);
+    txTime = launchTime_p + (((UINT64)taiTime.tv_sec * 1000000000ULL) + (UINT64)taiTime.tv_nsec) -
+             (((UINT64)monoTime.tv_sec * 1000000000ULL) + (UINT64)monoTime.tv_nsec);
+
+    OPLK_MEMSET(&msg, 0, sizeof(msg));
+    OPLK_MEMSET(aControl, 0, sizeof(aControl));
+    msg.msg_control = aControl;
+    msg.msg_controllen = sizeof(aControl);
+
+    pCmsg = CMSG_FIRSTHDR(&msg);
+    pCmsg->cmsg_level = SOL_SOCKET;
+    pCmsg->cmsg_type = SCM_TXTIME;
+    pCmsg->cmsg_len = CMSG_LEN(sizeof(UINT64));
+    OPLK_MEMCPY(CMSG_DATA(pCmsg), &txTime, sizeof(txTime));
+
+    if ((sendmsg(pInstance_p->txSocket, &msg, MSG_DONTWAIT) < 0) && (errno != EAGAIN))
+    {
+        DEBUG_LVL_EDRV_TRACE("%s() sendmsg returned error (%s)\n", __func__, strerror(errno));
+    }
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief  Edrv worker thread
+
+This function is the Edrv worker thread. It waits for frames in the receive ring
+and processes them as emulation of non-reentrant interrupt processing.
+
+\param  pArgument_p     User specific pointer pointing to the instance structure
+
+\return The function returns a thread error code.
+*/
+//------------------------------------------------------------------------------
+static void* workerThread(void* pArgument_p)
+{
+    tEdrvInstance*  pInstance = (tEdrvInstance*)pArgument_p;
+    struct pollfd   pollFd;
+
+    DEBUG_LVL_EDRV_TRACE("%s(): ThreadId:%ld\n", __func__, syscall(SYS_gettid));
+
+    pollFd.fd = pInstance->rxSocket;
+    pollFd.events = POLLIN | POLLERR;
+
+    /* signal that thread is successfully started */
+    sem_post(&pInstance->syncSem);
+
+    while (!pInstance->fStopThread)
+    {
+        processRxRing(pInstance);
+
+        pollFd.revents = 0;
+        if ((poll(&pollFd, 1, EDRV_POLL_TIMEOUT_MS) < 0) && (errno != EINTR))
+        {
+            DEBUG_LVL_ERROR_TRACE("%s(): poll failed (%s)\n", __func__, strerror(errno));
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get Edrv MAC address
+
+This function gets the interface's MAC address.
+
+\param  pIfName_p   Ethernet interface device name
+\param  pMacAddr_p  Pointer to store MAC address
+*/
+//------------------------------------------------------------------------------
+static void getMacAdrs(const char* pIfName_p, UINT8* pMacAddr_p)
+{
+    INT             fd;
+    struct ifreq    ifr;
+
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+    ifr.ifr_addr.sa_family = AF_INET;
+    strncpy(ifr.ifr_name, pIfName_p, IFNAMSIZ - 1);
+
+    ioctl(fd, SIOCGIFHWADDR, &ifr);
+
+    close(fd);
+
+    OPLK_MEMCPY(pMacAddr_p, ifr.ifr_hwaddr.sa_data, 6);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get link status
+
+This function returns the interface link status.
+
+\param  pIfName_p  Ethernet interface device name
+
+\return The function returns the link status.
+\retval TRUE    The link is up.
+\retval FALSE   The link is down.
+*/
+//------------------------------------------------------------------------------
+static INT getLinkStatus(const char* pIfName_p)
+{
+    BOOL            fRunning;
+    struct ifreq    ethreq;
+    INT             fd;
+
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+    OPLK_MEMSET(&ethreq, 0, sizeof(ethreq));
+
+    /* set the name of the interface we wish to check */
+    strncpy(ethreq.ifr_name, pIfName_p, IFNAMSIZ);
+
+    /* grab flags associated with this interface */
+    ioctl(fd, SIOCGIFFLAGS, &ethreq);
+
+    if (ethreq.ifr_flags & IFF_RUNNING)
+    {
+        fRunning = TRUE;
+    }
+    else
+    {
+        fRunning = FALSE;
+    }
+
+    close(fd);
+
+    return fRunning;
+}
+
+///\}
@@ -0,0 +1,1532 @@
+/**
+********************************************************************************
+\file   edrv-replay_linux.c
+
+\brief  Implementation of the replay Ethernet driver for Linux userspace
+
+This file contains the implementation of an Ethernet driver which replays a
+capture instead of receiving frames from a network. The device name selects a
+pcap or pcapng file, its frames are passed to the Rx handler of the DLL with
+the timing of the capture or accelerated. The driver measures the processing
+cost of every frame and records the NMT state changes of the stack which are
+visible in its transmitted frames. Field captures of CFM storms or error
+bursts can thereby be reproduced and profiled offline.
+
+\ingroup module_edrv
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <kernel/edrv.h>
+#include <kernel/edrvmirror.h>
+#include <kernel/edrvreplay.h>
+#include <common/target.h>
+#include <common/ami.h>
+#include <oplk/frame.h>
+#include <oplk/nmt.h>
+#include <oplk/dll.h>
+
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#ifndef CONFIG_THREAD_PRIORITY_EDRV_RX
+#define CONFIG_THREAD_PRIORITY_EDRV_RX      CONFIG_THREAD_PRIORITY_MEDIUM
+#endif
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define EDRV_MAX_FRAME_SIZE             0x600
+
+#define EDRVREPLAY_TX_EVENT_COUNT       64                  // Number of transmitted frames which can be in flight
+#define EDRVREPLAY_MAX_INTERFACES       8                   // Maximum number of interfaces in a pcapng section
+#define EDRVREPLAY_MAX_BLOCK_SIZE       0x10000             // Maximum size of a pcapng block which is evaluated
+
+#define EDRVREPLAY_WIRE_NS_PER_BYTE     80                  // Transmission time of a byte at 100 MBit/s
+#define EDRVREPLAY_WIRE_OVERHEAD        24                  // Preamble, SFD, CRC and inter frame gap in bytes
+#define EDRVREPLAY_MIN_FRAME_SIZE       60                  // Minimum Ethernet frame size without CRC
+
+#define EDRVREPLAY_LINKTYPE_ETHERNET    1                   // pcap link type of Ethernet
+
+#define EDRVREPLAY_PCAP_MAGIC           0xA1B2C3D4          // Magic of a pcap file with timestamps in us
+#define EDRVREPLAY_PCAP_MAGIC_NS        0xA1B23C4D          // Magic of a pcap file with timestamps in ns
+#define EDRVREPLAY_PCAP_HEADER_SIZE     24                  // Size of the pcap file header
+#define EDRVREPLAY_PCAP_RECORD_SIZE     16                  // Size of the pcap record header
+
+#define EDRVREPLAY_PCAPNG_SHB           0x0A0D0D0A          // Section header block
+#define EDRVREPLAY_PCAPNG_IDB           0x00000001          // Interface description block
+#define EDRVREPLAY_PCAPNG_SPB           0x00000003          // Simple packet block
+#define EDRVREPLAY_PCAPNG_EPB           0x00000006          // Enhanced packet block
+#define EDRVREPLAY_PCAPNG_BYTE_ORDER    0x1A2B3C4D          // Byte order magic of the section header block
+#define EDRVREPLAY_PCAPNG_OPT_TSRESOL   9                   // Option if_tsresol of the interface description block
+#define EDRVREPLAY_PCAPNG_OPT_FLAGS     2                   // Option epb_flags of the enhanced packet block
+#define EDRVREPLAY_PCAPNG_DIR_MASK      0x00000003          // Direction bits of epb_flags
+#define EDRVREPLAY_PCAPNG_DIR_OUTBOUND  0x00000002          // Frame was transmitted by the capturing node
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief Tx event
+
+The structure describes a frame transmitted by the stack whose Tx handler is
+called when the frame has left the wire.
+*/
+typedef struct sEdrvReplayTxEvent
+{
+    struct sEdrvReplayTxEvent*  pNext;                  ///< Next event in the queue or free list
+    UINT64                      dueTime;                ///< Time when the frame has left the wire [ns]
+    tEdrvTxBuffer*              pTxBuffer;              ///< Transmitted Tx buffer
+} tEdrvReplayTxEvent;
+
+/**
+\brief Capture interface
+
+The structure describes an interface of a pcapng section.
+*/
+typedef struct
+{
+    UINT16                      linkType;               ///< Link type of the interface
+    UINT8                       tsResol;                ///< Timestamp resolution (if_tsresol)
+} tEdrvReplayInterface;
+
+/**
+\brief Capture file
+
+The structure contains the state of the capture file reader.
+*/
+typedef struct
+{
+    FILE*                       pFile;                  ///< Capture file
+    BOOL                        fPcapng;                ///< The file is a pcapng file
+    BOOL                        fBigEndian;             ///< The current section is in big endian byte order
+    UINT16                      linkType;               ///< Link type of a pcap file
+    UINT32                      tsUnitNs;               ///< Unit of the pcap timestamp fraction [ns]
+    tEdrvReplayInterface        aInterface[EDRVREPLAY_MAX_INTERFACES];  ///< Interfaces of the pcapng section
+    UINT                        interfaceCount;         ///< Number of interfaces of the pcapng section
+    UINT64                      lastTimeStamp;          ///< Timestamp of the last frame [ns]
+    UINT8                       aBlock[EDRVREPLAY_MAX_BLOCK_SIZE];      ///< Buffer of the current pcapng block
+} tEdrvReplayCapture;
+
+// Private structure
+typedef struct
+{
+    tEdrvInitParam              initParam;
+    tEdrvReplayCapture*         pCapture;               ///< Capture file reader
+    FILE*                       pReportFile;            ///< Report file or NULL
+    tEdrvReplayTxEvent          aTxEvent[EDRVREPLAY_TX_EVENT_COUNT];    ///< Tx events
+    tEdrvReplayTxEvent*         pFreeTxEvents;          ///< List of free Tx events
+    tEdrvReplayTxEvent*         pTxQueue;               ///< Tx events sorted by their due time
+    UINT64                      wireFreeTime;           ///< Time when the wire becomes idle [ns]
+    UINT64                      startTime;              ///< Time when the first frame is injected [ns]
+    BOOL                        fRxPending;             ///< A frame of the capture waits for injection
+    UINT64                      rxDueTime;              ///< Time when the pending frame is injected [ns]
+    UINT64                      rxCaptureTime;          ///< Capture timestamp of the pending frame [ns]
+    UINT64                      firstCaptureTime;       ///< Capture timestamp of the first injected frame [ns]
+    UINT64                      frameIndex;             ///< Index of the pending frame in the capture
+    UINT64                      lastFrameIndex;         ///< Index of the last injected frame in the capture
+    UINT64                      lastCaptureTime;        ///< Capture time of the last injected frame [ns]
+    UINT                        rxFrameSize;            ///< Size of the pending frame
+    UINT8                       aRxFrame[EDRV_MAX_FRAME_SIZE];          ///< Pending frame
+    tNmtState                   nmtState;               ///< NMT state of the stack seen in its transmitted frames
+    tEdrvReplayStatistics       statistics;
+    BOOL                        fStopThread;
+    pthread_mutex_t             mutex;
+    pthread_cond_t              eventCond;
+    sem_t                       syncSem;
+    pthread_t                   hThread;
+} tEdrvInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tEdrvInstance edrvInstance_l;
+
+static tEdrvReplayConfig edrvReplayConfig_l =
+{
+    CONFIG_EDRV_REPLAY_SPEED_PERCENT,
+    CONFIG_EDRV_REPLAY_START_DELAY_MS,
+    CONFIG_EDRV_REPLAY_LOCAL_NODE_ID,
+    NULL                                // pReportFileName: no report
+};
+
+static const UINT8 aReplayMacPrefix_l[5] = {0x02, 0x52, 0x50, 0x4C, 0x00};
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static UINT64 getTimeNs(void);
+static UINT64 getWireTime(UINT frameSize_p);
+static tOplkError openCapture(tEdrvReplayCapture* pCapture_p, const char* pFileName_p);
+static BOOL readFrame(tEdrvReplayCapture* pCapture_p, UINT8* pFrame_p, UINT* pFrameSize_p,
+                      UINT64* pTimeStamp_p, BOOL* pfInject_p);
+static BOOL readPcapFrame(tEdrvReplayCapture* pCapture_p, UINT8* pFrame_p, UINT* pFrameSize_p,
+                          UINT64* pTimeStamp_p, BOOL* pfInject_p);
+static BOOL readPcapngFrame(tEdrvReplayCapture* pCapture_p, UINT8* pFrame_p, UINT* pFrameSize_p,
+                            UINT64* pTimeStamp_p, BOOL* pfInject_p);
+static void parseInterfaceBlock(tEdrvReplayCapture* pCapture_p, UINT blockSize_p);
+static UINT32 getEpbFlags(tEdrvReplayCapture* pCapture_p, UINT blockSize_p, UINT capturedSize_p);
+static UINT16 getCaptureUint16(const tEdrvReplayCapture* pCapture_p, void* pData_p);
+static UINT32 getCaptureUint32(const tEdrvReplayCapture* pCapture_p, void* pData_p);
+static UINT64 convertTimeStamp(UINT64 timeStamp_p, UINT8 tsResol_p);
+static void readNextFrame(tEdrvInstance* pInstance_p);
+static void injectFrame(tEdrvInstance* pInstance_p);
+static void checkNmtState(tEdrvInstance* pInstance_p, tPlkFrame* pFrame_p, UINT frameSize_p);
+static void* workerThread(void* pArgument_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Ethernet driver initialization
+
+This function initializes the Ethernet driver. The device name of the
+hardware parameters is the name of the capture file which is replayed.
+
+\param  pEdrvInitParam_p    Edrv initialization parameters
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_init(tEdrvInitParam* pEdrvInitParam_p)
+{
+    tOplkError          ret = kErrorOk;
+    pthread_condattr_t  condAttr;
+    UINT                i;
+
+    // clear instance structure
+    OPLK_MEMSET(&edrvInstance_l, 0, sizeof(edrvInstance_l));
+
+    if (pEdrvInitParam_p->hwParam.pDevName == NULL)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() no capture file specified\n", __func__);
+        return kErrorEdrvInit;
+    }
+
+    // if no MAC address was specified use a locally administered address
+    if ((pEdrvInitParam_p->aMacAddr[0] == 0) &&
+        (pEdrvInitParam_p->aMacAddr[1] == 0) &&
+        (pEdrvInitParam_p->aMacAddr[2] == 0) &&
+        (pEdrvInitParam_p->aMacAddr[3] == 0) &&
+        (pEdrvInitParam_p->aMacAddr[4] == 0) &&
+        (pEdrvInitParam_p->aMacAddr[5] == 0)  )
+    {
+        OPLK_MEMCPY(pEdrvInitParam_p->aMacAddr, aReplayMacPrefix_l, sizeof(aReplayMacPrefix_l));
+        pEdrvInitParam_p->aMacAddr[5] = (UINT8)edrvReplayConfig_l.localNodeId;
+    }
+
+    // save the init data (with updated MAC address)
+    edrvInstance_l.initParam = *pEdrvInitParam_p;
+    edrvInstance_l.nmtState = kNmtGsOff;
+
+    for (i = 0; i < EDRVREPLAY_TX_EVENT_COUNT; i++)
+    {
+        edrvInstance_l.aTxEvent[i].pNext = edrvInstance_l.pFreeTxEvents;
+        edrvInstance_l.pFreeTxEvents = &edrvInstance_l.aTxEvent[i];
+    }
+
+    edrvInstance_l.pCapture = (tEdrvReplayCapture*)OPLK_MALLOC(sizeof(tEdrvReplayCapture));
+    if (edrvInstance_l.pCapture == NULL)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't allocate capture reader\n", __func__);
+        ret = kErrorEdrvInit;
+        goto Exit;
+    }
+
+    ret = openCapture(edrvInstance_l.pCapture, pEdrvInitParam_p->hwParam.pDevName);
+    if (ret != kErrorOk)
+        goto Exit;
+
+    if (edrvReplayConfig_l.pReportFileName != NULL)
+    {
+        edrvInstance_l.pReportFile = fopen(edrvReplayConfig_l.pReportFileName, "w");
+        if (edrvInstance_l.pReportFile == NULL)
+        {
+            DEBUG_LVL_ERROR_TRACE("%s() couldn't open report file %s\n",
+                                  __func__, edrvReplayConfig_l.pReportFileName);
+            ret = kErrorEdrvInit;
+            goto Exit;
+        }
+
+        fprintf(edrvInstance_l.pReportFile,
+                "type,frame,time_ns,msg_type,src_node,dst_node,size,cost_ns,old_state,new_state\n");
+    }
+
+    if (pthread_mutex_init(&edrvInstance_l.mutex, NULL) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't init mutex\n", __func__);
+        ret = kErrorEdrvInit;
+        goto Exit;
+    }
+
+    // the due times are based on CLOCK_MONOTONIC, therefore the condition uses it too
+    if ((pthread_condattr_init(&condAttr) != 0) ||
+        (pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC) != 0) ||
+        (pthread_cond_init(&edrvInstance_l.eventCond, &condAttr) != 0))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't init condition\n", __func__);
+        ret = kErrorEdrvInit;
+        goto Exit;
+    }
+    pthread_condattr_destroy(&condAttr);
+
+    if (sem_init(&edrvInstance_l.syncSem, 0, 0) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't init semaphore\n", __func__);
+        ret = kErrorEdrvInit;
+        goto Exit;
+    }
+
+#if (CONFIG_EDRV_MIRROR != FALSE)
+    // the driver works without mirror ring, therefore errors are ignored
+    edrvmirror_init();
+#endif
+
+    edrvInstance_l.startTime = getTimeNs() + ((UINT64)edrvReplayConfig_l.startDelayMs * 1000000ULL);
+    readNextFrame(&edrvInstance_l);
+
+    if (target_createThread(&edrvInstance_l.hThread, kThreadRoleEdrvRx, "oplk-edrvreplay",
+                            workerThread, &edrvInstance_l) != kErrorOk)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Couldn't create worker thread!\n", __func__);
+        ret = kErrorEdrvInit;
+        goto Exit;
+    }
+
+    if (target_setThreadParams(edrvInstance_l.hThread, kThreadRoleEdrvRx, kThreadSchedFifo,
+                               CONFIG_THREAD_PRIORITY_EDRV_RX,
+                               CONFIG_THREAD_CPU_MASK_EDRV_RX) != kErrorOk)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't set thread scheduling parameters!\n",
+                                __func__);
+    }
+
+    /* wait until thread is started */
+    sem_wait(&edrvInstance_l.syncSem);
+
+    DEBUG_LVL_EDRV_TRACE("%s() replaying %s at %u%% speed\n", __func__,
+                         pEdrvInitParam_p->hwParam.pDevName, edrvReplayConfig_l.speedPercent);
+
+Exit:
+    if (ret != kErrorOk)
+    {
+        if (edrvInstance_l.pReportFile != NULL)
+        {
+            fclose(edrvInstance_l.pReportFile);
+            edrvInstance_l.pReportFile = NULL;
+        }
+
+        if (edrvInstance_l.pCapture != NULL)
+        {
+            if (edrvInstance_l.pCapture->pFile != NULL)
+                fclose(edrvInstance_l.pCapture->pFile);
+
+            OPLK_FREE(edrvInstance_l.pCapture);
+            edrvInstance_l.pCapture = NULL;
+        }
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Ethernet driver shutdown
+
+This function shuts down the Ethernet driver.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_shutdown(void)
+{
+    // signal shutdown to the thread
+    pthread_mutex_lock(&edrvInstance_l.mutex);
+    edrvInstance_l.fStopThread = TRUE;
+    pthread_cond_signal(&edrvInstance_l.eventCond);
+    pthread_mutex_unlock(&edrvInstance_l.mutex);
+
+    // wait for thread to terminate
+    pthread_join(edrvInstance_l.hThread, NULL);
+
+    pthread_cond_destroy(&edrvInstance_l.eventCond);
+    pthread_mutex_destroy(&edrvInstance_l.mutex);
+    sem_destroy(&edrvInstance_l.syncSem);
+
+#if (CONFIG_EDRV_MIRROR != FALSE)
+    edrvmirror_exit();
+#endif
+
+    if (edrvInstance_l.pReportFile != NULL)
+        fclose(edrvInstance_l.pReportFile);
+
+    if (edrvInstance_l.pCapture != NULL)
+    {
+        if (edrvInstance_l.pCapture->pFile != NULL)
+            fclose(edrvInstance_l.pCapture->pFile);
+        OPLK_FREE(edrvInstance_l.pCapture);
+    }
+
+    // clear instance structure
+    OPLK_MEMSET(&edrvInstance_l, 0, sizeof(edrvInstance_l));
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send Tx buffer
+
+This function sends the Tx buffer. The frame is not transmitted to a network,
+the Tx handler is called by the worker thread when the frame would have left
+a 100 MBit/s wire.
+
+\param  pBuffer_p           Tx buffer descriptor
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    tEdrvReplayTxEvent*     pEvent;
+    tEdrvReplayTxEvent**    ppEvent;
+    UINT64                  txStartTime;
+
+    FTRACE_MARKER("%s", __func__);
+
+    if (pBuffer_p->txBufferNumber.pArg != NULL)
+        return kErrorInvalidOperation;
+
+    pthread_mutex_lock(&edrvInstance_l.mutex);
+
+    pEvent = edrvInstance_l.pFreeTxEvents;
+    if (pEvent == NULL)
+    {
+        pthread_mutex_unlock(&edrvInstance_l.mutex);
+        return kErrorEdrvNoFreeTxDesc;
+    }
+    edrvInstance_l.pFreeTxEvents = pEvent->pNext;
+
+    // the frame occupies the wire after the frames which are already in flight
+    txStartTime = getTimeNs();
+    if (txStartTime < edrvInstance_l.wireFreeTime)
+        txStartTime = edrvInstance_l.wireFreeTime;
+
+    pEvent->dueTime = txStartTime + getWireTime(pBuffer_p->txFrameSize);
+    pEvent->pTxBuffer = pBuffer_p;
+    edrvInstance_l.wireFreeTime = pEvent->dueTime;
+    edrvInstance_l.statistics.txFrameCount++;
+
+    // mark buffer as in flight
+    pBuffer_p->txBufferNumber.pArg = pBuffer_p;
+
+    // the due times increase, therefore the event is appended to the queue
+    ppEvent = &edrvInstance_l.pTxQueue;
+    while (*ppEvent != NULL)
+        ppEvent = &(*ppEvent)->pNext;
+    pEvent->pNext = NULL;
+    *ppEvent = pEvent;
+
+    pthread_cond_signal(&edrvInstance_l.eventCond);
+    pthread_mutex_unlock(&edrvInstance_l.mutex);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Allocate Tx buffer
+
+This function allocates a Tx buffer.
+
+\param  pBuffer_p           Tx buffer descriptor
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_allocTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    if (pBuffer_p->maxBufferSize > EDRV_MAX_FRAME_SIZE)
+        return kErrorEdrvNoFreeBufEntry;
+
+    // allocate buffer with malloc
+    pBuffer_p->pBuffer = OPLK_MALLOC(pBuffer_p->maxBufferSize);
+    if (pBuffer_p->pBuffer == NULL)
+        return kErrorEdrvNoFreeBufEntry;
+
+    pBuffer_p->txBufferNumber.pArg = NULL;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Free Tx buffer
+
+This function releases the Tx buffer. A pending completion of the buffer is
+discarded.
+
+\param  pBuffer_p           Tx buffer descriptor
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_freeTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    UINT8*                  pBuffer = pBuffer_p->pBuffer;
+    tEdrvReplayTxEvent**    ppEvent;
+    tEdrvReplayTxEvent*     pEvent;
+
+    pthread_mutex_lock(&edrvInstance_l.mutex);
+    ppEvent = &edrvInstance_l.pTxQueue;
+    while (*ppEvent != NULL)
+    {
+        pEvent = *ppEvent;
+        if (pEvent->pTxBuffer == pBuffer_p)
+        {
+            *ppEvent = pEvent->pNext;
+            pEvent->pNext = edrvInstance_l.pFreeTxEvents;
+            edrvInstance_l.pFreeTxEvents = pEvent;
+        }
+        else
+        {
+            ppEvent = &pEvent->pNext;
+        }
+    }
+
+    // mark buffer as free, before actually freeing it
+    pBuffer_p->pBuffer = NULL;
+    pBuffer_p->txBufferNumber.pArg = NULL;
+    pthread_mutex_unlock(&edrvInstance_l.mutex);
+
+    OPLK_FREE(pBuffer);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Change Rx filter setup
+
+This function changes the Rx filter setup. The parameter entryChanged_p
+selects the Rx filter entry that shall be changed and \p changeFlags_p determines
+the property.
+If \p entryChanged_p is equal or larger count_p all Rx filters shall be changed.
+
+\note Rx filters are not supported by this driver!
+
+\param  pFilter_p           Base pointer of Rx filter array
+\param  count_p             Number of Rx filter array entries
+\param  entryChanged_p      Index of Rx filter entry that shall be changed
+\param  changeFlags_p       Bit mask that selects the changing Rx filter property
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_changeRxFilter(tEdrvFilter* pFilter_p, UINT count_p,
+                               UINT entryChanged_p, UINT changeFlags_p)
+{
+    UNUSED_PARAMETER(pFilter_p);
+    UNUSED_PARAMETER(count_p);
+    UNUSED_PARAMETER(entryChanged_p);
+    UNUSED_PARAMETER(changeFlags_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Clear multicast address entry
+
+This function removes the multicast entry from the Ethernet controller.
+
+\param  pMacAddr_p  Multicast address
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_clearRxMulticastMacAddr(UINT8* pMacAddr_p)
+{
+    UNUSED_PARAMETER(pMacAddr_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set multicast address entry
+
+This function sets a multicast entry into the Ethernet controller.
+
+\param  pMacAddr_p  Multicast address
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_setRxMulticastMacAddr(UINT8* pMacAddr_p)
+{
+    UNUSED_PARAMETER(pMacAddr_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get configuration of the replay
+
+This function returns the current configuration of the replay.
+
+\param  pConfig_p           Pointer to store the configuration.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+void edrvreplay_getConfig(tEdrvReplayConfig* pConfig_p)
+{
+    *pConfig_p = edrvReplayConfig_l;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set configuration of the replay
+
+This function sets the configuration of the replay. It must be called before
+the stack is initialized. The report file name is not copied, it must stay
+valid until the stack is initialized.
+
+\param  pConfig_p           Pointer to the configuration.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The configuration was applied.
+\retval kErrorInvalidOperation  The driver is already initialized.
+\retval kErrorEdrvInvalidParam  The configuration contains invalid values.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrvreplay_setConfig(const tEdrvReplayConfig* pConfig_p)
+{
+    if (edrvInstance_l.pCapture != NULL)
+        return kErrorInvalidOperation;
+
+    if (pConfig_p->localNodeId > C_ADR_BROADCAST)
+        return kErrorEdrvInvalidParam;
+
+    edrvReplayConfig_l = *pConfig_p;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get statistics of the replay
+
+This function returns the counters of the replay since the driver was
+initialized.
+
+\param  pStatistics_p       Pointer to store the statistics.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+void edrvreplay_getStatistics(tEdrvReplayStatistics* pStatistics_p)
+{
+    if (edrvInstance_l.pCapture != NULL)
+        pthread_mutex_lock(&edrvInstance_l.mutex);
+
+    *pStatistics_p = edrvInstance_l.statistics;
+
+    if (edrvInstance_l.pCapture != NULL)
+        pthread_mutex_unlock(&edrvInstance_l.mutex);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get current time
+
+The function returns the current time of the monotonic clock.
+
+\return The function returns the time in ns.
+*/
+//------------------------------------------------------------------------------
+static UINT64 getTimeNs(void)
+{
+    struct timespec     ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((UINT64)ts.tv_sec * 1000000000ULL) + (UINT64)ts.tv_nsec;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get transmission time of a frame
+
+The function returns the time a frame occupies a 100 MBit/s wire.
+
+\param  frameSize_p         Size of the frame without CRC.
+
+\return The function returns the transmission time in ns.
+*/
+//------------------------------------------------------------------------------
+static UINT64 getWireTime(UINT frameSize_p)
+{
+    if (frameSize_p < EDRVREPLAY_MIN_FRAME_SIZE)
+        frameSize_p = EDRVREPLAY_MIN_FRAME_SIZE;
+
+    return (UINT64)(frameSize_p + EDRVREPLAY_WIRE_OVERHEAD) * EDRVREPLAY_WIRE_NS_PER_BYTE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Open capture file
+
+The function opens the capture file and reads the pcap file header. pcapng
+files are detected by their section header block, which is evaluated with the
+following blocks.
+
+\param  pCapture_p          Pointer to the capture reader.
+\param  pFileName_p         Name of the capture file.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError openCapture(tEdrvReplayCapture* pCapture_p, const char* pFileName_p)
+{
+    UINT8       aHeader[EDRVREPLAY_PCAP_HEADER_SIZE];
+    UINT32      magic;
+
+    OPLK_MEMSET(pCapture_p, 0, sizeof(*pCapture_p) - sizeof(pCapture_p->aBlock));
+
+    pCapture_p->pFile = fopen(pFileName_p, "rb");
+    if (pCapture_p->pFile == NULL)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't open capture file %s\n", __func__, pFileName_p);
+        return kErrorEdrvInit;
+    }
+
+    if (fread(aHeader, sizeof(UINT32), 1, pCapture_p->pFile) != 1)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() %s is empty\n", __func__, pFileName_p);
+        return kErrorEdrvInit;
+    }
+
+    magic = ami_getUint32Le(aHeader);
+    if (magic == EDRVREPLAY_PCAPNG_SHB)
+    {
+        // the section header block is read with the first frame
+        pCapture_p->fPcapng = TRUE;
+        rewind(pCapture_p->pFile);
+        return kErrorOk;
+    }
+
+    if ((magic == EDRVREPLAY_PCAP_MAGIC) || (magic == EDRVREPLAY_PCAP_MAGIC_NS))
+    {
+        pCapture_p->fBigEndian = FALSE;
+    }
+    else
+    {
+        magic = ami_getUint32Be(aHeader);
+        if ((magic != EDRVREPLAY_PCAP_MAGIC) && (magic != EDRVREPLAY_PCAP_MAGIC_NS))
+        {
+            DEBUG_LVL_ERROR_TRACE("%s() %s is no pcap or pcapng file\n", __func__, pFileName_p);
+            return kErrorEdrvInit;
+        }
+        pCapture_p->fBigEndian = TRUE;
+    }
+
+    if (fread(&aHeader[sizeof(UINT32)], EDRVREPLAY_PCAP_HEADER_SIZE - sizeof(UINT32), 1,
+              pCapture_p->pFile) != 1)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() %s is truncated\n", __func__, pFileName_p);
+        return kErrorEdrvInit;
+    }
+
+    pCapture_p->tsUnitNs = (magic == EDRVREPLAY_PCAP_MAGIC_NS) ? 1 : 1000;
+    pCapture_p->linkType = (UINT16)getCaptureUint32(pCapture_p, &aHeader[20]);
+    if (pCapture_p->linkType != EDRVREPLAY_LINKTYPE_ETHERNET)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() %s has link type %u instead of Ethernet\n",
+                              __func__, pFileName_p, pCapture_p->linkType);
+        return kErrorEdrvInit;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read frame from capture file
+
+The function reads the next frame of the capture file.
+
+\param  pCapture_p          Pointer to the capture reader.
+\param  pFrame_p            Pointer to store the frame (EDRV_MAX_FRAME_SIZE bytes).
+\param  pFrameSize_p        Pointer to store the size of the frame.
+\param  pTimeStamp_p        Pointer to store the capture timestamp [ns].
+\param  pfInject_p          Pointer to store if the frame can be injected. It
+                            is FALSE for truncated or oversized frames, frames
+                            of other link types and frames which were
+                            transmitted by the capturing node.
+
+\return The function returns TRUE if a frame was read and FALSE at the end of
+        the capture.
+*/
+//------------------------------------------------------------------------------
+static BOOL readFrame(tEdrvReplayCapture* pCapture_p, UINT8* pFrame_p, UINT* pFrameSize_p,
+                      UINT64* pTimeStamp_p, BOOL* pfInject_p)
+{
+    if (pCapture_p->fPcapng)
+        return readPcapngFrame(pCapture_p, pFrame_p, pFrameSize_p, pTimeStamp_p, pfInject_p);
+
+    return readPcapFrame(pCapture_p, pFrame_p, pFrameSize_p, pTimeStamp_p, pfInject_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read frame from pcap file
+
+The function reads the next record of a pcap file.
+
+\param  pCapture_p          Pointer to the capture reader.
+\param  pFrame_p            Pointer to store the frame.
+\param  pFrameSize_p        Pointer to store the size of the frame.
+\param  pTimeStamp_p        Pointer to store the capture timestamp [ns].
+\param  pfInject_p          Pointer to store if the frame can be injected.
+
+\return The function returns TRUE if a frame was read and FALSE at the end of
+        the capture.
+*/
+//------------------------------------------------------------------------------
+static BOOL readPcapFrame(tEdrvReplayCapture* pCapture_p, UINT8* pFrame_p, UINT* pFrameSize_p,
+                          UINT64* pTimeStamp_p, BOOL* pfInject_p)
+{
+    UINT8       aRecord[EDRVREPLAY_PCAP_RECORD_SIZE];
+    UINT32      capturedSize;
+    UINT32      frameSize;
+
+    if (fread(aRecord, sizeof(aRecord), 1, pCapture_p->pFile) != 1)
+        return FALSE;
+
+    *pTimeStamp_p = ((UINT64)getCaptureUint32(pCapture_p, &aRecord[0]) * 1000000000ULL) +
+                    ((UINT64)getCaptureUint32(pCapture_p, &aRecord[4]) * pCapture_p->tsUnitNs);
+    capturedSize = getCaptureUint32(pCapture_p, &aRecord[8]);
+    frameSize = getCaptureUint32(pCapture_p, &aRecord[12]);
+
+    if ((capturedSize != frameSize) || (capturedSize > EDRV_MAX_FRAME_SIZE))
+    {
+        *pfInject_p = FALSE;
+        return (fseek(pCapture_p->pFile, (long)capturedSize, SEEK_CUR) == 0);
+    }
+
+    if (fread(pFrame_p, 1, capturedSize, pCapture_p->pFile) != capturedSize)
+        return FALSE;
+
+    *pFrameSize_p = capturedSize;
+    *pfInject_p = TRUE;
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read frame from pcapng file
+
+The function reads the blocks of a pcapng file until the next packet block.
+Section header and interface description blocks are evaluated, all other
+blocks are skipped.
+
+\param  pCapture_p          Pointer to the capture reader.
+\param  pFrame_p            Pointer to store the frame.
+\param  pFrameSize_p        Pointer to store the size of the frame.
+\param  pTimeStamp_p        Pointer to store the capture timestamp [ns].
+\param  pfInject_p          Pointer to store if the frame can be injected.
+
+\return The function returns TRUE if a frame was read and FALSE at the end of
+        the capture.
+*/
+//------------------------------------------------------------------------------
+static BOOL readPcapngFrame(tEdrvReplayCapture* pCapture_p, UINT8* pFrame_p, UINT* pFrameSize_p,
+                            UINT64* pTimeStamp_p, BOOL* pfInject_p)
+{
+    UINT8*                  pBlock = pCapture_p->aBlock;
+    UINT32                  blockType;
+    UINT32                  blockSize;
+    UINT32                  headerSize;
+    UINT32                  capturedSize;
+    UINT32                  frameSize;
+    UINT32                  interfaceId;
+    tEdrvReplayInterface*   pInterface;
+
+    for (;;)
+    {
+        if (fread(pBlock, 2 * sizeof(UINT32), 1, pCapture_p->pFile) != 1)
+            return FALSE;
+
+        headerSize = 2 * sizeof(UINT32);
+        blockType = getCaptureUint32(pCapture_p, &pBlock[0]);
+        if (blockType == EDRVREPLAY_PCAPNG_SHB)
+        {
+            // the byte order magic determines the byte order of the section
+            if (fread(&pBlock[headerSize], sizeof(UINT32), 1, pCapture_p->pFile) != 1)
+                return FALSE;
+
+            headerSize += sizeof(UINT32);
+            pCapture_p->fBigEndian = (ami_getUint32Be(&pBlock[8]) == EDRVREPLAY_PCAPNG_BYTE_ORDER);
+            pCapture_p->interfaceCount = 0;
+        }
+
+        blockSize = getCaptureUint32(pCapture_p, &pBlock[4]);
+        if ((blockSize < headerSize + sizeof(UINT32)) || ((blockSize & 3) != 0))
+        {
+            DEBUG_LVL_ERROR_TRACE("%s() invalid block size %u\n", __func__, blockSize);
+            return FALSE;
+        }
+
+        if (blockSize > EDRVREPLAY_MAX_BLOCK_SIZE)
+        {
+            if (fseek(pCapture_p->pFile, (long)(blockSize - headerSize), SEEK_CUR) != 0)
+                return FALSE;
+
+            if ((blockType == EDRVREPLAY_PCAPNG_EPB) || (blockType == EDRVREPLAY_PCAPNG_SPB))
+            {   // the frame is larger than any Ethernet frame
+                *pTimeStamp_p = pCapture_p->lastTimeStamp;
+                *pfInject_p = FALSE;
+                return TRUE;
+            }
+            continue;
+        }
+
+        if (fread(&pBlock[headerSize], blockSize - headerSize, 1, pCapture_p->pFile) != 1)
+            return FALSE;
+
+        switch (blockType)
+        {
+            case EDRVREPLAY_PCAPNG_IDB:
+                parseInterfaceBlock(pCapture_p, blockSize);
+                break;
+
+            case EDRVREPLAY_PCAPNG_EPB:
+                if (blockSize < 32)
+                    return FALSE;
+
+                interfaceId = getCaptureUint32(pCapture_p, &pBlock[8]);
+                capturedSize = getCaptureUint32(pCapture_p, &pBlock[20]);
+                frameSize = getCaptureUint32(pCapture_p, &pBlock[24]);
+                if (capturedSize > blockSize - 32)
+                    return FALSE;
+
+                *pfInject_p = TRUE;
+                *pTimeStamp_p = pCapture_p->lastTimeStamp;
+                if (interfaceId >= pCapture_p->interfaceCount)
+                {
+                    *pfInject_p = FALSE;
+                }
+                else
+                {
+                    pInterface = &pCapture_p->aInterface[interfaceId];
+                    *pTimeStamp_p = convertTimeStamp(((UINT64)getCaptureUint32(pCapture_p, &pBlock[12]) << 32) |
+                                                     getCaptureUint32(pCapture_p, &pBlock[16]),
+                                                     pInterface->tsResol);
+                    pCapture_p->lastTimeStamp = *pTimeStamp_p;
+
+                    if ((pInterface->linkType != EDRVREPLAY_LINKTYPE_ETHERNET) ||
+                        ((getEpbFlags(pCapture_p, blockSize, capturedSize) & EDRVREPLAY_PCAPNG_DIR_MASK) ==
+                         EDRVREPLAY_PCAPNG_DIR_OUTBOUND))
+                        *pfInject_p = FALSE;
+                }
+
+                if ((capturedSize != frameSize) || (capturedSize > EDRV_MAX_FRAME_SIZE))
+                    *pfInject_p = FALSE;
+
+                if (*pfInject_p)
+                {
+                    OPLK_MEMCPY(pFrame_p, &pBlock[28], capturedSize);
+                    *pFrameSize_p = capturedSize;
+                }
+                return TRUE;
+
+            case EDRVREPLAY_PCAPNG_SPB:
+                if (blockSize < 16)
+                    return FALSE;
+
+                // simple packet blocks belong to the first interface and have no timestamp
+                frameSize = getCaptureUint32(pCapture_p, &pBlock[8]);
+                *pTimeStamp_p = pCapture_p->lastTimeStamp;
+                *pfInject_p = ((pCapture_p->interfaceCount > 0) &&
+                               (pCapture_p->aInterface[0].linkType == EDRVREPLAY_LINKTYPE_ETHERNET) &&
+                               (frameSize <= blockSize - 16) &&
+                               (frameSize <= EDRV_MAX_FRAME_SIZE));
+                if (*pfInject_p)
+                {
+                    OPLK_MEMCPY(pFrame_p, &pBlock[12], frameSize);
+                    *pFrameSize_p = frameSize;
+                }
+                return TRUE;
+
+            default:
+                // section headers are evaluated above, other blocks are not needed
+                break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parse interface description block
+
+The function stores the link type and the timestamp resolution of an
+interface of the current pcapng section.
+
+\param  pCapture_p          Pointer to the capture reader. The block is in its
+                            block buffer.
+\param  blockSize_p         Size of the block.
+*/
+//------------------------------------------------------------------------------
+static void parseInterfaceBlock(tEdrvReplayCapture* pCapture_p, UINT blockSize_p)
+{
+    UINT8*                  pBlock = pCapture_p->aBlock;
+    tEdrvReplayInterface*   pInterface;
+    UINT                    offset = 16;
+    UINT16                  optionCode;
+    UINT16                  optionSize;
+
+    if ((blockSize_p < 20) || (pCapture_p->interfaceCount >= EDRVREPLAY_MAX_INTERFACES))
+    {   // frames of the interface are skipped
+        pCapture_p->interfaceCount++;
+        return;
+    }
+
+    pInterface = &pCapture_p->aInterface[pCapture_p->interfaceCount++];
+    pInterface->linkType = getCaptureUint16(pCapture_p, &pBlock[8]);
+    pInterface->tsResol = 6;
+
+    while (offset + 4 <= blockSize_p - 4)
+    {
+        optionCode = getCaptureUint16(pCapture_p, &pBlock[offset]);
+        optionSize = getCaptureUint16(pCapture_p, &pBlock[offset + 2]);
+        if ((optionCode == 0) || (offset + 4 + optionSize > blockSize_p - 4))
+            break;
+
+        if ((optionCode == EDRVREPLAY_PCAPNG_OPT_TSRESOL) && (optionSize >= 1))
+            pInterface->tsResol = pBlock[offset + 4];
+
+        offset += 4 + ((optionSize + 3) & ~3U);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get flags of an enhanced packet block
+
+The function searches the option epb_flags of an enhanced packet block.
+
+\param  pCapture_p          Pointer to the capture reader. The block is in its
+                            block buffer.
+\param  blockSize_p         Size of the block.
+\param  capturedSize_p      Captured size of the frame in the block.
+
+\return The function returns the flags or 0 if the block has no flags.
+*/
+//------------------------------------------------------------------------------
+static UINT32 getEpbFlags(tEdrvReplayCapture* pCapture_p, UINT blockSize_p, UINT capturedSize_p)
+{
+    UINT8*      pBlock = pCapture_p->aBlock;
+    UINT        offset = 28 + ((capturedSize_p + 3) & ~3U);
+    UINT16      optionCode;
+    UINT16      optionSize;
+
+    while (offset + 4 <= blockSize_p - 4)
+    {
+        optionCode = getCaptureUint16(pCapture_p, &pBlock[offset]);
+        optionSize = getCaptureUint16(pCapture_p, &pBlock[offset + 2]);
+        if ((optionCode == 0) || (offset + 4 + optionSize > blockSize_p - 4))
+            break;
+
+        if ((optionCode == EDRVREPLAY_PCAPNG_OPT_FLAGS) && (optionSize == sizeof(UINT32)))
+            return getCaptureUint32(pCapture_p, &pBlock[offset + 4]);
+
+        offset += 4 + ((optionSize + 3) & ~3U);
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read 16 bit value of the capture
+
+The function reads a 16 bit value in the byte order of the capture.
+
+\param  pCapture_p          Pointer to the capture reader.
+\param  pData_p             Pointer to the value.
+
+\return The function returns the value.
+*/
+//------------------------------------------------------------------------------
+static UINT16 getCaptureUint16(const tEdrvReplayCapture* pCapture_p, void* pData_p)
+{
+    return pCapture_p->fBigEndian ? ami_getUint16Be(pData_p) : ami_getUint16Le(pData_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read 32 bit value of the capture
+
+The function reads a 32 bit value in the byte order of the capture.
+
+\param  pCapture_p          Pointer to the capture reader.
+\param  pData_p             Pointer to the value.
+
+\return The function returns the value.
+*/
+//------------------------------------------------------------------------------
+static UINT32 getCaptureUint32(const tEdrvReplayCapture* pCapture_p, void* pData_p)
+{
+    return pCapture_p->fBigEndian ? ami_getUint32Be(pData_p) : ami_getUint32Le(pData_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Convert pcapng timestamp
+
+The function converts a pcapng timestamp into ns. The resolution is a
+negative power of 10, or of 2 if its most significant bit is set.
+
+\param  timeStamp_p         Timestamp in units of the resolution.
+\param  tsResol_p           Timestamp resolution (if_tsresol).
+
+\return The function returns the timestamp in ns.
+*/
+//------------------------------------------------------------------------------
+static UINT64 convertTimeStamp(UINT64 timeStamp_p, UINT8 tsResol_p)
+{
+    UINT    exponent = tsResol_p & 0x7F;
+    UINT64  divisor = 1;
+    UINT    i;
+
+    if ((tsResol_p & 0x80) != 0)
+    {
+        if (exponent > 32)
+            return 0;
+
+        return ((timeStamp_p >> exponent) * 1000000000ULL) +
+               (((timeStamp_p & ((1ULL << exponent) - 1)) * 1000000000ULL) >> exponent);
+    }
+
+    if (exponent <= 9)
+    {
+        for (i = exponent; i < 9; i++)
+            timeStamp_p *= 10;
+        return timeStamp_p;
+    }
+
+    for (i = 9; (i < exponent) && (i < 28); i++)
+        divisor *= 10;
+    return timeStamp_p / divisor;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read next frame to inject
+
+The function reads the capture until the next frame which is injected and
+calculates its due time. Frames which are not injected are counted as
+skipped. At the end of the capture the replay is marked as finished. It is
+called by the worker thread without the instance mutex, only the counters
+are updated with the mutex locked.
+
+\param  pInstance_p         Pointer to the driver instance.
+*/
+//------------------------------------------------------------------------------
+static void readNextFrame(tEdrvInstance* pInstance_p)
+{
+    tPlkFrame*  pFrame = (tPlkFrame*)pInstance_p->aRxFrame;
+    UINT64      timeStamp;
+    UINT64      offset;
+    BOOL        fInject;
+    UINT64      skippedCount = 0;
+    UINT64      readCount = 0;
+    BOOL        fFound = FALSE;
+
+    while (readFrame(pInstance_p->pCapture, pInstance_p->aRxFrame, &pInstance_p->rxFrameSize,
+                     &timeStamp, &fInject))
+    {
+        readCount++;
+
+        // frames of the local node are transmitted by the stack itself
+        if (fInject && (edrvReplayConfig_l.localNodeId != 0) &&
+            (pInstance_p->rxFrameSize > PLK_FRAME_OFFSET_SRC_NODEID) &&
+            (ami_getUint16Be(&pFrame->etherType) == C_DLL_ETHERTYPE_EPL) &&
+            (ami_getUint8Le(&pFrame->srcNodeId) == edrvReplayConfig_l.localNodeId))
+            fInject = FALSE;
+
+        if (fInject)
+        {
+            fFound = TRUE;
+            break;
+        }
+
+        skippedCount++;
+    }
+
+    if (fFound)
+    {
+        pInstance_p->frameIndex += readCount - 1;
+        if (pInstance_p->statistics.injectedFrameCount == 0)
+            pInstance_p->firstCaptureTime = timeStamp;
+
+        // timestamps before the first frame are replayed without delay
+        offset = (timeStamp > pInstance_p->firstCaptureTime) ? timeStamp - pInstance_p->firstCaptureTime : 0;
+        pInstance_p->rxCaptureTime = offset;
+        if (edrvReplayConfig_l.speedPercent == 0)
+            pInstance_p->rxDueTime = pInstance_p->startTime;
+        else
+            pInstance_p->rxDueTime = pInstance_p->startTime + ((offset * 100) / edrvReplayConfig_l.speedPercent);
+    }
+
+    if (pInstance_p->hThread != 0)
+        pthread_mutex_lock(&pInstance_p->mutex);
+
+    pInstance_p->statistics.readFrameCount += readCount;
+    pInstance_p->statistics.skippedFrameCount += skippedCount;
+    pInstance_p->fRxPending = fFound;
+    if (!fFound)
+        pInstance_p->statistics.fFinished = TRUE;
+
+    if (pInstance_p->hThread != 0)
+        pthread_mutex_unlock(&pInstance_p->mutex);
+
+    if (!fFound)
+    {
+        DEBUG_LVL_EDRV_TRACE("%s() replay finished: %llu frames injected, %llu skipped\n", __func__,
+                             (unsigned long long)pInstance_p->statistics.injectedFrameCount,
+                             (unsigned long long)pInstance_p->statistics.skippedFrameCount);
+        if (pInstance_p->pReportFile != NULL)
+            fflush(pInstance_p->pReportFile);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Inject pending frame
+
+The function passes the pending frame to the Rx handler of the stack and
+records its processing cost. It is called by the worker thread without the
+instance mutex.
+
+\param  pInstance_p         Pointer to the driver instance.
+*/
+//------------------------------------------------------------------------------
+static void injectFrame(tEdrvInstance* pInstance_p)
+{
+    tPlkFrame*      pFrame = (tPlkFrame*)pInstance_p->aRxFrame;
+    tEdrvRxBuffer   rxBuffer;
+    UINT64          startTime;
+    UINT64          cost;
+#if (CONFIG_EDRV_MIRROR != FALSE)
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    EDRVMIRROR_RECORD_FRAME(pInstance_p->aRxFrame, pInstance_p->rxFrameSize,
+                            ((UINT64)now.tv_sec * 1000000000ULL) + (UINT64)now.tv_nsec,
+                            0);
+#endif
+
+    rxBuffer.bufferInFrame = kEdrvBufferLastInFrame;
+    rxBuffer.rxFrameSize = pInstance_p->rxFrameSize;
+    rxBuffer.pBuffer = pInstance_p->aRxFrame;
+    rxBuffer.pRxTimeStamp = NULL;
+
+    FTRACE_MARKER("%s RX", __func__);
+    startTime = getTimeNs();
+    pInstance_p->initParam.pfnRxHandler(&rxBuffer);
+    cost = getTimeNs() - startTime;
+
+    pthread_mutex_lock(&pInstance_p->mutex);
+    pInstance_p->statistics.injectedFrameCount++;
+    pInstance_p->statistics.totalCostNs += cost;
+    if (cost > pInstance_p->statistics.maxCostNs)
+        pInstance_p->statistics.maxCostNs = cost;
+    pthread_mutex_unlock(&pInstance_p->mutex);
+
+    if (pInstance_p->pReportFile != NULL)
+    {
+        if ((pInstance_p->rxFrameSize > PLK_FRAME_OFFSET_SRC_NODEID) &&
+            (ami_getUint16Be(&pFrame->etherType) == C_DLL_ETHERTYPE_EPL))
+        {
+            fprintf(pInstance_p->pReportFile, "rx,%llu,%llu,0x%02X,%u,%u,%u,%llu,,\n",
+                    (unsigned long long)pInstance_p->frameIndex,
+                    (unsigned long long)pInstance_p->rxCaptureTime,
+                    ami_getUint8Le(&pFrame->messageType),
+                    ami_getUint8Le(&pFrame->srcNodeId),
+                    ami_getUint8Le(&pFrame->dstNodeId),
+                    pInstance_p->rxFrameSize,
+                    (unsigned long long)cost);
+        }
+        else
+        {   // non POWERLINK frame
+            fprintf(pInstance_p->pReportFile, "rx,%llu,%llu,,,,%u,%llu,,\n",
+                    (unsigned long long)pInstance_p->frameIndex,
+                    (unsigned long long)pInstance_p->rxCaptureTime,
+                    pInstance_p->rxFrameSize,
+                    (unsigned long long)cost);
+        }
+    }
+
+    pInstance_p->lastFrameIndex = pInstance_p->frameIndex;
+    pInstance_p->lastCaptureTime = pInstance_p->rxCaptureTime;
+    pInstance_p->frameIndex++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check NMT state of the stack
+
+The function determines the NMT state of the stack from a frame it has
+transmitted and records state changes. SoA and PRes frames of the MN carry its
+state, PRes, StatusResponse and IdentResponse frames of a CN carry the CN
+state. A state change is reported with the last injected frame, so the report
+does not depend on the replay speed. It is called by the worker thread without
+the instance mutex.
+
+\param  pInstance_p         Pointer to the driver instance.
+\param  pFrame_p            Pointer to the transmitted frame.
+\param  frameSize_p         Size of the frame.
+*/
+//------------------------------------------------------------------------------
+static void checkNmtState(tEdrvInstance* pInstance_p, tPlkFrame* pFrame_p, UINT frameSize_p)
+{
+    UINT8       nmtStatus;
+    tNmtState   nmtState;
+
+    if ((frameSize_p < PLK_FRAME_OFFSET_PDO_PAYLOAD) ||
+        (ami_getUint16Be(&pFrame_p->etherType) != C_DLL_ETHERTYPE_EPL))
+        return;
+
+    switch (ami_getUint8Le(&pFrame_p->messageType))
+    {
+        case kMsgTypeSoa:
+            nmtStatus = ami_getUint8Le(&pFrame_p->data.soa.nmtStatus);
+            break;
+
+        case kMsgTypePres:
+            nmtStatus = ami_getUint8Le(&pFrame_p->data.pres.nmtStatus);
+            break;
+
+        case kMsgTypeAsnd:
+            switch (ami_getUint8Le(&pFrame_p->data.asnd.serviceId))
+            {
+                case kDllAsndStatusResponse:
+                    nmtStatus = ami_getUint8Le(&pFrame_p->data.asnd.payload.statusResponse.nmtStatus);
+                    break;
+
+                case kDllAsndIdentResponse:
+                    nmtStatus = ami_getUint8Le(&pFrame_p->data.asnd.payload.identResponse.nmtStatus);
+                    break;
+
+                default:
+                    return;
+            }
+            break;
+
+        default:
+            return;
+    }
+
+    if (ami_getUint8Le(&pFrame_p->srcNodeId) == C_ADR_MN_DEF_NODE_ID)
+        nmtState = (tNmtState)(nmtStatus | NMT_TYPE_MS);
+    else
+        nmtState = (tNmtState)(nmtStatus | NMT_TYPE_CS);
+
+    if (nmtState == pInstance_p->nmtState)
+        return;
+
+    pthread_mutex_lock(&pInstance_p->mutex);
+    pInstance_p->statistics.stateChangeCount++;
+    pthread_mutex_unlock(&pInstance_p->mutex);
+
+    if (pInstance_p->pReportFile != NULL)
+    {
+        if (pInstance_p->statistics.injectedFrameCount == 0)
+        {   // state change before the first frame was injected
+            fprintf(pInstance_p->pReportFile, "state,,,,,,,,0x%03X,0x%03X\n",
+                    pInstance_p->nmtState, nmtState);
+        }
+        else
+        {
+            fprintf(pInstance_p->pReportFile, "state,%llu,%llu,,,,,,0x%03X,0x%03X\n",
+                    (unsigned long long)pInstance_p->lastFrameIndex,
+                    (unsigned long long)pInstance_p->lastCaptureTime,
+                    pInstance_p->nmtState, nmtState);
+        }
+
+        // state changes are rare, they shall not get lost if the process is killed
+        fflush(pInstance_p->pReportFile);
+    }
+
+    pInstance_p->nmtState = nmtState;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Worker thread
+
+This function implements the worker thread of the driver. It calls the
+Tx handlers when the transmitted frames have left the wire and injects the
+frames of the capture at their due times.
+
+\param  pArgument_p     Thread argument (pointer to the driver instance)
+
+\return The function returns a thread error code.
+*/
+//------------------------------------------------------------------------------
+static void* workerThread(void* pArgument_p)
+{
+    tEdrvInstance*          pInstance = (tEdrvInstance*)pArgument_p;
+    tEdrvReplayTxEvent*     pEvent;
+    tEdrvTxBuffer*          pTxBuffer;
+    UINT64                  dueTime;
+    UINT64                  now;
+    struct timespec         timeout;
+#if (CONFIG_EDRV_MIRROR != FALSE)
+    struct timespec         realTime;
+#endif
+
+    DEBUG_LVL_EDRV_TRACE("%s(): ThreadId:%ld\n", __func__, syscall(SYS_gettid));
+
+    /* signal that thread is successfully started */
+    sem_post(&pInstance->syncSem);
+
+    pthread_mutex_lock(&pInstance->mutex);
+    while (!pInstance->fStopThread)
+    {
+        pEvent = pInstance->pTxQueue;
+        if ((pEvent == NULL) && !pInstance->fRxPending)
+        {
+            pthread_cond_wait(&pInstance->eventCond, &pInstance->mutex);
+            continue;
+        }
+
+        dueTime = (pEvent != NULL) ? pEvent->dueTime : pInstance->rxDueTime;
+        if (pInstance->fRxPending && (pInstance->rxDueTime < dueTime))
+            dueTime = pInstance->rxDueTime;
+
+        now = getTimeNs();
+        if (dueTime > now)
+        {
+            timeout.tv_sec = (time_t)(dueTime / 1000000000ULL);
+            timeout.tv_nsec = (long)(dueTime % 1000000000ULL);
+            pthread_cond_timedwait(&pInstance->eventCond, &pInstance->mutex, &timeout);
+            continue;
+        }
+
+        if ((pEvent != NULL) && (pEvent->dueTime <= now))
+        {
+            pInstance->pTxQueue = pEvent->pNext;
+            pTxBuffer = pEvent->pTxBuffer;
+            pEvent->pNext = pInstance->pFreeTxEvents;
+            pInstance->pFreeTxEvents = pEvent;
+            pthread_mutex_unlock(&pInstance->mutex);
+
+            FTRACE_MARKER("%s TX-receive", __func__);
+#if (CONFIG_EDRV_MIRROR != FALSE)
+            clock_gettime(CLOCK_REALTIME, &realTime);
+            EDRVMIRROR_RECORD_FRAME(pTxBuffer->pBuffer, pTxBuffer->txFrameSize,
+                                    ((UINT64)realTime.tv_sec * 1000000000ULL) + (UINT64)realTime.tv_nsec,
+                                    EDRVMIRROR_FLAG_TX);
+#endif
+            checkNmtState(pInstance, (tPlkFrame*)pTxBuffer->pBuffer, pTxBuffer->txFrameSize);
+
+            pTxBuffer->txBufferNumber.pArg = NULL;
+            if (pTxBuffer->pfnTxHandler != NULL)
+                pTxBuffer->pfnTxHandler(pTxBuffer);
+        }
+        else
+        {
+            pthread_mutex_unlock(&pInstance->mutex);
+
+            injectFrame(pInstance);
+            readNextFrame(pInstance);
+        }
+
+        pthread_mutex_lock(&pInstance->mutex);
+    }
+    pthread_mutex_unlock(&pInstance->mutex);
+
+    return NULL;
+}
+
+///\}
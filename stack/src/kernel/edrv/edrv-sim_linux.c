@@ -0,0 +1,1686 @@
+/**
+********************************************************************************
+\file   edrv-sim_linux.c
+
+\brief  Implementation of the simulated Ethernet driver for Linux userspace
+
+This file contains the implementation of a simulated Ethernet driver. Instead
+of an Ethernet interface it attaches the MN to a network of CNs which are
+emulated inside the process. The simulated CNs answer PReq with PRes, Ident
+and Status requests with the corresponding ASnd frames, follow the NMT state
+commands and serve SDO requests with a minimal SDO server. The driver
+thereby allows to measure the boot time, the asynchronous scheduling and the
+cycle load of the MN with any number of CNs on a single machine.
+
+Frames are delivered by a worker thread in the order of their simulated time
+on a 100 MBit/s wire. Response latencies, SDO processing time and frame loss
+are configurable with the CONFIG_EDRV_SIM_xxx options or edrvsim_setConfig().
+Frame loss is generated from a seeded pseudo random sequence, so a run is
+reproducible.
+
+\ingroup module_edrv
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <kernel/edrv.h>
+#include <kernel/edrvmirror.h>
+#include <kernel/edrvsim.h>
+#include <common/target.h>
+#include <common/ami.h>
+#include <oplk/frame.h>
+#include <oplk/nmt.h>
+#include <oplk/dll.h>
+#include <oplk/sdo.h>
+#include <oplk/sdoabortcodes.h>
+
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#ifndef CONFIG_THREAD_PRIORITY_EDRV_RX
+#define CONFIG_THREAD_PRIORITY_EDRV_RX      CONFIG_THREAD_PRIORITY_MEDIUM
+#endif
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define EDRV_MAX_FRAME_SIZE         0x600
+
+#define EDRVSIM_EVENT_COUNT         512                 // Number of frames which can be in flight
+#define EDRVSIM_SDO_QUEUE_SIZE      4                   // Number of pending SDO frames per CN
+#define EDRVSIM_SDO_FRAME_SIZE      64                  // Maximum size of an SDO frame of a CN
+
+#define EDRVSIM_WIRE_NS_PER_BYTE    80                  // Transmission time of a byte at 100 MBit/s
+#define EDRVSIM_WIRE_OVERHEAD       24                  // Preamble, SFD, CRC and inter frame gap in bytes
+#define EDRVSIM_MIN_FRAME_SIZE      60                  // Minimum Ethernet frame size without CRC
+#define EDRVSIM_MIN_PLK_FRAME_SIZE  18                  // POWERLINK header up to the ASnd service ID
+
+#define EDRVSIM_DEVICE_TYPE         0x000F0191          // Default device type of the simulated CNs
+#define EDRVSIM_FEATURE_FLAGS       0x00000025          // Isochronous, SDO by ASnd, extended NMT state commands
+#define EDRVSIM_ASYNC_MTU           300                 // Asynchronous MTU of the simulated CNs
+#define EDRVSIM_PROFILE_VERSION     0x20                // POWERLINK profile version of the simulated CNs
+
+#define EDRVSIM_SDO_STATE_IDLE      0                   // No sequence layer connection
+#define EDRVSIM_SDO_STATE_INIT      1                   // Connection initialization was answered
+#define EDRVSIM_SDO_STATE_CONNECTED 2                   // Connection is established
+
+#define EDRVSIM_SDO_CON_MASK        0x03                // Mask of rcon and scon in the sequence layer header
+#define EDRVSIM_SDO_SEQ_NUM_MASK    0xFC                // Mask of the sequence numbers in the sequence layer header
+#define EDRVSIM_SDO_SEQ_OFFSET      18                  // Offset of the sequence layer header in the frame
+#define EDRVSIM_SDO_CMD_OFFSET      (EDRVSIM_SDO_SEQ_OFFSET + 4)
+#define EDRVSIM_SDO_DATA_OFFSET     (EDRVSIM_SDO_CMD_OFFSET + SDO_CMDL_HDR_FIXED_SIZE)
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief Frame event
+
+The structure describes a frame in flight. It is either the completion of a
+frame transmitted by the MN or a frame of a simulated CN which is delivered to
+the DLL at its due time.
+*/
+typedef struct sEdrvSimEvent
+{
+    struct sEdrvSimEvent*   pNext;                      ///< Next event in the queue or free list
+    UINT64                  dueTime;                    ///< Time when the frame has left the wire [ns]
+    tEdrvTxBuffer*          pTxBuffer;                  ///< Transmitted Tx buffer or NULL for a received frame
+    UINT                    frameSize;                  ///< Size of the received frame
+    UINT8                   aFrame[EDRV_MAX_FRAME_SIZE];    ///< Received frame
+} tEdrvSimEvent;
+
+/**
+\brief Pending SDO frame
+
+The structure contains an SDO frame which a simulated CN sends on the next
+UnspecifiedInvite after its ready time.
+*/
+typedef struct
+{
+    UINT64                  readyTime;                  ///< Time when the frame is ready to be sent [ns]
+    UINT                    frameSize;                  ///< Size of the frame
+    UINT8                   aFrame[EDRVSIM_SDO_FRAME_SIZE]; ///< Frame data
+} tEdrvSimSdoFrame;
+
+/**
+\brief Simulated CN
+
+The structure contains the state of a simulated CN.
+*/
+typedef struct
+{
+    tNmtState               nmtState;                   ///< NMT state of the CN
+    UINT8                   sdoState;                   ///< State of the SDO sequence layer connection
+    UINT8                   sdoRecvSeqNumCon;           ///< Last accepted sequence number of the client with scon
+    UINT8                   sdoSendSeqNumCon;           ///< Own sequence number with rcon
+    tEdrvSimSdoFrame        aSdoQueue[EDRVSIM_SDO_QUEUE_SIZE];  ///< Pending SDO frames
+    UINT                    sdoQueueRead;               ///< Index of the oldest pending SDO frame
+    UINT                    sdoQueueCount;              ///< Number of pending SDO frames
+    tEdrvSimSdoFrame        sdoLastResponse;            ///< Last SDO command response for retransmissions
+} tEdrvSimCn;
+
+// Private structure
+typedef struct
+{
+    tEdrvInitParam          initParam;
+    tEdrvSimEvent*          pEventPool;                 ///< Allocated events
+    tEdrvSimEvent*          pFreeEvents;                ///< List of free events
+    tEdrvSimEvent*          pEventQueue;                ///< Events sorted by their due time
+    UINT64                  wireFreeTime;               ///< Time when the simulated wire becomes idle [ns]
+    UINT32                  randomState;                ///< State of the loss generator
+    tEdrvSimCn              aCn[EDRVSIM_MAX_CN + 1];    ///< Simulated CNs indexed by their node ID
+    tEdrvSimStatistics      statistics;
+    BOOL                    fStopThread;
+    pthread_mutex_t         mutex;
+    pthread_cond_t          eventCond;
+    sem_t                   syncSem;
+    pthread_t               hThread;
+} tEdrvInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tEdrvInstance edrvInstance_l;
+
+static tEdrvSimConfig edrvSimConfig_l =
+{
+    CONFIG_EDRV_SIM_CN_COUNT,
+    CONFIG_EDRV_SIM_PRES_LATENCY_NS,
+    CONFIG_EDRV_SIM_ASND_LATENCY_NS,
+    CONFIG_EDRV_SIM_SDO_DELAY_US,
+    CONFIG_EDRV_SIM_PRES_LOSS_PER_MILLE,
+    CONFIG_EDRV_SIM_SDO_LOSS_PER_MILLE,
+    1,                                  // seed
+    0,                                  // presPayloadSize: echo PReq
+    EDRVSIM_DEVICE_TYPE,
+    0,                                  // vendorId
+    0,                                  // productCode
+    0                                   // revisionNumber
+};
+
+static const UINT8 aSimMacPrefix_l[5] = {0x02, 0x53, 0x49, 0x4D, 0x00};
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static UINT64 getTimeNs(void);
+static UINT64 getWireTime(UINT frameSize_p);
+static BOOL isLost(UINT perMille_p);
+static tEdrvSimEvent* allocEvent(void);
+static void queueEvent(tEdrvSimEvent* pEvent_p);
+static void transmitCnFrame(tEdrvSimEvent* pEvent_p, UINT64 startTime_p);
+static tEdrvSimEvent* createCnFrame(UINT nodeId_p, tMsgType msgType_p, UINT dstNodeId_p,
+                                    UINT frameSize_p);
+static void setupFrameHeader(UINT8* pFrame_p, UINT nodeId_p, tMsgType msgType_p,
+                             UINT dstNodeId_p);
+static void resetCn(tEdrvSimCn* pCn_p);
+static UINT8 getFlag2(const tEdrvSimCn* pCn_p, UINT64 now_p);
+static void processTxFrame(tPlkFrame* pFrame_p, UINT frameSize_p, UINT64 txEndTime_p);
+static void processSoc(void);
+static void processPreq(tPlkFrame* pFrame_p, UINT frameSize_p, UINT64 txEndTime_p);
+static void processSoa(tPlkFrame* pFrame_p, UINT64 txEndTime_p);
+static void processNmtCommand(tPlkFrame* pFrame_p);
+static void executeNmtCommand(tEdrvSimCn* pCn_p, UINT8 nmtCommand_p);
+static void processSdo(tPlkFrame* pFrame_p, UINT frameSize_p, UINT64 txEndTime_p);
+static BOOL processSdoCommand(tEdrvSimCn* pCn_p, UINT nodeId_p, UINT mnNodeId_p,
+                              tAsySdoCom* pCommand_p, UINT commandSize_p,
+                              UINT64 readyTime_p);
+static void queueSdoFrame(tEdrvSimCn* pCn_p, UINT nodeId_p, UINT mnNodeId_p,
+                          tAsySdoCom* pCommand_p, UINT commandSize_p,
+                          UINT64 readyTime_p);
+static BOOL readSimObject(UINT nodeId_p, UINT index_p, UINT subIndex_p, UINT32* pValue_p,
+                          UINT* pSize_p);
+static void* workerThread(void* pArgument_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Ethernet driver initialization
+
+This function initializes the Ethernet driver. The device name of the
+hardware parameters is not used, the driver attaches the MN to the simulated
+network.
+
+\param  pEdrvInitParam_p    Edrv initialization parameters
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_init(tEdrvInitParam* pEdrvInitParam_p)
+{
+    tOplkError          ret = kErrorOk;
+    pthread_condattr_t  condAttr;
+    UINT                nodeId;
+    UINT                i;
+
+    // clear instance structure
+    OPLK_MEMSET(&edrvInstance_l, 0, sizeof(edrvInstance_l));
+
+    /* if no MAC address was specified use a locally administered address
+     * which is built like the addresses of the simulated CNs
+     */
+    if ((pEdrvInitParam_p->aMacAddr[0] == 0) &&
+        (pEdrvInitParam_p->aMacAddr[1] == 0) &&
+        (pEdrvInitParam_p->aMacAddr[2] == 0) &&
+        (pEdrvInitParam_p->aMacAddr[3] == 0) &&
+        (pEdrvInitParam_p->aMacAddr[4] == 0) &&
+        (pEdrvInitParam_p->aMacAddr[5] == 0)  )
+    {
+        OPLK_MEMCPY(pEdrvInitParam_p->aMacAddr, aSimMacPrefix_l, sizeof(aSimMacPrefix_l));
+        pEdrvInitParam_p->aMacAddr[5] = C_ADR_MN_DEF_NODE_ID;
+    }
+
+    // save the init data (with updated MAC address)
+    edrvInstance_l.initParam = *pEdrvInitParam_p;
+    edrvInstance_l.randomState = (edrvSimConfig_l.seed != 0) ? edrvSimConfig_l.seed : 1;
+
+    edrvInstance_l.pEventPool = (tEdrvSimEvent*)OPLK_MALLOC(sizeof(tEdrvSimEvent) * EDRVSIM_EVENT_COUNT);
+    if (edrvInstance_l.pEventPool == NULL)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't allocate event pool\n", __func__);
+        ret = kErrorEdrvInit;
+        goto Exit;
+    }
+
+    for (i = 0; i < EDRVSIM_EVENT_COUNT; i++)
+    {
+        edrvInstance_l.pEventPool[i].pNext = edrvInstance_l.pFreeEvents;
+        edrvInstance_l.pFreeEvents = &edrvInstance_l.pEventPool[i];
+    }
+
+    for (nodeId = 1; nodeId <= EDRVSIM_MAX_CN; nodeId++)
+        resetCn(&edrvInstance_l.aCn[nodeId]);
+
+    if (pthread_mutex_init(&edrvInstance_l.mutex, NULL) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't init mutex\n", __func__);
+        ret = kErrorEdrvInit;
+        goto Exit;
+    }
+
+    // the due times are based on CLOCK_MONOTONIC, therefore the condition uses it too
+    if ((pthread_condattr_init(&condAttr) != 0) ||
+        (pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC) != 0) ||
+        (pthread_cond_init(&edrvInstance_l.eventCond, &condAttr) != 0))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't init condition\n", __func__);
+        ret = kErrorEdrvInit;
+        goto Exit;
+    }
+    pthread_condattr_destroy(&condAttr);
+
+    if (sem_init(&edrvInstance_l.syncSem, 0, 0) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't init semaphore\n", __func__);
+        ret = kErrorEdrvInit;
+        goto Exit;
+    }
+
+#if (CONFIG_EDRV_MIRROR != FALSE)
+    // the driver works without mirror ring, therefore errors are ignored
+    edrvmirror_init();
+#endif
+
+    if (target_createThread(&edrvInstance_l.hThread, kThreadRoleEdrvRx, "oplk-edrvsim",
+                            workerThread, &edrvInstance_l) != kErrorOk)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Couldn't create worker thread!\n", __func__);
+        ret = kErrorEdrvInit;
+        goto Exit;
+    }
+
+    if (target_setThreadParams(edrvInstance_l.hThread, kThreadRoleEdrvRx, kThreadSchedFifo,
+                               CONFIG_THREAD_PRIORITY_EDRV_RX,
+                               CONFIG_THREAD_CPU_MASK_EDRV_RX) != kErrorOk)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't set thread scheduling parameters!\n",
+                                __func__);
+    }
+
+    /* wait until thread is started */
+    sem_wait(&edrvInstance_l.syncSem);
+
+    DEBUG_LVL_EDRV_TRACE("%s() simulating %u CNs\n", __func__, edrvSimConfig_l.cnCount);
+
+Exit:
+    if ((ret != kErrorOk) && (edrvInstance_l.pEventPool != NULL))
+    {
+        OPLK_FREE(edrvInstance_l.pEventPool);
+        edrvInstance_l.pEventPool = NULL;
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Ethernet driver shutdown
+
+This function shuts down the Ethernet driver.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_shutdown(void)
+{
+    // signal shutdown to the thread
+    pthread_mutex_lock(&edrvInstance_l.mutex);
+    edrvInstance_l.fStopThread = TRUE;
+    pthread_cond_signal(&edrvInstance_l.eventCond);
+    pthread_mutex_unlock(&edrvInstance_l.mutex);
+
+    // wait for thread to terminate
+    pthread_join(edrvInstance_l.hThread, NULL);
+
+    pthread_cond_destroy(&edrvInstance_l.eventCond);
+    pthread_mutex_destroy(&edrvInstance_l.mutex);
+    sem_destroy(&edrvInstance_l.syncSem);
+
+#if (CONFIG_EDRV_MIRROR != FALSE)
+    edrvmirror_exit();
+#endif
+
+    OPLK_FREE(edrvInstance_l.pEventPool);
+
+    // clear instance structure
+    OPLK_MEMSET(&edrvInstance_l, 0, sizeof(edrvInstance_l));
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send Tx buffer
+
+This function sends the Tx buffer. The simulated CNs process the frame
+immediately and schedule their responses. The Tx handler is called by the
+worker thread when the frame has left the simulated wire.
+
+\param  pBuffer_p           Tx buffer descriptor
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    tEdrvSimEvent*  pEvent;
+    UINT64          txStartTime;
+
+    FTRACE_MARKER("%s", __func__);
+
+    if (pBuffer_p->txBufferNumber.pArg != NULL)
+        return kErrorInvalidOperation;
+
+    pthread_mutex_lock(&edrvInstance_l.mutex);
+
+    pEvent = allocEvent();
+    if (pEvent == NULL)
+    {
+        pthread_mutex_unlock(&edrvInstance_l.mutex);
+        return kErrorEdrvNoFreeTxDesc;
+    }
+
+    // the frame occupies the wire after the frames which are already in flight
+    txStartTime = getTimeNs();
+    if (txStartTime < edrvInstance_l.wireFreeTime)
+        txStartTime = edrvInstance_l.wireFreeTime;
+
+    pEvent->dueTime = txStartTime + getWireTime(pBuffer_p->txFrameSize);
+    pEvent->pTxBuffer = pBuffer_p;
+    edrvInstance_l.wireFreeTime = pEvent->dueTime;
+    edrvInstance_l.statistics.txFrameCount++;
+
+    // mark buffer as in flight
+    pBuffer_p->txBufferNumber.pArg = pBuffer_p;
+    queueEvent(pEvent);
+
+    processTxFrame((tPlkFrame*)pBuffer_p->pBuffer, pBuffer_p->txFrameSize,
+                   pEvent->dueTime);
+
+    pthread_mutex_unlock(&edrvInstance_l.mutex);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Allocate Tx buffer
+
+This function allocates a Tx buffer.
+
+\param  pBuffer_p           Tx buffer descriptor
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_allocTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    if (pBuffer_p->maxBufferSize > EDRV_MAX_FRAME_SIZE)
+        return kErrorEdrvNoFreeBufEntry;
+
+    // allocate buffer with malloc
+    pBuffer_p->pBuffer = OPLK_MALLOC(pBuffer_p->maxBufferSize);
+    if (pBuffer_p->pBuffer == NULL)
+        return kErrorEdrvNoFreeBufEntry;
+
+    pBuffer_p->txBufferNumber.pArg = NULL;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Free Tx buffer
+
+This function releases the Tx buffer. A pending completion of the buffer is
+discarded.
+
+\param  pBuffer_p           Tx buffer descriptor
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_freeTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    UINT8*          pBuffer = pBuffer_p->pBuffer;
+    tEdrvSimEvent** ppEvent;
+    tEdrvSimEvent*  pEvent;
+
+    pthread_mutex_lock(&edrvInstance_l.mutex);
+    ppEvent = &edrvInstance_l.pEventQueue;
+    while (*ppEvent != NULL)
+    {
+        pEvent = *ppEvent;
+        if (pEvent->pTxBuffer == pBuffer_p)
+        {
+            *ppEvent = pEvent->pNext;
+            pEvent->pNext = edrvInstance_l.pFreeEvents;
+            edrvInstance_l.pFreeEvents = pEvent;
+        }
+        else
+        {
+            ppEvent = &pEvent->pNext;
+        }
+    }
+
+    // mark buffer as free, before actually freeing it
+    pBuffer_p->pBuffer = NULL;
+    pBuffer_p->txBufferNumber.pArg = NULL;
+    pthread_mutex_unlock(&edrvInstance_l.mutex);
+
+    OPLK_FREE(pBuffer);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Change Rx filter setup
+
+This function changes the Rx filter setup. The parameter entryChanged_p
+selects the Rx filter entry that shall be changed and \p changeFlags_p determines
+the property.
+If \p entryChanged_p is equal or larger count_p all Rx filters shall be changed.
+
+\note Rx filters are not supported by this driver!
+
+\param  pFilter_p           Base pointer of Rx filter array
+\param  count_p             Number of Rx filter array entries
+\param  entryChanged_p      Index of Rx filter entry that shall be changed
+\param  changeFlags_p       Bit mask that selects the changing Rx filter property
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_changeRxFilter(tEdrvFilter* pFilter_p, UINT count_p,
+                               UINT entryChanged_p, UINT changeFlags_p)
+{
+    UNUSED_PARAMETER(pFilter_p);
+    UNUSED_PARAMETER(count_p);
+    UNUSED_PARAMETER(entryChanged_p);
+    UNUSED_PARAMETER(changeFlags_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Clear multicast address entry
+
+This function removes the multicast entry from the Ethernet controller.
+
+\param  pMacAddr_p  Multicast address
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_clearRxMulticastMacAddr(UINT8* pMacAddr_p)
+{
+    UNUSED_PARAMETER(pMacAddr_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set multicast address entry
+
+This function sets a multicast entry into the Ethernet controller.
+
+\param  pMacAddr_p  Multicast address
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_setRxMulticastMacAddr(UINT8* pMacAddr_p)
+{
+    UNUSED_PARAMETER(pMacAddr_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get configuration of the simulated network
+
+This function returns the current configuration of the simulated network.
+
+\param  pConfig_p           Pointer to store the configuration.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+void edrvsim_getConfig(tEdrvSimConfig* pConfig_p)
+{
+    *pConfig_p = edrvSimConfig_l;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set configuration of the simulated network
+
+This function sets the configuration of the simulated network. It should be
+called before the stack is initialized. If it is called later, the new
+latencies and loss rates apply to the following frames and CNs which are
+added to the network start in state NotActive.
+
+\param  pConfig_p           Pointer to the configuration.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The configuration was applied.
+\retval kErrorEdrvInvalidParam  The configuration contains invalid values.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrvsim_setConfig(const tEdrvSimConfig* pConfig_p)
+{
+    if ((pConfig_p->cnCount > EDRVSIM_MAX_CN) ||
+        (pConfig_p->presLossPerMille > 1000) ||
+        (pConfig_p->sdoLossPerMille > 1000) ||
+        (pConfig_p->presPayloadSize > (EDRV_MAX_FRAME_SIZE - PLK_FRAME_OFFSET_PDO_PAYLOAD)))
+        return kErrorEdrvInvalidParam;
+
+    if (edrvInstance_l.pEventPool != NULL)
+        pthread_mutex_lock(&edrvInstance_l.mutex);
+
+    edrvSimConfig_l = *pConfig_p;
+
+    if (edrvInstance_l.pEventPool != NULL)
+        pthread_mutex_unlock(&edrvInstance_l.mutex);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get statistics of the simulated network
+
+This function returns the frame counters of the simulated network since the
+driver was initialized.
+
+\param  pStatistics_p       Pointer to store the statistics.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+void edrvsim_getStatistics(tEdrvSimStatistics* pStatistics_p)
+{
+    if (edrvInstance_l.pEventPool != NULL)
+        pthread_mutex_lock(&edrvInstance_l.mutex);
+
+    *pStatistics_p = edrvInstance_l.statistics;
+
+    if (edrvInstance_l.pEventPool != NULL)
+        pthread_mutex_unlock(&edrvInstance_l.mutex);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get current time
+
+The function returns the current time of the monotonic clock.
+
+\return The function returns the time in ns.
+*/
+//------------------------------------------------------------------------------
+static UINT64 getTimeNs(void)
+{
+    struct timespec     ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((UINT64)ts.tv_sec * 1000000000ULL) + (UINT64)ts.tv_nsec;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get transmission time of a frame
+
+The function returns the time a frame occupies the simulated 100 MBit/s wire.
+
+\param  frameSize_p         Size of the frame without CRC.
+
+\return The function returns the transmission time in ns.
+*/
+//------------------------------------------------------------------------------
+static UINT64 getWireTime(UINT frameSize_p)
+{
+    if (frameSize_p < EDRVSIM_MIN_FRAME_SIZE)
+        frameSize_p = EDRVSIM_MIN_FRAME_SIZE;
+
+    return (UINT64)(frameSize_p + EDRVSIM_WIRE_OVERHEAD) * EDRVSIM_WIRE_NS_PER_BYTE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Decide whether a frame is lost
+
+The function draws the next number of the xorshift sequence of the loss
+generator and decides whether a frame is lost.
+
+\param  perMille_p          Loss probability [1/1000].
+
+\return The function returns TRUE if the frame is lost.
+*/
+//------------------------------------------------------------------------------
+static BOOL isLost(UINT perMille_p)
+{
+    UINT32  x;
+
+    if (perMille_p == 0)
+        return FALSE;
+
+    x = edrvInstance_l.randomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    edrvInstance_l.randomState = x;
+
+    return ((x % 1000) < perMille_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Allocate frame event
+
+The function takes an event from the free list. It must be called with the
+instance mutex locked.
+
+\return The function returns a pointer to the event or NULL if no event is free.
+*/
+//------------------------------------------------------------------------------
+static tEdrvSimEvent* allocEvent(void)
+{
+    tEdrvSimEvent*  pEvent = edrvInstance_l.pFreeEvents;
+
+    if (pEvent == NULL)
+    {
+        edrvInstance_l.statistics.overrunCount++;
+        return NULL;
+    }
+
+    edrvInstance_l.pFreeEvents = pEvent->pNext;
+    pEvent->pNext = NULL;
+    pEvent->pTxBuffer = NULL;
+    pEvent->frameSize = 0;
+
+    return pEvent;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Queue frame event
+
+The function inserts the event into the queue sorted by the due time. Events
+with equal due times keep their order. It must be called with the instance
+mutex locked.
+
+\param  pEvent_p            Event to be queued.
+*/
+//------------------------------------------------------------------------------
+static void queueEvent(tEdrvSimEvent* pEvent_p)
+{
+    tEdrvSimEvent** ppEvent = &edrvInstance_l.pEventQueue;
+
+    while ((*ppEvent != NULL) && ((*ppEvent)->dueTime <= pEvent_p->dueTime))
+        ppEvent = &(*ppEvent)->pNext;
+
+    pEvent_p->pNext = *ppEvent;
+    *ppEvent = pEvent_p;
+
+    // wake up the worker thread if the next due time changed
+    if (edrvInstance_l.pEventQueue == pEvent_p)
+        pthread_cond_signal(&edrvInstance_l.eventCond);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Transmit frame of a simulated CN
+
+The function schedules the frame of a simulated CN. The frame starts not
+before the given time and not before the wire is idle.
+
+\param  pEvent_p            Event containing the frame.
+\param  startTime_p         Earliest start of the transmission [ns].
+*/
+//------------------------------------------------------------------------------
+static void transmitCnFrame(tEdrvSimEvent* pEvent_p, UINT64 startTime_p)
+{
+    if (startTime_p < edrvInstance_l.wireFreeTime)
+        startTime_p = edrvInstance_l.wireFreeTime;
+
+    pEvent_p->dueTime = startTime_p + getWireTime(pEvent_p->frameSize);
+    edrvInstance_l.wireFreeTime = pEvent_p->dueTime;
+    edrvInstance_l.statistics.rxFrameCount++;
+
+    queueEvent(pEvent_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Create frame of a simulated CN
+
+The function allocates an event and sets up the Ethernet and POWERLINK header
+of a frame sent by a simulated CN. The rest of the frame is cleared.
+
+\param  nodeId_p            Node ID of the simulated CN.
+\param  msgType_p           POWERLINK message type.
+\param  dstNodeId_p         Destination node ID.
+\param  frameSize_p         Size of the frame without padding.
+
+\return The function returns a pointer to the event or NULL if no event is free.
+*/
+//------------------------------------------------------------------------------
+static tEdrvSimEvent* createCnFrame(UINT nodeId_p, tMsgType msgType_p, UINT dstNodeId_p,
+                                    UINT frameSize_p)
+{
+    tEdrvSimEvent*  pEvent = allocEvent();
+
+    if (pEvent == NULL)
+        return NULL;
+
+    if (frameSize_p < EDRVSIM_MIN_FRAME_SIZE)
+        frameSize_p = EDRVSIM_MIN_FRAME_SIZE;
+
+    OPLK_MEMSET(pEvent->aFrame, 0, frameSize_p);
+    pEvent->frameSize = frameSize_p;
+    setupFrameHeader(pEvent->aFrame, nodeId_p, msgType_p, dstNodeId_p);
+
+    return pEvent;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set up frame header
+
+The function sets up the Ethernet and POWERLINK header of a frame sent by a
+simulated CN. PRes and ASnd frames to the broadcast address use the
+corresponding multicast MAC addresses, other frames are addressed to the MN.
+
+\param  pFrame_p            Pointer to the frame.
+\param  nodeId_p            Node ID of the simulated CN.
+\param  msgType_p           POWERLINK message type.
+\param  dstNodeId_p         Destination node ID.
+*/
+//------------------------------------------------------------------------------
+static void setupFrameHeader(UINT8* pFrame_p, UINT nodeId_p, tMsgType msgType_p,
+                             UINT dstNodeId_p)
+{
+    tPlkFrame*  pFrame = (tPlkFrame*)pFrame_p;
+
+    if (msgType_p == kMsgTypePres)
+        ami_setUint48Be(pFrame->aDstMac, C_DLL_MULTICAST_PRES);
+    else if (dstNodeId_p == C_ADR_BROADCAST)
+        ami_setUint48Be(pFrame->aDstMac, C_DLL_MULTICAST_ASND);
+    else
+        OPLK_MEMCPY(pFrame->aDstMac, edrvInstance_l.initParam.aMacAddr, 6);
+
+    OPLK_MEMCPY(pFrame->aSrcMac, aSimMacPrefix_l, sizeof(aSimMacPrefix_l));
+    pFrame->aSrcMac[5] = (UINT8)nodeId_p;
+    ami_setUint16Be(&pFrame->etherType, C_DLL_ETHERTYPE_EPL);
+    ami_setUint8Le(&pFrame->messageType, (UINT8)msgType_p);
+    ami_setUint8Le(&pFrame->dstNodeId, (UINT8)dstNodeId_p);
+    ami_setUint8Le(&pFrame->srcNodeId, (UINT8)nodeId_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Reset simulated CN
+
+The function resets a simulated CN to the state NotActive and closes its SDO
+connection.
+
+\param  pCn_p               Pointer to the simulated CN.
+*/
+//------------------------------------------------------------------------------
+static void resetCn(tEdrvSimCn* pCn_p)
+{
+    pCn_p->nmtState = kNmtCsNotActive;
+    pCn_p->sdoState = EDRVSIM_SDO_STATE_IDLE;
+    pCn_p->sdoQueueRead = 0;
+    pCn_p->sdoQueueCount = 0;
+    pCn_p->sdoLastResponse.frameSize = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get flag 2 of a simulated CN
+
+The function returns the flags PR and RS of a simulated CN. RS counts the SDO
+frames whose processing time has elapsed.
+
+\param  pCn_p               Pointer to the simulated CN.
+\param  now_p               Current simulated time [ns].
+
+\return The function returns flag 2 for PRes, StatusResponse and IdentResponse.
+*/
+//------------------------------------------------------------------------------
+static UINT8 getFlag2(const tEdrvSimCn* pCn_p, UINT64 now_p)
+{
+    UINT    readyCount = 0;
+    UINT    i;
+
+    for (i = 0; i < pCn_p->sdoQueueCount; i++)
+    {
+        if (pCn_p->aSdoQueue[(pCn_p->sdoQueueRead + i) % EDRVSIM_SDO_QUEUE_SIZE].readyTime > now_p)
+            break;
+        readyCount++;
+    }
+
+    if (readyCount == 0)
+        return 0;
+
+    if (readyCount > PLK_FRAME_FLAG2_RS)
+        readyCount = PLK_FRAME_FLAG2_RS;
+
+    return (UINT8)((kDllAsyncReqPrioGeneric << PLK_FRAME_FLAG2_PR_SHIFT) | readyCount);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process frame transmitted by the MN
+
+The function lets the simulated CNs process a frame transmitted by the MN. It
+must be called with the instance mutex locked.
+
+\param  pFrame_p            Pointer to the frame.
+\param  frameSize_p         Size of the frame.
+\param  txEndTime_p         Time when the frame has left the wire [ns].
+*/
+//------------------------------------------------------------------------------
+static void processTxFrame(tPlkFrame* pFrame_p, UINT frameSize_p, UINT64 txEndTime_p)
+{
+    // the stack passes its frames unpadded, the padding is added on the wire
+    if ((frameSize_p < EDRVSIM_MIN_PLK_FRAME_SIZE) ||
+        (ami_getUint16Be(&pFrame_p->etherType) != C_DLL_ETHERTYPE_EPL))
+        return;
+
+    switch (ami_getUint8Le(&pFrame_p->messageType))
+    {
+        case kMsgTypeSoc:
+            processSoc();
+            break;
+
+        case kMsgTypePreq:
+            processPreq(pFrame_p, frameSize_p, txEndTime_p);
+            break;
+
+        case kMsgTypeSoa:
+            processSoa(pFrame_p, txEndTime_p);
+            break;
+
+        case kMsgTypeAsnd:
+            switch (ami_getUint8Le(&pFrame_p->data.asnd.serviceId))
+            {
+                case kDllAsndNmtCommand:
+                    processNmtCommand(pFrame_p);
+                    break;
+
+                case kDllAsndSdo:
+                    processSdo(pFrame_p, frameSize_p, txEndTime_p);
+                    break;
+
+                default:
+                    break;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process SoC
+
+The function processes a SoC. Simulated CNs in NotActive enter PreOperational1
+and CNs in PreOperational1 enter PreOperational2.
+*/
+//------------------------------------------------------------------------------
+static void processSoc(void)
+{
+    UINT        nodeId;
+    tEdrvSimCn* pCn;
+
+    for (nodeId = 1; nodeId <= edrvSimConfig_l.cnCount; nodeId++)
+    {
+        pCn = &edrvInstance_l.aCn[nodeId];
+        if (pCn->nmtState == kNmtCsPreOperational1)
+            pCn->nmtState = kNmtCsPreOperational2;
+        else if (pCn->nmtState == kNmtCsNotActive)
+            pCn->nmtState = kNmtCsPreOperational1;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process PReq
+
+The function answers a PReq with a PRes if the addressed CN is simulated and
+in an isochronous NMT state. The PRes echoes the payload of the PReq.
+
+\param  pFrame_p            Pointer to the PReq.
+\param  frameSize_p         Size of the PReq.
+\param  txEndTime_p         Time when the PReq has left the wire [ns].
+*/
+//------------------------------------------------------------------------------
+static void processPreq(tPlkFrame* pFrame_p, UINT frameSize_p, UINT64 txEndTime_p)
+{
+    UINT            nodeId = ami_getUint8Le(&pFrame_p->dstNodeId);
+    tEdrvSimCn*     pCn;
+    tEdrvSimEvent*  pEvent;
+    tPlkFrame*      pPres;
+    UINT            preqSize;
+    UINT            presSize;
+    UINT8           flag1;
+
+    if ((nodeId == 0) || (nodeId > edrvSimConfig_l.cnCount) ||
+        (frameSize_p < PLK_FRAME_OFFSET_PDO_PAYLOAD))
+        return;
+
+    pCn = &edrvInstance_l.aCn[nodeId];
+    if ((pCn->nmtState != kNmtCsPreOperational2) &&
+        (pCn->nmtState != kNmtCsReadyToOperate) &&
+        (pCn->nmtState != kNmtCsOperational))
+        return;
+
+    if (isLost(edrvSimConfig_l.presLossPerMille))
+    {
+        edrvInstance_l.statistics.presLossCount++;
+        return;
+    }
+
+    preqSize = ami_getUint16Le(&pFrame_p->data.preq.sizeLe);
+    if (preqSize > (frameSize_p - PLK_FRAME_OFFSET_PDO_PAYLOAD))
+        preqSize = frameSize_p - PLK_FRAME_OFFSET_PDO_PAYLOAD;
+
+    presSize = (edrvSimConfig_l.presPayloadSize != 0) ? edrvSimConfig_l.presPayloadSize : preqSize;
+
+    pEvent = createCnFrame(nodeId, kMsgTypePres, C_ADR_BROADCAST,
+                           PLK_FRAME_OFFSET_PDO_PAYLOAD + presSize);
+    if (pEvent == NULL)
+        return;
+
+    pPres = (tPlkFrame*)pEvent->aFrame;
+    flag1 = ami_getUint8Le(&pFrame_p->data.preq.flag1) & PLK_FRAME_FLAG1_MS;
+    if (pCn->nmtState == kNmtCsOperational)
+        flag1 |= PLK_FRAME_FLAG1_RD;
+
+    ami_setUint8Le(&pPres->data.pres.nmtStatus, (UINT8)pCn->nmtState);
+    ami_setUint8Le(&pPres->data.pres.flag1, flag1);
+    ami_setUint8Le(&pPres->data.pres.flag2, getFlag2(pCn, txEndTime_p));
+    ami_setUint8Le(&pPres->data.pres.pdoVersion, ami_getUint8Le(&pFrame_p->data.preq.pdoVersion));
+    ami_setUint16Le(&pPres->data.pres.sizeLe, (UINT16)presSize);
+    OPLK_MEMCPY(&pEvent->aFrame[PLK_FRAME_OFFSET_PDO_PAYLOAD],
+                &((UINT8*)pFrame_p)[PLK_FRAME_OFFSET_PDO_PAYLOAD],
+                (preqSize < presSize) ? preqSize : presSize);
+
+    transmitCnFrame(pEvent, txEndTime_p + edrvSimConfig_l.presLatencyNs);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process SoA
+
+The function processes a SoA. Simulated CNs in NotActive enter
+PreOperational1. If the SoA invites a simulated CN, the CN sends an
+IdentResponse, a StatusResponse or its next pending SDO frame.
+
+\param  pFrame_p            Pointer to the SoA.
+\param  txEndTime_p         Time when the SoA has left the wire [ns].
+*/
+//------------------------------------------------------------------------------
+static void processSoa(tPlkFrame* pFrame_p, UINT64 txEndTime_p)
+{
+    UINT                nodeId;
+    tEdrvSimCn*         pCn;
+    tEdrvSimEvent*      pEvent = NULL;
+    tPlkFrame*          pAsnd;
+    tEdrvSimSdoFrame*   pSdoFrame;
+    UINT8               serviceId;
+
+    for (nodeId = 1; nodeId <= edrvSimConfig_l.cnCount; nodeId++)
+    {
+        if (edrvInstance_l.aCn[nodeId].nmtState == kNmtCsNotActive)
+            edrvInstance_l.aCn[nodeId].nmtState = kNmtCsPreOperational1;
+    }
+
+    nodeId = ami_getUint8Le(&pFrame_p->data.soa.reqServiceTarget);
+    if ((nodeId == 0) || (nodeId > edrvSimConfig_l.cnCount))
+        return;
+
+    pCn = &edrvInstance_l.aCn[nodeId];
+    serviceId = ami_getUint8Le(&pFrame_p->data.soa.reqServiceId);
+    switch (serviceId)
+    {
+        case kDllReqServiceIdent:
+            pEvent = createCnFrame(nodeId, kMsgTypeAsnd, C_ADR_BROADCAST, C_DLL_MINSIZE_IDENTRES);
+            if (pEvent == NULL)
+                return;
+
+            pAsnd = (tPlkFrame*)pEvent->aFrame;
+            ami_setUint8Le(&pAsnd->data.asnd.serviceId, kDllAsndIdentResponse);
+            ami_setUint8Le(&pAsnd->data.asnd.payload.identResponse.flag2, getFlag2(pCn, txEndTime_p));
+            ami_setUint8Le(&pAsnd->data.asnd.payload.identResponse.nmtStatus, (UINT8)pCn->nmtState);
+            ami_setUint8Le(&pAsnd->data.asnd.payload.identResponse.powerlinkProfileVersion, EDRVSIM_PROFILE_VERSION);
+            ami_setUint32Le(&pAsnd->data.asnd.payload.identResponse.featureFlagsLe, EDRVSIM_FEATURE_FLAGS);
+            ami_setUint16Le(&pAsnd->data.asnd.payload.identResponse.mtuLe, EDRVSIM_ASYNC_MTU);
+            ami_setUint16Le(&pAsnd->data.asnd.payload.identResponse.pollInSizeLe, C_DLL_ISOCHR_MAX_PAYL);
+            ami_setUint16Le(&pAsnd->data.asnd.payload.identResponse.pollOutSizeLe, C_DLL_ISOCHR_MAX_PAYL);
+            ami_setUint32Le(&pAsnd->data.asnd.payload.identResponse.responseTimeLe, edrvSimConfig_l.presLatencyNs);
+            ami_setUint32Le(&pAsnd->data.asnd.payload.identResponse.deviceTypeLe, edrvSimConfig_l.deviceType);
+            ami_setUint32Le(&pAsnd->data.asnd.payload.identResponse.vendorIdLe, edrvSimConfig_l.vendorId);
+            ami_setUint32Le(&pAsnd->data.asnd.payload.identResponse.productCodeLe, edrvSimConfig_l.productCode);
+            ami_setUint32Le(&pAsnd->data.asnd.payload.identResponse.revisionNumberLe, edrvSimConfig_l.revisionNumber);
+            ami_setUint32Le(&pAsnd->data.asnd.payload.identResponse.serialNumberLe, nodeId);
+            break;
+
+        case kDllReqServiceStatus:
+            pEvent = createCnFrame(nodeId, kMsgTypeAsnd, C_ADR_BROADCAST, C_DLL_MINSIZE_STATUSRES);
+            if (pEvent == NULL)
+                return;
+
+            // the exception clear flag follows the exception reset flag of the MN
+            pAsnd = (tPlkFrame*)pEvent->aFrame;
+            ami_setUint8Le(&pAsnd->data.asnd.serviceId, kDllAsndStatusResponse);
+            ami_setUint8Le(&pAsnd->data.asnd.payload.statusResponse.flag1,
+                           ((ami_getUint8Le(&pFrame_p->data.soa.flag1) & PLK_FRAME_FLAG1_ER) != 0) ?
+                           PLK_FRAME_FLAG1_EC : 0);
+            ami_setUint8Le(&pAsnd->data.asnd.payload.statusResponse.flag2, getFlag2(pCn, txEndTime_p));
+            ami_setUint8Le(&pAsnd->data.asnd.payload.statusResponse.nmtStatus, (UINT8)pCn->nmtState);
+            break;
+
+        case kDllReqServiceUnspecified:
+            if (pCn->sdoQueueCount == 0)
+                return;
+
+            pSdoFrame = &pCn->aSdoQueue[pCn->sdoQueueRead];
+            if (pSdoFrame->readyTime > txEndTime_p)
+                return;
+
+            pCn->sdoQueueRead = (pCn->sdoQueueRead + 1) % EDRVSIM_SDO_QUEUE_SIZE;
+            pCn->sdoQueueCount--;
+
+            if (isLost(edrvSimConfig_l.sdoLossPerMille))
+            {
+                edrvInstance_l.statistics.sdoLossCount++;
+                return;
+            }
+
+            pEvent = allocEvent();
+            if (pEvent == NULL)
+                return;
+
+            OPLK_MEMCPY(pEvent->aFrame, pSdoFrame->aFrame, pSdoFrame->frameSize);
+            pEvent->frameSize = pSdoFrame->frameSize;
+            break;
+
+        default:
+            // NMT requests and SyncRequests are not simulated
+            return;
+    }
+
+    transmitCnFrame(pEvent, txEndTime_p + edrvSimConfig_l.asndLatencyNs);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process NMT command
+
+The function applies an NMT state command to the addressed simulated CNs.
+Plain commands address a single CN or all CNs, extended commands address the
+CNs in their node list.
+
+\param  pFrame_p            Pointer to the NMT command frame.
+*/
+//------------------------------------------------------------------------------
+static void processNmtCommand(tPlkFrame* pFrame_p)
+{
+    UINT        dstNodeId = ami_getUint8Le(&pFrame_p->dstNodeId);
+    UINT8       nmtCommand = ami_getUint8Le(&pFrame_p->data.asnd.payload.nmtCommandService.nmtCommandId);
+    UINT8*      pNodeList = pFrame_p->data.asnd.payload.nmtCommandService.aNmtCommandData;
+    UINT        nodeId;
+
+    if ((nmtCommand >= 0x40) && (nmtCommand < 0x60))
+    {   // extended NMT state command, convert to plain command
+        nmtCommand -= 0x20;
+        for (nodeId = 1; nodeId <= edrvSimConfig_l.cnCount; nodeId++)
+        {
+            if ((pNodeList[nodeId >> 3] & (1 << (nodeId & 7))) != 0)
+                executeNmtCommand(&edrvInstance_l.aCn[nodeId], nmtCommand);
+        }
+    }
+    else if (dstNodeId == C_ADR_BROADCAST)
+    {
+        for (nodeId = 1; nodeId <= edrvSimConfig_l.cnCount; nodeId++)
+            executeNmtCommand(&edrvInstance_l.aCn[nodeId], nmtCommand);
+    }
+    else if ((dstNodeId != 0) && (dstNodeId <= edrvSimConfig_l.cnCount))
+    {
+        executeNmtCommand(&edrvInstance_l.aCn[dstNodeId], nmtCommand);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Execute NMT state command
+
+The function changes the NMT state of a simulated CN according to a plain NMT
+state command. Reset commands restart the CN in NotActive.
+
+\param  pCn_p               Pointer to the simulated CN.
+\param  nmtCommand_p        Plain NMT state command.
+*/
+//------------------------------------------------------------------------------
+static void executeNmtCommand(tEdrvSimCn* pCn_p, UINT8 nmtCommand_p)
+{
+    switch (nmtCommand_p)
+    {
+        case 0x21:  // StartNode
+            if (pCn_p->nmtState == kNmtCsReadyToOperate)
+                pCn_p->nmtState = kNmtCsOperational;
+            break;
+
+        case 0x22:  // StopNode
+            if ((pCn_p->nmtState == kNmtCsPreOperational2) ||
+                (pCn_p->nmtState == kNmtCsReadyToOperate) ||
+                (pCn_p->nmtState == kNmtCsOperational))
+                pCn_p->nmtState = kNmtCsStopped;
+            break;
+
+        case 0x23:  // EnterPreOperational2
+            if ((pCn_p->nmtState == kNmtCsOperational) ||
+                (pCn_p->nmtState == kNmtCsStopped))
+                pCn_p->nmtState = kNmtCsPreOperational2;
+            break;
+
+        case 0x24:  // EnableReadyToOperate
+            if (pCn_p->nmtState == kNmtCsPreOperational2)
+                pCn_p->nmtState = kNmtCsReadyToOperate;
+            break;
+
+        case 0x28:  // ResetNode
+        case 0x29:  // ResetCommunication
+        case 0x2A:  // ResetConfiguration
+        case 0x2B:  // SwReset
+            resetCn(pCn_p);
+            break;
+
+        default:
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process SDO frame
+
+The function implements the server side of the SDO sequence layer of a
+simulated CN. It answers the connection initialization, acknowledges the
+frames of the client and passes new commands to processSdoCommand().
+
+\param  pFrame_p            Pointer to the SDO frame.
+\param  frameSize_p         Size of the frame.
+\param  txEndTime_p         Time when the frame has left the wire [ns].
+*/
+//------------------------------------------------------------------------------
+static void processSdo(tPlkFrame* pFrame_p, UINT frameSize_p, UINT64 txEndTime_p)
+{
+    UINT                nodeId = ami_getUint8Le(&pFrame_p->dstNodeId);
+    UINT                mnNodeId = ami_getUint8Le(&pFrame_p->srcNodeId);
+    tAsySdoSeq*         pSeq = &pFrame_p->data.asnd.payload.sdoSequenceFrame;
+    tEdrvSimCn*         pCn;
+    UINT8               recvSeqNumCon;
+    UINT8               sendSeqNumCon;
+    UINT64              readyTime = txEndTime_p + ((UINT64)edrvSimConfig_l.sdoDelayUs * 1000ULL);
+
+    if ((nodeId == 0) || (nodeId > edrvSimConfig_l.cnCount) ||
+        (frameSize_p < EDRVSIM_SDO_CMD_OFFSET))
+        return;
+
+    pCn = &edrvInstance_l.aCn[nodeId];
+    if (pCn->nmtState == kNmtCsNotActive)
+        return;
+
+    recvSeqNumCon = ami_getUint8Le(&pSeq->recvSeqNumCon);
+    sendSeqNumCon = ami_getUint8Le(&pSeq->sendSeqNumCon);
+
+    switch (sendSeqNumCon & EDRVSIM_SDO_CON_MASK)
+    {
+        case 0:
+            // connection closed by the client
+            pCn->sdoState = EDRVSIM_SDO_STATE_IDLE;
+            break;
+
+        case 1:
+            // initialization request (scon = 1, rcon = 0), answer with scon = 1, rcon = 1
+            if ((recvSeqNumCon & EDRVSIM_SDO_CON_MASK) != 0)
+                break;
+
+            pCn->sdoRecvSeqNumCon = sendSeqNumCon;
+            pCn->sdoSendSeqNumCon = (recvSeqNumCon & EDRVSIM_SDO_SEQ_NUM_MASK) | 1;
+            pCn->sdoState = EDRVSIM_SDO_STATE_INIT;
+            queueSdoFrame(pCn, nodeId, mnNodeId, NULL, 0, readyTime);
+            break;
+
+        default:
+            if (pCn->sdoState == EDRVSIM_SDO_STATE_INIT)
+            {   // connection confirmed (scon = 2, rcon = 1), answer with scon = 2, rcon = 2
+                if ((recvSeqNumCon & EDRVSIM_SDO_CON_MASK) != 1)
+                    break;
+
+                pCn->sdoRecvSeqNumCon = (sendSeqNumCon & EDRVSIM_SDO_SEQ_NUM_MASK) | 2;
+                pCn->sdoSendSeqNumCon = (recvSeqNumCon & EDRVSIM_SDO_SEQ_NUM_MASK) | 2;
+                pCn->sdoState = EDRVSIM_SDO_STATE_CONNECTED;
+                queueSdoFrame(pCn, nodeId, mnNodeId, NULL, 0, readyTime);
+                break;
+            }
+
+            if (pCn->sdoState != EDRVSIM_SDO_STATE_CONNECTED)
+                break;
+
+            if ((recvSeqNumCon & EDRVSIM_SDO_CON_MASK) == 3)
+            {   // the client missed the last response, send it again
+                if (pCn->sdoLastResponse.frameSize != 0)
+                {
+                    if (pCn->sdoQueueCount < EDRVSIM_SDO_QUEUE_SIZE)
+                    {
+                        pCn->aSdoQueue[(pCn->sdoQueueRead + pCn->sdoQueueCount) % EDRVSIM_SDO_QUEUE_SIZE] =
+                            pCn->sdoLastResponse;
+                        pCn->aSdoQueue[(pCn->sdoQueueRead + pCn->sdoQueueCount) % EDRVSIM_SDO_QUEUE_SIZE].readyTime =
+                            readyTime;
+                        pCn->sdoQueueCount++;
+                    }
+                }
+            }
+
+            if (((sendSeqNumCon & EDRVSIM_SDO_SEQ_NUM_MASK) ==
+                 ((pCn->sdoRecvSeqNumCon + 4) & EDRVSIM_SDO_SEQ_NUM_MASK)) &&
+                (frameSize_p > EDRVSIM_SDO_DATA_OFFSET))
+            {   // next frame of the client, it carries a command
+                pCn->sdoRecvSeqNumCon = (sendSeqNumCon & EDRVSIM_SDO_SEQ_NUM_MASK) | 2;
+                if (processSdoCommand(pCn, nodeId, mnNodeId, &pSeq->sdoSeqPayload,
+                                      frameSize_p - EDRVSIM_SDO_CMD_OFFSET, readyTime))
+                    break;
+            }
+
+            if ((sendSeqNumCon & EDRVSIM_SDO_CON_MASK) == 3)
+            {   // acknowledge requested
+                queueSdoFrame(pCn, nodeId, mnNodeId, NULL, 0, readyTime);
+            }
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process SDO command
+
+The function implements the SDO command layer of a simulated CN. Write
+commands are accepted without storing the data. ReadByIndex is answered for
+the device type and the identity object, other objects and commands are
+aborted. Segmented transfers are answered after the last segment.
+
+\param  pCn_p               Pointer to the simulated CN.
+\param  nodeId_p            Node ID of the simulated CN.
+\param  mnNodeId_p          Node ID of the SDO client.
+\param  pCommand_p          Pointer to the command layer of the received frame.
+\param  commandSize_p       Size of the command layer including padding.
+\param  readyTime_p         Time when the response is ready [ns].
+
+\return The function returns TRUE if a response was queued.
+*/
+//------------------------------------------------------------------------------
+static BOOL processSdoCommand(tEdrvSimCn* pCn_p, UINT nodeId_p, UINT mnNodeId_p,
+                              tAsySdoCom* pCommand_p, UINT commandSize_p,
+                              UINT64 readyTime_p)
+{
+    tAsySdoCom  response;
+    tAsySdoCom* pResponse = &response;
+    UINT8       flags = ami_getUint8Le(&pCommand_p->flags);
+    UINT8       commandId = ami_getUint8Le(&pCommand_p->commandId);
+    UINT        dataSize = 0;
+    UINT32      abortCode = 0;
+    UINT32      value;
+
+    if ((flags & SDO_CMDL_FLAG_RESPONSE) != 0)
+        return FALSE;
+
+    // intermediate segments are not answered, the data is not stored
+    if (((flags & SDO_CMDL_FLAG_SEGM_MASK) == SDO_CMDL_FLAG_SEGMINIT) ||
+        ((flags & SDO_CMDL_FLAG_SEGM_MASK) == SDO_CMDL_FLAG_SEGMENTED))
+        return FALSE;
+
+    OPLK_MEMSET(&response, 0, sizeof(response));
+    ami_setUint8Le(&pResponse->transactionId, ami_getUint8Le(&pCommand_p->transactionId));
+    ami_setUint8Le(&pResponse->commandId, commandId);
+
+    switch (commandId)
+    {
+        case kSdoServiceWriteByIndex:
+        case kSdoServiceWriteMultiByIndex:
+            break;
+
+        case kSdoServiceReadByIndex:
+            if ((commandSize_p < SDO_CMDL_HDR_FIXED_SIZE + SDO_CMDL_HDR_READBYINDEX_SIZE) ||
+                !readSimObject(nodeId_p, ami_getUint16Le(&pCommand_p->aCommandData[0]),
+                               ami_getUint8Le(&pCommand_p->aCommandData[2]), &value, &dataSize))
+            {
+                abortCode = SDO_AC_OBJECT_NOT_EXIST;
+                break;
+            }
+
+            ami_setUint32Le(&pResponse->aCommandData[0], value);
+            break;
+
+        default:
+            abortCode = SDO_AC_UNKNOWN_COMMAND_SPECIFIER;
+            break;
+    }
+
+    if (abortCode != 0)
+    {
+        ami_setUint8Le(&pResponse->flags, SDO_CMDL_FLAG_RESPONSE | SDO_CMDL_FLAG_ABORT);
+        ami_setUint32Le(&pResponse->aCommandData[0], abortCode);
+        dataSize = sizeof(abortCode);
+    }
+    else
+    {
+        ami_setUint8Le(&pResponse->flags, SDO_CMDL_FLAG_RESPONSE);
+    }
+    ami_setUint16Le(&pResponse->segmentSizeLe, (UINT16)dataSize);
+
+    // a response is a new frame of the server sequence
+    pCn_p->sdoSendSeqNumCon = (UINT8)((pCn_p->sdoSendSeqNumCon + 4) & EDRVSIM_SDO_SEQ_NUM_MASK) | 2;
+    queueSdoFrame(pCn_p, nodeId_p, mnNodeId_p, pResponse, SDO_CMDL_HDR_FIXED_SIZE + dataSize,
+                  readyTime_p);
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Queue SDO frame
+
+The function builds an SDO frame with the current sequence layer header of a
+simulated CN and queues it until the CN is invited. Command responses are
+also kept for retransmissions.
+
+\param  pCn_p               Pointer to the simulated CN.
+\param  nodeId_p            Node ID of the simulated CN.
+\param  mnNodeId_p          Node ID of the SDO client.
+\param  pCommand_p          Pointer to the command layer or NULL for an
+                            acknowledge.
+\param  commandSize_p       Size of the command layer.
+\param  readyTime_p         Time when the frame is ready [ns].
+*/
+//------------------------------------------------------------------------------
+static void queueSdoFrame(tEdrvSimCn* pCn_p, UINT nodeId_p, UINT mnNodeId_p,
+                          tAsySdoCom* pCommand_p, UINT commandSize_p,
+                          UINT64 readyTime_p)
+{
+    tEdrvSimSdoFrame*   pSdoFrame;
+    tPlkFrame*          pFrame;
+    UINT                frameSize = EDRVSIM_SDO_CMD_OFFSET + commandSize_p;
+
+    if (pCn_p->sdoQueueCount >= EDRVSIM_SDO_QUEUE_SIZE)
+    {   // a real CN would stall, the client recovers by its retransmissions
+        edrvInstance_l.statistics.overrunCount++;
+        return;
+    }
+
+    if (frameSize < EDRVSIM_MIN_FRAME_SIZE)
+        frameSize = EDRVSIM_MIN_FRAME_SIZE;
+
+    pSdoFrame = &pCn_p->aSdoQueue[(pCn_p->sdoQueueRead + pCn_p->sdoQueueCount) % EDRVSIM_SDO_QUEUE_SIZE];
+    OPLK_MEMSET(pSdoFrame->aFrame, 0, frameSize);
+    setupFrameHeader(pSdoFrame->aFrame, nodeId_p, kMsgTypeAsnd, mnNodeId_p);
+
+    pFrame = (tPlkFrame*)pSdoFrame->aFrame;
+    ami_setUint8Le(&pFrame->data.asnd.serviceId, kDllAsndSdo);
+    ami_setUint8Le(&pFrame->data.asnd.payload.sdoSequenceFrame.recvSeqNumCon, pCn_p->sdoRecvSeqNumCon);
+    ami_setUint8Le(&pFrame->data.asnd.payload.sdoSequenceFrame.sendSeqNumCon, pCn_p->sdoSendSeqNumCon);
+    if (pCommand_p != NULL)
+        OPLK_MEMCPY(&pSdoFrame->aFrame[EDRVSIM_SDO_CMD_OFFSET], pCommand_p, commandSize_p);
+
+    pSdoFrame->frameSize = frameSize;
+    pSdoFrame->readyTime = readyTime_p;
+    pCn_p->sdoQueueCount++;
+
+    if (pCommand_p != NULL)
+        pCn_p->sdoLastResponse = *pSdoFrame;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read object of a simulated CN
+
+The function returns the value of an object of the simulated CN. Only the
+device type and the identity object are simulated.
+
+\param  nodeId_p            Node ID of the simulated CN.
+\param  index_p             Object index.
+\param  subIndex_p          Object sub-index.
+\param  pValue_p            Pointer to store the value.
+\param  pSize_p             Pointer to store the size of the value.
+
+\return The function returns TRUE if the object exists.
+*/
+//------------------------------------------------------------------------------
+static BOOL readSimObject(UINT nodeId_p, UINT index_p, UINT subIndex_p, UINT32* pValue_p,
+                          UINT* pSize_p)
+{
+    *pSize_p = sizeof(UINT32);
+
+    if ((index_p == 0x1000) && (subIndex_p == 0))
+    {
+        *pValue_p = edrvSimConfig_l.deviceType;
+        return TRUE;
+    }
+
+    if (index_p != 0x1018)
+        return FALSE;
+
+    switch (subIndex_p)
+    {
+        case 0:
+            *pValue_p = 4;
+            *pSize_p = sizeof(UINT8);
+            return TRUE;
+
+        case 1:
+            *pValue_p = edrvSimConfig_l.vendorId;
+            return TRUE;
+
+        case 2:
+            *pValue_p = edrvSimConfig_l.productCode;
+            return TRUE;
+
+        case 3:
+            *pValue_p = edrvSimConfig_l.revisionNumber;
+            return TRUE;
+
+        case 4:
+            *pValue_p = nodeId_p;
+            return TRUE;
+
+        default:
+            return FALSE;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Edrv worker thread
+
+This function is the Edrv worker thread. It waits for the due time of the
+next frame event and calls the Tx handler of transmitted frames or passes the
+frames of the simulated CNs to the DLL. The callbacks of the DLL are therefore
+mutual exclusive like in the pcap driver.
+
+\param  pArgument_p     User specific pointer pointing to the instance structure
+
+\return The function returns a thread error code.
+*/
+//------------------------------------------------------------------------------
+static void* workerThread(void* pArgument_p)
+{
+    tEdrvInstance*  pInstance = (tEdrvInstance*)pArgument_p;
+    tEdrvSimEvent*  pEvent;
+    tEdrvTxBuffer*  pTxBuffer;
+    tEdrvRxBuffer   rxBuffer;
+    struct timespec dueTime;
+#if (CONFIG_EDRV_MIRROR != FALSE)
+    struct timespec now;
+#endif
+
+    DEBUG_LVL_EDRV_TRACE("%s(): ThreadId:%ld\n", __func__, syscall(SYS_gettid));
+
+    /* signal that thread is successfully started */
+    sem_post(&pInstance->syncSem);
+
+    pthread_mutex_lock(&pInstance->mutex);
+    while (!pInstance->fStopThread)
+    {
+        pEvent = pInstance->pEventQueue;
+        if (pEvent == NULL)
+        {
+            pthread_cond_wait(&pInstance->eventCond, &pInstance->mutex);
+            continue;
+        }
+
+        if (pEvent->dueTime > getTimeNs())
+        {
+            dueTime.tv_sec = (time_t)(pEvent->dueTime / 1000000000ULL);
+            dueTime.tv_nsec = (long)(pEvent->dueTime % 1000000000ULL);
+            pthread_cond_timedwait(&pInstance->eventCond, &pInstance->mutex, &dueTime);
+            continue;
+        }
+
+        pInstance->pEventQueue = pEvent->pNext;
+        pTxBuffer = pEvent->pTxBuffer;
+        if (pTxBuffer != NULL)
+        {
+            pTxBuffer->txBufferNumber.pArg = NULL;
+            pEvent->pNext = pInstance->pFreeEvents;
+            pInstance->pFreeEvents = pEvent;
+        }
+        pthread_mutex_unlock(&pInstance->mutex);
+
+#if (CONFIG_EDRV_MIRROR != FALSE)
+        clock_gettime(CLOCK_REALTIME, &now);
+#endif
+
+        if (pTxBuffer != NULL)
+        {
+            FTRACE_MARKER("%s TX-receive", __func__);
+            EDRVMIRROR_RECORD_FRAME(pTxBuffer->pBuffer, pTxBuffer->txFrameSize,
+                                    ((UINT64)now.tv_sec * 1000000000ULL) + (UINT64)now.tv_nsec,
+                                    EDRVMIRROR_FLAG_TX);
+
+            if (pTxBuffer->pfnTxHandler != NULL)
+                pTxBuffer->pfnTxHandler(pTxBuffer);
+        }
+        else
+        {
+            EDRVMIRROR_RECORD_FRAME(pEvent->aFrame, pEvent->frameSize,
+                                    ((UINT64)now.tv_sec * 1000000000ULL) + (UINT64)now.tv_nsec,
+                                    0);
+
+            rxBuffer.bufferInFrame = kEdrvBufferLastInFrame;
+            rxBuffer.rxFrameSize = pEvent->frameSize;
+            rxBuffer.pBuffer = pEvent->aFrame;
+            rxBuffer.pRxTimeStamp = NULL;
+
+            FTRACE_MARKER("%s RX", __func__);
+            pInstance->initParam.pfnRxHandler(&rxBuffer);
+        }
+
+        pthread_mutex_lock(&pInstance->mutex);
+        if (pTxBuffer == NULL)
+        {
+            pEvent->pNext = pInstance->pFreeEvents;
+            pInstance->pFreeEvents = pEvent;
+        }
+    }
+    pthread_mutex_unlock(&pInstance->mutex);
+
+    return NULL;
+}
+
+///\}
@@ -87,6 +87,24 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EDRV_SHIFT                                      150000ULL
 #endif
 
+#if (CONFIG_EDRV_CYCLIC_USE_LEAD_TIME != FALSE)
+#if (EDRV_USE_TTTX == TRUE)
+#error "EdrvCyclic lead time compensation can't be used with EDRV_USE_TTTX"
+#endif
+
+#ifndef EDRV_CYCLIC_LEAD_TIME_MARGIN_US
+#define EDRV_CYCLIC_LEAD_TIME_MARGIN_US                 5       // lead time in addition to the timer latency
+#endif
+
+#ifndef EDRV_CYCLIC_LEAD_TIME_MAX_US
+#define EDRV_CYCLIC_LEAD_TIME_MAX_US                    100     // upper limit of the lead time
+#endif
+
+#ifndef EDRV_CYCLIC_LEAD_TIME_DECAY_SHIFT
+#define EDRV_CYCLIC_LEAD_TIME_DECAY_SHIFT               8       // decay of the timer latency estimation (2^n cycles)
+#endif
+#endif
+
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
@@ -97,6 +115,9 @@ typedef struct
     UINT                    curTxBufferList;
     UINT                    curTxBufferEntry;
     UINT32                  cycleTimeUs;
+#if (CONFIG_EDRV_CYCLIC_USE_LEAD_TIME == FALSE)
+    BOOL                    fCycleTimeChanged;      // the periodic cycle timer must be restarted with the new cycle time
+#endif
     tTimerHdl               timerHdlCycle;
     tTimerHdl               timerHdlSlot;
     tEdrvCyclicCbSync       pfnSyncCb;
@@ -105,6 +126,14 @@ typedef struct
     ULONGLONG               nextCycleTime;
     BOOL                    fNextCycleValid;
 #endif
+#if (CONFIG_EDRV_CYCLIC_USE_LEAD_TIME != FALSE)
+    ULONGLONG               nextCycleTime;          // nominal start time of the next cycle [ns]
+    ULONGLONG               nextSlotTime;           // nominal launch time of the last scheduled frame [ns]
+    ULONGLONG               cycleWakeupTime;        // time the cycle timer is armed for [ns]
+    ULONGLONG               slotWakeupTime;         // time the slot timer is armed for [ns]
+    UINT32                  timerLatency;           // estimated latency of the timers [ns]
+    UINT32                  leadTime;               // time the timers are armed before the launch time [ns]
+#endif
 #if CONFIG_EDRV_CYCLIC_USE_DIAGNOSTICS != FALSE
     UINT                    sampleCount;
     ULONGLONG               startCycleTimeStamp;
@@ -126,6 +155,12 @@ static tOplkError timerHdlCycleCb(tTimerEventArg* pEventArg_p);
 static tOplkError timerHdlSlotCb(tTimerEventArg* pEventArg_p);
 #endif
 static tOplkError processTxBufferList(void);
+#if (CONFIG_EDRV_CYCLIC_USE_LEAD_TIME != FALSE)
+static tOplkError armLeadTimer(tTimerHdl* pTimerHdl_p, ULONGLONG launchTime_p,
+                               tTimerkCallback pfnCallback_p, ULONGLONG* pWakeupTime_p);
+static void       updateLeadTime(ULONGLONG wakeupTime_p, ULONGLONG now_p);
+static void       waitForLaunchTime(tEdrvTxBuffer* pTxBuffer_p, ULONGLONG launchTime_p);
+#endif
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -271,7 +306,9 @@ Exit:
 /**
 \brief  Set cycle time
 
-This function sets the cycle time controlled by the cyclic Edrv.
+This function sets the cycle time controlled by the cyclic Edrv. If the cycles
+are already running, the new cycle time is used from the cycle after the
+current one on.
 
 \param  cycleTimeUs_p   Cycle time [us]
 
@@ -283,6 +320,9 @@ This function sets the cycle time controlled by the cyclic Edrv.
 tOplkError edrvcyclic_setCycleTime(UINT32 cycleTimeUs_p)
 {
     edrvcyclicInstance_l.cycleTimeUs = cycleTimeUs_p;
+#if (CONFIG_EDRV_CYCLIC_USE_LEAD_TIME == FALSE)
+    edrvcyclicInstance_l.fCycleTimeChanged = TRUE;
+#endif
 
     return kErrorOk;
 }
@@ -314,9 +354,19 @@ tOplkError edrvcyclic_startCycle(void)
     OPLK_MEMSET(edrvcyclicInstance_l.ppTxBufferList, 0,
                 sizeof(*edrvcyclicInstance_l.ppTxBufferList) * edrvcyclicInstance_l.maxTxBufferCount * 2);
 
+#if (CONFIG_EDRV_CYCLIC_USE_LEAD_TIME != FALSE)
+    edrvcyclicInstance_l.timerLatency = 0;
+    edrvcyclicInstance_l.leadTime = EDRV_CYCLIC_LEAD_TIME_MARGIN_US * 1000;
+    edrvcyclicInstance_l.nextCycleTime = target_getCurrentTimestamp() +
+                                         (edrvcyclicInstance_l.cycleTimeUs * 1000ULL);
+    ret = armLeadTimer(&edrvcyclicInstance_l.timerHdlCycle, edrvcyclicInstance_l.nextCycleTime,
+                       timerHdlCycleCb, &edrvcyclicInstance_l.cycleWakeupTime);
+#else
+    edrvcyclicInstance_l.fCycleTimeChanged = FALSE;
     ret = hrestimer_modifyTimer(&edrvcyclicInstance_l.timerHdlCycle,
                                 edrvcyclicInstance_l.cycleTimeUs * 1000ULL,
                                 timerHdlCycleCb, 0L, TRUE);
+#endif
 
 #if (EDRV_USE_TTTX == TRUE)
     edrvcyclicInstance_l.fNextCycleValid = FALSE;
@@ -420,6 +470,44 @@ tOplkError edrvcyclic_getDiagnostics(tEdrvCyclicDiagnostics** ppDiagnostics_p)
 }
 #endif
 
+#if (EDRV_USE_TX_BUFFER_LIST == FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Send Tx buffer list
+
+This function sends a list of Tx buffers which are transmitted back-to-back.
+It is the default implementation for Ethernet drivers which can't post a whole
+list at once (EDRV_USE_TX_BUFFER_LIST is FALSE), so the buffers are sent one
+by one with edrv_sendTxBuffer().
+
+\param  ppBuffer_p          Pointer to the list of Tx buffers
+\param  count_p             Number of Tx buffers in the list
+\param  pSentCount_p        Pointer to store the number of Tx buffers which
+                            were sent. If an error occurs, the failing buffer
+                            is ppBuffer_p[*pSentCount_p].
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrv_sendTxBufferList(tEdrvTxBuffer** ppBuffer_p, UINT count_p, UINT* pSentCount_p)
+{
+    tOplkError      ret = kErrorOk;
+    UINT            index;
+
+    for (index = 0; index < count_p; index++)
+    {
+        ret = edrv_sendTxBuffer(ppBuffer_p[index]);
+        if (ret != kErrorOk)
+            break;
+    }
+
+    *pSentCount_p = index;
+    return ret;
+}
+#endif
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -446,6 +534,10 @@ static tOplkError timerHdlCycleCb(tTimerEventArg* pEventArg_p)
     UINT32          spareCycleTime;
     ULONGLONG       startNewCycleTimeStamp;
 #endif
+#if (CONFIG_EDRV_CYCLIC_USE_LEAD_TIME != FALSE)
+    ULONGLONG       now;
+    ULONGLONG       cycleStartTime;
+#endif
 
     if (pEventArg_p->timerHdl != edrvcyclicInstance_l.timerHdlCycle)
     {   // zombie callback
@@ -453,6 +545,39 @@ static tOplkError timerHdlCycleCb(tTimerEventArg* pEventArg_p)
         goto Exit;
     }
 
+#if (CONFIG_EDRV_CYCLIC_USE_LEAD_TIME != FALSE)
+    now = target_getCurrentTimestamp();
+    updateLeadTime(edrvcyclicInstance_l.cycleWakeupTime, now);
+
+    // the cycle timer is a one-shot timer which is re-armed for the next
+    // nominal cycle start, so the lead time doesn't accumulate
+    cycleStartTime = edrvcyclicInstance_l.nextCycleTime;
+    do
+    {
+        edrvcyclicInstance_l.nextCycleTime += (edrvcyclicInstance_l.cycleTimeUs * 1000ULL);
+    } while (edrvcyclicInstance_l.nextCycleTime <= now);
+
+    ret = armLeadTimer(&edrvcyclicInstance_l.timerHdlCycle, edrvcyclicInstance_l.nextCycleTime,
+                       timerHdlCycleCb, &edrvcyclicInstance_l.cycleWakeupTime);
+    if (ret != kErrorOk)
+    {
+        goto Exit;
+    }
+#else
+    if (edrvcyclicInstance_l.fCycleTimeChanged)
+    {   // the cycle time was changed during the previous cycle,
+        // restart the periodic timer at the start of this cycle
+        edrvcyclicInstance_l.fCycleTimeChanged = FALSE;
+        ret = hrestimer_modifyTimer(&edrvcyclicInstance_l.timerHdlCycle,
+                                    edrvcyclicInstance_l.cycleTimeUs * 1000ULL,
+                                    timerHdlCycleCb, 0L, TRUE);
+        if (ret != kErrorOk)
+        {
+            goto Exit;
+        }
+    }
+#endif
+
 #if CONFIG_EDRV_CYCLIC_USE_DIAGNOSTICS != FALSE
     startNewCycleTimeStamp = target_getCurrentTimestamp();
 #endif
@@ -475,6 +600,10 @@ static tOplkError timerHdlCycleCb(tTimerEventArg* pEventArg_p)
         goto Exit;
     }
 
+#if (CONFIG_EDRV_CYCLIC_USE_LEAD_TIME != FALSE)
+    edrvcyclicInstance_l.nextSlotTime = cycleStartTime;
+#endif
+
     ret = processTxBufferList();
     if (ret != kErrorOk)
     {
@@ -603,11 +732,18 @@ static tOplkError timerHdlSlotCb(tTimerEventArg* pEventArg_p)
         goto Exit;
     }
 
+#if (CONFIG_EDRV_CYCLIC_USE_LEAD_TIME != FALSE)
+    updateLeadTime(edrvcyclicInstance_l.slotWakeupTime, target_getCurrentTimestamp());
+#endif
+
 #if CONFIG_EDRV_CYCLIC_USE_DIAGNOSTICS != FALSE
     edrvcyclicInstance_l.lastSlotTimeStamp = target_getCurrentTimestamp();
 #endif
 
     pTxBuffer = edrvcyclicInstance_l.ppTxBufferList[edrvcyclicInstance_l.curTxBufferEntry];
+#if (CONFIG_EDRV_CYCLIC_USE_LEAD_TIME != FALSE)
+    waitForLaunchTime(pTxBuffer, edrvcyclicInstance_l.nextSlotTime);
+#endif
     ret = edrv_sendTxBuffer(pTxBuffer);
     if (ret != kErrorOk)
     {
@@ -643,6 +779,11 @@ static tOplkError processTxBufferList(void)
 {
     tOplkError          ret = kErrorOk;
     tEdrvTxBuffer*      pTxBuffer = NULL;
+#if (CONFIG_EDRV_CYCLIC_USE_LEAD_TIME == FALSE)
+    tEdrvTxBuffer**     ppTxBufferList = &edrvcyclicInstance_l.ppTxBufferList[edrvcyclicInstance_l.curTxBufferEntry];
+    UINT                count = 0;
+    UINT                sentCount;
+#endif
 #if (EDRV_USE_TTTX == TRUE)
     BOOL                fFirstPacket = TRUE;
     UINT64              launchTime;
@@ -650,6 +791,13 @@ static tOplkError processTxBufferList(void)
     UINT64              cycleMax;
     UINT64              currentMacTime = 0;
 #endif
+#if (CONFIG_EDRV_CYCLIC_USE_LEAD_TIME != FALSE)
+    ULONGLONG           launchTime;
+#endif
+
+#if (EDRV_USE_TX_BATCH != FALSE)
+    edrv_beginTxBatch();
+#endif
 
 #if (EDRV_USE_TTTX == TRUE)
     edrv_getMacTime(&currentMacTime);
@@ -672,14 +820,9 @@ static tOplkError processTxBufferList(void)
     cycleMin = launchTime;
     cycleMax = launchTime + (edrvcyclicInstance_l.cycleTimeUs * 1000ULL);
 
-    while ((pTxBuffer = edrvcyclicInstance_l.ppTxBufferList[edrvcyclicInstance_l.curTxBufferEntry]) != NULL)
+    // set the launch times of all frames of the list, they are sent at once
+    while ((pTxBuffer = ppTxBufferList[count]) != NULL)
     {
-        if (pTxBuffer == NULL)
-        {
-            ret = kErrorEdrvBufNotExisting;
-            goto Exit;
-        }
-
         if (fFirstPacket)
         {
             pTxBuffer->launchTime = launchTime ;
@@ -692,47 +835,94 @@ static tOplkError processTxBufferList(void)
         }
 
         if ((pTxBuffer->launchTime - cycleMin) >  (cycleMax - cycleMin))
-        {
+        {   // send the frames which fit into the cycle and report the error
+            pTxBuffer->launchTime = 0;
             ret = kErrorEdrvTxListNotFinishedYet;
-            goto Exit;
+            break;
+        }
+
+        count++;
+    }
+
+    if (count > 0)
+    {
+        tOplkError      sendRet;
+
+        sendRet = edrv_sendTxBufferList(ppTxBufferList, count, &sentCount);
+        for (count = 0; count < sentCount; count++)
+            ppTxBufferList[count]->launchTime = 0;
+
+        edrvcyclicInstance_l.curTxBufferEntry += sentCount;
+        if (sendRet != kErrorOk)
+        {
+            pTxBuffer = ppTxBufferList[sentCount];
+            ret = sendRet;
+        }
+    }
+
+    if (ret != kErrorOk)
+        goto Exit;
+
+#elif (CONFIG_EDRV_CYCLIC_USE_LEAD_TIME != FALSE)
+
+    while ((pTxBuffer = edrvcyclicInstance_l.ppTxBufferList[edrvcyclicInstance_l.curTxBufferEntry]) != NULL)
+    {
+        // the launch times are derived from the nominal cycle start time,
+        // so the latency of the timer callbacks doesn't add up over the cycle
+        launchTime = edrvcyclicInstance_l.nextSlotTime + pTxBuffer->timeOffsetNs;
+        edrvcyclicInstance_l.nextSlotTime = launchTime;
+
+        if (launchTime > target_getCurrentTimestamp() + edrvcyclicInstance_l.leadTime)
+        {
+            ret = armLeadTimer(&edrvcyclicInstance_l.timerHdlSlot, launchTime,
+                               timerHdlSlotCb, &edrvcyclicInstance_l.slotWakeupTime);
+            break;
         }
 
+        // the launch time is too close for the timer
+        waitForLaunchTime(pTxBuffer, launchTime);
         ret = edrv_sendTxBuffer(pTxBuffer);
         if (ret != kErrorOk)
+        {
             goto Exit;
+        }
 
-        pTxBuffer->launchTime = 0;
         edrvcyclicInstance_l.curTxBufferEntry++;
     }
 
 #else
 
-    while ((pTxBuffer = edrvcyclicInstance_l.ppTxBufferList[edrvcyclicInstance_l.curTxBufferEntry]) != NULL)
+    // send all frames which follow each other without delay at once
+    while (((pTxBuffer = ppTxBufferList[count]) != NULL) && (pTxBuffer->timeOffsetNs == 0))
+        count++;
+
+    if (count > 0)
     {
-        if (pTxBuffer->timeOffsetNs == 0)
-        {
-            ret = edrv_sendTxBuffer(pTxBuffer);
-            if (ret != kErrorOk)
-            {
-                goto Exit;
-            }
-        }
-        else
+        ret = edrv_sendTxBufferList(ppTxBufferList, count, &sentCount);
+        edrvcyclicInstance_l.curTxBufferEntry += sentCount;
+        if (ret != kErrorOk)
         {
-            ret = hrestimer_modifyTimer(&edrvcyclicInstance_l.timerHdlSlot,
-                                        pTxBuffer->timeOffsetNs,
-                                        timerHdlSlotCb,
-                                        0L,
-                                        FALSE);
-
-            break;
+            pTxBuffer = ppTxBufferList[sentCount];
+            goto Exit;
         }
+    }
 
-        edrvcyclicInstance_l.curTxBufferEntry++;
+    if (pTxBuffer != NULL)
+    {   // the next frame is sent by the slot timer
+        ret = hrestimer_modifyTimer(&edrvcyclicInstance_l.timerHdlSlot,
+                                    pTxBuffer->timeOffsetNs,
+                                    timerHdlSlotCb,
+                                    0L,
+                                    FALSE);
     }
 #endif
 
 Exit:
+#if (EDRV_USE_TX_BATCH != FALSE)
+    // Transmit all frames which were sent in this list
+    edrv_endTxBatch();
+#endif
+
     if (ret != kErrorOk)
     {
         if (edrvcyclicInstance_l.pfnErrorCb != NULL)
@@ -743,5 +933,120 @@ Exit:
     return ret;
 }
 
+#if (CONFIG_EDRV_CYCLIC_USE_LEAD_TIME != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Arm timer with lead time
+
+This function arms a one-shot timer which expires the current lead time before
+the specified launch time.
+
+\param  pTimerHdl_p     Pointer to timer handle
+\param  launchTime_p    Launch time of the frame [ns]
+\param  pfnCallback_p   Timer callback function
+\param  pWakeupTime_p   Pointer to store the time the timer is armed for
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError armLeadTimer(tTimerHdl* pTimerHdl_p, ULONGLONG launchTime_p,
+                               tTimerkCallback pfnCallback_p, ULONGLONG* pWakeupTime_p)
+{
+    ULONGLONG   now;
+    ULONGLONG   timeout = 0;
+
+    now = target_getCurrentTimestamp();
+    *pWakeupTime_p = launchTime_p - edrvcyclicInstance_l.leadTime;
+    if (*pWakeupTime_p > now)
+    {
+        timeout = *pWakeupTime_p - now;
+    }
+
+    return hrestimer_modifyTimer(pTimerHdl_p, timeout, pfnCallback_p, 0L, FALSE);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update lead time
+
+This function updates the estimation of the timer latency with the delay of a
+timer callback and calculates the lead time from it. The estimation follows
+increasing latencies immediately and decreases slowly.
+
+\param  wakeupTime_p    Time the timer was armed for [ns]
+\param  now_p           Time the timer callback was called [ns]
+*/
+//------------------------------------------------------------------------------
+static void updateLeadTime(ULONGLONG wakeupTime_p, ULONGLONG now_p)
+{
+    UINT32  latency = 0;
+    UINT32  leadTime;
+
+    if (now_p > wakeupTime_p)
+    {
+        latency = (UINT32)min(now_p - wakeupTime_p, EDRV_CYCLIC_LEAD_TIME_MAX_US * 1000ULL);
+    }
+
+    if (latency > edrvcyclicInstance_l.timerLatency)
+    {
+        edrvcyclicInstance_l.timerLatency = latency;
+    }
+    else
+    {
+        edrvcyclicInstance_l.timerLatency -= (edrvcyclicInstance_l.timerLatency - latency) >>
+                                             EDRV_CYCLIC_LEAD_TIME_DECAY_SHIFT;
+    }
+
+    leadTime = edrvcyclicInstance_l.timerLatency + (EDRV_CYCLIC_LEAD_TIME_MARGIN_US * 1000);
+    edrvcyclicInstance_l.leadTime = min(leadTime, EDRV_CYCLIC_LEAD_TIME_MAX_US * 1000);
+
+#if CONFIG_EDRV_CYCLIC_USE_DIAGNOSTICS != FALSE
+    edrvcyclicInstance_l.diagnostics.leadTime = edrvcyclicInstance_l.leadTime;
+    if (edrvcyclicInstance_l.diagnostics.timerLatencyMax < latency)
+    {
+        edrvcyclicInstance_l.diagnostics.timerLatencyMax = latency;
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Wait for launch time of frame
+
+This function prepares a frame for the transmission at its launch time. If the
+Ethernet driver transmits frames at their launch time, the launch time is
+stored in the Tx buffer. Otherwise the function polls the clock until the
+launch time is reached.
+
+\param  pTxBuffer_p     Tx buffer to be sent
+\param  launchTime_p    Launch time of the frame [ns]
+*/
+//------------------------------------------------------------------------------
+static void waitForLaunchTime(tEdrvTxBuffer* pTxBuffer_p, ULONGLONG launchTime_p)
+{
+    ULONGLONG   now;
+
+    now = target_getCurrentTimestamp();
+
+#if CONFIG_EDRV_CYCLIC_USE_DIAGNOSTICS != FALSE
+    if (now > launchTime_p)
+    {
+        edrvcyclicInstance_l.diagnostics.lateFrameCount++;
+    }
+#endif
+
+#if (EDRV_USE_TX_TIME != FALSE)
+    UNUSED_PARAMETER(now);
+    pTxBuffer_p->launchTime = launchTime_p;
+#else
+    UNUSED_PARAMETER(pTxBuffer_p);
+    while (now < launchTime_p)
+    {
+        now = target_getCurrentTimestamp();
+    }
+#endif
+}
+#endif
+
 ///\}
 
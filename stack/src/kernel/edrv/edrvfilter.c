@@ -0,0 +1,435 @@
+/**
+********************************************************************************
+\file   edrvfilter.c
+
+\brief  Software Rx filter of the Ethernet driver
+
+This file contains the software Rx filter which is used by Ethernet drivers
+whose controller cannot filter POWERLINK frames (e.g. edrv-pcap_linux,
+edrv-8139 and edrv-8255x). edrv_changeRxFilter() of the driver compiles the
+Rx filter array of the DLL into a hash table which is keyed on the message
+type, the destination node ID and the source node ID of a frame. A received
+frame is classified by one hash lookup per distinct key mask instead of being
+compared with every filter entry.
+
+\ingroup module_edrv
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <kernel/edrvfilter.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define EDRVFILTER_KEY_OFFSET       14      // offset of the message type, followed by destination and source node ID
+#define EDRVFILTER_COMPARE_SIZE     22      // number of frame bytes covered by a filter entry
+#define EDRVFILTER_KEY_MASK_COUNT   8       // maximum number of distinct key masks in the hash table
+#define EDRVFILTER_HASH_BITS        9
+#define EDRVFILTER_BUCKET_COUNT     (1 << EDRVFILTER_HASH_BITS)
+#define EDRVFILTER_NONE             0xFFFF  // end of a bucket chain
+
+#if (CONFIG_EDRV_SOFT_FILTER_COUNT >= EDRVFILTER_NONE)
+#error "CONFIG_EDRV_SOFT_FILTER_COUNT is too large"
+#endif
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief Entry of the hash table
+
+The entry refers to an enabled filter. The entries of a bucket are chained in
+ascending order of their filter index.
+*/
+typedef struct
+{
+    UINT32              key;            ///< Masked key of the filter, index of its key mask in the upper byte
+    UINT16              filterIndex;    ///< Index of the filter in the filter array
+    UINT16              next;           ///< Next entry of the bucket (EDRVFILTER_NONE = end)
+} tEdrvFilterEntry;
+
+/**
+\brief Instance of the software Rx filter
+
+The hash table is changed by edrvfilter_compile() and read by the Rx handler
+of the driver. The writer increments \ref sequence before and after a change.
+A reader which overlaps with a change does not wait for it, it searches the
+filter array linearly instead.
+*/
+typedef struct
+{
+    volatile UINT32     sequence;                               ///< Change sequence of the hash table
+    BOOL                fHashed;                                ///< The hash table covers all enabled filters
+    tEdrvFilter*        pFilter;                                ///< Filter array of the DLL
+    UINT                filterCount;                            ///< Number of entries of the filter array
+    UINT                keyMaskCount;                           ///< Number of distinct key masks
+    UINT32              aKeyMask[EDRVFILTER_KEY_MASK_COUNT];    ///< Distinct key masks of the enabled filters
+    UINT16              aBucket[EDRVFILTER_BUCKET_COUNT];       ///< First entry of each bucket
+    UINT                entryCount;                             ///< Number of used entries
+    tEdrvFilterEntry    aEntry[CONFIG_EDRV_SOFT_FILTER_COUNT];  ///< Entries of the hash table
+} tEdrvFilterInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tEdrvFilterInstance  edrvFilterInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static UINT32       getKey(const UINT8* pData_p);
+static UINT         getBucket(UINT32 key_p);
+static BOOL         compareFrame(const tEdrvFilter* pFilter_p, const UINT8* pFrame_p);
+static tEdrvFilter* lookupHashed(const UINT8* pFrame_p);
+static tEdrvFilter* lookupLinear(const UINT8* pFrame_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Compile Rx filter array
+
+The function builds the hash table from the enabled entries of the Rx filter
+array. It is called by edrv_changeRxFilter() of the driver with the complete
+filter array. The array must stay valid until the function is called with the
+next array or with NULL.
+
+If the enabled filters use more distinct key masks than the hash table
+supports or if the array has more entries than CONFIG_EDRV_SOFT_FILTER_COUNT,
+the frames are matched linearly.
+
+\param  pFilter_p           Base pointer of Rx filter array (NULL = no filters)
+\param  count_p             Number of Rx filter array entries
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+void edrvfilter_compile(tEdrvFilter* pFilter_p, UINT count_p)
+{
+    tEdrvFilterInstance*    pInstance = &edrvFilterInstance_l;
+    tEdrvFilterEntry*       pEntry;
+    UINT16*                 pLink;
+    UINT32                  keyMask;
+    UINT                    maskIndex;
+    UINT                    index;
+
+    pInstance->sequence++;
+    OPLK_MEMBAR();
+
+    pInstance->pFilter = pFilter_p;
+    pInstance->filterCount = (pFilter_p != NULL) ? count_p : 0;
+    pInstance->fHashed = (pInstance->filterCount <= CONFIG_EDRV_SOFT_FILTER_COUNT);
+    pInstance->keyMaskCount = 0;
+    pInstance->entryCount = 0;
+    OPLK_MEMSET(pInstance->aBucket, 0xFF, sizeof(pInstance->aBucket));
+
+    for (index = 0; pInstance->fHashed && (index < pInstance->filterCount); index++)
+    {
+        if (!pFilter_p[index].fEnable)
+            continue;
+
+        keyMask = getKey(pFilter_p[index].aFilterMask);
+        for (maskIndex = 0; maskIndex < pInstance->keyMaskCount; maskIndex++)
+        {
+            if (pInstance->aKeyMask[maskIndex] == keyMask)
+                break;
+        }
+
+        if (maskIndex == pInstance->keyMaskCount)
+        {
+            if (maskIndex == EDRVFILTER_KEY_MASK_COUNT)
+            {
+                DEBUG_LVL_EDRV_TRACE("%s() too many key masks, Rx filters are matched linearly\n",
+                                     __func__);
+                pInstance->fHashed = FALSE;
+                break;
+            }
+
+            pInstance->aKeyMask[maskIndex] = keyMask;
+            pInstance->keyMaskCount++;
+        }
+
+        pEntry = &pInstance->aEntry[pInstance->entryCount];
+        pEntry->key = (getKey(pFilter_p[index].aFilterValue) & keyMask) | ((UINT32)maskIndex << 24);
+        pEntry->filterIndex = (UINT16)index;
+        pEntry->next = EDRVFILTER_NONE;
+
+        // append the entry, so the chain stays sorted by the filter index
+        pLink = &pInstance->aBucket[getBucket(pEntry->key)];
+        while (*pLink != EDRVFILTER_NONE)
+            pLink = &pInstance->aEntry[*pLink].next;
+        *pLink = (UINT16)pInstance->entryCount;
+        pInstance->entryCount++;
+    }
+
+    OPLK_MEMBAR();
+    pInstance->sequence++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Match frame against the Rx filters
+
+The function returns the enabled Rx filter with the lowest index which matches
+the frame, like a linear search of the filter array would. The Tx buffer of the
+returned filter is the auto-response frame of the received frame.
+
+\param  pFrame_p            Received frame
+\param  frameSize_p         Size of the received frame
+
+\return The function returns the matching Rx filter or NULL if no filter matches.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tEdrvFilter* edrvfilter_match(const UINT8* pFrame_p, UINT frameSize_p)
+{
+    tEdrvFilterInstance*    pInstance = &edrvFilterInstance_l;
+    tEdrvFilter*            pFilter;
+    UINT32                  sequence;
+
+    if (frameSize_p < EDRVFILTER_COMPARE_SIZE)
+        return NULL;
+
+    sequence = pInstance->sequence;
+    OPLK_MEMBAR();
+
+    if ((sequence & 1) == 0)
+    {
+        if (pInstance->fHashed)
+            pFilter = lookupHashed(pFrame_p);
+        else
+            pFilter = lookupLinear(pFrame_p);
+
+        OPLK_MEMBAR();
+        if (sequence == pInstance->sequence)
+            return pFilter;
+    }
+
+    // the hash table was changed during the lookup
+    return lookupLinear(pFrame_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check if a received frame shall be dropped
+
+The function checks if a received frame is dropped by the Rx filters.
+POWERLINK frames are dropped if they do not match an enabled filter. All other
+frames are passed, because they are forwarded to the virtual Ethernet interface.
+
+\param  pFrame_p            Received frame
+\param  frameSize_p         Size of the received frame
+
+\return The function returns TRUE if the frame shall be dropped.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+BOOL edrvfilter_dropFrame(const UINT8* pFrame_p, UINT frameSize_p)
+{
+    if ((frameSize_p < EDRVFILTER_KEY_OFFSET) ||
+        ((((UINT)pFrame_p[12] << 8) | pFrame_p[13]) != C_DLL_ETHERTYPE_EPL))
+        return FALSE;
+
+    return (edrvfilter_match(pFrame_p, frameSize_p) == NULL);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get hash key of a frame or filter
+
+The key consists of the message type, the destination node ID and the source
+node ID.
+
+\param  pData_p             Frame, filter value or filter mask
+
+\return The function returns the key.
+*/
+//------------------------------------------------------------------------------
+static UINT32 getKey(const UINT8* pData_p)
+{
+    return ((UINT32)pData_p[EDRVFILTER_KEY_OFFSET] << 16) |
+           ((UINT32)pData_p[EDRVFILTER_KEY_OFFSET + 1] << 8) |
+           (UINT32)pData_p[EDRVFILTER_KEY_OFFSET + 2];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get bucket of a key
+
+\param  key_p               Masked key including the index of the key mask
+
+\return The function returns the bucket index.
+*/
+//------------------------------------------------------------------------------
+static UINT getBucket(UINT32 key_p)
+{
+    // multiplicative hash, the upper bits are mixed best
+    return (UINT)((UINT32)(key_p * 0x9E3779B1UL) >> (32 - EDRVFILTER_HASH_BITS));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Compare frame with a filter
+
+\param  pFilter_p           Rx filter
+\param  pFrame_p            Received frame
+
+\return The function returns TRUE if the frame matches the filter.
+*/
+//------------------------------------------------------------------------------
+static BOOL compareFrame(const tEdrvFilter* pFilter_p, const UINT8* pFrame_p)
+{
+    UINT    i;
+
+    for (i = 0; i < EDRVFILTER_COMPARE_SIZE; i++)
+    {
+        if (((pFrame_p[i] ^ pFilter_p->aFilterValue[i]) & pFilter_p->aFilterMask[i]) != 0)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Match frame with the hash table
+
+The frame key is looked up once per key mask. The indices are checked against
+the table bounds, because the table may be changed during the lookup.
+
+\param  pFrame_p            Received frame
+
+\return The function returns the matching Rx filter or NULL.
+*/
+//------------------------------------------------------------------------------
+static tEdrvFilter* lookupHashed(const UINT8* pFrame_p)
+{
+    tEdrvFilterInstance*    pInstance = &edrvFilterInstance_l;
+    tEdrvFilter*            pFilter = pInstance->pFilter;
+    const tEdrvFilterEntry* pEntry;
+    UINT32                  frameKey;
+    UINT32                  key;
+    UINT                    maskIndex;
+    UINT                    entryIndex;
+    UINT                    bestIndex = EDRVFILTER_NONE;
+    UINT                    steps;
+
+    if (pFilter == NULL)
+        return NULL;
+
+    frameKey = getKey(pFrame_p);
+    for (maskIndex = 0; (maskIndex < pInstance->keyMaskCount) &&
+                        (maskIndex < EDRVFILTER_KEY_MASK_COUNT); maskIndex++)
+    {
+        key = (frameKey & pInstance->aKeyMask[maskIndex]) | ((UINT32)maskIndex << 24);
+        entryIndex = pInstance->aBucket[getBucket(key)];
+
+        for (steps = 0; (entryIndex < CONFIG_EDRV_SOFT_FILTER_COUNT) &&
+                        (steps < CONFIG_EDRV_SOFT_FILTER_COUNT); steps++)
+        {
+            pEntry = &pInstance->aEntry[entryIndex];
+            if ((pEntry->filterIndex >= bestIndex) ||
+                (pEntry->filterIndex >= pInstance->filterCount))
+                break;  // the remaining entries of the chain have higher indices
+
+            if ((pEntry->key == key) && compareFrame(&pFilter[pEntry->filterIndex], pFrame_p))
+            {
+                bestIndex = pEntry->filterIndex;
+                break;
+            }
+
+            entryIndex = pEntry->next;
+        }
+    }
+
+    return (bestIndex != EDRVFILTER_NONE) ? &pFilter[bestIndex] : NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Match frame with the filter array
+
+\param  pFrame_p            Received frame
+
+\return The function returns the matching Rx filter or NULL.
+*/
+//------------------------------------------------------------------------------
+static tEdrvFilter* lookupLinear(const UINT8* pFrame_p)
+{
+    tEdrvFilter*    pFilter = edrvFilterInstance_l.pFilter;
+    UINT            count = edrvFilterInstance_l.filterCount;
+    UINT            index;
+
+    if (pFilter == NULL)
+        return NULL;
+
+    for (index = 0; index < count; index++)
+    {
+        if (pFilter[index].fEnable && compareFrame(&pFilter[index], pFrame_p))
+            return &pFilter[index];
+    }
+
+    return NULL;
+}
+
+/// \}
@@ -0,0 +1,670 @@
+/**
+********************************************************************************
+\file   edrvirq-linuxkernel.c
+
+\brief  Interrupt placement of the Linux kernel Ethernet drivers
+
+This file implements the interrupt and thread placement of the Linux kernel
+Ethernet drivers edrv-82573 and edrv-i210. The drivers register their
+interrupts, which are then pinned to the CPUs of their class. On kernels which
+thread the interrupt handlers (PREEMPT_RT or the kernel parameter threadirqs)
+the interrupt thread is recorded on the first call of the handler and its
+SCHED_FIFO priority is set. The affinity of the interrupt thread follows the
+affinity of the interrupt. The priorities of the kernel event thread and the
+poll thread can be set as well.
+
+Optionally the interrupt of the isochronous Rx path is requested with
+IRQF_NO_THREAD, so it is processed in the primary handler even if the kernel
+was booted with threadirqs. This isn't possible on PREEMPT_RT, because the Rx
+path takes spinlocks which are sleeping locks there.
+
+The defaults are set by module parameters, the settings can be changed and
+the effective configuration can be read with ioctl calls of the kernel module.
+
+\ingroup module_edrv
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <kernel/edrvirq.h>
+
+#include <linux/module.h>
+#include <linux/interrupt.h>
+#include <linux/hardirq.h>
+#include <linux/mutex.h>
+#include <linux/sched.h>
+#include <linux/version.h>
+#include <linux/workqueue.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#if defined(CONFIG_PREEMPT_RT_FULL) || defined(CONFIG_PREEMPT_RT)
+#define EDRVIRQ_HARDIRQ_SUPPORTED       FALSE
+#else
+#define EDRVIRQ_HARDIRQ_SUPPORTED       TRUE
+#endif
+
+#define EDRVIRQ_MAX_PRIORITY            (MAX_RT_PRIO - 1)
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Registered controller interrupt
+
+The structure contains the information about a registered interrupt of the
+Ethernet controller.
+*/
+typedef struct
+{
+    BOOL                    fUsed;              ///< The entry is used
+    UINT                    irq;                ///< Interrupt number
+    tEdrvIrqClass           irqClass;           ///< Class of the interrupt
+    BOOL                    fHardIrq;           ///< Interrupt was requested with IRQF_NO_THREAD
+    UINT32                  cpuMask;            ///< CPU mask the interrupt is pinned to
+    struct cpumask          affinityMask;       ///< Affinity mask of the interrupt
+    struct task_struct*     pThread;            ///< Interrupt thread, NULL until the first threaded call
+} tEdrvIrqEntry;
+
+/**
+\brief  Interrupt placement instance
+
+The structure contains the instance variables of the interrupt placement.
+*/
+typedef struct
+{
+    tEdrvIrqEntry           aIrq[PLK_IRQ_CONFIG_MAX_IRQS];  ///< Registered controller interrupts
+    struct task_struct*     apThread[kEdrvIrqThreadCount];  ///< Registered kernel threads
+} tEdrvIrqInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tEdrvIrqInstance     edrvIrqInstance_l;
+static DEFINE_MUTEX(edrvIrqMutex_l);
+
+static uint cpuMaskIsoc_l = CONFIG_IRQ_CPU_MASK_EDRV_ISOC;
+static uint cpuMaskAsync_l = CONFIG_IRQ_CPU_MASK_EDRV_ASYNC;
+static int  irqThreadPriority_l = CONFIG_THREAD_PRIORITY_EDRV_IRQ;
+static int  eventkPriority_l = CONFIG_THREAD_PRIORITY_EVENTK;
+static int  pollPriority_l = CONFIG_THREAD_PRIORITY_EDRV_POLL;
+static bool isocHardIrq_l = (CONFIG_IRQ_EDRV_ISOC_HARDIRQ != FALSE);
+
+module_param_named(irqCpuMaskIsoc, cpuMaskIsoc_l, uint, 0444);
+MODULE_PARM_DESC(irqCpuMaskIsoc, "CPU mask of the interrupt of the isochronous Rx path (0 = kernel default)");
+module_param_named(irqCpuMaskAsync, cpuMaskAsync_l, uint, 0444);
+MODULE_PARM_DESC(irqCpuMaskAsync, "CPU mask of the asynchronous queue interrupt (0 = kernel default)");
+module_param_named(irqThreadPriority, irqThreadPriority_l, int, 0444);
+MODULE_PARM_DESC(irqThreadPriority, "SCHED_FIFO priority of the interrupt threads (0 = kernel default)");
+module_param_named(eventkPriority, eventkPriority_l, int, 0444);
+MODULE_PARM_DESC(eventkPriority, "SCHED_FIFO priority of the kernel event thread (0 = built-in)");
+module_param_named(pollPriority, pollPriority_l, int, 0444);
+MODULE_PARM_DESC(pollPriority, "SCHED_FIFO priority of the poll thread (0 = built-in)");
+module_param_named(isocHardIrq, isocHardIrq_l, bool, 0444);
+MODULE_PARM_DESC(isocHardIrq, "Process the isochronous Rx interrupt in the primary handler (not on PREEMPT_RT)");
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void applyIrqThreadPriorities(struct work_struct* pWork_p);
+static void setAffinity(tEdrvIrqEntry* pEntry_p);
+static void setPriority(struct task_struct* pTask_p, int priority_p);
+static INT32 getPriority(const struct task_struct* pTask_p);
+static int  getThreadPriority(tEdrvIrqThread thread_p);
+
+static DECLARE_WORK(applyWork_l, applyIrqThreadPriorities);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the flags for requesting an interrupt
+
+The function returns the additional flags for request_irq() of a controller
+interrupt of the given class. The interrupt of the isochronous Rx path is not
+threaded if this is configured and supported by the kernel.
+
+\param  irqClass_p          Class of the interrupt.
+
+\return The function returns the interrupt flags.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+ULONG edrvirq_getRequestFlags(tEdrvIrqClass irqClass_p)
+{
+    if ((irqClass_p == kEdrvIrqClassIsoc) && isocHardIrq_l && EDRVIRQ_HARDIRQ_SUPPORTED)
+        return IRQF_NO_THREAD;
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Register a controller interrupt
+
+The function registers a requested interrupt of the Ethernet controller and
+pins it to the CPUs of its class. An existing entry of the interrupt is
+replaced.
+
+\param  irq_p               Interrupt number.
+\param  irqClass_p          Class of the interrupt.
+\param  flags_p             Flags the interrupt was requested with.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk            The interrupt is registered.
+\retval kErrorNoResource    No free entry is available.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrvirq_addIrq(UINT irq_p, tEdrvIrqClass irqClass_p, ULONG flags_p)
+{
+    tEdrvIrqEntry*  pEntry = NULL;
+    UINT            index;
+
+    mutex_lock(&edrvIrqMutex_l);
+
+    for (index = 0; index < PLK_IRQ_CONFIG_MAX_IRQS; index++)
+    {
+        if (edrvIrqInstance_l.aIrq[index].fUsed && (edrvIrqInstance_l.aIrq[index].irq == irq_p))
+        {
+            pEntry = &edrvIrqInstance_l.aIrq[index];
+            break;
+        }
+
+        if (!edrvIrqInstance_l.aIrq[index].fUsed && (pEntry == NULL))
+            pEntry = &edrvIrqInstance_l.aIrq[index];
+    }
+
+    if (pEntry == NULL)
+    {
+        mutex_unlock(&edrvIrqMutex_l);
+        DEBUG_LVL_ERROR_TRACE("%s() No free entry for IRQ %u\n", __func__, irq_p);
+        return kErrorNoResource;
+    }
+
+    OPLK_MEMSET(pEntry, 0, sizeof(*pEntry));
+    pEntry->irq = irq_p;
+    pEntry->irqClass = irqClass_p;
+    pEntry->fHardIrq = ((flags_p & IRQF_NO_THREAD) != 0);
+    setAffinity(pEntry);
+    pEntry->fUsed = TRUE;
+
+    mutex_unlock(&edrvIrqMutex_l);
+
+    printk("PLK: IRQ %u (%s): CPU mask 0x%08X, %s\n", irq_p,
+           (irqClass_p == kEdrvIrqClassIsoc) ? "isochronous" : "asynchronous",
+           pEntry->cpuMask, pEntry->fHardIrq ? "primary handler" : "default handling");
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Unregister a controller interrupt
+
+The function unregisters an interrupt of the Ethernet controller. It must be
+called before the interrupt is freed.
+
+\param  irq_p               Interrupt number.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+void edrvirq_removeIrq(UINT irq_p)
+{
+    tEdrvIrqEntry*  pEntry;
+    UINT            index;
+
+    mutex_lock(&edrvIrqMutex_l);
+
+    for (index = 0; index < PLK_IRQ_CONFIG_MAX_IRQS; index++)
+    {
+        pEntry = &edrvIrqInstance_l.aIrq[index];
+        if (!pEntry->fUsed || (pEntry->irq != irq_p))
+            continue;
+
+        pEntry->fUsed = FALSE;
+        // The thread is recorded by the handler, it must not run anymore
+        synchronize_irq(irq_p);
+        pEntry->pThread = NULL;
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(2, 6, 35)
+        if (pEntry->cpuMask != 0)
+            irq_set_affinity_hint(irq_p, NULL);
+#endif
+        break;
+    }
+
+    mutex_unlock(&edrvIrqMutex_l);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Record the interrupt thread
+
+The function must be called by the interrupt handler of the Ethernet driver.
+If the handler runs in an interrupt thread, the thread is recorded on the
+first call and its priority is set by a work item. Calls from the registered
+kernel threads of the stack, e.g. the poll thread, are ignored.
+
+\param  irq_p               Interrupt number.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+void edrvirq_captureThread(UINT irq_p)
+{
+    tEdrvIrqEntry*  pEntry;
+    UINT            index;
+
+    if (in_irq())
+        return;
+
+    for (index = 0; index < kEdrvIrqThreadCount; index++)
+    {
+        if (edrvIrqInstance_l.apThread[index] == current)
+            return;
+    }
+
+    for (index = 0; index < PLK_IRQ_CONFIG_MAX_IRQS; index++)
+    {
+        pEntry = &edrvIrqInstance_l.aIrq[index];
+        if (!pEntry->fUsed || (pEntry->irq != irq_p))
+            continue;
+
+        if (pEntry->pThread == NULL)
+        {
+            pEntry->pThread = current;
+            schedule_work(&applyWork_l);
+        }
+        break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Register a kernel thread
+
+The function registers a kernel thread of the stack and sets its configured
+priority. It must be called by the thread itself after it set its built-in
+priority.
+
+\param  thread_p            The kernel thread.
+\param  pTask_p             Task of the thread.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+void edrvirq_addThread(tEdrvIrqThread thread_p, struct task_struct* pTask_p)
+{
+    if (thread_p >= kEdrvIrqThreadCount)
+        return;
+
+    mutex_lock(&edrvIrqMutex_l);
+    edrvIrqInstance_l.apThread[thread_p] = pTask_p;
+    setPriority(pTask_p, getThreadPriority(thread_p));
+    mutex_unlock(&edrvIrqMutex_l);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Unregister a kernel thread
+
+The function unregisters a kernel thread of the stack. It must be called
+before the thread is stopped.
+
+\param  thread_p            The kernel thread.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+void edrvirq_removeThread(tEdrvIrqThread thread_p)
+{
+    if (thread_p >= kEdrvIrqThreadCount)
+        return;
+
+    mutex_lock(&edrvIrqMutex_l);
+    edrvIrqInstance_l.apThread[thread_p] = NULL;
+    mutex_unlock(&edrvIrqMutex_l);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set the interrupt and thread configuration
+
+The function changes the configuration. The CPU masks and priorities are
+applied to the registered interrupts and threads immediately, the primary
+handler processing when the interrupts are requested the next time.
+
+\param  pConfig_p           Pointer to the configuration.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The configuration is changed.
+\retval kErrorApiInvalidParam   A priority is out of range.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrvirq_setConfig(const tIrqConfig* pConfig_p)
+{
+    UINT            index;
+
+    if ((pConfig_p->irqThreadPriority < 0) || (pConfig_p->irqThreadPriority > EDRVIRQ_MAX_PRIORITY) ||
+        (pConfig_p->eventkPriority < 0) || (pConfig_p->eventkPriority > EDRVIRQ_MAX_PRIORITY) ||
+        (pConfig_p->pollPriority < 0) || (pConfig_p->pollPriority > EDRVIRQ_MAX_PRIORITY))
+        return kErrorApiInvalidParam;
+
+    mutex_lock(&edrvIrqMutex_l);
+
+    cpuMaskIsoc_l = pConfig_p->cpuMaskIsoc;
+    cpuMaskAsync_l = pConfig_p->cpuMaskAsync;
+    irqThreadPriority_l = pConfig_p->irqThreadPriority;
+    eventkPriority_l = pConfig_p->eventkPriority;
+    pollPriority_l = pConfig_p->pollPriority;
+    isocHardIrq_l = (pConfig_p->fIsocHardIrq != 0);
+
+    for (index = 0; index < PLK_IRQ_CONFIG_MAX_IRQS; index++)
+    {
+        if (edrvIrqInstance_l.aIrq[index].fUsed)
+            setAffinity(&edrvIrqInstance_l.aIrq[index]);
+    }
+
+    for (index = 0; index < kEdrvIrqThreadCount; index++)
+        setPriority(edrvIrqInstance_l.apThread[index], getThreadPriority((tEdrvIrqThread)index));
+
+    mutex_unlock(&edrvIrqMutex_l);
+
+    // Interrupt threads are set by the work item like after their first call
+    schedule_work(&applyWork_l);
+
+    printk("PLK: IRQ CPU masks 0x%08X/0x%08X, priorities IRQ %d, eventk %d, poll %d, hard IRQ %s\n",
+           cpuMaskIsoc_l, cpuMaskAsync_l, irqThreadPriority_l, eventkPriority_l, pollPriority_l,
+           (isocHardIrq_l && EDRVIRQ_HARDIRQ_SUPPORTED) ? "on" : "off");
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the interrupt and thread configuration
+
+The function returns the configuration and the effective settings of the
+registered interrupts and threads.
+
+\param  pConfig_p           Pointer to store the configuration.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+void edrvirq_getConfig(tIrqConfig* pConfig_p)
+{
+    tEdrvIrqEntry*  pEntry;
+    tIrqInfo*       pInfo;
+    UINT            index;
+
+    OPLK_MEMSET(pConfig_p, 0, sizeof(*pConfig_p));
+
+    mutex_lock(&edrvIrqMutex_l);
+
+    pConfig_p->cpuMaskIsoc = cpuMaskIsoc_l;
+    pConfig_p->cpuMaskAsync = cpuMaskAsync_l;
+    pConfig_p->irqThreadPriority = irqThreadPriority_l;
+    pConfig_p->eventkPriority = eventkPriority_l;
+    pConfig_p->pollPriority = pollPriority_l;
+    pConfig_p->fIsocHardIrq = isocHardIrq_l;
+    pConfig_p->fIsocHardIrqSupported = EDRVIRQ_HARDIRQ_SUPPORTED;
+    pConfig_p->eventkPriorityActive = getPriority(edrvIrqInstance_l.apThread[kEdrvIrqThreadEventk]);
+    pConfig_p->pollPriorityActive = getPriority(edrvIrqInstance_l.apThread[kEdrvIrqThreadPoll]);
+
+    for (index = 0; index < PLK_IRQ_CONFIG_MAX_IRQS; index++)
+    {
+        pEntry = &edrvIrqInstance_l.aIrq[index];
+        if (!pEntry->fUsed)
+            continue;
+
+        pInfo = &pConfig_p->aIrq[pConfig_p->irqCount++];
+        pInfo->irq = pEntry->irq;
+        pInfo->irqClass = pEntry->irqClass;
+        pInfo->cpuMask = pEntry->cpuMask;
+        pInfo->fHardIrq = pEntry->fHardIrq;
+        pInfo->threadPriority = getPriority(pEntry->pThread);
+    }
+
+    mutex_unlock(&edrvIrqMutex_l);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get interrupt placement diagnostics
+
+The function writes the effective interrupt and thread configuration to a
+provided buffer.
+
+\param  pBuffer_p           Pointer to buffer filled with diagnostics.
+\param  size_p              Size of buffer
+
+\return The function returns the number of characters written to the buffer.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+INT edrvirq_getDiagnostics(char* pBuffer_p, INT size_p)
+{
+    tIrqConfig      config;
+    INT             usedSize = 0;
+    UINT            index;
+
+    edrvirq_getConfig(&config);
+
+    usedSize += snprintf(pBuffer_p + usedSize, size_p - usedSize,
+                         "Thread priorities: eventk %d  poll %d\n",
+                         config.eventkPriorityActive, config.pollPriorityActive);
+
+    for (index = 0; index < config.irqCount; index++)
+    {
+        usedSize += snprintf(pBuffer_p + usedSize, size_p - usedSize,
+                             "IRQ %u: CPU mask 0x%08X  %s  thread priority %d\n",
+                             config.aIrq[index].irq, config.aIrq[index].cpuMask,
+                             config.aIrq[index].fHardIrq ? "hard" : "default",
+                             config.aIrq[index].threadPriority);
+    }
+
+    return usedSize;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Apply the priority of the interrupt threads
+
+The work function sets the configured priority of the recorded interrupt
+threads. It runs in process context, because the priority can't be changed
+from the interrupt handler.
+
+\param  pWork_p             Pointer to the work item. Not used!
+*/
+//------------------------------------------------------------------------------
+static void applyIrqThreadPriorities(struct work_struct* pWork_p)
+{
+    tEdrvIrqEntry*  pEntry;
+    UINT            index;
+
+    UNUSED_PARAMETER(pWork_p);
+
+    mutex_lock(&edrvIrqMutex_l);
+
+    for (index = 0; index < PLK_IRQ_CONFIG_MAX_IRQS; index++)
+    {
+        pEntry = &edrvIrqInstance_l.aIrq[index];
+        if (!pEntry->fUsed || (pEntry->pThread == NULL))
+            continue;
+
+        if (irqThreadPriority_l != 0)
+        {
+            setPriority(pEntry->pThread, irqThreadPriority_l);
+            printk("PLK: IRQ %u thread %s: priority %d\n",
+                   pEntry->irq, pEntry->pThread->comm, getPriority(pEntry->pThread));
+        }
+    }
+
+    mutex_unlock(&edrvIrqMutex_l);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Pin an interrupt to CPUs
+
+The function sets the affinity of a registered interrupt according to the CPU
+mask of its class. A mask of 0 leaves the affinity unchanged.
+
+\param  pEntry_p            Pointer to the interrupt entry.
+*/
+//------------------------------------------------------------------------------
+static void setAffinity(tEdrvIrqEntry* pEntry_p)
+{
+    UINT32      cpuMask;
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(2, 6, 35)
+    UINT        cpu;
+#endif
+
+    cpuMask = (pEntry_p->irqClass == kEdrvIrqClassIsoc) ? cpuMaskIsoc_l : cpuMaskAsync_l;
+    if ((cpuMask == 0) || (cpuMask == pEntry_p->cpuMask))
+        return;
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(2, 6, 35)
+    cpumask_clear(&pEntry_p->affinityMask);
+    for (cpu = 0; (cpu < 32) && (cpu < nr_cpu_ids); cpu++)
+    {
+        if ((cpuMask & (1UL << cpu)) != 0)
+            cpumask_set_cpu(cpu, &pEntry_p->affinityMask);
+    }
+
+    if (irq_set_affinity_hint(pEntry_p->irq, &pEntry_p->affinityMask) != 0)
+    {
+        printk("%s() Pinning IRQ %u to CPU mask 0x%08X failed\n", __FUNCTION__,
+               pEntry_p->irq, cpuMask);
+        return;
+    }
+
+    pEntry_p->cpuMask = cpuMask;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set the priority of a thread
+
+The function sets the SCHED_FIFO priority of a thread. A priority of 0 leaves
+the thread unchanged.
+
+\param  pTask_p             Task of the thread, may be NULL.
+\param  priority_p          SCHED_FIFO priority.
+*/
+//------------------------------------------------------------------------------
+static void setPriority(struct task_struct* pTask_p, int priority_p)
+{
+    struct sched_param  rtPrio;
+
+    if ((pTask_p == NULL) || (priority_p == 0))
+        return;
+
+    rtPrio.sched_priority = priority_p;
+    if (sched_setscheduler(pTask_p, SCHED_FIFO, &rtPrio) != 0)
+    {
+        printk("%s() Setting priority %d of thread %s failed\n", __FUNCTION__,
+               priority_p, pTask_p->comm);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the priority of a thread
+
+\param  pTask_p             Task of the thread, may be NULL.
+
+\return The function returns the real-time priority of the thread, 0 if it is
+        no real-time thread and -1 if the task is NULL.
+*/
+//------------------------------------------------------------------------------
+static INT32 getPriority(const struct task_struct* pTask_p)
+{
+    if (pTask_p == NULL)
+        return -1;
+
+    return (INT32)pTask_p->rt_priority;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the configured priority of a kernel thread
+
+\param  thread_p            The kernel thread.
+
+\return The function returns the configured priority (0 = built-in).
+*/
+//------------------------------------------------------------------------------
+static int getThreadPriority(tEdrvIrqThread thread_p)
+{
+    return (thread_p == kEdrvIrqThreadEventk) ? eventkPriority_l : pollPriority_l;
+}
+
+/// \}
@@ -0,0 +1,223 @@
+/**
+********************************************************************************
+\file   edrvmirror-posixshm.c
+
+\brief  Posix shared memory implementation of the Ethernet driver mirror ring
+
+This file implements the mirror ring of the Ethernet driver in posix shared
+memory. The Ethernet driver records every frame it receives or transmits in
+the ring. The ring is lossy: The writer never waits for a reader, it
+overwrites the oldest slot. The ring must only be written from a single
+thread, which is the receive thread of the Linux user space Ethernet drivers.
+
+\ingroup module_edrv
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <kernel/edrvmirror.h>
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <fcntl.h>           /* For O_* constants */
+#include <sys/stat.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define EDRVMIRROR_SLOT_SIZE    (sizeof(tEdrvMirrorSlot) + EDRVMIRROR_SLOT_DATA_SIZE)
+#define EDRVMIRROR_MEM_SIZE     (sizeof(tEdrvMirrorHeader) + \
+                                 (CONFIG_EDRV_MIRROR_SLOTS * EDRVMIRROR_SLOT_SIZE))
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static int                  fd_l = -1;
+static tEdrvMirrorHeader*   pHeader_l = NULL;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize mirror ring
+
+The function creates the shared memory of the mirror ring and initializes its
+header. The Ethernet driver works without the mirror ring if it cannot be
+created.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrvmirror_init(void)
+{
+    if (pHeader_l != NULL)
+        return kErrorNoFreeInstance;
+
+    if ((fd_l = shm_open(EDRVMIRROR_SHM_NAME, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR)) < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() shm_open failed!\n", __func__);
+        return kErrorNoResource;
+    }
+
+    if (ftruncate(fd_l, EDRVMIRROR_MEM_SIZE) == -1)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() ftruncate failed!\n", __func__);
+        close(fd_l);
+        fd_l = -1;
+        shm_unlink(EDRVMIRROR_SHM_NAME);
+        return kErrorNoResource;
+    }
+
+    pHeader_l = mmap(NULL, EDRVMIRROR_MEM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd_l, 0);
+    if (pHeader_l == MAP_FAILED)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() mmap failed!\n", __func__);
+        pHeader_l = NULL;
+        close(fd_l);
+        fd_l = -1;
+        shm_unlink(EDRVMIRROR_SHM_NAME);
+        return kErrorNoResource;
+    }
+
+    OPLK_MEMSET(pHeader_l, 0, EDRVMIRROR_MEM_SIZE);
+    pHeader_l->version = EDRVMIRROR_VERSION;
+    pHeader_l->slotCount = CONFIG_EDRV_MIRROR_SLOTS;
+    pHeader_l->slotSize = EDRVMIRROR_SLOT_SIZE;
+    OPLK_MEMBAR();
+    // the magic marks the ring as valid for readers
+    OPLK_MEMCPY(pHeader_l->aMagic, EDRVMIRROR_MAGIC, sizeof(pHeader_l->aMagic));
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Shut down mirror ring
+
+The function removes the shared memory of the mirror ring.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+void edrvmirror_exit(void)
+{
+    if (pHeader_l == NULL)
+        return;
+
+    munmap(pHeader_l, EDRVMIRROR_MEM_SIZE);
+    close(fd_l);
+    shm_unlink(EDRVMIRROR_SHM_NAME);
+    fd_l = -1;
+    pHeader_l = NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Record frame in mirror ring
+
+The function copies a frame into the oldest slot of the mirror ring. Frames
+larger than EDRVMIRROR_SLOT_DATA_SIZE are truncated.
+
+\param  pFrame_p        Pointer to the frame.
+\param  frameSize_p     Size of the frame in bytes.
+\param  timeStamp_p     Time of the frame in ns (CLOCK_REALTIME).
+\param  flags_p         Flags of the frame (EDRVMIRROR_FLAG_xxx).
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+void edrvmirror_recordFrame(const void* pFrame_p, UINT frameSize_p,
+                            UINT64 timeStamp_p, UINT32 flags_p)
+{
+    UINT64              writeCount;
+    tEdrvMirrorSlot*    pSlot;
+
+    if (pHeader_l == NULL)
+        return;
+
+    writeCount = pHeader_l->writeCount;
+    pSlot = (tEdrvMirrorSlot*)((UINT8*)(pHeader_l + 1) +
+                               ((writeCount % CONFIG_EDRV_MIRROR_SLOTS) * EDRVMIRROR_SLOT_SIZE));
+
+    // invalidate the slot while it is updated
+    __atomic_store_n(&pSlot->sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    pSlot->frameSize = frameSize_p;
+    pSlot->capturedSize = min(frameSize_p, EDRVMIRROR_SLOT_DATA_SIZE);
+    pSlot->flags = flags_p;
+    pSlot->timeStamp = timeStamp_p;
+    OPLK_MEMCPY(pSlot + 1, pFrame_p, pSlot->capturedSize);
+
+    __atomic_store_n(&pSlot->sequence, (UINT32)(writeCount + 1), __ATOMIC_RELEASE);
+    __atomic_store_n(&pHeader_l->writeCount, writeCount + 1, __ATOMIC_RELEASE);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+/// \}
@@ -0,0 +1,389 @@
+/**
+********************************************************************************
+\file   edrvpoll-linuxkernel.c
+
+\brief  Poll mode of the Linux kernel Ethernet drivers
+
+This file implements the poll mode of the Linux kernel Ethernet drivers
+edrv-82573, edrv-8255x and edrv-8139. During the isochronous phase of the
+POWERLINK cycle the interrupt of the Ethernet controller is disabled and a
+kernel thread busy-polls the controller. In the asynchronous phase and while
+the stack is idle the controller uses its interrupt again.
+
+The isochronous phase starts with a SoC and ends with a SoA, which are
+detected by the Ethernet driver when it transmits (MN) or receives (CN) them.
+The poll thread should run on a CPU which is isolated by the kernel parameter
+isolcpus, see CONFIG_THREAD_CPU_MASK_EDRV_POLL.
+
+\ingroup module_edrv
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <oplk/frame.h>
+#include <common/ami.h>
+#include <kernel/edrvpoll.h>
+#include <kernel/edrvirq.h>
+
+#include <linux/kthread.h>
+#include <linux/interrupt.h>
+#include <linux/math64.h>
+#include <linux/sched.h>
+#include <linux/wait.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define EDRVPOLL_THREAD_PRIORITY    80      // above the kernel event thread
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Poll mode statistics
+
+The structure contains the statistics of the poll mode. The interrupts are
+counted in both phases, the polls only in the isochronous phase.
+*/
+typedef struct
+{
+    ULONGLONG           cycleCount;             ///< Number of isochronous phases
+    ULONGLONG           irqCount;               ///< Number of interrupts of the controller
+    UINT                cycleIrqCount;          ///< Number of interrupts in the current cycle
+    UINT                maxCycleIrqCount;       ///< Maximum number of interrupts in a cycle
+    ULONGLONG           pollHitCount;           ///< Number of polls with pending events
+    ULONGLONG           pollMissCount;          ///< Number of polls without pending events
+} tEdrvPollStatistics;
+
+/**
+\brief  Poll mode instance
+
+The structure contains the instance variables of the poll mode.
+*/
+typedef struct
+{
+    UINT                irq;                    ///< Interrupt of the Ethernet controller
+    tEdrvPollCb         pfnPoll;                ///< Poll callback of the Ethernet driver
+    struct task_struct* pThread;                ///< Poll thread
+    wait_queue_head_t   waitQueue;              ///< Wait queue of the poll thread
+    volatile BOOL       fIsochronous;           ///< The isochronous phase is active
+    volatile BOOL       fPolling;               ///< The poll thread processes the controller
+    tEdrvPollStatistics statistics;             ///< Statistics of the poll mode
+} tEdrvPollInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tEdrvPollInstance    edrvPollInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static int  pollThread(void* pArg_p);
+static void bindThread(struct task_struct* pThread_p, ULONG cpuMask_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize poll mode
+
+The function initializes the poll mode and starts the poll thread. It must be
+called by the Ethernet driver after its interrupt was requested.
+
+\param  irq_p               Interrupt of the Ethernet controller.
+\param  pfnPoll_p           Poll callback of the Ethernet driver.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrvpoll_init(UINT irq_p, tEdrvPollCb pfnPoll_p)
+{
+    OPLK_MEMSET(&edrvPollInstance_l, 0, sizeof(edrvPollInstance_l));
+
+    edrvPollInstance_l.irq = irq_p;
+    edrvPollInstance_l.pfnPoll = pfnPoll_p;
+    init_waitqueue_head(&edrvPollInstance_l.waitQueue);
+
+    edrvPollInstance_l.pThread = kthread_create(pollThread, NULL, "EdrvPollThread");
+    if (IS_ERR(edrvPollInstance_l.pThread))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Couldn't create poll thread\n", __func__);
+        edrvPollInstance_l.pThread = NULL;
+        return kErrorNoResource;
+    }
+
+    bindThread(edrvPollInstance_l.pThread, CONFIG_THREAD_CPU_MASK_EDRV_POLL);
+    wake_up_process(edrvPollInstance_l.pThread);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Shut down poll mode
+
+The function stops the poll thread. The interrupt of the Ethernet controller
+is enabled again if it was disabled by the poll thread. It must be called by
+the Ethernet driver before its interrupt is freed.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+void edrvpoll_exit(void)
+{
+    if (edrvPollInstance_l.pThread == NULL)
+        return;
+
+    edrvirq_removeThread(kEdrvIrqThreadPoll);
+    kthread_stop(edrvPollInstance_l.pThread);
+    edrvPollInstance_l.pThread = NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Watch frame for phase changes
+
+The function must be called by the Ethernet driver for every frame it
+transmits or receives. A SoC starts the isochronous phase, a SoA ends it.
+
+\param  pFrame_p            Pointer to the frame.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+void edrvpoll_watchFrame(const void* pFrame_p)
+{
+    const tPlkFrame*    pFrame = (const tPlkFrame*)pFrame_p;
+    tMsgType            msgType;
+
+    if (ami_getUint16Be(&pFrame->etherType) != C_DLL_ETHERTYPE_EPL)
+        return;
+
+    msgType = (tMsgType)ami_getUint8Le(&pFrame->messageType);
+    if (msgType == kMsgTypeSoc)
+    {
+        edrvPollInstance_l.statistics.cycleCount++;
+        if (edrvPollInstance_l.statistics.cycleIrqCount > edrvPollInstance_l.statistics.maxCycleIrqCount)
+            edrvPollInstance_l.statistics.maxCycleIrqCount = edrvPollInstance_l.statistics.cycleIrqCount;
+        edrvPollInstance_l.statistics.cycleIrqCount = 0;
+
+        edrvPollInstance_l.fIsochronous = TRUE;
+        wake_up_interruptible(&edrvPollInstance_l.waitQueue);
+    }
+    else if (msgType == kMsgTypeSoa)
+    {
+        edrvPollInstance_l.fIsochronous = FALSE;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Count interrupt
+
+The function must be called by the interrupt handler of the Ethernet driver.
+Calls of the handler by the poll thread are not counted.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+void edrvpoll_countIrq(void)
+{
+    if (edrvPollInstance_l.fPolling)
+        return;
+
+    edrvPollInstance_l.statistics.irqCount++;
+    edrvPollInstance_l.statistics.cycleIrqCount++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get poll mode diagnostics
+
+The function writes the statistics of the poll mode to a provided buffer.
+
+\param  pBuffer_p           Pointer to buffer filled with diagnostics.
+\param  size_p              Size of buffer
+
+\return The function returns the number of characters written to the buffer.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+INT edrvpoll_getDiagnostics(char* pBuffer_p, INT size_p)
+{
+    tEdrvPollStatistics*    pStat = &edrvPollInstance_l.statistics;
+    INT                     usedSize = 0;
+    ULONG                   irqPerCycle100 = 0;
+
+    if (pStat->cycleCount != 0)
+        irqPerCycle100 = (ULONG)div64_u64(pStat->irqCount * 100, pStat->cycleCount);
+
+    usedSize += snprintf(pBuffer_p + usedSize, size_p - usedSize,
+                         "Poll mode: %s\n",
+                         edrvPollInstance_l.fIsochronous ? "isochronous (polling)" : "asynchronous (interrupt)");
+    usedSize += snprintf(pBuffer_p + usedSize, size_p - usedSize,
+                         "Cycles: %llu  IRQs: %llu  IRQs/cycle: %lu.%02lu (Max: %u)\n",
+                         pStat->cycleCount, pStat->irqCount,
+                         irqPerCycle100 / 100, irqPerCycle100 % 100,
+                         pStat->maxCycleIrqCount);
+    usedSize += snprintf(pBuffer_p + usedSize, size_p - usedSize,
+                         "Poll hits: %llu  Poll misses: %llu\n",
+                         pStat->pollHitCount, pStat->pollMissCount);
+
+    return usedSize;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Poll thread
+
+The thread waits for the start of the isochronous phase. It then disables the
+interrupt of the Ethernet controller and calls the poll callback of the
+Ethernet driver until the phase ends. Afterwards the interrupt is enabled
+again. The callback is called with local interrupts disabled, as the frame
+processing of the driver and the DLL expects the context of its interrupt
+handler.
+
+\param  pArg_p              Thread parameter. Not used!
+
+\return The function returns the thread exit code.
+*/
+//------------------------------------------------------------------------------
+static int pollThread(void* pArg_p)
+{
+    struct sched_param  rtPrio;
+    ULONG               flags;
+    BOOL                fHit;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    rtPrio.sched_priority = EDRVPOLL_THREAD_PRIORITY;
+    sched_setscheduler(current, SCHED_FIFO, &rtPrio);
+    // may override the built-in priority (module parameter pollPriority)
+    edrvirq_addThread(kEdrvIrqThreadPoll, current);
+
+    while (!kthread_should_stop())
+    {
+        wait_event_interruptible(edrvPollInstance_l.waitQueue,
+                                 edrvPollInstance_l.fIsochronous || kthread_should_stop());
+        if (kthread_should_stop())
+            break;
+
+        // Waits for a running interrupt handler of the controller
+        disable_irq(edrvPollInstance_l.irq);
+
+        do
+        {
+            local_irq_save(flags);
+            edrvPollInstance_l.fPolling = TRUE;
+            fHit = edrvPollInstance_l.pfnPoll();
+            edrvPollInstance_l.fPolling = FALSE;
+            local_irq_restore(flags);
+
+            if (fHit)
+            {
+                edrvPollInstance_l.statistics.pollHitCount++;
+            }
+            else
+            {
+                edrvPollInstance_l.statistics.pollMissCount++;
+                cpu_relax();
+            }
+        } while (edrvPollInstance_l.fIsochronous && !kthread_should_stop());
+
+        enable_irq(edrvPollInstance_l.irq);
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Bind thread to CPU
+
+The function binds a thread which is not yet running to the first CPU of the
+specified affinity mask.
+
+\param  pThread_p           Thread to bind.
+\param  cpuMask_p           CPU affinity mask (bit n = CPU n, 0 = no binding).
+*/
+//------------------------------------------------------------------------------
+static void bindThread(struct task_struct* pThread_p, ULONG cpuMask_p)
+{
+    UINT    cpu;
+
+    for (cpu = 0; cpu < (sizeof(cpuMask_p) * 8); cpu++)
+    {
+        if ((cpuMask_p & (1UL << cpu)) == 0)
+            continue;
+
+        if (cpu_online(cpu))
+            kthread_bind(pThread_p, cpu);
+        else
+            DEBUG_LVL_ERROR_TRACE("%s() CPU %u is not online\n", __func__, cpu);
+        return;
+    }
+}
+
+/// \}
@@ -0,0 +1,380 @@
+/**
+********************************************************************************
+\file   edrvrxpool-linux.c
+
+\brief  Reference counted Rx buffer pool for Linux userspace Ethernet drivers
+
+This file contains the pool of reference counted Rx buffers which is used by
+the Linux userspace Ethernet drivers. A driver hands a received frame in a pool
+buffer to its Rx handler. The frame can be held by any number of consumers
+(e.g. dllk, PDO, virtual Ethernet, mirror) without copying it and is released
+through edrv_releaseRxBuffer(). The buffer is recycled when its last reference
+is released.
+
+The pool either allocates its buffers itself (drivers which copy the frame out
+of a transient buffer) or manages the slots of a receive ring of the driver.
+Then the driver is notified by a recycle callback if a slot can be handed back
+to the hardware.
+
+\ingroup module_edrv
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <kernel/edrv.h>
+
+#include <pthread.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief Rx buffer pool instance
+
+The structure contains the instance variables of the Rx buffer pool.
+*/
+typedef struct
+{
+    UINT8*                  pMemory;            ///< Memory of the buffers
+    BOOL                    fOwnMemory;         ///< The memory was allocated by the pool
+    UINT                    bufferCount;        ///< Number of buffers
+    UINT                    bufferSize;         ///< Size of a buffer
+    UINT*                   pRefCount;          ///< Reference counts of the buffers
+    UINT                    nextIndex;          ///< Start index of the search for a free buffer
+    tEdrvRxPoolRecycleCb    pfnRecycle;         ///< Callback for recycled buffers
+    pthread_mutex_t         mutex;              ///< Protects the reference counts
+} tEdrvRxPoolInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tEdrvRxPoolInstance  rxPoolInstance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static BOOL getBufferIndex(UINT8* pBuffer_p, UINT* pIndex_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize Rx buffer pool
+
+The function initializes the Rx buffer pool. If \p pMemory_p is NULL, the pool
+allocates the buffers itself and the driver obtains them with
+edrvrxpool_allocBuffer(). Otherwise \p pMemory_p points to the receive ring of
+the driver which is divided into \p bufferCount_p slots. The driver marks a
+slot as used with edrvrxpool_acquireBuffer().
+
+\param  pMemory_p           Pointer to the receive ring of the driver or NULL.
+\param  bufferCount_p       Number of buffers.
+\param  bufferSize_p        Size of a buffer.
+\param  pfnRecycle_p        Callback which is called with the index of a buffer
+                            if its last reference is released. May be NULL.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrvrxpool_init(UINT8* pMemory_p, UINT bufferCount_p, UINT bufferSize_p,
+                           tEdrvRxPoolRecycleCb pfnRecycle_p)
+{
+    tEdrvRxPoolInstance*    pInstance = &rxPoolInstance_l;
+
+    if ((bufferCount_p == 0) || (bufferSize_p == 0))
+        return kErrorEdrvInvalidParam;
+
+    OPLK_MEMSET(pInstance, 0, sizeof(tEdrvRxPoolInstance));
+
+    pInstance->pRefCount = (UINT*)OPLK_MALLOC(bufferCount_p * sizeof(UINT));
+    if (pInstance->pRefCount == NULL)
+        return kErrorNoResource;
+
+    OPLK_MEMSET(pInstance->pRefCount, 0, bufferCount_p * sizeof(UINT));
+
+    if (pMemory_p == NULL)
+    {
+        pMemory_p = (UINT8*)OPLK_MALLOC(bufferCount_p * bufferSize_p);
+        if (pMemory_p == NULL)
+        {
+            OPLK_FREE(pInstance->pRefCount);
+            pInstance->pRefCount = NULL;
+            return kErrorNoResource;
+        }
+        pInstance->fOwnMemory = TRUE;
+    }
+
+    pInstance->pMemory = pMemory_p;
+    pInstance->bufferCount = bufferCount_p;
+    pInstance->bufferSize = bufferSize_p;
+    pInstance->pfnRecycle = pfnRecycle_p;
+
+    pthread_mutex_init(&pInstance->mutex, NULL);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Shut down Rx buffer pool
+
+The function frees the resources of the Rx buffer pool. Buffers which are
+still held by consumers become invalid.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+void edrvrxpool_exit(void)
+{
+    tEdrvRxPoolInstance*    pInstance = &rxPoolInstance_l;
+
+    if (pInstance->pRefCount == NULL)
+        return;
+
+    pthread_mutex_destroy(&pInstance->mutex);
+
+    if (pInstance->fOwnMemory)
+        OPLK_FREE(pInstance->pMemory);
+
+    OPLK_FREE(pInstance->pRefCount);
+    OPLK_MEMSET(pInstance, 0, sizeof(tEdrvRxPoolInstance));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Allocate a free Rx buffer
+
+The function returns a free buffer of a pool which has allocated its buffers
+itself. The buffer is returned with one reference which belongs to the driver.
+
+\param  ppBuffer_p          Pointer to store the pointer to the buffer.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                    A buffer was allocated.
+\retval kErrorEdrvNoFreeBufEntry    All buffers are held by consumers.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrvrxpool_allocBuffer(UINT8** ppBuffer_p)
+{
+    tEdrvRxPoolInstance*    pInstance = &rxPoolInstance_l;
+    tOplkError              ret = kErrorEdrvNoFreeBufEntry;
+    UINT                    index;
+    UINT                    i;
+
+    pthread_mutex_lock(&pInstance->mutex);
+    for (i = 0, index = pInstance->nextIndex; i < pInstance->bufferCount; i++)
+    {
+        if (pInstance->pRefCount[index] == 0)
+        {
+            pInstance->pRefCount[index] = 1;
+            pInstance->nextIndex = (index + 1) % pInstance->bufferCount;
+            *ppBuffer_p = pInstance->pMemory + (index * pInstance->bufferSize);
+            ret = kErrorOk;
+            break;
+        }
+
+        index = (index + 1) % pInstance->bufferCount;
+    }
+    pthread_mutex_unlock(&pInstance->mutex);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Acquire a slot of the receive ring
+
+The function marks the specified slot of the receive ring as used. The slot is
+returned with one reference which belongs to the driver.
+
+\param  index_p             Index of the slot.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                    The slot was acquired.
+\retval kErrorEdrvInvalidRxBuf      The slot is still held by a consumer.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrvrxpool_acquireBuffer(UINT index_p)
+{
+    tEdrvRxPoolInstance*    pInstance = &rxPoolInstance_l;
+    tOplkError              ret = kErrorEdrvInvalidRxBuf;
+
+    if (index_p >= pInstance->bufferCount)
+        return kErrorEdrvInvalidParam;
+
+    pthread_mutex_lock(&pInstance->mutex);
+    if (pInstance->pRefCount[index_p] == 0)
+    {
+        pInstance->pRefCount[index_p] = 1;
+        ret = kErrorOk;
+    }
+    pthread_mutex_unlock(&pInstance->mutex);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add a reference to a buffer
+
+The function adds a reference to the buffer which contains the specified
+frame. The buffer must already be held, i.e. the Rx handler has returned
+kEdrvReleaseRxBufferLater or the caller holds a reference.
+
+\param  pBuffer_p           Pointer into the buffer.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrvrxpool_addRef(UINT8* pBuffer_p)
+{
+    tEdrvRxPoolInstance*    pInstance = &rxPoolInstance_l;
+    tOplkError              ret = kErrorEdrvInvalidRxBuf;
+    UINT                    index;
+
+    if (!getBufferIndex(pBuffer_p, &index))
+        return kErrorEdrvInvalidRxBuf;
+
+    pthread_mutex_lock(&pInstance->mutex);
+    if (pInstance->pRefCount[index] != 0)
+    {
+        pInstance->pRefCount[index]++;
+        ret = kErrorOk;
+    }
+    pthread_mutex_unlock(&pInstance->mutex);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Release a reference to a buffer
+
+The function releases a reference to the buffer which contains the specified
+frame. If the last reference is released, the buffer is free again and the
+recycle callback of the driver is called.
+
+\param  pBuffer_p           Pointer into the buffer.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_edrv
+*/
+//------------------------------------------------------------------------------
+tOplkError edrvrxpool_release(UINT8* pBuffer_p)
+{
+    tEdrvRxPoolInstance*    pInstance = &rxPoolInstance_l;
+    tOplkError              ret = kErrorEdrvInvalidRxBuf;
+    UINT                    index;
+
+    if (!getBufferIndex(pBuffer_p, &index))
+        return kErrorEdrvInvalidRxBuf;
+
+    pthread_mutex_lock(&pInstance->mutex);
+    if (pInstance->pRefCount[index] != 0)
+    {
+        pInstance->pRefCount[index]--;
+        // The slot is handed back to the driver within the lock, so that it
+        // cannot be acquired before the driver has recycled it.
+        if ((pInstance->pRefCount[index] == 0) && (pInstance->pfnRecycle != NULL))
+            pInstance->pfnRecycle(index);
+        ret = kErrorOk;
+    }
+    pthread_mutex_unlock(&pInstance->mutex);
+
+    return ret;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the index of a buffer
+
+\param  pBuffer_p           Pointer into the buffer.
+\param  pIndex_p            Pointer to store the index of the buffer.
+
+\return The function returns TRUE if the pointer belongs to the pool.
+*/
+//------------------------------------------------------------------------------
+static BOOL getBufferIndex(UINT8* pBuffer_p, UINT* pIndex_p)
+{
+    tEdrvRxPoolInstance*    pInstance = &rxPoolInstance_l;
+
+    if ((pInstance->pMemory == NULL) || (pBuffer_p < pInstance->pMemory) ||
+        (pBuffer_p >= pInstance->pMemory + (pInstance->bufferCount * pInstance->bufferSize)))
+        return FALSE;
+
+    *pIndex_p = (UINT)((pBuffer_p - pInstance->pMemory) / pInstance->bufferSize);
+
+    return TRUE;
+}
+
+/// \}
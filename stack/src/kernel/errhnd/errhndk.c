@@ -46,6 +46,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/benchmark.h>
 #include <oplk/obd.h>
 #include <common/ami.h>
+#include <common/nodeset.h>
+#include <common/target.h>
+#include <common/flightrec.h>
+#include <common/metrics.h>
 #include <kernel/eventk.h>
 #include <kernel/dllk.h>
 
@@ -84,6 +88,25 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
+#if (CONFIG_ERRHND_HISTORY_COALESCE_WINDOW_MS != 0)
+/**
+\brief  Coalesced error history entry
+
+The structure describes an error history entry which is currently merged. The
+first occurrence of an error is posted immediately. All identical errors within
+the window are only counted, and the last of them is posted together with the
+count once the window has elapsed.
+*/
+typedef struct
+{
+    BOOL                fUsed;                  ///< Entry is in use
+    UINT16              addInfoKey;             ///< First two bytes of the additional information (node ID or error flag)
+    UINT32              windowStart;            ///< Tick count at which the window was started
+    UINT32              mergedCount;            ///< Number of identical errors merged since the window was started
+    tErrHistoryEntry    lastEntry;              ///< Last merged history entry
+} tErrHndkHistoryCoalesce;
+#endif
+
 
 /**
 \brief  Instance of kernel error handler
@@ -94,7 +117,14 @@ typedef struct
 {
     ULONG               dllErrorEvents;                                 ///< Variable stores detected error events
     BYTE                aMnCnLossPresEvent[NUM_DLL_MNCN_LOSSPRES_OBJS]; ///< Variable stores detected error events from CNs
+    tNodeSet            mnCnPendingSet;     ///< Node IDs of CNs whose threshold counter or event needs decrementing
     tErrHndObjects      errorObjects;                                   ///< Error objects (counters and thresholds)
+#if (CONFIG_ERRHND_HISTORY_COALESCE_WINDOW_MS != 0)
+    tErrHndkHistoryCoalesce aHistoryCoalesce[CONFIG_ERRHND_HISTORY_COALESCE_ENTRIES];  ///< Error history entries currently merged
+#endif
+#if (CONFIG_METRICS != FALSE)
+    tMetric*            pMetricDllErrors;                               ///< Metric of the posted DLL error events
+#endif
 } tErrHndkInstance;
 
 //------------------------------------------------------------------------------
@@ -110,6 +140,10 @@ static tOplkError generateHistoryEntry(UINT16 errorCode_p, tNetTime netTime_p);
 static tOplkError generateHistoryEntryNodeId(UINT16 errorCode_p, tNetTime netTime_p, UINT nodeId_p);
 static void       decrementCnCounters(void);
 static tOplkError postHistoryEntryEvent(tErrHistoryEntry* pHistoryEntry_p);
+static tOplkError sendHistoryEntryEvent(tErrHistoryEntry* pHistoryEntry_p);
+#if (CONFIG_ERRHND_HISTORY_COALESCE_WINDOW_MS != 0)
+static void       flushHistoryEntries(void);
+#endif
 static tOplkError handleDllErrors(tEvent* pEvent_p);
 
 #ifdef CONFIG_INCLUDE_NMT_MN
@@ -140,6 +174,11 @@ tOplkError errhndk_init(void)
 
     ret = kErrorOk;
     instance_l.dllErrorEvents = 0;
+    nodeset_clear(&instance_l.mnCnPendingSet);
+#if (CONFIG_ERRHND_HISTORY_COALESCE_WINDOW_MS != 0)
+    OPLK_MEMSET(instance_l.aHistoryCoalesce, 0, sizeof(instance_l.aHistoryCoalesce));
+#endif
+    METRICS_REGISTER("errhndk.dll_errors", kMetricTypeCounter, &instance_l.pMetricDllErrors);
 
     ret = errhndkcal_init();
     return ret;
@@ -231,6 +270,10 @@ tOplkError errhndk_decrementCounters(BOOL fMN_p)
     // reset error events
     instance_l.dllErrorEvents = 0L;
 
+#if (CONFIG_ERRHND_HISTORY_COALESCE_WINDOW_MS != 0)
+    flushHistoryEntries();
+#endif
+
     return kErrorOk;
 }
 
@@ -253,6 +296,13 @@ tOplkError errhndk_postError(tEventDllError* pErrEvent_p)
     tOplkError              Ret;
     tEvent                  Event;
 
+#if (CONFIG_FLIGHT_RECORDER != FALSE)
+    // freeze the flight recorder before further cycles overwrite the error
+    if ((pErrEvent_p->dllErrorEvents & CONFIG_FLIGHT_RECORDER_TRIGGER) != 0)
+        flightrec_trigger(pErrEvent_p->dllErrorEvents, pErrEvent_p->nodeId);
+#endif
+    METRICS_ADD(instance_l.pMetricDllErrors, 1);
+
     Event.eventSink = kEventSinkErrk;
     Event.eventType = kEventTypeDllError;
     Event.eventArgSize = sizeof(tEventDllError);
@@ -311,39 +361,42 @@ The function decrements the error counters used by a MN node.
 //------------------------------------------------------------------------------
 static tOplkError decrementMnCounters(void)
 {
-    BYTE*           pCnNodeId;
+    UINT            nodeId;
     UINT            nodeIdx;
     UINT32          thresholdCnt;
 
-    dllk_getCurrentCnNodeIdList(&pCnNodeId);
-
-    // iterate through node info structure list
-    while (*pCnNodeId != C_ADR_INVALID)
+    // Only CNs which had a loss of PRes since their threshold counter was
+    // last zero are visited. All other CNs have nothing to decrement.
+    for (nodeId = nodeset_getNext(&instance_l.mnCnPendingSet, C_ADR_INVALID);
+         nodeId != C_ADR_INVALID;
+         nodeId = nodeset_getNext(&instance_l.mnCnPendingSet, nodeId))
     {
-        nodeIdx = *pCnNodeId - 1;
-        if (nodeIdx < NUM_DLL_MNCN_LOSSPRES_OBJS)
+        nodeIdx = nodeId - 1;
+
+        if (instance_l.aMnCnLossPresEvent[nodeIdx] ==
+            ERRORHANDLERK_CN_LOSS_PRES_EVENT_NONE)
         {
-            if (instance_l.aMnCnLossPresEvent[nodeIdx] ==
-                ERRORHANDLERK_CN_LOSS_PRES_EVENT_NONE)
+            errhndkcal_getMnCnLossPresThresholdCnt(nodeIdx, &thresholdCnt);
+            if (thresholdCnt > 0)
             {
-                errhndkcal_getMnCnLossPresThresholdCnt(nodeIdx, &thresholdCnt);
-                if (thresholdCnt > 0)
-                {
-                    thresholdCnt--;
-                    errhndkcal_setMnCnLossPresThresholdCnt(nodeIdx, thresholdCnt);
-                }
+                thresholdCnt--;
+                errhndkcal_setMnCnLossPresThresholdCnt(nodeIdx, thresholdCnt);
             }
-            else
+
+            if (thresholdCnt == 0)
             {
-                if (instance_l.aMnCnLossPresEvent[nodeIdx] ==
-                    ERRORHANDLERK_CN_LOSS_PRES_EVENT_OCC)
-                {
-                    instance_l.aMnCnLossPresEvent[nodeIdx] =
-                                          ERRORHANDLERK_CN_LOSS_PRES_EVENT_NONE;
-                }
+                NODESET_REMOVE(&instance_l.mnCnPendingSet, nodeId);
+            }
+        }
+        else
+        {
+            if (instance_l.aMnCnLossPresEvent[nodeIdx] ==
+                ERRORHANDLERK_CN_LOSS_PRES_EVENT_OCC)
+            {
+                instance_l.aMnCnLossPresEvent[nodeIdx] =
+                                      ERRORHANDLERK_CN_LOSS_PRES_EVENT_NONE;
             }
         }
-        pCnNodeId++;
     }
 
     if ((instance_l.dllErrorEvents & DLL_ERR_MN_CRC) == 0)
@@ -794,6 +847,7 @@ static tOplkError handleMnCnLossPres(tEvent* pEvent_p)
     if (threshold > 0)
     {
         thresholdCnt += 8;
+        NODESET_ADD(&instance_l.mnCnPendingSet, nodeIdx + 1);
 
         if (thresholdCnt >= threshold)
         {
@@ -921,7 +975,9 @@ static tOplkError postHeartbeatEvent(UINT nodeId_p, tNmtState state_p,
 /**
 \brief    Post a history entry event
 
-The function is used to post a history entry event to the API.
+The function is used to post a history entry event to the API. If history
+entry coalescing is enabled, identical entries (same error code and additional
+information key) within CONFIG_ERRHND_HISTORY_COALESCE_WINDOW_MS are merged.
 
 \param  pHistoryEntry_p     Pointer to event which should be posted.
 
@@ -929,6 +985,96 @@ The function is used to post a history entry event to the API.
 */
 //------------------------------------------------------------------------------
 static tOplkError postHistoryEntryEvent(tErrHistoryEntry* pHistoryEntry_p)
+{
+#if (CONFIG_ERRHND_HISTORY_COALESCE_WINDOW_MS != 0)
+    tErrHndkHistoryCoalesce*    pCoalesce;
+    tErrHndkHistoryCoalesce*    pFree = NULL;
+    UINT16                      addInfoKey;
+    UINT                        index;
+
+    addInfoKey = ami_getUint16Le(&pHistoryEntry_p->aAddInfo[0]);
+
+    for (index = 0; index < tabentries(instance_l.aHistoryCoalesce); index++)
+    {
+        pCoalesce = &instance_l.aHistoryCoalesce[index];
+        if (pCoalesce->fUsed == FALSE)
+        {
+            if (pFree == NULL)
+                pFree = pCoalesce;
+            continue;
+        }
+
+        if ((pCoalesce->lastEntry.errorCode == pHistoryEntry_p->errorCode) &&
+            (pCoalesce->addInfoKey == addInfoKey))
+        {   // identical error within the window, only count it
+            pCoalesce->mergedCount++;
+            OPLK_MEMCPY(&pCoalesce->lastEntry, pHistoryEntry_p, sizeof(*pHistoryEntry_p));
+            return kErrorOk;
+        }
+    }
+
+    if (pFree != NULL)
+    {   // first occurrence, open a window and post the entry immediately
+        pFree->fUsed = TRUE;
+        pFree->addInfoKey = addInfoKey;
+        pFree->windowStart = target_getTickCount();
+        pFree->mergedCount = 0;
+        OPLK_MEMCPY(&pFree->lastEntry, pHistoryEntry_p, sizeof(*pHistoryEntry_p));
+    }
+    // if all entries are in use the error is posted without coalescing
+#endif
+
+    return sendHistoryEntryEvent(pHistoryEntry_p);
+}
+
+#if (CONFIG_ERRHND_HISTORY_COALESCE_WINDOW_MS != 0)
+//------------------------------------------------------------------------------
+/**
+\brief    Flush coalesced history entries
+
+The function closes all coalescing windows which have elapsed. If identical
+errors were merged within a window, the last of them is posted with the number
+of merged errors stored in bytes 4..7 of the additional information.
+*/
+//------------------------------------------------------------------------------
+static void flushHistoryEntries(void)
+{
+    tErrHndkHistoryCoalesce*    pCoalesce;
+    UINT32                      tickCount;
+    UINT                        index;
+
+    tickCount = target_getTickCount();
+
+    for (index = 0; index < tabentries(instance_l.aHistoryCoalesce); index++)
+    {
+        pCoalesce = &instance_l.aHistoryCoalesce[index];
+        if ((pCoalesce->fUsed == FALSE) ||
+            ((tickCount - pCoalesce->windowStart) < CONFIG_ERRHND_HISTORY_COALESCE_WINDOW_MS))
+            continue;
+
+        if (pCoalesce->mergedCount > 0)
+        {
+            ami_setUint32Le(&pCoalesce->lastEntry.aAddInfo[4], pCoalesce->mergedCount);
+            if (sendHistoryEntryEvent(&pCoalesce->lastEntry) != kErrorOk)
+                continue;   // retry in the next cycle
+        }
+        pCoalesce->fUsed = FALSE;
+    }
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief    Send a history entry event
+
+The function sends a history entry event to the API.
+
+\param  pHistoryEntry_p     Pointer to event which should be posted.
+
+\return Returns kErrorOk or error code
+*/
+//------------------------------------------------------------------------------
+static tOplkError sendHistoryEntryEvent(tErrHistoryEntry* pHistoryEntry_p)
 {
     tOplkError              ret;
     tEvent                  event;
@@ -998,6 +1144,7 @@ static tOplkError generateHistoryEntryNodeId(UINT16 errorCode_p,
 
     historyEntry.errorCode = errorCode_p;
     historyEntry.timeStamp = netTime_p;
+    OPLK_MEMSET(historyEntry.aAddInfo, 0, sizeof(historyEntry.aAddInfo));
     ami_setUint8Le(&historyEntry.aAddInfo[0], (BYTE)nodeId_p);
 
     ret = postHistoryEntryEvent(&historyEntry);
@@ -1033,6 +1180,7 @@ static tOplkError generateHistoryEntryWithError(UINT16 errorCode_p,
 
     historyEntry.errorCode = errorCode_p;
     historyEntry.timeStamp = netTime_p;
+    OPLK_MEMSET(historyEntry.aAddInfo, 0, sizeof(historyEntry.aAddInfo));
     ami_setUint16Le(&historyEntry.aAddInfo[0], (UINT16)oplkError_p);
 
     ret = postHistoryEntryEvent(&historyEntry);
@@ -89,12 +89,35 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
+static tOplkError processNmtkEvent(tEvent* pEvent_p);
 static tOplkError handleNmtEventinDll(tEvent* pEvent_p);
 
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
 
+/**
+\brief  Event dispatch table
+
+The following table defines the event handlers to be used for the specific
+event sinks. The event source is reported if the handler returns an error.
+*/
+static tEventDispatchEntry eventDispatchTbl_l[] =
+{
+    { kEventSinkDllk,        kEventSourceDllk,        dllk_process },
+#if defined(CONFIG_INCLUDE_PDO)
+    { kEventSinkPdokCal,     kEventSourcePdok,        pdokcal_process },
+#endif
+    { kEventSinkDllkCal,     kEventSourceDllk,        dllkcal_process },
+    // errors of nmtk_process() are reported by processNmtkEvent() itself,
+    // the returned error is the one of the DLL SoA preprocessing
+    { kEventSinkNmtk,        kEventSourceDllk,        processNmtkEvent },
+    { kEventSinkErrk,        kEventSourceErrk,        errhndk_process },
+    { kEventSinkInvalid,     kEventSourceInvalid,     NULL }
+};
+
+static tEventDispatchEntry* apDispatchIndex_l[EVENT_SINK_COUNT];    ///< Dispatch table entries indexed by sink
+
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
 //============================================================================//
@@ -117,6 +140,8 @@ tOplkError eventk_init (void)
 {
     tOplkError  ret = kErrorOk;
 
+    event_initDispatchIndex(eventDispatchTbl_l, apDispatchIndex_l);
+
     ret = eventkcal_init();
 
     return ret;
@@ -165,54 +190,23 @@ tOplkError eventk_process(tEvent* pEvent_p)
 {
     tOplkError              ret = kErrorOk;
     tEventSource            eventSource;
+    tProcessEventCb         pfnEventHandler;
 
-    switch (pEvent_p->eventSink)
-    {
-        // Note: case statements are sorted for best performance!
-        case kEventSinkDllk:
-            ret = dllk_process(pEvent_p);
-            eventSource = kEventSourceDllk;
-            break;
-
-#if defined(CONFIG_INCLUDE_PDO)
-        case kEventSinkPdokCal:
-            ret = pdokcal_process(pEvent_p);
-            eventSource = kEventSourcePdok;
-            break;
-#endif
-        case kEventSinkDllkCal:
-            ret = dllkcal_process(pEvent_p);
-            eventSource = kEventSourceDllk;
-            break;
-
-        case kEventSinkNmtk:
-            ret = nmtk_process(pEvent_p);
-            eventSource = kEventSourceNmtk;
-            if ((ret != kErrorOk) && (ret != kErrorShutdown))
-            {
-                // forward error event to API layer
-                eventk_postError(kEventSourceEventk, ret,
-                                 sizeof(eventSource),
-                                 &eventSource);
-            }
-            ret = handleNmtEventinDll(pEvent_p);
-            eventSource = kEventSourceDllk;
-            break;
+    BINTRACE2(kBinTraceIdEventkProcessBegin, pEvent_p->eventSink, pEvent_p->eventType);
 
-        case kEventSinkErrk:
-            ret = errhndk_process(pEvent_p);
-            eventSource = kEventSourceErrk;
-            break;
-
-        default:
-            // Unknown sink, provide error event to API layer
-            eventk_postError(kEventSourceEventk, ret,
-                             sizeof(pEvent_p->eventSink),
-                             &pEvent_p->eventSink);
-            ret = kErrorEventUnknownSink;
-            break;
+    ret = event_getHandlerForSink(apDispatchIndex_l, pEvent_p->eventSink,
+                                  &pfnEventHandler, &eventSource);
+    if (ret == kErrorEventUnknownSink)
+    {
+        // Unknown sink, provide error event to API layer
+        eventk_postError(kEventSourceEventk, ret,
+                         sizeof(pEvent_p->eventSink),
+                         &pEvent_p->eventSink);
+        BINTRACE2(kBinTraceIdEventkProcessEnd, pEvent_p->eventSink, ret);
+        return ret;
     }
 
+    ret = pfnEventHandler(pEvent_p);
     if ((ret != kErrorOk) && (ret != kErrorShutdown))
     {
         // forward error event to API layer
@@ -221,6 +215,7 @@ tOplkError eventk_process(tEvent* pEvent_p)
                          &eventSource);
     }
 
+    BINTRACE2(kBinTraceIdEventkProcessEnd, pEvent_p->eventSink, ret);
     return ret;
 }
 
@@ -249,6 +244,7 @@ tOplkError eventk_postEvent(tEvent* pEvent_p)
         case kEventSinkNmtMnu:
         case kEventSinkNmtu:
         case kEventSinkSdoAsySeq:
+        case kEventSinkSdoCom:
         case kEventSinkApi:
         case kEventSinkDlluCal:
         case kEventSinkErru:
@@ -301,6 +297,8 @@ tOplkError eventk_postError(tEventSource eventSource_p, tOplkError oplkError_p,
 
     ret = kErrorOk;
 
+    BINTRACE2(kBinTraceIdEventkError, eventSource_p, oplkError_p);
+
     // create argument
     eventError.eventSource = eventSource_p;
     eventError.oplkError = oplkError_p;
@@ -325,6 +323,38 @@ tOplkError eventk_postError(tEventSource eventSource_p, tOplkError oplkError_p,
 /// \name Private Functions
 /// \{
 
+//------------------------------------------------------------------------------
+/**
+\brief  Process NMT kernel event
+
+This function forwards an event to the NMT kernel module and afterwards to the
+DLLk module if the DLL has to handle it as well.
+
+\param  pEvent_p                Event to process.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                Function executes correctly
+\retval other error codes       An error occurred
+*/
+//------------------------------------------------------------------------------
+static tOplkError processNmtkEvent(tEvent* pEvent_p)
+{
+    tOplkError          ret;
+    tEventSource        eventSource;
+
+    ret = nmtk_process(pEvent_p);
+    if ((ret != kErrorOk) && (ret != kErrorShutdown))
+    {
+        // forward error event to API layer
+        eventSource = kEventSourceNmtk;
+        eventk_postError(kEventSourceEventk, ret,
+                         sizeof(eventSource),
+                         &eventSource);
+    }
+
+    return handleNmtEventinDll(pEvent_p);
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Handle NMT event in DLL
@@ -62,7 +62,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
-#define KERNEL_EVENT_THREAD_PRIORITY        55
+#ifndef CONFIG_THREAD_PRIORITY_EVENTK
+#define CONFIG_THREAD_PRIORITY_EVENTK       55
+#endif
 
 //------------------------------------------------------------------------------
 // module global vars
@@ -79,6 +81,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+// The semaphore is posted to stop the thread, so the timeout only limits the
+// time the thread sleeps while no events are posted.
+#define EVENTKCAL_THREAD_IDLE_TIMEOUT_MS  1000
 
 //------------------------------------------------------------------------------
 // local types
@@ -97,6 +102,7 @@ typedef struct
     sem_t*                  semUserData;
     sem_t*                  semKernelData;
     BOOL                    fInitialized;
+    tEventBatchStatistics   batchStatistics;
 } tEventkCalInstance;
 
 //------------------------------------------------------------------------------
@@ -108,6 +114,7 @@ static tEventkCalInstance   instance_l;             ///< Instance variable of ke
 // local function prototypes
 //------------------------------------------------------------------------------
 static void* eventThread(void* arg);
+static BOOL processEventBatch(tEventkCalInstance* pInstance_p);
 static void signalKernelEvent(void);
 static void signalUserEvent(void);
 
@@ -130,8 +137,6 @@ The function initializes the kernel event CAL module on Linux.
 //------------------------------------------------------------------------------
 tOplkError eventkcal_init(void)
 {
-    struct sched_param  schedParam;
-
     OPLK_MEMSET(&instance_l, 0, sizeof(tEventkCalInstance));
 
     if ((instance_l.semUserData = sem_open("/semUserEvent", O_CREAT | O_RDWR, S_IRWXG, 0)) == SEM_FAILED)
@@ -154,20 +159,18 @@ tOplkError eventkcal_init(void)
     eventkcal_setSignalingCircbuf(kEventQueueKInt, signalKernelEvent);
 
     instance_l.fStopThread = FALSE;
-    if (pthread_create(&instance_l.threadId, NULL, eventThread, (void*)&instance_l) != 0)
+    if (target_createThread(&instance_l.threadId, kThreadRoleEventK, "oplk-eventk",
+                            eventThread, (void*)&instance_l) != kErrorOk)
         goto Exit;
 
-    schedParam.__sched_priority = KERNEL_EVENT_THREAD_PRIORITY;
-    if (pthread_setschedparam(instance_l.threadId, SCHED_FIFO, &schedParam) != 0)
+    if (target_setThreadParams(instance_l.threadId, kThreadRoleEventK, kThreadSchedFifo,
+                               CONFIG_THREAD_PRIORITY_EVENTK,
+                               CONFIG_THREAD_CPU_MASK_EVENT) != kErrorOk)
     {
         DEBUG_LVL_ERROR_TRACE("%s(): couldn't set thread scheduling parameters! %d\n",
-               __func__, schedParam.__sched_priority);
+               __func__, CONFIG_THREAD_PRIORITY_EVENTK);
     }
 
-#if (defined(__GLIBC__) && __GLIBC__ >= 2 && __GLIBC_MINOR__ >= 12)
-    pthread_setname_np(instance_l.threadId, "oplk-eventk");
-#endif
-
     instance_l.fInitialized = TRUE;
     return kErrorOk;
 
@@ -207,6 +210,7 @@ tOplkError eventkcal_exit(void)
     if (instance_l.fInitialized == TRUE)
     {
         instance_l.fStopThread = TRUE;
+        sem_post(instance_l.semKernelData);
         while (instance_l.fStopThread == TRUE)
         {
             target_msleep(10);
@@ -291,17 +295,105 @@ void eventkcal_process(void)
     // Nothing to do, because we use threads
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get batch statistics of event thread
+
+This function returns the statistics of the batched event processing of the
+event handler thread.
+
+\param  pStatistics_p           Pointer to store the statistics.
+
+\ingroup module_eventkcal
+*/
+//------------------------------------------------------------------------------
+void eventkcal_getBatchStatistics(tEventBatchStatistics* pStatistics_p)
+{
+    OPLK_MEMCPY(pStatistics_p, &instance_l.batchStatistics, sizeof(tEventBatchStatistics));
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
 /// \name Private Functions
 /// \{
 
+//------------------------------------------------------------------------------
+/**
+\brief  Process a batch of events
+
+This function processes the events of the queues handled by the event thread
+until the queues are empty or the event or time budget of the batch
+(CONFIG_EVENT_BATCH_MAX_EVENTS, CONFIG_EVENT_BATCH_TIME_BUDGET_US) is exceeded.
+The batch statistics are updated accordingly.
+
+\param  pInstance_p             Pointer to the instance.
+
+\return The function returns TRUE if the batch was stopped by the budget and
+        events could be left in the queues.
+*/
+//------------------------------------------------------------------------------
+static BOOL processEventBatch(tEventkCalInstance* pInstance_p)
+{
+    struct timespec         startTime, curTime;
+    tEventBatchStatistics*  pStatistics = &pInstance_p->batchStatistics;
+    UINT32                  eventCount = 0;
+    UINT32                  batchTime = 0;
+    BOOL                    fBudgetExceeded = FALSE;
+
+    clock_gettime(CLOCK_MONOTONIC, &startTime);
+
+    for (;;)
+    {
+        /* first handle kernel internal events --> higher priority! */
+        if (eventkcal_getEventCountCircbuf(kEventQueueKInt) > 0)
+            eventkcal_processEventCircbuf(kEventQueueKInt);
+        else if (eventkcal_getEventCountCircbuf(kEventQueueU2K) > 0)
+            eventkcal_processEventCircbuf(kEventQueueU2K);
+        else
+            break;
+
+        eventCount++;
+
+        clock_gettime(CLOCK_MONOTONIC, &curTime);
+        batchTime = (UINT32)((curTime.tv_sec - startTime.tv_sec) * 1000000000L +
+                             (curTime.tv_nsec - startTime.tv_nsec));
+
+        if (((CONFIG_EVENT_BATCH_MAX_EVENTS != 0) &&
+             (eventCount >= CONFIG_EVENT_BATCH_MAX_EVENTS)) ||
+            ((CONFIG_EVENT_BATCH_TIME_BUDGET_US != 0) &&
+             (batchTime >= CONFIG_EVENT_BATCH_TIME_BUDGET_US * 1000UL)))
+        {
+            fBudgetExceeded = TRUE;
+            break;
+        }
+    }
+
+    if (eventCount > 0)
+    {
+        pStatistics->batchCount++;
+        pStatistics->eventCount += eventCount;
+        pStatistics->lastBatchSize = eventCount;
+        if (eventCount > pStatistics->maxBatchSize)
+            pStatistics->maxBatchSize = eventCount;
+        if (fBudgetExceeded)
+            pStatistics->budgetExceededCount++;
+        pStatistics->lastBatchTime = batchTime;
+        if (batchTime > pStatistics->maxBatchTime)
+            pStatistics->maxBatchTime = batchTime;
+        pStatistics->totalBatchTime += batchTime;
+    }
+
+    return fBudgetExceeded;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Event handler thread function
 
-This function contains the main function for the event handler thread.
+This function contains the main function for the event handler thread. The
+thread is woken up when the queues change from empty to non-empty and then
+processes the events in batches.
 
 \param  arg                     Thread parameter. Not used!
 
@@ -312,29 +404,23 @@ static void * eventThread(void *arg)
 {
     struct timespec         curTime, timeout;
     tEventkCalInstance*     pInstance = (tEventkCalInstance*)arg;
+    BOOL                    fPending = FALSE;
 
     while (!pInstance->fStopThread)
     {
-        clock_gettime(CLOCK_REALTIME, &curTime);
-        timeout.tv_sec = 0;
-        timeout.tv_nsec = 50000 * 1000;
-        TIMESPECADD(&timeout, &curTime);
-
-        if (sem_timedwait(pInstance->semKernelData, &timeout) == 0)
+        // Don't wait if the last batch was stopped with events left in the queues
+        if (!fPending)
         {
-            /* first handle kernel internal events --> higher priority! */
-            if (eventkcal_getEventCountCircbuf(kEventQueueKInt) > 0)
-            {
-                eventkcal_processEventCircbuf(kEventQueueKInt);
-            }
-            else
-            {
-                if (eventkcal_getEventCountCircbuf(kEventQueueU2K) > 0)
-                {
-                    eventkcal_processEventCircbuf(kEventQueueU2K);
-                }
-            }
+            clock_gettime(CLOCK_REALTIME, &curTime);
+            timeout.tv_sec = EVENTKCAL_THREAD_IDLE_TIMEOUT_MS / 1000;
+            timeout.tv_nsec = (EVENTKCAL_THREAD_IDLE_TIMEOUT_MS % 1000) * 1000000;
+            TIMESPECADD(&timeout, &curTime);
+
+            if (sem_timedwait(pInstance->semKernelData, &timeout) != 0)
+                continue;
         }
+
+        fPending = processEventBatch(pInstance);
     }
 
     pInstance->fStopThread = FALSE;
@@ -351,6 +437,12 @@ the circular buffer library as signal callback function
 //------------------------------------------------------------------------------
 void signalUserEvent(void)
 {
+    int     semValue;
+
+    // The event thread drains the queue, so a pending wakeup is sufficient
+    if ((sem_getvalue(instance_l.semUserData, &semValue) == 0) && (semValue > 0))
+        return;
+
     sem_post(instance_l.semUserData);
 }
 
@@ -364,6 +456,12 @@ the circular buffer library as signal callback function
 //------------------------------------------------------------------------------
 void signalKernelEvent(void)
 {
+    int     semValue;
+
+    // The event thread drains the queue, so a pending wakeup is sufficient
+    if ((sem_getvalue(instance_l.semKernelData, &semValue) == 0) && (semValue > 0))
+        return;
+
     sem_post(instance_l.semKernelData);
 }
 
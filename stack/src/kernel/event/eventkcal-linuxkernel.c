@@ -5,7 +5,16 @@
 \brief  Kernel event CAL module for Linux kernelspace
 
 This file implements the kernel event handler CAL module for the Linux
-kernelspace platform. It uses the circular buffer interface for all event queues.
+kernelspace platform. It uses the circular buffer interface for the queues
+between the kernel and the user layer.
+
+Kernel events and events to the user layer are posted into lock-free
+single-producer/single-consumer producer rings. Every CPU has a ring for each
+context level (task, softirq and hardirq), so a posting context can only be
+interrupted by a context which uses another ring and interrupts are never
+disabled while an event is posted. The event thread is the only consumer of
+the rings. It processes the events in the order of their global sequence
+numbers and is the only producer of the K2U queue.
 
 \see eventkcalintf-circbuf.c
 
@@ -46,16 +55,24 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/oplk.h>
 #include <oplk/debugstr.h>
 
+#include <kernel/eventk.h>
 #include <kernel/eventkcal.h>
 #include <kernel/eventkcalintf.h>
+#include <kernel/edrvirq.h>
 #include <common/circbuffer.h>
 
+#include "circbuf-arch.h"
+
 #include <linux/kthread.h>
 #include <asm/uaccess.h>
 #include <asm/atomic.h>
 #include <linux/errno.h>
 #include <linux/wait.h>
 #include <linux/delay.h>
+#include <linux/poll.h>
+#include <linux/slab.h>
+#include <linux/percpu.h>
+#include <linux/hardirq.h>
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -80,11 +97,57 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#if ((CONFIG_EVENT_SIZE_PRODUCER_RING & (CONFIG_EVENT_SIZE_PRODUCER_RING - 1)) != 0)
+#error "CONFIG_EVENT_SIZE_PRODUCER_RING must be a power of 2!"
+#endif
+
+#define EVENTK_RING_LEVEL_TASK      0               ///< Ring used in task context
+#define EVENTK_RING_LEVEL_SOFTIRQ   1               ///< Ring used in softirq context
+#define EVENTK_RING_LEVEL_HARDIRQ   2               ///< Ring used in hardirq context
+#define EVENTK_RING_LEVELS          3               ///< Number of rings per CPU
+
+#define EVENTK_RING_ALIGNMENT       8               ///< Alignment of the blocks in a ring
+#define EVENTK_RING_PADDING         0xFFFFFFFF      ///< Block size of a padding block at the end of a ring
 
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
 
+/**
+\brief Header of a block in a producer ring
+
+The header is followed by the event and its argument.
+*/
+typedef struct
+{
+    UINT32                  blockSize;          ///< Size of the block including the header or EVENTK_RING_PADDING
+    UINT32                  sequence;           ///< Global sequence number of the event
+    UINT32                  eventQueue;         ///< Queue the event is posted to (tEventQueue)
+    UINT32                  reserved;           ///< Keeps the event aligned
+} tEventkRingBlock;
+
+/**
+\brief Producer ring
+
+The ring is written by the contexts of a single context level of a CPU and
+read by the event thread. The head and the tail are free running byte counters
+which are only written by the producer and the consumer respectively.
+*/
+typedef struct
+{
+    UINT32                  head ____cacheline_aligned_in_smp;  ///< Write position, written by the producer
+    UINT32                  tail ____cacheline_aligned_in_smp;  ///< Read position, written by the consumer
+    BYTE*                   pBuffer;            ///< Ring memory
+} tEventkRing;
+
+/**
+\brief Producer rings of a CPU
+*/
+typedef struct
+{
+    tEventkRing             aRing[EVENTK_RING_LEVELS];  ///< Rings of the context levels
+} tEventkCpuRings;
+
 /**
 \brief Kernel event CAL instance type
 
@@ -96,18 +159,18 @@ typedef struct
     struct task_struct*     threadId;
     wait_queue_head_t       kernelWaitQueue;
     wait_queue_head_t       userWaitQueue;
-    atomic_t                userEventCount;
-    atomic_t                kernelEventCount;
+    atomic_t                fRingEventPending;  ///< An event was posted into a producer ring
+    atomic_t                ringSequence;       ///< Sequence number of the last event posted into a producer ring
+    atomic_t                ringPostErrorCount; ///< Number of events lost because a producer ring was full
     BOOL                    fThreadIsRunning;
     BOOL                    fInitialized;
-    BYTE                    aUintRxBuffer[sizeof(tEvent) + MAX_EVENT_ARG_SIZE];
-    BYTE                    aK2URxBuffer[sizeof(tEvent) + MAX_EVENT_ARG_SIZE];
 } tEventkCalInstance;
 
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
 static tEventkCalInstance   instance_l;             ///< Instance variable of kernel event CAL module
+static DEFINE_PER_CPU(tEventkCpuRings, cpuRings_l);  ///< Producer rings of the CPUs
 
 
 //------------------------------------------------------------------------------
@@ -115,7 +178,10 @@ static tEventkCalInstance   instance_l;             ///< Instance variable of ke
 //------------------------------------------------------------------------------
 static int eventThread(void* arg);
 static void signalUserEvent(void);
-static void signalKernelEvent(void);
+static tOplkError initProducerRings(void);
+static void exitProducerRings(void);
+static tOplkError postProducerRing(tEventQueue eventQueue_p, const tEvent* pEvent_p);
+static BOOL processProducerRing(void);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -129,6 +195,10 @@ The function initializes the kernel event CAL module. Depending on the
 configuration it gets the function pointer interface of the used queue
 implementations and calls the appropriate init functions.
 
+The K2U and U2K queues are mapped into the user library (see
+eventkcal_getQueueMem()) and must therefore be lock-free circular buffers.
+The user-internal queue is handled completely by the user library.
+
 \return The function returns a tOplkError error code.
 \retval kErrorOk                Function executes correctly
 \retval other error codes       An error occurred
@@ -142,8 +212,16 @@ tOplkError eventkcal_init(void)
 
     init_waitqueue_head(&instance_l.kernelWaitQueue);
     init_waitqueue_head(&instance_l.userWaitQueue);
-    atomic_set(&instance_l.kernelEventCount, 0);
-    atomic_set(&instance_l.userEventCount, 0);
+    atomic_set(&instance_l.fRingEventPending, 0);
+    atomic_set(&instance_l.ringSequence, 0);
+    atomic_set(&instance_l.ringPostErrorCount, 0);
+
+    if (!CIRCBUF_IS_LOCKFREE(CIRCBUF_KERNEL_TO_USER_QUEUE) ||
+        !CIRCBUF_IS_LOCKFREE(CIRCBUF_USER_TO_KERNEL_QUEUE))
+    {
+        TRACE("%s() K2U and U2K queues must be lock-free!\n", __func__);
+        return kErrorNoResource;
+    }
 
     if (eventkcal_initQueueCircbuf(kEventQueueK2U) != kErrorOk)
         goto Exit;
@@ -151,20 +229,13 @@ tOplkError eventkcal_init(void)
     if (eventkcal_initQueueCircbuf(kEventQueueU2K) != kErrorOk)
         goto Exit;
 
-    if (eventkcal_initQueueCircbuf(kEventQueueKInt) != kErrorOk)
-        goto Exit;
-
-    if (eventkcal_initQueueCircbuf(kEventQueueUInt) != kErrorOk)
+    if (initProducerRings() != kErrorOk)
         goto Exit;
 
+    // The user library is only woken up if the K2U queue gets non-empty. The
+    // U2K queue is signaled by the user library with PLK_CMD_SIGNAL_EVENT.
     eventkcal_setSignalingCircbuf(kEventQueueK2U, signalUserEvent);
 
-    eventkcal_setSignalingCircbuf(kEventQueueU2K, signalKernelEvent);
-
-    eventkcal_setSignalingCircbuf(kEventQueueUInt, signalUserEvent);
-
-    eventkcal_setSignalingCircbuf(kEventQueueKInt, signalKernelEvent);
-
     instance_l.threadId =  kthread_run(eventThread, NULL, "EventkThread");
 
     set_cpus_allowed(instance_l.threadId, cpumask_of_cpu(1));
@@ -177,8 +248,7 @@ Exit:
     TRACE("%s() Initialization error!\n", __func__);
     eventkcal_exitQueueCircbuf(kEventQueueK2U);
     eventkcal_exitQueueCircbuf(kEventQueueU2K);
-    eventkcal_exitQueueCircbuf(kEventQueueKInt);
-    eventkcal_exitQueueCircbuf(kEventQueueUInt);
+    exitProducerRings();
 
     return kErrorNoResource;
 }
@@ -203,6 +273,7 @@ tOplkError eventkcal_exit(void)
 
     instance_l.fInitialized = FALSE;
 
+    edrvirq_removeThread(kEdrvIrqThreadEventk);
     kthread_stop(instance_l.threadId);
 
     while(instance_l.fThreadIsRunning)
@@ -217,8 +288,13 @@ tOplkError eventkcal_exit(void)
 
     eventkcal_exitQueueCircbuf(kEventQueueK2U);
     eventkcal_exitQueueCircbuf(kEventQueueU2K);
-    eventkcal_exitQueueCircbuf(kEventQueueUInt);
-    eventkcal_exitQueueCircbuf(kEventQueueKInt);
+    exitProducerRings();
+
+    if (atomic_read(&instance_l.ringPostErrorCount) != 0)
+    {
+        TRACE("%s() %d events lost in full producer rings\n",
+              __func__, atomic_read(&instance_l.ringPostErrorCount));
+    }
 
     return kErrorOk;
 }
@@ -229,7 +305,10 @@ tOplkError eventkcal_exit(void)
 
 This function posts a event to a queue. It is called from the generic kernel
 event post function in the event handler. Depending on the sink the appropriate
-queue post function is called.
+queue post function is called. The K2U queue is lock-free and has a single
+consumer in user space. The event thread posts directly into the K2U queue,
+all other contexts post into their producer ring and the event thread forwards
+the event.
 
 \param  pEvent_p                Event to be posted.
 
@@ -250,7 +329,12 @@ tOplkError eventkcal_postUserEvent(tEvent* pEvent_p)
            pEvent_p->eventArgSize);*/
 
     if (instance_l.fInitialized)
-        ret = eventkcal_postEventCircbuf(kEventQueueK2U, pEvent_p);
+    {
+        if (current == instance_l.threadId)
+            ret = eventkcal_postEventCircbuf(kEventQueueK2U, pEvent_p);
+        else
+            ret = postProducerRing(kEventQueueK2U, pEvent_p);
+    }
     else
         ret = kErrorIllegalInstance;
 
@@ -262,8 +346,8 @@ tOplkError eventkcal_postUserEvent(tEvent* pEvent_p)
 \brief    Post kernel event
 
 This function posts an event to a queue. It is called from the generic kernel
-event post function in the event handler. Depending on the sink the appropriate
-queue post function is called.
+event post function in the event handler. The event is posted into the producer
+ring of the calling context.
 
 \param  pEvent_p                Event to be posted.
 
@@ -284,7 +368,7 @@ tOplkError eventkcal_postKernelEvent(tEvent* pEvent_p)
            pEvent_p->eventArgSize);*/
 
     if (instance_l.fInitialized)
-        ret = eventkcal_postEventCircbuf(kEventQueueKInt, pEvent_p);
+        ret = postProducerRing(kEventQueueKInt, pEvent_p);
     else
         ret = kErrorIllegalInstance;
 
@@ -306,167 +390,86 @@ void eventkcal_process(void)
 
 //------------------------------------------------------------------------------
 /**
-\brief    Post event from user
+\brief    Get memory of event queue
 
-This function posts a event from the user layer to a queue.
+This function returns the shared memory of an event queue which is mapped into
+the user library. The memory has the same layout as the posixshm circular
+buffers: the queue header is followed by the queue data at the next page
+boundary. Only the K2U and U2K queues can be mapped.
 
-\param  arg                Ioctl argument. Contains the event to post.
+\param  eventQueue_p            Event queue to get the memory for.
+\param  pSize_p                 Pointer to store the size of the memory.
 
-\return The function returns Linux error code.
+\return The function returns the start of the memory or NULL on error.
 
 \ingroup module_eventkcal
 */
 //------------------------------------------------------------------------------
-int eventkcal_postEventFromUser(unsigned long arg)
+BYTE* eventkcal_getQueueMem(tEventQueue eventQueue_p, size_t* pSize_p)
 {
-    tOplkError      ret = kErrorOk;
-    tEvent          event;
-    char*           pArg = NULL;
-    int             order = 0;
-
     if (!instance_l.fInitialized)
-        return -EIO;
-
-    if (copy_from_user(&event, (const void __user *)arg, sizeof(tEvent)))
-        return -EFAULT;
-
-    if (event.eventArgSize != 0)
-    {
-        order = get_order(event.eventArgSize);
-        pArg = (BYTE*)__get_free_pages(GFP_KERNEL, order);
-
-        if (!pArg)
-            return -EIO;
-
-        //TRACE("%s() allocated %d Bytes at %p\n", __func__, event.eventArgSize, pArg);
-        if (copy_from_user(pArg, (const void __user *)event.pEventArg, event.eventArgSize))
-        {
-            free_pages((ULONG)pArg, order);
-            return -EFAULT;
-        }
-        event.pEventArg = pArg;
-    }
+        return NULL;
 
-    switch (event.eventSink)
+    switch (eventQueue_p)
     {
-        case kEventSinkSync:
-        case kEventSinkNmtk:
-        case kEventSinkDllk:
-        case kEventSinkDllkCal:
-        case kEventSinkPdok:
-        case kEventSinkPdokCal:
-        case kEventSinkErrk:
-            /*TRACE("U2K  type:%s(%d) sink:%s(%d) size:%d!\n",
-                   debugstr_getEventTypeStr(event.eventType), event.eventType,
-                   debugstr_getEventSinkStr(event.eventSink), event.eventSink,
-                   event.eventArgSize);*/
-            ret = eventkcal_postEventCircbuf(kEventQueueU2K, &event);
-            break;
+        case kEventQueueK2U:
+            return circbuf_getSharedMem(CIRCBUF_KERNEL_TO_USER_QUEUE, pSize_p);
 
-        case kEventSinkNmtMnu:
-        case kEventSinkNmtu:
-        case kEventSinkSdoAsySeq:
-        case kEventSinkApi:
-        case kEventSinkDlluCal:
-        case kEventSinkErru:
-        case kEventSinkLedu:
-            /*TRACE("UINT type:%s(%d) sink:%s(%d) size:%d!\n",
-                   debugstr_getEventTypeStr(event.eventType), event.eventType,
-                   debugstr_getEventSinkStr(event.eventSink), event.eventSink,
-                   event.eventArgSize);*/
-            ret = eventkcal_postEventCircbuf(kEventQueueUInt, &event);
-            break;
+        case kEventQueueU2K:
+            return circbuf_getSharedMem(CIRCBUF_USER_TO_KERNEL_QUEUE, pSize_p);
 
         default:
-            ret = -EIO;
-            break;
+            return NULL;
     }
-
-    if (event.eventArgSize != 0)
-        free_pages((ULONG)pArg, order);
-
-    return 0;
 }
 
 //------------------------------------------------------------------------------
 /**
-\brief    Get an event for the user layer
-
-This function waits for events to the user.
+\brief    Signal event from user
 
-\param  arg                Ioctl argument. Contains the received event.
+This function wakes up the event thread after the user library posted an event
+into the empty U2K queue.
 
 \return The function returns Linux error code.
 
 \ingroup module_eventkcal
 */
 //------------------------------------------------------------------------------
-int eventkcal_getEventForUser(unsigned long arg)
+int eventkcal_signalEventFromUser(void)
 {
-    tOplkError          error;
-    int                 ret;
-    size_t              readSize;
-    int                 timeout = 500 * HZ / 1000;
-
     if (!instance_l.fInitialized)
         return -EIO;
 
-    ret = wait_event_interruptible_timeout(instance_l.userWaitQueue,
-                             (atomic_read(&instance_l.userEventCount) > 0), timeout);
-    if (ret == 0)
-    {
-        //TRACE("%s() timeout!\n", __func__);
-        return -ERESTARTSYS;
-    }
-
-    if (ret == -ERESTARTSYS)
-    {
-        //TRACE("%s() interrupted\n", __func__);
-        return ret;
-    }
-
-    if (!instance_l.fInitialized)
-        return -EIO;
+    wake_up_interruptible(&instance_l.kernelWaitQueue);
+    return 0;
+}
 
-    if (eventkcal_getEventCountCircbuf(kEventQueueK2U) > 0)
-    {
-        atomic_dec(&instance_l.userEventCount);
+//------------------------------------------------------------------------------
+/**
+\brief    Poll for events to the user layer
 
-        error = eventkcal_getEventCircbuf(kEventQueueK2U, instance_l.aK2URxBuffer, &readSize);
-        if(error != kErrorOk)
-        {
-            DEBUG_LVL_ERROR_TRACE("%s() Error reading K2U events %d!\n", __func__, error);
-            return -EIO;
-        }
+This function implements the poll operation of the driver. The device is
+readable as long as the K2U queue contains events.
 
-        //TRACE("%s() copy kernel event to user: %d Bytes\n", __func__, readSize);
-        if (copy_to_user((void __user *)arg, instance_l.aK2URxBuffer, readSize))
-            return -EFAULT;
+\param  pFile_p                 File pointer of the device.
+\param  pWait_p                 Poll table of the caller.
 
-        return 0;
-    }
-    else
-    {
+\return The function returns the poll mask.
 
-        if (eventkcal_getEventCountCircbuf(kEventQueueUInt) > 0)
-        {
-            atomic_dec(&instance_l.userEventCount);
+\ingroup module_eventkcal
+*/
+//------------------------------------------------------------------------------
+unsigned int eventkcal_pollEventForUser(struct file* pFile_p, struct poll_table_struct* pWait_p)
+{
+    if (!instance_l.fInitialized)
+        return POLLERR;
 
-            error = eventkcal_getEventCircbuf(kEventQueueUInt, instance_l.aUintRxBuffer, &readSize);
-            if(error != kErrorOk)
-            {
-                DEBUG_LVL_ERROR_TRACE ("%s() Error reading UINT events %d!\n", __func__, error);
-                return -EIO;
-            }
+    poll_wait(pFile_p, &instance_l.userWaitQueue, pWait_p);
 
-            //TRACE("%s() copy user event to user: %d Bytes\n", __func__, readSize);
-            if(copy_to_user((void __user *)arg, instance_l.aUintRxBuffer, readSize))
-                return -EFAULT;
+    if (eventkcal_getEventCountCircbuf(kEventQueueK2U) > 0)
+        return POLLIN | POLLRDNORM;
 
-            return 0;
-        }
-    }
-    return -ERESTARTSYS;
+    return 0;
 }
 
 //============================================================================//
@@ -501,11 +504,16 @@ static int eventThread(void* arg)
         sched_setscheduler(current, SCHED_FIFO, &rt_prio);
 #endif
 
+    // may override the built-in priority (module parameter eventkPriority)
+    edrvirq_addThread(kEdrvIrqThreadEventk, current);
+
     instance_l.fThreadIsRunning = TRUE;
     while (!kthread_should_stop())
     {
         result = wait_event_interruptible_timeout(instance_l.kernelWaitQueue,
-                                         (atomic_read(&instance_l.kernelEventCount) > 0), timeout);
+                                         ((atomic_read(&instance_l.fRingEventPending) != 0) ||
+                                          (eventkcal_getEventCountCircbuf(kEventQueueU2K) > 0)),
+                                         timeout);
 
         if (kthread_should_stop())
             break;
@@ -513,18 +521,14 @@ static int eventThread(void* arg)
         if (result == 0)
             continue;
 
-        /* first handle all kernel internal events --> higher priority! */
-        while (eventkcal_getEventCountCircbuf(kEventQueueKInt) > 0)
-        {
-            eventkcal_processEventCircbuf(kEventQueueKInt);
-            atomic_dec(&instance_l.kernelEventCount);
-        }
+        /* first handle all kernel internal events --> higher priority!
+           An event posted after the flag is reset sets it again. */
+        atomic_xchg(&instance_l.fRingEventPending, 0);
+        while (processProducerRing())
+            ;
 
         if (eventkcal_getEventCountCircbuf(kEventQueueU2K) > 0)
-        {
             eventkcal_processEventCircbuf(kEventQueueU2K);
-            atomic_dec(&instance_l.kernelEventCount);
-        }
     }
 
     instance_l.fThreadIsRunning = FALSE;
@@ -536,27 +540,235 @@ static int eventThread(void* arg)
 \brief  Signal a user event
 
 This function signals that a user event was posted. It will be registered in
-the circular buffer library as signal callback function
+the circular buffer library as signal callback function. The user library
+drains the queue before it polls again, therefore it is only woken up if the
+queue changed from empty to non-empty.
 */
 //------------------------------------------------------------------------------
 void signalUserEvent(void)
 {
-    atomic_inc(&instance_l.userEventCount);
-    wake_up_interruptible(&instance_l.userWaitQueue);
+    if (eventkcal_getEventCountCircbuf(kEventQueueK2U) == 1)
+        wake_up_interruptible(&instance_l.userWaitQueue);
 }
 
 //------------------------------------------------------------------------------
 /**
-\brief  Signal a kernel event
+\brief  Initialize producer rings
+
+The function allocates the producer rings of all possible CPUs. A ring must be
+able to store two events of the maximum size, so that an event always fits
+into an empty ring regardless of the position of its head.
 
-This function signals that a kernel event was posted. It will be registered in
-the circular buffer library as signal callback function
+\return The function returns a tOplkError error code.
 */
 //------------------------------------------------------------------------------
-void signalKernelEvent(void)
+static tOplkError initProducerRings(void)
 {
-    atomic_inc(&instance_l.kernelEventCount);
-    wake_up_interruptible(&instance_l.kernelWaitQueue);
+    tEventkCpuRings*    pCpuRings;
+    int                 cpu;
+    UINT                level;
+
+    if (CONFIG_EVENT_SIZE_PRODUCER_RING <
+        2 * (sizeof(tEventkRingBlock) + sizeof(tEvent) + MAX_EVENT_ARG_SIZE))
+    {
+        TRACE("%s() Producer ring size is too small!\n", __func__);
+        return kErrorNoResource;
+    }
+
+    for_each_possible_cpu(cpu)
+    {
+        pCpuRings = &per_cpu(cpuRings_l, cpu);
+        for (level = 0; level < EVENTK_RING_LEVELS; level++)
+        {
+            pCpuRings->aRing[level].head = 0;
+            pCpuRings->aRing[level].tail = 0;
+            pCpuRings->aRing[level].pBuffer = kmalloc(CONFIG_EVENT_SIZE_PRODUCER_RING, GFP_KERNEL);
+            if (pCpuRings->aRing[level].pBuffer == NULL)
+                return kErrorNoResource;
+        }
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Clean up producer rings
+
+The function frees the producer rings of all possible CPUs. Events which are
+still stored in the rings are discarded.
+*/
+//------------------------------------------------------------------------------
+static void exitProducerRings(void)
+{
+    tEventkCpuRings*    pCpuRings;
+    int                 cpu;
+    UINT                level;
+
+    for_each_possible_cpu(cpu)
+    {
+        pCpuRings = &per_cpu(cpuRings_l, cpu);
+        for (level = 0; level < EVENTK_RING_LEVELS; level++)
+        {
+            kfree(pCpuRings->aRing[level].pBuffer);
+            pCpuRings->aRing[level].pBuffer = NULL;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Post event into producer ring
+
+The function posts an event into the producer ring of the calling context and
+wakes up the event thread. The rings are only written by contexts of the same
+level on the same CPU. Preemption is disabled while the event is written, so
+such a context can only be interrupted by a context of a higher level.
+
+\param  eventQueue_p            Queue the event is posted to.
+\param  pEvent_p                Event to be posted.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                Event is posted
+\retval kErrorEventPostError    The ring is full or the context can't post
+*/
+//------------------------------------------------------------------------------
+static tOplkError postProducerRing(tEventQueue eventQueue_p, const tEvent* pEvent_p)
+{
+    tEventkRing*        pRing;
+    tEventkRingBlock*   pBlock;
+    UINT                level;
+    UINT32              blockSize;
+    UINT32              head;
+    UINT32              tail;
+    UINT32              offset;
+    UINT32              reqSize;
+
+    if (in_nmi() || (pEvent_p->eventArgSize > MAX_EVENT_ARG_SIZE))
+        return kErrorEventPostError;
+
+    blockSize = (sizeof(tEventkRingBlock) + sizeof(tEvent) + pEvent_p->eventArgSize +
+                 (EVENTK_RING_ALIGNMENT - 1)) & ~(EVENTK_RING_ALIGNMENT - 1);
+
+    if (in_irq())
+        level = EVENTK_RING_LEVEL_HARDIRQ;
+    else if (in_softirq())
+        level = EVENTK_RING_LEVEL_SOFTIRQ;
+    else
+        level = EVENTK_RING_LEVEL_TASK;
+
+    pRing = &get_cpu_var(cpuRings_l).aRing[level];
+
+    head = pRing->head;
+    tail = smp_load_acquire(&pRing->tail);
+    offset = head & (CONFIG_EVENT_SIZE_PRODUCER_RING - 1);
+
+    // A block which doesn't fit at the end of the ring starts at its beginning
+    reqSize = blockSize;
+    if (offset + blockSize > CONFIG_EVENT_SIZE_PRODUCER_RING)
+        reqSize += CONFIG_EVENT_SIZE_PRODUCER_RING - offset;
+
+    if (reqSize > CONFIG_EVENT_SIZE_PRODUCER_RING - (head - tail))
+    {
+        put_cpu_var(cpuRings_l);
+        atomic_inc(&instance_l.ringPostErrorCount);
+        return kErrorEventPostError;
+    }
+
+    if (reqSize != blockSize)
+    {
+        ((tEventkRingBlock*)(pRing->pBuffer + offset))->blockSize = EVENTK_RING_PADDING;
+        head += CONFIG_EVENT_SIZE_PRODUCER_RING - offset;
+        offset = 0;
+    }
+
+    pBlock = (tEventkRingBlock*)(pRing->pBuffer + offset);
+    pBlock->blockSize = blockSize;
+    pBlock->sequence = (UINT32)atomic_inc_return(&instance_l.ringSequence);
+    pBlock->eventQueue = (UINT32)eventQueue_p;
+    OPLK_MEMCPY(pBlock + 1, pEvent_p, sizeof(tEvent));
+    if (pEvent_p->eventArgSize != 0)
+        OPLK_MEMCPY((BYTE*)(pBlock + 1) + sizeof(tEvent), pEvent_p->pEventArg, pEvent_p->eventArgSize);
+
+    // Publish the block after it is completely written
+    smp_store_release(&pRing->head, head + blockSize);
+    put_cpu_var(cpuRings_l);
+
+    if (atomic_xchg(&instance_l.fRingEventPending, 1) == 0)
+        wake_up_interruptible(&instance_l.kernelWaitQueue);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process event of producer rings
+
+The function processes the oldest event of all producer rings. Kernel events
+are passed in place to the event handler, events to the user layer are
+forwarded to the K2U queue. It must only be called by the event thread.
+
+\return The function returns TRUE if an event was processed or FALSE if all
+        rings are empty.
+*/
+//------------------------------------------------------------------------------
+static BOOL processProducerRing(void)
+{
+    tEventkRing*        pRing;
+    tEventkRing*        pOldestRing = NULL;
+    tEventkRingBlock*   pBlock;
+    tEventkRingBlock*   pOldestBlock = NULL;
+    tEvent*             pEvent;
+    int                 cpu;
+    UINT                level;
+    UINT32              head;
+    UINT32              offset;
+
+    for_each_possible_cpu(cpu)
+    {
+        for (level = 0; level < EVENTK_RING_LEVELS; level++)
+        {
+            pRing = &per_cpu(cpuRings_l, cpu).aRing[level];
+            head = smp_load_acquire(&pRing->head);
+            if (pRing->tail == head)
+                continue;
+
+            offset = pRing->tail & (CONFIG_EVENT_SIZE_PRODUCER_RING - 1);
+            pBlock = (tEventkRingBlock*)(pRing->pBuffer + offset);
+            if (pBlock->blockSize == EVENTK_RING_PADDING)
+            {   // A padding block is always followed by a block at the start
+                smp_store_release(&pRing->tail, pRing->tail + CONFIG_EVENT_SIZE_PRODUCER_RING - offset);
+                pBlock = (tEventkRingBlock*)pRing->pBuffer;
+            }
+
+            if ((pOldestBlock == NULL) || ((INT32)(pBlock->sequence - pOldestBlock->sequence) < 0))
+            {
+                pOldestBlock = pBlock;
+                pOldestRing = pRing;
+            }
+        }
+    }
+
+    if (pOldestBlock == NULL)
+        return FALSE;
+
+    pEvent = (tEvent*)(pOldestBlock + 1);
+    if (pEvent->eventArgSize != 0)
+        pEvent->pEventArg = (BYTE*)pEvent + sizeof(tEvent);
+    else
+        pEvent->pEventArg = NULL;
+
+    if (pOldestBlock->eventQueue == kEventQueueK2U)
+    {
+        if (eventkcal_postEventCircbuf(kEventQueueK2U, pEvent) != kErrorOk)
+            TRACE("%s() K2U queue is full, event type %d is lost\n", __func__, pEvent->eventType);
+    }
+    else
+        eventk_process(pEvent);
+
+    // Release the block after the event is processed
+    smp_store_release(&pOldestRing->tail, pOldestRing->tail + pOldestBlock->blockSize);
+    return TRUE;
 }
 
 /// \}
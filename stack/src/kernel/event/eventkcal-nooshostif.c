@@ -51,6 +51,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <kernel/eventkcal.h>
 #include <kernel/eventkcalintf.h>
 
+#include <hostiflib.h>
+
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
 //============================================================================//
@@ -88,6 +90,8 @@ CAL module.
 typedef struct
 {
     BOOL                    fInitialized;
+    tHostifInstance         pHifInstance;           ///< Host interface instance used for the doorbell
+    tEventBatchStatistics   batchStatistics;        ///< Statistics of the processed event batches
 } tEventkCalInstance;
 
 //------------------------------------------------------------------------------
@@ -99,6 +103,9 @@ static tEventkCalInstance   instance_l;             ///< Instance variable of ke
 // local function prototypes
 //------------------------------------------------------------------------------
 static BOOL checkForwardEventToKint(tEvent* pEvent_p);
+static void signalK2uDoorbell(void);
+static UINT32 processQueue(tEventQueue eventQueue_p, UINT32 maxCount_p,
+                           ULONGLONG startCycles_p, BOOL* pfBudgetExceeded_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -130,6 +137,17 @@ tOplkError eventkcal_init(void)
     if (eventkcal_initQueueCircbuf(kEventQueueKInt) != kErrorOk)
         goto Exit;
 
+    // Ring the host interface event irq as doorbell for the user side
+    instance_l.pHifInstance = hostif_getInstance(0);
+    if (instance_l.pHifInstance == NULL)
+        goto Exit;
+
+    if (eventkcal_setSignalingCircbuf(kEventQueueK2U, signalK2uDoorbell) != kErrorOk)
+        goto Exit;
+
+    if (hostif_irqSourceEnable(instance_l.pHifInstance, kHostifIrqSrcEvent, TRUE) != kHostifSuccessful)
+        goto Exit;
+
     instance_l.fInitialized = TRUE;
     return kErrorOk;
 
@@ -160,6 +178,7 @@ tOplkError eventkcal_exit(void)
 {
     if (instance_l.fInitialized == TRUE)
     {
+        hostif_irqSourceEnable(instance_l.pHifInstance, kHostifIrqSrcEvent, FALSE);
         eventkcal_exitQueueCircbuf(kEventQueueKInt);
         eventkcal_exitQueueCircbuf(kEventQueueK2U);
         eventkcal_exitQueueCircbuf(kEventQueueU2K);
@@ -232,22 +251,70 @@ tOplkError eventkcal_postUserEvent(tEvent* pEvent_p)
 /**
 \brief  Process function of kernel CAL module
 
-This function will be called by the systems process function.
+This function will be called by the systems process function. It processes
+the events which are pending in the queues when it is called, so the events
+posted by the user side are handled in bulk. The batch is bounded by the event
+and time budget (CONFIG_EVENT_BATCH_MAX_EVENTS,
+CONFIG_EVENT_BATCH_TIME_BUDGET_US); remaining events are processed by the next
+call. The batch statistics are updated accordingly.
 
 \ingroup module_eventkcal
 */
 //------------------------------------------------------------------------------
 void eventkcal_process(void)
 {
-    if (eventkcal_getEventCountCircbuf(kEventQueueU2K) > 0)
+    tEventBatchStatistics*  pStatistics = &instance_l.batchStatistics;
+    ULONGLONG               startCycles;
+    UINT32                  eventCount;
+    UINT32                  batchTime;
+    BOOL                    fBudgetExceeded = FALSE;
+
+    startCycles = target_getCycleCounter();
+
+    eventCount = processQueue(kEventQueueU2K, CONFIG_EVENT_BATCH_MAX_EVENTS,
+                              startCycles, &fBudgetExceeded);
+    if (!fBudgetExceeded &&
+        ((CONFIG_EVENT_BATCH_MAX_EVENTS == 0) || (eventCount < CONFIG_EVENT_BATCH_MAX_EVENTS)))
     {
-        eventkcal_processEventCircbuf(kEventQueueU2K);
+        eventCount += processQueue(kEventQueueKInt,
+                                   (CONFIG_EVENT_BATCH_MAX_EVENTS != 0) ?
+                                   (CONFIG_EVENT_BATCH_MAX_EVENTS - eventCount) : 0,
+                                   startCycles, &fBudgetExceeded);
     }
 
-    if (eventkcal_getEventCountCircbuf(kEventQueueKInt) > 0)
-    {
-        eventkcal_processEventCircbuf(kEventQueueKInt);
-    }
+    if (eventCount == 0)
+        return;
+
+    batchTime = (UINT32)target_convertCyclesToNs(target_getCycleCounter() - startCycles);
+
+    pStatistics->batchCount++;
+    pStatistics->eventCount += eventCount;
+    pStatistics->lastBatchSize = eventCount;
+    if (eventCount > pStatistics->maxBatchSize)
+        pStatistics->maxBatchSize = eventCount;
+    if (fBudgetExceeded)
+        pStatistics->budgetExceededCount++;
+    pStatistics->lastBatchTime = batchTime;
+    if (batchTime > pStatistics->maxBatchTime)
+        pStatistics->maxBatchTime = batchTime;
+    pStatistics->totalBatchTime += batchTime;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the event batch statistics
+
+The function copies the statistics of the batched event processing of
+eventkcal_process().
+
+\param  pStatistics_p           Pointer to store the statistics.
+
+\ingroup module_eventkcal
+*/
+//------------------------------------------------------------------------------
+void eventkcal_getBatchStatistics(tEventBatchStatistics* pStatistics_p)
+{
+    OPLK_MEMCPY(pStatistics_p, &instance_l.batchStatistics, sizeof(tEventBatchStatistics));
 }
 
 //============================================================================//
@@ -297,5 +364,61 @@ static BOOL checkForwardEventToKint(tEvent* pEvent_p)
     return fRet;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Process the events of a queue
+
+This function processes the events which are pending in the queue when it is
+called, until the event budget \p maxCount_p or the time budget of the batch is
+exceeded.
+
+\param  eventQueue_p            Queue to process.
+\param  maxCount_p              Maximum number of events to process (0 = unlimited).
+\param  startCycles_p           Cycle counter value at the start of the batch.
+\param  pfBudgetExceeded_p      Pointer to store if the batch was stopped by the
+                                event or time budget.
+
+\return The function returns the number of processed events.
+*/
+//------------------------------------------------------------------------------
+static UINT32 processQueue(tEventQueue eventQueue_p, UINT32 maxCount_p,
+                           ULONGLONG startCycles_p, BOOL* pfBudgetExceeded_p)
+{
+    UINT32  pendingCount;
+    UINT32  eventCount = 0;
+
+    pendingCount = (UINT32)eventkcal_getEventCountCircbuf(eventQueue_p);
+    while (eventCount < pendingCount)
+    {
+        eventkcal_processEventCircbuf(eventQueue_p);
+        eventCount++;
+
+        if (((maxCount_p != 0) && (eventCount >= maxCount_p)) ||
+            ((CONFIG_EVENT_BATCH_TIME_BUDGET_US != 0) &&
+             (target_convertCyclesToNs(target_getCycleCounter() - startCycles_p) >=
+              CONFIG_EVENT_BATCH_TIME_BUDGET_US * 1000ULL)))
+        {
+            // Report only if events are left in the queue
+            *pfBudgetExceeded_p = (eventCount < pendingCount);
+            break;
+        }
+    }
+
+    return eventCount;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Signal the kernel-to-user queue doorbell
+
+This function is the signaling callback of the kernel-to-user queue. It sets
+the event irq of the host interface to notify the user side about new events.
+*/
+//------------------------------------------------------------------------------
+static void signalK2uDoorbell(void)
+{
+    hostif_irqSet(instance_l.pHifInstance, kHostifIrqSrcEvent);
+}
+
 /// \}
 
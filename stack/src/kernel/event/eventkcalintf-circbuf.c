@@ -49,6 +49,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <common/circbuffer.h>
 
+#include "common/event/event.h"
+
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
 //============================================================================//
@@ -81,7 +83,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // local vars
 //------------------------------------------------------------------------------
 static tCircBufInstance*        instance_l[kEventQueueNum];
-static BYTE                     aRxBuffer_l[kEventQueueNum][sizeof(tEvent) + MAX_EVENT_ARG_SIZE];
+static BYTE                     aRxBuffer_l[kEventQueueNum][sizeof(tEvent) + MAX_EVENT_ARG_SIZE +
+                                            EVENT_LATENCY_STAMP_SIZE];
+#if (CONFIG_EVENT_PAYLOAD_POOL_SLOTS != 0)
+static tEventPayloadPool        payloadPool_l;      ///< Payload pool of the kernel internal queue
+#endif
 
 //------------------------------------------------------------------------------
 // local function prototypes
@@ -174,6 +180,10 @@ tOplkError eventkcal_initQueueCircbuf(tEventQueue eventQueue_p)
             break;
     }
 
+#if (CONFIG_EVENT_LATENCY != FALSE)
+    event_initLatency(eventQueue_p);
+#endif
+
     return kErrorOk;
 }
 
@@ -212,7 +222,11 @@ tOplkError eventkcal_exitQueueCircbuf(tEventQueue eventQueue_p)
 /**
 \brief    Post event using circular buffer
 
-This function posts an event to the provided queue instance.
+This function posts an event to the provided queue instance. Large arguments
+of events for the kernel internal queue are stored in the payload pool if
+CONFIG_EVENT_PAYLOAD_POOL_SLOTS is not 0, the queue entry then only references
+the argument. If CONFIG_EVENT_LATENCY is enabled, the post time is appended to
+the queue entry.
 
 \param  eventQueue_p            Event queue to which the event should be posted.
 \param  pEvent_p                Event to be posted.
@@ -228,6 +242,9 @@ tOplkError eventkcal_postEventCircbuf(tEventQueue eventQueue_p, tEvent* pEvent_p
 {
     tOplkError          ret = kErrorOk;
     tCircBufError       circError;
+    BYTE*               pData;
+    void*               pPayload = NULL;
+    size_t              argSize;
 
     if (eventQueue_p > kEventQueueNum)
     {
@@ -241,20 +258,47 @@ tOplkError eventkcal_postEventCircbuf(tEventQueue eventQueue_p, tEvent* pEvent_p
         return kErrorInvalidInstanceParam;
     }
 
+#if (CONFIG_EVENT_PAYLOAD_POOL_SLOTS != 0)
+    if (eventQueue_p == kEventQueueKInt)
+        pPayload = event_allocPayload(&payloadPool_l, pEvent_p);
+#endif
+    argSize = (pPayload != NULL) ? sizeof(void*) : pEvent_p->eventArgSize;
+
     /*TRACE("%s() Event:%d Sink:%d\n", __func__, pEvent_p->eventType, pEvent_p->eventSink);*/
-    if (pEvent_p->eventArgSize == 0)
+    // Serialize the event directly into the queue
+    circError = circbuf_reserve(instance_l[eventQueue_p],
+                                sizeof(tEvent) + argSize + EVENT_LATENCY_STAMP_SIZE,
+                                (void**)&pData);
+    if (circError != kCircBufOk)
     {
-        circError = circbuf_writeData(instance_l[eventQueue_p], pEvent_p, sizeof(tEvent));
-    }
-    else
-    {
-        circError = circbuf_writeMultipleData(instance_l[eventQueue_p], pEvent_p, sizeof(tEvent),
-                                              pEvent_p->pEventArg, (ULONG)pEvent_p->eventArgSize);
+#if (CONFIG_EVENT_PAYLOAD_POOL_SLOTS != 0)
+        if (pPayload != NULL)
+            event_freePayload(&payloadPool_l, pPayload);
+#endif
+        return kErrorEventPostError;
     }
+
+    OPLK_MEMCPY(pData, pEvent_p, sizeof(tEvent));
+    if (pPayload != NULL)
+        OPLK_MEMCPY(pData + sizeof(tEvent), &pPayload, sizeof(void*));
+    else if (pEvent_p->eventArgSize != 0)
+        OPLK_MEMCPY(pData + sizeof(tEvent), pEvent_p->pEventArg, pEvent_p->eventArgSize);
+
+#if (CONFIG_EVENT_LATENCY != FALSE)
+    event_stampLatency(pData + sizeof(tEvent) + argSize);
+#endif
+
+    circError = circbuf_commit(instance_l[eventQueue_p], pData);
     if(circError != kCircBufOk)
     {
         ret = kErrorEventPostError;
     }
+#if (CONFIG_EVENT_LATENCY != FALSE)
+    else
+    {
+        event_observeDepth(eventQueue_p, circbuf_getDataCount(instance_l[eventQueue_p]));
+    }
+#endif
     return ret;
 }
 
@@ -263,7 +307,10 @@ tOplkError eventkcal_postEventCircbuf(tEventQueue eventQueue_p, tEvent* pEvent_p
 \brief    Process event using circular buffers
 
 This function reads a circular buffer event queue and processes the event
-by calling the event handlers process function.
+by calling the event handlers process function. The event is processed in the
+circular buffer and released afterwards. Only events which wrap around the end
+of the buffer are copied. Arguments stored in the payload pool are passed to
+the sink in place as well.
 
 \param  eventQueue_p            Event queue used for reading the event.
 
@@ -281,6 +328,11 @@ tOplkError eventkcal_processEventCircbuf(tEventQueue eventQueue_p)
     tOplkError          ret = kErrorOk;
     size_t              readSize;
     tCircBufInstance*   pCircBufInstance;
+    BOOL                fInPlace = TRUE;
+    void*               pPayload = NULL;
+#if (CONFIG_EVENT_LATENCY != FALSE)
+    UINT64              startTime;
+#endif
 
     //TRACE("%s()\n", __func__);
 
@@ -298,8 +350,14 @@ tOplkError eventkcal_processEventCircbuf(tEventQueue eventQueue_p)
 
     pCircBufInstance = instance_l[eventQueue_p];
 
-    error = circbuf_readData(pCircBufInstance, aRxBuffer_l[eventQueue_p],
-                             sizeof(tEvent) + MAX_EVENT_ARG_SIZE, &readSize);
+    error = circbuf_peek(pCircBufInstance, (void**)&pEplEvent, &readSize);
+    if (error == kCircBufDataNotContiguous)
+    {   // Event wraps around the end of the buffer and must be copied
+        fInPlace = FALSE;
+        pEplEvent = (tEvent*)aRxBuffer_l[eventQueue_p];
+        error = circbuf_readData(pCircBufInstance, aRxBuffer_l[eventQueue_p],
+                                 sizeof(aRxBuffer_l[eventQueue_p]), &readSize);
+    }
     if(error != kCircBufOk)
     {
         if (error == kCircBufNoReadableData)
@@ -310,13 +368,39 @@ tOplkError eventkcal_processEventCircbuf(tEventQueue eventQueue_p)
 
         return kErrorGeneralError;
     }
-    pEplEvent = (tEvent*)aRxBuffer_l[eventQueue_p];
-    pEplEvent->eventArgSize = (readSize - sizeof(tEvent));
 
-    if(pEplEvent->eventArgSize > 0)
-        pEplEvent->pEventArg = &aRxBuffer_l[eventQueue_p][sizeof(tEvent)];
+    // The queue could be written by another address space, check the block
+    if (readSize < sizeof(tEvent) + EVENT_LATENCY_STAMP_SIZE)
+    {
+        if (fInPlace)
+            circbuf_release(pCircBufInstance);
+        return kErrorEventReadError;
+    }
+
+#if (CONFIG_EVENT_LATENCY != FALSE)
+    // the post time is stored behind the argument
+    readSize -= EVENT_LATENCY_STAMP_SIZE;
+    startTime = event_observeLatency(eventQueue_p, pEplEvent, (BYTE*)pEplEvent + readSize);
+#endif
+
+#if (CONFIG_EVENT_PAYLOAD_POOL_SLOTS != 0)
+    if (eventQueue_p == kEventQueueKInt)
+        pPayload = event_getPayloadRef(pEplEvent, readSize - sizeof(tEvent));
+#endif
+
+    if (pPayload != NULL)
+    {   // argument is stored in the payload pool, keep the size of the header
+        pEplEvent->pEventArg = pPayload;
+    }
     else
-        pEplEvent->pEventArg = NULL;
+    {
+        pEplEvent->eventArgSize = (readSize - sizeof(tEvent));
+
+        if(pEplEvent->eventArgSize > 0)
+            pEplEvent->pEventArg = (BYTE*)pEplEvent + sizeof(tEvent);
+        else
+            pEplEvent->pEventArg = NULL;
+    }
 
     /*TRACE("Process Kernel  type:%s(%d) sink:%s(%d) size:%d!\n",
            debugstr_getEventTypeStr(pEplEvent->eventType), pEplEvent->eventType,
@@ -324,6 +408,19 @@ tOplkError eventkcal_processEventCircbuf(tEventQueue eventQueue_p)
            pEplEvent->eventArgSize);*/
 
     ret = eventk_process(pEplEvent);
+
+#if (CONFIG_EVENT_LATENCY != FALSE)
+    event_observeProcessing(eventQueue_p, pEplEvent, startTime);
+#endif
+
+#if (CONFIG_EVENT_PAYLOAD_POOL_SLOTS != 0)
+    if (pPayload != NULL)
+        event_freePayload(&payloadPool_l, pPayload);
+#endif
+
+    if (fInPlace)
+        circbuf_release(pCircBufInstance);
+
     return ret;
 }
 
@@ -333,7 +430,9 @@ tOplkError eventkcal_processEventCircbuf(tEventQueue eventQueue_p)
 \brief    Read event from circular buffers
 
 This function reads a circular buffer event queue and stores the event data
-at pDataBuffer_p.
+at pDataBuffer_p. If CONFIG_EVENT_LATENCY is enabled, the buffer must provide
+EVENT_LATENCY_STAMP_SIZE additional bytes for the post time of the event, which
+is not included in the returned length.
 
 \param  eventQueue_p            Event queue used for reading the event.
 \param  pDataBuffer_p           Pointer to store event.
@@ -367,7 +466,8 @@ tOplkError eventkcal_getEventCircbuf(tEventQueue eventQueue_p, BYTE* pDataBuffer
     pCircBufInstance = instance_l[eventQueue_p];
 
     error = circbuf_readData(pCircBufInstance, pDataBuffer_p,
-                             sizeof(tEvent) + MAX_EVENT_ARG_SIZE, pReadSize_p);
+                             sizeof(tEvent) + MAX_EVENT_ARG_SIZE + EVENT_LATENCY_STAMP_SIZE,
+                             pReadSize_p);
     if(error != kCircBufOk)
     {
         if (error == kCircBufNoReadableData)
@@ -379,6 +479,11 @@ tOplkError eventkcal_getEventCircbuf(tEventQueue eventQueue_p, BYTE* pDataBuffer
         return kErrorGeneralError;
     }
 
+#if (CONFIG_EVENT_LATENCY != FALSE)
+    if (*pReadSize_p >= EVENT_LATENCY_STAMP_SIZE)
+        *pReadSize_p -= EVENT_LATENCY_STAMP_SIZE;
+#endif
+
     return kErrorOk;
 }
 
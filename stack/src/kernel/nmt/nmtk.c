@@ -284,6 +284,8 @@ tOplkError nmtk_process(tEvent* pEvent_p)
         nmtStateChange.newNmtState = nmtkStates_g[nmtkInstance_g.stateIndex].nmtState;
         nmtStateChange.oldNmtState = nmtkStates_g[oldState].nmtState;
         nmtStateChange.nmtEvent = nmtEvent;
+        BINTRACE4(kBinTraceIdNmtkStateChange, nmtStateChange.oldNmtState,
+                  nmtStateChange.newNmtState, nmtEvent, 0);
         event.eventType = kEventTypeNmtStateChange;
         OPLK_MEMSET(&event.netTime, 0x00, sizeof(event.netTime));
         event.pEventArg = &nmtStateChange;
@@ -303,6 +305,22 @@ tOplkError nmtk_process(tEvent* pEvent_p)
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get the current NMT state
+
+The function returns the current state of the kernel NMT state machine.
+
+\return The function returns the current NMT state.
+
+\ingroup module_nmtk
+*/
+//------------------------------------------------------------------------------
+tNmtState nmtk_getNmtState(void)
+{
+    return nmtkStates_g[nmtkInstance_g.stateIndex].nmtState;
+}
+
 
 //=========================================================================//
 //                                                                         //
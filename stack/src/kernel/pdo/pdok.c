@@ -46,6 +46,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <kernel/pdokcal.h>
 #include <kernel/eventk.h>
 #include <kernel/dllk.h>
+#include <common/cyclestat.h>
 #include <oplk/benchmark.h>
 #include <oplk/debugstr.h>
 
@@ -73,11 +74,51 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+// The channel lookup tables are indexed by the node ID of the PDO. Only node IDs
+// up to NMT_MAX_NODE_ID can be tracked by the DLL, so the tables need not cover
+// the whole node ID range.
+#define PDOK_CHANNEL_LUT_SIZE       (NMT_MAX_NODE_ID + 1)
+
+#if (D_PDO_RPDOChannels_U16 < 0xFF) && (D_PDO_TPDOChannels_U16 < 0xFF)
+#define PDOK_CHANNEL_ID_INVALID     0xFF
+#else
+#define PDOK_CHANNEL_ID_INVALID     0xFFFF
+#endif
 
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
 
+/**
+\brief Channel ID type of the lookup tables
+
+The smallest type which can hold all configured channel IDs is used.
+*/
+#if (D_PDO_RPDOChannels_U16 < 0xFF) && (D_PDO_TPDOChannels_U16 < 0xFF)
+typedef UINT8 tPdokChannelId;
+#else
+typedef UINT16 tPdokChannelId;
+#endif
+
+#if (CONFIG_PDO_ROUTE_COUNT != 0)
+/**
+\brief RPDO to TPDO route
+
+The structure contains a route added by pdok_addRoute() and the triple buffer
+which passes the routed data from the receive to the transmit path.
+*/
+typedef struct
+{
+    tPdoRoute               route;              ///< Route configuration
+    UINT                    aBufOffset[3];      ///< Offsets of the triple buffers in the route data
+    OPLK_ATOMIC_T           writeBuf;           ///< Buffer written by the receive path
+    OPLK_ATOMIC_T           cleanBuf;           ///< Buffer with the latest data
+    OPLK_ATOMIC_T           readBuf;            ///< Buffer read by the transmit path
+    volatile UINT8          newData;            ///< The clean buffer contains new data
+    BOOL                    fValid;             ///< The read buffer contains received data
+} tPdokRoute;
+#endif
+
 /**
 \brief Kernel PDO module instance
 
@@ -88,8 +129,27 @@ typedef struct
 {
     tPdoChannelSetup        pdoChannels;        ///< PDO channel setup
     BOOL                    fRunning;           ///< Flag determines if PDO engine is running
-    UINT                    aTpdoChannelIdLut[D_PDO_TPDOChannels_U16];
-    UINT                    aRpdoChannelIdLut[D_PDO_RPDOChannels_U16];
+    tPdokChannelId          aTpdoChannelIdLut[PDOK_CHANNEL_LUT_SIZE];   ///< TPDO channel ID of each node ID
+    tPdokChannelId          aRpdoChannelIdLut[PDOK_CHANNEL_LUT_SIZE];   ///< First RPDO channel ID of each node ID
+    tPdokChannelId          aRpdoNextChannel[D_PDO_RPDOChannels_U16];   ///< Next RPDO channel ID of the same node ID
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+    BOOL                    afTxRemapPending[D_PDO_TPDOChannels_U16];   ///< TPDO channel waits for the first TPDO of its new mapping
+#endif
+#if (CONFIG_PDO_ROUTE_COUNT != 0)
+    tPdokRoute              aRoute[CONFIG_PDO_ROUTE_COUNT];             ///< RPDO to TPDO routes
+    UINT                    routeCount;                                 ///< Number of used routes
+    UINT                    routeDataSize;                              ///< Used size of the route data of one buffer
+    BYTE                    aRouteData[3 * CONFIG_PDO_ROUTE_BUFFER_SIZE];   ///< Triple buffers of the routes
+#endif
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+    BOOL                    fKernelPi;                                  ///< Flag determines if the kernel process images are assembled
+    tPdoKernelPiCopy        aKernelPiCopy[CONFIG_PDO_KERNEL_PI_COPY_COUNT]; ///< Copy operations of the kernel process images
+    UINT16                  aRxKernelPiCopy[D_PDO_RPDOChannels_U16 + 1];    ///< First copy operation of each RPDO channel
+    UINT16                  aTxKernelPiCopy[D_PDO_TPDOChannels_U16 + 1];    ///< First copy operation of each TPDO channel
+    UINT                    kernelPiOutSize;                            ///< Size of the output process image
+    const BYTE*             pKernelPiIn;                                ///< Input process image read by the transmit path, NULL = none published yet
+    BYTE                    aKernelPiOut[PDO_KERNEL_PI_SIZE];           ///< Output process image assembled by the receive path
+#endif
 }tPdokInstance;
 
 //------------------------------------------------------------------------------
@@ -101,8 +161,25 @@ static tPdokInstance  pdokInstance_g;
 // local function prototypes
 //------------------------------------------------------------------------------
 static tOplkError cbProcessTpdo(tFrameInfo* pFrameInfo_p, BOOL fReadyFlag_p) SECTION_PDOK_PROCESS_TPDO_CB;
-static tOplkError copyTxPdo(tPlkFrame* pFrame_p, UINT frameSize_p, BOOL fReadyFlag_p);
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+static tOplkError cbProcessTpdoZeroCopy(tFrameInfo* pFrameInfo_p, BOOL fReadyFlag_p) SECTION_PDOK_PROCESS_TPDO_CB;
+#endif
+static tOplkError copyTxPdo(tFrameInfo* pFrameInfo_p, BOOL fReadyFlag_p, BOOL fZeroCopy_p);
 static void disablePdoChannels(tPdoChannel* pPdoChannel, UINT channelCnt);
+static void resetChannelIdLut(tPdokChannelId* pLut_p);
+static void resetRpdoChannelList(void);
+static void linkRpdoChannel(UINT channelId_p, UINT nodeId_p);
+static void unlinkRpdoChannel(UINT channelId_p, UINT nodeId_p);
+#if (CONFIG_PDO_ROUTE_COUNT != 0)
+static void writeRoutes(UINT channelId_p, const BYTE* pPayload_p, UINT pdoSize_p);
+static void readRoutes(UINT channelId_p, BYTE* pPayload_p, UINT pdoSize_p);
+#endif
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+static BOOL indexKernelPiCopy(BOOL fTx_p, UINT16* paIndex_p, UINT channelCount_p,
+                              UINT piSize_p, UINT copyCount_p, UINT* pCopyIndex_p);
+static void writeKernelPi(UINT channelId_p, const BYTE* pPayload_p, UINT pdoSize_p);
+static void readKernelPi(UINT channelId_p, BYTE* pPayload_p, UINT pdoSize_p);
+#endif
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -124,6 +201,8 @@ tOplkError pdok_init(void)
     tOplkError      ret = kErrorOk;
 
     OPLK_MEMSET(&pdokInstance_g, 0, sizeof(pdokInstance_g));
+    resetRpdoChannelList();
+    resetChannelIdLut(pdokInstance_g.aTpdoChannelIdLut);
 
     if ((ret = pdokcal_init()) != kErrorOk)
     {
@@ -131,6 +210,9 @@ tOplkError pdok_init(void)
     }
 
     dllk_regTpdoHandler(cbProcessTpdo);
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+    dllk_regTpdoZeroCopyHandler(cbProcessTpdoZeroCopy);
+#endif
 
     return ret;
 }
@@ -150,6 +232,9 @@ tOplkError pdok_exit(void)
 {
     pdokInstance_g.fRunning = FALSE;
     dllk_regTpdoHandler(NULL);
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+    dllk_regTpdoZeroCopyHandler(NULL);
+#endif
     pdok_deAllocChannelMem();
     pdokcal_cleanupPdoMem();
     pdokcal_exit();
@@ -185,6 +270,10 @@ tOplkError pdok_deAllocChannelMem(void)
     }
 #endif // NMT_MAX_NODE_ID > 0
 
+    pdok_clearRoutes();
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+    pdokInstance_g.fKernelPi = FALSE;
+#endif
 
     // de-allocate mem for RX PDO channels
     if (pdokInstance_g.pdoChannels.allocation.rxPdoChannelCount != 0)
@@ -229,7 +318,25 @@ tOplkError pdok_allocChannelMem(tPdoAllocationParam* pAllocationParam_p)
 
 #if NMT_MAX_NODE_ID > 0
     tDllNodeOpParam     nodeOpParam;
+#endif
+
+    // the PDO engine is stopped until the PDO buffers are set up again
+    pdokInstance_g.fRunning = FALSE;
+
+    // the channel IDs of the routes and the kernel process images become invalid
+    pdok_clearRoutes();
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+    pdokInstance_g.fKernelPi = FALSE;
+#endif
 
+    if ((pAllocationParam_p->rxPdoChannelCount > D_PDO_RPDOChannels_U16) ||
+        (pAllocationParam_p->txPdoChannelCount > D_PDO_TPDOChannels_U16))
+    {
+        ret = kErrorPdoInitError;
+        goto Exit;
+    }
+
+#if NMT_MAX_NODE_ID > 0
     nodeOpParam.opNodeType = kDllNodeOpTypeFilterPdo;
     nodeOpParam.nodeId = C_ADR_BROADCAST;
     ret = dllk_deleteNode(&nodeOpParam);
@@ -264,6 +371,7 @@ tOplkError pdok_allocChannelMem(tPdoAllocationParam* pAllocationParam_p)
 
     disablePdoChannels(pdokInstance_g.pdoChannels.pRxPdoChannel,
                        pdokInstance_g.pdoChannels.allocation.rxPdoChannelCount);
+    resetRpdoChannelList();
 
     if (pdokInstance_g.pdoChannels.allocation.txPdoChannelCount != pAllocationParam_p->txPdoChannelCount)
     {   // allocation should be changed
@@ -291,6 +399,10 @@ tOplkError pdok_allocChannelMem(tPdoAllocationParam* pAllocationParam_p)
 
     disablePdoChannels(pdokInstance_g.pdoChannels.pTxPdoChannel,
                        pdokInstance_g.pdoChannels.allocation.txPdoChannelCount);
+    resetChannelIdLut(pdokInstance_g.aTpdoChannelIdLut);
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+    OPLK_MEMSET(pdokInstance_g.afTxRemapPending, 0, sizeof(pdokInstance_g.afTxRemapPending));
+#endif
 
 Exit:
     return ret;
@@ -327,12 +439,16 @@ tOplkError pdok_configureChannel(tPdoChannelConf* pChannelConf_p)
 
         pDestPdoChannel = &pdokInstance_g.pdoChannels.pRxPdoChannel[pChannelConf_p->channelId];
 
+        // remove the channel from the channel list of its old node, so that a
+        // running channel is not found by pdok_processRxPdo() while it is changed
+        unlinkRpdoChannel(pChannelConf_p->channelId, pDestPdoChannel->nodeId);
+
         // copy channel configuration to local structure
         OPLK_MEMCPY(pDestPdoChannel, &pChannelConf_p->pdoChannel,
                     sizeof (pChannelConf_p->pdoChannel));
 
         // Store channel ID for fast access
-        pdokInstance_g.aRpdoChannelIdLut[pDestPdoChannel->nodeId] = pChannelConf_p->channelId;
+        linkRpdoChannel(pChannelConf_p->channelId, pDestPdoChannel->nodeId);
 
 #if NMT_MAX_NODE_ID > 0
         if ((pDestPdoChannel->nodeId != PDO_INVALID_NODE_ID)
@@ -371,15 +487,30 @@ tOplkError pdok_configureChannel(tPdoChannelConf* pChannelConf_p)
 
         pDestPdoChannel = &pdokInstance_g.pdoChannels.pTxPdoChannel[pChannelConf_p->channelId];
 
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+        if (pdokInstance_g.fRunning)
+        {   // The TPDO buffer may still contain data of the old mapping. It is
+            // dropped and the frame is sent as invalid until the user layer has
+            // written the first TPDO of the new mapping.
+            if (pDestPdoChannel->nodeId < PDOK_CHANNEL_LUT_SIZE)
+                pdokInstance_g.aTpdoChannelIdLut[pDestPdoChannel->nodeId] = PDOK_CHANNEL_ID_INVALID;
+            pdokcal_discardTxPdo(pChannelConf_p->channelId);
+            pdokInstance_g.afTxRemapPending[pChannelConf_p->channelId] = TRUE;
+        }
+#endif
+
         // copy channel to local structure
         OPLK_MEMCPY(pDestPdoChannel, &pChannelConf_p->pdoChannel,
                     sizeof (pChannelConf_p->pdoChannel));
 
         // Store channel ID for fast access
-        pdokInstance_g.aTpdoChannelIdLut[pDestPdoChannel->nodeId] = pChannelConf_p->channelId;
+        if (pDestPdoChannel->nodeId < PDOK_CHANNEL_LUT_SIZE)
+            pdokInstance_g.aTpdoChannelIdLut[pDestPdoChannel->nodeId] = (tPdokChannelId)pChannelConf_p->channelId;
     }
 
+#if (CONFIG_PDO_HITLESS_REMAP == FALSE)
     pdokInstance_g.fRunning = FALSE;
+#endif
 Exit:
     return Ret;
 }
@@ -388,7 +519,21 @@ Exit:
 /**
 \brief  Process a RxPDO
 
-The function processes a received RxPDO.
+The function processes a received RxPDO. The PDO payload is copied from the
+frame into the write buffer of the PDO triple buffer. Afterwards, only the
+buffer index is published to the user layer.
+
+Several RPDO channels may be configured for the same source node. They are
+chained in a channel list of the node and all of them are fed from the frame
+in a single pass. The frame header is evaluated only once.
+
+If CONFIG_PDO_RX_DIRECT_COPY is enabled, the function is called directly
+in the context of the DLL frame receive handler and the frame still resides in
+the Rx buffer of the Ethernet driver. If CONFIG_PDO_RX_WORKER is enabled, the
+function is called by the RPDO worker thread with a copy of the frame.
+
+If CONFIG_PDO_RX_DMA is enabled, the payload is copied by DMA. The function then
+returns kErrorReject and the Rx buffer is released after the transfer.
 
 \param  pFrame_p                Pointer to frame to be decoded
 \param  frameSize_p             Size of frame to be encoded
@@ -406,6 +551,8 @@ tOplkError pdok_processRxPdo(tPlkFrame* pFrame_p, UINT frameSize_p)
     tMsgType            msgType;
     tPdoChannel*        pPdoChannel;
     UINT                channelId;
+    UINT                nextChannelId;
+    BYTE                pdoVersion;
 
     // check if received RPDO is valid
     frameData = ami_getUint8Le(&pFrame_p->data.pres.flag1);
@@ -429,39 +576,72 @@ tOplkError pdok_processRxPdo(tPlkFrame* pFrame_p, UINT frameSize_p)
     if (pdokInstance_g.fRunning)
     {
         // Get PDO channel reference
-        channelId = pdokInstance_g.aRpdoChannelIdLut[nodeId];
-        pPdoChannel = &pdokInstance_g.pdoChannels.pRxPdoChannel[channelId];
+        if (nodeId >= PDOK_CHANNEL_LUT_SIZE)
+            goto Exit;
 
-        // retrieve PDO version from frame
-        frameData = ami_getUint8Le(&pFrame_p->data.pres.pdoVersion);
-        if ((pPdoChannel->mappingVersion & PLK_VERSION_MAIN) != (frameData & PLK_VERSION_MAIN))
-        {   // PDO versions do not match
-            // $$$ raise PDO error
-            // terminate processing of this RPDO
+        channelId = pdokInstance_g.aRpdoChannelIdLut[nodeId];
+        if (channelId == PDOK_CHANNEL_ID_INVALID)
+        {   // no RPDO channel is configured for this node
             goto Exit;
         }
 
-        // valid RPDO found
+        // retrieve PDO version from frame
+        pdoVersion = ami_getUint8Le(&pFrame_p->data.pres.pdoVersion) & PLK_VERSION_MAIN;
 
-        if ((unsigned int)(pPdoChannel->pdoSize + PLK_FRAME_OFFSET_PDO_PAYLOAD) > frameSize_p)
-        {   // RPDO is too short
-            // $$$ raise PDO error, set Ret
-            goto Exit;
-        }
+        for (; channelId != PDOK_CHANNEL_ID_INVALID; channelId = nextChannelId)
+        {
+            nextChannelId = pdokInstance_g.aRpdoNextChannel[channelId];
+            pPdoChannel = &pdokInstance_g.pdoChannels.pRxPdoChannel[channelId];
+
+            if ((pPdoChannel->mappingVersion & PLK_VERSION_MAIN) != pdoVersion)
+            {   // PDO versions do not match
+                // $$$ raise PDO error
+                // skip this RPDO channel
+                continue;
+            }
+
+            // valid RPDO found
+
+            if ((unsigned int)(pPdoChannel->pdoSize + PLK_FRAME_OFFSET_PDO_PAYLOAD) > frameSize_p)
+            {   // RPDO is too short
+                // $$$ raise PDO error, set Ret
+                continue;
+            }
+
+            /*
+            TRACE ("%s() Channel:%d Node:%d MapObjectCnt:%d PdoSize:%d\n",
+                   __func__, channelId, nodeId, pPdoChannel->mappObjectCount,
+                   pPdoChannel->pdoSize);
+            */
 
-        /*
-        TRACE ("%s() Channel:%d Node:%d MapObjectCnt:%d PdoSize:%d\n",
-               __func__, channelId, nodeId, pPdoChannel->mappObjectCount,
-               pPdoChannel->pdoSize);
-        */
+#if (CONFIG_PDO_ROUTE_COUNT != 0)
+            writeRoutes(channelId, &pFrame_p->data.pres.aPayload[0], pPdoChannel->pdoSize);
+#endif
 
-        pdokcal_writeRxPdo(channelId,
-                           &pFrame_p->data.pres.aPayload[0],
-                           pPdoChannel->pdoSize);
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+            if (pdokInstance_g.fKernelPi)
+                writeKernelPi(channelId, &pFrame_p->data.pres.aPayload[0], pPdoChannel->pdoSize);
+#endif
+
+#if (CONFIG_PDO_RX_DMA != FALSE)
+            // The Rx buffer is released after a DMA transfer, so only the last
+            // channel of the node may be transferred by DMA.
+            if (nextChannelId == PDOK_CHANNEL_ID_INVALID)
+            {
+                ret = pdokcal_copyRxPdoDma(channelId, pFrame_p, frameSize_p, pPdoChannel->pdoSize);
+                continue;
+            }
+#endif
+            pdokcal_writeRxPdo(channelId,
+                               &pFrame_p->data.pres.aPayload[0],
+                               pPdoChannel->pdoSize);
+        }
+        CYCLESTAT_MARK(kCycleStatStageRxPdo);
     }
 
 Exit:
-#if CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_SYNC != FALSE
+#if (CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_SYNC != FALSE) && (CONFIG_PDO_RX_DIRECT_COPY == FALSE) && \
+    (CONFIG_PDO_RX_WORKER == FALSE)
     dllk_releaseRxFrame(pFrame_p, frameSize_p);
     // $$$ return value?
 #endif
@@ -510,8 +690,175 @@ The function sends a sync event.
 //------------------------------------------------------------------------------
 tOplkError pdok_sendSyncEvent(void)
 {
+#if (CONFIG_DLL_SOC_TIME_INFO != FALSE)
+    tSocTimeInfo    socTimeInfo;
+
+    // publish the time of the SoC before the application is informed
+    dllk_getSocTimeInfo(&socTimeInfo);
+    pdokcal_writeSocTime(&socTimeInfo);
+#endif
+
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+    if (pdokInstance_g.fKernelPi)
+    {
+        const BYTE*     pKernelPiIn;
+
+        // the application gets the output image of this cycle with the sync event
+        pdokcal_writeKernelPiOut(pdokInstance_g.aKernelPiOut, pdokInstance_g.kernelPiOutSize);
+
+        // the TPDOs of the next cycle are taken from the latest input image
+        pKernelPiIn = pdokcal_getKernelPiIn();
+        if (pKernelPiIn != NULL)
+            pdokInstance_g.pKernelPiIn = pKernelPiIn;
+    }
+#endif
+
     pdokcal_sendSyncEvent();
+    CYCLESTAT_MARK(kCycleStatStageSyncEvent);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add RPDO to TPDO route
+
+The function adds a route which copies a region of an RPDO into a TPDO. The
+region is copied when the RPDO is received and inserted into the TPDO when the
+TPDO is sent, so the data is forwarded without passing the process images.
+The data is passed by a triple buffer per route, therefore the receive and the
+transmit path may run in different contexts. The region of the TPDO is
+overwritten by the route as soon as the first RPDO has been received.
+
+The routes are removed if the PDO channels are reallocated.
+
+\param  pRoute_p                Pointer to the route.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The route is added.
+\retval kErrorPdoNotExist       The RPDO or TPDO channel does not exist.
+\retval kErrorNoResource        No free route or route data is available.
+
+\ingroup module_pdok
+**/
+//------------------------------------------------------------------------------
+tOplkError pdok_addRoute(const tPdoRoute* pRoute_p)
+{
+#if (CONFIG_PDO_ROUTE_COUNT != 0)
+    tPdokRoute*     pRoute;
+    UINT            i;
+
+    if ((pRoute_p->rxChannelId >= pdokInstance_g.pdoChannels.allocation.rxPdoChannelCount) ||
+        (pRoute_p->txChannelId >= pdokInstance_g.pdoChannels.allocation.txPdoChannelCount))
+        return kErrorPdoNotExist;
+
+    if ((pRoute_p->size == 0) ||
+        (pdokInstance_g.routeCount >= CONFIG_PDO_ROUTE_COUNT) ||
+        (pRoute_p->size > (CONFIG_PDO_ROUTE_BUFFER_SIZE - pdokInstance_g.routeDataSize)))
+        return kErrorNoResource;
+
+    pRoute = &pdokInstance_g.aRoute[pdokInstance_g.routeCount];
+    pRoute->route = *pRoute_p;
+    for (i = 0; i < 3; i++)
+        pRoute->aBufOffset[i] = (3 * pdokInstance_g.routeDataSize) + (i * pRoute_p->size);
+    pRoute->writeBuf = 0;
+    pRoute->cleanBuf = 1;
+    pRoute->readBuf = 2;
+    pRoute->newData = 0;
+    pRoute->fValid = FALSE;
+
+    pdokInstance_g.routeDataSize += pRoute_p->size;
+    pdokInstance_g.routeCount++;
+
     return kErrorOk;
+#else
+    UNUSED_PARAMETER(pRoute_p);
+    return kErrorNoResource;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set up kernel process images
+
+The function sets up the process images which are assembled by the kernel
+layer. The copy operations are read from the PDO memory, the RPDO operations
+first and each direction sorted by the channel ID. The RPDOs are copied into
+the output process image when they are received, and the image is published
+in the PDO memory at the sync event. The input process image published by the
+user layer is switched at the sync event and copied into the TPDOs when they
+are sent, so all TPDOs of a cycle are taken from the same image.
+
+The kernel process images are disabled if the PDO channels are reallocated.
+
+\param  pSetup_p                Pointer to the setup of the process images.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The kernel process images are set up.
+\retval kErrorPdoNotExist       A copy operation is invalid.
+\retval kErrorNoResource        The process images or the copy operations
+                                exceed the configured size.
+
+\ingroup module_pdok
+**/
+//------------------------------------------------------------------------------
+tOplkError pdok_setupKernelPi(const tPdoKernelPiSetup* pSetup_p)
+{
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+    tOplkError      ret;
+    UINT            copyIndex = 0;
+
+    pdokInstance_g.fKernelPi = FALSE;
+    pdokInstance_g.pKernelPiIn = NULL;
+
+    if (pSetup_p->copyCount == 0)
+        return kErrorOk;
+
+    if ((pSetup_p->copyCount > CONFIG_PDO_KERNEL_PI_COPY_COUNT) ||
+        (pSetup_p->rxPiSize > CONFIG_PDO_KERNEL_PI_SIZE) ||
+        (pSetup_p->txPiSize > CONFIG_PDO_KERNEL_PI_SIZE))
+        return kErrorNoResource;
+
+    // the operations are copied before they are checked, the user layer may
+    // still modify the PDO memory
+    ret = pdokcal_readKernelPiCopy(pdokInstance_g.aKernelPiCopy, pSetup_p->copyCount);
+    if (ret != kErrorOk)
+        return ret;
+
+    if (!indexKernelPiCopy(FALSE, pdokInstance_g.aRxKernelPiCopy,
+                           pdokInstance_g.pdoChannels.allocation.rxPdoChannelCount,
+                           pSetup_p->rxPiSize, pSetup_p->copyCount, &copyIndex) ||
+        !indexKernelPiCopy(TRUE, pdokInstance_g.aTxKernelPiCopy,
+                           pdokInstance_g.pdoChannels.allocation.txPdoChannelCount,
+                           pSetup_p->txPiSize, pSetup_p->copyCount, &copyIndex) ||
+        (copyIndex != pSetup_p->copyCount))
+        return kErrorPdoNotExist;
+
+    OPLK_MEMSET(pdokInstance_g.aKernelPiOut, 0, sizeof(pdokInstance_g.aKernelPiOut));
+    pdokInstance_g.kernelPiOutSize = pSetup_p->rxPiSize;
+    pdokInstance_g.fKernelPi = TRUE;
+
+    return kErrorOk;
+#else
+    UNUSED_PARAMETER(pSetup_p);
+    return kErrorNoResource;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Remove all RPDO to TPDO routes
+
+The function removes all routes added by pdok_addRoute().
+
+\ingroup module_pdok
+**/
+//------------------------------------------------------------------------------
+void pdok_clearRoutes(void)
+{
+#if (CONFIG_PDO_ROUTE_COUNT != 0)
+    pdokInstance_g.routeCount = 0;
+    pdokInstance_g.routeDataSize = 0;
+#endif
 }
 
 //============================================================================//
@@ -537,10 +884,31 @@ NMT_CS_OPERATIONAL.
 static tOplkError cbProcessTpdo(tFrameInfo* pFrameInfo_p, BOOL fReadyFlag_p)
 {
     tOplkError      Ret = kErrorOk;
-    Ret = copyTxPdo(pFrameInfo_p->pFrame, pFrameInfo_p->frameSize, fReadyFlag_p);
+    Ret = copyTxPdo(pFrameInfo_p, fReadyFlag_p, FALSE);
     return Ret;
 }
 
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  TPDO zero-copy callback function
+
+This function is called by the DLL if a PRes of a CN needs to be encoded. If the
+PRes fits into the buffer of its TPDO channel, the frame in the frame info is
+replaced by the frame in the TPDO buffer, so that the payload is not copied.
+
+\param  pFrameInfo_p                Pointer to frame info structure
+\param  fReadyFlag_p                State of RD flag which shall be set in TPDO
+
+\return The function returns a tOplkError error code.
+**/
+//------------------------------------------------------------------------------
+static tOplkError cbProcessTpdoZeroCopy(tFrameInfo* pFrameInfo_p, BOOL fReadyFlag_p)
+{
+    return copyTxPdo(pFrameInfo_p, fReadyFlag_p, TRUE);
+}
+#endif
+
 //------------------------------------------------------------------------------
 /**
 \brief  Disable PDO channels
@@ -563,35 +931,139 @@ static void disablePdoChannels(tPdoChannel* pPdoChannel_p, UINT channelCnt_p)
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Reset a channel lookup table
+
+The function marks all node IDs of a channel lookup table as having no PDO
+channel.
+
+\param  pLut_p                  Pointer to the lookup table
+*/
+//------------------------------------------------------------------------------
+static void resetChannelIdLut(tPdokChannelId* pLut_p)
+{
+    UINT        nodeId;
+
+    for (nodeId = 0; nodeId < PDOK_CHANNEL_LUT_SIZE; nodeId++)
+        pLut_p[nodeId] = PDOK_CHANNEL_ID_INVALID;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Reset RPDO channel lists
+
+The function removes all RPDO channels from the channel lists of the nodes.
+*/
+//------------------------------------------------------------------------------
+static void resetRpdoChannelList(void)
+{
+    UINT        channelId;
+
+    resetChannelIdLut(pdokInstance_g.aRpdoChannelIdLut);
+    for (channelId = 0; channelId < D_PDO_RPDOChannels_U16; channelId++)
+        pdokInstance_g.aRpdoNextChannel[channelId] = PDOK_CHANNEL_ID_INVALID;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add an RPDO channel to the channel list of a node
+
+The channel is appended to the list, so the channels of a node are processed
+in the order they were configured. The list is kept consistent for a concurrent
+pdok_processRxPdo() at every step.
+
+\param  channelId_p             Channel ID of the RPDO.
+\param  nodeId_p                Source node ID of the RPDO.
+*/
+//------------------------------------------------------------------------------
+static void linkRpdoChannel(UINT channelId_p, UINT nodeId_p)
+{
+    tPdokChannelId*     pLink;
+
+    if (nodeId_p >= PDOK_CHANNEL_LUT_SIZE)
+        return;
+
+    pdokInstance_g.aRpdoNextChannel[channelId_p] = PDOK_CHANNEL_ID_INVALID;
+
+    pLink = &pdokInstance_g.aRpdoChannelIdLut[nodeId_p];
+    while (*pLink != PDOK_CHANNEL_ID_INVALID)
+    {
+        if (*pLink == channelId_p)
+            return;
+        pLink = &pdokInstance_g.aRpdoNextChannel[*pLink];
+    }
+    *pLink = (tPdokChannelId)channelId_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Remove an RPDO channel from the channel list of a node
+
+\param  channelId_p             Channel ID of the RPDO.
+\param  nodeId_p                Source node ID of the RPDO.
+*/
+//------------------------------------------------------------------------------
+static void unlinkRpdoChannel(UINT channelId_p, UINT nodeId_p)
+{
+    tPdokChannelId*     pLink;
+
+    if (nodeId_p >= PDOK_CHANNEL_LUT_SIZE)
+        return;
+
+    pLink = &pdokInstance_g.aRpdoChannelIdLut[nodeId_p];
+    while (*pLink != PDOK_CHANNEL_ID_INVALID)
+    {
+        if (*pLink == channelId_p)
+        {
+            *pLink = pdokInstance_g.aRpdoNextChannel[channelId_p];
+            return;
+        }
+        pLink = &pdokInstance_g.aRpdoNextChannel[*pLink];
+    }
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Copy TX PDO
 
-This function copies a PDO into the specified frame.
+This function copies a PDO into the specified frame. If zero-copy is allowed
+and the frame fits into the TPDO buffer, the frame is replaced by the frame in
+the TPDO buffer instead. The PDO is still copied if the TPDO buffer is used by
+the frame of the current cycle.
 
-\param  pFrame_p                Pointer to frame.
-\param  frameSize_p             Size of frame.
-\param  fReadyFlag_p
+\param  pFrameInfo_p            Pointer to frame info structure.
+\param  fReadyFlag_p            State of RD flag which shall be set in TPDO
+\param  fZeroCopy_p             The frame may be replaced by the TPDO buffer.
 //
 \return The function returns a tOplkError error code.
 **/
 //---------------------------------------------------------------------------
-static tOplkError copyTxPdo(tPlkFrame* pFrame_p, UINT frameSize_p, BOOL fReadyFlag_p)
+static tOplkError copyTxPdo(tFrameInfo* pFrameInfo_p, BOOL fReadyFlag_p, BOOL fZeroCopy_p)
 {
     tOplkError          ret = kErrorOk;
+    tPlkFrame*          pFrame = pFrameInfo_p->pFrame;
+    UINT                frameSize = pFrameInfo_p->frameSize;
     BYTE                flag1;
     UINT                nodeId;
     tMsgType            msgType;
     tPdoChannel*        pPdoChannel;
     UINT                channelId;
     UINT16              pdoSize;
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+    tPlkFrame*          pTxPdoFrame;
+#endif
+
+#if (CONFIG_PDO_TX_ZERO_COPY == FALSE)
+    UNUSED_PARAMETER(fZeroCopy_p);
+#endif
 
     // set TPDO invalid, so that only fully processed TPDOs are sent as valid
-    flag1 = ami_getUint8Le(&pFrame_p->data.pres.flag1);
-    ami_setUint8Le(&pFrame_p->data.pres.flag1, (flag1 & ~PLK_FRAME_FLAG1_RD));
+    flag1 = ami_getUint8Le(&pFrame->data.pres.flag1);
+    ami_setUint8Le(&pFrame->data.pres.flag1, (flag1 & ~PLK_FRAME_FLAG1_RD));
 
     // retrieve POWERLINK message type
-    msgType = ami_getUint8Le(&pFrame_p->messageType);
+    msgType = ami_getUint8Le(&pFrame->messageType);
     if (msgType == kMsgTypePres)
     {   // TPDO is PRes frame
         nodeId = PDO_PRES_NODE_ID;  // 0x00
@@ -599,28 +1071,69 @@ static tOplkError copyTxPdo(tPlkFrame* pFrame_p, UINT frameSize_p, BOOL fReadyFl
     else
     {   // TPDO is PReq frame
         // retrieve node ID
-        nodeId = ami_getUint8Le(&pFrame_p->dstNodeId);
+        nodeId = ami_getUint8Le(&pFrame->dstNodeId);
     }
 
-    if (pdokInstance_g.fRunning)
-    {
-        // Get PDO channel reference
+    // Get PDO channel reference
+    if (nodeId < PDOK_CHANNEL_LUT_SIZE)
         channelId = pdokInstance_g.aTpdoChannelIdLut[nodeId];
+    else
+        channelId = PDOK_CHANNEL_ID_INVALID;
+
+    if (pdokInstance_g.fRunning && (channelId != PDOK_CHANNEL_ID_INVALID))
+    {
         pPdoChannel = &pdokInstance_g.pdoChannels.pTxPdoChannel[channelId];
 
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+        if (pdokInstance_g.afTxRemapPending[channelId])
+        {
+            if (pdokcal_isTxPdoNew(channelId))
+                pdokInstance_g.afTxRemapPending[channelId] = FALSE;
+            else    // no TPDO of the new mapping yet, the receivers shall ignore the payload
+                fReadyFlag_p = FALSE;
+        }
+#endif
+
         // valid TPDO found
-        if ((unsigned int)(pPdoChannel->pdoSize + 24) <= frameSize_p)
+        if ((unsigned int)(pPdoChannel->pdoSize + 24) <= frameSize)
         {
             /*
             TRACE ("%s() Channel:%d Node:%d MapObjectCnt:%d PdoSize:%d\n",
                 __func__, channelId, nodeId, pPdoChannel->mappObjectCount, pPdoChannel->pdoSize);
             */
 
-            // set PDO version in frame
-            ami_setUint8Le(&pFrame_p->data.pres.pdoVersion, pPdoChannel->mappingVersion);
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+            pTxPdoFrame = NULL;
+            if (fZeroCopy_p &&
+                ((frameSize - PLK_FRAME_OFFSET_PDO_PAYLOAD) <= (UINT)PDO_TX_PAYLOAD_SIZE(pPdoChannel->pdoSize)))
+            {   // send the frame directly from the TPDO buffer, unless the
+                // buffer is still used by the frame of the current cycle
+                pTxPdoFrame = pdokcal_getTxPdoFrame(channelId, pFrame);
+            }
+
+            if (pTxPdoFrame != NULL)
+            {
+                pFrame = pTxPdoFrame;
+                pFrameInfo_p->pFrame = pFrame;
+            }
+            else
+#endif
+            {
+                pdokcal_readTxPdo(channelId, &pFrame->data.pres.aPayload[0],
+                                  pPdoChannel->pdoSize);
+            }
 
-            pdokcal_readTxPdo(channelId, &pFrame_p->data.pres.aPayload[0],
-                              pPdoChannel->pdoSize);
+#if (CONFIG_PDO_ROUTE_COUNT != 0)
+            readRoutes(channelId, &pFrame->data.pres.aPayload[0], pPdoChannel->pdoSize);
+#endif
+
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+            if (pdokInstance_g.fKernelPi && (pdokInstance_g.pKernelPiIn != NULL))
+                readKernelPi(channelId, &pFrame->data.pres.aPayload[0], pPdoChannel->pdoSize);
+#endif
+
+            // set PDO version in frame
+            ami_setUint8Le(&pFrame->data.pres.pdoVersion, pPdoChannel->mappingVersion);
 
             // set PDO size in frame
             pdoSize = pPdoChannel->pdoSize;
@@ -634,20 +1147,204 @@ static tOplkError copyTxPdo(tPlkFrame* pFrame_p, UINT frameSize_p, BOOL fReadyFl
     else
     {
         // set PDO size in frame to zero, because no TPDO mapped
+        // or no TPDO channel is configured for this node
         pdoSize = 0;
     }
 
     // set PDO size in frame
-    ami_setUint16Le(&pFrame_p->data.pres.sizeLe, pdoSize);
+    ami_setUint16Le(&pFrame->data.pres.sizeLe, pdoSize);
 
     if (fReadyFlag_p != FALSE)
     {
         // set TPDO valid
-        ami_setUint8Le(&pFrame_p->data.pres.flag1, (flag1 | PLK_FRAME_FLAG1_RD));
+        ami_setUint8Le(&pFrame->data.pres.flag1, (flag1 | PLK_FRAME_FLAG1_RD));
     }
 
     return ret;
 }
 
+#if (CONFIG_PDO_ROUTE_COUNT != 0)
+//------------------------------------------------------------------------------
+/**
+\brief  Write routed RPDO data
+
+The function copies the routed regions of a received RPDO into the write
+buffers of the routes and publishes them.
+
+\param  channelId_p             Channel ID of the RPDO.
+\param  pPayload_p              Pointer to the RPDO payload.
+\param  pdoSize_p               Size of the RPDO.
+**/
+//------------------------------------------------------------------------------
+static void writeRoutes(UINT channelId_p, const BYTE* pPayload_p, UINT pdoSize_p)
+{
+    tPdokRoute*     pRoute;
+    OPLK_ATOMIC_T   temp;
+    UINT            i;
+
+    for (i = 0, pRoute = pdokInstance_g.aRoute; i < pdokInstance_g.routeCount; i++, pRoute++)
+    {
+        if ((pRoute->route.rxChannelId != channelId_p) ||
+            ((UINT)(pRoute->route.rxOffset + pRoute->route.size) > pdoSize_p))
+            continue;
+
+        OPLK_MEMCPY(&pdokInstance_g.aRouteData[pRoute->aBufOffset[pRoute->writeBuf]],
+                    pPayload_p + pRoute->route.rxOffset, pRoute->route.size);
+
+        temp = pRoute->writeBuf;
+        OPLK_ATOMIC_EXCHANGE(&pRoute->cleanBuf, temp, pRoute->writeBuf);
+        pRoute->newData = 1;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Insert routed RPDO data into a TPDO
+
+The function inserts the latest data of the routes into a TPDO which is sent.
+
+\param  channelId_p             Channel ID of the TPDO.
+\param  pPayload_p              Pointer to the TPDO payload.
+\param  pdoSize_p               Size of the TPDO.
+**/
+//------------------------------------------------------------------------------
+static void readRoutes(UINT channelId_p, BYTE* pPayload_p, UINT pdoSize_p)
+{
+    tPdokRoute*     pRoute;
+    OPLK_ATOMIC_T   temp;
+    UINT            i;
+
+    for (i = 0, pRoute = pdokInstance_g.aRoute; i < pdokInstance_g.routeCount; i++, pRoute++)
+    {
+        if ((pRoute->route.txChannelId != channelId_p) ||
+            ((UINT)(pRoute->route.txOffset + pRoute->route.size) > pdoSize_p))
+            continue;
+
+        if (pRoute->newData)
+        {
+            temp = pRoute->readBuf;
+            OPLK_ATOMIC_EXCHANGE(&pRoute->cleanBuf, temp, pRoute->readBuf);
+            pRoute->newData = 0;
+            pRoute->fValid = TRUE;
+        }
+
+        if (pRoute->fValid)
+        {
+            OPLK_MEMCPY(pPayload_p + pRoute->route.txOffset,
+                        &pdokInstance_g.aRouteData[pRoute->aBufOffset[pRoute->readBuf]],
+                        pRoute->route.size);
+        }
+    }
+}
+#endif
+
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Index the kernel process image copy operations of one direction
+
+The function checks the copy operations of one direction, which start at the
+given index, and stores the first operation of each channel in the index
+table. The operations of a channel end at the first operation of the next
+channel.
+
+\param  fTx_p                   TRUE for the TPDO and FALSE for the RPDO operations.
+\param  paIndex_p               Pointer to the index table with one entry more
+                                than channels.
+\param  channelCount_p          Number of allocated channels of the direction.
+\param  piSize_p                Size of the process image of the direction.
+\param  copyCount_p             Number of copy operations.
+\param  pCopyIndex_p            Pointer to the index of the first operation of
+                                the direction. It is set to the index behind
+                                the last operation of the direction.
+
+\return The function returns TRUE if the operations are valid.
+**/
+//------------------------------------------------------------------------------
+static BOOL indexKernelPiCopy(BOOL fTx_p, UINT16* paIndex_p, UINT channelCount_p,
+                              UINT piSize_p, UINT copyCount_p, UINT* pCopyIndex_p)
+{
+    tPdoKernelPiCopy*   pCopy;
+    UINT                copyIndex;
+    UINT                nextChannelId = 0;
+
+    for (copyIndex = *pCopyIndex_p; copyIndex < copyCount_p; copyIndex++)
+    {
+        pCopy = &pdokInstance_g.aKernelPiCopy[copyIndex];
+        if ((pCopy->fTx != FALSE) != (fTx_p != FALSE))
+            break;
+
+        if ((pCopy->channelId >= channelCount_p) ||
+            ((UINT)(pCopy->channelId + 1) < nextChannelId) ||
+            (pCopy->size == 0) ||
+            (pCopy->piOffset > piSize_p) || (pCopy->size > (piSize_p - pCopy->piOffset)))
+            return FALSE;
+
+        while (nextChannelId <= pCopy->channelId)
+            paIndex_p[nextChannelId++] = (UINT16)copyIndex;
+    }
+
+    while (nextChannelId <= channelCount_p)
+        paIndex_p[nextChannelId++] = (UINT16)copyIndex;
+
+    *pCopyIndex_p = copyIndex;
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy an RPDO into the kernel output process image
+
+\param  channelId_p             Channel ID of the RPDO.
+\param  pPayload_p              Pointer to the RPDO payload.
+\param  pdoSize_p               Size of the RPDO.
+**/
+//------------------------------------------------------------------------------
+static void writeKernelPi(UINT channelId_p, const BYTE* pPayload_p, UINT pdoSize_p)
+{
+    const tPdoKernelPiCopy* pCopy;
+    const tPdoKernelPiCopy* pCopyEnd;
+
+    pCopy = &pdokInstance_g.aKernelPiCopy[pdokInstance_g.aRxKernelPiCopy[channelId_p]];
+    pCopyEnd = &pdokInstance_g.aKernelPiCopy[pdokInstance_g.aRxKernelPiCopy[channelId_p + 1]];
+
+    for (; pCopy < pCopyEnd; pCopy++)
+    {
+        if ((UINT)(pCopy->pdoOffset + pCopy->size) > pdoSize_p)
+            continue;
+
+        OPLK_MEMCPY(&pdokInstance_g.aKernelPiOut[pCopy->piOffset],
+                    pPayload_p + pCopy->pdoOffset, pCopy->size);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy a TPDO from the kernel input process image
+
+\param  channelId_p             Channel ID of the TPDO.
+\param  pPayload_p              Pointer to the TPDO payload.
+\param  pdoSize_p               Size of the TPDO.
+**/
+//------------------------------------------------------------------------------
+static void readKernelPi(UINT channelId_p, BYTE* pPayload_p, UINT pdoSize_p)
+{
+    const tPdoKernelPiCopy* pCopy;
+    const tPdoKernelPiCopy* pCopyEnd;
+
+    pCopy = &pdokInstance_g.aKernelPiCopy[pdokInstance_g.aTxKernelPiCopy[channelId_p]];
+    pCopyEnd = &pdokInstance_g.aKernelPiCopy[pdokInstance_g.aTxKernelPiCopy[channelId_p + 1]];
+
+    for (; pCopy < pCopyEnd; pCopy++)
+    {
+        if ((UINT)(pCopy->pdoOffset + pCopy->size) > pdoSize_p)
+            continue;
+
+        OPLK_MEMCPY(pPayload_p + pCopy->pdoOffset,
+                    &pdokInstance_g.pKernelPiIn[pCopy->piOffset], pCopy->size);
+    }
+}
+#endif
+
 ///\}
 
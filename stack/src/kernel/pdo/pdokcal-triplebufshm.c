@@ -7,7 +7,9 @@
 This file contains an implementation for the kernel PDO CAL module which uses
 a shared memory region between user and kernel layer. PDOs are transfered
 through triple buffering between the layers. Therefore, reads and writes to
-the PDOs can occur completely asynchronously.
+the PDOs can occur completely asynchronously. The RPDOs can be read by
+CONFIG_PDO_RX_READER_COUNT independent readers, they are exchanged through
+CONFIG_PDO_RX_READER_COUNT + 2 buffers.
 
 This file contains no specific shared memory implementation. This is encapsulated
 in the pdokcalmem-XX.c modules.
@@ -49,6 +51,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 #include <oplk/oplkinc.h>
 #include <common/pdo.h>
+#include <common/memcopy.h>
 #include <kernel/pdokcal.h>
 
 //============================================================================//
@@ -75,22 +78,43 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#define PDOKCAL_TX_BUF_INVALID      PDO_BUFFER_COUNT    ///< No TPDO buffer is used by the last frame
 
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+/**
+\brief Kernel TPDO buffer state
+
+The structure holds the TPDO buffers of a channel which are owned by the kernel
+layer besides the read buffer. The frame which was built last may still be
+armed or on the wire, so its buffer is neither used for the next frame nor
+handed back to the user layer.
+*/
+typedef struct
+{
+    OPLK_ATOMIC_T       spareBuf;               ///< Spare buffer, replaces a read buffer which is still sent
+    OPLK_ATOMIC_T       frameBuf;               ///< Buffer of the last frame built by pdokcal_getTxPdoFrame()
+} tPdokcalTxBufState;
+#endif
 
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
 static tPdoMemRegion*       pPdoMem_l;
 static size_t               pdoMemRegionSize_l;
-static BYTE*                pTripleBuf_l[3];
+static BYTE*                pPdoBuf_l[PDO_BUFFER_COUNT];
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+static tPdokcalTxBufState   aTxBufState_l[D_PDO_TPDOChannels_U16];
+#endif
 
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
 static void setupPdoMemInfo(tPdoChannelSetup* pPdoChannels_p, tPdoMemRegion* pPdoMemRegion_p);
+static OPLK_ATOMIC_T getFreeRxBuffer(const tPdoBufferInfo* pInfo_p);
+static void exchangeTxReadBuffer(UINT channelId_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -131,25 +155,25 @@ tOplkError pdokcal_initPdoMem(tPdoChannelSetup* pPdoChannels, size_t rxPdoMemSiz
                               size_t txPdoMemSize_p)
 {
     size_t  pdoMemSize;
+    UINT    i;
 
     pdoMemSize = txPdoMemSize_p + rxPdoMemSize_p;
 
     if (pPdoMem_l != NULL)
         pdokcal_freeMem((BYTE*)pPdoMem_l, pdoMemRegionSize_l);
 
-    pdoMemRegionSize_l = (pdoMemSize * 3) + sizeof(tPdoMemRegion);
+    pdoMemRegionSize_l = (pdoMemSize * PDO_BUFFER_COUNT) + PDO_ALIGN_CACHE_LINE(sizeof(tPdoMemRegion));
     if (pdokcal_allocateMem(pdoMemRegionSize_l, (BYTE**)&pPdoMem_l) != kErrorOk)
     {
         return kErrorNoResource;
     }
 
-    pTripleBuf_l[0] = (BYTE*)pPdoMem_l + sizeof(tPdoMemRegion);
-    pTripleBuf_l[1] = pTripleBuf_l[0] + pdoMemSize;
-    pTripleBuf_l[2] = pTripleBuf_l[1] + pdoMemSize;
+    pPdoBuf_l[0] = (BYTE*)pPdoMem_l + PDO_ALIGN_CACHE_LINE(sizeof(tPdoMemRegion));
+    for (i = 1; i < PDO_BUFFER_COUNT; i++)
+        pPdoBuf_l[i] = pPdoBuf_l[i - 1] + pdoMemSize;
 
-    TRACE ("%s() PdoMem:%p size:%d Triple buffers at: %p/%p/%p\n", __func__,
-           pPdoMem_l, pdoMemRegionSize_l,
-           pTripleBuf_l[0], pTripleBuf_l[1], pTripleBuf_l[2]);
+    TRACE ("%s() PdoMem:%p size:%d %d buffers at: %p\n", __func__,
+           pPdoMem_l, pdoMemRegionSize_l, PDO_BUFFER_COUNT, pPdoBuf_l[0]);
 
     OPLK_MEMSET(pPdoMem_l, 0, pdoMemRegionSize_l);
     setupPdoMemInfo(pPdoChannels, pPdoMem_l);
@@ -177,9 +201,7 @@ void pdokcal_cleanupPdoMem(void)
 
     pPdoMem_l = NULL;
     pdoMemRegionSize_l = 0;
-    pTripleBuf_l[0] = NULL;
-    pTripleBuf_l[1] = NULL;
-    pTripleBuf_l[2] = NULL;
+    OPLK_MEMSET(pPdoBuf_l, 0, sizeof(pPdoBuf_l));
 }
 
 //------------------------------------------------------------------------------
@@ -199,27 +221,199 @@ The function writes a received RXPDO into the PDO memory range.
 //------------------------------------------------------------------------------
 tOplkError pdokcal_writeRxPdo(UINT channelId_p, BYTE* pPayload_p, UINT16 pdoSize_p)
 {
-    BYTE*           pPdo;
-    OPLK_ATOMIC_T   temp;
+    //TRACE ("%s() chan:%d wi:%d\n", __func__, channelId_p, pPdoMem_l->rxChannelInfo[channelId_p].info.writeBuf);
 
-    pPdo = pTripleBuf_l[pPdoMem_l->rxChannelInfo[channelId_p].writeBuf] +
-           pPdoMem_l->rxChannelInfo[channelId_p].channelOffset;
-    //TRACE ("%s() chan:%d wi:%d\n", __func__, channelId_p, pPdoMem_l->rxChannelInfo[channelId_p].writeBuf);
+#if (CONFIG_PDO_RX_STREAM_COPY != FALSE)
+    // ordered by the barrier of pdokcal_commitRxPdo()
+    memcopy_stream(pdokcal_getRxPdoWriteBuffer(channelId_p), pPayload_p, pdoSize_p);
+#else
+    OPLK_MEMCPY(pdokcal_getRxPdoWriteBuffer(channelId_p), pPayload_p, pdoSize_p);
+#endif
+    pdokcal_commitRxPdo(channelId_p);
 
-    OPLK_MEMCPY(pPdo, pPayload_p, pdoSize_p);
+    //TRACE ("%s() *pPayload_p:%02x\n", __func__, *pPayload_p);
+    return kErrorOk;
+}
 
-    temp = pPdoMem_l->rxChannelInfo[channelId_p].writeBuf;
-    OPLK_ATOMIC_EXCHANGE(&pPdoMem_l->rxChannelInfo[channelId_p].cleanBuf,
-                         temp,
-                         pPdoMem_l->rxChannelInfo[channelId_p].writeBuf);
+//------------------------------------------------------------------------------
+/**
+\brief  Get write buffer of RXPDO
 
-    pPdoMem_l->rxChannelInfo[channelId_p].newData = 1;
+The function returns the address of an RXPDO in the current write buffer. The
+RXPDO can be written there by other means than
+pdokcal_writeRxPdo() (e.g. by DMA) and is published with pdokcal_commitRxPdo().
 
-    //TRACE ("%s() chan:%d new wi:%d\n", __func__, channelId_p, pPdoMem_l->rxChannelInfo[channelId_p].writeBuf);
-    //TRACE ("%s() *pPayload_p:%02x\n", __func__, *pPayload_p);
+\param  channelId_p             Channel ID of PDO to write.
+
+\return The function returns the address of the RXPDO in the write buffer.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+BYTE* pdokcal_getRxPdoWriteBuffer(UINT channelId_p)
+{
+    return pPdoBuf_l[pPdoMem_l->rxChannelInfo[channelId_p].info.writeBuf] +
+           pPdoMem_l->rxChannelInfo[channelId_p].info.channelOffset;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Commit RXPDO
+
+The function publishes the RXPDO which is written into the write buffer as the
+latest buffer. Afterwards a buffer which is held by no reader becomes the write
+buffer, so the function never waits for the readers.
+
+\param  channelId_p             Channel ID of PDO to commit.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+void pdokcal_commitRxPdo(UINT channelId_p)
+{
+    tPdoBufferInfo* pInfo = &pPdoMem_l->rxChannelInfo[channelId_p].info;
+
+    // the sequence number travels with the buffer, so the reader knows if it got fresh data
+    pInfo->sequence++;
+    pInfo->aSequence[pInfo->writeBuf] = pInfo->sequence;
+
+    // Publish the buffer after its data is completely written. The barrier also
+    // drains the write-combining buffers of a write-combining PDO memory.
+    OPLK_MEMBAR();
+    pInfo->cleanBuf = pInfo->writeBuf;
+
+    // A reader claims a buffer and checks afterwards that it is still the latest
+    // one. The barrier orders the publication before the check of the claims,
+    // so either the writer sees the claim or the reader sees the new buffer.
+    OPLK_MEMBAR();
+    pInfo->writeBuf = getFreeRxBuffer(pInfo);
+
+    //TRACE ("%s() chan:%d new wi:%d\n", __func__, channelId_p, pPdoMem_l->rxChannelInfo[channelId_p].info.writeBuf);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write SoC time information to PDO memory
+
+The function publishes the time information of the last SoC in the PDO memory,
+where the user layer reads it together with the RPDOs of the cycle.
+
+\param  pSocTimeInfo_p          Pointer to the SoC time information.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+void pdokcal_writeSocTime(const tSocTimeInfo* pSocTimeInfo_p)
+{
+    tPdoSocTime*    pSocTime;
+
+    if (pPdoMem_l == NULL)
+        return;
+
+    pSocTime = &pPdoMem_l->socTime.socTime;
+
+    pSocTime->sequence++;
+    OPLK_MEMBAR();
+    pSocTime->timeInfo = *pSocTimeInfo_p;
+    OPLK_MEMBAR();
+    pSocTime->sequence++;
+}
+
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Read copy operations of the kernel process images
+
+The function copies the copy operations of the kernel process images which
+were written to the PDO memory by the user layer. The caller must validate
+the copied operations, because the user layer may still modify the PDO memory.
+
+\param  paCopy_p                Pointer to store the copy operations.
+\param  copyCount_p             Number of copy operations to read.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+tOplkError pdokcal_readKernelPiCopy(tPdoKernelPiCopy* paCopy_p, UINT copyCount_p)
+{
+    if (pPdoMem_l == NULL)
+        return kErrorNoResource;
+
+    if (copyCount_p > CONFIG_PDO_KERNEL_PI_COPY_COUNT)
+        return kErrorNoResource;
+
+    OPLK_MEMCPY(paCopy_p, pPdoMem_l->kernelPi.aCopy, copyCount_p * sizeof(tPdoKernelPiCopy));
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Write output process image to PDO memory
+
+The function copies the output process image assembled by the kernel layer
+into the write buffer of its triple buffer and publishes it.
+
+\param  pImage_p                Pointer to the output process image.
+\param  size_p                  Size of the output process image.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+void pdokcal_writeKernelPiOut(const BYTE* pImage_p, UINT size_p)
+{
+    tPdoBufferInfo*     pInfo;
+    OPLK_ATOMIC_T       temp;
+
+    if ((pPdoMem_l == NULL) || (size_p > PDO_KERNEL_PI_SIZE))
+        return;
+
+    pInfo = &pPdoMem_l->kernelPi.aImageInfo[PDO_KERNEL_PI_OUTPUT].info;
+
+    OPLK_MEMCPY(pPdoMem_l->kernelPi.aaaImage[PDO_KERNEL_PI_OUTPUT][pInfo->writeBuf], pImage_p, size_p);
+    OPLK_MEMBAR();
+
+    temp = pInfo->writeBuf;
+    OPLK_ATOMIC_EXCHANGE(&pInfo->cleanBuf, temp, pInfo->writeBuf);
+    pInfo->newData = 1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get input process image from PDO memory
+
+The function switches to the input process image which was published last by
+the user layer. The buffer stays valid until the next call of the function
+which returns a new buffer.
+
+\return The function returns a pointer to the input process image or NULL if
+        the user layer did not publish a new image since the last call.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+const BYTE* pdokcal_getKernelPiIn(void)
+{
+    tPdoBufferInfo*     pInfo;
+    OPLK_ATOMIC_T       temp;
+
+    if (pPdoMem_l == NULL)
+        return NULL;
+
+    pInfo = &pPdoMem_l->kernelPi.aImageInfo[PDO_KERNEL_PI_INPUT].info;
+    if (!pInfo->newData)
+        return NULL;
+
+    temp = pInfo->readBuf;
+    OPLK_ATOMIC_EXCHANGE(&pInfo->cleanBuf, temp, pInfo->readBuf);
+    pInfo->newData = 0;
+    OPLK_MEMBAR();
+
+    return pPdoMem_l->kernelPi.aaaImage[PDO_KERNEL_PI_INPUT][pInfo->readBuf];
+}
+#endif
+
 //------------------------------------------------------------------------------
 /**
 \brief  Read TXPDO from PDO memory
@@ -238,28 +432,115 @@ The function reads a TXPDO to be sent from the PDO memory range.
 tOplkError pdokcal_readTxPdo(UINT channelId_p, BYTE* pPayload_p, UINT16 pdoSize_p)
 {
     BYTE*           pPdo;
-    OPLK_ATOMIC_T   readBuf;
 
-    if (pPdoMem_l->txChannelInfo[channelId_p].newData)
-    {
-        readBuf = pPdoMem_l->txChannelInfo[channelId_p].readBuf;
-        OPLK_ATOMIC_EXCHANGE(&pPdoMem_l->txChannelInfo[channelId_p].cleanBuf,
-                             readBuf,
-                             pPdoMem_l->txChannelInfo[channelId_p].readBuf);
-        pPdoMem_l->txChannelInfo[channelId_p].newData = 0;
-    }
+    if (pPdoMem_l->txChannelInfo[channelId_p].info.newData)
+        exchangeTxReadBuffer(channelId_p);
+
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+    // the payload is copied, the next frame does not use a TPDO buffer
+    aTxBufState_l[channelId_p].frameBuf = PDOKCAL_TX_BUF_INVALID;
+#endif
 
     /*TRACE ("%s() pPdo_p:%p pPayload:%p size:%d value:%d\n", __func__,
             pPdo_p, pPayload_p, pdoSize_p, *pPdo_p);*/
-    //TRACE ("%s() chan:%d ri:%d\n", __func__, channelId_p, pPdoMem_l->txChannelInfo[channelId_p].readBuf);
-    pPdo =  pTripleBuf_l[pPdoMem_l->txChannelInfo[channelId_p].readBuf] +
-            pPdoMem_l->txChannelInfo[channelId_p].channelOffset;
-
+    //TRACE ("%s() chan:%d ri:%d\n", __func__, channelId_p, pPdoMem_l->txChannelInfo[channelId_p].info.readBuf);
+    pPdo =  pPdoBuf_l[pPdoMem_l->txChannelInfo[channelId_p].info.readBuf] +
+            pPdoMem_l->txChannelInfo[channelId_p].info.channelOffset;
+
+#if (CONFIG_PDO_TX_STREAM_COPY != FALSE)
+    memcopy_stream(pPayload_p, pPdo, pdoSize_p);
+    memcopy_streamFence();
+#else
     OPLK_MEMCPY(pPayload_p, pPdo, pdoSize_p);
+#endif
 
     return kErrorOk;
 }
 
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Get TXPDO frame
+
+The function returns the read buffer of a TXPDO channel as frame, i.e. the
+payload is not copied. If the user layer has written a new TXPDO, the read
+buffer is exchanged like in pdokcal_readTxPdo(). The frame header is copied
+from the specified frame into the room in front of the channel buffer.
+
+The frame built by the previous call may still be armed for the current cycle.
+Its buffer is never handed back to the user layer, the spare buffer of the
+channel is exchanged instead. If there is no new TXPDO, the read buffer is
+still used by the previous frame and the function fails. The caller must copy
+the TXPDO with pdokcal_readTxPdo() in this case.
+
+\param  channelId_p             Channel ID of PDO to read.
+\param  pFrame_p                Frame which is currently used for the TXPDO.
+
+\return The function returns a pointer to the frame in the PDO memory or NULL
+        if the read buffer is still used by the previous frame.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+tPlkFrame* pdokcal_getTxPdoFrame(UINT channelId_p, tPlkFrame* pFrame_p)
+{
+    tPlkFrame*      pTxFrame;
+
+    if (pPdoMem_l->txChannelInfo[channelId_p].info.newData)
+        exchangeTxReadBuffer(channelId_p);
+
+    if (pPdoMem_l->txChannelInfo[channelId_p].info.readBuf == aTxBufState_l[channelId_p].frameBuf)
+        return NULL;
+
+    aTxBufState_l[channelId_p].frameBuf = pPdoMem_l->txChannelInfo[channelId_p].info.readBuf;
+    pTxFrame = (tPlkFrame*)(pPdoBuf_l[pPdoMem_l->txChannelInfo[channelId_p].info.readBuf] +
+                            pPdoMem_l->txChannelInfo[channelId_p].info.channelOffset -
+                            PLK_FRAME_OFFSET_PDO_PAYLOAD);
+
+    if (pTxFrame != pFrame_p)
+        OPLK_MEMCPY_FIXED(pTxFrame, pFrame_p, PLK_FRAME_OFFSET_PDO_PAYLOAD);
+
+    return pTxFrame;
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check for new TXPDO
+
+The function checks if the user layer has written a TXPDO which was not yet
+read by pdokcal_readTxPdo().
+
+\param  channelId_p             Channel ID of PDO to check.
+
+\return The function returns TRUE if a new TXPDO is available.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+BOOL pdokcal_isTxPdoNew(UINT channelId_p)
+{
+    return (pPdoMem_l->txChannelInfo[channelId_p].info.newData != 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Discard new TXPDO
+
+The function discards a TXPDO which was written by the user layer but not yet
+read by pdokcal_readTxPdo(). The next call of pdokcal_readTxPdo() delivers the
+last read TXPDO again until the user layer writes a new one.
+
+\param  channelId_p             Channel ID of PDO to discard.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+void pdokcal_discardTxPdo(UINT channelId_p)
+{
+    pPdoMem_l->txChannelInfo[channelId_p].info.newData = 0;
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -270,7 +551,8 @@ tOplkError pdokcal_readTxPdo(UINT channelId_p, BYTE* pPayload_p, UINT16 pdoSize_
 \brief  Setup PDO memory info
 
 The function sets up the PDO memory info. For each channel the offset in the
-shared buffer and the size are stored.
+shared buffer and the size are stored. The channel buffers are aligned to cache
+lines, so the buffers of different channels never share a cache line.
 
 \param  pPdoChannels_p      Pointer to PDO channel setup.
 \param  pPdoMemRegion_p     Pointer to shared PDO memory region.
@@ -290,12 +572,18 @@ static void setupPdoMemInfo(tPdoChannelSetup* pPdoChannels_p, tPdoMemRegion* pPd
          channelId++, pPdoChannel++)
     {
         //TRACE ("RPDO %d at offset:%d\n", channelId, offset);
-        pPdoMemRegion_p->rxChannelInfo[channelId].channelOffset = offset;
-        pPdoMemRegion_p->rxChannelInfo[channelId].readBuf = 0;
-        pPdoMemRegion_p->rxChannelInfo[channelId].writeBuf = 1;
-        pPdoMemRegion_p->rxChannelInfo[channelId].cleanBuf = 2;
-        pPdoMemRegion_p->rxChannelInfo[channelId].newData = 0;
-        offset += pPdoChannel->pdoSize;
+        pPdoMemRegion_p->rxChannelInfo[channelId].info.channelOffset = offset;
+        pPdoMemRegion_p->rxChannelInfo[channelId].info.readBuf = 0;
+        pPdoMemRegion_p->rxChannelInfo[channelId].info.writeBuf = 1;
+        pPdoMemRegion_p->rxChannelInfo[channelId].info.cleanBuf = 2;
+        pPdoMemRegion_p->rxChannelInfo[channelId].info.newData = 0;
+        pPdoMemRegion_p->rxChannelInfo[channelId].info.sequence = 0;
+        OPLK_MEMSET(pPdoMemRegion_p->rxChannelInfo[channelId].info.aSequence, 0,
+                    sizeof(pPdoMemRegion_p->rxChannelInfo[channelId].info.aSequence));
+        // all readers start with the same buffer, it is not newer than the clean buffer
+        OPLK_MEMSET(pPdoMemRegion_p->rxChannelInfo[channelId].info.aReaderBuf, 0,
+                    sizeof(pPdoMemRegion_p->rxChannelInfo[channelId].info.aReaderBuf));
+        offset += PDO_ALIGN_CACHE_LINE(pPdoChannel->pdoSize);
     }
 
     for (channelId = 0, pPdoChannel = pPdoChannels_p->pTxPdoChannel;
@@ -303,14 +591,88 @@ static void setupPdoMemInfo(tPdoChannelSetup* pPdoChannels_p, tPdoMemRegion* pPd
          channelId++, pPdoChannel++)
     {
         //TRACE ("TPDO %d at offset:%d\n", channelId, offset);
-        pPdoMemRegion_p->txChannelInfo[channelId].channelOffset = offset;
-        pPdoMemRegion_p->txChannelInfo[channelId].readBuf = 0;
-        pPdoMemRegion_p->txChannelInfo[channelId].writeBuf = 1;
-        pPdoMemRegion_p->txChannelInfo[channelId].cleanBuf = 2;
-        pPdoMemRegion_p->txChannelInfo[channelId].newData = 0;
-        offset += pPdoChannel->pdoSize;
+        pPdoMemRegion_p->txChannelInfo[channelId].info.channelOffset = offset + PDO_TX_FRAME_HEADROOM;
+        pPdoMemRegion_p->txChannelInfo[channelId].info.readBuf = 0;
+        pPdoMemRegion_p->txChannelInfo[channelId].info.writeBuf = 1;
+        pPdoMemRegion_p->txChannelInfo[channelId].info.cleanBuf = 2;
+        pPdoMemRegion_p->txChannelInfo[channelId].info.newData = 0;
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+        aTxBufState_l[channelId].spareBuf = 3;
+        aTxBufState_l[channelId].frameBuf = PDOKCAL_TX_BUF_INVALID;
+#endif
+        offset += PDO_TX_BUFFER_SIZE(pPdoChannel->pdoSize);
     }
     pPdoMemRegion_p->pdoMemSize = offset;
+
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+    for (channelId = 0; channelId < 2; channelId++)
+    {
+        pPdoMemRegion_p->kernelPi.aImageInfo[channelId].info.readBuf = 0;
+        pPdoMemRegion_p->kernelPi.aImageInfo[channelId].info.writeBuf = 1;
+        pPdoMemRegion_p->kernelPi.aImageInfo[channelId].info.cleanBuf = 2;
+        pPdoMemRegion_p->kernelPi.aImageInfo[channelId].info.newData = 0;
+        pPdoMemRegion_p->kernelPi.aImageInfo[channelId].info.sequence = 0;
+    }
+    OPLK_MEMSET(pPdoMemRegion_p->kernelPi.aaaImage, 0, sizeof(pPdoMemRegion_p->kernelPi.aaaImage));
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get free RXPDO buffer
+
+The function searches a buffer of an RXPDO channel which is neither the latest
+buffer nor held by a reader. There is always one, because every reader holds
+only one buffer.
+
+\param  pInfo_p             Pointer to the control information of the channel.
+
+\return The function returns the index of the free buffer.
+*/
+//------------------------------------------------------------------------------
+static OPLK_ATOMIC_T getFreeRxBuffer(const tPdoBufferInfo* pInfo_p)
+{
+    UINT    usedMask;
+    UINT    readerId;
+    UINT    buffer;
+
+    usedMask = 1U << pInfo_p->cleanBuf;
+    for (readerId = 0; readerId < CONFIG_PDO_RX_READER_COUNT; readerId++)
+        usedMask |= 1U << pInfo_p->aReaderBuf[readerId];
+
+    for (buffer = 0; (usedMask & (1U << buffer)) != 0; buffer++)
+        ;
+
+    return (OPLK_ATOMIC_T)buffer;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Exchange TXPDO read buffer
+
+The function exchanges the read buffer of a TXPDO channel with the latest
+buffer written by the user layer. With CONFIG_PDO_TX_ZERO_COPY a read buffer
+which is still used by the last frame is kept as spare buffer, and the previous
+spare buffer is handed back to the user layer instead.
+
+\param  channelId_p         Channel ID of the TXPDO.
+*/
+//------------------------------------------------------------------------------
+static void exchangeTxReadBuffer(UINT channelId_p)
+{
+    tPdoBufferInfo*     pInfo = &pPdoMem_l->txChannelInfo[channelId_p].info;
+    OPLK_ATOMIC_T       readBuf;
+
+    readBuf = pInfo->readBuf;
+#if (CONFIG_PDO_TX_ZERO_COPY != FALSE)
+    if (readBuf == aTxBufState_l[channelId_p].frameBuf)
+    {
+        readBuf = aTxBufState_l[channelId_p].spareBuf;
+        aTxBufState_l[channelId_p].spareBuf = pInfo->readBuf;
+    }
+#endif
+    OPLK_ATOMIC_EXCHANGE(&pInfo->cleanBuf, readBuf, pInfo->readBuf);
+    pInfo->newData = 0;
 }
 ///\}
 
@@ -109,6 +109,16 @@ tOplkError pdokcal_init(void)
     if ((Ret = pdokcal_initSync()) != kErrorOk)
         return Ret;
 
+#if CONFIG_PDO_RX_WORKER != FALSE
+    if ((Ret = pdokcal_initRxWorker()) != kErrorOk)
+        return Ret;
+#endif
+
+#if CONFIG_PDO_RX_DMA != FALSE
+    if ((Ret = pdokcal_initRxDma()) != kErrorOk)
+        return Ret;
+#endif
+
     dllk_regRpdoHandler(cbProcessRpdo);
 
     return Ret;
@@ -127,6 +137,12 @@ The function de-initializes the PDO kernel CAL module.
 //------------------------------------------------------------------------------
 tOplkError pdokcal_exit(void)
 {
+#if CONFIG_PDO_RX_WORKER != FALSE
+    pdokcal_exitRxWorker();
+#endif
+#if CONFIG_PDO_RX_DMA != FALSE
+    pdokcal_exitRxDma();
+#endif
     pdokcal_exitSync();
     pdokcal_closeMem();
     return kErrorOk;
@@ -176,7 +192,8 @@ tOplkError pdokcal_process(tEvent* pEvent_p)
 
         case kEventTypePdoRx:
             {
-#if CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_SYNC != FALSE
+#if (CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_SYNC != FALSE) && (CONFIG_PDO_RX_DIRECT_COPY == FALSE) && \
+    (CONFIG_PDO_RX_WORKER == FALSE)
                 tFrameInfo*  pFrameInfo;
                 pFrameInfo = (tFrameInfo*)pEvent_p->pEventArg;
                 Ret = pdok_processRxPdo(pFrameInfo->pFrame, pFrameInfo->frameSize);
@@ -194,6 +211,18 @@ tOplkError pdokcal_process(tEvent* pEvent_p)
             Ret = pdokcal_controlSync(*((BOOL*)pEvent_p->pEventArg));
             break;
 
+        case kEventTypePdokAddRoute:
+            Ret = pdok_addRoute((tPdoRoute*)pEvent_p->pEventArg);
+            break;
+
+        case kEventTypePdokClearRoutes:
+            pdok_clearRoutes();
+            break;
+
+        case kEventTypePdokSetupKernelPi:
+            Ret = pdok_setupKernelPi((tPdoKernelPiSetup*)pEvent_p->pEventArg);
+            break;
+
         default:
             Ret = kErrorInvalidEvent;
             break;
@@ -216,6 +245,13 @@ It posts the frame to the event queue. It is called in states
 NMT_CS_READY_TO_OPERATE and NMT_CS_OPERATIONAL. The passed PDO needs not to be
 valid.
 
+If CONFIG_PDO_RX_DIRECT_COPY is enabled, the frame is not posted to the event
+queue. Instead, the PDO payload is copied directly from the Rx buffer into the
+PDO triple buffer. This avoids copying the whole frame into and out of the
+event queue. If CONFIG_PDO_RX_DMA is enabled, the copy is done by DMA and the
+function returns kErrorReject, so the DLL keeps the Rx buffer until the
+transfer is completed.
+
 \param  pFrameInfo_p            pointer to frame info structure
 
 \return The function returns a tOplkError error code.
@@ -224,8 +260,15 @@ valid.
 static tOplkError cbProcessRpdo(tFrameInfo* pFrameInfo_p)
 {
     tOplkError      ret = kErrorOk;
+#if (CONFIG_PDO_RX_DIRECT_COPY == FALSE) && (CONFIG_PDO_RX_WORKER == FALSE)
     tEvent          event;
+#endif
 
+#if CONFIG_PDO_RX_WORKER != FALSE
+    ret = pdokcal_postRxPdo(pFrameInfo_p->pFrame, pFrameInfo_p->frameSize);
+#elif CONFIG_PDO_RX_DIRECT_COPY != FALSE
+    ret = pdok_processRxPdo(pFrameInfo_p->pFrame, pFrameInfo_p->frameSize);
+#else
     event.eventSink = kEventSinkPdokCal;
     event.eventType = kEventTypePdoRx;
 #if CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_SYNC != FALSE
@@ -243,6 +286,7 @@ static tOplkError cbProcessRpdo(tFrameInfo* pFrameInfo_p)
     {
         ret = kErrorReject; // Reject release of rx buffer
     }
+#endif
 #endif
 
     return ret;
@@ -8,6 +8,12 @@ This file contains an implementation for the kernel PDO CAL module which uses
 the Linux kernel driver to provide its kernel memory to the user layer by
 the mmap device operation.
 
+The PDO buffers can be mapped cached, write-combining or uncached (see
+pdokcal_setMemCacheMode()). The page which contains the buffer control
+information is always cached, because the triple buffer indices are exchanged
+by atomic operations. The attributes of the kernel mapping are changed together
+with the user mapping, so that both use the same memory type.
+
 \ingroup module_pdokcal
 *******************************************************************************/
 
@@ -45,6 +51,15 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <kernel/pdokcal.h>
 
 #include <linux/slab.h>
+#include <linux/mm.h>
+#ifdef CONFIG_X86
+#include <linux/version.h>
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(4, 17, 0))
+#include <asm/set_memory.h>
+#else
+#include <asm/cacheflush.h>
+#endif
+#endif
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -78,10 +93,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
+static BYTE*                pPdoMem_l = NULL;       // allocated PDO memory
+static size_t               pdoMemSize_l = 0;       // size of the allocated PDO memory
+static tPdoMemCacheMode     cacheMode_l = kPdoMemCached;    // memory type of the PDO buffers
 
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
+static size_t getCachedSize(void);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -149,6 +168,10 @@ tOplkError pdokcal_allocateMem(size_t memSize_p, BYTE** ppPdoMem_p)
         return kErrorNoResource;
     }
     TRACE("%s() Allocated memory for PDO at %p size:%d/%d\n", __func__, *ppPdoMem_p, memSize_p, order);
+
+    pPdoMem_l = *ppPdoMem_p;
+    pdoMemSize_l = PAGE_SIZE << order;
+    cacheMode_l = kPdoMemCached;
     return kErrorOk;
 }
 
@@ -171,16 +194,126 @@ tOplkError pdokcal_freeMem(BYTE* pMem_p, size_t memSize_p)
 {
     ULONG         order;
 
+    if ((pMem_p == pPdoMem_l) && (cacheMode_l != kPdoMemCached))
+        pdokcal_setMemCacheMode(kPdoMemCached, NULL);
+
+    pPdoMem_l = NULL;
+    pdoMemSize_l = 0;
+
     order = get_order(memSize_p);
     free_pages((ULONG)pMem_p, order);
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Set memory type of the PDO buffers
+
+The function changes the memory type of the PDO buffers in the kernel mapping.
+The user mapping must use the same memory type for the buffers, i.e. the pages
+behind the returned cached size. Write-combining and uncached buffers are only
+supported on x86, because on other architectures the memory type of the kernel
+mapping cannot be changed. The memory type can only be changed while the PDO
+memory is cached, so all user mappings use the same type.
+
+\param  mode_p                  Memory type of the PDO buffers.
+\param  pCachedSize_p           Pointer to store the size at the start of the
+                                PDO memory which stays cached. May be NULL.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The memory type is set.
+\retval kErrorNoResource        No PDO memory is allocated or the memory type
+                                cannot be changed.
+\retval kErrorApiNotSupported   The memory type is not supported.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+tOplkError pdokcal_setMemCacheMode(tPdoMemCacheMode mode_p, size_t* pCachedSize_p)
+{
+    size_t      cachedSize;
+#ifdef CONFIG_X86
+    ULONG       address;
+    int         pageCount;
+    int         result;
+#endif
+
+    if (pPdoMem_l == NULL)
+        return kErrorNoResource;
+
+    cachedSize = getCachedSize();
+    if (pCachedSize_p != NULL)
+        *pCachedSize_p = cachedSize;
+
+    if (mode_p == cacheMode_l)
+        return kErrorOk;
+
+    if ((mode_p != kPdoMemCached) && (cacheMode_l != kPdoMemCached))
+        return kErrorNoResource;    // another user mapping uses a different type
+
+#ifdef CONFIG_X86
+    address = (ULONG)pPdoMem_l + cachedSize;
+    pageCount = (int)((pdoMemSize_l - cachedSize) >> PAGE_SHIFT);
+    if (pageCount == 0)
+    {
+        cacheMode_l = mode_p;
+        return kErrorOk;
+    }
+
+    switch (mode_p)
+    {
+        case kPdoMemWriteCombine:
+            result = set_memory_wc(address, pageCount);
+            break;
+
+        case kPdoMemUncached:
+            result = set_memory_uc(address, pageCount);
+            break;
+
+        default:
+            result = set_memory_wb(address, pageCount);
+            break;
+    }
+
+    if (result != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't set memory type %d (%d)\n", __func__, mode_p, result);
+        return kErrorNoResource;
+    }
+
+    cacheMode_l = mode_p;
+    return kErrorOk;
+#else
+    return kErrorApiNotSupported;
+#endif
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
 /// \name Private Functions
 /// \{
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get the cached part of the PDO memory
+
+The function returns the size of the pages at the start of the PDO memory which
+contain the buffer control information. They are always cached.
+
+\return The function returns the size of the cached part in bytes.
+*/
+//------------------------------------------------------------------------------
+static size_t getCachedSize(void)
+{
+    size_t      cachedSize;
+
+    cachedSize = PAGE_ALIGN(PDO_ALIGN_CACHE_LINE(sizeof(tPdoMemRegion)));
+    if (cachedSize > pdoMemSize_l)
+        cachedSize = pdoMemSize_l;
+
+    return cachedSize;
+}
+
 ///\}
 
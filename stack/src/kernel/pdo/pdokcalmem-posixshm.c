@@ -46,9 +46,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/vfs.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/types.h>
+#include <errno.h>
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -83,10 +85,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // local vars
 //------------------------------------------------------------------------------
 static int                  fd_l;
+static BOOL                 fHugePages_l;
 
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
+static size_t getMapSize(size_t memSize_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -100,6 +104,8 @@ The function performs all actions needed to setup the shared memory at
 the start of the stack.
 
 For the Posix shared-memory implementation it opens the shared memory segment.
+If CONFIG_PDO_SHM_HUGETLBFS_PATH is set, the segment is created on this
+hugetlbfs mount instead. If this fails, Posix shared memory is used.
 
 \return The function returns a tOplkError error code.
 
@@ -108,6 +114,21 @@ For the Posix shared-memory implementation it opens the shared memory segment.
 //------------------------------------------------------------------------------
 tOplkError pdokcal_openMem(void)
 {
+    fHugePages_l = FALSE;
+
+    if (CONFIG_PDO_SHM_HUGETLBFS_PATH[0] != '\0')
+    {
+        fd_l = open(CONFIG_PDO_SHM_HUGETLBFS_PATH PDO_SHMEM_NAME, O_RDWR | O_CREAT, 0600);
+        if (fd_l != -1)
+        {
+            fHugePages_l = TRUE;
+            return kErrorOk;
+        }
+
+        DEBUG_LVL_ERROR_TRACE("%s() Unable to create PDO memory on %s (%s), using shared memory\n",
+                              __func__, CONFIG_PDO_SHM_HUGETLBFS_PATH, strerror(errno));
+    }
+
     if ((fd_l = shm_open(PDO_SHMEM_NAME, O_RDWR | O_CREAT, 0)) == -1)
     {
         return kErrorNoResource;
@@ -131,7 +152,15 @@ For the Posix shared-memory implementation it unlinks the shared memory segment.
 //------------------------------------------------------------------------------
 tOplkError pdokcal_closeMem(void)
 {
-    shm_unlink(PDO_SHMEM_NAME);
+    if (fHugePages_l)
+    {
+        close(fd_l);
+        unlink(CONFIG_PDO_SHM_HUGETLBFS_PATH PDO_SHMEM_NAME);
+    }
+    else
+    {
+        shm_unlink(PDO_SHMEM_NAME);
+    }
     return kErrorOk;
 }
 
@@ -140,6 +169,7 @@ tOplkError pdokcal_closeMem(void)
 \brief  Allocate PDO shared memory
 
 The function allocates shared memory for the kernel needed to transfer the PDOs.
+If CONFIG_PDO_SHM_LOCK is TRUE, the memory is locked into RAM.
 
 \param  memSize_p               Size of PDO memory
 \param  ppPdoMem_p              Pointer to store the PDO memory pointer.
@@ -151,11 +181,14 @@ The function allocates shared memory for the kernel needed to transfer the PDOs.
 //------------------------------------------------------------------------------
 tOplkError pdokcal_allocateMem(size_t memSize_p, BYTE** ppPdoMem_p)
 {
+    size_t          mapSize;
+
     TRACE ("%s()\n", __func__);
-    if (ftruncate(fd_l, memSize_p) < 0)
+    mapSize = getMapSize(memSize_p);
+    if (ftruncate(fd_l, mapSize) < 0)
         return kErrorNoResource;
 
-    *ppPdoMem_p = mmap(NULL, memSize_p, PROT_READ | PROT_WRITE, MAP_SHARED, fd_l, 0);
+    *ppPdoMem_p = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd_l, 0);
     if (*ppPdoMem_p == MAP_FAILED)
     {
         TRACE ("%s() mmap failed!}n", __func__);
@@ -163,6 +196,11 @@ tOplkError pdokcal_allocateMem(size_t memSize_p, BYTE** ppPdoMem_p)
         return kErrorNoResource;
     }
 
+    if (CONFIG_PDO_SHM_LOCK && (mlock(*ppPdoMem_p, mapSize) != 0))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Unable to lock PDO memory (%s)\n", __func__, strerror(errno));
+    }
+
     TRACE ("%s() Allocated memory for PDO at %p size:%d\n", __func__, *ppPdoMem_p, memSize_p);
     return kErrorOk;
 }
@@ -186,7 +224,7 @@ tOplkError pdokcal_freeMem(BYTE* pMem_p, size_t memSize_p)
 {
     TRACE ("%s()\n", __func__);
 
-    if (munmap(pMem_p, memSize_p) != 0)
+    if (munmap(pMem_p, getMapSize(memSize_p)) != 0)
     {
         TRACE("%s() munmap failed!\n", __func__);
         return kErrorGeneralError;
@@ -200,5 +238,29 @@ tOplkError pdokcal_freeMem(BYTE* pMem_p, size_t memSize_p)
 /// \name Private Functions
 /// \{
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get size of PDO memory mapping
+
+The function returns the size of the mapping for the PDO memory. Memory on a
+hugetlbfs mount can only be mapped in multiples of the huge page size.
+
+\param  memSize_p               Size of PDO memory
+
+\return The function returns the size of the mapping.
+*/
+//------------------------------------------------------------------------------
+static size_t getMapSize(size_t memSize_p)
+{
+    struct statfs   fsInfo;
+    size_t          pageSize;
+
+    if (!fHugePages_l || (fstatfs(fd_l, &fsInfo) != 0) || (fsInfo.f_bsize <= 0))
+        return memSize_p;
+
+    pageSize = (size_t)fsInfo.f_bsize;
+    return ((memSize_p + pageSize - 1) / pageSize) * pageSize;
+}
+
 ///\}
 
@@ -0,0 +1,310 @@
+/**
+********************************************************************************
+\file   pdokcalrx-linux.c
+
+\brief  RPDO worker of the kernel PDO CAL module for Linux userspace
+
+This file implements an RPDO worker thread for the Linux userspace platform.
+The DLL receive path only copies the received PRes/PReq frames into a
+single-producer/single-consumer queue. The worker thread decodes the RPDOs
+and writes them into the PDO triple buffers. This keeps the receive path short
+if many RPDOs have to be processed per cycle. The worker is enabled with
+CONFIG_PDO_RX_WORKER.
+
+\ingroup module_pdokcal
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <kernel/pdokcal.h>
+#include <kernel/pdok.h>
+#include <common/ami.h>
+#include <common/target.h>
+
+#if (CONFIG_PDO_RX_WORKER != FALSE)
+
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#ifndef CONFIG_THREAD_PRIORITY_PDO_RX
+#define CONFIG_THREAD_PRIORITY_PDO_RX       60
+#endif
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define PDOKCAL_RX_QUEUE_MASK           (CONFIG_PDO_RX_WORKER_QUEUE_SIZE - 1)
+
+// The semaphore is posted to stop the worker, so the timeout only limits the
+// time the worker sleeps while no RPDOs are received.
+#define PDOKCAL_RX_IDLE_TIMEOUT_MS      1000
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief RPDO queue entry
+
+The structure contains a received frame which is queued for the RPDO worker.
+*/
+typedef struct
+{
+    UINT                frameSize;                      ///< Size of the queued frame data
+    BYTE                aFrame[C_IP_MAX_MTU];           ///< Frame data up to the end of the PDO payload
+} tPdokCalRxEntry;
+
+/**
+\brief RPDO worker instance
+
+The structure contains the instance variables of the RPDO worker. The write
+index is only modified by the receive path, the read index only by the
+worker thread.
+*/
+typedef struct
+{
+    pthread_t           threadId;                       ///< ID of the worker thread
+    sem_t               semRxData;                      ///< Semaphore to wake up the worker thread
+    volatile BOOL       fStopThread;                    ///< Flag to stop the worker thread
+    BOOL                fInitialized;                   ///< Flag determines if the worker is initialized
+    volatile UINT       writeIndex;                     ///< Index of the next entry to be written
+    volatile UINT       readIndex;                      ///< Index of the next entry to be read
+    UINT                overflowCount;                  ///< Number of frames dropped because the queue was full
+    tPdokCalRxEntry     aEntry[CONFIG_PDO_RX_WORKER_QUEUE_SIZE];    ///< Queue entries
+} tPdokCalRxInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tPdokCalRxInstance   instance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void* rxWorkerThread(void* pArg_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize RPDO worker
+
+The function initializes the RPDO queue and starts the RPDO worker thread.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+tOplkError pdokcal_initRxWorker(void)
+{
+    OPLK_MEMSET(&instance_l, 0, sizeof(tPdokCalRxInstance));
+
+    if (sem_init(&instance_l.semRxData, 0, 0) != 0)
+        return kErrorNoResource;
+
+    instance_l.fStopThread = FALSE;
+    if (target_createThread(&instance_l.threadId, kThreadRolePdoRx, "oplk-pdorx",
+                            rxWorkerThread, (void*)&instance_l) != kErrorOk)
+    {
+        sem_destroy(&instance_l.semRxData);
+        return kErrorNoResource;
+    }
+
+    if (target_setThreadParams(instance_l.threadId, kThreadRolePdoRx, kThreadSchedFifo,
+                               CONFIG_THREAD_PRIORITY_PDO_RX,
+                               CONFIG_THREAD_CPU_MASK_PDO_RX) != kErrorOk)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s(): couldn't set thread scheduling parameters! %d\n",
+                              __func__, CONFIG_THREAD_PRIORITY_PDO_RX);
+    }
+
+    instance_l.fInitialized = TRUE;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Clean up RPDO worker
+
+The function stops the RPDO worker thread.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+void pdokcal_exitRxWorker(void)
+{
+    if (!instance_l.fInitialized)
+        return;
+
+    instance_l.fStopThread = TRUE;
+    sem_post(&instance_l.semRxData);
+    pthread_join(instance_l.threadId, NULL);
+    sem_destroy(&instance_l.semRxData);
+
+    if (instance_l.overflowCount != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() %u RPDO frames were dropped\n", __func__,
+                              instance_l.overflowCount);
+    }
+
+    instance_l.fInitialized = FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Post received RPDO frame to the worker
+
+The function copies a received PRes or PReq frame up to the end of its PDO
+payload into the RPDO queue and wakes up the worker thread. It must only be
+called by the DLL receive path. If the queue is full, the frame is dropped.
+
+\param  pFrame_p                Pointer to the received frame.
+\param  frameSize_p             Size of the received frame.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+tOplkError pdokcal_postRxPdo(tPlkFrame* pFrame_p, UINT frameSize_p)
+{
+    tPdokCalRxEntry*    pEntry;
+    UINT                writeIndex = instance_l.writeIndex;
+    UINT                copySize;
+
+    if ((writeIndex - instance_l.readIndex) >= CONFIG_PDO_RX_WORKER_QUEUE_SIZE)
+    {
+        instance_l.overflowCount++;
+        return kErrorOk;
+    }
+
+    // limit copied data to size of PDO (because from some CNs the frame is larger than necessary)
+    copySize = ami_getUint16Le(&pFrame_p->data.pres.sizeLe) + PLK_FRAME_OFFSET_PDO_PAYLOAD;
+    if (copySize > frameSize_p)
+        copySize = frameSize_p;
+    if (copySize > sizeof(pEntry->aFrame))
+        copySize = sizeof(pEntry->aFrame);
+
+    pEntry = &instance_l.aEntry[writeIndex & PDOKCAL_RX_QUEUE_MASK];
+    OPLK_MEMCPY(pEntry->aFrame, pFrame_p, copySize);
+    pEntry->frameSize = copySize;
+
+    // Publish the entry after its data is completely written
+    OPLK_MEMBAR();
+    instance_l.writeIndex = writeIndex + 1;
+
+    // The worker drains the queue, so it only has to be woken up for the first entry
+    if (writeIndex == instance_l.readIndex)
+        sem_post(&instance_l.semRxData);
+
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  RPDO worker thread
+
+The function contains the main loop of the RPDO worker thread. It processes
+the queued frames until the queue is empty and waits until it is signaled by
+the receive path again.
+
+\param  pArg_p                  Pointer to the worker instance.
+
+\return The function returns the thread exit code.
+*/
+//------------------------------------------------------------------------------
+static void* rxWorkerThread(void* pArg_p)
+{
+    tPdokCalRxInstance* pInstance = (tPdokCalRxInstance*)pArg_p;
+    tPdokCalRxEntry*    pEntry;
+    UINT                readIndex;
+    struct timespec     curTime, timeout;
+
+    while (!pInstance->fStopThread)
+    {
+        readIndex = pInstance->readIndex;
+        if (readIndex == pInstance->writeIndex)
+        {
+            clock_gettime(CLOCK_REALTIME, &curTime);
+            timeout.tv_sec = PDOKCAL_RX_IDLE_TIMEOUT_MS / 1000;
+            timeout.tv_nsec = (PDOKCAL_RX_IDLE_TIMEOUT_MS % 1000) * 1000000;
+            TIMESPECADD(&timeout, &curTime);
+
+            sem_timedwait(&pInstance->semRxData, &timeout);
+            continue;
+        }
+
+        // Read the entry after its publication
+        OPLK_MEMBAR();
+        pEntry = &pInstance->aEntry[readIndex & PDOKCAL_RX_QUEUE_MASK];
+        pdok_processRxPdo((tPlkFrame*)pEntry->aFrame, pEntry->frameSize);
+
+        // Release the entry after its data is completely processed
+        OPLK_MEMBAR();
+        pInstance->readIndex = readIndex + 1;
+    }
+
+    return NULL;
+}
+
+/// \}
+
+#endif // CONFIG_PDO_RX_WORKER != FALSE
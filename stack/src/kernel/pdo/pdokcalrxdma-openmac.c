@@ -0,0 +1,284 @@
+/**
+********************************************************************************
+\file   pdokcalrxdma-openmac.c
+
+\brief  RPDO DMA of the kernel PDO CAL module for openMAC designs
+
+This file copies the RPDO payload of received frames by the memory-to-memory
+DMA of an openMAC FPGA design into the PDO triple buffer. The DLL receive path
+only queues the transfer and keeps the Rx buffer of the frame. The DMA
+completion callback publishes the triple buffer and releases the Rx buffer, so
+the PCP doesn't copy any PDO data. If the design provides no DMA, the RPDOs are
+copied by the CPU. The DMA is enabled with CONFIG_PDO_RX_DMA.
+
+\ingroup module_pdokcal
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <kernel/pdokcal.h>
+#include <kernel/dllk.h>
+
+#if (CONFIG_PDO_RX_DMA != FALSE)
+
+#include <target/openmac.h>
+
+#if (CONFIG_PDO_RX_DIRECT_COPY == FALSE) || (CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_SYNC == FALSE)
+#error "CONFIG_PDO_RX_DMA requires CONFIG_PDO_RX_DIRECT_COPY and CONFIG_DLL_DEFERRED_RXFRAME_RELEASE_SYNC!"
+#endif
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define PDOKCAL_RX_DMA_EXIT_TIMEOUT     100000      ///< Loops to wait for pending transfers on exit
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief RPDO DMA transfer
+
+The structure describes a pending RPDO transfer. It is owned by the receive
+path while fPending is FALSE and by the DMA completion callback otherwise.
+*/
+typedef struct
+{
+    volatile BOOL       fPending;                       ///< Transfer is queued at the DMA
+    UINT                channelId;                      ///< RPDO channel of the transfer
+    tPlkFrame*          pFrame;                         ///< Frame in the Rx buffer
+    UINT                frameSize;                      ///< Size of the frame
+} tPdokCalRxDmaTransfer;
+
+/**
+\brief RPDO DMA instance
+*/
+typedef struct
+{
+    BOOL                    fDmaAvailable;              ///< The design provides a DMA
+    UINT                    skipCount;                  ///< Number of RPDOs skipped because the channel was still transferred
+    tPdokCalRxDmaTransfer   aTransfer[CONFIG_PDO_RX_DMA_TRANSFERS];  ///< Transfers
+} tPdokCalRxDmaInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tPdokCalRxDmaInstance    instance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void cbDmaDone(void* pArg_p, void* pDst_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize RPDO DMA
+
+The function opens the DMA of the design. If the design provides no DMA, the
+RPDOs are copied by the CPU.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+tOplkError pdokcal_initRxDma(void)
+{
+    OPLK_MEMSET(&instance_l, 0, sizeof(instance_l));
+
+    if (openmac_dmaInit() == kErrorOk)
+        instance_l.fDmaAvailable = TRUE;
+    else
+    {
+        DEBUG_LVL_PDO_TRACE("%s() No DMA available, RPDOs are copied by the CPU\n", __func__);
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Clean up RPDO DMA
+
+The function waits for the pending transfers and closes the DMA.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+void pdokcal_exitRxDma(void)
+{
+    UINT    i;
+    UINT    timeout;
+
+    if (!instance_l.fDmaAvailable)
+        return;
+
+    for (i = 0; i < CONFIG_PDO_RX_DMA_TRANSFERS; i++)
+    {
+        for (timeout = 0; instance_l.aTransfer[i].fPending &&
+                          (timeout < PDOKCAL_RX_DMA_EXIT_TIMEOUT); timeout++)
+            ;
+    }
+
+    openmac_dmaExit();
+    instance_l.fDmaAvailable = FALSE;
+
+    if (instance_l.skipCount != 0)
+    {
+        DEBUG_LVL_PDO_TRACE("%s() %d RPDOs skipped\n", __func__, instance_l.skipCount);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy RPDO by DMA
+
+The function queues the transfer of an RPDO payload from the Rx buffer into the
+write buffer of the PDO triple buffer. It is called in the context of the DLL
+frame receive handler. The triple buffer is published and the Rx buffer is
+released by the completion callback. If the previous RPDO of the channel is
+still transferred, the RPDO is skipped, because it would be written into the
+same write buffer. If no DMA transfer can be queued, the RPDO is copied by the
+CPU.
+
+\param  channelId_p             Channel ID of the RPDO.
+\param  pFrame_p                Received frame in the Rx buffer.
+\param  frameSize_p             Size of the frame.
+\param  pdoSize_p               Size of the RPDO payload.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The RPDO is copied or skipped, the Rx buffer can
+                                be released.
+\retval kErrorReject            The transfer is queued, the Rx buffer is released
+                                after the transfer.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+tOplkError pdokcal_copyRxPdoDma(UINT channelId_p, tPlkFrame* pFrame_p, UINT frameSize_p,
+                                UINT16 pdoSize_p)
+{
+    tPdokCalRxDmaTransfer*  pTransfer = NULL;
+    UINT                    i;
+
+    if (!instance_l.fDmaAvailable)
+        return pdokcal_writeRxPdo(channelId_p, &pFrame_p->data.pres.aPayload[0], pdoSize_p);
+
+    for (i = 0; i < CONFIG_PDO_RX_DMA_TRANSFERS; i++)
+    {
+        if (instance_l.aTransfer[i].fPending)
+        {
+            if (instance_l.aTransfer[i].channelId == channelId_p)
+            {
+                instance_l.skipCount++;
+                return kErrorOk;
+            }
+        }
+        else if (pTransfer == NULL)
+        {
+            pTransfer = &instance_l.aTransfer[i];
+        }
+    }
+
+    if (pTransfer != NULL)
+    {
+        pTransfer->channelId = channelId_p;
+        pTransfer->pFrame = pFrame_p;
+        pTransfer->frameSize = frameSize_p;
+        pTransfer->fPending = TRUE;
+
+        if (openmac_dmaCopy(pdokcal_getRxPdoWriteBuffer(channelId_p),
+                            &pFrame_p->data.pres.aPayload[0], pdoSize_p,
+                            cbDmaDone, pTransfer) == kErrorOk)
+            return kErrorReject;
+
+        pTransfer->fPending = FALSE;
+    }
+
+    return pdokcal_writeRxPdo(channelId_p, &pFrame_p->data.pres.aPayload[0], pdoSize_p);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  DMA completion callback
+
+The function is called in interrupt context when an RPDO transfer is completed.
+It publishes the triple buffer of the channel and releases the Rx buffer.
+
+\param  pArg_p                  Completed transfer.
+\param  pDst_p                  Destination address of the transfer.
+*/
+//------------------------------------------------------------------------------
+static void cbDmaDone(void* pArg_p, void* pDst_p)
+{
+    tPdokCalRxDmaTransfer*  pTransfer = (tPdokCalRxDmaTransfer*)pArg_p;
+
+    UNUSED_PARAMETER(pDst_p);
+
+    pdokcal_commitRxPdo(pTransfer->channelId);
+    dllk_releaseRxFrame(pTransfer->pFrame, pTransfer->frameSize);
+    pTransfer->fPending = FALSE;
+}
+
+/// \}
+
+#endif // CONFIG_PDO_RX_DMA != FALSE
@@ -0,0 +1,226 @@
+/**
+********************************************************************************
+\file   pdokcalsync-futex.c
+
+\brief  PDO CAL kernel sync module using a futex in shared memory
+
+This file contains an implementation for the kernel PDO CAL sync module which
+uses a futex in POSIX shared memory for synchronisation with the user layer in
+another process.
+
+The sync module is responsible to notify the user layer that new PDO data
+can be transfered. Together with the notification the cycle counter and the
+time stamp of the sync event are stored in the shared memory. The futex is
+only woken if a user thread sleeps on it, a user thread which spins on the
+futex word gets the event without a system call.
+
+\ingroup module_pdokcal
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <common/pdo.h>
+#include <kernel/pdokcal.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#include <time.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tPdoSyncShm*     pSyncShm_l = NULL;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize kernel PDO CAL sync module
+
+The function initializes the kernel PDO CAL sync module. It creates the shared
+memory of the futex or attaches to it if the user layer already created it.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+tOplkError pdokcal_initSync(void)
+{
+    int         fd;
+    void*       pMem;
+
+    if ((fd = shm_open(PDO_SYNC_SHMEM_NAME, O_RDWR | O_CREAT, S_IRWXU | S_IRWXG)) < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() shm_open failed!\n", __func__);
+        return kErrorNoResource;
+    }
+
+    if (ftruncate(fd, sizeof(tPdoSyncShm)) == -1)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() ftruncate failed!\n", __func__);
+        close(fd);
+        return kErrorNoResource;
+    }
+
+    pMem = mmap(NULL, sizeof(tPdoSyncShm), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (pMem == MAP_FAILED)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() mmap failed!\n", __func__);
+        return kErrorNoResource;
+    }
+
+    pSyncShm_l = (tPdoSyncShm*)pMem;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Clean up PDO CAL sync module
+
+The function cleans up the PDO CAL sync module.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+void pdokcal_exitSync(void)
+{
+    if (pSyncShm_l != NULL)
+    {
+        munmap(pSyncShm_l, sizeof(tPdoSyncShm));
+        pSyncShm_l = NULL;
+    }
+    shm_unlink(PDO_SYNC_SHMEM_NAME);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send a sync event
+
+The function stores the cycle information of the sync event in the shared
+memory and increments the futex word. The futex is only woken if the user layer
+sleeps on it.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+tOplkError pdokcal_sendSyncEvent(void)
+{
+    struct timespec     curTime;
+
+    if (pSyncShm_l == NULL)
+        return kErrorOk;
+
+    clock_gettime(CLOCK_MONOTONIC, &curTime);
+
+    pSyncShm_l->sequence++;
+    OPLK_MEMBAR();
+    pSyncShm_l->cycleCount++;
+    pSyncShm_l->timeStamp = ((UINT64)curTime.tv_sec * 1000000000ULL) + (UINT64)curTime.tv_nsec;
+    OPLK_MEMBAR();
+    pSyncShm_l->sequence++;
+
+    // The full barrier of the increment orders it before reading the waiter
+    // count, a waiter registered later sees the new value and doesn't sleep.
+    __sync_fetch_and_add(&pSyncShm_l->syncCount, 1);
+    if (pSyncShm_l->waiterCount != 0)
+        syscall(SYS_futex, &pSyncShm_l->syncCount, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Enable sync events
+
+The function enables sync events.
+
+\param  fEnable_p               enable/disable sync event
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdokcal
+*/
+//------------------------------------------------------------------------------
+tOplkError pdokcal_controlSync(BOOL fEnable_p)
+{
+    UNUSED_PARAMETER(fEnable_p);
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
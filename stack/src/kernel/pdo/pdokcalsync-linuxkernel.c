@@ -8,7 +8,10 @@ This file contains an implementation for the kernel PDO CAL sync module which
 uses the openPOWERLINK Linux kernel driver interface.
 
 The sync module is responsible to notify the user layer that new PDO data
-can be transfered.
+can be transfered. The user layer registers an eventfd which is signaled on
+every sync event, so the sync can be waited for with poll() or epoll together
+with other file descriptors. The cycle counter and the time stamp of the last
+sync event are provided in a page which is mapped by the user layer.
 
 \ingroup module_pdokcal
 *******************************************************************************/
@@ -45,10 +48,18 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 #include <oplk/oplkinc.h>
 #include <common/pdo.h>
+#include <kernel/pdokcal.h>
+#include <oplk/powerlink-module.h>
 
 #include <linux/slab.h>
 #include <linux/sched.h>
 #include <linux/wait.h>
+#include <linux/eventfd.h>
+#include <linux/spinlock.h>
+#include <linux/ktime.h>
+#include <linux/version.h>
+#include <linux/gfp.h>
+#include <linux/err.h>
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -80,8 +91,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 typedef struct
 {
-    wait_queue_head_t       syncWaitQueue;
-    BOOL                    fSync;
+    struct eventfd_ctx*     pEventFd;       ///< eventfd registered by the user layer
+    spinlock_t              lock;           ///< Protects the eventfd and the sync information
+    tPdoSyncInfoMem*        pSyncInfo;      ///< Sync information page mapped by the user layer
     BOOL                    fInitialized;
 } tPdokCalSyncInstance;
 
@@ -113,7 +125,11 @@ tOplkError pdokcal_initSync(void)
 {
     OPLK_MEMSET(&instance_l, 0, sizeof(tPdokCalSyncInstance));
 
-    init_waitqueue_head(&instance_l.syncWaitQueue);
+    spin_lock_init(&instance_l.lock);
+    instance_l.pSyncInfo = (tPdoSyncInfoMem*)get_zeroed_page(GFP_KERNEL);
+    if (instance_l.pSyncInfo == NULL)
+        return kErrorNoResource;
+
     instance_l.fInitialized = TRUE;
 
     return kErrorOk;
@@ -131,6 +147,13 @@ The function cleans up the PDO CAL sync module
 void pdokcal_exitSync(void)
 {
     instance_l.fInitialized = FALSE;
+    pdokcal_setSyncEventFd(-1);
+
+    if (instance_l.pSyncInfo != NULL)
+    {
+        free_page((ULONG)instance_l.pSyncInfo);
+        instance_l.pSyncInfo = NULL;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -146,60 +169,108 @@ The function sends a sync event
 //------------------------------------------------------------------------------
 tOplkError pdokcal_sendSyncEvent(void)
 {
-    if (instance_l.fInitialized)
+    ULONG       flags;
+
+    if (!instance_l.fInitialized)
+        return kErrorOk;
+
+    spin_lock_irqsave(&instance_l.lock, flags);
+
+    instance_l.pSyncInfo->sequence++;
+    smp_wmb();
+    instance_l.pSyncInfo->cycleCount++;
+    instance_l.pSyncInfo->timeStamp = ktime_to_ns(ktime_get());
+    smp_wmb();
+    instance_l.pSyncInfo->sequence++;
+
+    if (instance_l.pEventFd != NULL)
     {
-        instance_l.fSync = TRUE;
-        wake_up_interruptible(&instance_l.syncWaitQueue);
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(6, 8, 0))
+        eventfd_signal(instance_l.pEventFd);
+#else
+        eventfd_signal(instance_l.pEventFd, 1);
+#endif
     }
+
+    spin_unlock_irqrestore(&instance_l.lock, flags);
+
     return kErrorOk;
 }
 
 //------------------------------------------------------------------------------
 /**
-\brief  Wait for a sync event
+\brief  Enable sync events
+
+The function enables sync events
 
-The function waits for a sync event
+\param  fEnable_p               enable/disable sync event
 
 \return The function returns a tOplkError error code.
 
 \ingroup module_pdokcal
 */
 //------------------------------------------------------------------------------
-tOplkError pdokcal_waitSyncEvent(void)
+tOplkError pdokcal_controlSync(BOOL fEnable_p)
 {
-    int                 ret;
-    int                 timeout = 1000 * HZ / 1000;
+    UNUSED_PARAMETER(fEnable_p);
+    return kErrorOk;
+}
 
-    if (!instance_l.fInitialized)
-        return kErrorNoResource;
+//------------------------------------------------------------------------------
+/**
+\brief  Register the sync eventfd
 
-    ret = wait_event_interruptible_timeout(instance_l.syncWaitQueue,
-                                           instance_l.fSync == TRUE, timeout);
-    if (ret == 0)
-        return kErrorRetry;
+The function registers the eventfd of the user layer which is signaled on every
+sync event. A previously registered eventfd is released.
 
-    instance_l.fSync = FALSE;
-    return kErrorOk;
-}
+\param  eventFd_p               File descriptor of the eventfd in the calling
+                                process. If -1 the eventfd is unregistered.
 
+\return The function returns Linux error code.
 
+\ingroup module_pdokcal
+*/
 //------------------------------------------------------------------------------
-/**
-\brief  Enable sync events
+int pdokcal_setSyncEventFd(int eventFd_p)
+{
+    struct eventfd_ctx*     pNewEventFd = NULL;
+    struct eventfd_ctx*     pOldEventFd;
+    ULONG                   flags;
 
-The function enables sync events
+    if (eventFd_p >= 0)
+    {
+        pNewEventFd = eventfd_ctx_fdget(eventFd_p);
+        if (IS_ERR(pNewEventFd))
+            return PTR_ERR(pNewEventFd);
+    }
 
-\param  fEnable_p               enable/disable sync event
+    spin_lock_irqsave(&instance_l.lock, flags);
+    pOldEventFd = instance_l.pEventFd;
+    instance_l.pEventFd = pNewEventFd;
+    spin_unlock_irqrestore(&instance_l.lock, flags);
 
-\return The function returns a tOplkError error code.
+    if (pOldEventFd != NULL)
+        eventfd_ctx_put(pOldEventFd);
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the sync information page
+
+The function returns the page containing the sync information
+(\ref tPdoSyncInfoMem) which is mapped into the user layer.
+
+\return The function returns the address of the page or NULL if the module is
+        not initialized.
 
 \ingroup module_pdokcal
 */
 //------------------------------------------------------------------------------
-tOplkError pdokcal_controlSync(BOOL fEnable_p)
+BYTE* pdokcal_getSyncInfoMem(void)
 {
-    UNUSED_PARAMETER(fEnable_p);
-    return kErrorOk;
+    return (BYTE*)instance_l.pSyncInfo;
 }
 
 //============================================================================//
@@ -48,8 +48,17 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/benchmark.h>
 
 #include <linux/module.h>
+#include <linux/moduleparam.h>
 #include <linux/kernel.h>
+#include <linux/version.h>
 #include <linux/hrtimer.h>
+#include <linux/smp.h>
+#include <linux/irqflags.h>
+#include <linux/hardirq.h>
+#ifdef CONFIG_DEBUG_FS
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#endif
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -64,6 +73,24 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define PROVE_OVERRUN
 
+#ifndef CONFIG_HRESTIMER_CPU
+#define CONFIG_HRESTIMER_CPU        -1      // CPU the timers are pinned to (-1 = not pinned)
+#endif
+
+#ifndef CONFIG_HRESTIMER_IRQ_MODE
+#define CONFIG_HRESTIMER_IRQ_MODE   HRESTIMER_IRQ_MODE_HARD // IRQ mode of the timer callbacks
+#endif
+
+// IRQ modes of the timer callbacks
+#define HRESTIMER_IRQ_MODE_DEFAULT  0       // kernel default (softirq thread on PREEMPT_RT)
+#define HRESTIMER_IRQ_MODE_HARD     1       // hard IRQ context also on PREEMPT_RT
+#define HRESTIMER_IRQ_MODE_SOFT     2       // softirq context
+
+// the hard/soft mode flags are available since kernel 5.4
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,4,0)
+#define HRESTIMER_HAVE_IRQ_MODE
+#endif
+
 #ifndef CONFIG_HIGH_RES_TIMERS
 #error "Kernel symbol CONFIG_HIGH_RES_TIMERS is required."
 #endif
@@ -121,6 +148,11 @@ typedef struct
     struct hrtimer       timer;             ///< hrtimer structure of the timer
     BOOL                 fContinuously;     ///< Determines if it is a continuous or one-shot timer
     ULONGLONG            period;            ///< The timer period
+    ULONGLONG            relTimeout;        ///< Relative timeout of the next timer start [ns]
+    ULONG                expiryCount;       ///< Number of timer expiries
+    ULONGLONG            latencySum;        ///< Sum of the expiry latencies [ns]
+    ULONG                minLatency;        ///< Minimum expiry latency [ns]
+    ULONG                maxLatency;        ///< Maximum expiry latency [ns]
 } tHresTimerInfo;
 
 /**
@@ -131,6 +163,10 @@ The structure defines a high-resolution timer module instance.
 typedef struct
 {
     tHresTimerInfo      aTimerInfo[TIMER_COUNT];    ///< Array with timer information for a set of timers
+    enum hrtimer_mode   mode;                       ///< Mode flags (pinned, hard/soft) of the timers
+#ifdef CONFIG_DEBUG_FS
+    struct dentry*      pDebugfsFile;               ///< Debugfs file of the latency statistics
+#endif
 } tHresTimerInstance;
 
 //------------------------------------------------------------------------------
@@ -138,10 +174,33 @@ typedef struct
 //------------------------------------------------------------------------------
 static tHresTimerInstance    hresTimerInstance_l;
 
+static int  hrtimerCpu_l = CONFIG_HRESTIMER_CPU;
+static int  hrtimerIrqMode_l = CONFIG_HRESTIMER_IRQ_MODE;
+
+module_param_named(hrtimerCpu, hrtimerCpu_l, int, 0444);
+MODULE_PARM_DESC(hrtimerCpu, "CPU the POWERLINK high-resolution timers are pinned to (-1 = not pinned)");
+module_param_named(hrtimerIrqMode, hrtimerIrqMode_l, int, 0444);
+MODULE_PARM_DESC(hrtimerIrqMode, "IRQ mode of the high-resolution timers (0 = default, 1 = hard IRQ, 2 = softirq)");
+
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
 enum hrtimer_restart timerCallback(struct hrtimer* pTimer_p);
+static void startTimer(tHresTimerInfo* pTimerInfo_p, ULONGLONG time_p);
+static void startTimerOnCpu(void* pInfo_p);
+#ifdef CONFIG_DEBUG_FS
+static int  showLatency(struct seq_file* pSeqFile_p, void* pData_p);
+static int  openLatency(struct inode* pInode_p, struct file* pFile_p);
+
+static const struct file_operations latencyFileOps_l =
+{
+    .owner   = THIS_MODULE,
+    .open    = openLatency,
+    .read    = seq_read,
+    .llseek  = seq_lseek,
+    .release = single_release,
+};
+#endif
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -167,7 +226,10 @@ tOplkError hrestimer_init(void)
 /**
 \brief    Add instance of high-resolution timer module
 
-The function adds an instance of the high-resolution timer module.
+The function adds an instance of the high-resolution timer module. The
+timers are set up according to the module parameters hrtimerCpu and
+hrtimerIrqMode. If debugfs is available, the expiry latency statistics of the
+timers can be read from the file powerlink_hrestimer in the debugfs root.
 
 \return Returns a tOplkError error code.
 
@@ -187,6 +249,30 @@ tOplkError hrestimer_addInstance(void)
     return ret;
 #endif
 
+    hresTimerInstance_l.mode = 0;
+    if (hrtimerCpu_l >= 0)
+    {
+        if ((hrtimerCpu_l >= nr_cpu_ids) || !cpu_online(hrtimerCpu_l))
+        {
+            printk("hrestimer: CPU %d is not available, timers are not pinned!\n", hrtimerCpu_l);
+            hrtimerCpu_l = -1;
+        }
+        else
+        {
+            hresTimerInstance_l.mode |= HRTIMER_MODE_PINNED;
+        }
+    }
+
+#ifdef HRESTIMER_HAVE_IRQ_MODE
+    if (hrtimerIrqMode_l == HRESTIMER_IRQ_MODE_HARD)
+        hresTimerInstance_l.mode |= HRTIMER_MODE_HARD;
+    else if (hrtimerIrqMode_l == HRESTIMER_IRQ_MODE_SOFT)
+        hresTimerInstance_l.mode |= HRTIMER_MODE_SOFT;
+#else
+    if (hrtimerIrqMode_l != HRESTIMER_IRQ_MODE_DEFAULT)
+        printk("hrestimer: IRQ mode %d is not supported by this kernel!\n", hrtimerIrqMode_l);
+#endif
+
     /* Initialize hrtimer structures for all usable timers */
     for (index = 0; index < TIMER_COUNT; index++)
     {
@@ -195,7 +281,8 @@ tOplkError hrestimer_addInstance(void)
 
         pTimerInfo = &hresTimerInstance_l.aTimerInfo[index];
         pTimer = &pTimerInfo->timer;
-        hrtimer_init(pTimer, CLOCK_MONOTONIC, HRTIMER_MODE_ABS);
+        hrtimer_init(pTimer, CLOCK_MONOTONIC, HRTIMER_MODE_ABS | hresTimerInstance_l.mode);
+        pTimerInfo->minLatency = ULONG_MAX;
 
         pTimer->function = timerCallback;
 
@@ -206,6 +293,14 @@ tOplkError hrestimer_addInstance(void)
         pTimer->cb_mode = HRTIMER_CB_SOFTIRQ;
 #endif
     }
+
+#ifdef CONFIG_DEBUG_FS
+    hresTimerInstance_l.pDebugfsFile = debugfs_create_file("powerlink_hrestimer", 0444, NULL,
+                                                           NULL, &latencyFileOps_l);
+    if (IS_ERR(hresTimerInstance_l.pDebugfsFile))
+        hresTimerInstance_l.pDebugfsFile = NULL;
+#endif
+
     return ret;
 }
 
@@ -228,7 +323,7 @@ tOplkError hrestimer_delInstance(void)
 
     for (index = 0; index < TIMER_COUNT; index++)
     {
-        pTimerInfo = &hresTimerInstance_l.aTimerInfo[0];
+        pTimerInfo = &hresTimerInstance_l.aTimerInfo[index];
         pTimerInfo->pfnCallback = NULL;
         pTimerInfo->eventArg.timerHdl = 0;
         /* In this case we can not just try to cancel the timer.
@@ -236,6 +331,12 @@ tOplkError hrestimer_delInstance(void)
          * has returned. */
         hrtimer_cancel(&pTimerInfo->timer);
     }
+
+#ifdef CONFIG_DEBUG_FS
+    debugfs_remove(hresTimerInstance_l.pDebugfsFile);
+    hresTimerInstance_l.pDebugfsFile = NULL;
+#endif
+
     return ret;
 }
 
@@ -273,7 +374,6 @@ tOplkError hrestimer_modifyTimer(tTimerHdl* pTimerHdl_p, ULONGLONG time_p,
     tOplkError              ret = kErrorOk;
     UINT                    index;
     tHresTimerInfo*         pTimerInfo;
-    ktime_t                 relTime;
 
     if(pTimerHdl_p == NULL)
         return kErrorTimerInvalidHandle;
@@ -324,14 +424,7 @@ tOplkError hrestimer_modifyTimer(tTimerHdl* pTimerHdl_p, ULONGLONG time_p,
     pTimerInfo->fContinuously = fContinue_p;
     pTimerInfo->period        = time_p;
 
-    /* HRTIMER_MODE_REL does not influence general handling of this timer.
-     * It only sets relative mode for this start operation.
-     * -> Expire time is calculated by: Now + RelTime
-     * hrtimer_start also skips pending timer events.
-     * The state HRTIMER_STATE_CALLBACK is ignored.
-     * We have to cope with that in our callback function. */
-    relTime = ktime_add_ns(ktime_set(0, 0), time_p);
-    hrtimer_start(&pTimerInfo->timer, relTime, HRTIMER_MODE_REL);
+    startTimer(pTimerInfo, time_p);
 
     return ret;
 }
@@ -425,6 +518,7 @@ enum hrtimer_restart timerCallback(struct hrtimer* pTimer_p)
     tHresTimerInfo*         pTimerInfo;
     tTimerHdl               orgTimerHdl;
     enum hrtimer_restart    ret;
+    ULONG                   latency;
 
     BENCHMARK_MOD_24_SET(4);
 
@@ -434,6 +528,15 @@ enum hrtimer_restart timerCallback(struct hrtimer* pTimer_p)
     if (index >= TIMER_COUNT)
         goto Exit;      // invalid handle
 
+    // update expiry latency statistics
+    latency = (ULONG)ktime_to_ns(ktime_sub(ktime_get(), hrtimer_get_expires(pTimer_p)));
+    pTimerInfo->expiryCount++;
+    pTimerInfo->latencySum += latency;
+    if (latency < pTimerInfo->minLatency)
+        pTimerInfo->minLatency = latency;
+    if (latency > pTimerInfo->maxLatency)
+        pTimerInfo->maxLatency = latency;
+
     /* We store the timer handle before calling the callback function
      * as the timer can be modified inside it. */
     orgTimerHdl = pTimerInfo->eventArg.timerHdl;
@@ -477,5 +580,117 @@ Exit:
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief    Start a timer
+
+The function starts the hrtimer of a timer with the specified relative timeout.
+If the timers are pinned to a CPU, the timer is started on this CPU because an
+hrtimer expires on the CPU it was started on. Periodic timers are restarted by
+the callback function and therefore stay on this CPU. If the function is called
+in interrupt context or with disabled interrupts, no function call can be sent
+to the other CPU and the timer is started on the current CPU.
+
+\param  pTimerInfo_p    Pointer to timer info of the timer.
+\param  time_p          Relative timeout in [ns].
+*/
+//------------------------------------------------------------------------------
+static void startTimer(tHresTimerInfo* pTimerInfo_p, ULONGLONG time_p)
+{
+    pTimerInfo_p->relTimeout = time_p;
+
+    if ((hrtimerCpu_l >= 0) && !in_interrupt() && !irqs_disabled())
+    {
+        if (smp_call_function_single(hrtimerCpu_l, startTimerOnCpu, pTimerInfo_p, 1) == 0)
+            return;
+    }
+
+    startTimerOnCpu(pTimerInfo_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Start a timer on the current CPU
+
+The function starts the hrtimer of a timer on the current CPU.
+
+\param  pInfo_p         Pointer to timer info of the timer.
+*/
+//------------------------------------------------------------------------------
+static void startTimerOnCpu(void* pInfo_p)
+{
+    tHresTimerInfo*         pTimerInfo = (tHresTimerInfo*)pInfo_p;
+    ktime_t                 relTime;
+
+    /* HRTIMER_MODE_REL does not influence general handling of this timer.
+     * It only sets relative mode for this start operation.
+     * -> Expire time is calculated by: Now + RelTime
+     * hrtimer_start also skips pending timer events.
+     * The state HRTIMER_STATE_CALLBACK is ignored.
+     * We have to cope with that in our callback function. */
+    relTime = ktime_add_ns(ktime_set(0, 0), pTimerInfo->relTimeout);
+    hrtimer_start(&pTimerInfo->timer, relTime, HRTIMER_MODE_REL | hresTimerInstance_l.mode);
+}
+
+#ifdef CONFIG_DEBUG_FS
+//------------------------------------------------------------------------------
+/**
+\brief    Show the expiry latency statistics
+
+The function prints the expiry latency statistics of the timers to the debugfs
+file.
+
+\param  pSeqFile_p      Pointer to sequence file.
+\param  pData_p         Private data (unused).
+
+\return The function returns 0.
+*/
+//------------------------------------------------------------------------------
+static int showLatency(struct seq_file* pSeqFile_p, void* pData_p)
+{
+    UINT                    index;
+    tHresTimerInfo*         pTimerInfo;
+    ULONGLONG               avgLatency;
+
+    UNUSED_PARAMETER(pData_p);
+
+    seq_printf(pSeqFile_p, "CPU: %d, IRQ mode: %d\n", hrtimerCpu_l, hrtimerIrqMode_l);
+    seq_printf(pSeqFile_p, "Timer    Expiries   Min [ns]   Avg [ns]   Max [ns]\n");
+
+    for (index = 0; index < TIMER_COUNT; index++)
+    {
+        pTimerInfo = &hresTimerInstance_l.aTimerInfo[index];
+        if (pTimerInfo->expiryCount == 0)
+        {
+            seq_printf(pSeqFile_p, "%5u %11u          -          -          -\n", index, 0);
+            continue;
+        }
+
+        avgLatency = pTimerInfo->latencySum;
+        do_div(avgLatency, pTimerInfo->expiryCount);
+        seq_printf(pSeqFile_p, "%5u %11lu %10lu %10llu %10lu\n", index,
+                   pTimerInfo->expiryCount, pTimerInfo->minLatency,
+                   avgLatency, pTimerInfo->maxLatency);
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Open the debugfs file
+
+\param  pInode_p        Pointer to inode of the file.
+\param  pFile_p         Pointer to file structure.
+
+\return The function returns 0 or a negative error code.
+*/
+//------------------------------------------------------------------------------
+static int openLatency(struct inode* pInode_p, struct file* pFile_p)
+{
+    return single_open(pFile_p, showLatency, pInode_p->i_private);
+}
+#endif
+
 /// \}
 
@@ -2,11 +2,14 @@
 ********************************************************************************
 \file   hrestimer-posix.c
 
-\brief  High-resolution timer module for Linux using Posix timer functions
+\brief  High-resolution timer module for Linux using absolute timerfd deadlines
 
 This module is the target specific implementation of the high-resolution
-timer module for Linux userspace. It uses Posix timer functions for its
-implementation.
+timer module for Linux userspace. Every timer is served by its own thread which
+waits on a timerfd armed with absolute CLOCK_MONOTONIC deadlines. Continuous
+timers advance their deadline by the period from the first expiration, so no
+drift accumulates. Optionally the thread busy-polls the clock for the last
+microseconds before the deadline (see CONFIG_HRESTIMER_BUSY_WAIT_US).
 
 \ingroup module_hrestimer
 *******************************************************************************/
@@ -45,11 +48,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/oplkinc.h>
 #include <kernel/hrestimer.h>
 #include <oplk/benchmark.h>
+#include <common/target.h>
 
 #include <time.h>
 #include <unistd.h>
 #include <pthread.h>
-#include <signal.h>
+#include <sys/timerfd.h>
 #include <sys/syscall.h>
 
 //============================================================================//
@@ -64,7 +68,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define TIMER_MIN_VAL_SINGLE  20000        ///< minimum timer intervall for single timeouts
 #define TIMER_MIN_VAL_CYCLE   100000       ///< minimum timer intervall for continuous timeouts
 
-#define SIGHIGHRES           SIGRTMIN + 1
+#ifndef CONFIG_THREAD_PRIORITY_HRTIMER
+#define CONFIG_THREAD_PRIORITY_HRTIMER      CONFIG_THREAD_PRIORITY_HIGH
+#endif
 
 /* macros for timer handles */
 #define TIMERHDL_MASK         0x0FFFFFFF
@@ -88,6 +94,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#define BUSY_WAIT_TIME        ((ULONGLONG)CONFIG_HRESTIMER_BUSY_WAIT_US * 1000ULL)
 
 //------------------------------------------------------------------------------
 // local types
@@ -102,7 +109,14 @@ typedef struct
 {
     tTimerEventArg      eventArg;       ///< Event argument
     tTimerkCallback     pfnCallback;    ///< Pointer to timer callback function
-    timer_t             timer;          ///< timer_t struct of this timer
+    INT                 timerFd;        ///< timerfd of this timer
+    pthread_t           threadId;       ///< Handle of timer thread
+    pthread_mutex_t     mutex;          ///< Mutex protecting the timer settings
+    ULONGLONG           deadline;       ///< Absolute CLOCK_MONOTONIC time of next expiration in ns
+    ULONGLONG           period;         ///< Timer period in ns
+    BOOL                fArmed;         ///< Flag determines if the timer is running
+    BOOL                fContinue;      ///< Flag determines if timer will be restarted continuously
+    BOOL                fTerminate;     ///< Thread termination flag
 } tHresTimerInfo;
 
 /**
@@ -113,7 +127,6 @@ The structure defines a high-resolution timer module instance.
 typedef struct
 {
     tHresTimerInfo      aTimerInfo[TIMER_COUNT];    ///< Array with timer information for a set of timers
-    pthread_t           threadId;                   ///< Timer thread Id
 } tHresTimerInstance;
 
 //------------------------------------------------------------------------------
@@ -124,7 +137,9 @@ static tHresTimerInstance       hresTimerInstance_l;
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
-static void* timerThread(void* pParm_p);
+static void* timerThread(void* pArgument_p);
+static void  armTimerFd(tHresTimerInfo* pTimerInfo_p, ULONGLONG expireTime_p);
+static void  cleanupTimer(tHresTimerInfo* pTimerInfo_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -150,7 +165,10 @@ tOplkError hrestimer_init(void)
 /**
 \brief    Add instance of high-resolution timer module
 
-The function adds an instance of the high-resolution timer module.
+The function adds an instance of the high-resolution timer module. It creates
+a timerfd and a thread for every timer. The threads are scheduled with
+SCHED_FIFO and the priority CONFIG_THREAD_PRIORITY_HRTIMER and are pinned to
+the CPUs in CONFIG_THREAD_CPU_MASK_HRTIMER.
 
 \return Returns a tOplkError error code.
 
@@ -161,45 +179,59 @@ tOplkError hrestimer_addInstance(void)
 {
     tOplkError              ret = kErrorOk;
     UINT                    index;
-    struct sched_param      schedParam;
     tHresTimerInfo*         pTimerInfo;
-    struct sigevent         sev;
 
-    OPLK_MEMSET(&hresTimerInstance_l, 0, sizeof (hresTimerInstance_l));
+    OPLK_MEMSET(&hresTimerInstance_l, 0, sizeof(hresTimerInstance_l));
 
     /* Initialize timer threads for all usable timers. */
     for (index = 0; index < TIMER_COUNT; index++)
     {
         pTimerInfo = &hresTimerInstance_l.aTimerInfo[index];
 
-        sev.sigev_notify = SIGEV_SIGNAL;
-        sev.sigev_signo = SIGHIGHRES;
-        sev.sigev_value.sival_ptr = pTimerInfo;
+        pTimerInfo->timerFd = timerfd_create(CLOCK_MONOTONIC, 0);
+        if (pTimerInfo->timerFd < 0)
+        {
+            DEBUG_LVL_ERROR_TRACE("%s() Couldn't create timerfd!\n", __func__);
+            ret = kErrorNoResource;
+            break;
+        }
 
-        if (timer_create(CLOCK_MONOTONIC, &sev, &pTimerInfo->timer) != 0)
+        if (pthread_mutex_init(&pTimerInfo->mutex, NULL) != 0)
         {
-            return kErrorNoResource;
+            close(pTimerInfo->timerFd);
+            ret = kErrorNoResource;
+            break;
         }
-    }
 
-    if (pthread_create(&hresTimerInstance_l.threadId, NULL,
-                       timerThread, NULL) != 0)
-    {
-        return kErrorNoResource;
+        if (target_createThread(&pTimerInfo->threadId, kThreadRoleHrTimer, "oplk-hrtimer",
+                                timerThread, pTimerInfo) != kErrorOk)
+        {
+            pthread_mutex_destroy(&pTimerInfo->mutex);
+            close(pTimerInfo->timerFd);
+            ret = kErrorNoResource;
+            break;
+        }
+
+        if (target_setThreadParams(pTimerInfo->threadId, kThreadRoleHrTimer, kThreadSchedFifo,
+                                   CONFIG_THREAD_PRIORITY_HRTIMER,
+                                   CONFIG_THREAD_CPU_MASK_HRTIMER) != kErrorOk)
+        {
+            DEBUG_LVL_ERROR_TRACE("%s() Couldn't set thread scheduling parameters!\n", __func__);
+            cleanupTimer(pTimerInfo);
+            ret = kErrorNoResource;
+            break;
+        }
     }
 
-    schedParam.__sched_priority = CONFIG_THREAD_PRIORITY_HIGH;
-    if (pthread_setschedparam(hresTimerInstance_l.threadId, SCHED_FIFO, &schedParam) != 0)
+    if (ret != kErrorOk)
     {
-        DEBUG_LVL_ERROR_TRACE("%s() Couldn't set thread scheduling parameters!\n", __func__);
-        pthread_cancel(hresTimerInstance_l.threadId);
-        return kErrorNoResource;
+        while (index > 0)
+        {
+            index--;
+            cleanupTimer(&hresTimerInstance_l.aTimerInfo[index]);
+        }
     }
 
-#if (defined(__GLIBC__) && __GLIBC__ >= 2 && __GLIBC_MINOR__ >= 12)
-    pthread_setname_np(hresTimerInstance_l.threadId, "oplk-hrtimer");
-#endif
-
     return ret;
 }
 
@@ -216,27 +248,14 @@ The function deletes an instance of the high-resolution timer module.
 //------------------------------------------------------------------------------
 tOplkError hrestimer_delInstance(void)
 {
-    tHresTimerInfo*         pTimerInfo;
-    tOplkError              ret = kErrorOk;
     UINT                    index;
 
     for (index = 0; index < TIMER_COUNT; index++)
     {
-        pTimerInfo = &hresTimerInstance_l.aTimerInfo[index];
-        timer_delete(pTimerInfo->timer);
-        pTimerInfo->eventArg.timerHdl = 0;
-        pTimerInfo->pfnCallback = NULL;
+        cleanupTimer(&hresTimerInstance_l.aTimerInfo[index]);
     }
 
-    /* send exit signal to thread */
-    pthread_cancel(hresTimerInstance_l.threadId);
-    /* wait until thread terminates */
-    DEBUG_LVL_TIMERH_TRACE("%s() Waiting for thread to exit...\n", __func__);
-
-    pthread_join(hresTimerInstance_l.threadId, NULL);
-    DEBUG_LVL_TIMERH_TRACE("%s() Thread exited!\n", __func__);
-
-    return ret;
+    return kErrorOk;
 }
 
 //------------------------------------------------------------------------------
@@ -251,6 +270,9 @@ as the new timer. That means the callback function must check the passed handle
 with the one returned by this function. If these are unequal, the call can be
 discarded.
 
+The timeout is converted into an absolute deadline. Continuous timers expire
+at this deadline plus multiples of the period.
+
 \param  pTimerHdl_p     Pointer to timer handle.
 \param  time_p          Relative timeout in [ns].
 \param  pfnCallback_p   Callback function, which is called when timer expires.
@@ -269,10 +291,11 @@ tOplkError hrestimer_modifyTimer(tTimerHdl* pTimerHdl_p, ULONGLONG time_p,
                                  tTimerkCallback pfnCallback_p, ULONG argument_p,
                                  BOOL fContinue_p)
 {
-    tOplkError              ret = kErrorOk;
+    ULONGLONG               startTime;
     UINT                    index;
     tHresTimerInfo*         pTimerInfo;
-    struct itimerspec       RelTime;
+
+    startTime = target_getCurrentTimestamp();
 
     // check pointer to handle
     if (pTimerHdl_p == NULL)
@@ -321,6 +344,8 @@ tOplkError hrestimer_modifyTimer(tTimerHdl* pTimerHdl_p, ULONGLONG time_p,
             time_p = TIMER_MIN_VAL_SINGLE;
     }
 
+    pthread_mutex_lock(&pTimerInfo->mutex);
+
     /* increment timer handle
      * (if timer expires right after this statement, the user
      * would detect an unknown timer handle and discard it) */
@@ -330,36 +355,19 @@ tOplkError hrestimer_modifyTimer(tTimerHdl* pTimerHdl_p, ULONGLONG time_p,
     /* initialize timer info */
     pTimerInfo->eventArg.argument.value = argument_p;
     pTimerInfo->pfnCallback = pfnCallback_p;
+    pTimerInfo->fContinue = fContinue_p;
+    pTimerInfo->period = time_p;
+    pTimerInfo->deadline = startTime + time_p;
+    pTimerInfo->fArmed = TRUE;
 
-    if (time_p >= 1000000000L)
-    {
-        RelTime.it_value.tv_sec = (time_p / 1000000000L);
-        RelTime.it_value.tv_nsec = (time_p % 1000000000) ;
-    }
-    else
-    {
-        RelTime.it_value.tv_sec = 0;
-        RelTime.it_value.tv_nsec = time_p;
-    }
-
-    if (fContinue_p)
-    {
-        RelTime.it_interval.tv_nsec = RelTime.it_value.tv_nsec;
-        RelTime.it_interval.tv_sec = RelTime.it_value.tv_sec;
-    }
-    else
-    {
-        RelTime.it_interval.tv_nsec = 0;
-        RelTime.it_interval.tv_sec = 0;
-    }
+    DEBUG_LVL_TIMERH_TRACE("%s() timer:%lx deadline=%llu\n", __func__,
+                           pTimerInfo->eventArg.timerHdl, pTimerInfo->deadline);
 
-    DEBUG_LVL_TIMERH_TRACE("%s() timer:%lx timeout=%ld:%ld\n", __func__,
-                            pTimerInfo->eventArg.timerHdl,
-                            RelTime.it_value.tv_sec, RelTime.it_value.tv_nsec);
+    armTimerFd(pTimerInfo, pTimerInfo->deadline - BUSY_WAIT_TIME);
 
-    timer_settime(pTimerInfo->timer, 0, &RelTime, NULL);
+    pthread_mutex_unlock(&pTimerInfo->mutex);
 
-    return ret;
+    return kErrorOk;
 }
 
 //------------------------------------------------------------------------------
@@ -381,13 +389,12 @@ tOplkError hrestimer_deleteTimer(tTimerHdl* pTimerHdl_p)
     tOplkError                  ret = kErrorOk;
     UINT                        index;
     tHresTimerInfo*             pTimerInfo;
-    struct itimerspec           relTime;
-
-    DEBUG_LVL_TIMERH_TRACE("%s() Deleting timer:%lx\n", __func__, *pTimerHdl_p);
 
-    if(pTimerHdl_p == NULL)
+    if (pTimerHdl_p == NULL)
         return kErrorTimerInvalidHandle;
 
+    DEBUG_LVL_TIMERH_TRACE("%s() Deleting timer:%lx\n", __func__, *pTimerHdl_p);
+
     if (*pTimerHdl_p == 0)
     {   // no timer created yet
         return ret;
@@ -406,15 +413,18 @@ tOplkError hrestimer_deleteTimer(tTimerHdl* pTimerHdl_p)
         }
     }
 
-    // values of 0 disarms the timer
-    relTime.it_value.tv_sec = 0;
-    relTime.it_value.tv_nsec = 0;
-    timer_settime(pTimerInfo->timer, 0, &relTime, NULL);
+    pthread_mutex_lock(&pTimerInfo->mutex);
+
+    // a value of 0 disarms the timer
+    pTimerInfo->fArmed = FALSE;
+    armTimerFd(pTimerInfo, 0);
 
     *pTimerHdl_p = 0;
     pTimerInfo->eventArg.timerHdl = 0;
     pTimerInfo->pfnCallback = NULL;
 
+    pthread_mutex_unlock(&pTimerInfo->mutex);
+
     return ret;
 }
 
@@ -428,45 +438,141 @@ tOplkError hrestimer_deleteTimer(tTimerHdl* pTimerHdl_p)
 /**
 \brief    Timer thread function
 
-The function provides the main function of the timer thread.
+The function provides the main function of a timer thread. It waits until the
+timerfd of its timer expires, busy-waits for the rest of the time until the
+deadline and calls the callback function. Continuous timers are re-armed with
+the next deadline before the callback is called. If the thread was late by
+more than a period the missed expirations are skipped.
 
-\param  pParm_p     Thread parameter (unused!)
+\param  pArgument_p     Thread parameter. It contains the pointer to the timer
+                        info structure.
 
 \return Returns a void* as specified by the pthread interface but it is not used!
 */
 //------------------------------------------------------------------------------
-static void* timerThread(void* pParm_p)
+static void* timerThread(void* pArgument_p)
 {
-    INT                                 iRet;
-    tHresTimerInfo*                     pTimerInfo;
-    sigset_t                            awaitedSignal;
-    siginfo_t                           signalInfo;
-
-    UNUSED_PARAMETER(pParm_p);
+    tHresTimerInfo*             pTimerInfo = (tHresTimerInfo*)pArgument_p;
+    UINT64                      expirations;
+    ULONGLONG                   now;
+    ULONGLONG                   deadline;
+    tTimerHdl                   timerHdl;
+    tTimerkCallback             pfnCallback;
 
     DEBUG_LVL_TIMERH_TRACE("%s(): ThreadId:%ld\n", __func__, syscall(SYS_gettid));
 
-    sigemptyset(&awaitedSignal);
-    sigaddset(&awaitedSignal, SIGHIGHRES);
-    pthread_sigmask(SIG_BLOCK, &awaitedSignal, NULL);
-
-    /* loop forever until thread will be canceled */
+    /* loop until the thread is terminated */
     while (1)
     {
-        if ((iRet = sigwaitinfo(&awaitedSignal, &signalInfo)) > 0)
+        if (read(pTimerInfo->timerFd, &expirations, sizeof(expirations)) < 0)
+        {   // interrupted by a signal
+            continue;
+        }
+
+        pthread_mutex_lock(&pTimerInfo->mutex);
+
+        if (pTimerInfo->fTerminate)
+        {
+            pthread_mutex_unlock(&pTimerInfo->mutex);
+            DEBUG_LVL_TIMERH_TRACE("%s() Exiting signal received!\n", __func__);
+            break;
+        }
+
+        now = target_getCurrentTimestamp();
+        if (!pTimerInfo->fArmed || (now + BUSY_WAIT_TIME < pTimerInfo->deadline))
+        {   // timer was deleted or modified after the timerfd expired
+            pthread_mutex_unlock(&pTimerInfo->mutex);
+            continue;
+        }
+
+        deadline = pTimerInfo->deadline;
+        timerHdl = pTimerInfo->eventArg.timerHdl;
+        pfnCallback = pTimerInfo->pfnCallback;
+
+        if (pTimerInfo->fContinue)
         {
-            pTimerInfo = (tHresTimerInfo*)signalInfo.si_value.sival_ptr;
-            /* call callback function */
-            if (pTimerInfo->pfnCallback != NULL)
-            {
-                pTimerInfo->pfnCallback(&pTimerInfo->eventArg);
+            pTimerInfo->deadline += pTimerInfo->period;
+            if (pTimerInfo->deadline <= now)
+            {   // skip missed expirations but keep the cycle phase
+                pTimerInfo->deadline += ((now - pTimerInfo->deadline) / pTimerInfo->period + 1) *
+                                        pTimerInfo->period;
             }
+            armTimerFd(pTimerInfo, pTimerInfo->deadline - BUSY_WAIT_TIME);
+        }
+        else
+        {
+            pTimerInfo->fArmed = FALSE;
+        }
+
+        pthread_mutex_unlock(&pTimerInfo->mutex);
+
+        while (now < deadline)
+        {   // poll the clock for the rest of the time
+            now = target_getCurrentTimestamp();
+        }
+
+        FTRACE_MARKER("HighReskTimer(%d) expired", (int)timerHdl);
+
+        /* check if timer handle is still valid.
+         * Could be modified during busy waiting! */
+        if ((pfnCallback != NULL) && (timerHdl == pTimerInfo->eventArg.timerHdl))
+        {
+            pfnCallback(&pTimerInfo->eventArg);
         }
     }
 
-    DEBUG_LVL_TIMERH_TRACE("%s() Exiting!\n", __func__);
     return NULL;
 }
 
-/// \}
+//------------------------------------------------------------------------------
+/**
+\brief    Arm timerfd of a timer
 
+The function arms the timerfd of a timer with an absolute expiration time.
+The caller must hold the mutex of the timer.
+
+\param  pTimerInfo_p    Pointer to timer info structure.
+\param  expireTime_p    Absolute CLOCK_MONOTONIC expiration time in ns. A value
+                        of 0 disarms the timerfd.
+*/
+//------------------------------------------------------------------------------
+static void armTimerFd(tHresTimerInfo* pTimerInfo_p, ULONGLONG expireTime_p)
+{
+    struct itimerspec   absTime;
+
+    OPLK_MEMSET(&absTime, 0, sizeof(absTime));
+    absTime.it_value.tv_sec = (time_t)(expireTime_p / 1000000000ULL);
+    absTime.it_value.tv_nsec = (long)(expireTime_p % 1000000000ULL);
+
+    timerfd_settime(pTimerInfo_p->timerFd, TFD_TIMER_ABSTIME, &absTime, NULL);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Clean up a timer
+
+The function terminates the thread of a timer and frees its resources.
+
+\param  pTimerInfo_p    Pointer to timer info structure.
+*/
+//------------------------------------------------------------------------------
+static void cleanupTimer(tHresTimerInfo* pTimerInfo_p)
+{
+    pthread_mutex_lock(&pTimerInfo_p->mutex);
+    pTimerInfo_p->eventArg.timerHdl = 0;
+    pTimerInfo_p->pfnCallback = NULL;
+    pTimerInfo_p->fArmed = FALSE;
+    pTimerInfo_p->fTerminate = TRUE;
+    /* send exit signal to thread by an immediate expiration */
+    armTimerFd(pTimerInfo_p, 1);
+    pthread_mutex_unlock(&pTimerInfo_p->mutex);
+
+    DEBUG_LVL_TIMERH_TRACE("%s() Waiting for thread to exit...\n", __func__);
+    pthread_join(pTimerInfo_p->threadId, NULL);
+    DEBUG_LVL_TIMERH_TRACE("%s() Thread exited!\n", __func__);
+
+    pthread_mutex_destroy(&pTimerInfo_p->mutex);
+    close(pTimerInfo_p->timerFd);
+}
+
+/// \}
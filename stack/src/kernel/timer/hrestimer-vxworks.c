@@ -60,6 +60,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define TIMER_MIN_VAL_SINGLE  20000        ///< minimum timer intervall for single timeouts
 #define TIMER_MIN_VAL_CYCLE   100000       ///< minimum timer intervall for continuous timeouts
 
+#ifndef CONFIG_HRESTIMER_CB_TASK_PRIORITY
+#define CONFIG_HRESTIMER_CB_TASK_PRIORITY   10                  ///< priority of the hrtimer callback task
+#endif
+
+#ifndef CONFIG_HRESTIMER_CB_TASK_STACK_SIZE
+#define CONFIG_HRESTIMER_CB_TASK_STACK_SIZE EPL_TASK_STACK_SIZE ///< stack size of the hrtimer callback task
+#endif
+
 /* macros for timer handles */
 #define TIMERHDL_MASK         0x0FFFFFFF
 #define TIMERHDL_SHIFT        28
@@ -108,6 +116,7 @@ typedef struct
 {
     tHresTimerInfo          aTimerInfo[TIMER_COUNT];
     int                     taskId;
+    BOOL                    fLibInitialized;    ///< hrtimer library was initialized by this module
 } tHresTimerInstance;
 
 //------------------------------------------------------------------------------
@@ -143,7 +152,11 @@ tOplkError hrestimer_init(void)
 /**
 \brief    Add instance of high-resolution timer module
 
-The function adds an instance of the high-resolution timer module.
+The function adds an instance of the high-resolution timer module. The timers
+are created with the hrtimer library, which is driven by the HPET. If the
+library has not been initialized by the application, it is initialized here.
+The timer callbacks, e.g. the cycle timer of the edrvcyclic module, are called
+from the callback task of the library.
 
 \return Returns a tOplkError error code.
 
@@ -156,6 +169,7 @@ tOplkError hrestimer_addInstance(void)
     UINT                        index;
     tHresTimerInfo*             pTimerInfo;
     tHrtimerSig                 sig;
+    int                         result;
 
     OPLK_MEMSET(&hresTimerInstance_l, 0, sizeof(hresTimerInstance_l));
 
@@ -165,10 +179,23 @@ tOplkError hrestimer_addInstance(void)
         pTimerInfo = &hresTimerInstance_l.aTimerInfo[index];
 
         sig.sigType = kHrtimerSigCallback;
-        sig.sigParam.m_signalCallback.pfnCallback = NULL;
-        sig.sigParam.m_signalCallback.m_arg = 0;
+        sig.sigParam.m_signalCallback.m_pfnCallback = NULL;
+        sig.sigParam.m_signalCallback.m_arg = NULL;
+
+        result = hrtimer_create(CLOCK_MONOTONIC, &sig, &pTimerInfo->timer);
+        if (result == kHrtimerReturnNotInit)
+        {   // initialize the hrtimer library and the HPET
+            if (hrtimer_init(CONFIG_HRESTIMER_CB_TASK_PRIORITY,
+                             CONFIG_HRESTIMER_CB_TASK_STACK_SIZE) != kHrtimerReturnOk)
+            {
+                DEBUG_LVL_ERROR_TRACE("%s() Couldn't initialize hrtimer library!\n", __func__);
+                return kErrorNoResource;
+            }
+            hresTimerInstance_l.fLibInitialized = TRUE;
+            result = hrtimer_create(CLOCK_MONOTONIC, &sig, &pTimerInfo->timer);
+        }
 
-        if (hrtimer_create(CLOCK_MONOTONIC, &sig, &pTimerInfo->timer) != 0)
+        if (result != kHrtimerReturnOk)
             return kErrorNoResource;
     }
 
@@ -198,6 +225,13 @@ tOplkError hrestimer_delInstance(void)
         pTimerInfo->eventArg.timerHdl = 0;
         pTimerInfo->pfnCallback = NULL;
     }
+
+    if (hresTimerInstance_l.fLibInitialized)
+    {
+        hrtimer_shutdown();
+        hresTimerInstance_l.fLibInitialized = FALSE;
+    }
+
     return kErrorOk;
 }
 
@@ -255,7 +289,7 @@ tOplkError hrestimer_modifyTimer(tTimerHdl* pTimerHdl_p, ULONGLONG time_p,
             DEBUG_LVL_ERROR_TRACE("%s() Invalid timer index:%d\n", __func__, index);
             return kErrorTimerNoTimerCreated;
         }
-        pTimerInfo->eventArg.timerHdl = HDL_INIT(uiIndex);
+        pTimerInfo->eventArg.timerHdl = HDL_INIT(index);
     }
     else
     {
@@ -288,7 +322,7 @@ tOplkError hrestimer_modifyTimer(tTimerHdl* pTimerHdl_p, ULONGLONG time_p,
     /* initialize timer info */
     pTimerInfo->eventArg.argument.value = argument_p;
     pTimerInfo->pfnCallback = pfnCallback_p;
-    hrtimer_setCallback(pTimerInfo->timer, (void*)pTimerInfo->pfnCallback,
+    hrtimer_setCallback(pTimerInfo->timer, (tHrTimerCbFuncPtr)pTimerInfo->pfnCallback,
                         (void*)&pTimerInfo->eventArg);
 
     /*logMsg("set TCB: %p(%p)\n", (int)pTimerInfo->pfnCallback, (int)pTimerInfo->eventArg.argument.value, 0, 0, 0, 0);*/
@@ -371,12 +405,14 @@ tOplkError hrestimer_deleteTimer(tTimerHdl* pTimerHdl_p)
     // values of 0 disarms the timer
     relTime.it_value.tv_sec = 0;
     relTime.it_value.tv_nsec = 0;
+    relTime.it_interval.tv_sec = 0;
+    relTime.it_interval.tv_nsec = 0;
     hrtimer_settime(pTimerInfo->timer, 0, &relTime, NULL);
 
     *pTimerHdl_p = 0;
     pTimerInfo->eventArg.timerHdl = 0;
     pTimerInfo->pfnCallback = NULL;
-    hrtimer_setCallback(pTimerInfo->timer, (void*)pTimerInfo->pfnCallback, 0);
+    hrtimer_setCallback(pTimerInfo->timer, (tHrTimerCbFuncPtr)pTimerInfo->pfnCallback, NULL);
     return ret;
 }
 
@@ -42,6 +42,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <kernel/hrestimer.h>
+#include <kernel/edrv.h>
+#include <common/target.h>
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -55,6 +57,19 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define TIMERHDL_MASK               0x0FFFFFFF
 #define TIMERHDL_SHIFT              28
 
+#ifndef CONFIG_HRESTIMER_BUSYWAIT_NS
+#define CONFIG_HRESTIMER_BUSYWAIT_NS    0       // time before the expiry which is spent busy waiting
+#endif
+
+// Standard waitable timers don't expire earlier than 1 ms, therefore shorter
+// timeouts are extended to 1 ms. High resolution waitable timers are used
+// with the requested timeout.
+#if (EDRV_USE_HIGHRES_TIMER != FALSE)
+#define HRESTIMER_MIN_WAIT_NS       0
+#else
+#define HRESTIMER_MIN_WAIT_NS       1000000
+#endif
+
 //------------------------------------------------------------------------------
 // module global vars
 //------------------------------------------------------------------------------
@@ -88,7 +103,8 @@ typedef struct
 {
     tTimerEventArg      eventArg;
     tTimerkCallback     pfnCallback;
-    LARGE_INTEGER       dueTime;    // for continuous timers, otherwise 0
+    ULONGLONG           expireTime; // expiry time (target_getCurrentTimestamp() base) [ns]
+    ULONGLONG           period;     // for continuous timers, otherwise 0 [ns]
 } tHresTimerInfo;
 
 /**
@@ -122,7 +138,7 @@ NTSETTIMERRESOLUTION        NtSetTimerResolution;
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
-
+static BOOL armTimer(UINT index_p, ULONGLONG expireTime_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -264,8 +280,6 @@ tOplkError hrestimer_modifyTimer(tTimerHdl* pTimerHdl_p, ULONGLONG time_p,
     BOOL                        fRet;
     UINT                        index;
     tHresTimerInfo*             pTimerInfo;
-    HANDLE                      hTimer;
-    LARGE_INTEGER               dueTime;
 
     if(pTimerHdl_p == NULL)
         return kErrorTimerInvalidHandle;
@@ -296,36 +310,23 @@ tOplkError hrestimer_modifyTimer(tTimerHdl* pTimerHdl_p, ULONGLONG time_p,
     pTimerInfo->eventArg.timerHdl = ((pTimerInfo->eventArg.timerHdl + 1) & TIMERHDL_MASK)
                                         | ((index + 1) << TIMERHDL_SHIFT);
 
-    // calculate duetime [100 ns] (negative value = relative time)
-    dueTime.QuadPart = (LONGLONG)time_p / -100LL;
-    if (dueTime.QuadPart > -10000LL)
-    {   // duetime is less than 1 ms
-        dueTime.QuadPart = -10000LL;
-    }
+    if (time_p < HRESTIMER_MIN_WAIT_NS)
+        time_p = HRESTIMER_MIN_WAIT_NS;
 
-    if (fContinue_p != FALSE)
-    {   // continuous timer
-        pTimerInfo->dueTime = dueTime;
-    }
-    else
-    {   // one-shot timer
-        pTimerInfo->dueTime.QuadPart = 0LL;
-    }
+    // continuous timers are rearmed relative to their last expiry time to
+    // avoid a drift by the callback latency
+    pTimerInfo->period = (fContinue_p != FALSE) ? time_p : 0;
+    pTimerInfo->expireTime = target_getCurrentTimestamp() + time_p;
 
     pTimerInfo->eventArg.argument.value = argument_p;
     pTimerInfo->pfnCallback = pfnCallback_p;
 
     *pTimerHdl_p = pTimerInfo->eventArg.timerHdl;
 
-    // configure timer
-    hTimer = edrv_getTimerHandle(index);
-
-    fRet = SetWaitableTimer(hTimer, &dueTime, 0L, NULL, NULL, 0);
+    fRet = armTimer(index, pTimerInfo->expireTime);
     if (!fRet)
-    {
-        DEBUG_LVL_ERROR_TRACE("SetWaitableTimer failed (%d)\n", GetLastError());
         return kErrorTimerNoTimerCreated;
-    }
+
     return ret;
 }
 
@@ -386,7 +387,8 @@ tOplkError hrestimer_deleteTimer(tTimerHdl* pTimerHdl_p)
 \brief    Timer callback function
 
 The function implements the timer callback function. It is called when a timer
-expires.
+expires. If CONFIG_HRESTIMER_BUSYWAIT_NS is set, the waitable timer expires
+this time before the timer and the remaining time is spent busy waiting.
 
 \param  index_p     Index of timer (0 or 1)
 */
@@ -394,26 +396,32 @@ expires.
 void hresTimerCb(UINT index_p)
 {
     tHresTimerInfo* pTimerInfo;
+    ULONGLONG       now;
 
-    if (index_p > TIMER_COUNT)
+    if (index_p >= TIMER_COUNT)
         return;     // invalid handle
 
     pTimerInfo = &hresTimerInstance_l.aTimerInfo[index_p];
 
-    if (pTimerInfo->dueTime.QuadPart != 0)
-    {   // periodic timer
-        HANDLE  hTimer;
-        BOOL    fRet;
+    now = target_getCurrentTimestamp();
+#if (CONFIG_HRESTIMER_BUSYWAIT_NS != 0)
+    while (now < pTimerInfo->expireTime)
+    {
+        YieldProcessor();
+        now = target_getCurrentTimestamp();
+    }
+#endif
 
-        // configure timer
-        hTimer = edrv_getTimerHandle(index_p);
+    if (pTimerInfo->period != 0)
+    {   // periodic timer
+        pTimerInfo->expireTime += pTimerInfo->period;
+        if (pTimerInfo->expireTime < now)
+        {   // periods were missed, continue from now
+            pTimerInfo->expireTime = now + pTimerInfo->period;
+        }
 
-        fRet = SetWaitableTimer(hTimer, &pTimerInfo->dueTime, 0L, NULL, NULL, 0);
-        if (!fRet)
-        {
-            DEBUG_LVL_ERROR_TRACE("SetWaitableTimer failed (%d)\n", GetLastError());
+        if (!armTimer(index_p, pTimerInfo->expireTime))
             return;
-        }
     }
 
     if (pTimerInfo->pfnCallback != NULL)
@@ -423,3 +431,46 @@ void hresTimerCb(UINT index_p)
     return;
 }
 
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief    Arm a waitable timer
+
+The function arms the waitable timer of the specified timer for the specified
+expiry time. The waitable timer expires CONFIG_HRESTIMER_BUSYWAIT_NS earlier.
+
+\param  index_p         Index of timer (0 or 1)
+\param  expireTime_p    Expiry time (target_getCurrentTimestamp() base) [ns]
+
+\return The function returns TRUE if the timer was armed, otherwise FALSE.
+*/
+//------------------------------------------------------------------------------
+static BOOL armTimer(UINT index_p, ULONGLONG expireTime_p)
+{
+    HANDLE          hTimer;
+    LARGE_INTEGER   dueTime;
+    LONGLONG        waitTime;
+
+    waitTime = (LONGLONG)(expireTime_p - target_getCurrentTimestamp()) - CONFIG_HRESTIMER_BUSYWAIT_NS;
+
+    // calculate duetime [100 ns] (negative value = relative time)
+    dueTime.QuadPart = -(waitTime / 100LL);
+    if (dueTime.QuadPart >= 0)
+        dueTime.QuadPart = -1LL;
+
+    hTimer = edrv_getTimerHandle(index_p);
+    if (!SetWaitableTimer(hTimer, &dueTime, 0L, NULL, NULL, 0))
+    {
+        DEBUG_LVL_ERROR_TRACE("SetWaitableTimer failed (%d)\n", GetLastError());
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/// \}
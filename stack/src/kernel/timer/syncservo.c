@@ -0,0 +1,321 @@
+/**
+********************************************************************************
+\file   syncservo.c
+
+\brief  Implementation of the sync servo module
+
+The sync servo locks the sync timer of a CN to the SoC frames of the MN. It is
+a PI controller: The proportional part corrects the phase of the next sync
+event, the integral part estimates the cycle length of the MN in the time base
+of the local clock and therefore compensates the drift between both clocks.
+
+After the first SoC or a change of the cycle length, the servo runs with high
+gains for CONFIG_SYNCTIMER_ACQUISITION_CYCLES cycles to lock in quickly. Then
+it switches to the gains CONFIG_SYNCTIMER_KP_SHIFT and CONFIG_SYNCTIMER_KI_SHIFT
+which filter the jitter of the SoC reception. Once locked, sync errors above
+the outlier limit are ignored. If several consecutive errors exceed the limit,
+the timing of the MN has changed and the servo starts a new acquisition.
+
+\ingroup module_synctimer
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <kernel/syncservo.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define SYNCSERVO_FRACTION_SHIFT        8       ///< Fractional bits of the estimated cycle length
+#define SYNCSERVO_MEAN_SHIFT            4       ///< Weight of a sample in the mean absolute error (1 / 2^n)
+#define SYNCSERVO_MAX_DRIFT_SHIFT       6       ///< Maximum deviation of the estimated cycle length (1 / 2^n)
+#define SYNCSERVO_ACQ_KP_SHIFT          1       ///< Proportional gain during the acquisition (1 / 2^n)
+#define SYNCSERVO_ACQ_KI_SHIFT          3       ///< Integral gain during the acquisition (1 / 2^n)
+#define SYNCSERVO_OUTLIER_RESTART       4       ///< Consecutive outliers which restart the acquisition
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static INT32 scaleTicks(INT32 ticks_p, UINT32 tickNs_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize sync servo
+
+The function initializes a sync servo for the specified cycle length. The
+statistics are cleared and the next sync error starts the acquisition.
+
+\param  pServo_p            Pointer to the sync servo.
+\param  period_p            Configured cycle length in ticks.
+\param  outlierLimit_p      Sync errors in ticks above this limit are ignored
+                            after the acquisition. 0 disables the outlier
+                            rejection.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+void syncservo_init(tSyncServo* pServo_p, UINT32 period_p, UINT32 outlierLimit_p)
+{
+    OPLK_MEMSET(pServo_p, 0, sizeof(*pServo_p));
+
+    pServo_p->nominalPeriod = period_p;
+    pServo_p->period = period_p;
+    pServo_p->periodFraction = (INT64)period_p << SYNCSERVO_FRACTION_SHIFT;
+    pServo_p->outlierLimit = outlierLimit_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Restart acquisition
+
+The function restarts the acquisition of the sync servo, e.g. after the sync
+timer was stopped. The estimated cycle length is kept.
+
+\param  pServo_p            Pointer to the sync servo.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+void syncservo_restart(tSyncServo* pServo_p)
+{
+    pServo_p->outlierSequence = 0;
+    pServo_p->statistics.fLocked = FALSE;
+    pServo_p->statistics.sampleCount = 0;
+    pServo_p->statistics.acquisitionCount++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update sync servo
+
+The function passes a new sync error to the sync servo. The error is the
+difference between the reception time of the SoC and the time predicted for
+it, i.e. it is positive if the SoC was received late. The function updates the
+estimated cycle length and returns the phase correction of the next sync
+event.
+
+\param  pServo_p            Pointer to the sync servo.
+\param  error_p             Sync error in ticks.
+
+\return The function returns the phase correction in ticks.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+INT32 syncservo_update(tSyncServo* pServo_p, INT32 error_p)
+{
+    tSyncServoStatistics*   pStatistics = &pServo_p->statistics;
+    BOOL                    fAcquisition;
+    UINT32                  absError;
+    UINT                    kpShift;
+    UINT                    kiShift;
+    INT64                   nominalFraction;
+    INT64                   maxDrift;
+
+    absError = (error_p < 0) ? (UINT32)(-(INT64)error_p) : (UINT32)error_p;
+    fAcquisition = (pStatistics->sampleCount < CONFIG_SYNCTIMER_ACQUISITION_CYCLES);
+
+    if ((!fAcquisition) && (pServo_p->outlierLimit != 0) && (absError > pServo_p->outlierLimit))
+    {
+        pStatistics->outlierCount++;
+        pServo_p->outlierSequence++;
+        if (pServo_p->outlierSequence < SYNCSERVO_OUTLIER_RESTART)
+            return 0;
+
+        // The SoC timing of the MN has changed permanently, lock in again
+        syncservo_restart(pServo_p);
+        fAcquisition = TRUE;
+    }
+    pServo_p->outlierSequence = 0;
+
+    if (fAcquisition)
+    {
+        kpShift = SYNCSERVO_ACQ_KP_SHIFT;
+        kiShift = SYNCSERVO_ACQ_KI_SHIFT;
+    }
+    else
+    {
+        kpShift = CONFIG_SYNCTIMER_KP_SHIFT;
+        kiShift = CONFIG_SYNCTIMER_KI_SHIFT;
+    }
+
+    // Integral part: estimate the cycle length of the MN
+    pServo_p->periodFraction += ((INT64)error_p * (1 << SYNCSERVO_FRACTION_SHIFT)) >> kiShift;
+
+    nominalFraction = (INT64)pServo_p->nominalPeriod << SYNCSERVO_FRACTION_SHIFT;
+    maxDrift = nominalFraction >> SYNCSERVO_MAX_DRIFT_SHIFT;
+    if (pServo_p->periodFraction > nominalFraction + maxDrift)
+        pServo_p->periodFraction = nominalFraction + maxDrift;
+    else if (pServo_p->periodFraction < nominalFraction - maxDrift)
+        pServo_p->periodFraction = nominalFraction - maxDrift;
+
+    pServo_p->period = (UINT32)(pServo_p->periodFraction >> SYNCSERVO_FRACTION_SHIFT);
+
+    pStatistics->sampleCount++;
+    pStatistics->lastError = error_p;
+    if (!fAcquisition)
+    {
+        if (!pStatistics->fLocked)
+        {
+            pStatistics->fLocked = TRUE;
+            pStatistics->minError = error_p;
+            pStatistics->maxError = error_p;
+            pServo_p->absErrorFraction = (UINT64)absError << SYNCSERVO_MEAN_SHIFT;
+        }
+        else
+        {
+            if (error_p < pStatistics->minError)
+                pStatistics->minError = error_p;
+            if (error_p > pStatistics->maxError)
+                pStatistics->maxError = error_p;
+            pServo_p->absErrorFraction += absError;
+            pServo_p->absErrorFraction -= pServo_p->absErrorFraction >> SYNCSERVO_MEAN_SHIFT;
+        }
+    }
+
+    // Proportional part: correct the phase of the next sync event
+    return error_p / (1 << kpShift);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Count rejected SoC
+
+The function counts a SoC which was rejected by the sync timer because it was
+received too late, i.e. after a loss of sync.
+
+\param  pServo_p            Pointer to the sync servo.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+void syncservo_reject(tSyncServo* pServo_p)
+{
+    pServo_p->statistics.rejectedCount++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get sync servo statistics
+
+The function copies the statistics of the sync servo and converts the times
+from ticks of the sync timer to nanoseconds.
+
+\param  pServo_p            Pointer to the sync servo.
+\param  tickNs_p            Duration of a tick in nanoseconds.
+\param  pStatistics_p       Pointer to store the statistics.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+void syncservo_getStatistics(const tSyncServo* pServo_p, UINT32 tickNs_p,
+                             tSyncServoStatistics* pStatistics_p)
+{
+    INT64   deviation;
+
+    *pStatistics_p = pServo_p->statistics;
+
+    pStatistics_p->lastError = scaleTicks(pServo_p->statistics.lastError, tickNs_p);
+    pStatistics_p->minError = scaleTicks(pServo_p->statistics.minError, tickNs_p);
+    pStatistics_p->maxError = scaleTicks(pServo_p->statistics.maxError, tickNs_p);
+    pStatistics_p->meanAbsError = (UINT32)((pServo_p->absErrorFraction >> SYNCSERVO_MEAN_SHIFT) * tickNs_p);
+    pStatistics_p->period = pServo_p->period * tickNs_p;
+
+    if (pServo_p->nominalPeriod != 0)
+    {
+        deviation = pServo_p->periodFraction - ((INT64)pServo_p->nominalPeriod << SYNCSERVO_FRACTION_SHIFT);
+        pStatistics_p->drift = (INT32)((deviation * 1000000000LL / pServo_p->nominalPeriod) /
+                                       (1 << SYNCSERVO_FRACTION_SHIFT));
+    }
+    else
+    {
+        pStatistics_p->drift = 0;
+    }
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Convert ticks to nanoseconds
+
+The function converts a signed time from ticks of the sync timer to
+nanoseconds.
+
+\param  ticks_p             Time in ticks.
+\param  tickNs_p            Duration of a tick in nanoseconds.
+
+\return The function returns the time in nanoseconds.
+*/
+//------------------------------------------------------------------------------
+static INT32 scaleTicks(INT32 ticks_p, UINT32 tickNs_p)
+{
+    return (INT32)((INT64)ticks_p * (INT64)tickNs_p);
+}
+
+/// \}
@@ -0,0 +1,787 @@
+/**
+********************************************************************************
+\file   synctimer-linuxuser.c
+
+\brief  Implementation of the Linux userspace synchronization timer module
+
+This file contains the implementation of the synchronization timer module for
+Linux userspace CNs. It is the software counterpart of the openMAC
+synchronization timer: The sync, loss of sync and second loss of sync timers
+are served by a single thread which waits on a timerfd armed with absolute
+CLOCK_MONOTONIC deadlines. The sync timer is locked to the received SoC frames
+by the sync servo.
+
+The SoC is time stamped with the receive time stamp of the Ethernet driver.
+The pcap and raw socket drivers pass the time when the kernel received the
+frame, so the phase estimation is not affected by the scheduling latency of
+the receive thread. If a driver provides no time stamp, the SoC is time
+stamped with target_getCurrentTimestamp() when it is passed to the module and
+the sync error statistics contain the latency jitter of the receive path.
+
+\ingroup module_synctimer
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <kernel/synctimer.h>
+#include <kernel/syncservo.h>
+#include <common/target.h>
+
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/timerfd.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+#ifndef CONFIG_THREAD_PRIORITY_SYNCTIMER
+#define CONFIG_THREAD_PRIORITY_SYNCTIMER    CONFIG_THREAD_PRIORITY_HIGH
+#endif
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define TIMER_HDL_SYNC          0
+#define TIMER_HDL_LOSSOFSYNC    1
+#define TIMER_HDL_LOSSOFSYNC2   2
+#define TIMER_HDL_INVALID       0xFF
+#define TIMER_COUNT             3
+
+#define BUSY_WAIT_TIME          ((ULONGLONG)CONFIG_HRESTIMER_BUSY_WAIT_US * 1000ULL)
+#define RX_LATENCY_MAX          1000000000UL    ///< Receive time stamps older than 1 s are invalid
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+typedef struct
+{
+    ULONGLONG   absoluteTime;
+    BOOL        fEnable;
+} tTimerInfo;
+
+typedef struct
+{
+    tSyncTimerCbSync            pfnSyncCb;
+    UINT32                      lossOfSyncTolerance;
+    tSyncTimerCbLossOfSync      pfnLossOfSyncCb;
+    UINT32                      lossOfSyncTimeout;
+    UINT32                      lossOfSyncTolerance2;
+    tSyncTimerCbLossOfSync      pfnLossOfSync2Cb;
+    UINT32                      lossOfSyncTimeout2;
+    // synctimer ctrl specific
+    BOOL                        fRun;
+    UINT32                      cycleLen;
+    UINT32                      advanceShift;
+    UINT32                      rejectThreshold;
+    ULONGLONG                   targetSyncTime;
+    ULONGLONG                   previousSyncTime;
+    tSyncServo                  servo;
+    // synctimer drv specific
+    tTimerInfo                  aTimerInfo[TIMER_COUNT];
+    int                         timerFd;
+    pthread_t                   threadId;
+    pthread_mutex_t             mutex;
+    BOOL                        fTerminate;
+} tTimerInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tTimerInstance   instance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void ctrlDoSyncAdjustment(ULONGLONG timeStamp_p);
+static void ctrlUpdateRejectThreshold(void);
+static void* timerThread(void* pArgument_p);
+static UINT drvFindShortestTimer(void);
+static void drvConfigureShortestTimer(void);
+static void drvArmTimerFd(ULONGLONG expireTime_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Synchronization timer module initialization
+
+This function initializes the synchronization timer module. It creates the
+timerfd and the timer thread. The thread is scheduled with SCHED_FIFO and the
+priority CONFIG_THREAD_PRIORITY_SYNCTIMER and is pinned to the CPUs in
+CONFIG_THREAD_CPU_MASK_HRTIMER.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+tOplkError synctimer_addInstance(void)
+{
+    OPLK_MEMSET(&instance_l, 0, sizeof(instance_l));
+
+    instance_l.timerFd = timerfd_create(CLOCK_MONOTONIC, 0);
+    if (instance_l.timerFd < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Couldn't create timerfd!\n", __func__);
+        return kErrorNoResource;
+    }
+
+    if (pthread_mutex_init(&instance_l.mutex, NULL) != 0)
+    {
+        close(instance_l.timerFd);
+        return kErrorNoResource;
+    }
+
+    if (target_createThread(&instance_l.threadId, kThreadRoleSyncTimer, "oplk-synctimer",
+                            timerThread, NULL) != kErrorOk)
+    {
+        pthread_mutex_destroy(&instance_l.mutex);
+        close(instance_l.timerFd);
+        return kErrorNoResource;
+    }
+
+    if (target_setThreadParams(instance_l.threadId, kThreadRoleSyncTimer, kThreadSchedFifo,
+                               CONFIG_THREAD_PRIORITY_SYNCTIMER,
+                               CONFIG_THREAD_CPU_MASK_HRTIMER) != kErrorOk)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Couldn't set thread scheduling parameters!\n", __func__);
+        synctimer_delInstance();
+        return kErrorNoResource;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Synchronization timer delete module
+
+This function deletes the synchronization timer module. It terminates the
+timer thread and frees its resources.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+tOplkError synctimer_delInstance(void)
+{
+    pthread_mutex_lock(&instance_l.mutex);
+    instance_l.fTerminate = TRUE;
+    // send exit signal to the thread by an immediate expiration
+    drvArmTimerFd(1);
+    pthread_mutex_unlock(&instance_l.mutex);
+
+    pthread_join(instance_l.threadId, NULL);
+
+    pthread_mutex_destroy(&instance_l.mutex);
+    close(instance_l.timerFd);
+
+    OPLK_MEMSET(&instance_l, 0, sizeof(instance_l));
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Synchronization timer register synchronization handler
+
+This function registers the synchronization handler callback.
+
+\param  pfnSyncCb_p     Synchronization callback
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+tOplkError synctimer_registerHandler(tSyncTimerCbSync pfnSyncCb_p)
+{
+    instance_l.pfnSyncCb = pfnSyncCb_p;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Synchronization timer register loss of synchronization handler
+
+This function registers the loss of synchronization handler callback.
+
+\param  pfnLossOfSyncCb_p   Loss of synchronization callback
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+tOplkError synctimer_registerLossOfSyncHandler(tSyncTimerCbLossOfSync pfnLossOfSyncCb_p)
+{
+    instance_l.pfnLossOfSyncCb = pfnLossOfSyncCb_p;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Synchronization timer register second synchronization handler
+
+This function registers the second synchronization handler callback.
+
+\param  pfnLossOfSync2Cb_p  Second synchronization callback
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+tOplkError synctimer_registerLossOfSyncHandler2(tSyncTimerCbLossOfSync pfnLossOfSync2Cb_p)
+{
+    instance_l.pfnLossOfSync2Cb = pfnLossOfSync2Cb_p;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Synchronization timer shift setter
+
+This function sets the negative time shift.
+
+\param  advanceShift_p      Time shift in microseconds
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+tOplkError synctimer_setSyncShift(UINT32 advanceShift_p)
+{
+    pthread_mutex_lock(&instance_l.mutex);
+    instance_l.advanceShift = advanceShift_p * 1000;
+    pthread_mutex_unlock(&instance_l.mutex);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Synchronization timer cycle time
+
+This function sets the cycle time and restarts the sync servo.
+
+\param  cycleLen_p      Cycle time in microseconds
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+tOplkError synctimer_setCycleLen(UINT32 cycleLen_p)
+{
+    pthread_mutex_lock(&instance_l.mutex);
+    instance_l.cycleLen = cycleLen_p * 1000;
+    syncservo_init(&instance_l.servo, instance_l.cycleLen, CONFIG_SYNCTIMER_OUTLIER_LIMIT);
+    ctrlUpdateRejectThreshold();
+    pthread_mutex_unlock(&instance_l.mutex);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Synchronization timer loss of synchronization setter
+
+This function sets the loss of synchronization tolerance.
+
+\param  lossOfSyncTolerance_p   Loss of sync tolerance in nanoseconds
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+tOplkError synctimer_setLossOfSyncTolerance(UINT32 lossOfSyncTolerance_p)
+{
+    pthread_mutex_lock(&instance_l.mutex);
+    instance_l.lossOfSyncTolerance = lossOfSyncTolerance_p;
+    ctrlUpdateRejectThreshold();
+    pthread_mutex_unlock(&instance_l.mutex);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Synchronization timer second loss of synchronization setter
+
+This function sets the loss of synchronization tolerance.
+
+\param  lossOfSyncTolerance2_p      Second loss of sync tolerance in nanoseconds
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+tOplkError synctimer_setLossOfSyncTolerance2(UINT32 lossOfSyncTolerance2_p)
+{
+    pthread_mutex_lock(&instance_l.mutex);
+
+    instance_l.lossOfSyncTolerance2 = lossOfSyncTolerance2_p;
+
+    if (lossOfSyncTolerance2_p > 0)
+        instance_l.lossOfSyncTimeout2 = instance_l.cycleLen + lossOfSyncTolerance2_p;
+    else
+        instance_l.lossOfSyncTimeout2 = 0;
+
+    pthread_mutex_unlock(&instance_l.mutex);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Synchronization timer trigger setter
+
+This function passes a received SoC to the module. It restarts the loss of
+sync timers and adjusts the sync timer.
+
+\param  pTimeStamp_p    Receive time stamp of the SoC, i.e. the lower 32 bit
+                        of a target_getCurrentTimestamp() value. If it is NULL
+                        the current time is used instead.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+tOplkError synctimer_syncTriggerAtTimeStamp(tTimestamp* pTimeStamp_p)
+{
+    ULONGLONG   timeStamp;
+    UINT32      rxLatency;
+
+    timeStamp = target_getCurrentTimestamp();
+    if (pTimeStamp_p != NULL)
+    {   // extend the receive time stamp to 64 bit, it lies in the past
+        rxLatency = (UINT32)timeStamp - (UINT32)pTimeStamp_p->timeStamp;
+        if (rxLatency < RX_LATENCY_MAX)
+            timeStamp -= rxLatency;
+    }
+
+    pthread_mutex_lock(&instance_l.mutex);
+
+    if (instance_l.cycleLen != 0)
+    {
+        instance_l.aTimerInfo[TIMER_HDL_LOSSOFSYNC].absoluteTime = timeStamp + instance_l.lossOfSyncTimeout;
+        instance_l.aTimerInfo[TIMER_HDL_LOSSOFSYNC].fEnable = TRUE;
+
+        if (instance_l.lossOfSyncTimeout2 > 0)
+        {
+            instance_l.aTimerInfo[TIMER_HDL_LOSSOFSYNC2].absoluteTime = timeStamp + instance_l.lossOfSyncTimeout2;
+            instance_l.aTimerInfo[TIMER_HDL_LOSSOFSYNC2].fEnable = TRUE;
+        }
+
+        ctrlDoSyncAdjustment(timeStamp);
+    }
+
+    pthread_mutex_unlock(&instance_l.mutex);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Stop synchronization timer module
+
+This function stops the module.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+tOplkError synctimer_stopSync(void)
+{
+    UINT    timerHdl;
+
+    pthread_mutex_lock(&instance_l.mutex);
+
+    instance_l.fRun = FALSE;
+    for (timerHdl = 0; timerHdl < TIMER_COUNT; timerHdl++)
+        instance_l.aTimerInfo[timerHdl].fEnable = FALSE;
+
+    drvConfigureShortestTimer();
+
+    pthread_mutex_unlock(&instance_l.mutex);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Enable second sync interrupt
+
+The external sync interrupt is not available on Linux, therefore the function
+does nothing.
+
+\param  syncIntCycle_p      Trigger external sync int every nth cycle
+\param  pulseWidth_p        Pulse width of external sync interrupt in nanoseconds.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+void synctimer_enableExtSyncIrq(UINT32 syncIntCycle_p, UINT32 pulseWidth_p)
+{
+    UNUSED_PARAMETER(syncIntCycle_p);
+    UNUSED_PARAMETER(pulseWidth_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Disable second sync interrupt
+
+The external sync interrupt is not available on Linux, therefore the function
+does nothing.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+void synctimer_disableExtSyncIrq(void)
+{
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get sync statistics
+
+This function copies the statistics of the sync servo.
+
+\param  pStatistics_p   Pointer to store the statistics
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+tOplkError synctimer_getStatistics(tSyncServoStatistics* pStatistics_p)
+{
+    pthread_mutex_lock(&instance_l.mutex);
+    syncservo_getStatistics(&instance_l.servo, 1, pStatistics_p);
+    pthread_mutex_unlock(&instance_l.mutex);
+
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Adjust the synchronization
+
+This function adjusts the sync timer to a received SoC with the sync servo.
+The caller must hold the mutex of the module.
+
+\param  timeStamp_p     Time stamp of the SoC
+*/
+//------------------------------------------------------------------------------
+static void ctrlDoSyncAdjustment(ULONGLONG timeStamp_p)
+{
+    tTimerInfo* pTimerInfo = &instance_l.aTimerInfo[TIMER_HDL_SYNC];
+    ULONGLONG   timeDiff;
+    INT64       deviation;
+    INT32       correction;
+    BOOL        fCurrentSyncPending;
+
+    timeStamp_p -= instance_l.advanceShift;
+
+    if (instance_l.fRun != FALSE)
+    {
+        timeDiff = timeStamp_p - instance_l.previousSyncTime;
+        if (timeDiff >= instance_l.rejectThreshold)
+        {   // adjust target sync time, because of Loss of Sync
+            syncservo_reject(&instance_l.servo);
+            for (; timeDiff >= instance_l.rejectThreshold; timeDiff -= instance_l.servo.period)
+                instance_l.targetSyncTime += instance_l.servo.period;
+        }
+
+        deviation = (INT64)(timeStamp_p - instance_l.targetSyncTime);
+        if (deviation > (INT64)instance_l.rejectThreshold)
+            deviation = instance_l.rejectThreshold;
+        else if (deviation < -(INT64)instance_l.rejectThreshold)
+            deviation = -(INT64)instance_l.rejectThreshold;
+
+        correction = syncservo_update(&instance_l.servo, (INT32)deviation);
+
+        // the sync timer is still pending for the current SoC if it was not
+        // advanced by the timer thread yet
+        fCurrentSyncPending = (pTimerInfo->absoluteTime == instance_l.targetSyncTime);
+
+        pTimerInfo->absoluteTime = (ULONGLONG)((INT64)pTimerInfo->absoluteTime + correction);
+        instance_l.targetSyncTime = pTimerInfo->absoluteTime;
+        if (fCurrentSyncPending)
+        {   // set target to next sync
+            instance_l.targetSyncTime += instance_l.servo.period;
+        }
+    }
+    else
+    {   // first trigger
+        syncservo_restart(&instance_l.servo);
+        instance_l.targetSyncTime = timeStamp_p + instance_l.servo.period;
+        instance_l.fRun = TRUE;
+
+        pTimerInfo->absoluteTime = instance_l.targetSyncTime;
+    }
+
+    pTimerInfo->fEnable = TRUE;
+    instance_l.previousSyncTime = timeStamp_p;
+
+    drvConfigureShortestTimer();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update reject threshold
+
+This function updates the reject threshold and the loss of sync timeout. The
+caller must hold the mutex of the module.
+*/
+//------------------------------------------------------------------------------
+static void ctrlUpdateRejectThreshold(void)
+{
+    UINT32  maxRejectThreshold;
+
+    maxRejectThreshold = instance_l.cycleLen >> 1;  // half of cycle length
+
+    instance_l.rejectThreshold = instance_l.cycleLen;
+
+    if (instance_l.lossOfSyncTolerance > maxRejectThreshold)
+        instance_l.rejectThreshold += maxRejectThreshold;
+    else
+        instance_l.rejectThreshold += instance_l.lossOfSyncTolerance;
+
+    instance_l.lossOfSyncTimeout = instance_l.cycleLen + instance_l.lossOfSyncTolerance;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Timer thread function
+
+The function implements the timer thread. It waits for the expiration of the
+timerfd, advances the expired timer and calls its callback.
+
+\param  pArgument_p     Thread argument (not used)
+
+\return The function returns NULL.
+*/
+//------------------------------------------------------------------------------
+static void* timerThread(void* pArgument_p)
+{
+    UINT64                  expirations;
+    ULONGLONG               now;
+    ULONGLONG               deadline;
+    UINT                    timerHdl;
+    tTimerInfo*             pTimerInfo;
+    tSyncTimerCbSync        pfnCallback;
+
+    UNUSED_PARAMETER(pArgument_p);
+
+    while (1)
+    {
+        if (read(instance_l.timerFd, &expirations, sizeof(expirations)) < 0)
+        {   // interrupted by a signal
+            continue;
+        }
+
+        pthread_mutex_lock(&instance_l.mutex);
+
+        if (instance_l.fTerminate)
+        {
+            pthread_mutex_unlock(&instance_l.mutex);
+            break;
+        }
+
+        now = target_getCurrentTimestamp();
+        timerHdl = drvFindShortestTimer();
+        if ((timerHdl == TIMER_HDL_INVALID) ||
+            (now + BUSY_WAIT_TIME < instance_l.aTimerInfo[timerHdl].absoluteTime))
+        {   // timer was deleted or modified after the timerfd expired
+            drvConfigureShortestTimer();
+            pthread_mutex_unlock(&instance_l.mutex);
+            continue;
+        }
+
+        pTimerInfo = &instance_l.aTimerInfo[timerHdl];
+        deadline = pTimerInfo->absoluteTime;
+
+        switch (timerHdl)
+        {
+            case TIMER_HDL_SYNC:
+                pfnCallback = instance_l.pfnSyncCb;
+                pTimerInfo->absoluteTime += instance_l.servo.period;
+                while ((pTimerInfo->absoluteTime <= now) && (instance_l.servo.period != 0))
+                {   // skip missed cycles but keep the cycle phase
+                    pTimerInfo->absoluteTime += instance_l.servo.period;
+                }
+                break;
+
+            case TIMER_HDL_LOSSOFSYNC:
+                pfnCallback = instance_l.pfnLossOfSyncCb;
+                pTimerInfo->absoluteTime += instance_l.cycleLen;
+                break;
+
+            default:
+                pfnCallback = instance_l.pfnLossOfSync2Cb;
+                pTimerInfo->fEnable = FALSE;
+                break;
+        }
+
+        drvConfigureShortestTimer();
+
+        pthread_mutex_unlock(&instance_l.mutex);
+
+        while (now < deadline)
+        {   // poll the clock for the rest of the time
+            now = target_getCurrentTimestamp();
+        }
+
+        if (pfnCallback != NULL)
+            pfnCallback();
+    }
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find shortest due timer
+
+This function searches for the next timer that shall expire. The caller must
+hold the mutex of the module.
+
+\return The function returns the next due timer handle.
+*/
+//------------------------------------------------------------------------------
+static UINT drvFindShortestTimer(void)
+{
+    UINT    targetTimerHdl = TIMER_HDL_INVALID;
+    UINT    timerHdl;
+
+    for (timerHdl = 0; timerHdl < TIMER_COUNT; timerHdl++)
+    {
+        if ((instance_l.aTimerInfo[timerHdl].fEnable != FALSE) &&
+            ((targetTimerHdl == TIMER_HDL_INVALID) ||
+             (instance_l.aTimerInfo[timerHdl].absoluteTime <
+              instance_l.aTimerInfo[targetTimerHdl].absoluteTime)))
+        {
+            targetTimerHdl = timerHdl;
+        }
+    }
+
+    return targetTimerHdl;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Configure shortest due timer
+
+This function arms the timerfd for the next due timer. The caller must hold the
+mutex of the module.
+*/
+//------------------------------------------------------------------------------
+static void drvConfigureShortestTimer(void)
+{
+    UINT        timerHdl;
+    ULONGLONG   expireTime;
+
+    timerHdl = drvFindShortestTimer();
+    if (timerHdl == TIMER_HDL_INVALID)
+    {
+        drvArmTimerFd(0);
+        return;
+    }
+
+    expireTime = instance_l.aTimerInfo[timerHdl].absoluteTime;
+    if (expireTime > BUSY_WAIT_TIME)
+        expireTime -= BUSY_WAIT_TIME;
+    else
+        expireTime = 1;
+
+    drvArmTimerFd(expireTime);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Arm timerfd
+
+The function arms the timerfd with an absolute expiration time.
+
+\param  expireTime_p    Absolute CLOCK_MONOTONIC expiration time in ns. A value
+                        of 0 disarms the timerfd.
+*/
+//------------------------------------------------------------------------------
+static void drvArmTimerFd(ULONGLONG expireTime_p)
+{
+    struct itimerspec   absTime;
+
+    OPLK_MEMSET(&absTime, 0, sizeof(absTime));
+    absTime.it_value.tv_sec = (time_t)(expireTime_p / 1000000000ULL);
+    absTime.it_value.tv_nsec = (long)(expireTime_p % 1000000000ULL);
+
+    timerfd_settime(instance_l.timerFd, TFD_TIMER_ABSTIME, &absTime, NULL);
+}
+
+/// \}
@@ -44,10 +44,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/oplkinc.h>
 
 #include <kernel/synctimer.h>
+#if (CONFIG_SYNCTIMER_PI_SERVO != FALSE)
+#include <kernel/syncservo.h>
+#endif
 #include <target/openmac.h>
 #include <omethlib.h>
 
 #include <oplk/benchmark.h>
+#include <common/target.h>
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -124,6 +128,9 @@ typedef struct
     UINT32                      rejectThreshold;
     UINT32                      targetSyncTime;
     UINT32                      previousSyncTime;
+#if (CONFIG_SYNCTIMER_PI_SERVO != FALSE)
+    tSyncServo                  servo;
+#endif
     // synctimer drv specific
     tTimerInfo                  aTimerInfo[TIMER_COUNT];
     UINT                        activeTimerHdl;
@@ -511,6 +518,40 @@ void synctimer_disableExtSyncIrq(void)
 }
 #endif //TIMER_USE_EXT_SYNC_INT
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get sync statistics
+
+This function copies the statistics of the sync servo. The statistics are only
+available if the module is compiled with CONFIG_SYNCTIMER_PI_SERVO.
+
+\param  pStatistics_p   Pointer to store the statistics
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_synctimer
+*/
+//------------------------------------------------------------------------------
+tOplkError synctimer_getStatistics(tSyncServoStatistics* pStatistics_p)
+{
+#if (CONFIG_SYNCTIMER_PI_SERVO != FALSE)
+    tSyncServo  servo;
+
+    // copy the servo atomically, it is updated in interrupt context
+    target_enableGlobalInterrupt(FALSE);
+    servo = instance_l.servo;
+    target_enableGlobalInterrupt(TRUE);
+
+    syncservo_getStatistics(&servo, OMETH_TICKS_2_NS(1), pStatistics_p);
+
+    return kErrorOk;
+#else
+    UNUSED_PARAMETER(pStatistics_p);
+
+    return kErrorApiNotSupported;
+#endif
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -545,7 +586,12 @@ static tOplkError ctrlDoSyncAdjustment(UINT32 timeStamp_p)
 
         deviation = timeStamp_p - instance_l.targetSyncTime;
 
+#if (CONFIG_SYNCTIMER_PI_SERVO != FALSE)
+        deviation = syncservo_update(&instance_l.servo, deviation);
+        instance_l.meanTimeDiff = instance_l.servo.period;
+#else
         deviation = deviation >> PROPORTIONAL_FRACTION_SHIFT;
+#endif
 
         ret = drvModifyTimerRel(TIMER_HDL_SYNC, deviation, &instance_l.targetSyncTime, &fCurrentSyncModified);
 
@@ -556,6 +602,9 @@ static tOplkError ctrlDoSyncAdjustment(UINT32 timeStamp_p)
     }
     else
     {   // first trigger
+#if (CONFIG_SYNCTIMER_PI_SERVO != FALSE)
+        syncservo_restart(&instance_l.servo);
+#endif
         instance_l.targetSyncTime = timeStamp_p + instance_l.meanTimeDiff;
         instance_l.fRun = TRUE;
 
@@ -591,6 +640,9 @@ static void ctrlAddActualTimeDiff(UINT32 actualTimeDiff_p)
     }
     else
     {   // adjust target sync time, because of Loss of Sync
+#if (CONFIG_SYNCTIMER_PI_SERVO != FALSE)
+        syncservo_reject(&instance_l.servo);
+#endif
         for (; actualTimeDiff_p >= instance_l.rejectThreshold;
              actualTimeDiff_p -= instance_l.meanTimeDiff,
              instance_l.targetSyncTime += instance_l.meanTimeDiff)
@@ -643,6 +695,11 @@ static void ctrlSetConfiguredTimeDiff(UINT32 configuredTimeDiff_p)
 
     instance_l.meanTimeDiff = configuredTimeDiff_p;
 
+#if (CONFIG_SYNCTIMER_PI_SERVO != FALSE)
+    syncservo_init(&instance_l.servo, configuredTimeDiff_p,
+                   OMETH_NS_2_TICKS(CONFIG_SYNCTIMER_OUTLIER_LIMIT));
+#endif
+
     ctrlUpdateRejectThreshold();
 }
 
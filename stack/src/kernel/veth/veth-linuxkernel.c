@@ -92,7 +92,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
-
+#define VETH_NAPI_WEIGHT            16      // max. number of frames delivered per NAPI poll
+#define VETH_RX_QUEUE_SIZE          64      // max. number of frames waiting for the NAPI poll
 
 //------------------------------------------------------------------------------
 // local types
@@ -103,6 +104,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // local vars
 //------------------------------------------------------------------------------
 static struct net_device* pVEthNetDevice_g = NULL;
+static struct napi_struct vethNapi_l;
+static struct sk_buff_head vethRxQueue_l;
 
 //------------------------------------------------------------------------------
 // local function prototypes
@@ -113,6 +116,7 @@ static int veth_xmit(struct sk_buff* pSkb_p, struct net_device* pNetDevice_p);
 static struct net_device_stats* veth_getStats(struct net_device* pNetDevice_p);
 static void veth_timeout(struct net_device* pNetDevice_p);
 static tOplkError veth_receiveFrame(tFrameInfo* pFrameInfo_p);
+static int veth_poll(struct napi_struct* pNapi_p, int budget_p);
 
 //------------------------------------------------------------------------------
 // local vars
@@ -162,6 +166,10 @@ tOplkError veth_addInstance(const UINT8 aSrcMac_p[6])
     // copy own MAC address to net device structure
     OPLK_MEMCPY(pVEthNetDevice_g->dev_addr, aSrcMac_p, 6);
 
+    // received frames are delivered in batches by the NAPI poll function
+    skb_queue_head_init(&vethRxQueue_l);
+    netif_napi_add(pVEthNetDevice_g, &vethNapi_l, veth_poll, VETH_NAPI_WEIGHT);
+
     //register VEth to the network subsystem
     if (register_netdev(pVEthNetDevice_g))
         DEBUG_LVL_VETH_TRACE("veth_addInstance: Could not register VEth...\n");
@@ -186,6 +194,8 @@ tOplkError veth_delInstance(void)
 {
     if (pVEthNetDevice_g != NULL)
     {
+        netif_napi_del(&vethNapi_l);
+
         //unregister VEth from the network subsystem
         unregister_netdev(pVEthNetDevice_g);
         // destructor was set to free_netdev,
@@ -196,6 +206,38 @@ tOplkError veth_delInstance(void)
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get virtual Ethernet statistics
+
+The function returns the frame counters of the virtual Ethernet interface.
+
+\param  pStatistics_p   Pointer to store the statistics.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_veth
+*/
+//------------------------------------------------------------------------------
+tOplkError veth_getStatistics(tVethStatistics* pStatistics_p)
+{
+    struct net_device_stats* pStats;
+
+    if ((pStatistics_p == NULL) || (pVEthNetDevice_g == NULL))
+        return kErrorInvalidInstanceParam;
+
+    pStats = netdev_priv(pVEthNetDevice_g);
+    pStatistics_p->txFrames = pStats->tx_packets;
+    pStatistics_p->txBytes = pStats->tx_bytes;
+    pStatistics_p->txRetries = pStats->tx_fifo_errors;
+    pStatistics_p->txDropped = pStats->tx_dropped;
+    pStatistics_p->rxFrames = pStats->rx_packets;
+    pStatistics_p->rxBytes = pStats->rx_bytes;
+    pStatistics_p->rxDropped = pStats->rx_dropped;
+
+    return kErrorOk;
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -218,6 +260,8 @@ static int veth_open(struct net_device* pNetDevice_p)
     tOplkError  ret = kErrorOk;
 
     //open the device
+    napi_enable(&vethNapi_l);
+
     //start the interface queue for the network subsystem
     netif_start_queue(pNetDevice_p);
 
@@ -245,6 +289,9 @@ static int veth_close(struct net_device* pNetDevice_p)
 
     dllk_deregAsyncHandler(veth_receiveFrame);
     netif_stop_queue(pNetDevice_p);     //stop the interface queue for the network subsystem
+
+    napi_disable(&vethNapi_l);
+    skb_queue_purge(&vethRxQueue_l);
     return 0;
 }
 
@@ -279,8 +326,11 @@ static int veth_xmit(struct sk_buff* pSkb_p, struct net_device* pNetDevice_p)
     if (ret != kErrorOk)
     {
         DEBUG_LVL_VETH_TRACE("veth_xmit: dllkcal_sendAsyncFrame returned 0x%02X\n", ret);
+        // keep the skb and let the network subsystem requeue it once the
+        // queue is woken up again
         netif_stop_queue(pNetDevice_p);
-        goto Exit;
+        pStats->tx_fifo_errors++;
+        return NETDEV_TX_BUSY;
     }
     else
     {
@@ -292,8 +342,7 @@ static int veth_xmit(struct sk_buff* pSkb_p, struct net_device* pNetDevice_p)
         pStats->tx_bytes += frameInfo.frameSize;
     }
 
-Exit:
-    return 0;
+    return NETDEV_TX_OK;
 }
 
 //------------------------------------------------------------------------------
@@ -336,7 +385,10 @@ static void veth_timeout(struct net_device* pNetDevice_p)
 /**
 \brief  Receive frame from virtual Ethernet interface
 
-The function receives a frame from the virtual Ethernet interface.
+The function receives a frame from the virtual Ethernet interface. It is called
+in the POWERLINK receive context and only queues the frame. The frames are
+passed to the network subsystem by veth_poll() in softirq context, so the
+receive context never runs the IP stack.
 
 \param  pFrameInfo_p        Pointer to frame information of received frame.
 
@@ -352,7 +404,8 @@ static tOplkError veth_receiveFrame(tFrameInfo* pFrameInfo_p)
 
     DEBUG_LVL_VETH_TRACE("veth_receiveFrame: FrameSize=%u\n", pFrameInfo_p->frameSize);
 
-    if ((pSkb = dev_alloc_skb(pFrameInfo_p->frameSize + 2)) == NULL)
+    if ((skb_queue_len(&vethRxQueue_l) >= VETH_RX_QUEUE_SIZE) ||
+        ((pSkb = dev_alloc_skb(pFrameInfo_p->frameSize + 2)) == NULL))
     {
         pStats->rx_dropped++;
         goto Exit;
@@ -366,7 +419,8 @@ static tOplkError veth_receiveFrame(tFrameInfo* pFrameInfo_p)
     pSkb->protocol = eth_type_trans(pSkb, pNetDevice);
     pSkb->ip_summed = CHECKSUM_UNNECESSARY;
 
-    netif_rx(pSkb);         // call netif_rx with skb
+    skb_queue_tail(&vethRxQueue_l, pSkb);
+    napi_schedule(&vethNapi_l);
 
     DEBUG_LVL_VETH_TRACE("veth_receiveFrame: SrcMAC=0x%llx\n", ami_getUint48Be(pFrameInfo_p->pFrame->aSrcMac));
 
@@ -378,5 +432,47 @@ Exit:
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  NAPI poll function of virtual Ethernet driver
+
+The function passes up to \p budget_p queued frames to the network subsystem.
+The frames are delivered with netif_receive_skb() without GRO, as the
+POWERLINK async phase carries only a single frame per cycle. Afterwards the
+transmit queue is woken up if veth_xmit() stopped it because the DLL TX queue
+was full, so that blocked frames are retried together with the RX batch.
+
+\param  pNapi_p         Pointer to NAPI structure.
+\param  budget_p        Maximum number of frames to deliver.
+
+\return The function returns the number of delivered frames.
+*/
+//------------------------------------------------------------------------------
+static int veth_poll(struct napi_struct* pNapi_p, int budget_p)
+{
+    struct sk_buff* pSkb;
+    int             workDone = 0;
+
+    while ((workDone < budget_p) && ((pSkb = skb_dequeue(&vethRxQueue_l)) != NULL))
+    {
+        netif_receive_skb(pSkb);
+        workDone++;
+    }
+
+    if (workDone < budget_p)
+    {
+        napi_complete(pNapi_p);
+
+        // a frame may have been queued after the queue was found empty
+        if (!skb_queue_empty(&vethRxQueue_l))
+            napi_schedule(pNapi_p);
+    }
+
+    if (netif_queue_stopped(pNapi_p->dev))
+        netif_wake_queue(pNapi_p->dev);
+
+    return workDone;
+}
+
 ///\}
 
@@ -61,6 +61,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <kernel/veth.h>
 #include <kernel/dllkcal.h>
 #include <kernel/dllk.h>
+#include <common/target.h>
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -85,7 +86,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
-
+#define VETH_FRAME_BUFFER_SIZE      (ETHER_HDR_LEN + ETHERMTU)
+#define VETH_RX_BATCH_SIZE          16          // max. number of TAP frames read per wakeup
+#define VETH_TX_RETRY_INTERVAL_US   500         // delay between attempts if the async TX queue is full
+#define VETH_TX_RETRY_TIMEOUT_US    100000      // drop a frame if the async TX queue stays full this long
 
 //------------------------------------------------------------------------------
 // local types
@@ -98,6 +102,7 @@ typedef struct
     int                 fd;
     BOOL                fStop;
     pthread_t           threadHandle;
+    tVethStatistics     statistics;
 } tVethInstance;
 
 //------------------------------------------------------------------------------
@@ -112,6 +117,7 @@ static tVethInstance        vethInstance_l;
 static void getMacAdrs(UINT8* pMac_p);
 static tOplkError veth_receiveFrame(tFrameInfo* pFrameInfo_p);
 static void* vethRecvThread(void* pArg_p);
+static void sendAsyncFrame(tVethInstance* pInstance_p, tFrameInfo* pFrameInfo_p);
 
 //------------------------------------------------------------------------------
 // local vars
@@ -157,6 +163,15 @@ tOplkError veth_addInstance(const UINT8 aSrcMac_p[6])
         return err;
     }
 
+    // the receive thread drains all pending frames after each wakeup
+    if (fcntl(vethInstance_l.fd, F_SETFL, fcntl(vethInstance_l.fd, F_GETFL) | O_NONBLOCK) < 0)
+    {
+        DEBUG_LVL_VETH_TRACE("Error setting TAP device to non-blocking mode\n");
+        close(vethInstance_l.fd);
+        return kErrorNoResource;
+    }
+    OPLK_MEMSET(&vethInstance_l.statistics, 0, sizeof(vethInstance_l.statistics));
+
     // save MAC address of TAP device and Ethernet device to be able to
     // exchange them
     OPLK_MEMCPY(vethInstance_l.macAdrs, aSrcMac_p, 6);
@@ -164,12 +179,12 @@ tOplkError veth_addInstance(const UINT8 aSrcMac_p[6])
 
     // start tap receive thread
     vethInstance_l.fStop = FALSE;
-    if (pthread_create(&vethInstance_l.threadHandle, NULL, vethRecvThread, (void*)&vethInstance_l) != 0)
+    if (target_createThread(&vethInstance_l.threadHandle, kThreadRoleVeth, "oplk-veth",
+                            vethRecvThread, (void*)&vethInstance_l) != kErrorOk)
         return kErrorNoFreeInstance;
 
-#if (defined(__GLIBC__) && __GLIBC__ >= 2 && __GLIBC_MINOR__ >= 12)
-    pthread_setname_np(vethInstance_l.threadHandle, "oplk-veth");
-#endif
+    // The receive thread is no realtime thread, it is only placed on request
+    target_setThreadParams(vethInstance_l.threadHandle, kThreadRoleVeth, kThreadSchedDefault, 0, 0);
 
     // register callback function in DLL
     ret = dllk_regAsyncHandler(veth_receiveFrame);
@@ -198,6 +213,28 @@ tOplkError veth_delInstance(void)
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get virtual Ethernet statistics
+
+The function returns the frame counters of the virtual Ethernet interface.
+
+\param  pStatistics_p   Pointer to store the statistics.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_veth
+*/
+//------------------------------------------------------------------------------
+tOplkError veth_getStatistics(tVethStatistics* pStatistics_p)
+{
+    if (pStatistics_p == NULL)
+        return kErrorInvalidInstanceParam;
+
+    OPLK_MEMCPY(pStatistics_p, &vethInstance_l.statistics, sizeof(*pStatistics_p));
+    return kErrorOk;
+}
+
 
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
@@ -258,7 +295,7 @@ The function receives a frame from the virtual Ethernet interface.
 //------------------------------------------------------------------------------
 static tOplkError veth_receiveFrame(tFrameInfo* pFrameInfo_p)
 {
-    UINT            nwrite;
+    ssize_t         nwrite;
 
     // replace the MAC address of the POWERLINK Ethernet interface with virtual
     // Ethernet MAC address before forwarding it into the virtual Ethernet interface
@@ -268,9 +305,15 @@ static tOplkError veth_receiveFrame(tFrameInfo* pFrameInfo_p)
     }
 
     nwrite = write(vethInstance_l.fd, pFrameInfo_p->pFrame, pFrameInfo_p->frameSize);
-    if (nwrite != pFrameInfo_p->frameSize)
+    if (nwrite != (ssize_t)pFrameInfo_p->frameSize)
     {
         DEBUG_LVL_VETH_TRACE("Error writing data to virtual Ethernet interface!\n");
+        vethInstance_l.statistics.rxDropped++;
+    }
+    else
+    {
+        vethInstance_l.statistics.rxFrames++;
+        vethInstance_l.statistics.rxBytes += pFrameInfo_p->frameSize;
     }
     return kErrorOk;
 }
@@ -279,8 +322,9 @@ static tOplkError veth_receiveFrame(tFrameInfo* pFrameInfo_p)
 /**
 \brief  Receive frame from virtual Ethernet interface
 
-The function receives a frame from the virtual Ethernet interface. It is implemented
-to be used as a thread which does a blocking read in a while loop.
+The function receives frames from the virtual Ethernet interface. It is
+implemented to be used as a thread which waits for the TAP device in a while
+loop. After each wakeup it reads up to VETH_RX_BATCH_SIZE frames.
 
 \param  pArg_p        Thread argument. Pointer to virtual ethernet instance.
 
@@ -289,14 +333,14 @@ to be used as a thread which does a blocking read in a while loop.
 //------------------------------------------------------------------------------
 static void* vethRecvThread(void* pArg_p)
 {
-    UINT8               buffer[ETHERMTU];
-    UINT                nread;
+    UINT8               buffer[VETH_FRAME_BUFFER_SIZE];
+    ssize_t             nread;
     tFrameInfo          frameInfo;
-    tOplkError          ret = kErrorOk;
     tVethInstance*      pInstance = (tVethInstance*)pArg_p;
     fd_set              readFds;
     int                 result;
     struct timeval      timeout;
+    UINT                batchCount;
 
     while (!pInstance->fStop)
     {
@@ -318,10 +362,13 @@ static void* vethRecvThread(void* pArg_p)
                 break;
 
             default:    // data from tun/tap ready for read
-                nread = read(pInstance->fd, buffer, ETHERMTU);
-                if (nread > 0)
+                for (batchCount = 0; (batchCount < VETH_RX_BATCH_SIZE) && !pInstance->fStop; batchCount++)
                 {
-                    DEBUG_LVL_VETH_TRACE("VETH:Read %d bytes from the tap interface\n", nread);
+                    nread = read(pInstance->fd, buffer, sizeof(buffer));
+                    if (nread <= 0)
+                        break;  // no more frames pending
+
+                    DEBUG_LVL_VETH_TRACE("VETH:Read %d bytes from the tap interface\n", (int)nread);
                     DEBUG_LVL_VETH_TRACE("SRC MAC: %02X:%02X:%02x:%02X:%02X:%02x\n",
                                           buffer[6], buffer[7], buffer[8], buffer[9], buffer[10], buffer[11]);
                     DEBUG_LVL_VETH_TRACE("DST MAC: %02X:%02X:%02x:%02X:%02X:%02x\n",
@@ -330,12 +377,8 @@ static void* vethRecvThread(void* pArg_p)
                     OPLK_MEMCPY(&buffer[6], pInstance->macAdrs, ETHER_ADDR_LEN);
 
                     frameInfo.pFrame = (tPlkFrame *)buffer;
-                    frameInfo.frameSize = nread;
-                    ret = dllkcal_sendAsyncFrame(&frameInfo, kDllAsyncReqPrioGeneric);
-                    if (ret != kErrorOk)
-                    {
-                        DEBUG_LVL_VETH_TRACE("veth_xmit: dllkcal_sendAsyncFrame returned 0x%02X\n", ret);
-                    }
+                    frameInfo.frameSize = (UINT)nread;
+                    sendAsyncFrame(pInstance, &frameInfo);
                 }
                 break;
         }
@@ -346,5 +389,48 @@ static void* vethRecvThread(void* pArg_p)
     return NULL;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Send frame from virtual Ethernet interface
+
+The function passes a frame read from the TAP device to the DLL. If the async
+TX queue is full, the function waits for the DLL to drain it instead of
+dropping the frame. The TAP device is not read in the meantime, so the host
+network stack is throttled to the async bandwidth of the POWERLINK cycle. If the
+queue stays full for VETH_TX_RETRY_TIMEOUT_US (e.g. no async slots are
+assigned in the current NMT state), the frame is dropped.
+
+\param  pInstance_p     Pointer to virtual ethernet instance.
+\param  pFrameInfo_p    Pointer to frame information of frame to send.
+*/
+//------------------------------------------------------------------------------
+static void sendAsyncFrame(tVethInstance* pInstance_p, tFrameInfo* pFrameInfo_p)
+{
+    tOplkError          ret;
+    UINT                retryCount = 0;
+
+    for (;;)
+    {
+        ret = dllkcal_sendAsyncFrame(pFrameInfo_p, kDllAsyncReqPrioGeneric);
+        if (ret == kErrorOk)
+        {
+            pInstance_p->statistics.txFrames++;
+            pInstance_p->statistics.txBytes += pFrameInfo_p->frameSize;
+            return;
+        }
+
+        if ((ret != kErrorDllAsyncTxBufferFull) || pInstance_p->fStop ||
+            (retryCount >= (VETH_TX_RETRY_TIMEOUT_US / VETH_TX_RETRY_INTERVAL_US)))
+            break;
+
+        retryCount++;
+        pInstance_p->statistics.txRetries++;
+        usleep(VETH_TX_RETRY_INTERVAL_US);
+    }
+
+    DEBUG_LVL_VETH_TRACE("veth_xmit: dllkcal_sendAsyncFrame returned 0x%02X\n", ret);
+    pInstance_p->statistics.txDropped++;
+}
+
 ///\}
 
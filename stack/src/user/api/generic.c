@@ -53,14 +53,30 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <user/sdocom.h>
 #include <user/identu.h>
 #include <user/cfmu.h>
+#include <user/multiplexu.h>
 #include <user/ctrlu.h>
 
 #include <common/target.h>
+#include <common/cyclestat.h>
+#include <common/flightrec.h>
+#include <common/metrics.h>
+
+#if (CONFIG_DLL_PROCESS_SYNC == DLL_PROCESS_SYNC_ON_TIMER)
+#include <kernel/synctimer.h>
+#endif
 
 #if (CONFIG_OBD_USE_LOAD_CONCISEDCF != FALSE)
 #include <oplk/obdcdc.h>
 #endif
 
+#if (CONFIG_OBD_USE_STORE_MMAP != FALSE)
+#include <oplk/obdstore.h>
+#endif
+
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+#include <oplk/obdfile.h>
+#endif
+
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
 //============================================================================//
@@ -102,6 +118,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 static tOplkError cbSdoCon(tSdoComFinished* pSdoComFinished_p);
 #endif
 static tOplkError cbReceivedAsnd(tFrameInfo *pFrameInfo_p);
+static tOplkError transferObjectStream(tSdoComConHdl* pSdoComConHdl_p, UINT nodeId_p, UINT index_p,
+                                       UINT subindex_p, tObdDomainStream* pStream_p, UINT size_p,
+                                       tSdoAccessType accessType_p, tSdoType sdoType_p,
+                                       void* pUserArg_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -138,7 +158,13 @@ tOplkError oplk_init(tOplkApiInitParam* pInitParam_p)
         return ret;
     }
 
-    return ctrlu_initStack(pInitParam_p);
+    ret = ctrlu_initStack(pInitParam_p);
+
+#if (CONFIG_MEMARENA != FALSE)
+    memarena_setInitDone();
+#endif
+
+    return ret;
 }
 
 //------------------------------------------------------------------------------
@@ -271,6 +297,17 @@ tOplkError oplk_linkObject(UINT objIndex_p, void* pVar_p, UINT* pVarEntries_p,
         indexEntries = (UINT8)(varEntries + firstSubindex_p - 1);
     }
 
+    if ((*pEntrySize_p != 0x00) && (indexEntries >= firstSubindex_p))
+    {   // all entries have the same size, link them with a single object lookup
+        usedSize = (tObdSize)((indexEntries - firstSubindex_p) + 1) * *pEntrySize_p;
+        ret = obd_defineVarRange(objIndex_p, firstSubindex_p, (indexEntries - firstSubindex_p) + 1,
+                                 *pEntrySize_p, pData);
+
+        *pVarEntries_p = ((indexEntries - firstSubindex_p) + 1);
+        *pEntrySize_p = usedSize;
+        return ret;
+    }
+
     // map entries
     for (subindex = firstSubindex_p; subindex <= indexEntries; subindex++)
     {
@@ -382,6 +419,9 @@ tOplkError oplk_readObject(tSdoComConHdl* pSdoComConHdl_p, UINT nodeId_p, UINT i
         transParamByIndex.subindex = subindex_p;
         transParamByIndex.pfnSdoFinishedCb = cbSdoCon;
         transParamByIndex.pUserArg = pUserArg_p;
+        transParamByIndex.pStream = NULL;
+        transParamByIndex.paScatterList = NULL;
+        transParamByIndex.scatterEntryCount = 0;
 
         if ((ret = sdocom_initTransferByIndex(&transParamByIndex)) != kErrorOk)
             return ret;
@@ -470,6 +510,9 @@ tOplkError oplk_writeObject(tSdoComConHdl* pSdoComConHdl_p, UINT nodeId_p, UINT
         transParamByIndex.subindex = subindex_p;
         transParamByIndex.pfnSdoFinishedCb = cbSdoCon;
         transParamByIndex.pUserArg = pUserArg_p;
+        transParamByIndex.pStream = NULL;
+        transParamByIndex.paScatterList = NULL;
+        transParamByIndex.scatterEntryCount = 0;
 
         if ((ret = sdocom_initTransferByIndex(&transParamByIndex)) != kErrorOk)
             return ret;
@@ -483,6 +526,190 @@ tOplkError oplk_writeObject(tSdoComConHdl* pSdoComConHdl_p, UINT nodeId_p, UINT
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Read entry of a remote node into a stream
+
+The function reads the specified entry of a remote node by an SDO transfer and
+writes the received data segment by segment to a domain stream (e.g. a stream
+opened by oplk_openDomainFile()), so large domains can be uploaded without
+buffering the whole data. The function returns kErrorApiTaskDeferred and the
+application is informed via the event callback function when the task is
+completed. The stream is closed (or aborted) when the transfer has finished.
+
+\param  pSdoComConHdl_p     A pointer to the SDO connection handle.
+\param  nodeId_p            Node ID of the node to read.
+\param  index_p             The index of the object to read.
+\param  subindex_p          The subindex of the object to read.
+\param  pStream_p           Pointer to the stream which receives the data. At
+                            most maxSize bytes of the stream are read.
+\param  sdoType_p           The type of the SDO transfer (SDO over ASnd, SDO over
+                            UDP or SDO over PDO)
+\param  pUserArg_p          User defined argument which will be passed to the
+                            event callback function.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorApiTaskDeferred   The SDO transfer was started.
+\retval kErrorApiInvalidParam   The function is not available due to missing
+                                domain stream support.
+\retval Other                   Error occurred while starting the transfer.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_readObjectToStream(tSdoComConHdl* pSdoComConHdl_p, UINT nodeId_p, UINT index_p,
+                                   UINT subindex_p, tObdDomainStream* pStream_p,
+                                   tSdoType sdoType_p, void* pUserArg_p)
+{
+    if (pStream_p == NULL)
+        return kErrorApiInvalidParam;
+
+    return transferObjectStream(pSdoComConHdl_p, nodeId_p, index_p, subindex_p, pStream_p,
+                                pStream_p->maxSize, kSdoAccessTypeRead, sdoType_p, pUserArg_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write entry of a remote node from a stream
+
+The function writes the data of a domain stream segment by segment to the
+specified entry of a remote node by an SDO transfer, so large domains (e.g. a
+firmware image for object 0x1F50) can be downloaded without buffering the
+whole data. The function returns kErrorApiTaskDeferred and the application is
+informed via the event callback function when the task is completed.
+
+\param  pSdoComConHdl_p     A pointer to the SDO connection handle.
+\param  nodeId_p            Node ID of the node to write.
+\param  index_p             The index of the object to write.
+\param  subindex_p          The subindex of the object to write.
+\param  pStream_p           Pointer to the stream which provides the data. The
+                            current size of the stream is written.
+\param  sdoType_p           The type of the SDO transfer (SDO over ASnd, SDO over
+                            UDP or SDO over PDO)
+\param  pUserArg_p          User defined argument which will be passed to the
+                            event callback function.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorApiTaskDeferred   The SDO transfer was started.
+\retval kErrorApiInvalidParam   The function is not available due to missing
+                                domain stream support.
+\retval Other                   Error occurred while starting the transfer.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_writeObjectFromStream(tSdoComConHdl* pSdoComConHdl_p, UINT nodeId_p, UINT index_p,
+                                      UINT subindex_p, tObdDomainStream* pStream_p,
+                                      tSdoType sdoType_p, void* pUserArg_p)
+{
+    if (pStream_p == NULL)
+        return kErrorApiInvalidParam;
+
+    return transferObjectStream(pSdoComConHdl_p, nodeId_p, index_p, subindex_p, pStream_p,
+                                pStream_p->size, kSdoAccessTypeWrite, sdoType_p, pUserArg_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read entry of a remote node into a scatter list
+
+The function reads the specified entry of a remote node by an SDO transfer.
+The received data is copied from the frames directly into the buffers of the
+scatter list in their order, so large objects can be read into several buffers
+(e.g. blocks of a diagnostic buffer) without a temporary buffer. The function
+returns kErrorApiTaskDeferred and the application is informed via the event
+callback function when the task is completed. The number of read bytes is
+reported in the event.
+
+\param  pSdoComConHdl_p     A pointer to the SDO connection handle.
+\param  nodeId_p            Node ID of the node to read.
+\param  index_p             The index of the object to read.
+\param  subindex_p          The subindex of the object to read.
+\param  aEntry_p            Scatter list which receives the data. The list and
+                            the buffers must stay valid until the transfer is
+                            completed.
+\param  entryCount_p        Number of entries of the scatter list.
+\param  sdoType_p           The type of the SDO transfer (SDO over ASnd, SDO over
+                            UDP or SDO over PDO)
+\param  pUserArg_p          User defined argument which will be passed to the
+                            event callback function.
+
+\note   Entries of the local OD are read with oplk_readLocalObject().
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorApiTaskDeferred   The SDO transfer was started.
+\retval kErrorApiInvalidParam   The parameters are invalid or the function is not
+                                available due to missing SDO client support.
+\retval Other                   Error occurred while starting the transfer.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_readObjectToScatterList(tSdoComConHdl* pSdoComConHdl_p, UINT nodeId_p, UINT index_p,
+                                        UINT subindex_p, tSdoScatterEntry* aEntry_p, UINT entryCount_p,
+                                        tSdoType sdoType_p, void* pUserArg_p)
+{
+#if defined(CONFIG_INCLUDE_SDOC)
+    tOplkError                  ret;
+    tSdoComTransParamByIndex    transParamByIndex;
+    UINT                        size = 0;
+    UINT                        entry;
+
+    if ((index_p == 0) || (aEntry_p == NULL) || (entryCount_p == 0) ||
+        (pSdoComConHdl_p == NULL) || (nodeId_p == 0) || (nodeId_p == obd_getNodeId()))
+        return kErrorApiInvalidParam;
+
+    for (entry = 0; entry < entryCount_p; entry++)
+    {
+        if (((aEntry_p[entry].pData == NULL) && (aEntry_p[entry].size != 0)) ||
+            (aEntry_p[entry].size > (UINT_MAX - size)))
+            return kErrorApiInvalidParam;
+
+        size += aEntry_p[entry].size;
+    }
+
+    if (size == 0)
+        return kErrorApiInvalidParam;
+
+#if defined(CONFIG_INCLUDE_CFM)
+    if (cfmu_isSdoRunning(nodeId_p))
+        return kErrorApiSdoBusyIntern;
+#endif
+
+    ret = sdocom_defineConnection(pSdoComConHdl_p, nodeId_p, sdoType_p);
+    if ((ret != kErrorOk) && (ret != kErrorSdoComHandleExists))
+        return ret;
+
+    transParamByIndex.pData = NULL;
+    transParamByIndex.sdoAccessType = kSdoAccessTypeRead;
+    transParamByIndex.sdoComConHdl = *pSdoComConHdl_p;
+    transParamByIndex.dataSize = size;
+    transParamByIndex.index = index_p;
+    transParamByIndex.subindex = subindex_p;
+    transParamByIndex.pfnSdoFinishedCb = cbSdoCon;
+    transParamByIndex.pUserArg = pUserArg_p;
+    transParamByIndex.pStream = NULL;
+    transParamByIndex.paScatterList = aEntry_p;
+    transParamByIndex.scatterEntryCount = entryCount_p;
+
+    if ((ret = sdocom_initTransferByIndex(&transParamByIndex)) != kErrorOk)
+        return ret;
+
+    return kErrorApiTaskDeferred;
+#else
+    UNUSED_PARAMETER(pSdoComConHdl_p);
+    UNUSED_PARAMETER(nodeId_p);
+    UNUSED_PARAMETER(index_p);
+    UNUSED_PARAMETER(subindex_p);
+    UNUSED_PARAMETER(aEntry_p);
+    UNUSED_PARAMETER(entryCount_p);
+    UNUSED_PARAMETER(sdoType_p);
+    UNUSED_PARAMETER(pUserArg_p);
+
+    return kErrorApiInvalidParam;
+#endif
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Free SDO channel
@@ -621,6 +848,125 @@ tOplkError oplk_writeLocalObject(UINT index_p, UINT subindex_p, void* pSrcData_p
     return obd_writeEntry(index_p, subindex_p, pSrcData_p, (tObdSize)size_p);
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Prepare accesses to local objects
+
+The function looks up the objects of a list of local object accesses. The list
+can then be read or written repeatedly with oplk_readLocalObjects() and
+oplk_writeLocalObjects() without searching the local OD. The result of the
+lookup of each object is stored in its errorCode.
+
+\param  aObject_p           Array of object accesses.
+\param  objectCount_p       Number of object accesses in the array.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk          All objects were found.
+\retval Other             The error of the first object which could not be
+                          looked up.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_prepareLocalObjects(tOplkApiLocalObject* aObject_p, UINT objectCount_p)
+{
+    tOplkError              ret = kErrorOk;
+    tOplkApiLocalObject*    pObject;
+
+    if ((aObject_p == NULL) && (objectCount_p != 0))
+        return kErrorApiInvalidParam;
+
+    for (pObject = aObject_p; pObject < aObject_p + objectCount_p; pObject++)
+    {
+        pObject->errorCode = obd_resolveEntry(pObject->index, pObject->subindex,
+                                              &pObject->entryRef);
+        if ((pObject->errorCode != kErrorOk) && (ret == kErrorOk))
+            ret = pObject->errorCode;
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read local objects
+
+The function reads the objects of a list of local object accesses which was
+prepared with oplk_prepareLocalObjects(). The object callback functions are
+called like by oplk_readLocalObject(). The result of each access is stored in
+its errorCode.
+
+\param  aObject_p           Array of object accesses.
+\param  objectCount_p       Number of object accesses in the array.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk          All objects were read.
+\retval Other             The error of the first object which could not be
+                          read.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_readLocalObjects(tOplkApiLocalObject* aObject_p, UINT objectCount_p)
+{
+    tOplkError              ret = kErrorOk;
+    tOplkApiLocalObject*    pObject;
+    tObdSize                obdSize;
+
+    if ((aObject_p == NULL) && (objectCount_p != 0))
+        return kErrorApiInvalidParam;
+
+    for (pObject = aObject_p; pObject < aObject_p + objectCount_p; pObject++)
+    {
+        obdSize = (tObdSize)pObject->size;
+        pObject->errorCode = obd_readResolvedEntry(&pObject->entryRef, pObject->pData, &obdSize);
+        pObject->size = (UINT)obdSize;
+        if ((pObject->errorCode != kErrorOk) && (ret == kErrorOk))
+            ret = pObject->errorCode;
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write local objects
+
+The function writes the objects of a list of local object accesses which was
+prepared with oplk_prepareLocalObjects(). The access types are checked and the
+object callback functions are called like by oplk_writeLocalObject(). The
+result of each access is stored in its errorCode.
+
+\param  aObject_p           Array of object accesses.
+\param  objectCount_p       Number of object accesses in the array.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk          All objects were written.
+\retval Other             The error of the first object which could not be
+                          written.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_writeLocalObjects(tOplkApiLocalObject* aObject_p, UINT objectCount_p)
+{
+    tOplkError              ret = kErrorOk;
+    tOplkApiLocalObject*    pObject;
+
+    if ((aObject_p == NULL) && (objectCount_p != 0))
+        return kErrorApiInvalidParam;
+
+    for (pObject = aObject_p; pObject < aObject_p + objectCount_p; pObject++)
+    {
+        pObject->errorCode = obd_writeResolvedEntry(&pObject->entryRef, pObject->pData,
+                                                    (tObdSize)pObject->size);
+        if ((pObject->errorCode != kErrorOk) && (ret == kErrorOk))
+            ret = pObject->errorCode;
+    }
+
+    return ret;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Send a generic ASnd frame
@@ -644,17 +990,31 @@ tOplkError oplk_sendAsndFrame(UINT8 dstNodeId_p, tAsndFrame* pAsndFrame_p,
 {
     tOplkError      ret;
     tFrameInfo      frameInfo;
+    tAsndFrame*     pTxAsndFrame;
     BYTE            buffer[C_DLL_MAX_ASYNC_MTU];
 
+    if (pAsndFrame_p == NULL)
+        return kErrorReject;
+
+    // Build the frame directly in the TX queue if the queue supports it
+    ret = oplk_allocAsndFrame(asndSize_p, &pTxAsndFrame);
+    if (ret == kErrorOk)
+    {
+        OPLK_MEMCPY(pTxAsndFrame, pAsndFrame_p, asndSize_p);
+        return oplk_sendAllocatedAsndFrame(dstNodeId_p, pTxAsndFrame, asndSize_p);
+    }
+    else if (ret != kErrorApiNotSupported)
+    {
+        return ret;
+    }
+
     // Calculate size of frame (Asnd data + header)
     frameInfo.frameSize = asndSize_p + offsetof(tPlkFrame, data);
 
     // Check for correct input
-    if ((pAsndFrame_p == NULL) || (frameInfo.frameSize >= sizeof(buffer)))
+    if (frameInfo.frameSize >= sizeof(buffer))
         return kErrorReject;
 
-    // Calculate size of frame (Asnd data + header)
-    frameInfo.frameSize = asndSize_p + offsetof(tPlkFrame, data);
     frameInfo.pFrame = (tPlkFrame*)buffer;
 
     // Copy Asnd data
@@ -672,6 +1032,92 @@ tOplkError oplk_sendAsndFrame(UINT8 dstNodeId_p, tAsndFrame* pAsndFrame_p,
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Allocate an ASnd frame in the TX queue
+
+The function allocates an ASnd frame directly in the asynchronous TX queue of
+the stack. The application builds the ASnd frame (service ID and payload) in
+place and sends it with oplk_sendAllocatedAsndFrame(), so the frame isn't
+copied on its way into the queue. An allocated frame holds back all following
+asynchronous frames of the generic priority, therefore it must be sent
+immediately after it is filled.
+
+\param  asndSize_p          Size of the ASnd frame. The size contains the
+                            service ID and the payload.
+\param  ppAsndFrame_p       Pointer to store the pointer to the ASnd frame.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    The ASnd frame was allocated.
+\retval kErrorDllAsyncTxBufferFull  The TX queue is full.
+\retval kErrorApiNotSupported       The stack configuration can't allocate
+                                    frames in place, oplk_sendAsndFrame() must
+                                    be used.
+\retval Other                       Error occurred while allocating the frame.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_allocAsndFrame(size_t asndSize_p, tAsndFrame** ppAsndFrame_p)
+{
+    tOplkError      ret;
+    tFrameInfo      frameInfo;
+
+    if (ppAsndFrame_p == NULL)
+        return kErrorApiInvalidParam;
+
+    frameInfo.frameSize = asndSize_p + offsetof(tPlkFrame, data);
+    if (frameInfo.frameSize >= C_DLL_MAX_ASYNC_MTU)
+        return kErrorReject;
+
+    ret = dllucal_allocAsyncFrame(&frameInfo, kDllAsyncReqPrioGeneric);
+    if (ret != kErrorOk)
+        return ret;
+
+    OPLK_MEMSET(frameInfo.pFrame, 0x00, offsetof(tPlkFrame, data));
+    *ppAsndFrame_p = &frameInfo.pFrame->data.asnd;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send an allocated ASnd frame
+
+The function sends an ASnd frame which was allocated by oplk_allocAsndFrame()
+and filled by the application.
+
+\param  dstNodeId_p         Destination Node ID
+\param  pAsndFrame_p        Pointer to ASnd frame returned by
+                            oplk_allocAsndFrame().
+\param  asndSize_p          Size of the ASnd frame. It must be the size the
+                            frame was allocated with.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk          ASnd frame was successfully sent.
+\retval Other             Error occurred while sending the ASnd frame.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_sendAllocatedAsndFrame(UINT8 dstNodeId_p, tAsndFrame* pAsndFrame_p,
+                                       size_t asndSize_p)
+{
+    tFrameInfo      frameInfo;
+
+    if (pAsndFrame_p == NULL)
+        return kErrorApiInvalidParam;
+
+    frameInfo.frameSize = asndSize_p + offsetof(tPlkFrame, data);
+    frameInfo.pFrame = (tPlkFrame*)((UINT8*)pAsndFrame_p - offsetof(tPlkFrame, data));
+
+    // Fill in additional data (SrcNodeId is filled by DLL if it is set to 0)
+    ami_setUint8Le(&frameInfo.pFrame->messageType, (UINT8)kMsgTypeAsnd);
+    ami_setUint8Le(&frameInfo.pFrame->dstNodeId, (UINT8)dstNodeId_p);
+    ami_setUint8Le(&frameInfo.pFrame->srcNodeId, (UINT8)0);
+
+    return dllucal_sendAllocatedAsyncFrame(&frameInfo, kDllAsyncReqPrioGeneric);
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Set forwarding of received ASnd frames
@@ -718,6 +1164,41 @@ tOplkError oplk_setAsndForward(UINT8 serviceId_p, tOplkApiAsndFilter filterType_
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Limit forwarding of received ASnd frames
+
+The function limits the forwarding of received ASnd frames of the specified
+service ID. The limits are applied in the kernel layer, so dropped frames are
+neither copied to the user layer nor cause a wakeup of the user layer.
+Responses to requests of the local MN are never dropped.
+
+\param  serviceId_p             The ASnd service ID for which the limit will be
+                                set.
+\param  maxFramesPerSec_p       Maximum number of forwarded frames per second.
+                                0 disables the rate limit.
+\param  fForwardChangedOnly_p   If TRUE, a StatusResponse is only forwarded if
+                                it differs from the last forwarded StatusResponse
+                                of the same node. Only valid for the
+                                StatusResponse service ID.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk          Limit was successfully set.
+\retval Other             Error occurred while setting the limit.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_setAsndForwardLimit(UINT8 serviceId_p, UINT maxFramesPerSec_p,
+                                    BOOL fForwardChangedOnly_p)
+{
+    if ((fForwardChangedOnly_p != FALSE) && (serviceId_p != kDllAsndStatusResponse))
+        return kErrorApiInvalidParam;
+
+    return dllucal_setAsndServiceLimit((tDllAsndServiceId)serviceId_p,
+                                       maxFramesPerSec_p, fForwardChangedOnly_p);
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Post user defined event
@@ -798,6 +1279,8 @@ embedded system).
 
 \note   The function is only used if the CDC functionality is included in the
         openPOWERLINK stack.
+\note   A precompiled CDC (see tools/precompile-cdc.pl) is used in place, so
+        the buffer must stay valid until the stack is shut down.
 
 \see oplk_setCdcFilename()
 
@@ -859,33 +1342,240 @@ tOplkError oplk_setCdcFilename(char* pCdcFilename_p)
 
 //------------------------------------------------------------------------------
 /**
-\brief  Stack process function
+\brief  Set the OD store filename
 
-The process function is used in single threaded environments e.g. without any OS.
-It gives processing time to several tasks in the openPOWERLINK stack.
+The function sets the file in which the stack stores the object dictionary.
+The objects are stored if "save" is written to object 0x1010 and loaded at the
+reset of the respective OD partition.
+
+\param  pStoreFilename_p  Filename of the store file.
+
+\note   The function is only used if the OD store functionality is included
+        in the openPOWERLINK stack. It has to be called before the first
+        NMT reset.
 
 \return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    The filename has successfully been set.
+\retval kErrorApiInvalidParam       The function is not available due to missing
+                                    OD store module.
 
 \ingroup module_api
 */
 //------------------------------------------------------------------------------
-tOplkError oplk_process(void)
+tOplkError oplk_setStoreFilename(char* pStoreFilename_p)
 {
-    return ctrlu_processStack();
+#if (CONFIG_OBD_USE_STORE_MMAP != FALSE)
+    obdstore_setFilename(pStoreFilename_p);
+    return kErrorOk;
+#else
+    UNUSED_PARAMETER(pStoreFilename_p);
+
+    return kErrorApiInvalidParam;
+#endif
 }
 
 //------------------------------------------------------------------------------
 /**
-\brief Check if kernel stack is alive
+\brief  Set the stream of a domain object
 
-The function checks if the kernel part of the stack is alive.
+The function backs a local domain object with a stream. All accesses to the
+data of the object (local accesses and SDO transfers) are done by the access
+callback of the stream, so the data doesn't need to be held in memory.
 
-\return Returns the status of the kernel stack.
-\retval TRUE        The kernel stack is alive.
-\retval FALSE       The kernel stack is dead.
+\param  index_p             The index of the domain object.
+\param  subindex_p          The subindex of the domain object.
+\param  pStream_p           Pointer to the stream. NULL removes the stream from
+                            the object.
 
-\ingroup module_api
-*/
+\note   The function is only available if CONFIG_OBD_DOMAIN_STREAM_COUNT is
+        not 0.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    The stream was set.
+\retval kErrorApiInvalidParam       The function is not available due to missing
+                                    domain stream support.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_setDomainStream(UINT index_p, UINT subindex_p, tObdDomainStream* pStream_p)
+{
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    return obd_setDomainStream(index_p, subindex_p, pStream_p);
+#else
+    UNUSED_PARAMETER(index_p);
+    UNUSED_PARAMETER(subindex_p);
+    UNUSED_PARAMETER(pStream_p);
+
+    return kErrorApiInvalidParam;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Back a domain object with a file
+
+The function opens (or creates) a file and backs the specified local domain
+object with it. SDO transfers of the object are read from and written to the
+file segment by segment. A download of the object replaces the content of the
+file.
+
+\param  index_p             The index of the domain object.
+\param  subindex_p          The subindex of the domain object.
+\param  pFilename_p         Filename of the file.
+\param  maxSize_p           Maximum size which can be downloaded to the object.
+\param  ppStream_p          Pointer to store the stream of the file. It may be
+                            NULL if the stream isn't needed by the application.
+
+\note   The function is only available if CONFIG_OBD_DOMAIN_STREAM_COUNT is
+        not 0.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    The object is backed by the file.
+\retval kErrorApiInvalidParam       The function is not available due to missing
+                                    domain stream support.
+\retval Other                       The file or the object couldn't be set up.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_openDomainFile(UINT index_p, UINT subindex_p, const char* pFilename_p,
+                               UINT32 maxSize_p, tObdDomainStream** ppStream_p)
+{
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    tOplkError          ret;
+    tObdDomainStream*   pStream;
+
+    if (pFilename_p == NULL)
+        return kErrorApiInvalidParam;
+
+    ret = obdfile_open(pFilename_p, maxSize_p, &pStream);
+    if (ret != kErrorOk)
+        return ret;
+
+    ret = obd_setDomainStream(index_p, subindex_p, pStream);
+    if (ret != kErrorOk)
+    {
+        obdfile_close(pStream);
+        return ret;
+    }
+
+    if (ppStream_p != NULL)
+        *ppStream_p = pStream;
+
+    return kErrorOk;
+#else
+    UNUSED_PARAMETER(index_p);
+    UNUSED_PARAMETER(subindex_p);
+    UNUSED_PARAMETER(pFilename_p);
+    UNUSED_PARAMETER(maxSize_p);
+    UNUSED_PARAMETER(ppStream_p);
+
+    return kErrorApiInvalidParam;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close the file of a domain object
+
+The function detaches a file stream opened by oplk_openDomainFile() from all
+domain objects and closes the file. Open file streams are also closed by
+oplk_shutdown().
+
+\param  pStream_p           Pointer to the stream of the file.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    The file was closed.
+\retval kErrorApiInvalidParam       The function is not available due to missing
+                                    domain stream support.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_closeDomainFile(tObdDomainStream* pStream_p)
+{
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    return obdfile_close(pStream_p);
+#else
+    UNUSED_PARAMETER(pStream_p);
+
+    return kErrorApiInvalidParam;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Stack process function
+
+The process function is used in single threaded environments e.g. without any OS.
+It gives processing time to several tasks in the openPOWERLINK stack.
+
+\return The function returns a \ref tOplkError error code.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_process(void)
+{
+    return ctrlu_processStack();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Wait for work and process the stack
+
+The function is used instead of calling oplk_process() in a loop. It waits until
+the stack has work for the application thread or the timeout elapsed and
+processes everything pending afterwards. In single threaded environments the
+user event queues and timers are checked without running the complete process
+function. In environments where the stack uses its own threads the function
+sleeps until the stack processed events.
+
+\param  timeoutMs_p         Maximum time to wait in milliseconds.
+
+\return The function returns a \ref tOplkError error code.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_waitAndProcess(UINT32 timeoutMs_p)
+{
+    return ctrlu_waitAndProcess(timeoutMs_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the wait handle of the stack
+
+The function returns a file descriptor which can be added to the poll()/select()
+loop of the application. It becomes readable if the stack processed events.
+The application calls oplk_waitAndProcess() with a timeout of 0 afterwards,
+which also resets the file descriptor.
+
+\return The function returns the file descriptor or -1 if it is not available
+        on the target.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+int oplk_getWaitHandle(void)
+{
+    return ctrlu_getWaitHandle();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief Check if kernel stack is alive
+
+The function checks if the kernel part of the stack is alive.
+
+\return Returns the status of the kernel stack.
+\retval TRUE        The kernel stack is alive.
+\retval FALSE       The kernel stack is dead.
+
+\ingroup module_api
+*/
 //------------------------------------------------------------------------------
 BOOL oplk_checkKernelStack(void)
 {
@@ -918,7 +1608,459 @@ the specified timeout elapsed.
 //------------------------------------------------------------------------------
 tOplkError oplk_waitSyncEvent(ULONG timeout_p)
 {
-    return pdoucal_waitSyncEvent(timeout_p);
+    tOplkError      ret;
+
+    ret = pdoucal_waitSyncEvent(timeout_p);
+    if (ret == kErrorOk)
+    {
+        CYCLESTAT_MARK_SYNC_START();
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief Get sync file descriptor
+
+The function returns a file descriptor which becomes readable when a sync event
+occurred. The application can wait for the sync event with poll(), select() or
+epoll together with its other file descriptors instead of calling
+oplk_waitSyncEvent(). After the descriptor became readable, the application
+must acknowledge the sync event by calling oplk_getSyncInfo().
+
+\note The file descriptor is only available if the user library is connected
+      to the openPOWERLINK Linux kernel driver.
+
+\return The function returns the file descriptor or -1 if it is not available.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+int oplk_getSyncFd(void)
+{
+    return pdoucal_getSyncFd();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief Get sync information
+
+The function acknowledges the pending sync events and returns the cycle
+counter and the time stamp of the last sync event. The number of missed sync
+events shows how many sync events were signaled without being handled by the
+application.
+
+\param  pSyncInfo_p     Pointer to store the sync information.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                The sync information was read.
+\retval kErrorApiInvalidParam   The passed pointer is invalid.
+\retval kErrorApiNotSupported   The sync information is not available.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getSyncInfo(tSyncInfo* pSyncInfo_p)
+{
+    tOplkError      ret;
+
+    if (pSyncInfo_p == NULL)
+        return kErrorApiInvalidParam;
+
+    ret = pdoucal_getSyncInfo(pSyncInfo_p);
+    if (ret == kErrorOk)
+    {
+        CYCLESTAT_MARK_SYNC_START();
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief Get SoC time information
+
+The function returns the NetTime and RelativeTime of the last SoC together with
+the local time of the SoC and the estimated offset of the NetTime to the local
+time. The information is updated on every sync event, so in the sync callback
+it belongs to the cycle of the RPDOs in the process image.
+
+\param  pSocTimeInfo_p  Pointer to store the SoC time information.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                The SoC time information was read.
+\retval kErrorApiInvalidParam   The passed pointer is invalid.
+\retval kErrorApiNotSupported   No SoC time information is available. Either
+                                CONFIG_DLL_SOC_TIME_INFO is disabled or no SoC
+                                was processed yet.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getSocTimeInfo(tSocTimeInfo* pSocTimeInfo_p)
+{
+    if (pSocTimeInfo_p == NULL)
+        return kErrorApiInvalidParam;
+
+    if ((pdoucal_getSocTime(pSocTimeInfo_p) != kErrorOk) || (pSocTimeInfo_p->socCount == 0))
+        return kErrorApiNotSupported;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief Get the current NetTime
+
+The function interpolates the current NetTime from the last SoC. It adds the
+estimated offset of the NetTime to the current local time, therefore it needs
+no system call apart from reading the local clock.
+
+\note The local time of the SoC is taken by the kernel layer. The result is
+      only valid if the kernel layer uses the same clock as the application,
+      i.e. if the stack runs in user space or in the Linux kernel on the same
+      machine.
+
+\param  pNetTime_p      Pointer to store the NetTime.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                The NetTime was calculated.
+\retval kErrorApiInvalidParam   The passed pointer is invalid.
+\retval kErrorApiNotSupported   No SoC time information is available.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getNetTime(tNetTime* pNetTime_p)
+{
+    tOplkError      ret;
+    tSocTimeInfo    socTimeInfo;
+    UINT64          netTime;
+
+    if (pNetTime_p == NULL)
+        return kErrorApiInvalidParam;
+
+    ret = oplk_getSocTimeInfo(&socTimeInfo);
+    if (ret != kErrorOk)
+        return ret;
+
+    netTime = (UINT64)((INT64)target_getCurrentTimestamp() + socTimeInfo.netTimeOffset);
+    pNetTime_p->sec = (UINT32)(netTime / 1000000000ULL);
+    pNetTime_p->nsec = (UINT32)(netTime % 1000000000ULL);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief Get cycle statistics
+
+The function copies the latency histograms of the cycle stages which are
+recorded by the stack. The times of the stages are measured in nanoseconds
+relative to the start of the cycle, see \ref tCycleStatStage. On an MN it
+additionally copies the PReq and PRes timings of the isochronous slots of the
+CNs, see \ref tCycleStatNode. The histograms also contain the percentiles of
+a rolling window of recent samples, which can be used to tune the PRes
+timeouts of the CNs. The statistics are only available if the stack is
+compiled with CONFIG_CYCLE_STATISTICS.
+
+\param  pStatistics_p   Pointer to store the cycle statistics.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                The statistics were copied.
+\retval kErrorApiInvalidParam   The passed pointer is invalid.
+\retval kErrorApiNotSupported   The cycle statistics are not included in the stack.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getCycleStatistics(tCycleStatistics* pStatistics_p)
+{
+    if (pStatistics_p == NULL)
+        return kErrorApiInvalidParam;
+
+#if (CONFIG_CYCLE_STATISTICS != FALSE)
+    return cyclestat_getStatistics(pStatistics_p);
+#else
+    return kErrorApiNotSupported;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief Set sync budget
+
+The function sets the time budget of the synchronous processing of the
+application. The processing starts with the delivery of the sync event and
+ends with the call of oplk_exchangeProcessImageIn(). Both times are measured
+relative to the start of the cycle. Every cycle in which the TPDOs are copied
+later than the budget is counted as an overrun. Optionally the TPDOs of an
+overrun are skipped, so the CN or MN sends the TPDOs of the previous cycle
+instead of late data. The budget is only available if the stack is compiled
+with CONFIG_CYCLE_STATISTICS.
+
+\param  budget_p            Budget in nanoseconds relative to the start of the
+                            cycle. 0 disables the budget.
+\param  fSkipLateTxPdo_p    Skip the TPDOs of cycles which exceeded the budget.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                The budget was set.
+\retval kErrorApiNotSupported   The cycle statistics are not included in the stack.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_setSyncBudget(UINT32 budget_p, BOOL fSkipLateTxPdo_p)
+{
+#if (CONFIG_CYCLE_STATISTICS != FALSE)
+    return cyclestat_setSyncBudget(budget_p, fSkipLateTxPdo_p);
+#else
+    UNUSED_PARAMETER(budget_p);
+    UNUSED_PARAMETER(fSkipLateTxPdo_p);
+    return kErrorApiNotSupported;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief Get sync budget statistics
+
+The function copies the settings and the overrun statistics of the sync budget
+which was set by oplk_setSyncBudget(), see \ref tCycleStatSyncBudget.
+
+\param  pSyncBudget_p   Pointer to store the sync budget statistics.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                The statistics were copied.
+\retval kErrorApiInvalidParam   The passed pointer is invalid.
+\retval kErrorApiNotSupported   The cycle statistics are not included in the stack.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getSyncBudgetStatistics(tCycleStatSyncBudget* pSyncBudget_p)
+{
+    if (pSyncBudget_p == NULL)
+        return kErrorApiInvalidParam;
+
+#if (CONFIG_CYCLE_STATISTICS != FALSE)
+    return cyclestat_getSyncBudget(pSyncBudget_p);
+#else
+    return kErrorApiNotSupported;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get start-up timing
+
+The function copies the duration of the start-up phases of the stack, see
+\ref tOplkApiStartupTiming. The phases which were not passed yet are zero. The
+timing is only available if the stack is compiled with
+CONFIG_CTRL_STARTUP_TIMING.
+
+\param  pTiming_p       Pointer to store the start-up timing.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                The timing was copied.
+\retval kErrorApiInvalidParam   The passed pointer is invalid.
+\retval kErrorApiNotSupported   The start-up timing is not included in the stack.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getStartupTiming(tOplkApiStartupTiming* pTiming_p)
+{
+    if (pTiming_p == NULL)
+        return kErrorApiInvalidParam;
+
+#if (CONFIG_CTRL_STARTUP_TIMING != FALSE)
+    return ctrlu_getStartupTiming(pTiming_p);
+#else
+    return kErrorApiNotSupported;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get sync statistics
+
+The function copies the statistics of the servo which locks the sync timer of
+a CN to the SoC frames of the MN, see \ref tSyncServoStatistics. The statistics
+are only available on a CN which processes the isochronous task on the sync
+timer (CONFIG_DLL_PROCESS_SYNC is DLL_PROCESS_SYNC_ON_TIMER). The kernel layer
+must be linked into the application.
+
+\param  pStatistics_p   Pointer to store the sync statistics.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                The statistics were copied.
+\retval kErrorApiInvalidParam   The passed pointer is invalid.
+\retval kErrorApiNotSupported   The sync servo is not included in the stack.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getSyncStatistics(tSyncServoStatistics* pStatistics_p)
+{
+    if (pStatistics_p == NULL)
+        return kErrorApiInvalidParam;
+
+#if (CONFIG_DLL_PROCESS_SYNC == DLL_PROCESS_SYNC_ON_TIMER)
+    return synctimer_getStatistics(pStatistics_p);
+#else
+    return kErrorApiNotSupported;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get event queue statistics
+
+The function copies the maximum used size (high-water mark) of the event queues
+which are accessible by the user layer, see \ref tEventQueueStatistics. The
+sizes are only recorded on Linux if the stack is compiled with
+DEBUG_CIRCBUF_SIZE_CHECK.
+
+\param  pStatistics_p   Pointer to store the queue statistics.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                The statistics were copied.
+\retval kErrorApiInvalidParam   The passed pointer is invalid.
+\retval kErrorApiNotSupported   The queue sizes are not recorded by the stack.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getEventQueueStatistics(tEventQueueStatistics* pStatistics_p)
+{
+    if (pStatistics_p == NULL)
+        return kErrorApiInvalidParam;
+
+    return ctrlu_getEventQueueStatistics(pStatistics_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get multiplexed cycle report
+
+The function copies the report of the multiplexed cycle assignment (object
+0x1F9B) which the MN computed at the last NMT_ResetConfiguration. The report
+contains the isochronous time of the continuous CNs and of each multiplexed
+cycle, see \ref tMultiplexReport. The assignment is only computed if the stack
+is compiled with CONFIG_NMTMNU_MULTIPLEX_SCHEDULE.
+
+\param  pReport_p       Pointer to store the report.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                The report was copied.
+\retval kErrorApiInvalidParam   The passed pointer is invalid.
+\retval kErrorInvalidOperation  No assignment was computed yet.
+\retval kErrorApiNotSupported   The scheduler is not included in the stack.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getMultiplexReport(tMultiplexReport* pReport_p)
+{
+    if (pReport_p == NULL)
+        return kErrorApiInvalidParam;
+
+#if defined(CONFIG_INCLUDE_NMT_MN) && (CONFIG_NMTMNU_MULTIPLEX_SCHEDULE != FALSE)
+    return multiplexu_getReport(pReport_p);
+#else
+    return kErrorApiNotSupported;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief Get flight record
+
+The function copies the frames of the last cycles kept by the cycle flight
+recorder, see \ref tFlightRecord. The recorder is frozen by the first DLL error
+which matches CONFIG_FLIGHT_RECORDER_TRIGGER and keeps the cycles before the
+error until it is rearmed with oplk_rearmFlightRecorder(). The record is only
+available if the stack is compiled with CONFIG_FLIGHT_RECORDER.
+
+\param  pRecord_p       Pointer to store the flight record.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                The record was copied.
+\retval kErrorApiInvalidParam   The passed pointer is invalid.
+\retval kErrorApiNotSupported   The flight recorder is not included in the stack.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getFlightRecord(tFlightRecord* pRecord_p)
+{
+    if (pRecord_p == NULL)
+        return kErrorApiInvalidParam;
+
+#if (CONFIG_FLIGHT_RECORDER != FALSE)
+    return flightrec_getRecord(pRecord_p);
+#else
+    return kErrorApiNotSupported;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief Rearm flight recorder
+
+The function discards the cycles kept by the cycle flight recorder and
+unfreezes it. Recording restarts with the next cycle.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                The recorder was rearmed.
+\retval kErrorApiNotSupported   The flight recorder is not included in the stack.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_rearmFlightRecorder(void)
+{
+#if (CONFIG_FLIGHT_RECORDER != FALSE)
+    flightrec_rearm();
+    return kErrorOk;
+#else
+    return kErrorApiNotSupported;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief Get metrics
+
+The function copies the counters, gauges and histograms registered by the
+stack modules in the metrics registry, see \ref tMetricsMemory. External
+collectors can read the same data from the shared memory of the registry
+without calling the stack. The metrics are only available if the stack is
+compiled with CONFIG_METRICS.
+
+\param  pMetrics_p      Pointer to store the metrics.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                The metrics were copied.
+\retval kErrorApiInvalidParam   The passed pointer is invalid.
+\retval kErrorApiNotSupported   The metrics registry is not included in the stack.
+\retval kErrorNoResource        The metrics registry is not initialized.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getMetrics(tMetricsMemory* pMetrics_p)
+{
+    if (pMetrics_p == NULL)
+        return kErrorApiInvalidParam;
+
+#if (CONFIG_METRICS != FALSE)
+    return metrics_getMemory(pMetrics_p);
+#else
+    return kErrorApiNotSupported;
+#endif
 }
 
 //------------------------------------------------------------------------------
@@ -984,6 +2126,80 @@ static tOplkError cbSdoCon(tSdoComFinished* pSdoComFinished_p)
 }
 #endif
 
+//------------------------------------------------------------------------------
+/**
+\brief  Start a stream transfer of a remote object
+
+The function starts an SDO transfer between an entry of a remote node and a
+domain stream.
+
+\param  pSdoComConHdl_p     A pointer to the SDO connection handle.
+\param  nodeId_p            Node ID of the remote node.
+\param  index_p             The index of the object.
+\param  subindex_p          The subindex of the object.
+\param  pStream_p           Pointer to the stream.
+\param  size_p              Size of the transfer.
+\param  accessType_p        Read or write access.
+\param  sdoType_p           The type of the SDO transfer.
+\param  pUserArg_p          User defined argument which will be passed to the
+                            event callback function.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError transferObjectStream(tSdoComConHdl* pSdoComConHdl_p, UINT nodeId_p, UINT index_p,
+                                       UINT subindex_p, tObdDomainStream* pStream_p, UINT size_p,
+                                       tSdoAccessType accessType_p, tSdoType sdoType_p,
+                                       void* pUserArg_p)
+{
+#if defined(CONFIG_INCLUDE_SDOC) && (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    tOplkError                  ret;
+    tSdoComTransParamByIndex    transParamByIndex;
+
+    if ((index_p == 0) || (size_p == 0) || (pSdoComConHdl_p == NULL) ||
+        (nodeId_p == 0) || (nodeId_p == obd_getNodeId()))
+        return kErrorApiInvalidParam;
+
+#if defined(CONFIG_INCLUDE_CFM)
+    if (cfmu_isSdoRunning(nodeId_p))
+        return kErrorApiSdoBusyIntern;
+#endif
+
+    ret = sdocom_defineConnection(pSdoComConHdl_p, nodeId_p, sdoType_p);
+    if ((ret != kErrorOk) && (ret != kErrorSdoComHandleExists))
+        return ret;
+
+    transParamByIndex.pData = NULL;
+    transParamByIndex.sdoAccessType = accessType_p;
+    transParamByIndex.sdoComConHdl = *pSdoComConHdl_p;
+    transParamByIndex.dataSize = size_p;
+    transParamByIndex.index = index_p;
+    transParamByIndex.subindex = subindex_p;
+    transParamByIndex.pfnSdoFinishedCb = cbSdoCon;
+    transParamByIndex.pUserArg = pUserArg_p;
+    transParamByIndex.pStream = pStream_p;
+    transParamByIndex.paScatterList = NULL;
+    transParamByIndex.scatterEntryCount = 0;
+
+    if ((ret = sdocom_initTransferByIndex(&transParamByIndex)) != kErrorOk)
+        return ret;
+
+    return kErrorApiTaskDeferred;
+#else
+    UNUSED_PARAMETER(pSdoComConHdl_p);
+    UNUSED_PARAMETER(nodeId_p);
+    UNUSED_PARAMETER(index_p);
+    UNUSED_PARAMETER(subindex_p);
+    UNUSED_PARAMETER(pStream_p);
+    UNUSED_PARAMETER(size_p);
+    UNUSED_PARAMETER(accessType_p);
+    UNUSED_PARAMETER(sdoType_p);
+    UNUSED_PARAMETER(pUserArg_p);
+
+    return kErrorApiInvalidParam;
+#endif
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Callback function for received ASnds
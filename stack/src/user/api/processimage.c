@@ -44,6 +44,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <user/pdou.h>
 
+#if (CONFIG_EVENTU_CYCLE_SLICE != FALSE)
+#include <user/eventucal.h>
+#endif
+
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
 //============================================================================//
@@ -77,6 +81,11 @@ typedef struct
 {
     tOplkApiProcessImage     inputImage;
     tOplkApiProcessImage     outputImage;
+    BOOL                     fZeroCopy;
+    BOOL                     fKernelAssembly;           // the process images are assembled by the kernel layer
+    volatile UINT32          outputSequence;             // seqlock of the output image, odd while it is written
+    volatile UINT32          inputSequence;              // seqlock of the input image snapshot, odd while it is written
+    UINT8*                   pInputSnapshot;             // input image of the last exchange, NULL = no snapshots
 } tApiProcessImageInstance;
 
 //------------------------------------------------------------------------------
@@ -87,6 +96,10 @@ static tApiProcessImageInstance  instance_l;
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
+static tOplkError checkSnapshotRange(const tOplkApiProcessImage* pImage_p, void* pDest_p,
+                                     UINT offset_p, UINT size_p);
+static void       readSnapshot(const volatile UINT32* pSequence_p, const UINT8* pSource_p,
+                               void* pDest_p, UINT size_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -142,6 +155,11 @@ tOplkError oplk_allocProcessImage(UINT sizeProcessImageIn_p, UINT sizeProcessIma
           instance_l.inputImage.pImage,  instance_l.inputImage.imageSize,
           instance_l.outputImage.pImage, instance_l.outputImage.imageSize);
 
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+    pdou_setStaticCopyProcessImage(instance_l.outputImage.pImage, instance_l.outputImage.imageSize,
+                                   instance_l.inputImage.pImage, instance_l.inputImage.imageSize);
+#endif
+
 Exit:
     return ret;
 }
@@ -168,6 +186,27 @@ tOplkError oplk_freeProcessImage(void)
         goto Exit;
     }
 
+    if (instance_l.fZeroCopy)
+    {
+        pdou_setupZeroCopy(NULL, 0, NULL, 0);
+        instance_l.fZeroCopy = FALSE;
+    }
+    if (instance_l.fKernelAssembly)
+    {
+        pdou_setupKernelPi(NULL, 0, NULL, 0);
+        instance_l.fKernelAssembly = FALSE;
+    }
+    pdou_enableTxPdoDirtyTracking(FALSE);
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+    pdou_setStaticCopyProcessImage(NULL, 0, NULL, 0);
+#endif
+
+    if (instance_l.pInputSnapshot != NULL)
+    {
+        OPLK_FREE(instance_l.pInputSnapshot);
+        instance_l.pInputSnapshot = NULL;
+    }
+
     instance_l.inputImage.imageSize = 0;
     instance_l.outputImage.imageSize = 0;
 
@@ -255,7 +294,11 @@ tOplkError oplk_linkProcessImageObject(UINT objIndex_p, UINT firstSubindex_p,
 /**
 \brief  Exchange input process image
 
-The function exchanges the input process image.
+The function exchanges the input process image. If snapshots of the input
+process image are enabled, the exchanged image is copied for
+oplk_getProcessImageInSnapshot(). With CONFIG_EVENTU_CYCLE_SLICE the exchange
+completes the sync work of the cycle and starts the slice of the low-priority
+events.
 
 \return The function returns a \ref tOplkError error code.
 \retval kErrorOk                    Input process image is successfully exchanged.
@@ -267,12 +310,29 @@ The function exchanges the input process image.
 tOplkError oplk_exchangeProcessImageIn(void)
 {
     tOplkError      ret;
+    UINT8*          pSnapshot;
 
     if (instance_l.inputImage.pImage != NULL)
         ret = pdou_copyTxPdoFromPi();
     else
         ret = kErrorApiPINotAllocated;
 
+    pSnapshot = instance_l.pInputSnapshot;
+    if ((ret == kErrorOk) && (pSnapshot != NULL) && !instance_l.fZeroCopy &&
+        !instance_l.fKernelAssembly)
+    {
+        instance_l.inputSequence++;
+        OPLK_MEMBAR();
+        OPLK_MEMCPY(pSnapshot, instance_l.inputImage.pImage, instance_l.inputImage.imageSize);
+        OPLK_MEMBAR();
+        instance_l.inputSequence++;
+    }
+
+#if (CONFIG_EVENTU_CYCLE_SLICE != FALSE)
+    if (ret == kErrorOk)
+        eventucal_startCycleSlice();
+#endif
+
     return ret;
 }
 
@@ -280,7 +340,9 @@ tOplkError oplk_exchangeProcessImageIn(void)
 /**
 \brief  Exchange output process image
 
-The function exchanges the output process image.
+The function exchanges the output process image. The update is guarded by a
+sequence counter, so oplk_getProcessImageOutSnapshot() can read a consistent
+copy from another thread without blocking the exchange.
 
 \return The function returns a \ref tOplkError error code.
 \retval kErrorOk                    Output process image is successfully exchanged.
@@ -293,20 +355,113 @@ tOplkError oplk_exchangeProcessImageOut(void)
 {
     tOplkError      ret;
 
-    if (instance_l.outputImage.pImage != NULL)
-        ret = pdou_copyRxPdoToPi();
-    else
-        ret = kErrorApiPINotAllocated;
+    if (instance_l.outputImage.pImage == NULL)
+        return kErrorApiPINotAllocated;
+
+    instance_l.outputSequence++;
+    OPLK_MEMBAR();
+    ret = pdou_copyRxPdoToPi();
+    OPLK_MEMBAR();
+    instance_l.outputSequence++;
 
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Exchange the input process image of selected nodes
+
+The function exchanges only the parts of the input process image which are
+mapped to the TXPDOs of the selected nodes. Bit n of the bitmap (byte n / 8,
+bit n % 8) represents node ID n, bit 0 selects the PRes of the local node.
+
+Every PDO channel belongs to exactly one node, so several application threads
+may exchange their part of the process image concurrently without locking, as
+long as their node sets are disjoint. A node set must not be exchanged
+concurrently with oplk_exchangeProcessImageIn().
+
+The input snapshot is only updated by oplk_exchangeProcessImageIn(). A pending
+hitless remapping is applied by the next full exchange, until then the remapped
+channel is skipped.
+
+\param  pNodeBitmap_p           Pointer to the bitmap of the selected nodes.
+\param  bitmapSize_p            Size of the bitmap in bytes.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    Input process image is successfully exchanged.
+\retval kErrorApiInvalidParam       The bitmap pointer is NULL.
+\retval kErrorApiPINotAllocated     Memory for process images is not allocated.
+\retval kErrorApiNotSupported       The zero-copy mode is active.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_exchangeProcessImageInNodes(const UINT8* pNodeBitmap_p, UINT bitmapSize_p)
+{
+    if (pNodeBitmap_p == NULL)
+        return kErrorApiInvalidParam;
+
+    if (instance_l.inputImage.pImage == NULL)
+        return kErrorApiPINotAllocated;
+
+    return pdou_copyTxPdoFromPiPartial(pNodeBitmap_p, bitmapSize_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Exchange the output process image of selected nodes
+
+The function exchanges only the parts of the output process image which are
+mapped to the RXPDOs of the selected nodes. Bit n of the bitmap (byte n / 8,
+bit n % 8) represents node ID n.
+
+Every PDO channel belongs to exactly one node, so several application threads
+may exchange their part of the process image concurrently without locking, as
+long as their node sets are disjoint. A node set must not be exchanged
+concurrently with oplk_exchangeProcessImageOut().
+
+The sequence counter of the output snapshot, the bitmap of
+oplk_getProcessImageOutUpdates() and the sequence numbers of
+oplk_getProcessImageOutSequence() are only updated by
+oplk_exchangeProcessImageOut(). Therefore oplk_getProcessImageOutSnapshot()
+must not be used together with partial exchanges.
+
+\param  pNodeBitmap_p           Pointer to the bitmap of the selected nodes.
+\param  bitmapSize_p            Size of the bitmap in bytes.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    Output process image is successfully exchanged.
+\retval kErrorApiInvalidParam       The bitmap pointer is NULL.
+\retval kErrorApiPINotAllocated     Memory for process images is not allocated.
+\retval kErrorApiNotSupported       The zero-copy mode is active.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_exchangeProcessImageOutNodes(const UINT8* pNodeBitmap_p, UINT bitmapSize_p)
+{
+    if (pNodeBitmap_p == NULL)
+        return kErrorApiInvalidParam;
+
+    if (instance_l.outputImage.pImage == NULL)
+        return kErrorApiPINotAllocated;
+
+    return pdou_copyRxPdoToPiPartial(pNodeBitmap_p, bitmapSize_p);
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Get pointer to input process image
 
 The function returns the pointer to the input process image.
 
+In zero-copy mode the function returns the TXPDO buffer which is currently
+written. It changes with every call of oplk_exchangeProcessImageIn() and does
+not contain the data of the previous cycle, therefore the input process image
+has to be written completely in each cycle. The same applies to the buffer of
+the input process image which is returned if the process images are assembled
+by the kernel layer.
+
 \return The function returns a pointer to the input process image.
 
 \ingroup module_api
@@ -314,6 +469,14 @@ The function returns the pointer to the input process image.
 //------------------------------------------------------------------------------
 void* oplk_getProcessImageIn(void)
 {
+    void*           pImage;
+
+    if (instance_l.fKernelAssembly && ((pImage = pdou_getKernelPiIn()) != NULL))
+        return pImage;
+
+    if (instance_l.fZeroCopy && ((pImage = pdou_getZeroCopyTxPdo()) != NULL))
+        return pImage;
+
     return instance_l.inputImage.pImage;
 }
 
@@ -323,6 +486,11 @@ void* oplk_getProcessImageIn(void)
 
 The function returns the pointer to the output process image.
 
+In zero-copy mode the function returns the RXPDO buffer which was received
+last. If the process images are assembled by the kernel layer, it returns the
+buffer of the output process image of the last sync event. The buffers change
+with every call of oplk_exchangeProcessImageOut().
+
 \return The function returns a pointer to the output process image.
 
 \ingroup module_api
@@ -330,6 +498,507 @@ The function returns the pointer to the output process image.
 //------------------------------------------------------------------------------
 void* oplk_getProcessImageOut(void)
 {
+    void*           pImage;
+
+    if (instance_l.fKernelAssembly && ((pImage = pdou_getKernelPiOut()) != NULL))
+        return pImage;
+
+    if (instance_l.fZeroCopy && ((pImage = pdou_getZeroCopyRxPdo()) != NULL))
+        return pImage;
+
     return instance_l.outputImage.pImage;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Enable zero-copy process images
+
+The function enables or disables the zero-copy mode of the process images. In
+zero-copy mode oplk_getProcessImageIn() and oplk_getProcessImageOut() return
+pointers into the PDO buffers and the exchange functions only switch the
+buffers instead of copying the process images. This is possible if all objects
+of a single PDO channel are linked to the process image at the offset where
+they are located in the PDO and they don't need a conversion. Otherwise the
+process image is copied as usual. The pointers have to be fetched again after
+each exchange.
+
+In zero-copy mode the process image variables in the object dictionary are
+not updated.
+
+\param  fEnable_p               TRUE enables the zero-copy mode, FALSE disables it.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    Zero-copy mode is successfully set up.
+\retval kErrorApiPINotAllocated     Memory for process images is not allocated.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_setProcessImageZeroCopy(BOOL fEnable_p)
+{
+    tOplkError      ret;
+
+    if ((instance_l.inputImage.pImage == NULL) || (instance_l.outputImage.pImage == NULL))
+        return kErrorApiPINotAllocated;
+
+    if (fEnable_p)
+    {
+        ret = pdou_setupZeroCopy(instance_l.outputImage.pImage, instance_l.outputImage.imageSize,
+                                 instance_l.inputImage.pImage, instance_l.inputImage.imageSize);
+    }
+    else
+    {
+        ret = pdou_setupZeroCopy(NULL, 0, NULL, 0);
+    }
+
+    if (ret == kErrorOk)
+        instance_l.fZeroCopy = fEnable_p;
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Enable assembly of the process images in the kernel layer
+
+The function enables or disables the assembly of the process images in the
+kernel layer. It is intended for kernel-interface builds, where the user layer
+otherwise copies every PDO from the PDO memory into the process images. The
+kernel layer copies the received RXPDOs into the output process image and
+publishes it at the sync event, and it copies the TXPDOs from the input process
+image which was exchanged last. The images are located in the PDO memory, so
+oplk_getProcessImageIn() and oplk_getProcessImageOut() return pointers into
+it and the exchange functions only switch the buffers. The pointers have to be
+fetched again after each exchange.
+
+This is possible if all mapped objects are linked to the process images and
+don't need a conversion. Otherwise the process images are copied as usual. The
+process images must not exceed CONFIG_PDO_KERNEL_PI_SIZE. The mode takes
+precedence over the zero-copy mode. The process image variables in the object
+dictionary and the RXPDO update information are not updated, and the partial
+exchange functions are not supported.
+
+\param  fEnable_p               TRUE enables the kernel assembly, FALSE disables it.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    The kernel assembly is successfully set up.
+\retval kErrorApiPINotAllocated     Memory for process images is not allocated.
+\retval kErrorApiPISizeExceeded     A process image exceeds CONFIG_PDO_KERNEL_PI_SIZE.
+\retval kErrorApiNotSupported       The stack is compiled without CONFIG_PDO_KERNEL_PI.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_setProcessImageKernelAssembly(BOOL fEnable_p)
+{
+    tOplkError      ret;
+
+    if ((instance_l.inputImage.pImage == NULL) || (instance_l.outputImage.pImage == NULL))
+        return kErrorApiPINotAllocated;
+
+    if (fEnable_p)
+    {
+        ret = pdou_setupKernelPi(instance_l.outputImage.pImage, instance_l.outputImage.imageSize,
+                                 instance_l.inputImage.pImage, instance_l.inputImage.imageSize);
+    }
+    else
+    {
+        ret = pdou_setupKernelPi(NULL, 0, NULL, 0);
+    }
+
+    if (ret == kErrorOk)
+        instance_l.fKernelAssembly = fEnable_p;
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Enable snapshots of the input process image
+
+The function enables or disables snapshots of the input process image. If
+enabled, oplk_exchangeProcessImageIn() copies the exchanged input process image
+into a separate buffer, from which oplk_getProcessImageInSnapshot() reads. The
+application writes the input process image itself, so the image can only be
+read consistently at the exchange.
+
+The function must not be called concurrently with
+oplk_exchangeProcessImageIn().
+
+\param  fEnable_p               TRUE enables the snapshots, FALSE disables them.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    Snapshots are successfully enabled or disabled.
+\retval kErrorApiPINotAllocated     Memory for process images is not allocated.
+\retval kErrorApiPIOutOfMemory      The snapshot buffer could not be allocated.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_enableProcessImageInSnapshot(BOOL fEnable_p)
+{
+    UINT8*          pSnapshot;
+
+    if (instance_l.inputImage.pImage == NULL)
+        return kErrorApiPINotAllocated;
+
+    if (!fEnable_p)
+    {
+        pSnapshot = instance_l.pInputSnapshot;
+        instance_l.pInputSnapshot = NULL;
+        if (pSnapshot != NULL)
+            OPLK_FREE(pSnapshot);
+        return kErrorOk;
+    }
+
+    if (instance_l.pInputSnapshot != NULL)
+        return kErrorOk;
+
+    pSnapshot = (UINT8*)OPLK_MALLOC(instance_l.inputImage.imageSize);
+    if (pSnapshot == NULL)
+        return kErrorApiPIOutOfMemory;
+
+    // the snapshot contains zeros until the first exchange
+    OPLK_MEMSET(pSnapshot, 0, instance_l.inputImage.imageSize);
+    instance_l.pInputSnapshot = pSnapshot;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read a consistent snapshot of the input process image
+
+The function copies a region of the input process image as it was exchanged by
+the last call of oplk_exchangeProcessImageIn(). It may be called by any thread.
+It never blocks the exchange, instead it repeats the copy if an exchange
+occurred in the meantime. Snapshots have to be enabled by
+oplk_enableProcessImageInSnapshot().
+
+\param  pDest_p                 Pointer to store the copied data.
+\param  offset_p                Offset of the region in the input process image.
+\param  size_p                  Size of the region in bytes.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    The snapshot is copied.
+\retval kErrorApiInvalidParam       The destination pointer is NULL.
+\retval kErrorApiPINotAllocated     Memory for process images is not allocated.
+\retval kErrorApiPISizeExceeded     The region exceeds the process image.
+\retval kErrorApiNotSupported       Snapshots are not enabled or the zero-copy
+                                    mode is active.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getProcessImageInSnapshot(void* pDest_p, UINT offset_p, UINT size_p)
+{
+    tOplkError      ret;
+    UINT8*          pSnapshot;
+
+    ret = checkSnapshotRange(&instance_l.inputImage, pDest_p, offset_p, size_p);
+    if (ret != kErrorOk)
+        return ret;
+
+    pSnapshot = instance_l.pInputSnapshot;
+    if (pSnapshot == NULL)
+        return kErrorApiNotSupported;
+
+    readSnapshot(&instance_l.inputSequence, pSnapshot + offset_p, pDest_p, size_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read a consistent snapshot of the output process image
+
+The function copies a region of the output process image as it was exchanged
+by the last call of oplk_exchangeProcessImageOut(). It may be called by any
+thread, e.g. an HMI or logging thread. It never blocks the exchange, instead it
+repeats the copy if an exchange occurred in the meantime.
+
+\param  pDest_p                 Pointer to store the copied data.
+\param  offset_p                Offset of the region in the output process image.
+\param  size_p                  Size of the region in bytes.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    The snapshot is copied.
+\retval kErrorApiInvalidParam       The destination pointer is NULL.
+\retval kErrorApiPINotAllocated     Memory for process images is not allocated.
+\retval kErrorApiPISizeExceeded     The region exceeds the process image.
+\retval kErrorApiNotSupported       The zero-copy mode is active.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getProcessImageOutSnapshot(void* pDest_p, UINT offset_p, UINT size_p)
+{
+    tOplkError      ret;
+
+    ret = checkSnapshotRange(&instance_l.outputImage, pDest_p, offset_p, size_p);
+    if (ret != kErrorOk)
+        return ret;
+
+    readSnapshot(&instance_l.outputSequence, (UINT8*)instance_l.outputImage.pImage + offset_p,
+                 pDest_p, size_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Enable write tracking of the input process image
+
+The function enables or disables the write tracking of the input process image.
+If write tracking is enabled, oplk_exchangeProcessImageIn() only encodes the
+TXPDOs which contain data marked as written by oplk_markProcessImageInDirty()
+since the last exchange. The other TXPDOs keep their last data. This also
+applies to mapped objects which are not linked to the process image.
+
+\param  fEnable_p               TRUE enables write tracking, FALSE disables it.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    Write tracking is successfully set up.
+\retval kErrorApiPINotAllocated     Memory for process images is not allocated.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_enableProcessImageInDirtyTracking(BOOL fEnable_p)
+{
+    if (instance_l.inputImage.pImage == NULL)
+        return kErrorApiPINotAllocated;
+
+    pdou_enableTxPdoDirtyTracking(fEnable_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Mark a region of the input process image as written
+
+The function marks a region of the input process image as written. The TXPDOs
+which contain data of this region are encoded at the next call of
+oplk_exchangeProcessImageIn().
+
+\param  offset_p                Offset of the written region in the input
+                                process image.
+\param  size_p                  Size of the written region.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    Region is successfully marked.
+\retval kErrorApiPINotAllocated     Memory for process images is not allocated.
+\retval kErrorApiPISizeExceeded     Region exceeds the input process image.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_markProcessImageInDirty(UINT offset_p, UINT size_p)
+{
+    if (instance_l.inputImage.pImage == NULL)
+        return kErrorApiPINotAllocated;
+
+    if ((offset_p > instance_l.inputImage.imageSize) ||
+        (size_p > (instance_l.inputImage.imageSize - offset_p)))
+        return kErrorApiPISizeExceeded;
+
+    pdou_markTxPdoDirty((BYTE*)instance_l.inputImage.pImage + offset_p, size_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the nodes with fresh data in the output process image
+
+The function returns a bitmap of the nodes whose RXPDOs contained new data at
+the last call of oplk_exchangeProcessImageOut(). Bit n of the bitmap (byte
+n / 8, bit n % 8) represents node ID n, 32 bytes cover all node IDs. The
+application can use it to process only the data of the nodes which have been
+updated instead of comparing the whole output process image.
+
+\param  pNodeBitmap_p           Pointer to store the bitmap.
+\param  bitmapSize_p            Size of the bitmap buffer in bytes.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    The bitmap is returned.
+\retval kErrorApiInvalidParam       The bitmap pointer is NULL.
+\retval kErrorApiPINotAllocated     Memory for process images is not allocated.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getProcessImageOutUpdates(UINT8* pNodeBitmap_p, UINT bitmapSize_p)
+{
+    if (pNodeBitmap_p == NULL)
+        return kErrorApiInvalidParam;
+
+    if (instance_l.outputImage.pImage == NULL)
+        return kErrorApiPINotAllocated;
+
+    OPLK_MEMSET(pNodeBitmap_p, 0, bitmapSize_p);
+    pdou_getRxPdoUpdates(pNodeBitmap_p, bitmapSize_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the RXPDO sequence number of a node
+
+The function returns the sequence number of the RXPDO of the specified node
+which has been copied into the output process image by the last call of
+oplk_exchangeProcessImageOut(). The sequence number is incremented with every
+PDO received from the node. An application which does not exchange the output
+process image in every cycle can use it to detect stale data of a node.
+
+\param  nodeId_p                Node ID of the RXPDO.
+\param  pSequence_p             Pointer to store the sequence number. 0 means
+                                that no PDO has been received yet.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    The sequence number is returned.
+\retval kErrorApiInvalidParam       The sequence pointer is NULL.
+\retval kErrorApiPINotAllocated     Memory for process images is not allocated.
+\retval kErrorPdoNotExist           No RXPDO is configured for the node.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getProcessImageOutSequence(UINT nodeId_p, UINT32* pSequence_p)
+{
+    if (pSequence_p == NULL)
+        return kErrorApiInvalidParam;
+
+    if (instance_l.outputImage.pImage == NULL)
+        return kErrorApiPINotAllocated;
+
+    return pdou_getRxPdoSequence(nodeId_p, pSequence_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Route RPDO data into a TPDO
+
+The function adds a route which forwards a region of an RPDO into a TPDO in the
+kernel layer. The data is inserted into the TPDO when it is sent and does not
+pass the process images, so a gateway can forward data with the latency of the
+kernel layer instead of the application cycle. The region of the TPDO is
+overwritten by the route as soon as the first RPDO has been received, therefore
+the application must not write the objects mapped to it.
+
+The routes are removed if the PDO channels are reallocated, i.e. they must be
+added after the mapping has been configured. The number of routes and their
+total size are limited by CONFIG_PDO_ROUTE_COUNT and
+CONFIG_PDO_ROUTE_BUFFER_SIZE of the kernel layer.
+
+\param  rxMappParamIndex_p      Index of the mapping parameter object of the
+                                RPDO (0x1600 - 0x16FF).
+\param  rxOffset_p              Offset of the region in the RPDO in bytes.
+\param  size_p                  Size of the region in bytes.
+\param  txMappParamIndex_p      Index of the mapping parameter object of the
+                                TPDO (0x1A00 - 0x1AFF).
+\param  txOffset_p              Offset of the region in the TPDO in bytes.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                    The route is passed to the kernel layer.
+\retval kErrorApiInvalidParam       The indices or the region are invalid.
+\retval kErrorPdoNotExist           The RPDO or TPDO is not configured.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_addPdoRoute(UINT rxMappParamIndex_p, UINT rxOffset_p, UINT size_p,
+                            UINT txMappParamIndex_p, UINT txOffset_p)
+{
+    return pdou_addPdoRoute(rxMappParamIndex_p, rxOffset_p, size_p,
+                            txMappParamIndex_p, txOffset_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Remove all PDO routes
+
+The function removes all routes added by oplk_addPdoRoute().
+
+\return The function returns a \ref tOplkError error code.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_clearPdoRoutes(void)
+{
+    return pdou_clearPdoRoutes();
+}
+
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check the parameters of a snapshot
+
+\param  pImage_p                Pointer to the process image.
+\param  pDest_p                 Pointer to store the copied data.
+\param  offset_p                Offset of the region in the process image.
+\param  size_p                  Size of the region in bytes.
+
+\return The function returns a \ref tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError checkSnapshotRange(const tOplkApiProcessImage* pImage_p, void* pDest_p,
+                                     UINT offset_p, UINT size_p)
+{
+    if (pDest_p == NULL)
+        return kErrorApiInvalidParam;
+
+    if (pImage_p->pImage == NULL)
+        return kErrorApiPINotAllocated;
+
+    if ((offset_p > pImage_p->imageSize) || (size_p > (pImage_p->imageSize - offset_p)))
+        return kErrorApiPISizeExceeded;
+
+    // in zero-copy mode and with kernel assembly the exchange switches the buffers
+    if (instance_l.fZeroCopy || instance_l.fKernelAssembly)
+        return kErrorApiNotSupported;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy data guarded by a sequence counter
+
+The function copies the data and repeats the copy until the sequence counter
+was even and unchanged during the copy, i.e. no writer modified the data.
+
+\param  pSequence_p             Pointer to the sequence counter of the data.
+\param  pSource_p               Pointer to the data.
+\param  pDest_p                 Pointer to store the copied data.
+\param  size_p                  Size of the data in bytes.
+*/
+//------------------------------------------------------------------------------
+static void readSnapshot(const volatile UINT32* pSequence_p, const UINT8* pSource_p,
+                         void* pDest_p, UINT size_p)
+{
+    UINT32      sequence;
+
+    do
+    {
+        do
+        {
+            sequence = *pSequence_p;
+        } while ((sequence & 1) != 0);
+
+        OPLK_MEMBAR();
+        OPLK_MEMCPY(pDest_p, pSource_p, size_p);
+        OPLK_MEMBAR();
+    } while (sequence != *pSequence_p);
+}
+
+/// \}
@@ -0,0 +1,814 @@
+/**
+********************************************************************************
+\file   sdobatch.c
+
+\brief  Batched SDO client API
+
+This file implements the batched SDO client API. The application posts lists
+of SDO requests with oplk_postSdoRequests(). The requests are scheduled on a
+limited number of concurrent command layer connections. A connection stays
+assigned to its node as long as requests for this node are pending, so
+consecutive requests to the same node share one connection. The results are
+stored in a completion queue which is polled with oplk_getSdoCompletions().
+
+The requests are started in the context of oplk_postSdoRequests() and of the
+SDO finished callback. Like the other SDO API functions,
+oplk_postSdoRequests() must not be called concurrently with the processing of
+the stack. oplk_getSdoCompletions() may be called from any thread.
+
+\ingroup module_api
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+#include <user/sdocom.h>
+#include <user/cfmu.h>
+#include <user/sdobatch.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+// Maximum number of requests which are pending, running or completed but not
+// yet fetched by the application
+#ifndef CONFIG_API_SDO_BATCH_QUEUE_SIZE
+#define CONFIG_API_SDO_BATCH_QUEUE_SIZE         256
+#endif
+
+// Maximum number of concurrent SDO connections used for batched requests
+#ifndef CONFIG_API_SDO_BATCH_MAX_CONNECTIONS
+#define CONFIG_API_SDO_BATCH_MAX_CONNECTIONS    8
+#endif
+
+// Maximum number of requests to the same node which are performed by one Read
+// or Write Multiple Parameter by Index transfer (1 = single transfers only)
+#ifndef CONFIG_API_SDO_BATCH_MULTI_ENTRIES
+#define CONFIG_API_SDO_BATCH_MULTI_ENTRIES      16
+#endif
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define SDO_BATCH_NO_REQUEST        CONFIG_API_SDO_BATCH_QUEUE_SIZE
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+#if defined(CONFIG_INCLUDE_SDOC)
+/**
+\brief  SDO batch channel
+
+The structure describes a connection which is used for batched SDO requests.
+*/
+typedef struct
+{
+    BOOL                fConnected;             ///< The channel is assigned to a command layer connection
+    BOOL                fOwner;                 ///< The connection was defined by the channel and is freed by it
+    tSdoComConHdl       sdoComConHdl;           ///< Handle of the command layer connection
+    UINT                nodeId;                 ///< Node ID the connection is assigned to
+    tSdoType            sdoType;                ///< SDO type of the connection
+    tOplkApiSdoRequest* pRequest;               ///< Running request (NULL if the channel is idle)
+#if (CONFIG_API_SDO_BATCH_MULTI_ENTRIES > 1)
+    tOplkApiSdoRequest* apMultiRequest[CONFIG_API_SDO_BATCH_MULTI_ENTRIES];  ///< Requests of the running multiple parameter transfer
+    tSdoMultiAccEntry   aMultiEntry[CONFIG_API_SDO_BATCH_MULTI_ENTRIES];     ///< Entries of the running multiple parameter transfer
+    UINT                multiCount;             ///< Number of requests of the running multiple parameter transfer (0 = single transfer)
+    BOOL                fNoMulti;               ///< The node does not support multiple parameter transfers
+#endif
+} tSdoBatchChannel;
+
+/**
+\brief  SDO batch instance
+
+The structure contains all variables of the SDO batch module.
+*/
+typedef struct
+{
+    tSdoBatchChannel        aChannel[CONFIG_API_SDO_BATCH_MAX_CONNECTIONS];     ///< Connections for batched requests
+    UINT                    maxConnections;                                     ///< Number of connections which may be used
+    tOplkApiSdoRequest*     apPending[CONFIG_API_SDO_BATCH_QUEUE_SIZE];         ///< Pending requests in posting order
+    UINT                    pendingCount;                                       ///< Number of pending requests
+    UINT                    runningCount;                                       ///< Number of running requests
+    tOplkApiSdoCompletion   aCompletion[CONFIG_API_SDO_BATCH_QUEUE_SIZE];       ///< Completion queue
+    volatile UINT           completionWriteIndex;                               ///< Number of written completions
+    volatile UINT           completionReadIndex;                                ///< Number of fetched completions
+} tSdoBatchInstance;
+#endif
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+#if defined(CONFIG_INCLUDE_SDOC)
+static tSdoBatchInstance    sdoBatchInstance_l;
+#endif
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+#if defined(CONFIG_INCLUDE_SDOC)
+static void       scheduleRequests(void);
+static UINT       findPendingRequest(tSdoBatchChannel* pChannel_p);
+static void       startRequest(tSdoBatchChannel* pChannel_p, UINT pendingIndex_p);
+#if (CONFIG_API_SDO_BATCH_MULTI_ENTRIES > 1)
+static BOOL       startMultiRequest(tSdoBatchChannel* pChannel_p, tOplkApiSdoRequest* pRequest_p);
+static void       finishMultiRequest(tSdoBatchChannel* pChannel_p, tSdoComFinished* pSdoComFinished_p);
+#endif
+static void       releaseChannel(tSdoBatchChannel* pChannel_p);
+static void       completeRequest(tOplkApiSdoRequest* pRequest_p, tOplkError errorCode_p,
+                                  tSdoComConState sdoComConState_p, UINT32 abortCode_p,
+                                  UINT transferredBytes_p);
+static tOplkError cbSdoFinished(tSdoComFinished* pSdoComFinished_p);
+#endif
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize SDO batch module
+
+The function initializes the SDO batch module.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError sdobatch_init(void)
+{
+#if defined(CONFIG_INCLUDE_SDOC)
+    OPLK_MEMSET(&sdoBatchInstance_l, 0, sizeof(sdoBatchInstance_l));
+    sdoBatchInstance_l.maxConnections = CONFIG_API_SDO_BATCH_MAX_CONNECTIONS;
+#endif
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Clean up SDO batch module
+
+The function cleans up the SDO batch module. It frees the connections of the
+module. Pending requests are discarded without completion.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError sdobatch_exit(void)
+{
+#if defined(CONFIG_INCLUDE_SDOC)
+    UINT    channelIndex;
+
+    for (channelIndex = 0; channelIndex < CONFIG_API_SDO_BATCH_MAX_CONNECTIONS; channelIndex++)
+        releaseChannel(&sdoBatchInstance_l.aChannel[channelIndex]);
+
+    OPLK_MEMSET(&sdoBatchInstance_l, 0, sizeof(sdoBatchInstance_l));
+#endif
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Post SDO requests
+
+The function posts a list of SDO requests. The requests are performed in the
+background and their results are reported through the completion queue (see
+oplk_getSdoCompletions()). Requests to the same node are performed one after
+another on the same connection. Consecutive small requests with the same
+access type to the same node are combined into one Read or Write Multiple
+Parameter by Index transfer. The requests to different nodes are performed
+concurrently on up to CONFIG_API_SDO_BATCH_MAX_CONNECTIONS connections (see
+oplk_setSdoBatchConcurrency()). Requests to the local node are performed
+immediately.
+
+Either all or none of the requests are posted.
+
+\param  aRequest_p          Array of SDO requests. The requests must stay
+                            valid until their completions are fetched.
+\param  requestCount_p      Number of requests in the array.
+
+\return The function returns a \ref tOplkError error code.
+\retval kErrorOk                The requests were posted.
+\retval kErrorApiSdoQueueFull   The queue has not enough free entries.
+\retval Other                   Invalid request.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_postSdoRequests(tOplkApiSdoRequest* aRequest_p, UINT requestCount_p)
+{
+#if defined(CONFIG_INCLUDE_SDOC)
+    tOplkApiSdoRequest* pRequest;
+    tOplkError          ret;
+    UINT                count;
+    UINT                usedEntries;
+    tObdSize            obdSize;
+
+    if ((aRequest_p == NULL) || (requestCount_p == 0))
+        return kErrorApiInvalidParam;
+
+    for (count = 0; count < requestCount_p; count++)
+    {
+        pRequest = &aRequest_p[count];
+        if ((pRequest->index == 0) || (pRequest->pData == NULL) || (pRequest->size == 0) ||
+            ((pRequest->accessType != kSdoAccessTypeRead) && (pRequest->accessType != kSdoAccessTypeWrite)) ||
+            (pRequest->nodeId >= C_ADR_BROADCAST))
+            return kErrorApiInvalidParam;
+    }
+
+    usedEntries = sdoBatchInstance_l.pendingCount + sdoBatchInstance_l.runningCount +
+                  (sdoBatchInstance_l.completionWriteIndex - sdoBatchInstance_l.completionReadIndex);
+    if ((usedEntries + requestCount_p) > CONFIG_API_SDO_BATCH_QUEUE_SIZE)
+        return kErrorApiSdoQueueFull;
+
+    for (count = 0; count < requestCount_p; count++)
+    {
+        pRequest = &aRequest_p[count];
+        if ((pRequest->nodeId == 0) || (pRequest->nodeId == obd_getNodeId()))
+        {   // local OD access can be performed immediately
+            if (pRequest->accessType == kSdoAccessTypeRead)
+            {
+                obdSize = (tObdSize)pRequest->size;
+                ret = obd_readEntryToLe(pRequest->index, pRequest->subindex, pRequest->pData, &obdSize);
+            }
+            else
+            {
+                obdSize = (tObdSize)pRequest->size;
+                ret = obd_writeEntryFromLe(pRequest->index, pRequest->subindex, pRequest->pData, obdSize);
+            }
+
+            completeRequest(pRequest, ret,
+                            (ret == kErrorOk) ? kSdoComTransferFinished : kSdoComTransferNotActive,
+                            0, (ret == kErrorOk) ? (UINT)obdSize : 0);
+        }
+        else
+        {
+            sdoBatchInstance_l.apPending[sdoBatchInstance_l.pendingCount++] = pRequest;
+        }
+    }
+
+    scheduleRequests();
+    return kErrorOk;
+#else
+    UNUSED_PARAMETER(aRequest_p);
+    UNUSED_PARAMETER(requestCount_p);
+
+    return kErrorApiNotSupported;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get SDO completions
+
+The function fetches completions of SDO requests which were posted with
+oplk_postSdoRequests() from the completion queue. It does not wait for
+completions.
+
+\param  aCompletion_p       Array to store the completions.
+\param  maxCount_p          Number of entries in the array.
+\param  pCount_p            Pointer to store the number of fetched completions.
+
+\return The function returns a \ref tOplkError error code.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_getSdoCompletions(tOplkApiSdoCompletion* aCompletion_p, UINT maxCount_p,
+                                  UINT* pCount_p)
+{
+#if defined(CONFIG_INCLUDE_SDOC)
+    UINT    count;
+    UINT    readIndex;
+
+    if ((aCompletion_p == NULL) || (pCount_p == NULL))
+        return kErrorApiInvalidParam;
+
+    readIndex = sdoBatchInstance_l.completionReadIndex;
+    for (count = 0; (count < maxCount_p) && (readIndex != sdoBatchInstance_l.completionWriteIndex); count++)
+    {
+        aCompletion_p[count] = sdoBatchInstance_l.aCompletion[readIndex % CONFIG_API_SDO_BATCH_QUEUE_SIZE];
+        readIndex++;
+    }
+    sdoBatchInstance_l.completionReadIndex = readIndex;
+
+    *pCount_p = count;
+    return kErrorOk;
+#else
+    UNUSED_PARAMETER(aCompletion_p);
+    UNUSED_PARAMETER(maxCount_p);
+    UNUSED_PARAMETER(pCount_p);
+
+    return kErrorApiNotSupported;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set SDO batch concurrency
+
+The function sets the number of connections which are used concurrently for
+batched SDO requests. If the number is decreased, running requests are
+finished before their connections are freed.
+
+\param  maxConnections_p    Number of concurrent connections
+                            (1 .. CONFIG_API_SDO_BATCH_MAX_CONNECTIONS).
+
+\return The function returns a \ref tOplkError error code.
+
+\ingroup module_api
+*/
+//------------------------------------------------------------------------------
+tOplkError oplk_setSdoBatchConcurrency(UINT maxConnections_p)
+{
+#if defined(CONFIG_INCLUDE_SDOC)
+    if ((maxConnections_p == 0) || (maxConnections_p > CONFIG_API_SDO_BATCH_MAX_CONNECTIONS))
+        return kErrorApiInvalidParam;
+
+    sdoBatchInstance_l.maxConnections = maxConnections_p;
+    scheduleRequests();
+    return kErrorOk;
+#else
+    UNUSED_PARAMETER(maxConnections_p);
+
+    return kErrorApiNotSupported;
+#endif
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+#if defined(CONFIG_INCLUDE_SDOC)
+//------------------------------------------------------------------------------
+/**
+\brief  Schedule pending requests
+
+The function starts pending requests on all idle channels. An idle channel
+continues with the next request for its node. If no request for its node is
+pending, the connection is freed and the channel is assigned to the node of
+the oldest pending request which is not served by another channel.
+*/
+//------------------------------------------------------------------------------
+static void scheduleRequests(void)
+{
+    UINT                channelIndex;
+    UINT                pendingIndex;
+    tSdoBatchChannel*   pChannel;
+
+    for (channelIndex = 0; channelIndex < CONFIG_API_SDO_BATCH_MAX_CONNECTIONS; channelIndex++)
+    {
+        pChannel = &sdoBatchInstance_l.aChannel[channelIndex];
+        while (pChannel->pRequest == NULL)
+        {
+            if (channelIndex >= sdoBatchInstance_l.maxConnections)
+            {   // channel exceeds the concurrency limit
+                releaseChannel(pChannel);
+                break;
+            }
+
+            pendingIndex = findPendingRequest(pChannel);
+            if (pendingIndex == SDO_BATCH_NO_REQUEST)
+            {
+                if (pChannel->fConnected)
+                {   // no more requests for the node, try another node
+                    releaseChannel(pChannel);
+                    continue;
+                }
+                break;
+            }
+
+            startRequest(pChannel, pendingIndex);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find pending request for a channel
+
+The function searches the oldest pending request which can be started on the
+channel. For a connected channel only requests for its node and SDO type are
+considered. For an unconnected channel only requests for nodes which are not
+served by another channel and which are not configured by the CFM are
+considered.
+
+\param  pChannel_p          Pointer to the channel.
+
+\return The function returns the index of the pending request or
+        SDO_BATCH_NO_REQUEST if no request can be started.
+*/
+//------------------------------------------------------------------------------
+static UINT findPendingRequest(tSdoBatchChannel* pChannel_p)
+{
+    UINT                pendingIndex;
+    UINT                channelIndex;
+    tOplkApiSdoRequest* pRequest;
+
+    for (pendingIndex = 0; pendingIndex < sdoBatchInstance_l.pendingCount; pendingIndex++)
+    {
+        pRequest = sdoBatchInstance_l.apPending[pendingIndex];
+        if (pChannel_p->fConnected)
+        {
+            if ((pRequest->nodeId == pChannel_p->nodeId) && (pRequest->sdoType == pChannel_p->sdoType))
+                return pendingIndex;
+            continue;
+        }
+
+#if defined(CONFIG_INCLUDE_CFM)
+        if (cfmu_isSdoRunning(pRequest->nodeId))
+            continue;
+#endif
+
+        for (channelIndex = 0; channelIndex < CONFIG_API_SDO_BATCH_MAX_CONNECTIONS; channelIndex++)
+        {
+            if (sdoBatchInstance_l.aChannel[channelIndex].fConnected &&
+                (sdoBatchInstance_l.aChannel[channelIndex].nodeId == pRequest->nodeId))
+                break;
+        }
+
+        if (channelIndex == CONFIG_API_SDO_BATCH_MAX_CONNECTIONS)
+            return pendingIndex;
+    }
+
+    return SDO_BATCH_NO_REQUEST;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Start request
+
+The function removes a request from the pending requests and starts it on the
+channel. If the channel is not connected yet, the command layer connection to
+the node of the request is defined. If the request cannot be started, it is
+completed with the error.
+
+\param  pChannel_p          Pointer to the channel.
+\param  pendingIndex_p      Index of the pending request.
+*/
+//------------------------------------------------------------------------------
+static void startRequest(tSdoBatchChannel* pChannel_p, UINT pendingIndex_p)
+{
+    tOplkError                  ret;
+    tOplkApiSdoRequest*         pRequest;
+    tSdoComTransParamByIndex    transParamByIndex;
+    UINT                        index;
+
+    pRequest = sdoBatchInstance_l.apPending[pendingIndex_p];
+
+    // remove request from pending requests and keep the posting order
+    sdoBatchInstance_l.pendingCount--;
+    for (index = pendingIndex_p; index < sdoBatchInstance_l.pendingCount; index++)
+        sdoBatchInstance_l.apPending[index] = sdoBatchInstance_l.apPending[index + 1];
+
+    if (!pChannel_p->fConnected)
+    {
+        ret = sdocom_defineConnection(&pChannel_p->sdoComConHdl, pRequest->nodeId, pRequest->sdoType);
+        if ((ret != kErrorOk) && (ret != kErrorSdoComHandleExists))
+        {
+            completeRequest(pRequest, ret, kSdoComTransferNotActive, 0, 0);
+            return;
+        }
+
+        // a connection which was defined by the application is used, but not freed
+        pChannel_p->fOwner = (ret == kErrorOk);
+        pChannel_p->fConnected = TRUE;
+        pChannel_p->nodeId = pRequest->nodeId;
+        pChannel_p->sdoType = pRequest->sdoType;
+#if (CONFIG_API_SDO_BATCH_MULTI_ENTRIES > 1)
+        pChannel_p->fNoMulti = FALSE;
+#endif
+    }
+
+#if (CONFIG_API_SDO_BATCH_MULTI_ENTRIES > 1)
+    if (startMultiRequest(pChannel_p, pRequest))
+        return;
+#endif
+
+    transParamByIndex.pData = pRequest->pData;
+    transParamByIndex.sdoAccessType = pRequest->accessType;
+    transParamByIndex.sdoComConHdl = pChannel_p->sdoComConHdl;
+    transParamByIndex.dataSize = pRequest->size;
+    transParamByIndex.index = pRequest->index;
+    transParamByIndex.subindex = pRequest->subindex;
+    transParamByIndex.pfnSdoFinishedCb = cbSdoFinished;
+    transParamByIndex.pUserArg = pChannel_p;
+    transParamByIndex.pStream = NULL;
+    transParamByIndex.paScatterList = NULL;
+    transParamByIndex.scatterEntryCount = 0;
+
+    pChannel_p->pRequest = pRequest;
+    sdoBatchInstance_l.runningCount++;
+
+    ret = sdocom_initTransferByIndex(&transParamByIndex);
+    if ((ret != kErrorOk) && (pChannel_p->pRequest == pRequest))
+    {   // transfer was not started
+        pChannel_p->pRequest = NULL;
+        sdoBatchInstance_l.runningCount--;
+        completeRequest(pRequest, ret, kSdoComTransferNotActive, 0, 0);
+    }
+}
+
+#if (CONFIG_API_SDO_BATCH_MULTI_ENTRIES > 1)
+//------------------------------------------------------------------------------
+/**
+\brief  Start multiple parameter request
+
+The function collects the pending requests for the node of the channel which
+follow the request with the same access type and starts them together with the
+request as one Read or Write Multiple Parameter by Index transfer. Requests
+are collected as long as the transfer fits into a single segment. If the
+request cannot be combined with other requests, the function does nothing.
+
+\param  pChannel_p          Pointer to the connected channel.
+\param  pRequest_p          Pointer to the request which was removed from the
+                            pending requests.
+
+\return The function returns TRUE if the request was handled, otherwise FALSE.
+*/
+//------------------------------------------------------------------------------
+static BOOL startMultiRequest(tSdoBatchChannel* pChannel_p, tOplkApiSdoRequest* pRequest_p)
+{
+    tOplkError                      ret;
+    tOplkApiSdoRequest*             pNextRequest;
+    tSdoComTransParamMultiByIndex   transParamMultiByIndex;
+    tSdoMultiAccEntry*              pEntry;
+    UINT                            pendingIndex;
+    UINT                            index;
+    UINT                            count;
+    UINT                            payloadSize;
+
+    // the response of a read uses the same sub-blocks as the request of a write
+    payloadSize = SDO_MULTI_SUBBLOCK_SIZE(pRequest_p->size);
+    if (pChannel_p->fNoMulti || (payloadSize > SDO_MULTI_MAX_PAYLOAD_SIZE))
+        return FALSE;
+
+    pChannel_p->apMultiRequest[0] = pRequest_p;
+    count = 1;
+    pendingIndex = 0;
+    while ((pendingIndex < sdoBatchInstance_l.pendingCount) && (count < CONFIG_API_SDO_BATCH_MULTI_ENTRIES))
+    {
+        pNextRequest = sdoBatchInstance_l.apPending[pendingIndex];
+        if ((pNextRequest->nodeId != pChannel_p->nodeId) || (pNextRequest->sdoType != pChannel_p->sdoType))
+        {
+            pendingIndex++;
+            continue;
+        }
+
+        // keep the order of the requests to the node
+        if ((pNextRequest->accessType != pRequest_p->accessType) ||
+            ((payloadSize + SDO_MULTI_SUBBLOCK_SIZE(pNextRequest->size)) > SDO_MULTI_MAX_PAYLOAD_SIZE))
+            break;
+
+        payloadSize += SDO_MULTI_SUBBLOCK_SIZE(pNextRequest->size);
+        pChannel_p->apMultiRequest[count++] = pNextRequest;
+
+        sdoBatchInstance_l.pendingCount--;
+        for (index = pendingIndex; index < sdoBatchInstance_l.pendingCount; index++)
+            sdoBatchInstance_l.apPending[index] = sdoBatchInstance_l.apPending[index + 1];
+    }
+
+    if (count == 1)
+        return FALSE;
+
+    for (index = 0; index < count; index++)
+    {
+        pEntry = &pChannel_p->aMultiEntry[index];
+        pEntry->index = pChannel_p->apMultiRequest[index]->index;
+        pEntry->subindex = pChannel_p->apMultiRequest[index]->subindex;
+        pEntry->pData = pChannel_p->apMultiRequest[index]->pData;
+        pEntry->dataSize = pChannel_p->apMultiRequest[index]->size;
+        pEntry->abortCode = 0;
+    }
+
+    transParamMultiByIndex.sdoComConHdl = pChannel_p->sdoComConHdl;
+    transParamMultiByIndex.paEntries = pChannel_p->aMultiEntry;
+    transParamMultiByIndex.entryCount = count;
+    transParamMultiByIndex.sdoAccessType = pRequest_p->accessType;
+    transParamMultiByIndex.pfnSdoFinishedCb = cbSdoFinished;
+    transParamMultiByIndex.pUserArg = pChannel_p;
+
+    pChannel_p->pRequest = pRequest_p;
+    pChannel_p->multiCount = count;
+    sdoBatchInstance_l.runningCount += count;
+
+    ret = sdocom_initTransferMultiByIndex(&transParamMultiByIndex);
+    if ((ret != kErrorOk) && (pChannel_p->pRequest == pRequest_p))
+    {   // transfer was not started
+        pChannel_p->pRequest = NULL;
+        pChannel_p->multiCount = 0;
+        sdoBatchInstance_l.runningCount -= count;
+        for (index = 0; index < count; index++)
+            completeRequest(pChannel_p->apMultiRequest[index], ret, kSdoComTransferNotActive, 0, 0);
+    }
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Finish multiple parameter request
+
+The function stores the results of the requests of a finished multiple
+parameter transfer in the completion queue. If the node does not support
+multiple parameter transfers, the requests are pending again and are
+performed one by one.
+
+\param  pChannel_p          Pointer to the channel.
+\param  pSdoComFinished_p   Pointer to the SDO finished information.
+*/
+//------------------------------------------------------------------------------
+static void finishMultiRequest(tSdoBatchChannel* pChannel_p, tSdoComFinished* pSdoComFinished_p)
+{
+    tSdoMultiAccEntry*  pEntry;
+    UINT                count;
+    UINT                index;
+
+    count = pChannel_p->multiCount;
+    pChannel_p->pRequest = NULL;
+    pChannel_p->multiCount = 0;
+    sdoBatchInstance_l.runningCount -= count;
+
+    if ((pSdoComFinished_p->sdoComConState == kSdoComTransferRxAborted) &&
+        (pSdoComFinished_p->abortCode == SDO_AC_UNKNOWN_COMMAND_SPECIFIER))
+    {   // put the requests in front of the pending requests, there is space for them
+        pChannel_p->fNoMulti = TRUE;
+        for (index = sdoBatchInstance_l.pendingCount; index > 0; index--)
+            sdoBatchInstance_l.apPending[index - 1 + count] = sdoBatchInstance_l.apPending[index - 1];
+        for (index = 0; index < count; index++)
+            sdoBatchInstance_l.apPending[index] = pChannel_p->apMultiRequest[index];
+        sdoBatchInstance_l.pendingCount += count;
+        return;
+    }
+
+    for (index = 0; index < count; index++)
+    {
+        pEntry = &pChannel_p->aMultiEntry[index];
+        if (pSdoComFinished_p->sdoComConState != kSdoComTransferFinished)
+        {
+            completeRequest(pChannel_p->apMultiRequest[index], kErrorOk, pSdoComFinished_p->sdoComConState,
+                            pSdoComFinished_p->abortCode, 0);
+        }
+        else if (pEntry->abortCode != 0)
+        {
+            completeRequest(pChannel_p->apMultiRequest[index], kErrorOk, kSdoComTransferRxAborted,
+                            pEntry->abortCode, 0);
+        }
+        else
+        {
+            completeRequest(pChannel_p->apMultiRequest[index], kErrorOk, kSdoComTransferFinished,
+                            0, pEntry->dataSize);
+        }
+    }
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief  Release channel
+
+The function frees the connection of an idle channel if it was defined by the
+channel.
+
+\param  pChannel_p          Pointer to the channel.
+*/
+//------------------------------------------------------------------------------
+static void releaseChannel(tSdoBatchChannel* pChannel_p)
+{
+    if (!pChannel_p->fConnected || (pChannel_p->pRequest != NULL))
+        return;
+
+    if (pChannel_p->fOwner)
+        sdocom_undefineConnection(pChannel_p->sdoComConHdl);
+
+    pChannel_p->fConnected = FALSE;
+    pChannel_p->fOwner = FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Complete request
+
+The function stores the result of a request in the completion queue.
+
+\param  pRequest_p          Pointer to the completed request.
+\param  errorCode_p         Error which prevented the transfer.
+\param  sdoComConState_p    State of the finished transfer.
+\param  abortCode_p         SDO abort code.
+\param  transferredBytes_p  Number of transferred bytes.
+*/
+//------------------------------------------------------------------------------
+static void completeRequest(tOplkApiSdoRequest* pRequest_p, tOplkError errorCode_p,
+                            tSdoComConState sdoComConState_p, UINT32 abortCode_p,
+                            UINT transferredBytes_p)
+{
+    tOplkApiSdoCompletion*  pCompletion;
+
+    // The queue cannot overflow, because oplk_postSdoRequests() only accepts
+    // requests for free entries.
+    pCompletion = &sdoBatchInstance_l.aCompletion[sdoBatchInstance_l.completionWriteIndex %
+                                                  CONFIG_API_SDO_BATCH_QUEUE_SIZE];
+    pCompletion->pRequest = pRequest_p;
+    pCompletion->errorCode = errorCode_p;
+    pCompletion->sdoComConState = sdoComConState_p;
+    pCompletion->abortCode = abortCode_p;
+    pCompletion->transferredBytes = transferredBytes_p;
+
+    sdoBatchInstance_l.completionWriteIndex++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Callback function for batched SDO transfers
+
+The function is called by the SDO command layer when a batched SDO transfer is
+finished. It stores the result in the completion queue and starts the next
+pending requests.
+
+\param  pSdoComFinished_p   Pointer to the SDO finished information.
+
+\return The function returns a \ref tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError cbSdoFinished(tSdoComFinished* pSdoComFinished_p)
+{
+    tSdoBatchChannel*   pChannel;
+    tOplkApiSdoRequest* pRequest;
+
+    pChannel = (tSdoBatchChannel*)pSdoComFinished_p->pUserArg;
+    if ((pChannel == NULL) || (pChannel->pRequest == NULL))
+        return kErrorOk;
+
+#if (CONFIG_API_SDO_BATCH_MULTI_ENTRIES > 1)
+    if (pChannel->multiCount > 0)
+    {
+        finishMultiRequest(pChannel, pSdoComFinished_p);
+        scheduleRequests();
+        return kErrorOk;
+    }
+#endif
+
+    pRequest = pChannel->pRequest;
+    pChannel->pRequest = NULL;
+    sdoBatchInstance_l.runningCount--;
+
+    completeRequest(pRequest, kErrorOk, pSdoComFinished_p->sdoComConState,
+                    pSdoComFinished_p->abortCode, pSdoComFinished_p->transferredBytes);
+
+    scheduleRequests();
+    return kErrorOk;
+}
+#endif
+
+/// \}
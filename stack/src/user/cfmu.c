@@ -51,6 +51,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <user/sdocom.h>
 #include <user/nmtu.h>
 
+#if (CONFIG_OBD_USE_LOAD_CONCISEDCF != FALSE)
+#include <oplk/obdcdc.h>
+#endif
+
 #if !defined(CONFIG_INCLUDE_SDOC)
 #error "CFM module needs openPOWERLINK module SDO client!"
 #endif
@@ -70,10 +74,36 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_CFM_CONFIGURE_CYCLE_LENGTH  FALSE
 #endif
 
+// maximum number of CNs which are configured in parallel (0 = unlimited)
+#ifndef CONFIG_CFM_MAX_PARALLEL_DOWNLOADS
+#define CONFIG_CFM_MAX_PARALLEL_DOWNLOADS  0
+#endif
+
+// maximum number of consecutive ConciseDCF entries which are written by one
+// Write Multiple Parameter by Index transfer (1 = single writes only)
+#ifndef CONFIG_CFM_MULTI_ENTRIES
+#define CONFIG_CFM_MULTI_ENTRIES           8
+#endif
+
+// use a digest of the ConciseDCF and the CN identity as expected
+// configuration date/time if 0x1F26/0x1F27 are not set
+#ifndef CONFIG_CFM_CONF_DIGEST
+#define CONFIG_CFM_CONF_DIGEST             FALSE
+#endif
+
 // return pointer to node info structure for specified node ID
 // d.k. may be replaced by special (hash) function if node ID array is smaller than 254
 #define CFM_GET_NODEINFO(uiNodeId_p)(cfmInstance_g.apNodeInfo[uiNodeId_p - 1])
 
+#if (CONFIG_CFM_CONF_DIGEST != FALSE)
+// FNV-1a 64 bit parameters for the configuration digest
+#define CFM_DIGEST_OFFSET_BASIS            0xCBF29CE484222325ULL
+#define CFM_DIGEST_PRIME                   0x00000100000001B3ULL
+
+// number of digest entries in CFM_VerifyConfiguration_REC (ConfDate, ConfTime)
+#define CFM_DIGEST_ENTRY_COUNT             2
+#endif
+
 //------------------------------------------------------------------------------
 // module global vars
 //------------------------------------------------------------------------------
@@ -107,6 +137,10 @@ typedef enum
     kCfmStateWaitStore,
     kCfmStateUpToDate,
     kCfmStateInternalAbort,
+    kCfmStatePending,
+#if (CONFIG_CFM_CONF_DIGEST != FALSE)
+    kCfmStateWaitDigest,
+#endif
 } tCfmState;
 
 /**
@@ -126,6 +160,26 @@ typedef struct
     tCfmState               cfmState;
     UINT                    curDataSize;
     BOOL                    fDoStore;
+    BOOL                    fDownloadActive;
+    tNmtNodeEvent           pendingNodeEvent;
+#if (CONFIG_CFM_MULTI_ENTRIES > 1)
+    tSdoMultiAccEntry       aMultiEntry[CONFIG_CFM_MULTI_ENTRIES];  ///< Entries of the running multiple parameter write
+    UINT                    multiEntryCount;        ///< Number of entries of the running multiple parameter write (0 = single write)
+    BOOL                    fNoMulti;               ///< The CN does not support multiple parameter writes
+#endif
+#if (CONFIG_CFM_CONF_DIGEST != FALSE)
+    UINT32                  aLeConfDigest[CFM_DIGEST_ENTRY_COUNT];
+    UINT                    digestEntriesRemaining;
+#endif
+#if (CONFIG_OBD_USE_LOAD_CONCISEDCF != FALSE)
+    UINT8*                  pBaseDcf;               ///< First entry of the shared ConciseDCF (NULL = not shared)
+    UINT32                  baseSize;               ///< Size of the entries of the shared ConciseDCF
+    UINT32                  baseEntryCount;         ///< Number of entries of the shared ConciseDCF
+    UINT8*                  pDataBaseDcf;           ///< Next entry of the shared ConciseDCF
+    UINT32                  baseEntriesRemaining;   ///< Remaining entries of the shared ConciseDCF
+    UINT8*                  pNodeDcf;               ///< First entry of the node specific ConciseDCF
+    UINT32                  nodeEntryCount;         ///< Number of entries of the node specific ConciseDCF
+#endif
 } tCfmNodeInfo;
 
 /**
@@ -142,6 +196,12 @@ typedef struct
 #endif
     tCfmCbEventCnProgress   pfnCbEventCnProgress;
     tCfmCbEventCnResult     pfnCbEventCnResult;
+    UINT                    activeDownloadCount;
+#if (CONFIG_CFM_MAX_PARALLEL_DOWNLOADS != 0)
+    UINT8                   aPendingNodeId[NMT_MAX_NODE_ID];
+    UINT                    pendingCount;
+    BOOL                    fStartingPending;
+#endif
 } tCfmInstance;
 
 //------------------------------------------------------------------------------
@@ -154,11 +214,33 @@ static tCfmInstance             cfmInstance_g;
 //------------------------------------------------------------------------------
 
 static tCfmNodeInfo* allocNodeInfo(UINT nodeId_p);
+static tOplkError configureNode(tCfmNodeInfo* pNodeInfo_p, tNmtNodeEvent nodeEvent_p);
+static tOplkError startDownload(tCfmNodeInfo* pNodeInfo_p, tNmtNodeEvent nodeEvent_p);
+static void       releaseDownload(tCfmNodeInfo* pNodeInfo_p);
+#if (CONFIG_CFM_MAX_PARALLEL_DOWNLOADS != 0)
+static void       startPendingDownloads(void);
+#endif
 static tOplkError callCbProgress(tCfmNodeInfo* pNodeInfo_p);
 static tOplkError downloadCycleLength(tCfmNodeInfo* pNodeInfo_p);
 static tOplkError downloadObject(tCfmNodeInfo* pNodeInfo_p);
+static tOplkError finishDownload(tCfmNodeInfo* pNodeInfo_p);
+#if (CONFIG_OBD_USE_LOAD_CONCISEDCF != FALSE)
+static BOOL       setupSharedConfig(tCfmNodeInfo* pNodeInfo_p);
+static BOOL       checkDcfEntries(UINT8* pData_p, UINT32 size_p, UINT32 entryCount_p);
+static UINT8*     findDcfEntry(UINT8* pData_p, UINT32 entryCount_p, UINT index_p, UINT subIndex_p);
+static tOplkError downloadSharedObject(tCfmNodeInfo* pNodeInfo_p);
+#endif
 static tOplkError sdoWriteObject(tCfmNodeInfo* pNodeInfo_p, void* pLeSrcData_p, UINT size_p);
+static tOplkError initTransfer(tCfmNodeInfo* pNodeInfo_p, tSdoComTransParamByIndex* pTransParamByIndex_p);
 static tOplkError cbSdoCon(tSdoComFinished* pSdoComFinished_p);
+#if (CONFIG_CFM_MULTI_ENTRIES > 1)
+static UINT       packDcfEntries(tCfmNodeInfo* pNodeInfo_p);
+static tOplkError finishMultiWrite(tCfmNodeInfo* pNodeInfo_p, tSdoComFinished* pSdoComFinished_p);
+#endif
+#if (CONFIG_CFM_CONF_DIGEST != FALSE)
+static void       calcConfDigest(tCfmNodeInfo* pNodeInfo_p, tIdentResponse* pIdentResponse_p);
+static tOplkError downloadDigest(tCfmNodeInfo* pNodeInfo_p);
+#endif
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -284,13 +366,7 @@ configuration data and time of this CN differ from the expected (local) values.
 tOplkError cfmu_processNodeEvent(UINT nodeId_p, tNmtNodeEvent nodeEvent_p, tNmtState nmtState_p)
 {
     tOplkError          ret = kErrorOk;
-    static UINT32       leSignature;
     tCfmNodeInfo*       pNodeInfo = NULL;
-    tObdSize            obdSize;
-    UINT32              expConfTime = 0;
-    UINT32              expConfDate = 0;
-    tIdentResponse*     pIdentResponse = NULL;
-    BOOL                fDoUpdate = FALSE;
 
     if ((nodeEvent_p != kNmtNodeEventCheckConf) &&
         (nodeEvent_p != kNmtNodeEventUpdateConf) &&
@@ -322,6 +398,8 @@ tOplkError cfmu_processNodeEvent(UINT nodeId_p, tNmtNodeEvent nodeEvent_p, tNmtS
                 return ret;
             }
         }
+
+        releaseDownload(pNodeInfo);
     }
 
     if ((nodeEvent_p == kNmtNodeEventFound) ||
@@ -330,135 +408,19 @@ tOplkError cfmu_processNodeEvent(UINT nodeId_p, tNmtNodeEvent nodeEvent_p, tNmtS
         return ret;
     }
 
-    pNodeInfo->curDataSize = 0;
-
-    // fetch pointer to ConciseDCF from object 0x1F22
-    // (this allows the application to link its own memory to this object)
-    pNodeInfo->pDataConciseDcf = obd_getObjectDataPtr(0x1F22, nodeId_p);
-    if (pNodeInfo->pDataConciseDcf == NULL)
-        return kErrorCfmNoConfigData;
-
-    obdSize = obd_getDataSize(0x1F22, nodeId_p);
-    pNodeInfo->bytesRemaining = (UINT32) obdSize;
-    pNodeInfo->eventCnProgress.totalNumberOfBytes = pNodeInfo->bytesRemaining;
-#if (CONFIG_CFM_CONFIGURE_CYCLE_LENGTH != FALSE)
-    pNodeInfo->eventCnProgress.totalNumberOfBytes += sizeof (UINT32);
-#endif
-    pNodeInfo->eventCnProgress.bytesDownloaded = 0;
-    if (obdSize < sizeof(UINT32))
-    {
-        pNodeInfo->eventCnProgress.error = kErrorCfmInvalidDcf;
-        ret = callCbProgress(pNodeInfo);
-        if (ret != kErrorOk)
-            return ret;
-        return pNodeInfo->eventCnProgress.error;
-    }
-
-    pNodeInfo->entriesRemaining = ami_getUint32Le(pNodeInfo->pDataConciseDcf);
-    pNodeInfo->pDataConciseDcf += sizeof(UINT32);
-    pNodeInfo->bytesRemaining -= sizeof(UINT32);
-    pNodeInfo->eventCnProgress.bytesDownloaded += sizeof(UINT32);
-
-    if (pNodeInfo->entriesRemaining == 0)
-    {
-        pNodeInfo->eventCnProgress.error = kErrorCfmNoConfigData;
-        ret = callCbProgress(pNodeInfo);
-        if (ret != kErrorOk)
-            return ret;
-    }
-    else
-    {
-        obdSize = sizeof(expConfDate);
-        ret = obd_readEntry(0x1F26, nodeId_p, &expConfDate, &obdSize);
-        if (ret != kErrorOk)
-        {
-            DEBUG_LVL_CFM_TRACE("CN%x Error Reading 0x1F26 returns 0x%X\n", nodeId_p, ret);
-        }
-        obdSize = sizeof(expConfTime);
-        ret = obd_readEntry(0x1F27, nodeId_p, &expConfTime, &obdSize);
-        if (ret != kErrorOk)
-        {
-            DEBUG_LVL_CFM_TRACE("CN%x Error Reading 0x1F27 returns 0x%X\n", nodeId_p, ret);
-        }
-        if ((expConfDate != 0) || (expConfTime != 0))
-        {   // store configuration in CN at the end of the download,
-            // because expected configuration date or time is set
-            pNodeInfo->fDoStore = TRUE;
-            pNodeInfo->eventCnProgress.totalNumberOfBytes += sizeof(UINT32);
-        }
-        else
-        {   // expected configuration date and time is not set
-            fDoUpdate = TRUE;
-        }
-        identu_getIdentResponse(nodeId_p, &pIdentResponse);
-        if (pIdentResponse == NULL)
-        {
-            DEBUG_LVL_CFM_TRACE("CN%x Ident Response is NULL\n", nodeId_p);
-            return kErrorInvalidNodeId;
-        }
-    }
-
-#if (CONFIG_CFM_CONFIGURE_CYCLE_LENGTH != FALSE)
-    obdSize = sizeof(cfmInstance_g.leCycleLength);
-    ret = obd_readEntryToLe(0x1006, 0x00, &cfmInstance_g.leCycleLength, &obdSize);
-    if (ret != kErrorOk)
-    {   // local OD access failed
-        DEBUG_LVL_CFM_TRACE("Local OBD read failed %d\n", ret);
-        return ret;
+#if (CONFIG_CFM_MAX_PARALLEL_DOWNLOADS != 0)
+    if (cfmInstance_g.activeDownloadCount >= CONFIG_CFM_MAX_PARALLEL_DOWNLOADS)
+    {   // all downloads are busy -> configure the node when a download has finished
+        pNodeInfo->cfmState = kCfmStatePending;
+        pNodeInfo->pendingNodeEvent = nodeEvent_p;
+        cfmInstance_g.aPendingNodeId[cfmInstance_g.pendingCount] = (UINT8)nodeId_p;
+        cfmInstance_g.pendingCount++;
+        DEBUG_LVL_CFM_TRACE("CN%x - Cfg pending\n", nodeId_p);
+        return kErrorReject;
     }
 #endif
 
-    if ((pNodeInfo->entriesRemaining == 0) ||
-        ((nodeEvent_p != kNmtNodeEventUpdateConf) && (fDoUpdate == FALSE) &&
-         ((ami_getUint32Le(&pIdentResponse->verifyConfigurationDateLe) == expConfDate) &&
-          (ami_getUint32Le(&pIdentResponse->verifyConfigurationTimeLe) == expConfTime))))
-    {
-        pNodeInfo->cfmState = kCfmStateIdle;
-
-        // current version is already available on the CN, no need to write new values, we can continue
-        DEBUG_LVL_CFM_TRACE("CN%x - Cfg Upto Date\n", nodeId_p);
-
-        ret = downloadCycleLength(pNodeInfo);
-        if (ret == kErrorReject)
-        {
-            pNodeInfo->cfmState = kCfmStateUpToDate;
-        }
-    }
-    else if (nodeEvent_p == kNmtNodeEventUpdateConf)
-    {
-        pNodeInfo->cfmState = kCfmStateDownload;
-        ret = downloadObject(pNodeInfo);
-        if (ret == kErrorOk)
-        {   // SDO transfer started
-            ret = kErrorReject;
-        }
-    }
-    else
-    {
-        pNodeInfo->cfmState = kCfmStateWaitRestore;
-
-        pNodeInfo->eventCnProgress.totalNumberOfBytes += sizeof(leSignature);
-        ami_setUint32Le(&leSignature, 0x64616F6C);
-        //Restore Default Parameters
-        DEBUG_LVL_CFM_TRACE("CN%x - Cfg Mismatch | MN Expects: %lx-%lx ", nodeId_p, expConfDate, expConfTime);
-        DEBUG_LVL_CFM_TRACE("CN Has: %lx-%lx. Restoring Default...\n",
-                             ami_getUint32Le(&pIdentResponse->verifyConfigurationDateLe),
-                             ami_getUint32Le(&pIdentResponse->verifyConfigurationTimeLe));
-
-        pNodeInfo->eventCnProgress.objectIndex = 0x1011;
-        pNodeInfo->eventCnProgress.objectSubIndex = 0x01;
-        ret = sdoWriteObject(pNodeInfo, &leSignature, sizeof(leSignature));
-        if (ret == kErrorOk)
-        {   // SDO transfer started
-            ret = kErrorReject;
-        }
-        else
-        {
-            // error occurred
-            DEBUG_LVL_CFM_TRACE("CfmCbEvent(Node): sdoWriteObject() returned 0x%02X\n", ret);
-        }
-    }
-    return ret;
+    return startDownload(pNodeInfo, nodeEvent_p);
 }
 
 //------------------------------------------------------------------------------
@@ -560,6 +522,197 @@ tOplkError cfmu_cbObdAccess(tObdCbParam MEM* pParam_p)
 /// \name Private Functions
 /// \{
 
+//------------------------------------------------------------------------------
+/**
+\brief  Configure node
+
+The function checks the configuration of the specified CN and starts the
+restore, the download or the cycle length update. It is called with a reserved
+download.
+
+\param  pNodeInfo_p     Node info of the node to be configured.
+\param  nodeEvent_p     Node event which triggered the configuration.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk        Configuration is OK -> continue boot process for this CN.
+\retval kErrorReject    Defer further processing until configuration process has finished.
+\retval other error     Major error has occurred.
+*/
+//------------------------------------------------------------------------------
+static tOplkError configureNode(tCfmNodeInfo* pNodeInfo_p, tNmtNodeEvent nodeEvent_p)
+{
+    tOplkError          ret = kErrorOk;
+    static UINT32       leSignature;
+    UINT                nodeId = pNodeInfo_p->eventCnProgress.nodeId;
+    tObdSize            obdSize;
+    UINT32              expConfTime = 0;
+    UINT32              expConfDate = 0;
+    tIdentResponse*     pIdentResponse = NULL;
+    BOOL                fDoUpdate = FALSE;
+    UINT32              entryCount;
+
+    pNodeInfo_p->curDataSize = 0;
+    pNodeInfo_p->fDoStore = FALSE;
+#if (CONFIG_CFM_MULTI_ENTRIES > 1)
+    pNodeInfo_p->multiEntryCount = 0;
+#endif
+#if (CONFIG_CFM_CONF_DIGEST != FALSE)
+    pNodeInfo_p->digestEntriesRemaining = 0;
+#endif
+
+    // fetch pointer to ConciseDCF from object 0x1F22
+    // (this allows the application to link its own memory to this object)
+    pNodeInfo_p->pDataConciseDcf = obd_getObjectDataPtr(0x1F22, nodeId);
+    if (pNodeInfo_p->pDataConciseDcf == NULL)
+        return kErrorCfmNoConfigData;
+
+    obdSize = obd_getDataSize(0x1F22, nodeId);
+    pNodeInfo_p->bytesRemaining = (UINT32) obdSize;
+    pNodeInfo_p->eventCnProgress.totalNumberOfBytes = pNodeInfo_p->bytesRemaining;
+#if (CONFIG_CFM_CONFIGURE_CYCLE_LENGTH != FALSE)
+    pNodeInfo_p->eventCnProgress.totalNumberOfBytes += sizeof (UINT32);
+#endif
+    pNodeInfo_p->eventCnProgress.bytesDownloaded = 0;
+    if (obdSize < sizeof(UINT32))
+    {
+        pNodeInfo_p->eventCnProgress.error = kErrorCfmInvalidDcf;
+        ret = callCbProgress(pNodeInfo_p);
+        if (ret != kErrorOk)
+            return ret;
+        return pNodeInfo_p->eventCnProgress.error;
+    }
+
+    pNodeInfo_p->entriesRemaining = ami_getUint32Le(pNodeInfo_p->pDataConciseDcf);
+    pNodeInfo_p->pDataConciseDcf += sizeof(UINT32);
+    pNodeInfo_p->bytesRemaining -= sizeof(UINT32);
+    pNodeInfo_p->eventCnProgress.bytesDownloaded += sizeof(UINT32);
+    entryCount = pNodeInfo_p->entriesRemaining;
+
+#if (CONFIG_OBD_USE_LOAD_CONCISEDCF != FALSE)
+    if (!setupSharedConfig(pNodeInfo_p))
+    {
+        pNodeInfo_p->eventCnProgress.error = kErrorCfmInvalidDcf;
+        ret = callCbProgress(pNodeInfo_p);
+        if (ret != kErrorOk)
+            return ret;
+        return pNodeInfo_p->eventCnProgress.error;
+    }
+    entryCount += pNodeInfo_p->baseEntriesRemaining;
+#endif
+
+    if (entryCount == 0)
+    {
+        pNodeInfo_p->eventCnProgress.error = kErrorCfmNoConfigData;
+        ret = callCbProgress(pNodeInfo_p);
+        if (ret != kErrorOk)
+            return ret;
+    }
+    else
+    {
+        obdSize = sizeof(expConfDate);
+        ret = obd_readEntry(0x1F26, nodeId, &expConfDate, &obdSize);
+        if (ret != kErrorOk)
+        {
+            DEBUG_LVL_CFM_TRACE("CN%x Error Reading 0x1F26 returns 0x%X\n", nodeId, ret);
+        }
+        obdSize = sizeof(expConfTime);
+        ret = obd_readEntry(0x1F27, nodeId, &expConfTime, &obdSize);
+        if (ret != kErrorOk)
+        {
+            DEBUG_LVL_CFM_TRACE("CN%x Error Reading 0x1F27 returns 0x%X\n", nodeId, ret);
+        }
+        identu_getIdentResponse(nodeId, &pIdentResponse);
+        if (pIdentResponse == NULL)
+        {
+            DEBUG_LVL_CFM_TRACE("CN%x Ident Response is NULL\n", nodeId);
+            return kErrorInvalidNodeId;
+        }
+#if (CONFIG_CFM_CONF_DIGEST != FALSE)
+        if ((expConfDate == 0) && (expConfTime == 0))
+        {   // expected configuration date and time is not set,
+            // so the CN is stamped with the configuration digest instead
+            calcConfDigest(pNodeInfo_p, pIdentResponse);
+            expConfDate = ami_getUint32Le(&pNodeInfo_p->aLeConfDigest[0]);
+            expConfTime = ami_getUint32Le(&pNodeInfo_p->aLeConfDigest[1]);
+            pNodeInfo_p->digestEntriesRemaining = CFM_DIGEST_ENTRY_COUNT;
+            pNodeInfo_p->eventCnProgress.totalNumberOfBytes += sizeof(pNodeInfo_p->aLeConfDigest);
+        }
+#endif
+        if ((expConfDate != 0) || (expConfTime != 0))
+        {   // store configuration in CN at the end of the download,
+            // because expected configuration date or time is set
+            pNodeInfo_p->fDoStore = TRUE;
+            pNodeInfo_p->eventCnProgress.totalNumberOfBytes += sizeof(UINT32);
+        }
+        else
+        {   // expected configuration date and time is not set
+            fDoUpdate = TRUE;
+        }
+    }
+
+#if (CONFIG_CFM_CONFIGURE_CYCLE_LENGTH != FALSE)
+    obdSize = sizeof(cfmInstance_g.leCycleLength);
+    ret = obd_readEntryToLe(0x1006, 0x00, &cfmInstance_g.leCycleLength, &obdSize);
+    if (ret != kErrorOk)
+    {   // local OD access failed
+        DEBUG_LVL_CFM_TRACE("Local OBD read failed %d\n", ret);
+        return ret;
+    }
+#endif
+
+    if ((entryCount == 0) ||
+        ((nodeEvent_p != kNmtNodeEventUpdateConf) && (fDoUpdate == FALSE) &&
+         ((ami_getUint32Le(&pIdentResponse->verifyConfigurationDateLe) == expConfDate) &&
+          (ami_getUint32Le(&pIdentResponse->verifyConfigurationTimeLe) == expConfTime))))
+    {
+        pNodeInfo_p->cfmState = kCfmStateIdle;
+
+        // current version is already available on the CN, no need to write new values, we can continue
+        DEBUG_LVL_CFM_TRACE("CN%x - Cfg Upto Date\n", nodeId);
+
+        ret = downloadCycleLength(pNodeInfo_p);
+        if (ret == kErrorReject)
+        {
+            pNodeInfo_p->cfmState = kCfmStateUpToDate;
+        }
+    }
+    else if (nodeEvent_p == kNmtNodeEventUpdateConf)
+    {
+        pNodeInfo_p->cfmState = kCfmStateDownload;
+        ret = downloadObject(pNodeInfo_p);
+        if (ret == kErrorOk)
+        {   // SDO transfer started
+            ret = kErrorReject;
+        }
+    }
+    else
+    {
+        pNodeInfo_p->cfmState = kCfmStateWaitRestore;
+
+        pNodeInfo_p->eventCnProgress.totalNumberOfBytes += sizeof(leSignature);
+        ami_setUint32Le(&leSignature, 0x64616F6C);
+        //Restore Default Parameters
+        DEBUG_LVL_CFM_TRACE("CN%x - Cfg Mismatch | MN Expects: %lx-%lx ", nodeId, expConfDate, expConfTime);
+        DEBUG_LVL_CFM_TRACE("CN Has: %lx-%lx. Restoring Default...\n",
+                             ami_getUint32Le(&pIdentResponse->verifyConfigurationDateLe),
+                             ami_getUint32Le(&pIdentResponse->verifyConfigurationTimeLe));
+
+        pNodeInfo_p->eventCnProgress.objectIndex = 0x1011;
+        pNodeInfo_p->eventCnProgress.objectSubIndex = 0x01;
+        ret = sdoWriteObject(pNodeInfo_p, &leSignature, sizeof(leSignature));
+        if (ret == kErrorOk)
+        {   // SDO transfer started
+            ret = kErrorReject;
+        }
+        else
+        {
+            // error occurred
+            DEBUG_LVL_CFM_TRACE("CfmCbEvent(Node): sdoWriteObject() returned 0x%02X\n", ret);
+        }
+    }
+    return ret;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Allocate node information
@@ -637,6 +790,7 @@ static tOplkError finishConfig(tCfmNodeInfo* pNodeInfo_p, tNmtCommand nmtCommand
         if (ret != kErrorOk)
         {
             DEBUG_LVL_CFM_TRACE("SDO Free Error!\n");
+            releaseDownload(pNodeInfo_p);
             return ret;
         }
     }
@@ -646,9 +800,131 @@ static tOplkError finishConfig(tCfmNodeInfo* pNodeInfo_p, tNmtCommand nmtCommand
     {
         ret = cfmInstance_g.pfnCbEventCnResult(pNodeInfo_p->eventCnProgress.nodeId, nmtCommand_p);
     }
+
+    releaseDownload(pNodeInfo_p);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Start configuration download of a node
+
+The function starts the configuration of the specified node and accounts it as
+an active download until releaseDownload() is called. If the configuration
+finishes without a pending SDO transfer the download is released immediately.
+
+\param  pNodeInfo_p     Pointer to the node info structure.
+\param  nodeEvent_p     Node event which triggered the configuration.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk        The node is already configured.
+\retval kErrorReject    The configuration download is running.
+*/
+//------------------------------------------------------------------------------
+static tOplkError startDownload(tCfmNodeInfo* pNodeInfo_p, tNmtNodeEvent nodeEvent_p)
+{
+    tOplkError      ret;
+
+    pNodeInfo_p->fDownloadActive = TRUE;
+    cfmInstance_g.activeDownloadCount++;
+
+    ret = configureNode(pNodeInfo_p, nodeEvent_p);
+    if (ret != kErrorReject)
+    {   // no SDO transfer is running for this node
+        releaseDownload(pNodeInfo_p);
+    }
+
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Release configuration download of a node
+
+The function releases the download slot occupied by the specified node or
+removes the node from the list of pending nodes. If a download slot becomes
+free the next pending node is started.
+
+\param  pNodeInfo_p     Pointer to the node info structure.
+*/
+//------------------------------------------------------------------------------
+static void releaseDownload(tCfmNodeInfo* pNodeInfo_p)
+{
+#if (CONFIG_CFM_MAX_PARALLEL_DOWNLOADS != 0)
+    UINT    index;
+
+    for (index = 0; index < cfmInstance_g.pendingCount; index++)
+    {
+        if (cfmInstance_g.aPendingNodeId[index] == pNodeInfo_p->eventCnProgress.nodeId)
+        {   // remove node from the list of pending nodes
+            cfmInstance_g.pendingCount--;
+            for (; index < cfmInstance_g.pendingCount; index++)
+                cfmInstance_g.aPendingNodeId[index] = cfmInstance_g.aPendingNodeId[index + 1];
+            break;
+        }
+    }
+#endif
+
+    if (!pNodeInfo_p->fDownloadActive)
+        return;
+
+    pNodeInfo_p->fDownloadActive = FALSE;
+    cfmInstance_g.activeDownloadCount--;
+
+#if (CONFIG_CFM_MAX_PARALLEL_DOWNLOADS != 0)
+    startPendingDownloads();
+#endif
+}
+
+#if (CONFIG_CFM_MAX_PARALLEL_DOWNLOADS != 0)
+//------------------------------------------------------------------------------
+/**
+\brief  Start pending configuration downloads
+
+The function starts the configuration of pending nodes in the order they were
+queued until the maximum number of parallel downloads is reached. Because the
+NMT MN was told to wait for the result of a pending node, the result of a
+configuration which finishes immediately is reported via the result callback.
+*/
+//------------------------------------------------------------------------------
+static void startPendingDownloads(void)
+{
+    tOplkError      ret;
+    tCfmNodeInfo*   pNodeInfo;
+    UINT            nodeId;
+
+    if (cfmInstance_g.fStartingPending)
+        return;     // called by a download which finished immediately
+
+    cfmInstance_g.fStartingPending = TRUE;
+    while ((cfmInstance_g.pendingCount > 0) &&
+           (cfmInstance_g.activeDownloadCount < CONFIG_CFM_MAX_PARALLEL_DOWNLOADS))
+    {
+        nodeId = cfmInstance_g.aPendingNodeId[0];
+        pNodeInfo = CFM_GET_NODEINFO(nodeId);
+        releaseDownload(pNodeInfo);     // removes the node from the pending list
+
+        pNodeInfo->cfmState = kCfmStateIdle;
+        ret = startDownload(pNodeInfo, pNodeInfo->pendingNodeEvent);
+        if (ret == kErrorReject)
+            continue;   // result is reported by finishConfig()
+
+        if (ret != kErrorOk)
+        {
+            DEBUG_LVL_CFM_TRACE("CN%x - Cfg error 0x%X\n", nodeId, ret);
+        }
+
+        if (cfmInstance_g.pfnCbEventCnResult != NULL)
+        {
+            cfmInstance_g.pfnCbEventCnResult(nodeId,
+                                             (ret == kErrorOk) ? kNmtNodeCommandConfOk :
+                                                                 kNmtNodeCommandConfErr);
+        }
+    }
+    cfmInstance_g.fStartingPending = FALSE;
+}
+#endif
+
 //------------------------------------------------------------------------------
 /**
 \brief  SDO finished callback function
@@ -670,6 +946,11 @@ static tOplkError cbSdoCon(tSdoComFinished* pSdoComFinished_p)
     if (pNodeInfo == NULL)
         return kErrorInvalidNodeId;
 
+#if (CONFIG_CFM_MULTI_ENTRIES > 1)
+    if (pNodeInfo->multiEntryCount > 0)
+        return finishMultiWrite(pNodeInfo, pSdoComFinished_p);
+#endif
+
     pNodeInfo->eventCnProgress.sdoAbortCode = pSdoComFinished_p->abortCode;
     pNodeInfo->eventCnProgress.bytesDownloaded += pSdoComFinished_p->transferredBytes;
 
@@ -725,8 +1006,21 @@ static tOplkError cbSdoCon(tSdoComFinished* pSdoComFinished_p)
             }
             break;
 
+#if (CONFIG_CFM_CONF_DIGEST != FALSE)
+        case kCfmStateWaitDigest:
+            if (pSdoComFinished_p->sdoComConState != kSdoComTransferFinished)
+            {   // CN does not accept the digest, finish the download without it
+                DEBUG_LVL_CFM_TRACE("CN%x - Writing digest failed\n", pNodeInfo->eventCnProgress.nodeId);
+                pNodeInfo->digestEntriesRemaining = 0;
+            }
+            pNodeInfo->cfmState = kCfmStateDownload;
+            ret = downloadObject(pNodeInfo);
+            break;
+#endif
+
         case kCfmStateInternalAbort:
-            // configuration was aborted
+        case kCfmStatePending:
+            // configuration was aborted or not yet started
             break;
     }
 
@@ -786,7 +1080,11 @@ node.
 static tOplkError downloadObject(tCfmNodeInfo* pNodeInfo_p)
 {
     tOplkError          ret = kErrorOk;
-    static UINT32       leSignature;
+
+#if (CONFIG_OBD_USE_LOAD_CONCISEDCF != FALSE)
+    if (pNodeInfo_p->pBaseDcf != NULL)
+        return downloadSharedObject(pNodeInfo_p);
+#endif
 
     // forward data pointer for last transfer
     pNodeInfo_p->pDataConciseDcf += pNodeInfo_p->curDataSize;
@@ -822,41 +1120,342 @@ static tOplkError downloadObject(tCfmNodeInfo* pNodeInfo_p)
         }
 
         pNodeInfo_p->entriesRemaining--;
+#if (CONFIG_CFM_MULTI_ENTRIES > 1)
+        packDcfEntries(pNodeInfo_p);
+#endif
         ret = sdoWriteObject(pNodeInfo_p, pNodeInfo_p->pDataConciseDcf, pNodeInfo_p->curDataSize);
         if (ret != kErrorOk)
             return ret;
     }
     else
     {   // download finished
-        if (pNodeInfo_p->fDoStore != FALSE)
+        return finishDownload(pNodeInfo_p);
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Finish download of ConciseDCF
+
+The function is called after the last object of the ConciseDCF was downloaded.
+It downloads the configuration digest, stores the configuration or downloads
+the cycle length.
+
+\param  pNodeInfo_p     Node info of the node.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError finishDownload(tCfmNodeInfo* pNodeInfo_p)
+{
+    tOplkError          ret = kErrorOk;
+    static UINT32       leSignature;
+
+#if (CONFIG_CFM_CONF_DIGEST != FALSE)
+    if (pNodeInfo_p->digestEntriesRemaining > 0)
+        return downloadDigest(pNodeInfo_p);
+#endif
+
+    if (pNodeInfo_p->fDoStore != FALSE)
+    {
+        // store configuration into non-volatile memory
+        pNodeInfo_p->cfmState = kCfmStateWaitStore;
+        ami_setUint32Le(&leSignature, 0x65766173);
+        pNodeInfo_p->eventCnProgress.objectIndex = 0x1010;
+        pNodeInfo_p->eventCnProgress.objectSubIndex = 0x01;
+        ret = sdoWriteObject(pNodeInfo_p, &leSignature, sizeof (leSignature));
+    }
+    else
+    {
+        ret = downloadCycleLength(pNodeInfo_p);
+        if (ret == kErrorReject)
         {
-            // store configuration into non-volatile memory
-            pNodeInfo_p->cfmState = kCfmStateWaitStore;
-            ami_setUint32Le(&leSignature, 0x65766173);
-            pNodeInfo_p->eventCnProgress.objectIndex = 0x1010;
-            pNodeInfo_p->eventCnProgress.objectSubIndex = 0x01;
-            ret = sdoWriteObject(pNodeInfo_p, &leSignature, sizeof (leSignature));
-            if (ret != kErrorOk)
-                return ret;
+            pNodeInfo_p->cfmState = kCfmStateUpToDate;
+            return kErrorOk;
         }
         else
         {
-            ret = downloadCycleLength(pNodeInfo_p);
-            if (ret == kErrorReject)
-            {
-                pNodeInfo_p->cfmState = kCfmStateUpToDate;
-                return kErrorOk;
-            }
-            else
-            {
-                return finishConfig(pNodeInfo_p, kNmtNodeCommandConfReset);
-            }
+            return finishConfig(pNodeInfo_p, kNmtNodeCommandConfReset);
         }
     }
 
     return ret;
 }
 
+#if (CONFIG_OBD_USE_LOAD_CONCISEDCF != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Set up shared configuration of a node
+
+The function checks whether object 0x1F22 of the node is linked to a node
+specific ConciseDCF of a precompiled CDC with shared CN configurations (see
+obdcdc_getSharedConfig()). In this case the shared ConciseDCF is downloaded
+with its objects replaced by the node specific ones, followed by the remaining
+node specific objects.
+
+\param  pNodeInfo_p     Node info of the node. The data pointer must point
+                        behind the number of entries of the ConciseDCF.
+
+\return The function returns FALSE if the shared configuration is invalid,
+        otherwise TRUE.
+*/
+//------------------------------------------------------------------------------
+static BOOL setupSharedConfig(tCfmNodeInfo* pNodeInfo_p)
+{
+    UINT8*      pBaseDcf;
+    UINT32      baseSize;
+    UINT8*      pNodeDcf;
+    UINT32      baseEntryCount;
+
+    pNodeInfo_p->pBaseDcf = NULL;
+    pNodeInfo_p->baseEntriesRemaining = 0;
+
+    if (obdcdc_getSharedConfig(pNodeInfo_p->eventCnProgress.nodeId, &pBaseDcf, &baseSize,
+                               &pNodeDcf) != kErrorOk)
+        return TRUE;
+
+    if (pNodeDcf != pNodeInfo_p->pDataConciseDcf - sizeof(UINT32))
+        return TRUE;    // object 0x1F22 was overwritten by the application
+
+    baseEntryCount = ami_getUint32Le(pBaseDcf);
+    pBaseDcf += sizeof(UINT32);
+    baseSize -= sizeof(UINT32);
+    if (!checkDcfEntries(pBaseDcf, baseSize, baseEntryCount) ||
+        !checkDcfEntries(pNodeInfo_p->pDataConciseDcf, pNodeInfo_p->bytesRemaining,
+                         pNodeInfo_p->entriesRemaining))
+        return FALSE;
+
+    pNodeInfo_p->pBaseDcf = pBaseDcf;
+    pNodeInfo_p->baseSize = baseSize;
+    pNodeInfo_p->baseEntryCount = baseEntryCount;
+    pNodeInfo_p->pDataBaseDcf = pBaseDcf;
+    pNodeInfo_p->baseEntriesRemaining = baseEntryCount;
+    pNodeInfo_p->pNodeDcf = pNodeInfo_p->pDataConciseDcf;
+    pNodeInfo_p->nodeEntryCount = pNodeInfo_p->entriesRemaining;
+    pNodeInfo_p->eventCnProgress.totalNumberOfBytes += baseSize;
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check entries of a ConciseDCF
+
+\param  pData_p         Pointer to the first entry.
+\param  size_p          Size of the entries.
+\param  entryCount_p    Number of entries.
+
+\return The function returns TRUE if all entries are complete.
+*/
+//------------------------------------------------------------------------------
+static BOOL checkDcfEntries(UINT8* pData_p, UINT32 size_p, UINT32 entryCount_p)
+{
+    UINT32      dataSize;
+
+    for (; entryCount_p > 0; entryCount_p--)
+    {
+        if (size_p < CDC_OFFSET_DATA)
+            return FALSE;
+
+        dataSize = ami_getUint32Le(&pData_p[CDC_OFFSET_SIZE]);
+        if ((dataSize == 0) || (dataSize > size_p - CDC_OFFSET_DATA))
+            return FALSE;
+
+        pData_p += CDC_OFFSET_DATA + dataSize;
+        size_p -= CDC_OFFSET_DATA + dataSize;
+    }
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find entry of a ConciseDCF
+
+\param  pData_p         Pointer to the first entry of the checked ConciseDCF.
+\param  entryCount_p    Number of entries.
+\param  index_p         Index of the object.
+\param  subIndex_p      Subindex of the object.
+
+\return The function returns a pointer to the entry or NULL if the object is
+        not contained in the ConciseDCF.
+*/
+//------------------------------------------------------------------------------
+static UINT8* findDcfEntry(UINT8* pData_p, UINT32 entryCount_p, UINT index_p, UINT subIndex_p)
+{
+    for (; entryCount_p > 0; entryCount_p--)
+    {
+        if ((ami_getUint16Le(&pData_p[CDC_OFFSET_INDEX]) == index_p) &&
+            (ami_getUint8Le(&pData_p[CDC_OFFSET_SUBINDEX]) == subIndex_p))
+            return pData_p;
+
+        pData_p += CDC_OFFSET_DATA + ami_getUint32Le(&pData_p[CDC_OFFSET_SIZE]);
+    }
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Download next object of a shared configuration
+
+The function downloads the next object of the shared ConciseDCF, replaced by
+the node specific object with the same index and subindex, if available. After
+the shared ConciseDCF, the node specific objects which don't replace a shared
+object are downloaded.
+
+\param  pNodeInfo_p     Node info of the node.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError downloadSharedObject(tCfmNodeInfo* pNodeInfo_p)
+{
+    UINT8*      pEntry;
+    UINT8*      pNodeEntry;
+
+    if (pNodeInfo_p->baseEntriesRemaining > 0)
+    {
+        pEntry = pNodeInfo_p->pDataBaseDcf;
+        pNodeInfo_p->pDataBaseDcf += CDC_OFFSET_DATA + ami_getUint32Le(&pEntry[CDC_OFFSET_SIZE]);
+        pNodeInfo_p->baseEntriesRemaining--;
+
+        pNodeEntry = findDcfEntry(pNodeInfo_p->pNodeDcf, pNodeInfo_p->nodeEntryCount,
+                                  ami_getUint16Le(&pEntry[CDC_OFFSET_INDEX]),
+                                  ami_getUint8Le(&pEntry[CDC_OFFSET_SUBINDEX]));
+        if (pNodeEntry != NULL)
+            pEntry = pNodeEntry;
+    }
+    else
+    {
+        do
+        {
+            if (pNodeInfo_p->entriesRemaining == 0)
+                return finishDownload(pNodeInfo_p);
+
+            pEntry = pNodeInfo_p->pDataConciseDcf;
+            pNodeInfo_p->pDataConciseDcf += CDC_OFFSET_DATA + ami_getUint32Le(&pEntry[CDC_OFFSET_SIZE]);
+            pNodeInfo_p->entriesRemaining--;
+        } while (findDcfEntry(pNodeInfo_p->pBaseDcf, pNodeInfo_p->baseEntryCount,
+                              ami_getUint16Le(&pEntry[CDC_OFFSET_INDEX]),
+                              ami_getUint8Le(&pEntry[CDC_OFFSET_SUBINDEX])) != NULL);
+    }
+
+    pNodeInfo_p->eventCnProgress.objectIndex = ami_getUint16Le(&pEntry[CDC_OFFSET_INDEX]);
+    pNodeInfo_p->eventCnProgress.objectSubIndex = ami_getUint8Le(&pEntry[CDC_OFFSET_SUBINDEX]);
+    pNodeInfo_p->curDataSize = (UINT)ami_getUint32Le(&pEntry[CDC_OFFSET_SIZE]);
+    pNodeInfo_p->eventCnProgress.bytesDownloaded += CDC_OFFSET_DATA;
+
+    return sdoWriteObject(pNodeInfo_p, &pEntry[CDC_OFFSET_DATA], pNodeInfo_p->curDataSize);
+}
+#endif
+
+
+#if (CONFIG_CFM_CONF_DIGEST != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Calculate configuration digest
+
+The function calculates the configuration digest of the specified node. The
+digest covers the complete ConciseDCF and the identity of the CN as reported
+in its IdentResponse. Thus a changed ConciseDCF, a replaced device or a new
+application software on the CN lead to a new download. The digest is stored
+in little endian byte order as CFM_VerifyConfiguration_REC.ConfDate_U32 and
+.ConfTime_U32.
+
+\param  pNodeInfo_p         Node info of the node. The data pointer must point
+                            behind the number of entries of the ConciseDCF.
+\param  pIdentResponse_p    Pointer to the IdentResponse of the node.
+*/
+//------------------------------------------------------------------------------
+static void calcConfDigest(tCfmNodeInfo* pNodeInfo_p, tIdentResponse* pIdentResponse_p)
+{
+    UINT64          digest = CFM_DIGEST_OFFSET_BASIS;
+    const UINT8*    apData[] = {pNodeInfo_p->pDataConciseDcf - sizeof(UINT32),
+                                (UINT8*)&pIdentResponse_p->deviceTypeLe,
+                                (UINT8*)&pIdentResponse_p->vendorIdLe,
+                                (UINT8*)&pIdentResponse_p->productCodeLe,
+                                (UINT8*)&pIdentResponse_p->revisionNumberLe,
+                                (UINT8*)&pIdentResponse_p->serialNumberLe,
+                                (UINT8*)&pIdentResponse_p->applicationSwDateLe,
+                                (UINT8*)&pIdentResponse_p->applicationSwTimeLe};
+    UINT32          aSize[] = {pNodeInfo_p->bytesRemaining + sizeof(UINT32),
+                               sizeof(UINT32), sizeof(UINT32), sizeof(UINT32),
+                               sizeof(UINT32), sizeof(UINT32), sizeof(UINT32),
+                               sizeof(UINT32)};
+    UINT            part;
+    UINT32          offset;
+    UINT32          confDate;
+    UINT32          confTime;
+
+    for (part = 0; part < tabentries(apData); part++)
+    {
+        for (offset = 0; offset < aSize[part]; offset++)
+        {
+            digest ^= apData[part][offset];
+            digest *= CFM_DIGEST_PRIME;
+        }
+    }
+
+#if (CONFIG_OBD_USE_LOAD_CONCISEDCF != FALSE)
+    if (pNodeInfo_p->pBaseDcf != NULL)
+    {   // the shared ConciseDCF is part of the configuration
+        for (offset = 0; offset < pNodeInfo_p->baseSize; offset++)
+        {
+            digest ^= pNodeInfo_p->pBaseDcf[offset];
+            digest *= CFM_DIGEST_PRIME;
+        }
+    }
+#endif
+
+    confDate = (UINT32)(digest >> 32);
+    confTime = (UINT32)digest;
+    if ((confDate == 0) && (confTime == 0))
+        confTime = 1;   // zero means that no configuration is verified
+
+    ami_setUint32Le(&pNodeInfo_p->aLeConfDigest[0], confDate);
+    ami_setUint32Le(&pNodeInfo_p->aLeConfDigest[1], confTime);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Download configuration digest
+
+The function writes the next entry of the configuration digest to
+CFM_VerifyConfiguration_REC of the specified node. It is called after the
+ConciseDCF is completely downloaded and before the configuration is stored,
+so the CN only reports the digest if its configuration is complete.
+
+\param  pNodeInfo_p     Node info of the node for which to download the digest.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError downloadDigest(tCfmNodeInfo* pNodeInfo_p)
+{
+    tOplkError      ret;
+    UINT            entry;
+
+    entry = CFM_DIGEST_ENTRY_COUNT - pNodeInfo_p->digestEntriesRemaining;
+    pNodeInfo_p->digestEntriesRemaining--;
+    pNodeInfo_p->curDataSize = 0;
+    pNodeInfo_p->cfmState = kCfmStateWaitDigest;
+    pNodeInfo_p->eventCnProgress.objectIndex = 0x1020;
+    pNodeInfo_p->eventCnProgress.objectSubIndex = entry + 1;
+
+    ret = sdoWriteObject(pNodeInfo_p, &pNodeInfo_p->aLeConfDigest[entry], sizeof(UINT32));
+    if (ret != kErrorOk)
+    {   // finish the download without digest
+        DEBUG_LVL_CFM_TRACE("CN%x Writing 0x1020 returns 0x%X\n", pNodeInfo_p->eventCnProgress.nodeId, ret);
+        pNodeInfo_p->digestEntriesRemaining = 0;
+        pNodeInfo_p->cfmState = kCfmStateDownload;
+        ret = downloadObject(pNodeInfo_p);
+    }
+
+    return ret;
+}
+#endif
 
 //------------------------------------------------------------------------------
 /**
@@ -897,14 +1496,17 @@ static tOplkError sdoWriteObject(tCfmNodeInfo* pNodeInfo_p, void* pLeSrcData_p,
     transParamByIndex.subindex = pNodeInfo_p->eventCnProgress.objectSubIndex;
     transParamByIndex.pfnSdoFinishedCb = cbSdoCon;
     transParamByIndex.pUserArg = pNodeInfo_p;
+    transParamByIndex.pStream = NULL;
+    transParamByIndex.paScatterList = NULL;
+    transParamByIndex.scatterEntryCount = 0;
 
-    ret = sdocom_initTransferByIndex(&transParamByIndex);
+    ret = initTransfer(pNodeInfo_p, &transParamByIndex);
     if (ret == kErrorSdoComHandleBusy)
     {
         ret = sdocom_abortTransfer(pNodeInfo_p->sdoComConHdl, SDO_AC_DATA_NOT_TRANSF_DUE_LOCAL_CONTROL);
         if (ret == kErrorOk)
         {
-            ret = sdocom_initTransferByIndex(&transParamByIndex);
+            ret = initTransfer(pNodeInfo_p, &transParamByIndex);
         }
     }
     else if (ret == kErrorSdoSeqConnectionBusy)
@@ -927,11 +1529,175 @@ static tOplkError sdoWriteObject(tCfmNodeInfo* pNodeInfo_p, void* pLeSrcData_p,
 
         // retry transfer
         transParamByIndex.sdoComConHdl = pNodeInfo_p->sdoComConHdl;
-        ret = sdocom_initTransferByIndex(&transParamByIndex);
+        ret = initTransfer(pNodeInfo_p, &transParamByIndex);
     }
 
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize SDO write transfer
+
+The function starts the SDO write transfer of the specified node. If entries
+of the ConciseDCF are packed for a multiple parameter write, they are written
+by a Write Multiple Parameter by Index transfer. Otherwise the single object
+of the transfer parameters is written.
+
+\param  pNodeInfo_p             Node info of the node to write to.
+\param  pTransParamByIndex_p    Pointer to the parameters of a single write.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError initTransfer(tCfmNodeInfo* pNodeInfo_p, tSdoComTransParamByIndex* pTransParamByIndex_p)
+{
+#if (CONFIG_CFM_MULTI_ENTRIES > 1)
+    tSdoComTransParamMultiByIndex   transParamMultiByIndex;
+
+    if (pNodeInfo_p->multiEntryCount > 0)
+    {
+        transParamMultiByIndex.sdoComConHdl = pTransParamByIndex_p->sdoComConHdl;
+        transParamMultiByIndex.paEntries = pNodeInfo_p->aMultiEntry;
+        transParamMultiByIndex.entryCount = pNodeInfo_p->multiEntryCount;
+        transParamMultiByIndex.sdoAccessType = kSdoAccessTypeWrite;
+        transParamMultiByIndex.pfnSdoFinishedCb = pTransParamByIndex_p->pfnSdoFinishedCb;
+        transParamMultiByIndex.pUserArg = pTransParamByIndex_p->pUserArg;
+
+        return sdocom_initTransferMultiByIndex(&transParamMultiByIndex);
+    }
+#endif
+
+    return sdocom_initTransferByIndex(pTransParamByIndex_p);
+}
+
+#if (CONFIG_CFM_MULTI_ENTRIES > 1)
+//------------------------------------------------------------------------------
+/**
+\brief  Pack ConciseDCF entries
+
+The function packs the current entry of the ConciseDCF and the following
+entries into one Write Multiple Parameter by Index transfer as long as they
+fit into a single segment. The size of the current entry is increased to cover
+all packed entries, so that downloadObject() continues behind them. Invalid
+entries are not packed and are detected by downloadObject().
+
+\param  pNodeInfo_p     Node info of the node. The data pointer must point to
+                        the data of the current entry.
+
+\return The function returns the number of packed entries (0 = single write).
+*/
+//------------------------------------------------------------------------------
+static UINT packDcfEntries(tCfmNodeInfo* pNodeInfo_p)
+{
+    UINT8*              pEntry;
+    UINT32              bytesRemaining;
+    UINT                dataSize;
+    UINT                payloadSize;
+    UINT                count;
+    tSdoMultiAccEntry*  pMultiEntry;
+
+    pNodeInfo_p->multiEntryCount = 0;
+    payloadSize = SDO_MULTI_SUBBLOCK_SIZE(pNodeInfo_p->curDataSize);
+    if (pNodeInfo_p->fNoMulti || (payloadSize > SDO_MULTI_MAX_PAYLOAD_SIZE))
+        return 0;
+
+    pMultiEntry = &pNodeInfo_p->aMultiEntry[0];
+    pMultiEntry->index = pNodeInfo_p->eventCnProgress.objectIndex;
+    pMultiEntry->subindex = pNodeInfo_p->eventCnProgress.objectSubIndex;
+    pMultiEntry->pData = pNodeInfo_p->pDataConciseDcf;
+    pMultiEntry->dataSize = pNodeInfo_p->curDataSize;
+
+    pEntry = pNodeInfo_p->pDataConciseDcf + pNodeInfo_p->curDataSize;
+    bytesRemaining = pNodeInfo_p->bytesRemaining - pNodeInfo_p->curDataSize;
+    for (count = 1; (count < CONFIG_CFM_MULTI_ENTRIES) && (pNodeInfo_p->entriesRemaining > 0); count++)
+    {
+        if (bytesRemaining < CDC_OFFSET_DATA)
+            break;
+
+        dataSize = (UINT)ami_getUint32Le(&pEntry[CDC_OFFSET_SIZE]);
+        if ((dataSize == 0) || ((bytesRemaining - CDC_OFFSET_DATA) < dataSize) ||
+            ((payloadSize + SDO_MULTI_SUBBLOCK_SIZE(dataSize)) > SDO_MULTI_MAX_PAYLOAD_SIZE))
+            break;
+
+        pMultiEntry = &pNodeInfo_p->aMultiEntry[count];
+        pMultiEntry->index = ami_getUint16Le(&pEntry[CDC_OFFSET_INDEX]);
+        pMultiEntry->subindex = ami_getUint8Le(&pEntry[CDC_OFFSET_SUBINDEX]);
+        pMultiEntry->pData = &pEntry[CDC_OFFSET_DATA];
+        pMultiEntry->dataSize = dataSize;
+
+        payloadSize += SDO_MULTI_SUBBLOCK_SIZE(dataSize);
+        pEntry += CDC_OFFSET_DATA + dataSize;
+        bytesRemaining -= CDC_OFFSET_DATA + dataSize;
+        pNodeInfo_p->entriesRemaining--;
+        pNodeInfo_p->eventCnProgress.bytesDownloaded += CDC_OFFSET_DATA;
+    }
+
+    if (count > 1)
+    {
+        pNodeInfo_p->multiEntryCount = count;
+        pNodeInfo_p->curDataSize = (UINT)(pEntry - pNodeInfo_p->pDataConciseDcf);
+    }
+
+    return pNodeInfo_p->multiEntryCount;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Finish multiple parameter write
+
+The function is called when a Write Multiple Parameter by Index transfer of
+packed ConciseDCF entries is finished. If the CN does not support the
+command, the packed entries are written one by one. Otherwise the result is
+processed like the result of a single write. The first entry which could not
+be written is reported as the failed object.
+
+\param  pNodeInfo_p         Node info of the node.
+\param  pSdoComFinished_p   Pointer to SDO COM finished structure.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError finishMultiWrite(tCfmNodeInfo* pNodeInfo_p, tSdoComFinished* pSdoComFinished_p)
+{
+    tSdoComFinished     sdoComFinished;
+    UINT                count;
+    UINT                index;
+
+    count = pNodeInfo_p->multiEntryCount;
+    pNodeInfo_p->multiEntryCount = 0;
+
+    if ((pNodeInfo_p->cfmState == kCfmStateDownload) &&
+        (pSdoComFinished_p->sdoComConState == kSdoComTransferRxAborted) &&
+        (pSdoComFinished_p->abortCode == SDO_AC_UNKNOWN_COMMAND_SPECIFIER))
+    {   // unpack the entries and write the first one again
+        DEBUG_LVL_CFM_TRACE("CN%x - Multiple parameter write not supported\n", pNodeInfo_p->eventCnProgress.nodeId);
+        pNodeInfo_p->fNoMulti = TRUE;
+        pNodeInfo_p->entriesRemaining += count - 1;
+        pNodeInfo_p->eventCnProgress.bytesDownloaded -= (count - 1) * CDC_OFFSET_DATA;
+        pNodeInfo_p->curDataSize = pNodeInfo_p->aMultiEntry[0].dataSize;
+        return sdoWriteObject(pNodeInfo_p, pNodeInfo_p->pDataConciseDcf, pNodeInfo_p->curDataSize);
+    }
+
+    sdoComFinished = *pSdoComFinished_p;
+    if (sdoComFinished.sdoComConState == kSdoComTransferFinished)
+    {
+        for (index = 0; index < count; index++)
+        {
+            if (pNodeInfo_p->aMultiEntry[index].abortCode != 0)
+            {
+                pNodeInfo_p->eventCnProgress.objectIndex = pNodeInfo_p->aMultiEntry[index].index;
+                pNodeInfo_p->eventCnProgress.objectSubIndex = pNodeInfo_p->aMultiEntry[index].subindex;
+                sdoComFinished.sdoComConState = kSdoComTransferRxAborted;
+                sdoComFinished.abortCode = pNodeInfo_p->aMultiEntry[index].abortCode;
+                break;
+            }
+        }
+    }
+
+    return cbSdoCon(&sdoComFinished);
+}
+#endif
+
 ///\}
 
@@ -58,16 +58,26 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <user/statusu.h>
 #include <user/timeru.h>
 #include <user/cfmu.h>
+#include <user/sdobatch.h>
 #include <user/eventucal.h>
 
 #include <common/ctrl.h>
+#include <common/cyclestat.h>
+#include <common/flightrec.h>
+#include <common/metrics.h>
 #include <oplk/obd.h>
 #include <common/target.h>
 
+#include <user/ctrlu.h>
 #include <user/ctrlucal.h>
 
 #if (CONFIG_OBD_USE_LOAD_CONCISEDCF != FALSE)
 #include <oplk/obdcdc.h>
+#include <oplk/obdfile.h>
+#endif
+
+#if (CONFIG_OBD_USE_STORE_MMAP != FALSE)
+#include <oplk/obdstore.h>
 #endif
 
 #if defined(CONFIG_INCLUDE_NMT_MN)
@@ -124,6 +134,11 @@ typedef struct
 {
     UINT16              lastHeartbeat;          ///< Last detected heartbeat
     tOplkApiInitParam   initParam;              ///< Stack initialization parameters
+#if (CONFIG_CTRL_STARTUP_TIMING != FALSE)
+    ULONGLONG           startTimestamp;         ///< Timestamp of the stack initialization
+    BOOL                fStartupComplete;       ///< The node reached PreOperational2
+    tOplkApiStartupTiming startupTiming;        ///< Duration of the start-up phases
+#endif
 } tCtrluInstance;
 
 //------------------------------------------------------------------------------
@@ -165,6 +180,11 @@ tOplkError linkDomainObjects(tLinkObjectRequest* pLinkRequest_p, size_t requestC
 static tOplkError cbBootEvent(tNmtBootEvent BootEvent_p, tNmtState NmtState_p,
                               UINT16 errorCode_p);
 
+#if (CONFIG_CTRL_STARTUP_TIMING != FALSE)
+static UINT32     getElapsedUs(ULONGLONG startTimestamp_p);
+static void       recordStartupTiming(tNmtState nmtState_p, ULONGLONG startTimestamp_p);
+#endif
+
 #if defined(CONFIG_INCLUDE_LEDU)
 static tOplkError cbLedStateChange(tLedType LedType_p, BOOL fOn_p);
 #endif
@@ -254,12 +274,25 @@ tOplkError ctrlu_initStack(tOplkApiInitParam* pInitParam_p)
 {
     tOplkError              ret = kErrorOk;
     tCtrlInitParam          ctrlParam;
+#if (CONFIG_CTRL_STARTUP_TIMING != FALSE)
+    ULONGLONG               timestamp;
+
+    OPLK_MEMSET(&ctrlInstance_l.startupTiming, 0, sizeof(tOplkApiStartupTiming));
+    ctrlInstance_l.fStartupComplete = FALSE;
+    ctrlInstance_l.startTimestamp = target_getCurrentTimestamp();
+    timestamp = ctrlInstance_l.startTimestamp;
+#endif
 
     // reset instance structure
     OPLK_MEMSET(&ctrlInstance_l.initParam, 0, sizeof(tOplkApiInitParam));
     OPLK_MEMCPY(&ctrlInstance_l.initParam, pInitParam_p,
                 min(sizeof(tOplkApiInitParam), (size_t)pInitParam_p->sizeOfInitParam));
 
+#if (TARGET_SYSTEM == _LINUX_)
+    // the thread placement must be known before the stack modules create their threads
+    target_setThreadConfig(ctrlInstance_l.initParam.aThreadParam);
+#endif
+
     // check event callback function pointer
     if (ctrlInstance_l.initParam.pfnCbEvent == NULL)
     {   // application must always have an event callback function
@@ -274,6 +307,11 @@ tOplkError ctrlu_initStack(tOplkApiInitParam* pInitParam_p)
     ret = linkDomainObjects(linkObjectRequestsMn, tabentries(linkObjectRequestsMn));
 #endif
 
+#if (CONFIG_CTRL_STARTUP_TIMING != FALSE)
+    ctrlInstance_l.startupTiming.odInitUs = getElapsedUs(timestamp);
+    timestamp = target_getCurrentTimestamp();
+#endif
+
     TRACE("Initializing kernel modules ...\n");
     OPLK_MEMCPY(ctrlParam.aMacAddress, ctrlInstance_l.initParam.aMacAddress, 6);
     strncpy(ctrlParam.szEthDevName, ctrlInstance_l.initParam.hwParam.pDevName, 127);
@@ -283,6 +321,11 @@ tOplkError ctrlu_initStack(tOplkApiInitParam* pInitParam_p)
     if ((ret = ctrlucal_executeCmd(kCtrlInitStack)) != kErrorOk)
         goto Exit;
 
+#if (CONFIG_CTRL_STARTUP_TIMING != FALSE)
+    ctrlInstance_l.startupTiming.kernelInitUs = getElapsedUs(timestamp);
+    timestamp = target_getCurrentTimestamp();
+#endif
+
     /* Read back init param because current MAC address was copied by DLLK */
     ret = ctrlucal_readInitParam(&ctrlParam);
     if (ret != kErrorOk)
@@ -292,6 +335,31 @@ tOplkError ctrlu_initStack(tOplkApiInitParam* pInitParam_p)
 
     OPLK_MEMCPY(ctrlInstance_l.initParam.aMacAddress, ctrlParam.aMacAddress, 6);
 
+#if (CONFIG_CYCLE_STATISTICS != FALSE)
+    TRACE("Initialize cycle statistics module...\n");
+    if ((ret = cyclestat_init()) != kErrorOk)
+        goto Exit;
+#endif
+
+#if (CONFIG_FLIGHT_RECORDER != FALSE)
+    TRACE("Initialize flight recorder module...\n");
+    if ((ret = flightrec_init()) != kErrorOk)
+        goto Exit;
+#endif
+
+#if (CONFIG_METRICS != FALSE)
+    TRACE("Initialize metrics registry...\n");
+    if ((ret = metrics_init()) != kErrorOk)
+        goto Exit;
+#endif
+
+#if (CONFIG_API_DEFERRED_EVENTS != FALSE)
+    TRACE("Initialize deferred API event worker...\n");
+    if ((ret = ctrlu_initDeferredEvents(ctrlInstance_l.initParam.pfnCbEvent,
+                                        ctrlInstance_l.initParam.pEventUserArg)) != kErrorOk)
+        goto Exit;
+#endif
+
     TRACE("Initialize Eventu module...\n");
     if ((ret = eventu_init(processUserEvent)) != kErrorOk)
         goto Exit;
@@ -350,6 +418,14 @@ tOplkError ctrlu_initStack(tOplkApiInitParam* pInitParam_p)
     }
 #endif
 
+#if defined(CONFIG_INCLUDE_SDOC)
+    ret = sdobatch_init();
+    if (ret != kErrorOk)
+    {
+        goto Exit;
+    }
+#endif
+
 #if defined (CONFIG_INCLUDE_CFM)
     TRACE("Initialize Cfm module...\n");
     ret = cfmu_init(cbCfmEventCnProgress, cbCfmEventCnResult);
@@ -359,6 +435,14 @@ tOplkError ctrlu_initStack(tOplkApiInitParam* pInitParam_p)
     }
 #endif
 
+#if (CONFIG_CTRL_STARTUP_TIMING != FALSE)
+    ctrlInstance_l.startupTiming.userInitUs = getElapsedUs(timestamp);
+    TRACE("Stack initialized: OD %lu us, kernel %lu us, user modules %lu us\n",
+          (ULONG)ctrlInstance_l.startupTiming.odInitUs,
+          (ULONG)ctrlInstance_l.startupTiming.kernelInitUs,
+          (ULONG)ctrlInstance_l.startupTiming.userInitUs);
+#endif
+
     // the application must start NMT state machine
     // via oplk_execNmtCommand(kNmtEventSwReset)
     // and thereby the whole POWERLINK stack
@@ -388,6 +472,11 @@ tOplkError ctrlu_shutdownStack(void)
     TRACE("cfmu_exit():    0x%X\n", ret);
 #endif
 
+#if defined(CONFIG_INCLUDE_SDOC)
+    ret = sdobatch_exit();
+    TRACE("sdobatch_exit():  0x%X\n", ret);
+#endif
+
 #if defined(CONFIG_INCLUDE_SDOS) || defined(CONFIG_INCLUDE_SDOC)
     ret = sdocom_delInstance();
     TRACE("sdocom_delInstance():  0x%X\n", ret);
@@ -434,6 +523,23 @@ tOplkError ctrlu_shutdownStack(void)
     ret = eventu_exit();
     TRACE("eventu_exit():  0x%X\n", ret);
 
+#if (CONFIG_API_DEFERRED_EVENTS != FALSE)
+    // deliver the remaining deferred events before the kernel stack is shut down
+    ctrlu_exitDeferredEvents();
+#endif
+
+#if (CONFIG_CYCLE_STATISTICS != FALSE)
+    cyclestat_exit();
+#endif
+
+#if (CONFIG_FLIGHT_RECORDER != FALSE)
+    flightrec_exit();
+#endif
+
+#if (CONFIG_METRICS != FALSE)
+    metrics_exit();
+#endif
+
     /* shutdown kernel stack */
     ret = ctrlucal_executeCmd(kCtrlCleanupStack);
     TRACE("shoutdown kernel modules():  0x%X\n", ret);
@@ -442,6 +548,14 @@ tOplkError ctrlu_shutdownStack(void)
     obdcdc_exit();
 #endif
 
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    obdfile_exit();
+#endif
+
+#if (CONFIG_OBD_USE_STORE_MMAP != FALSE)
+    obdstore_exit();
+#endif
+
     ret = obd_deleteInstance();
 
     return ret;
@@ -471,10 +585,90 @@ tOplkError ctrlu_processStack(void)
 
     ret = timeru_process();
 
+#if (TARGET_SYSTEM == _LINUX_) && (CONFIG_TARGET_CACHE_ALLOC != FALSE) && (CONFIG_METRICS != FALSE)
+    target_updateCacheMetrics();
+#endif
+
 Exit:
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Wait for work and process openPOWERLINK stack
+
+This function waits until an event is pending for the user part of the stack,
+the next user timer expires or the timeout elapsed. Afterwards it processes the
+stack like ctrlu_processStack().
+
+\param  timeoutMs_p         Maximum time to wait in milliseconds.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_ctrlu
+*/
+//------------------------------------------------------------------------------
+tOplkError ctrlu_waitAndProcess(UINT32 timeoutMs_p)
+{
+    UINT32      timerTimeout;
+
+    timerTimeout = timeru_getNextTimeout();
+    if (timerTimeout < timeoutMs_p)
+        timeoutMs_p = timerTimeout;
+
+    eventucal_waitEvent(timeoutMs_p);
+
+    return ctrlu_processStack();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get wait handle of openPOWERLINK stack
+
+This function returns a file descriptor which becomes readable if the user part
+of the stack processed events.
+
+\return The function returns the file descriptor or -1 if the target does not
+        provide one.
+
+\ingroup module_ctrlu
+*/
+//------------------------------------------------------------------------------
+int ctrlu_getWaitHandle(void)
+{
+#if (TARGET_SYSTEM == _LINUX_)
+    return eventucal_getWaitHandle();
+#else
+    return -1;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get event queue statistics
+
+This function returns the maximum used size of the event queues which are
+accessible by the user layer. The sizes are only recorded on Linux targets if
+the stack is compiled with DEBUG_CIRCBUF_SIZE_CHECK.
+
+\param  pStatistics_p           Pointer to store the statistics.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_ctrlu
+*/
+//------------------------------------------------------------------------------
+tOplkError ctrlu_getEventQueueStatistics(tEventQueueStatistics* pStatistics_p)
+{
+#if ((TARGET_SYSTEM == _LINUX_) && defined(DEBUG_CIRCBUF_SIZE_CHECK))
+    eventucal_getQueueStatistics(pStatistics_p);
+    return kErrorOk;
+#else
+    UNUSED_PARAMETER(pStatistics_p);
+    return kErrorApiNotSupported;
+#endif
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Check if kernel stack is running
@@ -522,7 +716,9 @@ BOOL ctrlu_checkKernelStack(void)
 /**
 \brief  Call user event callback
 
-The function calls the user event callback function
+The function calls the user event callback function. If
+CONFIG_API_DEFERRED_EVENTS is enabled, non-critical events are queued for the
+deferred event worker instead and kErrorOk is returned.
 
 \param  eventType_p         Event type to send.
 \param  pEventArg_p         Event argument to send.
@@ -536,6 +732,11 @@ tOplkError ctrlu_callUserEventCallback(tOplkApiEventType eventType_p, tOplkApiEv
 {
     tOplkError          ret = kErrorOk;
 
+#if (CONFIG_API_DEFERRED_EVENTS != FALSE)
+    if (ctrlu_postDeferredEvent(eventType_p, pEventArg_p) == kErrorOk)
+        return kErrorOk;
+#endif
+
     ret = ctrlInstance_l.initParam.pfnCbEvent(eventType_p, pEventArg_p,
                                               ctrlInstance_l.initParam.pEventUserArg);
     return ret;
@@ -575,7 +776,11 @@ tOplkError ctrlu_cbObdAccess(tObdCbParam MEM* pParam_p)
 
     switch (pParam_p->index)
     {
+#if (CONFIG_DLL_RUNTIME_CYCLE_CHANGE != FALSE)
+        case 0x1006:    // NMT_CycleLen_U32 (applied at a cycle boundary)
+#else
         //case 0x1006:    // NMT_CycleLen_U32 (valid on reset)
+#endif
         case 0x1C14:    // DLL_LossOfFrameTolerance_U32
         //case 0x1F98:    // NMT_CycleTiming_REC (valid on reset)
             if (pParam_p->obdEvent == kObdEvPostWrite)
@@ -598,6 +803,46 @@ tOplkError ctrlu_cbObdAccess(tObdCbParam MEM* pParam_p)
             }
             break;
 
+#if (CONFIG_OBD_USE_STORE_RESTORE != FALSE)
+        case 0x1010:    // NMT_StoreParam_REC
+        case 0x1011:    // NMT_RestoreDefParam_REC
+            if (pParam_p->obdEvent == kObdEvPreWrite)
+            {
+                tObdPart    odPart;
+
+                switch (pParam_p->subIndex)
+                {
+                    case 1:                             // all parameters
+                        odPart = kObdPartAll;
+                        break;
+
+                    case 2:                             // communication parameters
+                        odPart = kObdPartGen;
+                        break;
+
+                    case 3:                             // application parameters
+                        odPart = kObdPartApp;
+                        break;
+
+                    default:
+                        pParam_p->abortCode = SDO_AC_UNSUPPORTED_ACCESS;
+                        return kErrorObdAccessViolation;
+                }
+
+                // the signature "save" or "load" has to be written
+                if (*((UINT32*)pParam_p->pArg) != ((pParam_p->index == 0x1010) ? 0x65766173UL : 0x64616F6CUL))
+                {
+                    pParam_p->abortCode = SDO_AC_DATA_NOT_TRANSF_DUE_LOCAL_CONTROL;
+                    return kErrorWrongSignature;
+                }
+
+                ret = obd_accessOdPart(odPart, (pParam_p->index == 0x1010) ? kObdDirStore : kObdDirRestore);
+                if (ret != kErrorOk)
+                    pParam_p->abortCode = SDO_AC_ACCESS_FAILED_DUE_HW_ERROR;
+            }
+            break;
+#endif
+
         case 0x1F9E:    // NMT_ResetCmd_U8
             if (pParam_p->obdEvent == kObdEvPreWrite)
             {
@@ -745,6 +990,28 @@ tOplkError ctrlu_cbObdAccess(tObdCbParam MEM* pParam_p)
     return ret;
 }
 
+#if (CONFIG_CTRL_STARTUP_TIMING != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Get start-up timing
+
+The function copies the duration of the start-up phases which were measured
+since the last stack initialization.
+
+\param  pTiming_p               Pointer to store the start-up timing.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_ctrlu
+*/
+//------------------------------------------------------------------------------
+tOplkError ctrlu_getStartupTiming(tOplkApiStartupTiming* pTiming_p)
+{
+    OPLK_MEMCPY(pTiming_p, &ctrlInstance_l.startupTiming, sizeof(tOplkApiStartupTiming));
+    return kErrorOk;
+}
+#endif
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -847,6 +1114,12 @@ static tOplkError initObd(tOplkApiInitParam* pInitParam_p)
 
 #if (CONFIG_OBD_USE_LOAD_CONCISEDCF != FALSE)
     ret = obdcdc_init();
+    if (ret != kErrorOk)
+        return ret;
+#endif
+
+#if (CONFIG_OBD_USE_STORE_MMAP != FALSE)
+    ret = obdstore_init();
 #endif
 
     return ret;
@@ -868,6 +1141,14 @@ static tOplkError cbNmtStateChange(tEventNmtStateChange nmtStateChange_p)
     tOplkError          ret = kErrorOk;
     BYTE                nmtState;
     tOplkApiEventArg    eventArg;
+#if (CONFIG_CTRL_STARTUP_TIMING != FALSE)
+    ULONGLONG           timestamp;
+#if (CONFIG_OBD_USE_LOAD_CONCISEDCF != FALSE)
+    ULONGLONG           cdcTimestamp;
+#endif
+
+    timestamp = target_getCurrentTimestamp();
+#endif
 
     // save NMT state in OD
     nmtState = (UINT8)nmtStateChange_p.newNmtState;
@@ -916,9 +1197,16 @@ static tOplkError cbNmtStateChange(tEventNmtStateChange nmtStateChange_p)
                 return ret;
 
 #if (CONFIG_OBD_USE_LOAD_CONCISEDCF != FALSE)
+#if (CONFIG_CTRL_STARTUP_TIMING != FALSE)
+            cdcTimestamp = target_getCurrentTimestamp();
+#endif
             ret = obdcdc_loadCdc();
             if (ret != kErrorOk)
                 return ret;
+#if (CONFIG_CTRL_STARTUP_TIMING != FALSE)
+            if (!ctrlInstance_l.fStartupComplete)
+                ctrlInstance_l.startupTiming.cdcLoadUs = getElapsedUs(cdcTimestamp);
+#endif
 #endif
             break;
 
@@ -1004,6 +1292,10 @@ static tOplkError cbNmtStateChange(tEventNmtStateChange nmtStateChange_p)
             break;
     }
 
+#if (CONFIG_CTRL_STARTUP_TIMING != FALSE)
+    recordStartupTiming(nmtStateChange_p.newNmtState, timestamp);
+#endif
+
 #if defined(CONFIG_INCLUDE_LEDU)
     // forward event to Led module
     ret = ledu_cbNmtStateChange(nmtStateChange_p);
@@ -1747,4 +2039,77 @@ tOplkError linkDomainObjects(tLinkObjectRequest* pLinkRequest_p, size_t requestC
     return ret;
 }
 #endif
+#if (CONFIG_CTRL_STARTUP_TIMING != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Get elapsed time
+
+The function returns the time which elapsed since the specified timestamp.
+
+\param  startTimestamp_p        Start timestamp (target_getCurrentTimestamp()).
+
+\return The function returns the elapsed time in microseconds.
+*/
+//------------------------------------------------------------------------------
+static UINT32 getElapsedUs(ULONGLONG startTimestamp_p)
+{
+    return (UINT32)((target_getCurrentTimestamp() - startTimestamp_p) / 1000);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Record start-up timing of an NMT state
+
+The function records the duration of the NMT reset states and the time until
+the node reaches PreOperational1 and PreOperational2 after the stack
+initialization. Only the first start-up is recorded.
+
+\param  nmtState_p              New NMT state.
+\param  startTimestamp_p        Timestamp at which the state change was
+                                processed.
+*/
+//------------------------------------------------------------------------------
+static void recordStartupTiming(tNmtState nmtState_p, ULONGLONG startTimestamp_p)
+{
+    tOplkApiStartupTiming*  pTiming = &ctrlInstance_l.startupTiming;
+
+    if (ctrlInstance_l.fStartupComplete)
+        return;
+
+    switch (nmtState_p)
+    {
+        case kNmtGsResetApplication:
+            pTiming->resetApplicationUs = getElapsedUs(startTimestamp_p);
+            break;
+
+        case kNmtGsResetCommunication:
+            pTiming->resetCommunicationUs = getElapsedUs(startTimestamp_p);
+            break;
+
+        case kNmtGsResetConfiguration:
+            pTiming->resetConfigurationUs = getElapsedUs(startTimestamp_p);
+            break;
+
+        case kNmtCsPreOperational1:
+        case kNmtMsPreOperational1:
+            pTiming->preOp1Us = getElapsedUs(ctrlInstance_l.startTimestamp);
+            break;
+
+        case kNmtCsPreOperational2:
+        case kNmtMsPreOperational2:
+            pTiming->preOp2Us = getElapsedUs(ctrlInstance_l.startTimestamp);
+            ctrlInstance_l.fStartupComplete = TRUE;
+            TRACE("Start-up: reset application %lu us, reset communication %lu us "
+                  "(CDC %lu us), reset configuration %lu us, PreOp1 %lu us, PreOp2 %lu us\n",
+                  (ULONG)pTiming->resetApplicationUs, (ULONG)pTiming->resetCommunicationUs,
+                  (ULONG)pTiming->cdcLoadUs, (ULONG)pTiming->resetConfigurationUs,
+                  (ULONG)pTiming->preOp1Us, (ULONG)pTiming->preOp2Us);
+            break;
+
+        default:
+            break;
+    }
+}
+#endif
+
 /// \}
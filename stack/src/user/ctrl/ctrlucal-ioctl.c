@@ -90,10 +90,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // local vars
 //------------------------------------------------------------------------------
 static int fd_l;           // file descriptor for powerlink device
+static tCtrlStatusMem*  pStatusMem_l = NULL;    // status page of the kernel stack
 
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
+static void readStatusMem(UINT16* pStatus_p, UINT16* pHeartbeat_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -112,12 +114,28 @@ The function initializes the user control CAL module.
 //------------------------------------------------------------------------------
 tOplkError ctrlucal_init(void)
 {
+    void*       pMem;
+
     if ((fd_l = open(PLK_DEV_FILE, O_RDWR)) < 0)
     {
         TRACE("%s() open return error %d (%s)\n", __func__, fd_l, strerror(fd_l));
         return kErrorNoResource;
     }
 
+    // map the status page, status and heartbeat are read by ioctl if the
+    // kernel module does not provide it
+    pMem = mmap(NULL, sizeof(tCtrlStatusMem), PROT_READ, MAP_SHARED, fd_l,
+                PLK_MMAP_PGOFF_CTRL_STATUS * sysconf(_SC_PAGE_SIZE));
+    if (pMem == MAP_FAILED)
+    {
+        TRACE("%s() status page not available, using ioctl\n", __func__);
+        pStatusMem_l = NULL;
+    }
+    else
+    {
+        pStatusMem_l = (tCtrlStatusMem*)pMem;
+    }
+
     return kErrorOk;
 }
 
@@ -132,6 +150,12 @@ The function cleans up the user control CAL module.
 //------------------------------------------------------------------------------
 void ctrlucal_exit(void)
 {
+    if (pStatusMem_l != NULL)
+    {
+        munmap(pStatusMem_l, sizeof(tCtrlStatusMem));
+        pStatusMem_l = NULL;
+    }
+
     close(fd_l);
 }
 
@@ -251,6 +275,13 @@ UINT16 ctrlucal_getStatus(void)
 {
     int         ret;
     UINT16      status;
+    UINT16      heartbeat;
+
+    if (pStatusMem_l != NULL)
+    {
+        readStatusMem(&status, &heartbeat);
+        return status;
+    }
 
     if ((ret = ioctl(fd_l, PLK_CMD_CTRL_GET_STATUS, &status)) != 0)
     {
@@ -274,8 +305,15 @@ The function reads the heartbeat genereated by the kernel stack.
 UINT16 ctrlucal_getHeartbeat(void)
 {
     int         ret;
+    UINT16      status;
     UINT16      heartbeat;
 
+    if (pStatusMem_l != NULL)
+    {
+        readStatusMem(&status, &heartbeat);
+        return heartbeat;
+    }
+
     if ((ret = ioctl(fd_l, PLK_CMD_CTRL_GET_HEARTBEAT, &heartbeat)) != 0)
     {
         TRACE("%s() error %d\n", __func__, ret);
@@ -352,4 +390,32 @@ int ctrlucal_getFd(void)
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read status and heartbeat from the status page
+
+The function reads a consistent pair of status and heartbeat counter from the
+status page mapped from the kernel module.
+
+\param  pStatus_p           Pointer to store the kernel stack status.
+\param  pHeartbeat_p        Pointer to store the heartbeat counter.
+*/
+//------------------------------------------------------------------------------
+static void readStatusMem(UINT16* pStatus_p, UINT16* pHeartbeat_p)
+{
+    UINT32      sequence;
+
+    do
+    {
+        sequence = pStatusMem_l->sequence;
+        OPLK_MEMBAR();
+        *pStatus_p = pStatusMem_l->status;
+        *pHeartbeat_p = pStatusMem_l->heartbeat;
+        OPLK_MEMBAR();
+    } while (((sequence & 1) != 0) || (sequence != pStatusMem_l->sequence));
+}
 
+///\}
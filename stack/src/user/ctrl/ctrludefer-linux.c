@@ -0,0 +1,418 @@
+/**
+********************************************************************************
+\file   ctrludefer-linux.c
+
+\brief  Deferred API event callbacks for Linux userspace
+
+This file implements a worker thread which calls the application event
+callback for non-critical API events. The user event thread only queues these
+events, so the processing of the stack events does not depend on the duration
+of the application handlers (e.g. LED signalling via sysfs GPIOs).
+
+Only events whose return value is not evaluated by the stack are deferred:
+LED events, node events (except kNmtNodeEventCheckConf and
+kNmtNodeEventUpdateConf), boot events, warnings and error history entries. A
+queued LED event is replaced by a newer event of the same LED and a queued NMT
+state event of a node is replaced by a newer NMT state event of the same node,
+as long as no other event of this node was queued in between. Deferred events
+are delivered in the order they were queued, but asynchronously to the events
+which are still called by the user event thread. If the queue is full, the
+event is handed back to the caller which calls the callback directly.
+
+The worker is enabled with CONFIG_API_DEFERRED_EVENTS.
+
+\ingroup module_ctrlu
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <user/ctrlu.h>
+#include <common/target.h>
+
+#if (CONFIG_API_DEFERRED_EVENTS != FALSE)
+
+#include <pthread.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define CTRLU_DEFER_QUEUE_MASK          (CONFIG_API_DEFERRED_EVENTS_QUEUE_SIZE - 1)
+
+#if ((CONFIG_API_DEFERRED_EVENTS_QUEUE_SIZE & CTRLU_DEFER_QUEUE_MASK) != 0)
+#error "CONFIG_API_DEFERRED_EVENTS_QUEUE_SIZE must be a power of two!"
+#endif
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief Deferred event queue entry
+
+The structure contains an API event which is queued for the worker thread.
+*/
+typedef struct
+{
+    tOplkApiEventType   eventType;                      ///< Type of the event
+    tOplkApiEventArg    eventArg;                       ///< Copy of the event argument
+} tCtrluDeferEntry;
+
+/**
+\brief Deferred event worker instance
+
+The structure contains the instance variables of the deferred event worker.
+The queue is protected by the mutex.
+*/
+typedef struct
+{
+    pthread_t           threadId;                       ///< ID of the worker thread
+    pthread_mutex_t     mutex;                          ///< Mutex protecting the queue
+    pthread_cond_t      condition;                      ///< Condition to wake up the worker thread
+    BOOL                fStopThread;                    ///< Flag to stop the worker thread
+    BOOL                fInitialized;                   ///< Flag determines if the worker is initialized
+    tOplkApiCbEvent     pfnCbEvent;                     ///< Event callback of the application
+    void*               pUserArg;                       ///< User argument of the event callback
+    UINT                readIndex;                      ///< Index of the next entry to be read
+    UINT                count;                          ///< Number of queued entries
+    UINT                coalescedCount;                 ///< Number of events replaced by a newer event
+    UINT                overflowCount;                  ///< Number of events called directly because the queue was full
+    tCtrluDeferEntry    aEntry[CONFIG_API_DEFERRED_EVENTS_QUEUE_SIZE];  ///< Queue entries
+} tCtrluDeferInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tCtrluDeferInstance  instance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static BOOL  isDeferrable(tOplkApiEventType eventType_p, const tOplkApiEventArg* pEventArg_p);
+static BOOL  coalesceEvent(tOplkApiEventType eventType_p, const tOplkApiEventArg* pEventArg_p);
+static void* workerThread(void* pArg_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize deferred event worker
+
+The function initializes the deferred event queue and starts the worker thread.
+The worker thread inherits the scheduling parameters of the calling thread
+unless the application placed the role kThreadRoleApiEvent.
+
+\param  pfnCbEvent_p            Event callback of the application.
+\param  pUserArg_p              User argument of the event callback.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_ctrlu
+*/
+//------------------------------------------------------------------------------
+tOplkError ctrlu_initDeferredEvents(tOplkApiCbEvent pfnCbEvent_p, void* pUserArg_p)
+{
+    OPLK_MEMSET(&instance_l, 0, sizeof(tCtrluDeferInstance));
+
+    instance_l.pfnCbEvent = pfnCbEvent_p;
+    instance_l.pUserArg = pUserArg_p;
+
+    if (pthread_mutex_init(&instance_l.mutex, NULL) != 0)
+        return kErrorNoResource;
+
+    if (pthread_cond_init(&instance_l.condition, NULL) != 0)
+    {
+        pthread_mutex_destroy(&instance_l.mutex);
+        return kErrorNoResource;
+    }
+
+    if (target_createThread(&instance_l.threadId, kThreadRoleApiEvent, "oplk-apievent",
+                            workerThread, (void*)&instance_l) != kErrorOk)
+    {
+        pthread_cond_destroy(&instance_l.condition);
+        pthread_mutex_destroy(&instance_l.mutex);
+        return kErrorNoResource;
+    }
+
+    // The worker is no realtime thread, it is only placed on request
+    target_setThreadParams(instance_l.threadId, kThreadRoleApiEvent, kThreadSchedDefault, 0, 0);
+
+    instance_l.fInitialized = TRUE;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Clean up deferred event worker
+
+The function stops the worker thread after it delivered the queued events.
+
+\ingroup module_ctrlu
+*/
+//------------------------------------------------------------------------------
+void ctrlu_exitDeferredEvents(void)
+{
+    if (!instance_l.fInitialized)
+        return;
+
+    pthread_mutex_lock(&instance_l.mutex);
+    instance_l.fInitialized = FALSE;
+    instance_l.fStopThread = TRUE;
+    pthread_cond_signal(&instance_l.condition);
+    pthread_mutex_unlock(&instance_l.mutex);
+
+    pthread_join(instance_l.threadId, NULL);
+
+    if ((instance_l.coalescedCount != 0) || (instance_l.overflowCount != 0))
+    {
+        DEBUG_LVL_EVENTU_TRACE("%s() %u events coalesced, %u called directly\n",
+                               __func__, instance_l.coalescedCount, instance_l.overflowCount);
+    }
+
+    pthread_cond_destroy(&instance_l.condition);
+    pthread_mutex_destroy(&instance_l.mutex);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Post an API event to the deferred event worker
+
+The function queues an API event for the worker thread if the event can be
+deferred. A queued event of the same source is replaced by the new event if
+possible.
+
+\param  eventType_p             Type of the event.
+\param  pEventArg_p             Event argument. It is copied into the queue.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The event was queued.
+\retval kErrorReject            The event must be delivered by the caller,
+                                because it cannot be deferred or the queue
+                                is full.
+
+\ingroup module_ctrlu
+*/
+//------------------------------------------------------------------------------
+tOplkError ctrlu_postDeferredEvent(tOplkApiEventType eventType_p, const tOplkApiEventArg* pEventArg_p)
+{
+    tCtrluDeferEntry*   pEntry;
+
+    if (!instance_l.fInitialized || !isDeferrable(eventType_p, pEventArg_p))
+        return kErrorReject;
+
+    pthread_mutex_lock(&instance_l.mutex);
+
+    if (coalesceEvent(eventType_p, pEventArg_p))
+    {
+        instance_l.coalescedCount++;
+        pthread_mutex_unlock(&instance_l.mutex);
+        return kErrorOk;
+    }
+
+    if (instance_l.count >= CONFIG_API_DEFERRED_EVENTS_QUEUE_SIZE)
+    {
+        instance_l.overflowCount++;
+        pthread_mutex_unlock(&instance_l.mutex);
+        return kErrorReject;
+    }
+
+    pEntry = &instance_l.aEntry[(instance_l.readIndex + instance_l.count) & CTRLU_DEFER_QUEUE_MASK];
+    pEntry->eventType = eventType_p;
+    pEntry->eventArg = *pEventArg_p;
+    instance_l.count++;
+
+    pthread_cond_signal(&instance_l.condition);
+    pthread_mutex_unlock(&instance_l.mutex);
+
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check if an API event can be deferred
+
+\param  eventType_p             Type of the event.
+\param  pEventArg_p             Event argument.
+
+\return The function returns TRUE if the stack does not evaluate the return
+        value of the event callback for this event.
+*/
+//------------------------------------------------------------------------------
+static BOOL isDeferrable(tOplkApiEventType eventType_p, const tOplkApiEventArg* pEventArg_p)
+{
+    switch (eventType_p)
+    {
+        case kOplkApiEventLed:
+        case kOplkApiEventBoot:
+        case kOplkApiEventWarning:
+        case kOplkApiEventHistoryEntry:
+            return TRUE;
+
+        case kOplkApiEventNode:
+            return ((pEventArg_p->nodeEvent.nodeEvent != kNmtNodeEventCheckConf) &&
+                    (pEventArg_p->nodeEvent.nodeEvent != kNmtNodeEventUpdateConf));
+
+        default:
+            return FALSE;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Replace a queued event by a newer event
+
+The function searches the queue from the newest to the oldest entry for an
+event of the same source. LED events replace the queued event of the same LED.
+NMT state events of a node replace the queued NMT state event of the node if it
+is the newest queued event of this node. The mutex must be locked by the
+caller.
+
+\param  eventType_p             Type of the new event.
+\param  pEventArg_p             Event argument of the new event.
+
+\return The function returns TRUE if a queued event was replaced.
+*/
+//------------------------------------------------------------------------------
+static BOOL coalesceEvent(tOplkApiEventType eventType_p, const tOplkApiEventArg* pEventArg_p)
+{
+    tCtrluDeferEntry*   pEntry;
+    UINT                i;
+
+    if ((eventType_p != kOplkApiEventLed) &&
+        ((eventType_p != kOplkApiEventNode) ||
+         (pEventArg_p->nodeEvent.nodeEvent != kNmtNodeEventNmtState)))
+        return FALSE;
+
+    for (i = instance_l.count; i > 0; i--)
+    {
+        pEntry = &instance_l.aEntry[(instance_l.readIndex + i - 1) & CTRLU_DEFER_QUEUE_MASK];
+        if (pEntry->eventType != eventType_p)
+            continue;
+
+        if (eventType_p == kOplkApiEventLed)
+        {
+            if (pEntry->eventArg.ledEvent.ledType != pEventArg_p->ledEvent.ledType)
+                continue;
+        }
+        else
+        {
+            if (pEntry->eventArg.nodeEvent.nodeId != pEventArg_p->nodeEvent.nodeId)
+                continue;
+
+            if (pEntry->eventArg.nodeEvent.nodeEvent != kNmtNodeEventNmtState)
+                return FALSE;   // keep the order of the events of this node
+        }
+
+        pEntry->eventArg = *pEventArg_p;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Deferred event worker thread
+
+The thread calls the event callback of the application for the queued events.
+The mutex is released while the callback is executed. When the thread is
+stopped, it delivers the remaining events before it exits.
+
+\param  pArg_p                  Thread argument (pointer to the instance).
+
+\return The function returns the thread exit code.
+*/
+//------------------------------------------------------------------------------
+static void* workerThread(void* pArg_p)
+{
+    tCtrluDeferInstance*    pInstance = (tCtrluDeferInstance*)pArg_p;
+    tCtrluDeferEntry        entry;
+    tOplkError              ret;
+
+    pthread_mutex_lock(&pInstance->mutex);
+    for (;;)
+    {
+        while ((pInstance->count == 0) && !pInstance->fStopThread)
+            pthread_cond_wait(&pInstance->condition, &pInstance->mutex);
+
+        if (pInstance->count == 0)
+            break;
+
+        entry = pInstance->aEntry[pInstance->readIndex];
+        pInstance->readIndex = (pInstance->readIndex + 1) & CTRLU_DEFER_QUEUE_MASK;
+        pInstance->count--;
+        pthread_mutex_unlock(&pInstance->mutex);
+
+        ret = pInstance->pfnCbEvent(entry.eventType, &entry.eventArg, pInstance->pUserArg);
+        if (ret != kErrorOk)
+        {
+            DEBUG_LVL_EVENTU_TRACE("%s() event 0x%X returned 0x%X\n",
+                                   __func__, entry.eventType, ret);
+        }
+
+        pthread_mutex_lock(&pInstance->mutex);
+    }
+    pthread_mutex_unlock(&pInstance->mutex);
+
+    return NULL;
+}
+
+/// \}
+
+#endif // CONFIG_API_DEFERRED_EVENTS != FALSE
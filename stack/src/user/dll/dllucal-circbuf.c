@@ -100,6 +100,8 @@ static tOplkError insertDataBlock(tDllCalQueueInstance pDllCalQueue_p, BYTE* pDa
 static tOplkError getDataBlock(tDllCalQueueInstance pDllCalQueue_p, BYTE* pData_p, UINT* pDataSize_p);
 static tOplkError getDataBlockCount(tDllCalQueueInstance pDllCalQueue_p, ULONG* pDataBlockCount_p);
 static tOplkError resetDataBlockQueue(tDllCalQueueInstance pDllCalQueue_p, ULONG timeOutMs_p);
+static tOplkError reserveDataBlock(tDllCalQueueInstance pDllCalQueue_p, UINT8** ppData_p, UINT dataSize_p);
+static tOplkError commitDataBlock(tDllCalQueueInstance pDllCalQueue_p, UINT8* pData_p);
 
 /* define external function interface */
 static tDllCalFuncIntf funcintf_l =
@@ -109,7 +111,9 @@ static tDllCalFuncIntf funcintf_l =
     insertDataBlock,
     getDataBlock,
     getDataBlockCount,
-    resetDataBlockQueue
+    resetDataBlockQueue,
+    reserveDataBlock,
+    commitDataBlock
 };
 
 //============================================================================//
@@ -388,3 +392,74 @@ static tOplkError resetDataBlockQueue(tDllCalQueueInstance pDllCalQueue_p,
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Reserve data block in queue
+
+Reserves a data block in the DLL CAL queue which can be filled in place. The
+data block must be handed over to the DLL by calling commitDataBlock().
+
+\param  pDllCalQueue_p          Pointer to DllCal Queue instance
+\param  ppData_p                Pointer to store the pointer to the data block
+\param  dataSize_p              Size of the data block
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                    Function executes correctly
+\retval kErrorDllAsyncTxBufferFull  The queue is full
+\retval other                       Error
+*/
+//------------------------------------------------------------------------------
+static tOplkError reserveDataBlock(tDllCalQueueInstance pDllCalQueue_p,
+                                   UINT8** ppData_p, UINT dataSize_p)
+{
+    tCircBufError               error;
+    tDllCalCircBufInstance*     pDllCalCircBufInstance =
+                                        (tDllCalCircBufInstance*)pDllCalQueue_p;
+
+    if (pDllCalCircBufInstance == NULL)
+        return kErrorInvalidInstanceParam;
+
+    error = circbuf_reserve(pDllCalCircBufInstance->pCircBufInstance, dataSize_p,
+                            (void**)ppData_p);
+    switch (error)
+    {
+        case kCircBufOk:
+            return kErrorOk;
+
+        case kCircBufOutOfMem:
+        case kCircBufBufferFull:
+            return kErrorDllAsyncTxBufferFull;
+
+        default:
+            return kErrorNoResource;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Commit data block in queue
+
+Commits a data block which was reserved by reserveDataBlock().
+
+\param  pDllCalQueue_p          Pointer to DllCal Queue instance
+\param  pData_p                 Pointer to the data block
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                Function executes correctly
+\retval other                   Error
+*/
+//------------------------------------------------------------------------------
+static tOplkError commitDataBlock(tDllCalQueueInstance pDllCalQueue_p, UINT8* pData_p)
+{
+    tDllCalCircBufInstance*     pDllCalCircBufInstance =
+                                        (tDllCalCircBufInstance*)pDllCalQueue_p;
+
+    if (pDllCalCircBufInstance == NULL)
+        return kErrorInvalidInstanceParam;
+
+    if (circbuf_commit(pDllCalCircBufInstance->pCircBufInstance, pData_p) != kCircBufOk)
+        return kErrorNoResource;
+
+    return kErrorOk;
+}
+
@@ -42,9 +42,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 #include <common/dllcal.h>
 #include <user/ctrlucal.h>
+#include <user/eventu.h>
 #include <oplk/powerlink-module.h>
 
 #include <sys/ioctl.h>
+#include <pthread.h>
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -87,9 +89,26 @@ typedef struct
     int                         fd;                 ///< File descriptor of openPOWERLINK driver
 } tDllCalIoctlInstance;
 
+/**
+\brief Batch of async frames
+
+Frames which are sent by the thread that started a batch are collected and
+sent to the kernel with a single PLK_CMD_DLLCAL_ASYNCSEND_MULTI call.
+*/
+typedef struct
+{
+    BOOL                fActive;                ///< Frames are collected in the batch
+    pthread_t           threadId;               ///< Thread which started the batch
+    UINT                frameCount;             ///< Number of collected frames
+    tIoctlDllCalAsync   aFrame[PLK_DLLCAL_ASYNCSEND_MAX_FRAMES];
+    tOplkError          aStatus[PLK_DLLCAL_ASYNCSEND_MAX_FRAMES];
+    BYTE                aFrameData[PLK_DLLCAL_ASYNCSEND_MAX_FRAMES][C_DLL_MAX_ASYNC_MTU];
+} tDllCalIoctlBatch;
+
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
+static tDllCalIoctlBatch    batch_l;
 
 //------------------------------------------------------------------------------
 // local function prototypes
@@ -101,6 +120,7 @@ typedef struct
 static tOplkError addInstance(tDllCalQueueInstance* ppDllCalQueue_p, tDllCalQueue DllCalQueue_p);
 static tOplkError delInstance(tDllCalQueueInstance pDllCalQueue_p);
 static tOplkError insertDataBlock(tDllCalQueueInstance pDllCalQueue_p, BYTE* pData_p, UINT* pDataSize_p);
+static tOplkError sendBatch(void);
 
 /* define external function interface */
 static tDllCalFuncIntf funcintf_l =
@@ -110,6 +130,8 @@ static tDllCalFuncIntf funcintf_l =
     insertDataBlock,
     NULL,
     NULL,
+    NULL,
+    NULL,
     NULL
 };
 
@@ -134,6 +156,43 @@ tDllCalFuncIntf* dllcalioctl_getInterface(void)
     return &funcintf_l;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Start collecting async frames
+
+After calling this function all NMT and generic async frames sent by the
+calling thread are collected and sent to the kernel with one call when the
+batch is full or dllcalioctl_flushBatch() is called. Frames of other threads
+are sent immediately. Errors of collected frames are reported by error events.
+
+\ingroup module_dllucal
+*/
+//------------------------------------------------------------------------------
+void dllcalioctl_startBatch(void)
+{
+    batch_l.frameCount = 0;
+    batch_l.threadId = pthread_self();
+    batch_l.fActive = TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send collected async frames
+
+The function sends all frames collected since dllcalioctl_startBatch() and
+stops collecting frames.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_dllucal
+*/
+//------------------------------------------------------------------------------
+tOplkError dllcalioctl_flushBatch(void)
+{
+    batch_l.fActive = FALSE;
+    return sendBatch();
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -227,6 +286,20 @@ static tOplkError insertDataBlock(tDllCalQueueInstance pDllCalQueue_p,
         goto Exit;
     }
 
+    if (batch_l.fActive && pthread_equal(batch_l.threadId, pthread_self()) &&
+        (pInstance->dllCalQueue != kDllCalQueueTxSync) && (*pDataSize_p <= C_DLL_MAX_ASYNC_MTU))
+    {
+        if (batch_l.frameCount == PLK_DLLCAL_ASYNCSEND_MAX_FRAMES)
+            sendBatch();
+
+        OPLK_MEMCPY(batch_l.aFrameData[batch_l.frameCount], pData_p, *pDataSize_p);
+        batch_l.aFrame[batch_l.frameCount].size = *pDataSize_p;
+        batch_l.aFrame[batch_l.frameCount].queue = pInstance->dllCalQueue;
+        batch_l.aFrame[batch_l.frameCount].pData = batch_l.aFrameData[batch_l.frameCount];
+        batch_l.frameCount++;
+        return kErrorOk;
+    }
+
     ioctlAsyncFrame.size = *pDataSize_p;
     ioctlAsyncFrame.queue = pInstance->dllCalQueue;
     ioctlAsyncFrame.pData = pData_p;
@@ -240,3 +313,53 @@ Exit:
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Send batch of async frames
+
+The function sends the collected async frames to the kernel. Frames which
+could not be written into the kernel queues are reported by error events.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                All frames are sent
+\retval other                   At least one frame is lost
+*/
+//------------------------------------------------------------------------------
+static tOplkError sendBatch(void)
+{
+    tOplkError                  ret = kErrorOk;
+    tIoctlDllCalAsyncMulti      multiInfo;
+    UINT                        i;
+
+    if (batch_l.frameCount == 0)
+        return kErrorOk;
+
+    multiInfo.pFrames = batch_l.aFrame;
+    multiInfo.pStatus = batch_l.aStatus;
+    multiInfo.frameCount = batch_l.frameCount;
+    batch_l.frameCount = 0;
+
+    if (ioctl(ctrlucal_getFd(), PLK_CMD_DLLCAL_ASYNCSEND_MULTI, (ULONG)&multiInfo) < 0)
+    {
+        ret = kErrorDllAsyncTxBufferFull;
+        eventu_postError(kEventSourceDllu, ret, sizeof(multiInfo.frameCount),
+                         &multiInfo.frameCount);
+        return ret;
+    }
+
+    for (i = 0; i < multiInfo.frameCount; i++)
+    {
+        if (batch_l.aStatus[i] == kErrorOk)
+            continue;
+
+        DEBUG_LVL_ERROR_TRACE("%s() frame %d lost (0x%X), queue fill level NMT:%d gen:%d\n",
+                              __func__, i, batch_l.aStatus[i],
+                              multiInfo.fillLevelNmt, multiInfo.fillLevelGen);
+        ret = batch_l.aStatus[i];
+        eventu_postError(kEventSourceDllu, ret, sizeof(batch_l.aFrame[i].queue),
+                         &batch_l.aFrame[i].queue);
+    }
+
+    return ret;
+}
+
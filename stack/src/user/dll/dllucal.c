@@ -103,6 +103,7 @@ static tOplkError SetAsndServiceIdFilter(tDllAsndServiceId ServiceId_p,
                                          tDllAsndFilter Filter_p);
 static tOplkError HandleRxAsndFrame(tFrameInfo* pFrameInfo_p);
 static tOplkError HandleNotRxAsndFrame(tDllAsndNotRx* pAsndNotRx_p);
+static tOplkError postFillTxEvent(tDllAsyncReqPriority priority_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -329,6 +330,47 @@ tOplkError dllucal_regAsndService(tDllAsndServiceId serviceId_p,
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Set ASnd forwarding limits
+
+This function configures the kernel DLL to limit the number of received frames
+of the specified ASnd service ID which are forwarded to the user layer. Frames
+above the limit are dropped in the kernel layer. Responses to requests of the
+local MN are always forwarded.
+
+\param  serviceId_p             ASnd service ID to limit.
+\param  maxFramesPerSec_p       Maximum number of forwarded frames per second.
+                                0 disables the rate limit.
+\param  fCoalesce_p             If TRUE, unchanged StatusResponses of a node are
+                                not forwarded again. Only valid for
+                                kDllAsndStatusResponse.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_dllucal
+*/
+//------------------------------------------------------------------------------
+tOplkError dllucal_setAsndServiceLimit(tDllAsndServiceId serviceId_p,
+                                       UINT maxFramesPerSec_p, BOOL fCoalesce_p)
+{
+    tEvent                      event;
+    tDllCalAsndServiceIdLimit   servLimit;
+
+    if (serviceId_p >= tabentries(instance_l.apfnDlluCbAsnd))
+        return kErrorDllInvalidAsndServiceId;
+
+    event.eventSink = kEventSinkDllkCal;
+    event.eventType = kEventTypeDllkServLimit;
+    servLimit.serviceId = serviceId_p;
+    servLimit.maxFramesPerSec = maxFramesPerSec_p;
+    servLimit.fCoalesce = fCoalesce_p;
+    event.pEventArg = &servLimit;
+    event.eventArgSize = sizeof(servLimit);
+
+    return eventu_postEvent(&event);
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Send asynchronous frame
@@ -348,7 +390,6 @@ tOplkError dllucal_sendAsyncFrame(tFrameInfo* pFrameInfo_p,
                                   tDllAsyncReqPriority priority_p)
 {
     tOplkError  ret = kErrorOk;
-    tEvent      event;
 
     switch (priority_p)
     {
@@ -368,20 +409,103 @@ tOplkError dllucal_sendAsyncFrame(tFrameInfo* pFrameInfo_p,
     }
 
     if (ret != kErrorOk)
+        return ret;
+
+    return postFillTxEvent(priority_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Allocate asynchronous frame in the TX queue
+
+This function allocates an asynchronous frame directly in the TX queue of the
+specified priority. The caller builds the frame in place and hands it over to
+the DLL by calling dllucal_sendAllocatedAsyncFrame(), which saves the copy of
+the frame into the queue. An allocated frame holds back all following frames
+of the queue, so it must be sent without delay.
+
+\param  pFrameInfo_p            Pointer to frame info. The frame size must be
+                                set by the caller and includes the ethernet
+                                header (14 bytes). The pointer to the frame
+                                is returned in it.
+\param  priority_p              Priority for sending this frame.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                    The frame was allocated.
+\retval kErrorDllAsyncTxBufferFull  The TX queue is full.
+\retval kErrorApiNotSupported       The DLL CAL queue can't allocate frames in
+                                    place, the frame must be sent by
+                                    dllucal_sendAsyncFrame().
+
+\ingroup module_dllucal
+*/
+//------------------------------------------------------------------------------
+tOplkError dllucal_allocAsyncFrame(tFrameInfo* pFrameInfo_p,
+                                   tDllAsyncReqPriority priority_p)
+{
+    tDllCalFuncIntf*        pFuncs;
+    tDllCalQueueInstance    queue;
+    UINT8*                  pData;
+    tOplkError              ret;
+
+    if (priority_p == kDllAsyncReqPrioNmt)
     {
-        goto Exit;
+        pFuncs = instance_l.pTxNmtFuncs;
+        queue = instance_l.dllCalQueueTxNmt;
+    }
+    else
+    {
+        pFuncs = instance_l.pTxGenFuncs;
+        queue = instance_l.dllCalQueueTxGen;
     }
 
-    // post event to DLL
-    event.eventSink = kEventSinkDllk;
-    event.eventType = kEventTypeDllkFillTx;
-    OPLK_MEMSET(&event.netTime, 0x00, sizeof(event.netTime));
-    event.pEventArg = &priority_p;
-    event.eventArgSize = sizeof(priority_p);
-    ret = eventu_postEvent(&event);
+    if ((pFuncs->pfnReserveDataBlock == NULL) || (pFuncs->pfnCommitDataBlock == NULL))
+        return kErrorApiNotSupported;
 
-Exit:
-    return ret;
+    ret = pFuncs->pfnReserveDataBlock(queue, &pData, pFrameInfo_p->frameSize);
+    if (ret != kErrorOk)
+        return ret;
+
+    pFrameInfo_p->pFrame = (tPlkFrame*)pData;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send allocated asynchronous frame
+
+This function hands an asynchronous frame which was allocated by
+dllucal_allocAsyncFrame() and built in place over to the DLL.
+
+\param  pFrameInfo_p            Pointer to the frame info returned by
+                                dllucal_allocAsyncFrame().
+\param  priority_p              Priority the frame was allocated with.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_dllucal
+*/
+//------------------------------------------------------------------------------
+tOplkError dllucal_sendAllocatedAsyncFrame(tFrameInfo* pFrameInfo_p,
+                                           tDllAsyncReqPriority priority_p)
+{
+    tOplkError  ret;
+
+    if (priority_p == kDllAsyncReqPrioNmt)
+    {
+        ret = instance_l.pTxNmtFuncs->pfnCommitDataBlock(instance_l.dllCalQueueTxNmt,
+                                                         (UINT8*)pFrameInfo_p->pFrame);
+    }
+    else
+    {
+        ret = instance_l.pTxGenFuncs->pfnCommitDataBlock(instance_l.dllCalQueueTxGen,
+                                                         (UINT8*)pFrameInfo_p->pFrame);
+    }
+
+    if (ret != kErrorOk)
+        return ret;
+
+    return postFillTxEvent(priority_p);
 }
 
 #if defined(CONFIG_INCLUDE_NMT_MN)
@@ -673,3 +797,26 @@ static tOplkError HandleNotRxAsndFrame(tDllAsndNotRx* pAsndNotRx_p)
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Post fill TX event
+
+This function informs the DLL that a frame was added to the TX queue of the
+specified priority.
+
+\param  priority_p              Priority of the TX queue.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError postFillTxEvent(tDllAsyncReqPriority priority_p)
+{
+    tEvent      event;
+
+    event.eventSink = kEventSinkDllk;
+    event.eventType = kEventTypeDllkFillTx;
+    OPLK_MEMSET(&event.netTime, 0x00, sizeof(event.netTime));
+    event.pEventArg = &priority_p;
+    event.eventArgSize = sizeof(priority_p);
+    return eventu_postEvent(&event);
+}
@@ -48,6 +48,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <user/nmtu.h>
 #include <user/nmtmnu.h>
 #include <user/sdoseq.h>
+#include <user/sdocom.h>
 #include <user/dllucal.h>
 #include <user/ledu.h>
 #include <oplk/benchmark.h>
@@ -92,6 +93,7 @@ The user event instance holds the Api process callback function pointer.
 typedef struct
 {
     tProcessEventCb         pfnApiProcessEventCb;  ///< Callback for generic api events
+    tEventDispatchEntry*    apDispatchIndex[EVENT_SINK_COUNT];  ///< Dispatch table entries indexed by sink
 } tEventuInstance;
 
 //------------------------------------------------------------------------------
@@ -119,6 +121,9 @@ static tEventDispatchEntry eventDispatchTbl_l[] =
 #if defined (CONFIG_INCLUDE_SDOC) || defined(CONFIG_INCLUDE_SDOS)
     { kEventSinkSdoAsySeq,   kEventSourceSdoAsySeq,   sdoseq_processEvent },
 #endif
+#if defined(CONFIG_INCLUDE_SDOS) && (CONFIG_SDO_SERVER_ASYNC != FALSE)
+    { kEventSinkSdoCom,      kEventSourceSdoCom,      sdocom_processEvent },
+#endif
 #if defined (CONFIG_INCLUDE_LEDU)
     { kEventSinkLedu,        kEventSourceLedu,        ledu_processEvent },
 #else
@@ -156,6 +161,7 @@ tOplkError eventu_init(tProcessEventCb pfnApiProcessEventCb_p)
     tOplkError ret = kErrorOk;
 
     instance_l.pfnApiProcessEventCb = pfnApiProcessEventCb_p;
+    event_initDispatchIndex(eventDispatchTbl_l, instance_l.apDispatchIndex);
 
     ret = eventucal_init();
 
@@ -206,10 +212,10 @@ tOplkError eventu_process (tEvent* pEvent_p)
     tOplkError              ret = kErrorOk;
     tEventSource            eventSource;
     tProcessEventCb         pfnEventHandler;
-    tEventDispatchEntry*    pDispatchEntry;
 
-    pDispatchEntry = &eventDispatchTbl_l[0];
-    ret = event_getHandlerForSink(&pDispatchEntry, pEvent_p->eventSink,
+    BINTRACE2(kBinTraceIdEventuProcessBegin, pEvent_p->eventSink, pEvent_p->eventType);
+
+    ret = event_getHandlerForSink(instance_l.apDispatchIndex, pEvent_p->eventSink,
                                   &pfnEventHandler, &eventSource);
     if (ret == kErrorEventUnknownSink)
     {
@@ -221,7 +227,20 @@ tOplkError eventu_process (tEvent* pEvent_p)
     {
         if (pfnEventHandler != NULL)
         {
+#if (CONFIG_EVENTU_LOW_PRIORITY_THREAD != FALSE)
+            // API callbacks run application code which doesn't access the
+            // state shared between the event threads
+            if (pEvent_p->eventSink != kEventSinkApi)
+            {
+                eventucal_lockSharedState();
+                ret = pfnEventHandler(pEvent_p);
+                eventucal_unlockSharedState();
+            }
+            else
+                ret = pfnEventHandler(pEvent_p);
+#else
             ret = pfnEventHandler(pEvent_p);
+#endif
             if ((ret != kErrorOk) && (ret != kErrorShutdown))
             {
                 // forward error event to API layer
@@ -230,6 +249,8 @@ tOplkError eventu_process (tEvent* pEvent_p)
             }
         }
     }
+
+    BINTRACE2(kBinTraceIdEventuProcessEnd, pEvent_p->eventSink, ret);
     return ret;
 }
 
@@ -271,6 +292,7 @@ tOplkError eventu_postEvent(tEvent* pEvent_p)
         case kEventSinkNmtMnu:
         case kEventSinkNmtu:
         case kEventSinkSdoAsySeq:
+        case kEventSinkSdoCom:
         case kEventSinkApi:
         case kEventSinkDlluCal:
         case kEventSinkErru:
@@ -312,6 +334,8 @@ tOplkError eventu_postError(tEventSource eventSource_p,  tOplkError error_p,
 
     ret = kErrorOk;
 
+    BINTRACE2(kBinTraceIdEventuError, eventSource_p, error_p);
+
     // create argument
     eventError.eventSource = eventSource_p;
     eventError.oplkError = error_p;
@@ -55,6 +55,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <pthread.h>
 #include <semaphore.h>
 #include <linux/errno.h>
+#include <errno.h>
+#include <unistd.h>
+#include <limits.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 #include <common/target.h>
 
 //============================================================================//
@@ -64,7 +69,21 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
-#define USER_EVENT_THREAD_PRIORITY        45
+#ifndef CONFIG_THREAD_PRIORITY_EVENTU
+#define CONFIG_THREAD_PRIORITY_EVENTU       45
+#endif
+
+#ifndef CONFIG_THREAD_PRIORITY_EVENTU_LOW
+#define CONFIG_THREAD_PRIORITY_EVENTU_LOW   30
+#endif
+
+#if ((CONFIG_EVENTU_LOW_PRIORITY_THREAD != FALSE) && (CONFIG_EVENT_SIZE_CIRCBUF_USER_INTERNAL_LOW == 0))
+#error "CONFIG_EVENTU_LOW_PRIORITY_THREAD requires the low-priority lane (CONFIG_EVENT_SIZE_CIRCBUF_USER_INTERNAL_LOW)!"
+#endif
+
+#if ((CONFIG_EVENTU_CYCLE_SLICE != FALSE) && (CONFIG_EVENTU_LOW_PRIORITY_THREAD == FALSE))
+#error "CONFIG_EVENTU_CYCLE_SLICE requires the thread of the low-priority lane (CONFIG_EVENTU_LOW_PRIORITY_THREAD)!"
+#endif
 
 //------------------------------------------------------------------------------
 // module global vars
@@ -81,6 +100,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+// The semaphore is posted to stop the thread, so the timeout only limits the
+// time the thread sleeps while no events are posted.
+#define EVENTUCAL_THREAD_IDLE_TIMEOUT_MS  1000
 
 //------------------------------------------------------------------------------
 // local types
@@ -97,7 +119,19 @@ typedef struct
     BOOL                    fStopThread;
     sem_t*                  semUserData;
     sem_t*                  semKernelData;
+    int                     waitFd;                 ///< eventfd signaled after events were processed
     BOOL                    fInitialized;
+    tEventBatchStatistics   batchStatistics;
+#if (CONFIG_EVENTU_LOW_PRIORITY_THREAD != FALSE)
+    pthread_t               lowThreadId;            ///< Thread of the low-priority lane
+    BOOL                    fStopLowThread;
+    BOOL                    fLowThreadStarted;
+    sem_t                   semLowData;             ///< Signaled if events are posted to the low-priority lane
+    pthread_mutex_t         sharedStateLock;        ///< Serializes the sinks of both threads
+#endif
+#if (CONFIG_EVENTU_CYCLE_SLICE != FALSE)
+    sem_t                   semSlice;               ///< Signaled at the start of a cycle slice
+#endif
 } tEventuCalInstance;
 
 //------------------------------------------------------------------------------
@@ -109,8 +143,19 @@ static tEventuCalInstance       instance_l;             ///< Instance variable o
 // local function prototypes
 //------------------------------------------------------------------------------
 static void* eventThread(void* arg);
+static BOOL processEventBatch(tEventuCalInstance* pInstance_p);
 static void signalUserEvent(void);
 static void signalKernelEvent(void);
+static void signalWaitHandle(void);
+#if (CONFIG_EVENTU_LOW_PRIORITY_THREAD != FALSE)
+static tOplkError startLowThread(void);
+static void stopLowThread(void);
+static void* lowEventThread(void* arg);
+static void signalLowUserEvent(void);
+#endif
+#if (CONFIG_EVENTU_CYCLE_SLICE != FALSE)
+static void processCycleSlices(tEventuCalInstance* pInstance_p);
+#endif
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -132,9 +177,8 @@ CAL module.
 //------------------------------------------------------------------------------
 tOplkError eventucal_init(void)
 {
-    struct sched_param  schedParam;
-
     OPLK_MEMSET(&instance_l, 0, sizeof(tEventuCalInstance));
+    instance_l.waitFd = -1;
 
     if ((instance_l.semUserData = sem_open("/semUserEvent", O_RDWR)) == SEM_FAILED)
         goto Exit;
@@ -142,6 +186,9 @@ tOplkError eventucal_init(void)
     if ((instance_l.semKernelData = sem_open("/semKernelEvent", O_RDWR)) == SEM_FAILED)
         goto Exit;
 
+    if ((instance_l.waitFd = eventfd(0, EFD_NONBLOCK)) < 0)
+        goto Exit;
+
     if (eventucal_initQueueCircbuf(kEventQueueK2U) != kErrorOk)
         goto Exit;
 
@@ -155,21 +202,24 @@ tOplkError eventucal_init(void)
 
     eventucal_setSignalingCircbuf(kEventQueueUInt, signalUserEvent);
 
+#if (CONFIG_EVENTU_LOW_PRIORITY_THREAD != FALSE)
+    if (startLowThread() != kErrorOk)
+        goto Exit;
+#endif
+
     instance_l.fStopThread = FALSE;
-    if (pthread_create(&instance_l.threadId, NULL, eventThread, (void*)&instance_l) != 0)
+    if (target_createThread(&instance_l.threadId, kThreadRoleEventU, "oplk-eventu",
+                            eventThread, (void*)&instance_l) != kErrorOk)
         goto Exit;
 
-    schedParam.__sched_priority = USER_EVENT_THREAD_PRIORITY;
-    if (pthread_setschedparam(instance_l.threadId, SCHED_FIFO, &schedParam) != 0)
+    if (target_setThreadParams(instance_l.threadId, kThreadRoleEventU, kThreadSchedFifo,
+                               CONFIG_THREAD_PRIORITY_EVENTU,
+                               CONFIG_THREAD_CPU_MASK_EVENT) != kErrorOk)
     {
         DEBUG_LVL_ERROR_TRACE("%s(): couldn't set thread scheduling parameters! %d\n",
-                              __func__, schedParam.__sched_priority);
+                              __func__, CONFIG_THREAD_PRIORITY_EVENTU);
     }
 
-#if (defined(__GLIBC__) && __GLIBC__ >= 2 && __GLIBC_MINOR__ >= 12)
-    pthread_setname_np(instance_l.threadId, "oplk-eventu");
-#endif
-
     instance_l.fInitialized = TRUE;
     return kErrorOk;
 
@@ -180,6 +230,13 @@ Exit:
     if (instance_l.semKernelData != SEM_FAILED)
         sem_close(instance_l.semKernelData);
 
+    if (instance_l.waitFd >= 0)
+        close(instance_l.waitFd);
+
+#if (CONFIG_EVENTU_LOW_PRIORITY_THREAD != FALSE)
+    stopLowThread();
+#endif
+
     eventucal_exitQueueCircbuf(kEventQueueK2U);
     eventucal_exitQueueCircbuf(kEventQueueU2K);
     eventucal_exitQueueCircbuf(kEventQueueUInt);
@@ -208,6 +265,7 @@ tOplkError eventucal_exit(void)
     if (instance_l.fInitialized == TRUE)
     {
         instance_l.fStopThread = TRUE;
+        sem_post(instance_l.semUserData);
         while (instance_l.fStopThread == TRUE)
         {
             target_msleep(10);
@@ -218,12 +276,17 @@ tOplkError eventucal_exit(void)
             }
         }
 
+#if (CONFIG_EVENTU_LOW_PRIORITY_THREAD != FALSE)
+        stopLowThread();
+#endif
+
         eventucal_exitQueueCircbuf(kEventQueueK2U);
         eventucal_exitQueueCircbuf(kEventQueueU2K);
         eventucal_exitQueueCircbuf(kEventQueueUInt);
 
         sem_close(instance_l.semUserData);
         sem_close(instance_l.semKernelData);
+        close(instance_l.waitFd);
     }
     instance_l.fInitialized = FALSE;
 
@@ -302,17 +365,236 @@ void eventucal_process(void)
     // Nothing to do, because we use threads
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Wait for user events
+
+This function waits until the event thread processed events or the timeout
+elapsed. It resets the wait handle.
+
+\param  timeoutMs_p             Maximum time to wait in milliseconds.
+
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+void eventucal_waitEvent(UINT32 timeoutMs_p)
+{
+    struct pollfd   pollFd;
+    UINT64          value;
+
+    pollFd.fd = instance_l.waitFd;
+    pollFd.events = POLLIN;
+
+    if (poll(&pollFd, 1, (timeoutMs_p > INT_MAX) ? -1 : (int)timeoutMs_p) <= 0)
+        return;
+
+    if (read(instance_l.waitFd, &value, sizeof(value)) != sizeof(value))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s(): couldn't read wait handle!\n", __func__);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get wait handle
+
+This function returns the eventfd which is signaled after the event thread
+processed events.
+
+\return The function returns the file descriptor.
+
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+int eventucal_getWaitHandle(void)
+{
+    return instance_l.waitFd;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get batch statistics of event thread
+
+This function returns the statistics of the batched event processing of the
+event handler thread.
+
+\param  pStatistics_p           Pointer to store the statistics.
+
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+void eventucal_getBatchStatistics(tEventBatchStatistics* pStatistics_p)
+{
+    OPLK_MEMCPY(pStatistics_p, &instance_l.batchStatistics, sizeof(tEventBatchStatistics));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get event queue statistics
+
+This function returns the maximum used size of the kernel-to-user,
+user-to-kernel and user internal queues. The sizes are only recorded if the
+stack is compiled with DEBUG_CIRCBUF_SIZE_CHECK, otherwise they are 0.
+
+\param  pStatistics_p           Pointer to store the statistics.
+
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+void eventucal_getQueueStatistics(tEventQueueStatistics* pStatistics_p)
+{
+    OPLK_MEMSET(pStatistics_p, 0, sizeof(tEventQueueStatistics));
+
+#ifdef DEBUG_CIRCBUF_SIZE_CHECK
+    pStatistics_p->aMaxSize[kEventQueueK2U] = eventucal_getMaxSizeCircbuf(kEventQueueK2U);
+    pStatistics_p->aMaxSize[kEventQueueU2K] = eventucal_getMaxSizeCircbuf(kEventQueueU2K);
+    pStatistics_p->aMaxSize[kEventQueueUInt] = eventucal_getMaxSizeCircbuf(kEventQueueUInt);
+#endif
+}
+
+#if (CONFIG_EVENTU_LOW_PRIORITY_THREAD != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Lock the state shared by the event threads
+
+This function locks the state of the user modules which is shared between the
+event thread and the thread of the low-priority lane. The lock is recursive
+and uses priority inheritance, so a low-priority thread holding it is raised
+to the priority of the event thread while the event thread waits for it.
+
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+void eventucal_lockSharedState(void)
+{
+    pthread_mutex_lock(&instance_l.sharedStateLock);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Unlock the state shared by the event threads
+
+This function unlocks the state locked by eventucal_lockSharedState().
+
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+void eventucal_unlockSharedState(void)
+{
+    pthread_mutex_unlock(&instance_l.sharedStateLock);
+}
+#endif
+
+#if (CONFIG_EVENTU_CYCLE_SLICE != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Start a cycle slice
+
+This function starts the slice of the cycle in which the thread of the
+low-priority lane processes its events. It is called after the application
+exchanged the input process image, i.e. after the sync work of the cycle is
+completed.
+
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+void eventucal_startCycleSlice(void)
+{
+    int     semValue;
+
+    if (!instance_l.fLowThreadStarted)
+        return;
+
+    // A slice which is not taken yet is replaced by this one
+    if ((sem_getvalue(&instance_l.semSlice, &semValue) == 0) && (semValue > 0))
+        return;
+
+    sem_post(&instance_l.semSlice);
+}
+#endif
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
 /// \name Private Functions
 /// \{
 
+//------------------------------------------------------------------------------
+/**
+\brief  Process a batch of events
+
+This function processes the events of the queues handled by the event thread
+until the queues are empty or the event or time budget of the batch
+(CONFIG_EVENT_BATCH_MAX_EVENTS, CONFIG_EVENT_BATCH_TIME_BUDGET_US) is exceeded.
+The batch statistics are updated accordingly.
+
+\param  pInstance_p             Pointer to the instance.
+
+\return The function returns TRUE if the batch was stopped by the budget and
+        events could be left in the queues.
+*/
+//------------------------------------------------------------------------------
+static BOOL processEventBatch(tEventuCalInstance* pInstance_p)
+{
+    struct timespec         startTime, curTime;
+    tEventBatchStatistics*  pStatistics = &pInstance_p->batchStatistics;
+    UINT32                  eventCount = 0;
+    UINT32                  batchTime = 0;
+    BOOL                    fBudgetExceeded = FALSE;
+
+    clock_gettime(CLOCK_MONOTONIC, &startTime);
+
+    for (;;)
+    {
+        /* first handle all kernel to user events --> higher priority! */
+        if (eventucal_getEventCountCircbuf(kEventQueueK2U) > 0)
+            eventucal_processEventCircbuf(kEventQueueK2U);
+        else if (eventucal_getEventCountCircbuf(kEventQueueUInt) > 0)
+            eventucal_processEventCircbuf(kEventQueueUInt);
+        else
+            break;
+
+        eventCount++;
+
+        clock_gettime(CLOCK_MONOTONIC, &curTime);
+        batchTime = (UINT32)((curTime.tv_sec - startTime.tv_sec) * 1000000000L +
+                             (curTime.tv_nsec - startTime.tv_nsec));
+
+        if (((CONFIG_EVENT_BATCH_MAX_EVENTS != 0) &&
+             (eventCount >= CONFIG_EVENT_BATCH_MAX_EVENTS)) ||
+            ((CONFIG_EVENT_BATCH_TIME_BUDGET_US != 0) &&
+             (batchTime >= CONFIG_EVENT_BATCH_TIME_BUDGET_US * 1000UL)))
+        {
+            fBudgetExceeded = TRUE;
+            break;
+        }
+    }
+
+    if (eventCount > 0)
+    {
+        pStatistics->batchCount++;
+        pStatistics->eventCount += eventCount;
+        pStatistics->lastBatchSize = eventCount;
+        if (eventCount > pStatistics->maxBatchSize)
+            pStatistics->maxBatchSize = eventCount;
+        if (fBudgetExceeded)
+            pStatistics->budgetExceededCount++;
+        pStatistics->lastBatchTime = batchTime;
+        if (batchTime > pStatistics->maxBatchTime)
+            pStatistics->maxBatchTime = batchTime;
+        pStatistics->totalBatchTime += batchTime;
+    }
+
+    return fBudgetExceeded;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Event handler thread function
 
-This function contains the main function for the event handler thread.
+This function contains the main function for the event handler thread. The
+thread is woken up when the queues change from empty to non-empty and then
+processes the events in batches.
 
 \param  arg                     Thread parameter. Not used!
 
@@ -323,29 +605,24 @@ static void* eventThread(void* arg)
 {
     struct timespec         curTime, timeout;
     tEventuCalInstance*     pInstance = (tEventuCalInstance*)arg;
+    BOOL                    fPending = FALSE;
 
     while (!pInstance->fStopThread)
     {
-        clock_gettime(CLOCK_REALTIME, &curTime);
-        timeout.tv_sec = 0;
-        timeout.tv_nsec = 50000 * 1000;
-        TIMESPECADD(&timeout, &curTime);
-
-        if (sem_timedwait(pInstance->semUserData, &timeout) == 0)
+        // Don't wait if the last batch was stopped with events left in the queues
+        if (!fPending)
         {
-            /* first handle all user to kernel events --> higher priority! */
-            if (eventucal_getEventCountCircbuf(kEventQueueK2U) > 0)
-            {
-                eventucal_processEventCircbuf(kEventQueueK2U);
-            }
-            else
-            {
-                if (eventucal_getEventCountCircbuf(kEventQueueUInt) > 0)
-                {
-                    eventucal_processEventCircbuf(kEventQueueUInt);
-                }
-            }
+            clock_gettime(CLOCK_REALTIME, &curTime);
+            timeout.tv_sec = EVENTUCAL_THREAD_IDLE_TIMEOUT_MS / 1000;
+            timeout.tv_nsec = (EVENTUCAL_THREAD_IDLE_TIMEOUT_MS % 1000) * 1000000;
+            TIMESPECADD(&timeout, &curTime);
+
+            if (sem_timedwait(pInstance->semUserData, &timeout) != 0)
+                continue;
         }
+
+        fPending = processEventBatch(pInstance);
+        signalWaitHandle();
     }
     pInstance->fStopThread = FALSE;
 
@@ -362,6 +639,12 @@ in the circular buffer library as signal callback function.
 //------------------------------------------------------------------------------
 void signalUserEvent(void)
 {
+    int     semValue;
+
+    // The event thread drains the queue, so a pending wakeup is sufficient
+    if ((sem_getvalue(instance_l.semUserData, &semValue) == 0) && (semValue > 0))
+        return;
+
     sem_post(instance_l.semUserData);
 }
 
@@ -375,8 +658,257 @@ in the circular buffer library as signal callback function.
 //------------------------------------------------------------------------------
 void signalKernelEvent(void)
 {
+    int     semValue;
+
+    // The event thread drains the queue, so a pending wakeup is sufficient
+    if ((sem_getvalue(instance_l.semKernelData, &semValue) == 0) && (semValue > 0))
+        return;
+
     sem_post(instance_l.semKernelData);
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Signal the wait handle
+
+This function signals the wait handle after the event thread processed events.
+*/
+//------------------------------------------------------------------------------
+static void signalWaitHandle(void)
+{
+    UINT64          value = 1;
+
+    if (write(instance_l.waitFd, &value, sizeof(value)) != sizeof(value))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s(): couldn't signal wait handle!\n", __func__);
+    }
+}
+
+#if (CONFIG_EVENTU_LOW_PRIORITY_THREAD != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Start the thread of the low-priority lane
+
+This function detaches the low-priority lane of the user internal queue from
+the event thread and starts a separate thread for it. Besides the shared state
+lock is initialized.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError startLowThread(void)
+{
+    pthread_mutexattr_t     mutexAttr;
+
+    if (pthread_mutexattr_init(&mutexAttr) != 0)
+        return kErrorNoResource;
+
+    pthread_mutexattr_settype(&mutexAttr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutexattr_setprotocol(&mutexAttr, PTHREAD_PRIO_INHERIT);
+    if (pthread_mutex_init(&instance_l.sharedStateLock, &mutexAttr) != 0)
+    {
+        pthread_mutexattr_destroy(&mutexAttr);
+        return kErrorNoResource;
+    }
+    pthread_mutexattr_destroy(&mutexAttr);
+
+    if (sem_init(&instance_l.semLowData, 0, 0) != 0)
+    {
+        pthread_mutex_destroy(&instance_l.sharedStateLock);
+        return kErrorNoResource;
+    }
+
+#if (CONFIG_EVENTU_CYCLE_SLICE != FALSE)
+    if (sem_init(&instance_l.semSlice, 0, 0) != 0)
+    {
+        sem_destroy(&instance_l.semLowData);
+        pthread_mutex_destroy(&instance_l.sharedStateLock);
+        return kErrorNoResource;
+    }
+#endif
+
+    if (eventucal_setLowLaneSignalingCircbuf(kEventQueueUInt, signalLowUserEvent) != kErrorOk)
+        goto Exit;
+
+    instance_l.fStopLowThread = FALSE;
+    if (target_createThread(&instance_l.lowThreadId, kThreadRoleEventULow, "oplk-eventu-low",
+                            lowEventThread, (void*)&instance_l) != kErrorOk)
+        goto Exit;
+
+    if (target_setThreadParams(instance_l.lowThreadId, kThreadRoleEventULow, kThreadSchedFifo,
+                               CONFIG_THREAD_PRIORITY_EVENTU_LOW,
+                               CONFIG_THREAD_CPU_MASK_EVENT) != kErrorOk)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s(): couldn't set thread scheduling parameters! %d\n",
+                              __func__, CONFIG_THREAD_PRIORITY_EVENTU_LOW);
+    }
+
+    instance_l.fLowThreadStarted = TRUE;
+    return kErrorOk;
+
+Exit:
+#if (CONFIG_EVENTU_CYCLE_SLICE != FALSE)
+    sem_destroy(&instance_l.semSlice);
+#endif
+    sem_destroy(&instance_l.semLowData);
+    pthread_mutex_destroy(&instance_l.sharedStateLock);
+    return kErrorNoResource;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Stop the thread of the low-priority lane
+
+This function stops the thread of the low-priority lane and cleans up the
+semaphore and the shared state lock.
+*/
+//------------------------------------------------------------------------------
+static void stopLowThread(void)
+{
+    UINT            i = 0;
+
+    if (!instance_l.fLowThreadStarted)
+        return;
+
+    instance_l.fStopLowThread = TRUE;
+    sem_post(&instance_l.semLowData);
+    while (instance_l.fStopLowThread == TRUE)
+    {
+        target_msleep(10);
+        if (i++ > 100)
+        {
+            TRACE("Low-priority event thread is not terminating, continue shutdown...!\n");
+            break;
+        }
+    }
+
+#if (CONFIG_EVENTU_CYCLE_SLICE != FALSE)
+    sem_destroy(&instance_l.semSlice);
+#endif
+    sem_destroy(&instance_l.semLowData);
+    pthread_mutex_destroy(&instance_l.sharedStateLock);
+    instance_l.fLowThreadStarted = FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Event thread function of the low-priority lane
+
+This function contains the main function for the thread of the low-priority
+lane. The thread processes the SDO, error, LED and API events of the user
+internal queue, so they can't delay the kernel-to-user and NMT events handled
+by the event thread. If CONFIG_EVENTU_CYCLE_SLICE is enabled, the events are
+processed in cycle slices, see processCycleSlices().
+
+\param  arg                     Thread parameter. Not used!
+
+\return The function returns the thread exit code.
+*/
+//------------------------------------------------------------------------------
+static void* lowEventThread(void* arg)
+{
+    struct timespec         curTime, timeout;
+    tEventuCalInstance*     pInstance = (tEventuCalInstance*)arg;
+
+    while (!pInstance->fStopLowThread)
+    {
+        clock_gettime(CLOCK_REALTIME, &curTime);
+        timeout.tv_sec = EVENTUCAL_THREAD_IDLE_TIMEOUT_MS / 1000;
+        timeout.tv_nsec = (EVENTUCAL_THREAD_IDLE_TIMEOUT_MS % 1000) * 1000000;
+        TIMESPECADD(&timeout, &curTime);
+
+        if (sem_timedwait(&pInstance->semLowData, &timeout) != 0)
+            continue;
+
+#if (CONFIG_EVENTU_CYCLE_SLICE != FALSE)
+        processCycleSlices(pInstance);
+#else
+        while (!pInstance->fStopLowThread &&
+               (eventucal_getLowLaneEventCountCircbuf(kEventQueueUInt) > 0))
+            eventucal_processLowLaneEventCircbuf(kEventQueueUInt);
+#endif
+
+        signalWaitHandle();
+    }
+    pInstance->fStopLowThread = FALSE;
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Signal a low-priority user event
+
+This function signals that an event has been posted to the low-priority lane.
+It will be registered in the circular buffer library as signal callback
+function of the lane.
+*/
+//------------------------------------------------------------------------------
+static void signalLowUserEvent(void)
+{
+    int     semValue;
+
+    // The thread drains the lane, so a pending wakeup is sufficient
+    if ((sem_getvalue(&instance_l.semLowData, &semValue) == 0) && (semValue > 0))
+        return;
+
+    sem_post(&instance_l.semLowData);
+}
+#endif
+
+#if (CONFIG_EVENTU_CYCLE_SLICE != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Process the low-priority lane in cycle slices
+
+This function processes the events of the low-priority lane until the lane is
+empty. The events are only processed in a cycle slice, which is started by
+eventucal_startCycleSlice() after the sync work of a cycle is completed. In
+every slice events are processed until CONFIG_EVENTU_CYCLE_SLICE_BUDGET_US is
+used up, the remaining events wait for the next slice. Every event is one unit
+of work, so a single event can exceed the budget.
+
+Slices which were started before the thread waits for them are dropped,
+because their cycle may already be over. If no slice is started within
+CONFIG_EVENTU_CYCLE_SLICE_IDLE_MS, e.g. before the process images are
+exchanged, the thread processes one budget of events anyway.
+
+\param  pInstance_p             Pointer to the instance.
+*/
+//------------------------------------------------------------------------------
+static void processCycleSlices(tEventuCalInstance* pInstance_p)
+{
+    struct timespec     startTime, curTime, timeout;
+    UINT32              sliceTime;
+
+    while (!pInstance_p->fStopLowThread &&
+           (eventucal_getLowLaneEventCountCircbuf(kEventQueueUInt) > 0))
+    {
+        while (sem_trywait(&pInstance_p->semSlice) == 0)
+            ;
+
+        clock_gettime(CLOCK_REALTIME, &curTime);
+        timeout.tv_sec = CONFIG_EVENTU_CYCLE_SLICE_IDLE_MS / 1000;
+        timeout.tv_nsec = (CONFIG_EVENTU_CYCLE_SLICE_IDLE_MS % 1000) * 1000000;
+        TIMESPECADD(&timeout, &curTime);
+
+        while ((sem_timedwait(&pInstance_p->semSlice, &timeout) != 0) && (errno == EINTR))
+            ;
+
+        clock_gettime(CLOCK_MONOTONIC, &startTime);
+        do
+        {
+            eventucal_processLowLaneEventCircbuf(kEventQueueUInt);
+
+            clock_gettime(CLOCK_MONOTONIC, &curTime);
+            sliceTime = (UINT32)((curTime.tv_sec - startTime.tv_sec) * 1000000000L +
+                                 (curTime.tv_nsec - startTime.tv_nsec));
+        } while (!pInstance_p->fStopLowThread &&
+                 (eventucal_getLowLaneEventCountCircbuf(kEventQueueUInt) > 0) &&
+                 (sliceTime < CONFIG_EVENTU_CYCLE_SLICE_BUDGET_US * 1000UL));
+    }
+}
+#endif
+
 /// \}
 
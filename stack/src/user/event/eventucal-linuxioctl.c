@@ -9,8 +9,11 @@ This user event CAL module implementation uses ioctl calls on Linux.
 \brief  User event CAL module for Linux user/kernelspace
 
 This file implements the user event handler CAL module for the Linux
-userspace platform. It uses the ioctl() calls to communicate with a kernel
-CAL module running in Linux kernelspace.
+userspace platform. The K2U and U2K queues of the kernel CAL module running in
+Linux kernelspace are mapped into the process with mmap(). Events are
+exchanged through these lock-free circular buffers, a poll() wakeup or a
+PLK_CMD_SIGNAL_EVENT ioctl() is only needed if a queue changes from empty to
+non-empty. User-internal events are handled by a local circular buffer.
 
 \ingroup module_eventucal
 *******************************************************************************/
@@ -48,15 +51,23 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 #include <oplk/debugstr.h>
 #include <user/eventucal.h>
+#include <user/eventucalintf.h>
+#include <user/eventu.h>
 #include <common/target.h>
+#include <common/circbuffer.h>
 
 #include <pthread.h>
 
 #include <oplk/powerlink-module.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <limits.h>
 
 #include <unistd.h> //sleep
 #include <user/ctrlucal.h>
+#include <common/dllcal.h>
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -66,7 +77,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // const defines
 //------------------------------------------------------------------------------
 
-#define USER_EVENT_THREAD_PRIORITY      20
+#ifndef CONFIG_THREAD_PRIORITY_EVENTU
+#define CONFIG_THREAD_PRIORITY_EVENTU   20
+#endif
 
 //------------------------------------------------------------------------------
 // module global vars
@@ -83,11 +96,27 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#define EVENT_THREAD_POLL_TIMEOUT   500     ///< Poll timeout of event thread in ms
 
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
 
+/**
+\brief Mapped kernel event queue
+
+The structure describes an event queue of the kernel CAL module which is
+mapped into the user library. The circular buffer instance uses the mapped
+memory directly, it is always used in lock-free mode and needs no architecture
+specific part.
+*/
+typedef struct
+{
+    tCircBufInstance    circBuf;            ///< Circular buffer instance of the queue
+    BYTE*               pMem;               ///< Start of the mapped memory
+    size_t              memSize;            ///< Size of the mapped memory
+} tEventuCalQueue;
+
 /**
 \brief User event CAL instance type
 
@@ -97,8 +126,14 @@ CAL module.
 typedef struct
 {
     int                 fd;
+    int                 eventFd;            ///< eventfd used to signal user-internal events
+    int                 waitFd;             ///< eventfd signaled after events were processed
     pthread_t           threadId;
     BOOL                fStopThread;
+    tEventuCalQueue     k2uQueue;           ///< Mapped kernel-to-user queue
+    tEventuCalQueue     u2kQueue;           ///< Mapped user-to-kernel queue
+    pthread_mutex_t     u2kMutex;           ///< Serializes the producers of the U2K queue
+    BYTE                aRxBuffer[sizeof(tEvent) + MAX_EVENT_ARG_SIZE];
 } tEventuCalInstance;
 
 //------------------------------------------------------------------------------
@@ -110,7 +145,11 @@ static tEventuCalInstance    instance_l;
 // local function prototypes
 //------------------------------------------------------------------------------
 static void* eventThread(void* arg_p);
-static tOplkError postEvent(tEvent* pEvent_p);
+static tOplkError mapQueue(tEventuCalQueue* pQueue_p, UINT8 bufferId_p, off_t pageOffset_p);
+static void unmapQueue(tEventuCalQueue* pQueue_p);
+static void processKernelEvents(void);
+static void signalUserEvent(void);
+static void signalWaitHandle(void);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -133,32 +172,66 @@ implementations and calls the appropriate init functions.
 //------------------------------------------------------------------------------
 tOplkError eventucal_init(void)
 {
-    tOplkError          ret = kErrorOk;
-    struct sched_param  schedParam;
-
     OPLK_MEMSET(&instance_l, 0, sizeof(tEventuCalInstance));
 
     instance_l.fd = ctrlucal_getFd();
     instance_l.fStopThread = FALSE;
+    pthread_mutex_init(&instance_l.u2kMutex, NULL);
+
+    instance_l.waitFd = -1;
+
+    if ((instance_l.eventFd = eventfd(0, 0)) < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s(): couldn't create eventfd!\n", __func__);
+        goto Exit;
+    }
+
+    if ((instance_l.waitFd = eventfd(0, EFD_NONBLOCK)) < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s(): couldn't create wait handle!\n", __func__);
+        goto Exit;
+    }
+
+    if (mapQueue(&instance_l.k2uQueue, CIRCBUF_KERNEL_TO_USER_QUEUE,
+                 PLK_MMAP_PGOFF_EVENT_K2U) != kErrorOk)
+        goto Exit;
+
+    if (mapQueue(&instance_l.u2kQueue, CIRCBUF_USER_TO_KERNEL_QUEUE,
+                 PLK_MMAP_PGOFF_EVENT_U2K) != kErrorOk)
+        goto Exit;
+
+    if (eventucal_initQueueCircbuf(kEventQueueUInt) != kErrorOk)
+        goto Exit;
+
+    eventucal_setSignalingCircbuf(kEventQueueUInt, signalUserEvent);
 
     //create thread for signaling new data
-    if (pthread_create(&instance_l.threadId, NULL, eventThread, NULL) != 0)
+    if (target_createThread(&instance_l.threadId, kThreadRoleEventU, "oplk-eventu",
+                            eventThread, NULL) != kErrorOk)
     {
         goto Exit;
     }
-    schedParam.__sched_priority = USER_EVENT_THREAD_PRIORITY;
-    if (pthread_setschedparam(instance_l.threadId, SCHED_FIFO, &schedParam) != 0)
+    if (target_setThreadParams(instance_l.threadId, kThreadRoleEventU, kThreadSchedFifo,
+                               CONFIG_THREAD_PRIORITY_EVENTU,
+                               CONFIG_THREAD_CPU_MASK_EVENT) != kErrorOk)
     {
         DEBUG_LVL_ERROR_TRACE("%s(): couldn't set thread scheduling parameters! %d\n",
-                              __func__, schedParam.__sched_priority);
+                              __func__, CONFIG_THREAD_PRIORITY_EVENTU);
     }
 
-#if (defined(__GLIBC__) && __GLIBC__ >= 2 && __GLIBC_MINOR__ >= 12)
-    pthread_setname_np(instance_l.threadId, "oplk-eventu");
-#endif
+    return kErrorOk;
 
 Exit:
-    return ret;
+    eventucal_exitQueueCircbuf(kEventQueueUInt);
+    unmapQueue(&instance_l.u2kQueue);
+    unmapQueue(&instance_l.k2uQueue);
+    if (instance_l.eventFd >= 0)
+        close(instance_l.eventFd);
+    if (instance_l.waitFd >= 0)
+        close(instance_l.waitFd);
+    pthread_mutex_destroy(&instance_l.u2kMutex);
+
+    return kErrorNoResource;
 }
 
 //------------------------------------------------------------------------------
@@ -178,8 +251,14 @@ functions of the queue implementations for each used queue.
 tOplkError eventucal_exit(void)
 {
     UINT            i = 0;
+    UINT64          value = 1;
 
     instance_l.fStopThread = TRUE;
+    if (write(instance_l.eventFd, &value, sizeof(value)) != sizeof(value))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s(): couldn't wake up event thread!\n", __func__);
+    }
+
     while (instance_l.fStopThread == TRUE)
     {
         target_msleep(10);
@@ -190,6 +269,13 @@ tOplkError eventucal_exit(void)
         }
     }
 
+    eventucal_exitQueueCircbuf(kEventQueueUInt);
+    unmapQueue(&instance_l.u2kQueue);
+    unmapQueue(&instance_l.k2uQueue);
+    close(instance_l.eventFd);
+    close(instance_l.waitFd);
+    pthread_mutex_destroy(&instance_l.u2kMutex);
+
     return kErrorOk;
 }
 
@@ -212,7 +298,7 @@ queue post function is called.
 //------------------------------------------------------------------------------
 tOplkError eventucal_postUserEvent(tEvent* pEvent_p)
 {
-    return postEvent(pEvent_p);
+    return eventucal_postEventCircbuf(kEventQueueUInt, pEvent_p);
 }
 
 //------------------------------------------------------------------------------
@@ -220,8 +306,9 @@ tOplkError eventucal_postUserEvent(tEvent* pEvent_p)
 \brief    Post kernel event
 
 This function posts an event to a queue. It is called from the generic user
-event post function in the event handler. Depending on the sink the appropriate
-queue post function is called.
+event post function in the event handler. The event is written directly into
+the mapped U2K queue. The kernel event thread is only signaled if the queue
+was empty before.
 
 \param  pEvent_p                Event to be posted.
 
@@ -234,7 +321,42 @@ queue post function is called.
 //------------------------------------------------------------------------------
 tOplkError eventucal_postKernelEvent(tEvent* pEvent_p)
 {
-    return postEvent(pEvent_p);
+    tOplkError          ret = kErrorOk;
+    tCircBufError       circError;
+    BYTE*               pData;
+    BOOL                fSignal;
+
+    /*TRACE("%s() Event type:%s(%d) sink:%s(%d) size:%d!\n", __func__,
+           debugstr_getEventTypeStr(pEvent_p->eventType), pEvent_p->eventType,
+           debugstr_getEventSinkStr(pEvent_p->eventSink), pEvent_p->eventSink,
+           pEvent_p->eventArgSize);*/
+
+    pthread_mutex_lock(&instance_l.u2kMutex);
+
+    circError = circbuf_reserve(&instance_l.u2kQueue.circBuf,
+                                sizeof(tEvent) + pEvent_p->eventArgSize, (void**)&pData);
+    if (circError != kCircBufOk)
+    {
+        pthread_mutex_unlock(&instance_l.u2kMutex);
+        return kErrorEventPostError;
+    }
+
+    OPLK_MEMCPY(pData, pEvent_p, sizeof(tEvent));
+    if (pEvent_p->eventArgSize != 0)
+        OPLK_MEMCPY(pData + sizeof(tEvent), pEvent_p->pEventArg, pEvent_p->eventArgSize);
+
+    if (circbuf_commit(&instance_l.u2kQueue.circBuf, pData) != kCircBufOk)
+        ret = kErrorEventPostError;
+
+    // If the kernel consumed all previous events, it could be sleeping
+    fSignal = (circbuf_getDataCount(&instance_l.u2kQueue.circBuf) == 1);
+
+    pthread_mutex_unlock(&instance_l.u2kMutex);
+
+    if (fSignal && (ioctl(instance_l.fd, PLK_CMD_SIGNAL_EVENT) != 0))
+        ret = kErrorNoResource;
+
+    return ret;
 }
 
 //------------------------------------------------------------------------------
@@ -251,46 +373,206 @@ void eventucal_process(void)
     // Nothing to do, because we use threads
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Wait for user events
+
+This function waits until the event thread processed events or the timeout
+elapsed. It resets the wait handle.
+
+\param  timeoutMs_p             Maximum time to wait in milliseconds.
+
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+void eventucal_waitEvent(UINT32 timeoutMs_p)
+{
+    struct pollfd   pollFd;
+    UINT64          value;
+
+    pollFd.fd = instance_l.waitFd;
+    pollFd.events = POLLIN;
+
+    if (poll(&pollFd, 1, (timeoutMs_p > INT_MAX) ? -1 : (int)timeoutMs_p) <= 0)
+        return;
+
+    if (read(instance_l.waitFd, &value, sizeof(value)) != sizeof(value))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s(): couldn't read wait handle!\n", __func__);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get wait handle
+
+This function returns the eventfd which is signaled after the event thread
+processed events.
+
+\return The function returns the file descriptor.
+
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+int eventucal_getWaitHandle(void)
+{
+    return instance_l.waitFd;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get event queue statistics
+
+This function returns the maximum used size of the user internal queue. The
+kernel-to-user and user-to-kernel queues are mapped from the kernel module and
+are reported with size 0. The size is only recorded if the stack is compiled
+with DEBUG_CIRCBUF_SIZE_CHECK.
+
+\param  pStatistics_p           Pointer to store the statistics.
+
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+void eventucal_getQueueStatistics(tEventQueueStatistics* pStatistics_p)
+{
+    OPLK_MEMSET(pStatistics_p, 0, sizeof(tEventQueueStatistics));
+
+#ifdef DEBUG_CIRCBUF_SIZE_CHECK
+    pStatistics_p->aMaxSize[kEventQueueUInt] = eventucal_getMaxSizeCircbuf(kEventQueueUInt);
+#endif
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
 
 //------------------------------------------------------------------------------
 /**
-\brief    Post event
+\brief    Map a kernel event queue
 
-This function posts an event to a queue. It is called from the generic user
-event post function in the event handler. Depending on the sink the appropriate
-queue post function is called.
+This function maps an event queue of the kernel CAL module. The queue memory
+starts with the circular buffer header, the buffer follows at the next page
+boundary. The header page is mapped first to get the buffer size.
 
-\param  pEvent_p                Event to be posted.
+\param  pQueue_p                Pointer to the queue to map.
+\param  bufferId_p              Circular buffer ID of the queue.
+\param  pageOffset_p            Page offset which selects the queue in the driver.
 
 \return The function returns a tOplkError error code.
-\retval kErrorOk                Function executes correctly
-\retval other error codes       An error occurred
 */
 //------------------------------------------------------------------------------
-static tOplkError postEvent(tEvent* pEvent_p)
+static tOplkError mapQueue(tEventuCalQueue* pQueue_p, UINT8 bufferId_p, off_t pageOffset_p)
 {
-    int             ioctlret;
+    size_t              pageSize = (size_t)sysconf(_SC_PAGE_SIZE);
+    size_t              headerSize;
+    tCircBufHeader*     pHeader;
+    size_t              bufferSize;
 
-    /*TRACE("%s() Event type:%s(%d) sink:%s(%d) size:%d!\n", __func__,
-           debugstr_getEventTypeStr(pEvent_p->eventType), pEvent_p->eventType,
-           debugstr_getEventSinkStr(pEvent_p->eventSink), pEvent_p->eventSink,
-           pEvent_p->eventArgSize);*/
+    headerSize = (sizeof(tCircBufHeader) + pageSize - 1) & ~(pageSize - 1);
 
-    ioctlret = ioctl(instance_l.fd, PLK_CMD_POST_EVENT, pEvent_p);
-    if (ioctlret != 0)
+    pHeader = mmap(NULL, headerSize, PROT_READ, MAP_SHARED, instance_l.fd,
+                   pageOffset_p * pageSize);
+    if (pHeader == MAP_FAILED)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() mmap of queue %d header failed!\n", __func__, bufferId_p);
         return kErrorNoResource;
+    }
+    bufferSize = pHeader->bufferSize;
+    munmap(pHeader, headerSize);
+
+    pQueue_p->memSize = headerSize + bufferSize;
+    pQueue_p->pMem = mmap(NULL, pQueue_p->memSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                          instance_l.fd, pageOffset_p * pageSize);
+    if (pQueue_p->pMem == MAP_FAILED)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() mmap of queue %d failed!\n", __func__, bufferId_p);
+        pQueue_p->pMem = NULL;
+        return kErrorNoResource;
+    }
+
+    OPLK_MEMSET(&pQueue_p->circBuf, 0, sizeof(tCircBufInstance));
+    pQueue_p->circBuf.pCircBufHeader = (tCircBufHeader*)pQueue_p->pMem;
+    pQueue_p->circBuf.pCircBuf = pQueue_p->pMem + headerSize;
+    pQueue_p->circBuf.bufferId = bufferId_p;
+    pQueue_p->circBuf.fLockFree = TRUE;
 
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief    Unmap a kernel event queue
+
+\param  pQueue_p                Pointer to the queue to unmap.
+*/
+//------------------------------------------------------------------------------
+static void unmapQueue(tEventuCalQueue* pQueue_p)
+{
+    if (pQueue_p->pMem == NULL)
+        return;
+
+    munmap(pQueue_p->pMem, pQueue_p->memSize);
+    pQueue_p->pMem = NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Process events of the K2U queue
+
+This function processes all events in the mapped K2U queue. The events are
+processed in the queue and released afterwards. Only events which wrap around
+the end of the buffer are copied.
+*/
+//------------------------------------------------------------------------------
+static void processKernelEvents(void)
+{
+    tCircBufInstance*   pCircBuf = &instance_l.k2uQueue.circBuf;
+    tEvent*             pEvent;
+    tCircBufError       error;
+    size_t              readSize;
+    BOOL                fInPlace;
+
+    while (circbuf_getDataCount(pCircBuf) > 0)
+    {
+        fInPlace = TRUE;
+        error = circbuf_peek(pCircBuf, (void**)&pEvent, &readSize);
+        if (error == kCircBufDataNotContiguous)
+        {   // Event wraps around the end of the buffer and must be copied
+            fInPlace = FALSE;
+            pEvent = (tEvent*)instance_l.aRxBuffer;
+            error = circbuf_readData(pCircBuf, instance_l.aRxBuffer,
+                                     sizeof(instance_l.aRxBuffer), &readSize);
+        }
+        if (error != kCircBufOk)
+        {
+            eventu_postError(kEventSourceEventu, kErrorEventReadError,
+                             sizeof(tCircBufError), &error);
+            return;
+        }
+
+        /*TRACE ("%s() User: got event type:%d(%s) sink:%d(%s)\n", __func__,
+                pEvent->eventType, debugstr_getEventTypeStr(pEvent->eventType),
+                pEvent->eventSink, debugstr_getEventSinkStr(pEvent->eventSink));*/
+        pEvent->eventArgSize = (UINT)(readSize - sizeof(tEvent));
+        if (pEvent->eventArgSize > 0)
+            pEvent->pEventArg = (BYTE*)pEvent + sizeof(tEvent);
+        else
+            pEvent->pEventArg = NULL;
+
+        eventu_process(pEvent);
+
+        if (fInPlace)
+            circbuf_release(pCircBuf);
+    }
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief    Event thread function
 
-This function implements the event thread.
+This function implements the event thread. It waits until the driver signals
+events in the K2U queue or a user-internal event is posted and processes all
+pending events afterwards.
 
 \param  arg_p                Thread argument.
 
@@ -298,32 +580,83 @@ This function implements the event thread.
 //------------------------------------------------------------------------------
 static void* eventThread(void* arg_p)
 {
-    tEvent*     pEvent;
-    int         ret;
-    char        eventBuf[sizeof(tEvent) + MAX_EVENT_ARG_SIZE];
+    struct pollfd   aPollFd[2];
+    UINT64          value;
 
     UNUSED_PARAMETER(arg_p);
 
-    pEvent = (tEvent*)eventBuf;
+    aPollFd[0].fd = instance_l.fd;
+    aPollFd[0].events = POLLIN;
+    aPollFd[1].fd = instance_l.eventFd;
+    aPollFd[1].events = POLLIN;
 
     while (!instance_l.fStopThread)
     {
-        ret = ioctl(instance_l.fd, PLK_CMD_GET_EVENT, eventBuf);
-        if (ret == 0)
-        {
-            /*TRACE ("%s() User: got event type:%d(%s) sink:%d(%s)\n", __func__,
-                    pEvent->eventType, debugstr_getEventTypeStr(pEvent->eventType),
-                    pEvent->eventSink, debugstr_getEventSinkStr(pEvent->eventSink));*/
-            if (pEvent->eventArgSize != 0)
-                pEvent->pEventArg = (char*)pEvent + sizeof(tEvent);
+        if (poll(aPollFd, 2, EVENT_THREAD_POLL_TIMEOUT) <= 0)
+            continue;
 
-            ret = eventu_process(pEvent);
+        if ((aPollFd[1].revents & POLLIN) != 0)
+        {
+            if (read(instance_l.eventFd, &value, sizeof(value)) != sizeof(value))
+            {
+                DEBUG_LVL_ERROR_TRACE("%s(): couldn't read eventfd!\n", __func__);
+            }
         }
-        /*else
-            TRACE("%s() ret = %d\n", __func__, ret);*/
+
+        // async frames sent while processing the events are passed to the
+        // kernel with one call
+        dllcalioctl_startBatch();
+
+        processKernelEvents();
+
+        while (eventucal_getEventCountCircbuf(kEventQueueUInt) > 0)
+            eventucal_processEventCircbuf(kEventQueueUInt);
+
+        dllcalioctl_flushBatch();
+
+        signalWaitHandle();
     }
     instance_l.fStopThread = FALSE;
 
     return NULL;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Signal a user event
+
+This function signals that a user-internal event was posted. It will be
+registered in the circular buffer library as signal callback function. The
+event thread drains the queue before it polls again, therefore it is only woken
+up if the queue changed from empty to non-empty.
+*/
+//------------------------------------------------------------------------------
+static void signalUserEvent(void)
+{
+    UINT64          value = 1;
+
+    if (eventucal_getEventCountCircbuf(kEventQueueUInt) != 1)
+        return;
+
+    if (write(instance_l.eventFd, &value, sizeof(value)) != sizeof(value))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s(): couldn't signal user event!\n", __func__);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Signal the wait handle
+
+This function signals the wait handle after the event thread processed events.
+*/
+//------------------------------------------------------------------------------
+static void signalWaitHandle(void)
+{
+    UINT64          value = 1;
+
+    if (write(instance_l.waitFd, &value, sizeof(value)) != sizeof(value))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s(): couldn't signal wait handle!\n", __func__);
+    }
+}
@@ -242,6 +242,30 @@ void eventucal_process(void)
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Wait for user events
+
+This function waits until an event is in the kernel-to-user queue or the timeout elapsed. Without an operating
+system the CPU cannot sleep, but the check is much cheaper than running the
+complete process function.
+
+\param  timeoutMs_p             Maximum time to wait in milliseconds.
+
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+void eventucal_waitEvent(UINT32 timeoutMs_p)
+{
+    UINT32      startTime = target_getTickCount();
+
+    while (eventucal_getEventCountCircbuf(kEventQueueK2U) == 0)
+    {
+        if ((target_getTickCount() - startTime) >= timeoutMs_p)
+            break;
+    }
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
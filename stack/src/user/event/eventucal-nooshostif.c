@@ -46,10 +46,13 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/oplkinc.h>
 #include <oplk/oplk.h>
 
+#include <common/target.h>
 #include <user/eventu.h>
 #include <user/eventucal.h>
 #include <user/eventucalintf.h>
 
+#include <hostiflib.h>
+
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
 //============================================================================//
@@ -80,6 +83,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 typedef struct
 {
     BOOL                    fInitialized;
+    tHostifInstance         pHifInstance;           ///< Host interface instance used for the doorbell
+    volatile BOOL           fDoorbell;              ///< The kernel side has signaled new events
 } tEventuCalArchInstance;
 
 //------------------------------------------------------------------------------
@@ -90,6 +95,7 @@ static tEventuCalArchInstance       instance_l;             ///< Instance variab
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
+static void hostifIrqEventCb(void* pArg_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -119,6 +125,16 @@ tOplkError eventucal_init(void)
     if (eventucal_initQueueCircbuf(kEventQueueK2U) != kErrorOk)
         goto Exit;
 
+    instance_l.pHifInstance = hostif_getInstance(0);
+    if (instance_l.pHifInstance == NULL)
+        goto Exit;
+
+    // Drain events posted before the doorbell handler was registered
+    instance_l.fDoorbell = TRUE;
+    if (hostif_irqRegHdl(instance_l.pHifInstance, kHostifIrqSrcEvent,
+                         hostifIrqEventCb) != kHostifSuccessful)
+        goto Exit;
+
     instance_l.fInitialized = TRUE;
     return kErrorOk;
 
@@ -147,6 +163,7 @@ tOplkError eventucal_exit(void)
 {
     if (instance_l.fInitialized == TRUE)
     {
+        hostif_irqRegHdl(instance_l.pHifInstance, kHostifIrqSrcEvent, NULL);
         eventucal_exitQueueCircbuf(kEventQueueK2U);
         eventucal_exitQueueCircbuf(kEventQueueU2K);
     }
@@ -210,24 +227,70 @@ tOplkError eventucal_postUserEvent(tEvent* pEvent_p)
 /**
 \brief  Process function of user CAL module
 
-This function will be called by the systems process function.
+This function will be called by the systems process function. The queue is
+only read if the kernel side has rung the doorbell. All pending events are
+processed then, because the kernel side only rings the doorbell again if it
+writes to an empty queue.
 
 \ingroup module_eventucal
 */
 //------------------------------------------------------------------------------
 void eventucal_process(void)
 {
-    if (eventucal_getEventCountCircbuf(kEventQueueK2U) > 0)
+    if (!instance_l.fDoorbell)
+        return;
+
+    instance_l.fDoorbell = FALSE;
+
+    while (eventucal_getEventCountCircbuf(kEventQueueK2U) > 0)
     {
         eventucal_processEventCircbuf(kEventQueueK2U);
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Wait for user events
+
+This function waits until the doorbell of the kernel-to-user queue was rung or the timeout elapsed. Without an operating
+system the CPU cannot sleep, but the check is much cheaper than running the
+complete process function.
+
+\param  timeoutMs_p             Maximum time to wait in milliseconds.
+
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+void eventucal_waitEvent(UINT32 timeoutMs_p)
+{
+    UINT32      startTime = target_getTickCount();
+
+    while (!instance_l.fDoorbell)
+    {
+        if ((target_getTickCount() - startTime) >= timeoutMs_p)
+            break;
+    }
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
 /// \name Private Functions
 /// \{
 
+//------------------------------------------------------------------------------
+/**
+\brief  Event doorbell callback called by Host Interface library
+
+\param  pArg_p                  Argument pointer provides hostif instance
+*/
+//------------------------------------------------------------------------------
+static void hostifIrqEventCb(void* pArg_p)
+{
+    UNUSED_PARAMETER(pArg_p);
+
+    instance_l.fDoorbell = TRUE;
+}
+
 /// \}
 
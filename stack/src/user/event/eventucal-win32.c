@@ -90,6 +90,7 @@ typedef struct
     HANDLE                  threadHandle;
     HANDLE                  semUserData;
     HANDLE                  semKernelData;
+    HANDLE                  hWaitEvent;             ///< Auto-reset event set after events were processed
     BOOL                    fInitialized;
     BOOL                    fStopThread;
 } tEventuCalInstance;
@@ -137,6 +138,9 @@ tOplkError eventucal_init(void)
     if ((instance_l.semKernelData = CreateSemaphore(NULL, 0, 100, "Local\\semKernelEvent")) == NULL)
         goto Exit;
 
+    if ((instance_l.hWaitEvent = CreateEvent(NULL, FALSE, FALSE, NULL)) == NULL)
+        goto Exit;
+
     if (eventucal_initQueueCircbuf(kEventQueueK2U) != kErrorOk)
         goto Exit;
 
@@ -172,6 +176,9 @@ Exit:
     if (instance_l.semKernelData != NULL)
         CloseHandle(instance_l.semKernelData);
 
+    if (instance_l.hWaitEvent != NULL)
+        CloseHandle(instance_l.hWaitEvent);
+
     eventucal_exitQueueCircbuf(kEventQueueK2U);
     eventucal_exitQueueCircbuf(kEventQueueU2K);
     eventucal_exitQueueCircbuf(kEventQueueUInt);
@@ -208,6 +215,7 @@ tOplkError eventucal_exit(void)
 
         CloseHandle(instance_l.semUserData);
         CloseHandle(instance_l.semKernelData);
+        CloseHandle(instance_l.hWaitEvent);
     }
     instance_l.fInitialized = FALSE;
 
@@ -285,6 +293,23 @@ void eventucal_process(void)
     // Nothing to do, because we use threads
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Wait for user events
+
+This function waits until the event thread processed events or the timeout
+elapsed.
+
+\param  timeoutMs_p             Maximum time to wait in milliseconds.
+
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+void eventucal_waitEvent(UINT32 timeoutMs_p)
+{
+    WaitForSingleObject(instance_l.hWaitEvent, timeoutMs_p);
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -328,6 +353,7 @@ static DWORD WINAPI eventThread(LPVOID arg)
                         eventucal_processEventCircbuf(kEventQueueUInt);
                     }
                 }
+                SetEvent(pInstance->hWaitEvent);
                 break;
 
             case WAIT_TIMEOUT:
@@ -43,9 +43,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 
 #include <user/eventucal.h>
+#include <user/eventucalintf.h>
 
 #include <common/circbuffer.h>
 
+#include "common/event/event.h"
+
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
 //============================================================================//
@@ -82,11 +85,19 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // local vars
 //------------------------------------------------------------------------------
 static tCircBufInstance*       instance_l[kEventQueueNum];
+static tCircBufInstance*       aLowLaneInstance_l[kEventQueueNum];     ///< Low-priority lanes, only used for the user internal queue
+static BOOL                    afLowLaneDetached_l[kEventQueueNum];    ///< Low-priority lane is processed separately
+#if (CONFIG_EVENT_PAYLOAD_POOL_SLOTS != 0)
+static tEventPayloadPool       payloadPool_l;                          ///< Payload pool of the user internal queue
+#endif
 
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
-static tOplkError postEvent(tCircBufInstance* pCircBufInstance_p, tEvent* pEvent_p);
+static tOplkError postEvent(tCircBufInstance* pCircBufInstance_p, tEvent* pEvent_p,
+                            BOOL fPayloadPool_p);
+static tCircBufInstance* getReadInstance(tEventQueue eventQueue_p);
+static tOplkError processEvent(tEventQueue eventQueue_p, tCircBufInstance* pCircBufInstance_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -101,7 +112,9 @@ static tOplkError postEvent(tCircBufInstance* pCircBufInstance_p, tEvent* pEvent
 \brief    Initialize an event queue
 
 The function initializes a circular buffer event queue. The queue to initialize
-is specified by eventQueue_p.
+is specified by eventQueue_p. For the user internal queue an additional
+low-priority lane is allocated if CONFIG_EVENT_SIZE_CIRCBUF_USER_INTERNAL_LOW
+is not 0.
 
 \param  eventQueue_p            Event queue to initialize.
 
@@ -132,6 +145,18 @@ tOplkError eventucal_initQueueCircbuf(tEventQueue eventQueue_p)
                 TRACE("PLK : Could not allocate CIRCBUF_USER_INTERNAL_QUEUE circbuffer\n");
                 return kErrorNoResource;
             }
+
+#if (CONFIG_EVENT_SIZE_CIRCBUF_USER_INTERNAL_LOW != 0)
+            circError = circbuf_alloc(CIRCBUF_USER_INTERNAL_LOW_QUEUE, CONFIG_EVENT_SIZE_CIRCBUF_USER_INTERNAL_LOW,
+                                      &aLowLaneInstance_l[eventQueue_p]);
+            if (circError != kCircBufOk)
+            {
+                TRACE("PLK : Could not allocate CIRCBUF_USER_INTERNAL_LOW_QUEUE circbuffer\n");
+                circbuf_free(instance_l[eventQueue_p]);
+                instance_l[eventQueue_p] = NULL;
+                return kErrorNoResource;
+            }
+#endif
             break;
 
         case kEventQueueU2K:
@@ -157,6 +182,10 @@ tOplkError eventucal_initQueueCircbuf(tEventQueue eventQueue_p)
             break;
     }
 
+#if (CONFIG_EVENT_LATENCY != FALSE)
+    event_initLatency(eventQueue_p);
+#endif
+
     return kErrorOk;
 }
 
@@ -188,6 +217,12 @@ tOplkError eventucal_exitQueueCircbuf(tEventQueue eventQueue_p)
     {
         case kEventQueueUInt:
             circbuf_free(instance_l[eventQueue_p]);
+            if (aLowLaneInstance_l[eventQueue_p] != NULL)
+            {
+                circbuf_free(aLowLaneInstance_l[eventQueue_p]);
+                aLowLaneInstance_l[eventQueue_p] = NULL;
+            }
+            afLowLaneDetached_l[eventQueue_p] = FALSE;
             break;
 
         case kEventQueueU2K:
@@ -212,7 +247,12 @@ tOplkError eventucal_exitQueueCircbuf(tEventQueue eventQueue_p)
 /**
 \brief    Post event using circular buffer
 
-This function posts an event to the provided queue instance.
+This function posts an event to the provided queue instance. Events for
+low-priority sinks (see EVENT_SINK_IS_LOW_PRIORITY) are posted to the
+low-priority lane of the queue if there is one. Large arguments of events for
+the user internal queue are stored in the payload pool if
+CONFIG_EVENT_PAYLOAD_POOL_SLOTS is not 0. If CONFIG_EVENT_LATENCY is enabled,
+the post time is appended to the queue entry.
 
 \param  eventQueue_p            Event queue to which the event should be posted to.
 \param  pEvent_p                Pointer to event
@@ -226,13 +266,26 @@ This function posts an event to the provided queue instance.
 //------------------------------------------------------------------------------
 tOplkError eventucal_postEventCircbuf(tEventQueue eventQueue_p, tEvent* pEvent_p)
 {
+    tOplkError          ret;
+
     if (eventQueue_p > kEventQueueNum)
         return kErrorInvalidInstanceParam;
 
     if (instance_l[eventQueue_p] == NULL)
         return kErrorInvalidInstanceParam;
 
-    return postEvent(instance_l[eventQueue_p], pEvent_p);
+    if ((aLowLaneInstance_l[eventQueue_p] != NULL) &&
+        EVENT_SINK_IS_LOW_PRIORITY(pEvent_p->eventSink))
+        ret = postEvent(aLowLaneInstance_l[eventQueue_p], pEvent_p, (eventQueue_p == kEventQueueUInt));
+    else
+        ret = postEvent(instance_l[eventQueue_p], pEvent_p, (eventQueue_p == kEventQueueUInt));
+
+#if (CONFIG_EVENT_LATENCY != FALSE)
+    if (ret == kErrorOk)
+        event_observeDepth(eventQueue_p, eventucal_getEventCountCircbuf(eventQueue_p));
+#endif
+
+    return ret;
 }
 
 //------------------------------------------------------------------------------
@@ -240,7 +293,12 @@ tOplkError eventucal_postEventCircbuf(tEventQueue eventQueue_p, tEvent* pEvent_p
 \brief    Process event using circular buffers
 
 This function reads a circular buffer event queue and processes the event
-by calling the event handlers process function.
+by calling the event handlers process function. The event is processed in the
+circular buffer and released afterwards. Only events which wrap around the end
+of the buffer are copied. Arguments stored in the payload pool are passed to
+the sink in place as well. The low-priority lane of the queue is only read if
+the queue itself is empty and the lane is not processed separately (see
+eventucal_setLowLaneSignalingCircbuf()).
 
 \param  eventQueue_p            Event queue used for reading the event.
 
@@ -253,44 +311,42 @@ by calling the event handlers process function.
 //------------------------------------------------------------------------------
 tOplkError eventucal_processEventCircbuf(tEventQueue eventQueue_p)
 {
-    tEvent*             pEplEvent;
-    tCircBufError       error;
-    tOplkError          ret = kErrorOk;
-    size_t              readSize;
-    tCircBufInstance*   pCircBufInstance;
-    BYTE                aRxBuffer[sizeof(tEvent) + MAX_EVENT_ARG_SIZE];
-
     if (eventQueue_p > kEventQueueNum)
         return kErrorInvalidInstanceParam;
 
     if (instance_l[eventQueue_p] == NULL)
         return kErrorInvalidInstanceParam;
 
-    pCircBufInstance = instance_l[eventQueue_p];
+    return processEvent(eventQueue_p, getReadInstance(eventQueue_p));
+}
 
-    error = circbuf_readData(pCircBufInstance, aRxBuffer,
-                             sizeof(tEvent) + MAX_EVENT_ARG_SIZE, &readSize);
-    if(error != kCircBufOk)
-    {
-        if (error == kCircBufNoReadableData)
-            return kErrorOk;
+//------------------------------------------------------------------------------
+/**
+\brief    Process event of the low-priority lane
 
-        eventu_postError(kEventSourceEventk, kErrorEventReadError,
-                         sizeof(tCircBufError), &error);
+This function reads one event from the low-priority lane of a circular buffer
+event queue and processes it like eventucal_processEventCircbuf(). It is used
+by a separate thread which processes the lane after it was detached by
+eventucal_setLowLaneSignalingCircbuf().
 
-        return kErrorGeneralError;
-    }
+\param  eventQueue_p            Event queue used for reading the event.
 
-    pEplEvent = (tEvent*)aRxBuffer;
-    pEplEvent->eventArgSize = (readSize - sizeof(tEvent));
+\return The function returns a tOplkError error code.
+\retval kErrorOk                Function executes correctly
+\retval other                   Error
 
-    if(pEplEvent->eventArgSize > 0)
-        pEplEvent->pEventArg = &aRxBuffer[sizeof(tEvent)];
-    else
-        pEplEvent->pEventArg = NULL;
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+tOplkError eventucal_processLowLaneEventCircbuf(tEventQueue eventQueue_p)
+{
+    if (eventQueue_p > kEventQueueNum)
+        return kErrorInvalidInstanceParam;
 
-    ret = eventu_process(pEplEvent);
-    return ret;
+    if (aLowLaneInstance_l[eventQueue_p] == NULL)
+        return kErrorInvalidInstanceParam;
+
+    return processEvent(eventQueue_p, aLowLaneInstance_l[eventQueue_p]);
 }
 
 //------------------------------------------------------------------------------
@@ -315,9 +371,73 @@ UINT eventucal_getEventCountCircbuf(tEventQueue eventQueue_p)
     if (instance_l[eventQueue_p] == NULL)
         return 0;
 
+    if ((aLowLaneInstance_l[eventQueue_p] != NULL) && !afLowLaneDetached_l[eventQueue_p])
+    {
+        return circbuf_getDataCount(instance_l[eventQueue_p]) +
+               circbuf_getDataCount(aLowLaneInstance_l[eventQueue_p]);
+    }
+
     return circbuf_getDataCount(instance_l[eventQueue_p]);
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief Get number of events in the low-priority lane
+
+This function returns the number of events which are currently available in
+the low-priority lane of the circular buffer event queue.
+
+\param  eventQueue_p            Event queue to read the count from.
+
+\return The function returns the number of active events.
+
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+UINT eventucal_getLowLaneEventCountCircbuf(tEventQueue eventQueue_p)
+{
+    if (eventQueue_p > kEventQueueNum)
+        return 0;
+
+    if (aLowLaneInstance_l[eventQueue_p] == NULL)
+        return 0;
+
+    return circbuf_getDataCount(aLowLaneInstance_l[eventQueue_p]);
+}
+
+#ifdef DEBUG_CIRCBUF_SIZE_CHECK
+//------------------------------------------------------------------------------
+/**
+\brief Get maximum used size of event queue
+
+This function returns the maximum used size of the circular buffer event
+queue. The low-priority lane of the user internal queue is included.
+
+\param  eventQueue_p            Event queue to read the size from.
+
+\return The function returns the maximum used size in bytes.
+
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+UINT32 eventucal_getMaxSizeCircbuf(tEventQueue eventQueue_p)
+{
+    if (eventQueue_p >= kEventQueueNum)
+        return 0;
+
+    if (instance_l[eventQueue_p] == NULL)
+        return 0;
+
+    if (aLowLaneInstance_l[eventQueue_p] != NULL)
+    {
+        return circbuf_getMaxSize(instance_l[eventQueue_p]) +
+               circbuf_getMaxSize(aLowLaneInstance_l[eventQueue_p]);
+    }
+
+    return circbuf_getMaxSize(instance_l[eventQueue_p]);
+}
+#endif
+
 //------------------------------------------------------------------------------
 /**
 \brief  Setup event signaling for circular buffer event queue
@@ -342,6 +462,43 @@ tOplkError eventucal_setSignalingCircbuf(tEventQueue eventQueue_p, VOIDFUNCPTR p
         return kErrorInvalidInstanceParam;
 
     circBuf_setSignaling(instance_l[eventQueue_p], pfnSignalCb_p);
+    if ((aLowLaneInstance_l[eventQueue_p] != NULL) && !afLowLaneDetached_l[eventQueue_p])
+        circBuf_setSignaling(aLowLaneInstance_l[eventQueue_p], pfnSignalCb_p);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Detach the low-priority lane of an event queue
+
+This function sets up a separate signaling callback for the low-priority lane
+of the specified circular buffer event queue. Afterwards the lane is no longer
+read by eventucal_processEventCircbuf() and not counted by
+eventucal_getEventCountCircbuf(). Its events must be processed with
+eventucal_processLowLaneEventCircbuf().
+
+\param  eventQueue_p            Event queue of the lane.
+\param  pfnSignalCb_p           Pointer to signaling callback function.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                Function executes correctly
+\retval kErrorInvalidInstanceParam The queue has no low-priority lane.
+
+\ingroup module_eventucal
+*/
+//------------------------------------------------------------------------------
+tOplkError eventucal_setLowLaneSignalingCircbuf(tEventQueue eventQueue_p, VOIDFUNCPTR pfnSignalCb_p)
+{
+    if (eventQueue_p > kEventQueueNum)
+        return kErrorInvalidInstanceParam;
+
+    if (aLowLaneInstance_l[eventQueue_p] == NULL)
+        return kErrorInvalidInstanceParam;
+
+    circBuf_setSignaling(aLowLaneInstance_l[eventQueue_p], pfnSignalCb_p);
+    afLowLaneDetached_l[eventQueue_p] = TRUE;
+
     return kErrorOk;
 }
 
@@ -359,27 +516,55 @@ This function posts an event to the provided queue instance.
 
 \param  pCircBufInstance_p      Pointer to circular buffer instance
 \param  pEvent_p                Pointer to event
+\param  fPayloadPool_p          Store a large argument in the payload pool.
 
 \return tOplkError
 \retval kErrorOk                Function executes correctly
 \retval other                   Error
 */
 //------------------------------------------------------------------------------
-static tOplkError postEvent(tCircBufInstance* pCircBufInstance_p, tEvent* pEvent_p)
+static tOplkError postEvent(tCircBufInstance* pCircBufInstance_p, tEvent* pEvent_p,
+                            BOOL fPayloadPool_p)
 {
     tOplkError          ret = kErrorOk;
     tCircBufError       circError;
+    BYTE*               pData;
+    void*               pPayload = NULL;
+    size_t              argSize;
     //TRACE("%s() Event:%d Sink:%d\n", __func__, pEvent_p->eventType, pEvent_p->eventSink);
 
-    if (pEvent_p->eventArgSize == 0)
-    {
-        circError = circbuf_writeData(pCircBufInstance_p, pEvent_p, sizeof(tEvent));
-    }
-    else
+#if (CONFIG_EVENT_PAYLOAD_POOL_SLOTS != 0)
+    if (fPayloadPool_p)
+        pPayload = event_allocPayload(&payloadPool_l, pEvent_p);
+#else
+    UNUSED_PARAMETER(fPayloadPool_p);
+#endif
+    argSize = (pPayload != NULL) ? sizeof(void*) : pEvent_p->eventArgSize;
+
+    // Serialize the event directly into the queue
+    circError = circbuf_reserve(pCircBufInstance_p,
+                                sizeof(tEvent) + argSize + EVENT_LATENCY_STAMP_SIZE,
+                                (void**)&pData);
+    if (circError != kCircBufOk)
     {
-        circError = circbuf_writeMultipleData(pCircBufInstance_p, pEvent_p, sizeof(tEvent),
-                                              pEvent_p->pEventArg, (ULONG)pEvent_p->eventArgSize);
+#if (CONFIG_EVENT_PAYLOAD_POOL_SLOTS != 0)
+        if (pPayload != NULL)
+            event_freePayload(&payloadPool_l, pPayload);
+#endif
+        return kErrorEventPostError;
     }
+
+    OPLK_MEMCPY(pData, pEvent_p, sizeof(tEvent));
+    if (pPayload != NULL)
+        OPLK_MEMCPY(pData + sizeof(tEvent), &pPayload, sizeof(void*));
+    else if (pEvent_p->eventArgSize != 0)
+        OPLK_MEMCPY(pData + sizeof(tEvent), pEvent_p->pEventArg, pEvent_p->eventArgSize);
+
+#if (CONFIG_EVENT_LATENCY != FALSE)
+    event_stampLatency(pData + sizeof(tEvent) + argSize);
+#endif
+
+    circError = circbuf_commit(pCircBufInstance_p, pData);
     if(circError != kCircBufOk)
     {
         ret = kErrorEventPostError;
@@ -387,5 +572,126 @@ static tOplkError postEvent(tCircBufInstance* pCircBufInstance_p, tEvent* pEvent
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief    Get circular buffer instance to read from
+
+This function returns the circular buffer instance from which the next event
+of the queue shall be read. The low-priority lane is only returned if the
+queue itself contains no events.
+
+\param  eventQueue_p            Event queue to read from.
+
+\return The function returns the circular buffer instance to read from.
+*/
+//------------------------------------------------------------------------------
+static tCircBufInstance* getReadInstance(tEventQueue eventQueue_p)
+{
+    if ((aLowLaneInstance_l[eventQueue_p] != NULL) && !afLowLaneDetached_l[eventQueue_p] &&
+        (circbuf_getDataCount(instance_l[eventQueue_p]) == 0))
+        return aLowLaneInstance_l[eventQueue_p];
+
+    return instance_l[eventQueue_p];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Process an event of a circular buffer
+
+This function reads the next event from the given circular buffer instance of
+the queue and passes it to the event handler (see
+eventucal_processEventCircbuf()).
+
+\param  eventQueue_p            Event queue used for reading the event.
+\param  pCircBufInstance_p      Circular buffer instance to read from.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError processEvent(tEventQueue eventQueue_p, tCircBufInstance* pCircBufInstance_p)
+{
+    tEvent*             pEplEvent;
+    tCircBufError       error;
+    tOplkError          ret = kErrorOk;
+    size_t              readSize;
+    BOOL                fInPlace = TRUE;
+    BYTE                aRxBuffer[sizeof(tEvent) + MAX_EVENT_ARG_SIZE + EVENT_LATENCY_STAMP_SIZE];
+    void*               pPayload = NULL;
+#if (CONFIG_EVENT_LATENCY != FALSE)
+    UINT64              startTime;
+#endif
+
+#if ((CONFIG_EVENT_LATENCY == FALSE) && (CONFIG_EVENT_PAYLOAD_POOL_SLOTS == 0))
+    UNUSED_PARAMETER(eventQueue_p);
+#endif
+
+    error = circbuf_peek(pCircBufInstance_p, (void**)&pEplEvent, &readSize);
+    if (error == kCircBufDataNotContiguous)
+    {   // Event wraps around the end of the buffer and must be copied
+        fInPlace = FALSE;
+        pEplEvent = (tEvent*)aRxBuffer;
+        error = circbuf_readData(pCircBufInstance_p, aRxBuffer,
+                                 sizeof(aRxBuffer), &readSize);
+    }
+    if(error != kCircBufOk)
+    {
+        if (error == kCircBufNoReadableData)
+            return kErrorOk;
+
+        eventu_postError(kEventSourceEventk, kErrorEventReadError,
+                         sizeof(tCircBufError), &error);
+
+        return kErrorGeneralError;
+    }
+
+#if (CONFIG_EVENT_LATENCY != FALSE)
+    if (readSize < sizeof(tEvent) + EVENT_LATENCY_STAMP_SIZE)
+    {
+        if (fInPlace)
+            circbuf_release(pCircBufInstance_p);
+        return kErrorEventReadError;
+    }
+
+    // the post time is stored behind the argument
+    readSize -= EVENT_LATENCY_STAMP_SIZE;
+    startTime = event_observeLatency(eventQueue_p, pEplEvent, (BYTE*)pEplEvent + readSize);
+#endif
+
+#if (CONFIG_EVENT_PAYLOAD_POOL_SLOTS != 0)
+    if (eventQueue_p == kEventQueueUInt)
+        pPayload = event_getPayloadRef(pEplEvent, readSize - sizeof(tEvent));
+#endif
+
+    if (pPayload != NULL)
+    {   // argument is stored in the payload pool, keep the size of the header
+        pEplEvent->pEventArg = pPayload;
+    }
+    else
+    {
+        pEplEvent->eventArgSize = (readSize - sizeof(tEvent));
+
+        if(pEplEvent->eventArgSize > 0)
+            pEplEvent->pEventArg = (BYTE*)pEplEvent + sizeof(tEvent);
+        else
+            pEplEvent->pEventArg = NULL;
+    }
+
+    ret = eventu_process(pEplEvent);
+
+#if (CONFIG_EVENT_LATENCY != FALSE)
+    event_observeProcessing(eventQueue_p, pEplEvent, startTime);
+#endif
+
+#if (CONFIG_EVENT_PAYLOAD_POOL_SLOTS != 0)
+    if (pPayload != NULL)
+        event_freePayload(&payloadPool_l, pPayload);
+#endif
+
+    if (fInPlace)
+        circbuf_release(pCircBufInstance_p);
+
+    return ret;
+}
+
 /// \}
 
@@ -41,6 +41,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <common/ami.h>
+#include <common/target.h>
 #include <user/identu.h>
 #include <user/dllucal.h>
 
@@ -69,14 +70,26 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#define IDENTU_MAX_CHANGE_CB        4       // maximum number of change callbacks
 
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
+typedef struct
+{
+    UINT32              timeStamp;          // tick count of the reception of the cached IdentResponse
+    UINT32              version;            // version of the cached IdentResponse
+    BOOL                fRequestPending;    // IdentRequest issued, but no response received yet
+    tIdentuCbResponse   apfnCbWaiting[CONFIG_NMTU_CACHE_MAX_WAITERS];   // requesters of the cached IdentResponse
+} tIdentuCacheEntry;
+
 typedef struct
 {
     tIdentResponse*     apIdentResponse[254];    // the IdentResponse are managed dynamically
     tIdentuCbResponse   apfnCbResponse[254];
+    tIdentuCacheEntry   aCacheEntry[254];
+    tIdentuCbResponse   apfnCbChange[IDENTU_MAX_CHANGE_CB];
+    UINT32              lastVersion;             // last assigned version, kept on reset
 } tIdentuInstance;
 
 //------------------------------------------------------------------------------
@@ -88,6 +101,10 @@ static tIdentuInstance   instance_g;
 // local function prototypes
 //------------------------------------------------------------------------------
 static tOplkError   identu_cbIdentResponse(tFrameInfo* pFrameInfo_p);
+#if defined(CONFIG_INCLUDE_NMT_MN)
+static tOplkError   issueRequest(UINT index_p);
+#endif
+static BOOL         updateCache(UINT index_p, tIdentResponse* pIdentResponse_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -168,8 +185,10 @@ The function resets an ident module instance
 //------------------------------------------------------------------------------
 tOplkError identu_reset()
 {
-    tOplkError  ret;
-    UINT        index;
+    tOplkError          ret;
+    UINT                index;
+    tIdentuCbResponse   apfnCbChange[IDENTU_MAX_CHANGE_CB];
+    UINT32              lastVersion;
 
     ret = kErrorOk;
     for (index = 0; index < tabentries(instance_g.apIdentResponse); index++)
@@ -179,7 +198,13 @@ tOplkError identu_reset()
             OPLK_FREE(instance_g.apIdentResponse[index]);
         }
     }
+
+    // the change callbacks and the version counter survive the reset
+    OPLK_MEMCPY(apfnCbChange, instance_g.apfnCbChange, sizeof(apfnCbChange));
+    lastVersion = instance_g.lastVersion;
     OPLK_MEMSET(&instance_g, 0, sizeof(tIdentuInstance));
+    OPLK_MEMCPY(instance_g.apfnCbChange, apfnCbChange, sizeof(apfnCbChange));
+    instance_g.lastVersion = lastVersion;
 
     return ret;
 }
@@ -267,7 +292,7 @@ tOplkError identu_requestIdentResponse(UINT nodeId_p, tIdentuCbResponse pfnCbRes
         else
         {
             instance_g.apfnCbResponse[nodeId_p] = pfnCbResponse_p;
-            ret = dllucal_issueRequest(kDllReqServiceIdent, (nodeId_p + 1), 0xFF);
+            ret = issueRequest(nodeId_p);
         }
 #else
         ret = kErrorInvalidOperation;
@@ -309,6 +334,173 @@ UINT32 identu_getRunningRequests(void)
     return reqs;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Request cached ident response
+
+The function provides the cached IdentResponse of a specified node. If the
+cached IdentResponse is not older than CONFIG_IDENTU_CACHE_MAX_AGE, the
+callback function is called immediately. Otherwise, an IdentRequest is issued
+and the callback function is called when the IdentResponse is received.
+Concurrent requesters of the same node share one IdentRequest.
+
+\param  nodeId_p            The Node ID to request the IdentResponse for.
+\param  pfnCbResponse_p     Function pointer to callback function which will
+                            be called with the IdentResponse. NULL, if only
+                            the cache shall be refreshed.
+
+\return The function returns a tOplkError error code.
+\retval kErrorInvalidOperation  No further requester can be queued for this node.
+
+\ingroup module_identu
+*/
+//------------------------------------------------------------------------------
+tOplkError identu_requestCachedIdentResponse(UINT nodeId_p, tIdentuCbResponse pfnCbResponse_p)
+{
+#if defined(CONFIG_INCLUDE_NMT_MN)
+    tOplkError          ret = kErrorOk;
+    UINT                index;
+    UINT                waiter;
+    tIdentuCacheEntry*  pEntry;
+
+    index = nodeId_p - 1;
+    if (index >= tabentries(instance_g.aCacheEntry))
+        return kErrorInvalidNodeId;
+
+    pEntry = &instance_g.aCacheEntry[index];
+    if ((instance_g.apIdentResponse[index] != NULL) &&
+        ((target_getTickCount() - pEntry->timeStamp) <= CONFIG_IDENTU_CACHE_MAX_AGE))
+    {   // cached IdentResponse is recent enough
+        if (pfnCbResponse_p != NULL)
+            ret = pfnCbResponse_p(nodeId_p, instance_g.apIdentResponse[index]);
+        return ret;
+    }
+
+    if (pfnCbResponse_p != NULL)
+    {
+        for (waiter = 0; waiter < tabentries(pEntry->apfnCbWaiting); waiter++)
+        {
+            if ((pEntry->apfnCbWaiting[waiter] == NULL) ||
+                (pEntry->apfnCbWaiting[waiter] == pfnCbResponse_p))
+                break;
+        }
+
+        if (waiter >= tabentries(pEntry->apfnCbWaiting))
+            return kErrorInvalidOperation;
+    }
+
+    ret = issueRequest(index);
+    if ((ret == kErrorOk) && (pfnCbResponse_p != NULL))
+        pEntry->apfnCbWaiting[waiter] = pfnCbResponse_p;
+
+    return ret;
+#else
+    UNUSED_PARAMETER(nodeId_p);
+    UNUSED_PARAMETER(pfnCbResponse_p);
+
+    return kErrorInvalidOperation;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get snapshot of ident response
+
+The function copies the cached IdentResponse of a specified node together with
+its version and age. The version changes whenever a received IdentResponse
+differs from the previous one.
+
+\param  nodeId_p            The Node ID to get the IdentResponse for.
+\param  pSnapshot_p         Pointer to store the snapshot.
+
+\return The function returns a tOplkError error code.
+\retval kErrorInvalidOperation  No IdentResponse is cached for this node.
+
+\ingroup module_identu
+*/
+//------------------------------------------------------------------------------
+tOplkError identu_getIdentResponseSnapshot(UINT nodeId_p, tIdentuSnapshot* pSnapshot_p)
+{
+    UINT    index;
+
+    index = nodeId_p - 1;
+    if (index >= tabentries(instance_g.apIdentResponse))
+        return kErrorInvalidNodeId;
+
+    if (instance_g.apIdentResponse[index] == NULL)
+        return kErrorInvalidOperation;
+
+    OPLK_MEMCPY(&pSnapshot_p->identResponse, instance_g.apIdentResponse[index],
+                sizeof(tIdentResponse));
+    pSnapshot_p->version = instance_g.aCacheEntry[index].version;
+    pSnapshot_p->age = target_getTickCount() - instance_g.aCacheEntry[index].timeStamp;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Register change callback
+
+The function registers a callback function which is called whenever the
+cached IdentResponse of a node changes.
+
+\param  pfnCbChange_p       Function pointer to the callback function.
+
+\return The function returns a tOplkError error code.
+\retval kErrorNoResource    The maximum number of change callbacks is reached.
+
+\ingroup module_identu
+*/
+//------------------------------------------------------------------------------
+tOplkError identu_registerChangeCb(tIdentuCbResponse pfnCbChange_p)
+{
+    UINT    index;
+    UINT    freeIndex = IDENTU_MAX_CHANGE_CB;
+
+    for (index = 0; index < IDENTU_MAX_CHANGE_CB; index++)
+    {
+        if (instance_g.apfnCbChange[index] == pfnCbChange_p)
+            return kErrorOk;
+
+        if ((instance_g.apfnCbChange[index] == NULL) && (freeIndex == IDENTU_MAX_CHANGE_CB))
+            freeIndex = index;
+    }
+
+    if (freeIndex == IDENTU_MAX_CHANGE_CB)
+        return kErrorNoResource;
+
+    instance_g.apfnCbChange[freeIndex] = pfnCbChange_p;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Deregister change callback
+
+The function deregisters a callback function which was registered with
+identu_registerChangeCb().
+
+\param  pfnCbChange_p       Function pointer to the callback function.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_identu
+*/
+//------------------------------------------------------------------------------
+tOplkError identu_deregisterChangeCb(tIdentuCbResponse pfnCbChange_p)
+{
+    UINT    index;
+
+    for (index = 0; index < IDENTU_MAX_CHANGE_CB; index++)
+    {
+        if (instance_g.apfnCbChange[index] == pfnCbChange_p)
+            instance_g.apfnCbChange[index] = NULL;
+    }
+
+    return kErrorOk;
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -333,51 +525,139 @@ IdentResponse is received.
 static tOplkError identu_cbIdentResponse(tFrameInfo* pFrameInfo_p)
 {
     tOplkError              ret = kErrorOk;
+    tOplkError              retCb;
     UINT                    nodeId;
     UINT                    index;
+    UINT                    cb;
+    BOOL                    fChanged = FALSE;
     tIdentuCbResponse       pfnCbResponse;
+    tIdentuCbResponse       apfnCbWaiting[CONFIG_NMTU_CACHE_MAX_WAITERS];
+    tIdentResponse*         pIdentResponse = NULL;
 
     nodeId = ami_getUint8Le(&pFrameInfo_p->pFrame->srcNodeId);
     index = nodeId - 1;
 
     if (index < tabentries(instance_g.apfnCbResponse))
     {
-        // save pointer to callback function
+        // save pointers to callback functions
         pfnCbResponse = instance_g.apfnCbResponse[index];
-        // reset callback function pointer so that caller may issue next request immediately
+        OPLK_MEMCPY(apfnCbWaiting, instance_g.aCacheEntry[index].apfnCbWaiting, sizeof(apfnCbWaiting));
+        // reset callback function pointers so that caller may issue next request immediately
         instance_g.apfnCbResponse[index] = NULL;
+        OPLK_MEMSET(instance_g.aCacheEntry[index].apfnCbWaiting, 0, sizeof(apfnCbWaiting));
+        instance_g.aCacheEntry[index].fRequestPending = FALSE;
 
-        if (pfnCbResponse == NULL)
-            goto Exit;
+        if (pFrameInfo_p->frameSize >= C_DLL_MINSIZE_IDENTRES)
+        {   // IdentResponse received
+            fChanged = updateCache(index, &pFrameInfo_p->pFrame->data.asnd.payload.identResponse);
+            pIdentResponse = instance_g.apIdentResponse[index];
+            if (pIdentResponse == NULL)
+            {   // malloc failed
+                pIdentResponse = &pFrameInfo_p->pFrame->data.asnd.payload.identResponse;
+            }
+        }
+        // otherwise IdentResponse not received or it has invalid size
 
-        if (pFrameInfo_p->frameSize < C_DLL_MINSIZE_IDENTRES)
-        {   // IdentResponse not received or it has invalid size
-            ret = pfnCbResponse(nodeId, NULL);
+        if (pfnCbResponse != NULL)
+            ret = pfnCbResponse(nodeId, pIdentResponse);
+
+        for (cb = 0; cb < tabentries(apfnCbWaiting); cb++)
+        {
+            if (apfnCbWaiting[cb] == NULL)
+                break;
+
+            retCb = apfnCbWaiting[cb](nodeId, pIdentResponse);
+            if (ret == kErrorOk)
+                ret = retCb;
         }
-        else
-        {   // IdentResponse received
-            if (instance_g.apIdentResponse[index] == NULL)
-            {   // memory for IdentResponse must be allocated
-                instance_g.apIdentResponse[index] = OPLK_MALLOC(sizeof(tIdentResponse));
-                if (instance_g.apIdentResponse[index] == NULL)
-                {   // malloc failed
-                    ret = pfnCbResponse(nodeId,
-                                        &pFrameInfo_p->pFrame->data.asnd.payload.identResponse);
-                    goto Exit;
+
+        if (fChanged)
+        {
+            for (cb = 0; cb < IDENTU_MAX_CHANGE_CB; cb++)
+            {
+                if (instance_g.apfnCbChange[cb] != NULL)
+                {
+                    retCb = instance_g.apfnCbChange[cb](nodeId, instance_g.apIdentResponse[index]);
+                    if (ret == kErrorOk)
+                        ret = retCb;
                 }
             }
-
-            // copy IdentResponse to instance structure
-            OPLK_MEMCPY(instance_g.apIdentResponse[index],
-                        &pFrameInfo_p->pFrame->data.asnd.payload.identResponse,
-                        sizeof(tIdentResponse));
-            ret = pfnCbResponse(nodeId, instance_g.apIdentResponse[index]);
         }
     }
 
-Exit:
     return ret;
 }
 
+#if defined(CONFIG_INCLUDE_NMT_MN)
+//------------------------------------------------------------------------------
+/**
+\brief  Issue IdentRequest
+
+The function issues an IdentRequest for the specified node unless one is
+already pending. Thereby, all requesters of a node share one IdentRequest.
+
+\param  index_p             Index of the node (node ID - 1).
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_identu
+*/
+//------------------------------------------------------------------------------
+static tOplkError issueRequest(UINT index_p)
+{
+    tOplkError  ret;
+
+    if (instance_g.aCacheEntry[index_p].fRequestPending)
+        return kErrorOk;
+
+    ret = dllucal_issueRequest(kDllReqServiceIdent, (index_p + 1), 0xFF);
+    if (ret == kErrorOk)
+        instance_g.aCacheEntry[index_p].fRequestPending = TRUE;
+
+    return ret;
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update cached IdentResponse
+
+The function stores a received IdentResponse in the cache of the specified
+node. The version of the cached IdentResponse is incremented if its content
+changes.
+
+\param  index_p             Index of the node (node ID - 1).
+\param  pIdentResponse_p    Pointer to the received IdentResponse.
+
+\return The function returns TRUE if the cached IdentResponse was changed.
+
+\ingroup module_identu
+*/
+//------------------------------------------------------------------------------
+static BOOL updateCache(UINT index_p, tIdentResponse* pIdentResponse_p)
+{
+    tIdentuCacheEntry*  pEntry = &instance_g.aCacheEntry[index_p];
+
+    if (instance_g.apIdentResponse[index_p] == NULL)
+    {   // memory for IdentResponse must be allocated
+        instance_g.apIdentResponse[index_p] = OPLK_MALLOC(sizeof(tIdentResponse));
+        if (instance_g.apIdentResponse[index_p] == NULL)
+            return FALSE;
+    }
+    else if (OPLK_MEMCMP(instance_g.apIdentResponse[index_p], pIdentResponse_p,
+                         sizeof(tIdentResponse)) == 0)
+    {   // IdentResponse is unchanged
+        pEntry->timeStamp = target_getTickCount();
+        return FALSE;
+    }
+
+    // copy IdentResponse to instance structure
+    OPLK_MEMCPY(instance_g.apIdentResponse[index_p], pIdentResponse_p, sizeof(tIdentResponse));
+    pEntry->timeStamp = target_getTickCount();
+    pEntry->version = ++instance_g.lastVersion;
+
+    return TRUE;
+}
+
 ///\}
 
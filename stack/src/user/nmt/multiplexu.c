@@ -0,0 +1,349 @@
+/**
+********************************************************************************
+\file   multiplexu.c
+
+\brief  Implementation of multiplexed cycle scheduler
+
+This file contains the implementation of the multiplexed cycle scheduler. At
+NMT_ResetConfiguration it assigns the multiplexed CNs of the MN to the
+multiplexed cycles (object 0x1F9B) so that the isochronous phases of all
+multiplexed cycles are as short and as balanced as possible.
+
+\ingroup module_multiplexu
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2012, SYSTEC electronic GmbH
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <common/ami.h>
+#include <oplk/obd.h>
+#include <oplk/frame.h>
+#include <user/multiplexu.h>
+#include <user/identu.h>
+
+#if defined(CONFIG_INCLUDE_NMT_MN) && (CONFIG_NMTMNU_MULTIPLEX_SCHEDULE != FALSE)
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+// transmission time of a frame with the specified size without CRC in [ns]
+#define MULTIPLEXU_FRAME_TIME_NS(size_p) \
+    (C_DLL_T_PREAMBLE + (((size_p) + 4) * 8 * C_DLL_T_BITTIME) + C_DLL_T_IFG)
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+typedef struct
+{
+    UINT                nodeId;
+    UINT32              timeNs;             // isochronous time of the CN
+} tMultiplexuNode;
+
+typedef struct
+{
+    tMultiplexReport    report;
+    tMultiplexuNode     aNode[NMT_MAX_NODE_ID];     // multiplexed CNs sorted by time
+} tMultiplexuInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tMultiplexuInstance  instance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError calcNodeTime(UINT nodeId_p, UINT32* pTimeNs_p);
+static UINT32     calcFrameTime(UINT16 payload_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Compute multiplexed cycle assignment
+
+The function computes the multiplexed cycle assignment of the multiplexed CNs
+(NMT_NODEASSIGN_MULTIPLEXED_CN in object 0x1F81) and writes it to object
+0x1F9B. The isochronous time of a CN is determined from its PReq and PRes
+payload limits (objects 0x1F8B and 0x1F8D) and its PRes latency. The latency
+is the PRes timeout (object 0x1F92) or the shorter response time which the CN
+reported in its last IdentResponse.
+
+The CNs are assigned in the order of decreasing isochronous time, each to the
+multiplexed cycle with the lowest load so far (longest processing time first).
+This minimizes the longest isochronous phase and balances the multiplexed
+cycles.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_multiplexu
+*/
+//------------------------------------------------------------------------------
+tOplkError multiplexu_schedule(void)
+{
+    tOplkError          ret;
+    tMultiplexReport*   pReport = &instance_l.report;
+    tObdSize            obdSize;
+    UINT32              nodeCfg;
+    UINT32              timeNs;
+    UINT32              maxCycleTimeNs = 0;
+    UINT8               multiplCycleCnt;
+    UINT8               count;
+    UINT8               cycleAssign;
+    UINT                nodeCount = 0;
+    UINT                index;
+    UINT                pos;
+    UINT                cycle;
+
+    OPLK_MEMSET(pReport, 0, sizeof(tMultiplexReport));
+
+    obdSize = sizeof(multiplCycleCnt);
+    ret = obd_readEntry(0x1F98, 7, &multiplCycleCnt, &obdSize);
+    if (ret != kErrorOk)
+        return ret;
+
+    obdSize = sizeof(count);
+    if (obd_readEntry(0x1F9B, 0, &count, &obdSize) != kErrorOk)
+    {   // multiplexed cycle assignment is not supported by the OD
+        multiplCycleCnt = 0;
+    }
+
+    // read number of nodes from object 0x1F81/0
+    obdSize = sizeof(count);
+    ret = obd_readEntry(0x1F81, 0, &count, &obdSize);
+    if ((ret == kErrorObdIndexNotExist) || (ret == kErrorObdSubindexNotExist))
+        return kErrorOk;
+    else if (ret != kErrorOk)
+        return ret;
+
+    for (index = 1; index <= count; index++)
+    {
+        obdSize = sizeof(nodeCfg);
+        ret = obd_readEntry(0x1F81, index, &nodeCfg, &obdSize);
+        if (ret == kErrorObdSubindexNotExist)
+        {   // not all subindexes of object 0x1F81 have to exist
+            continue;
+        }
+        else if (ret != kErrorOk)
+        {
+            return ret;
+        }
+
+        if ((nodeCfg & (NMT_NODEASSIGN_NODE_EXISTS | NMT_NODEASSIGN_NODE_IS_CN |
+                        NMT_NODEASSIGN_ASYNCONLY_NODE | NMT_NODEASSIGN_PRES_CHAINING)) !=
+            (NMT_NODEASSIGN_NODE_EXISTS | NMT_NODEASSIGN_NODE_IS_CN))
+        {   // node is not polled by a PReq in the isochronous phase
+            continue;
+        }
+
+        ret = calcNodeTime(index, &timeNs);
+        if (ret != kErrorOk)
+            return ret;
+
+        if ((multiplCycleCnt == 0) || ((nodeCfg & NMT_NODEASSIGN_MULTIPLEXED_CN) == 0))
+        {   // node is polled in every cycle
+            pReport->continuousNodeCount++;
+            pReport->continuousTimeNs += timeNs;
+            continue;
+        }
+
+        // insert node into the list sorted by decreasing time
+        for (pos = nodeCount; (pos > 0) && (instance_l.aNode[pos - 1].timeNs < timeNs); pos--)
+        {
+            instance_l.aNode[pos] = instance_l.aNode[pos - 1];
+        }
+        instance_l.aNode[pos].nodeId = index;
+        instance_l.aNode[pos].timeNs = timeNs;
+        nodeCount++;
+    }
+
+    // assign each node to the multiplexed cycle with the lowest load
+    for (pos = 0; pos < nodeCount; pos++)
+    {
+        cycle = 0;
+        for (index = 1; index < multiplCycleCnt; index++)
+        {
+            if (pReport->aCycleTimeNs[index] < pReport->aCycleTimeNs[cycle])
+                cycle = index;
+        }
+
+        pReport->aCycleTimeNs[cycle] += instance_l.aNode[pos].timeNs;
+        pReport->aCycleNodeCount[cycle]++;
+        if (pReport->aCycleTimeNs[cycle] > maxCycleTimeNs)
+            maxCycleTimeNs = pReport->aCycleTimeNs[cycle];
+
+        cycleAssign = (UINT8)(cycle + 1);
+        ret = obd_writeEntry(0x1F9B, instance_l.aNode[pos].nodeId, &cycleAssign, sizeof(cycleAssign));
+        if (ret != kErrorOk)
+            return ret;
+
+        DEBUG_LVL_NMTMN_TRACE("Multiplex: CN %3u -> cycle %3u (%lu ns)\n",
+                              instance_l.aNode[pos].nodeId, cycleAssign,
+                              (ULONG)instance_l.aNode[pos].timeNs);
+    }
+
+    pReport->multiplCycleCnt = multiplCycleCnt;
+    pReport->multiplexedNodeCount = nodeCount;
+    pReport->isochrPhaseNs = pReport->continuousTimeNs + maxCycleTimeNs;
+    pReport->fValid = TRUE;
+
+    DEBUG_LVL_NMTMN_TRACE("Multiplex: %u continuous CNs (%lu ns), %u multiplexed CNs in %u cycles, isochronous phase %lu ns\n",
+                          pReport->continuousNodeCount, (ULONG)pReport->continuousTimeNs,
+                          nodeCount, multiplCycleCnt, (ULONG)pReport->isochrPhaseNs);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get multiplexed cycle report
+
+The function copies the report of the last computed multiplexed cycle
+assignment.
+
+\param  pReport_p           Pointer to store the report.
+
+\return The function returns a tOplkError error code.
+\retval kErrorInvalidOperation  No assignment was computed yet.
+
+\ingroup module_multiplexu
+*/
+//------------------------------------------------------------------------------
+tOplkError multiplexu_getReport(tMultiplexReport* pReport_p)
+{
+    OPLK_MEMCPY(pReport_p, &instance_l.report, sizeof(tMultiplexReport));
+
+    return (instance_l.report.fValid) ? kErrorOk : kErrorInvalidOperation;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Calculate isochronous time of a CN
+
+The function calculates the time the PReq and the PRes of a CN occupy in the
+isochronous phase.
+
+\param  nodeId_p            Node ID of the CN.
+\param  pTimeNs_p           Pointer to store the time in [ns].
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError calcNodeTime(UINT nodeId_p, UINT32* pTimeNs_p)
+{
+    tOplkError      ret;
+    tObdSize        obdSize;
+    UINT16          preqPayloadLimit = 0;
+    UINT16          presPayloadLimit = 0;
+    UINT32          latencyNs = 0;
+    UINT32          responseTimeNs;
+    tIdentResponse* pIdentResponse;
+
+    obdSize = sizeof(preqPayloadLimit);
+    ret = obd_readEntry(0x1F8B, nodeId_p, &preqPayloadLimit, &obdSize);
+    if ((ret != kErrorOk) && (ret != kErrorObdIndexNotExist) && (ret != kErrorObdSubindexNotExist))
+        return ret;
+
+    obdSize = sizeof(presPayloadLimit);
+    ret = obd_readEntry(0x1F8D, nodeId_p, &presPayloadLimit, &obdSize);
+    if ((ret != kErrorOk) && (ret != kErrorObdIndexNotExist) && (ret != kErrorObdSubindexNotExist))
+        return ret;
+
+    obdSize = sizeof(latencyNs);
+    ret = obd_readEntry(0x1F92, nodeId_p, &latencyNs, &obdSize);
+    if ((ret != kErrorOk) && (ret != kErrorObdIndexNotExist) && (ret != kErrorObdSubindexNotExist))
+        return ret;
+
+    if (identu_getIdentResponse(nodeId_p, &pIdentResponse) == kErrorOk)
+    {   // use the response time reported by the CN if it is shorter
+        responseTimeNs = ami_getUint32Le(&pIdentResponse->responseTimeLe);
+        if ((responseTimeNs != 0) && ((latencyNs == 0) || (responseTimeNs < latencyNs)))
+            latencyNs = responseTimeNs;
+    }
+
+    *pTimeNs_p = calcFrameTime(preqPayloadLimit) + calcFrameTime(presPayloadLimit) + latencyNs;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Calculate transmission time of a PReq or PRes
+
+\param  payload_p           Payload size of the frame.
+
+\return The function returns the transmission time in [ns].
+*/
+//------------------------------------------------------------------------------
+static UINT32 calcFrameTime(UINT16 payload_p)
+{
+    UINT    frameSize;
+
+    frameSize = PLK_FRAME_OFFSET_PDO_PAYLOAD + payload_p;
+    if (frameSize < C_DLL_MINSIZE_PRES)
+        frameSize = C_DLL_MINSIZE_PRES;
+
+    return MULTIPLEXU_FRAME_TIME_NS(frameSize);
+}
+
+///\}
+
+#endif /* defined(CONFIG_INCLUDE_NMT_MN) && (CONFIG_NMTMNU_MULTIPLEX_SCHEDULE != FALSE) */
@@ -46,6 +46,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <user/statusu.h>
 #include <user/dllucal.h>
 #include <common/ami.h>
+#include <common/nodeset.h>
+#include <common/target.h>
 #include <oplk/benchmark.h>
 #include <oplk/obd.h>
 #include <user/syncu.h>
@@ -77,6 +79,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // const defines
 //------------------------------------------------------------------------------
 
+#ifndef CONFIG_NMTMNU_PIPELINED_BOOT
+#define CONFIG_NMTMNU_PIPELINED_BOOT            FALSE   // advance CNs independently and wait only for mandatory CNs
+#endif
+
 // TracePoint support for realtime-debugging
 #ifdef _DBG_TRACE_POINTS_
     void TgtDbgSignalTracePoint (UINT8 bTracePointNumber_p);
@@ -87,6 +93,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     #define TGT_DBG_SIGNAL_TRACE_POINT(p)
     #define TGT_DBG_POST_TRACE_VALUE(v)
 #endif
+
+// offset between a plain NMT state command and its extended variant
+#define NMTMNU_EXT_CMD_OFFSET                   (NMT_EXT_COMMAND_START - NMT_PLAIN_COMMAND_START)
+
 #define NMTMNU_DBG_POST_TRACE_VALUE(Event_p, uiNodeId_p, wErrorCode_p) \
     TGT_DBG_POST_TRACE_VALUE((kEventSinkNmtMnu << 28) | (Event_p << 24) \
                              | (uiNodeId_p << 16) | wErrorCode_p)
@@ -97,6 +107,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define NMTMNU_NODE_FLAG_HALTED                 0x0004  // boot process for this CN is halted
 #define NMTMNU_NODE_FLAG_NMT_CMD_ISSUED         0x0008  // NMT command was just issued, wrong NMT states will be tolerated
 #define NMTMNU_NODE_FLAG_PREOP2_REACHED         0x0010  // NodeAddIsochronous has been called, waiting for ISOCHRON
+#define NMTMNU_NODE_FLAG_CHECKCOM_EARLY         0x0020  // CheckCom was started before the MN entered ReadyToOp
 #define NMTMNU_NODE_FLAG_COUNT_STATREQ          0x0300  // counter for StatusRequest timer handle
 #define NMTMNU_NODE_FLAG_COUNT_LONGER           0x0C00  // counter for longer timeouts timer handle
 #define NMTMNU_NODE_FLAG_INC_STATREQ            0x0100  // increment for StatusRequest timer handle
@@ -128,6 +139,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define NMTMNU_TIMERARG_STATREQ                 0x00020000L // timer event is for StatusRequest
 #define NMTMNU_TIMERARG_LONGER                  0x00040000L // timer event is for longer timeouts
 #define NMTMNU_TIMERARG_STATE_MON               0x00080000L // timer event for StatusRequest to monitor execution of NMT state changes
+#define NMTMNU_TIMERARG_TICK                    0x00100000L // timer event for the supervisor tick of the node timers
 #define NMTMNU_TIMERARG_COUNT_SR                0x00000300L // counter for StatusRequest
 #define NMTMNU_TIMERARG_COUNT_LO                0x00000C00L // counter for longer timeouts
 // The counters must have the same position as in the node flags above.
@@ -176,17 +188,28 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // d.k. may be replaced by special (hash) function if node ID array is smaller than 254
 #define NMTMNU_GET_NODEINFO(nodeId_p) (&nmtMnuInstance_g.aNodeInfo[nodeId_p - 1])
 
+// Every internal node state except kNmtMnuNodeStateUnknown has a node set of the
+// CNs currently in it, so boot step scans only visit the nodes concerned.
+#define NMTMNU_NODE_STATE_COUNT                 (kNmtMnuNodeStateOperational + 1)
+
+// The MN waits for all signaled CNs before it advances its own NMT state.
+// In pipelined boot mode optional CNs follow on their own and never hold the
+// mandatory CNs back.
+#if (CONFIG_NMTMNU_PIPELINED_BOOT != FALSE)
+#define NMTMNU_NODE_IS_SIGNALED(pNodeInfo_p)    (((pNodeInfo_p)->nodeCfg & NMT_NODEASSIGN_MANDATORY_CN) != 0)
+#else
+#define NMTMNU_NODE_IS_SIGNALED(pNodeInfo_p)    TRUE
+#endif
+
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
 
 typedef struct
 {
-    UINT8               cmdData;
-    UINT                cmdDataId;
-    UINT                nodeIdCnt;
-    UINT8               nodeIdMask;
-    UINT                nodeId;
+    BOOL                fNodeSetValid;      ///< Node set of the node list is set up
+    tNodeSet            nodeSet;            ///< Node IDs of the node list
+    UINT                nodeId;             ///< Last returned node ID
 } tNmtMnuGetNodeId;
 
 /**
@@ -235,6 +258,21 @@ typedef enum
     kNmtMnuNodeStateOperational             = 0x07, // CN is in NMT state OPERATIONAL
 } tNmtMnuNodeState;
 
+#if (CONFIG_NMTMNU_SUPERVISOR_TICK_MS != 0)
+/**
+* \brief Node timer
+*
+* The node timers are deadlines which are checked by the supervisor tick.
+*/
+typedef struct
+{
+    UINT32              deadline;               ///< Tick count in [ms] when the timer expires
+    UINT32              argument;               ///< Timer argument (NMTMNU_TIMERARG_xxx, 0 = timer inactive)
+} tNmtMnuNodeTimer;
+#else
+typedef tTimerHdl tNmtMnuNodeTimer;
+#endif
+
 typedef INT (*tProcessNodeEventFunc)(UINT nodeId_p, tNmtState nodeNmtState_p,
                                      tNmtState nmtState_p, UINT16 errorCode_p,
                                      tOplkError* pRet_p);
@@ -246,14 +284,20 @@ typedef INT (*tProcessNodeEventFunc)(UINT nodeId_p, tNmtState nodeNmtState_p,
 */
 typedef struct
 {
-    tTimerHdl           timerHdlStatReq;        ///< Timer to delay StatusRequests and IdentRequests
-    tTimerHdl           timerHdlLonger;         ///< 2nd timer for NMT command EnableReadyToOp and CheckCommunication
+    tNmtMnuNodeTimer    timerHdlStatReq;        ///< Timer to delay StatusRequests and IdentRequests
+    tNmtMnuNodeTimer    timerHdlLonger;         ///< 2nd timer for NMT command EnableReadyToOp and CheckCommunication
     tNmtMnuNodeState    nodeState;              ///< Internal node state (kind of sub state of NMT state)
     UINT32              nodeCfg;                ///< Subindex from 0x1F81
     UINT16              flags;                  ///< Node flags (see node flag defines)
     UINT16              prcFlags;               ///< PRC specific node flags
     UINT32              relPropagationDelayNs;  ///< Propagation delay in nanoseconds
     UINT32              pResTimeFirstNs;        ///< PRes time
+#if (CONFIG_NMTMNU_IDENTREQ_BACKOFF_MAX_MS != 0)
+    ULONG               identReqDelay;          ///< Delay of the next IdentRequest in [ms] (0 = statusRequestDelay)
+#endif
+#if (CONFIG_NMTMNU_STATREQ_RELAX_MAX_MS != 0)
+    ULONG               statReqDelay;           ///< Delay of the next StatusRequest in [ms] (0 = statusRequestDelay)
+#endif
 } tNmtMnuNodeInfo;
 
 /**
@@ -264,6 +308,7 @@ typedef struct
 typedef struct
 {
     tNmtMnuNodeInfo     aNodeInfo[NMT_MAX_NODE_ID];     ///< Information about CNs
+    tNodeSet            aNodeStateSet[NMTMNU_NODE_STATE_COUNT];  ///< Node sets of CNs per internal node state
     tTimerHdl           timerHdlNmtState;               ///< Timeout for stay in NMT state
     UINT                mandatorySlaveCount;            ///< Count of found mandatory CNs
     UINT                signalSlaveCount;               ///< Count of CNs which are not identified
@@ -277,6 +322,20 @@ typedef struct
     UINT32              prcPResMnTimeoutNs;             ///< to be commented!
     UINT32              prcPResTimeFirstCorrectionNs;   ///< to be commented!
     UINT32              prcPResTimeFirstNegOffsetNs;    ///< to be commented!
+#if (CONFIG_NMTMNU_IDENTREQ_BACKOFF_MAX_MS != 0)
+    tNodeSet            identBackoffSet;                ///< Optional CNs with a backed off IdentRequest interval
+#endif
+#if (CONFIG_NMTMNU_SUPERVISOR_TICK_MS != 0)
+    tTimerHdl           timerHdlTick;                   ///< Timer of the supervisor tick
+    BOOL                fTickActive;                    ///< Supervisor tick timer is running
+    tNodeSet            activeTimerSet;                 ///< CNs which may have an active node timer
+#endif
+#if (CONFIG_NMTMNU_COALESCE_NMT_CMD != FALSE)
+    tNodeSet            nmtExtSet;                      ///< CNs which support extended NMT commands
+    tNodeSet            coalesceSet;                    ///< CNs of the pending coalesced NMT command
+    tNmtCommand         coalesceCmd;                    ///< Pending coalesced extended NMT command
+    UINT                coalesceDepth;                  ///< Nesting depth of NMT command batches
+#endif
 } tNmtMnuInstance;
 
 //------------------------------------------------------------------------------
@@ -307,6 +366,15 @@ static tOplkError doPreop1(tEventNmtStateChange nmtStateChange_p);
 static tOplkError processInternalEvent(UINT nodeId_p, tNmtState nodeNmtState_p,
                                        UINT16 errorCode_p, tNmtMnuIntNodeEvent nodeEvent_p);
 static tOplkError reset(void);
+static tOplkError processNodeTimer(UINT32 timerArg_p);
+static tOplkError modifyNodeTimer(tNmtMnuNodeTimer* pTimer_p, ULONG timeInMs_p, tTimerArg argument_p);
+static tOplkError deleteNodeTimer(tNmtMnuNodeTimer* pTimer_p);
+#if (CONFIG_NMTMNU_SUPERVISOR_TICK_MS != 0)
+static tOplkError processSupervisorTick(void);
+#endif
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+static tOplkError processLinkUp(void);
+#endif
 
 static tOplkError prcMeasure(void);
 static tOplkError prcCalculate(UINT nodeIdFirstNode_p);
@@ -334,6 +402,14 @@ static tOplkError prcHandleNmtReset(UINT nodeId_p, tNmtCommand nmtCommand_p,
 
 static tOplkError sendNmtCommand(UINT nodeId_p, tNmtCommand nmtCommand_p,
                                  UINT8* pNmtCommandData_p, UINT dataSize_p);
+static tOplkError sendNmtCommandFrame(UINT nodeId_p, tNmtCommand nmtCommand_p,
+                                      UINT8* pNmtCommandData_p, UINT dataSize_p);
+#if (CONFIG_NMTMNU_COALESCE_NMT_CMD != FALSE)
+static BOOL       isCoalescable(UINT nodeId_p, tNmtCommand nmtCommand_p, UINT dataSize_p);
+static tOplkError flushNmtCommand(void);
+#endif
+static void       beginNmtCommandBatch(void);
+static tOplkError endNmtCommandBatch(void);
 
 static tOplkError getNodeIdFromCmd(UINT nodeId_p, tNmtCommand nmtCommand_p, UINT8* pCmdData_p,
                                    tNmtMnuGetNodeId* pOp_p, UINT* pNodeId_p);
@@ -341,6 +417,15 @@ static tOplkError nodeListToNodeId(UINT8* pCmdData_p, tNmtMnuGetNodeId* pOp_p, U
 static tOplkError removeNodeIdFromExtCmd(UINT nodeId_p, UINT8* pCmdData_p, UINT size_p);
 
 static ULONG      computeCeilDiv(ULONG numerator_p, ULONG denominator_p);
+static void       setNodeState(tNmtMnuNodeInfo* pNodeInfo_p, tNmtMnuNodeState nodeState_p);
+static UINT       getNextNodeInState(tNmtMnuNodeState nodeState_p, UINT nodeId_p);
+#if (CONFIG_NMTMNU_IDENTREQ_BACKOFF_MAX_MS != 0)
+static ULONG      getIdentReqDelay(UINT nodeId_p, tNmtMnuNodeInfo* pNodeInfo_p);
+static tOplkError resetIdentReqBackoff(UINT nodeId_p, tNmtMnuNodeInfo* pNodeInfo_p);
+#endif
+#if (CONFIG_NMTMNU_STATREQ_RELAX_MAX_MS != 0)
+static ULONG      getStatReqDelay(tNmtMnuNodeInfo* pNodeInfo_p, BOOL fHealthy_p);
+#endif
 
 /* internal node event handler functions */
 static INT processNodeEventNoIdentResponse (UINT nodeId_p, tNmtState nodeNmtState_p,
@@ -1015,6 +1100,10 @@ The function implements the callback function for NMT events.
 tOplkError nmtmnu_processEvent(tEvent* pEvent_p)
 {
     tOplkError      ret = kErrorOk;
+    tOplkError      batchRet;
+
+    // NMT commands which are issued while processing the event are coalesced
+    beginNmtCommandBatch();
 
     // process event
     switch (pEvent_p->eventType)
@@ -1028,99 +1117,14 @@ tOplkError nmtmnu_processEvent(tEvent* pEvent_p)
                 nodeId = (UINT)(pTimerEventArg->argument.value & NMTMNU_TIMERARG_NODE_MASK);
                 if (nodeId != 0)
                 {
-                    tObdSize             ObdSize;
-                    UINT8                bNmtState;
-                    tNmtMnuNodeInfo*     pNodeInfo;
-
-                    pNodeInfo = NMTMNU_GET_NODEINFO(nodeId);
-                    ObdSize = 1;
-                    ret = obd_readEntry(0x1F8E, nodeId, &bNmtState, &ObdSize);
-                    if (ret != kErrorOk)
-                        break;
-
-                    if ((pTimerEventArg->argument.value & NMTMNU_TIMERARG_IDENTREQ) != 0L)
-                    {
-                        if ((UINT32)(pNodeInfo->flags & NMTMNU_NODE_FLAG_COUNT_STATREQ) !=
-                            (pTimerEventArg->argument.value & NMTMNU_TIMERARG_COUNT_SR))
-                        {   // this is an old (already deleted or modified) timer
-                            // but not the current timer
-                            // so discard it
-                            NMTMNU_DBG_POST_TRACE_VALUE(kNmtMnuIntNodeEventTimerIdentReq,
-                                                        nodeId, ((pNodeInfo->nodeState << 8) | 0xFF));
-
-                            break;
-                        }
-                        /*NMTMNU_DBG_POST_TRACE_VALUE(kNmtMnuIntNodeEventTimerIdentReq, uiNodeId,
-                                                        ((pNodeInfo->nodeState << 8) | 0x80
-                                                         | ((pNodeInfo->flags & NMTMNU_NODE_FLAG_COUNT_STATREQ) >> 6)
-                                                         | ((pTimerEventArg->argument.value & NMTMNU_TIMERARG_COUNT_SR) >> 8)));*/
-                        ret = processInternalEvent(nodeId, (tNmtState) (bNmtState | NMT_TYPE_CS),
-                                                   E_NO_ERROR, kNmtMnuIntNodeEventTimerIdentReq);
-                    }
-
-                    else if ((pTimerEventArg->argument.value & NMTMNU_TIMERARG_STATREQ) != 0L)
-                    {
-                        if ((UINT32)(pNodeInfo->flags & NMTMNU_NODE_FLAG_COUNT_STATREQ)
-                            != (pTimerEventArg->argument.value & NMTMNU_TIMERARG_COUNT_SR))
-                        {   // this is an old (already deleted or modified) timer
-                            // but not the current timer
-                            // so discard it
-                            NMTMNU_DBG_POST_TRACE_VALUE(kNmtMnuIntNodeEventTimerStatReq,
-                                                        nodeId, ((pNodeInfo->nodeState << 8) | 0xFF));
-
-                            break;
-                        }
-                        /* NMTMNU_DBG_POST_TRACE_VALUE(kNmtMnuIntNodeEventTimerStatReq, uiNodeId,
-                                                        ((pNodeInfo->nodeState << 8) | 0x80
-                                                         | ((pNodeInfo->flags & NMTMNU_NODE_FLAG_COUNT_STATREQ) >> 6)
-                                                         | ((pTimerEventArg->argument.value & NMTMNU_TIMERARG_COUNT_SR) >> 8))); */
-                        ret = processInternalEvent(nodeId, (tNmtState) (bNmtState | NMT_TYPE_CS),
-                                                   E_NO_ERROR, kNmtMnuIntNodeEventTimerStatReq);
-                    }
-
-                    else if ((pTimerEventArg->argument.value & NMTMNU_TIMERARG_STATE_MON) != 0L)
-                    {
-                        if ((UINT32)(pNodeInfo->flags & NMTMNU_NODE_FLAG_COUNT_STATREQ)
-                            != (pTimerEventArg->argument.value & NMTMNU_TIMERARG_COUNT_SR))
-                        {   // this is an old (already deleted or modified) timer
-                            // but not the current timer
-                            // so discard it
-                            NMTMNU_DBG_POST_TRACE_VALUE(kNmtMnuIntNodeEventTimerStateMon,
-                                                        nodeId, ((pNodeInfo->nodeState << 8) | 0xFF));
-
-                            break;
-                        }
-                        /* NMTMNU_DBG_POST_TRACE_VALUE(kNmtMnuIntNodeEventTimerStatReq, uiNodeId,
-                                                        ((pNodeInfo->nodeState << 8) | 0x80
-                                                         | ((pNodeInfo->flags & NMTMNU_NODE_FLAG_COUNT_STATREQ) >> 6)
-                                                         | ((pTimerEventArg->argument.value & NMTMNU_TIMERARG_COUNT_SR) >> 8))); */
-                        ret = processInternalEvent(nodeId, (tNmtState) (bNmtState | NMT_TYPE_CS),
-                                                   E_NO_ERROR, kNmtMnuIntNodeEventTimerStateMon);
-                    }
-
-                    else if ((pTimerEventArg->argument.value & NMTMNU_TIMERARG_LONGER) != 0L)
-                    {
-                        if ((UINT32)(pNodeInfo->flags & NMTMNU_NODE_FLAG_COUNT_LONGER)
-                            != (pTimerEventArg->argument.value & NMTMNU_TIMERARG_COUNT_LO))
-                        {   // this is an old (already deleted or modified) timer
-                            // but not the current timer
-                            // so discard it
-                            NMTMNU_DBG_POST_TRACE_VALUE(kNmtMnuIntNodeEventTimerLonger, nodeId,
-                                                        ((pNodeInfo->nodeState << 8) | 0xFF));
-
-                            break;
-                        }
-                        /* NMTMNU_DBG_POST_TRACE_VALUE(kNmtMnuIntNodeEventTimerLonger, uiNodeId,
-                                                        ((pNodeInfo->nodeState << 8) | 0x80
-                                                         | ((pNodeInfo->flags & NMTMNU_NODE_FLAG_COUNT_LONGER) >> 6)
-                                                         | ((pTimerEventArg->argument.value & NMTMNU_TIMERARG_COUNT_LO) >> 8))); */
-                        ret = processInternalEvent(nodeId, (tNmtState) (bNmtState | NMT_TYPE_CS),
-                                                   E_NO_ERROR, kNmtMnuIntNodeEventTimerLonger);
-                    }
-
+                    ret = processNodeTimer((UINT32)pTimerEventArg->argument.value);
                 }
                 else
                 {   // global timer event
+#if (CONFIG_NMTMNU_SUPERVISOR_TICK_MS != 0)
+                    if (pTimerEventArg->argument.value == NMTMNU_TIMERARG_TICK)
+                        ret = processSupervisorTick();
+#endif
                 }
             }
             break;
@@ -1312,12 +1316,22 @@ tOplkError nmtmnu_processEvent(tEvent* pEvent_p)
             }
             break;
 
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+        case kEventTypeNmtMnuLinkUp:
+            ret = processLinkUp();
+            break;
+#endif
+
         default:
             ret = kErrorNmtInvalidEvent;
             break;
     }
 
 Exit:
+    batchRet = endNmtCommandBatch();
+    if (ret == kErrorOk)
+        ret = batchRet;
+
     return ret;
 }
 
@@ -1440,6 +1454,14 @@ static tOplkError cbIdentResponse(UINT nodeId_p, tIdentResponse* pIdentResponse_
         errorCode = E_NO_ERROR;
         nmtState = (tNmtState)(ami_getUint8Le(&pIdentResponse_p->nmtStatus) | NMT_TYPE_CS);
 
+#if (CONFIG_NMTMNU_COALESCE_NMT_CMD != FALSE)
+        // only CNs which support extended NMT commands receive coalesced commands
+        if ((ami_getUint32Le(&pIdentResponse_p->featureFlagsLe) & PLK_FEATURE_NMT_EXT) != 0)
+            NODESET_ADD(&nmtMnuInstance_g.nmtExtSet, nodeId_p);
+        else
+            NODESET_REMOVE(&nmtMnuInstance_g.nmtExtSet, nodeId_p);
+#endif
+
         // check IdentResponse $$$ move to ProcessIntern, because this function may be called also if CN
 
         // check DeviceType (0x1F84)
@@ -1677,14 +1699,24 @@ static tOplkError startBootStep1(BOOL fNmtResetAllIssued_p)
 
         if (subIndex != localNodeId)
         {
-            // reset flags "not scanned" and "isochronous"
-            pNodeInfo->flags &= ~(NMTMNU_NODE_FLAG_ISOCHRON | NMTMNU_NODE_FLAG_NOT_SCANNED);
+            // reset flags "not scanned", "isochronous" and "early CheckCom"
+            pNodeInfo->flags &= ~(NMTMNU_NODE_FLAG_ISOCHRON | NMTMNU_NODE_FLAG_NOT_SCANNED |
+                                  NMTMNU_NODE_FLAG_CHECKCOM_EARLY);
 
             // Reset all PRC flags and PRC related values
             pNodeInfo->prcFlags = 0;
             pNodeInfo->pResTimeFirstNs = 0;
             pNodeInfo->relPropagationDelayNs = 0;
 
+            // restart with the fixed request interval
+#if (CONFIG_NMTMNU_IDENTREQ_BACKOFF_MAX_MS != 0)
+            pNodeInfo->identReqDelay = 0;
+            NODESET_REMOVE(&nmtMnuInstance_g.identBackoffSet, subIndex);
+#endif
+#if (CONFIG_NMTMNU_STATREQ_RELAX_MAX_MS != 0)
+            pNodeInfo->statReqDelay = 0;
+#endif
+
             if (subIndex == C_ADR_DIAG_DEF_NODE_ID)
             {   // diagnostic node must be scanned by MN in any case
                 nodeCfg |= (NMT_NODEASSIGN_NODE_IS_CN | NMT_NODEASSIGN_NODE_EXISTS);
@@ -1694,11 +1726,11 @@ static tOplkError startBootStep1(BOOL fNmtResetAllIssued_p)
 
             // save node config in local node info structure
             pNodeInfo->nodeCfg = nodeCfg;
-            pNodeInfo->nodeState = kNmtMnuNodeStateUnknown;
+            setNodeState(pNodeInfo, kNmtMnuNodeStateUnknown);
 
             if ((nodeCfg & (NMT_NODEASSIGN_NODE_IS_CN | NMT_NODEASSIGN_NODE_EXISTS)) != 0)
             {   // node is configured as CN
-                if (fNmtResetAllIssued_p == FALSE)
+                if ((fNmtResetAllIssued_p == FALSE) && NMTMNU_NODE_IS_SIGNALED(pNodeInfo))
                 {
                     // identify the node
                     ret = identu_requestIdentResponse(subIndex, cbIdentResponse);
@@ -1706,10 +1738,13 @@ static tOplkError startBootStep1(BOOL fNmtResetAllIssued_p)
                         goto Exit;
                 }
 
-                // set flag "not scanned"
-                pNodeInfo->flags |= NMTMNU_NODE_FLAG_NOT_SCANNED;
-                nmtMnuInstance_g.signalSlaveCount++;
-                // signal slave counter shall be decremented if IdentRequest was sent once to a CN
+                if (NMTMNU_NODE_IS_SIGNALED(pNodeInfo))
+                {
+                    // set flag "not scanned"
+                    pNodeInfo->flags |= NMTMNU_NODE_FLAG_NOT_SCANNED;
+                    nmtMnuInstance_g.signalSlaveCount++;
+                    // signal slave counter shall be decremented if IdentRequest was sent once to a CN
+                }
 
                 if ((nodeCfg & NMT_NODEASSIGN_MANDATORY_CN) != 0)
                 {   // node is a mandatory CN
@@ -1729,9 +1764,27 @@ static tOplkError startBootStep1(BOOL fNmtResetAllIssued_p)
 
     for (; subIndex <= tabentries(nmtMnuInstance_g.aNodeInfo); subIndex++, pNodeInfo++)
     {   // clear node structure of unused entries
+        setNodeState(pNodeInfo, kNmtMnuNodeStateUnknown);
         OPLK_MEMSET(pNodeInfo, 0, sizeof(*pNodeInfo));
     }
 
+#if (CONFIG_NMTMNU_PIPELINED_BOOT != FALSE)
+    if (fNmtResetAllIssued_p == FALSE)
+    {   // identify optional CNs after all mandatory CNs have been queued
+        pNodeInfo = nmtMnuInstance_g.aNodeInfo;
+        for (subIndex = 1; subIndex <= count; subIndex++, pNodeInfo++)
+        {
+            if ((subIndex == localNodeId) || NMTMNU_NODE_IS_SIGNALED(pNodeInfo) ||
+                ((pNodeInfo->nodeCfg & (NMT_NODEASSIGN_NODE_IS_CN | NMT_NODEASSIGN_NODE_EXISTS)) == 0))
+                continue;
+
+            ret = identu_requestIdentResponse(subIndex, cbIdentResponse);
+            if (ret != kErrorOk)
+                goto Exit;
+        }
+    }
+#endif
+
 Exit:
     return ret;
 }
@@ -1874,8 +1927,8 @@ static tOplkError startBootStep2(void)
             // set NMT state change flag
             pNodeInfo->flags |= NMTMNU_NODE_FLAG_NMT_CMD_ISSUED;
 
-            ret = timeru_modifyTimer(&pNodeInfo->timerHdlStatReq,
-                                     nmtMnuInstance_g.statusRequestDelay, timerArg);
+            ret = modifyNodeTimer(&pNodeInfo->timerHdlStatReq,
+                                  nmtMnuInstance_g.statusRequestDelay, timerArg);
             if (ret != kErrorOk)
                 goto Exit;
 
@@ -1886,7 +1939,8 @@ static tOplkError startBootStep2(void)
                 goto Exit;
 
             if ((pNodeInfo->nodeState == kNmtMnuNodeStateConfigured) &&
-                ((nmtMnuInstance_g.flags & NMTMNU_FLAG_HALTED) == 0))
+                ((nmtMnuInstance_g.flags & NMTMNU_FLAG_HALTED) == 0) &&
+                NMTMNU_NODE_IS_SIGNALED(pNodeInfo))
             {   // boot process is not halted
                 // set flag "not scanned"
                 pNodeInfo->flags |= NMTMNU_NODE_FLAG_NOT_SCANNED;
@@ -1965,8 +2019,8 @@ static tOplkError nodeBootStep2(UINT nodeId_p, tNmtMnuNodeInfo* pNodeInfo_p)
     {   // start timer
         // when the timer expires the CN must be ReadyToOp
         NMTMNU_SET_FLAGS_TIMERARG_LONGER(pNodeInfo_p, nodeId_p, timerArg);
-        ret = timeru_modifyTimer(&pNodeInfo_p->timerHdlLonger,
-                                 nmtMnuInstance_g.timeoutReadyToOp, timerArg);
+        ret = modifyNodeTimer(&pNodeInfo_p->timerHdlLonger,
+                              nmtMnuInstance_g.timeoutReadyToOp, timerArg);
     }
 Exit:
     return ret;
@@ -1995,33 +2049,42 @@ static tOplkError startCheckCom(void)
         // reset flag that application was informed about possible state change
         nmtMnuInstance_g.flags &= ~NMTMNU_FLAG_APP_INFORMED;
 
-        pNodeInfo = nmtMnuInstance_g.aNodeInfo;
-        for (index = 1; index <= tabentries(nmtMnuInstance_g.aNodeInfo); index++, pNodeInfo++)
+        for (index = getNextNodeInState(kNmtMnuNodeStateReadyToOp, 0); index != C_ADR_INVALID;
+             index = getNextNodeInState(kNmtMnuNodeStateReadyToOp, index))
         {
-            if (pNodeInfo->nodeState == kNmtMnuNodeStateReadyToOp)
+            pNodeInfo = NMTMNU_GET_NODEINFO(index);
+            if ((pNodeInfo->flags & NMTMNU_NODE_FLAG_CHECKCOM_EARLY) != 0)
+            {   // CheckCom is already running since PreOp2, keep its timer
+                ret = kErrorReject;
+            }
+            else
             {
                 ret = nodeCheckCom(index, pNodeInfo);
-                if (ret == kErrorReject)
-                {   // timer was started
-                    // wait until it expires
-                    if ((pNodeInfo->nodeCfg & NMT_NODEASSIGN_MANDATORY_CN) != 0)
-                    {   // node is a mandatory CN
-                        nmtMnuInstance_g.mandatorySlaveCount++;
-                    }
-                }
-                else
-                {
-                    if (ret != kErrorOk)
-                        goto Exit;
+            }
+
+            if (ret == kErrorReject)
+            {   // timer was started
+                // wait until it expires
+                if ((pNodeInfo->nodeCfg & NMT_NODEASSIGN_MANDATORY_CN) != 0)
+                {   // node is a mandatory CN
+                    nmtMnuInstance_g.mandatorySlaveCount++;
                 }
+            }
+            else
+            {
+                if (ret != kErrorOk)
+                    goto Exit;
+            }
 
-                // set flag "not scanned"
-                pNodeInfo->flags |= NMTMNU_NODE_FLAG_NOT_SCANNED;
+            if (!NMTMNU_NODE_IS_SIGNALED(pNodeInfo))
+                continue;
 
-                nmtMnuInstance_g.signalSlaveCount++;
-                // signal slave counter shall be decremented if timeout elapsed and regardless of an error
-                // mandatory slave counter shall be decremented if timeout elapsed and no error occurred
-            }
+            // set flag "not scanned"
+            pNodeInfo->flags |= NMTMNU_NODE_FLAG_NOT_SCANNED;
+
+            nmtMnuInstance_g.signalSlaveCount++;
+            // signal slave counter shall be decremented if timeout elapsed and regardless of an error
+            // mandatory slave counter shall be decremented if timeout elapsed and no error occurred
         }
     }
     ret = kErrorOk;
@@ -2058,8 +2121,8 @@ static tOplkError nodeCheckCom(UINT nodeId_p, tNmtMnuNodeInfo* pNodeInfo_p)
 
         // start timer (when the timer expires the CN must be still ReadyToOp)
         NMTMNU_SET_FLAGS_TIMERARG_LONGER(pNodeInfo_p, nodeId_p, timerArg);
-        ret = timeru_modifyTimer(&pNodeInfo_p->timerHdlLonger,
-                                 nmtMnuInstance_g.timeoutCheckCom, timerArg);
+        ret = modifyNodeTimer(&pNodeInfo_p->timerHdlLonger,
+                              nmtMnuInstance_g.timeoutCheckCom, timerArg);
 
         // update mandatory slave counter, because timer was started
         if (ret == kErrorOk)
@@ -2068,7 +2131,7 @@ static tOplkError nodeCheckCom(UINT nodeId_p, tNmtMnuNodeInfo* pNodeInfo_p)
     else
     {   // timer was not started
         // assume everything is OK
-        pNodeInfo_p->nodeState = kNmtMnuNodeStateComChecked;
+        setNodeState(pNodeInfo_p, kNmtMnuNodeStateComChecked);
     }
     return ret;
 }
@@ -2085,9 +2148,13 @@ The function starts all nodes which are ReadyToOp and CheckCom did not fail.
 static tOplkError startNodes(void)
 {
     tOplkError       ret = kErrorOk;
+    tOplkError       batchRet;
     UINT             index;
     tNmtMnuNodeInfo* pNodeInfo;
 
+    // the StartNode commands of all CNs are coalesced
+    beginNmtCommandBatch();
+
     if ((nmtMnuInstance_g.flags & NMTMNU_FLAG_HALTED) == 0)
     {   // boot process is not halted
         // send NMT command Start Node
@@ -2096,31 +2163,32 @@ static tOplkError startNodes(void)
         // reset flag that application was informed about possible state change
         nmtMnuInstance_g.flags &= ~NMTMNU_FLAG_APP_INFORMED;
 
-        pNodeInfo = nmtMnuInstance_g.aNodeInfo;
-        for (index = 1; index <= tabentries(nmtMnuInstance_g.aNodeInfo); index++, pNodeInfo++)
+        for (index = getNextNodeInState(kNmtMnuNodeStateComChecked, 0); index != C_ADR_INVALID;
+             index = getNextNodeInState(kNmtMnuNodeStateComChecked, index))
         {
-            if (pNodeInfo->nodeState == kNmtMnuNodeStateComChecked)
+            pNodeInfo = NMTMNU_GET_NODEINFO(index);
+            if ((nmtMnuInstance_g.nmtStartup & NMT_STARTUP_STARTALLNODES) == 0)
             {
-                if ((nmtMnuInstance_g.nmtStartup & NMT_STARTUP_STARTALLNODES) == 0)
-                {
-                    NMTMNU_DBG_POST_TRACE_VALUE(0, index, kNmtCmdStartNode);
-                    ret = nmtmnu_sendNmtCommand(index, kNmtCmdStartNode);
-                    if (ret != kErrorOk)
-                        goto Exit;
-                }
-
-                if ((pNodeInfo->nodeCfg & NMT_NODEASSIGN_MANDATORY_CN) != 0)
-                {   // node is a mandatory CN
-                    nmtMnuInstance_g.mandatorySlaveCount++;
-                }
+                NMTMNU_DBG_POST_TRACE_VALUE(0, index, kNmtCmdStartNode);
+                ret = nmtmnu_sendNmtCommand(index, kNmtCmdStartNode);
+                if (ret != kErrorOk)
+                    goto Exit;
+            }
 
-                // set flag "not scanned"
-                pNodeInfo->flags |= NMTMNU_NODE_FLAG_NOT_SCANNED;
+            if (!NMTMNU_NODE_IS_SIGNALED(pNodeInfo))
+                continue;
 
-                nmtMnuInstance_g.signalSlaveCount++;
-                // signal slave counter shall be decremented if StatusRequest was sent once to a CN
-                // mandatory slave counter shall be decremented if mandatory CN is OPERATIONAL
+            if ((pNodeInfo->nodeCfg & NMT_NODEASSIGN_MANDATORY_CN) != 0)
+            {   // node is a mandatory CN
+                nmtMnuInstance_g.mandatorySlaveCount++;
             }
+
+            // set flag "not scanned"
+            pNodeInfo->flags |= NMTMNU_NODE_FLAG_NOT_SCANNED;
+
+            nmtMnuInstance_g.signalSlaveCount++;
+            // signal slave counter shall be decremented if StatusRequest was sent once to a CN
+            // mandatory slave counter shall be decremented if mandatory CN is OPERATIONAL
         }
 
         // $$$ inform application if NMT_STARTUP_NO_STARTNODE is set
@@ -2134,6 +2202,10 @@ static tOplkError startNodes(void)
         }
     }
 Exit:
+    batchRet = endNmtCommandBatch();
+    if (ret == kErrorOk)
+        ret = batchRet;
+
     return ret;
 }
 
@@ -2163,15 +2235,22 @@ static INT processNodeEventIdentResponse(UINT nodeId_p, tNmtState nodeNmtState_p
 
     NMTMNU_DBG_POST_TRACE_VALUE(kNmtMnuIntNodeEventIdentResponse, nodeId_p, pNodeInfo->nodeState);
 
+#if (CONFIG_NMTMNU_IDENTREQ_BACKOFF_MAX_MS != 0)
+    *pRet_p = resetIdentReqBackoff(nodeId_p, pNodeInfo);
+    if (*pRet_p != kErrorOk)
+        return -1;
+#endif
+
     if ((pNodeInfo->nodeState != kNmtMnuNodeStateResetConf) &&
         (pNodeInfo->nodeState != kNmtMnuNodeStateConfRestored))
     {
-        pNodeInfo->nodeState = kNmtMnuNodeStateIdentified;
+        setNodeState(pNodeInfo, kNmtMnuNodeStateIdentified);
     }
 
     pNodeInfo->flags &= ~(NMTMNU_NODE_FLAG_ISOCHRON |
                           NMTMNU_NODE_FLAG_NMT_CMD_ISSUED |
-                          NMTMNU_NODE_FLAG_PREOP2_REACHED);
+                          NMTMNU_NODE_FLAG_PREOP2_REACHED |
+                          NMTMNU_NODE_FLAG_CHECKCOM_EARLY);
 
     if (nmtState_p == kNmtMsPreOperational1)
     {
@@ -2197,8 +2276,8 @@ static INT processNodeEventIdentResponse(UINT nodeId_p, tNmtState nodeNmtState_p
 
             NMTMNU_SET_FLAGS_TIMERARG_STATE_MON(pNodeInfo, nodeId_p, timerArg);
 
-            *pRet_p = timeru_modifyTimer(&pNodeInfo->timerHdlStatReq,
-                                         nmtMnuInstance_g.statusRequestDelay, timerArg);
+            *pRet_p = modifyNodeTimer(&pNodeInfo->timerHdlStatReq,
+                                      nmtMnuInstance_g.statusRequestDelay, timerArg);
             if (*pRet_p != kErrorOk)
                 return -1;
         }
@@ -2380,7 +2459,7 @@ static INT processNodeEventConfigured(UINT nodeId_p, tNmtState nodeNmtState_p, t
         return 0;
     }
 
-    pNodeInfo->nodeState = kNmtMnuNodeStateConfigured;
+    setNodeState(pNodeInfo, kNmtMnuNodeStateConfigured);
     if (nmtState_p == kNmtMsPreOperational1)
     {
         if ((pNodeInfo->nodeCfg & NMT_NODEASSIGN_MANDATORY_CN) != 0)
@@ -2431,7 +2510,7 @@ INT processNodeEventNoIdentResponse(UINT nodeId_p, tNmtState nodeNmtState_p, tNm
     if ((pNodeInfo->nodeState != kNmtMnuNodeStateResetConf) &&
         (pNodeInfo->nodeState != kNmtMnuNodeStateConfRestored))
     {
-        pNodeInfo->nodeState = kNmtMnuNodeStateUnknown;
+        setNodeState(pNodeInfo, kNmtMnuNodeStateUnknown);
     }
 
     // check NMT state of CN
@@ -2456,8 +2535,13 @@ INT processNodeEventNoIdentResponse(UINT nodeId_p, tNmtState nodeNmtState_p, tNm
                                        ((pNodeInfo->nodeState << 8) | 0x80
                                         | ((pNodeInfo->flags & NMTMNU_NODE_FLAG_COUNT_STATREQ) >> 6)
                                         | ((TimerArg.argument.value & NMTMNU_TIMERARG_COUNT_SR) >> 8)));*/
-        *pRet_p = timeru_modifyTimer(&pNodeInfo->timerHdlStatReq,
-                                     nmtMnuInstance_g.statusRequestDelay, timerArg);
+#if (CONFIG_NMTMNU_IDENTREQ_BACKOFF_MAX_MS != 0)
+        *pRet_p = modifyNodeTimer(&pNodeInfo->timerHdlStatReq,
+                                  getIdentReqDelay(nodeId_p, pNodeInfo), timerArg);
+#else
+        *pRet_p = modifyNodeTimer(&pNodeInfo->timerHdlStatReq,
+                                  nmtMnuInstance_g.statusRequestDelay, timerArg);
+#endif
     }
     else
     {   // trigger IdentRequest immediately
@@ -2527,8 +2611,17 @@ static INT processNodeEventStatusResponse(UINT nodeId_p, tNmtState nodeNmtState_
                                       ((pNodeInfo->nodeState << 8) | 0x80
                                        | ((pNodeInfo->flags & NMTMNU_NODE_FLAG_COUNT_STATREQ) >> 6)
                                        | ((TimerArg.argument.value & NMTMNU_TIMERARG_COUNT_SR) >> 8)));*/
-        *pRet_p = timeru_modifyTimer(&pNodeInfo->timerHdlStatReq,
-                                     nmtMnuInstance_g.statusRequestDelay, timerArg);
+#if (CONFIG_NMTMNU_STATREQ_RELAX_MAX_MS != 0)
+        *pRet_p = modifyNodeTimer(&pNodeInfo->timerHdlStatReq,
+                                  getStatReqDelay(pNodeInfo,
+                                                  ((pNodeInfo->nodeState == kNmtMnuNodeStateOperational) &&
+                                                   (errorCode_p == E_NO_ERROR) &&
+                                                   ((pNodeInfo->flags & NMTMNU_NODE_FLAG_NMT_CMD_ISSUED) == 0))),
+                                  timerArg);
+#else
+        *pRet_p = modifyNodeTimer(&pNodeInfo->timerHdlStatReq,
+                                  nmtMnuInstance_g.statusRequestDelay, timerArg);
+#endif
     }
     return 0;
 }
@@ -2637,7 +2730,7 @@ static INT processNodeEventExecResetNode(UINT nodeId_p, tNmtState nodeNmtState_p
         return 0;
     }
 
-    pNodeInfo->nodeState = kNmtMnuNodeStateConfRestored;
+    setNodeState(pNodeInfo, kNmtMnuNodeStateConfRestored);
     NMTMNU_DBG_POST_TRACE_VALUE(kNmtMnuIntNodeEventExecResetNode, nodeId_p,
                                 (((nodeNmtState_p & 0xFF) << 8) | kNmtCmdResetNode));
 
@@ -2681,7 +2774,7 @@ static INT processNodeEventExecResetConf(UINT nodeId_p, tNmtState nodeNmtState_p
        return 0;
     }
 
-    pNodeInfo->nodeState = kNmtMnuNodeStateResetConf;
+    setNodeState(pNodeInfo, kNmtMnuNodeStateResetConf);
     NMTMNU_DBG_POST_TRACE_VALUE(nodeEvent_p, nodeId_p,
                                 (((nodeNmtState_p & 0xFF) << 8) |
                                  kNmtCmdResetConfiguration));
@@ -2878,7 +2971,13 @@ static INT processNodeEventTimerLonger(UINT nodeId_p, tNmtState nodeNmtState_p,
 
         case kNmtMnuNodeStateReadyToOp:
             // CheckCom finished successfully
-            pNodeInfo->nodeState = kNmtMnuNodeStateComChecked;
+            setNodeState(pNodeInfo, kNmtMnuNodeStateComChecked);
+            pNodeInfo->flags &= ~NMTMNU_NODE_FLAG_CHECKCOM_EARLY;
+
+            if (nmtState_p < kNmtMsReadyToOperate)
+            {   // early CheckCom of pipelined boot, MN counters are not involved yet
+                break;
+            }
 
             if ((pNodeInfo->flags & NMTMNU_NODE_FLAG_NOT_SCANNED) != 0)
             {
@@ -2946,6 +3045,11 @@ static INT processNodeEventNmtCmdSent(UINT nodeId_p, tNmtState nodeNmtState_p, t
     if (*pRet_p != kErrorOk)
         return -1;
 
+#if (CONFIG_NMTMNU_STATREQ_RELAX_MAX_MS != 0)
+    // poll the node at the fixed interval again after an NMT command
+    pNodeInfo->statReqDelay = 0;
+#endif
+
     if (nodeNmtState_p == kNmtCsNotActive)
     {   // restart processing with IdentRequest
         NMTMNU_SET_FLAGS_TIMERARG_IDENTREQ(pNodeInfo, nodeId_p, timerArg);
@@ -2959,8 +3063,8 @@ static INT processNodeEventNmtCmdSent(UINT nodeId_p, tNmtState nodeNmtState_p, t
         // set NMT state change flag
         pNodeInfo->flags |= NMTMNU_NODE_FLAG_NMT_CMD_ISSUED;
     }
-    *pRet_p = timeru_modifyTimer(&pNodeInfo->timerHdlStatReq,
-                                 nmtMnuInstance_g.statusRequestDelay, timerArg);
+    *pRet_p = modifyNodeTimer(&pNodeInfo->timerHdlStatReq,
+                              nmtMnuInstance_g.statusRequestDelay, timerArg);
     // finish processing, because NmtState_p is the expected and not the current state
     return -1;
 }
@@ -3169,11 +3273,11 @@ static tOplkError checkNmtState(UINT nodeId_p, tNmtMnuNodeInfo* pNodeInfo_p,
     else if ((expNmtState == kNmtCsPreOperational2) && (nodeNmtState_p == kNmtCsReadyToOperate))
     {   // CN switched to ReadyToOp
         // delete timer for timeout handling
-        ret = timeru_deleteTimer(&pNodeInfo_p->timerHdlLonger);
+        ret = deleteNodeTimer(&pNodeInfo_p->timerHdlLonger);
         if (ret != kErrorOk)
             goto Exit;
 
-        pNodeInfo_p->nodeState = kNmtMnuNodeStateReadyToOp;
+        setNodeState(pNodeInfo_p, kNmtMnuNodeStateReadyToOp);
 
         // update object 0x1F8F NMT_MNNodeExpState_AU8 to ReadyToOp
         ret = obd_writeEntry(0x1F8F, nodeId_p, &nodeNmtState, 1);
@@ -3184,6 +3288,19 @@ static tOplkError checkNmtState(UINT nodeId_p, tNmtMnuNodeInfo* pNodeInfo_p,
         {   // node is a mandatory CN -> decrement counter
             nmtMnuInstance_g.mandatorySlaveCount--;
         }
+#if (CONFIG_NMTMNU_PIPELINED_BOOT != FALSE)
+        if (localNmtState_p == kNmtMsPreOperational2)
+        {   // start CheckCommunication already, startCheckCom() takes over the running timer
+            ret = nodeCheckCom(nodeId_p, pNodeInfo_p);
+            if (ret == kErrorReject)
+            {
+                pNodeInfo_p->flags |= NMTMNU_NODE_FLAG_CHECKCOM_EARLY;
+                ret = kErrorOk;
+            }
+            else if (ret != kErrorOk)
+                goto ExitButUpdate;
+        }
+#endif
         if (localNmtState_p >= kNmtMsReadyToOperate)
         {   // start procedure CheckCommunication for this node
             ret = nodeCheckCom(nodeId_p, pNodeInfo_p);
@@ -3204,7 +3321,7 @@ static tOplkError checkNmtState(UINT nodeId_p, tNmtMnuNodeInfo* pNodeInfo_p,
     }
     else if ((pNodeInfo_p->nodeState == kNmtMnuNodeStateComChecked) && (nodeNmtState_p == kNmtCsOperational))
     {   // CN switched to OPERATIONAL
-        pNodeInfo_p->nodeState = kNmtMnuNodeStateOperational;
+        setNodeState(pNodeInfo_p, kNmtMnuNodeStateOperational);
 
         if ((pNodeInfo_p->nodeCfg & NMT_NODEASSIGN_MANDATORY_CN) != 0)
         {   // node is a mandatory CN -> decrement counter
@@ -3234,7 +3351,7 @@ static tOplkError checkNmtState(UINT nodeId_p, tNmtMnuNodeInfo* pNodeInfo_p,
         }
 
         // -> CN is in wrong NMT state
-        pNodeInfo_p->nodeState = kNmtMnuNodeStateUnknown;
+        setNodeState(pNodeInfo_p, kNmtMnuNodeStateUnknown);
 
         BENCHMARK_MOD_07_TOGGLE(7);
 
@@ -3307,14 +3424,277 @@ static tOplkError reset(void)
     ret = timeru_deleteTimer(&nmtMnuInstance_g.timerHdlNmtState);
     for (index = 1; index <= tabentries(nmtMnuInstance_g.aNodeInfo); index++)
     {
-        ret = timeru_deleteTimer(&NMTMNU_GET_NODEINFO(index)->timerHdlStatReq);
-        ret = timeru_deleteTimer(&NMTMNU_GET_NODEINFO(index)->timerHdlLonger);
+        ret = deleteNodeTimer(&NMTMNU_GET_NODEINFO(index)->timerHdlStatReq);
+        ret = deleteNodeTimer(&NMTMNU_GET_NODEINFO(index)->timerHdlLonger);
     }
+#if (CONFIG_NMTMNU_SUPERVISOR_TICK_MS != 0)
+    ret = timeru_deleteTimer(&nmtMnuInstance_g.timerHdlTick);
+    nmtMnuInstance_g.fTickActive = FALSE;
+    nodeset_clear(&nmtMnuInstance_g.activeTimerSet);
+#endif
 
     nmtMnuInstance_g.prcPResMnTimeoutNs = 0;
+#if (CONFIG_NMTMNU_IDENTREQ_BACKOFF_MAX_MS != 0)
+    nodeset_clear(&nmtMnuInstance_g.identBackoffSet);
+#endif
+#if (CONFIG_NMTMNU_COALESCE_NMT_CMD != FALSE)
+    nodeset_clear(&nmtMnuInstance_g.nmtExtSet);
+#endif
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process expired node timer
+
+The function processes an expired timer of a CN. Timers which were modified or
+deleted after they were started are discarded.
+
+\param  timerArg_p          Timer argument (NMTMNU_TIMERARG_xxx).
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError processNodeTimer(UINT32 timerArg_p)
+{
+    tOplkError              ret;
+    UINT                    nodeId;
+    tObdSize                obdSize;
+    UINT8                   nmtState;
+    tNmtMnuNodeInfo*        pNodeInfo;
+    tNmtMnuIntNodeEvent     nodeEvent;
+    UINT32                  timerCount;
+    UINT32                  nodeCount;
+
+    nodeId = (UINT)(timerArg_p & NMTMNU_TIMERARG_NODE_MASK);
+    pNodeInfo = NMTMNU_GET_NODEINFO(nodeId);
+
+    obdSize = 1;
+    ret = obd_readEntry(0x1F8E, nodeId, &nmtState, &obdSize);
+    if (ret != kErrorOk)
+        return ret;
+
+    if ((timerArg_p & NMTMNU_TIMERARG_IDENTREQ) != 0L)
+    {
+        nodeEvent = kNmtMnuIntNodeEventTimerIdentReq;
+        timerCount = timerArg_p & NMTMNU_TIMERARG_COUNT_SR;
+        nodeCount = pNodeInfo->flags & NMTMNU_NODE_FLAG_COUNT_STATREQ;
+    }
+    else if ((timerArg_p & NMTMNU_TIMERARG_STATREQ) != 0L)
+    {
+        nodeEvent = kNmtMnuIntNodeEventTimerStatReq;
+        timerCount = timerArg_p & NMTMNU_TIMERARG_COUNT_SR;
+        nodeCount = pNodeInfo->flags & NMTMNU_NODE_FLAG_COUNT_STATREQ;
+    }
+    else if ((timerArg_p & NMTMNU_TIMERARG_STATE_MON) != 0L)
+    {
+        nodeEvent = kNmtMnuIntNodeEventTimerStateMon;
+        timerCount = timerArg_p & NMTMNU_TIMERARG_COUNT_SR;
+        nodeCount = pNodeInfo->flags & NMTMNU_NODE_FLAG_COUNT_STATREQ;
+    }
+    else if ((timerArg_p & NMTMNU_TIMERARG_LONGER) != 0L)
+    {
+        nodeEvent = kNmtMnuIntNodeEventTimerLonger;
+        timerCount = timerArg_p & NMTMNU_TIMERARG_COUNT_LO;
+        nodeCount = pNodeInfo->flags & NMTMNU_NODE_FLAG_COUNT_LONGER;
+    }
+    else
+    {
+        return kErrorOk;
+    }
+
+    if (nodeCount != timerCount)
+    {   // this is an old (already deleted or modified) timer
+        // but not the current timer
+        // so discard it
+        NMTMNU_DBG_POST_TRACE_VALUE(nodeEvent, nodeId, ((pNodeInfo->nodeState << 8) | 0xFF));
+        return kErrorOk;
+    }
+
+    return processInternalEvent(nodeId, (tNmtState)(nmtState | NMT_TYPE_CS), E_NO_ERROR, nodeEvent);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Start or modify a node timer
+
+The function starts or restarts a timer of a CN. If the supervisor tick is
+enabled, the timer is a deadline which is checked by processSupervisorTick(),
+otherwise a timer of the user timer module is used.
+
+\param  pTimer_p            Pointer to the node timer.
+\param  timeInMs_p          Timeout in [ms].
+\param  argument_p          Timer argument, contains the node ID.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError modifyNodeTimer(tNmtMnuNodeTimer* pTimer_p, ULONG timeInMs_p, tTimerArg argument_p)
+{
+#if (CONFIG_NMTMNU_SUPERVISOR_TICK_MS != 0)
+    tTimerArg   timerArg;
+
+    pTimer_p->deadline = target_getTickCount() + (UINT32)timeInMs_p;
+    pTimer_p->argument = (UINT32)argument_p.argument.value;
+    NODESET_ADD(&nmtMnuInstance_g.activeTimerSet,
+                (UINT)(pTimer_p->argument & NMTMNU_TIMERARG_NODE_MASK));
+
+    if (nmtMnuInstance_g.fTickActive)
+        return kErrorOk;
+
+    timerArg.eventSink = kEventSinkNmtMnu;
+    timerArg.argument.value = NMTMNU_TIMERARG_TICK;
+    nmtMnuInstance_g.fTickActive = TRUE;
+    return timeru_modifyTimer(&nmtMnuInstance_g.timerHdlTick, CONFIG_NMTMNU_SUPERVISOR_TICK_MS, timerArg);
+#else
+    return timeru_modifyTimer(pTimer_p, timeInMs_p, argument_p);
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Delete a node timer
+
+\param  pTimer_p            Pointer to the node timer.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError deleteNodeTimer(tNmtMnuNodeTimer* pTimer_p)
+{
+#if (CONFIG_NMTMNU_SUPERVISOR_TICK_MS != 0)
+    // the node is removed from the active timer set by the next tick
+    pTimer_p->argument = 0;
+    return kErrorOk;
+#else
+    return timeru_deleteTimer(pTimer_p);
+#endif
+}
+
+#if (CONFIG_NMTMNU_SUPERVISOR_TICK_MS != 0)
+//------------------------------------------------------------------------------
+/**
+\brief  Process the supervisor tick
+
+The function checks the node timers of all CNs with an active timer and
+processes the expired ones. The tick timer is restarted as long as a node
+timer is active.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError processSupervisorTick(void)
+{
+    tOplkError          ret = kErrorOk;
+    tOplkError          tickRet;
+    tNmtMnuNodeInfo*    pNodeInfo;
+    tNmtMnuNodeTimer*   apTimer[2];
+    tTimerArg           timerArg;
+    UINT32              now;
+    UINT32              argument;
+    UINT                nodeId;
+    UINT                index;
+
+    nmtMnuInstance_g.fTickActive = FALSE;
+    now = target_getTickCount();
+
+    for (nodeId = nodeset_getNext(&nmtMnuInstance_g.activeTimerSet, C_ADR_INVALID);
+         nodeId != C_ADR_INVALID;
+         nodeId = nodeset_getNext(&nmtMnuInstance_g.activeTimerSet, nodeId))
+    {
+        pNodeInfo = NMTMNU_GET_NODEINFO(nodeId);
+        apTimer[0] = &pNodeInfo->timerHdlStatReq;
+        apTimer[1] = &pNodeInfo->timerHdlLonger;
+
+        for (index = 0; index < tabentries(apTimer); index++)
+        {
+            argument = apTimer[index]->argument;
+            if ((argument == 0) || ((INT32)(now - apTimer[index]->deadline) < 0))
+                continue;
+
+            // the timer may be restarted while its expiry is processed
+            apTimer[index]->argument = 0;
+            ret = processNodeTimer(argument);
+            if (ret != kErrorOk)
+                goto Exit;
+        }
+
+        if ((pNodeInfo->timerHdlStatReq.argument == 0) && (pNodeInfo->timerHdlLonger.argument == 0))
+            NODESET_REMOVE(&nmtMnuInstance_g.activeTimerSet, nodeId);
+    }
+
+Exit:
+    if (!nmtMnuInstance_g.fTickActive && !nodeset_isEmpty(&nmtMnuInstance_g.activeTimerSet))
+    {
+        timerArg.eventSink = kEventSinkNmtMnu;
+        timerArg.argument.value = NMTMNU_TIMERARG_TICK;
+        nmtMnuInstance_g.fTickActive = TRUE;
+        tickRet = timeru_modifyTimer(&nmtMnuInstance_g.timerHdlTick, CONFIG_NMTMNU_SUPERVISOR_TICK_MS, timerArg);
+        if (ret == kErrorOk)
+            ret = tickRet;
+    }
+
+    return ret;
+}
+#endif
+
+#if (CONFIG_EDRV_FAST_LINK != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Process a link up of the MN
+
+The function is called if the Ethernet driver reported that the link of the MN
+came up again. The CNs which are not identified were probably not reachable
+while the link was down, so they are requested immediately instead of after
+the IdentRequest interval. Their IdentRequest backoff is reset and the regular
+interval is restarted in case they still don't answer.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError processLinkUp(void)
+{
+    tOplkError          ret = kErrorOk;
+    tTimerArg           timerArg;
+    tNmtMnuNodeInfo*    pNodeInfo;
+    UINT                nodeId;
+
+    // below PreOp2 the missing CNs are requested without delay anyway
+    if (nmtu_getNmtState() < kNmtMsPreOperational2)
+        return kErrorOk;
+
+    for (nodeId = 1; nodeId <= tabentries(nmtMnuInstance_g.aNodeInfo); nodeId++)
+    {
+        pNodeInfo = NMTMNU_GET_NODEINFO(nodeId);
+        if (((pNodeInfo->nodeCfg & (NMT_NODEASSIGN_NODE_IS_CN | NMT_NODEASSIGN_NODE_EXISTS)) !=
+             (NMT_NODEASSIGN_NODE_IS_CN | NMT_NODEASSIGN_NODE_EXISTS)) ||
+            (pNodeInfo->nodeState != kNmtMnuNodeStateUnknown))
+            continue;
+
+#if (CONFIG_NMTMNU_IDENTREQ_BACKOFF_MAX_MS != 0)
+        pNodeInfo->identReqDelay = 0;
+        NODESET_REMOVE(&nmtMnuInstance_g.identBackoffSet, nodeId);
+#endif
+
+        NMTMNU_SET_FLAGS_TIMERARG_IDENTREQ(pNodeInfo, nodeId, timerArg);
+        ret = modifyNodeTimer(&pNodeInfo->timerHdlStatReq,
+                              nmtMnuInstance_g.statusRequestDelay, timerArg);
+        if (ret != kErrorOk)
+            break;
+
+        ret = identu_requestIdentResponse(nodeId, cbIdentResponse);
+        if (ret == kErrorInvalidOperation)
+        {   // IdentRequest is already pending
+            ret = kErrorOk;
+        }
+        else if (ret != kErrorOk)
+            break;
+    }
 
     return ret;
 }
+#endif
 
 //------------------------------------------------------------------------------
 /**
@@ -3769,7 +4149,13 @@ static void prcSyncError(tNmtMnuNodeInfo* pNodeInfo_p)
 /**
 \brief  Perform shift phase for PRC node insertion
 
-The function performs the shift phase for PRC node insertion.
+The function performs the shift phase for PRC node insertion. The nodes are
+shifted in descending order of their node IDs. Up to
+NMTMNU_PRC_NODE_SHIFT_MAX_NUM SyncReqs are issued at once, so the shift of
+several nodes only takes one SyncReq/SyncRes round-trip per node instead of
+waiting for the SyncRes of each node before issuing the next SyncReq. If more
+than one node is shifted per batch, the next batch restarts the search at the
+highest node ID, so nodes whose shift failed are shifted again.
 
 \param  nodeIdPrevShift_p   Node ID of previously shifted node.
 
@@ -3783,15 +4169,23 @@ static tOplkError prcShift(UINT nodeIdPrevShift_p)
     tNmtMnuNodeInfo*    pNodeInfo;
     tDllSyncRequest     syncRequestData;
     UINT                size;
+    UINT                syncReqNum;
+    tNmtMnuNodeInfo*    pNodeInfoLastSyncReq;
 
     ret = kErrorOk;
-    if (nodeIdPrevShift_p == C_ADR_INVALID)
+    if ((nodeIdPrevShift_p == C_ADR_INVALID) || (NMTMNU_PRC_NODE_SHIFT_MAX_NUM > 1))
         nodeIdPrevShift_p = 254;
 
+    // prepare SyncReq
+    syncRequestData.syncControl = PLK_SYNC_PRES_TIME_FIRST_VALID |
+                                  PLK_SYNC_DEST_MAC_ADDRESS_VALID;
+    size = sizeof(UINT) + 2 * sizeof(UINT32);
+    syncReqNum = 0;
+    pNodeInfoLastSyncReq = NULL;
+
     // The search starts with the previous shift node
     // as this node might require a second SyncReq
-    nodeId = nodeIdPrevShift_p;
-    do
+    for (nodeId = nodeIdPrevShift_p; nodeId >= 1; nodeId--)
     {
         pNodeInfo = NMTMNU_GET_NODEINFO(nodeId);
         if (pNodeInfo == NULL)
@@ -3799,31 +4193,33 @@ static tOplkError prcShift(UINT nodeIdPrevShift_p)
 
         if ((pNodeInfo->nodeCfg & NMT_NODEASSIGN_PRES_CHAINING) &&
             ((pNodeInfo->flags & NMTMNU_NODE_FLAG_ISOCHRON) ||
-             (pNodeInfo->prcFlags & NMTMNU_NODE_FLAG_PRC_ADD_IN_PROGRESS)))
+             (pNodeInfo->prcFlags & NMTMNU_NODE_FLAG_PRC_ADD_IN_PROGRESS)) &&
+            (pNodeInfo->prcFlags & NMTMNU_NODE_FLAG_PRC_SHIFT_REQUIRED))
         {
-            if (pNodeInfo->prcFlags & NMTMNU_NODE_FLAG_PRC_SHIFT_REQUIRED)
+            // Send SyncReq
+            syncRequestData.nodeId        = nodeId;
+            syncRequestData.pResTimeFirst = pNodeInfo->pResTimeFirstNs;
+            ret = syncu_requestSyncResponse(prcCbSyncResShift, &syncRequestData, size);
+            if (ret != kErrorOk)
+                goto Exit;
+
+            syncReqNum++;
+            pNodeInfoLastSyncReq = pNodeInfo;
+
+            if (syncReqNum == NMTMNU_PRC_NODE_SHIFT_MAX_NUM)
                 break;
         }
-        nodeId--;
-    } while (nodeId >= 1);
+    }
 
-    if (nodeId == 0)
+    if (pNodeInfoLastSyncReq == NULL)
     {   // No node requires shifting
         // Enter next phase
         ret = prcAdd(C_ADR_INVALID);
         goto Exit;
     }
 
-    // Call shift on reception of SyncRes
-    pNodeInfo->prcFlags |= NMTMNU_NODE_FLAG_PRC_CALL_SHIFT;
-
-    // Send SyncReq
-    syncRequestData.nodeId        = nodeId;
-    syncRequestData.syncControl   = PLK_SYNC_PRES_TIME_FIRST_VALID |
-                                        PLK_SYNC_DEST_MAC_ADDRESS_VALID;
-    syncRequestData.pResTimeFirst = pNodeInfo->pResTimeFirstNs;
-    size = sizeof(UINT) + 2 * sizeof(UINT32);
-    ret = syncu_requestSyncResponse(prcCbSyncResShift, &syncRequestData, size);
+    // Call shift on reception of the last SyncRes
+    pNodeInfoLastSyncReq->prcFlags |= NMTMNU_NODE_FLAG_PRC_CALL_SHIFT;
 
 Exit:
     return ret;
@@ -4408,8 +4804,11 @@ Exit:
 /**
 \brief  Send NMT command to network
 
-This function creates the NMT command frame and forwards it to DLL for
-transmission.
+This function sends an NMT command. Within an NMT command batch (see
+beginNmtCommandBatch()), plain NMT state commands without command data to CNs
+which support extended NMT commands are collected and sent as one extended
+NMT command with a node list at the end of the batch. Any other NMT command
+sends the collected command first, so the order of the commands is kept.
 
 \param  nodeId_p            Node id of target node
 \param  nmtCommand_p        NMT command
@@ -4421,6 +4820,52 @@ transmission.
 //------------------------------------------------------------------------------
 static tOplkError sendNmtCommand(UINT nodeId_p, tNmtCommand nmtCommand_p,
                                  UINT8* pNmtCommandData_p, UINT dataSize_p)
+{
+#if (CONFIG_NMTMNU_COALESCE_NMT_CMD != FALSE)
+    tOplkError  ret;
+    tNmtCommand extCmd;
+
+    if (isCoalescable(nodeId_p, nmtCommand_p, dataSize_p))
+    {
+        extCmd = (tNmtCommand)(nmtCommand_p + NMTMNU_EXT_CMD_OFFSET);
+        if (!nodeset_isEmpty(&nmtMnuInstance_g.coalesceSet) &&
+            (nmtMnuInstance_g.coalesceCmd != extCmd))
+        {
+            ret = flushNmtCommand();
+            if (ret != kErrorOk)
+                return ret;
+        }
+
+        nmtMnuInstance_g.coalesceCmd = extCmd;
+        NODESET_ADD(&nmtMnuInstance_g.coalesceSet, nodeId_p);
+        return kErrorOk;
+    }
+
+    ret = flushNmtCommand();
+    if (ret != kErrorOk)
+        return ret;
+#endif
+
+    return sendNmtCommandFrame(nodeId_p, nmtCommand_p, pNmtCommandData_p, dataSize_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send NMT command frame
+
+This function creates the NMT command frame and forwards it to DLL for
+transmission.
+
+\param  nodeId_p            Node id of target node
+\param  nmtCommand_p        NMT command
+\param  pNmtCommandData_p   Pointer to NMT command data
+\param  dataSize_p          Size of NMT command data
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError sendNmtCommandFrame(UINT nodeId_p, tNmtCommand nmtCommand_p,
+                                      UINT8* pNmtCommandData_p, UINT dataSize_p)
 {
     tOplkError  ret = kErrorOk;
     tFrameInfo  frameInfo;
@@ -4448,6 +4893,116 @@ static tOplkError sendNmtCommand(UINT nodeId_p, tNmtCommand nmtCommand_p,
     return ret;
 }
 
+#if (CONFIG_NMTMNU_COALESCE_NMT_CMD != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Check if an NMT command can be coalesced
+
+\param  nodeId_p            Node id of target node
+\param  nmtCommand_p        NMT command
+\param  dataSize_p          Size of NMT command data
+
+\return The function returns TRUE if the command can be added to an extended
+        NMT command.
+*/
+//------------------------------------------------------------------------------
+static BOOL isCoalescable(UINT nodeId_p, tNmtCommand nmtCommand_p, UINT dataSize_p)
+{
+    if ((nmtMnuInstance_g.coalesceDepth == 0) || (nodeId_p >= C_ADR_BROADCAST) || (dataSize_p != 0))
+        return FALSE;
+
+    switch (nmtCommand_p)
+    {
+        case kNmtCmdStartNode:
+        case kNmtCmdStopNode:
+        case kNmtCmdEnterPreOperational2:
+        case kNmtCmdEnableReadyToOperate:
+        case kNmtCmdResetNode:
+        case kNmtCmdResetCommunication:
+        case kNmtCmdResetConfiguration:
+        case kNmtCmdSwReset:
+            return NODESET_CONTAINS(&nmtMnuInstance_g.nmtExtSet, nodeId_p);
+
+        default:
+            return FALSE;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send the coalesced NMT command
+
+The function sends the collected NMT command. If it addresses a single CN,
+the plain NMT command is sent.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError flushNmtCommand(void)
+{
+    UINT8       aNodeList[NODESET_NODELIST_SIZE];
+    UINT        nodeId;
+
+    if (nodeset_isEmpty(&nmtMnuInstance_g.coalesceSet))
+        return kErrorOk;
+
+    if (nodeset_count(&nmtMnuInstance_g.coalesceSet) == 1)
+    {
+        nodeId = nodeset_getNext(&nmtMnuInstance_g.coalesceSet, C_ADR_INVALID);
+        nodeset_clear(&nmtMnuInstance_g.coalesceSet);
+        return sendNmtCommandFrame(nodeId,
+                                   (tNmtCommand)(nmtMnuInstance_g.coalesceCmd - NMTMNU_EXT_CMD_OFFSET),
+                                   NULL, 0);
+    }
+
+    nodeset_toNodeList(&nmtMnuInstance_g.coalesceSet, aNodeList);
+    nodeset_clear(&nmtMnuInstance_g.coalesceSet);
+    DEBUG_LVL_NMTMN_TRACE("NMTCmd(%02X->list)\n", nmtMnuInstance_g.coalesceCmd);
+
+    return sendNmtCommandFrame(C_ADR_BROADCAST, nmtMnuInstance_g.coalesceCmd,
+                               aNodeList, sizeof(aNodeList));
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief  Begin an NMT command batch
+
+The per-node NMT commands which are issued until the matching call of
+endNmtCommandBatch() are coalesced into extended NMT commands. Batches may be
+nested, the commands are sent at the end of the outermost batch.
+*/
+//------------------------------------------------------------------------------
+static void beginNmtCommandBatch(void)
+{
+#if (CONFIG_NMTMNU_COALESCE_NMT_CMD != FALSE)
+    nmtMnuInstance_g.coalesceDepth++;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  End an NMT command batch
+
+The function ends an NMT command batch and sends the coalesced NMT command at
+the end of the outermost batch.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError endNmtCommandBatch(void)
+{
+#if (CONFIG_NMTMNU_COALESCE_NMT_CMD != FALSE)
+    if (nmtMnuInstance_g.coalesceDepth > 0)
+        nmtMnuInstance_g.coalesceDepth--;
+
+    if (nmtMnuInstance_g.coalesceDepth == 0)
+        return flushNmtCommand();
+#endif
+
+    return kErrorOk;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Calculates node numbers from NMT command frame
@@ -4528,7 +5083,8 @@ static tOplkError getNodeIdFromCmd(UINT nodeId_p, tNmtCommand nmtCommand_p,
 
 Extended NMT commands use 'Node Lists'. These are 32 byte wide bit fields, where
 each bit corresponds to a node number. This function walks through the bit
-field, and returns for every found node ID.
+field, and returns for every found node ID. The node list is converted into a
+node set on the first call, further calls only visit the set bits.
 
 For a detailed description of the bit field format, see section 7.3.1.2.3
 'POWERLINK Node List Format' of the Ethernet POWERLINK specification
@@ -4548,43 +5104,19 @@ DS 301 V1.2.0
 static tOplkError nodeListToNodeId(UINT8* pCmdData_p, tNmtMnuGetNodeId* pOp_p,
                                    UINT* pNodeId_p)
 {
-    tOplkError          ret = kErrorOk;
-    BOOL                matchFound = FALSE;
-
-    *pNodeId_p = C_ADR_INVALID;
-
-    // Loop over bitarray, handle only nodes whose bits are set
-    while ((pOp_p->cmdDataId < 32) && (matchFound == FALSE))
+    if (pOp_p->fNodeSetValid == FALSE)
     {
-        pOp_p->cmdData = ami_getUint8Le(&pCmdData_p[pOp_p->cmdDataId]);
-
-        if (pOp_p->nodeIdCnt == 0)
-            pOp_p->nodeIdMask = 0x01;
-
-        while ((pOp_p->nodeIdCnt < 8) && (matchFound == FALSE))
-        {
-            if ((pOp_p->cmdData & pOp_p->nodeIdMask) != 0)
-            {   // Match
-                *pNodeId_p = pOp_p->nodeId;
-                matchFound = TRUE;
-            }
-
-            pOp_p->nodeId++;
-            pOp_p->nodeIdCnt++;
-            pOp_p->nodeIdMask <<= 1;
-        }
-
-        if (pOp_p->nodeIdCnt == 8)
-        {
-            pOp_p->nodeIdCnt = 0;
-            pOp_p->cmdDataId++;
-        }
+        nodeset_fromNodeList(&pOp_p->nodeSet, pCmdData_p);
+        pOp_p->fNodeSetValid = TRUE;
     }
 
-    if (matchFound == TRUE)
-        ret = kErrorRetry;
+    pOp_p->nodeId = nodeset_getNext(&pOp_p->nodeSet, pOp_p->nodeId);
+    *pNodeId_p = pOp_p->nodeId;
 
-    return  ret;
+    if (pOp_p->nodeId == C_ADR_INVALID)
+        return kErrorOk;
+
+    return kErrorRetry;
 }
 
 //------------------------------------------------------------------------------
@@ -4650,6 +5182,181 @@ static ULONG computeCeilDiv(ULONG numerator_p, ULONG denominator_p)
     return result;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Set internal node state
+
+The function sets the internal node state of a CN and moves the CN into the
+node set of the new state.
+
+\param  pNodeInfo_p     Pointer to node info structure of node.
+\param  nodeState_p     New internal node state.
+*/
+//------------------------------------------------------------------------------
+static void setNodeState(tNmtMnuNodeInfo* pNodeInfo_p, tNmtMnuNodeState nodeState_p)
+{
+    UINT    nodeId;
+
+    nodeId = (UINT)(pNodeInfo_p - nmtMnuInstance_g.aNodeInfo) + 1;
+
+    if (pNodeInfo_p->nodeState != kNmtMnuNodeStateUnknown)
+        NODESET_REMOVE(&nmtMnuInstance_g.aNodeStateSet[pNodeInfo_p->nodeState], nodeId);
+
+    pNodeInfo_p->nodeState = nodeState_p;
+
+    if (nodeState_p != kNmtMnuNodeStateUnknown)
+        NODESET_ADD(&nmtMnuInstance_g.aNodeStateSet[nodeState_p], nodeId);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get next node in internal node state
+
+The function scans the node set of the specified internal node state for the
+next CN after the specified node ID, so nodes in other states are never
+touched.
+
+\param  nodeState_p     Internal node state to scan for.
+\param  nodeId_p        Node ID after which the scan starts. 0 starts the scan
+                        with the first node.
+
+\return The function returns the node ID of the next CN in the specified state
+        or C_ADR_INVALID if there is none.
+*/
+//------------------------------------------------------------------------------
+static UINT getNextNodeInState(tNmtMnuNodeState nodeState_p, UINT nodeId_p)
+{
+    return nodeset_getNext(&nmtMnuInstance_g.aNodeStateSet[nodeState_p], nodeId_p);
+}
+
+#if (CONFIG_NMTMNU_IDENTREQ_BACKOFF_MAX_MS != 0)
+//------------------------------------------------------------------------------
+/**
+\brief  Get delay of the next IdentRequest
+
+The function returns the delay of the next IdentRequest to a CN which did not
+answer the last IdentRequest. Optional CNs are requested with an exponentially
+growing interval up to CONFIG_NMTMNU_IDENTREQ_BACKOFF_MAX_MS, so absent optional
+CNs do not occupy the asynchronous slot. Mandatory CNs are always requested at
+the fixed interval, because the boot process waits for them.
+
+\param  nodeId_p            Node ID of the CN.
+\param  pNodeInfo_p         Pointer to node info structure of the CN.
+
+\return The function returns the delay in [ms].
+*/
+//------------------------------------------------------------------------------
+static ULONG getIdentReqDelay(UINT nodeId_p, tNmtMnuNodeInfo* pNodeInfo_p)
+{
+    ULONG   delay;
+    ULONG   maxDelay;
+
+    if ((pNodeInfo_p->nodeCfg & NMT_NODEASSIGN_MANDATORY_CN) != 0)
+        return nmtMnuInstance_g.statusRequestDelay;
+
+    delay = pNodeInfo_p->identReqDelay;
+    if (delay == 0)
+        delay = nmtMnuInstance_g.statusRequestDelay;
+
+    maxDelay = CONFIG_NMTMNU_IDENTREQ_BACKOFF_MAX_MS;
+    if (maxDelay < nmtMnuInstance_g.statusRequestDelay)
+        maxDelay = nmtMnuInstance_g.statusRequestDelay;
+
+    pNodeInfo_p->identReqDelay = (delay > (maxDelay / 2)) ? maxDelay : (delay * 2);
+    NODESET_ADD(&nmtMnuInstance_g.identBackoffSet, nodeId_p);
+
+    return delay;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Reset IdentRequest backoff
+
+The function is called if a CN answered an IdentRequest. It resets the
+IdentRequest interval of the CN. Because a new CN indicates a change of the
+network topology, the pending IdentRequests of all other backed off CNs are
+rescheduled with the fixed interval.
+
+\param  nodeId_p            Node ID of the CN.
+\param  pNodeInfo_p         Pointer to node info structure of the CN.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError resetIdentReqBackoff(UINT nodeId_p, tNmtMnuNodeInfo* pNodeInfo_p)
+{
+    tOplkError          ret = kErrorOk;
+    tTimerArg           timerArg;
+    tNmtMnuNodeInfo*    pNodeInfo;
+    UINT                nodeId;
+
+    pNodeInfo_p->identReqDelay = 0;
+    if (!NODESET_CONTAINS(&nmtMnuInstance_g.identBackoffSet, nodeId_p))
+        return kErrorOk;
+
+    NODESET_REMOVE(&nmtMnuInstance_g.identBackoffSet, nodeId_p);
+
+    for (nodeId = nodeset_getNext(&nmtMnuInstance_g.identBackoffSet, C_ADR_INVALID);
+         nodeId != C_ADR_INVALID;
+         nodeId = nodeset_getNext(&nmtMnuInstance_g.identBackoffSet, nodeId))
+    {
+        pNodeInfo = NMTMNU_GET_NODEINFO(nodeId);
+        if ((pNodeInfo->nodeState != kNmtMnuNodeStateUnknown) || (pNodeInfo->identReqDelay == 0))
+            continue;
+
+        pNodeInfo->identReqDelay = 0;
+        NMTMNU_SET_FLAGS_TIMERARG_IDENTREQ(pNodeInfo, nodeId, timerArg);
+        ret = modifyNodeTimer(&pNodeInfo->timerHdlStatReq,
+                              nmtMnuInstance_g.statusRequestDelay, timerArg);
+        if (ret != kErrorOk)
+            break;
+    }
+
+    return ret;
+}
+#endif
+
+#if (CONFIG_NMTMNU_STATREQ_RELAX_MAX_MS != 0)
+//------------------------------------------------------------------------------
+/**
+\brief  Get delay of the next StatusRequest
+
+The function returns the delay of the next StatusRequest to a CN which is not
+accessed isochronously. The interval to a healthy CN is doubled with every
+StatusResponse up to CONFIG_NMTMNU_STATREQ_RELAX_MAX_MS. Any other response
+returns to the fixed interval.
+
+\param  pNodeInfo_p         Pointer to node info structure of the CN.
+\param  fHealthy_p          TRUE if the CN is operational without error.
+
+\return The function returns the delay in [ms].
+*/
+//------------------------------------------------------------------------------
+static ULONG getStatReqDelay(tNmtMnuNodeInfo* pNodeInfo_p, BOOL fHealthy_p)
+{
+    ULONG   delay;
+    ULONG   maxDelay;
+
+    if (!fHealthy_p)
+    {
+        pNodeInfo_p->statReqDelay = 0;
+        return nmtMnuInstance_g.statusRequestDelay;
+    }
+
+    delay = pNodeInfo_p->statReqDelay;
+    if (delay == 0)
+        delay = nmtMnuInstance_g.statusRequestDelay;
+
+    maxDelay = CONFIG_NMTMNU_STATREQ_RELAX_MAX_MS;
+    if (maxDelay < nmtMnuInstance_g.statusRequestDelay)
+        maxDelay = nmtMnuInstance_g.statusRequestDelay;
+
+    pNodeInfo_p->statReqDelay = (delay > (maxDelay / 2)) ? maxDelay : (delay * 2);
+
+    return delay;
+}
+#endif
+
 ///\}
 
 #endif
@@ -45,6 +45,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "user/nmtu.h"
 #include "user/timeru.h"
 #include "user/dllucal.h"
+#include "user/multiplexu.h"
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -377,6 +378,21 @@ static tOplkError configureDll(void)
                 dllNodeInfo.presTimeoutNs = 0;
                 dllNodeInfo.preqPayloadLimit = 0;
             }
+
+            dllNodeInfo.multiplCycleAssign = 0;
+            if ((nodeCfg & NMT_NODEASSIGN_MULTIPLEXED_CN) != 0)
+            {   // node is polled only in its multiplexed cycle
+                obdSize = sizeof(dllNodeInfo.multiplCycleAssign);
+                ret = obd_readEntry(0x1F9B, index, &dllNodeInfo.multiplCycleAssign, &obdSize);
+                if ((ret == kErrorObdIndexNotExist) || (ret == kErrorObdSubindexNotExist))
+                {
+                    dllNodeInfo.multiplCycleAssign = 0;
+                }
+                else if (ret != kErrorOk)
+                {
+                    return ret;
+                }
+            }
 #endif // if defined(INCLUDE_CONFIG_NMT_MN)
 
             ret = dllucal_configNode(&dllNodeInfo);
@@ -432,6 +448,17 @@ static BOOL processGeneralStateChange(tNmtState newNmtState_p, tOplkError* pRet_
 
         // build the configuration with infos from OD
         case kNmtGsResetConfiguration:
+#if defined(CONFIG_INCLUDE_NMT_MN) && (CONFIG_NMTMNU_MULTIPLEX_SCHEDULE != FALSE)
+            if (obd_getNodeId() == C_ADR_MN_DEF_NODE_ID)
+            {   // assign the multiplexed CNs to the multiplexed cycles
+                ret = multiplexu_schedule();
+                if (ret != kErrorOk)
+                {
+                    break;
+                }
+            }
+#endif
+
 #if NMT_MAX_NODE_ID > 0
             // configure the DLL (PReq/PRes payload limits and PRes timeout)
             ret = configureDll();
@@ -41,9 +41,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <common/ami.h>
+#include <common/target.h>
 #include <user/statusu.h>
 #include <user/dllucal.h>
 
+#include <stddef.h>
+
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
 //============================================================================//
@@ -68,13 +71,26 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#define STATUSU_MAX_CHANGE_CB       4       // maximum number of change callbacks
 
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
+typedef struct
+{
+    UINT32              timeStamp;          // tick count of the reception of the cached StatusResponse
+    UINT32              version;            // version of the cached StatusResponse
+    BOOL                fRequestPending;    // StatusRequest issued, but no response received yet
+    tStatusuCbResponse  apfnCbWaiting[CONFIG_NMTU_CACHE_MAX_WAITERS];  // requesters of the cached StatusResponse
+} tStatusuCacheEntry;
+
 typedef struct
 {
     tStatusuCbResponse      apfnCbResponse[254];
+    tStatusResponse*        apStatusResponse[254];      // the cached StatusResponses are managed dynamically
+    tStatusuCacheEntry      aCacheEntry[254];
+    tStatusuCbResponse      apfnCbChange[STATUSU_MAX_CHANGE_CB];
+    UINT32                  lastVersion;                // last assigned version, kept on reset
 } tStatusuInstance;
 
 //------------------------------------------------------------------------------
@@ -86,6 +102,10 @@ static tStatusuInstance   instance_g;
 // local function prototypes
 //------------------------------------------------------------------------------
 static tOplkError statusu_cbStatusResponse(tFrameInfo* pFrameInfo_p);
+#if defined(CONFIG_INCLUDE_NMT_MN)
+static tOplkError issueRequest(UINT index_p);
+#endif
+static BOOL       updateCache(UINT index_p, tStatusResponse* pStatusResponse_p, UINT size_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -153,6 +173,8 @@ tOplkError statusu_delInstance(void)
 
     // deregister StatusResponse callback function
     ret = dllucal_regAsndService(kDllAsndStatusResponse, NULL, kDllAsndFilterNone);
+
+    statusu_reset();
     return ret;
 }
 
@@ -169,8 +191,25 @@ The function resets a status module instance
 //------------------------------------------------------------------------------
 tOplkError statusu_reset(void)
 {
-    // reset instance structure
+    UINT                index;
+    tStatusuCbResponse  apfnCbChange[STATUSU_MAX_CHANGE_CB];
+    UINT32              lastVersion;
+
+    for (index = 0; index < tabentries(instance_g.apStatusResponse); index++)
+    {
+        if (instance_g.apStatusResponse[index] != NULL)
+        {
+            OPLK_FREE(instance_g.apStatusResponse[index]);
+        }
+    }
+
+    // reset instance structure, the change callbacks and the version counter
+    // survive the reset
+    OPLK_MEMCPY(apfnCbChange, instance_g.apfnCbChange, sizeof(apfnCbChange));
+    lastVersion = instance_g.lastVersion;
     OPLK_MEMSET(&instance_g, 0, sizeof(instance_g));
+    OPLK_MEMCPY(instance_g.apfnCbChange, apfnCbChange, sizeof(apfnCbChange));
+    instance_g.lastVersion = lastVersion;
 
     return kErrorOk;
 }
@@ -218,7 +257,7 @@ tOplkError statusu_requestStatusResponse(UINT nodeId_p, tStatusuCbResponse pfnCb
         else
         {
             instance_g.apfnCbResponse[nodeId_p] = pfnCbResponse_p;
-            ret = dllucal_issueRequest(kDllReqServiceStatus, (nodeId_p + 1), 0xFF);
+            ret = issueRequest(nodeId_p);
         }
 #else
         ret = kErrorInvalidOperation;
@@ -232,6 +271,173 @@ tOplkError statusu_requestStatusResponse(UINT nodeId_p, tStatusuCbResponse pfnCb
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Request cached StatusResponse
+
+The function provides the cached StatusResponse of a specified node. If the
+cached StatusResponse is not older than CONFIG_STATUSU_CACHE_MAX_AGE, the
+callback function is called immediately. Otherwise, a StatusRequest is issued
+and the callback function is called when the StatusResponse is received.
+Concurrent requesters of the same node share one StatusRequest.
+
+\param  nodeId_p            The Node ID to request the StatusResponse for.
+\param  pfnCbResponse_p     Function pointer to callback function which will
+                            be called with the StatusResponse. NULL, if only
+                            the cache shall be refreshed.
+
+\return The function returns a tOplkError error code.
+\retval kErrorInvalidOperation  No further requester can be queued for this node.
+
+\ingroup module_statusu
+*/
+//------------------------------------------------------------------------------
+tOplkError statusu_requestCachedStatusResponse(UINT nodeId_p, tStatusuCbResponse pfnCbResponse_p)
+{
+#if defined(CONFIG_INCLUDE_NMT_MN)
+    tOplkError          ret = kErrorOk;
+    UINT                index;
+    UINT                waiter;
+    tStatusuCacheEntry* pEntry;
+
+    index = nodeId_p - 1;
+    if (index >= tabentries(instance_g.aCacheEntry))
+        return kErrorInvalidNodeId;
+
+    pEntry = &instance_g.aCacheEntry[index];
+    if ((instance_g.apStatusResponse[index] != NULL) &&
+        ((target_getTickCount() - pEntry->timeStamp) <= CONFIG_STATUSU_CACHE_MAX_AGE))
+    {   // cached StatusResponse is recent enough
+        if (pfnCbResponse_p != NULL)
+            ret = pfnCbResponse_p(nodeId_p, instance_g.apStatusResponse[index]);
+        return ret;
+    }
+
+    if (pfnCbResponse_p != NULL)
+    {
+        for (waiter = 0; waiter < tabentries(pEntry->apfnCbWaiting); waiter++)
+        {
+            if ((pEntry->apfnCbWaiting[waiter] == NULL) ||
+                (pEntry->apfnCbWaiting[waiter] == pfnCbResponse_p))
+                break;
+        }
+
+        if (waiter >= tabentries(pEntry->apfnCbWaiting))
+            return kErrorInvalidOperation;
+    }
+
+    ret = issueRequest(index);
+    if ((ret == kErrorOk) && (pfnCbResponse_p != NULL))
+        pEntry->apfnCbWaiting[waiter] = pfnCbResponse_p;
+
+    return ret;
+#else
+    UNUSED_PARAMETER(nodeId_p);
+    UNUSED_PARAMETER(pfnCbResponse_p);
+
+    return kErrorInvalidOperation;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get snapshot of StatusResponse
+
+The function copies the cached StatusResponse of a specified node together
+with its version and age. The version changes whenever a received
+StatusResponse differs from the previous one.
+
+\param  nodeId_p            The Node ID to get the StatusResponse for.
+\param  pSnapshot_p         Pointer to store the snapshot.
+
+\return The function returns a tOplkError error code.
+\retval kErrorInvalidOperation  No StatusResponse is cached for this node.
+
+\ingroup module_statusu
+*/
+//------------------------------------------------------------------------------
+tOplkError statusu_getStatusResponseSnapshot(UINT nodeId_p, tStatusuSnapshot* pSnapshot_p)
+{
+    UINT    index;
+
+    index = nodeId_p - 1;
+    if (index >= tabentries(instance_g.apStatusResponse))
+        return kErrorInvalidNodeId;
+
+    if (instance_g.apStatusResponse[index] == NULL)
+        return kErrorInvalidOperation;
+
+    OPLK_MEMCPY(&pSnapshot_p->statusResponse, instance_g.apStatusResponse[index],
+                sizeof(tStatusResponse));
+    pSnapshot_p->version = instance_g.aCacheEntry[index].version;
+    pSnapshot_p->age = target_getTickCount() - instance_g.aCacheEntry[index].timeStamp;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Register change callback
+
+The function registers a callback function which is called whenever the
+cached StatusResponse of a node changes.
+
+\param  pfnCbChange_p       Function pointer to the callback function.
+
+\return The function returns a tOplkError error code.
+\retval kErrorNoResource    The maximum number of change callbacks is reached.
+
+\ingroup module_statusu
+*/
+//------------------------------------------------------------------------------
+tOplkError statusu_registerChangeCb(tStatusuCbResponse pfnCbChange_p)
+{
+    UINT    index;
+    UINT    freeIndex = STATUSU_MAX_CHANGE_CB;
+
+    for (index = 0; index < STATUSU_MAX_CHANGE_CB; index++)
+    {
+        if (instance_g.apfnCbChange[index] == pfnCbChange_p)
+            return kErrorOk;
+
+        if ((instance_g.apfnCbChange[index] == NULL) && (freeIndex == STATUSU_MAX_CHANGE_CB))
+            freeIndex = index;
+    }
+
+    if (freeIndex == STATUSU_MAX_CHANGE_CB)
+        return kErrorNoResource;
+
+    instance_g.apfnCbChange[freeIndex] = pfnCbChange_p;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Deregister change callback
+
+The function deregisters a callback function which was registered with
+statusu_registerChangeCb().
+
+\param  pfnCbChange_p       Function pointer to the callback function.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_statusu
+*/
+//------------------------------------------------------------------------------
+tOplkError statusu_deregisterChangeCb(tStatusuCbResponse pfnCbChange_p)
+{
+    UINT    index;
+
+    for (index = 0; index < STATUSU_MAX_CHANGE_CB; index++)
+    {
+        if (instance_g.apfnCbChange[index] == pfnCbChange_p)
+            instance_g.apfnCbChange[index] = NULL;
+    }
+
+    return kErrorOk;
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -256,37 +462,144 @@ StatusResponse is received.
 static tOplkError statusu_cbStatusResponse(tFrameInfo* pFrameInfo_p)
 {
     tOplkError          ret = kErrorOk;
+    tOplkError          retCb;
     UINT                nodeId;
     UINT                index;
+    UINT                cb;
+    BOOL                fChanged = FALSE;
     tStatusuCbResponse  pfnCbResponse;
+    tStatusuCbResponse  apfnCbWaiting[CONFIG_NMTU_CACHE_MAX_WAITERS];
+    tStatusResponse*    pStatusResponse = NULL;
 
     nodeId = ami_getUint8Le(&pFrameInfo_p->pFrame->srcNodeId);
     index = nodeId - 1;
 
     if (index < tabentries(instance_g.apfnCbResponse))
     {
-        // memorize pointer to callback function
+        // memorize pointers to callback functions
         pfnCbResponse = instance_g.apfnCbResponse[index];
-        if (pfnCbResponse == NULL)
-        {   // response was not requested
-            goto Exit;
-        }
-        // reset callback function pointer so that a caller may issue next request
+        OPLK_MEMCPY(apfnCbWaiting, instance_g.aCacheEntry[index].apfnCbWaiting, sizeof(apfnCbWaiting));
+        // reset callback function pointers so that a caller may issue next request
         instance_g.apfnCbResponse[index] = NULL;
+        OPLK_MEMSET(instance_g.aCacheEntry[index].apfnCbWaiting, 0, sizeof(apfnCbWaiting));
+        instance_g.aCacheEntry[index].fRequestPending = FALSE;
 
-        if (pFrameInfo_p->frameSize < C_DLL_MINSIZE_STATUSRES)
-        {   // StatusResponse not received or it has invalid size
-            ret = pfnCbResponse(nodeId, NULL);
-        }
-        else
+        if (pFrameInfo_p->frameSize >= C_DLL_MINSIZE_STATUSRES)
         {   // StatusResponse received
-            ret = pfnCbResponse(nodeId, &pFrameInfo_p->pFrame->data.asnd.payload.statusResponse);
+            pStatusResponse = &pFrameInfo_p->pFrame->data.asnd.payload.statusResponse;
+            fChanged = updateCache(index, pStatusResponse,
+                                   pFrameInfo_p->frameSize - offsetof(tPlkFrame, data.asnd.payload.statusResponse));
+        }
+        // otherwise StatusResponse not received or it has invalid size
+
+        if (pfnCbResponse != NULL)
+            ret = pfnCbResponse(nodeId, pStatusResponse);
+
+        for (cb = 0; cb < tabentries(apfnCbWaiting); cb++)
+        {
+            if (apfnCbWaiting[cb] == NULL)
+                break;
+
+            retCb = apfnCbWaiting[cb](nodeId, pStatusResponse);
+            if (ret == kErrorOk)
+                ret = retCb;
+        }
+
+        if (fChanged)
+        {
+            for (cb = 0; cb < STATUSU_MAX_CHANGE_CB; cb++)
+            {
+                if (instance_g.apfnCbChange[cb] != NULL)
+                {
+                    retCb = instance_g.apfnCbChange[cb](nodeId, instance_g.apStatusResponse[index]);
+                    if (ret == kErrorOk)
+                        ret = retCb;
+                }
+            }
         }
     }
 
-Exit:
     return ret;
 }
 
+#if defined(CONFIG_INCLUDE_NMT_MN)
+//------------------------------------------------------------------------------
+/**
+\brief  Issue StatusRequest
+
+The function issues a StatusRequest for the specified node unless one is
+already pending. Thereby, all requesters of a node share one StatusRequest.
+
+\param  index_p             Index of the node (node ID - 1).
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_statusu
+*/
+//------------------------------------------------------------------------------
+static tOplkError issueRequest(UINT index_p)
+{
+    tOplkError  ret;
+
+    if (instance_g.aCacheEntry[index_p].fRequestPending)
+        return kErrorOk;
+
+    ret = dllucal_issueRequest(kDllReqServiceStatus, (index_p + 1), 0xFF);
+    if (ret == kErrorOk)
+        instance_g.aCacheEntry[index_p].fRequestPending = TRUE;
+
+    return ret;
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update cached StatusResponse
+
+The function stores a received StatusResponse in the cache of the specified
+node. Error history entries which are not contained in the frame are cleared.
+The version of the cached StatusResponse is incremented if its content
+changes.
+
+\param  index_p             Index of the node (node ID - 1).
+\param  pStatusResponse_p   Pointer to the received StatusResponse.
+\param  size_p              Size of the StatusResponse in the frame.
+
+\return The function returns TRUE if the cached StatusResponse was changed.
+
+\ingroup module_statusu
+*/
+//------------------------------------------------------------------------------
+static BOOL updateCache(UINT index_p, tStatusResponse* pStatusResponse_p, UINT size_p)
+{
+    tStatusuCacheEntry* pEntry = &instance_g.aCacheEntry[index_p];
+    tStatusResponse     statusResponse;
+
+    if (size_p > sizeof(tStatusResponse))
+        size_p = sizeof(tStatusResponse);
+
+    OPLK_MEMSET(&statusResponse, 0, sizeof(tStatusResponse));
+    OPLK_MEMCPY(&statusResponse, pStatusResponse_p, size_p);
+
+    if (instance_g.apStatusResponse[index_p] == NULL)
+    {   // memory for StatusResponse must be allocated
+        instance_g.apStatusResponse[index_p] = (tStatusResponse*)OPLK_MALLOC(sizeof(tStatusResponse));
+        if (instance_g.apStatusResponse[index_p] == NULL)
+            return FALSE;
+    }
+    else if (OPLK_MEMCMP(instance_g.apStatusResponse[index_p], &statusResponse,
+                         sizeof(tStatusResponse)) == 0)
+    {   // StatusResponse is unchanged
+        pEntry->timeStamp = target_getTickCount();
+        return FALSE;
+    }
+
+    OPLK_MEMCPY(instance_g.apStatusResponse[index_p], &statusResponse, sizeof(tStatusResponse));
+    pEntry->timeStamp = target_getTickCount();
+    pEntry->version = ++instance_g.lastVersion;
+
+    return TRUE;
+}
+
 ///\}
 
@@ -67,6 +67,33 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#if (CONFIG_OBD_INDEX_HASH_SIZE != 0)
+#if ((CONFIG_OBD_INDEX_HASH_SIZE & (CONFIG_OBD_INDEX_HASH_SIZE - 1)) != 0)
+#error "CONFIG_OBD_INDEX_HASH_SIZE must be a power of two!"
+#endif
+
+#define OBD_INDEX_HASH_MASK         (CONFIG_OBD_INDEX_HASH_SIZE - 1)
+#define OBD_INDEX_HASH_MAX_ENTRIES  ((CONFIG_OBD_INDEX_HASH_SIZE / 4) * 3)   // keep the probe sequences short
+#define OBD_INDEX_HASH(index_p)     (((index_p) ^ ((index_p) >> 8)) & OBD_INDEX_HASH_MASK)
+#endif
+
+#if (CONFIG_OBD_LOAD_CHANGED_ONLY != FALSE)
+#define OBD_GEN_PART_FIRST_INDEX    0x1000                                  // first index of the communication profile area
+#define OBD_GEN_PART_INDEX_COUNT    0x1000                                  // number of indices of the communication profile area
+#endif
+
+// states of the cached length of a VSTRING object
+#define OBD_STRING_LEN_UNKNOWN      0                                       // the string has to be scanned
+#define OBD_STRING_LEN_CACHED       1                                       // the length is valid
+#define OBD_STRING_LEN_PINNED       2                                       // the string can be written through a pointer
+
+#if (CONFIG_OBD_FAST_ACCESS != FALSE)
+#if (CONFIG_OBD_CHECK_OBJECT_RANGE != FALSE)
+#define OBD_PLAIN_WRITE_EXCL_ACCESS (kObdAccConst | kObdAccRange)           // range checked objects need the normal write
+#else
+#define OBD_PLAIN_WRITE_EXCL_ACCESS kObdAccConst
+#endif
+#endif
 
 //------------------------------------------------------------------------------
 // local types
@@ -89,6 +116,26 @@ typedef struct
     tObdInitParam                   initParam;
     tObdStoreLoadCallback           pfnStoreLoadObjectCb;
     BYTE                            obdTrashObject[8];
+#if (CONFIG_OBD_USE_STORE_RESTORE != FALSE)
+    tObdPart                        storeDirtyParts;        ///< Partitions changed since they were stored or loaded
+    tObdPart                        storeVarParts;          ///< Partitions with stored objects linked to application variables
+#endif
+#if (CONFIG_OBD_INDEX_HASH_SIZE != 0)
+    BOOL                            fIndexHashValid;
+    tObdEntryPtr                    apIndexHash[CONFIG_OBD_INDEX_HASH_SIZE];
+#endif
+#if (CONFIG_OBD_DEFER_DEFAULTS != FALSE)
+    tObdPart                        deferredParts;          ///< Partitions whose default values were not yet copied
+#endif
+#if (CONFIG_OBD_LOAD_CHANGED_ONLY != FALSE)
+    BOOL                            fGenPartLoaded;         ///< The communication part was completely loaded
+    UINT8                           aGenChanged[OBD_GEN_PART_INDEX_COUNT / 8];  ///< Objects changed since the last load
+    UINT8                           aGenPinned[OBD_GEN_PART_INDEX_COUNT / 8];   ///< Objects which are always loaded
+#endif
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    tObdVarEntry MEM*               apStreamVarEntry[CONFIG_OBD_DOMAIN_STREAM_COUNT];   ///< Domain objects which are backed by a stream
+    tObdDomainStream*               apStream[CONFIG_OBD_DOMAIN_STREAM_COUNT];           ///< Streams of the domain objects
+#endif
 } tObdInstance;
 
 //------------------------------------------------------------------------------
@@ -99,14 +146,20 @@ static tObdInstance                 obdInstance_l;
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
-static tOplkError   writeEntryPre(UINT uiIndex_p, UINT subIndex_p, void* pSrcData_p, void** ppDstData_p,
-                                  tObdSize size_p, tObdEntryPtr* ppObdEntry_p, tObdSubEntryPtr* ppSubEntry_p,
+static tOplkError   writeEntryPre(tObdEntryPtr pObdEntry_p, tObdSubEntryPtr pSubEntry_p, UINT subIndex_p,
+                                  void* pSrcData_p, void** ppDstData_p, tObdSize size_p,
                                   tObdCbParam MEM* pCbParam_p, tObdSize* pObdSize_p);
+static tOplkError   readEntry(tObdEntryPtr pObdEntry_p, tObdSubEntryPtr pSubEntry_p, UINT subIndex_p,
+                              void* pDstData_p, tObdSize* pSize_p);
+static tObdSubEntryPtr getResolvedSubEntry(tObdEntryRef* pEntryRef_p);
 static tOplkError   writeEntryPost(tObdEntryPtr pObdEntry_p, tObdSubEntryPtr pSubEntry_p,
                                    tObdCbParam MEM* pCbParam_p, void* pSrcData_p,
                                    void* pDstData_p, tObdSize obdSize_p);
 static tObdSize     getDataSize(tObdSubEntryPtr pSubIndexEntry_p);
 static tObdSize     getObdStringLen(void* pObjData_p, tObdSize objLen_p, tObdType objType_p);
+static tObdVString MEM* getStringLenCache(tObdSubEntryPtr pSubIndexEntry_p);
+static void         cacheStringLen(tObdSubEntryPtr pSubIndexEntry_p, tObdSize length_p);
+static void         invalidateStringLen(tObdSubEntryPtr pSubIndexEntry_p, BOOL fPin_p);
 static tObdSize     getDomainSize(tObdSubEntryPtr pSubIndexEntry_p);
 static tObdSize     getVstringSize(tObdSubEntryPtr pSubIndexEntry_p);
 static tObdSize     getOstringSize(tObdSubEntryPtr pSubIndexEntry_p);
@@ -129,18 +182,51 @@ static tOplkError   isNumerical(tObdSubEntryPtr pObdSubEntry_p, BOOL* pfEntryNum
 static UINT32       calcPartitionIndexNum(tObdEntryPtr pObdEntry_p);
 static void         calcOdIndexNum(tObdInitParam* pInitParam_p);
 
+#if (CONFIG_OBD_INDEX_HASH_SIZE != 0)
+static void         buildIndexHash(tObdInitParam* pInitParam_p);
+static void         addPartitionToIndexHash(tObdEntryPtr pObdEntry_p, UINT32 numEntries_p);
+static tObdEntryPtr lookupIndexHash(UINT index_p);
+#endif
+
 #if (CONFIG_OBD_CHECK_OBJECT_RANGE != FALSE)
 static tOplkError   checkObjectRange(tObdSubEntryPtr pSubIndexEntry_p, void* pData_p);
 #endif
 
+#if (CONFIG_OBD_DEFER_DEFAULTS != FALSE)
+static void         loadDeferredDefaults(tObdPart obdPart_p);
+#endif
+
+#if (CONFIG_OBD_LOAD_CHANGED_ONLY != FALSE)
+static void         markObjectChanged(UINT index_p, BOOL fPin_p);
+static BOOL         isObjectChanged(UINT index_p);
+#endif
+
 #if (CONFIG_OBD_USE_STORE_RESTORE != FALSE)
 static tOplkError   prepareStoreRestore(tObdDir direction_p, tObdCbStoreParam MEM* pCbStore_p);
-static tOplkError   cleanupStoreRestore(tObdDir direction_p, tObdCbStoreParam MEM* pCbStore_p)
+static tOplkError   cleanupStoreRestore(tObdDir direction_p, tObdCbStoreParam MEM* pCbStore_p);
 static tOplkError   doStoreRestore(tObdAccess access_p, tObdCbStoreParam MEM* pCbStore_p,
                                    void MEM* pObjData_p, tObdSize objSize_p);
 static tOplkError   callStoreCallback(tObdCbStoreParam MEM* pCbStoreParam_p);
 #endif // (CONFIG_OBD_USE_STORE_RESTORE != FALSE)
 
+#if (CONFIG_OBD_USE_STORE_RESTORE != FALSE) || (CONFIG_OBD_DEFER_DEFAULTS != FALSE)
+static tObdPart     getOdPart(UINT index_p);
+#endif
+
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+static tObdDomainStream* getDomainStream(tObdSubEntryPtr pSubEntry_p);
+static tOplkError   readDomainStream(tObdDomainStream* pStream_p, void* pDstData_p, tObdSize* pSize_p);
+static tOplkError   writeDomainStream(tObdSubEntryPtr pSubEntry_p, tObdDomainStream* pStream_p,
+                                      void* pSrcData_p, tObdSize size_p);
+#endif
+
+#if (CONFIG_OBD_FAST_ACCESS != FALSE)
+static BOOL         isPlainObject(tObdEntryPtr pObdEntry_p, tObdSubEntryPtr pSubEntry_p,
+                                  tObdAccess exclAccess_p);
+static tOplkError   writePlainObject(tObdEntryPtr pObdEntry_p, tObdSubEntryPtr pSubEntry_p,
+                                     void* pSrcData_p, tObdSize size_p);
+#endif
+
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
@@ -205,8 +291,32 @@ tOplkError obd_init(tObdInitParam MEM* pInitParam_p)
 
     // clear callback function for command LOAD and STORE
     obdInstance_l.pfnStoreLoadObjectCb = NULL;
+#if (CONFIG_OBD_USE_STORE_RESTORE != FALSE)
+    obdInstance_l.storeDirtyParts = kObdPartAll;
+    obdInstance_l.storeVarParts = kObdPartNo;
+#endif
 
     calcOdIndexNum(&obdInstance_l.initParam);
+#if (CONFIG_OBD_INDEX_HASH_SIZE != 0)
+    buildIndexHash(&obdInstance_l.initParam);
+#endif
+
+#if (CONFIG_OBD_DEFER_DEFAULTS != FALSE)
+    // the default values are copied on the first access of a partition or
+    // by the NMT reset which loads the partition
+    obdInstance_l.deferredParts = kObdPartAll;
+#endif
+
+#if (CONFIG_OBD_LOAD_CHANGED_ONLY != FALSE)
+    // the first load of the communication part is always complete
+    obdInstance_l.fGenPartLoaded = FALSE;
+    OPLK_MEMSET(obdInstance_l.aGenPinned, 0, sizeof(obdInstance_l.aGenPinned));
+#endif
+
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    OPLK_MEMSET(obdInstance_l.apStreamVarEntry, 0, sizeof(obdInstance_l.apStreamVarEntry));
+    OPLK_MEMSET(obdInstance_l.apStream, 0, sizeof(obdInstance_l.apStream));
+#endif
 
     // initialize object dictionary
     // so all all VarEntries will be initialized to trash object and default values will be set to current data
@@ -256,9 +366,27 @@ tOplkError obd_writeEntry(UINT index_p, UINT subIndex_p, void* pSrcData_p, tObdS
     tObdCbParam MEM         cbParam;
     void MEM*               pDstData;
     tObdSize                obdSize;
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    tObdDomainStream*       pStream;
+#endif
+
+    ret = getEntry(index_p, subIndex_p, &pObdEntry, &pSubEntry);
+    if (ret != kErrorOk)
+        return ret;
+
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    pStream = getDomainStream(pSubEntry);
+    if (pStream != NULL)
+        return writeDomainStream(pSubEntry, pStream, pSrcData_p, size_p);
+#endif
+
+#if (CONFIG_OBD_FAST_ACCESS != FALSE)
+    if (isPlainObject(pObdEntry, pSubEntry, OBD_PLAIN_WRITE_EXCL_ACCESS))
+        return writePlainObject(pObdEntry, pSubEntry, pSrcData_p, size_p);
+#endif
 
-    ret = writeEntryPre(index_p, subIndex_p, pSrcData_p, &pDstData, size_p,
-                        &pObdEntry, &pSubEntry, &cbParam, &obdSize);
+    ret = writeEntryPre(pObdEntry, pSubEntry, subIndex_p, pSrcData_p, &pDstData, size_p,
+                        &cbParam, &obdSize);
     if (ret != kErrorOk)
         return ret;
 
@@ -290,9 +418,6 @@ tOplkError obd_readEntry(UINT index_p, UINT subIndex_p, void* pDstData_p, tObdSi
     tOplkError                      ret;
     tObdEntryPtr                    pObdEntry;
     tObdSubEntryPtr                 pSubEntry;
-    tObdCbParam  MEM                cbParam;
-    void*                           pSrcData;
-    tObdSize                        obdSize;
 
     if ((pDstData_p == NULL) || (pSize_p == NULL))
         return kErrorInvalidInstanceParam;
@@ -301,44 +426,223 @@ tOplkError obd_readEntry(UINT index_p, UINT subIndex_p, void* pDstData_p, tObdSi
     if (ret != kErrorOk)
         return ret;
 
-     pSrcData = getObjectDataPtr(pSubEntry);
+    return readEntry(pObdEntry, pSubEntry, subIndex_p, pDstData_p, pSize_p);
+}
 
-    // check source pointer
-    if (pSrcData == NULL)
-        return kErrorObdReadViolation;
+//------------------------------------------------------------------------------
+/**
+\brief  Resolve OD entry
 
-    // address of source data to structure of callback parameters
-    // so callback function can change this data before reading
-    cbParam.index = index_p;
-    cbParam.subIndex = subIndex_p;
-    cbParam.pArg = pSrcData;
-    cbParam.obdEvent = kObdEvPreRead;
-    ret = callObjectCallback(pObdEntry->pfnCallback, &cbParam);
+The function looks up an OD entry and stores the references to the entry for
+obd_readResolvedEntry() and obd_writeResolvedEntry(). The references stay valid
+as long as the OD is not re-initialized.
+
+\param      index_p         Index of the entry.
+\param      subIndex_p      Sub-index of the entry.
+\param      pEntryRef_p     Pointer to store the references to the entry.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+tOplkError obd_resolveEntry(UINT index_p, UINT subIndex_p, tObdEntryRef* pEntryRef_p)
+{
+    tOplkError                      ret;
+
+    if (pEntryRef_p == NULL)
+        return kErrorInvalidInstanceParam;
+
+    pEntryRef_p->pObdEntry = NULL;
+    ret = getEntry(index_p, subIndex_p, &pEntryRef_p->pObdEntry, &pEntryRef_p->pSubEntry);
     if (ret != kErrorOk)
+    {
+        pEntryRef_p->pObdEntry = NULL;
         return ret;
+    }
 
-    // get size of data and check if application has reserved enough memory
-    obdSize = getDataSize(pSubEntry);
-    if (*pSize_p < obdSize)
-        return kErrorObdValueLengthError;
+    pEntryRef_p->subIndex = subIndex_p;
+    return kErrorOk;
+}
 
-    // read value from object
-    OPLK_MEMCPY(pDstData_p, pSrcData, obdSize);
-    if (pSubEntry->type == kObdTypeVString)
+//------------------------------------------------------------------------------
+/**
+\brief  Read resolved OD entry
+
+The function reads an OD entry which was looked up by obd_resolveEntry(). The
+object callback function is called like by obd_readEntry().
+
+\param      pEntryRef_p     Pointer to the references to the entry.
+\param      pDstData_p      Pointer to store the read data.
+\param      pSize_p         Pointer to size of buffer. The real data size will
+                            be written to this location.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+tOplkError obd_readResolvedEntry(tObdEntryRef* pEntryRef_p, void* pDstData_p, tObdSize* pSize_p)
+{
+    tObdSubEntryPtr                 pSubEntry;
+
+    if ((pDstData_p == NULL) || (pSize_p == NULL))
+        return kErrorInvalidInstanceParam;
+
+    pSubEntry = getResolvedSubEntry(pEntryRef_p);
+    if (pSubEntry == NULL)
+        return kErrorObdIndexNotExist;
+
+    return readEntry(pEntryRef_p->pObdEntry, pSubEntry, pEntryRef_p->subIndex, pDstData_p, pSize_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write resolved OD entry
+
+The function writes an OD entry which was looked up by obd_resolveEntry(). The
+access type is checked and the object callback function is called like by
+obd_writeEntry().
+
+\param      pEntryRef_p     Pointer to the references to the entry.
+\param      pSrcData_p      Pointer to the data to write.
+\param      size_p          Size of the data to write.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+tOplkError obd_writeResolvedEntry(tObdEntryRef* pEntryRef_p, void* pSrcData_p, tObdSize size_p)
+{
+    tOplkError              ret;
+    tObdSubEntryPtr         pSubEntry;
+    tObdCbParam MEM         cbParam;
+    void MEM*               pDstData;
+    tObdSize                obdSize;
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    tObdDomainStream*       pStream;
+#endif
+
+    pSubEntry = getResolvedSubEntry(pEntryRef_p);
+    if (pSubEntry == NULL)
+        return kErrorObdIndexNotExist;
+
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    pStream = getDomainStream(pSubEntry);
+    if (pStream != NULL)
+        return writeDomainStream(pSubEntry, pStream, pSrcData_p, size_p);
+#endif
+
+#if (CONFIG_OBD_FAST_ACCESS != FALSE)
+    if (isPlainObject(pEntryRef_p->pObdEntry, pSubEntry, OBD_PLAIN_WRITE_EXCL_ACCESS))
+        return writePlainObject(pEntryRef_p->pObdEntry, pSubEntry, pSrcData_p, size_p);
+#endif
+
+    ret = writeEntryPre(pEntryRef_p->pObdEntry, pSubEntry, pEntryRef_p->subIndex, pSrcData_p,
+                        &pDstData, size_p, &cbParam, &obdSize);
+    if (ret != kErrorOk)
+        return ret;
+
+    ret = writeEntryPost(pEntryRef_p->pObdEntry, pSubEntry, &cbParam, pSrcData_p, pDstData, obdSize);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Begin segmented write of OD entry
+
+The function prepares a write of an OD entry whose data is copied directly into
+the object in several parts, e.g. by the segments of an SDO download. The
+access type and the size are checked and the callback events kObdEvWrStringDomain
+and kObdEvInitWrite are called once for the whole write. The caller copies the
+data to pWrite_p->pData and completes the write by obd_finishSegmentedWrite().
+Strings and domains can't be written by a domain stream this way, they have to
+be accessed through the stream returned by obd_getDomainStream().
+
+\param      index_p         Index of the entry.
+\param      subIndex_p      Sub-index of the entry.
+\param      size_p          Size of the whole write.
+\param      pWrite_p        Pointer to store the description of the write.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+tOplkError obd_beginSegmentedWrite(UINT index_p, UINT subIndex_p, tObdSize size_p,
+                                   tObdSegmentedWrite* pWrite_p)
+{
+    tOplkError              ret;
+    tObdCbParam MEM         cbParam;
+    void MEM*               pDstData;
+    tObdSize                obdSize;
+
+    if (pWrite_p == NULL)
+        return kErrorInvalidInstanceParam;
+
+    pWrite_p->pData = NULL;
+    ret = obd_resolveEntry(index_p, subIndex_p, &pWrite_p->entryRef);
+    if (ret != kErrorOk)
+        return ret;
+
+    ret = writeEntryPre(pWrite_p->entryRef.pObdEntry, pWrite_p->entryRef.pSubEntry, subIndex_p,
+                        NULL, &pDstData, size_p, &cbParam, &obdSize);
+    if (ret != kErrorOk)
     {
-        if (*pSize_p > obdSize)
-        {   // space left to set the terminating null-character
-            ((char MEM*)pDstData_p)[obdSize] = '\0';
-            obdSize++;
-        }
+        pWrite_p->entryRef.pObdEntry = NULL;
+        return ret;
     }
-    *pSize_p = obdSize;
 
-    // write address of destination data to structure of callback parameters
-    // so callback function can change this data after reading
-    cbParam.pArg     = pDstData_p;
-    cbParam.obdEvent = kObdEvPostRead;
-    ret = callObjectCallback(pObdEntry->pfnCallback, &cbParam);
+    pWrite_p->pData = pDstData;
+    pWrite_p->size = obdSize;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Finish segmented write of OD entry
+
+The function completes a write which was prepared by obd_beginSegmentedWrite()
+after the data was copied into the object. The range of the value is checked
+and the callback events kObdEvPreWrite and kObdEvPostWrite are called like by
+obd_writeEntry(). Both see the new data already in the object.
+
+\param      pWrite_p        Pointer to the description of the write.
+\param      size_p          Number of bytes which were copied into the object.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+tOplkError obd_finishSegmentedWrite(tObdSegmentedWrite* pWrite_p, tObdSize size_p)
+{
+    tOplkError              ret;
+    tObdSubEntryPtr         pSubEntry;
+    tObdCbParam MEM         cbParam;
+    BOOL                    fEntryNumerical;
+
+    if ((pWrite_p == NULL) || (pWrite_p->pData == NULL))
+        return kErrorInvalidInstanceParam;
+
+    pSubEntry = getResolvedSubEntry(&pWrite_p->entryRef);
+    if (pSubEntry == NULL)
+        return kErrorObdIndexNotExist;
+
+    ret = isNumerical(pSubEntry, &fEntryNumerical);
+    if (ret != kErrorOk)
+        return ret;
+
+    if ((size_p > pWrite_p->size) || ((fEntryNumerical != FALSE) && (size_p != pWrite_p->size)))
+        return kErrorObdValueLengthError;
+
+    cbParam.index = pWrite_p->entryRef.pObdEntry->index;
+    cbParam.subIndex = pWrite_p->entryRef.subIndex;
+    ret = writeEntryPost(pWrite_p->entryRef.pObdEntry, pSubEntry, &cbParam,
+                         pWrite_p->pData, pWrite_p->pData, size_p);
+
+    pWrite_p->pData = NULL;
     return ret;
 }
 
@@ -469,6 +773,74 @@ tOplkError obd_defineVar(tVarParam MEM* pVarParam_p)
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Define a range of OD variables
+
+The function defines consecutive variables for consecutive sub-indices of an
+object. All variables have the same size and are located one after the other
+in memory. The object is looked up only once for the whole range.
+
+\param  index_p                 Index of the object.
+\param  firstSubindex_p         First sub-index to define.
+\param  subindexCount_p         Number of sub-indices to define.
+\param  entrySize_p             Size of one variable.
+\param  pData_p                 Pointer to the first variable.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+tOplkError obd_defineVarRange(UINT index_p, UINT firstSubindex_p, UINT subindexCount_p,
+                              tObdSize entrySize_p, void MEM* pData_p)
+{
+    tOplkError              ret;
+    tObdEntryPtr            pObdEntry;
+    tObdSubEntryPtr         pSubIndexEntry;
+    tObdVarEntry MEM*       pVarEntry;
+    tObdCbParam MEM         cbParam;
+    BYTE MEM*               pData = (BYTE MEM*)pData_p;
+    UINT                    subindex;
+
+    ret = getIndex(&obdInstance_l.initParam, index_p, &pObdEntry);
+    if (ret != kErrorOk)
+        return ret;
+
+    for (subindex = firstSubindex_p; subindexCount_p > 0;
+         subindex++, subindexCount_p--, pData += entrySize_p)
+    {
+        ret = getSubindex(pObdEntry, subindex, &pSubIndexEntry);
+        if (ret != kErrorOk)
+            return ret;
+
+        cbParam.index = index_p;
+        cbParam.subIndex = subindex;
+        cbParam.pArg = NULL;
+        cbParam.obdEvent = kObdEvCheckExist;
+        if (callObjectCallback(pObdEntry->pfnCallback, &cbParam) != kErrorOk)
+            return kErrorObdIndexNotExist;
+
+        ret = getVarEntry(pSubIndexEntry, &pVarEntry);
+        if (ret != kErrorOk)
+            return ret;
+
+        if (pSubIndexEntry->type != kObdTypeDomain)
+        {
+            if (getObjectSize(pSubIndexEntry) != entrySize_p)
+                return kErrorObdValueLengthError;
+        }
+        else
+        {   // size can be set only for objects of type DOMAIN
+            pVarEntry->size = entrySize_p;
+        }
+
+        pVarEntry->pData = pData;
+    }
+
+    return kErrorOk;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Get current data pointer of object entry
@@ -505,6 +877,13 @@ void* obd_getObjectDataPtr(UINT index_p, UINT subIndex_p)
         pData = NULL;
         return pData;
     }
+
+#if (CONFIG_OBD_LOAD_CHANGED_ONLY != FALSE)
+    // the object can be written through the pointer
+    markObjectChanged(index_p, TRUE);
+#endif
+    invalidateStringLen(pObdSubEntry, TRUE);
+
     pData = getObjectDataPtr(pObdSubEntry);
     return pData;
 }
@@ -525,7 +904,11 @@ The function registers a user object dictionary.
 //------------------------------------------------------------------------------
 tOplkError obd_registerUserOd(tObdEntryPtr pUserOd_p)
 {
-    obdInitParam_l.m_pUserPart = pUserOd_p;
+    obdInstance_l.initParam.pUserPart = pUserOd_p;
+    obdInstance_l.initParam.numUser = (pUserOd_p != NULL) ? calcPartitionIndexNum(pUserOd_p) : 0;
+#if (CONFIG_OBD_INDEX_HASH_SIZE != 0)
+    buildIndexHash(&obdInstance_l.initParam);
+#endif
     return kErrorOk;
 }
 #endif
@@ -757,14 +1140,63 @@ tOplkError obd_getType(UINT index_p, UINT subIndex_p, tObdType* pType_p)
 
 //------------------------------------------------------------------------------
 /**
-\brief  Read entry and convert it to little endian
-
-The function reads an object entry and converts numerical types into the little
-endian byte order for numerical types. For other types a normal read will be
-performed. This is useful for the PDO and SDO module.
+\brief  Get information about an entry
 
-The application can always read the data even if the attribute kObdAccRead is
-not set. The attribute is only checked on SDO transfers.
+The function returns the type, the access type, the data size, the numerical
+flag and the data pointer of an entry with a single lookup. This is useful for
+modules like the PDO module which need all of them.
+
+\param  index_p                 Index of object.
+\param  subIndex_p              Sub-index of object.
+\param  pEntryInfo_p            Pointer to store the information.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+tOplkError obd_getEntryInfo(UINT index_p, UINT subIndex_p, tObdEntryInfo* pEntryInfo_p)
+{
+    tOplkError          ret;
+    tObdEntryPtr        pObdEntry;
+    tObdSubEntryPtr     pObdSubEntry;
+
+    ret = getIndex(&obdInstance_l.initParam, index_p, &pObdEntry);
+    if (ret != kErrorOk)
+        return ret;
+
+    ret = getSubindex(pObdEntry, subIndex_p, &pObdSubEntry);
+    if (ret != kErrorOk)
+        return ret;
+
+    ret = isNumerical(pObdSubEntry, &pEntryInfo_p->fNumerical);
+    if (ret != kErrorOk)
+        return ret;
+
+    pEntryInfo_p->type = pObdSubEntry->type;
+    pEntryInfo_p->access = pObdSubEntry->access;
+    pEntryInfo_p->dataSize = getDataSize(pObdSubEntry);
+    pEntryInfo_p->pData = getObjectDataPtr(pObdSubEntry);
+
+#if (CONFIG_OBD_LOAD_CHANGED_ONLY != FALSE)
+    // the object can be written through the pointer (e.g. PDO mapping)
+    markObjectChanged(index_p, TRUE);
+#endif
+    invalidateStringLen(pObdSubEntry, TRUE);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read entry and convert it to little endian
+
+The function reads an object entry and converts numerical types into the little
+endian byte order for numerical types. For other types a normal read will be
+performed. This is useful for the PDO and SDO module.
+
+The application can always read the data even if the attribute kObdAccRead is
+not set. The attribute is only checked on SDO transfers.
 
 \param  index_p                 Index of object to read.
 \param  subIndex_p              Sub-index of object to read.
@@ -787,11 +1219,20 @@ tOplkError obd_readEntryToLe(UINT index_p, UINT subIndex_p, void* pDstData_p,
     tObdCbParam  MEM                cbParam;
     void*                           pSrcData;
     tObdSize                        obdSize;
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    tObdDomainStream*               pStream;
+#endif
 
     ret = getEntry(index_p, subIndex_p, &pObdEntry, &pSubEntry);
     if (ret != kErrorOk)
         return ret;
 
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    pStream = getDomainStream(pSubEntry);
+    if (pStream != NULL)
+        return readDomainStream(pStream, pDstData_p, pSize_p);
+#endif
+
     pSrcData = getObjectDataPtr(pSubEntry);
     if (pSrcData == NULL)
         return kErrorObdReadViolation;
@@ -806,6 +1247,10 @@ tOplkError obd_readEntryToLe(UINT index_p, UINT subIndex_p, void* pDstData_p,
     if (ret != kErrorOk)
         return ret;
 
+    // the callback function may have changed the string
+    if (pObdEntry->pfnCallback != NULL)
+        invalidateStringLen(pSubEntry, FALSE);
+
     // get size of data and check if application has reserved enough memory
     obdSize = getDataSize(pSubEntry);
     if (*pSize_p < obdSize)
@@ -919,12 +1364,39 @@ tOplkError obd_writeEntryFromLe(UINT index_p, UINT subIndex_p, void* pSrcData_p,
     tObdSize                obdSize;
     UINT64                  buffer;
     void*                   pBuffer = &buffer;
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    tObdDomainStream*       pStream;
+#endif
+#if (CONFIG_OBD_FAST_ACCESS != FALSE)
+    BOOL                    fPlain;
+#endif
 
-    ret = writeEntryPre(index_p, subIndex_p, pSrcData_p, &pDstData, size_p,
-                        &pObdEntry, &pSubEntry, &cbParam, &obdSize);
+    ret = getEntry(index_p, subIndex_p, &pObdEntry, &pSubEntry);
     if (ret != kErrorOk)
         return ret;
 
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    pStream = getDomainStream(pSubEntry);
+    if (pStream != NULL)
+        return writeDomainStream(pSubEntry, pStream, pSrcData_p, size_p);
+#endif
+
+#if (CONFIG_OBD_FAST_ACCESS != FALSE)
+    fPlain = isPlainObject(pObdEntry, pSubEntry, OBD_PLAIN_WRITE_EXCL_ACCESS);
+    if (fPlain)
+    {   // the size has to be checked before the source value is converted
+        if (size_p != getObjectSize(pSubEntry))
+            return kErrorObdValueLengthError;
+    }
+    else
+#endif
+    {
+        ret = writeEntryPre(pObdEntry, pSubEntry, subIndex_p, pSrcData_p, &pDstData, size_p,
+                            &cbParam, &obdSize);
+        if (ret != kErrorOk)
+            return ret;
+    }
+
     switch (pSubEntry->type)
     {
         case kObdTypeBool:
@@ -981,6 +1453,11 @@ tOplkError obd_writeEntryFromLe(UINT index_p, UINT subIndex_p, void* pSrcData_p,
             break;
     }
 
+#if (CONFIG_OBD_FAST_ACCESS != FALSE)
+    if (fPlain)
+        return writePlainObject(pObdEntry, pSubEntry, pBuffer, size_p);
+#endif
+
     ret = writeEntryPost(pObdEntry, pSubEntry, &cbParam, pBuffer, pDstData, obdSize);
     return ret;
 }
@@ -1018,6 +1495,35 @@ tOplkError obd_getAccessType(UINT index_p, UINT subIndex_p, tObdAccess* pAccessT
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Check if an object has a callback function
+
+The function checks if a callback function is registered for an object. The
+accesses to such an object call the function.
+
+\param  index_p                 Index of object.
+\param  pfCallback_p            Pointer to store the result. It is set to TRUE
+                                if the object has a callback function.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+tOplkError obd_hasCallback(UINT index_p, BOOL* pfCallback_p)
+{
+    tOplkError          ret;
+    tObdEntryPtr        pObdEntry;
+
+    ret = getIndex(&obdInstance_l.initParam, index_p, &pObdEntry);
+    if (ret != kErrorOk)
+        return ret;
+
+    *pfCallback_p = (pObdEntry->pfnCallback != NULL);
+    return kErrorOk;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Get VarEntry structure of object
@@ -1046,6 +1552,126 @@ tOplkError obd_searchVarEntry(UINT index_p, UINT subIndex_p, tObdVarEntry MEM**
     return ret;
 }
 
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+//------------------------------------------------------------------------------
+/**
+\brief  Set stream of a domain object
+
+The function backs a domain object with a stream. All accesses to the data of
+the object (local accesses and SDO transfers) are done by the callback
+function of the stream instead of the memory of the object. The object
+callback function is not called for the data accesses. A stream which is
+already set for the object is replaced.
+
+\param  index_p                 Index of the object.
+\param  subIndex_p              Sub-index of the object.
+\param  pStream_p               Pointer to the stream. NULL removes the stream
+                                from the object.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                    The stream was set.
+\retval kErrorObdUnknownObjectType  The object is no domain.
+\retval kErrorObdOutOfMemory        All streams are in use
+                                    (see CONFIG_OBD_DOMAIN_STREAM_COUNT).
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+tOplkError obd_setDomainStream(UINT index_p, UINT subIndex_p, tObdDomainStream* pStream_p)
+{
+    tOplkError              ret;
+    tObdSubEntryPtr         pSubEntry;
+    tObdVarEntry MEM*       pVarEntry = NULL;
+    UINT                    freeSlot = CONFIG_OBD_DOMAIN_STREAM_COUNT;
+    UINT                    slot;
+
+    ret = getEntry(index_p, subIndex_p, NULL, &pSubEntry);
+    if (ret != kErrorOk)
+        return ret;
+
+    if (pSubEntry->type != kObdTypeDomain)
+        return kErrorObdUnknownObjectType;
+
+    ret = getVarEntry(pSubEntry, &pVarEntry);
+    if (ret != kErrorOk)
+        return ret;
+
+    for (slot = 0; slot < CONFIG_OBD_DOMAIN_STREAM_COUNT; slot++)
+    {
+        if (obdInstance_l.apStreamVarEntry[slot] == pVarEntry)
+            break;
+
+        if ((obdInstance_l.apStreamVarEntry[slot] == NULL) && (freeSlot == CONFIG_OBD_DOMAIN_STREAM_COUNT))
+            freeSlot = slot;
+    }
+
+    if (slot == CONFIG_OBD_DOMAIN_STREAM_COUNT)
+    {
+        if (pStream_p == NULL)
+            return kErrorOk;
+
+        if (freeSlot == CONFIG_OBD_DOMAIN_STREAM_COUNT)
+            return kErrorObdOutOfMemory;
+
+        slot = freeSlot;
+    }
+
+    obdInstance_l.apStreamVarEntry[slot] = (pStream_p != NULL) ? pVarEntry : NULL;
+    obdInstance_l.apStream[slot] = pStream_p;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get stream of a domain object
+
+\param  index_p                 Index of the object.
+\param  subIndex_p              Sub-index of the object.
+
+\return The function returns a pointer to the stream of the object or NULL if
+        the object is not backed by a stream.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+tObdDomainStream* obd_getDomainStream(UINT index_p, UINT subIndex_p)
+{
+    tObdSubEntryPtr         pSubEntry;
+
+    if (getEntry(index_p, subIndex_p, NULL, &pSubEntry) != kErrorOk)
+        return NULL;
+
+    return getDomainStream(pSubEntry);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Release a domain stream
+
+The function removes a stream from all domain objects which are backed by it.
+It must be called before the stream becomes invalid.
+
+\param  pStream_p               Pointer to the stream.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+void obd_releaseDomainStream(tObdDomainStream* pStream_p)
+{
+    UINT                    slot;
+
+    for (slot = 0; slot < CONFIG_OBD_DOMAIN_STREAM_COUNT; slot++)
+    {
+        if (obdInstance_l.apStream[slot] == pStream_p)
+        {
+            obdInstance_l.apStreamVarEntry[slot] = NULL;
+            obdInstance_l.apStream[slot] = NULL;
+        }
+    }
+}
+#endif
+
 //------------------------------------------------------------------------------
 /**
 \brief  Set callback function for load/store command
@@ -1063,7 +1689,10 @@ The function sets the callback function for the load/store command.
 tOplkError obd_storeLoadObjCallback(tObdStoreLoadCallback pfnCallback_p)
 {
     // set new address of callback function
-    pfnStoreLoadObjectCb_l = pfnCallback_p;
+    obdInstance_l.pfnStoreLoadObjectCb = pfnCallback_p;
+
+    // the new callback does not know the stored data yet
+    obdInstance_l.storeDirtyParts = kObdPartAll;
     return kErrorOk;
 }
 #endif // (CONFIG_OBD_USE_STORE_RESTORE != FALSE)
@@ -1081,30 +1710,31 @@ tOplkError obd_storeLoadObjCallback(tObdStoreLoadCallback pfnCallback_p)
 The function prepares write of data to an OBD entry. Strings are stored with
 added '\0' character.
 
-\param  index_p                 Index of object.
+\param  pObdEntry_p             Pointer to object entry.
+\param  pSubEntry_p             Pointer to sub-index entry.
 \param  subIndex_p              Sub-index of object.
-\param  pSrcData_p              Points to the data which should be written.
+\param  pSrcData_p              Points to the data which should be written
+                                (NULL if it is copied into the object later).
 \param  ppDstData_p             Pointer to store object data pointer.
 \param  size_p                  Size of the data to be written.
-\param  ppObdEntry_p            Pointer to store pointer to object entry.
-\param  ppSubEntry_p            Pointer to store pointer to sub-index entry.
 \param  pCbParam_p              Points to the callback parameter structure.
 \param  pObdSize_p              Pointer to store size of the object.
 
 \return The function returns a tOplkError error code.
 */
 //------------------------------------------------------------------------------
-static tOplkError writeEntryPre(UINT index_p, UINT subIndex_p, void* pSrcData_p,
-                                void** ppDstData_p, tObdSize size_p, tObdEntryPtr* ppObdEntry_p,
-                                tObdSubEntryPtr* ppSubEntry_p, tObdCbParam MEM* pCbParam_p,
+static tOplkError writeEntryPre(tObdEntryPtr pObdEntry_p, tObdSubEntryPtr pSubEntry_p,
+                                UINT subIndex_p, void* pSrcData_p, void** ppDstData_p,
+                                tObdSize size_p, tObdCbParam MEM* pCbParam_p,
                                 tObdSize*  pObdSize_p)
 {
     tOplkError              ret;
-    tObdEntryPtr            pObdEntry;
-    tObdSubEntryPtr         pSubEntry;
+    tObdEntryPtr            pObdEntry = pObdEntry_p;
+    tObdSubEntryPtr         pSubEntry = pSubEntry_p;
     tObdAccess              access;
     void MEM*               pDstData;
     tObdSize                obdSize;
+    tObdSize                dataSize = size_p;
     BOOL                    fEntryNumerical;
 
 #if (CONFIG_OBD_USE_STRING_DOMAIN_IN_RAM != FALSE)
@@ -1112,10 +1742,6 @@ static tOplkError writeEntryPre(UINT index_p, UINT subIndex_p, void* pSrcData_p,
     void MEM*               pCurrData;
 #endif
 
-    ret = getEntry(index_p, subIndex_p, &pObdEntry, &pSubEntry);
-    if (ret != kErrorOk)
-        return ret;
-
     access = (tObdAccess)pSubEntry->access;
     // check access for write
     if ((access & kObdAccConst) != 0)
@@ -1124,7 +1750,7 @@ static tOplkError writeEntryPre(UINT index_p, UINT subIndex_p, void* pSrcData_p,
     // To use the same callback function for ObdWriteEntry as well as for
     // an SDO download call at first (kObdEvPre...) the callback function
     // with the argument pointer to object size.
-    pCbParam_p->index    = index_p;
+    pCbParam_p->index    = pObdEntry->index;
     pCbParam_p->subIndex = subIndex_p;
 
     // Because object size and object pointer are adapted by user callback
@@ -1160,6 +1786,7 @@ static tOplkError writeEntryPre(UINT index_p, UINT subIndex_p, void* pSrcData_p,
         {
             ((tObdVString MEM*)pCurrData)->size    = memVStringDomain.objSize;
             ((tObdVString MEM*)pCurrData)->pString = memVStringDomain.pData;
+            invalidateStringLen(pSubEntry, FALSE);
         }
         else
         {
@@ -1197,7 +1824,14 @@ static tOplkError writeEntryPre(UINT index_p, UINT subIndex_p, void* pSrcData_p,
     if (size_p > obdSize)
         return kErrorObdValueLengthError;
 
-    if (pSubEntry->type == kObdTypeVString)
+    if ((pSubEntry->type == kObdTypeVString) && (pSrcData_p == NULL))
+    {   // the data is copied later, so one byte is always reserved for 0-termination
+        if (dataSize >= obdSize)
+            return kErrorObdValueLengthError;
+
+        size_p = dataSize;
+    }
+    else if (pSubEntry->type == kObdTypeVString)
     {
         if (((char MEM*)pSrcData_p)[size_p - 1] == '\0')
         {   // last byte of source string contains null character
@@ -1223,8 +1857,6 @@ static tOplkError writeEntryPre(UINT index_p, UINT subIndex_p, void* pSrcData_p,
 
     // set output parameters
     *pObdSize_p = obdSize;
-    *ppObdEntry_p = pObdEntry;
-    *ppSubEntry_p = pSubEntry;
     *ppDstData_p = pDstData;
 
     // all checks are done
@@ -1232,6 +1864,125 @@ static tOplkError writeEntryPre(UINT index_p, UINT subIndex_p, void* pSrcData_p,
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Read OD entry data
+
+The function reads the data of an OD entry which was already looked up.
+
+\param  pObdEntry_p             Pointer to object entry.
+\param  pSubEntry_p             Pointer to sub-index entry.
+\param  subIndex_p              Sub-index of object.
+\param  pDstData_p              Pointer to store the read data.
+\param  pSize_p                 Pointer to size of buffer. The real data size
+                                will be written to this location.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError readEntry(tObdEntryPtr pObdEntry_p, tObdSubEntryPtr pSubEntry_p, UINT subIndex_p,
+                            void* pDstData_p, tObdSize* pSize_p)
+{
+    tOplkError                      ret;
+    tObdCbParam  MEM                cbParam;
+    void*                           pSrcData;
+    tObdSize                        obdSize;
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    tObdDomainStream*               pStream;
+
+    pStream = getDomainStream(pSubEntry_p);
+    if (pStream != NULL)
+        return readDomainStream(pStream, pDstData_p, pSize_p);
+#endif
+
+    pSrcData = getObjectDataPtr(pSubEntry_p);
+
+    // check source pointer
+    if (pSrcData == NULL)
+        return kErrorObdReadViolation;
+
+#if (CONFIG_OBD_FAST_ACCESS != FALSE)
+    if (isPlainObject(pObdEntry_p, pSubEntry_p, 0))
+    {   // no callback function can change the data, so it is copied directly
+        obdSize = dataTypeSize_l[pSubEntry_p->type].size;
+        if (*pSize_p < obdSize)
+            return kErrorObdValueLengthError;
+
+        OPLK_MEMCPY(pDstData_p, pSrcData, obdSize);
+        *pSize_p = obdSize;
+        return kErrorOk;
+    }
+#endif
+
+    // address of source data to structure of callback parameters
+    // so callback function can change this data before reading
+    cbParam.index = pObdEntry_p->index;
+    cbParam.subIndex = subIndex_p;
+    cbParam.pArg = pSrcData;
+    cbParam.obdEvent = kObdEvPreRead;
+    ret = callObjectCallback(pObdEntry_p->pfnCallback, &cbParam);
+    if (ret != kErrorOk)
+        return ret;
+
+    // the callback function may have changed the string
+    if (pObdEntry_p->pfnCallback != NULL)
+        invalidateStringLen(pSubEntry_p, FALSE);
+
+    // get size of data and check if application has reserved enough memory
+    obdSize = getDataSize(pSubEntry_p);
+    if (*pSize_p < obdSize)
+        return kErrorObdValueLengthError;
+
+    // read value from object
+    OPLK_MEMCPY(pDstData_p, pSrcData, obdSize);
+    if (pSubEntry_p->type == kObdTypeVString)
+    {
+        if (*pSize_p > obdSize)
+        {   // space left to set the terminating null-character
+            ((char MEM*)pDstData_p)[obdSize] = '\0';
+            obdSize++;
+        }
+    }
+    *pSize_p = obdSize;
+
+    // write address of destination data to structure of callback parameters
+    // so callback function can change this data after reading
+    cbParam.pArg     = pDstData_p;
+    cbParam.obdEvent = kObdEvPostRead;
+    ret = callObjectCallback(pObdEntry_p->pfnCallback, &cbParam);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get sub-index entry of a resolved entry
+
+The function returns the sub-index entry of an entry which was looked up by
+obd_resolveEntry(). The sub-index entry of an array is shared by all sub-indices
+of the array, therefore its sub-index number is updated.
+
+\param  pEntryRef_p             Pointer to the references to the entry.
+
+\return The function returns the pointer to the sub-index entry or NULL if the
+        entry was not resolved.
+*/
+//------------------------------------------------------------------------------
+static tObdSubEntryPtr getResolvedSubEntry(tObdEntryRef* pEntryRef_p)
+{
+    tObdSubEntryPtr         pSubEntry;
+
+    if ((pEntryRef_p == NULL) || (pEntryRef_p->pObdEntry == NULL))
+        return NULL;
+
+    pSubEntry = pEntryRef_p->pSubEntry;
+    if ((pSubEntry->access & kObdAccArray) != 0)
+    {
+        // update sub-index number (sub-index entry of an array is always in RAM !!!)
+        pSubEntry->subIndex = pEntryRef_p->subIndex;
+    }
+    return pSubEntry;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Finish writes to OD
@@ -1273,8 +2024,9 @@ static tOplkError writeEntryPost(tObdEntryPtr pObdEntry_p, tObdSubEntryPtr pSubE
     if (ret != kErrorOk)
         return ret;
 
-    // copy object data to OBD
-    OPLK_MEMCPY(pDstData_p, pSrcData_p, obdSize_p);
+    // copy object data to OBD, unless it was copied there directly
+    if (pDstData_p != pSrcData_p)
+        OPLK_MEMCPY(pDstData_p, pSrcData_p, obdSize_p);
 
     if (pSubEntry_p->type == kObdTypeVString)
     {
@@ -1286,89 +2038,365 @@ static tOplkError writeEntryPost(tObdEntryPtr pObdEntry_p, tObdSubEntryPtr pSubE
     pCbParam_p->pArg     = pDstData_p;
     pCbParam_p->obdEvent = kObdEvPostWrite;
     ret = callObjectCallback(pObdEntry_p->pfnCallback, pCbParam_p);
+
+    // the string is scanned once per write instead of once per read
+    if (pSubEntry_p->type == kObdTypeVString)
+        cacheStringLen(pSubEntry_p, getObdStringLen(pDstData_p, obdSize_p, kObdTypeVString));
+
+#if (CONFIG_OBD_USE_STORE_RESTORE != FALSE)
+    // the partition has to be stored again
+    if ((pSubEntry_p->access & kObdAccStore) != 0)
+        obdInstance_l.storeDirtyParts |= getOdPart(pObdEntry_p->index);
+#endif
+
+#if (CONFIG_OBD_LOAD_CHANGED_ONLY != FALSE)
+    // the object has to be loaded at the next reset
+    markObjectChanged(pObdEntry_p->index, FALSE);
+#endif
     return ret;
 }
 
+#if (CONFIG_OBD_FAST_ACCESS != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Check if an object can be accessed directly
+
+The function checks if an object is a plain object. A plain object has no
+callback function and a numerical type with a fixed size, therefore it can be
+read or written by copying its data without the callback events and the size
+adaptions of strings and domains.
+
+\param  pObdEntry_p             Pointer to object entry.
+\param  pSubEntry_p             Pointer to sub-index entry.
+\param  exclAccess_p            Access flags which require the normal access
+                                (e.g. kObdAccConst for writes).
+
+\return The function returns TRUE if the object is a plain object.
+*/
+//------------------------------------------------------------------------------
+static BOOL isPlainObject(tObdEntryPtr pObdEntry_p, tObdSubEntryPtr pSubEntry_p,
+                          tObdAccess exclAccess_p)
+{
+    if ((pObdEntry_p->pfnCallback != NULL) || ((pSubEntry_p->access & exclAccess_p) != 0))
+        return FALSE;
+
+    if (pSubEntry_p->type >= kObdTypeMax)
+        return FALSE;
+
+    // strings and domains determine their size by a function
+    return ((dataTypeSize_l[pSubEntry_p->type].pfnGetObjSize == NULL) &&
+            (dataTypeSize_l[pSubEntry_p->type].size != 0));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write plain object
+
+The function writes a plain object (see isPlainObject()). It does the same
+checks and bookkeeping as writeEntryPre() and writeEntryPost() for such an
+object.
+
+\param  pObdEntry_p             Pointer to object entry.
+\param  pSubEntry_p             Pointer to sub-index entry.
+\param  pSrcData_p              Points to the data in platform byte order.
+\param  size_p                  Size of the data to be written.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError writePlainObject(tObdEntryPtr pObdEntry_p, tObdSubEntryPtr pSubEntry_p,
+                                   void* pSrcData_p, tObdSize size_p)
+{
+    void MEM*               pDstData;
+
+    pDstData = (void MEM*)getObjectDataPtr(pSubEntry_p);
+    if (pDstData == NULL)
+        return kErrorObdAccessViolation;
+
+    if (size_p != dataTypeSize_l[pSubEntry_p->type].size)
+        return kErrorObdValueLengthError;
+
+    OPLK_MEMCPY(pDstData, pSrcData_p, size_p);
+
+#if (CONFIG_OBD_USE_STORE_RESTORE != FALSE)
+    if ((pSubEntry_p->access & kObdAccStore) != 0)
+        obdInstance_l.storeDirtyParts |= getOdPart(pObdEntry_p->index);
+#endif
+
+#if (CONFIG_OBD_LOAD_CHANGED_ONLY != FALSE)
+    markObjectChanged(pObdEntry_p->index, FALSE);
+#else
+    UNUSED_PARAMETER(pObdEntry_p);
+#endif
+    return kErrorOk;
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get data size of an object
+
+The function gets the data size of an object. For string objects it returns
+the string length without the terminating null-character.
+
+\param  pSubIndexEntry_p        Pointer to the sub-index entry of the object.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tObdSize getDataSize(tObdSubEntryPtr pSubIndexEntry_p)
+{
+    tObdSize            dataSize;
+    void MEM*           pData;
+    tObdVString MEM*    pString;
+
+    if (pSubIndexEntry_p->type == kObdTypeVString)
+    {
+        pString = getStringLenCache(pSubIndexEntry_p);
+        if ((pString != NULL) && (pString->lengthState == OBD_STRING_LEN_CACHED))
+            return pString->length;
+    }
+
+    // If OD entry is defined by macro OBD_SUBINDEX_ROM_VSTRING
+    // then the current pointer is always NULL. The function
+    // returns the length of default string.
+    dataSize = getObjectSize(pSubIndexEntry_p);
+
+    if (pSubIndexEntry_p->type == kObdTypeVString)
+    {
+        // The pointer to current value can be received from getObjectCurrentPtr()
+        pData = ((void MEM*)getObjectCurrentPtr(pSubIndexEntry_p));
+        if (pData != NULL)
+        {
+            dataSize = getObdStringLen((void *)pData, dataSize, pSubIndexEntry_p->type);
+            cacheStringLen(pSubIndexEntry_p, dataSize);
+        }
+    }
+    return dataSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get length of string
+
+The function calculates the length of string. The '\0' character is NOT
+included.
+
+\param  pObjData_p          The pointer to the object.
+\param  objLen_p            The maximum length of the object.
+\param  objType_p           The type of the object (VSTRING, ...)
+
+\return The function returns the size of the string.
+*/
+//------------------------------------------------------------------------------
+static tObdSize getObdStringLen(void* pObjData_p, tObdSize objLen_p, tObdType objType_p)
+{
+    tObdSize        strLen = 0;
+    UINT8*          pString;
+
+    if (pObjData_p == NULL)
+        return 0;
+
+    // Visible String: data format byte
+    if (objType_p == kObdTypeVString)
+    {
+        pString = pObjData_p;
+        for (strLen = 0; strLen < objLen_p; strLen++)
+        {
+            if (*pString == '\0')
+                break;
+            pString++;
+        }
+    }
+    else
+    {
+        // all other types
+        strLen = 0;
+    }
+    return strLen;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get length cache of a VSTRING object
+
+The function returns the current value structure of a VSTRING object, which
+caches the length of the string. Strings which are linked to application
+variables or are part of an array have no length cache, because their current
+value is no tObdVString.
+
+\param  pSubIndexEntry_p        Pointer to sub-index entry.
+
+\return The function returns a pointer to the current value structure or NULL
+        if the object has no length cache.
+*/
+//------------------------------------------------------------------------------
+static tObdVString MEM* getStringLenCache(tObdSubEntryPtr pSubIndexEntry_p)
+{
+    if ((pSubIndexEntry_p->type != kObdTypeVString) || (pSubIndexEntry_p->pCurrent == NULL) ||
+        ((pSubIndexEntry_p->access & (kObdAccVar | kObdAccArray)) != 0))
+        return NULL;
+
+    return (tObdVString MEM*)pSubIndexEntry_p->pCurrent;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Cache the length of a VSTRING object
+
+\param  pSubIndexEntry_p        Pointer to sub-index entry.
+\param  length_p                Current length of the string.
+*/
+//------------------------------------------------------------------------------
+static void cacheStringLen(tObdSubEntryPtr pSubIndexEntry_p, tObdSize length_p)
+{
+    tObdVString MEM*    pString;
+
+    pString = getStringLenCache(pSubIndexEntry_p);
+    if ((pString == NULL) || (pString->lengthState == OBD_STRING_LEN_PINNED))
+        return;
+
+    pString->length = length_p;
+    pString->lengthState = OBD_STRING_LEN_CACHED;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Invalidate the cached length of a VSTRING object
+
+The function invalidates the cached length after the string was changed
+without a write access of the OD. A pinned string is never cached again, since
+it can be changed through a pointer at any time (e.g. by a PDO).
+
+\param  pSubIndexEntry_p        Pointer to sub-index entry.
+\param  fPin_p                  Pin the string.
+*/
+//------------------------------------------------------------------------------
+static void invalidateStringLen(tObdSubEntryPtr pSubIndexEntry_p, BOOL fPin_p)
+{
+    tObdVString MEM*    pString;
+
+    pString = getStringLenCache(pSubIndexEntry_p);
+    if (pString == NULL)
+        return;
+
+    if (fPin_p)
+        pString->lengthState = OBD_STRING_LEN_PINNED;
+    else if (pString->lengthState != OBD_STRING_LEN_PINNED)
+        pString->lengthState = OBD_STRING_LEN_UNKNOWN;
+}
+
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+//------------------------------------------------------------------------------
+/**
+\brief  Get stream of a domain entry
+
+\param  pSubEntry_p             Pointer to sub-index entry.
+
+\return The function returns a pointer to the stream of the entry or NULL if
+        the entry is not backed by a stream.
+*/
+//------------------------------------------------------------------------------
+static tObdDomainStream* getDomainStream(tObdSubEntryPtr pSubEntry_p)
+{
+    tObdVarEntry MEM*       pVarEntry = NULL;
+    UINT                    slot;
+
+    if ((pSubEntry_p->type != kObdTypeDomain) || (getVarEntry(pSubEntry_p, &pVarEntry) != kErrorOk))
+        return NULL;
+
+    for (slot = 0; slot < CONFIG_OBD_DOMAIN_STREAM_COUNT; slot++)
+    {
+        if (obdInstance_l.apStreamVarEntry[slot] == pVarEntry)
+            return obdInstance_l.apStream[slot];
+    }
+
+    return NULL;
+}
+
 //------------------------------------------------------------------------------
 /**
-\brief  Get data size of an object
+\brief  Read a domain stream
 
-The function gets the data size of an object. For string objects it returns
-the string length without the terminating null-character.
+The function reads the complete data of a domain stream into a buffer.
 
-\param  pSubIndexEntry_p        Pointer to the sub-index entry of the object.
+\param  pStream_p               Pointer to the stream.
+\param  pDstData_p              Pointer to store the read data.
+\param  pSize_p                 Pointer to size of buffer. The real data size
+                                will be written to this location.
 
 \return The function returns a tOplkError error code.
 */
 //------------------------------------------------------------------------------
-static tObdSize getDataSize(tObdSubEntryPtr pSubIndexEntry_p)
+static tOplkError readDomainStream(tObdDomainStream* pStream_p, void* pDstData_p, tObdSize* pSize_p)
 {
-    tObdSize    dataSize;
-    void MEM*   pData;
+    tOplkError              ret;
+    UINT32                  size = pStream_p->size;
 
-    // If OD entry is defined by macro OBD_SUBINDEX_ROM_VSTRING
-    // then the current pointer is always NULL. The function
-    // returns the length of default string.
-    dataSize = getObjectSize(pSubIndexEntry_p);
+    if (*pSize_p < size)
+        return kErrorObdValueLengthError;
 
-    if (pSubIndexEntry_p->type == kObdTypeVString)
+    ret = pStream_p->pfnAccess(pStream_p->pArg, kObdDomainStreamOpen, 0, NULL, size);
+    if (ret != kErrorOk)
+        return ret;
+
+    ret = pStream_p->pfnAccess(pStream_p->pArg, kObdDomainStreamRead, 0, pDstData_p, size);
+    if (ret != kErrorOk)
     {
-        // The pointer to current value can be received from getObjectCurrentPtr()
-        pData = ((void MEM*)getObjectCurrentPtr(pSubIndexEntry_p));
-        if (pData != NULL)
-        {
-            dataSize = getObdStringLen((void *)pData, dataSize, pSubIndexEntry_p->type);
-        }
+        pStream_p->pfnAccess(pStream_p->pArg, kObdDomainStreamAbort, 0, NULL, 0);
+        return ret;
     }
-    return dataSize;
+
+    *pSize_p = size;
+    return pStream_p->pfnAccess(pStream_p->pArg, kObdDomainStreamClose, size, NULL, 0);
 }
 
 //------------------------------------------------------------------------------
 /**
-\brief  Get length of string
+\brief  Write a domain stream
 
-The function calculates the length of string. The '\0' character is NOT
-included.
+The function writes the complete data of a domain stream from a buffer.
 
-\param  pObjData_p          The pointer to the object.
-\param  objLen_p            The maximum length of the object.
-\param  objType_p           The type of the object (VSTRING, ...)
+\param  pSubEntry_p             Pointer to sub-index entry.
+\param  pStream_p               Pointer to the stream.
+\param  pSrcData_p              Pointer to the data to write.
+\param  size_p                  Size of the data to write.
 
-\return The function returns the size of the string.
+\return The function returns a tOplkError error code.
 */
 //------------------------------------------------------------------------------
-static tObdSize getObdStringLen(void* pObjData_p, tObdSize objLen_p, tObdType objType_p)
+static tOplkError writeDomainStream(tObdSubEntryPtr pSubEntry_p, tObdDomainStream* pStream_p,
+                                    void* pSrcData_p, tObdSize size_p)
 {
-    tObdSize        strLen = 0;
-    UINT8*          pString;
+    tOplkError              ret;
 
-    if (pObjData_p == NULL)
-        return 0;
+    if ((pSubEntry_p->access & kObdAccConst) != 0)
+        return kErrorObdAccessViolation;
 
-    // Visible String: data format byte
-    if (objType_p == kObdTypeVString)
-    {
-        pString = pObjData_p;
-        for (strLen = 0; strLen < objLen_p; strLen++)
-        {
-            if (*pString == '\0')
-                break;
-            pString++;
-        }
-    }
-    else
+    if (size_p > pStream_p->maxSize)
+        return kErrorObdValueLengthError;
+
+    ret = pStream_p->pfnAccess(pStream_p->pArg, kObdDomainStreamOpen, 0, NULL, size_p);
+    if (ret != kErrorOk)
+        return ret;
+
+    ret = pStream_p->pfnAccess(pStream_p->pArg, kObdDomainStreamWrite, 0, pSrcData_p, size_p);
+    if (ret != kErrorOk)
     {
-        // all other types
-        strLen = 0;
+        pStream_p->pfnAccess(pStream_p->pArg, kObdDomainStreamAbort, 0, NULL, 0);
+        return ret;
     }
-    return strLen;
+
+    return pStream_p->pfnAccess(pStream_p->pArg, kObdDomainStreamClose, size_p, NULL, 0);
 }
+#endif
 
 //------------------------------------------------------------------------------
 /**
 \brief  Get size of domain object
 
-The function returns the size of a domain object.
+The function returns the size of a domain object. The size of a domain which is
+backed by a stream is the current size of the stream.
 
 \param  pSubIndexEntry_p        Pointer to sub-index entry.
 
@@ -1381,6 +2409,14 @@ static tObdSize getDomainSize(tObdSubEntryPtr pSubIndexEntry_p)
     tObdVarEntry MEM*       pVarEntry = NULL;
     tOplkError              ret;
 
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    tObdDomainStream*       pStream;
+
+    pStream = getDomainStream(pSubIndexEntry_p);
+    if (pStream != NULL)
+        return pStream->size;
+#endif
+
     ret = getVarEntry(pSubIndexEntry_p, &pVarEntry);
     if ((ret == kErrorOk) && (pVarEntry != NULL))
     {
@@ -1779,7 +2815,8 @@ static UINT32 calcPartitionIndexNum(tObdEntryPtr pObdEntry_p)
 /**
 \brief  Calculate number of OD entries
 
-The function calculates the number of OD index entries in the OD.
+The function calculates the number of OD index entries in the OD. The numbers
+of the partitions which were already set by obd_initObd() are kept.
 
 \param  pInitParam_p        Pointer to the OD initialization parameters.
 */
@@ -1788,20 +2825,138 @@ static void calcOdIndexNum(tObdInitParam* pInitParam_p)
 {
     tObdEntryPtr    pObdEntry;
 
-    pObdEntry = pInitParam_p->pGenericPart;
-    pInitParam_p->numGeneric = calcPartitionIndexNum(pObdEntry);
+    // the numbers of entries are already set if obd_initObd() precomputed them
+    // from the size of the index tables
+    if (pInitParam_p->numGeneric == 0)
+    {
+        pObdEntry = pInitParam_p->pGenericPart;
+        pInitParam_p->numGeneric = calcPartitionIndexNum(pObdEntry);
+    }
 
-    pObdEntry = pInitParam_p->pManufacturerPart;
-    pInitParam_p->numManufacturer = calcPartitionIndexNum(pObdEntry);
+    if (pInitParam_p->numManufacturer == 0)
+    {
+        pObdEntry = pInitParam_p->pManufacturerPart;
+        pInitParam_p->numManufacturer = calcPartitionIndexNum(pObdEntry);
+    }
 
-    pObdEntry = pInitParam_p->pDevicePart;
-    pInitParam_p->numDevice = calcPartitionIndexNum(pObdEntry);
+    if (pInitParam_p->numDevice == 0)
+    {
+        pObdEntry = pInitParam_p->pDevicePart;
+        pInitParam_p->numDevice = calcPartitionIndexNum(pObdEntry);
+    }
 
 #if (defined (OBD_USER_OD) && (OBD_USER_OD != FALSE))
     pObdEntry = pInitParam_p->pUserPart;
-    pInitParam_p->numUser = calcPartitionIndexNum(pObdEntry);
+    pInitParam_p->numUser = (pObdEntry != NULL) ? calcPartitionIndexNum(pObdEntry) : 0;
+#endif
+}
+
+#if (CONFIG_OBD_INDEX_HASH_SIZE != 0)
+//------------------------------------------------------------------------------
+/**
+\brief  Build index hash table
+
+The function builds the hash table which maps the indices of all OD parts to
+their OD entries. If the hash table is too small for the OD, it is disabled and
+the indices are searched by binary search.
+
+\param  pInitParam_p        Pointer to the OD initialization parameters.
+*/
+//------------------------------------------------------------------------------
+static void buildIndexHash(tObdInitParam* pInitParam_p)
+{
+    UINT32          numEntries;
+
+    obdInstance_l.fIndexHashValid = FALSE;
+    OPLK_MEMSET(obdInstance_l.apIndexHash, 0, sizeof(obdInstance_l.apIndexHash));
+
+    numEntries = pInitParam_p->numGeneric + pInitParam_p->numManufacturer +
+                 pInitParam_p->numDevice;
+#if (defined (OBD_USER_OD) && (OBD_USER_OD != FALSE))
+    if (pInitParam_p->pUserPart != NULL)
+        numEntries += pInitParam_p->numUser;
+#endif
+
+    if (numEntries > OBD_INDEX_HASH_MAX_ENTRIES)
+    {
+        DEBUG_LVL_OBD_TRACE("%s() OD with %u indices exceeds hash table, using binary search!\n",
+                            __func__, (UINT)numEntries);
+        return;
+    }
+
+    // The static OD parts are added first, so they hide objects of the user
+    // OD with the same index like the binary search does.
+    addPartitionToIndexHash(pInitParam_p->pGenericPart, pInitParam_p->numGeneric);
+    addPartitionToIndexHash(pInitParam_p->pManufacturerPart, pInitParam_p->numManufacturer);
+    addPartitionToIndexHash(pInitParam_p->pDevicePart, pInitParam_p->numDevice);
+#if (defined (OBD_USER_OD) && (OBD_USER_OD != FALSE))
+    if (pInitParam_p->pUserPart != NULL)
+        addPartitionToIndexHash(pInitParam_p->pUserPart, pInitParam_p->numUser);
 #endif
+
+    obdInstance_l.fIndexHashValid = TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add OD partition to index hash table
+
+The function adds the OD entries of a partition to the index hash table. An
+index which is already in the hash table is not added again. The hash table
+uses linear probing.
+
+\param  pObdEntry_p         Pointer to the first index entry of the partition.
+\param  numEntries_p        Number of index entries in the partition.
+*/
+//------------------------------------------------------------------------------
+static void addPartitionToIndexHash(tObdEntryPtr pObdEntry_p, UINT32 numEntries_p)
+{
+    UINT            slot;
+
+    for (; numEntries_p > 0; numEntries_p--, pObdEntry_p++)
+    {
+        slot = OBD_INDEX_HASH(pObdEntry_p->index);
+        while (obdInstance_l.apIndexHash[slot] != NULL)
+        {
+            if (obdInstance_l.apIndexHash[slot]->index == pObdEntry_p->index)
+                break;
+
+            slot = (slot + 1) & OBD_INDEX_HASH_MASK;
+        }
+
+        if (obdInstance_l.apIndexHash[slot] == NULL)
+            obdInstance_l.apIndexHash[slot] = pObdEntry_p;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Look up index in hash table
+
+The function looks up an index in the index hash table.
+
+\param  index_p             Index to search.
+
+\return The function returns the pointer to the OD entry of the searched index.
+        If the index isn't found it returns NULL.
+*/
+//------------------------------------------------------------------------------
+static tObdEntryPtr lookupIndexHash(UINT index_p)
+{
+    UINT            slot;
+    tObdEntryPtr    pObdEntry;
+
+    slot = OBD_INDEX_HASH(index_p);
+    while ((pObdEntry = obdInstance_l.apIndexHash[slot]) != NULL)
+    {
+        if (pObdEntry->index == index_p)
+            return pObdEntry;
+
+        slot = (slot + 1) & OBD_INDEX_HASH_MASK;
+    }
+    return NULL;
 }
+#endif
 
 //------------------------------------------------------------------------------
 /**
@@ -1830,6 +2985,18 @@ static tOplkError getIndex(tObdInitParam MEM* pInitParam_p, UINT index_p,
     nLoop = 2;
 #endif
 
+#if (CONFIG_OBD_DEFER_DEFAULTS != FALSE)
+    // the partition of the object is accessed the first time
+    if (obdInstance_l.deferredParts != kObdPartNo)
+    {
+#if (defined (OBD_USER_OD) && (OBD_USER_OD != FALSE))
+        loadDeferredDefaults(getOdPart(index_p) | kObdPartUsr);
+#else
+        loadDeferredDefaults(getOdPart(index_p));
+#endif
+    }
+#endif
+
     // get start address of OD part
     // start address depends on object index because
     // object dictionary is divided in 3 parts
@@ -1881,6 +3048,16 @@ static tOplkError getIndex(tObdInitParam MEM* pInitParam_p, UINT index_p,
     }
 #endif
 
+#if (CONFIG_OBD_INDEX_HASH_SIZE != 0)
+    if (obdInstance_l.fIndexHashValid)
+    {   // the hash table contains the indices of all OD parts
+        if ((*ppObdEntry_p = lookupIndexHash(index_p)) != NULL)
+            return kErrorOk;
+
+        return kErrorObdIndexNotExist;
+    }
+#endif
+
 #if (defined (OBD_USER_OD) && (OBD_USER_OD != FALSE))
     do
     {
@@ -1924,12 +3101,38 @@ static tOplkError getSubindex(tObdEntryPtr pObdEntry_p, UINT subIndex_p,
                               tObdSubEntryPtr* ppObdSubEntry_p)
 {
     tObdSubEntryPtr     pSubEntry;
+    tObdSubEntryPtr     pDirectEntry;
     UINT                nSubIndexCount;
 
     // get start address of sub-index table and count of sub-indices
     pSubEntry =      pObdEntry_p->pSubIndex;
     nSubIndexCount = pObdEntry_p->count;
 
+    // Try to access the sub-index entry directly. The sub-indices of most
+    // objects are numbered consecutively and the sub-index entry of an array
+    // is always located behind sub-index 0.
+    if (subIndex_p < nSubIndexCount)
+    {
+        if ((subIndex_p > 1) && ((pSubEntry[1].access & kObdAccArray) != 0))
+            pDirectEntry = &pSubEntry[1];
+        else
+            pDirectEntry = &pSubEntry[subIndex_p];
+
+        if ((pDirectEntry->access & kObdAccArray) != 0)
+        {
+            // update sub-index number (sub-index entry of an array is always in RAM !!!)
+            pDirectEntry->subIndex = subIndex_p;
+            *ppObdSubEntry_p = pDirectEntry;
+            return kErrorOk;
+        }
+
+        if (pDirectEntry->subIndex == subIndex_p)
+        {
+            *ppObdSubEntry_p = pDirectEntry;
+            return kErrorOk;
+        }
+    }
+
     // search sub-index in sub-index table
     while (nSubIndexCount > 0)
     {
@@ -1988,27 +3191,76 @@ static tOplkError accessOdPartition(tObdPart currentOdPart_p, tObdEntryPtr pObdE
 
 #if (CONFIG_OBD_USE_STORE_RESTORE != FALSE)
     tObdCbStoreParam MEM        CbStore;
+    BOOL                        fStoreLoaded = TRUE;
 #else
     UNUSED_PARAMETER(currentOdPart_p);
 #endif
+#if (CONFIG_OBD_LOAD_CHANGED_ONLY != FALSE)
+    BOOL                        fLoadChanged = FALSE;
+#endif
 
 #if (CONFIG_OBD_USE_STORE_RESTORE != FALSE)
+    // a partition which did not change since it was stored or loaded need not be stored again
+    if ((direction_p == kObdDirStore) &&
+        (((obdInstance_l.storeDirtyParts | obdInstance_l.storeVarParts) & currentOdPart_p) == 0))
+        return kErrorOk;
+
     // prepare structure for STORE RESTORE callback function
     CbStore.currentOdPart   = (BYTE)currentOdPart_p;
     CbStore.pData           = NULL;
     CbStore.objSize         = 0;
+    CbStore.index           = 0;
+    CbStore.subIndex        = 0;
 
     // command of first action depends on direction to access
     if ((Ret = prepareStoreRestore(direction_p, &CbStore)) != kErrorOk)
         return Ret;
 #endif
 
+#if (CONFIG_OBD_DEFER_DEFAULTS != FALSE)
+    // loading copies the default values, storing needs them copied before
+    if (direction_p == kObdDirLoad)
+        obdInstance_l.deferredParts &= ~currentOdPart_p;
+    else if (direction_p == kObdDirStore)
+        loadDeferredDefaults(currentOdPart_p);
+#endif
+
+#if (CONFIG_OBD_LOAD_CHANGED_ONLY != FALSE)
+    // Unchanged communication objects still contain their default values. If
+    // the objects are loaded from non-volatile memory, all objects have to be
+    // read in order.
+    if ((direction_p == kObdDirLoad) && (currentOdPart_p == kObdPartGen))
+    {
+        fLoadChanged = obdInstance_l.fGenPartLoaded;
+#if (CONFIG_OBD_USE_STORE_RESTORE != FALSE)
+        if (obdInstance_l.pfnStoreLoadObjectCb != NULL)
+            fLoadChanged = FALSE;
+#endif
+    }
+    else if (direction_p == kObdDirRestore)
+    {
+        obdInstance_l.fGenPartLoaded = FALSE;
+    }
+#endif
+
     // we should not restore the OD values here
     // the next NMT command "Reset Node" or "Reset Communication" resets the OD data
     if (direction_p != kObdDirRestore)
     {
         while (pObdEntry_p->index != OBD_TABLE_INDEX_END)    // walk through OD part till end is found
         {
+#if (CONFIG_OBD_LOAD_CHANGED_ONLY != FALSE)
+            if (fLoadChanged && !isObjectChanged(pObdEntry_p->index))
+            {
+                pObdEntry_p++;
+                continue;
+            }
+
+            // objects with a callback function may need the kObdEvPostDefault event
+            if ((direction_p == kObdDirLoad) && (pObdEntry_p->pfnCallback != NULL))
+                markObjectChanged(pObdEntry_p->index, TRUE);
+#endif
+
             pSubIndex = pObdEntry_p->pSubIndex;
             nSubIndexCount = pObdEntry_p->count;
 
@@ -2018,6 +3270,10 @@ static tOplkError accessOdPartition(tObdPart currentOdPart_p, tObdEntryPtr pObdE
                 pDefault = getObjectDefaultPtr(pSubIndex);
                 pDstData = getObjectCurrentPtr(pSubIndex);
                 ObjSize  = getObjectSize(pSubIndex);
+#if (CONFIG_OBD_USE_STORE_RESTORE != FALSE)
+                CbStore.index    = pObdEntry_p->index;
+                CbStore.subIndex = pSubIndex->subIndex;
+#endif
 
                 switch (direction_p)
                 {
@@ -2027,6 +3283,11 @@ static tOplkError accessOdPartition(tObdPart currentOdPart_p, tObdEntryPtr pObdE
                         // Address of data has to be get from this structure.
                         if ((Access & kObdAccVar) != 0)
                         {
+#if (CONFIG_OBD_USE_STORE_RESTORE != FALSE)
+                            // changes of application variables are not seen by the OD
+                            if ((Access & kObdAccStore) != 0)
+                                obdInstance_l.storeVarParts |= currentOdPart_p;
+#endif
                             getVarEntry(pSubIndex, &pVarEntry);
                             obd_initVarEntry(pVarEntry, pSubIndex->type, ObjSize);
                             // at this time no application variable is defined therefore data can not be copied!
@@ -2063,16 +3324,26 @@ static tOplkError accessOdPartition(tObdPart currentOdPart_p, tObdEntryPtr pObdE
                             }
                         }
 
+#if (CONFIG_OBD_DEFER_DEFAULTS != FALSE)
+                        if ((obdInstance_l.deferredParts & currentOdPart_p) != 0)
+                            break;
+#endif
                         copyObjectData(pDstData, pDefault, ObjSize, pSubIndex->type);
                         callPostDefault(pDstData, pObdEntry_p, pSubIndex);
                         break;
 
                     // objects with attribute kObdAccStore has to be load from EEPROM or from a file
                     case kObdDirLoad:
+#if (CONFIG_OBD_LOAD_CHANGED_ONLY != FALSE)
+                        // application variables are changed without the OD
+                        if ((Access & kObdAccVar) != 0)
+                            markObjectChanged(pObdEntry_p->index, TRUE);
+#endif
                         copyObjectData(pDstData, pDefault, ObjSize, pSubIndex->type);
                         callPostDefault(pDstData, pObdEntry_p, pSubIndex);
 #if (CONFIG_OBD_USE_STORE_RESTORE != FALSE)
-                        doStoreRestore(Access, &CbStore, pDstData, ObjSize);
+                        if (doStoreRestore(Access, &CbStore, pDstData, ObjSize) != kErrorOk)
+                            fStoreLoaded = FALSE;
 #endif
                         break;
 
@@ -2094,6 +3365,9 @@ static tOplkError accessOdPartition(tObdPart currentOdPart_p, tObdEntryPtr pObdE
                         break;
                 }
 
+                // the string may have been replaced by the default or the stored value
+                invalidateStringLen(pSubIndex, FALSE);
+
                 nSubIndexCount--;
 
                 // next sub-index entry
@@ -2117,9 +3391,27 @@ static tOplkError accessOdPartition(tObdPart currentOdPart_p, tObdEntryPtr pObdE
         }
     }
 
+#if (CONFIG_OBD_LOAD_CHANGED_ONLY != FALSE)
+    if ((direction_p == kObdDirLoad) && (currentOdPart_p == kObdPartGen))
+    {   // only the pinned objects are changed without a write access
+        OPLK_MEMCPY(obdInstance_l.aGenChanged, obdInstance_l.aGenPinned,
+                    sizeof(obdInstance_l.aGenChanged));
+        obdInstance_l.fGenPartLoaded = TRUE;
+    }
+#endif
+
     // command of last action depends on direction to access
 #if (CONFIG_OBD_USE_STORE_RESTORE != FALSE)
-    return cleanupStoreRestore(direction_p, &CbStore);
+    Ret = cleanupStoreRestore(direction_p, &CbStore);
+    if (Ret != kErrorOk)
+        return Ret;
+
+    // only a partition which equals the stored data is clean
+    if ((direction_p == kObdDirStore) || ((direction_p == kObdDirLoad) && fStoreLoaded))
+        obdInstance_l.storeDirtyParts &= ~currentOdPart_p;
+    else if ((direction_p == kObdDirLoad) || (direction_p == kObdDirRestore))
+        obdInstance_l.storeDirtyParts |= currentOdPart_p;
+    return Ret;
 #else
     return Ret;
 #endif
@@ -2226,6 +3518,89 @@ static tOplkError callPostDefault(void* pData_p, tObdEntryPtr pObdEntry_p,
     return ret;
 }
 
+#if (CONFIG_OBD_DEFER_DEFAULTS != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Copy deferred default values
+
+The function copies the default values of the specified OD partitions which
+were deferred at obd_init(). The VarEntries of the partitions are initialized
+again, this is no problem because no variable can be linked to a partition
+before it is accessed.
+
+\param  obdPart_p               OD partitions which are accessed.
+*/
+//------------------------------------------------------------------------------
+static void loadDeferredDefaults(tObdPart obdPart_p)
+{
+    tObdPart        obdPart;
+    tOplkError      ret;
+
+    obdPart = (tObdPart)(obdInstance_l.deferredParts & obdPart_p);
+    if (obdPart == kObdPartNo)
+        return;
+
+    obdInstance_l.deferredParts &= ~obdPart;
+    ret = obd_accessOdPart(obdPart, kObdDirInit);
+    if ((ret != kErrorOk) && (ret != kErrorObdIllegalPart))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Loading defaults of OD part 0x%X failed with 0x%X\n",
+                              __func__, obdPart, ret);
+    }
+}
+#endif
+
+#if (CONFIG_OBD_LOAD_CHANGED_ONLY != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Mark object as changed
+
+The function marks a communication object as changed so that it is loaded again
+by the next NMT reset. A pinned object is loaded by every NMT reset because it
+can be changed without a write access of the OD.
+
+\param  index_p                 Index of the object.
+\param  fPin_p                  The object is pinned.
+*/
+//------------------------------------------------------------------------------
+static void markObjectChanged(UINT index_p, BOOL fPin_p)
+{
+    UINT        offset;
+
+    if ((index_p < OBD_GEN_PART_FIRST_INDEX) ||
+        (index_p >= OBD_GEN_PART_FIRST_INDEX + OBD_GEN_PART_INDEX_COUNT))
+        return;
+
+    offset = index_p - OBD_GEN_PART_FIRST_INDEX;
+    obdInstance_l.aGenChanged[offset >> 3] |= (UINT8)(1 << (offset & 7));
+    if (fPin_p)
+        obdInstance_l.aGenPinned[offset >> 3] |= (UINT8)(1 << (offset & 7));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check if object was changed
+
+The function checks if a communication object was changed since the last load.
+
+\param  index_p                 Index of the object.
+
+\return The function returns TRUE if the object has to be loaded.
+*/
+//------------------------------------------------------------------------------
+static BOOL isObjectChanged(UINT index_p)
+{
+    UINT        offset;
+
+    if ((index_p < OBD_GEN_PART_FIRST_INDEX) ||
+        (index_p >= OBD_GEN_PART_FIRST_INDEX + OBD_GEN_PART_INDEX_COUNT))
+        return TRUE;
+
+    offset = index_p - OBD_GEN_PART_FIRST_INDEX;
+    return ((obdInstance_l.aGenChanged[offset >> 3] & (1 << (offset & 7))) != 0);
+}
+#endif
+
 //------------------------------------------------------------------------------
 /**
 \brief  Check if object is numerical
@@ -2509,7 +3884,7 @@ The functions cleans up a store/restore command.
 //------------------------------------------------------------------------------
 static tOplkError cleanupStoreRestore(tObdDir direction_p, tObdCbStoreParam MEM* pCbStore_p)
 {
-    tOplkError          ret;
+    tOplkError          ret = kErrorOk;
 
     if (direction_p == kObdDirOBKCheck)
     {
@@ -2584,13 +3959,44 @@ static tOplkError callStoreCallback(tObdCbStoreParam MEM* pCbStoreParam_p)
 {
     tOplkError ret = kErrorOk;
 
-    if (pfnStoreLoadObjectCb_l != NULL)
+    if (obdInstance_l.pfnStoreLoadObjectCb != NULL)
     {
-        ret = pfnStoreLoadObjectCb_l(pCbStoreParam_p);
+        ret = obdInstance_l.pfnStoreLoadObjectCb(pCbStoreParam_p);
     }
     return ret;
 }
 #endif // (CONFIG_OBD_USE_STORE_RESTORE != FALSE)
 
+#if (CONFIG_OBD_USE_STORE_RESTORE != FALSE) || (CONFIG_OBD_DEFER_DEFAULTS != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Get OD partition of an object
+
+The functions determines the OD partition of an object index like getIndex().
+
+\param  index_p                 Object index.
+
+\return The function returns the OD partition.
+*/
+//------------------------------------------------------------------------------
+static tObdPart getOdPart(UINT index_p)
+{
+    if ((index_p >= 0x1000) && (index_p < 0x2000))
+        return kObdPartGen;
+
+    if ((index_p >= 0x2000) && (index_p < 0x6000))
+        return kObdPartMan;
+
+#if (CONFIG_OBD_INCLUDE_A000_TO_DEVICE_PART == FALSE)
+    if ((index_p >= 0x6000) && (index_p < 0x9FFF))
+#else
+    if ((index_p >= 0x6000) && (index_p < 0xFFFF))
+#endif
+        return kObdPartDev;
+
+    return kObdPartUsr;
+}
+#endif
+
 ///\}
 
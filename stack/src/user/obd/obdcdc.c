@@ -72,6 +72,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     #include <unistd.h>
     #include <sys/vfs.h>
     #include <sys/types.h>
+    #include <sys/mman.h>
     #include <sys/timeb.h>
     #include <utime.h>
     #include <limits.h>
@@ -160,6 +161,10 @@ typedef struct
     UINT8*              pCdcBuffer;
     unsigned int        cdcBufSize;
     char*               pCdcFilename;
+    UINT8*              pCdcImage;              ///< Resident precompiled CDC file
+    size_t              cdcImageSize;           ///< Size of the resident precompiled CDC file
+    BOOL                fCdcImageMapped;        ///< Resident CDC file is memory mapped
+    UINT8*              pSharedCdc;             ///< Loaded precompiled CDC with shared CN configurations
 } tObdCdcInstance;
 
 //------------------------------------------------------------------------------
@@ -174,6 +179,12 @@ static tOplkError processCdc(tObdCdcInfo* pCdcInfo_p);
 static tOplkError loadNextBuffer(tObdCdcInfo* pCdcInfo_p, size_t bufferSize);
 static tOplkError loadCdcBuffer(UINT8* pCdc_p, size_t cdcSize_p);
 static tOplkError loadCdcFile(char* pCdcFilename_p);
+static UINT8*     readCdcFile(FD_TYPE fdCdcFile_p, size_t cdcSize_p);
+static void       releaseCdcImage(void);
+static BOOL       isPrecompiledCdc(UINT8* pCdc_p, size_t cdcSize_p);
+static tOplkError processPrecompiledCdc(UINT8* pCdc_p, size_t cdcSize_p);
+static tOplkError linkNodeConfigs(UINT8* pCdc_p, BOOL fLink_p);
+static UINT       getNodeEntrySize(UINT8* pCdc_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -192,9 +203,7 @@ The function initializes the OBD CDC module.
 //------------------------------------------------------------------------------
 tOplkError obdcdc_init(void)
 {
-    cdcInstance_l.pCdcFilename = NULL;
-    cdcInstance_l.pCdcBuffer = NULL;
-    cdcInstance_l.cdcBufSize = 0;
+    OPLK_MEMSET(&cdcInstance_l, 0, sizeof(tObdCdcInstance));
     return kErrorOk;
 }
 
@@ -209,6 +218,8 @@ The function exits and cleans up the OBD CDC module.
 //------------------------------------------------------------------------------
 void obdcdc_exit(void)
 {
+    cdcInstance_l.pSharedCdc = NULL;
+    releaseCdcImage();
     cdcInstance_l.pCdcFilename = NULL;
     cdcInstance_l.pCdcBuffer = NULL;
     cdcInstance_l.cdcBufSize = 0;
@@ -266,9 +277,16 @@ tOplkError obdcdc_loadCdc(void)
 {
     tOplkError          ret;
 
+    // the links to a previously loaded precompiled CDC file are renewed
+    cdcInstance_l.pSharedCdc = NULL;
+    releaseCdcImage();
+
     if (cdcInstance_l.pCdcBuffer != NULL)
     {
-        ret = loadCdcBuffer(cdcInstance_l.pCdcBuffer, cdcInstance_l.cdcBufSize);
+        if (isPrecompiledCdc(cdcInstance_l.pCdcBuffer, cdcInstance_l.cdcBufSize))
+            ret = processPrecompiledCdc(cdcInstance_l.pCdcBuffer, cdcInstance_l.cdcBufSize);
+        else
+            ret = loadCdcBuffer(cdcInstance_l.pCdcBuffer, cdcInstance_l.cdcBufSize);
     }
     else if (cdcInstance_l.pCdcFilename != NULL)
     {
@@ -285,6 +303,62 @@ tOplkError obdcdc_loadCdc(void)
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get shared configuration of a CN
+
+The function returns the shared ConciseDCF of the specified CN if the loaded
+precompiled CDC contains shared CN configurations (format version 2). CNs of
+the same type reference one shared ConciseDCF and their object 0x1F22 only
+contains the node specific objects. An object of the node specific ConciseDCF
+replaces the object with the same index and subindex in the shared ConciseDCF.
+
+\param  nodeId_p        Node ID of the CN.
+\param  ppBaseDcf_p     Pointer to store the pointer to the shared ConciseDCF.
+\param  pBaseSize_p     Pointer to store the size of the shared ConciseDCF.
+\param  ppNodeDcf_p     Pointer to store the pointer to the node specific
+                        ConciseDCF to which object 0x1F22 of the CN was linked.
+                        The shared ConciseDCF is only valid as long as object
+                        0x1F22 still points to it.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The CN has a shared configuration.
+\retval kErrorObdNoConfigData   The CN has no shared configuration.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+tOplkError obdcdc_getSharedConfig(UINT nodeId_p, UINT8** ppBaseDcf_p, UINT32* pBaseSize_p,
+                                  UINT8** ppNodeDcf_p)
+{
+    UINT8*          pCdc = cdcInstance_l.pSharedCdc;
+    UINT32          nodeCount;
+    UINT8*          pEntry;
+    UINT32          baseSize;
+
+    if (pCdc == NULL)
+        return kErrorObdNoConfigData;
+
+    nodeCount = ami_getUint32Le(&pCdc[CDC_PRECOMPILED_OFFSET_NODE_COUNT]);
+    for (pEntry = &pCdc[CDC_PRECOMPILED_HEADER_SIZE]; nodeCount != 0;
+         nodeCount--, pEntry += CDC_PRECOMPILED_NODE_ENTRY_SIZE_SHARED)
+    {
+        if (ami_getUint32Le(&pEntry[CDC_PRECOMPILED_NODE_OFFSET_NODEID]) != nodeId_p)
+            continue;
+
+        baseSize = ami_getUint32Le(&pEntry[CDC_PRECOMPILED_NODE_OFFSET_BASE_SIZE]);
+        if (baseSize == 0)
+            return kErrorObdNoConfigData;
+
+        *ppBaseDcf_p = &pCdc[ami_getUint32Le(&pEntry[CDC_PRECOMPILED_NODE_OFFSET_BASE_OFFSET])];
+        *pBaseSize_p = baseSize;
+        *ppNodeDcf_p = &pCdc[ami_getUint32Le(&pEntry[CDC_PRECOMPILED_NODE_OFFSET_OFFSET])];
+        return kErrorOk;
+    }
+
+    return kErrorObdNoConfigData;
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -296,7 +370,10 @@ tOplkError obdcdc_loadCdc(void)
 \brief  Load Concise Device Configuration file
 
 The function loads the concise device configuration (CDC) from the specified
-file and writes its contents into the OD.
+file and writes its contents into the OD. If possible, the file is mapped into
+memory and processed like a CDC buffer. Otherwise it is read entry by entry.
+A precompiled CDC file stays resident until the CDC is loaded again, because
+the ConciseDCFs of the CNs are used in place.
 
 \param  pCdcFilename_p  The filename of the CDC file to load.
 
@@ -308,13 +385,15 @@ static tOplkError loadCdcFile(char* pCdcFilename_p)
     tOplkError      ret = kErrorOk;
     tObdCdcInfo     cdcInfo;
     UINT32          error;
+    UINT8*          pCdc;
+    UINT8           aMagic[sizeof(UINT32)];
 
     OPLK_MEMSET(&cdcInfo, 0, sizeof(tObdCdcInfo));
     cdcInfo.type = kObdCdcTypeFile;
     cdcInfo.handle.fdCdcFile = open(pCdcFilename_p, O_RDONLY | O_BINARY, 0666);
     if (!IS_FD_VALID(cdcInfo.handle.fdCdcFile))
     {   // error occurred
-        errno = (UINT32)errno;
+        error = (UINT32)errno;
         ret = eventu_postError(kEventSourceObdu, kErrorObdErrnoSet, sizeof(UINT32), &error);
         return ret;
     }
@@ -322,6 +401,50 @@ static tOplkError loadCdcFile(char* pCdcFilename_p)
     cdcInfo.cdcSize = lseek(cdcInfo.handle.fdCdcFile, 0, SEEK_END);
     lseek(cdcInfo.handle.fdCdcFile, 0, SEEK_SET);
 
+#if (TARGET_SYSTEM == _LINUX_)
+    // process the mapped file in place like a CDC buffer, the mapping must be
+    // writable because the ConciseDCFs linked into the OD may be overwritten
+    // by SDO; MAP_PRIVATE keeps these changes out of the file
+    pCdc = (cdcInfo.cdcSize > 0) ? mmap(NULL, cdcInfo.cdcSize, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                                        cdcInfo.handle.fdCdcFile, 0) : MAP_FAILED;
+    if (pCdc != MAP_FAILED)
+    {
+        close(cdcInfo.handle.fdCdcFile);
+        if (isPrecompiledCdc(pCdc, cdcInfo.cdcSize))
+        {
+            cdcInstance_l.pCdcImage = pCdc;
+            cdcInstance_l.cdcImageSize = cdcInfo.cdcSize;
+            cdcInstance_l.fCdcImageMapped = TRUE;
+            return processPrecompiledCdc(pCdc, cdcInfo.cdcSize);
+        }
+
+        madvise(pCdc, cdcInfo.cdcSize, MADV_SEQUENTIAL);
+        ret = loadCdcBuffer(pCdc, cdcInfo.cdcSize);
+        munmap(pCdc, cdcInfo.cdcSize);
+        return ret;
+    }
+#endif
+
+    if ((read(cdcInfo.handle.fdCdcFile, aMagic, sizeof(aMagic)) == sizeof(aMagic)) &&
+        isPrecompiledCdc(aMagic, cdcInfo.cdcSize))
+    {   // a precompiled CDC must be resident, so read it completely
+        pCdc = readCdcFile(cdcInfo.handle.fdCdcFile, cdcInfo.cdcSize);
+        close(cdcInfo.handle.fdCdcFile);
+        if (pCdc == NULL)
+        {
+            ret = eventu_postError(kEventSourceObdu, kErrorObdOutOfMemory, 0, NULL);
+            if (ret != kErrorOk)
+                return ret;
+            return kErrorReject;
+        }
+
+        cdcInstance_l.pCdcImage = pCdc;
+        cdcInstance_l.cdcImageSize = cdcInfo.cdcSize;
+        cdcInstance_l.fCdcImageMapped = FALSE;
+        return processPrecompiledCdc(pCdc, cdcInfo.cdcSize);
+    }
+    lseek(cdcInfo.handle.fdCdcFile, 0, SEEK_SET);
+
     ret = processCdc(&cdcInfo);
 
     if (cdcInfo.pCurBuffer != NULL)
@@ -373,6 +496,259 @@ Exit:
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Read complete CDC file
+
+The function reads the complete CDC file into a newly allocated buffer.
+
+\param  fdCdcFile_p     File descriptor of the opened CDC file.
+\param  cdcSize_p       Size of the CDC file.
+
+\return The function returns a pointer to the buffer or NULL on error.
+*/
+//------------------------------------------------------------------------------
+static UINT8* readCdcFile(FD_TYPE fdCdcFile_p, size_t cdcSize_p)
+{
+    UINT8*      pCdc;
+    size_t      offset;
+    int         readSize;
+
+    if ((pCdc = OPLK_MALLOC(cdcSize_p)) == NULL)
+        return NULL;
+
+    lseek(fdCdcFile_p, 0, SEEK_SET);
+    for (offset = 0; offset < cdcSize_p; offset += readSize)
+    {
+        readSize = read(fdCdcFile_p, pCdc + offset, cdcSize_p - offset);
+        if (readSize <= 0)
+        {
+            OPLK_FREE(pCdc);
+            return NULL;
+        }
+    }
+
+    return pCdc;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Release resident precompiled CDC file
+
+The function removes the links of the CN configurations to the resident
+precompiled CDC file and frees or unmaps it.
+*/
+//------------------------------------------------------------------------------
+static void releaseCdcImage(void)
+{
+    if (cdcInstance_l.pCdcImage == NULL)
+        return;
+
+    linkNodeConfigs(cdcInstance_l.pCdcImage, FALSE);
+
+#if (TARGET_SYSTEM == _LINUX_)
+    if (cdcInstance_l.fCdcImageMapped)
+        munmap(cdcInstance_l.pCdcImage, cdcInstance_l.cdcImageSize);
+    else
+#endif
+        OPLK_FREE(cdcInstance_l.pCdcImage);
+
+    cdcInstance_l.pCdcImage = NULL;
+    cdcInstance_l.cdcImageSize = 0;
+    cdcInstance_l.fCdcImageMapped = FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check for precompiled CDC
+
+The function checks whether the specified CDC is a precompiled CDC.
+
+\param  pCdc_p          Pointer to the CDC. Only its first four bytes are read.
+\param  cdcSize_p       Size of the CDC.
+
+\return The function returns TRUE if the CDC is precompiled, otherwise FALSE.
+*/
+//------------------------------------------------------------------------------
+static BOOL isPrecompiledCdc(UINT8* pCdc_p, size_t cdcSize_p)
+{
+    // A plain CDC starts with the number of entries which can never be
+    // as large as the magic number.
+    return ((cdcSize_p >= CDC_PRECOMPILED_HEADER_SIZE) &&
+            (ami_getUint32Le(&pCdc_p[CDC_PRECOMPILED_OFFSET_MAGIC]) == CDC_PRECOMPILED_MAGIC));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process precompiled Concise Device Configuration
+
+The function processes a precompiled CDC. A precompiled CDC consists of a
+header, an index of the ConciseDCFs of the CNs and a local CDC section. The
+local CDC section is a plain CDC without the ConciseDCFs and is written into
+the OD. The ConciseDCFs are not copied, instead object 0x1F22 of each CN is
+linked directly to its ConciseDCF in the precompiled CDC. Therefore the
+precompiled CDC must stay valid as long as the OD is used. In format version 2
+an index entry can additionally reference a ConciseDCF which is shared by
+several CNs, see obdcdc_getSharedConfig().
+
+\param  pCdc_p          Pointer to the precompiled CDC.
+\param  cdcSize_p       Size of the precompiled CDC.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError processPrecompiledCdc(UINT8* pCdc_p, size_t cdcSize_p)
+{
+    tOplkError      ret;
+    UINT32          localOffset;
+    UINT32          localSize;
+    UINT32          nodeCount;
+    UINT8*          pEntry;
+    UINT32          offset;
+    UINT32          size;
+    UINT32          version;
+    UINT            entrySize;
+    BOOL            fValid;
+
+    version = ami_getUint32Le(&pCdc_p[CDC_PRECOMPILED_OFFSET_VERSION]);
+    localOffset = ami_getUint32Le(&pCdc_p[CDC_PRECOMPILED_OFFSET_LOCAL_OFFSET]);
+    localSize = ami_getUint32Le(&pCdc_p[CDC_PRECOMPILED_OFFSET_LOCAL_SIZE]);
+    nodeCount = ami_getUint32Le(&pCdc_p[CDC_PRECOMPILED_OFFSET_NODE_COUNT]);
+    entrySize = getNodeEntrySize(pCdc_p);
+
+    if (((version != CDC_PRECOMPILED_VERSION) && (version != CDC_PRECOMPILED_VERSION_SHARED)) ||
+        (localOffset > cdcSize_p) || (localSize > cdcSize_p - localOffset) ||
+        (nodeCount > (cdcSize_p - CDC_PRECOMPILED_HEADER_SIZE) / entrySize))
+    {
+        DEBUG_LVL_OBD_TRACE("%s: Invalid precompiled CDC header\n", __func__);
+        ret = eventu_postError(kEventSourceObdu, kErrorObdInvalidDcf, 0, NULL);
+        if (ret != kErrorOk)
+            return ret;
+        return kErrorReject;
+    }
+
+    // check index before the OD is changed
+    for (pEntry = &pCdc_p[CDC_PRECOMPILED_HEADER_SIZE];
+         pEntry < &pCdc_p[CDC_PRECOMPILED_HEADER_SIZE + (nodeCount * entrySize)];
+         pEntry += entrySize)
+    {
+        offset = ami_getUint32Le(&pEntry[CDC_PRECOMPILED_NODE_OFFSET_OFFSET]);
+        size = ami_getUint32Le(&pEntry[CDC_PRECOMPILED_NODE_OFFSET_SIZE]);
+        fValid = ((ami_getUint32Le(&pEntry[CDC_PRECOMPILED_NODE_OFFSET_NODEID]) <= 0xFF) &&
+                  (offset <= cdcSize_p) && (size >= sizeof(UINT32)) && (size <= cdcSize_p - offset) &&
+                  (ami_getUint32Le(&pCdc_p[offset]) ==
+                   ami_getUint32Le(&pEntry[CDC_PRECOMPILED_NODE_OFFSET_OBJECT_COUNT])));
+
+        if (fValid && (version == CDC_PRECOMPILED_VERSION_SHARED))
+        {   // the shared ConciseDCF is optional
+            offset = ami_getUint32Le(&pEntry[CDC_PRECOMPILED_NODE_OFFSET_BASE_OFFSET]);
+            size = ami_getUint32Le(&pEntry[CDC_PRECOMPILED_NODE_OFFSET_BASE_SIZE]);
+            fValid = ((size == 0) ||
+                      ((offset <= cdcSize_p) && (size >= sizeof(UINT32)) && (size <= cdcSize_p - offset)));
+        }
+
+        if (!fValid)
+        {
+            DEBUG_LVL_OBD_TRACE("%s: Invalid node index entry in precompiled CDC\n", __func__);
+            ret = eventu_postError(kEventSourceObdu, kErrorObdInvalidDcf, 0, NULL);
+            if (ret != kErrorOk)
+                return ret;
+            return kErrorReject;
+        }
+    }
+
+    if (localSize > 0)
+    {
+        ret = loadCdcBuffer(&pCdc_p[localOffset], localSize);
+        if (ret != kErrorOk)
+            return ret;
+    }
+
+    if (version == CDC_PRECOMPILED_VERSION_SHARED)
+        cdcInstance_l.pSharedCdc = pCdc_p;
+
+    return linkNodeConfigs(pCdc_p, TRUE);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Link CN configurations to precompiled CDC
+
+The function links object 0x1F22 of all CNs in the index of a precompiled CDC
+to their ConciseDCFs, or removes these links.
+
+\param  pCdc_p          Pointer to the checked precompiled CDC.
+\param  fLink_p         TRUE to link the ConciseDCFs, FALSE to remove the links.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError linkNodeConfigs(UINT8* pCdc_p, BOOL fLink_p)
+{
+    tOplkError      ret = kErrorOk;
+    UINT32          nodeCount;
+    UINT8*          pEntry;
+    UINT            entrySize;
+    tVarParam       varParam;
+
+    nodeCount = ami_getUint32Le(&pCdc_p[CDC_PRECOMPILED_OFFSET_NODE_COUNT]);
+    pEntry = &pCdc_p[CDC_PRECOMPILED_HEADER_SIZE];
+    entrySize = getNodeEntrySize(pCdc_p);
+
+    varParam.validFlag = kVarValidAll;
+    varParam.index = 0x1F22;
+    for (; nodeCount != 0; nodeCount--, pEntry += entrySize)
+    {
+        varParam.subindex = ami_getUint32Le(&pEntry[CDC_PRECOMPILED_NODE_OFFSET_NODEID]);
+        if (fLink_p)
+        {
+            varParam.pData = &pCdc_p[ami_getUint32Le(&pEntry[CDC_PRECOMPILED_NODE_OFFSET_OFFSET])];
+            varParam.size = (tObdSize)ami_getUint32Le(&pEntry[CDC_PRECOMPILED_NODE_OFFSET_SIZE]);
+        }
+        else
+        {
+            varParam.pData = NULL;
+            varParam.size = 0;
+        }
+
+        ret = obd_defineVar(&varParam);
+        if ((ret != kErrorOk) && fLink_p)
+        {
+            tEventObdError          obdError;
+
+            obdError.index = varParam.index;
+            obdError.subIndex = varParam.subindex;
+
+            DEBUG_LVL_OBD_TRACE("%s: Linking object 0x%04X/%u failed with 0x%02X\n",
+                                 __func__, varParam.index, varParam.subindex, ret);
+            ret = eventu_postError(kEventSourceObdu, ret, sizeof(tEventObdError), &obdError);
+            if (ret != kErrorOk)
+                return ret;
+        }
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get size of node index entry
+
+The function returns the size of a node index entry of a precompiled CDC.
+
+\param  pCdc_p          Pointer to the precompiled CDC.
+
+\return The function returns the size of a node index entry.
+*/
+//------------------------------------------------------------------------------
+static UINT getNodeEntrySize(UINT8* pCdc_p)
+{
+    if (ami_getUint32Le(&pCdc_p[CDC_PRECOMPILED_OFFSET_VERSION]) == CDC_PRECOMPILED_VERSION_SHARED)
+        return CDC_PRECOMPILED_NODE_ENTRY_SIZE_SHARED;
+
+    return CDC_PRECOMPILED_NODE_ENTRY_SIZE;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Process Concise Device Configuration
@@ -75,6 +75,20 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     #define OBD_MAX_ARRAY_SUBENTRIES    3
 #endif
 
+// The index tables and the sub-index tables of objects without arrays are never
+// changed at runtime, therefore they can be placed in ROM. The sub-index tables
+// of arrays stay in RAM because their sub-index number is updated on access.
+#if (CONFIG_OBD_CONST_TABLES != FALSE)
+    #define OBD_TABLE_CONST             CONST
+    #define OBD_TABLE_MEM               ROM
+#else
+    #define OBD_TABLE_CONST
+    #define OBD_TABLE_MEM               MEM
+#endif
+
+// number of index entries of a partition table without the end entry
+#define OBD_TABLE_INDEX_NUM(tab)        ((sizeof(tab) / sizeof(tab[0])) - 1)
+
 
 //------------------------------------------------------------------------------
 // global variables
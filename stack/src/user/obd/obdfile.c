@@ -0,0 +1,380 @@
+/**
+********************************************************************************
+\file   obdfile.c
+
+\brief  Implementation of OBD file streams
+
+This file contains the implementation of domain streams which are backed by
+files. A domain object which is backed by a file stream is read from and
+written to the file at the offset of the access, so large domains (e.g. a
+firmware image in object 0x1F50) can be transferred by SDO without holding
+the whole data in memory.
+
+\ingroup module_obd
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#define _CRT_NONSTDC_NO_WARNINGS    // for MSVC 2005 or higher
+
+#include <oplk/oplkinc.h>
+#include <oplk/obd.h>
+#include <oplk/obdfile.h>
+
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#if (TARGET_SYSTEM == _WIN32_)
+
+    #include <io.h>
+    #include <sys/types.h>
+
+#elif (TARGET_SYSTEM == _LINUX_)
+
+    #include <unistd.h>
+    #include <sys/types.h>
+
+#endif
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#if (TARGET_SYSTEM == _WIN32_)
+
+    #define ftruncate   _chsize
+
+#elif (TARGET_SYSTEM == _LINUX_)
+
+    #define O_BINARY    0
+
+#endif
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  File stream
+
+The structure describes a domain stream which is backed by a file.
+*/
+typedef struct
+{
+    tObdDomainStream    stream;             ///< Domain stream of the file
+    int                 fd;                 ///< File descriptor of the file (-1 = unused)
+    BOOL                fWrite;             ///< The current transfer writes the file
+} tObdFileStream;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tObdFileStream   aFileStream_l[CONFIG_OBD_DOMAIN_STREAM_COUNT];
+static BOOL             fInitialized_l = FALSE;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError accessFile(void* pArg_p, tObdDomainStreamOp op_p, UINT32 offset_p,
+                             void* pData_p, UINT size_p);
+static void       initStreams(void);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Open a file stream
+
+The function opens (or creates) a file and provides a domain stream which reads
+and writes the file. The stream can be assigned to domain objects with
+obd_setDomainStream(). The current size of the stream is the size of the file.
+
+\param  pFilename_p             File name of the file.
+\param  maxSize_p               Maximum size which can be written to the file.
+\param  ppStream_p              Pointer to store the pointer to the stream.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                    The file stream was opened.
+\retval kErrorObdOutOfMemory        All file streams are in use.
+\retval kErrorObdErrnoSet           The file could not be opened, errno is set.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+tOplkError obdfile_open(const char* pFilename_p, UINT32 maxSize_p, tObdDomainStream** ppStream_p)
+{
+    tObdFileStream* pFileStream;
+    off_t           fileSize;
+    UINT            i;
+
+    if (!fInitialized_l)
+        initStreams();
+
+    pFileStream = NULL;
+    for (i = 0; i < CONFIG_OBD_DOMAIN_STREAM_COUNT; i++)
+    {
+        if (aFileStream_l[i].fd < 0)
+        {
+            pFileStream = &aFileStream_l[i];
+            break;
+        }
+    }
+
+    if (pFileStream == NULL)
+        return kErrorObdOutOfMemory;
+
+    pFileStream->fd = open(pFilename_p, O_RDWR | O_CREAT | O_BINARY, 0666);
+    if (pFileStream->fd < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s: Unable to open file %s\n", __func__, pFilename_p);
+        return kErrorObdErrnoSet;
+    }
+
+    fileSize = lseek(pFileStream->fd, 0, SEEK_END);
+    if (fileSize < 0)
+        fileSize = 0;
+
+    pFileStream->stream.pfnAccess = accessFile;
+    pFileStream->stream.pArg = pFileStream;
+    pFileStream->stream.size = (UINT32)fileSize;
+    pFileStream->stream.maxSize = maxSize_p;
+    pFileStream->fWrite = FALSE;
+
+    *ppStream_p = &pFileStream->stream;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close a file stream
+
+The function removes the stream from all domain objects and closes the file.
+
+\param  pStream_p               Pointer to the stream returned by obdfile_open().
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                    The file stream was closed.
+\retval kErrorInvalidInstanceParam  The stream is no open file stream.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+tOplkError obdfile_close(tObdDomainStream* pStream_p)
+{
+    tObdFileStream* pFileStream;
+    UINT            i;
+
+    for (i = 0; i < CONFIG_OBD_DOMAIN_STREAM_COUNT; i++)
+    {
+        pFileStream = &aFileStream_l[i];
+        if (fInitialized_l && (pFileStream->fd >= 0) && (&pFileStream->stream == pStream_p))
+        {
+            obd_releaseDomainStream(pStream_p);
+            close(pFileStream->fd);
+            pFileStream->fd = -1;
+            return kErrorOk;
+        }
+    }
+
+    return kErrorInvalidInstanceParam;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close all file streams
+
+The function closes all file streams which are still open.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+void obdfile_exit(void)
+{
+    UINT            i;
+
+    if (!fInitialized_l)
+        return;
+
+    for (i = 0; i < CONFIG_OBD_DOMAIN_STREAM_COUNT; i++)
+    {
+        if (aFileStream_l[i].fd >= 0)
+            obdfile_close(&aFileStream_l[i].stream);
+    }
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize file streams
+
+The function marks all file streams as unused.
+*/
+//------------------------------------------------------------------------------
+static void initStreams(void)
+{
+    UINT            i;
+
+    OPLK_MEMSET(aFileStream_l, 0, sizeof(aFileStream_l));
+    for (i = 0; i < CONFIG_OBD_DOMAIN_STREAM_COUNT; i++)
+        aFileStream_l[i].fd = -1;
+
+    fInitialized_l = TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Access a file stream
+
+The function is the access callback of the file streams. Data is read from and
+written to the file at the offset of the access. The file is truncated when a
+transfer starts to write it. The size of the stream is updated when a write
+transfer is closed; an aborted write transfer leaves an empty file.
+
+\param  pArg_p                  Pointer to the file stream.
+\param  op_p                    Stream operation.
+\param  offset_p                Offset of the access.
+\param  pData_p                 Pointer to the data buffer.
+\param  size_p                  Size of the access.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError accessFile(void* pArg_p, tObdDomainStreamOp op_p, UINT32 offset_p,
+                             void* pData_p, UINT size_p)
+{
+    tObdFileStream* pFileStream = (tObdFileStream*)pArg_p;
+    int             result;
+    UINT            done;
+
+    switch (op_p)
+    {
+        case kObdDomainStreamOpen:
+            pFileStream->fWrite = FALSE;
+            break;
+
+        case kObdDomainStreamRead:
+            if (((UINT32)size_p > pFileStream->stream.size) ||
+                (offset_p > pFileStream->stream.size - size_p))
+                return kErrorObdValueLengthError;
+
+            if (lseek(pFileStream->fd, (off_t)offset_p, SEEK_SET) < 0)
+                return kErrorObdErrnoSet;
+
+            for (done = 0; done < size_p; done += (UINT)result)
+            {
+                result = read(pFileStream->fd, (UINT8*)pData_p + done, size_p - done);
+                if (result <= 0)
+                    return kErrorObdErrnoSet;
+            }
+            break;
+
+        case kObdDomainStreamWrite:
+            if (((UINT32)size_p > pFileStream->stream.maxSize) ||
+                (offset_p > pFileStream->stream.maxSize - size_p))
+                return kErrorObdValueLengthError;
+
+            if (!pFileStream->fWrite)
+            {
+                if (ftruncate(pFileStream->fd, 0) != 0)
+                    return kErrorObdErrnoSet;
+
+                pFileStream->fWrite = TRUE;
+            }
+
+            if (lseek(pFileStream->fd, (off_t)offset_p, SEEK_SET) < 0)
+                return kErrorObdErrnoSet;
+
+            for (done = 0; done < size_p; done += (UINT)result)
+            {
+                result = write(pFileStream->fd, (UINT8*)pData_p + done, size_p - done);
+                if (result <= 0)
+                    return kErrorObdErrnoSet;
+            }
+            break;
+
+        case kObdDomainStreamClose:
+            if (pFileStream->fWrite)
+            {
+                pFileStream->stream.size = offset_p;
+                pFileStream->fWrite = FALSE;
+            }
+            break;
+
+        case kObdDomainStreamAbort:
+            if (pFileStream->fWrite)
+            {
+                if (ftruncate(pFileStream->fd, 0) != 0)
+                    return kErrorObdErrnoSet;
+
+                pFileStream->stream.size = 0;
+                pFileStream->fWrite = FALSE;
+            }
+            break;
+
+        default:
+            return kErrorInvalidOperation;
+    }
+
+    return kErrorOk;
+}
+
+/// \}
+
+#endif // (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
@@ -0,0 +1,649 @@
+/**
+********************************************************************************
+\file   obdstore.c
+
+\brief  Implementation of OBD store functions
+
+This file contains a store/restore backend for the object dictionary which
+keeps the OD partitions in a memory mapped file. Every partition has its own
+area in the file and a checksum in the file header. An object is only written
+if its stored value differs, so storing an unchanged OD does not touch the
+file. Loading copies the objects directly from the mapped file.
+
+The objects are stored in the order of the OD as records consisting of index,
+sub-index, size and data. If the layout of the OD changes, loading stops at
+the first record which does not match and the remaining objects keep their
+default values.
+
+\ingroup module_obd
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <oplk/obd.h>
+#include <oplk/obdstore.h>
+
+#if (CONFIG_OBD_USE_STORE_MMAP != FALSE)
+
+#if (CONFIG_OBD_USE_STORE_RESTORE == FALSE)
+#error "CONFIG_OBD_USE_STORE_MMAP requires CONFIG_OBD_USE_STORE_RESTORE!"
+#endif
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define OBD_STORE_MAGIC             0x534F4C50UL            // "PLOS"
+#define OBD_STORE_VERSION           1
+#define OBD_STORE_PART_COUNT        4                       // generic, manufacturer, device and user part
+#define OBD_STORE_HEADER_SIZE       4096                    // the partitions start page aligned
+#define OBD_STORE_ALIGN(size_p)     (((size_p) + 3) & ~((size_t)3))
+
+#if ((CONFIG_OBD_STORE_PART_SIZE % OBD_STORE_HEADER_SIZE) != 0)
+#error "CONFIG_OBD_STORE_PART_SIZE must be a multiple of 4096!"
+#endif
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+typedef struct
+{
+    UINT32              dataSize;               ///< Size of the stored records, 0 if the partition is empty
+    UINT32              checksum;               ///< Checksum over the stored records
+} tObdStorePartHeader;
+
+typedef struct
+{
+    UINT32              magic;
+    UINT32              version;
+    UINT32              partSize;
+    UINT32              reserved;
+    tObdStorePartHeader aPart[OBD_STORE_PART_COUNT];
+} tObdStoreFileHeader;
+
+typedef struct
+{
+    UINT16              index;
+    UINT8               subIndex;
+    UINT8               reserved;
+    UINT32              size;                   ///< Size of the object data following the record header
+} tObdStoreRecord;
+
+typedef struct
+{
+    char*               pStoreFilename;
+    int                 fd;
+    UINT8*              pImage;                 ///< Memory mapped store file
+    size_t              imageSize;
+    UINT8*              pPart;                  ///< Area of the partition of the current command
+    tObdStorePartHeader* pPartHeader;           ///< Header of the partition of the current command
+    size_t              offset;                 ///< Offset of the next record in the partition
+    UINT32              checksum;               ///< Running checksum of the written records
+    size_t              dirtyStart;             ///< First changed byte of the partition
+    size_t              dirtyEnd;               ///< End of the changed bytes of the partition
+    BOOL                fPartValid;             ///< Partition contains valid records (loading) or all records fit (storing)
+} tObdStoreInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tObdStoreInstance        storeInstance_l;
+static const UINT8              aZeroPadding_l[4] = { 0, 0, 0, 0 };
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError cbStoreLoadObject(tObdCbStoreParam MEM* pCbStoreParam_p);
+static tOplkError openStoreFile(void);
+static void       closeStoreFile(void);
+static tOplkError selectPartition(tObdPart odPart_p);
+static tOplkError writeObject(tObdCbStoreParam MEM* pCbStoreParam_p);
+static tOplkError readObject(tObdCbStoreParam MEM* pCbStoreParam_p);
+static tOplkError commitPartition(void);
+static void       updateStore(size_t offset_p, const void* pData_p, size_t size_p);
+static tOplkError syncImage(size_t offset_p, size_t size_p);
+static UINT32     calcChecksum(UINT32 checksum_p, const UINT8* pData_p, size_t size_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize OBD store module
+
+The function initializes the OBD store module and registers it as store/load
+callback of the OD. The store file is opened on the first access.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+tOplkError obdstore_init(void)
+{
+    OPLK_MEMSET(&storeInstance_l, 0, sizeof(tObdStoreInstance));
+    storeInstance_l.fd = -1;
+    storeInstance_l.pStoreFilename = CONFIG_OBD_DEF_STORE_FILENAME;
+
+    return obd_storeLoadObjCallback(cbStoreLoadObject);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Exit OBD store module
+
+The function exits the OBD store module and closes the store file.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+void obdstore_exit(void)
+{
+    obd_storeLoadObjCallback(NULL);
+    closeStoreFile();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set the store filename
+
+The function sets the filename of the store file. It must be called before
+the OD is loaded the first time.
+
+\param  pStoreFilename_p    The filename of the store file.
+
+\ingroup module_obd
+*/
+//------------------------------------------------------------------------------
+void obdstore_setFilename(char* pStoreFilename_p)
+{
+    closeStoreFile();
+    storeInstance_l.pStoreFilename = pStoreFilename_p;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Store/load callback function
+
+The function is called by the OD for every store/load command.
+
+\param  pCbStoreParam_p     Pointer to the callback parameters.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError cbStoreLoadObject(tObdCbStoreParam MEM* pCbStoreParam_p)
+{
+    tOplkError          ret;
+
+    if (storeInstance_l.pImage == NULL)
+    {
+        ret = openStoreFile();
+        if (ret != kErrorOk)
+            return ret;
+    }
+
+    switch (pCbStoreParam_p->command)
+    {
+        case kObdCmdOpenWrite:
+            ret = selectPartition(pCbStoreParam_p->currentOdPart);
+            storeInstance_l.fPartValid = TRUE;
+            storeInstance_l.checksum = 0x811C9DC5UL;
+            storeInstance_l.dirtyStart = CONFIG_OBD_STORE_PART_SIZE;
+            storeInstance_l.dirtyEnd = 0;
+            break;
+
+        case kObdCmdWriteObj:
+            ret = writeObject(pCbStoreParam_p);
+            break;
+
+        case kObdCmdCloseWrite:
+            ret = commitPartition();
+            break;
+
+        case kObdCmdOpenRead:
+            ret = selectPartition(pCbStoreParam_p->currentOdPart);
+            if (ret != kErrorOk)
+                break;
+
+            storeInstance_l.fPartValid =
+                (storeInstance_l.pPartHeader->dataSize != 0) &&
+                (storeInstance_l.pPartHeader->dataSize <= CONFIG_OBD_STORE_PART_SIZE) &&
+                (calcChecksum(0x811C9DC5UL, storeInstance_l.pPart, storeInstance_l.pPartHeader->dataSize) ==
+                 storeInstance_l.pPartHeader->checksum);
+            break;
+
+        case kObdCmdReadObj:
+            ret = readObject(pCbStoreParam_p);
+            break;
+
+        case kObdCmdCloseRead:
+            ret = kErrorOk;
+            break;
+
+        case kObdCmdClear:
+            ret = selectPartition(pCbStoreParam_p->currentOdPart);
+            if (ret != kErrorOk)
+                break;
+
+            storeInstance_l.pPartHeader->dataSize = 0;
+            storeInstance_l.pPartHeader->checksum = 0;
+            ret = syncImage(0, sizeof(tObdStoreFileHeader));
+            break;
+
+        default:
+            ret = kErrorObdAccessViolation;
+            break;
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Open the store file
+
+The function opens and maps the store file. If the file does not exist or was
+created with a different partition size, it is initialized with empty
+partitions.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError openStoreFile(void)
+{
+    struct stat             fileStat;
+    tObdStoreFileHeader*    pHeader;
+
+    storeInstance_l.imageSize = OBD_STORE_HEADER_SIZE + (OBD_STORE_PART_COUNT * CONFIG_OBD_STORE_PART_SIZE);
+
+    storeInstance_l.fd = open(storeInstance_l.pStoreFilename, O_RDWR | O_CREAT, 0666);
+    if (storeInstance_l.fd < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Unable to open store file %s\n", __func__, storeInstance_l.pStoreFilename);
+        return kErrorObdErrnoSet;
+    }
+
+    if ((fstat(storeInstance_l.fd, &fileStat) != 0) ||
+        (((size_t)fileStat.st_size != storeInstance_l.imageSize) &&
+         (ftruncate(storeInstance_l.fd, storeInstance_l.imageSize) != 0)))
+    {
+        closeStoreFile();
+        return kErrorObdErrnoSet;
+    }
+
+    storeInstance_l.pImage = (UINT8*)mmap(NULL, storeInstance_l.imageSize, PROT_READ | PROT_WRITE,
+                                          MAP_SHARED, storeInstance_l.fd, 0);
+    if (storeInstance_l.pImage == MAP_FAILED)
+    {
+        storeInstance_l.pImage = NULL;
+        closeStoreFile();
+        return kErrorObdErrnoSet;
+    }
+
+    pHeader = (tObdStoreFileHeader*)storeInstance_l.pImage;
+    if ((pHeader->magic != OBD_STORE_MAGIC) || (pHeader->version != OBD_STORE_VERSION) ||
+        (pHeader->partSize != CONFIG_OBD_STORE_PART_SIZE))
+    {
+        OPLK_MEMSET(pHeader, 0, sizeof(tObdStoreFileHeader));
+        pHeader->magic = OBD_STORE_MAGIC;
+        pHeader->version = OBD_STORE_VERSION;
+        pHeader->partSize = CONFIG_OBD_STORE_PART_SIZE;
+        return syncImage(0, sizeof(tObdStoreFileHeader));
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Close the store file
+
+The function unmaps and closes the store file.
+*/
+//------------------------------------------------------------------------------
+static void closeStoreFile(void)
+{
+    if (storeInstance_l.pImage != NULL)
+    {
+        munmap(storeInstance_l.pImage, storeInstance_l.imageSize);
+        storeInstance_l.pImage = NULL;
+    }
+
+    if (storeInstance_l.fd >= 0)
+    {
+        close(storeInstance_l.fd);
+        storeInstance_l.fd = -1;
+    }
+
+    storeInstance_l.pPart = NULL;
+    storeInstance_l.pPartHeader = NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Select the partition of a command
+
+The function selects the area of the specified OD partition in the store file.
+
+\param  odPart_p            OD partition of the current command.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError selectPartition(tObdPart odPart_p)
+{
+    UINT                    partIndex;
+
+    storeInstance_l.pPart = NULL;
+    storeInstance_l.pPartHeader = NULL;
+
+    switch (odPart_p)
+    {
+        case kObdPartGen:
+            partIndex = 0;
+            break;
+
+        case kObdPartMan:
+            partIndex = 1;
+            break;
+
+        case kObdPartDev:
+            partIndex = 2;
+            break;
+
+        case kObdPartUsr:
+            partIndex = 3;
+            break;
+
+        default:
+            return kErrorObdIllegalPart;
+    }
+
+    storeInstance_l.pPartHeader = &((tObdStoreFileHeader*)storeInstance_l.pImage)->aPart[partIndex];
+    storeInstance_l.pPart = storeInstance_l.pImage + OBD_STORE_HEADER_SIZE +
+                            (partIndex * CONFIG_OBD_STORE_PART_SIZE);
+    storeInstance_l.offset = 0;
+    storeInstance_l.fPartValid = FALSE;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write an object to the store file
+
+The function writes the record of an object to the current partition. Only
+bytes which differ from the stored ones are written.
+
+\param  pCbStoreParam_p     Pointer to the callback parameters.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError writeObject(tObdCbStoreParam MEM* pCbStoreParam_p)
+{
+    tObdStoreRecord         record;
+    size_t                  recordSize;
+    size_t                  padding;
+
+    if (storeInstance_l.pPart == NULL)
+        return kErrorObdIllegalPart;
+
+    padding = OBD_STORE_ALIGN(pCbStoreParam_p->objSize) - pCbStoreParam_p->objSize;
+    recordSize = sizeof(tObdStoreRecord) + pCbStoreParam_p->objSize + padding;
+    if (storeInstance_l.offset + recordSize > CONFIG_OBD_STORE_PART_SIZE)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Partition 0x%X exceeds CONFIG_OBD_STORE_PART_SIZE\n",
+                              __func__, pCbStoreParam_p->currentOdPart);
+        storeInstance_l.fPartValid = FALSE;
+        return kErrorObdOutOfMemory;
+    }
+
+    record.index = (UINT16)pCbStoreParam_p->index;
+    record.subIndex = (UINT8)pCbStoreParam_p->subIndex;
+    record.reserved = 0;
+    record.size = (UINT32)pCbStoreParam_p->objSize;
+
+    updateStore(storeInstance_l.offset, &record, sizeof(tObdStoreRecord));
+    updateStore(storeInstance_l.offset + sizeof(tObdStoreRecord), pCbStoreParam_p->pData,
+                pCbStoreParam_p->objSize);
+    updateStore(storeInstance_l.offset + sizeof(tObdStoreRecord) + pCbStoreParam_p->objSize,
+                aZeroPadding_l, padding);
+
+    storeInstance_l.checksum = calcChecksum(storeInstance_l.checksum,
+                                            storeInstance_l.pPart + storeInstance_l.offset, recordSize);
+    storeInstance_l.offset += recordSize;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read an object from the store file
+
+The function copies the object data of the next record of the current
+partition into the OD. If the record does not belong to the object, the
+partition is no longer used for loading.
+
+\param  pCbStoreParam_p     Pointer to the callback parameters.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError readObject(tObdCbStoreParam MEM* pCbStoreParam_p)
+{
+    tObdStoreRecord*        pRecord;
+    size_t                  recordSize;
+
+    if (!storeInstance_l.fPartValid)
+        return kErrorObdStoreInvalid;
+
+    pRecord = (tObdStoreRecord*)(storeInstance_l.pPart + storeInstance_l.offset);
+    recordSize = sizeof(tObdStoreRecord) + OBD_STORE_ALIGN(pCbStoreParam_p->objSize);
+
+    if ((storeInstance_l.offset + recordSize > storeInstance_l.pPartHeader->dataSize) ||
+        (pRecord->index != pCbStoreParam_p->index) ||
+        (pRecord->subIndex != pCbStoreParam_p->subIndex) ||
+        (pRecord->size != pCbStoreParam_p->objSize))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Stored object does not match 0x%04X/%u\n",
+                              __func__, pCbStoreParam_p->index, pCbStoreParam_p->subIndex);
+        storeInstance_l.fPartValid = FALSE;
+        return kErrorObdStoreInvalid;
+    }
+
+    OPLK_MEMCPY(pCbStoreParam_p->pData, pRecord + 1, pCbStoreParam_p->objSize);
+    storeInstance_l.offset += recordSize;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Commit the current partition
+
+The function writes the changed records and afterwards the header of the
+current partition to the store file. If neither records nor header changed,
+the file is not accessed. If not all records fit into the partition, the
+partition is cleared.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError commitPartition(void)
+{
+    tOplkError              ret;
+
+    if (storeInstance_l.pPart == NULL)
+        return kErrorObdIllegalPart;
+
+    if (!storeInstance_l.fPartValid)
+    {
+        storeInstance_l.pPartHeader->dataSize = 0;
+        storeInstance_l.pPartHeader->checksum = 0;
+        syncImage(0, sizeof(tObdStoreFileHeader));
+        return kErrorObdOutOfMemory;
+    }
+
+    if (storeInstance_l.dirtyEnd > storeInstance_l.dirtyStart)
+    {
+        ret = syncImage((size_t)(storeInstance_l.pPart - storeInstance_l.pImage) + storeInstance_l.dirtyStart,
+                        storeInstance_l.dirtyEnd - storeInstance_l.dirtyStart);
+        if (ret != kErrorOk)
+            return ret;
+    }
+
+    if ((storeInstance_l.pPartHeader->dataSize == storeInstance_l.offset) &&
+        (storeInstance_l.pPartHeader->checksum == storeInstance_l.checksum))
+        return kErrorOk;
+
+    storeInstance_l.pPartHeader->dataSize = (UINT32)storeInstance_l.offset;
+    storeInstance_l.pPartHeader->checksum = storeInstance_l.checksum;
+    return syncImage(0, sizeof(tObdStoreFileHeader));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update the store file
+
+The function writes data to the current partition if it differs from the
+stored data and records the changed range.
+
+\param  offset_p            Offset in the current partition.
+\param  pData_p             Pointer to the data.
+\param  size_p              Size of the data.
+*/
+//------------------------------------------------------------------------------
+static void updateStore(size_t offset_p, const void* pData_p, size_t size_p)
+{
+    if ((size_p == 0) || (OPLK_MEMCMP(storeInstance_l.pPart + offset_p, pData_p, size_p) == 0))
+        return;
+
+    OPLK_MEMCPY(storeInstance_l.pPart + offset_p, pData_p, size_p);
+
+    if (offset_p < storeInstance_l.dirtyStart)
+        storeInstance_l.dirtyStart = offset_p;
+    if (offset_p + size_p > storeInstance_l.dirtyEnd)
+        storeInstance_l.dirtyEnd = offset_p + size_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Synchronize the store file
+
+The function writes the pages of the specified range of the mapped store file
+back to the file.
+
+\param  offset_p            Offset in the store file.
+\param  size_p              Size of the range.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError syncImage(size_t offset_p, size_t size_p)
+{
+    size_t                  pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t                  start = offset_p & ~(pageSize - 1);
+
+    if (msync(storeInstance_l.pImage + start, offset_p + size_p - start, MS_SYNC) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Unable to write store file %s\n", __func__, storeInstance_l.pStoreFilename);
+        return kErrorObdErrnoSet;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Calculate the checksum of stored records
+
+The function continues an FNV-1a hash over the specified records. The records
+are always a multiple of four bytes, so the hash is calculated word by word.
+
+\param  checksum_p          Checksum of the preceding records.
+\param  pData_p             Pointer to the records.
+\param  size_p              Size of the records in bytes.
+
+\return The function returns the updated checksum.
+*/
+//------------------------------------------------------------------------------
+static UINT32 calcChecksum(UINT32 checksum_p, const UINT8* pData_p, size_t size_p)
+{
+    const UINT32*           pWord = (const UINT32*)pData_p;
+    size_t                  count;
+
+    for (count = size_p / sizeof(UINT32); count > 0; count--)
+    {
+        checksum_p ^= *pWord++;
+        checksum_p *= 0x01000193UL;
+    }
+
+    return checksum_p;
+}
+
+///\}
+
+#endif // (CONFIG_OBD_USE_STORE_MMAP != FALSE)
@@ -52,6 +52,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/obd.h>
 #include <common/pdo.h>
 #include <common/target.h>
+#include <common/cyclestat.h>
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -81,6 +82,133 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // local types
 //------------------------------------------------------------------------------
 
+/**
+\brief PDO copy operation
+
+The structure describes a single operation of a compiled PDO copy program.
+A copy operation either transfers a contiguous block between the PDO payload
+and the mapped objects, or it converts a single mapped object by using the AMI
+functions. A block consists of elements of the same size. Blocks of 1 byte
+elements are copied, blocks of larger elements are converted with the bulk
+AMI functions.
+*/
+typedef struct
+{
+    void*               pVar;                   ///< Pointer to data of first object
+    UINT16              byteOffset;             ///< Byte offset in PDO payload
+    UINT16              byteSize;               ///< Number of bytes of the block
+    UINT8               elementSize;            ///< Size of a single element in the block
+    tPdoMappObject*     pMappObject;            ///< Mapping object to be converted, NULL for a block
+} tPdoCopyOp;
+
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+/**
+\brief Generated PDO copy function
+
+The function transfers the mapped objects of one PDO channel between the PDO
+payload and the process image.
+
+\param  pPdo_p      Pointer to PDO payload.
+\param  pPi_p       Pointer to the process image of the direction.
+*/
+typedef void (*tPdoStaticCopyFunc)(BYTE* pPdo_p, BYTE* pPi_p);
+
+/**
+\brief Generated PDO copy function table entry
+
+The structure describes a copy function generated by tools/genpdocopy.pl for
+the mapping of a single PDO channel. The function is used for a channel if the
+hash of its runtime mapping matches (see calcStaticCopyHash()).
+*/
+typedef struct
+{
+    UINT32              hash;                   ///< Hash of the mapping the function is generated for
+    BOOL                fTx;                    ///< TRUE = TXPDO, FALSE = RXPDO
+    tPdoStaticCopyFunc  pfnCopy;                ///< Generated copy function
+} tPdoStaticCopy;
+
+// The generated copy functions and their table aPdoStaticCopy_l[]
+#include "pdostaticcopy.h"
+#endif
+
+/**
+\brief TXPDO channel write tracking
+
+The structure describes the memory range of the variables which are mapped to
+a TXPDO channel. If write tracking is enabled, a TXPDO channel is only encoded
+again if data within this range has been marked as written.
+*/
+typedef struct
+{
+    BYTE*               pVarStart;              ///< First byte of the mapped variables
+    BYTE*               pVarEnd;                ///< Byte behind the last byte of the mapped variables
+    BOOL                fDirty;                 ///< Flag determines if the channel has to be encoded
+} tPdoTxChannelDirty;
+
+/**
+\brief Zero-copy process image
+
+The structure describes the zero-copy mode of one direction. In zero-copy mode
+the application works directly on the PDO buffer of a single channel instead of
+a separate process image. This is only possible if the copy program of the
+channel is a plain copy of the process image, i.e. the process image is a byte
+copy of the PDO payload.
+*/
+typedef struct
+{
+    BYTE*               pPi;                    ///< Pointer to process image, NULL if zero-copy mode is disabled
+    UINT                piSize;                 ///< Size of process image
+    BOOL                fActive;                ///< Flag determines if the PDO buffer is used as process image
+    UINT                channelId;              ///< PDO channel used as process image
+    BYTE*               pPdo;                   ///< Pointer to the current PDO buffer of the channel
+} tPdoZeroCopy;
+
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+/**
+\brief Kernel process images
+
+The structure describes the process images which are assembled by the kernel
+layer. The application works directly on the buffers of the images in the PDO
+memory and the user layer only switches the buffers. This is only possible if
+the copy programs of all channels are plain copies of blocks of the process
+images, which the kernel layer executes.
+*/
+typedef struct
+{
+    BYTE*               pRxPi;                  ///< Pointer to output process image, NULL if the kernel process images are disabled
+    UINT                rxPiSize;               ///< Size of output process image
+    BYTE*               pTxPi;                  ///< Pointer to input process image
+    UINT                txPiSize;               ///< Size of input process image
+    BOOL                fActive;                ///< Flag determines if the kernel layer assembles the process images
+    BYTE*               pRxImage;               ///< Current output process image in the PDO memory
+    BYTE*               pTxImage;               ///< Current input process image in the PDO memory
+    tPdoKernelPiCopy    aCopy[CONFIG_PDO_KERNEL_PI_COPY_COUNT]; ///< Copy operations passed to the kernel layer
+} tPdouKernelPi;
+#endif
+
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+/**
+\brief Shadow mapping of a PDO direction
+
+The structure holds a new mapping of a single PDO channel which is changed while
+the PDO engine is running. The mapping is built and checked in the context of
+the OD access and switched into the channel tables at the next cycle boundary,
+i.e. at the start of pdou_copyRxPdoToPi() or pdou_copyTxPdoFromPi(). The other
+channels are not affected.
+*/
+typedef struct
+{
+    volatile BOOL       fPending;               ///< Flag determines if the shadow mapping waits for the switch
+    BOOL                fRxHold;                ///< RXPDO channel is not copied until it receives a new PDO
+    UINT32              rxHoldSequence;         ///< Sequence number of the last RXPDO before the switch
+    tPdoChannelConf     channelConf;            ///< Configuration of the channel with the new mapping
+    tPdoMappObject*     paObject;               ///< Mapping objects of the new mapping
+    tPdoCopyOp*         paCopyOp;               ///< Copy program of the new mapping
+    UINT                copyOpCount;            ///< Number of copy operations of the new mapping
+    WORD*               paBufSize;              ///< Size of the PDO buffer of each channel
+} tPdoShadowMapping;
+#endif
+
 /**
 \brief User PDO module instance
 
@@ -94,11 +222,43 @@ typedef struct
     BYTE                    aPdoIdToChannelIdTx[(PDOU_PDO_ID_MASK + 1)]; ///< TXPDO to channel ID conversion table
 #endif
     tPdoChannelSetup        pdoChannels;                ///< PDO channel setup
+    UINT                    rxChannelObjectCount;       ///< Number of mapping objects allocated per RX channel
+    UINT                    txChannelObjectCount;       ///< Number of mapping objects allocated per TX channel
     tPdoMappObject*         paRxObject;                 ///< Pointer to RX channel objects
     tPdoMappObject*         paTxObject;                 ///< Pointer to TX channel objects
+    tPdoCopyOp*             paRxCopyOp;                 ///< Pointer to RX channel copy programs
+    tPdoCopyOp*             paTxCopyOp;                 ///< Pointer to TX channel copy programs
+    UINT*                   paRxCopyOpCount;            ///< Pointer to number of copy operations per RX channel
+    UINT32*                 paRxSequence;               ///< Pointer to last read sequence number per RX channel
+    UINT8                   aRxUpdatedNodes[PDO_NODE_BITMAP_SIZE]; ///< Nodes whose RXPDOs were fresh at the last copy
+    UINT*                   paTxCopyOpCount;            ///< Pointer to number of copy operations per TX channel
+    tPdoTxChannelDirty*     paTxDirty;                  ///< Pointer to write tracking per TX channel
+    BOOL                    fTxDirtyTracking;           ///< Flag determines if TX write tracking is enabled
     BOOL                    fAllocated;                 ///< Flag determines if PDOs are allocated
     BOOL                    fRunning;                   ///< Flag determines if PDO engine is running
     tPdoCbEventPdoChange    pfnCbEventPdoChange;
+    tPdoZeroCopy            zeroCopyRx;                 ///< Zero-copy mode of the output process image
+    tPdoZeroCopy            zeroCopyTx;                 ///< Zero-copy mode of the input process image
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+    tPdouKernelPi           kernelPi;                   ///< Process images assembled by the kernel layer
+#endif
+#if (CONFIG_PDO_PARALLEL_COPY != FALSE)
+    BOOL                    fParallelRx;                ///< Flag determines if the RX channels are copied in parallel
+    BOOL                    fParallelTx;                ///< Flag determines if the TX channels are copied in parallel
+    UINT8                   aaParallelUpdatedNodes[PDOU_PARALLEL_COPY_THREADS][PDO_NODE_BITMAP_SIZE]; ///< Update bitmap of each parallel copy worker
+#endif
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+    BYTE*                   pRxPi;                      ///< Process image linked to the RXPDOs
+    UINT                    rxPiSize;                   ///< Size of the RXPDO process image
+    BYTE*                   pTxPi;                      ///< Process image linked to the TXPDOs
+    UINT                    txPiSize;                   ///< Size of the TXPDO process image
+    tPdoStaticCopyFunc*     papfnRxStaticCopy;          ///< Generated copy function per RX channel, NULL = interpreter
+    tPdoStaticCopyFunc*     papfnTxStaticCopy;          ///< Generated copy function per TX channel, NULL = interpreter
+#endif
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+    tPdoShadowMapping       rxShadow;                   ///< Shadow mapping of the RX channels
+    tPdoShadowMapping       txShadow;                   ///< Shadow mapping of the TX channels
+#endif
     //BYTE*                   pPdoMem;                    ///< pointer to PDO memory
 } tPdouInstance;
 
@@ -113,10 +273,12 @@ static tPdouInstance  pdouInstance_g;
 static tOplkError callPdoChangeCb(BOOL fActivated_p, UINT nodeId_p, UINT mappParamIndex_p,
                                   UINT8 mappObjectCount_p, BOOL fTx_p);
 static tOplkError setupRxPdoChannelTables(BYTE abChannelIdToPdoIdRx_p[D_PDO_RPDOChannels_U16],
-                                          UINT* pCountChannelIdRx_p);
+                                          UINT* pCountChannelIdRx_p, UINT* pObjectCount_p);
 static tOplkError setupTxPdoChannelTables(BYTE abChannelIdToPdoIdTx_p[D_PDO_TPDOChannels_U16],
-                                          UINT* pCountChannelIdTx_p);
-static tOplkError allocatePdoChannels(tPdoAllocationParam* pAllocationParam_p);
+                                          UINT* pCountChannelIdTx_p, UINT* pObjectCount_p);
+static UINT       getMappObjectCapacity(UINT mappParamIndex_p, UINT maxCount_p);
+static tOplkError allocatePdoChannels(tPdoAllocationParam* pAllocationParam_p,
+                                      UINT rxObjectCount_p, UINT txObjectCount_p);
 static tOplkError freePdoChannels(void);
 static tOplkError configureAllPdos(void);
 static tOplkError checkAndConfigurePdos(UINT16 mappParamIndex_p, UINT channelCount_p,
@@ -140,8 +302,50 @@ static tOplkError getMaxPdoSize(BYTE nodeId_p, BOOL fTxPdo_p,
 static tOplkError getPdoChannelId(UINT pdoId_p, BOOL fTxPdo_p, UINT* pChannelId_p);
 static UINT calcPdoMemSize(tPdoChannelSetup* pPdoChannels_p, size_t* pRxPdoMemSize_p,
                            size_t* pTxPdoMemSize_p);
+static void compileCopyProgram(tPdoMappObject* pMappObject_p, UINT mappObjectCount_p,
+                               tPdoCopyOp* pCopyOp_p, UINT* pCopyOpCount_p);
+static UINT getCopyElementSize(tPdoMappObject* pMappObject_p);
+static void copyBlockToPdo(BYTE* pPayload_p, tPdoCopyOp* pCopyOp_p);
+static void copyBlockFromPdo(BYTE* pPayload_p, tPdoCopyOp* pCopyOp_p);
 static tOplkError copyVarToPdo(BYTE* pPayload_p, tPdoMappObject* pMappObject_p);
 static tOplkError copyVarFromPdo(BYTE* pPayload_p, tPdoMappObject* pMappObject_p);
+static void setupTxChannelDirty(UINT channelId_p);
+static void trackRxSequence(UINT channelId_p, UINT nodeId_p, UINT8* pUpdatedNodes_p);
+static tOplkError copyRxChannelToPi(UINT channelId_p, UINT8* pUpdatedNodes_p);
+static tOplkError copyTxChannelFromPi(UINT channelId_p);
+#if (CONFIG_PDO_PARALLEL_COPY != FALSE)
+static void setupParallelCopy(void);
+static tOplkError copyRxPdosParallel(void);
+static tOplkError copyRxChannelParallel(UINT channelId_p, UINT workerIndex_p);
+static tOplkError copyTxChannelParallel(UINT channelId_p, UINT workerIndex_p);
+#endif
+static BOOL isNodeSelected(const UINT8* pNodeBitmap_p, UINT bitmapSize_p, UINT nodeId_p);
+static void setupZeroCopy(void);
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+static void setupKernelPi(void);
+static BOOL addKernelPiCopy(BOOL fTx_p, UINT* pCopyCount_p);
+#endif
+#if (CONFIG_PDO_WARMUP_CYCLES > 0)
+static void warmUpCopyPaths(void);
+#endif
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+static void setupStaticCopy(BOOL fTx_p, UINT channelId_p);
+static BOOL calcStaticCopyHash(tPdoMappObject* pMappObject_p, UINT mappObjectCount_p,
+                               BOOL fTx_p, BYTE* pPi_p, UINT piSize_p, UINT32* pHash_p);
+#endif
+static BOOL checkZeroCopyChannel(tPdoZeroCopy* pZeroCopy_p, tPdoChannel* pPdoChannel_p,
+                                 UINT channelCount_p, tPdoCopyOp* paCopyOp_p,
+                                 UINT* paCopyOpCount_p, UINT channelObjects_p);
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+static tOplkError allocShadowMapping(tPdoShadowMapping* pShadow_p, UINT channelCount_p,
+                                     UINT objectCount_p);
+static void freeShadowMapping(tPdoShadowMapping* pShadow_p);
+static tPdoShadowMapping* getShadowMapping(BOOL fTx_p);
+static void setShadowBufSizes(void);
+static tOplkError stageShadowMapping(tPdoShadowMapping* pShadow_p, tPdoChannelConf* pChannelConf_p,
+                                     UINT32* pAbortCode_p);
+static void switchShadowMapping(tPdoShadowMapping* pShadow_p);
+#endif
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -167,6 +371,16 @@ tOplkError pdou_init(tSyncCb pfnSyncCb_p)
     pdouInstance_g.fRunning = FALSE;
     pdouInstance_g.pfnCbEventPdoChange = NULL;
 
+#if (CONFIG_PDO_PARALLEL_COPY != FALSE)
+    {
+        tOplkError  ret;
+
+        ret = pdou_initParallelCopy();
+        if (ret != kErrorOk)
+            return ret;
+    }
+#endif
+
     return pdoucal_init(pfnSyncCb_p);
 }
 
@@ -185,6 +399,9 @@ tOplkError pdou_exit(void)
 {
     pdouInstance_g.fRunning = FALSE;
     pdouInstance_g.pfnCbEventPdoChange = NULL;
+#if (CONFIG_PDO_PARALLEL_COPY != FALSE)
+    pdou_exitParallelCopy();
+#endif
     freePdoChannels();
     pdoucal_cleanupPdoMem();
     return pdoucal_exit();
@@ -219,6 +436,9 @@ tOplkError pdou_cbNmtStateChange(tEventNmtStateChange nmtStateChange_p)
                 UINT    mapParamIndex;
                 UINT32  abortCode;
 
+                // the channels are disabled immediately and not at a cycle boundary
+                pdouInstance_g.fRunning = FALSE;
+
                 for (mapParamIndex = PDOU_OBD_IDX_RX_MAPP_PARAM;
                      mapParamIndex < PDOU_OBD_IDX_RX_MAPP_PARAM + sizeof(pdouInstance_g.aPdoIdToChannelIdRx);
                      mapParamIndex++)
@@ -241,12 +461,23 @@ tOplkError pdou_cbNmtStateChange(tEventNmtStateChange nmtStateChange_p)
                 ret = kErrorOk;
                 pdouInstance_g.fAllocated = FALSE;
                 pdouInstance_g.fRunning = FALSE;
+                pdouInstance_g.zeroCopyRx.fActive = FALSE;
+                pdouInstance_g.zeroCopyTx.fActive = FALSE;
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+                pdouInstance_g.kernelPi.fActive = FALSE;
+#endif
             }
             break;
 
         case kNmtGsResetConfiguration:
             pdouInstance_g.fAllocated = FALSE;
             pdouInstance_g.fRunning = FALSE;
+            pdouInstance_g.zeroCopyRx.fActive = FALSE;
+            pdouInstance_g.zeroCopyTx.fActive = FALSE;
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+            // the kernel layer disables its process images when the channels are reallocated
+            pdouInstance_g.kernelPi.fActive = FALSE;
+#endif
 
             // forward PDO configuration to Pdok module
             ret = configureAllPdos();
@@ -255,6 +486,16 @@ tOplkError pdou_cbNmtStateChange(tEventNmtStateChange nmtStateChange_p)
                 goto Exit;
             }
             pdouInstance_g.fRunning = TRUE;
+            setupZeroCopy();
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+            setupKernelPi();
+#endif
+#if (CONFIG_PDO_PARALLEL_COPY != FALSE)
+            setupParallelCopy();
+#endif
+#if (CONFIG_PDO_WARMUP_CYCLES > 0)
+            warmUpCopyPaths();
+#endif
             break;
 
         default:
@@ -372,11 +613,8 @@ The function copies RXPDOs into the process image
 tOplkError pdou_copyRxPdoToPi(void)
 {
     tOplkError          Ret;
-    UINT                mappObjectCount;
     tPdoChannel*        pPdoChannel;
-    tPdoMappObject*     pMappObject;
     UINT                channelId;
-    BYTE*               pPdo;
 
     if (!pdouInstance_g.fRunning)
     {
@@ -384,33 +622,112 @@ tOplkError pdou_copyRxPdoToPi(void)
         return kErrorOk;
     }
 
+    OPLK_MEMSET(pdouInstance_g.aRxUpdatedNodes, 0, sizeof(pdouInstance_g.aRxUpdatedNodes));
+
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+    if (pdouInstance_g.rxShadow.fPending)
+        switchShadowMapping(&pdouInstance_g.rxShadow);
+#endif
+
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+    if (pdouInstance_g.kernelPi.fActive)
+    {   // the kernel layer assembled the image, just switch to the latest one
+        pdouInstance_g.kernelPi.pRxImage = pdoucal_getKernelPiOut();
+        CYCLESTAT_MARK(kCycleStatStageRxPi);
+        return kErrorOk;
+    }
+#endif
+
+    if (pdouInstance_g.zeroCopyRx.fActive)
+    {   // the application reads the PDO buffer directly, just switch to the latest one
+        pPdoChannel = &pdouInstance_g.pdoChannels.pRxPdoChannel[pdouInstance_g.zeroCopyRx.channelId];
+        Ret = pdoucal_getRxPdo(&pdouInstance_g.zeroCopyRx.pPdo, pdouInstance_g.zeroCopyRx.channelId,
+                               pPdoChannel->pdoSize);
+        trackRxSequence(pdouInstance_g.zeroCopyRx.channelId, pPdoChannel->nodeId,
+                        pdouInstance_g.aRxUpdatedNodes);
+        CYCLESTAT_MARK(kCycleStatStageRxPi);
+        return Ret;
+    }
+
+#if (CONFIG_PDO_PARALLEL_COPY != FALSE)
+    if (pdouInstance_g.fParallelRx)
+    {
+        Ret = copyRxPdosParallel();
+        CYCLESTAT_MARK(kCycleStatStageRxPi);
+        return Ret;
+    }
+#endif
+
     for (channelId = 0;
          channelId < pdouInstance_g.pdoChannels.allocation.rxPdoChannelCount;
          channelId++)
     {
-        pPdoChannel = &pdouInstance_g.pdoChannels.pRxPdoChannel[channelId];
-
-        if (pPdoChannel->nodeId == PDO_INVALID_NODE_ID)
+        if (pdouInstance_g.pdoChannels.pRxPdoChannel[channelId].nodeId == PDO_INVALID_NODE_ID)
         {
             continue;
         }
 
-        Ret = pdoucal_getRxPdo(&pPdo, channelId, pPdoChannel->pdoSize);
+        Ret = copyRxChannelToPi(channelId, pdouInstance_g.aRxUpdatedNodes);
+        if (Ret != kErrorOk)
+        {   // other fatal error occurred
+            return Ret;
+        }
+    }
 
-        //TRACE("%s() Channel:%d Node:%d pPdo:%p\n", __func__, channelId, pPdoChannel->nodeId, pPdo);
+    CYCLESTAT_MARK(kCycleStatStageRxPi);
+    return kErrorOk;
+}
 
-        for (mappObjectCount = pPdoChannel->mappObjectCount,
-             pMappObject = pdouInstance_g.paRxObject + (channelId * D_PDO_RPDOChannelObjects_U8);
-             mappObjectCount > 0;
-             mappObjectCount--, pMappObject++)
-        {
-            Ret = copyVarFromPdo(pPdo, pMappObject);
-            if (Ret != kErrorOk)
-            {   // other fatal error occurred
-                return Ret;
-            }
-        }
+//------------------------------------------------------------------------------
+/**
+\brief  Copy the RXPDOs of selected nodes to process image
+
+The function copies the RXPDOs of the nodes selected in the bitmap into the
+process image. Bit n of the bitmap (byte n / 8, bit n % 8) represents node
+ID n. The channels of different nodes are independent, so several threads may
+call the function concurrently with disjoint node sets.
+
+A partial exchange does not update the bitmap of pdou_getRxPdoUpdates() and
+does not apply a pending hitless remapping, which is applied by the next call
+of pdou_copyRxPdoToPi(). It is not supported in zero-copy mode.
+
+\param  pNodeBitmap_p       Pointer to the bitmap of the selected nodes.
+\param  bitmapSize_p        Size of the bitmap in bytes.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+tOplkError pdou_copyRxPdoToPiPartial(const UINT8* pNodeBitmap_p, UINT bitmapSize_p)
+{
+    tOplkError          ret;
+    UINT                channelId;
+
+    if (!pdouInstance_g.fRunning)
+        return kErrorOk;
+
+    if (pdouInstance_g.zeroCopyRx.fActive)
+        return kErrorApiNotSupported;
+
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+    if (pdouInstance_g.kernelPi.fActive)
+        return kErrorApiNotSupported;
+#endif
+
+    for (channelId = 0;
+         channelId < pdouInstance_g.pdoChannels.allocation.rxPdoChannelCount;
+         channelId++)
+    {
+        if (!isNodeSelected(pNodeBitmap_p, bitmapSize_p,
+                            pdouInstance_g.pdoChannels.pRxPdoChannel[channelId].nodeId))
+            continue;
+
+        ret = copyRxChannelToPi(channelId, NULL);
+        if (ret != kErrorOk)
+            return ret;
     }
+
     return kErrorOk;
 }
 
@@ -429,11 +746,8 @@ The function copies the TXPDOs from the process image into the PDO buffers.
 tOplkError pdou_copyTxPdoFromPi (void)
 {
     tOplkError          ret = kErrorOk;
-    UINT                mappObjectCount;
     tPdoChannel*        pPdoChannel;
-    tPdoMappObject*     pMappObject;
     UINT                channelId;
-    BYTE*               pPdo;
 
     //TRACE_FUNC_ENTRY;
 
@@ -442,39 +756,125 @@ tOplkError pdou_copyTxPdoFromPi (void)
         return kErrorOk;
     }
 
+    if (!CYCLESTAT_CHECK_SYNC_END())
+    {   // sync budget exceeded, the previous TPDOs are sent again
+        return kErrorOk;
+    }
+
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+    if (pdouInstance_g.txShadow.fPending)
+        switchShadowMapping(&pdouInstance_g.txShadow);
+#endif
+
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+    if (pdouInstance_g.kernelPi.fActive)
+    {   // the kernel layer copies the image into the TPDOs, just hand it over
+        pdouInstance_g.kernelPi.pTxImage = pdoucal_setKernelPiIn();
+        CYCLESTAT_MARK(kCycleStatStageTxPi);
+        return kErrorOk;
+    }
+#endif
+
+    if (pdouInstance_g.zeroCopyTx.fActive)
+    {   // the application wrote the PDO buffer directly, just hand it over
+        channelId = pdouInstance_g.zeroCopyTx.channelId;
+        pPdoChannel = &pdouInstance_g.pdoChannels.pTxPdoChannel[channelId];
+        ret = pdoucal_setTxPdo(channelId, pdouInstance_g.zeroCopyTx.pPdo, pPdoChannel->pdoSize);
+        pdouInstance_g.zeroCopyTx.pPdo = pdoucal_getTxPdoAdrs(channelId);
+        CYCLESTAT_MARK(kCycleStatStageTxPi);
+        return ret;
+    }
+
+#if (CONFIG_PDO_PARALLEL_COPY != FALSE)
+    if (pdouInstance_g.fParallelTx)
+    {
+        ret = pdou_runParallelCopy(copyTxChannelParallel,
+                                   pdouInstance_g.pdoChannels.allocation.txPdoChannelCount);
+        CYCLESTAT_MARK(kCycleStatStageTxPi);
+        return ret;
+    }
+#endif
+
     for (channelId = 0;
          channelId < pdouInstance_g.pdoChannels.allocation.txPdoChannelCount;
          channelId++)
     {
-        pPdoChannel = &pdouInstance_g.pdoChannels.pTxPdoChannel[channelId];
-
-        if (pPdoChannel->nodeId == PDO_INVALID_NODE_ID)
+        if (pdouInstance_g.pdoChannels.pTxPdoChannel[channelId].nodeId == PDO_INVALID_NODE_ID)
         {
             continue;
         }
 
-        pPdo = pdoucal_getTxPdoAdrs(channelId);
-        //TRACE ("%s() pPdo: %p\n", __func__, pPdo);
-
-        for (mappObjectCount = pPdoChannel->mappObjectCount,
-             pMappObject = pdouInstance_g.paTxObject + (channelId * D_PDO_TPDOChannelObjects_U8);
-             mappObjectCount > 0;
-             mappObjectCount--, pMappObject++)
-        {
-            ret = copyVarToPdo(pPdo, pMappObject);
-            if (ret != kErrorOk)
-            {   // other fatal error occurred
-                return ret;
-            }
+        ret = copyTxChannelFromPi(channelId);
+        if (ret != kErrorOk)
+        {   // other fatal error occurred
+            return ret;
         }
-
-        // send PDO data to kernel layer
-        ret = pdoucal_setTxPdo(channelId, pPdo, pPdoChannel->pdoSize);
     }
 
+    CYCLESTAT_MARK(kCycleStatStageTxPi);
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Copy the TXPDOs of selected nodes from process image
+
+The function copies the TXPDOs of the nodes selected in the bitmap from the
+process image into the PDO buffers. Bit n of the bitmap (byte n / 8, bit n % 8)
+represents node ID n, bit 0 selects the PRes of the local node. The channels
+of different nodes are independent, so several threads may call the function
+concurrently with disjoint node sets.
+
+A partial exchange does not apply a pending hitless remapping, which is applied
+by the next call of pdou_copyTxPdoFromPi(). It is not supported in zero-copy
+mode.
+
+\param  pNodeBitmap_p       Pointer to the bitmap of the selected nodes.
+\param  bitmapSize_p        Size of the bitmap in bytes.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+tOplkError pdou_copyTxPdoFromPiPartial(const UINT8* pNodeBitmap_p, UINT bitmapSize_p)
+{
+    tOplkError          ret;
+    UINT                channelId;
+
+    if (!pdouInstance_g.fRunning)
+        return kErrorOk;
+
+    if (pdouInstance_g.zeroCopyTx.fActive)
+        return kErrorApiNotSupported;
+
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+    if (pdouInstance_g.kernelPi.fActive)
+        return kErrorApiNotSupported;
+#endif
+
+    for (channelId = 0;
+         channelId < pdouInstance_g.pdoChannels.allocation.txPdoChannelCount;
+         channelId++)
+    {
+        if (!isNodeSelected(pNodeBitmap_p, bitmapSize_p,
+                            pdouInstance_g.pdoChannels.pTxPdoChannel[channelId].nodeId))
+            continue;
+
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+        if (pdouInstance_g.txShadow.fPending &&
+            (pdouInstance_g.txShadow.channelConf.channelId == channelId))
+            continue;   // the channel is switched by the next full exchange
+#endif
+
+        ret = copyTxChannelFromPi(channelId);
+        if (ret != kErrorOk)
+            return ret;
+    }
+
+    return kErrorOk;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Register PDO change callback function
@@ -494,75 +894,519 @@ tOplkError pdou_registerEventPdoChangeCb(tPdoCbEventPdoChange pfnCbEventPdoChang
     return kErrorOk;
 }
 
-//============================================================================//
-//            P R I V A T E   F U N C T I O N S                               //
-//============================================================================//
-/// \name Private Functions
-/// \{
-
 //------------------------------------------------------------------------------
 /**
-\brief  Call PDO change callback function
+\brief  Set up zero-copy process images
 
-The function is used to call the registered callback function for PDO
-change events.
+The function sets up the zero-copy mode for the process images. If the mapping
+of a single PDO channel is a plain byte copy of a process image, the
+application works directly on the PDO buffer of this channel and the exchange
+functions only switch the buffers. Otherwise the process image is copied as
+usual. The check is repeated whenever the PDOs are configured.
 
-\param  fActivated_p        Determines if PDO is activated or disabled.
-\param  nodeId_p            Node ID this PDO mapping belongs to.
-\param  mappParamIndex_p    Object index of mapping parameter object.
-\param  mappObjectCount_p   Number of mapped objects.
-\param  fTx_p               TRUE for TXPDO and FALSE for RXPDO.
+\param  pRxPi_p             Pointer to the process image which is linked to the
+                            RXPDOs. NULL disables the zero-copy mode for RXPDOs.
+\param  rxPiSize_p          Size of the RXPDO process image.
+\param  pTxPi_p             Pointer to the process image which is linked to the
+                            TXPDOs. NULL disables the zero-copy mode for TXPDOs.
+\param  txPiSize_p          Size of the TXPDO process image.
 
 \return The function returns a tOplkError error code.
+
+\ingroup module_pdou
 */
 //------------------------------------------------------------------------------
-static tOplkError callPdoChangeCb(BOOL fActivated_p, UINT nodeId_p, UINT mappParamIndex_p,
-                                  UINT8 mappObjectCount_p, BOOL fTx_p)
+tOplkError pdou_setupZeroCopy(void* pRxPi_p, UINT rxPiSize_p, void* pTxPi_p, UINT txPiSize_p)
 {
-    tOplkError              ret = kErrorOk;
-    tPdoEventPdoChange      eventPdoChange;
-    tObdSize                obdSize;
+    pdouInstance_g.zeroCopyRx.pPi = (BYTE*)pRxPi_p;
+    pdouInstance_g.zeroCopyRx.piSize = rxPiSize_p;
+    pdouInstance_g.zeroCopyRx.fActive = FALSE;
+    pdouInstance_g.zeroCopyTx.pPi = (BYTE*)pTxPi_p;
+    pdouInstance_g.zeroCopyTx.piSize = txPiSize_p;
+    pdouInstance_g.zeroCopyTx.fActive = FALSE;
 
-    if (fActivated_p == FALSE)
+    if (pdouInstance_g.fRunning)
+        setupZeroCopy();
+
+    return kErrorOk;
+}
+
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Set process images for generated copy functions
+
+The function sets the process images which are used by the generated PDO copy
+functions. The mapping of all configured channels is checked against the
+generated functions again.
+
+\param  pRxPi_p             Pointer to the process image which is linked to the
+                            RXPDOs. NULL disables the generated RXPDO functions.
+\param  rxPiSize_p          Size of the RXPDO process image.
+\param  pTxPi_p             Pointer to the process image which is linked to the
+                            TXPDOs. NULL disables the generated TXPDO functions.
+\param  txPiSize_p          Size of the TXPDO process image.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+void pdou_setStaticCopyProcessImage(void* pRxPi_p, UINT rxPiSize_p, void* pTxPi_p, UINT txPiSize_p)
+{
+    UINT                channelId;
+
+    pdouInstance_g.pRxPi = (BYTE*)pRxPi_p;
+    pdouInstance_g.rxPiSize = rxPiSize_p;
+    pdouInstance_g.pTxPi = (BYTE*)pTxPi_p;
+    pdouInstance_g.txPiSize = txPiSize_p;
+
+    if (pdouInstance_g.papfnRxStaticCopy != NULL)
     {
-        obdSize = sizeof(mappObjectCount_p);
-        // read PDO mapping version
-        ret = obd_readEntry(mappParamIndex_p, 0x00, &mappObjectCount_p, &obdSize);
-        if (ret != kErrorOk)
-        {   // other fatal error occurred
-            return ret;
+        for (channelId = 0;
+             channelId < pdouInstance_g.pdoChannels.allocation.rxPdoChannelCount;
+             channelId++)
+        {
+            setupStaticCopy(FALSE, channelId);
         }
+    }
 
-        if (mappObjectCount_p == 0)
-        {   // PDO already disabled -> do not inform user
-            return ret;
+    if (pdouInstance_g.papfnTxStaticCopy != NULL)
+    {
+        for (channelId = 0;
+             channelId < pdouInstance_g.pdoChannels.allocation.txPdoChannelCount;
+             channelId++)
+        {
+            setupStaticCopy(TRUE, channelId);
         }
     }
-
-    eventPdoChange.fActivated = fActivated_p;
-    eventPdoChange.fTx = fTx_p;
-    eventPdoChange.nodeId = nodeId_p;
-    eventPdoChange.mappParamIndex = mappParamIndex_p;
-    eventPdoChange.mappObjectCount = mappObjectCount_p;
-
-    return pdouInstance_g.pfnCbEventPdoChange(&eventPdoChange);
 }
+#endif
 
 //------------------------------------------------------------------------------
 /**
-\brief  Setup RXPDO channel tables
+\brief  Get zero-copy RXPDO buffer
 
-This function allocates memory for PDO channel tables. It scans the PDO_RxCommParam
-objects to calculate the number of "PDO channels". It creates two tables:
-- PDO-to-ChannelId mapping
-- ChannelId to PDO mapping
+The function returns the RXPDO buffer which is used as process image in
+zero-copy mode. The buffer changes with every call of pdou_copyRxPdoToPi().
 
-The number of PDO channels will be transfered to the PDOk module which allocates
+\return The function returns a pointer to the RXPDO buffer or NULL if the
+        zero-copy mode is not active.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+void* pdou_getZeroCopyRxPdo(void)
+{
+    if (!pdouInstance_g.fRunning || !pdouInstance_g.zeroCopyRx.fActive)
+        return NULL;
+
+    return pdouInstance_g.zeroCopyRx.pPdo;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get zero-copy TXPDO buffer
+
+The function returns the TXPDO buffer which is used as process image in
+zero-copy mode. The buffer changes with every call of pdou_copyTxPdoFromPi().
+The buffer does not contain the data of the previous cycle, therefore it has
+to be written completely.
+
+\return The function returns a pointer to the TXPDO buffer or NULL if the
+        zero-copy mode is not active.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+void* pdou_getZeroCopyTxPdo(void)
+{
+    if (!pdouInstance_g.fRunning || !pdouInstance_g.zeroCopyTx.fActive)
+        return NULL;
+
+    return pdouInstance_g.zeroCopyTx.pPdo;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set up kernel process images
+
+The function sets up the process images which are assembled by the kernel
+layer. If all PDO channels only copy blocks of bytes between the PDOs and the
+process images, the copy operations are passed to the kernel layer. It copies
+the RXPDOs into the output process image and the TXPDOs from the input process
+image itself and exchanges the images with the user layer at the sync event.
+The application then works directly on the images in the PDO memory, which are
+returned by pdou_getKernelPiOut() and pdou_getKernelPiIn(), and the copy
+functions only switch the buffers. Otherwise the process image is copied as
+usual. The check is repeated whenever the PDOs are configured.
+
+\param  pRxPi_p             Pointer to the process image which is linked to the
+                            RXPDOs. NULL disables the kernel process images.
+\param  rxPiSize_p          Size of the RXPDO process image.
+\param  pTxPi_p             Pointer to the process image which is linked to the
+                            TXPDOs. NULL disables the kernel process images.
+\param  txPiSize_p          Size of the TXPDO process image.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                    The process images are set up.
+\retval kErrorApiPISizeExceeded     A process image exceeds CONFIG_PDO_KERNEL_PI_SIZE.
+\retval kErrorApiNotSupported       The kernel process images are not compiled in.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+tOplkError pdou_setupKernelPi(void* pRxPi_p, UINT rxPiSize_p, void* pTxPi_p, UINT txPiSize_p)
+{
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+    tPdouKernelPi*      pKernelPi = &pdouInstance_g.kernelPi;
+
+    if ((pRxPi_p == NULL) || (pTxPi_p == NULL))
+    {
+        pRxPi_p = NULL;
+        pTxPi_p = NULL;
+    }
+    else if ((rxPiSize_p > CONFIG_PDO_KERNEL_PI_SIZE) || (txPiSize_p > CONFIG_PDO_KERNEL_PI_SIZE))
+        return kErrorApiPISizeExceeded;
+
+    pKernelPi->pRxPi = (BYTE*)pRxPi_p;
+    pKernelPi->rxPiSize = rxPiSize_p;
+    pKernelPi->pTxPi = (BYTE*)pTxPi_p;
+    pKernelPi->txPiSize = txPiSize_p;
+
+    if (pdouInstance_g.fRunning)
+        setupKernelPi();
+
+    return kErrorOk;
+#else
+    UNUSED_PARAMETER(pRxPi_p);
+    UNUSED_PARAMETER(rxPiSize_p);
+    UNUSED_PARAMETER(pTxPi_p);
+    UNUSED_PARAMETER(txPiSize_p);
+
+    return kErrorApiNotSupported;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get kernel output process image
+
+The function returns the output process image which was assembled by the
+kernel layer. The buffer changes with every call of pdou_copyRxPdoToPi().
+
+\return The function returns a pointer to the output process image or NULL if
+        the kernel process images are not active.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+void* pdou_getKernelPiOut(void)
+{
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+    if (!pdouInstance_g.fRunning || !pdouInstance_g.kernelPi.fActive)
+        return NULL;
+
+    return pdouInstance_g.kernelPi.pRxImage;
+#else
+    return NULL;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get kernel input process image
+
+The function returns the input process image which is copied into the TXPDOs
+by the kernel layer. The buffer changes with every call of
+pdou_copyTxPdoFromPi(). The buffer does not contain the data of the previous
+cycle, therefore it has to be written completely.
+
+\return The function returns a pointer to the input process image or NULL if
+        the kernel process images are not active.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+void* pdou_getKernelPiIn(void)
+{
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+    if (!pdouInstance_g.fRunning || !pdouInstance_g.kernelPi.fActive)
+        return NULL;
+
+    return pdouInstance_g.kernelPi.pTxImage;
+#else
+    return NULL;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Enable TXPDO write tracking
+
+The function enables or disables the write tracking of the TXPDO variables. If
+write tracking is enabled, pdou_copyTxPdoFromPi() only encodes the TXPDO
+channels whose variables have been marked as written by pdou_markTxPdoDirty()
+since the last call. The other TXPDO channels keep their last data. All
+channels are encoded once after enabling the write tracking and after each PDO
+configuration.
+
+\param  fEnable_p           TRUE enables write tracking, FALSE disables it.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+void pdou_enableTxPdoDirtyTracking(BOOL fEnable_p)
+{
+    UINT                channelId;
+
+    if (pdouInstance_g.paTxDirty != NULL)
+    {
+        for (channelId = 0;
+             channelId < pdouInstance_g.pdoChannels.allocation.txPdoChannelCount;
+             channelId++)
+        {
+            pdouInstance_g.paTxDirty[channelId].fDirty = TRUE;
+        }
+    }
+
+    pdouInstance_g.fTxDirtyTracking = fEnable_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Mark TXPDO variables as written
+
+The function marks all TXPDO channels as dirty which have variables mapped
+within the specified memory range.
+
+\param  pData_p             Pointer to the written data.
+\param  size_p              Size of the written data.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+void pdou_markTxPdoDirty(const void* pData_p, UINT size_p)
+{
+    UINT                channelId;
+    tPdoTxChannelDirty* pTxDirty;
+    const BYTE*         pStart = (const BYTE*)pData_p;
+    const BYTE*         pEnd = pStart + size_p;
+
+    if (pdouInstance_g.paTxDirty == NULL)
+        return;
+
+    for (channelId = 0, pTxDirty = pdouInstance_g.paTxDirty;
+         channelId < pdouInstance_g.pdoChannels.allocation.txPdoChannelCount;
+         channelId++, pTxDirty++)
+    {
+        if ((pStart < pTxDirty->pVarEnd) && (pEnd > pTxDirty->pVarStart))
+            pTxDirty->fDirty = TRUE;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get RXPDO update bitmap
+
+The function returns a bitmap of the nodes whose RXPDOs contained fresh data at
+the last call of pdou_copyRxPdoToPi(). Bit n of the bitmap (byte n / 8, bit
+n % 8) represents node ID n.
+
+\param  pNodeBitmap_p       Pointer to store the bitmap.
+\param  bitmapSize_p        Size of the bitmap buffer in bytes. At most
+                            PDO_NODE_BITMAP_SIZE bytes are stored.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+void pdou_getRxPdoUpdates(UINT8* pNodeBitmap_p, UINT bitmapSize_p)
+{
+    if (bitmapSize_p > PDO_NODE_BITMAP_SIZE)
+        bitmapSize_p = PDO_NODE_BITMAP_SIZE;
+
+    OPLK_MEMCPY(pNodeBitmap_p, pdouInstance_g.aRxUpdatedNodes, bitmapSize_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get RXPDO sequence number of a node
+
+The function returns the sequence number of the RXPDO of the specified node
+which was read by the last call of pdou_copyRxPdoToPi(). The sequence number is
+incremented with every PDO received from the node.
+
+\param  nodeId_p            Node ID of the RXPDO.
+\param  pSequence_p         Pointer to store the sequence number. 0 means that
+                            no PDO has been received yet.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk            The sequence number is returned.
+\retval kErrorPdoNotExist   No RXPDO channel is configured for the node.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+tOplkError pdou_getRxPdoSequence(UINT nodeId_p, UINT32* pSequence_p)
+{
+    UINT                channelId;
+
+    if (pdouInstance_g.paRxSequence == NULL)
+        return kErrorPdoNotExist;
+
+    for (channelId = 0;
+         channelId < pdouInstance_g.pdoChannels.allocation.rxPdoChannelCount;
+         channelId++)
+    {
+        if (pdouInstance_g.pdoChannels.pRxPdoChannel[channelId].nodeId == nodeId_p)
+        {
+            *pSequence_p = pdouInstance_g.paRxSequence[channelId];
+            return kErrorOk;
+        }
+    }
+
+    return kErrorPdoNotExist;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add RPDO to TPDO route
+
+The function adds a route which copies a region of an RPDO into a TPDO in the
+kernel layer. The PDOs are specified by their mapping parameter objects.
+
+\param  rxMappParamIndex_p  Index of the RPDO mapping parameter object.
+\param  rxOffset_p          Offset of the region in the RPDO in bytes.
+\param  size_p              Size of the region in bytes.
+\param  txMappParamIndex_p  Index of the TPDO mapping parameter object.
+\param  txOffset_p          Offset of the region in the TPDO in bytes.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The route is passed to the kernel layer.
+\retval kErrorApiInvalidParam   The indices or the region are invalid.
+\retval kErrorPdoNotExist       The RPDO or TPDO channel does not exist.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+tOplkError pdou_addPdoRoute(UINT rxMappParamIndex_p, UINT rxOffset_p, UINT size_p,
+                            UINT txMappParamIndex_p, UINT txOffset_p)
+{
+    tOplkError  ret;
+    tPdoRoute   route;
+    UINT        channelId;
+
+    if (((rxMappParamIndex_p & PDOU_OBD_IDX_MASK) != PDOU_OBD_IDX_RX_MAPP_PARAM) ||
+        ((txMappParamIndex_p & PDOU_OBD_IDX_MASK) != PDOU_OBD_IDX_TX_MAPP_PARAM) ||
+        (size_p == 0) ||
+        ((rxOffset_p + size_p) > C_DLL_MAX_PAYL_OFFSET) ||
+        ((txOffset_p + size_p) > C_DLL_MAX_PAYL_OFFSET))
+        return kErrorApiInvalidParam;
+
+    ret = getPdoChannelId(rxMappParamIndex_p & PDOU_PDO_ID_MASK, FALSE, &channelId);
+    if (ret != kErrorOk)
+        return ret;
+    if (channelId >= pdouInstance_g.pdoChannels.allocation.rxPdoChannelCount)
+        return kErrorPdoNotExist;
+    route.rxChannelId = (UINT16)channelId;
+
+    ret = getPdoChannelId(txMappParamIndex_p & PDOU_PDO_ID_MASK, TRUE, &channelId);
+    if (ret != kErrorOk)
+        return ret;
+    if (channelId >= pdouInstance_g.pdoChannels.allocation.txPdoChannelCount)
+        return kErrorPdoNotExist;
+    route.txChannelId = (UINT16)channelId;
+
+    route.rxOffset = (UINT16)rxOffset_p;
+    route.txOffset = (UINT16)txOffset_p;
+    route.size = (UINT16)size_p;
+
+    return pdoucal_postAddRoute(&route);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Remove all RPDO to TPDO routes
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+tOplkError pdou_clearPdoRoutes(void)
+{
+    return pdoucal_postClearRoutes();
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Call PDO change callback function
+
+The function is used to call the registered callback function for PDO
+change events.
+
+\param  fActivated_p        Determines if PDO is activated or disabled.
+\param  nodeId_p            Node ID this PDO mapping belongs to.
+\param  mappParamIndex_p    Object index of mapping parameter object.
+\param  mappObjectCount_p   Number of mapped objects.
+\param  fTx_p               TRUE for TXPDO and FALSE for RXPDO.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError callPdoChangeCb(BOOL fActivated_p, UINT nodeId_p, UINT mappParamIndex_p,
+                                  UINT8 mappObjectCount_p, BOOL fTx_p)
+{
+    tOplkError              ret = kErrorOk;
+    tPdoEventPdoChange      eventPdoChange;
+    tObdSize                obdSize;
+
+    if (fActivated_p == FALSE)
+    {
+        obdSize = sizeof(mappObjectCount_p);
+        // read PDO mapping version
+        ret = obd_readEntry(mappParamIndex_p, 0x00, &mappObjectCount_p, &obdSize);
+        if (ret != kErrorOk)
+        {   // other fatal error occurred
+            return ret;
+        }
+
+        if (mappObjectCount_p == 0)
+        {   // PDO already disabled -> do not inform user
+            return ret;
+        }
+    }
+
+    eventPdoChange.fActivated = fActivated_p;
+    eventPdoChange.fTx = fTx_p;
+    eventPdoChange.nodeId = nodeId_p;
+    eventPdoChange.mappParamIndex = mappParamIndex_p;
+    eventPdoChange.mappObjectCount = mappObjectCount_p;
+
+    return pdouInstance_g.pfnCbEventPdoChange(&eventPdoChange);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Setup RXPDO channel tables
+
+This function allocates memory for PDO channel tables. It scans the PDO_RxCommParam
+objects to calculate the number of "PDO channels". It creates two tables:
+- PDO-to-ChannelId mapping
+- ChannelId to PDO mapping
+
+The number of PDO channels will be transfered to the PDOk module which allocates
 memory to store the mapping information.
 
 \param  abChannelIdToPdoIdRx_p      Pointer to array to store TX channel to PDO
                                     mapping
 \param  pCountChannelIdRx_p         Pointer to store number of RX channels
+\param  pObjectCount_p              Pointer to store the number of mapping
+                                    objects to be allocated per RX channel
 
 \return The function returns a tOplkError error code.
 
@@ -571,7 +1415,7 @@ memory to store the mapping information.
 //------------------------------------------------------------------------------
 static tOplkError setupRxPdoChannelTables(
                        BYTE abChannelIdToPdoIdRx_p[D_PDO_RPDOChannels_U16],
-                       UINT* pCountChannelIdRx_p)
+                       UINT* pCountChannelIdRx_p, UINT* pObjectCount_p)
 {
     tOplkError              ret = kErrorOk;
     tObdSize                obdSize;
@@ -579,8 +1423,10 @@ static tOplkError setupRxPdoChannelTables(
     UINT                    pdoId;
     UINT                    commParamIndex;
     UINT                    channelCount;
+    UINT                    objectCount;
 
     channelCount = 0;
+    *pObjectCount_p = 1;            // allocate at least one object per channel
 
     OPLK_MEMSET(pdouInstance_g.aPdoIdToChannelIdRx, 0,
                 sizeof(pdouInstance_g.aPdoIdToChannelIdRx));
@@ -608,6 +1454,11 @@ static tOplkError setupRxPdoChannelTables(
 
                 pdouInstance_g.aPdoIdToChannelIdRx[pdoId] = (BYTE)channelCount - 1;
                 abChannelIdToPdoIdRx_p[channelCount - 1] = (BYTE)pdoId;
+
+                objectCount = getMappObjectCapacity(PDOU_OBD_IDX_RX_MAPP_PARAM + pdoId,
+                                                    D_PDO_RPDOChannelObjects_U8);
+                if (objectCount > *pObjectCount_p)
+                    *pObjectCount_p = objectCount;
                 break;
 
             default:
@@ -635,13 +1486,15 @@ memory to store the mapping information.
 \param  abChannelIdToPdoIdTx_p      Pointer to array to store RX channel to PDO
                                     mapping
 \param  pCountChannelIdTx_p         Pointer to store number of TX channels
+\param  pObjectCount_p              Pointer to store the number of mapping
+                                    objects to be allocated per TX channel
 
 \return The function returns a tOplkError error code.
 **/
 //------------------------------------------------------------------------------
 static tOplkError setupTxPdoChannelTables(
                         BYTE abChannelIdToPdoIdTx_p[D_PDO_TPDOChannels_U16],
-                        UINT* pCountChannelIdTx_p)
+                        UINT* pCountChannelIdTx_p, UINT* pObjectCount_p)
 {
     tOplkError              ret = kErrorOk;
     tObdSize                obdSize;
@@ -649,8 +1502,10 @@ static tOplkError setupTxPdoChannelTables(
     UINT                    pdoId;
     UINT                    commParamIndex;
     UINT                    channelCount;
+    UINT                    objectCount;
 
     channelCount = 0;
+    *pObjectCount_p = 1;            // allocate at least one object per channel
 
 #if defined(CONFIG_INCLUDE_NMT_MN)
     OPLK_MEMSET(pdouInstance_g.aPdoIdToChannelIdTx, 0,
@@ -684,6 +1539,11 @@ static tOplkError setupTxPdoChannelTables(
                 pdouInstance_g.aPdoIdToChannelIdTx[pdoId] = (BYTE)channelCount - 1;
 #endif
                 abChannelIdToPdoIdTx_p[channelCount - 1] = (BYTE)pdoId;
+
+                objectCount = getMappObjectCapacity(PDOU_OBD_IDX_TX_MAPP_PARAM + pdoId,
+                                                    D_PDO_TPDOChannelObjects_U8);
+                if (objectCount > *pObjectCount_p)
+                    *pObjectCount_p = objectCount;
                 break;
 
             default:
@@ -697,6 +1557,41 @@ static tOplkError setupTxPdoChannelTables(
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get the number of mapping entries of a mapping parameter object
+
+The function determines how many mapping entries the mapping parameter object
+of a PDO provides in the OD. This is the largest number of objects the PDO can
+ever map, so only this many mapping objects are allocated per channel instead
+of the worst case of D_PDO_RPDOChannelObjects_U8/D_PDO_TPDOChannelObjects_U8.
+
+\param  mappParamIndex_p        Index of the mapping parameter object.
+\param  maxCount_p              Maximum number of mapping objects per channel.
+
+\return The function returns the number of mapping entries (0 if the mapping
+        parameter object does not exist).
+**/
+//------------------------------------------------------------------------------
+static UINT getMappObjectCapacity(UINT mappParamIndex_p, UINT maxCount_p)
+{
+    tObdEntryRef    entryRef;
+    UINT            count;
+
+    if (obd_resolveEntry(mappParamIndex_p, 0x00, &entryRef) != kErrorOk)
+        return 0;
+
+    // sub-index 0 holds the number of mapped objects
+    count = entryRef.pObdEntry->count;
+    if (count > 0)
+        count--;
+
+    if (count > maxCount_p)
+        count = maxCount_p;
+
+    return count;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Allocate memory for PDO channels
@@ -704,18 +1599,23 @@ static tOplkError setupTxPdoChannelTables(
 This function allocates memory for PDOs channels
 
 \param  pAllocationParam_p      Pointer to allocation parameters.
+\param  rxObjectCount_p         Number of mapping objects per RX channel.
+\param  txObjectCount_p         Number of mapping objects per TX channel.
 
 \return The function returns a tOplkError error code.
 **/
 //------------------------------------------------------------------------------
-static tOplkError allocatePdoChannels(tPdoAllocationParam* pAllocationParam_p)
+static tOplkError allocatePdoChannels(tPdoAllocationParam* pAllocationParam_p,
+                                      UINT rxObjectCount_p, UINT txObjectCount_p)
 {
     tOplkError      ret = kErrorOk;
     UINT            index;
 
-    if (pdouInstance_g.pdoChannels.allocation.rxPdoChannelCount != pAllocationParam_p->rxPdoChannelCount)
+    if ((pdouInstance_g.pdoChannels.allocation.rxPdoChannelCount != pAllocationParam_p->rxPdoChannelCount) ||
+        (pdouInstance_g.rxChannelObjectCount != rxObjectCount_p))
     {   // allocation should be changed
         pdouInstance_g.pdoChannels.allocation.rxPdoChannelCount = pAllocationParam_p->rxPdoChannelCount;
+        pdouInstance_g.rxChannelObjectCount = rxObjectCount_p;
         if (pdouInstance_g.pdoChannels.pRxPdoChannel != NULL)
         {
             OPLK_FREE(pdouInstance_g.pdoChannels.pRxPdoChannel);
@@ -728,10 +1628,40 @@ static tOplkError allocatePdoChannels(tPdoAllocationParam* pAllocationParam_p)
             pdouInstance_g.paRxObject = NULL;
         }
 
-        if (pAllocationParam_p->rxPdoChannelCount > 0)
+        if (pdouInstance_g.paRxCopyOp != NULL)
         {
-            pdouInstance_g.pdoChannels.pRxPdoChannel =
-                  OPLK_MALLOC(sizeof(tPdoChannel) * pAllocationParam_p->rxPdoChannelCount);
+            OPLK_FREE(pdouInstance_g.paRxCopyOp);
+            pdouInstance_g.paRxCopyOp = NULL;
+        }
+
+        if (pdouInstance_g.paRxCopyOpCount != NULL)
+        {
+            OPLK_FREE(pdouInstance_g.paRxCopyOpCount);
+            pdouInstance_g.paRxCopyOpCount = NULL;
+        }
+
+        if (pdouInstance_g.paRxSequence != NULL)
+        {
+            OPLK_FREE(pdouInstance_g.paRxSequence);
+            pdouInstance_g.paRxSequence = NULL;
+        }
+
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+        if (pdouInstance_g.papfnRxStaticCopy != NULL)
+        {
+            OPLK_FREE(pdouInstance_g.papfnRxStaticCopy);
+            pdouInstance_g.papfnRxStaticCopy = NULL;
+        }
+#endif
+
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+        freeShadowMapping(&pdouInstance_g.rxShadow);
+#endif
+
+        if (pAllocationParam_p->rxPdoChannelCount > 0)
+        {
+            pdouInstance_g.pdoChannels.pRxPdoChannel =
+                  OPLK_MALLOC(sizeof(tPdoChannel) * pAllocationParam_p->rxPdoChannelCount);
 
             if (pdouInstance_g.pdoChannels.pRxPdoChannel == NULL)
             {
@@ -742,13 +1672,56 @@ static tOplkError allocatePdoChannels(tPdoAllocationParam* pAllocationParam_p)
             pdouInstance_g.paRxObject =
                     OPLK_MALLOC(sizeof(tPdoMappObject)
                                * pAllocationParam_p->rxPdoChannelCount
-                               * D_PDO_RPDOChannelObjects_U8);
+                               * pdouInstance_g.rxChannelObjectCount);
 
             if (pdouInstance_g.paRxObject == NULL)
             {
                 ret = kErrorPdoInitError;
                 goto Exit;
             }
+
+            pdouInstance_g.paRxCopyOp =
+                    OPLK_MALLOC(sizeof(tPdoCopyOp)
+                               * pAllocationParam_p->rxPdoChannelCount
+                               * pdouInstance_g.rxChannelObjectCount);
+            if (pdouInstance_g.paRxCopyOp == NULL)
+            {
+                ret = kErrorPdoInitError;
+                goto Exit;
+            }
+
+            pdouInstance_g.paRxCopyOpCount =
+                    OPLK_MALLOC(sizeof(UINT) * pAllocationParam_p->rxPdoChannelCount);
+            if (pdouInstance_g.paRxCopyOpCount == NULL)
+            {
+                ret = kErrorPdoInitError;
+                goto Exit;
+            }
+
+            pdouInstance_g.paRxSequence =
+                    OPLK_MALLOC(sizeof(UINT32) * pAllocationParam_p->rxPdoChannelCount);
+            if (pdouInstance_g.paRxSequence == NULL)
+            {
+                ret = kErrorPdoInitError;
+                goto Exit;
+            }
+
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+            pdouInstance_g.papfnRxStaticCopy =
+                    OPLK_MALLOC(sizeof(tPdoStaticCopyFunc) * pAllocationParam_p->rxPdoChannelCount);
+            if (pdouInstance_g.papfnRxStaticCopy == NULL)
+            {
+                ret = kErrorPdoInitError;
+                goto Exit;
+            }
+#endif
+
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+            ret = allocShadowMapping(&pdouInstance_g.rxShadow, pAllocationParam_p->rxPdoChannelCount,
+                                     pdouInstance_g.rxChannelObjectCount);
+            if (ret != kErrorOk)
+                goto Exit;
+#endif
         }
     }
 
@@ -756,13 +1729,24 @@ static tOplkError allocatePdoChannels(tPdoAllocationParam* pAllocationParam_p)
     for (index = 0; index < pAllocationParam_p->rxPdoChannelCount; index++)
     {
         pdouInstance_g.pdoChannels.pRxPdoChannel[index].nodeId = PDO_INVALID_NODE_ID;
+        pdouInstance_g.paRxCopyOpCount[index] = 0;
+        pdouInstance_g.paRxSequence[index] = 0;
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+        pdouInstance_g.papfnRxStaticCopy[index] = NULL;
+#endif
     }
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+    pdouInstance_g.rxShadow.fPending = FALSE;
+    pdouInstance_g.rxShadow.fRxHold = FALSE;
+#endif
 
     //--------------------------------------------------------------------------
-    if (pdouInstance_g.pdoChannels.allocation.txPdoChannelCount != pAllocationParam_p->txPdoChannelCount)
-    {   // allocation should be changedconfigureChannel
+    if ((pdouInstance_g.pdoChannels.allocation.txPdoChannelCount != pAllocationParam_p->txPdoChannelCount) ||
+        (pdouInstance_g.txChannelObjectCount != txObjectCount_p))
+    {   // allocation should be changed
 
         pdouInstance_g.pdoChannels.allocation.txPdoChannelCount = pAllocationParam_p->txPdoChannelCount;
+        pdouInstance_g.txChannelObjectCount = txObjectCount_p;
         if (pdouInstance_g.pdoChannels.pTxPdoChannel != NULL)
         {
             OPLK_FREE(pdouInstance_g.pdoChannels.pTxPdoChannel);
@@ -775,6 +1759,36 @@ static tOplkError allocatePdoChannels(tPdoAllocationParam* pAllocationParam_p)
             pdouInstance_g.paTxObject = NULL;
         }
 
+        if (pdouInstance_g.paTxCopyOp != NULL)
+        {
+            OPLK_FREE(pdouInstance_g.paTxCopyOp);
+            pdouInstance_g.paTxCopyOp = NULL;
+        }
+
+        if (pdouInstance_g.paTxCopyOpCount != NULL)
+        {
+            OPLK_FREE(pdouInstance_g.paTxCopyOpCount);
+            pdouInstance_g.paTxCopyOpCount = NULL;
+        }
+
+        if (pdouInstance_g.paTxDirty != NULL)
+        {
+            OPLK_FREE(pdouInstance_g.paTxDirty);
+            pdouInstance_g.paTxDirty = NULL;
+        }
+
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+        if (pdouInstance_g.papfnTxStaticCopy != NULL)
+        {
+            OPLK_FREE(pdouInstance_g.papfnTxStaticCopy);
+            pdouInstance_g.papfnTxStaticCopy = NULL;
+        }
+#endif
+
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+        freeShadowMapping(&pdouInstance_g.txShadow);
+#endif
+
         if (pAllocationParam_p->txPdoChannelCount > 0)
         {
             pdouInstance_g.pdoChannels.pTxPdoChannel =
@@ -788,12 +1802,55 @@ static tOplkError allocatePdoChannels(tPdoAllocationParam* pAllocationParam_p)
             pdouInstance_g.paTxObject =
                     OPLK_MALLOC(sizeof(tPdoMappObject)
                                * pAllocationParam_p->txPdoChannelCount
-                               * D_PDO_TPDOChannelObjects_U8);
+                               * pdouInstance_g.txChannelObjectCount);
             if (pdouInstance_g.paTxObject == NULL)
             {
                 ret = kErrorPdoInitError;
                 goto Exit;
             }
+
+            pdouInstance_g.paTxCopyOp =
+                    OPLK_MALLOC(sizeof(tPdoCopyOp)
+                               * pAllocationParam_p->txPdoChannelCount
+                               * pdouInstance_g.txChannelObjectCount);
+            if (pdouInstance_g.paTxCopyOp == NULL)
+            {
+                ret = kErrorPdoInitError;
+                goto Exit;
+            }
+
+            pdouInstance_g.paTxCopyOpCount =
+                    OPLK_MALLOC(sizeof(UINT) * pAllocationParam_p->txPdoChannelCount);
+            if (pdouInstance_g.paTxCopyOpCount == NULL)
+            {
+                ret = kErrorPdoInitError;
+                goto Exit;
+            }
+
+            pdouInstance_g.paTxDirty =
+                    OPLK_MALLOC(sizeof(tPdoTxChannelDirty) * pAllocationParam_p->txPdoChannelCount);
+            if (pdouInstance_g.paTxDirty == NULL)
+            {
+                ret = kErrorPdoInitError;
+                goto Exit;
+            }
+
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+            pdouInstance_g.papfnTxStaticCopy =
+                    OPLK_MALLOC(sizeof(tPdoStaticCopyFunc) * pAllocationParam_p->txPdoChannelCount);
+            if (pdouInstance_g.papfnTxStaticCopy == NULL)
+            {
+                ret = kErrorPdoInitError;
+                goto Exit;
+            }
+#endif
+
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+            ret = allocShadowMapping(&pdouInstance_g.txShadow, pAllocationParam_p->txPdoChannelCount,
+                                     pdouInstance_g.txChannelObjectCount);
+            if (ret != kErrorOk)
+                goto Exit;
+#endif
         }
     }
 
@@ -801,7 +1858,15 @@ static tOplkError allocatePdoChannels(tPdoAllocationParam* pAllocationParam_p)
     for (index = 0; index < pAllocationParam_p->txPdoChannelCount; index++)
     {
         pdouInstance_g.pdoChannels.pTxPdoChannel[index].nodeId = PDO_INVALID_NODE_ID;
+        pdouInstance_g.paTxCopyOpCount[index] = 0;
+        setupTxChannelDirty(index);
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+        pdouInstance_g.papfnTxStaticCopy[index] = NULL;
+#endif
     }
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+    pdouInstance_g.txShadow.fPending = FALSE;
+#endif
 
 Exit:
     //TRACE("%s() = %s\n", __func__, debugstr_getRetValStr(Ret));
@@ -845,6 +1910,61 @@ static tOplkError freePdoChannels(void)
         pdouInstance_g.paTxObject = NULL;
     }
 
+    if (pdouInstance_g.paRxCopyOp != NULL)
+    {
+        OPLK_FREE(pdouInstance_g.paRxCopyOp);
+        pdouInstance_g.paRxCopyOp = NULL;
+    }
+
+    if (pdouInstance_g.paRxCopyOpCount != NULL)
+    {
+        OPLK_FREE(pdouInstance_g.paRxCopyOpCount);
+        pdouInstance_g.paRxCopyOpCount = NULL;
+    }
+
+    if (pdouInstance_g.paRxSequence != NULL)
+    {
+        OPLK_FREE(pdouInstance_g.paRxSequence);
+        pdouInstance_g.paRxSequence = NULL;
+    }
+
+    if (pdouInstance_g.paTxCopyOp != NULL)
+    {
+        OPLK_FREE(pdouInstance_g.paTxCopyOp);
+        pdouInstance_g.paTxCopyOp = NULL;
+    }
+
+    if (pdouInstance_g.paTxCopyOpCount != NULL)
+    {
+        OPLK_FREE(pdouInstance_g.paTxCopyOpCount);
+        pdouInstance_g.paTxCopyOpCount = NULL;
+    }
+
+    if (pdouInstance_g.paTxDirty != NULL)
+    {
+        OPLK_FREE(pdouInstance_g.paTxDirty);
+        pdouInstance_g.paTxDirty = NULL;
+    }
+
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+    if (pdouInstance_g.papfnRxStaticCopy != NULL)
+    {
+        OPLK_FREE(pdouInstance_g.papfnRxStaticCopy);
+        pdouInstance_g.papfnRxStaticCopy = NULL;
+    }
+
+    if (pdouInstance_g.papfnTxStaticCopy != NULL)
+    {
+        OPLK_FREE(pdouInstance_g.papfnTxStaticCopy);
+        pdouInstance_g.papfnTxStaticCopy = NULL;
+    }
+#endif
+
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+    freeShadowMapping(&pdouInstance_g.rxShadow);
+    freeShadowMapping(&pdouInstance_g.txShadow);
+#endif
+
     return ret;
 }
 
@@ -864,18 +1984,20 @@ static tOplkError configureAllPdos(void)
     BYTE                    aChannelIdToPdoIdRx[D_PDO_RPDOChannels_U16];
     BYTE                    aChannelIdToPdoIdTx[D_PDO_TPDOChannels_U16];
     tPdoAllocationParam     allocParam;
+    UINT                    rxObjectCount;
+    UINT                    txObjectCount;
     DWORD                   dwAbortCode = 0;
     size_t                  txPdoMemSize;
     size_t                  rxPdoMemSize;
 
-    ret = setupRxPdoChannelTables(aChannelIdToPdoIdRx, &allocParam.rxPdoChannelCount);
+    ret = setupRxPdoChannelTables(aChannelIdToPdoIdRx, &allocParam.rxPdoChannelCount, &rxObjectCount);
     if (ret != kErrorOk)
         goto Exit;
-    ret = setupTxPdoChannelTables(aChannelIdToPdoIdTx, &allocParam.txPdoChannelCount);
+    ret = setupTxPdoChannelTables(aChannelIdToPdoIdTx, &allocParam.txPdoChannelCount, &txObjectCount);
     if (ret != kErrorOk)
         goto Exit;
 
-    ret = allocatePdoChannels(&allocParam);
+    ret = allocatePdoChannels(&allocParam, rxObjectCount, txObjectCount);
     if (ret != kErrorOk)
         goto Exit;
     ret = pdoucal_postPdokChannelAlloc(&allocParam);
@@ -897,6 +2019,9 @@ static tOplkError configureAllPdos(void)
         goto Exit;
 
     calcPdoMemSize(&pdouInstance_g.pdoChannels, &rxPdoMemSize, &txPdoMemSize);
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+    setShadowBufSizes();
+#endif
     pdoucal_postSetupPdoBuffers(rxPdoMemSize, txPdoMemSize);
 
     // TODO how to be sure that kernel is ready before starting??
@@ -977,6 +2102,10 @@ static tOplkError checkAndConfigurePdo(UINT16 mappParamIndex_p,
     tPdoMappObject*     pMappObject;
     UINT                calcPdoSize;
     UINT                count;
+    UINT                maxObjectCount;
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+    tPdoShadowMapping*  pShadow = NULL;
+#endif
 
     DEBUG_LVL_PDO_TRACE("%s() mappParamIndex:%04x mappObjectCount:%d\n",
                         __func__, mappParamIndex_p, mappObjectCount_p);
@@ -985,8 +2114,31 @@ static tOplkError checkAndConfigurePdo(UINT16 mappParamIndex_p,
     commParamIndex = ~PDOU_OBD_IDX_MAPP_PARAM & mappParamIndex_p;
     fTxPdo = (mappParamIndex_p >= PDOU_OBD_IDX_TX_MAPP_PARAM) ? TRUE : FALSE;
 
-    if ((!fTxPdo && (mappObjectCount_p > D_PDO_RPDOChannelObjects_U8)) ||
-        (fTxPdo && (mappObjectCount_p > D_PDO_TPDOChannelObjects_U8)))
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+    if (pdouInstance_g.fRunning && pdouInstance_g.fAllocated &&
+        !(fTxPdo ? pdouInstance_g.zeroCopyTx.fActive : pdouInstance_g.zeroCopyRx.fActive))
+    {   // change the mapping of the channel without stopping the PDO engine
+        pShadow = getShadowMapping(fTxPdo);
+        if (pShadow->paObject == NULL)
+        {
+            pShadow = NULL;
+        }
+        else if (pShadow->fPending || pShadow->fRxHold)
+        {   // the previous change has not been switched yet
+            *pAbortCode_p = SDO_AC_DATA_NOT_TRANSF_DUE_DEVICE_STATE;
+            ret = kErrorPdoConfWhileEnabled;
+            goto Exit;
+        }
+    }
+#endif
+
+    // the mapping may be written before the channel tables are allocated
+    if (pdouInstance_g.fAllocated)
+        maxObjectCount = fTxPdo ? pdouInstance_g.txChannelObjectCount : pdouInstance_g.rxChannelObjectCount;
+    else
+        maxObjectCount = fTxPdo ? D_PDO_TPDOChannelObjects_U8 : D_PDO_RPDOChannelObjects_U8;
+
+    if (mappObjectCount_p > maxObjectCount)
     {
         DEBUG_LVL_ERROR_TRACE("%s() %d exceeds object!\n",
                               __func__, mappObjectCount_p);
@@ -1019,8 +2171,19 @@ static tOplkError checkAndConfigurePdo(UINT16 mappParamIndex_p,
         pdoChannelConf.pdoChannel.nodeId = PDO_INVALID_NODE_ID;
         pdoChannelConf.pdoChannel.mappObjectCount = 0;
         pdoChannelConf.pdoChannel.pdoSize = 0;
-        pdouInstance_g.fRunning = FALSE;
-        ret = configurePdoChannel(&pdoChannelConf);
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+        if (pShadow != NULL)
+        {
+            ret = stageShadowMapping(pShadow, &pdoChannelConf, pAbortCode_p);
+            if (ret != kErrorOk)
+                goto Exit;
+        }
+        else
+#endif
+        {
+            pdouInstance_g.fRunning = FALSE;
+            ret = configurePdoChannel(&pdoChannelConf);
+        }
 
         if ((pdouInstance_g.fAllocated) && (pdouInstance_g.pfnCbEventPdoChange != NULL))
         {
@@ -1059,10 +2222,14 @@ static tOplkError checkAndConfigurePdo(UINT16 mappParamIndex_p,
 
     if (fTxPdo)
         pMappObject = &pdouInstance_g.paTxObject[pdoChannelConf.channelId *
-                                                 D_PDO_TPDOChannelObjects_U8];
+                                                 pdouInstance_g.txChannelObjectCount];
     else
         pMappObject = &pdouInstance_g.paRxObject[pdoChannelConf.channelId *
-                                                 D_PDO_RPDOChannelObjects_U8];
+                                                 pdouInstance_g.rxChannelObjectCount];
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+    if (pShadow != NULL)
+        pMappObject = pShadow->paObject;
+#endif
 
     ret = setupMappingObjects(pMappObject, mappParamIndex_p, mappObjectCount_p,
                               maxPdoSize, pAbortCode_p, &calcPdoSize, &count);
@@ -1073,12 +2240,23 @@ static tOplkError checkAndConfigurePdo(UINT16 mappParamIndex_p,
     pdoChannelConf.pdoChannel.pdoSize = calcPdoSize;
     pdoChannelConf.pdoChannel.mappObjectCount = count;
 
-    // do not make the call before Alloc has been called
-    ret = configurePdoChannel(&pdoChannelConf);
-    if (ret != kErrorOk)
-    {   // fatal error occurred
-        *pAbortCode_p = SDO_AC_GENERAL_ERROR;
-        goto Exit;
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+    if (pShadow != NULL)
+    {
+        ret = stageShadowMapping(pShadow, &pdoChannelConf, pAbortCode_p);
+        if (ret != kErrorOk)
+            goto Exit;
+    }
+    else
+#endif
+    {
+        // do not make the call before Alloc has been called
+        ret = configurePdoChannel(&pdoChannelConf);
+        if (ret != kErrorOk)
+        {   // fatal error occurred
+            *pAbortCode_p = SDO_AC_GENERAL_ERROR;
+            goto Exit;
+        }
     }
 
     if ((pdouInstance_g.fAllocated) && (pdouInstance_g.pfnCbEventPdoChange != NULL))
@@ -1097,7 +2275,8 @@ Exit:
 /**
 \brief  Configure the specified PDO channel
 
-The function configures the specified PDO channel.
+The function configures the specified PDO channel. The mapping objects of
+the channel are compiled into a copy program which is executed on every cycle.
 
 \param  pChannelConf_p              PDO channel configuration
 
@@ -1108,17 +2287,36 @@ static tOplkError configurePdoChannel(tPdoChannelConf* pChannelConf_p)
 {
     tOplkError          ret = kErrorOk;
     tPdoChannel*        pDestPdoChannel;
+    UINT                channelId;
 
     if (pdouInstance_g.fAllocated != FALSE)
     {
+        channelId = pChannelConf_p->channelId;
         if (pChannelConf_p->fTx)
-            pDestPdoChannel = &pdouInstance_g.pdoChannels.pTxPdoChannel[pChannelConf_p->channelId];
+        {
+            pDestPdoChannel = &pdouInstance_g.pdoChannels.pTxPdoChannel[channelId];
+            compileCopyProgram(&pdouInstance_g.paTxObject[channelId * pdouInstance_g.txChannelObjectCount],
+                               pChannelConf_p->pdoChannel.mappObjectCount,
+                               &pdouInstance_g.paTxCopyOp[channelId * pdouInstance_g.txChannelObjectCount],
+                               &pdouInstance_g.paTxCopyOpCount[channelId]);
+            setupTxChannelDirty(channelId);
+        }
         else
-            pDestPdoChannel = &pdouInstance_g.pdoChannels.pRxPdoChannel[pChannelConf_p->channelId];
+        {
+            pDestPdoChannel = &pdouInstance_g.pdoChannels.pRxPdoChannel[channelId];
+            compileCopyProgram(&pdouInstance_g.paRxObject[channelId * pdouInstance_g.rxChannelObjectCount],
+                               pChannelConf_p->pdoChannel.mappObjectCount,
+                               &pdouInstance_g.paRxCopyOp[channelId * pdouInstance_g.rxChannelObjectCount],
+                               &pdouInstance_g.paRxCopyOpCount[channelId]);
+        }
 
         // Setup user channel configuration
         OPLK_MEMCPY(pDestPdoChannel, &pChannelConf_p->pdoChannel, sizeof(tPdoChannel));
 
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+        setupStaticCopy(pChannelConf_p->fTx, channelId);
+#endif
+
         // TRACE("postConfigureChannel: TX:%d channel:%d size:%d\n",
         //       pChannelConf_p->fTx, pChannelConf_p->channelId, pChannelConf_p->pdoChannel.pdoSize);
         ret = pdoucal_postConfigureChannel(pChannelConf_p);
@@ -1328,8 +2526,7 @@ static tOplkError checkAndSetObjectMapping(QWORD objectMapping_p,
     UINT                bitOffset;
     UINT                bitSize;
     UINT                byteSize;
-    tObdAccess          accessType;
-    BOOL                fNumerical;
+    tObdEntryInfo       entryInfo;
     tObdType            obdType;
     void*               pVar;
 
@@ -1349,13 +2546,14 @@ static tOplkError checkAndSetObjectMapping(QWORD objectMapping_p,
         goto Exit;
     }
 
-    ret = obd_getType(index, subIndex, &obdType);
+    ret = obd_getEntryInfo(index, subIndex, &entryInfo);
     if (ret != kErrorOk)
     {   // entry doesn't exist
         *pAbortCode_p = SDO_AC_OBJECT_NOT_EXIST;
         ret = kErrorPdoVarNotFound;
         goto Exit;
     }
+    obdType = entryInfo.type;
 
     if (((bitSize & 0x7) != 0x0) &&
         ((bitSize != 1) || (obdType != kObdTypeBool)))
@@ -1366,22 +2564,14 @@ static tOplkError checkAndSetObjectMapping(QWORD objectMapping_p,
     }
 
     // check access type
-    ret = obd_getAccessType(index, subIndex, &accessType);
-    if (ret != kErrorOk)
-    {   // entry doesn't exist
-        *pAbortCode_p = SDO_AC_OBJECT_NOT_EXIST;
-        ret = kErrorPdoVarNotFound;
-        goto Exit;
-    }
-
-    if ((accessType & kObdAccPdo) == 0)
+    if ((entryInfo.access & kObdAccPdo) == 0)
     {   // object is not mappable
         *pAbortCode_p = SDO_AC_OBJECT_NOT_MAPPABLE;
         ret = kErrorPdoVarNotMappable;
         goto Exit;
     }
 
-    if ((accessType & neededAccessType_p) == 0)
+    if ((entryInfo.access & neededAccessType_p) == 0)
     {   // object is not writeable (RPDO) or readable (TPDO) respectively
         *pAbortCode_p = SDO_AC_OBJECT_NOT_MAPPABLE;
         ret = kErrorPdoVarNotMappable;
@@ -1397,7 +2587,7 @@ static tOplkError checkAndSetObjectMapping(QWORD objectMapping_p,
         byteSize = (bitSize >> 3);
     }
 
-    obdSize = obd_getDataSize(index, subIndex);
+    obdSize = entryInfo.dataSize;
     if (obdSize < byteSize)
     {   // object does not exist or has smaller size
         *pAbortCode_p = SDO_AC_GENERAL_ERROR;
@@ -1405,14 +2595,7 @@ static tOplkError checkAndSetObjectMapping(QWORD objectMapping_p,
         // todo really don't want to exit here?
     }
 
-    ret = obd_isNumerical(index, subIndex, &fNumerical);
-    if (ret != kErrorOk)
-    {   // entry doesn't exist
-        *pAbortCode_p = SDO_AC_OBJECT_NOT_EXIST;
-        goto Exit;
-    }
-
-    if ((fNumerical != FALSE) && (byteSize != obdSize))
+    if ((entryInfo.fNumerical != FALSE) && (byteSize != obdSize))
     {
         // object is numerical,
         // therefore size has to fit, but it does not.
@@ -1421,7 +2604,7 @@ static tOplkError checkAndSetObjectMapping(QWORD objectMapping_p,
         goto Exit;
     }
 
-    pVar = obd_getObjectDataPtr(index, subIndex);
+    pVar = entryInfo.pData;
     if (pVar == NULL)
     {   // entry doesn't exist
         *pAbortCode_p = SDO_AC_OBJECT_NOT_EXIST;
@@ -1556,75 +2739,290 @@ static void decodeObjectMapping(QWORD objectMapping_p, UINT* pIndex_p,
 
 //------------------------------------------------------------------------------
 /**
-\brief  Copy variable to PDO
-
-This function copies a variable specified by the mapping object to the PDO
-payload.
+\brief  Compile PDO copy program
 
-\param  pPayload_p          Pointer to PDO payload in destination frame.
-\param  pMappObject_p       Pointer to mapping object.
+The function compiles the mapping objects of a PDO channel into a copy program.
+Objects with the same element size are merged into a single block if they are
+adjacent in the PDO payload as well as in memory. Objects which can't be
+handled as a block result in a copy operation which converts the object with
+the AMI functions.
 
-\return The function returns a tOplkError error code.
-**/
+\param  pMappObject_p           Pointer to first mapping object of the channel.
+\param  mappObjectCount_p       Number of mapping objects.
+\param  pCopyOp_p               Pointer to store the copy operations.
+\param  pCopyOpCount_p          Pointer to store the number of copy operations.
+*/
 //------------------------------------------------------------------------------
-static tOplkError copyVarToPdo(BYTE* pPayload_p, tPdoMappObject* pMappObject_p)
+static void compileCopyProgram(tPdoMappObject* pMappObject_p, UINT mappObjectCount_p,
+                               tPdoCopyOp* pCopyOp_p, UINT* pCopyOpCount_p)
 {
-    tOplkError      ret = kErrorOk;
-    UINT            byteOffset;
-    void*           pVar;
+    UINT                copyOpCount = 0;
+    tPdoCopyOp*         pPrevCopyOp = NULL;
+    UINT                byteOffset;
+    UINT                byteSize;
+    UINT                elementSize;
+    BYTE*               pVar;
 
-    byteOffset = PDO_MAPPOBJECT_GET_BITOFFSET(pMappObject_p) >> 3;
-    pPayload_p += byteOffset;
-    pVar = PDO_MAPPOBJECT_GET_VAR(pMappObject_p);
+    for (; mappObjectCount_p > 0; mappObjectCount_p--, pMappObject_p++)
+    {
+        byteOffset = PDO_MAPPOBJECT_GET_BITOFFSET(pMappObject_p) >> 3;
+        pVar = (BYTE*)PDO_MAPPOBJECT_GET_VAR(pMappObject_p);
+        elementSize = getCopyElementSize(pMappObject_p);
+
+        if (elementSize == 0)
+        {   // object needs an individual conversion
+            pCopyOp_p->pVar = pVar;
+            pCopyOp_p->byteOffset = (UINT16)byteOffset;
+            pCopyOp_p->byteSize = 0;
+            pCopyOp_p->elementSize = 0;
+            pCopyOp_p->pMappObject = pMappObject_p;
+            pPrevCopyOp = NULL;
+            pCopyOp_p++;
+            copyOpCount++;
+            continue;
+        }
+
+        if (PDO_MAPPOBJECT_IS_NUMERIC(pMappObject_p))
+        {
+            switch (PDO_MAPPOBJECT_GET_TYPE(pMappObject_p))
+            {
+                case kObdTypeInt16:
+                case kObdTypeUInt16:
+                    byteSize = 2;
+                    break;
+
+                case kObdTypeInt32:
+                case kObdTypeUInt32:
+                case kObdTypeReal32:
+                    byteSize = 4;
+                    break;
+
+                case kObdTypeInt64:
+                case kObdTypeUInt64:
+                case kObdTypeReal64:
+                    byteSize = 8;
+                    break;
+
+                default:
+                    byteSize = 1;
+                    break;
+            }
+        }
+        else
+        {
+            byteSize = PDO_MAPPOBJECT_GET_BYTESIZE(pMappObject_p);
+        }
+
+        if ((pPrevCopyOp != NULL) &&
+            (pPrevCopyOp->elementSize == elementSize) &&
+            ((UINT)(pPrevCopyOp->byteOffset + pPrevCopyOp->byteSize) == byteOffset) &&
+            (((BYTE*)pPrevCopyOp->pVar + pPrevCopyOp->byteSize) == pVar) &&
+            ((pPrevCopyOp->byteSize + byteSize) <= 0xFFFF))
+        {   // object directly follows the previous block, extend it
+            pPrevCopyOp->byteSize += (UINT16)byteSize;
+            continue;
+        }
+
+        pCopyOp_p->pVar = pVar;
+        pCopyOp_p->byteOffset = (UINT16)byteOffset;
+        pCopyOp_p->byteSize = (UINT16)byteSize;
+        pCopyOp_p->elementSize = (UINT8)elementSize;
+        pCopyOp_p->pMappObject = NULL;
+        pPrevCopyOp = pCopyOp_p;
+        pCopyOp_p++;
+        copyOpCount++;
+    }
+
+    *pCopyOpCount_p = copyOpCount;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get element size of mapping object for block copy
+
+The function determines how a mapping object can be transferred within a
+block. Strings and domains are always copied bytewise. On little endian
+targets, this is also true for numerical objects which are stored in a variable
+of the same size as in the PDO. On big endian targets, these objects are
+converted with the bulk AMI functions of the respective width.
+
+\param  pMappObject_p           Pointer to mapping object.
+
+\return The function returns the element size in bytes or 0 if the object
+        needs an individual conversion.
+*/
+//------------------------------------------------------------------------------
+static UINT getCopyElementSize(tPdoMappObject* pMappObject_p)
+{
+    if (!PDO_MAPPOBJECT_IS_NUMERIC(pMappObject_p))
+        return 1;
 
     switch (PDO_MAPPOBJECT_GET_TYPE(pMappObject_p))
     {
-        //-----------------------------------------------
-        // types without ami
-        case kObdTypeVString:
-        case kObdTypeOString:
-        case kObdTypeDomain:
-        default:
-            // read value from object
-            OPLK_MEMCPY(pPayload_p, pVar, PDO_MAPPOBJECT_GET_BYTESIZE(pMappObject_p));
-            break;
-
-        //-----------------------------------------------
-        // numerical type which needs ami-write
-        // 8 bit or smaller values
         case kObdTypeBool:
         case kObdTypeInt8:
         case kObdTypeUInt8:
-            ami_setUint8Le(pPayload_p, *((BYTE*)pVar));
-            break;
+            return 1;
 
-        // 16 bit values
         case kObdTypeInt16:
         case kObdTypeUInt16:
-            ami_setUint16Le(pPayload_p, *((WORD*)pVar));
-            break;
-
-        // 24 bit values
-        case kObdTypeInt24:
-        case kObdTypeUInt24:
-            ami_setUint24Le(pPayload_p, *((DWORD*)pVar));
-            break;
+            return CHECK_IF_BIG_ENDIAN() ? 2 : 1;
 
-        // 32 bit values
         case kObdTypeInt32:
         case kObdTypeUInt32:
         case kObdTypeReal32:
-            ami_setUint32Le(pPayload_p, *((DWORD*)pVar));
-            break;
+            return CHECK_IF_BIG_ENDIAN() ? 4 : 1;
 
-        // 40 bit values
-        case kObdTypeInt40:
-        case kObdTypeUInt40:
-            ami_setUint40Le(pPayload_p, *((QWORD*)pVar));
-            break;
+        case kObdTypeInt64:
+        case kObdTypeUInt64:
+        case kObdTypeReal64:
+            return CHECK_IF_BIG_ENDIAN() ? 8 : 1;
 
-        // 48 bit values
-        case kObdTypeInt48:
+        default:
+            // 24/40/48/56 bit values and time values always need conversion
+            return 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy block to PDO
+
+This function transfers a block of a copy program into the PDO payload.
+
+\param  pPayload_p          Pointer to PDO payload in destination frame.
+\param  pCopyOp_p           Pointer to copy operation.
+*/
+//------------------------------------------------------------------------------
+static void copyBlockToPdo(BYTE* pPayload_p, tPdoCopyOp* pCopyOp_p)
+{
+    pPayload_p += pCopyOp_p->byteOffset;
+
+    switch (pCopyOp_p->elementSize)
+    {
+        case 2:
+            ami_setUint16ArrayLe(pPayload_p, (UINT16*)pCopyOp_p->pVar, pCopyOp_p->byteSize >> 1);
+            break;
+
+        case 4:
+            ami_setUint32ArrayLe(pPayload_p, (UINT32*)pCopyOp_p->pVar, pCopyOp_p->byteSize >> 2);
+            break;
+
+        case 8:
+            ami_setUint64ArrayLe(pPayload_p, (UINT64*)pCopyOp_p->pVar, pCopyOp_p->byteSize >> 3);
+            break;
+
+        default:
+            OPLK_MEMCPY(pPayload_p, pCopyOp_p->pVar, pCopyOp_p->byteSize);
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy block from PDO
+
+This function transfers a block of a copy program from the PDO payload.
+
+\param  pPayload_p          Pointer to PDO payload in source frame.
+\param  pCopyOp_p           Pointer to copy operation.
+*/
+//------------------------------------------------------------------------------
+static void copyBlockFromPdo(BYTE* pPayload_p, tPdoCopyOp* pCopyOp_p)
+{
+    pPayload_p += pCopyOp_p->byteOffset;
+
+    switch (pCopyOp_p->elementSize)
+    {
+        case 2:
+            ami_getUint16ArrayLe(pPayload_p, (UINT16*)pCopyOp_p->pVar, pCopyOp_p->byteSize >> 1);
+            break;
+
+        case 4:
+            ami_getUint32ArrayLe(pPayload_p, (UINT32*)pCopyOp_p->pVar, pCopyOp_p->byteSize >> 2);
+            break;
+
+        case 8:
+            ami_getUint64ArrayLe(pPayload_p, (UINT64*)pCopyOp_p->pVar, pCopyOp_p->byteSize >> 3);
+            break;
+
+        default:
+            OPLK_MEMCPY(pCopyOp_p->pVar, pPayload_p, pCopyOp_p->byteSize);
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy variable to PDO
+
+This function copies a variable specified by the mapping object to the PDO
+payload.
+
+\param  pPayload_p          Pointer to PDO payload in destination frame.
+\param  pMappObject_p       Pointer to mapping object.
+
+\return The function returns a tOplkError error code.
+**/
+//------------------------------------------------------------------------------
+static tOplkError copyVarToPdo(BYTE* pPayload_p, tPdoMappObject* pMappObject_p)
+{
+    tOplkError      ret = kErrorOk;
+    UINT            byteOffset;
+    void*           pVar;
+
+    byteOffset = PDO_MAPPOBJECT_GET_BITOFFSET(pMappObject_p) >> 3;
+    pPayload_p += byteOffset;
+    pVar = PDO_MAPPOBJECT_GET_VAR(pMappObject_p);
+
+    switch (PDO_MAPPOBJECT_GET_TYPE(pMappObject_p))
+    {
+        //-----------------------------------------------
+        // types without ami
+        case kObdTypeVString:
+        case kObdTypeOString:
+        case kObdTypeDomain:
+        default:
+            // read value from object
+            OPLK_MEMCPY(pPayload_p, pVar, PDO_MAPPOBJECT_GET_BYTESIZE(pMappObject_p));
+            break;
+
+        //-----------------------------------------------
+        // numerical type which needs ami-write
+        // 8 bit or smaller values
+        case kObdTypeBool:
+        case kObdTypeInt8:
+        case kObdTypeUInt8:
+            ami_setUint8Le(pPayload_p, *((BYTE*)pVar));
+            break;
+
+        // 16 bit values
+        case kObdTypeInt16:
+        case kObdTypeUInt16:
+            ami_setUint16Le(pPayload_p, *((WORD*)pVar));
+            break;
+
+        // 24 bit values
+        case kObdTypeInt24:
+        case kObdTypeUInt24:
+            ami_setUint24Le(pPayload_p, *((DWORD*)pVar));
+            break;
+
+        // 32 bit values
+        case kObdTypeInt32:
+        case kObdTypeUInt32:
+        case kObdTypeReal32:
+            ami_setUint32Le(pPayload_p, *((DWORD*)pVar));
+            break;
+
+        // 40 bit values
+        case kObdTypeInt40:
+        case kObdTypeUInt40:
+            ami_setUint40Le(pPayload_p, *((QWORD*)pVar));
+            break;
+
+        // 48 bit values
+        case kObdTypeInt48:
         case kObdTypeUInt48:
             ami_setUint48Le(pPayload_p, *((QWORD*)pVar));
             break;
@@ -1751,47 +3149,992 @@ static tOplkError copyVarFromPdo(BYTE* pPayload_p, tPdoMappObject* pMappObject_p
 
 //------------------------------------------------------------------------------
 /**
-\brief  Calculate PDO memory size
+\brief  Track the sequence number of an RXPDO channel
 
-The function calculates the size needed for the PDO memory.
+The function compares the sequence number of the current RXPDO of a channel
+with the last one. If the channel got fresh data, the node is marked in the
+update bitmap.
 
-\param  pPdoChannels_p      Pointer to PDO channel setup.
-\param  pRxPdoMemSize_p     Pointer to store size of RX PDO buffers.
-\param  pTxPdoMemSize_p     Pointer to store size of TX PDO buffers.
+\param  channelId_p         Channel ID of the RXPDO.
+\param  nodeId_p            Node ID of the RXPDO.
+\param  pUpdatedNodes_p     Update bitmap in which the node is marked.
+*/
+//------------------------------------------------------------------------------
+static void trackRxSequence(UINT channelId_p, UINT nodeId_p, UINT8* pUpdatedNodes_p)
+{
+    UINT32      sequence;
 
-\return The function returns the size of the used PDO memory
+    sequence = pdoucal_getRxPdoSequence(channelId_p);
+    if (sequence != pdouInstance_g.paRxSequence[channelId_p])
+    {
+        pdouInstance_g.paRxSequence[channelId_p] = sequence;
+        pUpdatedNodes_p[nodeId_p >> 3] |= (UINT8)(1 << (nodeId_p & 7));
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy an RXPDO channel to the process image
+
+\param  channelId_p         ID of the RXPDO channel.
+\param  pUpdatedNodes_p     Update bitmap in which the node of the channel is
+                            marked if it received fresh data. NULL if the
+                            channel is copied by a partial exchange, then the
+                            received sequence and the update bitmap are left
+                            to the next full exchange.
+
+\return The function returns a tOplkError error code.
 */
 //------------------------------------------------------------------------------
-static UINT calcPdoMemSize(tPdoChannelSetup* pPdoChannels_p, size_t* pRxPdoMemSize_p,
-                           size_t* pTxPdoMemSize_p)
+static tOplkError copyRxChannelToPi(UINT channelId_p, UINT8* pUpdatedNodes_p)
 {
-    UINT                channelId;
-    size_t              rxSize;
-    size_t              txSize;
-    tPdoChannel*        pPdoChannel;
+    tOplkError          ret;
+    tPdoChannel*        pPdoChannel = &pdouInstance_g.pdoChannels.pRxPdoChannel[channelId_p];
+    UINT                copyOpCount;
+    tPdoCopyOp*         pCopyOp;
+    BYTE*               pPdo;
 
-    rxSize = 0;
-    for (channelId = 0, pPdoChannel = pPdoChannels_p->pRxPdoChannel;
-         channelId < pPdoChannels_p->allocation.rxPdoChannelCount;
-         channelId++, pPdoChannel++)
+    ret = pdoucal_getRxPdo(&pPdo, channelId_p, pPdoChannel->pdoSize);
+    if (pUpdatedNodes_p != NULL)
+        trackRxSequence(channelId_p, pPdoChannel->nodeId, pUpdatedNodes_p);
+
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+    if (pdouInstance_g.rxShadow.fRxHold &&
+        (pdouInstance_g.rxShadow.channelConf.channelId == channelId_p))
+    {   // the buffer may still contain a PDO of the old mapping
+        if (pUpdatedNodes_p == NULL)
+            return kErrorOk;    // the hold is released by the next full exchange
+        if (pdouInstance_g.rxShadow.fPending ||
+            (pdouInstance_g.paRxSequence[channelId_p] == pdouInstance_g.rxShadow.rxHoldSequence))
+            return kErrorOk;
+        pdouInstance_g.rxShadow.fRxHold = FALSE;
+    }
+#endif
+
+    //TRACE("%s() Channel:%d Node:%d pPdo:%p\n", __func__, channelId_p, pPdoChannel->nodeId, pPdo);
+
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+    if (pdouInstance_g.papfnRxStaticCopy[channelId_p] != NULL)
     {
-        rxSize += pPdoChannel->pdoSize;
+        pdouInstance_g.papfnRxStaticCopy[channelId_p](pPdo, pdouInstance_g.pRxPi);
+        return kErrorOk;
     }
-    if (pRxPdoMemSize_p != NULL)
-        *pRxPdoMemSize_p = rxSize;
+#endif
 
-    txSize = 0;
-    for (channelId = 0, pPdoChannel = pPdoChannels_p->pTxPdoChannel;
-         channelId < pPdoChannels_p->allocation.txPdoChannelCount;
-         channelId++, pPdoChannel++)
+    for (copyOpCount = pdouInstance_g.paRxCopyOpCount[channelId_p],
+         pCopyOp = pdouInstance_g.paRxCopyOp + (channelId_p * pdouInstance_g.rxChannelObjectCount);
+         copyOpCount > 0;
+         copyOpCount--, pCopyOp++)
+    {
+        if (pCopyOp->pMappObject == NULL)
+        {
+            copyBlockFromPdo(pPdo, pCopyOp);
+            continue;
+        }
+
+        ret = copyVarFromPdo(pPdo, pCopyOp->pMappObject);
+        if (ret != kErrorOk)
+            return ret;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy a TXPDO channel from the process image
+
+The function copies the TXPDO channel from the process image and passes it to
+the kernel layer. With write tracking, a channel whose variables were not
+written is skipped.
+
+\param  channelId_p         ID of the TXPDO channel.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError copyTxChannelFromPi(UINT channelId_p)
+{
+    tOplkError          ret;
+    tPdoChannel*        pPdoChannel = &pdouInstance_g.pdoChannels.pTxPdoChannel[channelId_p];
+    UINT                copyOpCount;
+    tPdoCopyOp*         pCopyOp;
+    BYTE*               pPdo;
+
+    if (pdouInstance_g.fTxDirtyTracking)
     {
-        txSize += pPdoChannel->pdoSize;
+        if (!pdouInstance_g.paTxDirty[channelId_p].fDirty)
+        {   // the last PDO is still valid
+            return kErrorOk;
+        }
+        pdouInstance_g.paTxDirty[channelId_p].fDirty = FALSE;
     }
-    if (pTxPdoMemSize_p != NULL)
-        *pTxPdoMemSize_p = txSize;
 
-    return rxSize + txSize;
+    pPdo = pdoucal_getTxPdoAdrs(channelId_p);
+    //TRACE ("%s() pPdo: %p\n", __func__, pPdo);
+
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+    if (pdouInstance_g.papfnTxStaticCopy[channelId_p] != NULL)
+    {
+        pdouInstance_g.papfnTxStaticCopy[channelId_p](pPdo, pdouInstance_g.pTxPi);
+        return pdoucal_setTxPdo(channelId_p, pPdo, pPdoChannel->pdoSize);
+    }
+#endif
+
+    for (copyOpCount = pdouInstance_g.paTxCopyOpCount[channelId_p],
+         pCopyOp = pdouInstance_g.paTxCopyOp + (channelId_p * pdouInstance_g.txChannelObjectCount);
+         copyOpCount > 0;
+         copyOpCount--, pCopyOp++)
+    {
+        if (pCopyOp->pMappObject == NULL)
+        {
+            copyBlockToPdo(pPdo, pCopyOp);
+            continue;
+        }
+
+        ret = copyVarToPdo(pPdo, pCopyOp->pMappObject);
+        if (ret != kErrorOk)
+            return ret;
+    }
+
+    // send PDO data to kernel layer
+    return pdoucal_setTxPdo(channelId_p, pPdo, pPdoChannel->pdoSize);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check if a node is selected in a node bitmap
+
+\param  pNodeBitmap_p       Pointer to the bitmap of the selected nodes.
+\param  bitmapSize_p        Size of the bitmap in bytes.
+\param  nodeId_p            Node ID of the PDO channel.
+
+\return The function returns TRUE if the node is selected.
+*/
+//------------------------------------------------------------------------------
+static BOOL isNodeSelected(const UINT8* pNodeBitmap_p, UINT bitmapSize_p, UINT nodeId_p)
+{
+    if ((nodeId_p == PDO_INVALID_NODE_ID) || ((nodeId_p >> 3) >= bitmapSize_p))
+        return FALSE;
+
+    return ((pNodeBitmap_p[nodeId_p >> 3] & (1 << (nodeId_p & 7))) != 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set up write tracking of a TXPDO channel
+
+The function determines the memory range of the variables which are mapped to
+a TXPDO channel and marks the channel as dirty. Objects which are converted
+individually are accounted with the size of the largest numerical type.
+
+\param  channelId_p         ID of the TXPDO channel.
+*/
+//------------------------------------------------------------------------------
+static void setupTxChannelDirty(UINT channelId_p)
+{
+    tPdoTxChannelDirty* pTxDirty = &pdouInstance_g.paTxDirty[channelId_p];
+    tPdoCopyOp*         pCopyOp;
+    UINT                copyOpCount;
+    BYTE*               pVar;
+    UINT                varSize;
+
+    pTxDirty->pVarStart = NULL;
+    pTxDirty->pVarEnd = NULL;
+    pTxDirty->fDirty = TRUE;
+
+    for (copyOpCount = pdouInstance_g.paTxCopyOpCount[channelId_p],
+         pCopyOp = pdouInstance_g.paTxCopyOp + (channelId_p * pdouInstance_g.txChannelObjectCount);
+         copyOpCount > 0;
+         copyOpCount--, pCopyOp++)
+    {
+        pVar = (BYTE*)pCopyOp->pVar;
+        varSize = (pCopyOp->pMappObject == NULL) ? pCopyOp->byteSize : sizeof(UINT64);
+
+        if ((pTxDirty->pVarStart == NULL) || (pVar < pTxDirty->pVarStart))
+            pTxDirty->pVarStart = pVar;
+        if ((pVar + varSize) > pTxDirty->pVarEnd)
+            pTxDirty->pVarEnd = pVar + varSize;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set up zero-copy mode
+
+The function checks whether the configured PDO channels can be used as process
+images and activates the zero-copy mode for each direction accordingly.
+*/
+//------------------------------------------------------------------------------
+static void setupZeroCopy(void)
+{
+    tPdoZeroCopy*       pZeroCopy;
+
+    pZeroCopy = &pdouInstance_g.zeroCopyRx;
+    pZeroCopy->fActive = checkZeroCopyChannel(pZeroCopy, pdouInstance_g.pdoChannels.pRxPdoChannel,
+                                              pdouInstance_g.pdoChannels.allocation.rxPdoChannelCount,
+                                              pdouInstance_g.paRxCopyOp,
+                                              pdouInstance_g.paRxCopyOpCount,
+                                              pdouInstance_g.rxChannelObjectCount);
+    if (pZeroCopy->fActive)
+    {
+        pdoucal_getRxPdo(&pZeroCopy->pPdo, pZeroCopy->channelId,
+                         pdouInstance_g.pdoChannels.pRxPdoChannel[pZeroCopy->channelId].pdoSize);
+    }
+
+    pZeroCopy = &pdouInstance_g.zeroCopyTx;
+    pZeroCopy->fActive = checkZeroCopyChannel(pZeroCopy, pdouInstance_g.pdoChannels.pTxPdoChannel,
+                                              pdouInstance_g.pdoChannels.allocation.txPdoChannelCount,
+                                              pdouInstance_g.paTxCopyOp,
+                                              pdouInstance_g.paTxCopyOpCount,
+                                              pdouInstance_g.txChannelObjectCount);
+    if (pZeroCopy->fActive)
+        pZeroCopy->pPdo = pdoucal_getTxPdoAdrs(pZeroCopy->channelId);
+
+    DEBUG_LVL_PDO_TRACE("%s() Zero-copy RX:%d TX:%d\n", __func__,
+                        pdouInstance_g.zeroCopyRx.fActive, pdouInstance_g.zeroCopyTx.fActive);
+}
+
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Set up kernel process images
+
+The function converts the copy programs of the configured PDO channels into
+copy operations of the kernel layer and activates the kernel process images if
+this is possible. The kernel layer is informed if they are disabled.
+*/
+//------------------------------------------------------------------------------
+static void setupKernelPi(void)
+{
+    tPdouKernelPi*      pKernelPi = &pdouInstance_g.kernelPi;
+    tPdoKernelPiSetup   setup;
+    UINT                copyCount = 0;
+    BOOL                fWasActive;
+
+    fWasActive = pKernelPi->fActive;
+    pKernelPi->fActive = FALSE;
+    OPLK_MEMSET(&setup, 0, sizeof(setup));
+
+    // the RXPDO operations are passed first, both sorted by the channel ID
+    if ((pKernelPi->pRxPi != NULL) &&
+        addKernelPiCopy(FALSE, &copyCount) && addKernelPiCopy(TRUE, &copyCount) &&
+        (copyCount != 0) &&
+        (pdoucal_writeKernelPiCopy(pKernelPi->aCopy, copyCount) == kErrorOk))
+    {
+        setup.rxPiSize = pKernelPi->rxPiSize;
+        setup.txPiSize = pKernelPi->txPiSize;
+        setup.copyCount = copyCount;
+    }
+
+    if ((setup.copyCount == 0) && !fWasActive)
+        return;
+
+    if ((pdoucal_postSetupKernelPi(&setup) == kErrorOk) && (setup.copyCount != 0))
+    {
+        pKernelPi->pRxImage = pdoucal_getKernelPiOut();
+        pKernelPi->pTxImage = pdoucal_getKernelPiIn();
+        pKernelPi->fActive = ((pKernelPi->pRxImage != NULL) && (pKernelPi->pTxImage != NULL));
+    }
+
+    DEBUG_LVL_PDO_TRACE("%s() Kernel process images:%d (%u copy operations)\n", __func__,
+                        pKernelPi->fActive, copyCount);
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Add kernel process image copy operations of one direction
+
+The function appends the copy programs of all configured channels of one
+direction to the copy operations of the kernel layer. This is only possible
+if every copy operation is a plain block copy within the process image.
+
+\param  fTx_p               TRUE for TXPDOs and FALSE for RXPDOs.
+\param  pCopyCount_p        Pointer to the number of copy operations, which is
+                            incremented by the added operations.
+
+\return The function returns TRUE if all operations could be added.
+*/
+//------------------------------------------------------------------------------
+static BOOL addKernelPiCopy(BOOL fTx_p, UINT* pCopyCount_p)
+{
+    tPdouKernelPi*      pKernelPi = &pdouInstance_g.kernelPi;
+    tPdoKernelPiCopy*   pKernelPiCopy;
+    tPdoChannel*        pPdoChannel;
+    tPdoCopyOp*         pCopyOp;
+    UINT*               paCopyOpCount;
+    UINT                channelCount;
+    UINT                channelObjects;
+    UINT                channelId;
+    UINT                copyOpCount;
+    BYTE*               pPi;
+    UINT                piSize;
+    UINT                piOffset;
+
+    if (fTx_p)
+    {
+        pPdoChannel = pdouInstance_g.pdoChannels.pTxPdoChannel;
+        channelCount = pdouInstance_g.pdoChannels.allocation.txPdoChannelCount;
+        channelObjects = pdouInstance_g.txChannelObjectCount;
+        pCopyOp = pdouInstance_g.paTxCopyOp;
+        paCopyOpCount = pdouInstance_g.paTxCopyOpCount;
+        pPi = pKernelPi->pTxPi;
+        piSize = pKernelPi->txPiSize;
+    }
+    else
+    {
+        pPdoChannel = pdouInstance_g.pdoChannels.pRxPdoChannel;
+        channelCount = pdouInstance_g.pdoChannels.allocation.rxPdoChannelCount;
+        channelObjects = pdouInstance_g.rxChannelObjectCount;
+        pCopyOp = pdouInstance_g.paRxCopyOp;
+        paCopyOpCount = pdouInstance_g.paRxCopyOpCount;
+        pPi = pKernelPi->pRxPi;
+        piSize = pKernelPi->rxPiSize;
+    }
+
+    if ((pPdoChannel == NULL) && (channelCount != 0))
+        return FALSE;
+
+    for (channelId = 0; channelId < channelCount; channelId++, pCopyOp += channelObjects)
+    {
+        if (pPdoChannel[channelId].nodeId == PDO_INVALID_NODE_ID)
+            continue;
+
+        for (copyOpCount = 0; copyOpCount < paCopyOpCount[channelId]; copyOpCount++)
+        {
+            if (pCopyOp[copyOpCount].byteSize == 0)
+                continue;
+
+            if ((pCopyOp[copyOpCount].pMappObject != NULL) ||
+                (pCopyOp[copyOpCount].elementSize != 1) ||
+                ((BYTE*)pCopyOp[copyOpCount].pVar < pPi) ||
+                (((BYTE*)pCopyOp[copyOpCount].pVar + pCopyOp[copyOpCount].byteSize) > (pPi + piSize)) ||
+                (*pCopyCount_p >= CONFIG_PDO_KERNEL_PI_COPY_COUNT))
+                return FALSE;
+
+            piOffset = (UINT)((BYTE*)pCopyOp[copyOpCount].pVar - pPi);
+
+            pKernelPiCopy = &pKernelPi->aCopy[*pCopyCount_p];
+            pKernelPiCopy->piOffset = piOffset;
+            pKernelPiCopy->channelId = (UINT16)channelId;
+            pKernelPiCopy->pdoOffset = pCopyOp[copyOpCount].byteOffset;
+            pKernelPiCopy->size = pCopyOp[copyOpCount].byteSize;
+            pKernelPiCopy->fTx = (UINT16)fTx_p;
+            (*pCopyCount_p)++;
+        }
+    }
+
+    return TRUE;
+}
+#endif
+
+#if (CONFIG_PDO_PARALLEL_COPY != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Set up parallel copy
+
+The function enables the parallel copy for each direction whose configured PDO
+channels contain more than CONFIG_PDO_PARALLEL_COPY_THRESHOLD bytes. A
+direction in zero-copy mode is not copied at all.
+*/
+//------------------------------------------------------------------------------
+static void setupParallelCopy(void)
+{
+    UINT        channelId;
+    UINT        rxSize = 0;
+    UINT        txSize = 0;
+
+    for (channelId = 0;
+         channelId < pdouInstance_g.pdoChannels.allocation.rxPdoChannelCount;
+         channelId++)
+    {
+        if (pdouInstance_g.pdoChannels.pRxPdoChannel[channelId].nodeId != PDO_INVALID_NODE_ID)
+            rxSize += pdouInstance_g.pdoChannels.pRxPdoChannel[channelId].pdoSize;
+    }
+
+    for (channelId = 0;
+         channelId < pdouInstance_g.pdoChannels.allocation.txPdoChannelCount;
+         channelId++)
+    {
+        if (pdouInstance_g.pdoChannels.pTxPdoChannel[channelId].nodeId != PDO_INVALID_NODE_ID)
+            txSize += pdouInstance_g.pdoChannels.pTxPdoChannel[channelId].pdoSize;
+    }
+
+    pdouInstance_g.fParallelRx = (!pdouInstance_g.zeroCopyRx.fActive &&
+                                  (rxSize > CONFIG_PDO_PARALLEL_COPY_THRESHOLD));
+    pdouInstance_g.fParallelTx = (!pdouInstance_g.zeroCopyTx.fActive &&
+                                  (txSize > CONFIG_PDO_PARALLEL_COPY_THRESHOLD));
+
+    DEBUG_LVL_PDO_TRACE("%s() Parallel copy RX:%d (%u bytes) TX:%d (%u bytes)\n", __func__,
+                        pdouInstance_g.fParallelRx, rxSize, pdouInstance_g.fParallelTx, txSize);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy the RXPDOs to the process image in parallel
+
+Every worker marks the updated nodes in its own bitmap, the bitmaps are merged
+after all channels are copied.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError copyRxPdosParallel(void)
+{
+    tOplkError  ret;
+    UINT        workerIndex;
+    UINT        index;
+
+    OPLK_MEMSET(pdouInstance_g.aaParallelUpdatedNodes, 0, sizeof(pdouInstance_g.aaParallelUpdatedNodes));
+
+    ret = pdou_runParallelCopy(copyRxChannelParallel,
+                               pdouInstance_g.pdoChannels.allocation.rxPdoChannelCount);
+
+    for (workerIndex = 0; workerIndex < PDOU_PARALLEL_COPY_THREADS; workerIndex++)
+    {
+        for (index = 0; index < PDO_NODE_BITMAP_SIZE; index++)
+            pdouInstance_g.aRxUpdatedNodes[index] |= pdouInstance_g.aaParallelUpdatedNodes[workerIndex][index];
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy an RXPDO channel on a parallel copy worker
+
+\param  channelId_p         ID of the RXPDO channel.
+\param  workerIndex_p       Index of the worker.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError copyRxChannelParallel(UINT channelId_p, UINT workerIndex_p)
+{
+    if (pdouInstance_g.pdoChannels.pRxPdoChannel[channelId_p].nodeId == PDO_INVALID_NODE_ID)
+        return kErrorOk;
+
+    return copyRxChannelToPi(channelId_p, pdouInstance_g.aaParallelUpdatedNodes[workerIndex_p]);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy a TXPDO channel on a parallel copy worker
+
+\param  channelId_p         ID of the TXPDO channel.
+\param  workerIndex_p       Index of the worker.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError copyTxChannelParallel(UINT channelId_p, UINT workerIndex_p)
+{
+    UNUSED_PARAMETER(workerIndex_p);
+
+    if (pdouInstance_g.pdoChannels.pTxPdoChannel[channelId_p].nodeId == PDO_INVALID_NODE_ID)
+        return kErrorOk;
+
+    return copyTxChannelFromPi(channelId_p);
+}
+#endif
+
+#if (CONFIG_PDO_WARMUP_CYCLES > 0)
+//------------------------------------------------------------------------------
+/**
+\brief  Warm up the process image copy paths
+
+The function runs the copy programs of the configured PDO channels
+CONFIG_PDO_WARMUP_CYCLES times like the application would do in each cycle,
+so that code and data of the copy paths are resident and cached before the
+first cycle. The RPDO copy overwrites the input process image with the
+current content of the RPDO buffers. A direction which uses zero-copy mode is
+skipped because it has no copy path and the buffers are owned by the
+application.
+*/
+//------------------------------------------------------------------------------
+static void warmUpCopyPaths(void)
+{
+    UINT        count;
+
+    for (count = 0; count < CONFIG_PDO_WARMUP_CYCLES; count++)
+    {
+        if (!pdouInstance_g.zeroCopyTx.fActive)
+            pdou_copyTxPdoFromPi();
+
+        if (!pdouInstance_g.zeroCopyRx.fActive)
+            pdou_copyRxPdoToPi();
+    }
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check if a PDO channel can be used as process image
+
+The function checks whether exactly one PDO channel of a direction is in use
+and whether its copy program only consists of byte blocks which are located at
+the same offset in the process image as in the PDO payload. The process image
+must not be larger than the PDO.
+
+\param  pZeroCopy_p         Pointer to zero-copy information. The channel ID is
+                            stored in it.
+\param  pPdoChannel_p       Pointer to first PDO channel of the direction.
+\param  channelCount_p      Number of PDO channels of the direction.
+\param  paCopyOp_p          Pointer to the copy programs of the direction.
+\param  paCopyOpCount_p     Pointer to the number of copy operations per channel.
+\param  channelObjects_p    Maximum number of mapped objects per channel.
+
+\return The function returns TRUE if the channel can be used as process image.
+*/
+//------------------------------------------------------------------------------
+static BOOL checkZeroCopyChannel(tPdoZeroCopy* pZeroCopy_p, tPdoChannel* pPdoChannel_p,
+                                 UINT channelCount_p, tPdoCopyOp* paCopyOp_p,
+                                 UINT* paCopyOpCount_p, UINT channelObjects_p)
+{
+    UINT                channelId;
+    UINT                usedChannelCount = 0;
+    UINT                copyOpCount;
+    tPdoCopyOp*         pCopyOp;
+
+    if ((pZeroCopy_p->pPi == NULL) || (pPdoChannel_p == NULL))
+        return FALSE;
+
+    for (channelId = 0; channelId < channelCount_p; channelId++)
+    {
+        if (pPdoChannel_p[channelId].nodeId == PDO_INVALID_NODE_ID)
+            continue;
+
+        pZeroCopy_p->channelId = channelId;
+        usedChannelCount++;
+    }
+
+    if (usedChannelCount != 1)
+        return FALSE;
+
+    channelId = pZeroCopy_p->channelId;
+    if (pZeroCopy_p->piSize > pPdoChannel_p[channelId].pdoSize)
+        return FALSE;
+
+    for (copyOpCount = paCopyOpCount_p[channelId],
+         pCopyOp = paCopyOp_p + (channelId * channelObjects_p);
+         copyOpCount > 0;
+         copyOpCount--, pCopyOp++)
+    {
+        if ((pCopyOp->pMappObject != NULL) || (pCopyOp->elementSize != 1) ||
+            ((BYTE*)pCopyOp->pVar < pZeroCopy_p->pPi) ||
+            ((UINT)((BYTE*)pCopyOp->pVar - pZeroCopy_p->pPi) != pCopyOp->byteOffset))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Set up generated copy function of a PDO channel
+
+The function searches the generated copy functions for the mapping of a PDO
+channel. If no function matches, the channel is copied by its copy program.
+
+\param  fTx_p               TRUE for TXPDO and FALSE for RXPDO.
+\param  channelId_p         ID of the PDO channel.
+*/
+//------------------------------------------------------------------------------
+static void setupStaticCopy(BOOL fTx_p, UINT channelId_p)
+{
+    tPdoStaticCopyFunc*     ppfnCopy;
+    tPdoChannel*            pPdoChannel;
+    tPdoMappObject*         pMappObject;
+    BYTE*                   pPi;
+    UINT                    piSize;
+    UINT32                  hash;
+    size_t                  i;
+
+    if (fTx_p)
+    {
+        ppfnCopy = &pdouInstance_g.papfnTxStaticCopy[channelId_p];
+        pPdoChannel = &pdouInstance_g.pdoChannels.pTxPdoChannel[channelId_p];
+        pMappObject = &pdouInstance_g.paTxObject[channelId_p * pdouInstance_g.txChannelObjectCount];
+        pPi = pdouInstance_g.pTxPi;
+        piSize = pdouInstance_g.txPiSize;
+    }
+    else
+    {
+        ppfnCopy = &pdouInstance_g.papfnRxStaticCopy[channelId_p];
+        pPdoChannel = &pdouInstance_g.pdoChannels.pRxPdoChannel[channelId_p];
+        pMappObject = &pdouInstance_g.paRxObject[channelId_p * pdouInstance_g.rxChannelObjectCount];
+        pPi = pdouInstance_g.pRxPi;
+        piSize = pdouInstance_g.rxPiSize;
+    }
+
+    *ppfnCopy = NULL;
+
+    if ((pPdoChannel->nodeId == PDO_INVALID_NODE_ID) ||
+        !calcStaticCopyHash(pMappObject, pPdoChannel->mappObjectCount, fTx_p, pPi, piSize, &hash))
+        return;
+
+    for (i = 0; i < tabentries(aPdoStaticCopy_l); i++)
+    {
+        if ((aPdoStaticCopy_l[i].hash == hash) && (aPdoStaticCopy_l[i].fTx == fTx_p))
+        {
+            *ppfnCopy = aPdoStaticCopy_l[i].pfnCopy;
+            break;
+        }
+    }
+
+    DEBUG_LVL_PDO_TRACE("%s() TX:%d channel:%d hash:0x%08X generated:%d\n", __func__,
+                        fTx_p, channelId_p, hash, (*ppfnCopy != NULL));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Calculate the hash of a PDO channel mapping
+
+The function calculates the FNV-1a hash of the mapping of a PDO channel as it
+is calculated by tools/genpdocopy.pl. The hash is calculated over 32 bit little
+endian values: the direction (1 = TX), the number of mapped objects and 0,
+followed by the offset of the variable in the process image, the bit offset in
+the PDO payload and the size or type (byteSizeOrType) of each object. A hash can only be calculated if all mapped
+variables are located in the process image.
+
+\param  pMappObject_p           Pointer to first mapping object of the channel.
+\param  mappObjectCount_p       Number of mapping objects.
+\param  fTx_p                   TRUE for TXPDO and FALSE for RXPDO.
+\param  pPi_p                   Pointer to the process image of the direction.
+\param  piSize_p                Size of the process image.
+\param  pHash_p                 Pointer to store the hash.
+
+\return The function returns TRUE if the hash could be calculated.
+*/
+//------------------------------------------------------------------------------
+static BOOL calcStaticCopyHash(tPdoMappObject* pMappObject_p, UINT mappObjectCount_p,
+                               BOOL fTx_p, BYTE* pPi_p, UINT piSize_p, UINT32* pHash_p)
+{
+    UINT32              hash = 0x811C9DC5UL;
+    UINT32              aValue[3];
+    UINT                i;
+    UINT                shift;
+    BYTE*               pVar;
+
+    if (pPi_p == NULL)
+        return FALSE;
+
+    aValue[0] = fTx_p ? 1 : 0;
+    aValue[1] = mappObjectCount_p;
+    aValue[2] = 0;
+
+    for (;;)
+    {
+        for (i = 0; i < tabentries(aValue); i++)
+        {
+            for (shift = 0; shift < 32; shift += 8)
+            {
+                hash ^= (aValue[i] >> shift) & 0xFF;
+                hash *= 0x01000193UL;
+            }
+        }
+
+        if (mappObjectCount_p == 0)
+            break;
+
+        pVar = (BYTE*)PDO_MAPPOBJECT_GET_VAR(pMappObject_p);
+        if ((pVar < pPi_p) || (pVar >= (pPi_p + piSize_p)))
+            return FALSE;
+
+        aValue[0] = (UINT32)(pVar - pPi_p);
+        aValue[1] = PDO_MAPPOBJECT_GET_BITOFFSET(pMappObject_p);
+        aValue[2] = pMappObject_p->byteSizeOrType;
+
+        mappObjectCount_p--;
+        pMappObject_p++;
+    }
+
+    *pHash_p = hash;
+    return TRUE;
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief  Calculate PDO memory size
+
+The function calculates the size needed for the PDO memory. Each channel
+buffer is padded to a cache line.
+
+\param  pPdoChannels_p      Pointer to PDO channel setup.
+\param  pRxPdoMemSize_p     Pointer to store size of RX PDO buffers.
+\param  pTxPdoMemSize_p     Pointer to store size of TX PDO buffers.
+
+\return The function returns the size of the used PDO memory
+*/
+//------------------------------------------------------------------------------
+static UINT calcPdoMemSize(tPdoChannelSetup* pPdoChannels_p, size_t* pRxPdoMemSize_p,
+                           size_t* pTxPdoMemSize_p)
+{
+    UINT                channelId;
+    size_t              rxSize;
+    size_t              txSize;
+    tPdoChannel*        pPdoChannel;
+
+    rxSize = 0;
+    for (channelId = 0, pPdoChannel = pPdoChannels_p->pRxPdoChannel;
+         channelId < pPdoChannels_p->allocation.rxPdoChannelCount;
+         channelId++, pPdoChannel++)
+    {
+        rxSize += PDO_ALIGN_CACHE_LINE(pPdoChannel->pdoSize);
+    }
+    if (pRxPdoMemSize_p != NULL)
+        *pRxPdoMemSize_p = rxSize;
+
+    txSize = 0;
+    for (channelId = 0, pPdoChannel = pPdoChannels_p->pTxPdoChannel;
+         channelId < pPdoChannels_p->allocation.txPdoChannelCount;
+         channelId++, pPdoChannel++)
+    {
+        txSize += PDO_TX_BUFFER_SIZE(pPdoChannel->pdoSize);
+    }
+    if (pTxPdoMemSize_p != NULL)
+        *pTxPdoMemSize_p = txSize;
+
+    return rxSize + txSize;
+}
+
+#if (CONFIG_PDO_HITLESS_REMAP != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Allocate a shadow mapping
+
+The function allocates the memory of the shadow mapping of a PDO direction.
+
+\param  pShadow_p           Pointer to the shadow mapping.
+\param  channelCount_p      Number of PDO channels of the direction.
+\param  objectCount_p       Maximum number of mapped objects per channel.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError allocShadowMapping(tPdoShadowMapping* pShadow_p, UINT channelCount_p,
+                                     UINT objectCount_p)
+{
+    pShadow_p->fPending = FALSE;
+    pShadow_p->fRxHold = FALSE;
+
+    pShadow_p->paObject = (tPdoMappObject*)OPLK_MALLOC(sizeof(tPdoMappObject) * objectCount_p);
+    pShadow_p->paCopyOp = (tPdoCopyOp*)OPLK_MALLOC(sizeof(tPdoCopyOp) * objectCount_p);
+    pShadow_p->paBufSize = (WORD*)OPLK_MALLOC(sizeof(WORD) * channelCount_p);
+    if ((pShadow_p->paObject == NULL) || (pShadow_p->paCopyOp == NULL) ||
+        (pShadow_p->paBufSize == NULL))
+    {
+        freeShadowMapping(pShadow_p);
+        return kErrorPdoInitError;
+    }
+
+    OPLK_MEMSET(pShadow_p->paBufSize, 0, sizeof(WORD) * channelCount_p);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Free a shadow mapping
+
+\param  pShadow_p           Pointer to the shadow mapping.
+*/
+//------------------------------------------------------------------------------
+static void freeShadowMapping(tPdoShadowMapping* pShadow_p)
+{
+    pShadow_p->fPending = FALSE;
+    pShadow_p->fRxHold = FALSE;
+
+    if (pShadow_p->paObject != NULL)
+    {
+        OPLK_FREE(pShadow_p->paObject);
+        pShadow_p->paObject = NULL;
+    }
+
+    if (pShadow_p->paCopyOp != NULL)
+    {
+        OPLK_FREE(pShadow_p->paCopyOp);
+        pShadow_p->paCopyOp = NULL;
+    }
+
+    if (pShadow_p->paBufSize != NULL)
+    {
+        OPLK_FREE(pShadow_p->paBufSize);
+        pShadow_p->paBufSize = NULL;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the shadow mapping of a PDO direction
+
+\param  fTx_p               TRUE for the TX direction, FALSE for RX.
+
+\return The function returns a pointer to the shadow mapping.
+*/
+//------------------------------------------------------------------------------
+static tPdoShadowMapping* getShadowMapping(BOOL fTx_p)
+{
+    return (fTx_p) ? &pdouInstance_g.txShadow : &pdouInstance_g.rxShadow;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Record the PDO buffer sizes
+
+The function records the size of the PDO buffer of each channel as set up by
+configureAllPdos(). A mapping changed at runtime must fit into this buffer
+because the PDO buffers are not set up again while the PDO engine is running.
+*/
+//------------------------------------------------------------------------------
+static void setShadowBufSizes(void)
+{
+    UINT    channelId;
+
+    if (pdouInstance_g.rxShadow.paBufSize != NULL)
+    {
+        for (channelId = 0; channelId < pdouInstance_g.pdoChannels.allocation.rxPdoChannelCount;
+             channelId++)
+        {
+            pdouInstance_g.rxShadow.paBufSize[channelId] =
+                (WORD)PDO_ALIGN_CACHE_LINE(pdouInstance_g.pdoChannels.pRxPdoChannel[channelId].pdoSize);
+        }
+    }
+
+    if (pdouInstance_g.txShadow.paBufSize != NULL)
+    {
+        for (channelId = 0; channelId < pdouInstance_g.pdoChannels.allocation.txPdoChannelCount;
+             channelId++)
+        {
+            pdouInstance_g.txShadow.paBufSize[channelId] =
+                (WORD)PDO_TX_PAYLOAD_SIZE(pdouInstance_g.pdoChannels.pTxPdoChannel[channelId].pdoSize);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Stage a new mapping in the shadow mapping
+
+The function compiles the copy program of a new mapping which has been set up
+in the mapping objects of the shadow mapping and marks it for the switch at
+the next cycle boundary. The kernel channel of an RXPDO is reconfigured
+immediately, so that the first PDO with the new mapping is already stored in
+the buffer when the user part switches. The RXPDO channel is held from now on
+until a PDO arrives after the switch.
+
+\param  pShadow_p           Pointer to the shadow mapping.
+\param  pChannelConf_p      Configuration of the channel with the new mapping.
+\param  pAbortCode_p        Pointer to store the abort code.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError stageShadowMapping(tPdoShadowMapping* pShadow_p, tPdoChannelConf* pChannelConf_p,
+                                     UINT32* pAbortCode_p)
+{
+    tOplkError  ret;
+
+    if (pChannelConf_p->pdoChannel.pdoSize > pShadow_p->paBufSize[pChannelConf_p->channelId])
+    {   // PDO buffer cannot be enlarged while running
+        *pAbortCode_p = SDO_AC_PDO_LENGTH_EXCEEDED;
+        return kErrorPdoLengthExceeded;
+    }
+
+    compileCopyProgram(pShadow_p->paObject, pChannelConf_p->pdoChannel.mappObjectCount,
+                       pShadow_p->paCopyOp, &pShadow_p->copyOpCount);
+    OPLK_MEMCPY(&pShadow_p->channelConf, pChannelConf_p, sizeof(tPdoChannelConf));
+
+    if (!pChannelConf_p->fTx)
+    {   // do not decode PDOs with the old copy program from now on
+        pShadow_p->rxHoldSequence = pdouInstance_g.paRxSequence[pChannelConf_p->channelId];
+        pShadow_p->fRxHold = TRUE;
+
+        ret = pdoucal_postConfigureChannel(pChannelConf_p);
+        if (ret != kErrorOk)
+        {
+            pShadow_p->fRxHold = FALSE;
+            *pAbortCode_p = SDO_AC_GENERAL_ERROR;
+            return ret;
+        }
+    }
+
+    pShadow_p->fPending = TRUE;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Switch a shadow mapping into the channel tables
+
+The function copies a staged mapping into the channel tables of its PDO
+channel. It is called at the start of the copy functions, so the copy program
+of the channel never changes while it is executed. The kernel channel of a
+TXPDO is reconfigured after the switch. It sends the TPDO as not ready until
+the first PDO with the new mapping has been written.
+
+\param  pShadow_p           Pointer to the shadow mapping.
+*/
+//------------------------------------------------------------------------------
+static void switchShadowMapping(tPdoShadowMapping* pShadow_p)
+{
+    tPdoChannelConf*    pChannelConf = &pShadow_p->channelConf;
+    UINT                channelId = pChannelConf->channelId;
+    UINT                objectCount;
+    tPdoMappObject*     pLiveObject;
+    tPdoCopyOp*         pLiveCopyOp;
+    tPdoChannel*        pLiveChannel;
+    UINT                index;
+
+    if (pChannelConf->fTx)
+    {
+        objectCount = pdouInstance_g.txChannelObjectCount;
+        pLiveObject = &pdouInstance_g.paTxObject[channelId * objectCount];
+        pLiveCopyOp = &pdouInstance_g.paTxCopyOp[channelId * objectCount];
+        pLiveChannel = &pdouInstance_g.pdoChannels.pTxPdoChannel[channelId];
+        pdouInstance_g.paTxCopyOpCount[channelId] = pShadow_p->copyOpCount;
+    }
+    else
+    {
+        objectCount = pdouInstance_g.rxChannelObjectCount;
+        pLiveObject = &pdouInstance_g.paRxObject[channelId * objectCount];
+        pLiveCopyOp = &pdouInstance_g.paRxCopyOp[channelId * objectCount];
+        pLiveChannel = &pdouInstance_g.pdoChannels.pRxPdoChannel[channelId];
+        pdouInstance_g.paRxCopyOpCount[channelId] = pShadow_p->copyOpCount;
+    }
+
+    OPLK_MEMCPY(pLiveObject, pShadow_p->paObject, sizeof(tPdoMappObject) * objectCount);
+    for (index = 0; index < pShadow_p->copyOpCount; index++)
+    {
+        pLiveCopyOp[index] = pShadow_p->paCopyOp[index];
+        if (pLiveCopyOp[index].pMappObject != NULL)
+        {   // rebase the conversion object into the channel table
+            pLiveCopyOp[index].pMappObject = pLiveObject +
+                                             (pShadow_p->paCopyOp[index].pMappObject - pShadow_p->paObject);
+        }
+    }
+    OPLK_MEMCPY(pLiveChannel, &pChannelConf->pdoChannel, sizeof(tPdoChannel));
+
+#if (CONFIG_PDO_STATIC_COPY != FALSE)
+    setupStaticCopy(pChannelConf->fTx, channelId);
+#endif
+
+    if (pChannelConf->fTx)
+    {
+        setupTxChannelDirty(channelId);
+        pdoucal_postConfigureChannel(pChannelConf);
+    }
+    else if (pChannelConf->pdoChannel.nodeId == PDO_INVALID_NODE_ID)
+    {   // a disabled channel is not copied at all
+        pShadow_p->fRxHold = FALSE;
+    }
+
+    pShadow_p->fPending = FALSE;
+}
+#endif
+
 ///\}
 
@@ -7,7 +7,10 @@
 This file contains an implementation for the user PDO CAL module which uses
 a shared memory region between user and kernel layer. PDOs are transfered
 through triple buffering between the layers. Therefore, reads and writes to
-the PDOs can occur completely asynchronously.
+the PDOs can occur completely asynchronously. The RPDOs can be read by
+CONFIG_PDO_RX_READER_COUNT independent readers, e.g. several threads or
+processes which map the PDO memory. Every reader gets its own consistent view
+of the latest RPDO of a channel.
 
 This file contains no specific shared memory implementation. This is encapsulated
 in the pdoucalmem-XX.c modules.
@@ -56,6 +59,16 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //            G L O B A L   D E F I N I T I O N S                             //
 //============================================================================//
 
+// The local PDO buffer is the copy of a single reader
+#if (CONFIG_PDO_HOSTIF_DMA != FALSE) && (CONFIG_PDO_RX_READER_COUNT > 1)
+#error "CONFIG_PDO_HOSTIF_DMA supports only one RPDO reader!"
+#endif
+
+// The kernel process images are accessed directly in the PDO memory
+#if (CONFIG_PDO_HOSTIF_DMA != FALSE) && (CONFIG_PDO_KERNEL_PI != FALSE)
+#error "CONFIG_PDO_KERNEL_PI is not supported with CONFIG_PDO_HOSTIF_DMA!"
+#endif
+
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
@@ -85,11 +98,15 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 static tPdoMemRegion*       pPdoMem_l;
 static size_t               memSize_l;
-static BYTE*                pTripleBuf_l[3];
+static BYTE*                pPdoBuf_l[PDO_BUFFER_COUNT];
+#if (CONFIG_PDO_HOSTIF_DMA != FALSE)
+static BYTE*                pLocalBuf_l;        // local copy of the PDO buffer, exchanged by DMA
+#endif
 
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
+static BOOL claimRxBuffer(tPdoBufferInfo* pInfo_p, UINT readerId_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -114,6 +131,7 @@ tOplkError pdoucal_initPdoMem(tPdoChannelSetup* pPdoChannels_p, size_t rxPdoMemS
                               size_t txPdoMemSize_p)
 {
     size_t          pdoMemSize;
+    UINT            i;
 
     UNUSED_PARAMETER(pPdoChannels_p);
 
@@ -124,7 +142,7 @@ tOplkError pdoucal_initPdoMem(tPdoChannelSetup* pPdoChannels_p, size_t rxPdoMemS
         pdoucal_cleanupPdoMem();
     }
 
-    memSize_l = (pdoMemSize * 3) + sizeof(tPdoMemRegion);
+    memSize_l = (pdoMemSize * PDO_BUFFER_COUNT) + PDO_ALIGN_CACHE_LINE(sizeof(tPdoMemRegion));
     if (memSize_l != 0)
     {
         if (pdoucal_allocateMem(memSize_l, (BYTE**)&pPdoMem_l) != kErrorOk)
@@ -135,17 +153,26 @@ tOplkError pdoucal_initPdoMem(tPdoChannelSetup* pPdoChannels_p, size_t rxPdoMemS
         }
     }
 
-    pTripleBuf_l[0] = (BYTE*)pPdoMem_l + sizeof(tPdoMemRegion);
-    pTripleBuf_l[1] = pTripleBuf_l[0] + pdoMemSize;
-    pTripleBuf_l[2] = pTripleBuf_l[1] + pdoMemSize;
+    pPdoBuf_l[0] = (BYTE*)pPdoMem_l + PDO_ALIGN_CACHE_LINE(sizeof(tPdoMemRegion));
+    for (i = 1; i < PDO_BUFFER_COUNT; i++)
+        pPdoBuf_l[i] = pPdoBuf_l[i - 1] + pdoMemSize;
 
     TRACE("%s() Mapped shared memory for PDO mem region at %p size %d\n",
           __func__, pPdoMem_l, memSize_l);
-    TRACE("%s() Triple buffers at: %p/%p/%p\n", __func__,
-          pTripleBuf_l[0], pTripleBuf_l[1], pTripleBuf_l[2]);
+    TRACE("%s() %d buffers at: %p\n", __func__, PDO_BUFFER_COUNT, pPdoBuf_l[0]);
 
     OPLK_ATOMIC_INIT(pPdoMem_l);
 
+#if (CONFIG_PDO_HOSTIF_DMA != FALSE)
+    pLocalBuf_l = (BYTE*)OPLK_MALLOC(pdoMemSize);
+    if (pLocalBuf_l == NULL)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Allocating local PDO buffer failed!\n", __func__);
+        return kErrorNoResource;
+    }
+    OPLK_MEMSET(pLocalBuf_l, 0, pdoMemSize);
+#endif
+
     return kErrorOk;
 }
 
@@ -167,13 +194,23 @@ void pdoucal_cleanupPdoMem(void)
             DEBUG_LVL_ERROR_TRACE("%s() Unmapping shared PDO mem failed\n", __func__);
         }
     }
+
+#if (CONFIG_PDO_HOSTIF_DMA != FALSE)
+    if (pLocalBuf_l != NULL)
+    {
+        OPLK_FREE(pLocalBuf_l);
+        pLocalBuf_l = NULL;
+    }
+#endif
 }
 
 //------------------------------------------------------------------------------
 /**
 \brief  Get address of TX PDO buffer
 
-The function returns the address of the TXPDO buffer specified.
+The function returns the address of the TXPDO buffer specified. If
+CONFIG_PDO_HOSTIF_DMA is enabled, the address is located in the local PDO buffer
+and the TXPDO is transferred by pdoucal_setTxPdo().
 
 \param  channelId_p             The PDO channel ID of the PDO to get the address.
 
@@ -184,12 +221,19 @@ The function returns the address of the TXPDO buffer specified.
 //------------------------------------------------------------------------------
 BYTE* pdoucal_getTxPdoAdrs(UINT channelId_p)
 {
-    OPLK_ATOMIC_T    wi;
     BYTE*            pPdo;
+#if (CONFIG_PDO_HOSTIF_DMA == FALSE)
+    OPLK_ATOMIC_T    wi;
+#endif
 
-    wi = pPdoMem_l->txChannelInfo[channelId_p].writeBuf;
+#if (CONFIG_PDO_HOSTIF_DMA != FALSE)
+    // the application writes the local buffer, pdoucal_setTxPdo() transfers it
+    pPdo = pLocalBuf_l + pPdoMem_l->txChannelInfo[channelId_p].info.channelOffset;
+#else
+    wi = pPdoMem_l->txChannelInfo[channelId_p].info.writeBuf;
     //TRACE("%s() channelId:%d wi:%d\n", __func__, channelId_p, wi);
-    pPdo = pTripleBuf_l[wi] + pPdoMem_l->txChannelInfo[channelId_p].channelOffset;
+    pPdo = pPdoBuf_l[wi] + pPdoMem_l->txChannelInfo[channelId_p].info.channelOffset;
+#endif
     return pPdo;
 }
 
@@ -212,20 +256,35 @@ tOplkError pdoucal_setTxPdo(UINT channelId_p, BYTE* pPdo_p, WORD pdoSize_p)
 {
     OPLK_ATOMIC_T    temp;
 
+#if (CONFIG_PDO_HOSTIF_DMA != FALSE)
+    tOplkError       ret;
+
+    // transfer the whole TXPDO into the current write buffer
+    ret = pdoucal_copyMem(pPdoBuf_l[pPdoMem_l->txChannelInfo[channelId_p].info.writeBuf] +
+                              pPdoMem_l->txChannelInfo[channelId_p].info.channelOffset,
+                          pPdo_p, pdoSize_p);
+    if (ret != kErrorOk)
+        return ret;
+#else
     UNUSED_PARAMETER(pPdo_p);
     UNUSED_PARAMETER(pdoSize_p);
+#endif
+
+    //TRACE("%s() chan:%d wi:%d\n", __func__, channelId_p, pPdoMem_l->txChannelInfo[channelId_p].info.writeBuf);
 
-    //TRACE("%s() chan:%d wi:%d\n", __func__, channelId_p, pPdoMem_l->txChannelInfo[channelId_p].writeBuf);
+    // Publish the buffer after its data is completely written. The barrier also
+    // drains the write-combining buffers of a write-combining PDO memory.
+    OPLK_MEMBAR();
 
     //shmWriterSpinlock(&pPdoMem_l->txSpinlock);
-    temp = pPdoMem_l->txChannelInfo[channelId_p].writeBuf;
-    OPLK_ATOMIC_EXCHANGE(&pPdoMem_l->txChannelInfo[channelId_p].cleanBuf,
+    temp = pPdoMem_l->txChannelInfo[channelId_p].info.writeBuf;
+    OPLK_ATOMIC_EXCHANGE(&pPdoMem_l->txChannelInfo[channelId_p].info.cleanBuf,
                          temp,
-                         pPdoMem_l->txChannelInfo[channelId_p].writeBuf);
-    pPdoMem_l->txChannelInfo[channelId_p].newData = 1;
+                         pPdoMem_l->txChannelInfo[channelId_p].info.writeBuf);
+    pPdoMem_l->txChannelInfo[channelId_p].info.newData = 1;
     //shmWriterSpinUnlock(&pPdoMem_l->txSpinlock);
 
-    //TRACE("%s() chan:%d new wi:%d\n", __func__, channelId_p, pPdoMem_l->txChannelInfo[channelId_p].writeBuf);
+    //TRACE("%s() chan:%d new wi:%d\n", __func__, channelId_p, pPdoMem_l->txChannelInfo[channelId_p].info.writeBuf);
 
     return kErrorOk;
 }
@@ -234,7 +293,9 @@ tOplkError pdoucal_setTxPdo(UINT channelId_p, BYTE* pPdo_p, WORD pdoSize_p)
 /**
 \brief  Read RXPDO from PDO memory
 
-The function reads an RXPDO from the PDO buffer.
+The function reads an RXPDO from the PDO buffer for the first reader. If
+CONFIG_PDO_HOSTIF_DMA is enabled, a new RXPDO is transferred into the local PDO
+buffer and the local copy is returned.
 
 \param  ppPdo_p                 Pointer to store the RXPDO data address.
 \param  channelId_p             Channel ID of PDO to read.
@@ -247,30 +308,309 @@ The function reads an RXPDO from the PDO buffer.
 //------------------------------------------------------------------------------
 tOplkError pdoucal_getRxPdo(BYTE** ppPdo_p, UINT channelId_p, WORD pdoSize_p)
 {
-    OPLK_ATOMIC_T    readBuf;
+    return pdoucal_getReaderRxPdo(0, ppPdo_p, channelId_p, pdoSize_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read RXPDO from PDO memory for a reader
+
+The function reads an RXPDO from the PDO buffer for the specified reader. If
+the kernel layer has written a new RXPDO, the reader claims its buffer. The
+returned RXPDO stays valid and unchanged until the next call for the same
+reader and channel. Every reader must be used by only one thread at a time,
+different readers may be used concurrently.
+
+\param  readerId_p              ID of the reader (0..CONFIG_PDO_RX_READER_COUNT - 1).
+\param  ppPdo_p                 Pointer to store the RXPDO data address.
+\param  channelId_p             Channel ID of PDO to read.
+\param  pdoSize_p               Size of PDO.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The RXPDO address is stored.
+\retval kErrorInvalidInstanceParam  The reader ID is invalid.
+
+\ingroup module_pdoucal
+*/
+//------------------------------------------------------------------------------
+tOplkError pdoucal_getReaderRxPdo(UINT readerId_p, BYTE** ppPdo_p, UINT channelId_p,
+                                  WORD pdoSize_p)
+{
+    tPdoBufferInfo*     pInfo;
 
+#if (CONFIG_PDO_HOSTIF_DMA == FALSE)
     UNUSED_PARAMETER(pdoSize_p);
+#endif
+
+    if (readerId_p >= CONFIG_PDO_RX_READER_COUNT)
+        return kErrorInvalidInstanceParam;
 
-    if (pPdoMem_l->rxChannelInfo[channelId_p].newData)
+    pInfo = &pPdoMem_l->rxChannelInfo[channelId_p].info;
+
+    if (claimRxBuffer(pInfo, readerId_p))
     {
-        readBuf = pPdoMem_l->rxChannelInfo[channelId_p].readBuf;
-        OPLK_ATOMIC_EXCHANGE(&pPdoMem_l->rxChannelInfo[channelId_p].cleanBuf,
-                             readBuf,
-                             pPdoMem_l->rxChannelInfo[channelId_p].readBuf);
-        pPdoMem_l->rxChannelInfo[channelId_p].newData = 0;
+#if (CONFIG_PDO_HOSTIF_DMA != FALSE)
+        tOplkError  ret;
+
+        // transfer the whole new RXPDO into the local buffer
+        ret = pdoucal_copyMem(pLocalBuf_l + pInfo->channelOffset,
+                              pPdoBuf_l[pInfo->aReaderBuf[readerId_p]] + pInfo->channelOffset,
+                              pdoSize_p);
+        if (ret != kErrorOk)
+            return ret;
+#endif
     }
 
-    readBuf = pPdoMem_l->rxChannelInfo[channelId_p].readBuf;
-    *ppPdo_p = pTripleBuf_l[readBuf] + pPdoMem_l->rxChannelInfo[channelId_p].channelOffset;
+#if (CONFIG_PDO_HOSTIF_DMA != FALSE)
+    *ppPdo_p = pLocalBuf_l + pInfo->channelOffset;
+#else
+    *ppPdo_p = pPdoBuf_l[pInfo->aReaderBuf[readerId_p]] + pInfo->channelOffset;
+#endif
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get sequence number of RXPDO
+
+The function returns the sequence number of the RXPDO which was returned by the
+last call of pdoucal_getRxPdo(). The kernel layer increments the sequence
+number of a channel with every received PDO, so the caller can detect whether
+the channel got fresh data without comparing the PDO.
+
+\param  channelId_p             Channel ID of PDO.
+
+\return The function returns the sequence number of the RXPDO. 0 means that no
+        PDO has been received yet.
+
+\ingroup module_pdoucal
+*/
+//------------------------------------------------------------------------------
+UINT32 pdoucal_getRxPdoSequence(UINT channelId_p)
+{
+    return pdoucal_getReaderRxPdoSequence(0, channelId_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get sequence number of RXPDO of a reader
+
+The function returns the sequence number of the RXPDO which was returned by the
+last call of pdoucal_getReaderRxPdo() for the specified reader.
+
+\param  readerId_p              ID of the reader (0..CONFIG_PDO_RX_READER_COUNT - 1).
+\param  channelId_p             Channel ID of PDO.
+
+\return The function returns the sequence number of the RXPDO. 0 means that no
+        PDO has been received yet or the reader ID is invalid.
+
+\ingroup module_pdoucal
+*/
+//------------------------------------------------------------------------------
+UINT32 pdoucal_getReaderRxPdoSequence(UINT readerId_p, UINT channelId_p)
+{
+    tPdoBufferInfo*     pInfo = &pPdoMem_l->rxChannelInfo[channelId_p].info;
+
+    if (readerId_p >= CONFIG_PDO_RX_READER_COUNT)
+        return 0;
+
+    return pInfo->aSequence[pInfo->aReaderBuf[readerId_p]];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get SoC time information
+
+The function reads the time information of the last SoC which is published by
+the kernel layer in the PDO memory on every sync event. Several threads may
+read it at the same time.
+
+\param  pSocTimeInfo_p          Pointer to store the SoC time information.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdoucal
+*/
+//------------------------------------------------------------------------------
+tOplkError pdoucal_getSocTime(tSocTimeInfo* pSocTimeInfo_p)
+{
+    tPdoSocTime*    pSocTime;
+    UINT32          sequence;
+
+    if (pPdoMem_l == NULL)
+        return kErrorNoResource;
+
+    pSocTime = &pPdoMem_l->socTime.socTime;
+
+    do
+    {
+        sequence = pSocTime->sequence;
+        OPLK_MEMBAR();
+        *pSocTimeInfo_p = pSocTime->timeInfo;
+        OPLK_MEMBAR();
+    } while (((sequence & 1) != 0) || (sequence != pSocTime->sequence));
 
     return kErrorOk;
 }
 
+#if (CONFIG_PDO_KERNEL_PI != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Write copy operations of the kernel process images
+
+The function writes the copy operations of the kernel process images to the
+PDO memory, where the kernel layer reads them when it is set up by
+pdoucal_postSetupKernelPi().
+
+\param  paCopy_p                Pointer to the copy operations.
+\param  copyCount_p             Number of copy operations.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdoucal
+*/
+//------------------------------------------------------------------------------
+tOplkError pdoucal_writeKernelPiCopy(const tPdoKernelPiCopy* paCopy_p, UINT copyCount_p)
+{
+    if (pPdoMem_l == NULL)
+        return kErrorNoResource;
+
+    if (copyCount_p > CONFIG_PDO_KERNEL_PI_COPY_COUNT)
+        return kErrorNoResource;
+
+    OPLK_MEMCPY(pPdoMem_l->kernelPi.aCopy, paCopy_p, copyCount_p * sizeof(tPdoKernelPiCopy));
+    OPLK_MEMBAR();
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get output process image
+
+The function switches to the output process image which was published last by
+the kernel layer. The buffer stays valid until the next call of the function.
+
+\return The function returns a pointer to the output process image or NULL if
+        the PDO memory is not available.
+
+\ingroup module_pdoucal
+*/
+//------------------------------------------------------------------------------
+BYTE* pdoucal_getKernelPiOut(void)
+{
+    tPdoBufferInfo*     pInfo;
+    OPLK_ATOMIC_T       temp;
+
+    if (pPdoMem_l == NULL)
+        return NULL;
+
+    pInfo = &pPdoMem_l->kernelPi.aImageInfo[PDO_KERNEL_PI_OUTPUT].info;
+    if (pInfo->newData)
+    {
+        temp = pInfo->readBuf;
+        OPLK_ATOMIC_EXCHANGE(&pInfo->cleanBuf, temp, pInfo->readBuf);
+        pInfo->newData = 0;
+        OPLK_MEMBAR();
+    }
+
+    return pPdoMem_l->kernelPi.aaaImage[PDO_KERNEL_PI_OUTPUT][pInfo->readBuf];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get input process image
+
+The function returns the write buffer of the input process image. It does not
+contain the data of the previous cycle.
+
+\return The function returns a pointer to the input process image or NULL if
+        the PDO memory is not available.
+
+\ingroup module_pdoucal
+*/
+//------------------------------------------------------------------------------
+BYTE* pdoucal_getKernelPiIn(void)
+{
+    if (pPdoMem_l == NULL)
+        return NULL;
+
+    return pPdoMem_l->kernelPi.aaaImage[PDO_KERNEL_PI_INPUT]
+                     [pPdoMem_l->kernelPi.aImageInfo[PDO_KERNEL_PI_INPUT].info.writeBuf];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Publish input process image
+
+The function publishes the write buffer of the input process image to the
+kernel layer, which reads it at the next sync event.
+
+\return The function returns a pointer to the new write buffer of the input
+        process image or NULL if the PDO memory is not available.
+
+\ingroup module_pdoucal
+*/
+//------------------------------------------------------------------------------
+BYTE* pdoucal_setKernelPiIn(void)
+{
+    tPdoBufferInfo*     pInfo;
+    OPLK_ATOMIC_T       temp;
+
+    if (pPdoMem_l == NULL)
+        return NULL;
+
+    pInfo = &pPdoMem_l->kernelPi.aImageInfo[PDO_KERNEL_PI_INPUT].info;
+
+    // publish the buffer after its data is completely written
+    OPLK_MEMBAR();
+    temp = pInfo->writeBuf;
+    OPLK_ATOMIC_EXCHANGE(&pInfo->cleanBuf, temp, pInfo->writeBuf);
+    pInfo->newData = 1;
+
+    return pPdoMem_l->kernelPi.aaaImage[PDO_KERNEL_PI_INPUT][pInfo->writeBuf];
+}
+#endif
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
 /// \name Private Functions
 /// \{
 
+//------------------------------------------------------------------------------
+/**
+\brief  Claim latest RXPDO buffer
+
+The function claims the latest buffer of an RXPDO channel for a reader, if it
+is newer than the buffer the reader holds. After the claim is stored, the
+buffer must still be the latest one. Otherwise the writer may have selected it
+as write buffer before it saw the claim and the claim is repeated. The writer
+never waits for the reader, it uses a buffer which is not claimed instead.
+
+\param  pInfo_p             Pointer to the control information of the channel.
+\param  readerId_p          ID of the reader.
+
+\return The function returns TRUE if the reader claimed a new buffer.
+*/
+//------------------------------------------------------------------------------
+static BOOL claimRxBuffer(tPdoBufferInfo* pInfo_p, UINT readerId_p)
+{
+    OPLK_ATOMIC_T   latestBuf;
+    BOOL            fNewBuf = FALSE;
+
+    latestBuf = pInfo_p->cleanBuf;
+    while (latestBuf != pInfo_p->aReaderBuf[readerId_p])
+    {
+        pInfo_p->aReaderBuf[readerId_p] = latestBuf;
+        OPLK_MEMBAR();
+        latestBuf = pInfo_p->cleanBuf;
+        fNewBuf = TRUE;
+    }
+
+    return fNewBuf;
+}
+
 ///\}
 
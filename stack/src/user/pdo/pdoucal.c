@@ -214,6 +214,89 @@ tOplkError pdoucal_postSetupPdoBuffers(size_t rxPdoMemSize_p, size_t txPdoMemSiz
     return Ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Send PDO route to kernel PDO module
+
+The function adds an RPDO to TPDO route in the kernel PDO module by posting
+a kEventTypePdokAddRoute event.
+
+\param  pRoute_p                Pointer to the route.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdoucal
+*/
+//------------------------------------------------------------------------------
+tOplkError pdoucal_postAddRoute(const tPdoRoute* pRoute_p)
+{
+    tOplkError      Ret = kErrorOk;
+    tEvent          Event;
+
+    Event.eventSink = kEventSinkPdokCal;
+    Event.eventType = kEventTypePdokAddRoute;
+    Event.pEventArg = (void*)pRoute_p;
+    Event.eventArgSize = sizeof(*pRoute_p);
+    Ret = eventu_postEvent(&Event);
+
+    return Ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Remove PDO routes in kernel PDO module
+
+The function removes all RPDO to TPDO routes of the kernel PDO module by
+posting a kEventTypePdokClearRoutes event.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdoucal
+*/
+//------------------------------------------------------------------------------
+tOplkError pdoucal_postClearRoutes(void)
+{
+    tOplkError      Ret = kErrorOk;
+    tEvent          Event;
+
+    Event.eventSink = kEventSinkPdokCal;
+    Event.eventType = kEventTypePdokClearRoutes;
+    Event.pEventArg = NULL;
+    Event.eventArgSize = 0;
+    Ret = eventu_postEvent(&Event);
+
+    return Ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set up kernel process images
+
+The function sets up the process images which are assembled by the kernel PDO
+module by posting a kEventTypePdokSetupKernelPi event. The copy operations
+must have been written to the PDO memory before.
+
+\param  pSetup_p                Pointer to the setup of the process images.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdoucal
+*/
+//------------------------------------------------------------------------------
+tOplkError pdoucal_postSetupKernelPi(const tPdoKernelPiSetup* pSetup_p)
+{
+    tOplkError      Ret = kErrorOk;
+    tEvent          Event;
+
+    Event.eventSink = kEventSinkPdokCal;
+    Event.eventType = kEventTypePdokSetupKernelPi;
+    Event.pEventArg = (void*)pSetup_p;
+    Event.eventArgSize = sizeof(*pSetup_p);
+    Ret = eventu_postEvent(&Event);
+
+    return Ret;
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -78,8 +78,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 typedef struct
 {
-    UINT8*  pBase;
-    UINT    span;
+    UINT8*          pBase;
+    UINT            span;
+    tHostifInstance pHifInstance;
 } tLimInstance;
 
 //------------------------------------------------------------------------------
@@ -120,6 +121,7 @@ tOplkError pdoucal_openMem(void)
     }
 
     hifret = hostif_getBuf(pInstance, kHostifInstIdPdo, &limPdo_l.pBase, &limPdo_l.span);
+    limPdo_l.pHifInstance = pInstance;
 
     if (hifret != kHostifSuccessful)
     {
@@ -204,6 +206,38 @@ tOplkError pdoucal_freeMem(BYTE* pMem_p, size_t memSize_p)
     return kErrorOk;
 }
 
+#if (CONFIG_PDO_HOSTIF_DMA != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Copy PDO memory
+
+The function copies a PDO buffer between the local memory of the host and the
+PDO memory of the PCP with a single DMA transfer of the host interface.
+
+\param  pDst_p                  Destination address
+\param  pSrc_p                  Source address
+\param  size_p                  Size of the buffer
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdoucal
+*/
+//------------------------------------------------------------------------------
+tOplkError pdoucal_copyMem(BYTE* pDst_p, const BYTE* pSrc_p, size_t size_p)
+{
+    tHostifReturn hifret;
+
+    hifret = hostif_dmaCopy(limPdo_l.pHifInstance, pDst_p, pSrc_p, (UINT)size_p);
+    if (hifret != kHostifSuccessful)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() DMA transfer failed (%d)\n", __func__, hifret);
+        return kErrorNoResource;
+    }
+
+    return kErrorOk;
+}
+#endif
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -6,7 +6,8 @@
 
 This file contains an implementation for the user PDO CAL module which uses
 the Linux kernel driver by using the mmap device operation to access the kernel
-memory.
+memory. The memory type of the PDO buffers is selected by
+CONFIG_PDO_MMAP_CACHE_MODE.
 
 \ingroup module_pdoucal
 *******************************************************************************/
@@ -78,6 +79,13 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#if (CONFIG_PDO_MMAP_CACHE_MODE == 1)
+#define PDOUCAL_MMAP_PGOFF_PDO          PLK_MMAP_PGOFF_PDO_WC
+#elif (CONFIG_PDO_MMAP_CACHE_MODE == 2)
+#define PDOUCAL_MMAP_PGOFF_PDO          PLK_MMAP_PGOFF_PDO_UC
+#else
+#define PDOUCAL_MMAP_PGOFF_PDO          PLK_MMAP_PGOFF_PDO
+#endif
 
 //------------------------------------------------------------------------------
 // local types
@@ -153,7 +161,16 @@ The function allocates shared memory for the user needed to transfer the PDOs.
 tOplkError pdoucal_allocateMem(size_t memSize_p, BYTE** ppPdoMem_p)
 {
     *ppPdoMem_p = mmap(NULL, memSize_p, PROT_READ | PROT_WRITE, MAP_SHARED,
-                       fd_l, 0);
+                       fd_l, PDOUCAL_MMAP_PGOFF_PDO * sysconf(_SC_PAGE_SIZE));
+#if (PDOUCAL_MMAP_PGOFF_PDO != PLK_MMAP_PGOFF_PDO)
+    if (*ppPdoMem_p == MAP_FAILED)
+    {   // the memory type is not supported by the architecture of the driver
+        DEBUG_LVL_ERROR_TRACE("%s() mmap with memory type %d failed (%s), using cached memory\n",
+                              __func__, CONFIG_PDO_MMAP_CACHE_MODE, strerror(errno));
+        *ppPdoMem_p = mmap(NULL, memSize_p, PROT_READ | PROT_WRITE, MAP_SHARED,
+                           fd_l, PLK_MMAP_PGOFF_PDO * sysconf(_SC_PAGE_SIZE));
+    }
+#endif
     if (*ppPdoMem_p == MAP_FAILED)
     {
         DEBUG_LVL_ERROR_TRACE("%s() mmap failed!\n", __func__);
@@ -47,6 +47,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/vfs.h>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <errno.h>
@@ -84,10 +85,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // local vars
 //------------------------------------------------------------------------------
 static int                  fd_l;
+static BOOL                 fHugePages_l;
 
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
+static size_t getMapSize(size_t memSize_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -101,6 +104,8 @@ The function performs all actions needed to setup the shared memory at the
 start of the stack.
 
 For the Posix shared-memory implementation it opens the shared memory segment.
+If CONFIG_PDO_SHM_HUGETLBFS_PATH is set and the kernel layer created the
+segment on this hugetlbfs mount, this segment is opened instead.
 
 \return The function returns a tOplkError error code.
 
@@ -109,6 +114,18 @@ For the Posix shared-memory implementation it opens the shared memory segment.
 //------------------------------------------------------------------------------
 tOplkError pdoucal_openMem(void)
 {
+    fHugePages_l = FALSE;
+
+    if (CONFIG_PDO_SHM_HUGETLBFS_PATH[0] != '\0')
+    {
+        fd_l = open(CONFIG_PDO_SHM_HUGETLBFS_PATH PDO_SHMEM_NAME, O_RDWR);
+        if (fd_l >= 0)
+        {
+            fHugePages_l = TRUE;
+            return kErrorOk;
+        }
+    }
+
     if ((fd_l = shm_open(PDO_SHMEM_NAME, O_RDWR, 0)) < 0)
     {
         TRACE("%s() Error open shared memory!\n", __func__);
@@ -133,7 +150,15 @@ For the Posix shared-memory implementation it unlinks the shared memory segment.
 //------------------------------------------------------------------------------
 tOplkError pdoucal_closeMem(void)
 {
-    shm_unlink(PDO_SHMEM_NAME);
+    if (fHugePages_l)
+    {
+        close(fd_l);
+        unlink(CONFIG_PDO_SHM_HUGETLBFS_PATH PDO_SHMEM_NAME);
+    }
+    else
+    {
+        shm_unlink(PDO_SHMEM_NAME);
+    }
     return kErrorOk;
 }
 
@@ -142,6 +167,7 @@ tOplkError pdoucal_closeMem(void)
 \brief  Allocate PDO shared memory
 
 The function allocates shared memory for the user needed to transfer the PDOs.
+If CONFIG_PDO_SHM_LOCK is TRUE, the memory is locked into RAM.
 
 \param  memSize_p               Size of PDO memory
 \param  ppPdoMem_p              Pointer to store the PDO memory pointer.
@@ -153,7 +179,10 @@ The function allocates shared memory for the user needed to transfer the PDOs.
 //------------------------------------------------------------------------------
 tOplkError pdoucal_allocateMem(size_t memSize_p, BYTE** ppPdoMem_p)
 {
-    *ppPdoMem_p = mmap(NULL, memSize_p, PROT_READ | PROT_WRITE, MAP_SHARED,
+    size_t          mapSize;
+
+    mapSize = getMapSize(memSize_p);
+    *ppPdoMem_p = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED,
                        fd_l, 0);
     if (*ppPdoMem_p == MAP_FAILED)
     {
@@ -161,6 +190,11 @@ tOplkError pdoucal_allocateMem(size_t memSize_p, BYTE** ppPdoMem_p)
         *ppPdoMem_p = NULL;
         return kErrorNoResource;
     }
+
+    if (CONFIG_PDO_SHM_LOCK && (mlock(*ppPdoMem_p, mapSize) != 0))
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Unable to lock PDO memory (%s)\n", __func__, strerror(errno));
+    }
     return kErrorOk;
 }
 
@@ -181,7 +215,7 @@ transfering the PDOs.
 //------------------------------------------------------------------------------
 tOplkError pdoucal_freeMem(BYTE* pMem_p, size_t memSize_p)
 {
-    if (munmap(pMem_p, memSize_p) != 0)
+    if (munmap(pMem_p, getMapSize(memSize_p)) != 0)
     {
         TRACE("%s() munmap failed (%s)\n", __func__, strerror(errno));
         return kErrorGeneralError;
@@ -195,5 +229,29 @@ tOplkError pdoucal_freeMem(BYTE* pMem_p, size_t memSize_p)
 /// \name Private Functions
 /// \{
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get size of PDO memory mapping
+
+The function returns the size of the mapping for the PDO memory. Memory on a
+hugetlbfs mount can only be mapped in multiples of the huge page size.
+
+\param  memSize_p               Size of PDO memory
+
+\return The function returns the size of the mapping.
+*/
+//------------------------------------------------------------------------------
+static size_t getMapSize(size_t memSize_p)
+{
+    struct statfs   fsInfo;
+    size_t          pageSize;
+
+    if (!fHugePages_l || (fstatfs(fd_l, &fsInfo) != 0) || (fsInfo.f_bsize <= 0))
+        return memSize_p;
+
+    pageSize = (size_t)fsInfo.f_bsize;
+    return ((memSize_p + pageSize - 1) / pageSize) * pageSize;
+}
+
 ///\}
 
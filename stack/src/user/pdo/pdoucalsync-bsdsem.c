@@ -173,6 +173,40 @@ tOplkError pdoucal_waitSyncEvent(ULONG timeout_p)
         return kErrorGeneralError;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get sync file descriptor
+
+The function returns a file descriptor which is readable when a sync event
+occurred. It is not supported by this implementation.
+
+\return The function always returns -1.
+*/
+//------------------------------------------------------------------------------
+int pdoucal_getSyncFd(void)
+{
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get sync information
+
+The function returns information about the last sync events. It is not
+supported by this implementation.
+
+\param  pSyncInfo_p     Pointer to store the sync information.
+
+\return The function returns kErrorApiNotSupported.
+*/
+//------------------------------------------------------------------------------
+tOplkError pdoucal_getSyncInfo(tSyncInfo* pSyncInfo_p)
+{
+    UNUSED_PARAMETER(pSyncInfo_p);
+
+    return kErrorApiNotSupported;
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -0,0 +1,358 @@
+/**
+********************************************************************************
+\file   pdoucalsync-futex.c
+
+\brief  Sync implementation for the PDO user CAL module using a futex
+
+This file contains a sync implementation for the PDO user CAL module. It waits
+on the futex in the POSIX shared memory which is incremented by the kernel
+layer on every sync event (see pdokcalsync-futex.c).
+
+A waiting thread first spins on the futex word for a limited time and only
+sleeps on the futex if no sync event arrived. The spin time adapts to the
+cycle: it is increased if spinning caught the sync event and decreased if the
+thread had to sleep anyway.
+
+\ingroup module_pdoucal
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <common/pdo.h>
+#include <user/pdoucal.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#ifndef CONFIG_PDOU_SYNC_SPIN_MAX
+#define CONFIG_PDOU_SYNC_SPIN_MAX           4096    // maximum number of futex word polls before sleeping
+#endif
+
+#ifndef CONFIG_PDOU_SYNC_SPIN_MIN
+#define CONFIG_PDOU_SYNC_SPIN_MIN           16      // minimum number of futex word polls before sleeping
+#endif
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief Instance of the futex sync module
+*/
+typedef struct
+{
+    tPdoSyncShm*        pSyncShm;           ///< Pointer to the sync shared memory
+    UINT32              syncCount;          ///< Value of the futex word at the last handled sync event
+    UINT32              spinCount;          ///< Current number of futex word polls before sleeping
+    UINT32              missedCycles;       ///< Number of sync events not handled since the last read
+} tPdoucalSyncInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tPdoucalSyncInstance     instance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static BOOL spinForSync(void);
+static void acknowledgeSync(void);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize PDO user CAL sync module
+
+The function initializes the PDO user CAL sync module
+
+\param  pfnSyncCb_p             Function that is called in case of sync event
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+tOplkError pdoucal_initSync(tSyncCb pfnSyncCb_p)
+{
+    int         fd;
+    void*       pMem;
+
+    UNUSED_PARAMETER(pfnSyncCb_p);
+
+    OPLK_MEMSET(&instance_l, 0, sizeof(instance_l));
+
+    if ((fd = shm_open(PDO_SYNC_SHMEM_NAME, O_RDWR | O_CREAT, S_IRWXU | S_IRWXG)) < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() shm_open failed!\n", __func__);
+        return kErrorNoResource;
+    }
+
+    if (ftruncate(fd, sizeof(tPdoSyncShm)) == -1)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() ftruncate failed!\n", __func__);
+        close(fd);
+        return kErrorNoResource;
+    }
+
+    pMem = mmap(NULL, sizeof(tPdoSyncShm), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (pMem == MAP_FAILED)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() mmap failed!\n", __func__);
+        return kErrorNoResource;
+    }
+
+    instance_l.pSyncShm = (tPdoSyncShm*)pMem;
+    instance_l.syncCount = instance_l.pSyncShm->syncCount;
+    instance_l.spinCount = CONFIG_PDOU_SYNC_SPIN_MIN;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Clean up PDO user CAL sync module
+
+The function cleans up the PDO user CAL sync module
+*/
+//------------------------------------------------------------------------------
+void pdoucal_exitSync(void)
+{
+    if (instance_l.pSyncShm != NULL)
+    {
+        munmap(instance_l.pSyncShm, sizeof(tPdoSyncShm));
+        instance_l.pSyncShm = NULL;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Wait for a sync event
+
+The function waits for a sync event. It returns immediately if a sync event
+occurred since the last call. Otherwise it spins on the futex word and sleeps
+on the futex if the sync event doesn't arrive while spinning.
+
+\param  timeout_p       Specifies a timeout in microseconds. If 0 it waits
+                        forever.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk              Successfully received sync event
+\retval kErrorGeneralError    Error while waiting on sync event
+*/
+//------------------------------------------------------------------------------
+tOplkError pdoucal_waitSyncEvent(ULONG timeout_p)
+{
+    struct timespec     timeout;
+    struct timespec*    pTimeout = NULL;
+    tPdoSyncShm*        pSyncShm = instance_l.pSyncShm;
+    int                 futexRet;
+
+    if (pSyncShm == NULL)
+        return kErrorGeneralError;
+
+    if (pSyncShm->syncCount == instance_l.syncCount)
+    {
+        if (spinForSync())
+        {
+            if (instance_l.spinCount < CONFIG_PDOU_SYNC_SPIN_MAX)
+                instance_l.spinCount <<= 1;
+        }
+        else
+        {
+            if (instance_l.spinCount > CONFIG_PDOU_SYNC_SPIN_MIN)
+                instance_l.spinCount >>= 1;
+
+            if (timeout_p != 0)
+            {
+                timeout.tv_sec = timeout_p / 1000000;
+                timeout.tv_nsec = (timeout_p % 1000000) * 1000;
+                pTimeout = &timeout;
+            }
+
+            // The full barrier of the increment orders it before the futex
+            // word is compared, see pdokcal_sendSyncEvent().
+            __sync_fetch_and_add(&pSyncShm->waiterCount, 1);
+            do
+            {
+                futexRet = syscall(SYS_futex, &pSyncShm->syncCount, FUTEX_WAIT,
+                                   instance_l.syncCount, pTimeout, NULL, 0);
+            } while ((futexRet != 0) && (errno == EINTR) &&
+                     (pSyncShm->syncCount == instance_l.syncCount));
+            __sync_fetch_and_sub(&pSyncShm->waiterCount, 1);
+
+            if (pSyncShm->syncCount == instance_l.syncCount)
+                return kErrorGeneralError;
+        }
+    }
+
+    acknowledgeSync();
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get sync file descriptor
+
+The function returns a file descriptor which is readable when a sync event
+occurred. It is not supported by this implementation.
+
+\return The function always returns -1.
+*/
+//------------------------------------------------------------------------------
+int pdoucal_getSyncFd(void)
+{
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get sync information
+
+The function acknowledges all pending sync events and returns the cycle
+counter and the time stamp of the last sync event. It also returns the number
+of sync events which were not handled since the last call.
+
+\param  pSyncInfo_p     Pointer to store the sync information.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+tOplkError pdoucal_getSyncInfo(tSyncInfo* pSyncInfo_p)
+{
+    tPdoSyncShm*        pSyncShm = instance_l.pSyncShm;
+    UINT32              sequence;
+
+    if (pSyncShm == NULL)
+        return kErrorNoResource;
+
+    if (pSyncShm->syncCount != instance_l.syncCount)
+        acknowledgeSync();
+
+    pSyncInfo_p->missedCycles = instance_l.missedCycles;
+    instance_l.missedCycles = 0;
+
+    do
+    {
+        sequence = pSyncShm->sequence;
+        OPLK_MEMBAR();
+        pSyncInfo_p->cycleCount = pSyncShm->cycleCount;
+        pSyncInfo_p->timeStamp = pSyncShm->timeStamp;
+        OPLK_MEMBAR();
+    } while (((sequence & 1) != 0) || (sequence != pSyncShm->sequence));
+
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Spin on the futex word
+
+The function polls the futex word until a sync event occurred or the current
+spin count is exhausted.
+
+\return The function returns TRUE if a sync event occurred, otherwise FALSE.
+*/
+//------------------------------------------------------------------------------
+static BOOL spinForSync(void)
+{
+    UINT32      spin;
+
+    for (spin = 0; spin < instance_l.spinCount; spin++)
+    {
+        if (instance_l.pSyncShm->syncCount != instance_l.syncCount)
+            return TRUE;
+
+#if defined(__i386__) || defined(__x86_64__)
+        __asm__ __volatile__("pause");
+#endif
+    }
+
+    return FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Acknowledge pending sync events
+
+The function marks all pending sync events as handled. All but the last one
+are counted as missed.
+*/
+//------------------------------------------------------------------------------
+static void acknowledgeSync(void)
+{
+    UINT32      syncCount;
+
+    syncCount = instance_l.pSyncShm->syncCount;
+    instance_l.missedCycles += syncCount - instance_l.syncCount - 1;
+    instance_l.syncCount = syncCount;
+}
+
+/// \}
@@ -5,7 +5,10 @@
 \brief  Sync implementation for the PDO user CAL module using Linux ioctl
 
 This file contains a sync implementation for the PDU user CAL module. It
-uses a Linux ioctl call for synchronisation.
+registers an eventfd at the openPOWERLINK Linux kernel driver, which is
+signaled on every sync event. The eventfd can be used by the application in
+its own poll() or epoll loop. The cycle counter and time stamp of the sync
+events are read from a page mapped from the driver.
 
 \ingroup module_pdoucal
 *******************************************************************************/
@@ -43,6 +46,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
 #include <time.h>
 
 #include <oplk/oplkinc.h>
@@ -68,7 +75,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // global function prototypes
 //------------------------------------------------------------------------------
 
-
 //============================================================================//
 //            P R I V A T E   D E F I N I T I O N S                           //
 //============================================================================//
@@ -84,7 +90,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
-static int              fd_l;
+static int                  fd_l;
+static int                  syncFd_l = -1;
+static tPdoSyncInfoMem*     pSyncInfo_l = NULL;
 
 //------------------------------------------------------------------------------
 // local function prototypes
@@ -107,10 +115,38 @@ The function initializes the PDO user CAL sync module
 //------------------------------------------------------------------------------
 tOplkError pdoucal_initSync(tSyncCb pfnSyncCb_p)
 {
+    void*       pMem;
+
     UNUSED_PARAMETER(pfnSyncCb_p);
 
     fd_l = ctrlucal_getFd();
+
+    if ((syncFd_l = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't create eventfd!\n", __func__);
+        return kErrorNoResource;
+    }
+
+    if (ioctl(fd_l, PLK_CMD_PDO_SYNC_EVENTFD, &syncFd_l) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't register eventfd!\n", __func__);
+        goto Exit;
+    }
+
+    pMem = mmap(NULL, sizeof(tPdoSyncInfoMem), PROT_READ, MAP_SHARED, fd_l,
+                PLK_MMAP_PGOFF_PDO_SYNC * sysconf(_SC_PAGE_SIZE));
+    if (pMem == MAP_FAILED)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() mmap of sync information failed!\n", __func__);
+        goto Exit;
+    }
+    pSyncInfo_l = (tPdoSyncInfoMem*)pMem;
+
     return kErrorOk;
+
+Exit:
+    pdoucal_exitSync();
+    return kErrorNoResource;
 }
 
 //------------------------------------------------------------------------------
@@ -122,6 +158,20 @@ The function cleans up the PDO user CAL sync module
 //------------------------------------------------------------------------------
 void pdoucal_exitSync(void)
 {
+    int         eventFd = -1;
+
+    if (pSyncInfo_l != NULL)
+    {
+        munmap(pSyncInfo_l, sizeof(tPdoSyncInfoMem));
+        pSyncInfo_l = NULL;
+    }
+
+    if (syncFd_l >= 0)
+    {
+        ioctl(fd_l, PLK_CMD_PDO_SYNC_EVENTFD, &eventFd);
+        close(syncFd_l);
+        syncFd_l = -1;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -140,17 +190,76 @@ The function waits for a sync event.
 //------------------------------------------------------------------------------
 tOplkError pdoucal_waitSyncEvent(ULONG timeout_p)
 {
-    int         ret;
+    struct pollfd   pollFd;
+    UINT64          value;
+    int             timeout;
+
+    pollFd.fd = syncFd_l;
+    pollFd.events = POLLIN;
+    timeout = (timeout_p == 0) ? -1 : (int)((timeout_p + 999) / 1000);
+
+    if (poll(&pollFd, 1, timeout) <= 0)
+        return kErrorGeneralError;
+
+    if (read(syncFd_l, &value, sizeof(value)) != sizeof(value))
+        return kErrorGeneralError;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get sync file descriptor
+
+The function returns the eventfd which is signaled on every sync event. It can
+be used in poll() or epoll. The event must be acknowledged by calling
+pdoucal_getSyncInfo() or pdoucal_waitSyncEvent().
+
+\return The function returns the file descriptor or -1 if it is not available.
+*/
+//------------------------------------------------------------------------------
+int pdoucal_getSyncFd(void)
+{
+    return syncFd_l;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get sync information
+
+The function acknowledges all pending sync events and returns the cycle
+counter and the time stamp of the last sync event. If more than one sync event
+was pending, the number of missed events is returned.
 
-    ret = ioctl(fd_l, PLK_CMD_PDO_SYNC, timeout_p);
-    if (ret == 0)
+\param  pSyncInfo_p     Pointer to store the sync information.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+tOplkError pdoucal_getSyncInfo(tSyncInfo* pSyncInfo_p)
+{
+    UINT64          value;
+    UINT32          sequence;
+
+    if (pSyncInfo_l == NULL)
+        return kErrorNoResource;
+
+    if (read(syncFd_l, &value, sizeof(value)) != sizeof(value))
+        value = 0;      // no event pending
+    pSyncInfo_p->missedCycles = (value > 1) ? (UINT32)(value - 1) : 0;
+
+    do
     {
-        return kErrorOk;
-    }
-    return kErrorGeneralError;
+        sequence = pSyncInfo_l->sequence;
+        OPLK_MEMBAR();
+        pSyncInfo_p->cycleCount = pSyncInfo_l->cycleCount;
+        pSyncInfo_p->timeStamp = pSyncInfo_l->timeStamp;
+        OPLK_MEMBAR();
+    } while (((sequence & 1) != 0) || (sequence != pSyncInfo_l->sequence));
+
+    return kErrorOk;
 }
 
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
-
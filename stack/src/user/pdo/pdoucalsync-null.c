@@ -42,6 +42,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <oplk/oplkinc.h>
 #include <common/pdo.h>
 #include <user/pdoucal.h>
+#include <common/cyclestat.h>
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -135,6 +136,40 @@ tOplkError pdoucal_waitSyncEvent(ULONG timeout_p)
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get sync file descriptor
+
+The function returns a file descriptor which is readable when a sync event
+occurred. It is not supported by this implementation.
+
+\return The function always returns -1.
+*/
+//------------------------------------------------------------------------------
+int pdoucal_getSyncFd(void)
+{
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get sync information
+
+The function returns information about the last sync events. It is not
+supported by this implementation.
+
+\param  pSyncInfo_p     Pointer to store the sync information.
+
+\return The function returns kErrorApiNotSupported.
+*/
+//------------------------------------------------------------------------------
+tOplkError pdoucal_getSyncInfo(tSyncInfo* pSyncInfo_p)
+{
+    UNUSED_PARAMETER(pSyncInfo_p);
+
+    return kErrorApiNotSupported;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Call sync callback function
@@ -148,6 +183,7 @@ tOplkError pdoucal_callSyncCb(void)
 {
     if (pfnSyncCb_l != NULL)
     {
+        CYCLESTAT_MARK_SYNC_START();
         return pfnSyncCb_l();
     }
     return kErrorOk;
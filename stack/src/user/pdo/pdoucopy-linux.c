@@ -0,0 +1,420 @@
+/**
+********************************************************************************
+\file   pdoucopy-linux.c
+
+\brief  Parallel process image copy for Linux userspace
+
+This file implements a pool of worker threads which copies the PDO channels of
+large process images in parallel. The caller of pdou_runParallelCopy() takes
+part in the copy as worker 0. The channels are split into one contiguous range
+per worker. Every worker first processes its own range and then takes the
+remaining channels of the other ranges, so an uneven distribution of the
+mapping sizes does not leave a worker waiting for the slowest one. The function
+returns after all channels are copied, i.e. the copy is complete before the
+process image is handed to the application.
+
+The workers block while no copy is running. Each worker is pinned to one CPU
+of CONFIG_THREAD_CPU_MASK_PDO_COPY, the CPUs are used round-robin. A CPU mask
+which the application sets for kThreadRolePdoCopy applies to all workers.
+
+The engine is enabled with CONFIG_PDO_PARALLEL_COPY.
+
+\ingroup module_pdou
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+#include <oplk/oplkinc.h>
+#include <user/pdou.h>
+#include <common/target.h>
+
+#if (CONFIG_PDO_PARALLEL_COPY != FALSE)
+
+#include <sched.h>
+#include <pthread.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#ifndef CONFIG_THREAD_PRIORITY_PDO_COPY
+#define CONFIG_THREAD_PRIORITY_PDO_COPY     60
+#endif
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief Channel range of a worker
+
+The structure contains the channels which are assigned to a worker. The next
+channel is taken by an atomic increment, by the worker itself and by the
+workers which have finished their own range. Every range uses its own cache
+line, because it is modified by several CPUs.
+*/
+typedef union
+{
+    struct
+    {
+        volatile UINT   next;                           ///< Next channel of the range
+        UINT            end;                            ///< End of the range (exclusive)
+    } range;
+    UINT8               aCacheLine[PDO_CACHE_LINE_SIZE];    ///< Cache line padding
+} tPdouCopyRange;
+
+/**
+\brief Parallel copy instance
+
+The structure contains the instance variables of the parallel copy engine. The
+start of a copy is signaled by incrementing the generation under the mutex.
+*/
+typedef struct
+{
+    pthread_t           aThreadId[CONFIG_PDO_PARALLEL_COPY_WORKERS];    ///< IDs of the worker threads
+    UINT                threadCount;                    ///< Number of started worker threads
+    pthread_mutex_t     mutex;                          ///< Mutex protecting the generation
+    pthread_cond_t      condition;                      ///< Condition to start the worker threads
+    UINT                generation;                     ///< Number of the current copy
+    BOOL                fStopThreads;                   ///< Flag to stop the worker threads
+    BOOL                fInitialized;                   ///< Flag determines if the engine is initialized
+    tPdouCopyChannelCb  pfnCopyChannel;                 ///< Copy function of the current copy
+    volatile UINT       pendingCount;                   ///< Number of worker threads which are still copying
+    volatile tOplkError firstError;                     ///< First error of the current copy
+    tPdouCopyRange      aRange[PDOU_PARALLEL_COPY_THREADS]; ///< Channel ranges of the workers
+} tPdouCopyInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tPdouCopyInstance    instance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void*  copyWorkerThread(void* pArg_p);
+static void   copyChannels(UINT workerIndex_p);
+static void   copyRange(tPdouCopyRange* pRange_p, UINT workerIndex_p);
+static UINT32 getWorkerCpuMask(UINT workerIndex_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize parallel copy engine
+
+The function starts the worker threads of the parallel copy engine.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+tOplkError pdou_initParallelCopy(void)
+{
+    UINT        index;
+
+    OPLK_MEMSET(&instance_l, 0, sizeof(tPdouCopyInstance));
+
+    if (pthread_mutex_init(&instance_l.mutex, NULL) != 0)
+        return kErrorNoResource;
+
+    if (pthread_cond_init(&instance_l.condition, NULL) != 0)
+    {
+        pthread_mutex_destroy(&instance_l.mutex);
+        return kErrorNoResource;
+    }
+
+    instance_l.fInitialized = TRUE;
+
+    for (index = 0; index < CONFIG_PDO_PARALLEL_COPY_WORKERS; index++)
+    {
+        // worker 0 is the calling thread
+        if (target_createThread(&instance_l.aThreadId[index], kThreadRolePdoCopy, "oplk-pdocopy",
+                                copyWorkerThread, (void*)(size_t)(index + 1)) != kErrorOk)
+        {
+            pdou_exitParallelCopy();
+            return kErrorNoResource;
+        }
+        instance_l.threadCount++;
+
+        if (target_setThreadParams(instance_l.aThreadId[index], kThreadRolePdoCopy, kThreadSchedFifo,
+                                   CONFIG_THREAD_PRIORITY_PDO_COPY,
+                                   getWorkerCpuMask(index)) != kErrorOk)
+        {
+            DEBUG_LVL_ERROR_TRACE("%s(): couldn't set thread scheduling parameters! %d\n",
+                                  __func__, CONFIG_THREAD_PRIORITY_PDO_COPY);
+        }
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Clean up parallel copy engine
+
+The function stops the worker threads of the parallel copy engine.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+void pdou_exitParallelCopy(void)
+{
+    UINT        index;
+
+    if (!instance_l.fInitialized)
+        return;
+
+    pthread_mutex_lock(&instance_l.mutex);
+    instance_l.fStopThreads = TRUE;
+    pthread_cond_broadcast(&instance_l.condition);
+    pthread_mutex_unlock(&instance_l.mutex);
+
+    for (index = 0; index < instance_l.threadCount; index++)
+        pthread_join(instance_l.aThreadId[index], NULL);
+
+    pthread_cond_destroy(&instance_l.condition);
+    pthread_mutex_destroy(&instance_l.mutex);
+    instance_l.threadCount = 0;
+    instance_l.fInitialized = FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy PDO channels in parallel
+
+The function calls the copy function for the channels 0 to channelCount_p - 1
+on the worker threads and the calling thread. It returns after all channels
+are copied. The copy function must not modify data which is shared with other
+channels, except data which is separated by the worker index.
+
+\param  pfnCopyChannel_p        Function which copies a single channel.
+\param  channelCount_p          Number of channels.
+
+\return The function returns the first error of the copy function or kErrorOk.
+
+\ingroup module_pdou
+*/
+//------------------------------------------------------------------------------
+tOplkError pdou_runParallelCopy(tPdouCopyChannelCb pfnCopyChannel_p, UINT channelCount_p)
+{
+    UINT        workerCount = instance_l.threadCount + 1;
+    UINT        index;
+
+    for (index = 0; index < workerCount; index++)
+    {
+        instance_l.aRange[index].range.next = (channelCount_p * index) / workerCount;
+        instance_l.aRange[index].range.end = (channelCount_p * (index + 1)) / workerCount;
+    }
+
+    instance_l.pfnCopyChannel = pfnCopyChannel_p;
+    instance_l.firstError = kErrorOk;
+    instance_l.pendingCount = instance_l.threadCount;
+
+    // the mutex publishes the ranges to the workers
+    pthread_mutex_lock(&instance_l.mutex);
+    instance_l.generation++;
+    pthread_cond_broadcast(&instance_l.condition);
+    pthread_mutex_unlock(&instance_l.mutex);
+
+    copyChannels(0);
+
+    while (instance_l.pendingCount != 0)
+        sched_yield();
+
+    // read the results of the workers after their completion
+    OPLK_MEMBAR();
+    return instance_l.firstError;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Parallel copy worker thread
+
+The function contains the main loop of a worker thread. It waits for the start
+of a copy, copies channels until all ranges are empty and signals its
+completion.
+
+\param  pArg_p                  Index of the worker.
+
+\return The function returns the thread exit code.
+*/
+//------------------------------------------------------------------------------
+static void* copyWorkerThread(void* pArg_p)
+{
+    UINT        workerIndex = (UINT)(size_t)pArg_p;
+    UINT        generation = 0;     // a copy may already be started before the thread runs
+
+    pthread_mutex_lock(&instance_l.mutex);
+
+    for (;;)
+    {
+        while (!instance_l.fStopThreads && (instance_l.generation == generation))
+            pthread_cond_wait(&instance_l.condition, &instance_l.mutex);
+
+        if (instance_l.fStopThreads)
+            break;
+
+        generation = instance_l.generation;
+        pthread_mutex_unlock(&instance_l.mutex);
+
+        copyChannels(workerIndex);
+
+        // publish the copied data before the completion
+        OPLK_MEMBAR();
+        __sync_sub_and_fetch(&instance_l.pendingCount, 1);
+
+        pthread_mutex_lock(&instance_l.mutex);
+    }
+
+    pthread_mutex_unlock(&instance_l.mutex);
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy the channels of all ranges
+
+The function copies the channels of the own range first and then takes the
+remaining channels of the following ranges.
+
+\param  workerIndex_p           Index of the worker.
+*/
+//------------------------------------------------------------------------------
+static void copyChannels(UINT workerIndex_p)
+{
+    UINT        workerCount = instance_l.threadCount + 1;
+    UINT        offset;
+
+    for (offset = 0; offset < workerCount; offset++)
+        copyRange(&instance_l.aRange[(workerIndex_p + offset) % workerCount], workerIndex_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Copy the remaining channels of a range
+
+\param  pRange_p                Range to copy.
+\param  workerIndex_p           Index of the worker.
+*/
+//------------------------------------------------------------------------------
+static void copyRange(tPdouCopyRange* pRange_p, UINT workerIndex_p)
+{
+    UINT            channelId;
+    tOplkError      ret;
+
+    for (;;)
+    {
+        channelId = __sync_fetch_and_add(&pRange_p->range.next, 1);
+        if (channelId >= pRange_p->range.end)
+            break;
+
+        ret = instance_l.pfnCopyChannel(channelId, workerIndex_p);
+        if (ret != kErrorOk)
+            __sync_bool_compare_and_swap(&instance_l.firstError, kErrorOk, ret);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the CPU of a worker thread
+
+The function selects one CPU of CONFIG_THREAD_CPU_MASK_PDO_COPY for a worker.
+The CPUs of the mask are assigned round-robin.
+
+\param  workerIndex_p           Index of the worker thread (0 = first thread).
+
+\return The function returns the CPU affinity mask of the worker thread. It is
+        0 if CONFIG_THREAD_CPU_MASK_PDO_COPY is 0.
+*/
+//------------------------------------------------------------------------------
+static UINT32 getWorkerCpuMask(UINT workerIndex_p)
+{
+    UINT32      cpuMask = CONFIG_THREAD_CPU_MASK_PDO_COPY;
+    UINT32      cpuBit;
+    UINT        cpuCount = 0;
+    UINT        cpuIndex;
+
+    for (cpuBit = 1; cpuBit != 0; cpuBit <<= 1)
+    {
+        if ((cpuMask & cpuBit) != 0)
+            cpuCount++;
+    }
+
+    if (cpuCount == 0)
+        return 0;
+
+    cpuIndex = workerIndex_p % cpuCount;
+    for (cpuBit = 1; cpuBit != 0; cpuBit <<= 1)
+    {
+        if ((cpuMask & cpuBit) == 0)
+            continue;
+
+        if (cpuIndex == 0)
+            break;
+        cpuIndex--;
+    }
+
+    return cpuBit;
+}
+
+/// \}
+
+#endif // CONFIG_PDO_PARALLEL_COPY != FALSE
@@ -77,10 +77,18 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // local types
 //------------------------------------------------------------------------------
 
+// connection index of the node ID lookup table, as small as the connection count allows
+#if (CONFIG_SDO_MAX_CONNECTION_ASND < 0x100)
+typedef UINT8 tSdoAsndConIndex;
+#else
+typedef UINT16 tSdoAsndConIndex;
+#endif
+
 // instance table
 typedef struct
 {
     UINT                aSdoAsndConnection[CONFIG_SDO_MAX_CONNECTION_ASND];
+    tSdoAsndConIndex    aNodeIdToCon[256];  ///< Connection index of each node ID (checked against aSdoAsndConnection)
     tSequLayerReceiveCb pfnSdoAsySeqCb;
 } tSdoAsndInstance;
 
@@ -231,6 +239,7 @@ tOplkError sdoasnd_initCon(tSdoConHdl* pSdoConHandle_p, UINT targetNodeId_p)
     {
         pConnection = &sdoAsndInstance_l.aSdoAsndConnection[freeCon];
         *pConnection = targetNodeId_p;
+        sdoAsndInstance_l.aNodeIdToCon[targetNodeId_p] = (tSdoAsndConIndex)freeCon;
         // save handle for higher layer
         *pSdoConHandle_p = (freeCon | SDO_ASND_HANDLE);
     }
@@ -347,21 +356,31 @@ tOplkError sdoAsndCb(tFrameInfo* pFrameInfo_p)
     pFrame = pFrameInfo_p->pFrame;
     nodeId = ami_getUint8Le(&pFrame->srcNodeId);
 
-    // search corresponding entry in control structure
-    count = 0;
-    pConnection = &sdoAsndInstance_l.aSdoAsndConnection[0];
-    while (count < CONFIG_SDO_MAX_CONNECTION_ASND)
+    // look up the connection of the node, search the control structure only
+    // if the node has no known connection
+    count = sdoAsndInstance_l.aNodeIdToCon[nodeId];
+    if ((count >= CONFIG_SDO_MAX_CONNECTION_ASND) ||
+        (sdoAsndInstance_l.aSdoAsndConnection[count] != nodeId))
     {
-        if (nodeId == *pConnection)
+        // search corresponding entry in control structure
+        count = 0;
+        pConnection = &sdoAsndInstance_l.aSdoAsndConnection[0];
+        while (count < CONFIG_SDO_MAX_CONNECTION_ASND)
         {
-            break;
+            if (nodeId == *pConnection)
+            {
+                break;
+            }
+            else if ((*pConnection == 0) && (freeEntry == 0xFFFF))
+            {   // free entry
+                freeEntry = count;
+            }
+            count++;
+            pConnection++;
         }
-        else if ((*pConnection == 0) && (freeEntry == 0xFFFF))
-        {   // free entry
-            freeEntry = count;
-        }
-        count++;
-        pConnection++;
+
+        if (count < CONFIG_SDO_MAX_CONNECTION_ASND)
+            sdoAsndInstance_l.aNodeIdToCon[nodeId] = (tSdoAsndConIndex)count;
     }
 
     if (count == CONFIG_SDO_MAX_CONNECTION_ASND)
@@ -370,6 +389,7 @@ tOplkError sdoAsndCb(tFrameInfo* pFrameInfo_p)
         {
             pConnection = &sdoAsndInstance_l.aSdoAsndConnection[freeEntry];
             *pConnection = nodeId;
+            sdoAsndInstance_l.aNodeIdToCon[nodeId] = (tSdoAsndConIndex)freeEntry;
             count = freeEntry;
         }
         else
@@ -41,6 +41,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <common/ami.h>
+#include <common/target.h>
 #include <user/sdocom.h>
 
 #if !defined(CONFIG_INCLUDE_SDOS) && !defined(CONFIG_INCLUDE_SDOC)
@@ -59,6 +60,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_SDO_MAX_CONNECTION_COM         5
 #endif
 
+// Size of the hash table which maps sequence layer connection handles to
+// command layer connections
+#ifndef CONFIG_SDO_COM_CON_HASH_SIZE
+#define CONFIG_SDO_COM_CON_HASH_SIZE          CONFIG_SDO_MAX_CONNECTION_COM
+#endif
+
 //------------------------------------------------------------------------------
 // module global vars
 //------------------------------------------------------------------------------
@@ -74,6 +81,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#define SDO_COM_CON_HASH(sdoSeqConHdl_p)    (((sdoSeqConHdl_p) & ~SDO_SEQ_HANDLE_MASK) % CONFIG_SDO_COM_CON_HASH_SIZE)
+#define SDO_COM_CON_END                     CONFIG_SDO_MAX_CONNECTION_COM           // end of hash chain
+#define SDO_COM_CON_UNLINKED                (CONFIG_SDO_MAX_CONNECTION_COM + 1)     // connection is not in the hash table
 
 //------------------------------------------------------------------------------
 // local types
@@ -127,6 +137,9 @@ typedef enum
     kSdoComStateIdle                = 0x00, ///< Idle state
 #if defined(CONFIG_INCLUDE_SDOS)
     kSdoComStateServerSegmTrans     = 0x01, ///< Client: Send following frames
+#if (CONFIG_SDO_SERVER_ASYNC != FALSE)
+    kSdoComStateServerObdAccess     = 0x02, ///< Server: Wait for the OD access of a worker thread
+#endif
 #endif
 #if defined(CONFIG_INCLUDE_SDOC)
     kSdoComStateClientWaitInit      = 0x10, ///< Server: Wait for init connection on lower layer
@@ -152,12 +165,25 @@ typedef struct
     UINT8*              pData;              ///< Pointer to data
     UINT                transferSize;       ///< Number of bytes to transfer
     UINT                transferredBytes;   ///< Number of bytes already transferred
+    UINT                maxSegmentSize;     ///< Maximum segment size of the current transfer
+    UINT32              startTickCount;     ///< Tick count in ms at the start of the transfer
     tSdoFinishedCb      pfnTransferFinished;///< Callback function to be called in the end of the SDO transfer
     void*               pUserArg;           ///< User definable argument pointer
     UINT32              lastAbortCode;      ///< Last abort code
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    tObdDomainStream*   pStream;            ///< Stream of the transferred domain (NULL = transfer from/to pData)
+#endif
+#if defined(CONFIG_INCLUDE_SDOS)
+    tObdSegmentedWrite  segmWrite;          ///< Segmented download into the object data
+#endif
 #if defined(CONFIG_INCLUDE_SDOC)
     UINT                targetIndex;        ///< Object Index to access
     UINT                targetSubIndex;     ///< Object subindex to access
+    tSdoMultiAccEntry*  paMultiEntry;       ///< Entries of a multiple parameter transfer
+    UINT                multiEntryCount;    ///< Number of entries of a multiple parameter transfer
+    tSdoScatterEntry*   pScatterEntry;      ///< Next entry of the scatter list of a read (NULL = read into pData)
+    UINT                scatterEntryCount;  ///< Number of remaining entries of the scatter list
+    UINT                scatterSize;        ///< Remaining size of the scatter list entry at pData
 #endif
 } tSdoComCon;
 
@@ -169,6 +195,9 @@ This structure describes a SDO command layer instance
 typedef struct
 {
     tSdoComCon          sdoComCon[CONFIG_SDO_MAX_CONNECTION_COM]; ///< Array to store command layer connections
+    tSdoComConHdl       aConHashHead[CONFIG_SDO_COM_CON_HASH_SIZE]; ///< First connection of each hash chain
+    tSdoComConHdl       aConHashNext[CONFIG_SDO_MAX_CONNECTION_COM]; ///< Next connection in the hash chain (ordered by handle)
+    UINT                aConHashBucket[CONFIG_SDO_MAX_CONNECTION_COM]; ///< Hash chain the connection is entered in
 #if defined(WIN32) || defined(_WIN32)
     LPCRITICAL_SECTION  pCriticalSection;
     CRITICAL_SECTION    criticalSection;
@@ -186,12 +215,18 @@ static tSdoComInstance sdoComInstance_l;
 static tOplkError receiveCb(tSdoSeqConHdl sdoSeqConHdl_p, tAsySdoCom* pSdoCom_p, UINT dataSize_p);
 static tOplkError conStateChangeCb(tSdoSeqConHdl sdoSeqConHdl_p, tAsySdoConState sdoConnectionState_p);
 static tOplkError searchConnection(tSdoSeqConHdl sdoSeqConHdl_p, tSdoComConEvent sdoComConEvent_p, tAsySdoCom* pSdoCom_p);
+static void       linkConnection(tSdoComConHdl sdoComConHdl_p);
+static void       unlinkConnection(tSdoComConHdl sdoComConHdl_p);
 static tOplkError processState(tSdoComConHdl sdoComConHdl_p, tSdoComConEvent SdoComConEvent_p,
                                tAsySdoCom* pSdoCom_p);
 static tOplkError processStateIdle(tSdoComConHdl sdoComConHdl_p, tSdoComConEvent sdoComConEvent_p,
                             tAsySdoCom* pRecvdCmdLayer_p);
 static tOplkError processStateServerSegmTrans(tSdoComConHdl sdoComConHdl_p, tSdoComConEvent sdoComConEvent_p,
                                               tAsySdoCom* pRecvdCmdLayer_p);
+#if (CONFIG_SDO_SERVER_ASYNC != FALSE)
+static tOplkError processStateServerObdAccess(tSdoComConHdl sdoComConHdl_p, tSdoComConEvent sdoComConEvent_p,
+                                              tAsySdoCom* pRecvdCmdLayer_p);
+#endif
 static tOplkError processStateClientWaitInit(tSdoComConHdl sdoComConHdl_p, tSdoComConEvent sdoComConEvent_p,
                                              tAsySdoCom* pRecvdCmdLayer_p);
 static tOplkError processStateClientConnected(tSdoComConHdl sdoComConHdl_p, tSdoComConEvent sdoComConEvent_p,
@@ -200,18 +235,38 @@ static tOplkError processStateClientSegmTransfer(tSdoComConHdl sdoComConHdl_p, t
                                                  tAsySdoCom* pRecvdCmdLayer_p);
 static tOplkError transferFinished(tSdoComConHdl sdoComConHdl_p, tSdoComCon* pSdoComCon_p,
                                    tSdoComConState sdoComConState_p);
+static UINT       getMaxSegmentSize(void);
+static tOplkError readObjectData(tSdoComCon* pSdoComCon_p, UINT offset_p, void* pDstData_p, UINT size_p);
+static tOplkError writeObjectData(tSdoComCon* pSdoComCon_p, UINT offset_p, const void* pSrcData_p, UINT size_p);
+static void       finishStream(tSdoComCon* pSdoComCon_p, BOOL fAbort_p);
 
 #if defined (CONFIG_INCLUDE_SDOS)
 static tOplkError serverInitReadByIndex(tSdoComCon* pSdoComCon_p, tAsySdoCom* pSdoCom_p);
 static tOplkError serverSendFrame(tSdoComCon* pSdoComCon_p, UINT index_p,
                                   UINT subIndex_p, tSdoComSendType sendType_p);
 static tOplkError serverInitWriteByIndex(tSdoComCon* pSdoComCon_p, tAsySdoCom* pSdoCom_p);
+static tOplkError serverInitReadMultiByIndex(tSdoComCon* pSdoComCon_p, tAsySdoCom* pSdoCom_p);
+static tOplkError serverInitWriteMultiByIndex(tSdoComCon* pSdoComCon_p, tAsySdoCom* pSdoCom_p);
+static tOplkError serverSendMultiFrame(tSdoComCon* pSdoComCon_p, tPlkFrame* pFrame_p, UINT dataSize_p);
+static UINT32     getAccessAbortCode(UINT index_p, UINT subIndex_p, BOOL fWrite_p);
+static UINT32     getWriteAbortCode(tOplkError error_p);
+static UINT32     finishObjectWrite(tSdoComCon* pSdoComCon_p);
+#if (CONFIG_SDO_SERVER_ASYNC != FALSE)
+static tOplkError deferObdAccess(tSdoComCon* pSdoComCon_p, UINT index_p, UINT subIndex_p,
+                                 BOOL fWrite_p, const void* pSrcData_p, UINT size_p);
+static tOplkError serverSendObdAccessResult(tSdoComCon* pSdoComCon_p, const tSdoComObdAccess* pObdAccess_p);
+#endif
 #endif
 
 #if defined(CONFIG_INCLUDE_SDOC)
 static tOplkError clientSend(tSdoComCon* pSdoComCon_p);
 static tOplkError clientProcessFrame(tSdoComConHdl sdoComConHdl_p, tAsySdoCom* pSdoCom_p);
 static tOplkError clientSendAbort(tSdoComCon* pSdoComCon_p, UINT32 abortCode_p);
+static UINT       clientBuildMultiRequest(tSdoComCon* pSdoComCon_p, UINT8* pPayload_p);
+static void       clientProcessMultiResponse(tSdoComCon* pSdoComCon_p, tAsySdoCom* pSdoCom_p);
+static tSdoMultiAccEntry* findMultiEntry(tSdoComCon* pSdoComCon_p, UINT* pEntryIndex_p,
+                                         UINT index_p, UINT subIndex_p);
+static tOplkError writeScatterData(tSdoComCon* pSdoComCon_p, const void* pSrcData_p, UINT size_p);
 #endif
 
 //============================================================================//
@@ -247,14 +302,30 @@ The function adds an instance of the command layer module.
 //------------------------------------------------------------------------------
 tOplkError sdocom_addInstance(void)
 {
-    tOplkError ret = kErrorOk;
+    tOplkError  ret = kErrorOk;
+    UINT        index;
 
     OPLK_MEMSET(&sdoComInstance_l, 0x00, sizeof(sdoComInstance_l));
 
+    for (index = 0; index < CONFIG_SDO_COM_CON_HASH_SIZE; index++)
+        sdoComInstance_l.aConHashHead[index] = SDO_COM_CON_END;
+
+    for (index = 0; index < CONFIG_SDO_MAX_CONNECTION_COM; index++)
+        sdoComInstance_l.aConHashNext[index] = SDO_COM_CON_UNLINKED;
+
     ret = sdoseq_addInstance(receiveCb, conStateChangeCb);
     if (ret != kErrorOk)
         return ret;
 
+#if defined(CONFIG_INCLUDE_SDOS) && (CONFIG_SDO_SERVER_ASYNC != FALSE)
+    ret = sdocom_initObdWorkers();
+    if (ret != kErrorOk)
+    {
+        sdoseq_delInstance();
+        return ret;
+    }
+#endif
+
 #if defined(WIN32) || defined(_WIN32)
     sdoComInstance_l.pCriticalSection = &sdoComInstance_l.criticalSection;
     InitializeCriticalSection(sdoComInstance_l.pCriticalSection);
@@ -277,6 +348,9 @@ tOplkError sdocom_delInstance(void)
 {
     tOplkError  ret = kErrorOk;
 
+#if defined(CONFIG_INCLUDE_SDOS) && (CONFIG_SDO_SERVER_ASYNC != FALSE)
+    sdocom_exitObdWorkers();
+#endif
 #if defined(WIN32) || defined(_WIN32)
     DeleteCriticalSection(sdoComInstance_l.pCriticalSection);
 #endif
@@ -284,6 +358,79 @@ tOplkError sdocom_delInstance(void)
     return ret;
 }
 
+#if defined(CONFIG_INCLUDE_SDOS) && (CONFIG_SDO_SERVER_ASYNC != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Process events of the SDO command layer
+
+The function processes the events posted to the SDO command layer. The worker
+threads post kEventTypeSdoObdAccessDone when a deferred OD access is finished,
+the response to the request is sent from the event thread. Results of
+connections which were closed or aborted meanwhile are discarded.
+
+\param  pEvent_p                Event to process.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_sdo_com
+*/
+//------------------------------------------------------------------------------
+tOplkError sdocom_processEvent(tEvent* pEvent_p)
+{
+    tOplkError              ret = kErrorOk;
+    const tSdoComObdAccess* pObdAccess;
+    tSdoComCon*             pSdoComCon;
+    UINT32                  abortCode;
+
+    if ((pEvent_p->eventType != kEventTypeSdoObdAccessDone) ||
+        (pEvent_p->eventArgSize != sizeof(tSdoComObdAccess)))
+        return kErrorInvalidEvent;
+
+    pObdAccess = (const tSdoComObdAccess*)pEvent_p->pEventArg;
+    if (pObdAccess->sdoComConHdl >= CONFIG_SDO_MAX_CONNECTION_COM)
+        return kErrorSdoComInvalidHandle;
+
+    pSdoComCon = &sdoComInstance_l.sdoComCon[pObdAccess->sdoComConHdl];
+    if ((pSdoComCon->sdoComState != kSdoComStateServerObdAccess) ||
+        (pSdoComCon->sdoSeqConHdl != pObdAccess->sdoSeqConHdl) ||
+        (pSdoComCon->transactionId != pObdAccess->transactionId))
+        return kErrorOk;    // request is obsolete
+
+    pSdoComCon->sdoComState = kSdoComStateIdle;
+    pSdoComCon->lastAbortCode = 0;
+
+    if (pObdAccess->fWrite)
+    {
+        abortCode = getWriteAbortCode(pObdAccess->result);
+        if (abortCode != 0)
+        {
+            pSdoComCon->pData = (UINT8*)&abortCode;
+            ret = serverSendFrame(pSdoComCon, pObdAccess->index, pObdAccess->subIndex, kSdoComSendTypeAbort);
+        }
+        else
+        {
+            ret = serverSendFrame(pSdoComCon, 0, 0, kSdoComSendTypeAckRes);
+        }
+    }
+    else
+    {
+        if (pObdAccess->result != kErrorOk)
+        {
+            abortCode = SDO_AC_GENERAL_ERROR;
+            pSdoComCon->pData = (UINT8*)&abortCode;
+            ret = serverSendFrame(pSdoComCon, pObdAccess->index, pObdAccess->subIndex, kSdoComSendTypeAbort);
+        }
+        else
+        {
+            ret = serverSendObdAccessResult(pSdoComCon, pObdAccess);
+        }
+    }
+
+    pSdoComCon->transferSize = 0;
+    return ret;
+}
+#endif
+
 #if defined(CONFIG_INCLUDE_SDOC)
 //------------------------------------------------------------------------------
 /**
@@ -369,6 +516,8 @@ tOplkError sdocom_defineConnection(tSdoComConHdl* pSdoComConHdl_p, UINT targetNo
             break;
     }
 
+    linkConnection(freeHdl);
+
     ret = processState(freeHdl, kSdoComConEventInitCon, NULL);
     return ret;
 }
@@ -392,8 +541,24 @@ tOplkError sdocom_initTransferByIndex(tSdoComTransParamByIndex* pSdoComTransPara
     tSdoComCon*     pSdoComCon;
 
     if ((pSdoComTransParam_p->subindex >= 0xFF) || (pSdoComTransParam_p->index == 0) ||
-        (pSdoComTransParam_p->index > 0xFFFF) || (pSdoComTransParam_p->pData == NULL) ||
-        (pSdoComTransParam_p->dataSize == 0))
+        (pSdoComTransParam_p->index > 0xFFFF) || (pSdoComTransParam_p->dataSize == 0))
+        return kErrorSdoComInvalidParam;
+
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    if ((pSdoComTransParam_p->pData == NULL) && (pSdoComTransParam_p->pStream == NULL) &&
+        (pSdoComTransParam_p->paScatterList == NULL))
+        return kErrorSdoComInvalidParam;
+#else
+    if (((pSdoComTransParam_p->pData == NULL) && (pSdoComTransParam_p->paScatterList == NULL)) ||
+        (pSdoComTransParam_p->pStream != NULL))
+        return kErrorSdoComInvalidParam;
+#endif
+
+    // a scatter list can only receive the data of a read
+    if ((pSdoComTransParam_p->paScatterList != NULL) &&
+        ((pSdoComTransParam_p->scatterEntryCount == 0) ||
+         (pSdoComTransParam_p->sdoAccessType != kSdoAccessTypeRead) ||
+         (pSdoComTransParam_p->pData != NULL) || (pSdoComTransParam_p->pStream != NULL)))
         return kErrorSdoComInvalidParam;
 
     if (pSdoComTransParam_p->sdoComConHdl >= CONFIG_SDO_MAX_CONNECTION_COM)
@@ -425,13 +590,134 @@ tOplkError sdocom_initTransferByIndex(tSdoComTransParamByIndex* pSdoComTransPara
     pSdoComCon->pData = pSdoComTransParam_p->pData;             // save pointer to data
     pSdoComCon->transferSize = pSdoComTransParam_p->dataSize;   // maximal bytes to transfer
     pSdoComCon->transferredBytes = 0;                           // bytes already transfered
+    pSdoComCon->pScatterEntry = pSdoComTransParam_p->paScatterList;
+    pSdoComCon->scatterEntryCount = pSdoComTransParam_p->scatterEntryCount;
+    pSdoComCon->scatterSize = 0;
 
     pSdoComCon->lastAbortCode = 0;
     pSdoComCon->sdoTransferType = kSdoTransAuto;
+    pSdoComCon->maxSegmentSize = getMaxSegmentSize();
+    pSdoComCon->startTickCount = target_getTickCount();
 
     pSdoComCon->targetIndex = pSdoComTransParam_p->index;
     pSdoComCon->targetSubIndex = pSdoComTransParam_p->subindex;
 
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    pSdoComCon->pStream = pSdoComTransParam_p->pStream;
+    if (pSdoComCon->pStream != NULL)
+    {
+        ret = pSdoComCon->pStream->pfnAccess(pSdoComCon->pStream->pArg, kObdDomainStreamOpen, 0,
+                                             NULL, pSdoComCon->transferSize);
+        if (ret != kErrorOk)
+        {
+            pSdoComCon->pStream = NULL;
+            pSdoComCon->transferSize = 0;
+            return ret;
+        }
+    }
+#endif
+
+    ret = processState(pSdoComTransParam_p->sdoComConHdl, kSdoComConEventSendFirst, NULL);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize a multiple parameter transfer by index command
+
+The function initializes a Read or Write Multiple Parameter by Index transfer.
+All entries are transferred with a single expedited command, therefore the
+command must fit into one segment. The result of every entry is stored in the
+entry array when the transfer is finished.
+
+\param  pSdoComTransParam_p     Pointer to transfer command parameters
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_sdo_com
+*/
+//------------------------------------------------------------------------------
+tOplkError sdocom_initTransferMultiByIndex(tSdoComTransParamMultiByIndex* pSdoComTransParam_p)
+{
+    tOplkError          ret;
+    tSdoComCon*         pSdoComCon;
+    tSdoMultiAccEntry*  pEntry;
+    UINT                entry;
+    UINT                requestSize;
+
+    if ((pSdoComTransParam_p->paEntries == NULL) || (pSdoComTransParam_p->entryCount == 0))
+        return kErrorSdoComInvalidParam;
+
+    if (pSdoComTransParam_p->sdoComConHdl >= CONFIG_SDO_MAX_CONNECTION_COM)
+        return kErrorSdoComInvalidHandle;
+
+    // get pointer to control structure of connection
+    pSdoComCon = &sdoComInstance_l.sdoComCon[pSdoComTransParam_p->sdoComConHdl];
+
+    if (pSdoComCon->sdoSeqConHdl == 0)
+        return kErrorSdoComInvalidHandle;
+
+    // check if command layer is idle
+    if ((pSdoComCon->transferredBytes + pSdoComCon->transferSize) > 0)
+        return kErrorSdoComHandleBusy;
+
+    requestSize = 0;
+    for (entry = 0; entry < pSdoComTransParam_p->entryCount; entry++)
+    {
+        pEntry = &pSdoComTransParam_p->paEntries[entry];
+        if ((pEntry->subindex >= 0xFF) || (pEntry->index == 0) || (pEntry->index > 0xFFFF) ||
+            (pEntry->pData == NULL) || (pEntry->dataSize == 0))
+            return kErrorSdoComInvalidParam;
+
+        if (pSdoComTransParam_p->sdoAccessType == kSdoAccessTypeRead)
+            requestSize += SDO_CMDL_HDR_MULTI_READ_SIZE;
+        else
+            requestSize += SDO_MULTI_SUBBLOCK_SIZE(pEntry->dataSize);
+    }
+
+    // the command must fit into a single segment
+    pSdoComCon->maxSegmentSize = getMaxSegmentSize();
+    if (requestSize > pSdoComCon->maxSegmentSize)
+        return kErrorSdoComInvalidParam;
+
+    for (entry = 0; entry < pSdoComTransParam_p->entryCount; entry++)
+    {   // entries which are not answered by a read response are reported as failed
+        pSdoComTransParam_p->paEntries[entry].abortCode =
+            (pSdoComTransParam_p->sdoAccessType == kSdoAccessTypeRead) ? SDO_AC_GENERAL_ERROR : 0;
+    }
+
+    // callback function for end of transfer
+    pSdoComCon->pfnTransferFinished = pSdoComTransParam_p->pfnSdoFinishedCb;
+    pSdoComCon->pUserArg = pSdoComTransParam_p->pUserArg;
+
+    if (pSdoComTransParam_p->sdoAccessType == kSdoAccessTypeRead)
+    {
+        pSdoComCon->sdoServiceType = kSdoServiceReadMultiByIndex;
+    }
+    else
+    {
+        pSdoComCon->sdoServiceType = kSdoServiceWriteMultiByIndex;
+    }
+
+    pSdoComCon->pData = NULL;
+    pSdoComCon->pScatterEntry = NULL;
+    pSdoComCon->transferSize = requestSize;                     // size of the command
+    pSdoComCon->transferredBytes = 0;
+
+    pSdoComCon->lastAbortCode = 0;
+    pSdoComCon->sdoTransferType = kSdoTransExpedited;
+    pSdoComCon->startTickCount = target_getTickCount();
+
+    pSdoComCon->targetIndex = pSdoComTransParam_p->paEntries[0].index;
+    pSdoComCon->targetSubIndex = pSdoComTransParam_p->paEntries[0].subindex;
+    pSdoComCon->paMultiEntry = pSdoComTransParam_p->paEntries;
+    pSdoComCon->multiEntryCount = pSdoComTransParam_p->entryCount;
+
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    pSdoComCon->pStream = NULL;
+#endif
+
     ret = processState(pSdoComTransParam_p->sdoComConHdl, kSdoComConEventSendFirst, NULL);
 
     return ret;
@@ -481,6 +767,8 @@ tOplkError sdocom_undefineConnection(tSdoComConHdl sdoComConHdl_p)
         }
     }
 
+    finishStream(pSdoComCon, TRUE);
+    unlinkConnection(sdoComConHdl_p);
     OPLK_MEMSET(pSdoComCon, 0x00, sizeof(tSdoComCon));
     return ret;
 }
@@ -519,9 +807,11 @@ tOplkError sdocom_getState(tSdoComConHdl sdoComConHdl_p, tSdoComFinished* pSdoCo
     pSdoComFinished_p->targetIndex = pSdoComCon->targetIndex;
     pSdoComFinished_p->targetSubIndex = pSdoComCon->targetSubIndex;
     pSdoComFinished_p->transferredBytes = pSdoComCon->transferredBytes;
+    pSdoComFinished_p->transferTimeMs = target_getTickCount() - pSdoComCon->startTickCount;
     pSdoComFinished_p->abortCode = pSdoComCon->lastAbortCode;
     pSdoComFinished_p->sdoComConHdl = sdoComConHdl_p;
-    if (pSdoComCon->sdoServiceType == kSdoServiceWriteByIndex)
+    if ((pSdoComCon->sdoServiceType == kSdoServiceWriteByIndex) ||
+        (pSdoComCon->sdoServiceType == kSdoServiceWriteMultiByIndex))
     {
         pSdoComFinished_p->sdoAccessType = kSdoAccessTypeWrite;
     }
@@ -725,7 +1015,15 @@ static tOplkError conStateChangeCb(tSdoSeqConHdl sdoSeqConHdl_p,
 /**
 \brief  Search a connection
 
-The function searches for an SDO sequence layer connection.
+The function searches for the command layer connections which use an SDO
+sequence layer connection and processes the event for each of them. The
+connections are looked up in the connection hash table. If no connection is
+found in the hash table, the connection array is searched for connections
+which are not entered in the matching hash chain. This happens if the
+sequence layer reported an event while the connection was being defined, or
+if the sequence layer connection of a client connection was reinitialized.
+These connections are entered again. If no connection exists, a new server
+connection is created.
 
 \param  sdoSeqConHdl_p          Handle of the SDO sequence layer connection.
 \param  sdoComConEvent_p        Event to process for found connection.
@@ -740,18 +1038,39 @@ static tOplkError searchConnection(tSdoSeqConHdl sdoSeqConHdl_p, tSdoComConEvent
     tOplkError          ret;
     tSdoComCon*         pSdoComCon;
     tSdoComConHdl       hdlCount;
+    tSdoComConHdl       hdlNext;
     tSdoComConHdl       hdlFree;
 
     ret = kErrorSdoComNotResponsible;
 
+    // process event for all connections in the hash chain
+    hdlCount = sdoComInstance_l.aConHashHead[SDO_COM_CON_HASH(sdoSeqConHdl_p)];
+    while (hdlCount < CONFIG_SDO_MAX_CONNECTION_COM)
+    {
+        // the connection could be removed from the chain while processing
+        hdlNext = sdoComInstance_l.aConHashNext[hdlCount];
+        if (sdoComInstance_l.sdoComCon[hdlCount].sdoSeqConHdl == sdoSeqConHdl_p)
+        {   // matching command layer handle found
+            ret = processState(hdlCount, sdoComConEvent_p, pSdoCom_p);
+        }
+        hdlCount = hdlNext;
+    }
+
+    if (ret != kErrorSdoComNotResponsible)
+        return ret;
+
     // get pointer to first element of the array
     pSdoComCon = &sdoComInstance_l.sdoComCon[0];
     hdlCount = 0;
     hdlFree = 0xFFFF;
     while (hdlCount < CONFIG_SDO_MAX_CONNECTION_COM)
     {
-        if (pSdoComCon->sdoSeqConHdl == sdoSeqConHdl_p)
-        {   // matching command layer handle found
+        if ((pSdoComCon->sdoSeqConHdl == sdoSeqConHdl_p) &&
+            ((sdoComInstance_l.aConHashNext[hdlCount] == SDO_COM_CON_UNLINKED) ||
+             (sdoComInstance_l.aConHashBucket[hdlCount] != SDO_COM_CON_HASH(sdoSeqConHdl_p))))
+        {   // matching command layer handle found which is not in the hash chain
+            unlinkConnection(hdlCount);
+            linkConnection(hdlCount);
             ret = processState(hdlCount, sdoComConEvent_p, pSdoCom_p);
         }
         else if ((pSdoComCon->sdoSeqConHdl == 0) &&(hdlFree == 0xFFFF))
@@ -776,12 +1095,72 @@ static tOplkError searchConnection(tSdoSeqConHdl sdoSeqConHdl_p, tSdoComConEvent
             hdlCount = hdlFree;
             pSdoComCon = &sdoComInstance_l.sdoComCon[hdlCount];
             pSdoComCon->sdoSeqConHdl = sdoSeqConHdl_p;
+            linkConnection(hdlCount);
             ret = processState(hdlCount, sdoComConEvent_p, pSdoCom_p);
         }
     }
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Enter connection in hash table
+
+The function enters a command layer connection in the hash chain of its
+sequence layer connection handle. The chain is ordered by the command layer
+handles, so the connections are processed in the same order as in the
+connection array. The function does nothing if the connection is already
+entered.
+
+\param  sdoComConHdl_p          Handle of the command layer connection.
+*/
+//------------------------------------------------------------------------------
+static void linkConnection(tSdoComConHdl sdoComConHdl_p)
+{
+    tSdoComConHdl*      pHdl;
+    UINT                bucket;
+
+    if (sdoComInstance_l.aConHashNext[sdoComConHdl_p] != SDO_COM_CON_UNLINKED)
+        return;
+
+    bucket = SDO_COM_CON_HASH(sdoComInstance_l.sdoComCon[sdoComConHdl_p].sdoSeqConHdl);
+    sdoComInstance_l.aConHashBucket[sdoComConHdl_p] = bucket;
+    pHdl = &sdoComInstance_l.aConHashHead[bucket];
+    while ((*pHdl < CONFIG_SDO_MAX_CONNECTION_COM) && (*pHdl < sdoComConHdl_p))
+        pHdl = &sdoComInstance_l.aConHashNext[*pHdl];
+
+    sdoComInstance_l.aConHashNext[sdoComConHdl_p] = *pHdl;
+    *pHdl = sdoComConHdl_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Remove connection from hash table
+
+The function removes a command layer connection from the hash chain it was
+entered in. The sequence layer connection handle of the connection may have
+changed in the meantime.
+
+\param  sdoComConHdl_p          Handle of the command layer connection.
+*/
+//------------------------------------------------------------------------------
+static void unlinkConnection(tSdoComConHdl sdoComConHdl_p)
+{
+    tSdoComConHdl*      pHdl;
+
+    if (sdoComInstance_l.aConHashNext[sdoComConHdl_p] == SDO_COM_CON_UNLINKED)
+        return;
+
+    pHdl = &sdoComInstance_l.aConHashHead[sdoComInstance_l.aConHashBucket[sdoComConHdl_p]];
+    while ((*pHdl < CONFIG_SDO_MAX_CONNECTION_COM) && (*pHdl != sdoComConHdl_p))
+        pHdl = &sdoComInstance_l.aConHashNext[*pHdl];
+
+    if (*pHdl == sdoComConHdl_p)
+        *pHdl = sdoComInstance_l.aConHashNext[sdoComConHdl_p];
+
+    sdoComInstance_l.aConHashNext[sdoComConHdl_p] = SDO_COM_CON_UNLINKED;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Process state kSdoComStateIdle
@@ -836,6 +1215,10 @@ static tOplkError processStateIdle(tSdoComConHdl sdoComConHdl_p, tSdoComConEvent
                         case kSdoServiceReadByIndex:
                             // read by index, search entry an start transfer
                             serverInitReadByIndex(pSdoComCon, pRecvdCmdLayer_p);
+#if (CONFIG_SDO_SERVER_ASYNC != FALSE)
+                            if (pSdoComCon->sdoComState == kSdoComStateServerObdAccess)
+                                break;      // response is sent when the OD access is finished
+#endif
                             // check next state
                             if (pSdoComCon->transferSize == 0)
                             {   // ready -> stay idle
@@ -851,6 +1234,10 @@ static tOplkError processStateIdle(tSdoComConHdl sdoComConHdl_p, tSdoComConEvent
                         case kSdoServiceWriteByIndex:
                             // search entry an start write
                             serverInitWriteByIndex(pSdoComCon, pRecvdCmdLayer_p);
+#if (CONFIG_SDO_SERVER_ASYNC != FALSE)
+                            if (pSdoComCon->sdoComState == kSdoComStateServerObdAccess)
+                                break;      // response is sent when the OD access is finished
+#endif
                             // check next state
                             if(pSdoComCon->transferSize == 0)
                             {   // already -> stay idle
@@ -863,6 +1250,20 @@ static tOplkError processStateIdle(tSdoComConHdl sdoComConHdl_p, tSdoComConEvent
                             }
                             break;
 
+                        case kSdoServiceReadMultiByIndex:
+                            // multiple parameter transfers are always expedited -> stay idle
+                            serverInitReadMultiByIndex(pSdoComCon, pRecvdCmdLayer_p);
+                            pSdoComCon->sdoComState = kSdoComStateIdle;
+                            pSdoComCon->lastAbortCode = 0;
+                            break;
+
+                        case kSdoServiceWriteMultiByIndex:
+                            // multiple parameter transfers are always expedited -> stay idle
+                            serverInitWriteMultiByIndex(pSdoComCon, pRecvdCmdLayer_p);
+                            pSdoComCon->sdoComState = kSdoComStateIdle;
+                            pSdoComCon->lastAbortCode = 0;
+                            break;
+
                         default:
                             //  unsupported command -> send abort
                             abortCode = SDO_AC_UNKNOWN_COMMAND_SPECIFIER;
@@ -885,6 +1286,8 @@ static tOplkError processStateIdle(tSdoComConHdl sdoComConHdl_p, tSdoComConEvent
         case kSdoComConEventTimeout:
         case kSdoComConEventConClosed:
             ret = sdoseq_deleteCon(pSdoComCon->sdoSeqConHdl);
+            finishStream(pSdoComCon, TRUE);
+            unlinkConnection(sdoComConHdl_p);
             OPLK_MEMSET(pSdoComCon, 0x00, sizeof(tSdoComCon));
             break;
 
@@ -928,10 +1331,26 @@ static tOplkError processStateServerSegmTrans(tSdoComConHdl sdoComConHdl_p, tSdo
             if (pSdoComCon->sdoServiceType == kSdoServiceReadByIndex)
             {
                 // send next frame
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+                if ((serverSendFrame(pSdoComCon, 0, 0, kSdoComSendTypeRes) != kErrorOk) &&
+                    (pSdoComCon->pStream != NULL))
+                {   // reading the stream failed
+                    finishStream(pSdoComCon, TRUE);
+                    pSdoComCon->lastAbortCode = SDO_AC_GENERAL_ERROR;
+                    pSdoComCon->pData = (UINT8*)&pSdoComCon->lastAbortCode;
+                    ret = serverSendFrame(pSdoComCon, 0, 0, kSdoComSendTypeAbort);
+                    pSdoComCon->sdoComState = kSdoComStateIdle;
+                    pSdoComCon->lastAbortCode = 0;
+                    break;
+                }
+#else
                 serverSendFrame(pSdoComCon, 0, 0, kSdoComSendTypeRes);
+#endif
+
                 // if all send -> back to idle
                 if (pSdoComCon->transferSize == 0)
                 {   // back to idle
+                    finishStream(pSdoComCon, FALSE);
                     pSdoComCon->sdoComState = kSdoComStateIdle;
                     pSdoComCon->lastAbortCode = 0;
                 }
@@ -949,6 +1368,7 @@ static tOplkError processStateServerSegmTrans(tSdoComConHdl sdoComConHdl_p, tSdo
                 // check if it is a abort
                 if ((flag & SDO_CMDL_FLAG_ABORT) != 0)
                 {
+                    finishStream(pSdoComCon, TRUE);
                     pSdoComCon->transferSize = 0;
                     pSdoComCon->transferredBytes = 0;
                     pSdoComCon->sdoComState = kSdoComStateIdle;
@@ -963,14 +1383,19 @@ static tOplkError processStateServerSegmTrans(tSdoComConHdl sdoComConHdl_p, tSdo
                     size = ami_getUint16Le(&pRecvdCmdLayer_p->segmentSizeLe);
                     if (size > pSdoComCon->transferSize)
                     {
+                        finishStream(pSdoComCon, TRUE);
                         pSdoComCon->lastAbortCode = SDO_AC_DATA_TYPE_LENGTH_TOO_HIGH;
                         ret = serverSendFrame(pSdoComCon, 0, 0, kSdoComSendTypeAbort);
                         return ret;
                     }
                     if (pSdoComCon->lastAbortCode == 0)
                     {
-                        OPLK_MEMCPY(pSdoComCon->pData, &pRecvdCmdLayer_p->aCommandData[0], size);
-                        (pSdoComCon->pData) += size;
+                        if (writeObjectData(pSdoComCon, pSdoComCon->transferredBytes,
+                                            &pRecvdCmdLayer_p->aCommandData[0], size) != kErrorOk)
+                        {   // writing the stream failed -> abort at the end of the transfer
+                            finishStream(pSdoComCon, TRUE);
+                            pSdoComCon->lastAbortCode = SDO_AC_GENERAL_ERROR;
+                        }
                     }
                     pSdoComCon->transferredBytes += size;
                     pSdoComCon->transferSize -= size;
@@ -980,6 +1405,9 @@ static tOplkError processStateServerSegmTrans(tSdoComConHdl sdoComConHdl_p, tSdo
                     {   // transfer ready
                         pSdoComCon->transferSize = 0;
 
+                        if (pSdoComCon->lastAbortCode == 0)
+                            pSdoComCon->lastAbortCode = finishObjectWrite(pSdoComCon);
+
                         if (pSdoComCon->lastAbortCode == 0)
                         {
                             // send response
@@ -1017,6 +1445,72 @@ static tOplkError processStateServerSegmTrans(tSdoComConHdl sdoComConHdl_p, tSdo
         case kSdoComConEventTimeout:
         case kSdoComConEventConClosed:
             ret = sdoseq_deleteCon(pSdoComCon->sdoSeqConHdl);
+            finishStream(pSdoComCon, TRUE);
+            unlinkConnection(sdoComConHdl_p);
+            OPLK_MEMSET(pSdoComCon, 0x00, sizeof(tSdoComCon));
+            break;
+
+        default:
+            break;
+    }
+    return ret;
+}
+
+#if (CONFIG_SDO_SERVER_ASYNC != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Process state kSdoComStateServerObdAccess
+
+The function processes the SDO command handler state: kSdoComStateServerObdAccess
+
+The OD access of the current request is executed by a worker thread. Further
+requests are not processed until the response is sent by sdocom_processEvent().
+
+\param  sdoComConHdl_p          Handle to command layer connection.
+\param  sdoComConEvent_p        Event to process.
+\param  pRecvdCmdLayer_p        SDO command layer part of received frame.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError processStateServerObdAccess(tSdoComConHdl sdoComConHdl_p, tSdoComConEvent sdoComConEvent_p,
+                                              tAsySdoCom* pRecvdCmdLayer_p)
+{
+    tOplkError          ret = kErrorOk;
+    UINT8               flag;
+    tSdoComCon*         pSdoComCon;
+
+    pSdoComCon = &sdoComInstance_l.sdoComCon[sdoComConHdl_p];
+
+    switch (sdoComConEvent_p)
+    {
+        case kSdoComConEventRec:
+            flag = ami_getUint8Le(&pRecvdCmdLayer_p->flags);
+
+            if (((flag & SDO_CMDL_FLAG_RESPONSE) == 0) &&
+                (ami_getUint8Le(&pRecvdCmdLayer_p->transactionId) == pSdoComCon->transactionId))
+            {
+                if ((flag & SDO_CMDL_FLAG_ABORT) != 0)
+                {   // the result of the OD access is discarded
+                    pSdoComCon->transferSize = 0;
+                    pSdoComCon->transferredBytes = 0;
+                    pSdoComCon->sdoComState = kSdoComStateIdle;
+                    pSdoComCon->lastAbortCode = 0;
+                }
+            }
+            else
+            {   // this command layer handle is not responsible
+                // (wrong direction or wrong transaction ID)
+                ret = kErrorSdoComNotResponsible;
+            }
+            break;
+
+        // connection closed
+        case kSdoComConEventInitError:
+        case kSdoComConEventTimeout:
+        case kSdoComConEventConClosed:
+            ret = sdoseq_deleteCon(pSdoComCon->sdoSeqConHdl);
+            unlinkConnection(sdoComConHdl_p);
             OPLK_MEMSET(pSdoComCon, 0x00, sizeof(tSdoComCon));
             break;
 
@@ -1026,6 +1520,7 @@ static tOplkError processStateServerSegmTrans(tSdoComConHdl sdoComConHdl_p, tSdo
     return ret;
 }
 #endif
+#endif
 
 #if defined(CONFIG_INCLUDE_SDOC)
 //------------------------------------------------------------------------------
@@ -1076,6 +1571,11 @@ static tOplkError processStateClientWaitInit(tSdoComConHdl sdoComConHdl_p, tSdoC
                 return ret;
                 break;
         }
+
+        // enter connection in the hash chain of the new sequence layer handle
+        unlinkConnection(sdoComConHdl_p);
+        linkConnection(sdoComConHdl_p);
+
         // d.k.: reset transaction ID, because new sequence layer connection was initialized
         // $$$ d.k. is this really necessary?
         //pSdoComCon->transactionId = 0;
@@ -1428,6 +1928,13 @@ static tOplkError processState(tSdoComConHdl sdoComConHdl_p, tSdoComConEvent sdo
         case kSdoComStateServerSegmTrans:
             ret = processStateServerSegmTrans(sdoComConHdl_p, sdoComConEvent_p, pRecvdCmdLayer_p);
             break;
+
+#if (CONFIG_SDO_SERVER_ASYNC != FALSE)
+        // OD access is executed by a worker thread
+        case kSdoComStateServerObdAccess:
+            ret = processStateServerObdAccess(sdoComConHdl_p, sdoComConEvent_p, pRecvdCmdLayer_p);
+            break;
+#endif
 #endif
 
 #if defined(CONFIG_INCLUDE_SDOC)
@@ -1522,9 +2029,23 @@ static tOplkError serverInitReadByIndex(tSdoComCon* pSdoComCon_p, tAsySdoCom* pS
 
     // get size of object to see if segmented or expedited transfer
     entrySize = obd_getDataSize(index, subindex);
-    if (entrySize > SDO_MAX_SEGMENT_SIZE)
+    pSdoComCon_p->maxSegmentSize = getMaxSegmentSize();
+    if (entrySize > pSdoComCon_p->maxSegmentSize)
     {
         pSdoComCon_p->sdoTransferType = kSdoTransSegmented;
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+        pSdoComCon_p->pStream = obd_getDomainStream(index, subindex);
+        if ((pSdoComCon_p->pStream != NULL) &&
+            (pSdoComCon_p->pStream->pfnAccess(pSdoComCon_p->pStream->pArg, kObdDomainStreamOpen,
+                                              0, NULL, entrySize) != kErrorOk))
+        {
+            pSdoComCon_p->pStream = NULL;
+            abortCode = SDO_AC_GENERAL_ERROR;
+            pSdoComCon_p->pData = (UINT8*)&abortCode;
+            ret = serverSendFrame(pSdoComCon_p, index, subindex, kSdoComSendTypeAbort);
+            return ret;
+        }
+#endif
         pSdoComCon_p->pData = obd_getObjectDataPtr(index, subindex);
     }
     else
@@ -1535,9 +2056,16 @@ static tOplkError serverInitReadByIndex(tSdoComCon* pSdoComCon_p, tAsySdoCom* pS
     pSdoComCon_p->transferSize = entrySize;
     pSdoComCon_p->transferredBytes = 0;
 
+#if (CONFIG_SDO_SERVER_ASYNC != FALSE)
+    if ((pSdoComCon_p->sdoTransferType == kSdoTransExpedited) &&
+        (deferObdAccess(pSdoComCon_p, index, subindex, FALSE, NULL, entrySize) == kErrorOk))
+        return kErrorOk;
+#endif
+
     ret = serverSendFrame(pSdoComCon_p, index, subindex, kSdoComSendTypeRes);
     if (ret != kErrorOk)
     {
+        finishStream(pSdoComCon_p, TRUE);
         abortCode = SDO_AC_GENERAL_ERROR;
         pSdoComCon_p->pData = (UINT8*)&abortCode;
         ret = serverSendFrame(pSdoComCon_p, index, subindex, kSdoComSendTypeAbort);
@@ -1627,30 +2155,35 @@ static tOplkError serverSendFrame(tSdoComCon* pSdoComCon_p, UINT index_p,
                     ami_setUint8Le(&pCommandFrame->flags,  flag);
                     // init data size in variable header, which includes itself
                     ami_setUint32Le(&pCommandFrame->aCommandData[0], pSdoComCon_p->transferSize + SDO_CMDL_HDR_VAR_SIZE);
-                    OPLK_MEMCPY(&pCommandFrame->aCommandData[SDO_CMDL_HDR_VAR_SIZE],pSdoComCon_p->pData, (SDO_MAX_SEGMENT_SIZE - SDO_CMDL_HDR_VAR_SIZE));
+                    ret = readObjectData(pSdoComCon_p, 0, &pCommandFrame->aCommandData[SDO_CMDL_HDR_VAR_SIZE],
+                                         (pSdoComCon_p->maxSegmentSize - SDO_CMDL_HDR_VAR_SIZE));
+                    if (ret != kErrorOk)
+                        return ret;
 
-                    pSdoComCon_p->transferSize -= (SDO_MAX_SEGMENT_SIZE - SDO_CMDL_HDR_VAR_SIZE);
-                    pSdoComCon_p->transferredBytes += (SDO_MAX_SEGMENT_SIZE - SDO_CMDL_HDR_VAR_SIZE);
-                    pSdoComCon_p->pData +=(SDO_MAX_SEGMENT_SIZE - SDO_CMDL_HDR_VAR_SIZE);
+                    pSdoComCon_p->transferSize -= (pSdoComCon_p->maxSegmentSize - SDO_CMDL_HDR_VAR_SIZE);
+                    pSdoComCon_p->transferredBytes += (pSdoComCon_p->maxSegmentSize - SDO_CMDL_HDR_VAR_SIZE);
 
-                    ami_setUint16Le(&pCommandFrame->segmentSizeLe, SDO_MAX_SEGMENT_SIZE);
+                    ami_setUint16Le(&pCommandFrame->segmentSizeLe, (WORD)pSdoComCon_p->maxSegmentSize);
 
-                    sizeOfFrame += SDO_MAX_SEGMENT_SIZE;
+                    sizeOfFrame += pSdoComCon_p->maxSegmentSize;
                     ret = sdoseq_sendData(pSdoComCon_p->sdoSeqConHdl, sizeOfFrame, pFrame);
                 }
-                else if ((pSdoComCon_p->transferredBytes > 0) &&(pSdoComCon_p->transferSize > SDO_MAX_SEGMENT_SIZE))
+                else if ((pSdoComCon_p->transferredBytes > 0) &&(pSdoComCon_p->transferSize > pSdoComCon_p->maxSegmentSize))
                 {   // segment
                     flag = ami_getUint8Le(&pCommandFrame->flags);
                     flag |= SDO_CMDL_FLAG_SEGMENTED;
                     ami_setUint8Le(&pCommandFrame->flags, flag);
 
-                    OPLK_MEMCPY(&pCommandFrame->aCommandData[0],pSdoComCon_p->pData, SDO_MAX_SEGMENT_SIZE);
-                    pSdoComCon_p->transferSize -= SDO_MAX_SEGMENT_SIZE;
-                    pSdoComCon_p->transferredBytes += SDO_MAX_SEGMENT_SIZE;
-                    pSdoComCon_p->pData +=SDO_MAX_SEGMENT_SIZE;
-                    ami_setUint16Le(&pCommandFrame->segmentSizeLe,SDO_MAX_SEGMENT_SIZE);
+                    ret = readObjectData(pSdoComCon_p, pSdoComCon_p->transferredBytes,
+                                         &pCommandFrame->aCommandData[0], pSdoComCon_p->maxSegmentSize);
+                    if (ret != kErrorOk)
+                        return ret;
+
+                    pSdoComCon_p->transferSize -= pSdoComCon_p->maxSegmentSize;
+                    pSdoComCon_p->transferredBytes += pSdoComCon_p->maxSegmentSize;
+                    ami_setUint16Le(&pCommandFrame->segmentSizeLe, (WORD)pSdoComCon_p->maxSegmentSize);
 
-                    sizeOfFrame += SDO_MAX_SEGMENT_SIZE;
+                    sizeOfFrame += pSdoComCon_p->maxSegmentSize;
                     ret = sdoseq_sendData(pSdoComCon_p->sdoSeqConHdl, sizeOfFrame, pFrame);
                 }
                 else
@@ -1662,9 +2195,12 @@ static tOplkError serverSendFrame(tSdoComCon* pSdoComCon_p, UINT index_p,
                     flag = ami_getUint8Le( &pCommandFrame->flags);
                     flag |= SDO_CMDL_FLAG_SEGMCOMPL;
                     ami_setUint8Le(&pCommandFrame->flags,  flag);
-                    OPLK_MEMCPY(&pCommandFrame->aCommandData[0],pSdoComCon_p->pData, pSdoComCon_p->transferSize);
-                    pSdoComCon_p->transferredBytes += pSdoComCon_p->transferSize;
-                    pSdoComCon_p->pData +=pSdoComCon_p->transferSize;
+                    ret = readObjectData(pSdoComCon_p, pSdoComCon_p->transferredBytes,
+                                         &pCommandFrame->aCommandData[0], pSdoComCon_p->transferSize);
+                    if (ret != kErrorOk)
+                        return ret;
+
+                    pSdoComCon_p->transferredBytes += pSdoComCon_p->transferSize;
                     ami_setUint16Le(&pCommandFrame->segmentSizeLe, (WORD) pSdoComCon_p->transferSize);
 
                     sizeOfFrame += pSdoComCon_p->transferSize;
@@ -1711,7 +2247,6 @@ static tOplkError serverInitWriteByIndex(tSdoComCon* pSdoComCon_p, tAsySdoCom* p
     UINT            index;
     UINT            subindex;
     UINT            bytesToTransfer;
-    tObdSize        entrySize;
     tObdAccess      accessType;
     UINT8*          pSrcData;
 
@@ -1788,84 +2323,81 @@ static tOplkError serverInitWriteByIndex(tSdoComCon* pSdoComCon_p, tAsySdoCom* p
     // write data to OD
     if (pSdoComCon_p->sdoTransferType == kSdoTransExpedited)
     {   // expedited transfer, size checking is done by obd_writeEntryFromLe()
-
-        ret = obd_writeEntryFromLe(index, subindex, pSrcData, pSdoComCon_p->transferSize);
-        switch (ret)
+#if (CONFIG_SDO_SERVER_ASYNC != FALSE)
+        if (deferObdAccess(pSdoComCon_p, index, subindex, TRUE, pSrcData,
+                           pSdoComCon_p->transferSize) == kErrorOk)
         {
-            case kErrorOk:
-                break;
+            pSdoComCon_p->transferSize = 0;
+            return kErrorOk;
+        }
+#endif
 
-            case kErrorObdAccessViolation:
-                pSdoComCon_p->lastAbortCode = SDO_AC_UNSUPPORTED_ACCESS;
-                // send abort
-                goto Abort;
-                break;
+        ret = obd_writeEntryFromLe(index, subindex, pSrcData, pSdoComCon_p->transferSize);
+        pSdoComCon_p->lastAbortCode = getWriteAbortCode(ret);
+        if (pSdoComCon_p->lastAbortCode != 0)
+        {   // send abort
+            goto Abort;
+        }
 
-            case kErrorObdValueLengthError:
-                pSdoComCon_p->lastAbortCode = SDO_AC_DATA_TYPE_LENGTH_NOT_MATCH;
-                // send abort
-                goto Abort;
-                break;
+        // send command acknowledge
+        ret = serverSendFrame(pSdoComCon_p, 0, 0, kSdoComSendTypeAckRes);
 
-            case kErrorObdValueTooHigh:
-                pSdoComCon_p->lastAbortCode = SDO_AC_VALUE_RANGE_TOO_HIGH;
-                // send abort
+        pSdoComCon_p->transferSize = 0;
+        return ret;
+    }
+    else
+    {
+        bytesToTransfer = ami_getUint16Le(&pSdoCom_p->segmentSizeLe);
+        bytesToTransfer -= (SDO_CMDL_HDR_FIXED_SIZE + SDO_CMDL_HDR_VAR_SIZE + SDO_CMDL_HDR_WRITEBYINDEX_SIZE);
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+        pSdoComCon_p->pStream = obd_getDomainStream(index, subindex);
+        if (pSdoComCon_p->pStream != NULL)
+        {
+            if (pSdoComCon_p->pStream->maxSize < pSdoComCon_p->transferSize)
+            {   // parameter too big
+                pSdoComCon_p->lastAbortCode = SDO_AC_DATA_TYPE_LENGTH_TOO_HIGH;
                 goto Abort;
-                break;
+            }
 
-            case kErrorObdValueTooLow:
-                pSdoComCon_p->lastAbortCode = SDO_AC_VALUE_RANGE_TOO_LOW;
-                // send abort
+            if ((accessType & kObdAccConst) != 0)
+            {
+                pSdoComCon_p->lastAbortCode = SDO_AC_UNSUPPORTED_ACCESS;
                 goto Abort;
-                break;
+            }
 
-            default:
+            if (pSdoComCon_p->pStream->pfnAccess(pSdoComCon_p->pStream->pArg, kObdDomainStreamOpen,
+                                                 0, NULL, pSdoComCon_p->transferSize) != kErrorOk)
+            {
                 pSdoComCon_p->lastAbortCode = SDO_AC_GENERAL_ERROR;
-                // send abort
                 goto Abort;
-                break;
+            }
         }
+        else
+#endif
+        {
+            // The access checks and the initial callbacks of the object are
+            // executed once for the whole download, afterwards the segments are
+            // copied directly into the object data.
+            ret = obd_beginSegmentedWrite(index, subindex, pSdoComCon_p->transferSize,
+                                          &pSdoComCon_p->segmWrite);
+            if (ret == kErrorObdValueLengthError)
+                pSdoComCon_p->lastAbortCode = SDO_AC_DATA_TYPE_LENGTH_TOO_HIGH;
+            else
+                pSdoComCon_p->lastAbortCode = getWriteAbortCode(ret);
 
-        // send command acknowledge
-        ret = serverSendFrame(pSdoComCon_p, 0, 0, kSdoComSendTypeAckRes);
+            if (pSdoComCon_p->lastAbortCode != 0)
+                goto Abort;
 
-        pSdoComCon_p->transferSize = 0;
-        return ret;
-    }
-    else
-    {
-        // get size of the object to check if it fits
-        // because we directly write to the destination memory
-        // d.k. no one calls the user OD callback function
-
-        entrySize = obd_getDataSize(index, subindex);
-        if (entrySize < pSdoComCon_p->transferSize)
-        {   // parameter too big
-            pSdoComCon_p->lastAbortCode = SDO_AC_DATA_TYPE_LENGTH_TOO_HIGH;
-            // send abort
-            // d.k. This is wrong: k.t. not needed send abort on end of write
-            /*pSdoComCon_p->pData = (UINT8*)&abortCode;
-            ret = serverSendFrame(pSdoComCon_p, index, subindex, kSdoComSendTypeAbort);*/
-            goto Abort;
+            pSdoComCon_p->pData = (UINT8*)pSdoComCon_p->segmWrite.pData;
         }
 
-        bytesToTransfer = ami_getUint16Le(&pSdoCom_p->segmentSizeLe);
-        bytesToTransfer -= (SDO_CMDL_HDR_FIXED_SIZE + SDO_CMDL_HDR_VAR_SIZE + SDO_CMDL_HDR_WRITEBYINDEX_SIZE);
-        pSdoComCon_p->pData = obd_getObjectDataPtr(index, subindex);    // get pointer to object entry
-        if (pSdoComCon_p->pData == NULL)
+        if (writeObjectData(pSdoComCon_p, 0, pSrcData, bytesToTransfer) != kErrorOk)
         {
             pSdoComCon_p->lastAbortCode = SDO_AC_GENERAL_ERROR;
-            // send abort
-            // d.k. This is wrong: k.t. not needed send abort on end of write
-/*            pSdoComCon_p->pData = (UINT8*)&pSdoComCon_p->lastAbortCode;
-            ret = serverSendFrame(pSdoComCon_p, index, subindex, kSdoComSendTypeAbort);*/
             goto Abort;
         }
-
-        OPLK_MEMCPY(pSdoComCon_p->pData, pSrcData, bytesToTransfer);
         pSdoComCon_p->transferredBytes = bytesToTransfer;
         pSdoComCon_p->transferSize -= bytesToTransfer;
-        (/*(UINT8*)*/pSdoComCon_p->pData) += bytesToTransfer;
 
         // send acknowledge without any Command layer data
         ret = sdoseq_sendData(pSdoComCon_p->sdoSeqConHdl, 0, (tPlkFrame*)NULL);
@@ -1875,6 +2407,7 @@ static tOplkError serverInitWriteByIndex(tSdoComCon* pSdoComCon_p, tAsySdoCom* p
 Abort:
     if (pSdoComCon_p->lastAbortCode != 0)
     {
+        finishStream(pSdoComCon_p, TRUE);
         // send abort
         pSdoComCon_p->pData = (UINT8*)&pSdoComCon_p->lastAbortCode;
         ret = serverSendFrame(pSdoComCon_p, index, subindex, kSdoComSendTypeAbort);
@@ -1885,6 +2418,444 @@ Abort:
 
     return ret;
 }
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process a ReadMultipleParameterByIndex command
+
+The function processes a Read Multiple Parameter by Index SDO command. The
+command is answered by a single response frame which contains a sub-block for
+each requested entry. A sub-block carries the data of the entry or a
+sub-abort code if the entry cannot be read. Entries which do not fit into the
+response frame are not answered. Segmented transfers are not supported.
+
+\param  pSdoComCon_p            Pointer to SDO command layer connection structure.
+\param  pSdoCom_p               Pointer to received command layer data.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError serverInitReadMultiByIndex(tSdoComCon* pSdoComCon_p, tAsySdoCom* pSdoCom_p)
+{
+    tOplkError      ret;
+    UINT8           aFrame[SDO_MAX_FRAME_SIZE];
+    tPlkFrame*      pFrame;
+    tAsySdoCom*     pCommandFrame;
+    UINT8*          pSubBlock;
+    UINT8*          pPrevSubBlock;
+    UINT            entryCount;
+    UINT            entry;
+    UINT            offset;
+    UINT            index;
+    UINT            subindex;
+    UINT            padding;
+    tObdSize        obdSize;
+    UINT32          abortCode;
+
+    pSdoComCon_p->sdoServiceType = kSdoServiceReadMultiByIndex;
+    pSdoComCon_p->sdoTransferType = kSdoTransExpedited;
+    pSdoComCon_p->transferSize = 0;
+    pSdoComCon_p->transferredBytes = 0;
+
+    if ((pSdoCom_p->flags & SDO_CMDL_FLAG_SEGM_MASK) != SDO_CMDL_FLAG_EXPEDITED)
+    {   // segmented multiple parameter transfers are not supported
+        abortCode = SDO_AC_UNKNOWN_COMMAND_SPECIFIER;
+        pSdoComCon_p->pData = (UINT8*)&abortCode;
+        ret = serverSendFrame(pSdoComCon_p, 0, 0, kSdoComSendTypeAbort);
+        return ret;
+    }
+
+    pFrame = (tPlkFrame*)&aFrame[0];
+    OPLK_MEMSET(&aFrame[0], 0x00, sizeof(aFrame));
+    pCommandFrame = &pFrame->data.asnd.payload.sdoSequenceFrame.sdoSeqPayload;
+
+    pSdoComCon_p->maxSegmentSize = getMaxSegmentSize();
+    entryCount = ami_getUint16Le(&pSdoCom_p->segmentSizeLe) / SDO_CMDL_HDR_MULTI_READ_SIZE;
+    pPrevSubBlock = NULL;
+    offset = 0;
+
+    for (entry = 0; entry < entryCount; entry++)
+    {
+        // a sub-block needs at least space for the sub-abort code
+        if ((offset + SDO_CMDL_HDR_MULTI_SUBHDR_SIZE + sizeof(UINT32)) > pSdoComCon_p->maxSegmentSize)
+            break;
+
+        index = ami_getUint16Le(&pSdoCom_p->aCommandData[entry * SDO_CMDL_HDR_MULTI_READ_SIZE]);
+        subindex = ami_getUint8Le(&pSdoCom_p->aCommandData[(entry * SDO_CMDL_HDR_MULTI_READ_SIZE) + 2]);
+        pSubBlock = &pCommandFrame->aCommandData[offset];
+
+        abortCode = getAccessAbortCode(index, subindex, FALSE);
+        if (abortCode == 0)
+        {
+            // the data is padded to a multiple of 4 bytes
+            obdSize = (pSdoComCon_p->maxSegmentSize - offset - SDO_CMDL_HDR_MULTI_SUBHDR_SIZE) & ~3;
+            ret = obd_readEntryToLe(index, subindex, &pSubBlock[SDO_CMDL_HDR_MULTI_SUBHDR_SIZE], &obdSize);
+            if (ret == kErrorObdValueLengthError)
+                abortCode = SDO_AC_OUT_OF_MEMORY;   // response frame is full
+            else if (ret != kErrorOk)
+                abortCode = SDO_AC_GENERAL_ERROR;
+        }
+
+        ami_setUint16Le(&pSubBlock[4], (UINT16)index);
+        ami_setUint8Le(&pSubBlock[6], (UINT8)subindex);
+        if (abortCode != 0)
+        {
+            ami_setUint8Le(&pSubBlock[7], SDO_CMDL_MULTI_FLAG_SUBABORT);
+            ami_setUint32Le(&pSubBlock[SDO_CMDL_HDR_MULTI_SUBHDR_SIZE], abortCode);
+            obdSize = sizeof(UINT32);
+            padding = 0;
+        }
+        else
+        {
+            padding = (4 - (obdSize & 3)) & 3;
+            ami_setUint8Le(&pSubBlock[7], (UINT8)padding);
+            pSdoComCon_p->transferredBytes += obdSize;
+        }
+
+        // chain the sub-block, the last sub-block keeps the offset 0
+        if (pPrevSubBlock != NULL)
+            ami_setUint32Le(&pPrevSubBlock[0], offset);
+
+        pPrevSubBlock = pSubBlock;
+        offset += SDO_CMDL_HDR_MULTI_SUBHDR_SIZE + obdSize + padding;
+    }
+
+    ret = serverSendMultiFrame(pSdoComCon_p, pFrame, offset);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process a WriteMultipleParameterByIndex command
+
+The function processes a Write Multiple Parameter by Index SDO command. Each
+sub-block of the command is written to the OD. The response contains a
+sub-abort entry for every sub-block which could not be written. Segmented
+transfers are not supported.
+
+\param  pSdoComCon_p            Pointer to SDO command layer connection structure.
+\param  pSdoCom_p               Pointer to received command layer data.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError serverInitWriteMultiByIndex(tSdoComCon* pSdoComCon_p, tAsySdoCom* pSdoCom_p)
+{
+    tOplkError      ret;
+    UINT8           aFrame[SDO_MAX_FRAME_SIZE];
+    tPlkFrame*      pFrame;
+    tAsySdoCom*     pCommandFrame;
+    UINT8*          pSubBlock;
+    UINT8*          pSubAbort;
+    UINT            segmentSize;
+    UINT            offset;
+    UINT            nextOffset;
+    UINT            dataEnd;
+    UINT            padding;
+    UINT            index;
+    UINT            subindex;
+    UINT            responseSize;
+    UINT32          abortCode;
+
+    pSdoComCon_p->sdoServiceType = kSdoServiceWriteMultiByIndex;
+    pSdoComCon_p->sdoTransferType = kSdoTransExpedited;
+    pSdoComCon_p->transferSize = 0;
+    pSdoComCon_p->transferredBytes = 0;
+
+    if ((pSdoCom_p->flags & SDO_CMDL_FLAG_SEGM_MASK) != SDO_CMDL_FLAG_EXPEDITED)
+    {   // segmented multiple parameter transfers are not supported
+        abortCode = SDO_AC_UNKNOWN_COMMAND_SPECIFIER;
+        pSdoComCon_p->pData = (UINT8*)&abortCode;
+        ret = serverSendFrame(pSdoComCon_p, 0, 0, kSdoComSendTypeAbort);
+        return ret;
+    }
+
+    pFrame = (tPlkFrame*)&aFrame[0];
+    OPLK_MEMSET(&aFrame[0], 0x00, sizeof(aFrame));
+    pCommandFrame = &pFrame->data.asnd.payload.sdoSequenceFrame.sdoSeqPayload;
+
+    pSdoComCon_p->maxSegmentSize = getMaxSegmentSize();
+    segmentSize = ami_getUint16Le(&pSdoCom_p->segmentSizeLe);
+    responseSize = 0;
+    offset = 0;
+
+    do
+    {
+        if ((offset + SDO_CMDL_HDR_MULTI_SUBHDR_SIZE) > segmentSize)
+        {
+            abortCode = SDO_AC_INVALID_BLOCK_SIZE;
+            pSdoComCon_p->pData = (UINT8*)&abortCode;
+            ret = serverSendFrame(pSdoComCon_p, 0, 0, kSdoComSendTypeAbort);
+            return ret;
+        }
+
+        pSubBlock = &pSdoCom_p->aCommandData[offset];
+        nextOffset = ami_getUint32Le(&pSubBlock[0]);
+        index = ami_getUint16Le(&pSubBlock[4]);
+        subindex = ami_getUint8Le(&pSubBlock[6]);
+        padding = ami_getUint8Le(&pSubBlock[7]) & SDO_CMDL_MULTI_PADDING_MASK;
+
+        // the data of the last sub-block ends with the segment
+        dataEnd = (nextOffset != 0) ? nextOffset : segmentSize;
+        if ((dataEnd > segmentSize) || (dataEnd < (offset + SDO_CMDL_HDR_MULTI_SUBHDR_SIZE + padding)))
+        {
+            abortCode = SDO_AC_INVALID_BLOCK_SIZE;
+            pSdoComCon_p->pData = (UINT8*)&abortCode;
+            ret = serverSendFrame(pSdoComCon_p, index, subindex, kSdoComSendTypeAbort);
+            return ret;
+        }
+
+        abortCode = getAccessAbortCode(index, subindex, TRUE);
+        if (abortCode == 0)
+        {
+            ret = obd_writeEntryFromLe(index, subindex, &pSubBlock[SDO_CMDL_HDR_MULTI_SUBHDR_SIZE],
+                                       dataEnd - offset - SDO_CMDL_HDR_MULTI_SUBHDR_SIZE - padding);
+            abortCode = getWriteAbortCode(ret);
+        }
+
+        if (abortCode == 0)
+        {
+            pSdoComCon_p->transferredBytes += dataEnd - offset - SDO_CMDL_HDR_MULTI_SUBHDR_SIZE - padding;
+        }
+        else if ((responseSize + SDO_CMDL_HDR_MULTI_SUBABORT_SIZE) <= pSdoComCon_p->maxSegmentSize)
+        {
+            pSubAbort = &pCommandFrame->aCommandData[responseSize];
+            ami_setUint16Le(&pSubAbort[0], (UINT16)index);
+            ami_setUint8Le(&pSubAbort[2], (UINT8)subindex);
+            ami_setUint8Le(&pSubAbort[3], SDO_CMDL_MULTI_FLAG_SUBABORT);
+            ami_setUint32Le(&pSubAbort[4], abortCode);
+            responseSize += SDO_CMDL_HDR_MULTI_SUBABORT_SIZE;
+        }
+
+        offset = nextOffset;
+    } while (offset != 0);
+
+    ret = serverSendMultiFrame(pSdoComCon_p, pFrame, responseSize);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send the response of a multiple parameter command
+
+The function completes the command layer header of the response to a
+multiple parameter command and sends the frame.
+
+\param  pSdoComCon_p            Pointer to SDO command layer connection structure.
+\param  pFrame_p                Pointer to frame which contains the response data.
+\param  dataSize_p              Size of the response data.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError serverSendMultiFrame(tSdoComCon* pSdoComCon_p, tPlkFrame* pFrame_p, UINT dataSize_p)
+{
+    tOplkError      ret;
+    tAsySdoCom*     pCommandFrame;
+
+    pCommandFrame = &pFrame_p->data.asnd.payload.sdoSequenceFrame.sdoSeqPayload;
+    ami_setUint8Le(&pCommandFrame->commandId, pSdoComCon_p->sdoServiceType);
+    ami_setUint8Le(&pCommandFrame->transactionId, pSdoComCon_p->transactionId);
+    ami_setUint8Le(&pCommandFrame->flags, SDO_CMDL_FLAG_RESPONSE);
+    ami_setUint16Le(&pCommandFrame->segmentSizeLe, (UINT16)dataSize_p);
+
+    ret = sdoseq_sendData(pSdoComCon_p->sdoSeqConHdl, SDO_CMDL_HDR_FIXED_SIZE + dataSize_p, pFrame_p);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check SDO access of an object
+
+The function checks if an object exists and if it may be accessed by an SDO.
+
+\param  index_p                 Index of the object.
+\param  subIndex_p              Sub-index of the object.
+\param  fWrite_p                TRUE for a write access, FALSE for a read access.
+
+\return The function returns the SDO abort code of the access or 0 if the
+        access is allowed.
+*/
+//------------------------------------------------------------------------------
+static UINT32 getAccessAbortCode(UINT index_p, UINT subIndex_p, BOOL fWrite_p)
+{
+    tOplkError      ret;
+    tObdAccess      accessType;
+
+    ret = obd_getAccessType(index_p, subIndex_p, &accessType);
+    if (ret == kErrorObdSubindexNotExist)
+        return SDO_AC_SUB_INDEX_NOT_EXIST;
+    else if (ret != kErrorOk)
+        return SDO_AC_OBJECT_NOT_EXIST;
+
+    if (fWrite_p)
+    {
+        if ((accessType & kObdAccWrite) == 0)
+            return ((accessType & kObdAccRead) != 0) ? SDO_AC_WRITE_TO_READ_ONLY_OBJ : SDO_AC_UNSUPPORTED_ACCESS;
+    }
+    else
+    {
+        if (((accessType & kObdAccRead) == 0) && ((accessType & kObdAccConst) == 0))
+            return ((accessType & kObdAccWrite) != 0) ? SDO_AC_READ_TO_WRITE_ONLY_OBJ : SDO_AC_UNSUPPORTED_ACCESS;
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get SDO abort code of an OD write
+
+The function converts the result of an OD write into an SDO abort code.
+
+\param  error_p                 Result of the OD write.
+
+\return The function returns the SDO abort code or 0 if the write succeeded.
+*/
+//------------------------------------------------------------------------------
+static UINT32 getWriteAbortCode(tOplkError error_p)
+{
+    switch (error_p)
+    {
+        case kErrorOk:
+            return 0;
+
+        case kErrorObdAccessViolation:
+            return SDO_AC_UNSUPPORTED_ACCESS;
+
+        case kErrorObdValueLengthError:
+            return SDO_AC_DATA_TYPE_LENGTH_NOT_MATCH;
+
+        case kErrorObdValueTooHigh:
+            return SDO_AC_VALUE_RANGE_TOO_HIGH;
+
+        case kErrorObdValueTooLow:
+            return SDO_AC_VALUE_RANGE_TOO_LOW;
+
+        default:
+            return SDO_AC_GENERAL_ERROR;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Finish the object write of a segmented download
+
+The function completes a segmented download after its last segment. A domain
+stream is closed, a download into the object data runs the final checks and
+the write callbacks of the object once.
+
+\param  pSdoComCon_p            Pointer to SDO command layer connection structure.
+
+\return The function returns the SDO abort code (0 = no error).
+*/
+//------------------------------------------------------------------------------
+static UINT32 finishObjectWrite(tSdoComCon* pSdoComCon_p)
+{
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    if (pSdoComCon_p->pStream != NULL)
+    {
+        finishStream(pSdoComCon_p, FALSE);
+        return 0;
+    }
+#endif
+
+    return getWriteAbortCode(obd_finishSegmentedWrite(&pSdoComCon_p->segmWrite,
+                                                      pSdoComCon_p->transferredBytes));
+}
+
+#if (CONFIG_SDO_SERVER_ASYNC != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Defer an expedited OD access to the worker threads
+
+The function hands an expedited OD access to the worker threads if the object
+has a callback function and does not belong to the communication profile area
+below CONFIG_SDO_SERVER_ASYNC_MIN_INDEX. The request is acknowledged on the
+sequence layer, the response is sent when the access is finished.
+
+\param  pSdoComCon_p            Pointer to SDO command layer connection structure.
+\param  index_p                 Index of the object.
+\param  subIndex_p              Sub-index of the object.
+\param  fWrite_p                TRUE = write access, FALSE = read access.
+\param  pSrcData_p              Data to be written (ignored for read accesses).
+\param  size_p                  Size of the data to be written or read.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The access was deferred.
+\retval kErrorReject            The access must be executed directly.
+*/
+//------------------------------------------------------------------------------
+static tOplkError deferObdAccess(tSdoComCon* pSdoComCon_p, UINT index_p, UINT subIndex_p,
+                                 BOOL fWrite_p, const void* pSrcData_p, UINT size_p)
+{
+    tOplkError          ret;
+    tSdoComObdAccess    obdAccess;
+    BOOL                fCallback;
+
+    if ((index_p < CONFIG_SDO_SERVER_ASYNC_MIN_INDEX) || (size_p > sizeof(obdAccess.aData)))
+        return kErrorReject;
+
+    if ((obd_hasCallback(index_p, &fCallback) != kErrorOk) || !fCallback)
+        return kErrorReject;
+
+    obdAccess.sdoComConHdl = (tSdoComConHdl)(pSdoComCon_p - &sdoComInstance_l.sdoComCon[0]);
+    obdAccess.sdoSeqConHdl = pSdoComCon_p->sdoSeqConHdl;
+    obdAccess.transactionId = pSdoComCon_p->transactionId;
+    obdAccess.fWrite = fWrite_p;
+    obdAccess.index = index_p;
+    obdAccess.subIndex = subIndex_p;
+    obdAccess.size = size_p;
+    obdAccess.result = kErrorOk;
+    if (fWrite_p)
+        OPLK_MEMCPY(obdAccess.aData, pSrcData_p, size_p);
+
+    ret = sdocom_queueObdAccess(&obdAccess);
+    if (ret != kErrorOk)
+        return ret;
+
+    pSdoComCon_p->sdoComState = kSdoComStateServerObdAccess;
+
+    // acknowledge the request on sequence layer without any command layer data
+    sdoseq_sendData(pSdoComCon_p->sdoSeqConHdl, 0, (tPlkFrame*)NULL);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send the response of a deferred OD read
+
+The function sends the expedited ReadByIndex response with the data read by a
+worker thread.
+
+\param  pSdoComCon_p            Pointer to SDO command layer connection structure.
+\param  pObdAccess_p            Finished OD access.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError serverSendObdAccessResult(tSdoComCon* pSdoComCon_p, const tSdoComObdAccess* pObdAccess_p)
+{
+    UINT8           aFrame[SDO_MAX_FRAME_SIZE];
+    tPlkFrame*      pFrame;
+    tAsySdoCom*     pCommandFrame;
+
+    pFrame = (tPlkFrame*)&aFrame[0];
+    OPLK_MEMSET(&aFrame[0], 0x00, sizeof(aFrame));
+
+    pCommandFrame = &pFrame->data.asnd.payload.sdoSequenceFrame.sdoSeqPayload;
+    ami_setUint8Le(&pCommandFrame->commandId, pSdoComCon_p->sdoServiceType);
+    ami_setUint8Le(&pCommandFrame->transactionId, pSdoComCon_p->transactionId);
+    ami_setUint8Le(&pCommandFrame->flags, SDO_CMDL_FLAG_RESPONSE);
+    ami_setUint16Le(&pCommandFrame->segmentSizeLe, (WORD)pObdAccess_p->size);
+    OPLK_MEMCPY(&pCommandFrame->aCommandData[0], pObdAccess_p->aData, pObdAccess_p->size);
+
+    pSdoComCon_p->transferredBytes = pObdAccess_p->size;
+    pSdoComCon_p->transferSize = 0;
+
+    return sdoseq_sendData(pSdoComCon_p->sdoSeqConHdl, SDO_CMDL_HDR_FIXED_SIZE + pObdAccess_p->size, pFrame);
+}
+#endif
 #endif
 
 #if defined(CONFIG_INCLUDE_SDOC)
@@ -1943,22 +2914,23 @@ static tOplkError clientSend(tSdoComCon* pSdoComCon_p)
                     break;
 
                 case kSdoServiceWriteByIndex:
-                    if (pSdoComCon_p->transferSize > (SDO_MAX_SEGMENT_SIZE - SDO_CMDL_HDR_WRITEBYINDEX_SIZE))
+                    if (pSdoComCon_p->transferSize > (pSdoComCon_p->maxSegmentSize - SDO_CMDL_HDR_WRITEBYINDEX_SIZE))
                     {   // segmented transfer -> variable part of header needed
                         pSdoComCon_p->sdoTransferType = kSdoTransSegmented;
                         ami_setUint32Le(&pCommandFrame->aCommandData[0], pSdoComCon_p->transferSize + SDO_CMDL_HDR_FIXED_SIZE);
                         pPayload = &pCommandFrame->aCommandData[SDO_CMDL_HDR_VAR_SIZE];
-                        ami_setUint16Le(&pCommandFrame->segmentSizeLe, SDO_MAX_SEGMENT_SIZE);
+                        ami_setUint16Le(&pCommandFrame->segmentSizeLe, (WORD)pSdoComCon_p->maxSegmentSize);
                         flags = SDO_CMDL_FLAG_SEGMINIT;
                         ami_setUint8Le(&pCommandFrame->flags, flags);
                         ami_setUint16Le(pPayload, (WORD)pSdoComCon_p->targetIndex);
                         pPayload += 2;
                         ami_setUint8Le(pPayload, (UINT8)pSdoComCon_p->targetSubIndex);
                         pPayload += 2;      // on byte for reserved
-                        sizeOfFrame += SDO_MAX_SEGMENT_SIZE;
-                        payloadSize = SDO_MAX_SEGMENT_SIZE - (SDO_CMDL_HDR_VAR_SIZE + SDO_CMDL_HDR_WRITEBYINDEX_SIZE);
-                        OPLK_MEMCPY(pPayload, pSdoComCon_p->pData, payloadSize);
-                        pSdoComCon_p->pData += payloadSize;
+                        sizeOfFrame += pSdoComCon_p->maxSegmentSize;
+                        payloadSize = pSdoComCon_p->maxSegmentSize - (SDO_CMDL_HDR_VAR_SIZE + SDO_CMDL_HDR_WRITEBYINDEX_SIZE);
+                        ret = readObjectData(pSdoComCon_p, 0, pPayload, payloadSize);
+                        if (ret != kErrorOk)
+                            return ret;
                         pSdoComCon_p->transferSize -= payloadSize;
                         pSdoComCon_p->transferredBytes = payloadSize;
                     }
@@ -1970,7 +2942,9 @@ static tOplkError clientSend(tSdoComCon* pSdoComCon_p)
                         pPayload += 2;
                         ami_setUint8Le(pPayload, (UINT8)pSdoComCon_p->targetSubIndex);
                         pPayload += 2;      // + 2 -> one byte for sub index and one byte reserved
-                        OPLK_MEMCPY(pPayload, pSdoComCon_p->pData,  pSdoComCon_p->transferSize);
+                        ret = readObjectData(pSdoComCon_p, 0, pPayload, pSdoComCon_p->transferSize);
+                        if (ret != kErrorOk)
+                            return ret;
                         sizeOfFrame += (pSdoComCon_p->transferSize + SDO_CMDL_HDR_WRITEBYINDEX_SIZE);
                         ami_setUint16Le(&pCommandFrame->segmentSizeLe, (WORD)(pSdoComCon_p->transferSize + SDO_CMDL_HDR_WRITEBYINDEX_SIZE));
                         pSdoComCon_p->transferredBytes = pSdoComCon_p->transferSize;
@@ -1978,6 +2952,24 @@ static tOplkError clientSend(tSdoComCon* pSdoComCon_p)
                     }
                     break;
 
+                case kSdoServiceReadMultiByIndex:
+                case kSdoServiceWriteMultiByIndex:
+                    // multiple parameter transfers are always expedited
+                    pSdoComCon_p->sdoTransferType = kSdoTransExpedited;
+                    payloadSize = clientBuildMultiRequest(pSdoComCon_p, &pCommandFrame->aCommandData[0]);
+                    ami_setUint16Le(&pCommandFrame->segmentSizeLe, (WORD)payloadSize);
+                    sizeOfFrame += payloadSize;
+                    if (pSdoComCon_p->sdoServiceType == kSdoServiceWriteMultiByIndex)
+                    {   // wait for the confirmation of the server
+                        pSdoComCon_p->transferredBytes = payloadSize;
+                        pSdoComCon_p->transferSize = 0;
+                    }
+                    else
+                    {   // wait for the data of the server
+                        pSdoComCon_p->transferredBytes = 1;
+                    }
+                    break;
+
                 case kSdoServiceNIL:
                 default:
                     // invalid service requested
@@ -1993,17 +2985,19 @@ static tOplkError clientSend(tSdoComCon* pSdoComCon_p)
                     // send next frame
                     if (pSdoComCon_p->sdoTransferType == kSdoTransSegmented)
                     {
-                        if (pSdoComCon_p->transferSize > SDO_MAX_SEGMENT_SIZE)
+                        if (pSdoComCon_p->transferSize > pSdoComCon_p->maxSegmentSize)
                         {   // next segment
                             pPayload = &pCommandFrame->aCommandData[0];
-                            ami_setUint16Le(&pCommandFrame->segmentSizeLe, SDO_MAX_SEGMENT_SIZE);
+                            ami_setUint16Le(&pCommandFrame->segmentSizeLe, (WORD)pSdoComCon_p->maxSegmentSize);
                             flags = SDO_CMDL_FLAG_SEGMENTED;
                             ami_setUint8Le(&pCommandFrame->flags, flags);
-                            OPLK_MEMCPY( pPayload,pSdoComCon_p->pData,  SDO_MAX_SEGMENT_SIZE);
-                            pSdoComCon_p->pData += SDO_MAX_SEGMENT_SIZE;
-                            pSdoComCon_p->transferSize -= SDO_MAX_SEGMENT_SIZE;
-                            pSdoComCon_p->transferredBytes += SDO_MAX_SEGMENT_SIZE;
-                            sizeOfFrame += SDO_MAX_SEGMENT_SIZE;
+                            ret = readObjectData(pSdoComCon_p, pSdoComCon_p->transferredBytes, pPayload,
+                                                 pSdoComCon_p->maxSegmentSize);
+                            if (ret != kErrorOk)
+                                return ret;
+                            pSdoComCon_p->transferSize -= pSdoComCon_p->maxSegmentSize;
+                            pSdoComCon_p->transferredBytes += pSdoComCon_p->maxSegmentSize;
+                            sizeOfFrame += pSdoComCon_p->maxSegmentSize;
                         }
                         else
                         {   // end of transfer
@@ -2011,8 +3005,10 @@ static tOplkError clientSend(tSdoComCon* pSdoComCon_p)
                             ami_setUint16Le(&pCommandFrame->segmentSizeLe, (WORD)pSdoComCon_p->transferSize);
                             flags = SDO_CMDL_FLAG_SEGMCOMPL;
                             ami_setUint8Le(&pCommandFrame->flags, flags);
-                            OPLK_MEMCPY(pPayload,pSdoComCon_p->pData,  pSdoComCon_p->transferSize);
-                            pSdoComCon_p->pData += pSdoComCon_p->transferSize;
+                            ret = readObjectData(pSdoComCon_p, pSdoComCon_p->transferredBytes, pPayload,
+                                                 pSdoComCon_p->transferSize);
+                            if (ret != kErrorOk)
+                                return ret;
                             sizeOfFrame += pSdoComCon_p->transferSize;
                             pSdoComCon_p->transferredBytes += pSdoComCon_p->transferSize;
                             pSdoComCon_p->transferSize = 0;
@@ -2127,7 +3123,12 @@ static tOplkError clientProcessFrame(tSdoComConHdl sdoComConHdl_p, tAsySdoCom* p
                                 dataSize = segmentSize;
                             }
 
-                            OPLK_MEMCPY(pSdoComCon->pData, &pSdoCom_p->aCommandData[0], dataSize);
+                            if (writeObjectData(pSdoComCon, 0, &pSdoCom_p->aCommandData[0], dataSize) != kErrorOk)
+                            {
+                                pSdoComCon->lastAbortCode = SDO_AC_GENERAL_ERROR;
+                                ret = transferFinished(sdoComConHdl_p, pSdoComCon, kSdoComTransferRxAborted);
+                                return ret;
+                            }
                             pSdoComCon->transferSize = 0;
                             pSdoComCon->transferredBytes = dataSize;
                             break;
@@ -2152,10 +3153,16 @@ static tOplkError clientProcessFrame(tSdoComConHdl sdoComConHdl_p, tAsySdoCom* p
                             // check size of buffer
                             segmentSize = ami_getUint16Le(&pSdoCom_p->segmentSizeLe);
                             segmentSize -= SDO_CMDL_HDR_VAR_SIZE;
-                            OPLK_MEMCPY(pSdoComCon->pData, &pSdoCom_p->aCommandData[SDO_CMDL_HDR_VAR_SIZE], segmentSize);
+                            if (writeObjectData(pSdoComCon, 0, &pSdoCom_p->aCommandData[SDO_CMDL_HDR_VAR_SIZE],
+                                                segmentSize) != kErrorOk)
+                            {
+                                pSdoComCon->lastAbortCode = SDO_AC_GENERAL_ERROR;
+                                clientSendAbort(pSdoComCon, pSdoComCon->lastAbortCode);
+                                ret = transferFinished(sdoComConHdl_p, pSdoComCon, kSdoComTransferTxAborted);
+                                return ret;
+                            }
 
-                            // correct counter an pointer
-                            pSdoComCon->pData += segmentSize;
+                            // correct counter
                             pSdoComCon->transferredBytes = segmentSize;
                             pSdoComCon->transferSize -= segmentSize;
                             break;
@@ -2172,8 +3179,14 @@ static tOplkError clientProcessFrame(tSdoComConHdl sdoComConHdl_p, tAsySdoCom* p
                                 ret = transferFinished(sdoComConHdl_p, pSdoComCon, kSdoComTransferTxAborted);
                                 return ret;
                             }
-                            OPLK_MEMCPY(pSdoComCon->pData, &pSdoCom_p->aCommandData[0], segmentSize);
-                            pSdoComCon->pData += segmentSize;
+                            if (writeObjectData(pSdoComCon, pSdoComCon->transferredBytes,
+                                                &pSdoCom_p->aCommandData[0], segmentSize) != kErrorOk)
+                            {
+                                pSdoComCon->lastAbortCode = SDO_AC_GENERAL_ERROR;
+                                clientSendAbort(pSdoComCon, pSdoComCon->lastAbortCode);
+                                ret = transferFinished(sdoComConHdl_p, pSdoComCon, kSdoComTransferTxAborted);
+                                return ret;
+                            }
                             pSdoComCon->transferredBytes += segmentSize;
                             pSdoComCon->transferSize -= segmentSize;
                             break;
@@ -2190,14 +3203,27 @@ static tOplkError clientProcessFrame(tSdoComConHdl sdoComConHdl_p, tAsySdoCom* p
                                 ret = transferFinished(sdoComConHdl_p, pSdoComCon, kSdoComTransferTxAborted);
                                 return ret;
                             }
-                            OPLK_MEMCPY(pSdoComCon->pData, &pSdoCom_p->aCommandData[0], segmentSize);
-                            pSdoComCon->pData += segmentSize;
+                            if (writeObjectData(pSdoComCon, pSdoComCon->transferredBytes,
+                                                &pSdoCom_p->aCommandData[0], segmentSize) != kErrorOk)
+                            {
+                                pSdoComCon->lastAbortCode = SDO_AC_GENERAL_ERROR;
+                                clientSendAbort(pSdoComCon, pSdoComCon->lastAbortCode);
+                                ret = transferFinished(sdoComConHdl_p, pSdoComCon, kSdoComTransferTxAborted);
+                                return ret;
+                            }
                             pSdoComCon->transferredBytes += segmentSize;
                             pSdoComCon->transferSize  = 0;
                             break;
                     }
                     break;
 
+                case kSdoServiceReadMultiByIndex:
+                case kSdoServiceWriteMultiByIndex:
+                    // the response is always expedited
+                    clientProcessMultiResponse(pSdoComCon, pSdoCom_p);
+                    pSdoComCon->transferSize = 0;
+                    break;
+
                 case kSdoServiceNIL:
                 default:
                     // invalid service requested
@@ -2272,6 +3298,185 @@ static tOplkError clientSendAbort(tSdoComCon* pSdoComCon_p, UINT32 abortCode_p)
     }
     return ret;
 }
+
+//------------------------------------------------------------------------------
+/**
+\brief  Build a multiple parameter request
+
+The function builds the command layer data of a Read or Write Multiple
+Parameter by Index request from the entries of the transfer. A read request
+contains the index and sub-index of every entry. A write request contains a
+sub-block for every entry which is padded to a multiple of 4 bytes.
+
+\param  pSdoComCon_p            Pointer to SDO command layer connection structure.
+\param  pPayload_p              Pointer to the command layer data of the frame.
+
+\return The function returns the size of the command layer data.
+*/
+//------------------------------------------------------------------------------
+static UINT clientBuildMultiRequest(tSdoComCon* pSdoComCon_p, UINT8* pPayload_p)
+{
+    tSdoMultiAccEntry*  pEntry;
+    UINT8*              pSubBlock;
+    UINT                entry;
+    UINT                offset;
+    UINT                nextOffset;
+
+    offset = 0;
+    for (entry = 0; entry < pSdoComCon_p->multiEntryCount; entry++)
+    {
+        pEntry = &pSdoComCon_p->paMultiEntry[entry];
+        pSubBlock = &pPayload_p[offset];
+        if (pSdoComCon_p->sdoServiceType == kSdoServiceReadMultiByIndex)
+        {
+            ami_setUint16Le(&pSubBlock[0], (UINT16)pEntry->index);
+            ami_setUint8Le(&pSubBlock[2], (UINT8)pEntry->subindex);
+            offset += SDO_CMDL_HDR_MULTI_READ_SIZE;
+        }
+        else
+        {
+            nextOffset = offset + SDO_MULTI_SUBBLOCK_SIZE(pEntry->dataSize);
+            // the last sub-block has the offset 0
+            ami_setUint32Le(&pSubBlock[0], ((entry + 1) < pSdoComCon_p->multiEntryCount) ? nextOffset : 0);
+            ami_setUint16Le(&pSubBlock[4], (UINT16)pEntry->index);
+            ami_setUint8Le(&pSubBlock[6], (UINT8)pEntry->subindex);
+            ami_setUint8Le(&pSubBlock[7], (UINT8)(nextOffset - offset - SDO_CMDL_HDR_MULTI_SUBHDR_SIZE - pEntry->dataSize));
+            OPLK_MEMCPY(&pSubBlock[SDO_CMDL_HDR_MULTI_SUBHDR_SIZE], pEntry->pData, pEntry->dataSize);
+            offset = nextOffset;
+        }
+    }
+
+    return offset;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process a multiple parameter response
+
+The function stores the results of a Read or Write Multiple Parameter by Index
+response in the entries of the transfer. The response of a write contains
+only the entries which could not be written. The response of a read contains
+the data or the sub-abort code of every entry. The number of transferred data
+bytes is stored in the connection.
+
+\param  pSdoComCon_p            Pointer to SDO command layer connection structure.
+\param  pSdoCom_p               Pointer to received frame.
+*/
+//------------------------------------------------------------------------------
+static void clientProcessMultiResponse(tSdoComCon* pSdoComCon_p, tAsySdoCom* pSdoCom_p)
+{
+    tSdoMultiAccEntry*  pEntry;
+    UINT8*              pSubBlock;
+    UINT                segmentSize;
+    UINT                entryIndex;
+    UINT                offset;
+    UINT                nextOffset;
+    UINT                dataEnd;
+    UINT                dataSize;
+    UINT8               flags;
+
+    segmentSize = ami_getUint16Le(&pSdoCom_p->segmentSizeLe);
+    entryIndex = 0;
+    pSdoComCon_p->transferredBytes = 0;
+
+    if (pSdoComCon_p->sdoServiceType == kSdoServiceWriteMultiByIndex)
+    {
+        for (offset = 0; (offset + SDO_CMDL_HDR_MULTI_SUBABORT_SIZE) <= segmentSize;
+             offset += SDO_CMDL_HDR_MULTI_SUBABORT_SIZE)
+        {
+            pSubBlock = &pSdoCom_p->aCommandData[offset];
+            pEntry = findMultiEntry(pSdoComCon_p, &entryIndex, ami_getUint16Le(&pSubBlock[0]),
+                                    ami_getUint8Le(&pSubBlock[2]));
+            if (pEntry != NULL)
+                pEntry->abortCode = ami_getUint32Le(&pSubBlock[4]);
+        }
+
+        for (entryIndex = 0; entryIndex < pSdoComCon_p->multiEntryCount; entryIndex++)
+        {
+            if (pSdoComCon_p->paMultiEntry[entryIndex].abortCode == 0)
+                pSdoComCon_p->transferredBytes += pSdoComCon_p->paMultiEntry[entryIndex].dataSize;
+        }
+        return;
+    }
+
+    offset = 0;
+    while ((offset + SDO_CMDL_HDR_MULTI_SUBHDR_SIZE) <= segmentSize)
+    {
+        pSubBlock = &pSdoCom_p->aCommandData[offset];
+        nextOffset = ami_getUint32Le(&pSubBlock[0]);
+        dataEnd = (nextOffset != 0) ? nextOffset : segmentSize;
+        if ((dataEnd > segmentSize) || (dataEnd < (offset + SDO_CMDL_HDR_MULTI_SUBHDR_SIZE)))
+            break;      // invalid sub-block, the remaining entries stay failed
+
+        flags = ami_getUint8Le(&pSubBlock[7]);
+        dataSize = dataEnd - offset - SDO_CMDL_HDR_MULTI_SUBHDR_SIZE;
+        pEntry = findMultiEntry(pSdoComCon_p, &entryIndex, ami_getUint16Le(&pSubBlock[4]),
+                                ami_getUint8Le(&pSubBlock[6]));
+        if (pEntry != NULL)
+        {
+            if ((flags & SDO_CMDL_MULTI_FLAG_SUBABORT) != 0)
+            {
+                if (dataSize >= sizeof(UINT32))
+                    pEntry->abortCode = ami_getUint32Le(&pSubBlock[SDO_CMDL_HDR_MULTI_SUBHDR_SIZE]);
+            }
+            else if (dataSize >= (UINT)(flags & SDO_CMDL_MULTI_PADDING_MASK))
+            {
+                dataSize -= (flags & SDO_CMDL_MULTI_PADDING_MASK);
+                if (dataSize > pEntry->dataSize)
+                {   // buffer provided by the application is too small -> copy only a part
+                    dataSize = pEntry->dataSize;
+                }
+
+                OPLK_MEMCPY(pEntry->pData, &pSubBlock[SDO_CMDL_HDR_MULTI_SUBHDR_SIZE], dataSize);
+                pEntry->dataSize = dataSize;
+                pEntry->abortCode = 0;
+                pSdoComCon_p->transferredBytes += dataSize;
+            }
+        }
+
+        if (nextOffset == 0)
+            break;
+        offset = nextOffset;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find entry of a multiple parameter transfer
+
+The function searches the entry of a multiple parameter transfer an answer
+sub-block belongs to. The server answers the entries in the order of the
+request, therefore the search starts behind the last found entry.
+
+\param  pSdoComCon_p            Pointer to SDO command layer connection structure.
+\param  pEntryIndex_p           Pointer to the array index where the search
+                                starts. The index behind the found entry is
+                                stored at this location.
+\param  index_p                 Index of the answered object.
+\param  subIndex_p              Sub-index of the answered object.
+
+\return The function returns a pointer to the entry or NULL if no entry is
+        found.
+*/
+//------------------------------------------------------------------------------
+static tSdoMultiAccEntry* findMultiEntry(tSdoComCon* pSdoComCon_p, UINT* pEntryIndex_p,
+                                         UINT index_p, UINT subIndex_p)
+{
+    tSdoMultiAccEntry*  pEntry;
+    UINT                entryIndex;
+
+    for (entryIndex = *pEntryIndex_p; entryIndex < pSdoComCon_p->multiEntryCount; entryIndex++)
+    {
+        pEntry = &pSdoComCon_p->paMultiEntry[entryIndex];
+        if ((pEntry->index == index_p) && (pEntry->subindex == subIndex_p))
+        {
+            *pEntryIndex_p = entryIndex + 1;
+            return pEntry;
+        }
+    }
+
+    return NULL;
+}
 #endif
 
 //------------------------------------------------------------------------------
@@ -2295,6 +3500,8 @@ static tOplkError transferFinished(tSdoComConHdl sdoComConHdl_p, tSdoComCon* pSd
     tSdoFinishedCb  pfnTransferFinished;
     tSdoComFinished sdoComFinished;
 
+    finishStream(pSdoComCon_p, (sdoComConState_p != kSdoComTransferFinished));
+
     if(pSdoComCon_p->pfnTransferFinished != NULL)
     {
 
@@ -2303,10 +3510,12 @@ static tOplkError transferFinished(tSdoComConHdl sdoComConHdl_p, tSdoComCon* pSd
         sdoComFinished.targetIndex = pSdoComCon_p->targetIndex;
         sdoComFinished.targetSubIndex = pSdoComCon_p->targetSubIndex;
         sdoComFinished.transferredBytes = pSdoComCon_p->transferredBytes;
+        sdoComFinished.transferTimeMs = target_getTickCount() - pSdoComCon_p->startTickCount;
         sdoComFinished.abortCode = pSdoComCon_p->lastAbortCode;
         sdoComFinished.sdoComConHdl = sdoComConHdl_p;
         sdoComFinished.sdoComConState = sdoComConState_p;
-        if (pSdoComCon_p->sdoServiceType == kSdoServiceWriteByIndex)
+        if ((pSdoComCon_p->sdoServiceType == kSdoServiceWriteByIndex) ||
+            (pSdoComCon_p->sdoServiceType == kSdoServiceWriteMultiByIndex))
         {
             sdoComFinished.sdoAccessType = kSdoAccessTypeWrite;
         }
@@ -2329,5 +3538,185 @@ static tOplkError transferFinished(tSdoComConHdl sdoComConHdl_p, tSdoComCon* pSd
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get maximum segment size
+
+The function determines the maximum segment size of a segmented transfer. The
+segments use the whole asynchronous MTU (object 0x1F98/8 NMT_CycleTiming_REC.
+AsyncMTU_U16), limited by the size of the frame buffers (SDO_MAX_SEGMENT_SIZE).
+
+\return The function returns the maximum segment size in bytes.
+*/
+//------------------------------------------------------------------------------
+static UINT getMaxSegmentSize(void)
+{
+    tOplkError      ret;
+    UINT16          asyncMtu;
+    tObdSize        obdSize;
+    UINT            segmentSize;
+
+    obdSize = sizeof(asyncMtu);
+    ret = obd_readEntry(0x1F98, 8, &asyncMtu, &obdSize);
+    if ((ret != kErrorOk) || (asyncMtu < C_DLL_MIN_ASYNC_MTU))
+        asyncMtu = C_DLL_MIN_ASYNC_MTU;
+
+    segmentSize = asyncMtu - SDO_ASYNC_HEADER_SIZE;
+    if (segmentSize > SDO_MAX_SEGMENT_SIZE)
+        segmentSize = SDO_MAX_SEGMENT_SIZE;
+
+    return segmentSize;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Read data of the transferred object
+
+The function reads data of the transferred object into a frame. The data is
+read from the stream of the transfer if the transferred domain is backed by a
+stream, otherwise it is copied from the data pointer of the connection, which
+is advanced.
+
+\param  pSdoComCon_p            Pointer to SDO command layer connection structure.
+\param  offset_p                Offset of the data in the object.
+\param  pDstData_p              Pointer to store the data.
+\param  size_p                  Size of the data.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError readObjectData(tSdoComCon* pSdoComCon_p, UINT offset_p, void* pDstData_p, UINT size_p)
+{
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    if (pSdoComCon_p->pStream != NULL)
+    {
+        return pSdoComCon_p->pStream->pfnAccess(pSdoComCon_p->pStream->pArg, kObdDomainStreamRead,
+                                                offset_p, pDstData_p, size_p);
+    }
+#else
+    UNUSED_PARAMETER(offset_p);
+#endif
+
+    OPLK_MEMCPY(pDstData_p, pSdoComCon_p->pData, size_p);
+    pSdoComCon_p->pData += size_p;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write data of the transferred object
+
+The function writes data of a received frame to the transferred object. The
+data is written to the stream of the transfer if the transferred domain is
+backed by a stream, otherwise it is copied to the data pointer of the
+connection, which is advanced. The data of a read into a scatter list is
+copied across the buffers of the list.
+
+\param  pSdoComCon_p            Pointer to SDO command layer connection structure.
+\param  offset_p                Offset of the data in the object.
+\param  pSrcData_p              Pointer to the received data.
+\param  size_p                  Size of the data.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError writeObjectData(tSdoComCon* pSdoComCon_p, UINT offset_p, const void* pSrcData_p, UINT size_p)
+{
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    if (pSdoComCon_p->pStream != NULL)
+    {
+        return pSdoComCon_p->pStream->pfnAccess(pSdoComCon_p->pStream->pArg, kObdDomainStreamWrite,
+                                                offset_p, (void*)pSrcData_p, size_p);
+    }
+#else
+    UNUSED_PARAMETER(offset_p);
+#endif
+
+#if defined(CONFIG_INCLUDE_SDOC)
+    if (pSdoComCon_p->pScatterEntry != NULL)
+        return writeScatterData(pSdoComCon_p, pSrcData_p, size_p);
+#endif
+
+    OPLK_MEMCPY(pSdoComCon_p->pData, pSrcData_p, size_p);
+    pSdoComCon_p->pData += size_p;
+    return kErrorOk;
+}
+
+#if defined(CONFIG_INCLUDE_SDOC)
+//------------------------------------------------------------------------------
+/**
+\brief  Write data to the scatter list of a read
+
+The function copies data of a received frame to the scatter list of a read.
+The data pointer of the connection points into the current buffer of the list.
+It is moved to the next buffer when the current one is full.
+
+\param  pSdoComCon_p            Pointer to SDO command layer connection structure.
+\param  pSrcData_p              Pointer to the received data.
+\param  size_p                  Size of the data.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError writeScatterData(tSdoComCon* pSdoComCon_p, const void* pSrcData_p, UINT size_p)
+{
+    const UINT8*    pSrcData = (const UINT8*)pSrcData_p;
+    UINT            copySize;
+
+    while (size_p > 0)
+    {
+        if (pSdoComCon_p->scatterSize == 0)
+        {   // current buffer is full -> continue with the next one
+            if (pSdoComCon_p->scatterEntryCount == 0)
+                return kErrorSdoComInvalidParam;
+
+            pSdoComCon_p->pData = (UINT8*)pSdoComCon_p->pScatterEntry->pData;
+            pSdoComCon_p->scatterSize = pSdoComCon_p->pScatterEntry->size;
+            pSdoComCon_p->pScatterEntry++;
+            pSdoComCon_p->scatterEntryCount--;
+            continue;
+        }
+
+        copySize = min(size_p, pSdoComCon_p->scatterSize);
+        OPLK_MEMCPY(pSdoComCon_p->pData, pSrcData, copySize);
+        pSdoComCon_p->pData += copySize;
+        pSdoComCon_p->scatterSize -= copySize;
+        pSrcData += copySize;
+        size_p -= copySize;
+    }
+
+    return kErrorOk;
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief  Finish the stream of a transfer
+
+The function closes or aborts the stream of the transfer of a connection and
+detaches it from the connection. It does nothing if the transferred object is
+not backed by a stream.
+
+\param  pSdoComCon_p            Pointer to SDO command layer connection structure.
+\param  fAbort_p                TRUE if the transfer was aborted.
+*/
+//------------------------------------------------------------------------------
+static void finishStream(tSdoComCon* pSdoComCon_p, BOOL fAbort_p)
+{
+#if (CONFIG_OBD_DOMAIN_STREAM_COUNT != 0)
+    tObdDomainStream*   pStream = pSdoComCon_p->pStream;
+
+    if (pStream == NULL)
+        return;
+
+    pSdoComCon_p->pStream = NULL;
+    pStream->pfnAccess(pStream->pArg, (fAbort_p ? kObdDomainStreamAbort : kObdDomainStreamClose),
+                       pSdoComCon_p->transferredBytes, NULL, 0);
+#else
+    UNUSED_PARAMETER(pSdoComCon_p);
+    UNUSED_PARAMETER(fAbort_p);
+#endif
+}
+
 ///\}
 
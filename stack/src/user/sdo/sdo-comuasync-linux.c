@@ -0,0 +1,331 @@
+/**
+********************************************************************************
+\file   sdo-comuasync-linux.c
+
+\brief  OD access worker threads of the asynchronous SDO server
+
+This file implements the worker threads which execute OD accesses of the SDO
+server for Linux userspace. The SDO command layer hands expedited accesses to
+objects with a callback function to the workers, so a slow object callback
+(e.g. one that fetches its data from a storage) does not block the user event
+thread. The sequence layer acknowledges the request meanwhile, and all other
+SDO connections and stack events continue to be processed. When an access is
+finished, the worker posts a kEventTypeSdoObdAccessDone event, and the command
+layer sends the response from the user event thread.
+
+The object callbacks of deferred accesses are called by the worker threads,
+concurrently to the other OD accesses of the stack and the application.
+
+The workers are enabled with CONFIG_SDO_SERVER_ASYNC.
+
+\ingroup module_sdo_com
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+#include <user/sdocom.h>
+#include <user/eventu.h>
+#include <common/target.h>
+
+#if defined(CONFIG_INCLUDE_SDOS) && (CONFIG_SDO_SERVER_ASYNC != FALSE)
+
+#include <pthread.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define SDOCOM_OBD_QUEUE_MASK           (CONFIG_SDO_SERVER_ASYNC_QUEUE_SIZE - 1)
+
+#if ((CONFIG_SDO_SERVER_ASYNC_QUEUE_SIZE & SDOCOM_OBD_QUEUE_MASK) != 0)
+#error "CONFIG_SDO_SERVER_ASYNC_QUEUE_SIZE must be a power of two!"
+#endif
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief OD access worker instance
+
+The structure contains the instance variables of the OD access workers. The
+queue is protected by the mutex.
+*/
+typedef struct
+{
+    pthread_t           aThreadId[CONFIG_SDO_SERVER_ASYNC_WORKERS];    ///< IDs of the worker threads
+    UINT                threadCount;                    ///< Number of started worker threads
+    pthread_mutex_t     mutex;                          ///< Mutex protecting the queue
+    pthread_cond_t      condition;                      ///< Condition to wake up the worker threads
+    BOOL                fStopThreads;                   ///< Flag to stop the worker threads
+    BOOL                fInitialized;                   ///< Flag determines if the workers are initialized
+    UINT                readIndex;                      ///< Index of the next access to be executed
+    UINT                count;                          ///< Number of queued accesses
+    tSdoComObdAccess    aQueue[CONFIG_SDO_SERVER_ASYNC_QUEUE_SIZE];    ///< Queued accesses
+} tSdoComObdWorkerInstance;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tSdoComObdWorkerInstance instance_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void* workerThread(void* pArg_p);
+static void  executeObdAccess(tSdoComObdAccess* pObdAccess_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize OD access workers
+
+The function initializes the queue and starts the worker threads. The workers
+are no realtime threads, they are only placed if the application configures
+the role kThreadRoleSdoServer.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_sdo_com
+*/
+//------------------------------------------------------------------------------
+tOplkError sdocom_initObdWorkers(void)
+{
+    UINT        index;
+
+    OPLK_MEMSET(&instance_l, 0, sizeof(tSdoComObdWorkerInstance));
+
+    if (pthread_mutex_init(&instance_l.mutex, NULL) != 0)
+        return kErrorNoResource;
+
+    if (pthread_cond_init(&instance_l.condition, NULL) != 0)
+    {
+        pthread_mutex_destroy(&instance_l.mutex);
+        return kErrorNoResource;
+    }
+
+    instance_l.fInitialized = TRUE;
+
+    for (index = 0; index < CONFIG_SDO_SERVER_ASYNC_WORKERS; index++)
+    {
+        if (target_createThread(&instance_l.aThreadId[index], kThreadRoleSdoServer, "oplk-sdoserver",
+                                workerThread, (void*)&instance_l) != kErrorOk)
+        {
+            sdocom_exitObdWorkers();
+            return kErrorNoResource;
+        }
+
+        instance_l.threadCount++;
+        target_setThreadParams(instance_l.aThreadId[index], kThreadRoleSdoServer,
+                               kThreadSchedDefault, 0, 0);
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Clean up OD access workers
+
+The function stops the worker threads. Queued accesses are discarded, the
+accesses which are executed at the moment are finished first.
+
+\ingroup module_sdo_com
+*/
+//------------------------------------------------------------------------------
+void sdocom_exitObdWorkers(void)
+{
+    UINT        index;
+
+    if (!instance_l.fInitialized)
+        return;
+
+    pthread_mutex_lock(&instance_l.mutex);
+    instance_l.fInitialized = FALSE;
+    instance_l.fStopThreads = TRUE;
+    pthread_cond_broadcast(&instance_l.condition);
+    pthread_mutex_unlock(&instance_l.mutex);
+
+    for (index = 0; index < instance_l.threadCount; index++)
+        pthread_join(instance_l.aThreadId[index], NULL);
+
+    pthread_cond_destroy(&instance_l.condition);
+    pthread_mutex_destroy(&instance_l.mutex);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Queue an OD access for the worker threads
+
+The function copies an OD access into the queue of the worker threads.
+
+\param  pObdAccess_p            OD access to be executed.
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                The access was queued.
+\retval kErrorReject            The access must be executed by the caller,
+                                because the workers are not running or the
+                                queue is full.
+
+\ingroup module_sdo_com
+*/
+//------------------------------------------------------------------------------
+tOplkError sdocom_queueObdAccess(const tSdoComObdAccess* pObdAccess_p)
+{
+    if (!instance_l.fInitialized)
+        return kErrorReject;
+
+    pthread_mutex_lock(&instance_l.mutex);
+
+    if (instance_l.count == CONFIG_SDO_SERVER_ASYNC_QUEUE_SIZE)
+    {
+        pthread_mutex_unlock(&instance_l.mutex);
+        return kErrorReject;
+    }
+
+    instance_l.aQueue[(instance_l.readIndex + instance_l.count) & SDOCOM_OBD_QUEUE_MASK] = *pObdAccess_p;
+    instance_l.count++;
+    pthread_cond_signal(&instance_l.condition);
+    pthread_mutex_unlock(&instance_l.mutex);
+
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  OD access worker thread
+
+The thread executes the queued OD accesses. The mutex is released while an
+access is executed.
+
+\param  pArg_p                  Thread argument (pointer to the instance).
+
+\return The function returns the thread exit code.
+*/
+//------------------------------------------------------------------------------
+static void* workerThread(void* pArg_p)
+{
+    tSdoComObdWorkerInstance*   pInstance = (tSdoComObdWorkerInstance*)pArg_p;
+    tSdoComObdAccess            obdAccess;
+
+    pthread_mutex_lock(&pInstance->mutex);
+    for (;;)
+    {
+        while ((pInstance->count == 0) && !pInstance->fStopThreads)
+            pthread_cond_wait(&pInstance->condition, &pInstance->mutex);
+
+        if (pInstance->fStopThreads)
+            break;
+
+        obdAccess = pInstance->aQueue[pInstance->readIndex];
+        pInstance->readIndex = (pInstance->readIndex + 1) & SDOCOM_OBD_QUEUE_MASK;
+        pInstance->count--;
+        pthread_mutex_unlock(&pInstance->mutex);
+
+        executeObdAccess(&obdAccess);
+
+        pthread_mutex_lock(&pInstance->mutex);
+    }
+    pthread_mutex_unlock(&pInstance->mutex);
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Execute an OD access
+
+The function executes an OD access and posts its result to the command layer.
+
+\param  pObdAccess_p            OD access to be executed.
+*/
+//------------------------------------------------------------------------------
+static void executeObdAccess(tSdoComObdAccess* pObdAccess_p)
+{
+    tEvent          event;
+    tOplkError      ret;
+
+    if (pObdAccess_p->fWrite)
+    {
+        pObdAccess_p->result = obd_writeEntryFromLe(pObdAccess_p->index, pObdAccess_p->subIndex,
+                                                    pObdAccess_p->aData, pObdAccess_p->size);
+    }
+    else
+    {
+        pObdAccess_p->result = obd_readEntryToLe(pObdAccess_p->index, pObdAccess_p->subIndex,
+                                                 pObdAccess_p->aData, &pObdAccess_p->size);
+    }
+
+    event.eventSink = kEventSinkSdoCom;
+    event.eventType = kEventTypeSdoObdAccessDone;
+    event.pEventArg = pObdAccess_p;
+    event.eventArgSize = sizeof(tSdoComObdAccess);
+
+    ret = eventu_postEvent(&event);
+    if (ret != kErrorOk)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() posting result of 0x%04X/%u failed (0x%X)\n",
+                              __func__, pObdAccess_p->index, pObdAccess_p->subIndex, ret);
+    }
+}
+
+/// \}
+
+#endif // defined(CONFIG_INCLUDE_SDOS) && (CONFIG_SDO_SERVER_ASYNC != FALSE)
@@ -41,6 +41,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <common/ami.h>
+#include <common/target.h>
 #include <user/sdoseq.h>
 
 #if !defined(CONFIG_INCLUDE_SDO_UDP) && !defined(CONFIG_INCLUDE_SDO_ASND)
@@ -54,12 +55,33 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
-#define SDO_HISTORY_SIZE            5
+#ifndef CONFIG_SDO_SEQ_HISTORY_SIZE
+#define CONFIG_SDO_SEQ_HISTORY_SIZE               5
+#endif
+
+// Maximum number of frames which can be sent without acknowledge. The sequence
+// number range limits the window, see SDO_SEQ_NUM_THRESHOLD.
+#define SDO_HISTORY_SIZE            CONFIG_SDO_SEQ_HISTORY_SIZE
+
+#ifndef CONFIG_SDO_SEQ_WINDOW_SIZE
+#define CONFIG_SDO_SEQ_WINDOW_SIZE                CONFIG_SDO_SEQ_HISTORY_SIZE
+#endif
 
 #ifndef CONFIG_SDO_MAX_CONNECTION_SEQ
 #define CONFIG_SDO_MAX_CONNECTION_SEQ             5
 #endif
 
+// Size of the hash table which maps the connection handles of the lower layers
+// to sequence layer connections
+#ifndef CONFIG_SDO_SEQ_CON_HASH_SIZE
+#define CONFIG_SDO_SEQ_CON_HASH_SIZE              (2 * CONFIG_SDO_MAX_CONNECTION_SEQ)
+#endif
+
+// Number of history frame buffers which are shared by all connections
+#ifndef CONFIG_SDO_SEQ_HISTORY_POOL_SIZE
+#define CONFIG_SDO_SEQ_HISTORY_POOL_SIZE          (CONFIG_SDO_MAX_CONNECTION_SEQ * CONFIG_SDO_SEQ_WINDOW_SIZE)
+#endif
+
 #define SDO_SEQ_DEFAULT_TIMEOUT     5000                    // in [ms] => 5 sec
 #define SDO_SEQ_RETRY_COUNT         5                       // => max. Timeout 30 sec
 #define SDO_SEQ_NUM_THRESHOLD       100                     // threshold which distinguishes between old and new sequence numbers
@@ -68,6 +90,19 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define SDO_SEQ_HISTROY_FRAME_SIZE  SDO_MAX_FRAME_SIZE      // buffersize for one frame in history
 #define SDO_CON_MASK                0x03                    // mask to get scon and rcon
 
+// hash function for lower layer connection handles (UDP and ASnd handles with
+// the same index are mapped to adjacent entries)
+#define SDO_SEQ_CON_HASH(conHdl_p)  (((((conHdl_p) & ~SDO_ASY_HANDLE_MASK) << 1) | \
+                                      (((conHdl_p) & SDO_UDP_HANDLE) ? 1 : 0)) % CONFIG_SDO_SEQ_CON_HASH_SIZE)
+
+#if ((SDO_HISTORY_SIZE < 2) || ((SDO_HISTORY_SIZE * 4) >= SDO_SEQ_NUM_THRESHOLD))
+#error "CONFIG_SDO_SEQ_HISTORY_SIZE is out of range!"
+#endif
+
+#if ((CONFIG_SDO_SEQ_WINDOW_SIZE < 2) || (CONFIG_SDO_SEQ_WINDOW_SIZE > SDO_HISTORY_SIZE))
+#error "CONFIG_SDO_SEQ_WINDOW_SIZE is out of range!"
+#endif
+
 const UINT32 SDO_SEQU_MAX_TIMEOUT_MS = (UINT32)86400000UL; // [ms], 86400000 ms = 1 day
 
 //------------------------------------------------------------------------------
@@ -108,18 +143,61 @@ typedef enum
 /**
 \brief  SDO sequence layer connection history
 
-This structure defines the SDO sequence layer connection history buffer.
+This structure defines the SDO sequence layer connection history buffer. The
+frames are stored in buffers of the history frame pool which is shared by all
+connections.
+
+The sender requests an acknowledge as soon as the number of free entries drops
+to the acknowledge request threshold, so the acknowledge can arrive before the
+window is exhausted. The threshold is raised if the sender had to wait for an
+acknowledge and lowered if the acknowledge arrived in time.
 */
 typedef struct
 {
-    UINT8           freeEntries;    ///< Number of free history entries
-    UINT8           writeIndex;     ///< Index of the next free buffer entry
-    UINT8           ackIndex;       ///< Index of the next message which should become acknowledged
-    UINT8           readIndex;      ///< Index between ackIndex and writeIndex to the next message for retransmission
-    UINT8           aHistoryFrame[SDO_HISTORY_SIZE][SDO_SEQ_HISTROY_FRAME_SIZE];
+    UINT8           freeEntries;            ///< Number of free history entries within the window
+    UINT8           windowSize;             ///< Number of frames which can be sent without acknowledge
+    UINT8           writeIndex;             ///< Index of the next free buffer entry
+    UINT8           ackIndex;               ///< Index of the next message which should become acknowledged
+    UINT8           readIndex;              ///< Index between ackIndex and writeIndex to the next message for retransmission
+    UINT8           ackRequestThreshold;    ///< Number of free entries at which an acknowledge is requested
+    BOOL            fAckRequested;          ///< An acknowledge request is outstanding
+    BOOL            fStalled;               ///< The sender had to wait for the outstanding acknowledge
+    UINT8*          apHistoryFrame[SDO_HISTORY_SIZE];   ///< Frame buffers of the history frame pool
     UINT            aFrameSize[SDO_HISTORY_SIZE];
 }tSdoSeqConHistory;
 
+#if (CONFIG_SDO_SEQ_ADAPTIVE_RTO != FALSE)
+/**
+\brief  SDO sequence layer retransmission timeout
+
+This structure contains the round trip time estimation of a connection. The
+round trip time is measured for one frame at a time, from sending it until its
+acknowledge is received. Frames which were retransmitted are not measured,
+because the acknowledge can't be assigned to one of the transmissions. The
+smoothed round trip time and its variance are kept in fixed point format like
+in TCP (RFC 6298), the retransmission timeout is their sum with four times the
+variance. It is doubled on every timeout until a new measurement is available.
+
+Acknowledges which don't acknowledge a new frame while frames are outstanding
+are counted as duplicate acknowledges. If the threshold is reached, the frames
+are retransmitted without waiting for the timeout. Repeated retransmission
+requests of the receiver for the same frame are served only once.
+*/
+typedef struct
+{
+    UINT32          rto;                    ///< Retransmission timeout in [ms]
+    INT32           srtt;                   ///< Smoothed round trip time in [ms / 8]
+    INT32           rttVar;                 ///< Round trip time variance in [ms / 4]
+    BOOL            fRttValid;              ///< The round trip time was measured at least once
+    BOOL            fRttPending;            ///< The round trip time of a frame is measured
+    UINT8           rttSeqNum;              ///< Sequence number of the measured frame
+    UINT32          rttStartTime;           ///< Tick count when the measured frame was sent
+    UINT8           lastAckSeqNum;          ///< Sequence number of the last received acknowledge
+    UINT            dupAckCount;            ///< Number of duplicate acknowledges
+    BOOL            fRetransmitted;         ///< A retransmission request of the receiver was served
+}tSdoSeqConRto;
+#endif
+
 /**
 \brief  SDO sequence layer states
 
@@ -148,6 +226,9 @@ typedef struct
     UINT8                   recvSeqNum;         ///< Receive sequence number
     UINT8                   sendSeqNum;         ///< Send sequence number
     tSdoSeqConHistory       sdoSeqConHistory;   ///< Connection history buffer
+#if (CONFIG_SDO_SEQ_ADAPTIVE_RTO != FALSE)
+    tSdoSeqConRto           sdoSeqConRto;       ///< Retransmission timeout
+#endif
     tTimerHdl               timerHandle;        ///< Timer handle
     UINT                    retryCount;         ///< Retry counter
     UINT                    useCount;           ///< One sequence layer connection may be used by multiple command layer connections
@@ -164,6 +245,10 @@ typedef struct
     tSdoComReceiveCb        pfnSdoComRecvCb;                            ///< Pointer to receive callback function
     tSdoComConCb            pfnSdoComConCb;                             ///< Pointer to connection callback function
     UINT32                  sdoSeqTimeout;                              ///< Configured Sequence layer timeout
+    UINT                    aConHashTable[CONFIG_SDO_SEQ_CON_HASH_SIZE];///< Connection index hashed by lower layer connection handle
+    UINT8                   aHistoryPool[CONFIG_SDO_SEQ_HISTORY_POOL_SIZE][SDO_SEQ_HISTROY_FRAME_SIZE];  ///< History frame pool
+    UINT8*                  apFreeHistoryFrame[CONFIG_SDO_SEQ_HISTORY_POOL_SIZE];                       ///< Free buffers of the history frame pool
+    UINT                    freeHistoryFrameCount;                      ///< Number of free buffers in the history frame pool
 
 #if defined(WIN32) || defined(_WIN32)
     LPCRITICAL_SECTION      pCriticalSection;
@@ -212,8 +297,16 @@ static tOplkError sendToLowerLayer(tSdoSeqCon* pSdoSeqCon_p, UINT dataSize_p, tP
 
 static tOplkError receiveCb(tSdoConHdl conHdl_p, tAsySdoSeq* pSdoSeqData_p, UINT dataSize_p);
 
+static UINT       searchConnection(tSdoConHdl conHdl_p);
+
+static UINT       getFreeConnection(void);
+
+static void       assignConnection(UINT index_p, tSdoConHdl conHdl_p);
+
 static tOplkError initHistory(tSdoSeqCon* pSdoSeqCon_p);
 
+static void       releaseHistory(tSdoSeqCon* pSdoSeqCon_p);
+
 static tOplkError addFrameToHistory(tSdoSeqCon* pSdoSeqCon_p, tPlkFrame* pFrame_p, UINT size_p);
 
 static tOplkError deleteAckedFrameFromHistory(tSdoSeqCon* pSdoSeqCon_p, UINT8 recvSeqNumber_p);
@@ -225,6 +318,20 @@ static UINT       getFreeHistoryEntries(tSdoSeqCon* pSdoSeqCon_p);
 
 static tOplkError setTimer(tSdoSeqCon* pSdoSeqCon_p, ULONG timeout_p);
 
+static ULONG      getRetransmitTimeout(tSdoSeqCon* pSdoSeqCon_p);
+
+static tOplkError retransmitFirstFrame(tSdoSeqCon* pSdoSeqCon_p);
+
+#if (CONFIG_SDO_SEQ_ADAPTIVE_RTO != FALSE)
+static void       initRto(tSdoSeqCon* pSdoSeqCon_p);
+
+static void       startRttMeasurement(tSdoSeqCon* pSdoSeqCon_p, tPlkFrame* pFrame_p);
+
+static void       updateRto(tSdoSeqCon* pSdoSeqCon_p, UINT8 ackSeqNum_p, BOOL fNewAck_p);
+
+static BOOL       isRetransmitRequested(tSdoSeqCon* pSdoSeqCon_p, BOOL fErrorResponse_p);
+#endif
+
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
 //============================================================================//
@@ -290,6 +397,14 @@ tOplkError sdoseq_addInstance(tSdoComReceiveCb pfnSdoComRecvCb_p, tSdoComConCb p
 
     OPLK_MEMSET(&sdoSeqInstance_l.aSdoSeqCon[0], 0x00, sizeof(sdoSeqInstance_l.aSdoSeqCon));
 
+    for (sdoSeqInstance_l.freeHistoryFrameCount = 0;
+         sdoSeqInstance_l.freeHistoryFrameCount < CONFIG_SDO_SEQ_HISTORY_POOL_SIZE;
+         sdoSeqInstance_l.freeHistoryFrameCount++)
+    {
+        sdoSeqInstance_l.apFreeHistoryFrame[sdoSeqInstance_l.freeHistoryFrameCount] =
+            sdoSeqInstance_l.aHistoryPool[sdoSeqInstance_l.freeHistoryFrameCount];
+    }
+
 #if defined(WIN32) || defined(_WIN32)
     // create critical section for process function
     sdoSeqInstance_l.pCriticalSection = &sdoSeqInstance_l.criticalSection;
@@ -420,24 +535,10 @@ tOplkError sdoseq_initCon(tSdoSeqConHdl* pSdoSeqConHdl_p, UINT nodeId_p, tSdoTyp
     }
 
     // find existing connection to the same node or find empty entry for connection
-    count = 0;
-    freeCon = CONFIG_SDO_MAX_CONNECTION_SEQ;
-    pSdoSeqCon = &sdoSeqInstance_l.aSdoSeqCon[0];
-
-    while (count < CONFIG_SDO_MAX_CONNECTION_SEQ)
-    {
-        if (pSdoSeqCon->conHandle == conHandle)
-            break;
-
-        if (pSdoSeqCon->conHandle == 0)
-            freeCon = count;
-
-        count++;
-        pSdoSeqCon++;
-    }
-
+    count = searchConnection(conHandle);
     if (count == CONFIG_SDO_MAX_CONNECTION_SEQ)
     {
+        freeCon = getFreeConnection();
         if (freeCon == CONFIG_SDO_MAX_CONNECTION_SEQ)
         {   // no free entry found
             switch (sdoType_p)
@@ -469,7 +570,7 @@ tOplkError sdoseq_initCon(tSdoSeqConHdl* pSdoSeqConHdl_p, UINT nodeId_p, tSdoTyp
         else
         {   // free entry found
             pSdoSeqCon = &sdoSeqInstance_l.aSdoSeqCon[freeCon];
-            pSdoSeqCon->conHandle = conHandle;
+            assignConnection(freeCon, conHandle);
             pSdoSeqCon->useCount++;     // increment use counter
             count = freeCon;
         }
@@ -567,13 +668,9 @@ tOplkError sdoseq_processEvent(tEvent* pEvent_p)
     timeru_deleteTimer(&pSdoSeqCon->timerHandle);
 
     // get indexnumber of control structure
-    count = 0;
-    while ((&sdoSeqInstance_l.aSdoSeqCon[count]) != pSdoSeqCon)
-    {
-        count++;
-        if (count > CONFIG_SDO_MAX_CONNECTION_SEQ)
-            return ret;
-    }
+    count = (UINT)(pSdoSeqCon - &sdoSeqInstance_l.aSdoSeqCon[0]);
+    if (count >= CONFIG_SDO_MAX_CONNECTION_SEQ)
+        return ret;
 
     // process event and call process function if needed
     ret = processState(count, 0, NULL, NULL, kSdoSeqEventTimeout);
@@ -633,10 +730,10 @@ tOplkError sdoseq_deleteCon(tSdoSeqConHdl sdoSeqConHdl_p)
 #endif
         }
         timeru_deleteTimer(&pSdoSeqCon->timerHandle);
+        releaseHistory(pSdoSeqCon);
 
         // cleanup control structure
         OPLK_MEMSET(pSdoSeqCon, 0x00, sizeof(tSdoSeqCon));
-        pSdoSeqCon->sdoSeqConHistory.freeEntries = SDO_HISTORY_SIZE;
     }
 
     return ret;
@@ -662,6 +759,54 @@ tOplkError sdoseq_setTimeout(UINT32 timeout_p)
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Set window size of a sequence layer connection
+
+The function sets the number of frames which can be sent on a connection
+without acknowledge. The window size is kept until the connection is deleted.
+It must not be smaller than the number of frames which are currently not
+acknowledged.
+
+\param  sdoSeqConHdl_p          Handle of the sequence layer connection.
+\param  windowSize_p            Window size in frames (2 .. CONFIG_SDO_SEQ_HISTORY_SIZE).
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_sdo_seq
+*/
+//------------------------------------------------------------------------------
+tOplkError sdoseq_setWindowSize(tSdoSeqConHdl sdoSeqConHdl_p, UINT windowSize_p)
+{
+    UINT                handle;
+    tSdoSeqCon*         pSdoSeqCon;
+    tSdoSeqConHistory*  pHistory;
+    UINT                usedEntries;
+
+    handle = (sdoSeqConHdl_p & ~SDO_SEQ_HANDLE_MASK);
+    if (handle >= CONFIG_SDO_MAX_CONNECTION_SEQ)
+        return kErrorSdoSeqInvalidHdl;
+
+    pSdoSeqCon = &sdoSeqInstance_l.aSdoSeqCon[handle];
+    if (pSdoSeqCon->useCount == 0)
+        return kErrorSdoSeqInvalidHdl;
+
+    if ((windowSize_p < 2) || (windowSize_p > SDO_HISTORY_SIZE))
+        return kErrorApiInvalidParam;
+
+    pHistory = &pSdoSeqCon->sdoSeqConHistory;
+    usedEntries = pHistory->windowSize - pHistory->freeEntries;
+    if (windowSize_p < usedEntries)
+        return kErrorApiInvalidParam;
+
+    pHistory->windowSize = (UINT8)windowSize_p;
+    pHistory->freeEntries = (UINT8)(windowSize_p - usedEntries);
+    if (pHistory->ackRequestThreshold >= windowSize_p)
+        pHistory->ackRequestThreshold = (UINT8)(windowSize_p - 1);
+
+    return kErrorOk;
+}
+
 //============================================================================//
 //            P R I V A T E   F U N C T I O N S                               //
 //============================================================================//
@@ -1101,8 +1246,6 @@ static tOplkError processStateConnected(tSdoSeqCon* pSdoSeqCon_p, tSdoSeqConHdl
     {
         // frame to send
         case kSdoSeqEventFrameSend:
-            // set timer
-            ret = setTimer(pSdoSeqCon_p, sdoSeqInstance_l.sdoSeqTimeout);
             // check if data frame or ack
             if (pData_p == NULL)
             {   // send ack, increment scon
@@ -1131,13 +1274,16 @@ static tOplkError processStateConnected(tSdoSeqCon* pSdoSeqCon_p, tSdoSeqConHdl
                     sdoSeqInstance_l.pfnSdoComConCb(sdoSeqConHdl_p, kAsySdoConStateFrameSent);
                 }
             }
+
+            // set timer, the frame is already stored in the history
+            ret = setTimer(pSdoSeqCon_p, getRetransmitTimeout(pSdoSeqCon_p));
             break;
 
         // frame received
         case kSdoSeqEventFrameRec:
             sendSeqNumCon = ami_getUint8Le(&pRecvFrame_p->sendSeqNumCon);
 
-            ret = setTimer(pSdoSeqCon_p, sdoSeqInstance_l.sdoSeqTimeout);
+            ret = setTimer(pSdoSeqCon_p, getRetransmitTimeout(pSdoSeqCon_p));
 
             switch (sendSeqNumCon & SDO_CON_MASK)
             {
@@ -1161,7 +1307,12 @@ static tOplkError processStateConnected(tSdoSeqCon* pSdoSeqCon_p, tSdoSeqConHdl
                 case 3:
                 // normal frame
                 case 2:
+#if (CONFIG_SDO_SEQ_ADAPTIVE_RTO != FALSE)
+                    if (isRetransmitRequested(pSdoSeqCon_p,
+                                              ((ami_getUint8Le(&pRecvFrame_p->recvSeqNumCon) & SDO_CON_MASK) == 3)))
+#else
                     if ((ami_getUint8Le(&pRecvFrame_p->recvSeqNumCon) & SDO_CON_MASK) == 3)
+#endif
                     {
                         // TRACE("sdoseq: error response received\n");
 
@@ -1247,27 +1398,13 @@ static tOplkError processStateConnected(tSdoSeqCon* pSdoSeqCon_p, tSdoSeqConHdl
         // timeout
         case kSdoSeqEventTimeout:
             freeEntries = getFreeHistoryEntries(pSdoSeqCon_p);
-            if ((freeEntries < SDO_HISTORY_SIZE)
+            if ((freeEntries < pSdoSeqCon_p->sdoSeqConHistory.windowSize)
                 && (pSdoSeqCon_p->retryCount < SDO_SEQ_RETRY_COUNT))
             {   // unacknowledged frames in history and retry counter not exceeded
                 // resend data with acknowledge request
-                pSdoSeqCon_p->retryCount++;
-                ret = setTimer(pSdoSeqCon_p, sdoSeqInstance_l.sdoSeqTimeout);
-                // read first frame from history
-                ret = readFromHistory(pSdoSeqCon_p, &pFrame, &frameSize, TRUE);
+                ret = retransmitFirstFrame(pSdoSeqCon_p);
                 if (ret != kErrorOk)
                     return ret;
-
-                if ((pFrame != NULL) && (frameSize != 0))
-                {
-                    // set ack request in scon
-                    ami_setUint8Le(&pFrame->data.asnd.payload.sdoSequenceFrame.sendSeqNumCon,
-                                   ami_getUint8Le(&pFrame->data.asnd.payload.sdoSequenceFrame.sendSeqNumCon) | 0x03);
-
-                    ret = sendToLowerLayer(pSdoSeqCon_p, frameSize, pFrame);
-                    if (ret != kErrorOk)
-                        return ret;
-                }
             }
             else
             {
@@ -1316,7 +1453,7 @@ static tOplkError processStateWaitAck(tSdoSeqCon* pSdoSeqCon_p, tSdoSeqConHdl sd
 
     DEBUG_LVL_SDO_TRACE("sdo-sequ: processStateWaitAck\n");
 
-    ret = setTimer(pSdoSeqCon_p, sdoSeqInstance_l.sdoSeqTimeout);
+    ret = setTimer(pSdoSeqCon_p, getRetransmitTimeout(pSdoSeqCon_p));
 
     //TODO: retry of acknowledge
     if (event_p == kSdoSeqEventFrameRec)
@@ -1402,7 +1539,16 @@ static tOplkError processStateWaitAck(tSdoSeqCon* pSdoSeqCon_p, tSdoSeqConHdl sd
 
     }
     else if (event_p == kSdoSeqEventTimeout)
-    {   // error -> Close
+    {
+#if (CONFIG_SDO_SEQ_ADAPTIVE_RTO != FALSE)
+        if (pSdoSeqCon_p->retryCount < SDO_SEQ_RETRY_COUNT)
+        {   // the timeout is shorter than the configured one, so retransmit
+            // the first frame with acknowledge request before giving up
+            return retransmitFirstFrame(pSdoSeqCon_p);
+        }
+#endif
+
+        // error -> Close
         pSdoSeqCon_p->sdoSeqState = kSdoSeqStateIdle;
         // set rcon and scon to 0
         pSdoSeqCon_p->sendSeqNum &= SEQ_NUM_MASK;
@@ -1521,10 +1667,11 @@ with information from pSdoSeqCon_p.
 static tOplkError sendFrame(tSdoSeqCon* pSdoSeqCon_p, UINT dataSize_p,
                             tPlkFrame* pData_p, BOOL fFrameInHistory_p)
 {
-    tOplkError      ret;
-    UINT8           aFrame[SDO_SEQ_FRAME_SIZE];
-    tPlkFrame *     pFrame;
-    UINT            freeEntries = 0;
+    tOplkError          ret;
+    UINT8               aFrame[SDO_SEQ_FRAME_SIZE];
+    tPlkFrame *         pFrame;
+    UINT                freeEntries = 0;
+    tSdoSeqConHistory*  pHistory;
 
     if (pData_p == NULL)
     {   // set pointer to own frame
@@ -1538,11 +1685,23 @@ static tOplkError sendFrame(tSdoSeqCon* pSdoSeqCon_p, UINT dataSize_p,
 
     if (fFrameInHistory_p != FALSE)
     {
-        // check if only one free entry in history buffer
+        pHistory = &pSdoSeqCon_p->sdoSeqConHistory;
+
+        // check if only one free entry in history buffer or frame pool
         freeEntries = getFreeHistoryEntries(pSdoSeqCon_p);
-        if (freeEntries <= 1)
+        if (freeEntries > sdoSeqInstance_l.freeHistoryFrameCount)
+            freeEntries = sdoSeqInstance_l.freeHistoryFrameCount;
+
+        if ((freeEntries <= 1) ||
+            ((pHistory->fAckRequested == FALSE) && (freeEntries <= pHistory->ackRequestThreshold)))
         {   // request an acknowledge in dataframe - own scon = 3
             pSdoSeqCon_p->recvSeqNum |= 0x03;
+            pHistory->fAckRequested = TRUE;
+        }
+
+        if (freeEntries <= 1)
+        {   // The sender has to wait for the acknowledge
+            pHistory->fStalled = TRUE;
         }
     }
 
@@ -1563,6 +1722,10 @@ static tOplkError sendFrame(tSdoSeqCon* pSdoSeqCon_p, UINT dataSize_p,
         }
         // save frame to history
         ret = addFrameToHistory(pSdoSeqCon_p, pFrame, dataSize_p);
+#if (CONFIG_SDO_SEQ_ADAPTIVE_RTO != FALSE)
+        if (ret == kErrorOk)
+            startRttMeasurement(pSdoSeqCon_p, pFrame);
+#endif
         if ((ret == kErrorSdoSeqNoFreeHistory) || (freeEntries <= 1))
         {
             ret = kErrorSdoSeqRequestAckNeeded;       // request Ack needed
@@ -1643,9 +1806,6 @@ static tOplkError receiveCb(tSdoConHdl conHdl_p, tAsySdoSeq* pSdoSeqData_p,
 
     do
     {
-        count = 0;
-        freeEntry = CONFIG_SDO_MAX_CONNECTION_SEQ;
-
 #if defined(WIN32) || defined(_WIN32)
         EnterCriticalSection(sdoSeqInstance_l.pCriticalSectionReceive);
 #endif
@@ -1653,23 +1813,11 @@ static tOplkError receiveCb(tSdoConHdl conHdl_p, tAsySdoSeq* pSdoSeqData_p,
         DEBUG_LVL_SDO_TRACE("Handle: 0x%x , First Databyte 0x%x\n", conHdl_p, ((BYTE*)pSdoSeqData_p)[0]);
 
         // search control structure for this connection
+        count = searchConnection(conHdl_p);
         pSdoSeqCon = &sdoSeqInstance_l.aSdoSeqCon[count];
-        while (count < CONFIG_SDO_MAX_CONNECTION_SEQ)
-        {
-            if (pSdoSeqCon->conHandle == conHdl_p)
-            {
-                break;
-            }
-            else if ((pSdoSeqCon->conHandle == 0) && (freeEntry == CONFIG_SDO_MAX_CONNECTION_SEQ))
-            {
-                freeEntry = count;   // free entry
-            }
-            count++;
-            pSdoSeqCon++;
-        }
-
         if (count == CONFIG_SDO_MAX_CONNECTION_SEQ)
         {   // new connection
+            freeEntry = getFreeConnection();
             if (freeEntry == CONFIG_SDO_MAX_CONNECTION_SEQ)
             {
                 ret = kErrorSdoSeqNoFreeHandle;
@@ -1682,7 +1830,7 @@ static tOplkError receiveCb(tSdoConHdl conHdl_p, tAsySdoSeq* pSdoSeqData_p,
             else
             {
                 pSdoSeqCon = &sdoSeqInstance_l.aSdoSeqCon[freeEntry];
-                pSdoSeqCon->conHandle = conHdl_p;    // save handle from lower layer
+                assignConnection(freeEntry, conHdl_p);    // save handle from lower layer
                 pSdoSeqCon->useCount++;
                 count = freeEntry;
             }
@@ -1704,11 +1852,91 @@ static tOplkError receiveCb(tSdoConHdl conHdl_p, tAsySdoSeq* pSdoSeqData_p,
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Search connection
+
+The function searches the sequence layer connection which belongs to a lower
+layer connection handle. The connection is looked up in the connection hash
+table. Only if the hash table entry does not refer to the connection, e.g.
+because of a collision, the connection array is searched and the hash table
+entry is updated.
+
+\param  conHdl_p            Connection handle of the lower layer.
+
+\return The function returns the index of the connection or
+        CONFIG_SDO_MAX_CONNECTION_SEQ if no connection was found.
+*/
+//------------------------------------------------------------------------------
+static UINT searchConnection(tSdoConHdl conHdl_p)
+{
+    UINT    hash;
+    UINT    index;
+
+    hash = SDO_SEQ_CON_HASH(conHdl_p);
+    index = sdoSeqInstance_l.aConHashTable[hash];
+    if ((index < CONFIG_SDO_MAX_CONNECTION_SEQ) &&
+        (sdoSeqInstance_l.aSdoSeqCon[index].conHandle == conHdl_p))
+        return index;
+
+    for (index = 0; index < CONFIG_SDO_MAX_CONNECTION_SEQ; index++)
+    {
+        if (sdoSeqInstance_l.aSdoSeqCon[index].conHandle == conHdl_p)
+        {
+            sdoSeqInstance_l.aConHashTable[hash] = index;
+            break;
+        }
+    }
+
+    return index;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get free connection
+
+The function searches a free entry in the connection array.
+
+\return The function returns the index of the free connection or
+        CONFIG_SDO_MAX_CONNECTION_SEQ if no free connection is available.
+*/
+//------------------------------------------------------------------------------
+static UINT getFreeConnection(void)
+{
+    UINT    index;
+
+    for (index = 0; index < CONFIG_SDO_MAX_CONNECTION_SEQ; index++)
+    {
+        if (sdoSeqInstance_l.aSdoSeqCon[index].conHandle == 0)
+            break;
+    }
+
+    return index;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Assign connection
+
+The function assigns a lower layer connection handle to a sequence layer
+connection and enters it in the connection hash table.
+
+\param  index_p             Index of the sequence layer connection.
+\param  conHdl_p            Connection handle of the lower layer.
+*/
+//------------------------------------------------------------------------------
+static void assignConnection(UINT index_p, tSdoConHdl conHdl_p)
+{
+    sdoSeqInstance_l.aSdoSeqCon[index_p].conHandle = conHdl_p;
+    sdoSeqInstance_l.aConHashTable[SDO_SEQ_CON_HASH(conHdl_p)] = index_p;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Initialize history buffer
 
-The function initializes the history buffer of a SDO connection.
+The function initializes the history buffer of a SDO connection. A window size
+which was set for the connection is kept.
 
 \param  pSdoSeqCon_p        Pointer to connection control structure.
 
@@ -1717,17 +1945,60 @@ The function initializes the history buffer of a SDO connection.
 //------------------------------------------------------------------------------
 static tOplkError initHistory(tSdoSeqCon* pSdoSeqCon_p)
 {
-    pSdoSeqCon_p->sdoSeqConHistory.freeEntries = SDO_HISTORY_SIZE;
-    pSdoSeqCon_p->sdoSeqConHistory.ackIndex = 0;
-    pSdoSeqCon_p->sdoSeqConHistory.writeIndex = 0;
+    tSdoSeqConHistory*  pHistory = &pSdoSeqCon_p->sdoSeqConHistory;
+
+    releaseHistory(pSdoSeqCon_p);
+
+    if (pHistory->windowSize == 0)
+        pHistory->windowSize = CONFIG_SDO_SEQ_WINDOW_SIZE;
+
+    pHistory->freeEntries = pHistory->windowSize;
+    pHistory->ackIndex = 0;
+    pHistory->writeIndex = 0;
+    pHistory->ackRequestThreshold = pHistory->windowSize / 2;
+    pHistory->fAckRequested = FALSE;
+    pHistory->fStalled = FALSE;
+
+#if (CONFIG_SDO_SEQ_ADAPTIVE_RTO != FALSE)
+    initRto(pSdoSeqCon_p);
+#endif
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Release history buffer
+
+The function returns all frame buffers of the history of a SDO connection to
+the history frame pool.
+
+\param  pSdoSeqCon_p        Pointer to connection control structure.
+*/
+//------------------------------------------------------------------------------
+static void releaseHistory(tSdoSeqCon* pSdoSeqCon_p)
+{
+    tSdoSeqConHistory*  pHistory = &pSdoSeqCon_p->sdoSeqConHistory;
+    UINT                index;
+
+    for (index = 0; index < SDO_HISTORY_SIZE; index++)
+    {
+        if (pHistory->apHistoryFrame[index] != NULL)
+        {
+            sdoSeqInstance_l.apFreeHistoryFrame[sdoSeqInstance_l.freeHistoryFrameCount++] =
+                pHistory->apHistoryFrame[index];
+            pHistory->apHistoryFrame[index] = NULL;
+            pHistory->aFrameSize[index] = 0;
+        }
+    }
+    pHistory->freeEntries = pHistory->windowSize;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Add frame to the history buffer
 
-The function adds a frame to the history buffer.
+The function adds a frame to the history buffer. The frame is copied into a
+buffer of the history frame pool.
 
 \param  pSdoSeqCon_p        Pointer to connection control structure.
 \param  pFrame_p            Pointer to frame to be stored in history buffer.
@@ -1741,6 +2012,7 @@ static tOplkError addFrameToHistory(tSdoSeqCon* pSdoSeqCon_p, tPlkFrame* pFrame_
 {
     tOplkError              ret = kErrorOk;
     tSdoSeqConHistory*      pHistory;
+    UINT8*                  pHistoryFrame;
 
     // add frame to history buffer
     // check size - SDO_SEQ_HISTORY_FRAME_SIZE includes the header size, but size_p does not!
@@ -1750,10 +2022,12 @@ static tOplkError addFrameToHistory(tSdoSeqCon* pSdoSeqCon_p, tPlkFrame* pFrame_
     pHistory = &pSdoSeqCon_p->sdoSeqConHistory;      // save pointer to history
 
     // check if a free entry is available
-    if (pHistory->freeEntries > 0)
+    if ((pHistory->freeEntries > 0) && (sdoSeqInstance_l.freeHistoryFrameCount > 0))
     {   // write message in free entry
-        OPLK_MEMCPY(&((tPlkFrame*)pHistory->aHistoryFrame[pHistory->writeIndex])->messageType,
+        pHistoryFrame = sdoSeqInstance_l.apFreeHistoryFrame[--sdoSeqInstance_l.freeHistoryFrameCount];
+        OPLK_MEMCPY(&((tPlkFrame*)pHistoryFrame)->messageType,
                     &pFrame_p->messageType, size_p + ASND_HEADER_SIZE);
+        pHistory->apHistoryFrame[pHistory->writeIndex] = pHistoryFrame;
         pHistory->aFrameSize[pHistory->writeIndex] = size_p;
         pHistory->freeEntries--;
         pHistory->writeIndex++;
@@ -1774,7 +2048,8 @@ static tOplkError addFrameToHistory(tSdoSeqCon* pSdoSeqCon_p, tPlkFrame* pFrame_
 /**
 \brief  Delete acknowledged frame from the history buffer
 
-The function deletes an acknowledged frame from the history buffer.
+The function deletes an acknowledged frame from the history buffer and adapts
+the acknowledge request threshold of the connection.
 
 \param  pSdoSeqCon_p        Pointer to connection control structure.
 \param  recvSeqNumber_p     Receive sequence number of frame to delete.
@@ -1788,6 +2063,7 @@ static tOplkError deleteAckedFrameFromHistory(tSdoSeqCon* pSdoSeqCon_p, UINT8 re
     tSdoSeqConHistory*      pHistory;
     UINT8                   ackIndex;
     UINT8                   currentSeqNum;
+    UINT8                   freeEntries;
 
     // get pointer to history buffer
     pHistory = &pSdoSeqCon_p->sdoSeqConHistory;
@@ -1795,14 +2071,18 @@ static tOplkError deleteAckedFrameFromHistory(tSdoSeqCon* pSdoSeqCon_p, UINT8 re
     // release all acknowledged frames from history buffer
 
     // check if there are entries in history
-    if (pHistory->freeEntries < SDO_HISTORY_SIZE)
+    if (pHistory->freeEntries < pHistory->windowSize)
     {
         ackIndex = pHistory->ackIndex;
+        freeEntries = pHistory->freeEntries;
         do
         {
-            currentSeqNum = (((tPlkFrame*)pHistory->aHistoryFrame[ackIndex])->data.asnd.payload.sdoSequenceFrame.sendSeqNumCon & SEQ_NUM_MASK);
+            currentSeqNum = (((tPlkFrame*)pHistory->apHistoryFrame[ackIndex])->data.asnd.payload.sdoSequenceFrame.sendSeqNumCon & SEQ_NUM_MASK);
             if (((recvSeqNumber_p - currentSeqNum) & SEQ_NUM_MASK) < SDO_SEQ_NUM_THRESHOLD)
             {
+                sdoSeqInstance_l.apFreeHistoryFrame[sdoSeqInstance_l.freeHistoryFrameCount++] =
+                    pHistory->apHistoryFrame[ackIndex];
+                pHistory->apHistoryFrame[ackIndex] = NULL;
                 pHistory->aFrameSize[ackIndex] = 0;
                 ackIndex++;
                 pHistory->freeEntries++;
@@ -1814,15 +2094,34 @@ static tOplkError deleteAckedFrameFromHistory(tSdoSeqCon* pSdoSeqCon_p, UINT8 re
             else
             {   // nothing to do anymore, because any further frame in history
                 // has larger sequence number than the acknowledge
-                return ret;
+                break;
             }
         }
-
         while ((((recvSeqNumber_p - 1 - currentSeqNum) & SEQ_NUM_MASK) < SDO_SEQ_NUM_THRESHOLD) &&
                (pHistory->writeIndex != ackIndex));
 
         // store local read-index to global var
         pHistory->ackIndex = ackIndex;
+
+#if (CONFIG_SDO_SEQ_ADAPTIVE_RTO != FALSE)
+        updateRto(pSdoSeqCon_p, recvSeqNumber_p, (pHistory->freeEntries != freeEntries));
+#endif
+
+        if ((pHistory->freeEntries != freeEntries) && pHistory->fAckRequested)
+        {   // Requested acknowledge received, adapt the request threshold
+            if (pHistory->fStalled)
+            {   // Acknowledge came too late, request it earlier
+                if (pHistory->ackRequestThreshold < (pHistory->windowSize - 1))
+                    pHistory->ackRequestThreshold++;
+            }
+            else
+            {   // Acknowledge came in time, request it later
+                if (pHistory->ackRequestThreshold > 1)
+                    pHistory->ackRequestThreshold--;
+            }
+            pHistory->fAckRequested = FALSE;
+            pHistory->fStalled = FALSE;
+        }
     }
 
     return ret;
@@ -1858,10 +2157,16 @@ static tOplkError readFromHistory(tSdoSeqCon* pSdoSeqCon_p, tPlkFrame** ppFrame_
     if (fInitRead_p)
     {   // initialize read index to the index which shall be acknowledged next
         pHistory->readIndex = pHistory->ackIndex;
+
+#if (CONFIG_SDO_SEQ_ADAPTIVE_RTO != FALSE)
+        // the acknowledge of a retransmitted frame can't be used for measuring
+        // the round trip time
+        pSdoSeqCon_p->sdoSeqConRto.fRttPending = FALSE;
+#endif
     }
 
     // check if entries are available for reading
-    if ((pHistory->freeEntries < SDO_HISTORY_SIZE) &&
+    if ((pHistory->freeEntries < pHistory->windowSize) &&
         (pHistory->writeIndex != pHistory->readIndex))
     {
         DEBUG_LVL_SDO_TRACE("readFromHistory(): init = %d, read = %u, write = %u, ack = %u",
@@ -1871,7 +2176,7 @@ static tOplkError readFromHistory(tSdoSeqCon* pSdoSeqCon_p, tPlkFrame** ppFrame_
                              (WORD)pHistory->freeEntries, pHistory->aFrameSize[pHistory->readIndex]);
 
         // return pointer to stored frame
-        *ppFrame_p = (tPlkFrame*)pHistory->aHistoryFrame[pHistory->readIndex];
+        *ppFrame_p = (tPlkFrame*)pHistory->apHistoryFrame[pHistory->readIndex];
         *pSize_p = pHistory->aFrameSize[pHistory->readIndex];   // save size
         pHistory->readIndex++;
         if (pHistory->readIndex == SDO_HISTORY_SIZE)
@@ -1942,5 +2247,218 @@ static tOplkError setTimer(tSdoSeqCon* pSdoSeqCon_p, ULONG timeout_p)
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get the retransmission timeout
+
+The function returns the timeout for the timer of a connection. The configured
+sequence layer timeout is used if no frames are outstanding, otherwise the
+adaptive retransmission timeout is used if it is enabled.
+
+\param  pSdoSeqCon_p        Pointer to connection control structure.
+
+\return The function returns the timeout in milliseconds.
+*/
+//------------------------------------------------------------------------------
+static ULONG getRetransmitTimeout(tSdoSeqCon* pSdoSeqCon_p)
+{
+#if (CONFIG_SDO_SEQ_ADAPTIVE_RTO != FALSE)
+    if (getFreeHistoryEntries(pSdoSeqCon_p) < pSdoSeqCon_p->sdoSeqConHistory.windowSize)
+        return min(pSdoSeqCon_p->sdoSeqConRto.rto, sdoSeqInstance_l.sdoSeqTimeout);
+#else
+    UNUSED_PARAMETER(pSdoSeqCon_p);
+#endif
+
+    return sdoSeqInstance_l.sdoSeqTimeout;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Retransmit the first frame after a timeout
+
+The function retransmits the first not acknowledged frame of the history with
+acknowledge request and restarts the timer. If the adaptive retransmission
+timeout is enabled, it is doubled and the retry counter is only incremented
+after it reached the configured sequence layer timeout. So the connection is
+not closed earlier than with the configured timeout.
+
+\param  pSdoSeqCon_p        Pointer to connection control structure.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError retransmitFirstFrame(tSdoSeqCon* pSdoSeqCon_p)
+{
+    tOplkError          ret;
+    UINT                frameSize;
+    tPlkFrame*          pFrame;
+#if (CONFIG_SDO_SEQ_ADAPTIVE_RTO != FALSE)
+    tSdoSeqConRto*      pRto = &pSdoSeqCon_p->sdoSeqConRto;
+
+    if (pRto->rto < sdoSeqInstance_l.sdoSeqTimeout)
+        pRto->rto = min(2 * pRto->rto, sdoSeqInstance_l.sdoSeqTimeout);
+    else
+        pSdoSeqCon_p->retryCount++;
+
+    // serve the next retransmission request of the receiver again
+    pRto->fRetransmitted = FALSE;
+    pRto->dupAckCount = 0;
+#else
+    pSdoSeqCon_p->retryCount++;
+#endif
+
+    ret = setTimer(pSdoSeqCon_p, getRetransmitTimeout(pSdoSeqCon_p));
+    // read first frame from history
+    ret = readFromHistory(pSdoSeqCon_p, &pFrame, &frameSize, TRUE);
+    if (ret != kErrorOk)
+        return ret;
+
+    if ((pFrame != NULL) && (frameSize != 0))
+    {
+        // set ack request in scon
+        ami_setUint8Le(&pFrame->data.asnd.payload.sdoSequenceFrame.sendSeqNumCon,
+                       ami_getUint8Le(&pFrame->data.asnd.payload.sdoSequenceFrame.sendSeqNumCon) | 0x03);
+
+        ret = sendToLowerLayer(pSdoSeqCon_p, frameSize, pFrame);
+    }
+
+    return ret;
+}
+
+#if (CONFIG_SDO_SEQ_ADAPTIVE_RTO != FALSE)
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the retransmission timeout
+
+The function resets the round trip time estimation of a connection. The
+configured sequence layer timeout is used until the round trip time was
+measured.
+
+\param  pSdoSeqCon_p        Pointer to connection control structure.
+*/
+//------------------------------------------------------------------------------
+static void initRto(tSdoSeqCon* pSdoSeqCon_p)
+{
+    tSdoSeqConRto*      pRto = &pSdoSeqCon_p->sdoSeqConRto;
+
+    OPLK_MEMSET(pRto, 0x00, sizeof(*pRto));
+    pRto->rto = sdoSeqInstance_l.sdoSeqTimeout;
+    pRto->lastAckSeqNum = pSdoSeqCon_p->sendSeqNum & SEQ_NUM_MASK;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Start a round trip time measurement
+
+The function starts measuring the round trip time of a frame which was sent for
+the first time, if no other frame is measured.
+
+\param  pSdoSeqCon_p        Pointer to connection control structure.
+\param  pFrame_p            Pointer to the sent frame.
+*/
+//------------------------------------------------------------------------------
+static void startRttMeasurement(tSdoSeqCon* pSdoSeqCon_p, tPlkFrame* pFrame_p)
+{
+    tSdoSeqConRto*      pRto = &pSdoSeqCon_p->sdoSeqConRto;
+
+    if (pRto->fRttPending)
+        return;
+
+    pRto->rttSeqNum = ami_getUint8Le(&pFrame_p->data.asnd.payload.sdoSequenceFrame.sendSeqNumCon) & SEQ_NUM_MASK;
+    pRto->rttStartTime = target_getTickCount();
+    pRto->fRttPending = TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Update the retransmission timeout with a received acknowledge
+
+The function is called for every received acknowledge while frames are
+outstanding. If the acknowledge contains the measured frame, the round trip
+time estimation and the retransmission timeout are updated. Otherwise, if it
+doesn't acknowledge any new frame, it is counted as duplicate acknowledge.
+
+\param  pSdoSeqCon_p        Pointer to connection control structure.
+\param  ackSeqNum_p         Received acknowledge sequence number.
+\param  fNewAck_p           Frames were acknowledged by the acknowledge.
+*/
+//------------------------------------------------------------------------------
+static void updateRto(tSdoSeqCon* pSdoSeqCon_p, UINT8 ackSeqNum_p, BOOL fNewAck_p)
+{
+    tSdoSeqConRto*      pRto = &pSdoSeqCon_p->sdoSeqConRto;
+    UINT32              rtt;
+    INT32               delta;
+
+    if (!fNewAck_p)
+    {
+        if (ackSeqNum_p == pRto->lastAckSeqNum)
+            pRto->dupAckCount++;
+
+        pRto->lastAckSeqNum = ackSeqNum_p;
+        return;
+    }
+
+    // the connection makes progress
+    pRto->lastAckSeqNum = ackSeqNum_p;
+    pRto->dupAckCount = 0;
+    pRto->fRetransmitted = FALSE;
+    pSdoSeqCon_p->retryCount = 0;
+
+    if (!pRto->fRttPending ||
+        (((ackSeqNum_p - pRto->rttSeqNum) & SEQ_NUM_MASK) >= SDO_SEQ_NUM_THRESHOLD))
+        return;
+
+    pRto->fRttPending = FALSE;
+    rtt = min(target_getTickCount() - pRto->rttStartTime, SDO_SEQU_MAX_TIMEOUT_MS);
+
+    if (!pRto->fRttValid)
+    {   // first measurement
+        pRto->srtt = (INT32)(rtt << 3);
+        pRto->rttVar = (INT32)(rtt << 1);
+        pRto->fRttValid = TRUE;
+    }
+    else
+    {   // srtt += (rtt - srtt) / 8, rttVar += (|rtt - srtt| - rttVar) / 4
+        delta = (INT32)rtt - (pRto->srtt >> 3);
+        pRto->srtt += delta;
+        if (delta < 0)
+            delta = -delta;
+        pRto->rttVar += delta - (pRto->rttVar >> 2);
+    }
+
+    // rto = srtt + 4 * rttVar
+    pRto->rto = max((UINT32)((pRto->srtt >> 3) + pRto->rttVar), CONFIG_SDO_SEQ_RTO_MIN_MS);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check if the history shall be retransmitted
+
+The function checks if the outstanding frames shall be retransmitted after a
+frame was received. A retransmission request of the receiver is served only
+once until new frames are acknowledged, because the receiver repeats it for
+every frame which follows a lost frame. The frames are retransmitted without
+waiting for the timeout if the threshold of duplicate acknowledges is reached.
+
+\param  pSdoSeqCon_p        Pointer to connection control structure.
+\param  fErrorResponse_p    The received frame is a retransmission request.
+
+\return The function returns TRUE if the history shall be retransmitted.
+*/
+//------------------------------------------------------------------------------
+static BOOL isRetransmitRequested(tSdoSeqCon* pSdoSeqCon_p, BOOL fErrorResponse_p)
+{
+    tSdoSeqConRto*      pRto = &pSdoSeqCon_p->sdoSeqConRto;
+
+    if ((pRto->dupAckCount < CONFIG_SDO_SEQ_DUP_ACK_THRESHOLD) &&
+        (!fErrorResponse_p || pRto->fRetransmitted))
+        return FALSE;
+
+    pRto->dupAckCount = 0;
+    pRto->fRetransmitted = TRUE;
+    return TRUE;
+}
+#endif
+
 ///\}
 
@@ -44,6 +44,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <common/ami.h>
+#include <common/target.h>
 #include <user/sdoudp.h>
 
 #if (TARGET_SYSTEM == _LINUX_)
@@ -51,6 +52,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <sys/epoll.h>
 #include <pthread.h>
 #endif
 
@@ -69,6 +71,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CONFIG_SDO_MAX_CONNECTION_UDP  5
 #endif
 
+#ifndef CONFIG_SDO_UDP_MAX_SOCKETS
+#define CONFIG_SDO_UDP_MAX_SOCKETS     4                // number of sockets (socket 0 is configured by sdoudp_config())
+#endif
+
+#ifndef CONFIG_SDO_UDP_RX_BATCH_SIZE
+#define CONFIG_SDO_UDP_RX_BATCH_SIZE   8                // number of datagrams received with one system call
+#endif
+
 //------------------------------------------------------------------------------
 // module global vars
 //------------------------------------------------------------------------------
@@ -94,6 +104,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define SOCKLEN_T   int*
 #endif
 
+#define SDO_UDP_THREAD_TIMEOUT_MS       400
+
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
@@ -112,8 +124,9 @@ typedef LPVOID tThreadArg;
 
 typedef struct
 {
-    ULONG           ipAddr;     /// IP address in network byte order
-    ULONG           port;       /// Port in network byte order
+    ULONG           ipAddr;         /// IP address in network byte order
+    ULONG           port;           /// Port in network byte order
+    UINT            socketIndex;    /// Index of the socket the connection uses
 } tSdoUdpCon;
 
 // instance table
@@ -121,13 +134,15 @@ typedef struct
 {
     tSdoUdpCon              aSdoAbsUdpConnection[CONFIG_SDO_MAX_CONNECTION_UDP];
     tSequLayerReceiveCb     pfnSdoAsySeqCb;
-    SOCKET                  udpSocket;
+    SOCKET                  aUdpSocket[CONFIG_SDO_UDP_MAX_SOCKETS];
 #if (TARGET_SYSTEM == _WIN32_)
     HANDLE                  threadHandle;
     LPCRITICAL_SECTION      pCriticalSection;
     CRITICAL_SECTION        criticalSection;
 #elif (TARGET_SYSTEM == _LINUX_)
     pthread_t               threadHandle;
+    int                     epollFd;
+    UINT8                   aRxBuffer[CONFIG_SDO_UDP_RX_BATCH_SIZE][SDO_MAX_REC_FRAME_SIZE];
 #endif
     BOOL                    fStopThread;
 } tSdoUdpInstance;
@@ -142,6 +157,11 @@ static tSdoUdpInstance      sdoUdpInstance_l;
 // local function prototypes
 //------------------------------------------------------------------------------
 static tThreadResult sdoUdpThread(tThreadArg lpParameter);
+static tOplkError    stopThread(void);
+static tOplkError    openSocket(UINT socketIndex_p, ULONG ipAddr_p, UINT port_p);
+static void          receiveFromSocket(tSdoUdpInstance* pInstance_p, UINT socketIndex_p);
+static void          processDatagram(tSdoUdpInstance* pInstance_p, UINT socketIndex_p,
+                                     UINT8* pBuffer_p, INT size_p, struct sockaddr_in* pRemoteAddr_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -181,6 +201,7 @@ The function adds an instance of an SDO over UDP module.
 tOplkError sdoudp_addInstance(tSequLayerReceiveCb pfnReceiveCb_p)
 {
     tOplkError          ret = kErrorOk;
+    UINT                socketIndex;
 
 #if (TARGET_SYSTEM == _WIN32_)
     int                 error;
@@ -209,7 +230,11 @@ tOplkError sdoudp_addInstance(tSequLayerReceiveCb pfnReceiveCb_p)
 #endif
 
     sdoUdpInstance_l.threadHandle = 0;
-    sdoUdpInstance_l.udpSocket = INVALID_SOCKET;
+    for (socketIndex = 0; socketIndex < CONFIG_SDO_UDP_MAX_SOCKETS; socketIndex++)
+        sdoUdpInstance_l.aUdpSocket[socketIndex] = INVALID_SOCKET;
+#if (TARGET_SYSTEM == _LINUX_)
+    sdoUdpInstance_l.epollFd = -1;
+#endif
 
     ret = sdoudp_config(INADDR_ANY, 0);
     return ret;
@@ -230,29 +255,19 @@ sockets and deletes the listener thread.
 tOplkError sdoudp_delInstance(void)
 {
     tOplkError      ret = kErrorOk;
+    UINT            socketIndex;
 
-#if (TARGET_SYSTEM == _WIN32_)
-    BOOL                fTermError;
-#endif
-
-    if (sdoUdpInstance_l.threadHandle != 0)
-    {   // listen thread was started -> close thread
-#if (TARGET_SYSTEM == _WIN32_)
-        fTermError = TerminateThread(sdoUdpInstance_l.threadHandle, 0);
-        if(fTermError == FALSE)
-            return kErrorSdoUdpThreadError;
-#elif (TARGET_SYSTEM == _LINUX_)
-        sdoUdpInstance_l.fStopThread = TRUE;
-        if (pthread_join(sdoUdpInstance_l.threadHandle, NULL) != 0)
-            return kErrorSdoUdpThreadError;
-#endif
-        sdoUdpInstance_l.threadHandle = 0;
-    }
+    ret = stopThread();
+    if (ret != kErrorOk)
+        return ret;
 
-    if (sdoUdpInstance_l.udpSocket != INVALID_SOCKET)
+    for (socketIndex = 0; socketIndex < CONFIG_SDO_UDP_MAX_SOCKETS; socketIndex++)
     {
-        closesocket(sdoUdpInstance_l.udpSocket);
-        sdoUdpInstance_l.udpSocket = INVALID_SOCKET;
+        if (sdoUdpInstance_l.aUdpSocket[socketIndex] != INVALID_SOCKET)
+        {
+            closesocket(sdoUdpInstance_l.aUdpSocket[socketIndex]);
+            sdoUdpInstance_l.aUdpSocket[socketIndex] = INVALID_SOCKET;
+        }
     }
 
 #if (TARGET_SYSTEM == _WIN32_)
@@ -280,64 +295,54 @@ NMT_ResetConfiguration.
 tOplkError sdoudp_config(ULONG ipAddr_p, UINT port_p)
 {
     tOplkError          ret = kErrorOk;
-    struct sockaddr_in  addr;
     INT                 error;
-
+    UINT                socketIndex;
 #if (TARGET_SYSTEM == _WIN32_)
-    BOOL                fTermError;
     ULONG               threadId;
+#elif (TARGET_SYSTEM == _LINUX_)
+    struct epoll_event  event;
 #endif
 
-    if (port_p == 0)
-    {
-        port_p = C_SDO_EPL_PORT;  // set UDP port to default port number
-    }
-    else if (port_p > 65535)
-    {
+    if (port_p > 65535)
         return kErrorSdoUdpSocketError;
-    }
 
-    if (sdoUdpInstance_l.threadHandle != 0)
-    {   // listen thread was started -> close old thread
-#if (TARGET_SYSTEM == _WIN32_)
-        fTermError = TerminateThread(sdoUdpInstance_l.threadHandle, 0);
-        if (fTermError == FALSE)
-            return kErrorSdoUdpThreadError;
-#elif (TARGET_SYSTEM == _LINUX_)
-        sdoUdpInstance_l.fStopThread = TRUE;
-        if (pthread_join(sdoUdpInstance_l.threadHandle, NULL) != 0)
-            return kErrorSdoUdpThreadError;
-#endif
-        sdoUdpInstance_l.threadHandle = 0;
-    }
+    ret = stopThread();
+    if (ret != kErrorOk)
+        return ret;
 
-    if (sdoUdpInstance_l.udpSocket != INVALID_SOCKET)
+    if (sdoUdpInstance_l.aUdpSocket[0] != INVALID_SOCKET)
     {
-        error = closesocket(sdoUdpInstance_l.udpSocket);
-        sdoUdpInstance_l.udpSocket = INVALID_SOCKET;
+        error = closesocket(sdoUdpInstance_l.aUdpSocket[0]);
+        sdoUdpInstance_l.aUdpSocket[0] = INVALID_SOCKET;
         if (error != 0)
             return kErrorSdoUdpSocketError;
     }
 
-    // create Socket
-    sdoUdpInstance_l.udpSocket = socket(PF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    if (sdoUdpInstance_l.udpSocket == INVALID_SOCKET)
-    {
-        ret = kErrorSdoUdpNoSocket;
-        DEBUG_LVL_SDO_TRACE("sdoudp_config: socket() failed\n");
+    ret = openSocket(0, ipAddr_p, port_p);
+    if (ret != kErrorOk)
         return ret;
-    }
 
-    // bind socket
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons((USHORT)port_p);
-    addr.sin_addr.s_addr = htonl(ipAddr_p);
-    error = bind(sdoUdpInstance_l.udpSocket, (struct sockaddr*)&addr, sizeof(addr));
-    if (error < 0)
+#if (TARGET_SYSTEM == _LINUX_)
+    // register all sockets at the epoll instance of the listen thread
+    sdoUdpInstance_l.epollFd = epoll_create(CONFIG_SDO_UDP_MAX_SOCKETS);
+    if (sdoUdpInstance_l.epollFd < 0)
+        return kErrorSdoUdpThreadError;
+
+    for (socketIndex = 0; socketIndex < CONFIG_SDO_UDP_MAX_SOCKETS; socketIndex++)
     {
-        DEBUG_LVL_SDO_TRACE("sdoudp_config: bind() finished with %i\n", error);
-        return kErrorSdoUdpNoSocket;
+        if (sdoUdpInstance_l.aUdpSocket[socketIndex] == INVALID_SOCKET)
+            continue;
+
+        OPLK_MEMSET(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.u32 = socketIndex;
+        if (epoll_ctl(sdoUdpInstance_l.epollFd, EPOLL_CTL_ADD,
+                      sdoUdpInstance_l.aUdpSocket[socketIndex], &event) != 0)
+            return kErrorSdoUdpSocketError;
     }
+#else
+    UNUSED_PARAMETER(socketIndex);
+#endif
 
     // create Listen-Thread
     sdoUdpInstance_l.fStopThread = FALSE;
@@ -347,18 +352,79 @@ tOplkError sdoudp_config(ULONG ipAddr_p, UINT port_p)
     if (sdoUdpInstance_l.threadHandle == NULL)
         return kErrorSdoUdpThreadError;
 #elif (TARGET_SYSTEM == _LINUX_)
-    if (pthread_create(&sdoUdpInstance_l.threadHandle, NULL, sdoUdpThread, (void*)&sdoUdpInstance_l) != 0)
+    if (target_createThread(&sdoUdpInstance_l.threadHandle, kThreadRoleSdoUdp, "oplk-sdoudp",
+                            sdoUdpThread, (void*)&sdoUdpInstance_l) != kErrorOk)
         return kErrorSdoUdpThreadError;
 
-#if (defined(__GLIBC__) && __GLIBC__ >= 2 && __GLIBC_MINOR__ >= 12)
-    pthread_setname_np(sdoUdpInstance_l.threadHandle, "oplk-sdoudp");
-#endif
+    // The receive thread is no realtime thread, it is only placed on request
+    target_setThreadParams(sdoUdpInstance_l.threadHandle, kThreadRoleSdoUdp, kThreadSchedDefault, 0, 0);
 #endif
 
     return ret;
 
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Add a socket
+
+The function binds an additional socket to the specified IP address and port,
+e.g. to serve SDO clients on several interfaces. The connections which are
+opened by remote clients use the socket on which the first frame was received.
+Connections opened by the local node use the socket configured by
+sdoudp_config().
+
+\param  ipAddr_p            IP address to bind the socket to.
+\param  port_p              Port to bind the socket to (0 = default SDO port).
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_sdo_udp
+*/
+//------------------------------------------------------------------------------
+tOplkError sdoudp_addSocket(ULONG ipAddr_p, UINT port_p)
+{
+    tOplkError          ret;
+    UINT                socketIndex;
+#if (TARGET_SYSTEM == _LINUX_)
+    struct epoll_event  event;
+#endif
+
+    if (port_p > 65535)
+        return kErrorSdoUdpSocketError;
+
+    for (socketIndex = 1; socketIndex < CONFIG_SDO_UDP_MAX_SOCKETS; socketIndex++)
+    {
+        if (sdoUdpInstance_l.aUdpSocket[socketIndex] == INVALID_SOCKET)
+            break;
+    }
+
+    if (socketIndex == CONFIG_SDO_UDP_MAX_SOCKETS)
+        return kErrorSdoUdpNoSocket;
+
+    ret = openSocket(socketIndex, ipAddr_p, port_p);
+    if (ret != kErrorOk)
+        return ret;
+
+#if (TARGET_SYSTEM == _LINUX_)
+    if (sdoUdpInstance_l.epollFd >= 0)
+    {   // listen thread is running -> add socket to its epoll instance
+        OPLK_MEMSET(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.u32 = socketIndex;
+        if (epoll_ctl(sdoUdpInstance_l.epollFd, EPOLL_CTL_ADD,
+                      sdoUdpInstance_l.aUdpSocket[socketIndex], &event) != 0)
+        {
+            closesocket(sdoUdpInstance_l.aUdpSocket[socketIndex]);
+            sdoUdpInstance_l.aUdpSocket[socketIndex] = INVALID_SOCKET;
+            return kErrorSdoUdpSocketError;
+        }
+    }
+#endif
+
+    return kErrorOk;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Initialize new connection
@@ -411,6 +477,7 @@ tOplkError sdoudp_initCon(tSdoConHdl* pSdoConHandle_p, UINT targetNodeId_p)
         // save infos for connection
         pSdoUdpCon->port = htons(C_SDO_EPL_PORT);
         pSdoUdpCon->ipAddr = htonl(0xC0A86400 | targetNodeId_p);   // 192.168.100.uiTargetNodeId_p
+        pSdoUdpCon->socketIndex = 0;
 
         // set handle
         *pSdoConHandle_p = (freeCon | SDO_UDP_HANDLE);
@@ -459,7 +526,8 @@ tOplkError sdoudp_sendData(tSdoConHdl sdoConHandle_p, tPlkFrame* pSrcData_p, UIN
     LeaveCriticalSection(sdoUdpInstance_l.pCriticalSection);
 #endif
 
-    error = sendto(sdoUdpInstance_l.udpSocket, (const char*)&pSrcData_p->messageType,
+    error = sendto(sdoUdpInstance_l.aUdpSocket[sdoUdpInstance_l.aSdoAbsUdpConnection[array].socketIndex],
+                   (const char*)&pSrcData_p->messageType,
                    dataSize_p, 0, (struct sockaddr*)&addr, sizeof(struct sockaddr_in));
     if (error < 0)
     {
@@ -495,6 +563,7 @@ tOplkError sdoudp_delConnection(tSdoConHdl sdoConHandle_p)
     // delete connection
     sdoUdpInstance_l.aSdoAbsUdpConnection[array].ipAddr = 0;
     sdoUdpInstance_l.aSdoAbsUdpConnection[array].port = 0;
+    sdoUdpInstance_l.aSdoAbsUdpConnection[array].socketIndex = 0;
 
     return ret;
 }
@@ -507,104 +576,247 @@ tOplkError sdoudp_delConnection(tSdoConHdl sdoConHandle_p)
 
 //------------------------------------------------------------------------------
 /**
-\brief  receive data from socket
+\brief  Stop listen thread
+
+The function stops the UDP listen thread.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError stopThread(void)
+{
+#if (TARGET_SYSTEM == _WIN32_)
+    BOOL                fTermError;
+#endif
+
+    if (sdoUdpInstance_l.threadHandle != 0)
+    {   // listen thread was started -> close thread
+#if (TARGET_SYSTEM == _WIN32_)
+        fTermError = TerminateThread(sdoUdpInstance_l.threadHandle, 0);
+        if (fTermError == FALSE)
+            return kErrorSdoUdpThreadError;
+#elif (TARGET_SYSTEM == _LINUX_)
+        sdoUdpInstance_l.fStopThread = TRUE;
+        if (pthread_join(sdoUdpInstance_l.threadHandle, NULL) != 0)
+            return kErrorSdoUdpThreadError;
+#endif
+        sdoUdpInstance_l.threadHandle = 0;
+    }
+
+#if (TARGET_SYSTEM == _LINUX_)
+    if (sdoUdpInstance_l.epollFd >= 0)
+    {
+        close(sdoUdpInstance_l.epollFd);
+        sdoUdpInstance_l.epollFd = -1;
+    }
+#endif
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Open socket
 
-The function receives data from the UDP socket.
+The function creates a UDP socket and binds it to the specified IP address and
+port.
 
-\param  pInstance_p           Pointer to SDO instance.
+\param  socketIndex_p       Index of the socket to open.
+\param  ipAddr_p            IP address to bind the socket to.
+\param  port_p              Port to bind the socket to (0 = default SDO port).
 
 \return The function returns a tOplkError error code.
 */
 //------------------------------------------------------------------------------
-void receiveFromSocket(tSdoUdpInstance* pInstance_p)
+static tOplkError openSocket(UINT socketIndex_p, ULONG ipAddr_p, UINT port_p)
 {
-    tOplkError          ret;
-    struct sockaddr_in  remoteAddr;
+    struct sockaddr_in  addr;
     INT                 error;
+    SOCKET              udpSocket;
+
+    if (port_p == 0)
+    {
+        port_p = C_SDO_EPL_PORT;  // set UDP port to default port number
+    }
+
+    // create Socket
+    udpSocket = socket(PF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (udpSocket == INVALID_SOCKET)
+    {
+        DEBUG_LVL_SDO_TRACE("sdoudp_config: socket() failed\n");
+        return kErrorSdoUdpNoSocket;
+    }
+
+    // bind socket
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((USHORT)port_p);
+    addr.sin_addr.s_addr = htonl(ipAddr_p);
+    error = bind(udpSocket, (struct sockaddr*)&addr, sizeof(addr));
+    if (error < 0)
+    {
+        DEBUG_LVL_SDO_TRACE("sdoudp_config: bind() finished with %i\n", error);
+        closesocket(udpSocket);
+        return kErrorSdoUdpNoSocket;
+    }
+
+    sdoUdpInstance_l.aUdpSocket[socketIndex_p] = udpSocket;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  receive data from socket
+
+The function receives data from a UDP socket. On Linux, all pending datagrams
+are received in batches of CONFIG_SDO_UDP_RX_BATCH_SIZE datagrams with one
+system call per batch and are dispatched to the sequence layer one after
+another.
+
+\param  pInstance_p         Pointer to SDO instance.
+\param  socketIndex_p       Index of the socket to receive from.
+*/
+//------------------------------------------------------------------------------
+static void receiveFromSocket(tSdoUdpInstance* pInstance_p, UINT socketIndex_p)
+{
+#if (TARGET_SYSTEM == _LINUX_)
+    struct mmsghdr      aMsg[CONFIG_SDO_UDP_RX_BATCH_SIZE];
+    struct iovec        aIov[CONFIG_SDO_UDP_RX_BATCH_SIZE];
+    struct sockaddr_in  aRemoteAddr[CONFIG_SDO_UDP_RX_BATCH_SIZE];
     INT                 count;
-    INT                 freeEntry;
+    INT                 index;
+
+    do
+    {
+        OPLK_MEMSET(aMsg, 0, sizeof(aMsg));
+        for (index = 0; index < CONFIG_SDO_UDP_RX_BATCH_SIZE; index++)
+        {
+            aIov[index].iov_base = pInstance_p->aRxBuffer[index];
+            aIov[index].iov_len = sizeof(pInstance_p->aRxBuffer[index]);
+            aMsg[index].msg_hdr.msg_iov = &aIov[index];
+            aMsg[index].msg_hdr.msg_iovlen = 1;
+            aMsg[index].msg_hdr.msg_name = &aRemoteAddr[index];
+            aMsg[index].msg_hdr.msg_namelen = sizeof(aRemoteAddr[index]);
+        }
+
+        count = recvmmsg(pInstance_p->aUdpSocket[socketIndex_p], aMsg,
+                         CONFIG_SDO_UDP_RX_BATCH_SIZE, MSG_DONTWAIT, NULL);
+        for (index = 0; index < count; index++)
+        {
+            processDatagram(pInstance_p, socketIndex_p, pInstance_p->aRxBuffer[index],
+                            (INT)aMsg[index].msg_len, &aRemoteAddr[index]);
+        }
+    } while (count == CONFIG_SDO_UDP_RX_BATCH_SIZE);
+#else
+    struct sockaddr_in  remoteAddr;
+    INT                 error;
     UINT8               aBuffer[SDO_MAX_REC_FRAME_SIZE];
     UINT                size;
-    tSdoConHdl          sdoConHdl;
 
     size = sizeof(struct sockaddr);
 
-    error = recvfrom(pInstance_p->udpSocket, (char*)&aBuffer[0], sizeof(aBuffer),
+    error = recvfrom(pInstance_p->aUdpSocket[socketIndex_p], (char*)&aBuffer[0], sizeof(aBuffer),
                      0, (struct sockaddr*)&remoteAddr, (SOCKLEN_T)&size);
-    if (error > 0)
-    {
-        // get handle for higher layer
-        count = 0;
-        freeEntry = 0xFFFF;
+    processDatagram(pInstance_p, socketIndex_p, aBuffer, error, &remoteAddr);
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process received datagram
+
+The function looks up the connection of a received datagram and forwards it
+to the sequence layer.
+
+\param  pInstance_p         Pointer to SDO instance.
+\param  socketIndex_p       Index of the socket the datagram was received on.
+\param  pBuffer_p           Pointer to the received datagram.
+\param  size_p              Size of the received datagram.
+\param  pRemoteAddr_p       Pointer to the address of the sender.
+*/
+//------------------------------------------------------------------------------
+static void processDatagram(tSdoUdpInstance* pInstance_p, UINT socketIndex_p,
+                            UINT8* pBuffer_p, INT size_p, struct sockaddr_in* pRemoteAddr_p)
+{
+    tOplkError          ret;
+    INT                 count;
+    INT                 freeEntry;
+    tSdoConHdl          sdoConHdl;
+
+    if (size_p <= 0)
+        return;
+
+    // get handle for higher layer
+    count = 0;
+    freeEntry = 0xFFFF;
 #if (TARGET_SYSTEM == _WIN32_)
-        EnterCriticalSection(sdoUdpInstance_l.pCriticalSection);
+    EnterCriticalSection(sdoUdpInstance_l.pCriticalSection);
 #endif
-        while (count < CONFIG_SDO_MAX_CONNECTION_UDP)
+    while (count < CONFIG_SDO_MAX_CONNECTION_UDP)
+    {
+        // check if this connection is already known
+        if ((pInstance_p->aSdoAbsUdpConnection[count].ipAddr == pRemoteAddr_p->sin_addr.s_addr) &&
+            (pInstance_p->aSdoAbsUdpConnection[count].port == pRemoteAddr_p->sin_port))
         {
-            // check if this connection is already known
-            if ((pInstance_p->aSdoAbsUdpConnection[count].ipAddr == remoteAddr.sin_addr.s_addr) &&
-                (pInstance_p->aSdoAbsUdpConnection[count].port == remoteAddr.sin_port))
-            {
-                break;
-            }
+            break;
+        }
 
-            if ((pInstance_p->aSdoAbsUdpConnection[count].ipAddr == 0) &&
-                (pInstance_p->aSdoAbsUdpConnection[count].port == 0) &&
-                (freeEntry == 0xFFFF))
-            {
-                freeEntry = count;
-            }
-            count++;
+        if ((pInstance_p->aSdoAbsUdpConnection[count].ipAddr == 0) &&
+            (pInstance_p->aSdoAbsUdpConnection[count].port == 0) &&
+            (freeEntry == 0xFFFF))
+        {
+            freeEntry = count;
         }
+        count++;
+    }
 
-        if (count == CONFIG_SDO_MAX_CONNECTION_UDP)
+    if (count == CONFIG_SDO_MAX_CONNECTION_UDP)
+    {
+        // connection unknown -> see if there is a free handle
+        if (freeEntry != 0xFFFF)
         {
-            // connection unknown -> see if there is a free handle
-            if (freeEntry != 0xFFFF)
-            {
-                // save address infos
-                pInstance_p->aSdoAbsUdpConnection[freeEntry].ipAddr = remoteAddr.sin_addr.s_addr;
-                pInstance_p->aSdoAbsUdpConnection[freeEntry].port = remoteAddr.sin_port;
+            // save address infos
+            pInstance_p->aSdoAbsUdpConnection[freeEntry].ipAddr = pRemoteAddr_p->sin_addr.s_addr;
+            pInstance_p->aSdoAbsUdpConnection[freeEntry].port = pRemoteAddr_p->sin_port;
+            pInstance_p->aSdoAbsUdpConnection[freeEntry].socketIndex = socketIndex_p;
 #if (TARGET_SYSTEM == _WIN32_)
-                LeaveCriticalSection(sdoUdpInstance_l.pCriticalSection);
+            LeaveCriticalSection(sdoUdpInstance_l.pCriticalSection);
 #endif
-                // call callback
-                sdoConHdl = freeEntry;
-                sdoConHdl |= SDO_UDP_HANDLE;
+            // call callback
+            sdoConHdl = freeEntry;
+            sdoConHdl |= SDO_UDP_HANDLE;
 
-                // offset 4 -> start of SDO Sequence header
-                ret = pInstance_p->pfnSdoAsySeqCb(sdoConHdl, (tAsySdoSeq*)&aBuffer[4], (error - 4));
-                if (ret != kErrorOk)
-                {
-                    DEBUG_LVL_ERROR_TRACE("%s new con: ip=%lX, port=%u, Ret=0x%X\n", __func__,
-                          (ULONG)ntohl(pInstance_p->aSdoAbsUdpConnection[freeEntry].ipAddr),
-                          ntohs((USHORT)pInstance_p->aSdoAbsUdpConnection[freeEntry].port), ret);
-                }
-            }
-            else
+            // offset 4 -> start of SDO Sequence header
+            ret = pInstance_p->pfnSdoAsySeqCb(sdoConHdl, (tAsySdoSeq*)&pBuffer_p[4], (size_p - 4));
+            if (ret != kErrorOk)
             {
-                DEBUG_LVL_ERROR_TRACE("Error in sdo-udpu: receiveFromSocket(): no free handle\n");
-#if (TARGET_SYSTEM == _WIN32_)
-                LeaveCriticalSection(sdoUdpInstance_l.pCriticalSection);
-#endif
+                DEBUG_LVL_ERROR_TRACE("%s new con: ip=%lX, port=%u, Ret=0x%X\n", __func__,
+                      (ULONG)ntohl(pInstance_p->aSdoAbsUdpConnection[freeEntry].ipAddr),
+                      ntohs((USHORT)pInstance_p->aSdoAbsUdpConnection[freeEntry].port), ret);
             }
         }
         else
         {
-            // known connection -> call callback with correct handle
-            sdoConHdl = count;
-            sdoConHdl |= SDO_UDP_HANDLE;
+            DEBUG_LVL_ERROR_TRACE("Error in sdo-udpu: receiveFromSocket(): no free handle\n");
 #if (TARGET_SYSTEM == _WIN32_)
             LeaveCriticalSection(sdoUdpInstance_l.pCriticalSection);
 #endif
-            // offset 4 -> start of SDO Sequence header
-            ret = pInstance_p->pfnSdoAsySeqCb(sdoConHdl, (tAsySdoSeq*)&aBuffer[4], (error - 4));
-            if (ret != kErrorOk)
-            {
-                DEBUG_LVL_ERROR_TRACE("%s known con: ip=%lX, port=%u, Ret=0x%X\n", __func__,
-                      (ULONG)ntohl(pInstance_p->aSdoAbsUdpConnection[count].ipAddr),
-                      ntohs((USHORT)pInstance_p->aSdoAbsUdpConnection[count].port), ret);
-            }
+        }
+    }
+    else
+    {
+        // known connection -> call callback with correct handle
+        sdoConHdl = count;
+        sdoConHdl |= SDO_UDP_HANDLE;
+#if (TARGET_SYSTEM == _WIN32_)
+        LeaveCriticalSection(sdoUdpInstance_l.pCriticalSection);
+#endif
+        // offset 4 -> start of SDO Sequence header
+        ret = pInstance_p->pfnSdoAsySeqCb(sdoConHdl, (tAsySdoSeq*)&pBuffer_p[4], (size_p - 4));
+        if (ret != kErrorOk)
+        {
+            DEBUG_LVL_ERROR_TRACE("%s known con: ip=%lX, port=%u, Ret=0x%X\n", __func__,
+                  (ULONG)ntohl(pInstance_p->aSdoAbsUdpConnection[count].ipAddr),
+                  ntohs((USHORT)pInstance_p->aSdoAbsUdpConnection[count].port), ret);
         }
     }
 }
@@ -613,9 +825,9 @@ void receiveFromSocket(tSdoUdpInstance* pInstance_p)
 /**
 \brief  UDP Receiving thread function
 
-The function implements the UDP receive thread. It waits for packets on the
-UDP socket and calls receiveFromSocket() if data is available.
-
+The function implements the UDP receive thread. It waits for packets on all
+UDP sockets (using epoll on Linux) and calls receiveFromSocket() for each
+socket with pending data.
 
 \param  pArg_p          Thread argument. The pointer to the SDO instance is
                         transfered to the thread as thread argument.
@@ -626,21 +838,52 @@ UDP socket and calls receiveFromSocket() if data is available.
 static tThreadResult sdoUdpThread(tThreadArg pArg_p)
 {
     tSdoUdpInstance*    pInstance;
-    fd_set              readFds;
     int                 result;
+    int                 index;
+#if (TARGET_SYSTEM == _LINUX_)
+    struct epoll_event  aEvent[CONFIG_SDO_UDP_MAX_SOCKETS];
+#else
+    fd_set              readFds;
     struct timeval      timeout;
+    SOCKET              maxSocket;
+#endif
 
     pInstance = (tSdoUdpInstance*)pArg_p;
 
     while (!pInstance->fStopThread)
     {
+#if (TARGET_SYSTEM == _LINUX_)
+        result = epoll_wait(pInstance->epollFd, aEvent, CONFIG_SDO_UDP_MAX_SOCKETS,
+                            SDO_UDP_THREAD_TIMEOUT_MS);
+        if (result < 0)
+        {
+            if (errno != EINTR)
+            {
+                DEBUG_LVL_SDO_TRACE("epoll_wait error: %s\n", strerror(errno));
+            }
+            continue;
+        }
+
+        // data available
+        for (index = 0; index < result; index++)
+            receiveFromSocket(pInstance, aEvent[index].data.u32);
+#else
         timeout.tv_sec = 0;
-        timeout.tv_usec = 400000;
+        timeout.tv_usec = SDO_UDP_THREAD_TIMEOUT_MS * 1000;
 
         FD_ZERO(&readFds);
-        FD_SET(pInstance->udpSocket, &readFds);
+        maxSocket = 0;
+        for (index = 0; index < CONFIG_SDO_UDP_MAX_SOCKETS; index++)
+        {
+            if (pInstance->aUdpSocket[index] == INVALID_SOCKET)
+                continue;
+
+            FD_SET(pInstance->aUdpSocket[index], &readFds);
+            if (pInstance->aUdpSocket[index] > maxSocket)
+                maxSocket = pInstance->aUdpSocket[index];
+        }
 
-        result = select(pInstance->udpSocket + 1, &readFds, NULL, NULL, &timeout);
+        result = select((int)maxSocket + 1, &readFds, NULL, NULL, &timeout);
         switch (result)
         {
             case 0:     // timeout
@@ -652,9 +895,15 @@ static tThreadResult sdoUdpThread(tThreadArg pArg_p)
                 break;
 
             default:    // data available
-                receiveFromSocket(pInstance);
+                for (index = 0; index < CONFIG_SDO_UDP_MAX_SOCKETS; index++)
+                {
+                    if ((pInstance->aUdpSocket[index] != INVALID_SOCKET) &&
+                        FD_ISSET(pInstance->aUdpSocket[index], &readFds))
+                        receiveFromSocket(pInstance, (UINT)index);
+                }
                 break;
         }
+#endif
     }
 
 #if (TARGET_SYSTEM == _LINUX_)
@@ -666,4 +915,3 @@ static tThreadResult sdoUdpThread(tThreadArg pArg_p)
 ///\}
 
 #endif
-
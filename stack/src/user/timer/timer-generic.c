@@ -295,6 +295,43 @@ tOplkError timeru_process(void)
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get time until the next timer expires
+
+This function returns the time until timeru_process() has to be called for the
+next expired timer.
+
+\return The function returns the time in milliseconds or
+        TIMERU_TIMEOUT_INFINITE if no timer is running.
+
+\ingroup module_timeru
+*/
+//------------------------------------------------------------------------------
+UINT32 timeru_getNextTimeout(void)
+{
+    UINT32              timeoutInMs = TIMERU_TIMEOUT_INFINITE;
+
+#if (TARGET_SYSTEM == _WIN32_ || TARGET_SYSTEM == _WINCE_ )
+    // the timers are processed by the process thread
+#else
+    UINT32              elapsedInMs;
+
+    enterCriticalSection(TIMERU_TIMER_LIST);
+    if (timeruInstance_l.pTimerListFirst != NULL)
+    {
+        elapsedInMs = getTickCount() - timeruInstance_l.startTimeInMs;
+        if (elapsedInMs >= timeruInstance_l.pTimerListFirst->timeoutInMs)
+            timeoutInMs = 0;
+        else
+            timeoutInMs = timeruInstance_l.pTimerListFirst->timeoutInMs - elapsedInMs;
+    }
+    leaveCriticalSection(TIMERU_TIMER_LIST);
+#endif
+
+    return timeoutInMs;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Create and set a timer
@@ -42,7 +42,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <user/timeru.h>
-#include <linux/timer.h>
+#include <linux/version.h>
+#include <linux/hrtimer.h>
+#include <linux/ktime.h>
 
 
 //============================================================================//
@@ -68,13 +70,26 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#ifndef CONFIG_TIMERU_SLACK_NS
+#define CONFIG_TIMERU_SLACK_NS      1000000     // allowed delay of a timer expiry [ns], lets the kernel coalesce timer interrupts
+#endif
+
+// The timer callbacks post events and must not run in hard IRQ context. The
+// soft mode is available since kernel 4.16, before the callbacks of a non
+// PREEMPT_RT kernel run in hard IRQ context.
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4,16,0)
+#define TIMERU_HRTIMER_MODE         HRTIMER_MODE_REL_SOFT
+#else
+#define TIMERU_HRTIMER_MODE         HRTIMER_MODE_REL
+#endif
 
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
 typedef struct
 {
-    struct timer_list   timer;
+    struct hrtimer      timer;
+    void*               pSelf;          // pointer to itself, for checking the handle
     tTimerArg           timerArgument;
 } tTimeruData;
 
@@ -85,7 +100,8 @@ typedef struct
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
-static void cbTimer(ULONG parameter_p);
+static enum hrtimer_restart cbTimer(struct hrtimer* pTimer_p);
+static void startTimer(tTimeruData* pData_p, ULONG timeInMs_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -158,6 +174,26 @@ tOplkError timeru_process(void)
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get time until the next timer expires
+
+This function returns the time until timeru_process() has to be called for the
+next expired timer.
+
+\note The timers of the Linux kernelspace implementation do not need
+      timeru_process()!
+
+\return The function returns TIMERU_TIMEOUT_INFINITE.
+
+\ingroup module_timeru
+*/
+//------------------------------------------------------------------------------
+UINT32 timeru_getNextTimeout(void)
+{
+    return TIMERU_TIMEOUT_INFINITE;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Create and set a timer
@@ -187,14 +223,13 @@ tOplkError timeru_setTimer(tTimerHdl* pTimerHdl_p, ULONG timeInMs_p, tTimerArg a
     if (pData == NULL)
         return kErrorNoResource;
 
-    init_timer(&pData->timer);
+    hrtimer_init(&pData->timer, CLOCK_MONOTONIC, TIMERU_HRTIMER_MODE);
     pData->timer.function = cbTimer;
-    pData->timer.data = (unsigned long) pData;
-    pData->timer.expires = jiffies + 1 + ((timeInMs_p * HZ) + 999) / 1000;
+    pData->pSelf = pData;
 
     OPLK_MEMCPY(&pData->timerArgument, &argument_p, sizeof(tTimerArg));
 
-    add_timer(&pData->timer);
+    startTimer(pData, timeInMs_p);
     *pTimerHdl_p = (tTimerHdl)pData;
     return ret;
 }
@@ -230,24 +265,19 @@ tOplkError timeru_modifyTimer(tTimerHdl* pTimerHdl_p, ULONG timeInMs_p, tTimerAr
         return timeru_setTimer(pTimerHdl_p, timeInMs_p, argument_p);
     }
     pData = (tTimeruData*)*pTimerHdl_p;
-    if ((tTimeruData*)pData->timer.data != pData)
+    if (pData->pSelf != pData)
         return kErrorTimerInvalidHandle;
 
-    mod_timer(&pData->timer, (jiffies + 1 + ((timeInMs_p * HZ) + 999) / 1000));
+    // hrtimer_start() removes the timer from the queue if it is still pending
+    startTimer(pData, timeInMs_p);
 
     // copy the TimerArg after the timer is restarted,
-    // so that a timer occurred immediately before mod_timer
+    // so that a timer occurred immediately before startTimer()
     // won't use the new TimerArg and
     // therefore the old timer cannot be distinguished from the new one.
     // But if the new timer is too fast, it may get lost.
     OPLK_MEMCPY(&pData->timerArgument, &argument_p, sizeof(tTimerArg));
 
-    // check if timer is really running
-    if (timer_pending(&pData->timer) == 0)
-    {   // timer is not running
-        // retry starting it
-        add_timer(&pData->timer);
-    }
     return ret;
 }
 
@@ -280,10 +310,11 @@ tOplkError timeru_deleteTimer(tTimerHdl* pTimerHdl_p)
         return kErrorOk;
 
     pData = (tTimeruData*)*pTimerHdl_p;
-    if ((tTimeruData*)pData->timer.data != pData)
+    if (pData->pSelf != pData)
         return kErrorTimerInvalidHandle;
 
-    del_timer(&pData->timer);         // try to delete the timer
+    hrtimer_cancel(&pData->timer);      // delete the timer and wait for a running callback
+    pData->pSelf = NULL;
     kfree(pData);                       // free memory in any case
 
     *pTimerHdl_p = 0;                   // uninitialize handle
@@ -315,13 +346,13 @@ BOOL timeru_isActive(tTimerHdl timerHdl_p)
     }
 
     pData = (tTimeruData*)timerHdl_p;
-    if ((tTimeruData*)pData->timer.data != pData)
+    if (pData->pSelf != pData)
     {   // invalid timer
         return fActive;
     }
 
     // check if timer is running
-    if (timer_pending(&pData->timer) != 0)
+    if (hrtimer_is_queued(&pData->timer))
     {   // timer is not running
         fActive = TRUE;
     }
@@ -334,6 +365,23 @@ BOOL timeru_isActive(tTimerHdl timerHdl_p)
 /// \name Private Functions
 /// \{
 
+//------------------------------------------------------------------------------
+/**
+\brief  Start a timer
+
+The function starts the hrtimer of a timer with the specified timeout. The
+timer may expire up to CONFIG_TIMERU_SLACK_NS later.
+
+\param  pData_p         Pointer to the timer data.
+\param  timeInMs_p      Timeout in milliseconds.
+*/
+//------------------------------------------------------------------------------
+static void startTimer(tTimeruData* pData_p, ULONG timeInMs_p)
+{
+    hrtimer_start_range_ns(&pData_p->timer, ms_to_ktime(timeInMs_p),
+                           CONFIG_TIMERU_SLACK_NS, TIMERU_HRTIMER_MODE);
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Timer callback function
@@ -341,18 +389,19 @@ BOOL timeru_isActive(tTimerHdl timerHdl_p)
 This function is registered if a timer is started and therefore will be called
 by the timer when it expires.
 
-\param  parameter_p     The user defined parameter supplied when starting the
-                        timer.
+\param  pTimer_p        Pointer to hrtimer struct of the expired timer.
+
+\return The function returns HRTIMER_NORESTART.
 */
 //------------------------------------------------------------------------------
-static void cbTimer(ULONG parameter_p)
+static enum hrtimer_restart cbTimer(struct hrtimer* pTimer_p)
 {
     tOplkError          ret = kErrorOk;
     tTimeruData*        pData;
     tEvent              event;
     tTimerEventArg      timerEventArg;
 
-    pData = (tTimeruData*)parameter_p;
+    pData = container_of(pTimer_p, tTimeruData, timer);
 
     // call event function
     timerEventArg.timerHdl = (tTimerHdl)pData;
@@ -366,6 +415,7 @@ static void cbTimer(ULONG parameter_p)
 
     ret = eventu_postEvent(&event);
     // d.k. do not free memory, user has to call timeru_deleteTimer()
+    return HRTIMER_NORESTART;
 }
 
 ///\}
@@ -5,7 +5,10 @@
 \brief  Implementation of user timer module for Linux userspace
 
 This file contains the implementation of the user timer module for Linux
-userspace. This implementation uses the posix timer interface.
+userspace. The timers are kept in a hierarchical timer wheel with a resolution
+of one millisecond, so setting, modifying and deleting a timer takes constant
+time. A single thread waits on a timerfd for the next tick which contains
+timers and posts the events of all timers expired until then.
 
 \ingroup module_timeru
 *******************************************************************************/
@@ -42,15 +45,16 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // includes
 //------------------------------------------------------------------------------
 #include <user/timeru.h>
+#include <common/target.h>
 
+#include <stddef.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <errno.h>
+#include <time.h>
 #include <sys/timerfd.h>
 #include <pthread.h>
 #include <sys/syscall.h>
-#include <semaphore.h>
-
-#include <signal.h>
 
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
@@ -75,27 +79,75 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+// The wheel consists of a first level with one slot per tick (millisecond)
+// and further levels which cover 64 times the range of the level below.
+// It covers timeouts of up to 2^32 ms.
+#define TIMERU_WHEEL_LEVEL0_BITS    8
+#define TIMERU_WHEEL_LEVEL_BITS     6
+#define TIMERU_WHEEL_LEVEL_COUNT    5
+#define TIMERU_WHEEL_LEVEL0_SIZE    (1 << TIMERU_WHEEL_LEVEL0_BITS)
+#define TIMERU_WHEEL_LEVEL_SIZE     (1 << TIMERU_WHEEL_LEVEL_BITS)
+#define TIMERU_WHEEL_LEVEL0_MASK    (TIMERU_WHEEL_LEVEL0_SIZE - 1)
+#define TIMERU_WHEEL_LEVEL_MASK     (TIMERU_WHEEL_LEVEL_SIZE - 1)
+#define TIMERU_WHEEL_SLOT_COUNT     (TIMERU_WHEEL_LEVEL0_SIZE + \
+                                     ((TIMERU_WHEEL_LEVEL_COUNT - 1) * TIMERU_WHEEL_LEVEL_SIZE))
+#define TIMERU_WHEEL_MAX_TIMEOUT    0xFFFFFFFFUL
+
+// number of ticks covered by the wheel levels below the specified level
+#define TIMERU_WHEEL_LEVEL_SHIFT(level_p)   (TIMERU_WHEEL_LEVEL0_BITS + \
+                                             (((level_p) - 1) * TIMERU_WHEEL_LEVEL_BITS))
+
+#ifndef CONFIG_TIMERU_SLACK_NS
+#define CONFIG_TIMERU_SLACK_NS      0           // allowed delay of a timer expiry [ns], lets timers which expire close together share one wake-up
+#endif
+
+// The timerfd is armed at multiples of the slack, so all timers expiring
+// within one slack interval are handled by a single wake-up of the thread.
+#define TIMERU_SLACK_TICKS          (CONFIG_TIMERU_SLACK_NS / 1000000)
 
 //------------------------------------------------------------------------------
 // local types
 //------------------------------------------------------------------------------
-typedef struct sTimeruData tTimeruData;
+typedef struct sTimeruListEntry tTimeruListEntry;
 
-struct sTimeruData
+/**
+\brief  Entry of a circular doubly linked timer list
+
+List heads are entries of the same type, so a timer can be removed from its
+list without knowing the list.
+*/
+struct sTimeruListEntry
 {
-    timer_t             timer;
-    tTimerArg           timerArgument;
-    tTimeruData*        pNextTimer;
-    tTimeruData*        pPrevTimer;
+    tTimeruListEntry*   pNext;
+    tTimeruListEntry*   pPrev;
 };
 
+/**
+\brief  User timer
+
+The wheel entry must be the first member, so a list entry can be cast to its
+timer.
+*/
+typedef struct
+{
+    tTimeruListEntry    wheelEntry;         ///< Entry in a wheel slot or in the list of expired timers
+    tTimeruListEntry    timerEntry;         ///< Entry in the list of all timers
+    tTimerArg           timerArgument;
+    UINT64              expireTick;         ///< Tick (absolute time in ms) at which the timer expires
+    BOOL                fActive;            ///< The timer is running
+} tTimeruData;
+
 typedef struct
 {
     pthread_t           processThread;
     pthread_mutex_t     mutex;
-    tTimeruData*        pFirstTimer;
-    tTimeruData*        pLastTimer;
-    tTimeruData*        pCurrentTimer;
+    int                 timerFd;
+    UINT64              curTick;            ///< Next tick to be processed by the wheel
+    UINT64              armedTick;          ///< Tick the timerfd is armed for, 0 if disarmed
+    UINT                activeCount;        ///< Number of timers in the wheel
+    tTimeruListEntry    aSlot[TIMERU_WHEEL_SLOT_COUNT];
+    tTimeruListEntry    expiredList;        ///< Expired timers which events are not yet posted
+    tTimeruListEntry    timerList;          ///< All allocated timers
 } tTimeruInstance;
 
 //------------------------------------------------------------------------------
@@ -106,12 +158,19 @@ static tTimeruInstance timeruInstance_g;
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
-static void cbTimer(ULONG parameter_p);
 static void* processThread(void* pArgument_p);
-static void addTimer(tTimeruData* pData_p);
-static void removeTimer(tTimeruData* pData_p);
-static void resetTimerList(void);
-static tTimeruData* getNextTimer(void);
+static void postExpiredTimers(void);
+static UINT64 getCurrentTick(BOOL fRoundUp_p);
+static void startTimer(tTimeruData* pData_p, ULONG timeInMs_p);
+static void stopTimer(tTimeruData* pData_p);
+static void insertTimer(tTimeruData* pData_p);
+static void cascadeSlot(UINT level_p);
+static void advanceWheel(UINT64 tick_p);
+static void armTimerFd(UINT64 tick_p);
+static UINT64 getNextEventTick(void);
+static void initList(tTimeruListEntry* pList_p);
+static void appendList(tTimeruListEntry* pList_p, tTimeruListEntry* pEntry_p);
+static void removeList(tTimeruListEntry* pEntry_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -146,41 +205,46 @@ The function adds a user timer instance.
 //------------------------------------------------------------------------------
 tOplkError timeru_addInstance(void)
 {
-    struct sched_param          schedParam;
-    INT                         retVal;
+    UINT                        slot;
 
     // reset instance structure
-    timeruInstance_g.processThread = 0;
-    timeruInstance_g.pFirstTimer = NULL;
-    timeruInstance_g.pLastTimer = NULL;
+    OPLK_MEMSET(&timeruInstance_g, 0, sizeof(tTimeruInstance));
+    for (slot = 0; slot < TIMERU_WHEEL_SLOT_COUNT; slot++)
+        initList(&timeruInstance_g.aSlot[slot]);
+    initList(&timeruInstance_g.expiredList);
+    initList(&timeruInstance_g.timerList);
+    timeruInstance_g.curTick = getCurrentTick(FALSE);
+
+    timeruInstance_g.timerFd = timerfd_create(CLOCK_MONOTONIC, 0);
+    if (timeruInstance_g.timerFd < 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't create timerfd! (%d)\n", __func__, errno);
+        return kErrorNoResource;
+    }
 
     if (pthread_mutex_init(&timeruInstance_g.mutex, NULL) != 0)
     {
         DEBUG_LVL_ERROR_TRACE("%s() couldn't init mutex!\n", __func__);
+        close(timeruInstance_g.timerFd);
         return kErrorNoResource;
     }
 
-    if ((retVal = pthread_create(&timeruInstance_g.processThread, NULL,
-                                 processThread,  &timeruInstance_g)) != 0)
+    if (target_createThread(&timeruInstance_g.processThread, kThreadRoleTimerU, "oplk-timeru",
+                            processThread, &timeruInstance_g) != kErrorOk)
     {
-        DEBUG_LVL_ERROR_TRACE("%s() couldn't create timer thread! (%d)\n",
-                                __func__, retVal);
+        DEBUG_LVL_ERROR_TRACE("%s() couldn't create timer thread!\n", __func__);
         pthread_mutex_destroy(&timeruInstance_g.mutex);
+        close(timeruInstance_g.timerFd);
         return kErrorNoResource;
     }
 
-    schedParam.__sched_priority = CONFIG_THREAD_PRIORITY_LOW;
-    if (pthread_setschedparam(timeruInstance_g.processThread, SCHED_RR,
-                              &schedParam) != 0)
+    if (target_setThreadParams(timeruInstance_g.processThread, kThreadRoleTimerU, kThreadSchedRr,
+                               CONFIG_THREAD_PRIORITY_LOW, 0) != kErrorOk)
     {
         DEBUG_LVL_ERROR_TRACE("%s() couldn't set thread scheduling parameters!\n",
                                 __func__);
     }
 
-#if (defined(__GLIBC__) && __GLIBC__ >= 2 && __GLIBC_MINOR__ >= 12)
-    pthread_setname_np(timeruInstance_g.processThread, "oplk-timeru");
-#endif
-
     return kErrorOk;
 }
 
@@ -208,17 +272,16 @@ tOplkError timeru_delInstance(void)
     DEBUG_LVL_TIMERU_TRACE("%s()Thread exited\n", __func__);
 
     /* free up timer list */
-    resetTimerList();
-    while ((pTimer = getNextTimer()) != NULL)
+    while (timeruInstance_g.timerList.pNext != &timeruInstance_g.timerList)
     {
-        removeTimer(pTimer);
+        pTimer = (tTimeruData*)((UINT8*)timeruInstance_g.timerList.pNext -
+                                offsetof(tTimeruData, timerEntry));
+        removeList(&pTimer->timerEntry);
         OPLK_FREE(pTimer);
     }
 
     pthread_mutex_destroy(&timeruInstance_g.mutex);
-
-    timeruInstance_g.pFirstTimer = NULL;
-    timeruInstance_g.pLastTimer = NULL;
+    close(timeruInstance_g.timerFd);
 
     return kErrorOk;
 }
@@ -242,6 +305,26 @@ tOplkError timeru_process(void)
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get time until the next timer expires
+
+This function returns the time until timeru_process() has to be called for the
+next expired timer.
+
+\note The timers of the Linux userspace implementation do not need
+      timeru_process()!
+
+\return The function returns TIMERU_TIMEOUT_INFINITE.
+
+\ingroup module_timeru
+*/
+//------------------------------------------------------------------------------
+UINT32 timeru_getNextTimeout(void)
+{
+    return TIMERU_TIMEOUT_INFINITE;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Create and set a timer
@@ -261,9 +344,6 @@ corresponding timer handle.
 tOplkError timeru_setTimer(tTimerHdl* pTimerHdl_p, ULONG timeInMs_p, tTimerArg argument_p)
 {
     tTimeruData*        pData;
-    struct itimerspec   relTime;
-    struct itimerspec   curTime;
-    struct sigevent     sev;
 
     if(pTimerHdl_p == NULL)
         return kErrorTimerInvalidHandle;
@@ -272,42 +352,16 @@ tOplkError timeru_setTimer(tTimerHdl* pTimerHdl_p, ULONG timeInMs_p, tTimerArg a
     if (pData == NULL)
         return kErrorNoResource;
 
+    OPLK_MEMSET(pData, 0, sizeof(tTimeruData));
     OPLK_MEMCPY(&pData->timerArgument, &argument_p, sizeof(tTimerArg));
 
-    addTimer(pData);
-
-    sev.sigev_notify = SIGEV_SIGNAL;
-    sev.sigev_signo = SIGRTMIN;
-    sev.sigev_value.sival_ptr = &pData->timer;
-    if (timer_create(CLOCK_MONOTONIC, &sev, &pData->timer) == -1)
-    {
-        DEBUG_LVL_ERROR_TRACE("%s() Error creating timer!\n", __func__);
-        OPLK_FREE(pData);
-        return kErrorNoResource;
-    }
-
-    if (timeInMs_p >= 1000)
-    {
-        relTime.it_value.tv_sec = (timeInMs_p / 1000);
-        relTime.it_value.tv_nsec = (timeInMs_p % 1000) * 1000000;
-    }
-    else
-    {
-        relTime.it_value.tv_sec = 0;
-        relTime.it_value.tv_nsec = timeInMs_p * 1000000;
-    }
-
     /*DEBUG_LVL_TIMERU_TRACE("%s() Set timer: %p, timeInMs_p=%ld\n",
                              __func__, (void *)pData, timeInMs_p); */
 
-    relTime.it_interval.tv_sec = 0;
-    relTime.it_interval.tv_nsec = 0;
-
-    if (timer_settime(pData->timer, 0, &relTime, &curTime) < 0)
-    {
-        DEBUG_LVL_ERROR_TRACE("%s() Error timer_settime!\n", __func__);
-        return kErrorTimerNoTimerCreated;
-    }
+    pthread_mutex_lock(&timeruInstance_g.mutex);
+    appendList(&timeruInstance_g.timerList, &pData->timerEntry);
+    startTimer(pData, timeInMs_p);
+    pthread_mutex_unlock(&timeruInstance_g.mutex);
 
     *pTimerHdl_p = (tTimerHdl)pData;
     return kErrorOk;
@@ -332,7 +386,6 @@ it creates the timer and stores the new timer handle at \p pTimerHdl_p.
 tOplkError timeru_modifyTimer(tTimerHdl* pTimerHdl_p, ULONG timeInMs_p, tTimerArg argument_p)
 {
     tTimeruData*        pData;
-    struct itimerspec   relTime, curTime;
 
     if(pTimerHdl_p == NULL)
         return kErrorTimerInvalidHandle;
@@ -344,34 +397,16 @@ tOplkError timeru_modifyTimer(tTimerHdl* pTimerHdl_p, ULONG timeInMs_p, tTimerAr
     }
     pData = (tTimeruData*)*pTimerHdl_p;
 
-    if (timeInMs_p >= 1000)
-    {
-        relTime.it_value.tv_sec = (timeInMs_p / 1000);
-        relTime.it_value.tv_nsec = (timeInMs_p % 1000) * 1000000;
-    }
-    else
-    {
-        relTime.it_value.tv_sec = 0;
-        relTime.it_value.tv_nsec = timeInMs_p * 1000000;
-    }
-
     /* DEBUG_LVL_TIMERU_TRACE("%s() Modify timer:%08x timeInMs_p=%ld\n",
                              __func__, *pTimerHdl_p, timeInMs_p); */
 
-    relTime.it_interval.tv_sec = 0;
-    relTime.it_interval.tv_nsec = 0;
-    if (timer_settime(pData->timer, 0, &relTime, &curTime) != 0)
-    {
-        DEBUG_LVL_ERROR_TRACE("%s() Error timer_settime!\n", __func__);
-        return kErrorTimerNoTimerCreated;
-    }
-
-    // copy the TimerArg after the timer is restarted,
-    // so that a timer occurred immediately before timer_settime
-    // won't use the new timerArg and
-    // therefore the old timer cannot be distinguished from the new one.
-    // But if the new timer is too fast, it may get lost.
+    // Restarting the timer also drops a pending expiration of the old timer,
+    // so the old timer cannot be mistaken for the new one.
+    pthread_mutex_lock(&timeruInstance_g.mutex);
+    stopTimer(pData);
     OPLK_MEMCPY(&pData->timerArgument, &argument_p, sizeof(tTimerArg));
+    startTimer(pData, timeInMs_p);
+    pthread_mutex_unlock(&timeruInstance_g.mutex);
 
     return kErrorOk;
 }
@@ -405,8 +440,10 @@ tOplkError timeru_deleteTimer(tTimerHdl* pTimerHdl_p)
     }
     pData = (tTimeruData*)*pTimerHdl_p;
 
-    timer_delete(pData->timer);
-    removeTimer(pData);
+    pthread_mutex_lock(&timeruInstance_g.mutex);
+    stopTimer(pData);
+    removeList(&pData->timerEntry);
+    pthread_mutex_unlock(&timeruInstance_g.mutex);
     OPLK_FREE(pData);
 
     // uninitialize handle
@@ -431,7 +468,7 @@ This function checks if a timer is active (is running).
 BOOL timeru_isActive(tTimerHdl timerHdl_p)
 {
     tTimeruData*        pData;
-    struct itimerspec   remaining;
+    BOOL                fActive;
 
     // check handle itself, i.e. was the handle initialized before
     if (timerHdl_p == 0)
@@ -440,17 +477,11 @@ BOOL timeru_isActive(tTimerHdl timerHdl_p)
     }
     pData = (tTimeruData*)timerHdl_p;
 
-    // check if timer is running
-    timer_gettime(pData->timer, &remaining);
+    pthread_mutex_lock(&timeruInstance_g.mutex);
+    fActive = pData->fActive;
+    pthread_mutex_unlock(&timeruInstance_g.mutex);
 
-    if ((remaining.it_value.tv_sec == 0) && (remaining.it_value.tv_nsec == 0))
-    {
-        return FALSE;
-    }
-    else
-    {
-        return TRUE;
-    }
+    return fActive;
 }
 
 //============================================================================//
@@ -464,7 +495,9 @@ BOOL timeru_isActive(tTimerHdl timerHdl_p)
 \brief  Timer thread function
 
 This function implements the timer thread function which will be started as
-thread and is responsible for processing expired timers.
+thread and is responsible for processing expired timers. It waits on the
+timerfd, advances the timer wheel to the current time and posts the events of
+all timers expired in between.
 
 \param  pArgument_p     Thread argument. Not used!
 
@@ -473,27 +506,36 @@ thread and is responsible for processing expired timers.
 //------------------------------------------------------------------------------
 static void* processThread(void* pArgument_p)
 {
-    tTimeruData*    pTimer;
-    sigset_t        awaitedSignal;
-    siginfo_t       signalInfo;
+    UINT64          expirations;
+    int             cancelState;
 
     UNUSED_PARAMETER(pArgument_p);
 
     DEBUG_LVL_TIMERU_TRACE("%s() ThreadId:%d\n", __func__, syscall(SYS_gettid));
 
-    sigemptyset(&awaitedSignal);
-    sigaddset(&awaitedSignal, SIGRTMIN);
-    pthread_sigmask(SIG_BLOCK, &awaitedSignal, NULL);
-
     /* loop forever until thread will be canceled */
     while (1)
     {
-        if (sigwaitinfo(&awaitedSignal, &signalInfo) > 0)
+        // the thread is only canceled while it waits for the timerfd
+        if (read(timeruInstance_g.timerFd, &expirations, sizeof(expirations)) < 0)
         {
-            pTimer = (tTimeruData*)signalInfo.si_value.sival_ptr;
-            /* call callback function of timer */
-            cbTimer((ULONG)pTimer);
+            if (errno != EINTR)
+            {
+                DEBUG_LVL_ERROR_TRACE("%s() Error reading timerfd! (%d)\n", __func__, errno);
+            }
+            continue;
         }
+
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancelState);
+        pthread_mutex_lock(&timeruInstance_g.mutex);
+
+        timeruInstance_g.armedTick = 0;
+        advanceWheel(getCurrentTick(FALSE));
+        armTimerFd(getNextEventTick());
+        postExpiredTimers();
+
+        pthread_mutex_unlock(&timeruInstance_g.mutex);
+        pthread_setcancelstate(cancelState, NULL);
     }
 
     DEBUG_LVL_TIMERU_TRACE("%s() Exiting!\n", __func__);
@@ -502,143 +544,368 @@ static void* processThread(void* pArgument_p)
 
 //------------------------------------------------------------------------------
 /**
-\brief  Timer callback function
+\brief  Post events of expired timers
 
-This function is registered if a timer is started and therefore will be called
-by the timer when it expires.
+This function posts the timer events of all expired timers. The mutex is
+released while an event is posted, so the event handler may access the timers.
+A timer which is deleted or modified in the meantime is removed from the list
+of expired timers and its event is not posted anymore.
 
-\param  parameter_p     The user defined parameter supplied when starting the
-                        timer.
+\note The function must be called with locked mutex.
 */
 //------------------------------------------------------------------------------
-static void cbTimer(ULONG parameter_p)
+static void postExpiredTimers(void)
 {
     tTimeruData*        pData;
     tEvent              event;
     tTimerEventArg      timerEventArg;
 
-    pData = (tTimeruData*)parameter_p;
-
-    // call event function
-    timerEventArg.timerHdl = (tTimerHdl)pData;
-    OPLK_MEMCPY(&timerEventArg.argument, &pData->timerArgument.argument,
-               sizeof(timerEventArg.argument));
-
-    event.eventSink = pData->timerArgument.eventSink;
     event.eventType = kEventTypeTimer;
     OPLK_MEMSET(&event.netTime, 0x00, sizeof(tNetTime));
     event.pEventArg = &timerEventArg;
     event.eventArgSize = sizeof(timerEventArg);
 
-    eventu_postEvent(&event);
+    while (timeruInstance_g.expiredList.pNext != &timeruInstance_g.expiredList)
+    {
+        pData = (tTimeruData*)timeruInstance_g.expiredList.pNext;
+        removeList(&pData->wheelEntry);
+
+        timerEventArg.timerHdl = (tTimerHdl)pData;
+        OPLK_MEMCPY(&timerEventArg.argument, &pData->timerArgument.argument,
+                    sizeof(timerEventArg.argument));
+        event.eventSink = pData->timerArgument.eventSink;
+
+        pthread_mutex_unlock(&timeruInstance_g.mutex);
+        eventu_postEvent(&event);
+        pthread_mutex_lock(&timeruInstance_g.mutex);
+    }
 }
 
 //------------------------------------------------------------------------------
 /**
-\brief  Add a timer to the timer list
+\brief  Get current tick
+
+This function returns the current value of the monotonic clock in ticks
+(milliseconds).
 
-This function adds a new timer to the timer list.
+\param  fRoundUp_p      Round up to the next full tick instead of down.
+
+\return The function returns the current tick.
+*/
+//------------------------------------------------------------------------------
+static UINT64 getCurrentTick(BOOL fRoundUp_p)
+{
+    struct timespec     curTime;
+    UINT64              tick;
+
+    clock_gettime(CLOCK_MONOTONIC, &curTime);
+    tick = ((UINT64)curTime.tv_sec * 1000) + (curTime.tv_nsec / 1000000);
+    if (fRoundUp_p && ((curTime.tv_nsec % 1000000) != 0))
+        tick++;
+
+    return tick;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Start a timer
+
+This function inserts the timer into the timer wheel and arms the timerfd if
+the timer expires before any other timer.
 
 \param  pData_p         Pointer to the timer structure.
+\param  timeInMs_p      Timeout in milliseconds.
+
+\note The function must be called with locked mutex.
 */
 //------------------------------------------------------------------------------
-static void addTimer(tTimeruData* pData_p)
+static void startTimer(tTimeruData* pData_p, ULONG timeInMs_p)
 {
-    tTimeruData*          pTimerData;
+    UINT64      curTick;
 
-    pthread_mutex_lock(&timeruInstance_g.mutex);
+    if (timeInMs_p > TIMERU_WHEEL_MAX_TIMEOUT)
+        timeInMs_p = TIMERU_WHEEL_MAX_TIMEOUT;
 
-    if (timeruInstance_g.pFirstTimer == NULL)
+    // The wheel is not advanced while it is empty, so the time needs to be
+    // skipped instead of processing the elapsed ticks one by one.
+    curTick = getCurrentTick(TRUE);
+    if ((timeruInstance_g.activeCount == 0) && (timeruInstance_g.curTick < curTick))
+        timeruInstance_g.curTick = getCurrentTick(FALSE);
+
+    // a timer must not expire before the specified time is elapsed
+    pData_p->expireTick = curTick + timeInMs_p;
+    pData_p->fActive = TRUE;
+    timeruInstance_g.activeCount++;
+    insertTimer(pData_p);
+
+    if ((timeruInstance_g.armedTick == 0) || (pData_p->expireTick < timeruInstance_g.armedTick))
+        armTimerFd(pData_p->expireTick);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Stop a timer
+
+This function removes the timer from the timer wheel or from the list of
+expired timers. The timerfd stays armed, a wake-up without expired timers is
+harmless.
+
+\param  pData_p         Pointer to the timer structure.
+
+\note The function must be called with locked mutex.
+*/
+//------------------------------------------------------------------------------
+static void stopTimer(tTimeruData* pData_p)
+{
+    if (pData_p->wheelEntry.pNext != NULL)
+        removeList(&pData_p->wheelEntry);
+
+    if (pData_p->fActive)
     {
-        timeruInstance_g.pFirstTimer = pData_p;
-        timeruInstance_g.pLastTimer = pData_p;
+        pData_p->fActive = FALSE;
+        timeruInstance_g.activeCount--;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Insert a timer into the wheel
+
+This function inserts a timer into the slot of the timer wheel which covers
+its expiration tick. Timers which are already expired are inserted into the
+slot of the current tick.
 
-        pData_p->pPrevTimer = NULL;
-        pData_p->pNextTimer = NULL;
+\param  pData_p         Pointer to the timer structure.
+*/
+//------------------------------------------------------------------------------
+static void insertTimer(tTimeruData* pData_p)
+{
+    UINT64      expireTick = pData_p->expireTick;
+    UINT64      delta;
+    UINT        level;
+    UINT        slot;
+
+    if (expireTick < timeruInstance_g.curTick)
+        expireTick = timeruInstance_g.curTick;
+
+    delta = expireTick - timeruInstance_g.curTick;
+    if (delta < TIMERU_WHEEL_LEVEL0_SIZE)
+    {
+        slot = (UINT)(expireTick & TIMERU_WHEEL_LEVEL0_MASK);
     }
     else
     {
-        pTimerData = timeruInstance_g.pLastTimer;
-        pTimerData->pNextTimer = pData_p;
-        pData_p->pPrevTimer = pTimerData;
-        pData_p->pNextTimer = NULL;
-        timeruInstance_g.pLastTimer = pData_p;
+        for (level = 1; level < TIMERU_WHEEL_LEVEL_COUNT - 1; level++)
+        {
+            if (delta < (1ULL << TIMERU_WHEEL_LEVEL_SHIFT(level + 1)))
+                break;
+        }
+
+        slot = TIMERU_WHEEL_LEVEL0_SIZE + ((level - 1) * TIMERU_WHEEL_LEVEL_SIZE) +
+               (UINT)((expireTick >> TIMERU_WHEEL_LEVEL_SHIFT(level)) & TIMERU_WHEEL_LEVEL_MASK);
     }
 
-    pthread_mutex_unlock(&timeruInstance_g.mutex);
+    appendList(&timeruInstance_g.aSlot[slot], &pData_p->wheelEntry);
 }
 
 //------------------------------------------------------------------------------
 /**
-\brief  Remove a timer from the timer list
+\brief  Cascade a wheel slot
 
-This function removes a new timer from the timer list.
+This function moves all timers of the current slot of the specified level to
+the lower levels of the wheel.
 
-\param  pData_p         Pointer to the timer structure.
+\param  level_p         Level of the wheel to cascade (1 or higher).
 */
 //------------------------------------------------------------------------------
-static void removeTimer(tTimeruData* pData_p)
+static void cascadeSlot(UINT level_p)
 {
-    tTimeruData*          pTimerData;
+    tTimeruListEntry*   pSlot;
+    tTimeruListEntry    list;
+
+    pSlot = &timeruInstance_g.aSlot[TIMERU_WHEEL_LEVEL0_SIZE +
+                                    ((level_p - 1) * TIMERU_WHEEL_LEVEL_SIZE) +
+                                    (UINT)((timeruInstance_g.curTick >> TIMERU_WHEEL_LEVEL_SHIFT(level_p)) &
+                                           TIMERU_WHEEL_LEVEL_MASK)];
+    if (pSlot->pNext == pSlot)
+        return;
+
+    // take over the whole slot, because timers could be inserted into it again
+    list.pNext = pSlot->pNext;
+    list.pPrev = pSlot->pPrev;
+    list.pNext->pPrev = &list;
+    list.pPrev->pNext = &list;
+    initList(pSlot);
+
+    while (list.pNext != &list)
+    {
+        tTimeruData* pData = (tTimeruData*)list.pNext;
 
-    pthread_mutex_lock(&timeruInstance_g.mutex);
+        removeList(&pData->wheelEntry);
+        insertTimer(pData);
+    }
+}
 
-    if (pData_p->pPrevTimer == NULL)          // first one
+//------------------------------------------------------------------------------
+/**
+\brief  Advance the timer wheel
+
+This function processes all ticks of the timer wheel up to the specified tick.
+The timers of these ticks are moved to the list of expired timers.
+
+\param  tick_p          Last tick to be processed.
+*/
+//------------------------------------------------------------------------------
+static void advanceWheel(UINT64 tick_p)
+{
+    tTimeruListEntry*   pSlot;
+    tTimeruData*        pData;
+    UINT                level;
+
+    while (timeruInstance_g.curTick <= tick_p)
     {
-        timeruInstance_g.pFirstTimer = pData_p->pNextTimer;
-        pTimerData = pData_p->pNextTimer;
-        if (pTimerData != NULL)
+        if (timeruInstance_g.activeCount == 0)
+        {   // nothing to do, just skip the elapsed time
+            timeruInstance_g.curTick = tick_p + 1;
+            break;
+        }
+
+        // move timers of higher levels down when the level below wraps around
+        for (level = 1; level < TIMERU_WHEEL_LEVEL_COUNT; level++)
         {
-            pTimerData->pPrevTimer = NULL;
+            if ((timeruInstance_g.curTick & ((1ULL << TIMERU_WHEEL_LEVEL_SHIFT(level)) - 1)) != 0)
+                break;
+            cascadeSlot(level);
         }
+
+        pSlot = &timeruInstance_g.aSlot[timeruInstance_g.curTick & TIMERU_WHEEL_LEVEL0_MASK];
+        while (pSlot->pNext != pSlot)
+        {
+            pData = (tTimeruData*)pSlot->pNext;
+            removeList(&pData->wheelEntry);
+            pData->fActive = FALSE;
+            timeruInstance_g.activeCount--;
+            appendList(&timeruInstance_g.expiredList, &pData->wheelEntry);
+        }
+
+        timeruInstance_g.curTick++;
     }
-    else if (pData_p->pNextTimer == NULL)     // last one
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get tick of next wheel event
+
+This function determines the next tick at which the timer wheel needs to be
+processed. This is either the next tick with expiring timers in the first
+level or the next cascade of the higher levels.
+
+\return The function returns the next tick or 0 if there is no active timer.
+*/
+//------------------------------------------------------------------------------
+static UINT64 getNextEventTick(void)
+{
+    UINT64      tick;
+    UINT        offset;
+
+    if (timeruInstance_g.activeCount == 0)
+        return 0;
+
+    for (offset = 0; offset < TIMERU_WHEEL_LEVEL0_SIZE; offset++)
     {
-        timeruInstance_g.pLastTimer = pData_p->pPrevTimer;
-        pTimerData = pData_p->pPrevTimer;
-        pTimerData->pNextTimer = NULL;
+        tick = timeruInstance_g.curTick + offset;
+        if ((tick & TIMERU_WHEEL_LEVEL0_MASK) == 0)
+            return tick;    // first level wraps around, higher levels are cascaded
+
+        if (timeruInstance_g.aSlot[tick & TIMERU_WHEEL_LEVEL0_MASK].pNext !=
+            &timeruInstance_g.aSlot[tick & TIMERU_WHEEL_LEVEL0_MASK])
+            return tick;
     }
-    else
+
+    return timeruInstance_g.curTick + TIMERU_WHEEL_LEVEL0_SIZE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Arm the timerfd
+
+This function arms the timerfd to expire at the specified tick. With a timer
+slack of more than one tick, the tick is rounded up to the next multiple of
+TIMERU_SLACK_TICKS.
+
+\param  tick_p          Tick at which the timerfd expires. 0 disarms it.
+*/
+//------------------------------------------------------------------------------
+static void armTimerFd(UINT64 tick_p)
+{
+    struct itimerspec   absTime;
+
+#if (TIMERU_SLACK_TICKS > 1)
+    if (tick_p != 0)
+        tick_p = ((tick_p + TIMERU_SLACK_TICKS - 1) / TIMERU_SLACK_TICKS) * TIMERU_SLACK_TICKS;
+
+    if (tick_p == timeruInstance_g.armedTick)
+        return;     // expiry is covered by the armed wake-up
+#endif
+
+    OPLK_MEMSET(&absTime, 0, sizeof(absTime));
+    if (tick_p != 0)
     {
-        pData_p->pPrevTimer->pNextTimer = pData_p->pNextTimer;
-        pData_p->pNextTimer->pPrevTimer = pData_p->pPrevTimer;
+        absTime.it_value.tv_sec = (time_t)(tick_p / 1000);
+        absTime.it_value.tv_nsec = (long)((tick_p % 1000) * 1000000);
     }
 
-    pthread_mutex_unlock(&timeruInstance_g.mutex);
+    if (timerfd_settime(timeruInstance_g.timerFd, TFD_TIMER_ABSTIME, &absTime, NULL) != 0)
+    {
+        DEBUG_LVL_ERROR_TRACE("%s() Error timerfd_settime! (%d)\n", __func__, errno);
+        return;
+    }
+
+    timeruInstance_g.armedTick = tick_p;
 }
 
 //------------------------------------------------------------------------------
 /**
-\brief  Reset the timer list
+\brief  Initialize a timer list
 
-This function resets the timer list.
+\param  pList_p         Pointer to the list head.
 */
 //------------------------------------------------------------------------------
-static void resetTimerList(void)
+static void initList(tTimeruListEntry* pList_p)
 {
-    timeruInstance_g.pCurrentTimer = timeruInstance_g.pFirstTimer;
+    pList_p->pNext = pList_p;
+    pList_p->pPrev = pList_p;
 }
 
 //------------------------------------------------------------------------------
 /**
-\brief  Get next timer from the list
+\brief  Append an entry to a timer list
 
-This function gets the next timer from the timer list.
-
-\return     The function returns a pointer to the next timer in the timer list.
+\param  pList_p         Pointer to the list head.
+\param  pEntry_p        Pointer to the entry to append.
 */
 //------------------------------------------------------------------------------
-static tTimeruData* getNextTimer(void)
+static void appendList(tTimeruListEntry* pList_p, tTimeruListEntry* pEntry_p)
 {
-    tTimeruData*    pTimer;
+    pEntry_p->pNext = pList_p;
+    pEntry_p->pPrev = pList_p->pPrev;
+    pList_p->pPrev->pNext = pEntry_p;
+    pList_p->pPrev = pEntry_p;
+}
 
-    pTimer = timeruInstance_g.pCurrentTimer;
-    if (pTimer != NULL)
-    {
-        timeruInstance_g.pCurrentTimer = pTimer->pNextTimer;
-    }
-    return pTimer;
+//------------------------------------------------------------------------------
+/**
+\brief  Remove an entry from its timer list
+
+\param  pEntry_p        Pointer to the entry to remove.
+*/
+//------------------------------------------------------------------------------
+static void removeList(tTimeruListEntry* pEntry_p)
+{
+    pEntry_p->pPrev->pNext = pEntry_p->pNext;
+    pEntry_p->pNext->pPrev = pEntry_p->pPrev;
+    pEntry_p->pNext = NULL;
+    pEntry_p->pPrev = NULL;
 }
 
 ///\}
-
@@ -232,6 +232,26 @@ tOplkError timeru_process(void)
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Get time until the next timer expires
+
+This function returns the time until timeru_process() has to be called for the
+next expired timer.
+
+\note The timers of the VxWorks implementation do not need
+      timeru_process()!
+
+\return The function returns TIMERU_TIMEOUT_INFINITE.
+
+\ingroup module_timeru
+*/
+//------------------------------------------------------------------------------
+UINT32 timeru_getNextTimeout(void)
+{
+    return TIMERU_TIMEOUT_INFINITE;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Create and set a timer
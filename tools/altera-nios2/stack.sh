@@ -42,6 +42,9 @@ fi
 # process arguments
 DEBUG=
 OUT_PATH=.
+PROFILE=
+PROFILE_ELF=
+PROFILE_REF=
 while [ $# -gt 0 ]
 do
     case "$1" in
@@ -52,12 +55,28 @@ do
             shift
             OUT_PATH=$1
             ;;
+        --profile)
+            shift
+            PROFILE=$1
+            ;;
+        --profile-elf)
+            shift
+            PROFILE_ELF=$1
+            ;;
+        --profile-ref)
+            shift
+            PROFILE_REF=$1
+            ;;
         --help)
             echo "$ stack.sh [BSP] [OPTIONS]"
             echo "BSP           ... Path to generated BSP (settings.bsp, public.mk, Makefile)"
             echo "OPTIONS       ... :"
             echo "                      --debug ... Lib is generated with O0"
             echo "                      --out   ... Path to directory where Lib is generated to"
+            echo "                      --profile ... Profile of a reference run (gprof flat profile"
+            echo "                                    or cycle counts) used to assign the TCI memory"
+            echo "                      --profile-elf ... ELF file of the profiled reference run"
+            echo "                      --profile-ref ... Description of the reference run"
             exit 1
             ;;
         *)
@@ -193,6 +212,28 @@ fi
 
 OUT_PATH+=/lib${LIB_NAME}
 
+# Generate the TCI memory section assignments from the profile
+if [ -n "${PROFILE}" ] && [ -z "${DEBUG}" ]; then
+    if [ -z "${PROFILE_ELF}" ]; then
+        echo "ERROR: No ELF file of the profiled reference run is given (--profile-elf)!"
+        exit 1
+    fi
+
+    echo "INFO: Generate TCI memory section assignments ... "
+
+    mkdir -p ${OUT_PATH}/include
+    perl ${OPLK_BASE_DIR}/tools/gensections.pl --arch nios2 \
+        --profile ${PROFILE} --elf ${PROFILE_ELF} --budget ${TCI_MEM_SIZE} \
+        --ref "${PROFILE_REF:-unknown}" --out ${OUT_PATH}/include/section-profile.h
+    if [ $? -ne 0 ]; then
+        echo "ERROR: Generating section assignments failed!"
+        exit 1
+    fi
+
+    CFG_LIB_CFLAGS+=" -DCONFIG_SECTION_PROFILE"
+    LIB_INCLUDES+=" ${OUT_PATH}/include"
+fi
+
 LIB_GEN_ARGS="--lib-name ${LIB_NAME} --lib-dir ${OUT_PATH} \
 --bsp-dir ${BSP_PATH} \
 --src-files ${LIB_SOURCES} \
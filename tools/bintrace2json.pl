@@ -0,0 +1,134 @@
+#!/usr/bin/perl
+#
+# Converts a binary trace file written by bintrace_writeFile() into the Chrome
+# trace event format (load it with chrome://tracing or Perfetto).
+#
+# The trace IDs are named after the eBinTraceId enumeration in
+# stack/include/oplk/bintrace.h. IDs ending with Begin and End are converted
+# to duration events, all other IDs to instant events. Every ring becomes a
+# thread of its own. The stack records error codes as numbers only, the
+# argument arg1 of IDs ending with Error is additionally converted to the name
+# of the tOplkError value (stack/include/oplk/errordefs.h in the same
+# directory as the header). All numbers in the trace file are little endian:
+#
+#   header      char[8] magic "OPLKBTRC", UINT32 version (1),
+#               UINT32 record size, UINT32 number of rings,
+#               UINT32 number of dropped trace points
+#   ring        UINT32 thread ID, UINT32 number of records,
+#               followed by the records in chronological order
+#   record      UINT64 timestamp in ns, UINT16 trace ID, UINT16 reserved,
+#               UINT32 arguments [4], UINT32 padding
+#
+# Usage: bintrace2json.pl <trace file> <JSON file> [<bintrace.h>]
+
+use File::Basename;
+
+$trace_file=$ARGV[0];
+$json_file=$ARGV[1];
+$header_file=$ARGV[2];
+
+die "Usage: $0 <trace file> <JSON file> [<bintrace.h>]\n" unless (defined $trace_file && defined $json_file);
+
+$header_file = dirname($0) . "/../stack/include/oplk/bintrace.h" unless (defined $header_file);
+
+# Read the trace ID names from the header
+%names = ();
+open(HEADER, '<', $header_file) or die "Unable to open file $header_file";
+while (<HEADER>)
+{
+    if (/^\s*kBinTraceId(\w+)\s*=\s*(0x[0-9A-Fa-f]+|\d+)/)
+    {
+        ($name, $value) = ($1, $2);
+        $value = oct($value) if ($value =~ /^0x/);
+        $names{$value} = $name;
+    }
+}
+close(HEADER);
+
+# Read the error code names
+%errors = ();
+if (open(ERRORDEFS, '<', dirname($header_file) . "/errordefs.h"))
+{
+    while (<ERRORDEFS>)
+    {
+        if (/^\s*kError(\w+)\s*=\s*(0x[0-9A-Fa-f]+|\d+)/)
+        {
+            ($name, $value) = ($1, $2);
+            $value = oct($value) if ($value =~ /^0x/);
+            $errors{$value} = $name;
+        }
+    }
+    close(ERRORDEFS);
+}
+
+open(TRACEDATA, '<:raw', $trace_file) or die "Unable to open file $trace_file";
+local $/;
+$trace = <TRACEDATA>;
+close(TRACEDATA) || die "Cannot close file!";
+
+die "Trace file $trace_file is too short\n" if (length($trace) < 24);
+
+($magic, $version, $record_size, $ring_count, $dropped) = unpack("a8VVVV", substr($trace, 0, 24));
+die "$trace_file is no binary trace file\n" if ($magic ne "OPLKBTRC");
+die "Unsupported trace file version $version\n" if ($version != 1);
+die "Unsupported record size $record_size\n" if ($record_size < 32);
+
+print "Warning: $dropped trace points were dropped, increase CONFIG_BINTRACE_RING_COUNT\n" if ($dropped != 0);
+
+$offset = 24;
+@events = ();
+$first_time = undef;
+
+for ($ring = 0; $ring < $ring_count; $ring++)
+{
+    die "Trace file $trace_file is truncated\n" if (length($trace) < $offset + 8);
+    ($thread_id, $record_count) = unpack("VV", substr($trace, $offset, 8));
+    $offset += 8;
+
+    for ($i = 0; $i < $record_count; $i++)
+    {
+        die "Trace file $trace_file is truncated\n" if (length($trace) < $offset + $record_size);
+        ($time, $id, $reserved, @args) = unpack("Q<vvVVVV", substr($trace, $offset, 32));
+        $offset += $record_size;
+
+        $first_time = $time if (!defined($first_time) || ($time < $first_time));
+        push(@events, [$time, $id, $thread_id, @args]);
+    }
+}
+
+open(JSON, '>', $json_file) or die "Unable to open file $json_file";
+print JSON "{\"traceEvents\":[\n";
+
+$separator = "";
+foreach $event (sort { $a->[0] <=> $b->[0] } @events)
+{
+    ($time, $id, $thread_id, @args) = @$event;
+
+    $name = exists($names{$id}) ? $names{$id} : sprintf("Id0x%04X", $id);
+    $phase = "i";
+    if ($name =~ /^(\w+)Begin$/)
+    {
+        $name = $1;
+        $phase = "B";
+    }
+    elsif ($name =~ /^(\w+)End$/)
+    {
+        $name = $1;
+        $phase = "E";
+    }
+
+    $error = "";
+    if (($name =~ /Error$/) && exists($errors{$args[1]}))
+    {
+        $error = ",\"error\":\"$errors{$args[1]}\"";
+    }
+
+    printf JSON "%s{\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":%u%s," .
+                "\"args\":{\"arg0\":%u,\"arg1\":%u,\"arg2\":%u,\"arg3\":%u%s}}",
+                $separator, $name, $phase, ($time - $first_time) / 1000.0, $thread_id,
+                ($phase eq "i") ? ",\"s\":\"t\"" : "", @args, $error;
+    $separator = ",\n";
+}
+
+print JSON "\n]}\n";
+close(JSON) || die "Cannot close file!";
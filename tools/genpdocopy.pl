@@ -0,0 +1,250 @@
+#!/usr/bin/perl
+#
+# Generates static PDO copy functions for the PDO mapping of an MN which is
+# configured by openCONFIGURATOR and uses the CiA 302-4 process image set up by
+# oplk_setupProcessImage().
+#
+# The script reads the mapping parameter objects (0x1600 - 0x16FF and
+# 0x1A00 - 0x1AFF) of the MN from the mnobd.txt file of an openCONFIGURATOR
+# project. The mapped process image objects (0xA000 - 0xA8C1) are translated
+# into offsets in the process image like in processimage-cia302.c. For every
+# mapping a straight-line copy function is generated. Contiguous byte objects
+# are copied by a single OPLK_MEMCPY(), larger numerical objects are converted
+# inline.
+#
+# The generated header contains the functions and the table aPdoStaticCopy_l[]
+# which is included by pdou.c if CONFIG_PDO_STATIC_COPY is TRUE. pdou.c uses a
+# generated function for a PDO channel if the hash of its runtime mapping
+# matches (see calcStaticCopyHash() in pdou.c), otherwise the channel is copied
+# by its copy program.
+#
+# Usage: genpdocopy.pl <mnobd.txt> <header file>
+
+use File::Basename;
+
+$mnobd_file=$ARGV[0];
+$header_file=$ARGV[1];
+
+die "Usage: $0 <mnobd.txt> <header file>\n" unless (defined $mnobd_file && defined $header_file);
+
+# CiA 302-4 process image objects: start index, end index, output image, type, size
+@pi_ranges = (
+    [0xA000, 0xA00F, 0, 0x0002, 1],
+    [0xA040, 0xA04F, 0, 0x0005, 1],
+    [0xA0C0, 0xA0C7, 0, 0x0003, 2],
+    [0xA100, 0xA107, 0, 0x0006, 2],
+    [0xA1C0, 0xA1C3, 0, 0x0004, 4],
+    [0xA200, 0xA203, 0, 0x0007, 4],
+    [0xA400, 0xA401, 0, 0x0015, 8],
+    [0xA440, 0xA441, 0, 0x001B, 8],
+    [0xA480, 0xA48F, 1, 0x0002, 1],
+    [0xA4C0, 0xA4CF, 1, 0x0005, 1],
+    [0xA540, 0xA547, 1, 0x0003, 2],
+    [0xA580, 0xA587, 1, 0x0006, 2],
+    [0xA640, 0xA643, 1, 0x0004, 4],
+    [0xA680, 0xA683, 1, 0x0007, 4],
+    [0xA880, 0xA881, 1, 0x0015, 8],
+    [0xA8C0, 0xA8C1, 1, 0x001B, 8]);
+$pi_subindex_count = 252;
+
+# Read the mapping parameters of the MN
+%count = ();
+%entries = ();
+open(MNOBD, '<', $mnobd_file) or die "Unable to open file $mnobd_file";
+while (<MNOBD>)
+{
+    last if (/^\/\/\/\/\s*Configuration Data for CN/);
+
+    if (/^\s*([0-9A-Fa-f]{4})\s+([0-9A-Fa-f]{2})\s+[0-9A-Fa-f]+\s+([0-9A-Fa-f]+)\s*$/)
+    {
+        ($index, $subindex, $value) = (hex($1), hex($2), $3);
+        next unless ((($index & 0xFF00) == 0x1600) || (($index & 0xFF00) == 0x1A00));
+
+        if ($subindex == 0)
+        {
+            $count{$index} = hex($value);
+        }
+        else
+        {
+            $entries{$index}{$subindex} = $value;
+        }
+    }
+}
+close(MNOBD);
+
+# FNV-1a hash over 32 bit little endian values, see calcStaticCopyHash()
+sub calcHash
+{
+    my $hash = 0x811C9DC5;
+
+    foreach my $value (@_)
+    {
+        for (my $shift = 0; $shift < 32; $shift += 8)
+        {
+            $hash ^= ($value >> $shift) & 0xFF;
+            $hash = ($hash * 0x01000193) % 4294967296;
+        }
+    }
+
+    return $hash;
+}
+
+# Get process image offset, type and size of a mapped object
+sub getPiObject
+{
+    my ($index, $subindex, $fTx) = @_;
+
+    foreach my $range (@pi_ranges)
+    {
+        my ($start, $end, $output, $type, $size) = @$range;
+        next unless (($index >= $start) && ($index <= $end));
+
+        die sprintf("Object 0x%04X is mapped in the wrong direction\n", $index) if ($output == $fTx);
+        die sprintf("Invalid subindex 0x%02X of object 0x%04X\n", $subindex, $index)
+            if (($subindex < 1) || ($subindex > $pi_subindex_count));
+
+        return (((($index - $start) * $pi_subindex_count) + $subindex - 1) * $size, $type, $size);
+    }
+
+    die sprintf("Object 0x%04X is no process image object\n", $index);
+}
+
+# Generate the statement which transfers a run of objects
+sub genRun
+{
+    my ($fTx, $piOffset, $pdoOffset, $size, $count) = @_;
+    my @lines = ();
+    my $i;
+    my $b;
+
+    if ($size == 1)
+    {
+        if ($count == 1)
+        {
+            push(@lines, $fTx ? "pPdo_p[$pdoOffset] = pPi_p[$piOffset];"
+                              : "pPi_p[$piOffset] = pPdo_p[$pdoOffset];");
+        }
+        else
+        {
+            push(@lines, $fTx ? "OPLK_MEMCPY(pPdo_p + $pdoOffset, pPi_p + $piOffset, $count);"
+                              : "OPLK_MEMCPY(pPi_p + $piOffset, pPdo_p + $pdoOffset, $count);");
+        }
+        return @lines;
+    }
+
+    $ctype = "UINT" . ($size * 8);
+    for ($i = 0; $i < $count; $i++, $piOffset += $size, $pdoOffset += $size)
+    {
+        if ($fTx)
+        {
+            push(@lines, "value$size = *(($ctype*)(pPi_p + $piOffset));");
+            for ($b = 0; $b < $size; $b++)
+            {
+                push(@lines, sprintf("pPdo_p[%d] = (BYTE)(value%d >> %d);", $pdoOffset + $b, $size, $b * 8));
+            }
+        }
+        else
+        {
+            @parts = ();
+            for ($b = 0; $b < $size; $b++)
+            {
+                push(@parts, sprintf("((%s)pPdo_p[%d] << %d)", $ctype, $pdoOffset + $b, $b * 8));
+            }
+            push(@lines, "*(($ctype*)(pPi_p + $piOffset)) = " . join(" |\n" . (" " x 8) . "    ", @parts) . ";");
+        }
+    }
+
+    return @lines;
+}
+
+open(OUT, '>', $header_file) or die "Unable to open file $header_file";
+print OUT "/* Generated by genpdocopy.pl from " . basename($mnobd_file) . ", do not edit! */\n\n";
+print OUT "#ifndef _INC_pdostaticcopy_H_\n#define _INC_pdostaticcopy_H_\n\n";
+
+@table = ();
+foreach $index (sort { $a <=> $b } keys %count)
+{
+    next if ($count{$index} == 0);
+
+    $fTx = (($index & 0xFF00) == 0x1A00) ? 1 : 0;
+    @hashValues = ($fTx, $count{$index}, 0);
+    @objects = ();
+
+    for ($subindex = 1; $subindex <= $count{$index}; $subindex++)
+    {
+        die sprintf("Mapping entry 0x%04X/0x%02X is missing\n", $index, $subindex)
+            unless (exists $entries{$index}{$subindex});
+
+        $value = $entries{$index}{$subindex};
+        $value = ("0" x (16 - length($value))) . $value;
+        $bitLength = hex(substr($value, 0, 4));
+        $bitOffset = hex(substr($value, 4, 4));
+        $objSubindex = hex(substr($value, 10, 2));
+        $objIndex = hex(substr($value, 12, 4));
+
+        ($piOffset, $type, $size) = getPiObject($objIndex, $objSubindex, $fTx);
+        die sprintf("Mapping entry 0x%04X/0x%02X is not byte aligned\n", $index, $subindex)
+            if (($bitOffset & 7) != 0);
+        die sprintf("Mapping entry 0x%04X/0x%02X has an invalid length\n", $index, $subindex)
+            if ($bitLength != $size * 8);
+
+        push(@hashValues, $piOffset, $bitOffset, $type);
+        push(@objects, [$piOffset, $bitOffset >> 3, $size]);
+    }
+
+    $name = sprintf("pdoStaticCopy%s_%04X", $fTx ? "Tx" : "Rx", $index);
+    $hash = calcHash(@hashValues);
+
+    # Merge contiguous objects of the same size into runs
+    @runs = ();
+    foreach $object (@objects)
+    {
+        ($piOffset, $pdoOffset, $size) = @$object;
+        if (@runs)
+        {
+            $run = $runs[-1];
+            if (($run->[2] == $size) &&
+                ($run->[0] + $run->[2] * $run->[3] == $piOffset) &&
+                ($run->[1] + $run->[2] * $run->[3] == $pdoOffset))
+            {
+                $run->[3]++;
+                next;
+            }
+        }
+        push(@runs, [$piOffset, $pdoOffset, $size, 1]);
+    }
+
+    @lines = ();
+    %values = ();
+    foreach $run (@runs)
+    {
+        push(@lines, genRun($fTx, @$run));
+        $values{$run->[2]} = 1 if ($fTx && ($run->[2] > 1));
+    }
+
+    printf OUT "// Mapping 0x%04X: %d objects, hash 0x%08X\n", $index, $count{$index}, $hash;
+    print OUT "static void $name(BYTE* pPdo_p, BYTE* pPi_p)\n{\n";
+    foreach $size (sort { $a <=> $b } keys %values)
+    {
+        printf OUT "    UINT%d              value%d;\n", $size * 8, $size;
+    }
+    print OUT "\n" if (%values);
+    print OUT "    $_\n" foreach (@lines);
+    print OUT "}\n\n";
+
+    push(@table, sprintf("    { 0x%08XUL, %s, %s },", $hash, $fTx ? "TRUE" : "FALSE", $name));
+}
+
+print OUT "static const tPdoStaticCopy aPdoStaticCopy_l[] =\n{\n";
+if (@table)
+{
+    print OUT "$_\n" foreach (@table);
+}
+else
+{
+    print OUT "    { 0, FALSE, NULL },\n";
+}
+print OUT "};\n\n#endif /* _INC_pdostaticcopy_H_ */\n";
+close(OUT) || die "Cannot close file!";
+
+printf "%d copy functions generated\n", scalar(@table);
@@ -0,0 +1,171 @@
+#!/usr/bin/perl
+#
+# Generates the typed C++ process image accessors for an MN which is configured
+# by openCONFIGURATOR and uses the process image set up by
+# oplk_setupProcessImage().
+#
+# The script reads the xap.xml file of an openCONFIGURATOR project. For every
+# channel of the input and the output image an accessor type of
+# oplk/piaccess.h is generated, whose offset is a template argument. Consecutive
+# channels of the same object and data type are additionally combined into an
+# array. A static_assert checks every accessor against the size of its image.
+#
+# The generated header declares the namespace <namespace>::in for the input
+# image (PI_IN of xap.h, written by the application) and <namespace>::out for
+# the output image (PI_OUT of xap.h, read by the application). The function
+# <namespace>::allocProcessImage() allocates the images with the sizes the
+# accessors were generated for.
+#
+# Usage: genpiaccess.pl <xap.xml> <header file> [namespace]
+
+use File::Basename;
+
+$xap_file=$ARGV[0];
+$header_file=$ARGV[1];
+$namespace=defined $ARGV[2] ? $ARGV[2] : "xap";
+
+die "Usage: $0 <xap.xml> <header file> [namespace]\n" unless (defined $xap_file && defined $header_file);
+
+# openCONFIGURATOR data types: C type, size in bytes
+%types = (
+    "Integer8"   => ["INT8", 1],
+    "Integer16"  => ["INT16", 2],
+    "Integer32"  => ["INT32", 4],
+    "Integer64"  => ["INT64", 8],
+    "Unsigned8"  => ["UINT8", 1],
+    "Unsigned16" => ["UINT16", 2],
+    "Unsigned32" => ["UINT32", 4],
+    "Unsigned64" => ["UINT64", 8],
+    "Real32"     => ["float", 4],
+    "Real64"     => ["double", 8]);
+
+# Read the channels of both process images
+%size = ();
+%channels = ("input" => [], "output" => []);
+$image = undef;
+open(XAP, '<', $xap_file) or die "Unable to open file $xap_file";
+while (<XAP>)
+{
+    if (/<ProcessImage\s+type="(input|output)"\s+size="(\d+)"/)
+    {
+        $image = $1;
+        $size{$image} = $2;
+    }
+    elsif (/<\/ProcessImage>/)
+    {
+        $image = undef;
+    }
+    elsif (/<Channel\s+Name="([^"]+)"\s+dataType="([^"]+)"\s+dataSize="(\d+)"\s+PIOffset="(0x[0-9A-Fa-f]+)"(?:\s+BitOffset="(0x[0-9A-Fa-f]+)")?/)
+    {
+        die "Channel $1 is outside of a process image\n" unless (defined $image);
+        push(@{$channels{$image}}, [$1, $2, $3, hex($4), defined $5 ? hex($5) : 0]);
+    }
+}
+close(XAP);
+
+# Translate a channel name into a C++ identifier
+sub getIdentifier
+{
+    my ($name) = @_;
+
+    $name =~ s/[^A-Za-z0-9_]/_/g;
+    $name = "_" . $name if ($name =~ /^[0-9]/);
+
+    return $name;
+}
+
+# Generate the accessors of one image
+sub genImage
+{
+    my ($image, $ns, $sizeName) = @_;
+    my @lines = ();
+    my @checks = ();
+    my @arrays = ();
+    my %names = ();
+
+    foreach my $channel (@{$channels{$image}})
+    {
+        my ($name, $dataType, $dataSize, $piOffset, $bitOffset) = @$channel;
+        my $id = getIdentifier($name);
+        my $prefix = ($name =~ /^(.*)\.[^.]*$/) ? $1 : $name;
+
+        die "Channel name $id is used twice\n" if (exists $names{$id});
+        $names{$id} = 1;
+
+        if ($dataType eq "Boolean")
+        {
+            die "Channel $name has an invalid size\n" if ($dataSize != 1);
+            die "Channel $name has an invalid bit offset\n" if ($bitOffset > 7);
+            push(@lines, sprintf("typedef oplk::pi::Bit<0x%04X, %d> %s;", $piOffset, $bitOffset, $id));
+            push(@checks, [$id, "1"]);
+            next;
+        }
+
+        die "Channel $name has the unknown data type $dataType\n" unless (exists $types{$dataType});
+        my ($ctype, $size) = @{$types{$dataType}};
+        die "Channel $name has an invalid size\n" if ($dataSize != $size * 8);
+        die "Channel $name is not byte aligned\n" if ($bitOffset != 0);
+
+        push(@lines, sprintf("typedef oplk::pi::Var<%s, 0x%04X> %s;", $ctype, $piOffset, $id));
+        push(@checks, [$id, "$id\::size"]);
+
+        # Combine consecutive channels of the same object
+        if (@arrays)
+        {
+            my $array = $arrays[-1];
+            if (($array->[0] eq $prefix) && ($array->[1] eq $ctype) &&
+                ($array->[2] + ($array->[3] * $size) == $piOffset))
+            {
+                $array->[3]++;
+                next;
+            }
+        }
+        push(@arrays, [$prefix, $ctype, $piOffset, 1]);
+    }
+
+    foreach my $array (@arrays)
+    {
+        my ($prefix, $ctype, $piOffset, $count) = @$array;
+        my $id = getIdentifier($prefix);
+
+        next if ($count < 2);
+        die "Array name $id is already used by a channel\n" if (exists $names{$id});
+        $names{$id} = 1;
+        push(@lines, sprintf("typedef oplk::pi::Array<%s, 0x%04X, %d> %s;", $ctype, $piOffset, $count, $id));
+        push(@checks, [$id, "$id\::size"]);
+    }
+
+    print OUT "namespace $ns\n{\n\n";
+    print OUT "$_\n" foreach (@lines);
+    print OUT "\n" if (@lines);
+    foreach my $check (@checks)
+    {
+        print OUT "static_assert(oplk::pi::fitsImage($check->[0]::offset, $check->[1], $sizeName),\n";
+        print OUT "              \"$check->[0] exceeds the process image\");\n";
+    }
+    print OUT "\n" if (@checks);
+    print OUT "} // namespace $ns\n\n";
+}
+
+die "The input process image is missing\n" unless (exists $size{"input"});
+die "The output process image is missing\n" unless (exists $size{"output"});
+
+$guard = "_INC_" . getIdentifier(basename($header_file, ".h", ".hpp")) . "_H_";
+
+open(OUT, '>', $header_file) or die "Unable to open file $header_file";
+print OUT "/* Generated by genpiaccess.pl from " . basename($xap_file) . ", do not edit! */\n\n";
+print OUT "#ifndef $guard\n#define $guard\n\n";
+print OUT "#include <oplk/piaccess.h>\n\n";
+print OUT "namespace $namespace\n{\n\n";
+printf OUT "static const UINT piInSize = %d;\n", $size{"input"};
+printf OUT "static const UINT piOutSize = %d;\n\n", $size{"output"};
+
+genImage("input", "in", "piInSize");
+genImage("output", "out", "piOutSize");
+
+print OUT "inline tOplkError allocProcessImage(void)\n{\n";
+print OUT "    return oplk_allocProcessImage(piInSize, piOutSize);\n}\n\n";
+print OUT "} // namespace $namespace\n\n#endif /* $guard */\n";
+close(OUT) || die "Cannot close file!";
+
+printf "%d input and %d output channels generated\n", scalar(@{$channels{"input"}}), scalar(@{$channels{"output"}});
@@ -0,0 +1,191 @@
+#!/usr/bin/perl
+#
+# Generates the tightly-coupled memory section assignments for a Nios II or
+# MicroBlaze build from the profile of a reference run.
+#
+# The functions which can be placed in the tightly-coupled memory are found by
+# scanning the sources for prototypes tagged with a SECTION_xxx macro. The
+# macros are ranked by execution time per byte of code, the code sizes are
+# read from the ELF file of the profiled build. Macros of the PCP hot paths in
+# dllk, pdok and edrv-openmac are assigned first, ordered by execution time.
+# The remaining budget is filled with the other macros.
+#
+# The profile is either a gprof flat profile (e.g. nios2-elf-gprof -b -p or
+# mb-gprof -b -p) or a text file with one "<function> <cycles>" pair per line,
+# e.g. taken with a cycle counter or performance counter.
+#
+# The generated header is used instead of the static assignments in
+# section-nios2.h or section-microblaze.h if the build defines
+# CONFIG_SECTION_PROFILE and the header is found in the include path.
+#
+# Usage: gensections.pl --profile <file> --elf <file> --budget <bytes>
+#                       --out <header> [--arch nios2|microblaze]
+#                       [--nm <nm tool>] [--reserve <bytes>] [--ref <text>]
+#                       [--src <dir>]...
+#
+#   --profile   Profile of the reference run
+#   --elf       ELF file of the profiled build
+#   --budget    Size of the tightly-coupled memory in bytes
+#   --out       Generated header file (section-profile.h)
+#   --arch      Target architecture (default: nios2)
+#   --nm        nm tool used to read the function sizes
+#               (default: nios2-elf-nm or mb-nm)
+#   --reserve   Bytes of the budget used by other code (e.g. exception vector)
+#   --ref       Description of the reference run, e.g. "mapping 1490 byte, 10 CNs"
+#   --src       Source directory to scan (default: stack/src, stack/include and
+#               hardware/drivers)
+
+use File::Basename;
+use File::Find;
+use Getopt::Long;
+
+$arch = "nios2";
+$reserve = 0;
+$ref = "unknown";
+@srcdirs = ();
+
+GetOptions("profile=s"  => \$profile_file,
+           "elf=s"      => \$elf_file,
+           "budget=i"   => \$budget,
+           "out=s"      => \$out_file,
+           "arch=s"     => \$arch,
+           "nm=s"       => \$nm,
+           "reserve=i"  => \$reserve,
+           "ref=s"      => \$ref,
+           "src=s"      => \@srcdirs)
+    or die "Invalid arguments!\n";
+
+die "Usage: $0 --profile <file> --elf <file> --budget <bytes> --out <header> [options]\n"
+    unless (defined $profile_file && defined $elf_file && defined $budget && defined $out_file);
+
+if ($arch eq "nios2")
+{
+    $attribute = "ALT_INTERNAL_RAM";
+    $nm = "nios2-elf-nm" unless (defined $nm);
+}
+elsif ($arch eq "microblaze")
+{
+    $attribute = "XIL_INTERNAL_RAM";
+    $nm = "mb-nm" unless (defined $nm);
+}
+else
+{
+    die "Unsupported architecture $arch\n";
+}
+
+if (!@srcdirs)
+{
+    $basedir = dirname($0) . "/..";
+    @srcdirs = ("$basedir/stack/src", "$basedir/stack/include", "$basedir/hardware/drivers");
+}
+
+# Find the section macros of all functions
+%macro_funcs = ();
+%macro_hot = ();
+find(sub
+     {
+         return unless (/\.[ch]$/);
+         return if (/^section-/);
+         $file = $_;
+         open(SRC, '<', $file) or die "Unable to open file $File::Find::name";
+         local $/;
+         $src = <SRC>;
+         close(SRC);
+
+         $src =~ s{/\*.*?\*/}{}gs;
+         $src =~ s{//[^\n]*}{}g;
+         while ($src =~ /(\w+)\s*\([^;{}()]*(?:\([^;{}()]*\)[^;{}()]*)*\)\s*(SECTION_\w+)\s*;/g)
+         {
+             ($func, $macro) = ($1, $2);
+             $macro_funcs{$macro}{$func} = 1;
+             $macro_hot{$macro} = 1 if ($file =~ /^(dllk|pdok|edrv-openmac)/);
+         }
+     }, @srcdirs);
+
+die "No section macros found in @srcdirs\n" unless (%macro_funcs);
+
+# Read the execution time of the functions
+%func_time = ();
+open(PROFILE, '<', $profile_file) or die "Unable to open file $profile_file";
+while (<PROFILE>)
+{
+    if (/^\s*[\d.]+\s+[\d.]+\s+([\d.]+)\s+(?:\d+\s+[\d.]+\s+[\d.]+\s+)?(\w+)\s*$/)
+    {   # gprof flat profile: % time, cumulative, self seconds [, calls, self/call, total/call], name
+        $func_time{$2} += $1;
+    }
+    elsif (/^\s*(\w+)\s+(\d+)\s*$/)
+    {   # cycle counter: function, cycles
+        $func_time{$1} += $2;
+    }
+}
+close(PROFILE);
+
+die "No functions found in profile $profile_file\n" unless (%func_time);
+
+# Read the code size of the functions
+%func_size = ();
+open(NM, "$nm -S $elf_file |") or die "Unable to run $nm";
+while (<NM>)
+{
+    if (/^[0-9A-Fa-f]+\s+([0-9A-Fa-f]+)\s+[tTwW]\s+(\w+)\s*$/)
+    {
+        $func_size{$2} = hex($1);
+    }
+}
+close(NM) or die "$nm failed on $elf_file\n";
+
+# Sum up time and size per macro
+%macro_time = ();
+%macro_size = ();
+foreach $macro (keys %macro_funcs)
+{
+    foreach $func (keys %{$macro_funcs{$macro}})
+    {
+        next unless (exists $func_size{$func});
+        $macro_time{$macro} += $func_time{$func} if (exists $func_time{$func});
+        $macro_size{$macro} += ($func_size{$func} + 3) & ~3;
+    }
+}
+
+$total_time = 0;
+$total_time += $_ foreach (values %func_time);
+
+# Rank: hot paths by time first, then the rest by time per byte
+@hot = sort { $macro_time{$b} <=> $macro_time{$a} or $a cmp $b }
+       grep { $macro_hot{$_} && $macro_time{$_} > 0 } keys %macro_size;
+@other = sort { ($macro_time{$b} / $macro_size{$b}) <=> ($macro_time{$a} / $macro_size{$a}) or $a cmp $b }
+         grep { !$macro_hot{$_} && $macro_time{$_} > 0 && $macro_size{$_} > 0 } keys %macro_size;
+
+$free = $budget - $reserve;
+@assigned = ();
+foreach $macro (@hot, @other)
+{
+    if ($macro_size{$macro} <= $free)
+    {
+        push(@assigned, $macro);
+        $free -= $macro_size{$macro};
+    }
+    elsif ($macro_hot{$macro})
+    {
+        print "Warning: hot path $macro ($macro_size{$macro} byte) does not fit into the budget\n";
+    }
+}
+
+# Write the header
+open(OUT, '>', $out_file) or die "Unable to open file $out_file";
+print OUT "/* Generated by gensections.pl, do not edit! */\n";
+print OUT "/* Reference run: $ref */\n";
+printf OUT "/* Budget: %d byte, reserved: %d byte, used: %d byte */\n",
+           $budget, $reserve, $budget - $reserve - $free;
+print OUT "\n#ifndef _INC_section_profile_H_\n#define _INC_section_profile_H_\n\n";
+foreach $macro (@assigned)
+{
+    printf OUT "#define %-35s %s    /* %5.1f %%, %5d byte */\n", $macro, $attribute,
+               ($total_time > 0) ? 100.0 * $macro_time{$macro} / $total_time : 0,
+               $macro_size{$macro};
+}
+print OUT "\n#endif /* _INC_section_profile_H_ */\n";
+close(OUT) || die "Cannot close file!";
+
+printf "%d of %d section macros assigned, %d of %d byte used\n",
+       scalar(@assigned), scalar(@hot) + scalar(@other), $budget - $reserve - $free, $budget - $reserve;
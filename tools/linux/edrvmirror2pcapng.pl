@@ -0,0 +1,134 @@
+#!/usr/bin/perl
+#
+# Drains the mirror ring of the openPOWERLINK Ethernet driver into a pcapng
+# file. The stack must be compiled with CONFIG_EDRV_MIRROR, the ring is then
+# created by the Linux user space Ethernet drivers in /dev/shm/shmEdrvMirror
+# (see stack/include/kernel/edrvmirror.h for its layout).
+#
+# The ring is lossy, frames which are overwritten before they are read are
+# counted and reported at the end. Writing to "-" streams the capture to
+# stdout, so it can be watched live in Wireshark:
+#
+#   edrvmirror2pcapng.pl - | wireshark -k -i -
+#
+# Usage: edrvmirror2pcapng.pl [-a] <pcapng file | ->
+#   -a  start with the frames which are already kept in the ring instead
+#       of the next frame
+
+use strict;
+use warnings;
+
+my $shm_file = "/dev/shm/shmEdrvMirror";
+my $header_size = 32;
+my $slot_header_size = 24;
+my $flag_tx = 0x00000001;
+
+my $fall = 0;
+if (defined $ARGV[0] && $ARGV[0] eq "-a")
+{
+    $fall = 1;
+    shift(@ARGV);
+}
+my $pcap_file = $ARGV[0];
+
+die "Usage: $0 [-a] <pcapng file | ->\n" unless (defined $pcap_file);
+
+my $fstop = 0;
+$SIG{INT} = sub { $fstop = 1; };
+$SIG{TERM} = sub { $fstop = 1; };
+
+open(RING, '<:raw', $shm_file) or die "Unable to open $shm_file, is the stack running with CONFIG_EDRV_MIRROR?\n";
+
+my ($magic, $version, $slot_count, $slot_size, $write_count) = read_header();
+die "$shm_file is no valid mirror ring\n" if ($magic ne "OPLKMIRR");
+die "Unsupported mirror ring version $version\n" if ($version != 1);
+
+my $pcap;
+if ($pcap_file eq "-")
+{
+    $pcap = \*STDOUT;
+    binmode($pcap);
+}
+else
+{
+    open($pcap, '>:raw', $pcap_file) or die "Unable to open file $pcap_file";
+}
+select((select($pcap), $| = 1)[0]);
+
+# Section header block
+print $pcap pack("VVVvvVVV", 0x0A0D0D0A, 28, 0x1A2B3C4D, 1, 0, 0xFFFFFFFF, 0xFFFFFFFF, 28);
+# Interface description block: Ethernet, timestamps in ns (if_tsresol = 9)
+print $pcap pack("VVvvV" . "vvCx3" . "vv" . "V", 1, 32, 1, 0, $slot_size - $slot_header_size,
+                 9, 1, 9, 0, 0, 32);
+
+my $read_count = $write_count;
+if ($fall)
+{
+    $read_count = ($write_count > $slot_count) ? $write_count - $slot_count : 0;
+}
+
+my $lost = 0;
+my $frames = 0;
+
+while (!$fstop)
+{
+    last if (! -e $shm_file);                                 # stack was shut down
+    ($magic, $version, $slot_count, $slot_size, $write_count) = read_header();
+    last if (!defined($magic) || ($magic ne "OPLKMIRR"));
+
+    if ($write_count - $read_count > $slot_count)
+    {   # reader was too slow
+        $lost += $write_count - $read_count - $slot_count;
+        $read_count = $write_count - $slot_count;
+    }
+
+    while ($read_count < $write_count)
+    {
+        my $offset = $header_size + ($read_count % $slot_count) * $slot_size;
+        my $slot;
+
+        sysseek(RING, $offset, 0);
+        sysread(RING, $slot, $slot_size);
+        my ($sequence, $frame_size, $captured_size, $flags, $time) =
+            unpack("VVVVQ<", substr($slot, 0, $slot_header_size));
+        my $data = substr($slot, $slot_header_size, $captured_size);
+
+        # the slot must still contain the same frame after it was copied
+        my $check;
+        sysseek(RING, $offset, 0);
+        sysread(RING, $check, 4);
+        if (($sequence != (($read_count + 1) & 0xFFFFFFFF)) || (unpack("V", $check) != $sequence))
+        {
+            $lost++;
+            $read_count++;
+            next;
+        }
+
+        my $padding = (4 - ($captured_size % 4)) % 4;
+        my $block_size = 28 + $captured_size + $padding + 12 + 4;
+        print $pcap pack("VVVVVVV", 6, $block_size, 0, int($time / 4294967296), $time % 4294967296,
+                         $captured_size, $frame_size);
+        print $pcap $data . ("\0" x $padding);
+        # epb_flags: direction inbound (1) or outbound (2)
+        print $pcap pack("vvV" . "vv" . "V", 2, 4, ($flags & $flag_tx) ? 2 : 1, 0, 0, $block_size);
+
+        $frames++;
+        $read_count++;
+    }
+
+    select(undef, undef, undef, 0.01);
+}
+
+close($pcap) if ($pcap_file ne "-");
+close(RING);
+
+print STDERR "$frames frames written, $lost frames lost\n";
+
+sub read_header
+{
+    my $header;
+
+    sysseek(RING, 0, 0);
+    return () if (sysread(RING, $header, $header_size) != $header_size);
+    return unpack("a8VVVxxxxQ<", $header);
+}
@@ -0,0 +1,101 @@
+#!/usr/bin/perl
+#
+# Dumps cycles of a process image record file written by the process image
+# recorder (apps/common/src/pirecorder/pirecorder-linux.c).
+#
+# The chunk which contains the first cycle is looked up in the index file
+# (<record file>.idx), so only the chunks of the requested cycles are read.
+# Every recorded cycle is printed as hex dump of the input and the output
+# process image, missing cycles are reported as such.
+#
+# Usage: pirecdump.pl <record file> <first cycle> [<cycle count>]
+
+$record_file=$ARGV[0];
+$first_cycle=$ARGV[1];
+$cycle_count=defined $ARGV[2] ? $ARGV[2] : 1;
+
+die "Usage: $0 <record file> <first cycle> [<cycle count>]\n" unless (defined $record_file && defined $first_cycle);
+
+open(REC, '<', $record_file) or die "Unable to open file $record_file";
+open(IDX, '<', "$record_file.idx") or die "Unable to open file $record_file.idx";
+binmode(REC);
+binmode(IDX);
+
+read(REC, $header, 24) == 24 or die "Invalid record file\n";
+($magic, $version, $in_size, $out_size, $chunk_cycles) = unpack("a8 V V V V", $header);
+die "Invalid record file\n" unless (($magic eq "OPLKPIR\0") && ($version == 1));
+
+# Print a process image as hex dump
+sub dumpImage
+{
+    my ($name, $image) = @_;
+
+    for (my $offset = 0; $offset < length($image); $offset += 16)
+    {
+        printf("  %-3s %06X: %s\n", $name, $offset,
+               join(" ", map { sprintf("%02X", $_) } unpack("C*", substr($image, $offset, 16))));
+    }
+}
+
+$cycle = $first_cycle;
+$end_cycle = $first_cycle + $cycle_count;
+while ($cycle < $end_cycle)
+{
+    $chunk = int($cycle / $chunk_cycles);
+    seek(IDX, $chunk * 8, 0) or die "Seek error\n";
+    last unless (read(IDX, $entry, 8) == 8);
+    ($offset_lo, $offset_hi) = unpack("V V", $entry);
+
+    seek(REC, $offset_hi * 4294967296 + $offset_lo, 0) or die "Seek error\n";
+    read(REC, $chunk_header, 24) == 24 or die "Truncated chunk $chunk\n";
+    ($magic, $count, $data_size) = unpack("V V V", $chunk_header);
+    die "Invalid chunk $chunk\n" unless ($magic == 0x4B434950);
+    read(REC, $data, $data_size) == $data_size or die "Truncated chunk $chunk\n";
+
+    # Decode the chunk up to the last requested cycle
+    $image = "\0" x ($in_size + $out_size);
+    $pos = 0;
+    for ($i = 0; ($i < $count) && ($chunk * $chunk_cycles + $i < $end_cycle); $i++)
+    {
+        $this_cycle = $chunk * $chunk_cycles + $i;
+        $flag = unpack("C", substr($data, $pos++, 1));
+        if ($flag == 0)
+        {
+            print "Cycle $this_cycle: missing\n" if ($this_cycle >= $cycle);
+            next;
+        }
+
+        $size = unpack("V", substr($data, $pos, 4));
+        $end = $pos + 4 + $size;
+        $pos += 4;
+        $image_pos = 0;
+        while ($pos < $end)
+        {
+            $token = unpack("C", substr($data, $pos++, 1));
+            if ($token < 0x80)
+            {
+                $image_pos += $token + 1;
+            }
+            else
+            {
+                $length = ($token & 0x7F) + 1;
+                substr($image, $image_pos, $length) ^= substr($data, $pos, $length);
+                $image_pos += $length;
+                $pos += $length;
+            }
+        }
+
+        if ($this_cycle >= $cycle)
+        {
+            print "Cycle $this_cycle:\n";
+            dumpImage("in", substr($image, 0, $in_size));
+            dumpImage("out", substr($image, $in_size, $out_size));
+        }
+    }
+
+    last if ($count < $chunk_cycles);
+    $cycle = ($chunk + 1) * $chunk_cycles;
+}
+
+close(IDX);
+close(REC);
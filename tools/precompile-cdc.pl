@@ -0,0 +1,165 @@
+#!/usr/bin/perl
+#
+# Converts a concise device configuration (CDC) file into a precompiled CDC.
+#
+# A precompiled CDC contains an index of the ConciseDCFs of all CNs (object
+# 0x1F22), so the stack can link them in place instead of parsing and
+# copying them. All numbers are little endian:
+#
+#   header      UINT32 magic "PCDC", UINT32 version (1 or 2),
+#               UINT32 offset and UINT32 size of local CDC section,
+#               UINT32 number of node index entries
+#   index       per CN: UINT32 node ID, UINT32 offset and UINT32 size of the
+#               ConciseDCF, UINT32 number of objects in the ConciseDCF,
+#               version 2 only: UINT32 offset and UINT32 size of the shared
+#               ConciseDCF (size 0 = no shared ConciseDCF)
+#   local CDC   plain CDC with all entries except the ConciseDCFs
+#   DCFs        ConciseDCFs of the CNs and shared ConciseDCFs
+#
+# With option -s, version 2 is written: CNs whose ConciseDCFs contain the same
+# objects in the same order share one ConciseDCF. The ConciseDCF of such a CN
+# only contains the objects with a node specific value, which replace the
+# objects of the shared ConciseDCF during the download (see cfmu.c).
+#
+# Usage: precompile-cdc.pl [-s] <CDC file> <precompiled CDC file>
+
+$fShared = 0;
+if ((defined $ARGV[0]) && ($ARGV[0] eq "-s"))
+{
+    $fShared = 1;
+    shift(@ARGV);
+}
+
+$cdc_file=$ARGV[0];
+$pcdc_file=$ARGV[1];
+
+die "Usage: $0 [-s] <CDC file> <precompiled CDC file>\n" unless (defined $cdc_file && defined $pcdc_file);
+
+open(CDCDATA, '<:raw', $cdc_file) or die "Unable to open file $cdc_file";
+local $/;
+$cdc = <CDCDATA>;
+close(CDCDATA) || die "Cannot close file!";
+
+die "CDC file $cdc_file is too short\n" if (length($cdc) < 4);
+
+$entries = unpack("V", substr($cdc, 0, 4));
+$offset = 4;
+$local_count = 0;
+$local_data = "";
+%dcf = ();
+
+for ($i = 0; $i < $entries; $i++)
+{
+    die "CDC file $cdc_file is truncated\n" if (length($cdc) < $offset + 7);
+    ($index, $subindex, $size) = unpack("vCV", substr($cdc, $offset, 7));
+    die "CDC file $cdc_file is truncated\n" if (length($cdc) < $offset + 7 + $size);
+
+    if (($index == 0x1F22) && ($size >= 4))
+    {
+        $dcf{$subindex} = substr($cdc, $offset + 7, $size);
+    }
+    else
+    {
+        $local_data .= substr($cdc, $offset, 7 + $size);
+        $local_count++;
+    }
+    $offset += 7 + $size;
+}
+
+@node_ids = sort { $a <=> $b } keys %dcf;
+
+# Split a ConciseDCF into its entries, returns undef if it is malformed
+sub splitDcf
+{
+    my ($data) = @_;
+    my @objects = ();
+    my $pos = 4;
+    my $count = unpack("V", substr($data, 0, 4));
+
+    for (my $i = 0; $i < $count; $i++)
+    {
+        return undef if (length($data) < $pos + 7);
+        my ($index, $subindex, $size) = unpack("vCV", substr($data, $pos, 7));
+        return undef if (($size == 0) || (length($data) < $pos + 7 + $size));
+        push(@objects, [sprintf("%04X/%02X", $index, $subindex), substr($data, $pos, 7 + $size)]);
+        $pos += 7 + $size;
+    }
+
+    return \@objects;
+}
+
+# Group CNs with the same objects in their ConciseDCFs
+%base_of = ();
+%group_nodes = ();
+if ($fShared)
+{
+    foreach $node_id (@node_ids)
+    {
+        $objects = splitDcf($dcf{$node_id});
+        next unless (defined $objects && @$objects);
+        $key = join(",", map { $_->[0] } @$objects);
+        push(@{$group_nodes{$key}}, [$node_id, $objects]);
+    }
+}
+
+%base_dcf = ();
+%node_dcf = %dcf;
+foreach $key (keys %group_nodes)
+{
+    @nodes = @{$group_nodes{$key}};
+    next if (scalar(@nodes) < 2);
+
+    # the ConciseDCF of the first CN of the group is shared
+    $base = $nodes[0][1];
+    $base_dcf{$key} = $dcf{$nodes[0][0]};
+    foreach $node (@nodes)
+    {
+        ($node_id, $objects) = @$node;
+        @delta = ();
+        for ($i = 0; $i < scalar(@$objects); $i++)
+        {
+            push(@delta, $objects->[$i][1]) if ($objects->[$i][1] ne $base->[$i][1]);
+        }
+        $node_dcf{$node_id} = pack("V", scalar(@delta)) . join("", @delta);
+        $base_of{$node_id} = $key;
+    }
+}
+
+$version = $fShared ? 2 : 1;
+$local_offset = 20 + (($fShared ? 24 : 16) * scalar(@node_ids));
+$local_section = ($local_count > 0) ? pack("V", $local_count) . $local_data : "";
+$data_offset = $local_offset + length($local_section);
+
+$dcf_data = "";
+%base_offset = ();
+foreach $key (sort keys %base_dcf)
+{
+    $base_offset{$key} = $data_offset + length($dcf_data);
+    $dcf_data .= $base_dcf{$key};
+}
+
+$index_data = "";
+foreach $node_id (@node_ids)
+{
+    $index_data .= pack("VVVV", $node_id, $data_offset + length($dcf_data),
+                        length($node_dcf{$node_id}), unpack("V", substr($node_dcf{$node_id}, 0, 4)));
+    if ($fShared)
+    {
+        $key = $base_of{$node_id};
+        $index_data .= (defined $key) ? pack("VV", $base_offset{$key}, length($base_dcf{$key}))
+                                      : pack("VV", 0, 0);
+    }
+    $dcf_data .= $node_dcf{$node_id};
+}
+
+open(PCDCDATA, '>:raw', $pcdc_file) or die "Unable to open file $pcdc_file";
+print PCDCDATA pack("a4VVVV", "PCDC", $version, $local_offset, length($local_section), scalar(@node_ids));
+print PCDCDATA $index_data;
+print PCDCDATA $local_section;
+print PCDCDATA $dcf_data;
+close(PCDCDATA) || die "Cannot close file!";
+
+printf "Done writing precompiled CDC with %d local objects and %d CN configurations (%d shared)...\n",
+       $local_count, scalar(@node_ids), scalar(keys %base_dcf);
+
+exit;
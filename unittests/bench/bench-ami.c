@@ -0,0 +1,243 @@
+/**
+********************************************************************************
+\file   bench-ami.c
+
+\brief  Benchmarks of the AMI module
+
+The file contains the benchmarks of the abstract memory interface (AMI) which
+converts the values of POWERLINK frames and PDOs between the host and the
+network byte order. The scalar functions are measured per value, the bulk
+functions per array of BENCH_AMI_ARRAY_SIZE values.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <common/ami.h>
+
+#include "bench.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define BENCH_AMI_ARRAY_SIZE        256
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void benchSetUint32Le(void* pArg_p, UINT32 iterations_p);
+static void benchGetUint32Be(void* pArg_p, UINT32 iterations_p);
+static void benchGetUint48Be(void* pArg_p, UINT32 iterations_p);
+static void benchSetUint16ArrayLe(void* pArg_p, UINT32 iterations_p);
+static void benchGetUint32ArrayBe(void* pArg_p, UINT32 iterations_p);
+static void benchGetUint64ArrayLe(void* pArg_p, UINT32 iterations_p);
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static UINT8            aFrame_l[BENCH_AMI_ARRAY_SIZE * sizeof(UINT64)];
+static UINT64           aValues_l[BENCH_AMI_ARRAY_SIZE];
+static volatile UINT64  sink_l;
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Run AMI benchmarks
+*/
+//------------------------------------------------------------------------------
+void benchami_run(void)
+{
+    UINT    i;
+
+    for (i = 0; i < sizeof(aFrame_l); i++)
+        aFrame_l[i] = (UINT8)i;
+
+    bench_measure("ami.setUint32Le", benchSetUint32Le, NULL);
+    bench_measure("ami.getUint32Be", benchGetUint32Be, NULL);
+    bench_measure("ami.getUint48Be", benchGetUint48Be, NULL);
+    bench_measure("ami.setUint16ArrayLe.256", benchSetUint16ArrayLe, NULL);
+    bench_measure("ami.getUint32ArrayBe.256", benchGetUint32ArrayBe, NULL);
+    bench_measure("ami.getUint64ArrayLe.256", benchGetUint64ArrayLe, NULL);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure ami_setUint32Le() on consecutive frame offsets
+
+\param  pArg_p              Not used.
+\param  iterations_p        Number of conversions to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchSetUint32Le(void* pArg_p, UINT32 iterations_p)
+{
+    UINT32  i;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (i = 0; i < iterations_p; i++)
+        ami_setUint32Le(&aFrame_l[(i % BENCH_AMI_ARRAY_SIZE) * sizeof(UINT32)], i);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure ami_getUint32Be() on consecutive frame offsets
+
+\param  pArg_p              Not used.
+\param  iterations_p        Number of conversions to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchGetUint32Be(void* pArg_p, UINT32 iterations_p)
+{
+    UINT32  i;
+    UINT32  sum = 0;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (i = 0; i < iterations_p; i++)
+        sum += ami_getUint32Be(&aFrame_l[(i % BENCH_AMI_ARRAY_SIZE) * sizeof(UINT32)]);
+
+    sink_l = sum;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure ami_getUint48Be(), which is used for MAC addresses
+
+\param  pArg_p              Not used.
+\param  iterations_p        Number of conversions to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchGetUint48Be(void* pArg_p, UINT32 iterations_p)
+{
+    UINT32  i;
+    UINT64  sum = 0;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (i = 0; i < iterations_p; i++)
+        sum += ami_getUint48Be(&aFrame_l[(i % BENCH_AMI_ARRAY_SIZE) * 6]);
+
+    sink_l = sum;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure ami_setUint16ArrayLe() on a PDO sized array
+
+\param  pArg_p              Not used.
+\param  iterations_p        Number of conversions to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchSetUint16ArrayLe(void* pArg_p, UINT32 iterations_p)
+{
+    UINT32  i;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (i = 0; i < iterations_p; i++)
+        ami_setUint16ArrayLe(aFrame_l, (const UINT16*)aValues_l, BENCH_AMI_ARRAY_SIZE);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure ami_getUint32ArrayBe() on a PDO sized array
+
+\param  pArg_p              Not used.
+\param  iterations_p        Number of conversions to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchGetUint32ArrayBe(void* pArg_p, UINT32 iterations_p)
+{
+    UINT32  i;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (i = 0; i < iterations_p; i++)
+        ami_getUint32ArrayBe(aFrame_l, (UINT32*)aValues_l, BENCH_AMI_ARRAY_SIZE);
+
+    sink_l = aValues_l[0];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure ami_getUint64ArrayLe() on a PDO sized array
+
+\param  pArg_p              Not used.
+\param  iterations_p        Number of conversions to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchGetUint64ArrayLe(void* pArg_p, UINT32 iterations_p)
+{
+    UINT32  i;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (i = 0; i < iterations_p; i++)
+        ami_getUint64ArrayLe(aFrame_l, aValues_l, BENCH_AMI_ARRAY_SIZE);
+
+    sink_l = aValues_l[0];
+}
+
+/// \}
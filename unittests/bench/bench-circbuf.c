@@ -0,0 +1,300 @@
+/**
+********************************************************************************
+\file   bench-circbuf.c
+
+\brief  Benchmarks of the circular buffer library
+
+The file contains the benchmarks of the circular buffer library, which is used
+for the event queues and the DLL asynchronous TX queues. Each benchmark is
+executed for a locked buffer and for a buffer in lock-free single-producer/
+single-consumer mode. The uncontended benchmarks write and read a block in the
+same thread. The contended benchmarks write in the benchmark thread while a
+second thread reads from a connected instance of the buffer, the result is
+the time per transferred block.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <pthread.h>
+#include <sched.h>
+
+#include <common/circbuffer.h>
+
+#include "bench.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define BENCH_CIRCBUF_SIZE          32768
+#define BENCH_CIRCBUF_BLOCK_SIZE    64
+
+// The locked benchmarks use the user internal event queue, the lock-free ones
+// the generic DLL TX queue. The build selects the lock-free ID with
+// CIRCBUF_LOCKFREE_BUFFERS.
+#define BENCH_CIRCBUF_ID_LOCKED     CIRCBUF_USER_INTERNAL_QUEUE
+#define BENCH_CIRCBUF_ID_LOCKFREE   CIRCBUF_DLLCAL_TXGEN
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Circular buffer benchmark context
+
+The structure contains the buffer instances used by one benchmark.
+*/
+typedef struct
+{
+    tCircBufInstance*   pWriter;            ///< Instance used by the benchmark thread
+    tCircBufInstance*   pReader;            ///< Connected instance used by the reader thread
+    pthread_t           readerThread;       ///< Reader thread of the contended benchmarks
+    volatile BOOL       fStopReader;        ///< Stops the reader thread
+    volatile UINT32     readCount;          ///< Number of blocks read by the reader thread
+} tBenchCircbuf;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void  runForBuffer(UINT8 bufferId_p, const char* pWriteReadName_p,
+                          const char* pReserveName_p, const char* pContendedName_p);
+static void  benchWriteRead(void* pArg_p, UINT32 iterations_p);
+static void  benchReserveCommit(void* pArg_p, UINT32 iterations_p);
+static void  benchContended(void* pArg_p, UINT32 iterations_p);
+static void* readerThread(void* pArg_p);
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Run circular buffer benchmarks
+*/
+//------------------------------------------------------------------------------
+void benchcircbuf_run(void)
+{
+    runForBuffer(BENCH_CIRCBUF_ID_LOCKED, "circbuf.writeRead.locked.64",
+                 "circbuf.reserveCommit.locked.64", "circbuf.contended.locked.64");
+    runForBuffer(BENCH_CIRCBUF_ID_LOCKFREE, "circbuf.writeRead.lockfree.64",
+                 "circbuf.reserveCommit.lockfree.64", "circbuf.contended.lockfree.64");
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Run the benchmarks of one circular buffer
+
+\param  bufferId_p          ID of the circular buffer to use.
+\param  pWriteReadName_p    Name of the uncontended write/read benchmark.
+\param  pReserveName_p      Name of the uncontended reserve/commit benchmark.
+\param  pContendedName_p    Name of the contended benchmark.
+*/
+//------------------------------------------------------------------------------
+static void runForBuffer(UINT8 bufferId_p, const char* pWriteReadName_p,
+                         const char* pReserveName_p, const char* pContendedName_p)
+{
+    tBenchCircbuf   bench;
+
+    OPLK_MEMSET(&bench, 0, sizeof(bench));
+
+    if (circbuf_alloc(bufferId_p, BENCH_CIRCBUF_SIZE, &bench.pWriter) != kCircBufOk)
+    {
+        bench_fail(pWriteReadName_p, "circbuf_alloc() failed");
+        return;
+    }
+
+    if (circbuf_connect(bufferId_p, &bench.pReader) != kCircBufOk)
+    {
+        bench_fail(pWriteReadName_p, "circbuf_connect() failed");
+        circbuf_free(bench.pWriter);
+        return;
+    }
+
+    bench_measure(pWriteReadName_p, benchWriteRead, &bench);
+    bench_measure(pReserveName_p, benchReserveCommit, &bench);
+
+    if (pthread_create(&bench.readerThread, NULL, readerThread, &bench) == 0)
+    {
+        bench_measure(pContendedName_p, benchContended, &bench);
+        bench.fStopReader = TRUE;
+        pthread_join(bench.readerThread, NULL);
+    }
+    else
+        bench_fail(pContendedName_p, "pthread_create() failed");
+
+    circbuf_disconnect(bench.pReader);
+    circbuf_free(bench.pWriter);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure circbuf_writeData() and circbuf_readData() without contention
+
+\param  pArg_p              Pointer to the benchmark context.
+\param  iterations_p        Number of blocks to write and read.
+*/
+//------------------------------------------------------------------------------
+static void benchWriteRead(void* pArg_p, UINT32 iterations_p)
+{
+    tBenchCircbuf*  pBench = (tBenchCircbuf*)pArg_p;
+    UINT8           aBlock[BENCH_CIRCBUF_BLOCK_SIZE];
+    size_t          readSize;
+    UINT32          i;
+
+    OPLK_MEMSET(aBlock, 0x55, sizeof(aBlock));
+
+    for (i = 0; i < iterations_p; i++)
+    {
+        circbuf_writeData(pBench->pWriter, aBlock, sizeof(aBlock));
+        circbuf_readData(pBench->pWriter, aBlock, sizeof(aBlock), &readSize);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure the zero-copy interface without contention
+
+The benchmark fills the block in place with circbuf_reserve() and
+circbuf_commit() and consumes it with circbuf_peek() and circbuf_release().
+
+\param  pArg_p              Pointer to the benchmark context.
+\param  iterations_p        Number of blocks to transfer.
+*/
+//------------------------------------------------------------------------------
+static void benchReserveCommit(void* pArg_p, UINT32 iterations_p)
+{
+    tBenchCircbuf*  pBench = (tBenchCircbuf*)pArg_p;
+    void*           pData;
+    size_t          blockSize;
+    UINT32          i;
+
+    for (i = 0; i < iterations_p; i++)
+    {
+        if (circbuf_reserve(pBench->pWriter, BENCH_CIRCBUF_BLOCK_SIZE, &pData) == kCircBufOk)
+        {
+            OPLK_MEMSET(pData, (UINT8)i, BENCH_CIRCBUF_BLOCK_SIZE);
+            circbuf_commit(pBench->pWriter, pData);
+        }
+
+        if (circbuf_peek(pBench->pWriter, &pData, &blockSize) == kCircBufOk)
+            circbuf_release(pBench->pWriter);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure circbuf_writeData() with a concurrent reader
+
+The function writes the blocks and waits until the reader thread has read all
+of them. If the buffer is full, the write is retried after yielding the CPU.
+
+\param  pArg_p              Pointer to the benchmark context.
+\param  iterations_p        Number of blocks to transfer.
+*/
+//------------------------------------------------------------------------------
+static void benchContended(void* pArg_p, UINT32 iterations_p)
+{
+    tBenchCircbuf*  pBench = (tBenchCircbuf*)pArg_p;
+    UINT8           aBlock[BENCH_CIRCBUF_BLOCK_SIZE];
+    UINT32          target;
+    UINT32          i;
+
+    OPLK_MEMSET(aBlock, 0xAA, sizeof(aBlock));
+    target = pBench->readCount + iterations_p;
+
+    for (i = 0; i < iterations_p; i++)
+    {
+        while (circbuf_writeData(pBench->pWriter, aBlock, sizeof(aBlock)) == kCircBufOutOfMem)
+            sched_yield();
+    }
+
+    while ((INT32)(target - pBench->readCount) > 0)
+        sched_yield();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Reader thread of the contended benchmarks
+
+\param  pArg_p              Pointer to the benchmark context.
+
+\return The function returns NULL.
+*/
+//------------------------------------------------------------------------------
+static void* readerThread(void* pArg_p)
+{
+    tBenchCircbuf*  pBench = (tBenchCircbuf*)pArg_p;
+    UINT8           aBlock[BENCH_CIRCBUF_BLOCK_SIZE];
+    size_t          readSize;
+
+    while (!pBench->fStopReader)
+    {
+        if (circbuf_readData(pBench->pReader, aBlock, sizeof(aBlock), &readSize) == kCircBufOk)
+            pBench->readCount++;
+        else
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+/// \}
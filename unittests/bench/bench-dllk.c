@@ -0,0 +1,217 @@
+/**
+********************************************************************************
+\file   bench-dllk.c
+
+\brief  Benchmarks of the kernel DLL frame functions
+
+The file contains the benchmarks of the frame functions of the kernel DLL
+module. The TX frames are created by dllk_createTxFrame(), so the frame
+templates are set up as by the DLL. The Ethernet driver is replaced by the
+stubs, which allocate the frame buffers from the heap.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <kernel/dll/dllk-internal.h>
+
+#include "bench.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define BENCH_DLLK_PRES_SIZE        C_DLL_MINSIZE_PRES      // PRes with 36 bytes payload
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError createFrames(void);
+static void       benchUpdateFramePres(void* pArg_p, UINT32 iterations_p);
+static void       benchUpdateFramePresToggle(void* pArg_p, UINT32 iterations_p);
+static void       benchCheckFrame(void* pArg_p, UINT32 iterations_p);
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tEdrvTxBuffer        aTxBuffer_l[DLLK_TXFRAME_COUNT];
+static tDllkFrameTemplate   aFrameTemplate_l[DLLK_TXFRAME_COUNT];
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Run kernel DLL benchmarks
+*/
+//------------------------------------------------------------------------------
+void benchdllk_run(void)
+{
+    if (createFrames() != kErrorOk)
+    {
+        bench_fail("dllk.updateFramePres", "creation of the TX frames failed");
+        return;
+    }
+
+    bench_measure("dllk.updateFramePres", benchUpdateFramePres, NULL);
+    bench_measure("dllk.updateFramePres.stateChange", benchUpdateFramePresToggle, NULL);
+    bench_measure("dllk.checkFrame.nmtRequest", benchCheckFrame, NULL);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Create the TX frames
+
+The function sets up the parts of the DLL instance which are used by the frame
+functions and creates the PRes and the NMT request frames.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError createFrames(void)
+{
+    tOplkError  ret;
+    UINT        handle = 0;
+    UINT        frameSize;
+
+    OPLK_MEMSET(&dllkInstance_g, 0, sizeof(dllkInstance_g));
+    dllkInstance_g.pTxBuffer = aTxBuffer_l;
+    dllkInstance_g.pFrameTemplate = aFrameTemplate_l;
+    dllkInstance_g.maxTxFrames = tabentries(aTxBuffer_l);
+    dllkInstance_g.dllConfigParam.nodeId = C_ADR_MN_DEF_NODE_ID;
+    dllkInstance_g.flag2 = 0x10;
+
+    frameSize = BENCH_DLLK_PRES_SIZE;
+    ret = dllk_createTxFrame(&handle, &frameSize, kMsgTypePres, kDllAsndNotDefined);
+    if (ret != kErrorOk)
+        return ret;
+
+    frameSize = C_DLL_MINSIZE_NMTREQ;
+    return dllk_createTxFrame(&handle, &frameSize, kMsgTypeAsnd, kDllAsndNmtRequest);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure dllk_updateFramePres() in a constant NMT state
+
+This is the case of every cycle in NMT_CS_OPERATIONAL. The dynamic fields do
+not change, so no frame data has to be written.
+
+\param  pArg_p              Not used.
+\param  iterations_p        Number of updates to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchUpdateFramePres(void* pArg_p, UINT32 iterations_p)
+{
+    tEdrvTxBuffer*  pTxBuffer = &dllkInstance_g.pTxBuffer[DLLK_TXFRAME_PRES];
+    UINT32          i;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (i = 0; i < iterations_p; i++)
+        dllk_updateFramePres(pTxBuffer + (i & 1), kNmtCsOperational);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure dllk_updateFramePres() with changing frame data
+
+The NMT state changes in every call, so the NMT status and flags are written.
+
+\param  pArg_p              Not used.
+\param  iterations_p        Number of updates to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchUpdateFramePresToggle(void* pArg_p, UINT32 iterations_p)
+{
+    tEdrvTxBuffer*  pTxBuffer = &dllkInstance_g.pTxBuffer[DLLK_TXFRAME_PRES];
+    UINT32          i;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (i = 0; i < iterations_p; i++)
+        dllk_updateFramePres(pTxBuffer, ((i & 1) != 0) ? kNmtCsOperational : kNmtCsPreOperational2);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure dllk_checkFrame()
+
+The function checks an NMT request frame as the DLL does it for every
+asynchronous frame from the application.
+
+\param  pArg_p              Not used.
+\param  iterations_p        Number of checks to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchCheckFrame(void* pArg_p, UINT32 iterations_p)
+{
+    tEdrvTxBuffer*  pTxBuffer = &dllkInstance_g.pTxBuffer[DLLK_TXFRAME_NMTREQ];
+    UINT32          i;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (i = 0; i < iterations_p; i++)
+        dllk_checkFrame((tPlkFrame*)pTxBuffer->pBuffer, pTxBuffer->txFrameSize);
+}
+
+/// \}
@@ -0,0 +1,221 @@
+/**
+********************************************************************************
+\file   bench-memcopy.c
+
+\brief  Benchmarks of the memory copy functions
+
+The file contains the benchmarks of the specialized memory copy functions.
+The fixed size copy is compared with OPLK_MEMCPY() for MAC addresses, the
+streaming copy with OPLK_MEMCPY() for PDO sized blocks, which are written into
+an image larger than the caches like the PDOs of a large process image.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdlib.h>
+
+#include <common/memcopy.h>
+
+#include "bench.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define BENCH_MEMCOPY_IMAGE_SIZE    (16 * 1024 * 1024)  // exceeds the caches of usual CPUs
+#define BENCH_MEMCOPY_BLOCK_SIZE    1024                // size of a large PDO
+#define BENCH_MEMCOPY_BLOCK_COUNT   (BENCH_MEMCOPY_IMAGE_SIZE / BENCH_MEMCOPY_BLOCK_SIZE)
+#define BENCH_MEMCOPY_MAC_SIZE      6
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void benchMemcpyMac(void* pArg_p, UINT32 iterations_p);
+static void benchFixedMac(void* pArg_p, UINT32 iterations_p);
+static void benchMemcpyBlock(void* pArg_p, UINT32 iterations_p);
+static void benchStreamBlock(void* pArg_p, UINT32 iterations_p);
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static BYTE*            pSrcImage_l;
+static BYTE*            pDstImage_l;
+static volatile size_t  macSize_l = BENCH_MEMCOPY_MAC_SIZE;  // hides the size from the compiler
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Run memory copy benchmarks
+*/
+//------------------------------------------------------------------------------
+void benchmemcopy_run(void)
+{
+    pSrcImage_l = (BYTE*)malloc(BENCH_MEMCOPY_IMAGE_SIZE);
+    pDstImage_l = (BYTE*)malloc(BENCH_MEMCOPY_IMAGE_SIZE);
+    if ((pSrcImage_l == NULL) || (pDstImage_l == NULL))
+    {
+        bench_fail("memcopy.memcpy.1k", "unable to allocate the images");
+        bench_fail("memcopy.stream.1k", "unable to allocate the images");
+    }
+    else
+    {
+        OPLK_MEMSET(pSrcImage_l, 0x55, BENCH_MEMCOPY_IMAGE_SIZE);
+        OPLK_MEMSET(pDstImage_l, 0, BENCH_MEMCOPY_IMAGE_SIZE);
+
+        bench_measure("memcopy.memcpy.mac", benchMemcpyMac, NULL);
+        bench_measure("memcopy.fixed.mac", benchFixedMac, NULL);
+        bench_measure("memcopy.memcpy.1k", benchMemcpyBlock, NULL);
+        bench_measure("memcopy.stream.1k", benchStreamBlock, NULL);
+    }
+
+    free(pSrcImage_l);
+    free(pDstImage_l);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure OPLK_MEMCPY() of a MAC address with a size known at runtime
+
+\param  pArg_p              Not used.
+\param  iterations_p        Number of copies to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchMemcpyMac(void* pArg_p, UINT32 iterations_p)
+{
+    UINT32  i;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (i = 0; i < iterations_p; i++)
+        OPLK_MEMCPY(&pDstImage_l[(i % 256) * 8], &pSrcImage_l[(i % 256) * 8], macSize_l);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure OPLK_MEMCPY_FIXED() of a MAC address
+
+\param  pArg_p              Not used.
+\param  iterations_p        Number of copies to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchFixedMac(void* pArg_p, UINT32 iterations_p)
+{
+    UINT32  i;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (i = 0; i < iterations_p; i++)
+        OPLK_MEMCPY_FIXED(&pDstImage_l[(i % 256) * 8], &pSrcImage_l[(i % 256) * 8], BENCH_MEMCOPY_MAC_SIZE);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure OPLK_MEMCPY() of PDO sized blocks into a large image
+
+\param  pArg_p              Not used.
+\param  iterations_p        Number of blocks to copy.
+*/
+//------------------------------------------------------------------------------
+static void benchMemcpyBlock(void* pArg_p, UINT32 iterations_p)
+{
+    UINT32  i;
+    size_t  offset;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (i = 0; i < iterations_p; i++)
+    {
+        offset = (size_t)(i % BENCH_MEMCOPY_BLOCK_COUNT) * BENCH_MEMCOPY_BLOCK_SIZE;
+        OPLK_MEMCPY(pDstImage_l + offset, pSrcImage_l + offset, BENCH_MEMCOPY_BLOCK_SIZE);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure memcopy_stream() of PDO sized blocks into a large image
+
+The stores are ordered once per call of the body, like once per cycle before
+the PDOs are published.
+
+\param  pArg_p              Not used.
+\param  iterations_p        Number of blocks to copy.
+*/
+//------------------------------------------------------------------------------
+static void benchStreamBlock(void* pArg_p, UINT32 iterations_p)
+{
+    UINT32  i;
+    size_t  offset;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (i = 0; i < iterations_p; i++)
+    {
+        offset = (size_t)(i % BENCH_MEMCOPY_BLOCK_COUNT) * BENCH_MEMCOPY_BLOCK_SIZE;
+        memcopy_stream(pDstImage_l + offset, pSrcImage_l + offset, BENCH_MEMCOPY_BLOCK_SIZE);
+    }
+
+    memcopy_streamFence();
+}
+
+/// \}
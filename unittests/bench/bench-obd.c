@@ -0,0 +1,297 @@
+/**
+********************************************************************************
+\file   bench-obd.c
+
+\brief  Benchmarks of the object dictionary
+
+The file contains the benchmarks of the object dictionary module. They use the
+object dictionary of the CiA 302-4 MN with its 160 device profile objects, so
+the index lookup has to pass a large table. The process image objects are
+linked to memory as an MN application does it.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/obd.h>
+
+#include "bench.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define BENCH_OBD_PI_ENTRIES        252         // number of subindices of a PI object
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Object dictionary benchmark entry
+
+The structure describes the object accessed by a benchmark.
+*/
+typedef struct
+{
+    UINT                index;              ///< Index of the object
+    UINT                subIndex;           ///< Subindex of the object
+} tBenchObdEntry;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void benchReadEntry(void* pArg_p, UINT32 iterations_p);
+static void benchWriteEntry(void* pArg_p, UINT32 iterations_p);
+static void benchReadEntryToLe(void* pArg_p, UINT32 iterations_p);
+static void benchGetDataSize(void* pArg_p, UINT32 iterations_p);
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static BOOL             fOdInitialized_l = FALSE;
+
+// Process image linked to the PI objects used by the benchmarks
+static UINT8            aPiUint8In_l[BENCH_OBD_PI_ENTRIES];
+static UINT16           aPiUint16In_l[BENCH_OBD_PI_ENTRIES];
+static UINT32           aPiUint32In_l[BENCH_OBD_PI_ENTRIES];
+static UINT8            aPiUint8Out_l[BENCH_OBD_PI_ENTRIES];
+static UINT16           aPiUint16Out_l[BENCH_OBD_PI_ENTRIES];
+static UINT32           aPiUint32Out_l[BENCH_OBD_PI_ENTRIES];
+static UINT64           aPiUint64Out_l[BENCH_OBD_PI_ENTRIES];
+
+static tBenchObdEntry   cycleLen_l = {0x1006, 0x00};
+static tBenchObdEntry   nodeAssign_l = {0x1F81, 200};
+static tBenchObdEntry   piUint32_l = {0xA680, 200};
+static tBenchObdEntry   piUint64_l = {0xA8C0, 200};
+static tBenchObdEntry   deviceName_l = {0x1008, 0x00};
+static volatile tObdSize sink_l;
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Initialize the object dictionary
+
+The function initializes the object dictionary and links the process image
+objects used by the benchmarks. It is called by all benchmarks which need the
+object dictionary, the initialization is only done once.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+tOplkError benchobd_initOd(void)
+{
+    tOplkError      ret;
+    tObdInitParam   initParam;
+
+    if (fOdInitialized_l)
+        return kErrorOk;
+
+    ret = obd_initObd(&initParam);
+    if (ret != kErrorOk)
+        return ret;
+
+    ret = obd_init(&initParam);
+    if (ret != kErrorOk)
+        return ret;
+
+    // TPDO sources (read-only from the network point of view)
+    ret = obd_defineVarRange(0xA040, 1, BENCH_OBD_PI_ENTRIES, sizeof(UINT8), aPiUint8In_l);
+    if (ret != kErrorOk)
+        return ret;
+    ret = obd_defineVarRange(0xA100, 1, BENCH_OBD_PI_ENTRIES, sizeof(UINT16), aPiUint16In_l);
+    if (ret != kErrorOk)
+        return ret;
+    ret = obd_defineVarRange(0xA200, 1, BENCH_OBD_PI_ENTRIES, sizeof(UINT32), aPiUint32In_l);
+    if (ret != kErrorOk)
+        return ret;
+
+    // RPDO targets
+    ret = obd_defineVarRange(0xA4C0, 1, BENCH_OBD_PI_ENTRIES, sizeof(UINT8), aPiUint8Out_l);
+    if (ret != kErrorOk)
+        return ret;
+    ret = obd_defineVarRange(0xA580, 1, BENCH_OBD_PI_ENTRIES, sizeof(UINT16), aPiUint16Out_l);
+    if (ret != kErrorOk)
+        return ret;
+    ret = obd_defineVarRange(0xA680, 1, BENCH_OBD_PI_ENTRIES, sizeof(UINT32), aPiUint32Out_l);
+    if (ret != kErrorOk)
+        return ret;
+    ret = obd_defineVarRange(0xA8C0, 1, BENCH_OBD_PI_ENTRIES, sizeof(UINT64), aPiUint64Out_l);
+    if (ret != kErrorOk)
+        return ret;
+
+    fOdInitialized_l = TRUE;
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Run object dictionary benchmarks
+*/
+//------------------------------------------------------------------------------
+void benchobd_run(void)
+{
+    if (benchobd_initOd() != kErrorOk)
+    {
+        bench_fail("obd.readEntry.0x1006", "initialization of the object dictionary failed");
+        return;
+    }
+
+    bench_measure("obd.readEntry.0x1006", benchReadEntry, &cycleLen_l);
+    bench_measure("obd.readEntry.0x1F81.200", benchReadEntry, &nodeAssign_l);
+    bench_measure("obd.readEntry.0xA8C0.200", benchReadEntry, &piUint64_l);
+    bench_measure("obd.readEntryToLe.0x1F81.200", benchReadEntryToLe, &nodeAssign_l);
+    bench_measure("obd.getDataSize.0x1008", benchGetDataSize, &deviceName_l);
+    bench_measure("obd.writeEntry.0x1006", benchWriteEntry, &cycleLen_l);
+    bench_measure("obd.writeEntry.0x1F81.200", benchWriteEntry, &nodeAssign_l);
+    bench_measure("obd.writeEntry.0xA680.200", benchWriteEntry, &piUint32_l);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure obd_readEntry()
+
+\param  pArg_p              Pointer to the object to read.
+\param  iterations_p        Number of accesses to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchReadEntry(void* pArg_p, UINT32 iterations_p)
+{
+    tBenchObdEntry* pEntry = (tBenchObdEntry*)pArg_p;
+    UINT64          value;
+    tObdSize        size;
+    UINT32          i;
+
+    for (i = 0; i < iterations_p; i++)
+    {
+        size = sizeof(value);
+        obd_readEntry(pEntry->index, pEntry->subIndex, &value, &size);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure obd_readEntryToLe()
+
+\param  pArg_p              Pointer to the object to read.
+\param  iterations_p        Number of accesses to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchReadEntryToLe(void* pArg_p, UINT32 iterations_p)
+{
+    tBenchObdEntry* pEntry = (tBenchObdEntry*)pArg_p;
+    UINT8           aValue[8];
+    tObdSize        size;
+    UINT32          i;
+
+    for (i = 0; i < iterations_p; i++)
+    {
+        size = sizeof(aValue);
+        obd_readEntryToLe(pEntry->index, pEntry->subIndex, aValue, &size);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure obd_getDataSize()
+
+The benchmark is used with VSTRING objects, which are queried for their size by
+SDO uploads.
+
+\param  pArg_p              Pointer to the object to query.
+\param  iterations_p        Number of accesses to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchGetDataSize(void* pArg_p, UINT32 iterations_p)
+{
+    tBenchObdEntry* pEntry = (tBenchObdEntry*)pArg_p;
+    tObdSize        size = 0;
+    UINT32          i;
+
+    for (i = 0; i < iterations_p; i++)
+        size += obd_getDataSize(pEntry->index, pEntry->subIndex);
+
+    sink_l = size;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure obd_writeEntry()
+
+The benchmark writes a 32 bit value, all objects used with it are UNSIGNED32.
+
+\param  pArg_p              Pointer to the object to write.
+\param  iterations_p        Number of accesses to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchWriteEntry(void* pArg_p, UINT32 iterations_p)
+{
+    tBenchObdEntry* pEntry = (tBenchObdEntry*)pArg_p;
+    UINT32          value;
+    UINT32          i;
+
+    for (i = 0; i < iterations_p; i++)
+    {
+        value = 1000 + (i & 0xFF);
+        obd_writeEntry(pEntry->index, pEntry->subIndex, &value, sizeof(value));
+    }
+}
+
+/// \}
@@ -0,0 +1,351 @@
+/**
+********************************************************************************
+\file   bench-pdo.c
+
+\brief  Benchmarks of the PDO copy functions
+
+The file contains the benchmarks of the user PDO module. The PDOs of an MN with
+BENCH_PDO_NODE_COUNT CNs are configured through the object dictionary as a
+configuration manager does it. Every CN gets an RPDO with 14 objects and a
+TPDO with 8 objects which are mapped to the process image objects of the MN.
+The PDO memory is the real triple buffer implementation, the kernel layer is
+emulated by the stubs.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+#include <oplk/obd.h>
+#include <oplk/nmt.h>
+#include <user/pdou.h>
+#include <common/cyclestat.h>
+
+#include "bench.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define BENCH_PDO_NODE_COUNT        10
+
+#define BENCH_PDO_RX_COMM_PARAM     0x1400
+#define BENCH_PDO_RX_MAPP_PARAM     0x1600
+#define BENCH_PDO_TX_COMM_PARAM     0x1800
+#define BENCH_PDO_TX_MAPP_PARAM     0x1A00
+
+// Builds an object mapping entry (length and offset in bits)
+#define BENCH_PDO_MAPPING(index, subIndex, bitOffset, bitSize) \
+    (((UINT64)(bitSize) << 48) | ((UINT64)(bitOffset) << 32) | \
+     ((UINT64)(subIndex) << 16) | (UINT64)(index))
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Mapped object group
+
+The structure describes a group of consecutive process image variables which
+is mapped into the PDO of every CN.
+*/
+typedef struct
+{
+    UINT16              index;              ///< Index of the process image object
+    UINT                count;              ///< Number of mapped variables per CN
+    UINT                bitSize;            ///< Size of one variable in bits
+} tBenchPdoGroup;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError configurePdos(void);
+static tOplkError configureChannel(UINT16 commIndex_p, UINT16 mappIndex_p, UINT nodeId_p,
+                                   const tBenchPdoGroup* pGroups_p, UINT groupCount_p);
+static void       benchCopyRxPdoToPi(void* pArg_p, UINT32 iterations_p);
+static void       benchCopyTxPdoFromPi(void* pArg_p, UINT32 iterations_p);
+static void       benchCopyTxPdoFromPiDirty(void* pArg_p, UINT32 iterations_p);
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+
+// A typical I/O node: digital and analog values of 8, 16 and 32 bits
+static const tBenchPdoGroup aRxGroups_l[] =
+{
+    {0xA4C0, 8, 8},
+    {0xA580, 4, 16},
+    {0xA680, 2, 32},
+};
+
+static const tBenchPdoGroup aTxGroups_l[] =
+{
+    {0xA040, 4, 8},
+    {0xA100, 2, 16},
+    {0xA200, 2, 32},
+};
+
+static void*        pDirtyVar_l;
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Run PDO benchmarks
+*/
+//------------------------------------------------------------------------------
+void benchpdo_run(void)
+{
+    tObdVarEntry MEM*   pVarEntry;
+
+    if (configurePdos() != kErrorOk)
+    {
+        bench_fail("pdo.copyRxPdoToPi", "configuration of the PDOs failed");
+        return;
+    }
+
+    bench_measure("pdo.copyRxPdoToPi", benchCopyRxPdoToPi, NULL);
+    bench_measure("pdo.copyTxPdoFromPi", benchCopyTxPdoFromPi, NULL);
+
+    // the application of CN 1 writes its first analog output
+    if (obd_searchVarEntry(aTxGroups_l[1].index, 1, &pVarEntry) != kErrorOk)
+    {
+        bench_fail("pdo.copyTxPdoFromPi.dirtyTracking", "mapped variable not found");
+        return;
+    }
+    pDirtyVar_l = pVarEntry->pData;
+
+    pdou_enableTxPdoDirtyTracking(TRUE);
+    bench_measure("pdo.copyTxPdoFromPi.dirtyTracking", benchCopyTxPdoFromPiDirty, NULL);
+    pdou_enableTxPdoDirtyTracking(FALSE);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Configure the PDOs
+
+The function writes the PDO mapping of all CNs to the object dictionary and
+switches the PDO module to NMT_GS_RESET_CONFIGURATION, which configures and
+starts the PDO channels.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError configurePdos(void)
+{
+    tOplkError              ret;
+    tEventNmtStateChange    nmtStateChange;
+    UINT                    node;
+
+    ret = benchobd_initOd();
+    if (ret != kErrorOk)
+        return ret;
+
+    ret = pdou_init(NULL);
+    if (ret != kErrorOk)
+        return ret;
+
+#if (CONFIG_CYCLE_STATISTICS != FALSE)
+    // the stack marks the PDO copy stages of the cycle statistics
+    ret = cyclestat_init();
+    if (ret != kErrorOk)
+        return ret;
+#endif
+
+    for (node = 0; node < BENCH_PDO_NODE_COUNT; node++)
+    {
+        ret = configureChannel(BENCH_PDO_RX_COMM_PARAM + node, BENCH_PDO_RX_MAPP_PARAM + node,
+                               node + 1, aRxGroups_l, tabentries(aRxGroups_l));
+        if (ret != kErrorOk)
+            return ret;
+
+        ret = configureChannel(BENCH_PDO_TX_COMM_PARAM + node, BENCH_PDO_TX_MAPP_PARAM + node,
+                               node + 1, aTxGroups_l, tabentries(aTxGroups_l));
+        if (ret != kErrorOk)
+            return ret;
+    }
+
+    OPLK_MEMSET(&nmtStateChange, 0, sizeof(nmtStateChange));
+    nmtStateChange.newNmtState = kNmtGsResetConfiguration;
+    nmtStateChange.oldNmtState = kNmtGsResetCommunication;
+    ret = pdou_cbNmtStateChange(nmtStateChange);
+    if (ret != kErrorOk)
+        return ret;
+
+    CYCLESTAT_START_CYCLE();
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Configure one PDO channel
+
+The function writes the communication and mapping parameters of one PDO. The
+variables of CN n are the subindices following the ones of CN n-1.
+
+\param  commIndex_p         Index of the communication parameter object.
+\param  mappIndex_p         Index of the mapping parameter object.
+\param  nodeId_p            Node ID of the CN.
+\param  pGroups_p           Mapped object groups.
+\param  groupCount_p        Number of mapped object groups.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError configureChannel(UINT16 commIndex_p, UINT16 mappIndex_p, UINT nodeId_p,
+                                   const tBenchPdoGroup* pGroups_p, UINT groupCount_p)
+{
+    tOplkError  ret;
+    UINT8       nodeId = (UINT8)nodeId_p;
+    UINT8       mappCount = 0;
+    UINT        bitOffset = 0;
+    UINT64      mapping;
+    UINT        group;
+    UINT        var;
+
+    ret = obd_writeEntry(commIndex_p, 0x01, &nodeId, sizeof(nodeId));
+    if (ret != kErrorOk)
+        return ret;
+
+    for (group = 0; group < groupCount_p; group++)
+    {
+        for (var = 0; var < pGroups_p[group].count; var++)
+        {
+            mapping = BENCH_PDO_MAPPING(pGroups_p[group].index,
+                                        (nodeId_p - 1) * pGroups_p[group].count + var + 1,
+                                        bitOffset, pGroups_p[group].bitSize);
+            mappCount++;
+            ret = obd_writeEntry(mappIndex_p, mappCount, &mapping, sizeof(mapping));
+            if (ret != kErrorOk)
+                return ret;
+
+            bitOffset += pGroups_p[group].bitSize;
+        }
+    }
+
+    return obd_writeEntry(mappIndex_p, 0x00, &mappCount, sizeof(mappCount));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure pdou_copyRxPdoToPi()
+
+The kernel layer is emulated to provide new data of all RPDOs in every cycle,
+so every call exchanges the triple buffers.
+
+\param  pArg_p              Not used.
+\param  iterations_p        Number of cycles to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchCopyRxPdoToPi(void* pArg_p, UINT32 iterations_p)
+{
+    UINT32  i;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (i = 0; i < iterations_p; i++)
+    {
+        stub_setRxPdoNewData();
+        pdou_copyRxPdoToPi();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure pdou_copyTxPdoFromPi()
+
+\param  pArg_p              Not used.
+\param  iterations_p        Number of cycles to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchCopyTxPdoFromPi(void* pArg_p, UINT32 iterations_p)
+{
+    UINT32  i;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (i = 0; i < iterations_p; i++)
+        pdou_copyTxPdoFromPi();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure pdou_copyTxPdoFromPi() with write tracking
+
+In every cycle the application marks one variable as written, so only one of
+the TPDOs has to be encoded.
+
+\param  pArg_p              Not used.
+\param  iterations_p        Number of cycles to execute.
+*/
+//------------------------------------------------------------------------------
+static void benchCopyTxPdoFromPiDirty(void* pArg_p, UINT32 iterations_p)
+{
+    UINT32  i;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    for (i = 0; i < iterations_p; i++)
+    {
+        pdou_markTxPdoDirty(pDirtyVar_l, sizeof(UINT16));
+        pdou_copyTxPdoFromPi();
+    }
+}
+
+/// \}
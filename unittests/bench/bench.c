@@ -0,0 +1,459 @@
+/**
+********************************************************************************
+\file   bench.c
+
+\brief  Benchmark harness of the openPOWERLINK benchmark suite
+
+The file contains the main function and the measurement harness of the
+benchmark suite. Every benchmark body is calibrated until one repetition takes
+at least the configured minimum time. It is then executed for the configured
+number of repetitions and the time per operation is reported as JSON, so the
+results of different releases can be compared by scripts.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/utsname.h>
+
+#include "bench.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define BENCH_MAX_RESULTS           64
+#define BENCH_MAX_REPETITIONS       100
+#define BENCH_DEFAULT_REPETITIONS   7
+#define BENCH_DEFAULT_MIN_TIME_MS   20
+#define BENCH_MAX_ITERATIONS        0x40000000UL
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Benchmark result
+
+The structure contains the result of one benchmark.
+*/
+typedef struct
+{
+    const char*     pName;                  ///< Name of the benchmark
+    const char*     pError;                 ///< Reason if the benchmark failed, otherwise NULL
+    UINT32          iterations;             ///< Operations per repetition
+    double          nsPerOpMin;             ///< Fastest repetition in ns per operation
+    double          nsPerOpMedian;          ///< Median repetition in ns per operation
+    double          nsPerOpMean;            ///< Mean of all repetitions in ns per operation
+    double          nsPerOpMax;             ///< Slowest repetition in ns per operation
+} tBenchResult;
+
+/**
+\brief  Benchmark harness instance
+
+The structure contains the options and the results of the benchmark run.
+*/
+typedef struct
+{
+    const char*     pFilter;                ///< Only benchmarks containing this string are run
+    UINT            repetitions;            ///< Number of measured repetitions
+    UINT64          minTimeNs;              ///< Minimum time of one repetition
+    UINT            resultCount;            ///< Number of stored results
+    tBenchResult    aResult[BENCH_MAX_RESULTS]; ///< Results of the executed benchmarks
+} tBenchInstance;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static UINT64        getTimeNs(void);
+static UINT64        runBody(tBenchBody pfnBody_p, void* pArg_p, UINT32 iterations_p);
+static tBenchResult* addResult(const char* pName_p);
+static int           compareDouble(const void* pA_p, const void* pB_p);
+static void          writeJson(FILE* pFile_p);
+static void          usage(const char* pProgName_p);
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tBenchInstance   instance_l;
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Main function of the benchmark suite
+
+The function parses the command line options, runs all benchmarks and writes
+the results.
+
+\param  argc            Number of arguments
+\param  argv            Pointer to arguments
+
+\return The function returns 0 if all benchmarks succeeded, otherwise 1.
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    const char* pOutFile = NULL;
+    FILE*       pFile;
+    UINT        i;
+    int         opt;
+    int         exitCode = 0;
+
+    instance_l.repetitions = BENCH_DEFAULT_REPETITIONS;
+    instance_l.minTimeNs = BENCH_DEFAULT_MIN_TIME_MS * 1000000ULL;
+
+    while ((opt = getopt(argc, argv, "o:f:r:t:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'o':
+                pOutFile = optarg;
+                break;
+
+            case 'f':
+                instance_l.pFilter = optarg;
+                break;
+
+            case 'r':
+                instance_l.repetitions = (UINT)strtoul(optarg, NULL, 0);
+                break;
+
+            case 't':
+                instance_l.minTimeNs = strtoull(optarg, NULL, 0) * 1000000ULL;
+                break;
+
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if ((instance_l.repetitions == 0) || (instance_l.repetitions > BENCH_MAX_REPETITIONS))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    benchami_run();
+    benchcircbuf_run();
+    benchobd_run();
+    benchpdo_run();
+    benchdllk_run();
+    benchmemcopy_run();
+
+    if (pOutFile != NULL)
+    {
+        pFile = fopen(pOutFile, "w");
+        if (pFile == NULL)
+        {
+            fprintf(stderr, "Unable to open %s\n", pOutFile);
+            return 1;
+        }
+    }
+    else
+        pFile = stdout;
+
+    writeJson(pFile);
+
+    if (pFile != stdout)
+        fclose(pFile);
+
+    for (i = 0; i < instance_l.resultCount; i++)
+    {
+        if (instance_l.aResult[i].pError != NULL)
+            exitCode = 1;
+    }
+
+    return exitCode;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Measure a benchmark
+
+The function measures the given benchmark body. The number of operations per
+repetition is doubled until one repetition takes at least the minimum time.
+Afterwards the configured number of repetitions is measured and stored.
+
+\param  pName_p             Name of the benchmark (must be a static string).
+\param  pfnBody_p           Benchmark body.
+\param  pArg_p              Argument passed to the benchmark body.
+*/
+//------------------------------------------------------------------------------
+void bench_measure(const char* pName_p, tBenchBody pfnBody_p, void* pArg_p)
+{
+    tBenchResult*   pResult;
+    double          aNsPerOp[BENCH_MAX_REPETITIONS];
+    double          sum = 0.0;
+    UINT32          iterations = 1;
+    UINT            i;
+
+    if ((instance_l.pFilter != NULL) && (strstr(pName_p, instance_l.pFilter) == NULL))
+        return;
+
+    pResult = addResult(pName_p);
+    if (pResult == NULL)
+        return;
+
+    // calibrate
+    while ((runBody(pfnBody_p, pArg_p, iterations) < instance_l.minTimeNs) &&
+           (iterations < BENCH_MAX_ITERATIONS))
+    {
+        iterations <<= 1;
+    }
+
+    for (i = 0; i < instance_l.repetitions; i++)
+    {
+        aNsPerOp[i] = (double)runBody(pfnBody_p, pArg_p, iterations) / iterations;
+        sum += aNsPerOp[i];
+    }
+
+    qsort(aNsPerOp, instance_l.repetitions, sizeof(double), compareDouble);
+
+    pResult->iterations = iterations;
+    pResult->nsPerOpMin = aNsPerOp[0];
+    pResult->nsPerOpMedian = aNsPerOp[instance_l.repetitions / 2];
+    pResult->nsPerOpMean = sum / instance_l.repetitions;
+    pResult->nsPerOpMax = aNsPerOp[instance_l.repetitions - 1];
+
+    fprintf(stderr, "%-40s %12.1f ns/op (min %.1f, %lu ops)\n",
+            pName_p, pResult->nsPerOpMedian, pResult->nsPerOpMin, (ULONG)iterations);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Report a failed benchmark
+
+The function records that a benchmark could not be executed, e.g. because its
+setup failed. The reason is written to the results and the benchmark suite
+exits with an error.
+
+\param  pName_p             Name of the benchmark (must be a static string).
+\param  pReason_p           Reason of the failure (must be a static string).
+*/
+//------------------------------------------------------------------------------
+void bench_fail(const char* pName_p, const char* pReason_p)
+{
+    tBenchResult*   pResult;
+
+    if ((instance_l.pFilter != NULL) && (strstr(pName_p, instance_l.pFilter) == NULL))
+        return;
+
+    pResult = addResult(pName_p);
+    if (pResult == NULL)
+        return;
+
+    pResult->pError = pReason_p;
+    fprintf(stderr, "%-40s FAILED: %s\n", pName_p, pReason_p);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get monotonic time
+
+\return The function returns the monotonic time in ns.
+*/
+//------------------------------------------------------------------------------
+static UINT64 getTimeNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (UINT64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Run benchmark body
+
+The function executes the benchmark body once and measures its duration.
+
+\param  pfnBody_p           Benchmark body.
+\param  pArg_p              Argument passed to the benchmark body.
+\param  iterations_p        Number of operations to execute.
+
+\return The function returns the duration in ns.
+*/
+//------------------------------------------------------------------------------
+static UINT64 runBody(tBenchBody pfnBody_p, void* pArg_p, UINT32 iterations_p)
+{
+    UINT64  start;
+
+    start = getTimeNs();
+    pfnBody_p(pArg_p, iterations_p);
+    return getTimeNs() - start;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add a result entry
+
+\param  pName_p             Name of the benchmark.
+
+\return The function returns a pointer to the zeroed result entry or NULL if
+        the result table is full.
+*/
+//------------------------------------------------------------------------------
+static tBenchResult* addResult(const char* pName_p)
+{
+    tBenchResult*   pResult;
+
+    if (instance_l.resultCount >= BENCH_MAX_RESULTS)
+    {
+        fprintf(stderr, "Too many benchmarks, %s skipped\n", pName_p);
+        return NULL;
+    }
+
+    pResult = &instance_l.aResult[instance_l.resultCount++];
+    memset(pResult, 0, sizeof(tBenchResult));
+    pResult->pName = pName_p;
+
+    return pResult;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Compare two doubles for qsort()
+
+\param  pA_p                Pointer to first value.
+\param  pB_p                Pointer to second value.
+
+\return The function returns -1, 0 or 1.
+*/
+//------------------------------------------------------------------------------
+static int compareDouble(const void* pA_p, const void* pB_p)
+{
+    double  a = *(const double*)pA_p;
+    double  b = *(const double*)pB_p;
+
+    return (a > b) - (a < b);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write results as JSON
+
+The function writes the configuration of the run and all results as JSON
+document. The benchmark names only contain characters which need no escaping.
+
+\param  pFile_p             File to write to.
+*/
+//------------------------------------------------------------------------------
+static void writeJson(FILE* pFile_p)
+{
+    struct utsname  uts;
+    tBenchResult*   pResult;
+    UINT            i;
+
+    if (uname(&uts) != 0)
+        memset(&uts, 0, sizeof(uts));
+
+    fprintf(pFile_p, "{\n");
+    fprintf(pFile_p, "  \"suite\": \"openPOWERLINK\",\n");
+    fprintf(pFile_p, "  \"timestamp\": %lu,\n", (ULONG)time(NULL));
+    fprintf(pFile_p, "  \"host\": {\"system\": \"%s\", \"release\": \"%s\", \"machine\": \"%s\"},\n",
+            uts.sysname, uts.release, uts.machine);
+    fprintf(pFile_p, "  \"compiler\": \"%s\",\n", __VERSION__);
+    fprintf(pFile_p, "  \"repetitions\": %u,\n", instance_l.repetitions);
+    fprintf(pFile_p, "  \"minTimeMs\": %lu,\n", (ULONG)(instance_l.minTimeNs / 1000000ULL));
+    fprintf(pFile_p, "  \"benchmarks\": [");
+
+    for (i = 0; i < instance_l.resultCount; i++)
+    {
+        pResult = &instance_l.aResult[i];
+        fprintf(pFile_p, "%s\n    {\"name\": \"%s\", ", (i == 0) ? "" : ",", pResult->pName);
+        if (pResult->pError != NULL)
+        {
+            fprintf(pFile_p, "\"error\": \"%s\"}", pResult->pError);
+            continue;
+        }
+
+        fprintf(pFile_p, "\"iterations\": %lu, \"nsPerOpMin\": %.2f, \"nsPerOpMedian\": %.2f, "
+                "\"nsPerOpMean\": %.2f, \"nsPerOpMax\": %.2f}",
+                (ULONG)pResult->iterations, pResult->nsPerOpMin, pResult->nsPerOpMedian,
+                pResult->nsPerOpMean, pResult->nsPerOpMax);
+    }
+
+    fprintf(pFile_p, "\n  ]\n}\n");
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print usage
+
+\param  pProgName_p         Name of the program.
+*/
+//------------------------------------------------------------------------------
+static void usage(const char* pProgName_p)
+{
+    fprintf(stderr, "Usage: %s [-o <file>] [-f <filter>] [-r <repetitions>] [-t <ms>]\n"
+            "  -o <file>        Write JSON results to <file> instead of stdout\n"
+            "  -f <filter>      Only run benchmarks whose name contains <filter>\n"
+            "  -r <count>       Number of measured repetitions (1-%d, default %d)\n"
+            "  -t <ms>          Minimum duration of one repetition (default %d ms)\n",
+            pProgName_p, BENCH_MAX_REPETITIONS, BENCH_DEFAULT_REPETITIONS,
+            BENCH_DEFAULT_MIN_TIME_MS);
+}
+
+/// \}
@@ -0,0 +1,92 @@
+/**
+********************************************************************************
+\file   bench.h
+
+\brief  Definitions of the openPOWERLINK benchmark suite
+
+The file contains the definitions of the benchmark harness which is used by
+the microbenchmarks of the stack's hot-path modules.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_bench_H_
+#define _INC_bench_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Benchmark body
+
+The function executes the measured operation \p iterations_p times. It is
+called repeatedly by the harness, which measures the time of each call.
+
+\param  pArg_p              Argument passed to bench_measure().
+\param  iterations_p        Number of operations to execute.
+*/
+typedef void (*tBenchBody)(void* pArg_p, UINT32 iterations_p);
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void bench_measure(const char* pName_p, tBenchBody pfnBody_p, void* pArg_p);
+void bench_fail(const char* pName_p, const char* pReason_p);
+
+void benchami_run(void);
+void benchcircbuf_run(void);
+void benchobd_run(void);
+void benchpdo_run(void);
+void benchdllk_run(void);
+void benchmemcopy_run(void);
+
+tOplkError benchobd_initOd(void);
+
+void stub_setRxPdoNewData(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_bench_H_ */
@@ -0,0 +1,414 @@
+/**
+********************************************************************************
+\file   stubs.c
+
+\brief  Stubs for the benchmark suite
+
+This file contains all stubs needed by the benchmark suite. Most stubs do
+nothing. The PDO CAL stubs emulate the kernel layer: they allocate the PDO
+memory from the heap and set up the triple buffers like the kernel PDO module.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdlib.h>
+#include <stdarg.h>
+
+#include <oplk/oplkinc.h>
+#include <oplk/obd.h>
+#include <oplk/cfm.h>
+#include <common/pdo.h>
+#include <common/target.h>
+#include <user/ctrlu.h>
+#include <user/errhndu.h>
+#include <user/pdoucal.h>
+#include <kernel/dllkcal.h>
+#include <kernel/edrv.h>
+#include <kernel/errhndk.h>
+#include <kernel/eventk.h>
+#include <kernel/hrestimer.h>
+#include <kernel/dll/dllk-internal.h>
+
+#include "bench.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+tDllkInstance       dllkInstance_g;
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static WORD             aRxPdoSize_l[D_PDO_RPDOChannels_U16];
+static WORD             aTxPdoSize_l[D_PDO_TPDOChannels_U16];
+static UINT             rxPdoChannelCount_l;
+static UINT             txPdoChannelCount_l;
+static tPdoMemRegion*   pPdoMem_l;
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Provide new data for all RPDOs
+
+The function emulates the kernel PDO module receiving new data of all RPDOs,
+so the next pdou_copyRxPdoToPi() claims the published buffers.
+*/
+//------------------------------------------------------------------------------
+void stub_setRxPdoNewData(void)
+{
+    UINT                channelId;
+    tPdoBufferInfo*     pInfo;
+
+    if (pPdoMem_l == NULL)
+        return;
+
+    // publish the write buffer and continue with the third one of the single reader
+    for (channelId = 0; channelId < rxPdoChannelCount_l; channelId++)
+    {
+        pInfo = &pPdoMem_l->rxChannelInfo[channelId].info;
+        pInfo->aSequence[pInfo->writeBuf] = ++pInfo->sequence;
+        pInfo->cleanBuf = pInfo->writeBuf;
+        pInfo->writeBuf = (OPLK_ATOMIC_T)(3 - pInfo->cleanBuf - pInfo->aReaderBuf[0]);
+    }
+}
+
+//------------------------------------------------------------------------------
+// target
+//------------------------------------------------------------------------------
+void trace(const char* fmt, ...)
+{
+    UNUSED_PARAMETER(fmt);
+}
+
+void target_msleep(UINT32 milliSeconds_p)
+{
+    UNUSED_PARAMETER(milliSeconds_p);
+}
+
+UINT32 target_getTickCount(void)
+{
+    return 0;
+}
+
+ULONGLONG target_getCurrentTimestamp(void)
+{
+    struct timespec curTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &curTime);
+    return ((ULONGLONG)curTime.tv_sec * 1000000000ULL) + (ULONGLONG)curTime.tv_nsec;
+}
+
+ULONGLONG target_getCycleCounter(void)
+{
+    // without a TSC the cycle counter counts nanoseconds
+    return target_getCurrentTimestamp();
+}
+
+ULONGLONG target_convertCyclesToNs(ULONGLONG cycles_p)
+{
+    return cycles_p;
+}
+
+//------------------------------------------------------------------------------
+// OD callbacks of modules which are not benchmarked
+//------------------------------------------------------------------------------
+tOplkError ctrlu_cbObdAccess(tObdCbParam MEM* pParam_p)
+{
+    UNUSED_PARAMETER(pParam_p);
+    return kErrorOk;
+}
+
+tOplkError errhndu_cbObdAccess(tObdCbParam MEM* pParam_p)
+{
+    UNUSED_PARAMETER(pParam_p);
+    return kErrorOk;
+}
+
+tOplkError errhndu_mnCnLossPresCbObdAccess(tObdCbParam MEM* pParam_p)
+{
+    UNUSED_PARAMETER(pParam_p);
+    return kErrorOk;
+}
+
+tOplkError cfmu_cbObdAccess(tObdCbParam MEM* pParam_p)
+{
+    UNUSED_PARAMETER(pParam_p);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+// PDO CAL, emulating the kernel layer
+//------------------------------------------------------------------------------
+tOplkError pdoucal_init(tSyncCb pfnSyncCb_p)
+{
+    UNUSED_PARAMETER(pfnSyncCb_p);
+    return kErrorOk;
+}
+
+tOplkError pdoucal_exit(void)
+{
+    return kErrorOk;
+}
+
+tOplkError pdoucal_postPdokChannelAlloc(tPdoAllocationParam* pAllocationParam_p)
+{
+    rxPdoChannelCount_l = pAllocationParam_p->rxPdoChannelCount;
+    txPdoChannelCount_l = pAllocationParam_p->txPdoChannelCount;
+    return kErrorOk;
+}
+
+tOplkError pdoucal_postConfigureChannel(tPdoChannelConf* pChannelConf_p)
+{
+    if (pChannelConf_p->fTx)
+        aTxPdoSize_l[pChannelConf_p->channelId] = pChannelConf_p->pdoChannel.pdoSize;
+    else
+        aRxPdoSize_l[pChannelConf_p->channelId] = pChannelConf_p->pdoChannel.pdoSize;
+
+    return kErrorOk;
+}
+
+tOplkError pdoucal_postAddRoute(const tPdoRoute* pRoute_p)
+{
+    UNUSED_PARAMETER(pRoute_p);
+    return kErrorOk;
+}
+
+tOplkError pdoucal_postClearRoutes(void)
+{
+    return kErrorOk;
+}
+
+tOplkError pdoucal_postSetupPdoBuffers(size_t rxPdoMemSize_p, size_t txPdoMemSize_p)
+{
+    UNUSED_PARAMETER(rxPdoMemSize_p);
+    UNUSED_PARAMETER(txPdoMemSize_p);
+    return kErrorOk;
+}
+
+tOplkError pdoucal_allocateMem(size_t memSize_p, BYTE** ppPdoMem_p)
+{
+    UINT    channelId;
+    ULONG   offset = 0;
+
+    pPdoMem_l = (tPdoMemRegion*)calloc(1, memSize_p);
+    if (pPdoMem_l == NULL)
+        return kErrorNoResource;
+
+    // set up the channels like pdokcal_initPdoMem()
+    for (channelId = 0; channelId < rxPdoChannelCount_l; channelId++)
+    {
+        pPdoMem_l->rxChannelInfo[channelId].info.channelOffset = offset;
+        pPdoMem_l->rxChannelInfo[channelId].info.readBuf = 0;
+        pPdoMem_l->rxChannelInfo[channelId].info.writeBuf = 1;
+        pPdoMem_l->rxChannelInfo[channelId].info.cleanBuf = 2;
+        offset += PDO_ALIGN_CACHE_LINE(aRxPdoSize_l[channelId]);
+    }
+
+    for (channelId = 0; channelId < txPdoChannelCount_l; channelId++)
+    {
+        pPdoMem_l->txChannelInfo[channelId].info.channelOffset = offset;
+        pPdoMem_l->txChannelInfo[channelId].info.readBuf = 0;
+        pPdoMem_l->txChannelInfo[channelId].info.writeBuf = 1;
+        pPdoMem_l->txChannelInfo[channelId].info.cleanBuf = 2;
+        offset += PDO_ALIGN_CACHE_LINE(aTxPdoSize_l[channelId]);
+    }
+    pPdoMem_l->pdoMemSize = offset;
+
+    *ppPdoMem_p = (BYTE*)pPdoMem_l;
+    return kErrorOk;
+}
+
+tOplkError pdoucal_freeMem(BYTE* pMem_p, size_t memSize_p)
+{
+    UNUSED_PARAMETER(memSize_p);
+
+    if ((tPdoMemRegion*)pMem_p == pPdoMem_l)
+        pPdoMem_l = NULL;
+
+    free(pMem_p);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+// kernel layer
+//------------------------------------------------------------------------------
+tOplkError edrv_allocTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    pBuffer_p->pBuffer = (UINT8*)calloc(1, pBuffer_p->maxBufferSize);
+    if (pBuffer_p->pBuffer == NULL)
+        return kErrorEdrvNoFreeBufEntry;
+
+    return kErrorOk;
+}
+
+tOplkError edrv_freeTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    free(pBuffer_p->pBuffer);
+    pBuffer_p->pBuffer = NULL;
+    return kErrorOk;
+}
+
+tOplkError edrv_sendTxBuffer(tEdrvTxBuffer* pBuffer_p)
+{
+    UNUSED_PARAMETER(pBuffer_p);
+    return kErrorOk;
+}
+
+tOplkError dllk_postEvent(tEventType eventType_p)
+{
+    UNUSED_PARAMETER(eventType_p);
+    return kErrorOk;
+}
+
+tOplkError dllk_issueLossOfPres(UINT nodeId_p)
+{
+    UNUSED_PARAMETER(nodeId_p);
+    return kErrorOk;
+}
+
+tOplkError dllk_changeState(tNmtEvent nmtEvent_p, tNmtState nmtState_p)
+{
+    UNUSED_PARAMETER(nmtEvent_p);
+    UNUSED_PARAMETER(nmtState_p);
+    return kErrorOk;
+}
+
+tDllkNodeInfo* dllk_getNodeInfo(UINT nodeId_p)
+{
+    UNUSED_PARAMETER(nodeId_p);
+    return NULL;
+}
+
+tOplkError dllk_cbMnTimerCycle(tTimerEventArg* pEventArg_p)
+{
+    UNUSED_PARAMETER(pEventArg_p);
+    return kErrorOk;
+}
+
+tOplkError dllk_cbCnTimer(tTimerEventArg* pEventArg_p)
+{
+    UNUSED_PARAMETER(pEventArg_p);
+    return kErrorOk;
+}
+
+tOplkError dllkcal_asyncFrameReceived(tFrameInfo* pFrameInfo_p)
+{
+    UNUSED_PARAMETER(pFrameInfo_p);
+    return kErrorOk;
+}
+
+tOplkError dllkcal_getSoaRequest(tDllReqServiceId* pReqServiceId_p,
+                                 UINT* pNodeId_p, tSoaPayload* pSoaPayload_p)
+{
+    UNUSED_PARAMETER(pNodeId_p);
+    UNUSED_PARAMETER(pSoaPayload_p);
+    *pReqServiceId_p = kDllReqServiceNo;
+    return kErrorOk;
+}
+
+tOplkError dllkcal_setAsyncPendingRequests(UINT nodeId_p, tDllAsyncReqPriority asyncReqPrio_p,
+                                           UINT count_p)
+{
+    UNUSED_PARAMETER(nodeId_p);
+    UNUSED_PARAMETER(asyncReqPrio_p);
+    UNUSED_PARAMETER(count_p);
+    return kErrorOk;
+}
+
+tOplkError errhndk_postError(tEventDllError* pDllEvent_p)
+{
+    UNUSED_PARAMETER(pDllEvent_p);
+    return kErrorOk;
+}
+
+tOplkError eventk_postEvent(tEvent* pEvent_p)
+{
+    UNUSED_PARAMETER(pEvent_p);
+    return kErrorOk;
+}
+
+tOplkError eventk_postError(tEventSource eventSource_p, tOplkError oplkError_p,
+                            UINT argSize_p, void* pArg_p)
+{
+    UNUSED_PARAMETER(eventSource_p);
+    UNUSED_PARAMETER(oplkError_p);
+    UNUSED_PARAMETER(argSize_p);
+    UNUSED_PARAMETER(pArg_p);
+    return kErrorOk;
+}
+
+tOplkError hrestimer_modifyTimer(tTimerHdl* pTimerHdl_p, ULONGLONG time_p,
+                                 tTimerkCallback pfnCallback_p, ULONG argument_p,
+                                 BOOL fContinue_p)
+{
+    UNUSED_PARAMETER(pTimerHdl_p);
+    UNUSED_PARAMETER(time_p);
+    UNUSED_PARAMETER(pfnCallback_p);
+    UNUSED_PARAMETER(argument_p);
+    UNUSED_PARAMETER(fContinue_p);
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
@@ -0,0 +1,276 @@
+/**
+********************************************************************************
+\file   qualify-edrv.c
+
+\brief  Ethernet driver test of the qualification tool
+
+The file contains the loopback test of the Ethernet driver reception path.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <unistd.h>
+
+#include <common/target.h>
+#include <common/ami.h>
+#include <kernel/edrv.h>
+
+#include "qualify.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define QUALIFY_EDRV_RX_NAME        "edrv.rxToDll"
+#define QUALIFY_EDRV_RTT_NAME       "edrv.txToRx"
+#define QUALIFY_EDRV_RX_BUDGET      10          // percent of the cycle
+
+#define QUALIFY_EDRV_FRAME_SIZE     60
+#define QUALIFY_EDRV_ETHERTYPE      0x88B5      // IEEE local experimental EtherType
+#define QUALIFY_EDRV_OFFS_TYPE      12
+#define QUALIFY_EDRV_OFFS_TXTIME    14
+
+#define QUALIFY_EDRV_DRAIN_MS       100         // time to receive the frames in flight
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Ethernet driver test instance
+
+The structure contains the state of the Ethernet driver loopback test.
+*/
+typedef struct
+{
+    tEdrvTxBuffer       txBuffer;           ///< Test frame
+    tQualifyResult*     pRxLatency;         ///< Result of the reception latency
+    tQualifyResult*     pRoundTrip;         ///< Result of the transmit to reception time
+    UINT                sentCount;          ///< Number of sent frames
+    volatile UINT       receivedCount;      ///< Number of received frames
+} tQualifyEdrvInstance;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void                 sendFrame(void* pArg_p, UINT64 now_p);
+static tEdrvReleaseRxBuffer cbFrameReceived(tEdrvRxBuffer* pRxBuffer_p);
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tQualifyEdrvInstance     instance_l;
+
+// Locally administered source MAC, the driver drops frames with its own MAC
+static const UINT8              aSrcMac_l[6] = {0x02, 0x00, 0x00, 0x51, 0xA1, 0xF7};
+static const UINT8              aDstMac_l[6] = {0x02, 0x00, 0x00, 0x51, 0xA1, 0xF8};
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Test the Ethernet driver reception path
+
+The test sends one frame in every cycle of the high-resolution timer and
+receives it through a loopback, which is the lo interface or a cable between
+two ports. The reception latency is the time from the kernel receive time
+stamp of the frame to the call of the Rx handler, i.e. the path a frame takes
+to the DLL. The transmit to reception time is recorded for information only,
+because it depends on the loopback.
+
+The test frames carry a locally administered source MAC address and a local
+experimental EtherType, so they don't disturb other devices. The driver
+ignores frames with its own source MAC address, therefore the frames can't
+use the MAC address of the interface.
+*/
+//------------------------------------------------------------------------------
+void qualifyedrv_test(void)
+{
+    const tQualifyConfig*   pConfig = qualify_getConfig();
+    tEdrvInitParam          initParam;
+    tOplkError              ret;
+
+    if (!qualify_isSelected(QUALIFY_EDRV_RX_NAME) && !qualify_isSelected(QUALIFY_EDRV_RTT_NAME))
+        return;
+
+    if (pConfig->pIfName == NULL)
+    {
+        qualify_skip(QUALIFY_EDRV_RX_NAME, "no interface specified");
+        qualify_skip(QUALIFY_EDRV_RTT_NAME, "no interface specified");
+        return;
+    }
+
+    OPLK_MEMSET(&instance_l, 0, sizeof(instance_l));
+    instance_l.pRxLatency = qualify_addResult(QUALIFY_EDRV_RX_NAME, QUALIFY_EDRV_RX_BUDGET, TRUE);
+    instance_l.pRoundTrip = qualify_addResult(QUALIFY_EDRV_RTT_NAME, 0, FALSE);
+    if ((instance_l.pRxLatency == NULL) || (instance_l.pRoundTrip == NULL))
+        return;
+
+    OPLK_MEMSET(&initParam, 0, sizeof(initParam));
+    initParam.pfnRxHandler = cbFrameReceived;
+    initParam.hwParam.pDevName = pConfig->pIfName;
+
+    ret = edrv_init(&initParam);
+    if (ret != kErrorOk)
+    {
+        qualify_fail(instance_l.pRxLatency, "unable to open the interface");
+        qualify_fail(instance_l.pRoundTrip, "unable to open the interface");
+        return;
+    }
+
+    instance_l.txBuffer.maxBufferSize = QUALIFY_EDRV_FRAME_SIZE;
+    ret = edrv_allocTxBuffer(&instance_l.txBuffer);
+    if (ret == kErrorOk)
+    {
+        OPLK_MEMSET(instance_l.txBuffer.pBuffer, 0, QUALIFY_EDRV_FRAME_SIZE);
+        OPLK_MEMCPY(instance_l.txBuffer.pBuffer, aDstMac_l, sizeof(aDstMac_l));
+        OPLK_MEMCPY(instance_l.txBuffer.pBuffer + 6, aSrcMac_l, sizeof(aSrcMac_l));
+        ami_setUint16Be(instance_l.txBuffer.pBuffer + QUALIFY_EDRV_OFFS_TYPE, QUALIFY_EDRV_ETHERTYPE);
+        instance_l.txBuffer.txFrameSize = QUALIFY_EDRV_FRAME_SIZE;
+
+        fprintf(stderr, "Running %s on %s\n", QUALIFY_EDRV_RX_NAME, pConfig->pIfName);
+        ret = qualifytimer_run(NULL, sendFrame, &instance_l);
+        target_msleep(QUALIFY_EDRV_DRAIN_MS);
+
+        if (ret != kErrorOk)
+        {
+            qualify_fail(instance_l.pRxLatency, "unable to start the high-resolution timer");
+            qualify_fail(instance_l.pRoundTrip, "unable to start the high-resolution timer");
+        }
+        else if (instance_l.receivedCount == 0)
+        {
+            qualify_fail(instance_l.pRxLatency, "no frame received, the interface needs a loopback");
+            qualify_fail(instance_l.pRoundTrip, "no frame received, the interface needs a loopback");
+        }
+        else if (instance_l.sentCount > instance_l.receivedCount)
+        {
+            instance_l.pRxLatency->lostCount = instance_l.sentCount - instance_l.receivedCount;
+            instance_l.pRoundTrip->lostCount = instance_l.pRxLatency->lostCount;
+        }
+    }
+    else
+    {
+        qualify_fail(instance_l.pRxLatency, "unable to allocate the Tx buffer");
+        qualify_fail(instance_l.pRoundTrip, "unable to allocate the Tx buffer");
+    }
+
+    edrv_shutdown();
+
+    if (instance_l.txBuffer.pBuffer != NULL)
+        edrv_freeTxBuffer(&instance_l.txBuffer);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send the test frame
+
+The function is called in every cycle of the high-resolution timer.
+
+\param  pArg_p              Pointer to the test instance.
+\param  now_p               Timestamp of the timer callback.
+*/
+//------------------------------------------------------------------------------
+static void sendFrame(void* pArg_p, UINT64 now_p)
+{
+    tQualifyEdrvInstance*   pInstance = (tQualifyEdrvInstance*)pArg_p;
+
+    ami_setUint64Le(pInstance->txBuffer.pBuffer + QUALIFY_EDRV_OFFS_TXTIME, now_p);
+
+    if (edrv_sendTxBuffer(&pInstance->txBuffer) == kErrorOk)
+        pInstance->sentCount++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Frame received callback
+
+\param  pRxBuffer_p         Pointer to the Rx buffer.
+
+\return The function returns a tEdrvReleaseRxBuffer flag.
+*/
+//------------------------------------------------------------------------------
+static tEdrvReleaseRxBuffer cbFrameReceived(tEdrvRxBuffer* pRxBuffer_p)
+{
+    UINT64  now;
+    UINT64  txTime;
+
+    now = target_getCurrentTimestamp();
+
+    if ((pRxBuffer_p->rxFrameSize < QUALIFY_EDRV_OFFS_TXTIME + sizeof(UINT64)) ||
+        (ami_getUint16Be(pRxBuffer_p->pBuffer + QUALIFY_EDRV_OFFS_TYPE) != QUALIFY_EDRV_ETHERTYPE) ||
+        (OPLK_MEMCMP(pRxBuffer_p->pBuffer + 6, aSrcMac_l, sizeof(aSrcMac_l)) != 0))
+        return kEdrvReleaseRxBufferImmediately;
+
+    instance_l.receivedCount++;
+
+    // the time stamp may only have 32 bit, the difference is small enough
+    if (pRxBuffer_p->pRxTimeStamp != NULL)
+    {
+        qualify_addSample(instance_l.pRxLatency,
+                          (UINT32)((TIME_STAMP_T)now - pRxBuffer_p->pRxTimeStamp->timeStamp));
+    }
+
+    txTime = ami_getUint64Le(pRxBuffer_p->pBuffer + QUALIFY_EDRV_OFFS_TXTIME);
+    qualify_addSample(instance_l.pRoundTrip, (UINT32)(now - txTime));
+
+    return kEdrvReleaseRxBufferImmediately;
+}
+
+/// \}
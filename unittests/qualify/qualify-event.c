@@ -0,0 +1,338 @@
+/**
+********************************************************************************
+\file   qualify-event.c
+
+\brief  Event test of the qualification tool
+
+The file contains the round trip test of the event queues between the user
+and the kernel layer. It implements the event handler functions which are
+called by the event CAL modules.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <time.h>
+#include <errno.h>
+#include <semaphore.h>
+
+#include <common/target.h>
+#include <kernel/eventk.h>
+#include <kernel/eventkcal.h>
+#include <user/eventu.h>
+#include <user/eventucal.h>
+
+#include "qualify.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define QUALIFY_EVENT_NAME          "event.roundTrip"
+#define QUALIFY_EVENT_BUDGET        100         // percent of the cycle
+#define QUALIFY_EVENT_TIMEOUT_MS    100         // an event taking longer is counted as lost
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Event test instance
+
+The structure contains the state of the event round trip test.
+*/
+typedef struct
+{
+    tQualifyResult*     pRoundTrip;         ///< Result of the round trip time
+    sem_t               semReply;           ///< Signaled if the reply event was received
+    BOOL                fRunning;           ///< The test is running
+} tQualifyEventInstance;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError postRequest(void);
+static void       addTimeNs(struct timespec* pTime_p, UINT64 timeNs_p);
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tQualifyEventInstance    instance_l;
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Test the event queue round trip
+
+The test posts an event from the user layer to the kernel layer once per
+cycle. The kernel event handler thread answers it with an event to the user
+layer. The round trip time is measured from posting the request until the
+user event handler thread processes the reply, so it contains both queues and
+the wake-up of both event threads. The requests are paced with the cycle time
+to measure the latency and not the throughput of the queues.
+*/
+//------------------------------------------------------------------------------
+void qualifyevent_test(void)
+{
+    const tQualifyConfig*   pConfig = qualify_getConfig();
+    struct timespec         next;
+    struct timespec         timeout;
+    UINT64                  cycleCount;
+    UINT64                  i;
+
+    if (!qualify_isSelected(QUALIFY_EVENT_NAME))
+        return;
+
+    OPLK_MEMSET(&instance_l, 0, sizeof(instance_l));
+    instance_l.pRoundTrip = qualify_addResult(QUALIFY_EVENT_NAME, QUALIFY_EVENT_BUDGET, FALSE);
+    if (instance_l.pRoundTrip == NULL)
+        return;
+
+    if (sem_init(&instance_l.semReply, 0, 0) != 0)
+    {
+        qualify_fail(instance_l.pRoundTrip, "unable to create the semaphore");
+        return;
+    }
+
+    // the kernel layer creates the shared queues
+    if (eventkcal_init() != kErrorOk)
+    {
+        qualify_fail(instance_l.pRoundTrip, "unable to initialize the kernel event queues");
+        sem_destroy(&instance_l.semReply);
+        return;
+    }
+
+    if (eventucal_init() != kErrorOk)
+    {
+        qualify_fail(instance_l.pRoundTrip, "unable to initialize the user event queues");
+        eventkcal_exit();
+        sem_destroy(&instance_l.semReply);
+        return;
+    }
+
+    fprintf(stderr, "Running %s\n", QUALIFY_EVENT_NAME);
+    instance_l.fRunning = TRUE;
+    cycleCount = ((UINT64)pConfig->durationS * 1000000ULL) / pConfig->cycleLenUs;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    for (i = 0; i < cycleCount; i++)
+    {
+        if (postRequest() != kErrorOk)
+        {
+            qualify_fail(instance_l.pRoundTrip, "unable to post the event");
+            break;
+        }
+
+        clock_gettime(CLOCK_REALTIME, &timeout);
+        addTimeNs(&timeout, QUALIFY_EVENT_TIMEOUT_MS * 1000000ULL);
+        while (sem_timedwait(&instance_l.semReply, &timeout) != 0)
+        {
+            if (errno != EINTR)
+            {
+                instance_l.pRoundTrip->lostCount++;
+                break;
+            }
+        }
+
+        addTimeNs(&next, (UINT64)pConfig->cycleLenUs * 1000ULL);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+
+    instance_l.fRunning = FALSE;
+    eventucal_exit();
+    eventkcal_exit();
+    sem_destroy(&instance_l.semReply);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process a kernel event
+
+The kernel event handler answers the request with an event to the user layer
+which carries the same time stamp.
+
+\param  pEvent_p            Event to process.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+tOplkError eventk_process(tEvent* pEvent_p)
+{
+    tEvent  event;
+
+    OPLK_MEMSET(&event, 0, sizeof(event));
+    event.eventSink = kEventSinkNmtu;
+    event.eventType = pEvent_p->eventType;
+    event.eventArgSize = pEvent_p->eventArgSize;
+    event.pEventArg = pEvent_p->pEventArg;
+
+    return eventkcal_postUserEvent(&event);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process a user event
+
+The user event handler records the round trip time of the reply.
+
+\param  pEvent_p            Event to process.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+tOplkError eventu_process(tEvent* pEvent_p)
+{
+    UINT64  now;
+    UINT64  postTime;
+
+    now = target_getCurrentTimestamp();
+
+    if (!instance_l.fRunning || (pEvent_p->eventArgSize != sizeof(postTime)))
+        return kErrorOk;
+
+    OPLK_MEMCPY(&postTime, pEvent_p->pEventArg, sizeof(postTime));
+    qualify_addSample(instance_l.pRoundTrip, (UINT32)(now - postTime));
+    sem_post(&instance_l.semReply);
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Post an error event from the kernel layer
+
+\param  eventSource_p       Source of the error.
+\param  oplkError_p         Error code.
+\param  argSize_p           Size of the error argument.
+\param  pArg_p              Pointer to the error argument.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+tOplkError eventk_postError(tEventSource eventSource_p, tOplkError oplkError_p,
+                            UINT argSize_p, void* pArg_p)
+{
+    UNUSED_PARAMETER(argSize_p);
+    UNUSED_PARAMETER(pArg_p);
+
+    fprintf(stderr, "Kernel event error 0x%04X from source 0x%02X\n", oplkError_p, eventSource_p);
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Post an error event from the user layer
+
+\param  eventSource_p       Source of the error.
+\param  oplkError_p         Error code.
+\param  argSize_p           Size of the error argument.
+\param  pArg_p              Pointer to the error argument.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+tOplkError eventu_postError(tEventSource eventSource_p, tOplkError oplkError_p,
+                            UINT argSize_p, void* pArg_p)
+{
+    UNUSED_PARAMETER(argSize_p);
+    UNUSED_PARAMETER(pArg_p);
+
+    fprintf(stderr, "User event error 0x%04X from source 0x%02X\n", oplkError_p, eventSource_p);
+    return kErrorOk;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Post the request event
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError postRequest(void)
+{
+    tEvent  event;
+    UINT64  postTime;
+
+    OPLK_MEMSET(&event, 0, sizeof(event));
+    event.eventSink = kEventSinkDllk;
+    event.eventType = kEventTypeTimer;
+    event.eventArgSize = sizeof(postTime);
+    event.pEventArg = &postTime;
+
+    postTime = target_getCurrentTimestamp();
+    return eventucal_postKernelEvent(&event);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add a time to a timespec
+
+\param  pTime_p             Time to add to.
+\param  timeNs_p            Time to add in ns.
+*/
+//------------------------------------------------------------------------------
+static void addTimeNs(struct timespec* pTime_p, UINT64 timeNs_p)
+{
+    timeNs_p += pTime_p->tv_nsec;
+    pTime_p->tv_sec += (time_t)(timeNs_p / 1000000000ULL);
+    pTime_p->tv_nsec = (long)(timeNs_p % 1000000000ULL);
+}
+
+/// \}
@@ -0,0 +1,223 @@
+/**
+********************************************************************************
+\file   qualify-load.c
+
+\brief  Background load of the qualification tool
+
+The file contains the threads which generate CPU or memory load while the
+tests are running.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "qualify.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define QUALIFY_LOAD_MAX_THREADS    64
+#define QUALIFY_LOAD_MEM_SIZE       (32 * 1024 * 1024)  // exceeds the caches of usual CPUs
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Background load instance
+
+The structure contains the threads of the background load.
+*/
+typedef struct
+{
+    pthread_t           aThread[QUALIFY_LOAD_MAX_THREADS];  ///< Load threads
+    UINT                threadCount;                        ///< Number of started threads
+    volatile BOOL       fStop;                              ///< Stop the load threads
+} tQualifyLoadInstance;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void* cpuLoadThread(void* pArg_p);
+static void* memoryLoadThread(void* pArg_p);
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tQualifyLoadInstance     instance_l;
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Start the background load
+
+The function starts the configured number of load threads. They run with the
+default scheduling policy, so they compete with the non real-time part of the
+system while the threads of the stack are preempting them.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+tOplkError qualifyload_start(void)
+{
+    const tQualifyConfig*   pConfig = qualify_getConfig();
+    void*                   (*pfnThread)(void*);
+
+    instance_l.fStop = FALSE;
+    instance_l.threadCount = 0;
+
+    if (pConfig->loadThreadCount > QUALIFY_LOAD_MAX_THREADS)
+        return kErrorInvalidOperation;
+
+    pfnThread = (pConfig->loadType == kQualifyLoadMemory) ? memoryLoadThread : cpuLoadThread;
+
+    while (instance_l.threadCount < pConfig->loadThreadCount)
+    {
+        if (pthread_create(&instance_l.aThread[instance_l.threadCount], NULL, pfnThread, NULL) != 0)
+        {
+            qualifyload_stop();
+            return kErrorNoResource;
+        }
+
+        instance_l.threadCount++;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Stop the background load
+
+The function stops all load threads and waits until they are finished.
+*/
+//------------------------------------------------------------------------------
+void qualifyload_stop(void)
+{
+    UINT    i;
+
+    instance_l.fStop = TRUE;
+
+    for (i = 0; i < instance_l.threadCount; i++)
+        pthread_join(instance_l.aThread[i], NULL);
+
+    instance_l.threadCount = 0;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  CPU load thread
+
+\param  pArg_p              Thread argument, not used.
+
+\return The function returns the thread exit code.
+*/
+//------------------------------------------------------------------------------
+static void* cpuLoadThread(void* pArg_p)
+{
+    volatile UINT32 value = 0;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    while (!instance_l.fStop)
+        value = value * 1103515245UL + 12345UL;
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Memory load thread
+
+The thread copies between two buffers which don't fit into the caches, so it
+loads the memory bus and evicts the data of the stack from the caches.
+
+\param  pArg_p              Thread argument, not used.
+
+\return The function returns the thread exit code.
+*/
+//------------------------------------------------------------------------------
+static void* memoryLoadThread(void* pArg_p)
+{
+    BYTE*   pBuffer;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    pBuffer = (BYTE*)malloc(2 * QUALIFY_LOAD_MEM_SIZE);
+    if (pBuffer == NULL)
+        return NULL;
+
+    memset(pBuffer, 0x55, 2 * QUALIFY_LOAD_MEM_SIZE);
+
+    while (!instance_l.fStop)
+    {
+        memcpy(pBuffer + QUALIFY_LOAD_MEM_SIZE, pBuffer, QUALIFY_LOAD_MEM_SIZE);
+        memcpy(pBuffer, pBuffer + QUALIFY_LOAD_MEM_SIZE, QUALIFY_LOAD_MEM_SIZE);
+    }
+
+    free(pBuffer);
+    return NULL;
+}
+
+/// \}
@@ -0,0 +1,264 @@
+/**
+********************************************************************************
+\file   qualify-pdo.c
+
+\brief  PDO test of the qualification tool
+
+The file contains the test of the PDO exchange through the triple buffers
+of the kernel and the user layer.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <common/target.h>
+#include <common/pdo.h>
+#include <kernel/pdokcal.h>
+#include <user/pdoucal.h>
+
+#include "qualify.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define QUALIFY_PDO_NAME            "pdo.exchange"
+#define QUALIFY_PDO_BUDGET          25          // percent of the cycle
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  PDO test instance
+
+The structure contains the state of the PDO exchange test.
+*/
+typedef struct
+{
+    tQualifyResult*     pExchange;          ///< Result of the exchange time
+    tPdoChannelSetup    channelSetup;       ///< Channels of the PDO memory
+    UINT                channelCount;       ///< Number of RPDO and TPDO channels
+    WORD                pdoSize;            ///< Size of one PDO
+    BYTE*               pFrame;             ///< Payload of the emulated frames
+    BYTE*               pProcessImage;      ///< Emulated process image
+} tQualifyPdoInstance;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError setupChannels(tQualifyPdoInstance* pInstance_p);
+static void       exchangePdos(void* pArg_p, UINT64 now_p);
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tQualifyPdoInstance  instance_l;
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Test the PDO exchange
+
+The test exchanges all RPDOs and TPDOs through the triple buffers of the
+stack in every cycle of the high-resolution timer. An MN with the configured
+number of CNs and PDO size is emulated: the kernel layer writes every RPDO as
+it would be received and reads every TPDO as it would be sent, the user layer
+copies the RPDOs to and the TPDOs from a process image. The exchange time is
+the sum of both layers, which run in different threads in the stack.
+*/
+//------------------------------------------------------------------------------
+void qualifypdo_test(void)
+{
+    const tQualifyConfig*   pConfig = qualify_getConfig();
+    tOplkError              ret;
+
+    if (!qualify_isSelected(QUALIFY_PDO_NAME))
+        return;
+
+    OPLK_MEMSET(&instance_l, 0, sizeof(instance_l));
+    instance_l.channelCount = pConfig->pdoChannelCount;
+    instance_l.pdoSize = (WORD)pConfig->pdoSize;
+
+    instance_l.pExchange = qualify_addResult(QUALIFY_PDO_NAME, QUALIFY_PDO_BUDGET, TRUE);
+    if (instance_l.pExchange == NULL)
+        return;
+
+    ret = setupChannels(&instance_l);
+    if (ret == kErrorOk)
+    {
+        fprintf(stderr, "Running %s with %u channels of %u bytes\n",
+                QUALIFY_PDO_NAME, instance_l.channelCount, instance_l.pdoSize);
+        if (qualifytimer_run(NULL, exchangePdos, &instance_l) != kErrorOk)
+            qualify_fail(instance_l.pExchange, "unable to start the high-resolution timer");
+
+        pdoucal_cleanupPdoMem();
+        pdokcal_cleanupPdoMem();
+    }
+    else
+        qualify_fail(instance_l.pExchange, "unable to set up the PDO memory");
+
+    free(instance_l.channelSetup.pRxPdoChannel);
+    free(instance_l.channelSetup.pTxPdoChannel);
+    free(instance_l.pFrame);
+    free(instance_l.pProcessImage);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set up the PDO channels
+
+The function sets up the channels and the PDO memory of the kernel and the
+user layer like the PDO modules do it after the mapping was configured.
+
+\param  pInstance_p         Pointer to the test instance.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError setupChannels(tQualifyPdoInstance* pInstance_p)
+{
+    tOplkError  ret;
+    size_t      rxPdoMemSize;
+    size_t      txPdoMemSize;
+    UINT        channelId;
+
+    pInstance_p->channelSetup.allocation.rxPdoChannelCount = pInstance_p->channelCount;
+    pInstance_p->channelSetup.allocation.txPdoChannelCount = pInstance_p->channelCount;
+    pInstance_p->channelSetup.pRxPdoChannel = (tPdoChannel*)calloc(pInstance_p->channelCount,
+                                                                   sizeof(tPdoChannel));
+    pInstance_p->channelSetup.pTxPdoChannel = (tPdoChannel*)calloc(pInstance_p->channelCount,
+                                                                   sizeof(tPdoChannel));
+    pInstance_p->pFrame = (BYTE*)calloc(1, pInstance_p->pdoSize);
+    pInstance_p->pProcessImage = (BYTE*)calloc(pInstance_p->channelCount, pInstance_p->pdoSize);
+    if ((pInstance_p->channelSetup.pRxPdoChannel == NULL) ||
+        (pInstance_p->channelSetup.pTxPdoChannel == NULL) ||
+        (pInstance_p->pFrame == NULL) || (pInstance_p->pProcessImage == NULL))
+        return kErrorNoResource;
+
+    for (channelId = 0; channelId < pInstance_p->channelCount; channelId++)
+    {
+        pInstance_p->channelSetup.pRxPdoChannel[channelId].nodeId = channelId + 1;
+        pInstance_p->channelSetup.pRxPdoChannel[channelId].pdoSize = pInstance_p->pdoSize;
+        pInstance_p->channelSetup.pTxPdoChannel[channelId].nodeId = channelId + 1;
+        pInstance_p->channelSetup.pTxPdoChannel[channelId].pdoSize = pInstance_p->pdoSize;
+    }
+
+    rxPdoMemSize = pInstance_p->channelCount * PDO_ALIGN_CACHE_LINE(pInstance_p->pdoSize);
+    txPdoMemSize = pInstance_p->channelCount * PDO_TX_BUFFER_SIZE(pInstance_p->pdoSize);
+
+    // the kernel layer allocates the memory which is mapped by the user layer
+    ret = pdokcal_initPdoMem(&pInstance_p->channelSetup, rxPdoMemSize, txPdoMemSize);
+    if (ret != kErrorOk)
+        return ret;
+
+    ret = pdoucal_initPdoMem(&pInstance_p->channelSetup, rxPdoMemSize, txPdoMemSize);
+    if (ret != kErrorOk)
+        pdokcal_cleanupPdoMem();
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Exchange all PDOs
+
+The function is called in every cycle of the high-resolution timer.
+
+\param  pArg_p              Pointer to the test instance.
+\param  now_p               Timestamp of the timer callback.
+*/
+//------------------------------------------------------------------------------
+static void exchangePdos(void* pArg_p, UINT64 now_p)
+{
+    tQualifyPdoInstance*    pInstance = (tQualifyPdoInstance*)pArg_p;
+    BYTE*                   pPdo;
+    BYTE*                   pVar;
+    UINT                    channelId;
+
+    // kernel layer: RPDOs received in this cycle
+    for (channelId = 0; channelId < pInstance->channelCount; channelId++)
+        pdokcal_writeRxPdo(channelId, pInstance->pFrame, pInstance->pdoSize);
+
+    // user layer: copy RPDOs to and TPDOs from the process image
+    for (channelId = 0, pVar = pInstance->pProcessImage; channelId < pInstance->channelCount;
+         channelId++, pVar += pInstance->pdoSize)
+    {
+        if (pdoucal_getRxPdo(&pPdo, channelId, pInstance->pdoSize) == kErrorOk)
+            OPLK_MEMCPY(pVar, pPdo, pInstance->pdoSize);
+
+        pPdo = pdoucal_getTxPdoAdrs(channelId);
+        if (pPdo == NULL)
+            continue;
+
+        OPLK_MEMCPY(pPdo, pVar, pInstance->pdoSize);
+        pdoucal_setTxPdo(channelId, pPdo, pInstance->pdoSize);
+    }
+
+    // kernel layer: TPDOs sent in the next cycle
+    for (channelId = 0; channelId < pInstance->channelCount; channelId++)
+        pdokcal_readTxPdo(channelId, pInstance->pFrame, pInstance->pdoSize);
+
+    qualify_addSample(pInstance->pExchange, (UINT32)(target_getCurrentTimestamp() - now_p));
+}
+
+/// \}
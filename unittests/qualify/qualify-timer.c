@@ -0,0 +1,239 @@
+/**
+********************************************************************************
+\file   qualify-timer.c
+
+\brief  Timer tests of the qualification tool
+
+The file contains the cyclic high-resolution timer which drives the cyclic
+tests and the test of the timer wake-up latency.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <unistd.h>
+
+#include <common/target.h>
+#include <kernel/hrestimer.h>
+
+#include "qualify.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define QUALIFY_TIMER_NAME          "timer.wakeup"
+#define QUALIFY_TIMER_BUDGET        10          // percent of the cycle
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Cyclic timer run
+
+The structure contains the state of one run of the cyclic timer.
+*/
+typedef struct
+{
+    tQualifyResult*     pLatency;           ///< Result of the wake-up latency, may be NULL
+    tQualifyCycleHook   pfnHook;            ///< Function called in every cycle, may be NULL
+    void*               pHookArg;           ///< Argument of the hook
+    UINT64              startTime;          ///< Timestamp the timer was started at
+    UINT64              period;             ///< Cycle time in ns
+    UINT64              lastCycle;          ///< Number of the last handled cycle
+    volatile BOOL       fStop;              ///< Ignore further expirations
+} tQualifyTimerRun;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tOplkError cbTimer(tTimerEventArg* pEventArg_p);
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tQualifyTimerRun     run_l;
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Run the cyclic timer
+
+The function starts a cyclic high-resolution timer with the target cycle time
+and lets it run for the test duration. In every cycle the wake-up latency is
+stored and the hook is called from the timer callback, i.e. in the same
+context the DLL starts a cycle of the MN.
+
+The hrestimer keeps the phase of the cycle, so the deadline of cycle n is the
+start time plus n cycle times. The start time is taken before the timer is
+set up, therefore the latency includes a bias of less than a microsecond.
+If a callback is more than a cycle late, the hrestimer skips the missed
+expirations. The latency of such a callback is taken relative to the deadline
+it was meant for and the skipped cycles are counted as lost.
+
+\param  pLatency_p          Result which receives the wake-up latencies, may be
+                            NULL.
+\param  pfnHook_p           Function called in every cycle, may be NULL.
+\param  pArg_p              Argument of the hook.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+tOplkError qualifytimer_run(tQualifyResult* pLatency_p, tQualifyCycleHook pfnHook_p, void* pArg_p)
+{
+    const tQualifyConfig*   pConfig = qualify_getConfig();
+    tOplkError              ret;
+    tTimerHdl               timerHdl = 0;
+
+    ret = hrestimer_init();
+    if (ret != kErrorOk)
+        return ret;
+
+    run_l.pLatency = pLatency_p;
+    run_l.pfnHook = pfnHook_p;
+    run_l.pHookArg = pArg_p;
+    run_l.period = (UINT64)pConfig->cycleLenUs * 1000ULL;
+    run_l.lastCycle = 0;
+    run_l.fStop = FALSE;
+    run_l.startTime = target_getCurrentTimestamp();
+
+    ret = hrestimer_modifyTimer(&timerHdl, run_l.period, cbTimer, 0, TRUE);
+    if (ret == kErrorOk)
+    {
+        sleep(pConfig->durationS);
+
+        run_l.fStop = TRUE;
+        hrestimer_deleteTimer(&timerHdl);
+    }
+
+    hrestimer_delInstance();
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Test the timer wake-up latency
+
+The test measures the latency of the high-resolution timer callback relative
+to its deadline. The hrestimer busy-waits for the deadline after it was woken
+up, so the latency contains the part of the wake-up which exceeds the busy
+wait time and the dispatch of the callback.
+*/
+//------------------------------------------------------------------------------
+void qualifytimer_test(void)
+{
+    tQualifyResult* pResult;
+
+    if (!qualify_isSelected(QUALIFY_TIMER_NAME))
+        return;
+
+    pResult = qualify_addResult(QUALIFY_TIMER_NAME, QUALIFY_TIMER_BUDGET, TRUE);
+    if (pResult == NULL)
+        return;
+
+    fprintf(stderr, "Running %s\n", QUALIFY_TIMER_NAME);
+    if (qualifytimer_run(pResult, NULL, NULL) != kErrorOk)
+        qualify_fail(pResult, "unable to start the high-resolution timer");
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Timer callback
+
+\param  pEventArg_p         Timer event argument.
+
+\return The function returns a tOplkError error code.
+*/
+//------------------------------------------------------------------------------
+static tOplkError cbTimer(tTimerEventArg* pEventArg_p)
+{
+    UINT64  now;
+    UINT64  cycle;
+    UINT64  expectedCycle;
+
+    UNUSED_PARAMETER(pEventArg_p);
+
+    now = target_getCurrentTimestamp();
+    if (run_l.fStop)
+        return kErrorOk;
+
+    // a callback later than a cycle belongs to the first cycle after the last one
+    cycle = (now - run_l.startTime) / run_l.period;
+    expectedCycle = run_l.lastCycle + 1;
+    if (cycle < expectedCycle)
+        expectedCycle = cycle;
+
+    if (run_l.pLatency != NULL)
+    {
+        run_l.pLatency->lostCount += (UINT)(cycle - expectedCycle);
+        qualify_addSample(run_l.pLatency,
+                          (UINT32)(now - run_l.startTime - (expectedCycle * run_l.period)));
+    }
+    run_l.lastCycle = cycle;
+
+    if (run_l.pfnHook != NULL)
+        run_l.pfnHook(run_l.pHookArg, now);
+
+    return kErrorOk;
+}
+
+/// \}
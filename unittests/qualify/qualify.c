@@ -0,0 +1,690 @@
+/**
+********************************************************************************
+\file   qualify.c
+
+\brief  Main module of the openPOWERLINK target qualification tool
+
+The qualification tool measures the latencies of the stack's real-time paths
+on the target with its own high-resolution timer, Ethernet driver, event and
+PDO CAL implementations, optionally under background load. The worst cases
+are checked against budgets of the target cycle time, which results in a
+pass/fail recommendation and the shortest cycle time the target can meet.
+
+The tool uses the same shared memory and semaphore names as the stack, so it
+must not run while an openPOWERLINK application is running. It needs real-time
+scheduling privileges to measure the latencies the stack would see.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/utsname.h>
+
+#include <common/target.h>
+
+#include "qualify.h"
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define QUALIFY_MAX_RESULTS             16
+#define QUALIFY_DEFAULT_CYCLE_US        1000
+#define QUALIFY_DEFAULT_DURATION_S      10
+#define QUALIFY_DEFAULT_PDO_CHANNELS    10
+#define QUALIFY_DEFAULT_PDO_SIZE        36
+#define QUALIFY_MIN_CYCLE_US            100
+#define QUALIFY_CYCLE_BUDGET_PERCENT    50      // share of the cycle the cyclic paths may use together
+#define QUALIFY_CYCLE_ROUNDING_US       50      // granularity of the recommended cycle time
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Qualification instance
+
+The structure contains the options and the results of the qualification run.
+*/
+typedef struct
+{
+    tQualifyConfig  config;                 ///< Options of the run
+    UINT            resultCount;            ///< Number of stored results
+    tQualifyResult  aResult[QUALIFY_MAX_RESULTS]; ///< Results of the executed tests
+    UINT32          cyclicPercent;          ///< Share of the cycle used by the cyclic paths together
+    UINT32          recommendedCycleUs;     ///< Shortest cycle time all budgets are met with
+    BOOL            fPass;                  ///< The target cycle time can be met
+} tQualifyInstance;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tQualifyResult* allocResult(const char* pName_p);
+static void            evaluateResult(tQualifyResult* pResult_p);
+static void            evaluateRun(void);
+static int             compareUint32(const void* pA_p, const void* pB_p);
+static void            printSummary(void);
+static void            writeJson(FILE* pFile_p);
+static void            usage(const char* pProgName_p);
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tQualifyInstance     instance_l;
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief  Main function of the qualification tool
+
+The function parses the command line options, starts the background load,
+runs all tests and writes the results and the recommendation.
+
+\param  argc            Number of arguments
+\param  argv            Pointer to arguments
+
+\return The function returns 0 if the target cycle time can be met, otherwise 1.
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    const char* pOutFile = NULL;
+    const char* pLoad = "cpu";
+    FILE*       pFile;
+    UINT        i;
+    int         opt;
+
+    instance_l.config.cycleLenUs = QUALIFY_DEFAULT_CYCLE_US;
+    instance_l.config.durationS = QUALIFY_DEFAULT_DURATION_S;
+    instance_l.config.pdoChannelCount = QUALIFY_DEFAULT_PDO_CHANNELS;
+    instance_l.config.pdoSize = QUALIFY_DEFAULT_PDO_SIZE;
+
+    while ((opt = getopt(argc, argv, "c:d:i:l:L:n:s:o:f:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'c':
+                instance_l.config.cycleLenUs = (UINT32)strtoul(optarg, NULL, 0);
+                break;
+
+            case 'd':
+                instance_l.config.durationS = (UINT32)strtoul(optarg, NULL, 0);
+                break;
+
+            case 'i':
+                instance_l.config.pIfName = optarg;
+                break;
+
+            case 'l':
+                instance_l.config.loadThreadCount = (UINT)strtoul(optarg, NULL, 0);
+                break;
+
+            case 'L':
+                pLoad = optarg;
+                break;
+
+            case 'n':
+                instance_l.config.pdoChannelCount = (UINT)strtoul(optarg, NULL, 0);
+                break;
+
+            case 's':
+                instance_l.config.pdoSize = (UINT)strtoul(optarg, NULL, 0);
+                break;
+
+            case 'o':
+                pOutFile = optarg;
+                break;
+
+            case 'f':
+                instance_l.config.pFilter = optarg;
+                break;
+
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (strcmp(pLoad, "cpu") == 0)
+        instance_l.config.loadType = kQualifyLoadCpu;
+    else if (strcmp(pLoad, "mem") == 0)
+        instance_l.config.loadType = kQualifyLoadMemory;
+    else
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if ((instance_l.config.cycleLenUs < QUALIFY_MIN_CYCLE_US) ||
+        (instance_l.config.durationS == 0) ||
+        (instance_l.config.pdoChannelCount == 0) ||
+        (instance_l.config.pdoChannelCount > D_PDO_RPDOChannels_U16) ||
+        (instance_l.config.pdoChannelCount > D_PDO_TPDOChannels_U16) ||
+        (instance_l.config.pdoSize == 0) ||
+        (instance_l.config.pdoSize > C_DLL_ISOCHR_MAX_PAYL))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (target_init() != kErrorOk)
+    {
+        fprintf(stderr, "Unable to initialize the target\n");
+        return 1;
+    }
+
+    fprintf(stderr, "Qualifying for a cycle time of %lu us, %lu s per test, %u %s load threads\n",
+            (ULONG)instance_l.config.cycleLenUs, (ULONG)instance_l.config.durationS,
+            instance_l.config.loadThreadCount, pLoad);
+
+    if (qualifyload_start() != kErrorOk)
+    {
+        fprintf(stderr, "Unable to start the background load\n");
+        target_cleanup();
+        return 1;
+    }
+
+    qualifytimer_test();
+    qualifyedrv_test();
+    qualifyevent_test();
+    qualifypdo_test();
+
+    qualifyload_stop();
+    target_cleanup();
+
+    for (i = 0; i < instance_l.resultCount; i++)
+        evaluateResult(&instance_l.aResult[i]);
+
+    evaluateRun();
+    printSummary();
+
+    if (pOutFile != NULL)
+    {
+        pFile = fopen(pOutFile, "w");
+        if (pFile == NULL)
+        {
+            fprintf(stderr, "Unable to open %s\n", pOutFile);
+            return 1;
+        }
+    }
+    else
+        pFile = stdout;
+
+    writeJson(pFile);
+
+    if (pFile != stdout)
+        fclose(pFile);
+
+    for (i = 0; i < instance_l.resultCount; i++)
+        free(instance_l.aResult[i].paSample);
+
+    return instance_l.fPass ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get the options of the run
+
+\return The function returns a pointer to the options.
+*/
+//------------------------------------------------------------------------------
+const tQualifyConfig* qualify_getConfig(void)
+{
+    return &instance_l.config;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Check if a test is selected
+
+\param  pName_p             Name of the test.
+
+\return The function returns TRUE if the test matches the filter.
+*/
+//------------------------------------------------------------------------------
+BOOL qualify_isSelected(const char* pName_p)
+{
+    return (instance_l.config.pFilter == NULL) ||
+           (strstr(pName_p, instance_l.config.pFilter) != NULL);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Add a latency result
+
+The function adds a result with room for one sample per cycle of the test
+duration.
+
+\param  pName_p             Name of the test (must be a static string).
+\param  budgetPercent_p     Share of the cycle time the worst case latency
+                            may use. 0 if the result is only informational.
+\param  fCyclic_p           TRUE if the path is executed in every cycle.
+
+\return The function returns a pointer to the result or NULL if it could not
+        be allocated.
+*/
+//------------------------------------------------------------------------------
+tQualifyResult* qualify_addResult(const char* pName_p, UINT budgetPercent_p, BOOL fCyclic_p)
+{
+    tQualifyResult* pResult;
+
+    pResult = allocResult(pName_p);
+    if (pResult == NULL)
+        return NULL;
+
+    pResult->budgetPercent = budgetPercent_p;
+    pResult->fCyclic = fCyclic_p;
+    pResult->capacity = (UINT)(((UINT64)instance_l.config.durationS * 1000000ULL) /
+                               instance_l.config.cycleLenUs) + 1;
+    pResult->paSample = (UINT32*)malloc(pResult->capacity * sizeof(UINT32));
+    if (pResult->paSample == NULL)
+    {
+        qualify_fail(pResult, "out of memory");
+        return NULL;
+    }
+
+    return pResult;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Store a latency sample
+
+The function is called from the measured context, therefore it only stores
+the sample. Samples exceeding the capacity are dropped.
+
+\param  pResult_p           Result to store the sample in.
+\param  latencyNs_p         Measured latency in ns.
+*/
+//------------------------------------------------------------------------------
+void qualify_addSample(tQualifyResult* pResult_p, UINT32 latencyNs_p)
+{
+    if (pResult_p->count < pResult_p->capacity)
+    {
+        pResult_p->paSample[pResult_p->count] = latencyNs_p;
+        pResult_p->count++;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Report a skipped test
+
+Skipped tests don't affect the verdict, but they are listed in the results so
+an incomplete qualification is visible.
+
+\param  pName_p             Name of the test (must be a static string).
+\param  pReason_p           Reason why the test was skipped (must be a static
+                            string).
+*/
+//------------------------------------------------------------------------------
+void qualify_skip(const char* pName_p, const char* pReason_p)
+{
+    tQualifyResult* pResult;
+
+    if (!qualify_isSelected(pName_p))
+        return;
+
+    pResult = allocResult(pName_p);
+    if (pResult == NULL)
+        return;
+
+    pResult->pSkipReason = pReason_p;
+    fprintf(stderr, "%-24s SKIPPED: %s\n", pName_p, pReason_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Report a test which failed to run
+
+The test fails the qualification.
+
+\param  pResult_p           Result of the test.
+\param  pReason_p           Reason of the failure (must be a static string).
+*/
+//------------------------------------------------------------------------------
+void qualify_fail(tQualifyResult* pResult_p, const char* pReason_p)
+{
+    pResult_p->pError = pReason_p;
+    fprintf(stderr, "%-24s FAILED: %s\n", pResult_p->pName, pReason_p);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief  Allocate a result entry
+
+\param  pName_p             Name of the test.
+
+\return The function returns a pointer to the zeroed result entry or NULL if
+        the result table is full.
+*/
+//------------------------------------------------------------------------------
+static tQualifyResult* allocResult(const char* pName_p)
+{
+    tQualifyResult* pResult;
+
+    if (instance_l.resultCount >= QUALIFY_MAX_RESULTS)
+    {
+        fprintf(stderr, "Too many tests, %s skipped\n", pName_p);
+        return NULL;
+    }
+
+    pResult = &instance_l.aResult[instance_l.resultCount++];
+    memset(pResult, 0, sizeof(tQualifyResult));
+    pResult->pName = pName_p;
+
+    return pResult;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Evaluate a result
+
+The function calculates the statistics of the samples and checks the worst
+case against the budget of the test. Lost samples fail the test, because they
+mean that a deadline was missed completely.
+
+\param  pResult_p           Result to evaluate.
+*/
+//------------------------------------------------------------------------------
+static void evaluateResult(tQualifyResult* pResult_p)
+{
+    UINT64  sum = 0;
+    UINT64  budgetNs;
+    UINT    count = pResult_p->count;
+    UINT    i;
+
+    if ((pResult_p->pSkipReason != NULL) || (pResult_p->pError != NULL))
+        return;
+
+    if (count == 0)
+    {
+        qualify_fail(pResult_p, "no samples");
+        return;
+    }
+
+    qsort(pResult_p->paSample, count, sizeof(UINT32), compareUint32);
+
+    for (i = 0; i < count; i++)
+        sum += pResult_p->paSample[i];
+
+    pResult_p->minNs = pResult_p->paSample[0];
+    pResult_p->meanNs = (UINT32)(sum / count);
+    pResult_p->p99Ns = pResult_p->paSample[(UINT)(((UINT64)count * 99) / 100)];
+    pResult_p->p999Ns = pResult_p->paSample[(UINT)(((UINT64)count * 999) / 1000)];
+    pResult_p->maxNs = pResult_p->paSample[count - 1];
+
+    budgetNs = (UINT64)instance_l.config.cycleLenUs * 10 * pResult_p->budgetPercent;
+    pResult_p->fPass = (pResult_p->lostCount == 0) &&
+                       ((pResult_p->budgetPercent == 0) || (pResult_p->maxNs <= budgetNs));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Evaluate the run
+
+The target cycle time is met if every test stays within its own budget and the
+worst cases of the paths which are executed in every cycle (timer, Ethernet
+driver and PDO exchange) together use at most QUALIFY_CYCLE_BUDGET_PERCENT of
+the cycle. The event round trip is not part of the sum, because asynchronous
+events only have to be handled within one cycle.
+
+The recommended cycle time is the shortest one which meets all budgets with
+the measured worst cases, rounded up to QUALIFY_CYCLE_ROUNDING_US.
+*/
+//------------------------------------------------------------------------------
+static void evaluateRun(void)
+{
+    tQualifyResult* pResult;
+    UINT64          cyclicNs = 0;
+    UINT64          minCycleNs = 0;
+    UINT64          cycleNs;
+    UINT            i;
+
+    instance_l.fPass = TRUE;
+
+    for (i = 0; i < instance_l.resultCount; i++)
+    {
+        pResult = &instance_l.aResult[i];
+        if (pResult->pSkipReason != NULL)
+            continue;
+
+        if ((pResult->pError != NULL) || !pResult->fPass)
+            instance_l.fPass = FALSE;
+
+        if ((pResult->pError != NULL) || (pResult->budgetPercent == 0))
+            continue;
+
+        cycleNs = ((UINT64)pResult->maxNs * 100) / pResult->budgetPercent;
+        if (cycleNs > minCycleNs)
+            minCycleNs = cycleNs;
+
+        if (pResult->fCyclic)
+            cyclicNs += pResult->maxNs;
+    }
+
+    cycleNs = (cyclicNs * 100) / QUALIFY_CYCLE_BUDGET_PERCENT;
+    if (cycleNs > minCycleNs)
+        minCycleNs = cycleNs;
+
+    instance_l.cyclicPercent = (UINT32)((cyclicNs / 10) / instance_l.config.cycleLenUs);
+    if (instance_l.cyclicPercent > QUALIFY_CYCLE_BUDGET_PERCENT)
+        instance_l.fPass = FALSE;
+
+    instance_l.recommendedCycleUs = (UINT32)((minCycleNs + (QUALIFY_CYCLE_ROUNDING_US * 1000) - 1) /
+                                             (QUALIFY_CYCLE_ROUNDING_US * 1000)) *
+                                    QUALIFY_CYCLE_ROUNDING_US;
+    if (instance_l.recommendedCycleUs < QUALIFY_MIN_CYCLE_US)
+        instance_l.recommendedCycleUs = QUALIFY_MIN_CYCLE_US;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Compare two UINT32 values for qsort()
+
+\param  pA_p                Pointer to first value.
+\param  pB_p                Pointer to second value.
+
+\return The function returns -1, 0 or 1.
+*/
+//------------------------------------------------------------------------------
+static int compareUint32(const void* pA_p, const void* pB_p)
+{
+    UINT32  a = *(const UINT32*)pA_p;
+    UINT32  b = *(const UINT32*)pB_p;
+
+    return (a > b) - (a < b);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print the results
+
+The function prints the statistics of all tests and the verdict to stderr.
+*/
+//------------------------------------------------------------------------------
+static void printSummary(void)
+{
+    tQualifyResult* pResult;
+    UINT            i;
+
+    fprintf(stderr, "\n%-24s %9s %9s %9s %9s %9s %6s %7s\n",
+            "Test [us]", "min", "mean", "p99", "p99.9", "max", "budget", "result");
+
+    for (i = 0; i < instance_l.resultCount; i++)
+    {
+        pResult = &instance_l.aResult[i];
+        if ((pResult->pSkipReason != NULL) || (pResult->pError != NULL))
+        {
+            fprintf(stderr, "%-24s %s\n", pResult->pName,
+                    (pResult->pSkipReason != NULL) ? "skipped" : "error");
+            continue;
+        }
+
+        fprintf(stderr, "%-24s %9.1f %9.1f %9.1f %9.1f %9.1f %5u%% %7s",
+                pResult->pName, pResult->minNs / 1000.0, pResult->meanNs / 1000.0,
+                pResult->p99Ns / 1000.0, pResult->p999Ns / 1000.0, pResult->maxNs / 1000.0,
+                pResult->budgetPercent, pResult->fPass ? "pass" : "FAIL");
+        if (pResult->lostCount != 0)
+            fprintf(stderr, " (%u lost)", pResult->lostCount);
+        fprintf(stderr, "\n");
+    }
+
+    fprintf(stderr, "\nCyclic paths use %lu%% of the cycle (limit %d%%)\n",
+            (ULONG)instance_l.cyclicPercent, QUALIFY_CYCLE_BUDGET_PERCENT);
+    fprintf(stderr, "Cycle time %lu us: %s, recommended minimum cycle time %lu us\n",
+            (ULONG)instance_l.config.cycleLenUs, instance_l.fPass ? "PASS" : "FAIL",
+            (ULONG)instance_l.recommendedCycleUs);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Write results as JSON
+
+The function writes the configuration of the run, all results and the verdict
+as JSON document. The test names only contain characters which need no
+escaping.
+
+\param  pFile_p             File to write to.
+*/
+//------------------------------------------------------------------------------
+static void writeJson(FILE* pFile_p)
+{
+    struct utsname  uts;
+    tQualifyResult* pResult;
+    UINT            i;
+
+    if (uname(&uts) != 0)
+        memset(&uts, 0, sizeof(uts));
+
+    fprintf(pFile_p, "{\n");
+    fprintf(pFile_p, "  \"suite\": \"openPOWERLINK qualification\",\n");
+    fprintf(pFile_p, "  \"timestamp\": %lu,\n", (ULONG)time(NULL));
+    fprintf(pFile_p, "  \"host\": {\"system\": \"%s\", \"release\": \"%s\", \"machine\": \"%s\"},\n",
+            uts.sysname, uts.release, uts.machine);
+    fprintf(pFile_p, "  \"cycleLenUs\": %lu,\n", (ULONG)instance_l.config.cycleLenUs);
+    fprintf(pFile_p, "  \"durationS\": %lu,\n", (ULONG)instance_l.config.durationS);
+    fprintf(pFile_p, "  \"load\": {\"type\": \"%s\", \"threads\": %u},\n",
+            (instance_l.config.loadType == kQualifyLoadCpu) ? "cpu" : "mem",
+            instance_l.config.loadThreadCount);
+    fprintf(pFile_p, "  \"tests\": [");
+
+    for (i = 0; i < instance_l.resultCount; i++)
+    {
+        pResult = &instance_l.aResult[i];
+        fprintf(pFile_p, "%s\n    {\"name\": \"%s\", ", (i == 0) ? "" : ",", pResult->pName);
+        if (pResult->pSkipReason != NULL)
+        {
+            fprintf(pFile_p, "\"skipped\": \"%s\"}", pResult->pSkipReason);
+            continue;
+        }
+
+        if (pResult->pError != NULL)
+        {
+            fprintf(pFile_p, "\"error\": \"%s\"}", pResult->pError);
+            continue;
+        }
+
+        fprintf(pFile_p, "\"samples\": %u, \"lost\": %u, \"minNs\": %lu, \"meanNs\": %lu, "
+                "\"p99Ns\": %lu, \"p999Ns\": %lu, \"maxNs\": %lu, \"budgetPercent\": %u, "
+                "\"pass\": %s}",
+                pResult->count, pResult->lostCount, (ULONG)pResult->minNs,
+                (ULONG)pResult->meanNs, (ULONG)pResult->p99Ns, (ULONG)pResult->p999Ns,
+                (ULONG)pResult->maxNs, pResult->budgetPercent,
+                pResult->fPass ? "true" : "false");
+    }
+
+    fprintf(pFile_p, "\n  ],\n");
+    fprintf(pFile_p, "  \"cyclicPercent\": %lu,\n", (ULONG)instance_l.cyclicPercent);
+    fprintf(pFile_p, "  \"recommendedCycleLenUs\": %lu,\n", (ULONG)instance_l.recommendedCycleUs);
+    fprintf(pFile_p, "  \"pass\": %s\n}\n", instance_l.fPass ? "true" : "false");
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Print usage
+
+\param  pProgName_p         Name of the program.
+*/
+//------------------------------------------------------------------------------
+static void usage(const char* pProgName_p)
+{
+    fprintf(stderr, "Usage: %s [-c <us>] [-d <s>] [-i <interface>] [-l <threads>] [-L cpu|mem]\n"
+            "          [-n <channels>] [-s <bytes>] [-o <file>] [-f <filter>]\n"
+            "  -c <us>          Target cycle time (min. %d, default %d us)\n"
+            "  -d <s>           Duration of each test (default %d s)\n"
+            "  -i <interface>   Interface for the Ethernet driver loopback test\n"
+            "                   (e.g. lo, the test is skipped without interface)\n"
+            "  -l <threads>     Number of background load threads (default 0)\n"
+            "  -L cpu|mem       Type of the background load (default cpu)\n"
+            "  -n <channels>    Number of RPDO and TPDO channels (default %d)\n"
+            "  -s <bytes>       Size of each PDO (default %d bytes)\n"
+            "  -o <file>        Write JSON results to <file> instead of stdout\n"
+            "  -f <filter>      Only run tests whose name contains <filter>\n",
+            pProgName_p, QUALIFY_MIN_CYCLE_US, QUALIFY_DEFAULT_CYCLE_US,
+            QUALIFY_DEFAULT_DURATION_S, QUALIFY_DEFAULT_PDO_CHANNELS,
+            QUALIFY_DEFAULT_PDO_SIZE);
+}
+
+/// \}
@@ -0,0 +1,148 @@
+/**
+********************************************************************************
+\file   qualify.h
+
+\brief  Definitions of the openPOWERLINK target qualification tool
+
+The file contains the definitions of the qualification tool which measures
+whether a target can run the stack with a given cycle time.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, Bernecker+Rainer Industrie-Elektronik Ges.m.b.H. (B&R)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_qualify_H_
+#define _INC_qualify_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplkinc.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Background load type
+
+The enumeration lists the background loads which can be started while the
+tests are running.
+*/
+typedef enum
+{
+    kQualifyLoadCpu = 0,                    ///< Threads spinning on the CPU
+    kQualifyLoadMemory,                     ///< Threads copying large memory blocks
+} tQualifyLoad;
+
+/**
+\brief  Qualification options
+
+The structure contains the options of the qualification run.
+*/
+typedef struct
+{
+    UINT32          cycleLenUs;             ///< Target cycle time in us
+    UINT32          durationS;              ///< Duration of one test in s
+    const char*     pIfName;                ///< Network interface for the edrv test, NULL to skip it
+    const char*     pFilter;                ///< Only tests containing this string are run
+    UINT            loadThreadCount;        ///< Number of background load threads
+    tQualifyLoad    loadType;               ///< Type of the background load
+    UINT            pdoChannelCount;        ///< Number of RPDO and TPDO channels of the PDO test
+    UINT            pdoSize;                ///< Size of one PDO in bytes
+} tQualifyConfig;
+
+/**
+\brief  Latency result
+
+The structure contains the samples and the evaluation of one latency test.
+*/
+typedef struct
+{
+    const char*     pName;                  ///< Name of the test
+    const char*     pSkipReason;            ///< Reason if the test was skipped, otherwise NULL
+    const char*     pError;                 ///< Reason if the test failed to run, otherwise NULL
+    UINT            budgetPercent;          ///< Share of the cycle the worst case may use, 0 if informational
+    BOOL            fCyclic;                ///< The path is executed in every cycle
+    UINT32*         paSample;               ///< Measured latencies in ns
+    UINT            capacity;               ///< Size of the sample array
+    volatile UINT   count;                  ///< Number of stored samples
+    UINT            lostCount;              ///< Number of samples which were not measured (e.g. missed cycles)
+    UINT32          minNs;                  ///< Minimum latency
+    UINT32          meanNs;                 ///< Mean latency
+    UINT32          p99Ns;                  ///< 99th percentile of the latency
+    UINT32          p999Ns;                 ///< 99.9th percentile of the latency
+    UINT32          maxNs;                  ///< Worst case latency
+    BOOL            fPass;                  ///< The worst case is within the budget
+} tQualifyResult;
+
+/**
+\brief  Cycle hook
+
+The function is called by qualifytimer_run() in every cycle of the
+high-resolution timer after the wake-up latency was recorded.
+
+\param  pArg_p              Argument passed to qualifytimer_run().
+\param  now_p               Timestamp of the timer callback.
+*/
+typedef void (*tQualifyCycleHook)(void* pArg_p, UINT64 now_p);
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+const tQualifyConfig* qualify_getConfig(void);
+tQualifyResult*       qualify_addResult(const char* pName_p, UINT budgetPercent_p, BOOL fCyclic_p);
+void                  qualify_addSample(tQualifyResult* pResult_p, UINT32 latencyNs_p);
+void                  qualify_skip(const char* pName_p, const char* pReason_p);
+void                  qualify_fail(tQualifyResult* pResult_p, const char* pReason_p);
+BOOL                  qualify_isSelected(const char* pName_p);
+
+tOplkError qualifytimer_run(tQualifyResult* pLatency_p, tQualifyCycleHook pfnHook_p, void* pArg_p);
+
+void qualifytimer_test(void);
+void qualifyedrv_test(void);
+void qualifyevent_test(void);
+void qualifypdo_test(void);
+
+tOplkError qualifyload_start(void);
+void       qualifyload_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _INC_qualify_H_ */